@@ -0,0 +1,794 @@
+/* Benchmark replaying archived redo logs through the whole pipeline
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <rapidjson/document.h>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+#if __APPLE__
+#include <malloc/malloc.h>
+#else
+#include <malloc.h>
+#endif
+
+#include "OpenLogReplicator.h"
+#include "builder/BuilderJson.h"
+#include "common/Ctx.h"
+#include "common/Format.h"
+#include "common/MemoryManager.h"
+#include "common/Thread.h"
+#include "common/exception/ConfigurationException.h"
+#include "common/exception/DataException.h"
+#include "common/exception/RuntimeException.h"
+#include "common/table/SysCol.h"
+#include "common/table/TablePack.h"
+#include "common/types/IntX.h"
+#include "locales/Locales.h"
+#include "metadata/Checkpoint.h"
+#include "metadata/Metadata.h"
+#include "metadata/SerializerJson.h"
+#include "parser/TransactionBuffer.h"
+#include "parser/TransactionMap.h"
+#include "replicator/ReplicatorBatch.h"
+#include "state/StateDisk.h"
+#include "writer/WriterDiscard.h"
+
+#ifdef LINK_LIBRARY_PROTOBUF
+#include "builder/BuilderProtobuf.h"
+#endif /* LINK_LIBRARY_PROTOBUF */
+
+namespace {
+    constexpr uint64_t POLL_US{10000};
+    constexpr uint64_t XID_MAP_LOOKUPS{1 << 20};
+    constexpr uint64_t XID_MAP_MIN_US{200000};
+    constexpr uint64_t SCHEMA_LOAD_TABLE_COLUMNS{20};
+    constexpr typeObj SCHEMA_LOAD_OBJ{100000};
+    const std::string CHECKPOINT_INFIX{"-chkpt-"};
+    const std::string CHECKPOINT_SUFFIX{".json"};
+    const std::string ALIAS{"bench"};
+
+    // Everything that defines a run, printed with the results so that numbers of two releases can be compared
+    struct BenchConfig {
+        std::string database;
+        std::string checkpointFile;
+        OpenLogReplicator::Scn startScn{OpenLogReplicator::Scn::none()};
+        std::vector<std::pair<std::string, std::string>> tables;
+        std::vector<std::string> redoLogs;
+        std::string format{"json"};
+        uint flags{0};
+        uint64_t memoryMaxMb{2048};
+        uint64_t runs{1};
+        // -1 - the default of the release
+        int64_t lwnPrefetch{-1};
+        // File backed transaction memory instead of the explicit swap, 0 - explicit swap
+        uint64_t transactionMapMb{0};
+        // Number of live XIDs of the XID map lookup benchmark, 0 - replay the redo logs
+        uint64_t xidMapLive{0};
+        // Number of SYS.COL$ rows of the schema load benchmark, 0 - replay the redo logs
+        uint64_t schemaLoadColumns{0};
+        bool coldCache{false};
+        bool json{false};
+    };
+
+    struct StageThread {
+        uint64_t count{0};
+        uint64_t cpuUs{0};
+    };
+
+    struct BenchResult {
+        bool failed{false};
+        double seconds{0};
+        uint64_t bytesRead{0};
+        uint64_t bytesParsed{0};
+        uint64_t recordsParsed{0};
+        uint64_t messagesBuilt{0};
+        uint64_t bytesBuilt{0};
+        uint64_t messagesSent{0};
+        uint64_t bytesSent{0};
+        uint64_t memoryHwmMb{0};
+        uint64_t memoryModuleHwmMb[OpenLogReplicator::Ctx::MEMORY_COUNT]{};
+        std::map<std::string, StageThread> threads;
+
+        [[nodiscard]] double perS(uint64_t value) const {
+            return seconds > 0 ? static_cast<double>(value) / seconds : 0;
+        }
+
+        [[nodiscard]] double mbPerS(uint64_t bytes) const {
+            return perS(bytes) / 1024 / 1024;
+        }
+    };
+
+    struct SchemaLoadResult {
+        std::string storage;
+        double loadS{0};
+        double walkS{0};
+        double findS{0};
+        double releaseS{0};
+        uint64_t memoryBytes{0};
+    };
+
+    struct XidMapResult {
+        std::string map;
+        std::string lookup;
+        double lookupsPerS{0};
+    };
+
+    void usage(const OpenLogReplicator::Ctx& ctx) {
+        ctx.info(0, "use: olr-bench -n <database> -c <schema checkpoint file> [-s <start scn>] [-t <owner>.<table>]... [-f json|protobuf] "
+                    "[-F <flags>] [-m <max memory mb>] [-r <runs>] [-p <lwn prefetch>] [-M <transaction map mb>] [-C] [-j] <redo log file or directory>...");
+        ctx.info(0, "use: olr-bench -X <live xids> [-r <runs>] [-j]");
+        ctx.info(0, "use: olr-bench -L <columns> [-r <runs>] [-j]");
+    }
+
+    bool parseArgs(int argc, char** argv, BenchConfig& config) {
+        int opt;
+        while ((opt = getopt(argc, argv, "n:c:s:t:f:F:m:r:p:M:X:L:Cj")) != -1) {
+            switch (opt) {
+                case 'n':
+                    config.database = optarg;
+                    break;
+                case 'c':
+                    config.checkpointFile = optarg;
+                    break;
+                case 's':
+                    config.startScn = strtoull(optarg, nullptr, 10);
+                    break;
+                case 't': {
+                    const std::string table(optarg);
+                    const size_t dot = table.find('.');
+                    if (dot == std::string::npos || dot == 0 || dot == table.length() - 1)
+                        return false;
+                    config.tables.emplace_back(table.substr(0, dot), table.substr(dot + 1));
+                    break;
+                }
+                case 'f':
+                    config.format = optarg;
+                    break;
+                case 'F':
+                    config.flags = static_cast<uint>(strtoul(optarg, nullptr, 10));
+                    break;
+                case 'm':
+                    config.memoryMaxMb = strtoull(optarg, nullptr, 10);
+                    break;
+                case 'r':
+                    config.runs = strtoull(optarg, nullptr, 10);
+                    break;
+                case 'p':
+                    config.lwnPrefetch = strtoll(optarg, nullptr, 10);
+                    if (config.lwnPrefetch < 0 || config.lwnPrefetch > 64)
+                        return false;
+                    break;
+                case 'M':
+                    config.transactionMapMb = strtoull(optarg, nullptr, 10);
+                    if (config.transactionMapMb < OpenLogReplicator::Ctx::MEMORY_CHUNK_MIN_MB)
+                        return false;
+                    break;
+                case 'X':
+                    config.xidMapLive = strtoull(optarg, nullptr, 10);
+                    if (config.xidMapLive == 0)
+                        return false;
+                    break;
+                case 'L':
+                    config.schemaLoadColumns = strtoull(optarg, nullptr, 10);
+                    if (config.schemaLoadColumns == 0)
+                        return false;
+                    break;
+                case 'C':
+                    config.coldCache = true;
+                    break;
+                case 'j':
+                    config.json = true;
+                    break;
+                default:
+                    return false;
+            }
+        }
+
+        if (config.xidMapLive > 0 || config.schemaLoadColumns > 0)
+            return optind == argc && config.runs > 0 && (config.xidMapLive == 0 || config.schemaLoadColumns == 0);
+
+        for (int i = optind; i < argc; ++i)
+            config.redoLogs.emplace_back(argv[i]);
+
+        if (config.tables.empty())
+            config.tables.emplace_back(".*", ".*");
+        return !config.database.empty() && !config.checkpointFile.empty() && !config.redoLogs.empty() && config.runs > 0 &&
+               (config.format == "json" || config.format == "protobuf");
+    }
+
+    // The file name carries the scn the schema is valid for: <database>-chkpt-<scn>.json
+    std::string checkpointName(const BenchConfig& config, OpenLogReplicator::Scn& scn) {
+        const size_t slash = config.checkpointFile.rfind('/');
+        const std::string fileName = slash == std::string::npos ? config.checkpointFile : config.checkpointFile.substr(slash + 1);
+        const std::string prefix = config.database + CHECKPOINT_INFIX;
+        const std::string& suffix = CHECKPOINT_SUFFIX;
+
+        if (fileName.length() <= prefix.length() + suffix.length() || fileName.compare(0, prefix.length(), prefix) != 0 ||
+                fileName.compare(fileName.length() - suffix.length(), suffix.length(), suffix) != 0)
+            throw OpenLogReplicator::ConfigurationException(30001, "file: " + config.checkpointFile + " - invalid name, expected: " + prefix +
+                                                                   "<scn>" + suffix);
+
+        const std::string scnStr = fileName.substr(prefix.length(), fileName.length() - prefix.length() - suffix.length());
+        if (scnStr.empty() || scnStr.find_first_not_of("0123456789") != std::string::npos)
+            throw OpenLogReplicator::ConfigurationException(30001, "file: " + config.checkpointFile + " - invalid scn: " + scnStr);
+        scn = strtoull(scnStr.c_str(), nullptr, 10);
+        return fileName;
+    }
+
+    // Every run starts from a private copy of the schema checkpoint, so that checkpoints written by a run never affect the next one
+    std::string prepareStateDir(const BenchConfig& config, const std::string& fileName) {
+        const char* tmpDir = getenv("TMPDIR");
+        std::string pattern = std::string(tmpDir != nullptr ? tmpDir : "/tmp") + "/olr-bench-XXXXXX";
+        if (mkdtemp(pattern.data()) == nullptr)
+            throw OpenLogReplicator::RuntimeException(10086, "directory: " + pattern + " - create returned: " + strerror(errno));
+
+        std::ifstream in(config.checkpointFile, std::ios::binary);
+        if (!in.is_open())
+            throw OpenLogReplicator::RuntimeException(10001, "file: " + config.checkpointFile + " - open for read returned: " + strerror(errno));
+        std::ofstream out(pattern + "/" + fileName, std::ios::binary);
+        out << in.rdbuf();
+        if (!out.good())
+            throw OpenLogReplicator::RuntimeException(10006, "file: " + pattern + "/" + fileName + " - open for writing returned: " +
+                                                             strerror(errno));
+        return pattern;
+    }
+
+    void removeStateDir(const std::string& path) {
+        DIR* dir = opendir(path.c_str());
+        if (dir == nullptr)
+            return;
+        const dirent* ent;
+        while ((ent = readdir(dir)) != nullptr) {
+            if (strcmp(ent->d_name, ".") != 0 && strcmp(ent->d_name, "..") != 0)
+                unlink((path + "/" + ent->d_name).c_str());
+        }
+        closedir(dir);
+        rmdir(path.c_str());
+    }
+
+    // Pages of the redo logs are dropped from the page cache, so that the run reads them from the disk like a replay of old archives
+    void dropCache(const std::string& path) {
+        DIR* dir = opendir(path.c_str());
+        if (dir != nullptr) {
+            const dirent* ent;
+            while ((ent = readdir(dir)) != nullptr) {
+                if (strcmp(ent->d_name, ".") != 0 && strcmp(ent->d_name, "..") != 0)
+                    dropCache(path + "/" + ent->d_name);
+            }
+            closedir(dir);
+            return;
+        }
+
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd == -1)
+            return;
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+
+    // Same wiring as a configured "batch" source with a "discard" target, without the configuration file
+    BenchResult runOnce(const BenchConfig& config, OpenLogReplicator::Ctx::LOG logLevel) {
+        using namespace OpenLogReplicator;
+
+        Scn checkpointScn;
+        const std::string fileName = checkpointName(config, checkpointScn);
+        const std::string statePath = prepareStateDir(config, fileName);
+
+        BenchResult result;
+        Ctx ctx;
+        ctx.logLevel = logLevel;
+        ctx.flags = config.flags;
+        // Timing the stages takes clock reads the release being measured may not have
+        ctx.latencySample = 0;
+        if (config.lwnPrefetch >= 0)
+            ctx.lwnPrefetch = static_cast<uint>(config.lwnPrefetch);
+        if (config.coldCache)
+            for (const std::string& redoLog: config.redoLogs)
+                dropCache(redoLog);
+
+        const uint64_t memoryMaxMb = std::max<uint64_t>((config.memoryMaxMb / Ctx::MEMORY_CHUNK_SIZE_MB) * Ctx::MEMORY_CHUNK_SIZE_MB,
+                                                        Ctx::MEMORY_CHUNK_MIN_MB * 2);
+        // Transactions are paged out at the same usage at which the explicit swap starts, to compare the two modes
+        if (config.transactionMapMb > 0) {
+            ctx.transactionMapMb = config.transactionMapMb;
+            ctx.transactionMapPath = statePath;
+            ctx.transactionMapResidentMb = std::min(config.transactionMapMb, memoryMaxMb * 3 / 4);
+        }
+        ctx.initialize(Ctx::MEMORY_CHUNK_MIN_MB, memoryMaxMb, std::min<uint64_t>(memoryMaxMb / 8, 128), 4, memoryMaxMb * 3 / 4, 4,
+                       std::min<uint64_t>(memoryMaxMb, 2048), 4);
+
+        auto* locales = new Locales();
+        locales->initialize();
+
+        auto* memoryManager = new MemoryManager(&ctx, ALIAS + "-memory-manager", statePath);
+        memoryManager->initialize();
+        ctx.spawnThread(memoryManager);
+
+        auto* metadata = new Metadata(&ctx, locales, config.database, -1, config.startScn != Scn::none() ? config.startScn : checkpointScn,
+                                      Seq::none(), "", 0);
+        metadata->resetElements();
+        for (const auto& [owner, table]: config.tables) {
+            metadata->addElement(owner, table, DbTable::OPTIONS::DEFAULT);
+            metadata->users.insert(owner);
+        }
+        metadata->state = new StateDisk(&ctx, statePath);
+        metadata->serializer = new SerializerJson();
+
+        auto* checkpoint = new Checkpoint(&ctx, metadata, ALIAS + "-checkpoint", WEB_CONFIG_FILE_NAME, -1);
+        ctx.spawnThread(checkpoint);
+
+        auto* transactionBuffer = new TransactionBuffer(&ctx);
+
+        rapidjson::Document formatJson;
+        formatJson.Parse(R"({"type":"json"})");
+        Format format = Format::parseJson(&ctx, fileName, formatJson);
+        Builder* builder;
+#ifdef LINK_LIBRARY_PROTOBUF
+        if (config.format == "protobuf")
+            builder = new BuilderProtobuf(&ctx, locales, metadata, format, 1048576);
+        else
+#endif /* LINK_LIBRARY_PROTOBUF */
+        builder = new BuilderJson(&ctx, locales, metadata, format, 1048576);
+        checkpoint->setBuilder(builder);
+
+        auto* replicator = new ReplicatorBatch(&ctx, Replicator::archGetLogList, builder, metadata, transactionBuffer, ALIAS, config.database);
+        builder->initialize();
+        replicator->initialize();
+        for (const std::string& redoLog: config.redoLogs)
+            replicator->addRedoLogsBatch(redoLog);
+        metadata->commitElements();
+
+        Writer* writer = new WriterDiscard(&ctx, ALIAS + "-writer", config.database, builder, metadata);
+        writer->initialize();
+
+        const auto start = std::chrono::steady_clock::now();
+        ctx.spawnThread(replicator);
+        ctx.spawnThread(writer);
+
+        // The writer is the last stage to finish, once every built message is confirmed
+        while (!writer->finished && !ctx.hardShutdown)
+            usleep(POLL_US);
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.failed = ctx.hardShutdown;
+
+        ctx.forEachThread([&result](const Thread* thread) {
+            const std::string name = thread->getName();
+            StageThread& stage = result.threads[name.substr(0, name.find(':'))];
+            ++stage.count;
+            if constexpr (Thread::contextCompiled)
+                stage.cpuUs += static_cast<uint64_t>(thread->contextTime[static_cast<uint>(Thread::CONTEXT::CPU)].load(std::memory_order_relaxed));
+        });
+
+        const RuntimeStats& stats = ctx.stats;
+        result.bytesRead = RuntimeStats::get(stats.bytesRead);
+        result.bytesParsed = RuntimeStats::get(stats.bytesParsed);
+        result.recordsParsed = RuntimeStats::get(stats.recordsParsed);
+        result.messagesBuilt = RuntimeStats::get(stats.messagesBuilt);
+        result.bytesBuilt = RuntimeStats::get(stats.bytesBuilt);
+        result.messagesSent = RuntimeStats::get(stats.messagesSent);
+        result.bytesSent = RuntimeStats::get(stats.bytesSent);
+        result.memoryHwmMb = ctx.getMemoryHWM();
+        for (uint module = 0; module < Ctx::MEMORY_COUNT; ++module)
+            result.memoryModuleHwmMb[module] = ctx.getMemoryModuleHwmMb(static_cast<Ctx::MEMORY>(module));
+
+        ctx.stopSoft();
+        ctx.mainFinish();
+
+        writer->flush();
+        delete writer;
+        delete builder;
+        delete replicator;
+        delete checkpoint;
+        delete transactionBuffer;
+        delete metadata;
+        delete locales;
+        delete memoryManager;
+
+        removeStateDir(statePath);
+        return result;
+    }
+
+    // Key of the XID as TransactionBuffer builds it from the usn and the slot, 32 slots of every undo segment are taken
+    XidMap xidMapKey(uint64_t xid) {
+        return ((xid / 32) << 16) | (xid % 32);
+    }
+
+    // Lookups per second over the keys, repeated for at least XID_MAP_MIN_US, found - the keys of one pass which are in the map
+    template<typename MAP>
+    double measureXidMap(const MAP& map, const std::vector<XidMap>& keys, uint64_t& found) {
+        uint64_t lookups = 0;
+        const auto start = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::duration elapsed{};
+        do {
+            found = 0;
+            for (const XidMap key: keys) {
+                if constexpr (std::is_same_v<MAP, OpenLogReplicator::TransactionMap>) {
+                    if (map.find(key) != nullptr)
+                        ++found;
+                } else {
+                    if (map.find(key) != map.end())
+                        ++found;
+                }
+            }
+            lookups += keys.size();
+            elapsed = std::chrono::steady_clock::now() - start;
+        } while (std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() < static_cast<int64_t>(XID_MAP_MIN_US));
+
+        return static_cast<double>(lookups) / std::chrono::duration<double>(elapsed).count();
+    }
+
+    // The XID map of TransactionBuffer against the node based map it replaced, with every XID live at the same time
+    std::vector<XidMapResult> runXidMap(const BenchConfig& config) {
+        using namespace OpenLogReplicator;
+
+        // Only the addresses are stored, a transaction is never touched
+        std::vector<uint64_t> transactions(config.xidMapLive);
+        TransactionMap flatMap;
+        std::unordered_map<XidMap, Transaction*> nodeMap;
+        for (uint64_t xid = 0; xid < config.xidMapLive; ++xid) {
+            auto* transaction = reinterpret_cast<Transaction*>(&transactions[xid]);
+            flatMap.insert(xidMapKey(xid), transaction);
+            nodeMap.insert_or_assign(xidMapKey(xid), transaction);
+        }
+
+        // Redo records of the open transactions come interleaved, the order is random; a miss is the first record of a new transaction
+        std::vector<XidMap> hitKeys;
+        std::vector<XidMap> missKeys;
+        hitKeys.reserve(XID_MAP_LOOKUPS);
+        missKeys.reserve(XID_MAP_LOOKUPS);
+        uint64_t random = 0x2545F4914F6CDD1DULL;
+        for (uint64_t i = 0; i < XID_MAP_LOOKUPS; ++i) {
+            random ^= random << 13;
+            random ^= random >> 7;
+            random ^= random << 17;
+            const uint64_t xid = random % config.xidMapLive;
+            hitKeys.push_back(xidMapKey(xid));
+            missKeys.push_back(xidMapKey(xid) | 0x20);
+        }
+
+        std::vector<XidMapResult> results;
+        for (const auto& [lookup, keys]: {std::make_pair("hit", &hitKeys), std::make_pair("miss", &missKeys)}) {
+            // Both maps must find what is live, the count also keeps the lookups from being optimized out
+            const uint64_t expected = keys == &hitKeys ? keys->size() : 0;
+            std::vector<double> flatRuns;
+            std::vector<double> nodeRuns;
+            for (uint64_t run = 0; run < config.runs; ++run) {
+                uint64_t flatFound;
+                uint64_t nodeFound;
+                flatRuns.push_back(measureXidMap(flatMap, *keys, flatFound));
+                nodeRuns.push_back(measureXidMap(nodeMap, *keys, nodeFound));
+                if (flatFound != expected || nodeFound != expected)
+                    throw RuntimeException(10101, "xid map: " + std::string(lookup) + " lookups found " + std::to_string(flatFound) + " flat and " +
+                                                  std::to_string(nodeFound) + " node entries, expected: " + std::to_string(expected));
+            }
+            std::sort(flatRuns.begin(), flatRuns.end());
+            std::sort(nodeRuns.begin(), nodeRuns.end());
+            results.push_back({"flat", lookup, flatRuns[flatRuns.size() / 2]});
+            results.push_back({"node", lookup, nodeRuns[nodeRuns.size() / 2]});
+        }
+        return results;
+    }
+
+    void printXidMapText(const BenchConfig& config, const std::vector<XidMapResult>& results) {
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(2);
+        for (const XidMapResult& result: results)
+            ss << "xid map " << std::left << std::setw(5) << result.map << std::setw(5) << result.lookup << std::right << config.xidMapLive <<
+               " live: " << result.lookupsPerS / 1000000 << " M lookups/s\n";
+        std::cout << ss.str() << std::flush;
+    }
+
+    void printXidMapJson(const BenchConfig& config, const std::vector<XidMapResult>& results) {
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(0);
+        ss << R"({"version":")" << OpenLogReplicator_VERSION_MAJOR << "." << OpenLogReplicator_VERSION_MINOR << "." <<
+           OpenLogReplicator_VERSION_PATCH << R"(","build-type":")" << OpenLogReplicator_CMAKE_BUILD_TYPE << R"(","arch":")" <<
+           OpenLogReplicator_CPU_ARCH << R"(","xid-map-live":)" << config.xidMapLive << R"(,"runs":)" << config.runs << R"(,"xid-map":[)";
+        for (uint64_t i = 0; i < results.size(); ++i)
+            ss << (i > 0 ? "," : "") << R"({"map":")" << results[i].map << R"(","lookup":")" << results[i].lookup << R"(","lookups-per-s":)" <<
+               results[i].lookupsPerS << "}";
+        ss << "]}\n";
+        std::cout << ss.str() << std::flush;
+    }
+
+    uint64_t heapInUse() {
+#if __APPLE__
+        return mstats().bytes_used;
+#else
+        return mallinfo2().uordblks;
+#endif
+    }
+
+    // A clustered SYS.COL$, the columns of a table come one after another in the blocks
+    OpenLogReplicator::RowId schemaLoadRowId(uint64_t column) {
+        return {2, static_cast<typeDba>(0x00401000 + (column / 64)), static_cast<typeSlot>(column % 64)};
+    }
+
+    // Load of SYS.COL$ from a schema checkpoint into a pack with the ordered maps of the storage, followed by the reads of the columns
+    template<template<class, class> class ORDEREDMAP>
+    SchemaLoadResult measureSchemaLoad(const OpenLogReplicator::Ctx* ctx, const BenchConfig& config, const std::string& storage) {
+        using namespace OpenLogReplicator;
+        using Pack = TablePack<SysCol, SysColSeg, TabRowIdUnorderedKeyDefault, ORDEREDMAP>;
+
+        // Redo of system transactions looks the rows up by ROWID in no particular order
+        std::vector<RowId> rowIds;
+        rowIds.reserve(config.schemaLoadColumns);
+        for (uint64_t column = 0; column < config.schemaLoadColumns; ++column)
+            rowIds.push_back(schemaLoadRowId(column));
+        std::shuffle(rowIds.begin(), rowIds.end(), std::mt19937_64(config.schemaLoadColumns));
+
+        SchemaLoadResult result;
+        result.storage = storage;
+        const uint64_t heapStart = heapInUse();
+        auto start = std::chrono::steady_clock::now();
+        auto* pack = new Pack();
+        for (uint64_t column = 0; column < config.schemaLoadColumns; ++column) {
+            const auto obj = static_cast<typeObj>(SCHEMA_LOAD_OBJ + (column / SCHEMA_LOAD_TABLE_COLUMNS));
+            const auto col = static_cast<typeCol>((column % SCHEMA_LOAD_TABLE_COLUMNS) + 1);
+            pack->addWithKeys(ctx, new SysCol(schemaLoadRowId(column), obj, col, col, col, "COLUMN_" + std::to_string(col), SysCol::COLTYPE::VARCHAR,
+                                              100, -1, -1, 1, 873, 0, 0, 0));
+        }
+        // Once the checkpoint is loaded the touched rows are dropped by Schema::dropUnusedMetadata() and the changed ones by Schema::resetChanged()
+        pack->setTouched.clear();
+        pack->setChanged.clear();
+        result.loadS = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.memoryBytes = heapInUse() - heapStart;
+
+        // The columns of every table, as Schema::buildMaps() reads them
+        uint64_t found = 0;
+        const RowId rowId;
+        start = std::chrono::steady_clock::now();
+        const uint64_t tables = (config.schemaLoadColumns + SCHEMA_LOAD_TABLE_COLUMNS - 1) / SCHEMA_LOAD_TABLE_COLUMNS;
+        for (uint64_t table = 0; table < tables; ++table) {
+            const auto obj = static_cast<typeObj>(SCHEMA_LOAD_OBJ + table);
+            for (auto it = pack->mapKey.upper_bound(SysColSeg(obj, 0, rowId)); it != pack->mapKey.end() && it->first.obj == obj; ++it)
+                if (it->second->segCol > 0)
+                    ++found;
+        }
+        result.walkS = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        for (const RowId& columnRowId: rowIds)
+            if (pack->mapRowId.find(columnRowId) != pack->mapRowId.end())
+                ++found;
+        result.findS = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        pack->release();
+        delete pack;
+        result.releaseS = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (found != 2 * config.schemaLoadColumns)
+            throw RuntimeException(10103, "schema load: " + storage + " found " + std::to_string(found) + " columns, expected: " +
+                                          std::to_string(2 * config.schemaLoadColumns));
+        return result;
+    }
+
+    // SYS.COL$ in the FlatMap storage of the large dictionaries against the node based TreeMap, of every run the one with the median load time
+    std::vector<SchemaLoadResult> runSchemaLoad(const BenchConfig& config) {
+        using namespace OpenLogReplicator;
+
+        Ctx ctx;
+        ctx.logLevel = Ctx::LOG::WARNING;
+        std::vector<SchemaLoadResult> results;
+        std::vector<SchemaLoadResult> flatRuns;
+        std::vector<SchemaLoadResult> nodeRuns;
+        for (uint64_t run = 0; run < config.runs; ++run) {
+            flatRuns.push_back(measureSchemaLoad<FlatMap>(&ctx, config, "flat"));
+            nodeRuns.push_back(measureSchemaLoad<TreeMap>(&ctx, config, "node"));
+        }
+        for (std::vector<SchemaLoadResult>* runs: {&flatRuns, &nodeRuns}) {
+            std::sort(runs->begin(), runs->end(), [](const SchemaLoadResult& result1, const SchemaLoadResult& result2) {
+                return result1.loadS < result2.loadS;
+            });
+            results.push_back((*runs)[runs->size() / 2]);
+        }
+        return results;
+    }
+
+    void printSchemaLoadText(const BenchConfig& config, const std::vector<SchemaLoadResult>& results) {
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(3);
+        for (const SchemaLoadResult& result: results)
+            ss << "schema load " << result.storage << " " << config.schemaLoadColumns << " columns: load " << result.loadS << " s, memory " <<
+               static_cast<double>(result.memoryBytes) / 1024 / 1024 << " MB, table walk " << result.walkS << " s, rowid find " << result.findS <<
+               " s, release " << result.releaseS << " s\n";
+        std::cout << ss.str() << std::flush;
+    }
+
+    void printSchemaLoadJson(const BenchConfig& config, const std::vector<SchemaLoadResult>& results) {
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(6);
+        ss << R"({"version":")" << OpenLogReplicator_VERSION_MAJOR << "." << OpenLogReplicator_VERSION_MINOR << "." <<
+           OpenLogReplicator_VERSION_PATCH << R"(","build-type":")" << OpenLogReplicator_CMAKE_BUILD_TYPE << R"(","arch":")" <<
+           OpenLogReplicator_CPU_ARCH << R"(","schema-load-columns":)" << config.schemaLoadColumns << R"(,"runs":)" << config.runs << R"(,"schema-load":[)";
+        for (uint64_t i = 0; i < results.size(); ++i)
+            ss << (i > 0 ? "," : "") << R"({"storage":")" << results[i].storage << R"(","load-s":)" << results[i].loadS << R"(,"memory-bytes":)" <<
+               results[i].memoryBytes << R"(,"walk-s":)" << results[i].walkS << R"(,"find-s":)" << results[i].findS << R"(,"release-s":)" <<
+               results[i].releaseS << "}";
+        ss << "]}\n";
+        std::cout << ss.str() << std::flush;
+    }
+
+    void printText(const BenchResult& result, const std::string& label) {
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(2);
+        ss << label << (result.failed ? " FAILED" : "") << ": " << result.seconds << " s, memory hwm: " <<
+           result.memoryHwmMb << " MB\n";
+        ss << "  reader:  " << static_cast<double>(result.bytesRead) / 1024 / 1024 << " MB, " << result.mbPerS(result.bytesRead) << " MB/s, hwm: " <<
+           result.memoryModuleHwmMb[static_cast<uint>(OpenLogReplicator::Ctx::MEMORY::READER)] << " MB\n";
+        ss << "  parser:  " << static_cast<double>(result.bytesParsed) / 1024 / 1024 << " MB, " << result.mbPerS(result.bytesParsed) << " MB/s, " <<
+           result.recordsParsed << " records, " << result.perS(result.recordsParsed) << " records/s, hwm: " <<
+           result.memoryModuleHwmMb[static_cast<uint>(OpenLogReplicator::Ctx::MEMORY::PARSER)] << " MB, transactions hwm: " <<
+           result.memoryModuleHwmMb[static_cast<uint>(OpenLogReplicator::Ctx::MEMORY::TRANSACTIONS)] << " MB\n";
+        ss << "  builder: " << result.messagesBuilt << " messages, " << result.perS(result.messagesBuilt) << " messages/s, " <<
+           result.mbPerS(result.bytesBuilt) << " MB/s, hwm: " << result.memoryModuleHwmMb[static_cast<uint>(OpenLogReplicator::Ctx::MEMORY::BUILDER)] <<
+           " MB\n";
+        ss << "  writer:  " << result.messagesSent << " messages, " << result.perS(result.messagesSent) << " messages/s, " <<
+           result.mbPerS(result.bytesSent) << " MB/s, hwm: " << result.memoryModuleHwmMb[static_cast<uint>(OpenLogReplicator::Ctx::MEMORY::WRITER)] <<
+           " MB\n";
+        if constexpr (OpenLogReplicator::Thread::contextCompiled) {
+            for (const auto& [name, stage]: result.threads)
+                ss << "  cpu " << name << " (" << stage.count << " threads): " << static_cast<double>(stage.cpuUs) / 1000000 << " s\n";
+        }
+        std::cout << ss.str() << std::flush;
+    }
+
+    void printJson(const BenchConfig& config, const BenchResult& result) {
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(3);
+        ss << R"({"version":")" << OpenLogReplicator_VERSION_MAJOR << "." << OpenLogReplicator_VERSION_MINOR << "." <<
+           OpenLogReplicator_VERSION_PATCH << R"(","build-type":")" << OpenLogReplicator_CMAKE_BUILD_TYPE << R"(","arch":")" <<
+           OpenLogReplicator_CPU_ARCH << R"(","database":")" << config.database << R"(","format":")" << config.format << R"(","flags":)" <<
+           config.flags << R"(,"max-mb":)" << config.memoryMaxMb << R"(,"runs":)" << config.runs << R"(,"lwn-prefetch":)" <<
+           config.lwnPrefetch << R"(,"transaction-map-mb":)" << config.transactionMapMb << R"(,"cold-cache":)" << (config.coldCache ? "true" : "false") << R"(,"failed":)" <<
+           (result.failed ? "true" : "false") << R"(,"seconds":)" << result.seconds << R"(,"memory-hwm-mb":)" << result.memoryHwmMb;
+        ss << R"(,"reader":{"bytes":)" << result.bytesRead << R"(,"mb-per-s":)" << result.mbPerS(result.bytesRead) << "}";
+        ss << R"(,"parser":{"bytes":)" << result.bytesParsed << R"(,"mb-per-s":)" << result.mbPerS(result.bytesParsed) << R"(,"records":)" <<
+           result.recordsParsed << R"(,"records-per-s":)" << result.perS(result.recordsParsed) << "}";
+        ss << R"(,"builder":{"messages":)" << result.messagesBuilt << R"(,"messages-per-s":)" << result.perS(result.messagesBuilt) <<
+           R"(,"mb-per-s":)" << result.mbPerS(result.bytesBuilt) << "}";
+        ss << R"(,"writer":{"messages":)" << result.messagesSent << R"(,"messages-per-s":)" << result.perS(result.messagesSent) <<
+           R"(,"mb-per-s":)" << result.mbPerS(result.bytesSent) << "}";
+        ss << R"(,"memory-module-hwm-mb":{)";
+        for (uint module = 0; module < OpenLogReplicator::Ctx::MEMORY_COUNT; ++module)
+            ss << (module > 0 ? "," : "") << '"' << OpenLogReplicator::Ctx::memoryModules[module] << R"(":)" << result.memoryModuleHwmMb[module];
+        ss << "}";
+        if constexpr (OpenLogReplicator::Thread::contextCompiled) {
+            ss << R"(,"cpu-s":{)";
+            bool first = true;
+            for (const auto& [name, stage]: result.threads) {
+                ss << (first ? "" : ",") << '"' << name << R"(":)" << static_cast<double>(stage.cpuUs) / 1000000;
+                first = false;
+            }
+            ss << "}";
+        }
+        ss << "}\n";
+        std::cout << ss.str() << std::flush;
+    }
+}
+
+int main(int argc, char** argv) {
+    OpenLogReplicator::Ctx ctx;
+    ctx.welcome("OpenLogReplicator v." + std::to_string(OpenLogReplicator_VERSION_MAJOR) + "." +
+                std::to_string(OpenLogReplicator_VERSION_MINOR) + "." + std::to_string(OpenLogReplicator_VERSION_PATCH) +
+                " olr-bench (C) 2018-2025 by Adam Leszczynski (aleszczynski@bersler.com), see LICENSE file for licensing information");
+
+    // Run arguments:
+    // -n database name, as in the schema checkpoint file name
+    // -c schema checkpoint file <database>-chkpt-<scn>.json, copied to a fresh state directory for every run
+    // -s start scn, default: the scn of the schema checkpoint
+    // -t owner.table to replicate, regular expressions as in the "filter" section, may repeat, default: every table
+    // -f output format json|protobuf, -F "flags" of the source, -m "max-mb" of the memory section
+    // -r number of runs, the run with the median time is reported as the result
+    // -p "lwn-prefetch" of the source, -p 0 against the default shows what prefetching the LWN members gains
+    // -C drop the redo logs from the page cache before every run, to measure a replay of archives which are not cached
+    // -X measure lookups of the transaction XID map with that many live XIDs instead of replaying redo logs, e.g. -X 100000
+    // -L measure the load of a SYS.COL$ with that many rows in the flat and in the node based storage instead of replaying redo logs, e.g. -L 1000000
+    // -j print the result as a single JSON line, to be attached to regression reports
+    BenchConfig config;
+    if (!parseArgs(argc, argv, config)) {
+        usage(ctx);
+        return 1;
+    }
+#ifndef LINK_LIBRARY_PROTOBUF
+    if (config.format == "protobuf") {
+        ctx.error(30001, "format: protobuf - not compiled");
+        return 1;
+    }
+#endif /* LINK_LIBRARY_PROTOBUF */
+
+    if (config.xidMapLive > 0) {
+        try {
+            const std::vector<XidMapResult> xidMapResults = runXidMap(config);
+            if (config.json)
+                printXidMapJson(config, xidMapResults);
+            else
+                printXidMapText(config, xidMapResults);
+        } catch (OpenLogReplicator::RuntimeException& ex) {
+            ctx.error(ex.code, ex.msg);
+            return 1;
+        }
+        return 0;
+    }
+
+    if (config.schemaLoadColumns > 0) {
+        try {
+            const std::vector<SchemaLoadResult> schemaLoadResults = runSchemaLoad(config);
+            if (config.json)
+                printSchemaLoadJson(config, schemaLoadResults);
+            else
+                printSchemaLoadText(config, schemaLoadResults);
+        } catch (OpenLogReplicator::DataException& ex) {
+            ctx.error(ex.code, ex.msg);
+            return 1;
+        } catch (OpenLogReplicator::RuntimeException& ex) {
+            ctx.error(ex.code, ex.msg);
+            return 1;
+        }
+        return 0;
+    }
+
+    OpenLogReplicator::IntX::initializeBASE10();
+    std::vector<BenchResult> results;
+    try {
+        for (uint64_t run = 1; run <= config.runs; ++run) {
+            results.push_back(runOnce(config, OpenLogReplicator::Ctx::LOG::WARNING));
+            if (!config.json)
+                printText(results.back(), "run " + std::to_string(run) + "/" + std::to_string(config.runs));
+            if (results.back().failed)
+                break;
+        }
+    } catch (OpenLogReplicator::ConfigurationException& ex) {
+        ctx.error(ex.code, ex.msg);
+        return 1;
+    } catch (OpenLogReplicator::DataException& ex) {
+        ctx.error(ex.code, ex.msg);
+        return 1;
+    } catch (OpenLogReplicator::RuntimeException& ex) {
+        ctx.error(ex.code, ex.msg);
+        return 1;
+    }
+
+    std::vector<BenchResult> sorted(results);
+    std::sort(sorted.begin(), sorted.end(), [](const BenchResult& result1, const BenchResult& result2) {
+        return result1.seconds < result2.seconds;
+    });
+    const BenchResult& median = sorted[sorted.size() / 2];
+    if (config.json)
+        printJson(config, median);
+    else if (sorted.size() > 1)
+        printText(median, "median");
+
+    return results.back().failed ? 1 : 0;
+}
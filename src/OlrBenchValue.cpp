@@ -0,0 +1,850 @@
+/* Micro-benchmark of column value encoding in the builders
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <rapidjson/document.h>
+#include <rapidjson/error/en.h>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <unistd.h>
+#include <vector>
+
+#include "builder/BuilderJson.h"
+#include "common/Ctx.h"
+#include "common/DbColumn.h"
+#include "common/DbTable.h"
+#include "common/Format.h"
+#include "common/Thread.h"
+#include "common/XmlCtx.h"
+#include "common/exception/ConfigurationException.h"
+#include "common/exception/DataException.h"
+#include "common/exception/RuntimeException.h"
+#include "common/table/SysCol.h"
+#include "common/types/Data.h"
+#include "common/types/IntX.h"
+#include "locales/Locales.h"
+#include "metadata/Metadata.h"
+
+#ifdef LINK_LIBRARY_PROTOBUF
+#include "builder/BuilderProtobuf.h"
+#endif /* LINK_LIBRARY_PROTOBUF */
+
+namespace OpenLogReplicator {
+    // Calls Builder::processValue() in a loop on a message which is never committed, the output position is rewound after every value
+    class BuilderBench final {
+    public:
+        // Number kernels of BuilderJson, DIGITS - the digit at a time formatting they replaced, kept as the reference
+        enum class NUMBER : unsigned char {
+            DEC, DEC_DIGITS, SDEC, HEX8, HEX16, HEX16_DIGITS
+        };
+
+    protected:
+        static constexpr uint64_t BATCH{1024};
+
+        Builder* builder;
+        const DbTable* table;
+
+        void begin() {
+            builder->builderBegin(Scn(1), Seq(1), table->obj, BuilderMsg::OUTPUT_BUFFER::NONE);
+#ifdef LINK_LIBRARY_PROTOBUF
+            if (builder->isProtobuf()) {
+                // The same value message is filled again and again, adding a value to the repeated field is not part of processValue()
+                auto* builderProtobuf = dynamic_cast<BuilderProtobuf*>(builder);
+                builderProtobuf->createResponse();
+                builderProtobuf->payloadPB = builderProtobuf->redoResponsePB->add_payload();
+                builderProtobuf->valuePB = builderProtobuf->payloadPB->add_after();
+            }
+#endif /* LINK_LIBRARY_PROTOBUF */
+        }
+
+        void end() {
+#ifdef LINK_LIBRARY_PROTOBUF
+            if (builder->isProtobuf()) {
+                auto* builderProtobuf = dynamic_cast<BuilderProtobuf*>(builder);
+                builderProtobuf->valuePB = nullptr;
+                builderProtobuf->payloadPB = nullptr;
+                builderProtobuf->redoResponsePB = nullptr;
+                builderProtobuf->arena.Reset();
+            }
+#endif /* LINK_LIBRARY_PROTOBUF */
+            builder->messagePosition = 0;
+            builder->messageSize = 0;
+            builder->msg = nullptr;
+        }
+
+        static void appendDecDigits(BuilderJson* builderJson, uint64_t value) {
+            char buffer[21];
+            uint size = 0;
+            do {
+                buffer[size++] = Data::map10(value % 10);
+                value /= 10;
+            } while (value > 0);
+
+            uint8_t* ptr = builderJson->lastBuilderQueue->data + builderJson->lastBuilderSize + builderJson->messagePosition;
+            for (uint i = 0; i < size; ++i)
+                *ptr++ = buffer[size - i - 1];
+            builderJson->messagePosition += size;
+        }
+
+        static void appendHex16Digits(BuilderJson* builderJson, uint64_t value) {
+            uint8_t* ptr = builderJson->lastBuilderQueue->data + builderJson->lastBuilderSize + builderJson->messagePosition;
+            for (int shift = 60; shift >= 0; shift -= 4)
+                *ptr++ = Data::map16((value >> shift) & 0xF);
+            builderJson->messagePosition += 16;
+        }
+
+        template<NUMBER number>
+        static void appendNumbers(BuilderJson* builderJson, const std::vector<uint64_t>& values, uint64_t position) {
+            for (const uint64_t value: values) {
+                if constexpr (number == NUMBER::DEC)
+                    builderJson->appendDec(value);
+                else if constexpr (number == NUMBER::DEC_DIGITS)
+                    appendDecDigits(builderJson, value);
+                else if constexpr (number == NUMBER::SDEC)
+                    builderJson->appendSDec(static_cast<int64_t>(value));
+                else if constexpr (number == NUMBER::HEX8)
+                    builderJson->appendHex8(static_cast<uint32_t>(value));
+                else if constexpr (number == NUMBER::HEX16)
+                    builderJson->appendHex16(value);
+                else
+                    appendHex16Digits(builderJson, value);
+                builderJson->messagePosition = position;
+            }
+        }
+
+        static void appendNumbers(NUMBER number, BuilderJson* builderJson, const std::vector<uint64_t>& values, uint64_t position) {
+            switch (number) {
+                case NUMBER::DEC:
+                    appendNumbers<NUMBER::DEC>(builderJson, values, position);
+                    break;
+                case NUMBER::DEC_DIGITS:
+                    appendNumbers<NUMBER::DEC_DIGITS>(builderJson, values, position);
+                    break;
+                case NUMBER::SDEC:
+                    appendNumbers<NUMBER::SDEC>(builderJson, values, position);
+                    break;
+                case NUMBER::HEX8:
+                    appendNumbers<NUMBER::HEX8>(builderJson, values, position);
+                    break;
+                case NUMBER::HEX16:
+                    appendNumbers<NUMBER::HEX16>(builderJson, values, position);
+                    break;
+                case NUMBER::HEX16_DIGITS:
+                    appendNumbers<NUMBER::HEX16_DIGITS>(builderJson, values, position);
+                    break;
+            }
+        }
+
+    public:
+        BuilderBench(Builder* newBuilder, const DbTable* newTable) :
+                builder(newBuilder),
+                table(newTable) {
+        }
+
+        // Average time of one value in ns, measured for at least minUs
+        double measure(typeCol col, const std::vector<uint8_t>& data, uint64_t minUs) {
+            begin();
+            const uint64_t position = builder->messagePosition;
+            const auto size = static_cast<uint32_t>(data.size());
+
+            // Warm up the caches and the value buffer
+            for (uint64_t i = 0; i < BATCH; ++i) {
+                builder->processValue(nullptr, nullptr, table, col, data.data(), size, FileOffset(), true, false);
+                builder->messagePosition = position;
+            }
+
+            uint64_t values = 0;
+            const auto start = std::chrono::steady_clock::now();
+            std::chrono::steady_clock::duration elapsed{};
+            do {
+                for (uint64_t i = 0; i < BATCH; ++i) {
+                    builder->processValue(nullptr, nullptr, table, col, data.data(), size, FileOffset(), true, false);
+                    builder->messagePosition = position;
+                }
+                values += BATCH;
+                elapsed = std::chrono::steady_clock::now() - start;
+            } while (std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() < static_cast<int64_t>(minUs));
+
+            end();
+            return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / static_cast<double>(values);
+        }
+
+        // Average time of decoding one binary XML document in ns, the decoded text stays in the value buffer
+        double measureXml(const XmlCtx* xmlCtx, const std::string& name, const std::vector<uint8_t>& data, uint64_t minUs) {
+            if (!builder->parseXml(xmlCtx, data.data(), data.size(), FileOffset()))
+                throw RuntimeException(10095, "XML case: " + name + " can't be decoded");
+
+            for (uint64_t i = 0; i < BATCH; ++i)
+                static_cast<void>(builder->parseXml(xmlCtx, data.data(), data.size(), FileOffset()));
+
+            uint64_t values = 0;
+            const auto start = std::chrono::steady_clock::now();
+            std::chrono::steady_clock::duration elapsed{};
+            do {
+                for (uint64_t i = 0; i < BATCH; ++i)
+                    static_cast<void>(builder->parseXml(xmlCtx, data.data(), data.size(), FileOffset()));
+                values += BATCH;
+                elapsed = std::chrono::steady_clock::now() - start;
+            } while (std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() < static_cast<int64_t>(minUs));
+
+            return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / static_cast<double>(values);
+        }
+
+        // Average time of the "rid" tag of one row in ns, rowsPerBlock rows one after another come from the same block
+        double measureRowid(uint64_t rowsPerBlock, uint64_t minUs) {
+            auto* builderJson = dynamic_cast<BuilderJson*>(builder);
+            begin();
+            const uint64_t position = builder->messagePosition;
+
+            uint64_t row = 0;
+            for (uint64_t i = 0; i < BATCH; ++i, ++row) {
+                builderJson->appendRowid(74565, static_cast<typeDba>(0x01000080 + (row / rowsPerBlock)), static_cast<typeSlot>(row % rowsPerBlock));
+                builder->messagePosition = position;
+            }
+
+            uint64_t values = 0;
+            const auto start = std::chrono::steady_clock::now();
+            std::chrono::steady_clock::duration elapsed{};
+            do {
+                for (uint64_t i = 0; i < BATCH; ++i, ++row) {
+                    builderJson->appendRowid(74565, static_cast<typeDba>(0x01000080 + (row / rowsPerBlock)),
+                                             static_cast<typeSlot>(row % rowsPerBlock));
+                    builder->messagePosition = position;
+                }
+                values += BATCH;
+                elapsed = std::chrono::steady_clock::now() - start;
+            } while (std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() < static_cast<int64_t>(minUs));
+
+            end();
+            return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / static_cast<double>(values);
+        }
+
+        // Average time of formatting one number of the values in ns, as appendHeader() formats the scn, xid and timestamps
+        double measureNumber(NUMBER number, const std::vector<uint64_t>& values, uint64_t minUs) {
+            auto* builderJson = dynamic_cast<BuilderJson*>(builder);
+            begin();
+            const uint64_t position = builder->messagePosition;
+
+            appendNumbers(number, builderJson, values, position);
+
+            uint64_t count = 0;
+            const auto start = std::chrono::steady_clock::now();
+            std::chrono::steady_clock::duration elapsed{};
+            do {
+                appendNumbers(number, builderJson, values, position);
+                count += values.size();
+                elapsed = std::chrono::steady_clock::now() - start;
+            } while (std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() < static_cast<int64_t>(minUs));
+
+            end();
+            return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / static_cast<double>(count);
+        }
+
+        // Average time of rendering one timestamp of the stream in ns, cached - through the cache of the builder
+        double measureIso8601(bool cached, const std::string& name, const std::vector<time_t>& timestamps, uint64_t minUs) {
+            char buffer[32];
+            char expected[32];
+            uint64_t length = 0;
+            for (const time_t timestamp: timestamps) {
+                const uint64_t expectedLength = Data::epochToIso8601(timestamp, expected, true, true);
+                length = cached ? builder->epochToIso8601(timestamp, buffer, true, true) : Data::epochToIso8601(timestamp, buffer, true, true);
+                if (length != expectedLength || memcmp(buffer, expected, length) != 0)
+                    throw RuntimeException(10102, "timestamp case: " + name + " renders " + std::string(buffer, length) + " instead of " +
+                                                  std::string(expected, expectedLength));
+            }
+
+            uint64_t values = 0;
+            const auto start = std::chrono::steady_clock::now();
+            std::chrono::steady_clock::duration elapsed{};
+            do {
+                if (cached) {
+                    for (const time_t timestamp: timestamps)
+                        length += builder->epochToIso8601(timestamp, buffer, true, true);
+                } else {
+                    for (const time_t timestamp: timestamps)
+                        length += Data::epochToIso8601(timestamp, buffer, true, true);
+                }
+                values += timestamps.size();
+                elapsed = std::chrono::steady_clock::now() - start;
+            } while (std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() < static_cast<int64_t>(minUs));
+
+            // The lengths are used, so that the calls are not optimized away
+            if (length == 0)
+                throw RuntimeException(10102, "timestamp case: " + name + " renders nothing");
+            return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / static_cast<double>(values);
+        }
+    };
+}
+
+namespace {
+    const std::string DATABASE{"BENCH"};
+
+    struct BenchConfig {
+        std::vector<std::string> formats{"json", "protobuf"};
+        std::string formatJson{R"({"type":"json"})"};
+        std::string filter;
+        uint64_t minMs{200};
+        uint64_t runs{3};
+        bool json{false};
+    };
+
+    // One column of the benchmark table with a typical redo image of its value
+    struct ValueCase {
+        std::string name;
+        OpenLogReplicator::SysCol::COLTYPE type;
+        uint length;
+        int precision;
+        int scale;
+        uint64_t charsetId;
+        std::vector<uint8_t> data;
+    };
+
+    struct XmlCase {
+        std::string name;
+        std::vector<uint8_t> data;
+    };
+
+    // Row ids of rows clustered in blocks, a block of one row renders the whole row id every time
+    struct RowidCase {
+        std::string name;
+        uint64_t rowsPerBlock;
+    };
+
+    // Numbers as they come in the message headers, each case is formatted by the current kernel and the reference one
+    struct NumberCase {
+        std::string name;
+        OpenLogReplicator::BuilderBench::NUMBER number;
+        std::vector<uint64_t> values;
+    };
+
+    // Commit timestamps of consecutive rows, rendered with and without the ISO 8601 cache of the builder
+    struct TimestampCase {
+        std::string name;
+        bool cached;
+        std::vector<time_t> timestamps;
+    };
+
+    struct CaseResult {
+        std::string format;
+        std::string name;
+        uint64_t size;
+        double ns;
+    };
+
+    std::vector<uint8_t> bytes(const std::string& str) {
+        return {str.begin(), str.end()};
+    }
+
+    std::vector<ValueCase> valueCases() {
+        using OpenLogReplicator::SysCol;
+        return {
+                {"number-int", SysCol::COLTYPE::NUMBER, 22, 10, 0, 0, {0xC5, 0x02, 0x18, 0x2E, 0x44, 0x5A}},
+                {"number-frac", SysCol::COLTYPE::NUMBER, 22, -1, -1, 0, {0xC1, 0x04, 0x0F, 0x10, 0x5B}},
+                {"number-neg", SysCol::COLTYPE::NUMBER, 22, -1, -1, 0, {0x3E, 0x3B, 0x66}},
+                {"varchar-al32utf8-ascii", SysCol::COLTYPE::VARCHAR, 100, -1, -1, 873, bytes("The quick brown fox jumps over the lazy dog")},
+                {"varchar-al32utf8-multibyte", SysCol::COLTYPE::VARCHAR, 100, -1, -1, 873,
+                 bytes("Za\xC5\xBC\xC3\xB3\xC5\x82\xC4\x87 g\xC4\x99\xC5\x9Bl\xC4\x85 ja\xC5\xBA\xC5\x84 \xE4\xB8\xAD\xE6\x96\x87")},
+                {"varchar-we8mswin1252", SysCol::COLTYPE::VARCHAR, 100, -1, -1, 178, bytes("Caf\xE9 cr\xE8me br\xFBl\xE9\x65 \x80 5")},
+                {"varchar-zhs16gbk", SysCol::COLTYPE::VARCHAR, 100, -1, -1, 852, {0xD6, 0xD0, 0xCE, 0xC4, 0xD7, 0xD6, 0xB7, 0xFB, 0x41, 0x42}},
+                {"varchar-zhs32gb18030", SysCol::COLTYPE::VARCHAR, 100, -1, -1, 854,
+                 {0xD6, 0xD0, 0xCE, 0xC4, 0x81, 0x30, 0x81, 0x30, 0x84, 0x31, 0xA4, 0x39, 0x95, 0x32, 0x82, 0x36, 0x41, 0x42}},
+                {"varchar-zht32euc", SysCol::COLTYPE::VARCHAR, 100, -1, -1, 860,
+                 {0xA4, 0xA4, 0xA4, 0xE5, 0x8E, 0xA2, 0xA1, 0xA1, 0x8E, 0xA3, 0xA1, 0xA2, 0x41, 0x42}},
+                {"varchar-zht32tris", SysCol::COLTYPE::VARCHAR, 100, -1, -1, 863,
+                 {0x8E, 0xA1, 0xA4, 0xA4, 0x8E, 0xA1, 0xA4, 0xE5, 0x8E, 0xA2, 0xA1, 0xA1, 0x41, 0x42}},
+                {"varchar-al16utf16", SysCol::COLTYPE::VARCHAR, 100, -1, -1, 2000,
+                 {0x00, 0x48, 0x00, 0x65, 0x00, 0x6C, 0x00, 0x6C, 0x00, 0x6F, 0x00, 0x2C, 0x00, 0x20, 0x4E, 0x16, 0x75, 0x4C}},
+                {"char-al32utf8", SysCol::COLTYPE::CHAR, 20, -1, -1, 873, bytes("ABC                 ")},
+                {"date", SysCol::COLTYPE::DATE, 7, -1, -1, 0, {120, 124, 6, 15, 13, 35, 57}},
+                {"timestamp", SysCol::COLTYPE::TIMESTAMP, 11, -1, 9, 0, {120, 124, 6, 15, 13, 35, 57, 0x07, 0x5B, 0xCD, 0x15}},
+                {"timestamp-tz", SysCol::COLTYPE::TIMESTAMP_WITH_TZ, 13, -1, 9, 0, {120, 124, 6, 15, 11, 35, 57, 0x07, 0x5B, 0xCD, 0x15, 22, 60}},
+                {"timestamp-ltz", SysCol::COLTYPE::TIMESTAMP_WITH_LOCAL_TZ, 11, -1, 9, 0, {120, 124, 6, 15, 13, 35, 57, 0x07, 0x5B, 0xCD, 0x15}},
+                {"raw", SysCol::COLTYPE::RAW, 16, -1, -1, 0,
+                 {0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF, 0xFE, 0xDC, 0xBA, 0x98, 0x76, 0x54, 0x32, 0x10}},
+                {"interval-ym", SysCol::COLTYPE::INTERVAL_YEAR_TO_MONTH, 5, 2, 0, 0, {0x80, 0x00, 0x00, 0x03, 65}},
+                {"interval-ds", SysCol::COLTYPE::INTERVAL_DAY_TO_SECOND, 11, 2, 6, 0, {0x80, 0x00, 0x00, 0x02, 63, 64, 65, 0x9D, 0xCD, 0x65, 0x00}},
+                {"float", SysCol::COLTYPE::FLOAT, 4, -1, -1, 0, {0xBF, 0xC0, 0x00, 0x00}},
+                {"double", SysCol::COLTYPE::DOUBLE, 8, -1, -1, 0, {0xC0, 0x93, 0x4A, 0x45, 0x6D, 0x5C, 0xFA, 0xAD}}
+        };
+    }
+
+    std::vector<RowidCase> rowidCases() {
+        return {
+                {"rowid-same-block", 200},
+                {"rowid-block-of-8", 8},
+                {"rowid-new-block", 1}
+        };
+    }
+
+    std::vector<NumberCase> numberCases() {
+        using OpenLogReplicator::BuilderBench;
+        std::vector<uint64_t> scns;
+        std::vector<uint64_t> timestamps;
+        std::vector<uint64_t> small;
+        std::vector<uint64_t> signedValues;
+        std::vector<uint64_t> sequences;
+        uint64_t scn = 12345678901234;
+        uint64_t timestamp = 1712345678000000000;
+        uint64_t random = 0x2545F4914F6CDD1DULL;
+        for (uint64_t i = 0; i < 1024; ++i) {
+            random ^= random << 13;
+            random ^= random >> 7;
+            random ^= random << 17;
+            scn += random % 16;
+            timestamp += random % 1000000;
+            scns.push_back(scn);
+            timestamps.push_back(timestamp);
+            small.push_back(random % 1000);
+            signedValues.push_back(static_cast<uint64_t>(static_cast<int64_t>(random % 2000000000) - 1000000000));
+            sequences.push_back(random & 0xFFFFFFFF);
+        }
+
+        return {
+                {"dec-scn", BuilderBench::NUMBER::DEC, scns},
+                {"dec-scn-digits", BuilderBench::NUMBER::DEC_DIGITS, scns},
+                {"dec-timestamp", BuilderBench::NUMBER::DEC, timestamps},
+                {"dec-timestamp-digits", BuilderBench::NUMBER::DEC_DIGITS, timestamps},
+                {"dec-small", BuilderBench::NUMBER::DEC, small},
+                {"dec-small-digits", BuilderBench::NUMBER::DEC_DIGITS, small},
+                {"sdec-signed", BuilderBench::NUMBER::SDEC, signedValues},
+                {"hex8-sqn", BuilderBench::NUMBER::HEX8, sequences},
+                {"hex16-scn", BuilderBench::NUMBER::HEX16, scns},
+                {"hex16-scn-digits", BuilderBench::NUMBER::HEX16_DIGITS, scns}
+        };
+    }
+
+    std::vector<TimestampCase> timestampCases() {
+        std::vector<time_t> transaction;
+        std::vector<time_t> rows;
+        std::vector<time_t> sparse;
+        std::vector<time_t> days;
+        time_t row = 1712345678;
+        time_t spread = 1712345678;
+        time_t day = 1712345678;
+        uint64_t random = 0x2545F4914F6CDD1DULL;
+        for (uint64_t i = 0; i < 1024; ++i) {
+            random ^= random << 13;
+            random ^= random >> 7;
+            random ^= random << 17;
+            // A busy source: a few rows in every second
+            if (random % 4 == 0)
+                ++row;
+            spread += static_cast<time_t>(random % 600);
+            day += 86400 + static_cast<time_t>(random % 86400);
+            transaction.push_back(1712345678);
+            rows.push_back(row);
+            sparse.push_back(spread);
+            days.push_back(day);
+        }
+
+        return {
+                {"iso8601-same-second", true, transaction},
+                {"iso8601-same-second-uncached", false, transaction},
+                {"iso8601-busy", true, rows},
+                {"iso8601-busy-uncached", false, rows},
+                {"iso8601-sparse", true, sparse},
+                {"iso8601-sparse-uncached", false, sparse},
+                {"iso8601-new-day", true, days},
+                {"iso8601-new-day-uncached", false, days}
+        };
+    }
+
+    // Binary XML of the benchmark documents, names are the tokens added by xmlTokens()
+    class XmlWriter final {
+    protected:
+        std::vector<uint8_t> data{0x9F, 0x01, 0x00};
+
+        void push16(uint64_t value) {
+            data.push_back(static_cast<uint8_t>(value >> 8));
+            data.push_back(static_cast<uint8_t>(value));
+        }
+
+        void single(uint16_t code, const std::string& value) {
+            data.push_back(0xC1);
+            push16(value.length());
+            push16(code);
+            data.insert(data.end(), value.begin(), value.end());
+        }
+
+    public:
+        XmlWriter& nameSpace(uint16_t nmSpc, uint16_t dict, const std::string& prefix) {
+            data.push_back(0xB2);
+            data.push_back(static_cast<uint8_t>(prefix.length()));
+            push16(0);
+            push16(nmSpc);
+            push16(dict);
+            data.insert(data.end(), prefix.begin(), prefix.end());
+            return *this;
+        }
+
+        XmlWriter& xmlns(uint16_t dict) {
+            data.push_back(0xDD);
+            push16(dict);
+            return *this;
+        }
+
+        XmlWriter& open(uint16_t code) {
+            data.push_back(0xC8);
+            push16(code);
+            return *this;
+        }
+
+        XmlWriter& attribute(uint16_t code, const std::string& value) {
+            single(code, value);
+            return *this;
+        }
+
+        XmlWriter& element(uint16_t code, const std::string& value) {
+            single(code, value);
+            return *this;
+        }
+
+        XmlWriter& text(const std::string& value) {
+            for (uint64_t pos = 0; pos < value.length(); pos += 128) {
+                const uint64_t size = std::min<uint64_t>(128, value.length() - pos);
+                data.push_back(static_cast<uint8_t>(size - 1));
+                data.insert(data.end(), value.begin() + static_cast<int64_t>(pos), value.begin() + static_cast<int64_t>(pos + size));
+            }
+            return *this;
+        }
+
+        XmlWriter& close() {
+            data.push_back(0xD9);
+            return *this;
+        }
+
+        std::vector<uint8_t> finish() {
+            data.push_back(0xA0);
+            return data;
+        }
+    };
+
+    constexpr uint16_t XML_ORDER{0x10};
+    constexpr uint16_t XML_ID{0x11};
+    constexpr uint16_t XML_CUSTOMER{0x12};
+    constexpr uint16_t XML_ITEM{0x13};
+    constexpr uint16_t XML_SKU{0x14};
+    constexpr uint16_t XML_QUANTITY{0x15};
+    constexpr uint16_t XML_NOTE{0x16};
+    constexpr uint16_t XML_INVOICE{0x117};
+    constexpr uint16_t XML_NMSPC{0x20};
+
+    void xmlTokens(OpenLogReplicator::Ctx& ctx, OpenLogReplicator::XmlCtx* xmlCtx) {
+        using namespace OpenLogReplicator;
+        const std::vector<std::tuple<uint16_t, std::string, std::string, std::string>> tokens{
+                {XML_ORDER, "", "order", "0"}, {XML_ID, "", "id", "1"}, {XML_CUSTOMER, "", "customer", "0"}, {XML_ITEM, "", "item", "0"},
+                {XML_SKU, "", "sku", "1"}, {XML_QUANTITY, "", "quantity", "0"}, {XML_NOTE, "", "note", "0"}, {XML_INVOICE, "20", "invoice", "0"}};
+
+        typeSlot slot = 0;
+        for (const auto& [code, nmSpcId, localName, flags]: tokens) {
+            std::ostringstream ss;
+            ss << std::uppercase << std::hex << (code < 0x100 ? std::setw(2) : std::setw(4)) << std::setfill('0') << code;
+            xmlCtx->xdbXQnPack.addWithKeys(&ctx, new XdbXQn(RowId(1, 1, slot++), nmSpcId, localName, flags, ss.str()));
+        }
+        xmlCtx->xdbXNmPack.addWithKeys(&ctx, new XdbXNm(RowId(1, 2, 0), "urn:example:invoice", "20"));
+    }
+
+    std::vector<XmlCase> xmlCases() {
+        XmlWriter small;
+        small.open(XML_ORDER).attribute(XML_ID, "17").element(XML_CUSTOMER, "ACME Corporation").close();
+
+        XmlWriter items;
+        items.open(XML_ORDER).attribute(XML_ID, "18").element(XML_CUSTOMER, "ACME Corporation");
+        for (uint64_t i = 0; i < 50; ++i)
+            items.open(XML_ITEM).attribute(XML_SKU, "SKU-" + std::to_string(1000 + i)).element(XML_QUANTITY, std::to_string(i + 1)).close();
+        items.close();
+
+        XmlWriter text;
+        std::string note;
+        for (uint64_t i = 0; i < 64; ++i)
+            note += "The quick brown fox jumps over the lazy dog. ";
+        text.open(XML_ORDER).attribute(XML_ID, "19").open(XML_NOTE).text(note).close().close();
+
+        XmlWriter nameSpace;
+        nameSpace.nameSpace(XML_NMSPC, 1, "inv").open(XML_INVOICE).xmlns(1).element(XML_CUSTOMER, "ACME Corporation").close();
+
+        return {{"xml-small", small.finish()}, {"xml-items", items.finish()}, {"xml-text", text.finish()}, {"xml-namespace", nameSpace.finish()}};
+    }
+
+    // Bench thread stands in for the parser thread the builder reports its context to
+    class BenchThread final : public OpenLogReplicator::Thread {
+    protected:
+        void run() override {
+        }
+
+    public:
+        explicit BenchThread(OpenLogReplicator::Ctx* newCtx) :
+                Thread(newCtx, "bench") {
+        }
+
+        [[nodiscard]] std::string getName() const override {
+            return {"BenchThread"};
+        }
+    };
+
+    void usage(const OpenLogReplicator::Ctx& ctx) {
+        ctx.info(0, "use: olr-bench-value [-f json|protobuf]... [-o <format json>] [-k <case>] [-t <min ms>] [-r <runs>] [-j]");
+    }
+
+    bool parseArgs(int argc, char** argv, BenchConfig& config) {
+        int opt;
+        bool formatSet = false;
+        while ((opt = getopt(argc, argv, "f:o:k:t:r:j")) != -1) {
+            switch (opt) {
+                case 'f':
+                    if (!formatSet)
+                        config.formats.clear();
+                    formatSet = true;
+                    config.formats.emplace_back(optarg);
+                    if (config.formats.back() != "json" && config.formats.back() != "protobuf")
+                        return false;
+                    break;
+                case 'o':
+                    config.formatJson = optarg;
+                    break;
+                case 'k':
+                    config.filter = optarg;
+                    break;
+                case 't':
+                    config.minMs = strtoull(optarg, nullptr, 10);
+                    break;
+                case 'r':
+                    config.runs = strtoull(optarg, nullptr, 10);
+                    break;
+                case 'j':
+                    config.json = true;
+                    break;
+                default:
+                    return false;
+            }
+        }
+
+        return optind == argc && config.minMs > 0 && config.runs > 0;
+    }
+
+    std::vector<CaseResult> runFormat(OpenLogReplicator::Ctx& ctx, OpenLogReplicator::Locales* locales, OpenLogReplicator::Metadata* metadata,
+                                      const BenchConfig& config, const std::string& formatName, const std::vector<ValueCase>& cases,
+                                      const OpenLogReplicator::XmlCtx* xmlCtx, const std::vector<XmlCase>& xmlCaseList) {
+        using namespace OpenLogReplicator;
+
+        rapidjson::Document formatJson;
+        if (formatJson.Parse(config.formatJson.c_str()).HasParseError())
+            throw ConfigurationException(30001, "format: " + config.formatJson + " - parse error: " + GetParseError_En(formatJson.GetParseError()));
+        Format format = Format::parseJson(&ctx, "-o", formatJson);
+
+        Builder* builder;
+#ifdef LINK_LIBRARY_PROTOBUF
+        if (formatName == "protobuf")
+            builder = new BuilderProtobuf(&ctx, locales, metadata, format, 1048576);
+        else
+#endif /* LINK_LIBRARY_PROTOBUF */
+        builder = new BuilderJson(&ctx, locales, metadata, format, 1048576);
+        builder->initialize();
+
+        auto* table = new DbTable(1, 1, 1, 0, DbTable::OPTIONS::DEFAULT, DATABASE, "VALUES");
+        for (uint64_t i = 0; i < cases.size(); ++i) {
+            const ValueCase& valueCase = cases[i];
+            std::string name(valueCase.name);
+            std::transform(name.begin(), name.end(), name.begin(), [](char c) {
+                return c == '-' ? '_' : static_cast<char>(toupper(c));
+            });
+            table->addColumn(new DbColumn(static_cast<typeCol>(i), 0, static_cast<typeCol>(i + 1), name, valueCase.type, valueCase.length,
+                                          valueCase.precision, valueCase.scale, valueCase.charsetId, 0, true, false, false, false, false, false,
+                                          false, false, false));
+        }
+        table->buildJsonFragments();
+
+        std::vector<CaseResult> results;
+        BuilderBench bench(builder, table);
+        for (uint64_t i = 0; i < cases.size(); ++i) {
+            if (!config.filter.empty() && cases[i].name.find(config.filter) == std::string::npos)
+                continue;
+
+            std::vector<double> runs;
+            for (uint64_t run = 0; run < config.runs; ++run)
+                runs.push_back(bench.measure(static_cast<typeCol>(i), cases[i].data, config.minMs * 1000 / config.runs + 1));
+            std::sort(runs.begin(), runs.end());
+            results.push_back({formatName, cases[i].name, cases[i].data.size(), runs[runs.size() / 2]});
+        }
+
+        for (const XmlCase& xmlCase: xmlCaseList) {
+            if (!config.filter.empty() && xmlCase.name.find(config.filter) == std::string::npos)
+                continue;
+
+            std::vector<double> runs;
+            for (uint64_t run = 0; run < config.runs; ++run)
+                runs.push_back(bench.measureXml(xmlCtx, xmlCase.name, xmlCase.data, config.minMs * 1000 / config.runs + 1));
+            std::sort(runs.begin(), runs.end());
+            results.push_back({formatName, xmlCase.name, xmlCase.data.size(), runs[runs.size() / 2]});
+        }
+
+        for (const TimestampCase& timestampCase: timestampCases()) {
+            if (!config.filter.empty() && timestampCase.name.find(config.filter) == std::string::npos)
+                continue;
+
+            std::vector<double> runs;
+            for (uint64_t run = 0; run < config.runs; ++run)
+                runs.push_back(bench.measureIso8601(timestampCase.cached, timestampCase.name, timestampCase.timestamps,
+                                                    config.minMs * 1000 / config.runs + 1));
+            std::sort(runs.begin(), runs.end());
+            results.push_back({formatName, timestampCase.name, sizeof(time_t), runs[runs.size() / 2]});
+        }
+
+        // The number kernels are those of the JSON builder
+        if (formatName == "json") {
+            for (const NumberCase& numberCase: numberCases()) {
+                if (!config.filter.empty() && numberCase.name.find(config.filter) == std::string::npos)
+                    continue;
+
+                std::vector<double> runs;
+                for (uint64_t run = 0; run < config.runs; ++run)
+                    runs.push_back(bench.measureNumber(numberCase.number, numberCase.values, config.minMs * 1000 / config.runs + 1));
+                std::sort(runs.begin(), runs.end());
+                results.push_back({formatName, numberCase.name, sizeof(uint64_t), runs[runs.size() / 2]});
+            }
+        }
+
+        // The "rid" tag is written only by the JSON builder and only with the option set, the cases get a builder of their own with it
+        if (formatName == "json") {
+            if (!formatJson.HasMember("rid"))
+                formatJson.AddMember("rid", 1, formatJson.GetAllocator());
+            else
+                formatJson["rid"].SetUint(1);
+            Format ridFormat = Format::parseJson(&ctx, "-o", formatJson);
+            auto* ridBuilder = new BuilderJson(&ctx, locales, metadata, ridFormat, 1048576);
+            ridBuilder->initialize();
+
+            BuilderBench ridBench(ridBuilder, table);
+            for (const RowidCase& rowidCase: rowidCases()) {
+                if (!config.filter.empty() && rowidCase.name.find(config.filter) == std::string::npos)
+                    continue;
+
+                std::vector<double> runs;
+                for (uint64_t run = 0; run < config.runs; ++run)
+                    runs.push_back(ridBench.measureRowid(rowidCase.rowsPerBlock, config.minMs * 1000 / config.runs + 1));
+                std::sort(runs.begin(), runs.end());
+                results.push_back({formatName, rowidCase.name, RowId::SIZE, runs[runs.size() / 2]});
+            }
+            delete ridBuilder;
+        }
+
+        delete table;
+        delete builder;
+        return results;
+    }
+
+    void printText(const std::vector<CaseResult>& results) {
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(1);
+        for (const CaseResult& result: results)
+            ss << std::left << std::setw(10) << result.format << std::setw(28) << result.name << std::right << std::setw(4) << result.size << " B " <<
+               std::setw(10) << result.ns << " ns/value " << std::setw(10) << (result.ns > 0 ? 1000 / result.ns : 0) << " M values/s\n";
+        std::cout << ss.str() << std::flush;
+    }
+
+    void printJson(const BenchConfig& config, const std::vector<CaseResult>& results) {
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(2);
+        ss << R"({"version":")" << OpenLogReplicator_VERSION_MAJOR << "." << OpenLogReplicator_VERSION_MINOR << "." <<
+           OpenLogReplicator_VERSION_PATCH << R"(","build-type":")" << OpenLogReplicator_CMAKE_BUILD_TYPE << R"(","arch":")" <<
+           OpenLogReplicator_CPU_ARCH << R"(","min-ms":)" << config.minMs << R"(,"runs":)" << config.runs << R"(,"values":[)";
+        for (uint64_t i = 0; i < results.size(); ++i)
+            ss << (i > 0 ? "," : "") << R"({"format":")" << results[i].format << R"(","case":")" << results[i].name << R"(","size":)" <<
+               results[i].size << R"(,"ns":)" << results[i].ns << "}";
+        ss << "]}\n";
+        std::cout << ss.str() << std::flush;
+    }
+}
+
+int main(int argc, char** argv) {
+    OpenLogReplicator::Ctx ctx;
+    ctx.welcome("OpenLogReplicator v." + std::to_string(OpenLogReplicator_VERSION_MAJOR) + "." +
+                std::to_string(OpenLogReplicator_VERSION_MINOR) + "." + std::to_string(OpenLogReplicator_VERSION_PATCH) +
+                " olr-bench-value (C) 2018-2025 by Adam Leszczynski (aleszczynski@bersler.com), see LICENSE file for licensing information");
+
+    // Run arguments:
+    // -f builder to measure json|protobuf, may repeat, default: both
+    // -o content of the "format" section, e.g. {"type":"json","timestamp":4}, default: {"type":"json"}
+    // -k measure only the cases with the name containing this text, e.g. varchar
+    // -t minimal time of a case in ms, split between the runs
+    // -r number of runs of every case, the median is reported
+    // -j print the result as a single JSON line, to be attached to regression reports
+    BenchConfig config;
+    if (!parseArgs(argc, argv, config)) {
+        usage(ctx);
+        return 1;
+    }
+#ifndef LINK_LIBRARY_PROTOBUF
+    config.formats.erase(std::remove(config.formats.begin(), config.formats.end(), "protobuf"), config.formats.end());
+    if (config.formats.empty()) {
+        ctx.error(30001, "format: protobuf - not compiled");
+        return 1;
+    }
+#endif /* LINK_LIBRARY_PROTOBUF */
+
+    OpenLogReplicator::IntX::initializeBASE10();
+    ctx.logLevel = OpenLogReplicator::Ctx::LOG::WARNING;
+    ctx.initialize(OpenLogReplicator::Ctx::MEMORY_CHUNK_MIN_MB, OpenLogReplicator::Ctx::MEMORY_CHUNK_MIN_MB * 4, OpenLogReplicator::Ctx::MEMORY_CHUNK_MIN_MB,
+                   4, 0, 4, OpenLogReplicator::Ctx::MEMORY_CHUNK_MIN_MB, 4);
+    BenchThread thread(&ctx);
+    ctx.parserThread = &thread;
+
+    auto* locales = new OpenLogReplicator::Locales();
+    locales->initialize();
+    auto* metadata = new OpenLogReplicator::Metadata(&ctx, locales, DATABASE, -1, OpenLogReplicator::Scn::none(), OpenLogReplicator::Seq::none(), "", 0);
+    auto* xmlCtx = new OpenLogReplicator::XmlCtx(&ctx, "", 0);
+
+    std::vector<CaseResult> results;
+    int ret = 0;
+    try {
+        const std::vector<ValueCase> cases = valueCases();
+        const std::vector<XmlCase> xmlCaseList = xmlCases();
+        xmlTokens(ctx, xmlCtx);
+        for (const std::string& format: config.formats) {
+            std::vector<CaseResult> formatResults = runFormat(ctx, locales, metadata, config, format, cases, xmlCtx, xmlCaseList);
+            results.insert(results.end(), formatResults.begin(), formatResults.end());
+        }
+
+        if (config.json)
+            printJson(config, results);
+        else
+            printText(results);
+    } catch (OpenLogReplicator::ConfigurationException& ex) {
+        ctx.error(ex.code, ex.msg);
+        ret = 1;
+    } catch (OpenLogReplicator::DataException& ex) {
+        ctx.error(ex.code, ex.msg);
+        ret = 1;
+    } catch (OpenLogReplicator::RuntimeException& ex) {
+        ctx.error(ex.code, ex.msg);
+        ret = 1;
+    }
+
+    delete xmlCtx;
+    delete metadata;
+    delete locales;
+    ctx.parserThread = nullptr;
+    return ret;
+}
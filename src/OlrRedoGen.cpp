@@ -0,0 +1,892 @@
+/* Generator of synthetic archived redo logs for scaling tests
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include "common/Ctx.h"
+#include "common/RedoLogRecord.h"
+#include "common/exception/ConfigurationException.h"
+#include "common/exception/DataException.h"
+#include "common/exception/RuntimeException.h"
+#include "common/table/SysCol.h"
+#include "common/types/RowId.h"
+#include "common/types/Scn.h"
+#include "parser/OpCode.h"
+
+namespace {
+    using OpenLogReplicator::Ctx;
+    using OpenLogReplicator::RedoLogRecord;
+    using OpenLogReplicator::RowId;
+    using OpenLogReplicator::Scn;
+    using OpenLogReplicator::SysCol;
+
+    // Identity of the generated database, the schema checkpoint carries the same values
+    constexpr uint32_t COMPAT_VSN{RedoLogRecord::REDO_VERSION_19_0};
+    constexpr uint32_t DBID{1357924680};
+    constexpr uint32_t RESETLOGS{1100000000};
+    constexpr uint32_t ACTIVATION{1200000000};
+    constexpr uint16_t THREAD{1};
+    constexpr uint64_t SCN_START{1000000};
+    constexpr time_t EPOCH_START{1735689600};
+    constexpr uint64_t LWNS_PER_SECOND{100};
+    constexpr uint32_t USER_ID{200};
+    constexpr uint32_t TS_ID{4};
+    constexpr typeObj OBJ_START{100000};
+    constexpr uint32_t UNDO_AFN{3};
+    constexpr uint32_t DATA_AFN{4};
+    constexpr typeSlot ROWS_PER_BLOCK{100};
+    const std::string LOG_ARCHIVE_FORMAT{"%t_%s_%r.dbf"};
+
+    // Redo layout, as decoded by Reader, Parser and the OpCode* classes
+    constexpr uint BLOCK_HEADER_SIZE{16};
+    constexpr uint RECORD_HEADER_SIZE{24};
+    constexpr uint RECORD_HEADER_LWN_SIZE{68};
+    constexpr uint VECTOR_HEADER_SIZE{32};
+    constexpr uint8_t VLD_RECORD{0x01};
+    constexpr uint8_t VLD_LWN{0x05};
+    constexpr uint8_t KTBOP_Z{0x03};
+    constexpr uint8_t KDO_FLAGS_XA{0x01};
+    constexpr uint8_t FB_ROW{RedoLogRecord::FB_H | RedoLogRecord::FB_F | RedoLogRecord::FB_L};
+    // Every (usn, slot) pair identifies at most one open transaction
+    constexpr uint16_t USN_COUNT{64};
+    constexpr uint16_t SLT_COUNT{256};
+
+    struct GenConfig {
+        std::string database{"GEN"};
+        std::string owner{"GEN"};
+        std::string outputDir{"."};
+        std::string columns{"n,v32,d"};
+        uint64_t tables{4};
+        uint64_t transactions{100000};
+        uint64_t opsMin{1};
+        uint64_t opsMax{10};
+        uint64_t concurrency{16};
+        uint64_t mix[3]{60, 30, 10};
+        uint64_t fileSizeMb{64};
+        uint blockSize{512};
+        uint64_t lwnRecords{64};
+        uint64_t seed{1};
+    };
+
+    struct GenColumn {
+        std::string name;
+        SysCol::COLTYPE type;
+        uint length;
+    };
+
+    struct GenRow {
+        typeDba bdba;
+        typeSlot slot;
+        std::vector<std::string> values;
+    };
+
+    struct GenTable {
+        std::string name;
+        typeObj obj;
+        typeDataObj dataObj;
+        typeDba bdba;
+        typeSlot slot{0};
+        std::vector<GenRow> rows;
+    };
+
+    struct GenTransaction {
+        uint16_t usn;
+        uint16_t slt;
+        uint32_t sqn;
+        uint64_t opsLeft;
+        uint16_t undoSeq{0};
+        bool begun{false};
+    };
+
+    void usage(const Ctx& ctx) {
+        ctx.info(0, "use: olr-redogen [-n <database>] [-u <owner>] [-o <output directory>] [-T <tables>] [-C <columns>] [-x <transactions>] "
+                    "[-r <ops>[:<ops max>]] [-c <concurrency>] [-m <insert>:<update>:<delete>] [-S <file size mb>] [-b 512|1024|4096] "
+                    "[-l <records per lwn>] [-s <seed>]");
+    }
+
+    bool validName(const std::string& name, uint64_t maxLength) {
+        if (name.empty() || name.length() > maxLength)
+            return false;
+        return std::all_of(name.begin(), name.end(), [](char c) {
+            return (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+        });
+    }
+
+    bool parseRange(const std::string& value, uint64_t& min, uint64_t& max) {
+        const size_t colon = value.find(':');
+        min = strtoull(value.c_str(), nullptr, 10);
+        max = colon == std::string::npos ? min : strtoull(value.c_str() + colon + 1, nullptr, 10);
+        return min > 0 && max >= min;
+    }
+
+    bool parseMix(const std::string& value, uint64_t* mix) {
+        std::istringstream ss(value);
+        std::string part;
+        uint count = 0;
+        while (std::getline(ss, part, ':')) {
+            if (count == 3 || part.empty() || part.find_first_not_of("0123456789") != std::string::npos)
+                return false;
+            mix[count++] = strtoull(part.c_str(), nullptr, 10);
+        }
+        return count == 3 && mix[0] > 0;
+    }
+
+    bool parseArgs(int argc, char** argv, GenConfig& config) {
+        int opt;
+        while ((opt = getopt(argc, argv, "n:u:o:T:C:x:r:c:m:S:b:l:s:")) != -1) {
+            switch (opt) {
+                case 'n':
+                    config.database = optarg;
+                    break;
+                case 'u':
+                    config.owner = optarg;
+                    break;
+                case 'o':
+                    config.outputDir = optarg;
+                    break;
+                case 'T':
+                    config.tables = strtoull(optarg, nullptr, 10);
+                    break;
+                case 'C':
+                    config.columns = optarg;
+                    break;
+                case 'x':
+                    config.transactions = strtoull(optarg, nullptr, 10);
+                    break;
+                case 'r':
+                    if (!parseRange(optarg, config.opsMin, config.opsMax))
+                        return false;
+                    break;
+                case 'c':
+                    config.concurrency = strtoull(optarg, nullptr, 10);
+                    break;
+                case 'm':
+                    if (!parseMix(optarg, config.mix))
+                        return false;
+                    break;
+                case 'S':
+                    config.fileSizeMb = strtoull(optarg, nullptr, 10);
+                    break;
+                case 'b':
+                    config.blockSize = static_cast<uint>(strtoul(optarg, nullptr, 10));
+                    break;
+                case 'l':
+                    config.lwnRecords = strtoull(optarg, nullptr, 10);
+                    break;
+                case 's':
+                    config.seed = strtoull(optarg, nullptr, 10);
+                    break;
+                default:
+                    return false;
+            }
+        }
+
+        return optind == argc && validName(config.database, 8) && validName(config.owner, 128) && config.tables > 0 && config.transactions > 0 &&
+               config.concurrency > 0 && config.concurrency <= static_cast<uint64_t>(USN_COUNT) * SLT_COUNT && config.fileSizeMb > 0 &&
+               (config.blockSize == 512 || config.blockSize == 1024 || config.blockSize == 4096) && config.lwnRecords > 0;
+    }
+
+    // Column list: n - NUMBER, v<length> - VARCHAR2, d - DATE, r<length> - RAW
+    std::vector<GenColumn> parseColumns(const std::string& spec) {
+        std::vector<GenColumn> columns;
+        std::istringstream ss(spec);
+        std::string part;
+        while (std::getline(ss, part, ',')) {
+            if (part.empty() || (part.length() > 1 && part.find_first_not_of("0123456789", 1) != std::string::npos))
+                throw OpenLogReplicator::ConfigurationException(30001, "columns: " + spec + " - invalid column: " + part);
+
+            const uint length = part.length() > 1 ? static_cast<uint>(strtoul(part.c_str() + 1, nullptr, 10)) : 0;
+            const std::string name = "C" + std::to_string(columns.size() + 1);
+            switch (part[0]) {
+                case 'n':
+                    columns.push_back({name, SysCol::COLTYPE::NUMBER, 22});
+                    break;
+                case 'v':
+                    columns.push_back({name, SysCol::COLTYPE::VARCHAR, length > 0 ? length : 32});
+                    break;
+                case 'd':
+                    columns.push_back({name, SysCol::COLTYPE::DATE, 7});
+                    break;
+                case 'r':
+                    columns.push_back({name, SysCol::COLTYPE::RAW, length > 0 ? length : 16});
+                    break;
+                default:
+                    throw OpenLogReplicator::ConfigurationException(30001, "columns: " + spec + " - invalid column type: " + part);
+            }
+            if (columns.back().length > 4000)
+                throw OpenLogReplicator::ConfigurationException(30001, "columns: " + spec + " - too long column: " + part);
+        }
+
+        if (columns.empty() || columns.size() > 250)
+            throw OpenLogReplicator::ConfigurationException(30001, "columns: " + spec + " - expected 1 to 250 columns");
+        return columns;
+    }
+
+    // Oracle redo time: seconds since 1988 with 31 days in every month
+    uint32_t redoTime(time_t epoch) {
+        struct tm tm{};
+        gmtime_r(&epoch, &tm);
+        return static_cast<uint32_t>((((((static_cast<uint64_t>(tm.tm_year + 1900 - 1988) * 12 + tm.tm_mon) * 31 + tm.tm_mday - 1) * 24 +
+                                        tm.tm_hour) * 60 + tm.tm_min) * 60) + tm.tm_sec);
+    }
+
+    class RedoGenerator final {
+    protected:
+        const Ctx& ctx;
+        const GenConfig& config;
+        std::mt19937_64 random;
+        std::vector<GenColumn> columns;
+        std::vector<GenTable> tables;
+        std::vector<GenTransaction> openTransactions;
+        std::deque<uint32_t> freeXids;
+        uint64_t began{0};
+        uint64_t committed{0};
+        uint64_t ops[3]{};
+        uint32_t nextSqn{1};
+
+        // Redo log being written
+        std::vector<uint8_t> file;
+        uint32_t sequence{0};
+        Scn firstScn;
+        uint32_t firstTime{0};
+        typeBlk block{0};
+        uint blockOffset{0};
+        uint64_t files{0};
+        uint64_t bytes{0};
+
+        // LWN being written
+        bool lwnOpen{false};
+        uint64_t lwnCount{0};
+        uint64_t lwnRecordCount{0};
+        typeBlk lwnBlock{0};
+        Scn scn{SCN_START};
+        uint16_t subScn{0};
+        uint32_t lwnTime{0};
+
+        uint64_t next(uint64_t range) {
+            return random() % range;
+        }
+
+        static void put(std::string& field, uint pos, uint8_t val) {
+            field[pos] = static_cast<char>(val);
+        }
+
+        void put16(std::string& field, uint pos, uint16_t val) const {
+            ctx.write16(reinterpret_cast<uint8_t*>(field.data()) + pos, val);
+        }
+
+        void put32(std::string& field, uint pos, uint32_t val) const {
+            ctx.write32(reinterpret_cast<uint8_t*>(field.data()) + pos, val);
+        }
+
+        static std::string numberValue(uint64_t value) {
+            if (value == 0)
+                return {static_cast<char>(0x80)};
+
+            std::vector<uint8_t> digits;
+            while (value > 0) {
+                digits.push_back(value % 100);
+                value /= 100;
+            }
+            std::string data(1, static_cast<char>(0xC0 + digits.size()));
+            uint64_t last = 0;
+            while (digits[last] == 0)
+                ++last;
+            for (uint64_t i = digits.size(); i > last; --i)
+                data.push_back(static_cast<char>(digits[i - 1] + 1));
+            return data;
+        }
+
+        std::string columnValue(const GenColumn& column) {
+            switch (column.type) {
+                case SysCol::COLTYPE::NUMBER:
+                    return numberValue(next(1000000000));
+
+                case SysCol::COLTYPE::DATE: {
+                    const uint64_t year = 2000 + next(31);
+                    return {static_cast<char>(year / 100 + 100), static_cast<char>(year % 100 + 100), static_cast<char>(1 + next(12)),
+                            static_cast<char>(1 + next(28)), static_cast<char>(1 + next(24)), static_cast<char>(1 + next(60)),
+                            static_cast<char>(1 + next(60))};
+                }
+
+                case SysCol::COLTYPE::RAW: {
+                    std::string data(column.length, 0);
+                    for (char& c: data)
+                        c = static_cast<char>(next(256));
+                    return data;
+                }
+
+                default: {
+                    std::string data(1 + next(column.length), 0);
+                    for (char& c: data)
+                        c = static_cast<char>('A' + next(26));
+                    return data;
+                }
+            }
+        }
+
+        // Size of the row in the block, only has to differ from the size of the first column
+        static uint16_t rowSize(const std::vector<std::string>& values) {
+            uint64_t size = 3;
+            for (const std::string& value: values)
+                size += value.length() + (value.length() > 250 ? 3 : 1);
+            return static_cast<uint16_t>(std::min<uint64_t>(size, 0xFFFF));
+        }
+
+        // Vector header and field list as decoded by Parser::decodeVector for 12.1+
+        void appendVector(std::vector<uint8_t>& record, uint8_t layer, uint8_t code, uint16_t cls, uint32_t afn, typeDba dba,
+                          const std::vector<std::string>& fields) const {
+            const uint64_t listSize = 2 + (2 * fields.size());
+            const uint64_t start = record.size();
+            record.resize(start + VECTOR_HEADER_SIZE + ((listSize + 2) & 0xFFFC), 0);
+
+            uint8_t* header = record.data() + start;
+            header[0] = layer;
+            header[1] = code;
+            ctx.write16(header + 2, cls);
+            ctx.write32(header + 4, afn);
+            ctx.write32(header + 8, dba);
+            ctx.writeScn(header + 12, scn);
+            header[20] = 1;
+
+            uint8_t* fieldList = header + VECTOR_HEADER_SIZE;
+            ctx.write16(fieldList, static_cast<uint16_t>(listSize));
+            for (uint64_t i = 0; i < fields.size(); ++i)
+                ctx.write16(fieldList + 2 + (i * 2), static_cast<uint16_t>(fields[i].length()));
+
+            for (const std::string& field: fields) {
+                const uint64_t pos = record.size();
+                record.resize(pos + ((field.length() + 3) & 0xFFFFFFFC), 0);
+                memcpy(record.data() + pos, field.data(), field.length());
+            }
+        }
+
+        [[nodiscard]] std::string ktbRedo() const {
+            std::string field(8, 0);
+            put(field, 0, KTBOP_Z);
+            return field;
+        }
+
+        [[nodiscard]] std::string kdo(const GenRow& row, uint8_t op, uint size) const {
+            std::string field(size, 0);
+            put32(field, 0, row.bdba);
+            put32(field, 4, row.bdba);
+            put(field, 10, op);
+            put(field, 11, KDO_FLAGS_XA);
+            put(field, 12, 1);
+            return field;
+        }
+
+        [[nodiscard]] std::string kdoIrp(const GenRow& row) const {
+            const auto cc = static_cast<uint>(row.values.size());
+            std::string field = kdo(row, RedoLogRecord::OP_IRP, std::max(48U, 45 + ((cc + 7) / 8)));
+            put(field, 16, FB_ROW);
+            put(field, 18, static_cast<uint8_t>(cc));
+            put16(field, 40, rowSize(row.values));
+            put16(field, 42, row.slot);
+            return field;
+        }
+
+        [[nodiscard]] std::string kdoDrp(const GenRow& row) const {
+            std::string field = kdo(row, RedoLogRecord::OP_DRP, 20);
+            put16(field, 16, row.slot);
+            return field;
+        }
+
+        [[nodiscard]] std::string kdoUrp(const GenRow& row, uint cc) const {
+            std::string field = kdo(row, RedoLogRecord::OP_URP, std::max(28U, 26 + ((cc + 7) / 8)));
+            put(field, 16, FB_ROW);
+            put16(field, 20, row.slot);
+            put(field, 22, static_cast<uint8_t>(row.values.size()));
+            put(field, 23, static_cast<uint8_t>(cc));
+            return field;
+        }
+
+        // Minimal supplemental log of a complete row piece, starting with the first column
+        [[nodiscard]] std::string suppLog(const GenRow& row) const {
+            std::string field(28, 0);
+            put(field, 0, 1);
+            put(field, 1, FB_ROW);
+            put16(field, 6, 1);
+            put16(field, 8, 1);
+            put32(field, 20, row.bdba);
+            put16(field, 24, row.slot);
+            return field;
+        }
+
+        // 5.1 undo header fields, followed by the undo of the row operation
+        std::vector<std::string> undoFields(GenTransaction& transaction, const GenTable& table) const {
+            std::string ktudb(20, 0);
+            put16(ktudb, 8, transaction.usn);
+            put16(ktudb, 10, transaction.slt);
+            put32(ktudb, 12, transaction.sqn);
+            put16(ktudb, 16, ++transaction.undoSeq);
+
+            std::string ktub(24, 0);
+            put32(ktub, 0, table.obj);
+            put32(ktub, 4, table.dataObj);
+            put32(ktub, 8, TS_ID);
+            put(ktub, 16, 0x0B);
+            put(ktub, 17, 0x01);
+            put(ktub, 18, static_cast<uint8_t>(transaction.slt));
+
+            return {ktudb, ktub, ktbRedo()};
+        }
+
+        void appendInsert(std::vector<uint8_t>& record, GenTransaction& transaction, GenTable& table) {
+            GenRow row{table.bdba, table.slot, {}};
+            for (const GenColumn& column: columns)
+                row.values.push_back(columnValue(column));
+            if (++table.slot == ROWS_PER_BLOCK) {
+                ++table.bdba;
+                table.slot = 0;
+            }
+
+            std::vector<std::string> undo = undoFields(transaction, table);
+            undo.push_back(kdoDrp(row));
+            undo.push_back(suppLog(row));
+            appendVector(record, 5, 1, 16 + (2 * transaction.usn), UNDO_AFN, 0, undo);
+
+            std::vector<std::string> redo{ktbRedo(), kdoIrp(row)};
+            redo.insert(redo.end(), row.values.begin(), row.values.end());
+            appendVector(record, 11, 2, 1, DATA_AFN, row.bdba, redo);
+
+            table.rows.push_back(std::move(row));
+        }
+
+        void appendDelete(std::vector<uint8_t>& record, GenTransaction& transaction, GenTable& table) {
+            const uint64_t index = next(table.rows.size());
+            const GenRow row = std::move(table.rows[index]);
+            table.rows[index] = std::move(table.rows.back());
+            table.rows.pop_back();
+
+            std::vector<std::string> undo = undoFields(transaction, table);
+            undo.push_back(kdoIrp(row));
+            undo.insert(undo.end(), row.values.begin(), row.values.end());
+            undo.push_back(suppLog(row));
+            appendVector(record, 5, 1, 16 + (2 * transaction.usn), UNDO_AFN, 0, undo);
+
+            appendVector(record, 11, 3, 1, DATA_AFN, row.bdba, {ktbRedo(), kdoDrp(row)});
+        }
+
+        void appendUpdate(std::vector<uint8_t>& record, GenTransaction& transaction, GenTable& table) {
+            GenRow& row = table.rows[next(table.rows.size())];
+
+            std::vector<uint16_t> colNums(columns.size());
+            for (uint16_t i = 0; i < colNums.size(); ++i)
+                colNums[i] = i;
+            std::shuffle(colNums.begin(), colNums.end(), random);
+            colNums.resize(1 + next(colNums.size()));
+            std::sort(colNums.begin(), colNums.end());
+
+            std::string colNumsField(colNums.size() * 2, 0);
+            for (uint i = 0; i < colNums.size(); ++i)
+                put16(colNumsField, i * 2, colNums[i]);
+
+            std::vector<std::string> undo = undoFields(transaction, table);
+            undo.push_back(kdoUrp(row, colNums.size()));
+            undo.push_back(colNumsField);
+            for (const uint16_t col: colNums)
+                undo.push_back(row.values[col]);
+            undo.push_back(suppLog(row));
+            appendVector(record, 5, 1, 16 + (2 * transaction.usn), UNDO_AFN, 0, undo);
+
+            std::vector<std::string> redo{ktbRedo(), kdoUrp(row, colNums.size()), colNumsField};
+            for (const uint16_t col: colNums) {
+                row.values[col] = columnValue(columns[col]);
+                redo.push_back(row.values[col]);
+            }
+            appendVector(record, 11, 5, 1, DATA_AFN, row.bdba, redo);
+        }
+
+        void appendOperation(std::vector<uint8_t>& record, GenTransaction& transaction) {
+            GenTable& table = tables[next(tables.size())];
+            uint64_t kind = next(config.mix[0] + config.mix[1] + config.mix[2]);
+            kind = kind < config.mix[0] ? 0 : (kind < config.mix[0] + config.mix[1] ? 1 : 2);
+            if (table.rows.empty())
+                kind = 0;
+            ++ops[kind];
+
+            if (kind == 0)
+                appendInsert(record, transaction, table);
+            else if (kind == 1)
+                appendUpdate(record, transaction, table);
+            else
+                appendDelete(record, transaction, table);
+        }
+
+        void appendBegin(std::vector<uint8_t>& record, const GenTransaction& transaction) const {
+            std::string ktudh(32, 0);
+            put16(ktudh, 0, transaction.slt);
+            put32(ktudh, 4, transaction.sqn);
+            appendVector(record, 5, 2, 15 + (2 * transaction.usn), UNDO_AFN, 0, {ktudh});
+        }
+
+        void appendCommit(std::vector<uint8_t>& record, const GenTransaction& transaction) const {
+            std::string ktucm(20, 0);
+            put16(ktucm, 0, transaction.slt);
+            put32(ktucm, 4, transaction.sqn);
+            appendVector(record, 5, 4, 15 + (2 * transaction.usn), UNDO_AFN, 0, {ktucm});
+        }
+
+        GenTransaction beginTransaction() {
+            const uint32_t xid = freeXids.front();
+            freeXids.pop_front();
+            ++began;
+            return {static_cast<uint16_t>(1 + (xid / SLT_COUNT)), static_cast<uint16_t>(xid % SLT_COUNT), nextSqn++,
+                    config.opsMin + next(config.opsMax - config.opsMin + 1)};
+        }
+
+        void allocateBlock() {
+            if (file.size() >= static_cast<uint64_t>(block + 1) * config.blockSize)
+                return;
+
+            file.resize(static_cast<uint64_t>(block + 1) * config.blockSize, 0);
+            uint8_t* data = file.data() + (static_cast<uint64_t>(block) * config.blockSize);
+            data[0] = 1;
+            data[1] = config.blockSize == 4096 ? 0x82 : 0x22;
+            ctx.write32(data + 4, block);
+            ctx.write32(data + 8, sequence);
+        }
+
+        void openFile() {
+            ++sequence;
+            file.clear();
+            file.reserve(config.fileSizeMb * 1024 * 1024 + (config.blockSize * 2));
+            file.resize(static_cast<uint64_t>(config.blockSize) * 2, 0);
+            block = 2;
+            blockOffset = BLOCK_HEADER_SIZE;
+            firstScn = Scn(scn.getData() + 1);
+            firstTime = redoTime(static_cast<time_t>(EPOCH_START + (lwnCount / LWNS_PER_SECOND)));
+        }
+
+        void openLwn() {
+            if (file.empty())
+                openFile();
+
+            lwnOpen = true;
+            lwnRecordCount = 0;
+            lwnBlock = block;
+            scn = Scn(scn.getData() + 1);
+            subScn = 0;
+            lwnTime = redoTime(static_cast<time_t>(EPOCH_START + (lwnCount / LWNS_PER_SECOND)));
+            ++lwnCount;
+        }
+
+        // Records are packed from offset 16 of every block and never start in the last 20 bytes of a block
+        void appendRecord(const std::vector<uint8_t>& vectors) {
+            const bool lwnHeader = (lwnRecordCount == 0);
+            const uint headerSize = lwnHeader ? RECORD_HEADER_LWN_SIZE : RECORD_HEADER_SIZE;
+            std::vector<uint8_t> record(headerSize, 0);
+            record.insert(record.end(), vectors.begin(), vectors.end());
+
+            ctx.write32(record.data(), static_cast<uint32_t>(record.size()));
+            record[4] = lwnHeader ? VLD_LWN : VLD_RECORD;
+            ctx.write16(record.data() + 6, static_cast<uint16_t>(scn.getData() >> 32));
+            ctx.write32(record.data() + 8, static_cast<uint32_t>(scn.getData()));
+            ctx.write16(record.data() + 12, ++subScn);
+            if (lwnHeader) {
+                ctx.write16(record.data() + 24, 1);
+                ctx.write16(record.data() + 26, 1);
+                ctx.writeScn(record.data() + 40, scn);
+                ctx.write32(record.data() + 64, lwnTime);
+            }
+
+            if (blockOffset + 20 >= config.blockSize) {
+                ++block;
+                blockOffset = BLOCK_HEADER_SIZE;
+            }
+            uint64_t pos = 0;
+            while (pos < record.size()) {
+                allocateBlock();
+                const uint64_t toCopy = std::min<uint64_t>(config.blockSize - blockOffset, record.size() - pos);
+                memcpy(file.data() + (static_cast<uint64_t>(block) * config.blockSize) + blockOffset, record.data() + pos, toCopy);
+                pos += toCopy;
+                blockOffset += toCopy;
+                if (blockOffset == config.blockSize) {
+                    ++block;
+                    blockOffset = BLOCK_HEADER_SIZE;
+                }
+            }
+
+            if (++lwnRecordCount == config.lwnRecords)
+                closeLwn();
+        }
+
+        void closeLwn() {
+            if (!lwnOpen)
+                return;
+            lwnOpen = false;
+
+            // The next LWN starts in a fresh block
+            if (blockOffset > BLOCK_HEADER_SIZE) {
+                ++block;
+                blockOffset = BLOCK_HEADER_SIZE;
+            }
+            uint8_t* header = file.data() + (static_cast<uint64_t>(lwnBlock) * config.blockSize) + BLOCK_HEADER_SIZE;
+            ctx.write32(header + 28, block - lwnBlock);
+            ctx.write32(header + 32, block - lwnBlock);
+
+            if (file.size() >= config.fileSizeMb * 1024 * 1024)
+                closeFile();
+        }
+
+        void writeFileHeader(typeBlk numBlocks) {
+            uint8_t* data = file.data();
+            data[1] = config.blockSize == 4096 ? 0x82 : 0x22;
+            ctx.write32(data + 20, config.blockSize);
+            ctx.write32(data + 24, numBlocks);
+            data[28] = 0x7D;
+            data[29] = 0x7C;
+            data[30] = 0x7B;
+            data[31] = 0x7A;
+
+            data += config.blockSize;
+            data[0] = 1;
+            data[1] = config.blockSize == 4096 ? 0x82 : 0x22;
+            ctx.write32(data + 4, 1);
+            ctx.write32(data + 8, sequence);
+            ctx.write32(data + 20, COMPAT_VSN);
+            ctx.write32(data + 24, DBID);
+            const std::string sid = (config.database + "        ").substr(0, 8);
+            memcpy(data + 28, sid.data(), 8);
+            ctx.write32(data + 40, numBlocks);
+            ctx.write32(data + 44, config.blockSize);
+            ctx.write16(data + 48, 1);
+            ctx.write32(data + 52, ACTIVATION);
+            ctx.write32(data + 156, numBlocks);
+            ctx.write32(data + 160, RESETLOGS);
+            ctx.writeScn(data + 164, Scn(1));
+            ctx.write16(data + 176, THREAD);
+            ctx.writeScn(data + 180, firstScn);
+            ctx.write32(data + 188, firstTime);
+            ctx.writeScn(data + 192, Scn(scn.getData() + 1));
+            ctx.write32(data + 200, lwnTime);
+        }
+
+        // A block is valid when the XOR of all its 64-bit words folds to zero, see Reader::calcChSum
+        void writeChecksums(typeBlk numBlocks) {
+            for (typeBlk num = 1; num < numBlocks; ++num) {
+                uint8_t* data = file.data() + (static_cast<uint64_t>(num) * config.blockSize);
+                ctx.write16(data + 14, 0);
+                uint64_t sum = 0;
+                for (uint i = 0; i < config.blockSize; i += sizeof(uint64_t)) {
+                    uint64_t word;
+                    memcpy(&word, data + i, sizeof(uint64_t));
+                    sum ^= word;
+                }
+                sum ^= (sum >> 32);
+                sum ^= (sum >> 16);
+                ctx.write16(data + 14, static_cast<uint16_t>(sum & 0xFFFF));
+            }
+        }
+
+        void closeFile() {
+            if (file.empty())
+                return;
+
+            const auto numBlocks = static_cast<typeBlk>(file.size() / config.blockSize);
+            writeFileHeader(numBlocks);
+            writeChecksums(numBlocks);
+
+            const std::string fileName = config.outputDir + "/" + std::to_string(THREAD) + "_" + std::to_string(sequence) + "_" +
+                                         std::to_string(RESETLOGS) + ".dbf";
+            std::ofstream out(fileName, std::ios::binary | std::ios::trunc);
+            if (!out.is_open())
+                throw OpenLogReplicator::RuntimeException(10006, "file: " + fileName + " - open for writing returned: " + strerror(errno));
+            out.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+            out.close();
+            if (out.fail())
+                throw OpenLogReplicator::RuntimeException(10007, "file: " + fileName + " - write returned: " + strerror(errno));
+
+            ++files;
+            bytes += file.size();
+            file.clear();
+        }
+
+        void writeSchema() const {
+            const std::string fileName = config.outputDir + "/" + config.database + "-chkpt-" + std::to_string(SCN_START) + ".json";
+            std::ostringstream ss;
+            ss << R"({"database":")" << config.database << R"(","scn":)" << SCN_START << R"(,"resetlogs":)" << RESETLOGS <<
+               R"(,"activation":)" << ACTIVATION << R"(,"time":0,"seq":1,"offset":0,"big-endian":0,"context":")" << config.database <<
+               R"(","con-id":0,"con-name":"","db-timezone":"+00:00","db-recovery-file-dest":"","db-block-checksum":"TYPICAL",)" <<
+               R"("log-archive-dest":"","log-archive-format":")" << LOG_ARCHIVE_FORMAT <<
+               R"(","nls-character-set":"AL32UTF8","nls-nchar-character-set":"AL16UTF16","supp-log-db-primary":0,"supp-log-db-all":1,)" <<
+               R"("online-redo":[],"incarnations":[{"incarnation":1,"resetlogs-scn":1,"prior-resetlogs-scn":0,"status":"CURRENT","resetlogs":)" <<
+               RESETLOGS << R"(,"prior-incarnation":0}],"users":[")" << config.owner << R"("],"schema-scn":)" << SCN_START << ",\n";
+
+            // Dictionary rows get distinct row ids per dictionary table
+            ss << R"("sys-ccol":[],"sys-cdef":[],"sys-col":[)";
+            uint64_t num = 0;
+            for (const GenTable& table: tables) {
+                for (uint64_t col = 0; col < columns.size(); ++col, ++num) {
+                    const GenColumn& column = columns[col];
+                    const bool text = column.type == SysCol::COLTYPE::VARCHAR;
+                    ss << (num > 0 ? ",\n" : "\n") << R"({"row-id":")" << RowId(21, 1000 + (num / 256), num % 256) << R"(","obj":)" << table.obj <<
+                       R"(,"col":)" << (col + 1) << R"(,"seg-col":)" << (col + 1) << R"(,"int-col":)" << (col + 1) << R"(,"name":")" << column.name <<
+                       R"(","type":)" << static_cast<uint>(column.type) << R"(,"length":)" << column.length <<
+                       R"(,"precision":-1,"scale":-1,"charset-form":)" << (text ? 1 : 0) << R"(,"charset-id":)" << (text ? 873 : 0) <<
+                       R"(,"null":0,"property":[0,0]})";
+                }
+            }
+            ss << "],\n" << R"("sys-deferredstg":[],"sys-ecol":[],"sys-lob":[],"sys-lob-comp-part":[],"sys-lob-frag":[],"sys-obj":[)";
+            num = 0;
+            for (const GenTable& table: tables) {
+                ss << (num > 0 ? ",\n" : "\n") << R"({"row-id":")" << RowId(18, 1000 + (num / 256), num % 256) << R"(","owner":)" << USER_ID <<
+                   R"(,"obj":)" << table.obj << R"(,"data-obj":)" << table.dataObj << R"(,"name":")" << table.name <<
+                   R"(","type":2,"flags":[0,0],"single":0})";
+                ++num;
+            }
+            ss << "],\n" << R"("sys-tab":[)";
+            num = 0;
+            for (const GenTable& table: tables) {
+                ss << (num > 0 ? ",\n" : "\n") << R"({"row-id":")" << RowId(4, 1000 + (num / 256), num % 256) << R"(","obj":)" << table.obj <<
+                   R"(,"data-obj":)" << table.dataObj << R"(,"ts":)" << TS_ID << R"(,"clu-cols":0,"flags":[0,0],"property":[0,0]})";
+                ++num;
+            }
+            ss << "],\n" << R"("sys-tabcompart":[],"sys-tabpart":[],"sys-tabsubpart":[],"sys-ts":[)" << "\n" << R"({"row-id":")" <<
+               RowId(16, 1000, 0) << R"(","ts":)" << TS_ID << R"(,"name":"USERS","block-size":8192}],)" << "\n" << R"("sys-user":[)" << "\n" <<
+               R"({"row-id":")" << RowId(22, 1000, 0) << R"(","user":)" << USER_ID << R"(,"name":")" << config.owner <<
+               R"(","spare1":[0,0],"single":0}],)" << "\n" << R"("xdb-ttset":[]})" << "\n";
+
+            std::ofstream out(fileName, std::ios::trunc);
+            if (!out.is_open())
+                throw OpenLogReplicator::RuntimeException(10006, "file: " + fileName + " - open for writing returned: " + strerror(errno));
+            out << ss.str();
+            out.close();
+            if (out.fail())
+                throw OpenLogReplicator::RuntimeException(10007, "file: " + fileName + " - write returned: " + strerror(errno));
+        }
+
+    public:
+        RedoGenerator(const Ctx& newCtx, const GenConfig& newConfig) :
+                ctx(newCtx),
+                config(newConfig),
+                random(newConfig.seed),
+                columns(parseColumns(newConfig.columns)) {
+            for (uint64_t num = 0; num < config.tables; ++num) {
+                const auto obj = static_cast<typeObj>(OBJ_START + num);
+                tables.push_back({"T" + std::to_string(num + 1), obj, obj, static_cast<typeDba>((DATA_AFN << 22) | (1000 + (num * 100000))), 0, {}});
+            }
+
+            std::vector<uint32_t> xids(static_cast<uint64_t>(USN_COUNT) * SLT_COUNT);
+            for (uint32_t xid = 0; xid < xids.size(); ++xid)
+                xids[xid] = xid;
+            std::shuffle(xids.begin(), xids.end(), random);
+            freeXids.assign(xids.begin(), xids.end());
+        }
+
+        // Steps of randomly chosen open transactions are interleaved one redo record at a time
+        void run() {
+            struct stat fileStat{};
+            if (stat(config.outputDir.c_str(), &fileStat) != 0 || !S_ISDIR(fileStat.st_mode))
+                throw OpenLogReplicator::ConfigurationException(30001, "directory: " + config.outputDir + " - can't read");
+            writeSchema();
+
+            std::vector<uint8_t> vectors;
+            while (committed < config.transactions) {
+                while (openTransactions.size() < config.concurrency && began < config.transactions)
+                    openTransactions.push_back(beginTransaction());
+
+                const uint64_t index = next(openTransactions.size());
+                GenTransaction& transaction = openTransactions[index];
+                if (!lwnOpen)
+                    openLwn();
+
+                vectors.clear();
+                if (!transaction.begun) {
+                    appendBegin(vectors, transaction);
+                    transaction.begun = true;
+                }
+                if (transaction.opsLeft > 0) {
+                    appendOperation(vectors, transaction);
+                    --transaction.opsLeft;
+                } else {
+                    appendCommit(vectors, transaction);
+                    freeXids.push_back(((static_cast<uint32_t>(transaction.usn) - 1) * SLT_COUNT) + transaction.slt);
+                    openTransactions[index] = openTransactions.back();
+                    openTransactions.pop_back();
+                    ++committed;
+                }
+                appendRecord(vectors);
+            }
+
+            closeLwn();
+            closeFile();
+        }
+
+        void printSummary() const {
+            ctx.info(0, "generated " + std::to_string(files) + " redo log files, " + std::to_string(bytes / 1024 / 1024) + " MB, sequence 1-" +
+                        std::to_string(sequence) + ", " + std::to_string(lwnCount) + " lwns, " + std::to_string(committed) + " transactions, " +
+                        std::to_string(ops[0]) + " inserts, " + std::to_string(ops[1]) + " updates, " + std::to_string(ops[2]) + " deletes");
+            ctx.info(0, "replay with: olr-bench -n " + config.database + " -c " + config.outputDir + "/" + config.database + "-chkpt-" +
+                        std::to_string(SCN_START) + ".json -t " + config.owner + ".T.* " + config.outputDir);
+        }
+    };
+}
+
+int main(int argc, char** argv) {
+    OpenLogReplicator::Ctx ctx;
+    ctx.welcome("OpenLogReplicator v." + std::to_string(OpenLogReplicator_VERSION_MAJOR) + "." +
+                std::to_string(OpenLogReplicator_VERSION_MINOR) + "." + std::to_string(OpenLogReplicator_VERSION_PATCH) +
+                " olr-redogen (C) 2018-2025 by Adam Leszczynski (aleszczynski@bersler.com), see LICENSE file for licensing information");
+
+    // Run arguments:
+    // -n database name, at most 8 characters, -u owner of the generated tables T1..Tn
+    // -o output directory for the redo log files <thread>_<sequence>_<resetlogs>.dbf and the schema checkpoint <database>-chkpt-<scn>.json
+    // -T number of tables, -C columns of every table: n - NUMBER, v<length> - VARCHAR2, d - DATE, r<length> - RAW, e.g. n,v32,d
+    // -x number of transactions, -r operations per transaction, fixed or a min:max range
+    // -c number of transactions open at the same time, their records are interleaved
+    // -m weights of insert:update:delete operations, updates and deletes touch rows inserted earlier
+    // -S size of a redo log file in MB, -b redo block size, -l records per LWN, -s seed of the random generator
+    GenConfig config;
+    if (!parseArgs(argc, argv, config)) {
+        usage(ctx);
+        return 1;
+    }
+
+    try {
+        RedoGenerator generator(ctx, config);
+        generator.run();
+        generator.printSummary();
+    } catch (OpenLogReplicator::ConfigurationException& ex) {
+        ctx.error(ex.code, ex.msg);
+        return 1;
+    } catch (OpenLogReplicator::DataException& ex) {
+        ctx.error(ex.code, ex.msg);
+        return 1;
+    } catch (OpenLogReplicator::RuntimeException& ex) {
+        ctx.error(ex.code, ex.msg);
+        return 1;
+    }
+
+    return 0;
+}
@@ -21,15 +21,26 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include <cerrno>
 #include <fcntl.h>
 #include <regex>
+#include <set>
 #include <sys/file.h>
 #include <sys/stat.h>
 #include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <unistd.h>
+#ifdef LINK_LIBRARY_NUMA
+#include <numa.h>
+#endif /* LINK_LIBRARY_NUMA */
 
+#include "builder/BuilderAvro.h"
 #include "builder/BuilderJson.h"
+#include "builder/LobStore.h"
 #include "common/Ctx.h"
 #include "common/MemoryManager.h"
+#include "common/TableCost.h"
+#include "common/Tracer.h"
+#include "common/Watchdog.h"
 #include "common/exception/ConfigurationException.h"
 #include "common/exception/RuntimeException.h"
 #include "common/metrics/Metrics.h"
@@ -40,12 +51,23 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include "metadata/Checkpoint.h"
 #include "metadata/Metadata.h"
 #include "metadata/SchemaElement.h"
+#include "metadata/SerializerBinary.h"
 #include "metadata/SerializerJson.h"
+#include "metadata/StandbyLease.h"
+#include "parser/RacCoordinator.h"
+#include "parser/RedoProfile.h"
 #include "parser/TransactionBuffer.h"
 #include "replicator/Replicator.h"
 #include "replicator/ReplicatorBatch.h"
+#include "replicator/PartitionCoordinator.h"
+#include "replicator/ShardCoordinator.h"
+#include "state/CheckpointRing.h"
 #include "state/StateDisk.h"
+#include "state/StateRedis.h"
+#include "writer/RateLimit.h"
 #include "writer/WriterDiscard.h"
+#include "writer/WriterShm.h"
+#include "writer/WriterSse.h"
 #include "writer/WriterFile.h"
 #include "OpenLogReplicator.h"
 
@@ -55,13 +77,18 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 
 #ifdef LINK_LIBRARY_OCI
 #include "replicator/ReplicatorOnline.h"
+#include "replicator/RacArchiveLogList.h"
 #include "replicator/ReplicatorRacOnline.h"
 #endif /* LINK_LIBRARY_OCI */
 
 #ifdef LINK_LIBRARY_PROTOBUF
 #include "builder/BuilderProtobuf.h"
 #include "stream/StreamNetwork.h"
+#include "writer/WriterFanout.h"
 #include "writer/WriterStream.h"
+#ifdef LINK_LIBRARY_GRPC
+#include "stream/StreamGrpc.h"
+#endif /* LINK_LIBRARY_GRPC */
 #ifdef LINK_LIBRARY_ZEROMQ
 #include "stream/StreamZeroMQ.h"
 #endif /* LINK_LIBRARY_ZEROMQ */
@@ -71,6 +98,10 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include "writer/WriterKafka.h"
 #endif /* LINK_LIBRARY_RDKAFKA */
 
+#ifdef LINK_LIBRARY_ARROW
+#include "writer/WriterParquet.h"
+#endif /* LINK_LIBRARY_ARROW */
+
 #ifdef LINK_LIBRARY_PROMETHEUS
 #include "common/metrics/MetricsPrometheus.h"
 #endif /* LINK_LIBRARY_PROMETHEUS */
@@ -104,6 +135,13 @@ namespace OpenLogReplicator {
         }
         writers.clear();
 
+        for (LobStore *lobStore: lobStores) {
+            lobStore->stop();
+            ctx->finishThread(lobStore);
+            delete lobStore;
+        }
+        lobStores.clear();
+
         for (Builder *builder: builders)
             delete builder;
         builders.clear();
@@ -112,6 +150,20 @@ namespace OpenLogReplicator {
             delete replicatorTmp;
         replicators.clear();
 
+        for (RacCoordinator *racCoordinator: racCoordinators)
+            delete racCoordinator;
+        racCoordinators.clear();
+
+        for (ShardCoordinator *shardCoordinator: shardCoordinators)
+            delete shardCoordinator;
+        shardCoordinators.clear();
+
+#ifdef LINK_LIBRARY_OCI
+        for (auto &racArchiveLogList: racArchiveLogLists)
+            delete racArchiveLogList.second;
+#endif /* LINK_LIBRARY_OCI */
+        racArchiveLogLists.clear();
+
         for (Checkpoint *checkpoint: checkpoints)
             delete checkpoint;
         checkpoints.clear();
@@ -132,6 +184,13 @@ namespace OpenLogReplicator {
             delete memoryManager;
         memoryManagers.clear();
 
+        delete watchdog;
+        watchdog = nullptr;
+
+        ctx->tracer = nullptr;
+        delete tracer;
+        tracer = nullptr;
+
         if (fid != -1)
             close(fid);
         delete[] configFileBuffer;
@@ -167,25 +226,29 @@ namespace OpenLogReplicator {
         configFileBuffer[configFileStat.st_size] = 0;
     }
 
-    void OpenLogReplicator::do_work(int instId, Locales *locales, struct stat configFileStat, const rapidjson::Value &sourceJson, const std::string alias, uint64_t memoryMaxMb) {
+    void OpenLogReplicator::do_work(int instId, Locales *locales, struct stat configFileStat, const rapidjson::Value &sourceJson, const std::string alias, uint64_t memoryMaxMb,
+                                    RacCoordinator *racCoordinator __attribute__((unused)), ShardCoordinator *shardCoordinator, uint shard) {
         const std::string name = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, sourceJson, "name");
         const rapidjson::Value &readerJson = Ctx::getJsonFieldO(configFileName, sourceJson, "reader");
 
         if (!ctx->isDisableChecksSet(Ctx::DISABLE_CHECKS::JSON_TAGS)) {
             static const std::vector<std::string> readerNames{
                 "disable-checks", "start-scn", "start-seq", "start-time-rel", "start-time", "con-id", "type",
-                "redo-copy-path", "db-timezone", "host-timezone", "log-timezone", "user", "password",
-                "server", "redo-log", "path-mapping", "log-archive-format", "asm"
+                "redo-copy-path", "redo-copy-compression", "redo-cache-path", "redo-cache-max-mb", "db-timezone", "host-timezone", "log-timezone", "user", "password",
+                "server", "redo-log", "path-mapping", "log-archive-format", "asm", "io-engine", "queue-depth",
+                "arch-prefetch", "arch-parsers", "dictionary-threads", "dictionary-prefetch-rows", "online-redo-discovery",
+                "snapshot-threads", "hedged-read", "arch-compressed", "object-store",
+                "position-index", "shards", "shard-overlap", "schema-verify-interval-s", "redo-relay", "relay-url", "profile"
             };
             Ctx::checkJsonFields(configFileName, readerJson, readerNames);
         }
 
         if (sourceJson.HasMember("flags")) {
             ctx->flags = Ctx::getJsonFieldU64(configFileName, sourceJson, "flags");
-            if (ctx->flags > 524287)
+            if (ctx->flags > 2097151)
                 throw ConfigurationException(
                     30001, "bad JSON, invalid \"flags\" value: " + std::to_string(ctx->flags) +
-                           ", expected: one of {0 .. 524287}");
+                           ", expected: one of {0 .. 2097151}");
             if (ctx->isFlagSet(Ctx::REDO_FLAGS::DIRECT_DISABLE))
                 ctx->redoVerifyDelayUs = 500000;
         }
@@ -238,13 +301,22 @@ namespace OpenLogReplicator {
 
         uint64_t stateType = State::TYPE_DISK;
         std::string statePath = "checkpoint";
+        std::string stateServer;
+        std::string stateKeyPrefix = name + ":";
+        bool stateBinary = false;
+        uint64_t leaseS = 0;
+        std::string leaseOwner;
+        uint64_t checkpointRingSlots = 0;
+        bool checkpointRingSync = true;
 
         if (sourceJson.HasMember("state")) {
             const rapidjson::Value &stateJson = Ctx::getJsonFieldO(configFileName, sourceJson, "state");
 
             if (!ctx->isDisableChecksSet(Ctx::DISABLE_CHECKS::JSON_TAGS)) {
                 static const std::vector<std::string> stateNames{
-                    "type", "path", "interval-s", "interval-mb", "keep-checkpoints", "schema-force-interval"
+                    "type", "path", "format", "interval-s", "interval-mb", "keep-checkpoints", "schema-force-interval",
+                    "schema-delta-max", "server", "key-prefix", "transaction-persist-s", "lease-s", "lease-owner",
+                    "writer-checkpoint-slots", "writer-checkpoint-fsync"
                 };
                 Ctx::checkJsonFields(configFileName, stateJson, stateNames);
             }
@@ -256,11 +328,29 @@ namespace OpenLogReplicator {
                     stateType = State::TYPE_DISK;
                     if (stateJson.HasMember("path"))
                         statePath = Ctx::getJsonFieldS(configFileName, Ctx::MAX_PATH_LENGTH, stateJson, "path");
+                } else if (stateTypeStr == "redis") {
+                    stateType = State::TYPE_REDIS;
+                    stateServer = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, stateJson, "server");
+                    if (stateJson.HasMember("key-prefix"))
+                        stateKeyPrefix = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, stateJson,
+                                                            "key-prefix");
                 } else
                     throw ConfigurationException(
                         30001,
                         std::string("bad JSON, invalid \"type\" value: ") + stateTypeStr +
-                        ", expected: one of {\"disk\"}");
+                        ", expected: one of {\"disk\", \"redis\"}");
+            }
+
+            if (stateJson.HasMember("format")) {
+                const std::string stateFormatStr = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH,
+                                                                      stateJson, "format");
+                if (stateFormatStr == "binary")
+                    stateBinary = true;
+                else if (stateFormatStr != "json")
+                    throw ConfigurationException(
+                        30001,
+                        std::string("bad JSON, invalid \"format\" value: ") + stateFormatStr +
+                        ", expected: one of {\"json\", \"binary\"}");
             }
 
             if (stateJson.HasMember("interval-s"))
@@ -274,6 +364,85 @@ namespace OpenLogReplicator {
 
             if (stateJson.HasMember("schema-force-interval"))
                 ctx->schemaForceInterval = Ctx::getJsonFieldU64(configFileName, stateJson, "schema-force-interval");
+
+            if (stateJson.HasMember("schema-delta-max"))
+                ctx->schemaDeltaMax = Ctx::getJsonFieldU64(configFileName, stateJson, "schema-delta-max");
+
+            if (stateJson.HasMember("transaction-persist-s")) {
+                ctx->transactionPersistS = Ctx::getJsonFieldU64(configFileName, stateJson, "transaction-persist-s");
+                if (ctx->transactionPersistS > 0 && stateType != State::TYPE_DISK)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"transaction-persist-s\" value: " +
+                                                        std::to_string(ctx->transactionPersistS) + ", expected: 0 for the state of type \"redis\"");
+            }
+
+            if (stateJson.HasMember("lease-s")) {
+                leaseS = Ctx::getJsonFieldU64(configFileName, stateJson, "lease-s");
+                if (leaseS > 3600)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"lease-s\" value: " + std::to_string(leaseS) +
+                                                        ", expected: one of {0 .. 3600}");
+            }
+
+            if (stateJson.HasMember("lease-owner"))
+                leaseOwner = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, stateJson, "lease-owner");
+
+            // The standby instances read the checkpoint of the lease holder from the shared state, the ring file is local
+            if (stateJson.HasMember("writer-checkpoint-slots")) {
+                checkpointRingSlots = Ctx::getJsonFieldU64(configFileName, stateJson, "writer-checkpoint-slots");
+                if (checkpointRingSlots != 0 && (checkpointRingSlots < CheckpointRing::SLOTS_MIN || checkpointRingSlots > CheckpointRing::SLOTS_MAX))
+                    throw ConfigurationException(30001, "bad JSON, invalid \"writer-checkpoint-slots\" value: " +
+                                                        std::to_string(checkpointRingSlots) + ", expected: one of {0, " +
+                                                        std::to_string(CheckpointRing::SLOTS_MIN) + " .. " +
+                                                        std::to_string(CheckpointRing::SLOTS_MAX) + "}");
+                if (checkpointRingSlots != 0 && stateType != State::TYPE_DISK)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"writer-checkpoint-slots\" value: " +
+                                                        std::to_string(checkpointRingSlots) + ", expected: 0 for the state of type \"redis\"");
+                if (checkpointRingSlots != 0 && leaseS > 0)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"writer-checkpoint-slots\" value: " +
+                                                        std::to_string(checkpointRingSlots) + ", expected: 0 with \"lease-s\"");
+            }
+
+            if (stateJson.HasMember("writer-checkpoint-fsync")) {
+                const uint val = Ctx::getJsonFieldU(configFileName, stateJson, "writer-checkpoint-fsync");
+                if (val > 1)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"writer-checkpoint-fsync\" value: " + std::to_string(val) +
+                                                        ", expected: one of {0, 1}");
+                checkpointRingSync = (val == 1);
+            }
+        }
+
+        uint partitions = 0;
+        std::string partitionNode;
+        uint64_t partitionTimeoutS = 30;
+        std::string partitionPath;
+        std::string partitionKeyPrefix = name + ":partition:";
+
+        if (sourceJson.HasMember("partition")) {
+            const rapidjson::Value& partitionJson = Ctx::getJsonFieldO(configFileName, sourceJson, "partition");
+
+            if (!ctx->isDisableChecksSet(Ctx::DISABLE_CHECKS::JSON_TAGS)) {
+                static const std::vector<std::string> partitionNames{"partitions", "node", "timeout-s", "path", "key-prefix"};
+                Ctx::checkJsonFields(configFileName, partitionJson, partitionNames);
+            }
+
+            partitions = Ctx::getJsonFieldU(configFileName, partitionJson, "partitions");
+            if (partitions < 1 || partitions > 4096)
+                throw ConfigurationException(30001, "bad JSON, invalid \"partitions\" value: " + std::to_string(partitions) +
+                                                    ", expected: one of {1 .. 4096}");
+
+            partitionNode = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, partitionJson, "node");
+
+            if (partitionJson.HasMember("timeout-s")) {
+                partitionTimeoutS = Ctx::getJsonFieldU64(configFileName, partitionJson, "timeout-s");
+                if (partitionTimeoutS < 3 || partitionTimeoutS > 3600)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"timeout-s\" value: " + std::to_string(partitionTimeoutS) +
+                                                        ", expected: one of {3 .. 3600}");
+            }
+
+            // The state of the partitions is shared by all instances, the state of every instance is its own
+            if (stateType == State::TYPE_DISK)
+                partitionPath = Ctx::getJsonFieldS(configFileName, Ctx::MAX_PATH_LENGTH, partitionJson, "path");
+            else if (partitionJson.HasMember("key-prefix"))
+                partitionKeyPrefix = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, partitionJson, "key-prefix");
         }
 
         std::string debugOwner;
@@ -326,16 +495,52 @@ namespace OpenLogReplicator {
             ctx->transactionSizeMax = transactionMaxMb * 1024 * 1024;
         }
 
+        if (sourceJson.HasMember("transaction-stream-mb")) {
+            const uint64_t transactionStreamMb = Ctx::getJsonFieldU64(configFileName, sourceJson, "transaction-stream-mb");
+            if (transactionStreamMb > memoryMaxMb)
+                throw ConfigurationException(30001, "bad JSON, invalid \"transaction-stream-mb\" value: " + std::to_string(transactionStreamMb) +
+                                                    ", expected: smaller than \"max-mb\" (" + std::to_string(memoryMaxMb) + ")");
+            ctx->transactionStreamSize = transactionStreamMb * 1024 * 1024;
+        }
+
+        if (sourceJson.HasMember("transaction-pool-size")) {
+            ctx->transactionPoolSize = Ctx::getJsonFieldU64(configFileName, sourceJson, "transaction-pool-size");
+            if (ctx->transactionPoolSize > 1048576)
+                throw ConfigurationException(30001, "bad JSON, invalid \"transaction-pool-size\" value: " +
+                                                    std::to_string(ctx->transactionPoolSize) + ", expected: one of {0 .. 1048576}");
+        }
+
+        if (sourceJson.HasMember("orphaned-lob-max-mb")) {
+            const uint64_t orphanedLobMaxMb = Ctx::getJsonFieldU64(configFileName, sourceJson, "orphaned-lob-max-mb");
+            if (orphanedLobMaxMb > memoryMaxMb)
+                throw ConfigurationException(
+                    30001, "bad JSON, invalid \"orphaned-lob-max-mb\" value: " + std::to_string(orphanedLobMaxMb) +
+                           ", expected: smaller than \"max-mb\" (" + std::to_string(memoryMaxMb) + ")");
+            ctx->orphanedLobSizeMax = orphanedLobMaxMb * 1024 * 1024;
+        }
+
 
         // METRICS
         if (sourceJson.HasMember("metrics")) {
             const rapidjson::Value &metricsJson = Ctx::getJsonFieldO(configFileName, sourceJson, "metrics");
 
             if (!ctx->isDisableChecksSet(Ctx::DISABLE_CHECKS::JSON_TAGS)) {
-                static const std::vector<std::string> metricsNames{"type", "bind", "tag-names"};
+                static const std::vector<std::string> metricsNames{"type", "bind", "tag-names", "latency-sample", "table-cost"};
                 Ctx::checkJsonFields(configFileName, metricsJson, metricsNames);
             }
 
+            if (metricsJson.HasMember("latency-sample"))
+                ctx->latencySample = Ctx::getJsonFieldU64(configFileName, metricsJson, "latency-sample");
+
+            if (metricsJson.HasMember("table-cost")) {
+                const uint tableCost = Ctx::getJsonFieldU(configFileName, metricsJson, "table-cost");
+                if (tableCost > 1)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"table-cost\" value: " + std::to_string(tableCost) +
+                                                        ", expected: one of {0, 1}");
+                if (tableCost == 1 && ctx->tableCost == nullptr)
+                    ctx->tableCost = new TableCost(ctx);
+            }
+
             if (metricsJson.HasMember("type")) {
                 const std::string metricsType = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH,
                                                                    metricsJson, "type");
@@ -362,10 +567,12 @@ namespace OpenLogReplicator {
 
                 if (metricsType == "prometheus") {
 #ifdef LINK_LIBRARY_PROMETHEUS
-                    const std::string prometheusBind = Ctx::getJsonFieldS(
-                        configFileName, Ctx::JSON_TOPIC_LENGTH, metricsJson, "bind");
+                    // Tenants of the replicator manager without own address are served by its HTTP server
+                    std::string prometheusBind;
+                    if (metricsJson.HasMember("bind") || ctx->tenant.empty())
+                        prometheusBind = Ctx::getJsonFieldS(configFileName, Ctx::JSON_TOPIC_LENGTH, metricsJson, "bind");
 
-                    ctx->metrics = new MetricsPrometheus(tagNames, prometheusBind);
+                    ctx->metrics = new MetricsPrometheus(tagNames, prometheusBind, ctx->tenant);
                     ctx->metrics->initialize(ctx);
 #else
                         throw ConfigurationException(30001, "bad JSON, invalid \"type\" value: \"" + metricsType +
@@ -380,6 +587,36 @@ namespace OpenLogReplicator {
             }
         }
 
+        // TRACING
+        if (sourceJson.HasMember("tracing") && tracer == nullptr) {
+            const rapidjson::Value &tracingJson = Ctx::getJsonFieldO(configFileName, sourceJson, "tracing");
+
+            if (!ctx->isDisableChecksSet(Ctx::DISABLE_CHECKS::JSON_TAGS)) {
+                static const std::vector<std::string> tracingNames{"endpoint", "interval-ms", "sample", "table"};
+                Ctx::checkJsonFields(configFileName, tracingJson, tracingNames);
+            }
+
+            const std::string endpoint = Ctx::getJsonFieldS(configFileName, Ctx::JSON_TOPIC_LENGTH, tracingJson, "endpoint");
+            uint64_t intervalMs = 1000;
+            if (tracingJson.HasMember("interval-ms")) {
+                intervalMs = Ctx::getJsonFieldU64(configFileName, tracingJson, "interval-ms");
+                if (intervalMs < 10 || intervalMs > 60000)
+                    throw ConfigurationException(
+                        30001, "bad JSON, invalid \"interval-ms\" value: " + std::to_string(intervalMs) +
+                               ", expected: one of {10 .. 60000}");
+            }
+
+            tracer = new Tracer(ctx, "tracer", endpoint, name, intervalMs);
+            tracer->configure(configFileName, tracingJson);
+            ctx->tracer = tracer;
+        }
+
+        // Every redo thread keeps its own position, the checkpoints of the instances are stored apart
+        if (instId != -1) {
+            statePath += "/" + std::to_string(instId);
+            stateKeyPrefix += std::to_string(instId) + ":";
+        }
+
         // METADATA
         auto *metadata = new Metadata(ctx, locales, name, conId, startScn, startSequence, startTime, startTimeRel);
         metadatas.push_back(metadata);
@@ -393,9 +630,51 @@ namespace OpenLogReplicator {
             metadata->addElement(".*", ".*", DbTable::OPTIONS::DEFAULT);
 
         if (stateType == State::TYPE_DISK) {
-            metadata->state = new StateDisk(ctx, statePath);
+            metadata->checkpointRingPath = statePath;
+            metadata->checkpointRingSlots = checkpointRingSlots;
+            metadata->checkpointRingSync = checkpointRingSync;
+            metadata->stateDisk = new StateDisk(ctx, "scripts");
+            if (stateBinary) {
+                metadata->state = new StateDisk(ctx, statePath, ".bin");
+                metadata->serializer = new SerializerBinary();
+            } else {
+                metadata->state = new StateDisk(ctx, statePath);
+                metadata->serializer = new SerializerJson();
+            }
+        } else if (stateType == State::TYPE_REDIS) {
             metadata->stateDisk = new StateDisk(ctx, "scripts");
-            metadata->serializer = new SerializerJson();
+            metadata->state = new StateRedis(ctx, stateServer, stateKeyPrefix);
+            if (stateBinary)
+                metadata->serializer = new SerializerBinary();
+            else
+                metadata->serializer = new SerializerJson();
+        }
+
+        // Instances sharing the state: the lease holder produces the output, the others parse behind it in standby
+        if (leaseS > 0) {
+            if (leaseOwner.empty()) {
+                char hostName[256];
+                if (gethostname(hostName, sizeof(hostName)) != 0)
+                    hostName[0] = 0;
+                hostName[sizeof(hostName) - 1] = 0;
+                leaseOwner = std::string(hostName) + ":" + std::to_string(getpid());
+            }
+            metadata->lease = new StandbyLease(ctx, metadata->state, name, leaseOwner, leaseS);
+            if (!metadata->lease->acquire(time(nullptr))) {
+                metadata->standby = true;
+                ctx->info(0, "standby mode, lease held by: " + metadata->lease->holder);
+            }
+        }
+
+        if (partitions > 0) {
+            State* partitionState;
+            if (stateType == State::TYPE_DISK)
+                partitionState = new StateDisk(ctx, partitionPath);
+            else
+                partitionState = new StateRedis(ctx, stateServer, partitionKeyPrefix);
+            metadata->partitions = new PartitionCoordinator(ctx, partitionState, name, partitionNode, partitions, partitionTimeoutS);
+            metadata->partitions->start(time(nullptr));
+            ctx->info(0, "partitioned output, " + metadata->partitions->describe());
         }
 
         // CHECKPOINT
@@ -408,6 +687,10 @@ namespace OpenLogReplicator {
         // TRANSACTION BUFFER
         auto *transactionBuffer = new TransactionBuffer(ctx);
         transactionBuffers.push_back(transactionBuffer);
+        if (ctx->transactionPersistS > 0) {
+            transactionBuffer->persistPath = statePath;
+            transactionBuffer->persistPrefix = name;
+        }
 
 
         // FORMAT
@@ -417,202 +700,12 @@ namespace OpenLogReplicator {
             static const std::vector<std::string> formatNames{
                 "db", "attributes", "interval-dts", "interval-ytm", "message", "rid", "xid", "timestamp",
                 "timestamp-tz", "timestamp-all", "char", "scn", "scn-type", "unknown", "schema", "column",
-                "unknown-type", "flush-buffer", "type"
+                "unknown-type", "raw", "flush-buffer", "type", "lob-store", "compact", "batch-rows", "batch-bytes"
             };
             Ctx::checkJsonFields(configFileName, formatJson, formatNames);
         }
 
-        Format::DB_FORMAT dbFormat = Format::DB_FORMAT::DEFAULT;
-        if (formatJson.HasMember("db")) {
-            const uint val = Ctx::getJsonFieldU64(configFileName, formatJson, "db");
-            if (val > 3)
-                throw ConfigurationException(
-                    30001,
-                    "bad JSON, invalid \"db\" value: " + std::to_string(val) + ", expected: one of {0 .. 3}");
-            dbFormat = static_cast<Format::DB_FORMAT>(val);
-        }
-
-        Format::ATTRIBUTES_FORMAT attributesFormat = Format::ATTRIBUTES_FORMAT::DEFAULT;
-        if (formatJson.HasMember("attributes")) {
-            const uint val = Ctx::getJsonFieldU64(configFileName, formatJson, "attributes");
-            if (val > 7)
-                throw ConfigurationException(
-                    30001,
-                    "bad JSON, invalid \"attributes\" value: " + std::to_string(val) +
-                    ", expected: one of {0 .. 7}");
-            attributesFormat = static_cast<Format::ATTRIBUTES_FORMAT>(val);
-        }
-
-        Format::INTERVAL_DTS_FORMAT intervalDtsFormat = Format::INTERVAL_DTS_FORMAT::UNIX_NANO;
-        if (formatJson.HasMember("interval-dts")) {
-            const uint val = Ctx::getJsonFieldU(configFileName, formatJson, "interval-dts");
-            if (val > 10)
-                throw ConfigurationException(
-                    30001,
-                    "bad JSON, invalid \"interval-dts\" value: " + std::to_string(val) +
-                    ", expected: one of {0 .. 10}");
-            intervalDtsFormat = static_cast<Format::INTERVAL_DTS_FORMAT>(val);
-        }
-
-        Format::INTERVAL_YTM_FORMAT intervalYtmFormat = Format::INTERVAL_YTM_FORMAT::MONTHS;
-        if (formatJson.HasMember("interval-ytm")) {
-            const uint val = Ctx::getJsonFieldU(configFileName, formatJson, "interval-ytm");
-            if (val > 4)
-                throw ConfigurationException(
-                    30001,
-                    "bad JSON, invalid \"interval-ytm\" value: " + std::to_string(val) +
-                    ", expected: one of {0 .. 4}");
-            intervalYtmFormat = static_cast<Format::INTERVAL_YTM_FORMAT>(val);
-        }
-
-        Format::MESSAGE_FORMAT messageFormat = Format::MESSAGE_FORMAT::DEFAULT;
-        if (formatJson.HasMember("message")) {
-            const uint val = Ctx::getJsonFieldU(configFileName, formatJson, "message");
-            if (val > 31)
-                throw ConfigurationException(
-                    30001,
-                    "bad JSON, invalid \"message\" value: " + std::to_string(val) + ", expected: one of {0 .. 31}");
-            if ((val & static_cast<uint>(Format::MESSAGE_FORMAT::FULL)) != 0 &&
-                (val & (static_cast<uint>(Format::MESSAGE_FORMAT::SKIP_BEGIN) |
-                        static_cast<uint>(Format::MESSAGE_FORMAT::SKIP_COMMIT))) != 0)
-                throw ConfigurationException(30001, "bad JSON, invalid \"message\" value: " + std::to_string(val) +
-                                                    ", expected: BEGIN/COMMIT flag is unset (" +
-                                                    std::to_string(
-                                                        static_cast<uint>(Format::MESSAGE_FORMAT::SKIP_BEGIN)) +
-                                                    "/" + std::to_string(
-                                                        static_cast<uint>(Format::MESSAGE_FORMAT::SKIP_COMMIT)) +
-                                                    ") together with FULL mode (" +
-                                                    std::to_string(static_cast<uint>(Format::MESSAGE_FORMAT::FULL))
-                                                    + ")");
-            messageFormat = static_cast<Format::MESSAGE_FORMAT>(val);
-        }
-
-        Format::RID_FORMAT ridFormat = Format::RID_FORMAT::SKIP;
-        if (formatJson.HasMember("rid")) {
-            const uint val = Ctx::getJsonFieldU(configFileName, formatJson, "rid");
-            if (val > 1)
-                throw ConfigurationException(
-                    30001, "bad JSON, invalid \"rid\" value: " + std::to_string(val) + ", expected: one of {0, 1}");
-            ridFormat = static_cast<Format::RID_FORMAT>(val);
-        }
-
-        Format::XID_FORMAT xidFormat = Format::XID_FORMAT::TEXT_HEX;
-        if (formatJson.HasMember("xid")) {
-            const uint val = Ctx::getJsonFieldU(configFileName, formatJson, "xid");
-            if (val > 2)
-                throw ConfigurationException(
-                    30001,
-                    "bad JSON, invalid \"xid\" value: " + std::to_string(val) + ", expected: one of {0 .. 2}");
-            xidFormat = static_cast<Format::XID_FORMAT>(val);
-        }
-
-        Format::TIMESTAMP_FORMAT timestampFormat = Format::TIMESTAMP_FORMAT::UNIX_NANO;
-        if (formatJson.HasMember("timestamp")) {
-            const uint val = Ctx::getJsonFieldU(configFileName, formatJson, "timestamp");
-            if (val > 15)
-                throw ConfigurationException(
-                    30001,
-                    "bad JSON, invalid \"timestamp\" value: " + std::to_string(val) +
-                    ", expected: one of {0 .. 15}");
-            timestampFormat = static_cast<Format::TIMESTAMP_FORMAT>(val);
-        }
-
-        Format::TIMESTAMP_TZ_FORMAT timestampTzFormat = Format::TIMESTAMP_TZ_FORMAT::UNIX_NANO_STRING;
-        if (formatJson.HasMember("timestamp-tz")) {
-            const uint val = Ctx::getJsonFieldU(configFileName, formatJson, "timestamp-tz");
-            if (val > 11)
-                throw ConfigurationException(
-                    30001,
-                    "bad JSON, invalid \"timestamp-tz\" value: " + std::to_string(val) +
-                    ", expected: one of {0 .. 11}");
-            timestampTzFormat = static_cast<Format::TIMESTAMP_TZ_FORMAT>(val);
-        }
-
-        Format::TIMESTAMP_ALL timestampAll = Format::TIMESTAMP_ALL::JUST_BEGIN;
-        if (formatJson.HasMember("timestamp-all")) {
-            const uint val = Ctx::getJsonFieldU64(configFileName, formatJson, "timestamp-all");
-            if (val > 1)
-                throw ConfigurationException(
-                    30001,
-                    "bad JSON, invalid \"timestamp-all\" value: " + std::to_string(val) +
-                    ", expected: one of {0, 1}");
-            timestampAll = static_cast<Format::TIMESTAMP_ALL>(val);
-        }
-
-        Format::CHAR_FORMAT charFormat = Format::CHAR_FORMAT::UTF8;
-        if (formatJson.HasMember("char")) {
-            const uint val = Ctx::getJsonFieldU(configFileName, formatJson, "char");
-            if (val > 3)
-                throw ConfigurationException(
-                    30001,
-                    "bad JSON, invalid \"char\" value: " + std::to_string(val) + ", expected: one of {0 .. 3}");
-            charFormat = static_cast<Format::CHAR_FORMAT>(val);
-        }
-
-        Format::SCN_FORMAT scnFormat = Format::SCN_FORMAT::NUMERIC;
-        if (formatJson.HasMember("scn")) {
-            const uint val = Ctx::getJsonFieldU(configFileName, formatJson, "scn");
-            if (val > 1)
-                throw ConfigurationException(
-                    30001, "bad JSON, invalid \"scn\" value: " + std::to_string(val) + ", expected: one of {0, 1}");
-            scnFormat = static_cast<Format::SCN_FORMAT>(val);
-        }
-
-        Format::SCN_TYPE scnType = Format::SCN_TYPE::NONE;
-        if (formatJson.HasMember("scn-type")) {
-            const uint val = Ctx::getJsonFieldU64(configFileName, formatJson, "scn-type");
-            if (val > 3)
-                throw ConfigurationException(
-                    30001,
-                    "bad JSON, invalid \"scn-type\" value: " + std::to_string(val) + ", expected: one of {0, 3}");
-            scnType = static_cast<Format::SCN_TYPE>(val);
-        }
-
-        Format::UNKNOWN_FORMAT unknownFormat = Format::UNKNOWN_FORMAT::QUESTION_MARK;
-        if (formatJson.HasMember("unknown")) {
-            const uint val = Ctx::getJsonFieldU(configFileName, formatJson, "unknown");
-            if (val > 1)
-                throw ConfigurationException(
-                    30001,
-                    "bad JSON, invalid \"unknown\" value: " + std::to_string(val) + ", expected: one of {0, 1}");
-            unknownFormat = static_cast<Format::UNKNOWN_FORMAT>(val);
-        }
-
-        Format::SCHEMA_FORMAT schemaFormat = Format::SCHEMA_FORMAT::DEFAULT;
-        if (formatJson.HasMember("schema")) {
-            const uint val = Ctx::getJsonFieldU(configFileName, formatJson, "schema");
-            if (val > 7)
-                throw ConfigurationException(
-                    30001,
-                    "bad JSON, invalid \"schema\" value: " + std::to_string(val) + ", expected: one of {0 .. 7}");
-            schemaFormat = static_cast<Format::SCHEMA_FORMAT>(val);
-        }
-
-        Format::COLUMN_FORMAT columnFormat = Format::COLUMN_FORMAT::CHANGED;
-        if (formatJson.HasMember("column")) {
-            const uint val = Ctx::getJsonFieldU(configFileName, formatJson, "column");
-            if (val > 2)
-                throw ConfigurationException(
-                    30001,
-                    "bad JSON, invalid \"column\" value: " + std::to_string(val) + ", expected: one of {0 .. 2}");
-
-            if (ctx->isFlagSet(Ctx::REDO_FLAGS::SCHEMALESS) && val != 0)
-                throw ConfigurationException(30001, "bad JSON, invalid \"column\" value: " + std::to_string(val) +
-                                                    ", expected: not used when flags has set schemaless mode (flags: "
-                                                    + std::to_string(ctx->flags) + ")");
-            columnFormat = static_cast<Format::COLUMN_FORMAT>(val);
-        }
-
-        Format::UNKNOWN_TYPE unknownType = Format::UNKNOWN_TYPE::HIDE;
-        if (formatJson.HasMember("unknown-type")) {
-            const uint val = Ctx::getJsonFieldU(configFileName, formatJson, "unknown-type");
-            if (val > 1)
-                throw ConfigurationException(
-                    30001,
-                    "bad JSON, invalid \"unknown-type\" value: " + std::to_string(val) +
-                    ", expected: one of {0, 1}");
-            unknownType = static_cast<Format::UNKNOWN_TYPE>(val);
-        }
+        Format format = Format::parseJson(ctx, configFileName, formatJson);
 
         uint64_t flushBuffer = 1048576;
         if (formatJson.HasMember("flush-buffer"))
@@ -622,23 +715,60 @@ namespace OpenLogReplicator {
                                                           "type");
 
         Builder *builder;
-        Format format(dbFormat, attributesFormat, intervalDtsFormat, intervalYtmFormat, messageFormat, ridFormat,
-                      xidFormat, timestampFormat,
-                      timestampTzFormat, timestampAll, charFormat, scnFormat, scnType, unknownFormat, schemaFormat,
-                      columnFormat, unknownType);
         if (formatType == "json") {
             builder = new BuilderJson(ctx, locales, metadata, format, flushBuffer);
         } else if (formatType == "protobuf") {
 #ifdef LINK_LIBRARY_PROTOBUF
+            if (ctx->transactionStreamSize > 0)
+                throw ConfigurationException(30001, "bad JSON, invalid \"format\" value: " + formatType +
+                                                    R"(, expected: "json" when "transaction-stream-mb" is set)");
             builder = new BuilderProtobuf(ctx, locales, metadata, format, flushBuffer);
 #else
                 throw ConfigurationException(30001, "bad JSON, invalid \"format\" value: " + formatType +
                                              ", expected: not \"protobuf\" since the code is not compiled");
 #endif /* LINK_LIBRARY_PROTOBUF */
+        } else if (formatType == "avro") {
+            if (ctx->transactionStreamSize > 0)
+                throw ConfigurationException(30001, "bad JSON, invalid \"format\" value: " + formatType +
+                                                    R"(, expected: "json" when "transaction-stream-mb" is set)");
+            if (format.isMessageFormatFull())
+                throw ConfigurationException(30001, "bad JSON, invalid \"format\" value: " + formatType +
+                                                    ", expected: a message per row, \"message\" without the full transaction flag");
+            builder = new BuilderAvro(ctx, locales, metadata, format, flushBuffer);
         } else
             throw ConfigurationException(
-                30001, "bad JSON, invalid \"format\" value: " + formatType + R"(, expected: "protobuf" or "json")");
+                30001, "bad JSON, invalid \"format\" value: " + formatType + R"(, expected: "protobuf", "avro" or "json")");
         builders.push_back(builder);
+        checkpoint->setBuilder(builder);
+
+        if (formatJson.HasMember("lob-store")) {
+            const rapidjson::Value &lobStoreJson = Ctx::getJsonFieldO(configFileName, formatJson, "lob-store");
+
+            if (!ctx->isDisableChecksSet(Ctx::DISABLE_CHECKS::JSON_TAGS)) {
+                static const std::vector<std::string> lobStoreNames{"path", "min-size", "queue-mb"};
+                Ctx::checkJsonFields(configFileName, lobStoreJson, lobStoreNames);
+            }
+
+            const std::string lobStorePath = Ctx::getJsonFieldS(configFileName, Ctx::MAX_PATH_LENGTH, lobStoreJson, "path");
+
+            uint64_t lobStoreMinSize = 1048576;
+            if (lobStoreJson.HasMember("min-size"))
+                lobStoreMinSize = Ctx::getJsonFieldU64(configFileName, lobStoreJson, "min-size");
+
+            uint64_t lobStoreQueueMb = 64;
+            if (lobStoreJson.HasMember("queue-mb")) {
+                lobStoreQueueMb = Ctx::getJsonFieldU64(configFileName, lobStoreJson, "queue-mb");
+                if (lobStoreQueueMb < 1 || lobStoreQueueMb > memoryMaxMb)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"queue-mb\" value: " + std::to_string(lobStoreQueueMb) +
+                                                        ", expected: one of {1 .. " + std::to_string(memoryMaxMb) + "}");
+            }
+
+            auto *lobStore = new LobStore(ctx, alias + "-lob", lobStorePath, lobStoreMinSize, lobStoreQueueMb * 1024 * 1024);
+            lobStores.push_back(lobStore);
+            lobStore->initialize();
+            builder->lobStore = lobStore;
+            ctx->spawnThread(lobStore);
+        }
 
         // READER
         const std::string readerType = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, readerJson,
@@ -648,6 +778,14 @@ namespace OpenLogReplicator {
         if (sourceJson.HasMember("redo-read-sleep-us"))
             ctx->redoReadSleepUs = Ctx::getJsonFieldU64(configFileName, sourceJson, "redo-read-sleep-us");
 
+        if (sourceJson.HasMember("redo-read-sleep-max-us")) {
+            ctx->redoReadSleepMaxUs = Ctx::getJsonFieldU64(configFileName, sourceJson, "redo-read-sleep-max-us");
+            if (ctx->redoReadSleepMaxUs < ctx->redoReadSleepUs || ctx->redoReadSleepMaxUs > 60000000)
+                throw ConfigurationException(30001, "bad JSON, invalid \"redo-read-sleep-max-us\" value: " +
+                                                    std::to_string(ctx->redoReadSleepMaxUs) + ", expected: one of {" +
+                                                    std::to_string(ctx->redoReadSleepUs) + " .. 60000000}");
+        }
+
         if (sourceJson.HasMember("arch-read-sleep-us"))
             ctx->archReadSleepUs = Ctx::getJsonFieldU64(configFileName, sourceJson, "arch-read-sleep-us");
 
@@ -659,16 +797,213 @@ namespace OpenLogReplicator {
                                                     ", expected: one of: {1 .. 1000000000}");
         }
 
+        if (sourceJson.HasMember("parser-threads")) {
+            ctx->parserThreads = Ctx::getJsonFieldU(configFileName, sourceJson, "parser-threads");
+            if (ctx->parserThreads > 32)
+                throw ConfigurationException(30001, "bad JSON, invalid \"parser-threads\" value: " + std::to_string(ctx->parserThreads) +
+                                                    ", expected: one of {0 .. 32}");
+        }
+
+        if (sourceJson.HasMember("lwn-prefetch")) {
+            ctx->lwnPrefetch = Ctx::getJsonFieldU(configFileName, sourceJson, "lwn-prefetch");
+            if (ctx->lwnPrefetch > 64)
+                throw ConfigurationException(30001, "bad JSON, invalid \"lwn-prefetch\" value: " + std::to_string(ctx->lwnPrefetch) +
+                                                    ", expected: one of {0 .. 64}");
+        }
+
+        if (sourceJson.HasMember("commit-flush-queue")) {
+            ctx->commitFlushQueue = Ctx::getJsonFieldU64(configFileName, sourceJson, "commit-flush-queue");
+            if (ctx->commitFlushQueue > 1000000)
+                throw ConfigurationException(30001, "bad JSON, invalid \"commit-flush-queue\" value: " + std::to_string(ctx->commitFlushQueue) +
+                                                    ", expected: one of {0 .. 1000000}");
+        }
+
         if (sourceJson.HasMember("redo-verify-delay-us"))
             ctx->redoVerifyDelayUs = Ctx::getJsonFieldU64(configFileName, sourceJson, "redo-verify-delay-us");
 
         if (sourceJson.HasMember("refresh-interval-us"))
             ctx->refreshIntervalUs = Ctx::getJsonFieldU64(configFileName, sourceJson, "refresh-interval-us");
 
+        if (readerJson.HasMember("io-engine")) {
+            const std::string ioEngine = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, readerJson, "io-engine");
+            if (ioEngine == "uring") {
+#ifdef LINK_LIBRARY_LIBURING
+                ctx->readIoUring = true;
+#else
+                throw ConfigurationException(30001, R"(bad JSON, invalid "io-engine" value: uring, expected: not "uring" since the code is not compiled)");
+#endif /* LINK_LIBRARY_LIBURING */
+            } else if (ioEngine == "mmap") {
+                ctx->readMmap = true;
+            } else if (ioEngine != "pread")
+                throw ConfigurationException(30001, "bad JSON, invalid \"io-engine\" value: " + ioEngine +
+                                                    R"(, expected: one of {"pread", "uring", "mmap"})");
+        }
+
+        if (readerJson.HasMember("hedged-read")) {
+            const uint hedgedRead = Ctx::getJsonFieldU(configFileName, readerJson, "hedged-read");
+            if (hedgedRead > 1)
+                throw ConfigurationException(30001, "bad JSON, invalid \"hedged-read\" value: " + std::to_string(hedgedRead) +
+                                                    ", expected: one of {0, 1}");
+            ctx->readHedged = (hedgedRead == 1);
+        }
+
+        if (readerJson.HasMember("position-index")) {
+            const uint positionIndex = Ctx::getJsonFieldU(configFileName, readerJson, "position-index");
+            if (positionIndex > 1)
+                throw ConfigurationException(30001, "bad JSON, invalid \"position-index\" value: " + std::to_string(positionIndex) +
+                                                    ", expected: one of {0, 1}");
+            ctx->positionCatalog = (positionIndex == 1);
+        }
+
+        if (readerJson.HasMember("arch-compressed")) {
+            const uint archCompressed = Ctx::getJsonFieldU(configFileName, readerJson, "arch-compressed");
+            if (archCompressed > 1)
+                throw ConfigurationException(30001, "bad JSON, invalid \"arch-compressed\" value: " + std::to_string(archCompressed) +
+                                                    ", expected: one of {0, 1}");
+#if defined(LINK_LIBRARY_ZSTD) || defined(LINK_LIBRARY_ZLIB)
+            ctx->archCompressed = (archCompressed == 1);
+#else
+            if (archCompressed == 1)
+                throw ConfigurationException(30001, R"(bad JSON, invalid "arch-compressed" value: 1, expected: 0 since the code is not compiled with zstd or zlib)");
+#endif
+        }
+
+        if (readerJson.HasMember("object-store")) {
+            const rapidjson::Value& objectStoreJson = Ctx::getJsonFieldO(configFileName, readerJson, "object-store");
+
+            if (!ctx->isDisableChecksSet(Ctx::DISABLE_CHECKS::JSON_TAGS)) {
+                static const std::vector<std::string> objectStoreNames{
+                    "endpoint", "region", "access-key", "secret-key", "streams", "range-mb"
+                };
+                Ctx::checkJsonFields(configFileName, objectStoreJson, objectStoreNames);
+            }
+
+            if (objectStoreJson.HasMember("endpoint"))
+                ctx->objectStoreEndpoint = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, objectStoreJson, "endpoint");
+            if (objectStoreJson.HasMember("region"))
+                ctx->objectStoreRegion = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, objectStoreJson, "region");
+            if (objectStoreJson.HasMember("access-key"))
+                ctx->objectStoreAccessKey = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, objectStoreJson, "access-key");
+            if (objectStoreJson.HasMember("secret-key"))
+                ctx->objectStoreSecretKey = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, objectStoreJson, "secret-key");
+
+            if (objectStoreJson.HasMember("streams")) {
+                ctx->objectStoreStreams = Ctx::getJsonFieldU(configFileName, objectStoreJson, "streams");
+                if (ctx->objectStoreStreams < 1 || ctx->objectStoreStreams > 32)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"streams\" value: " + std::to_string(ctx->objectStoreStreams) +
+                                                        ", expected: one of {1 .. 32}");
+            }
+
+            if (objectStoreJson.HasMember("range-mb")) {
+                ctx->objectStoreRangeMb = Ctx::getJsonFieldU64(configFileName, objectStoreJson, "range-mb");
+                if (ctx->objectStoreRangeMb < 1 || ctx->objectStoreRangeMb > 256)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"range-mb\" value: " + std::to_string(ctx->objectStoreRangeMb) +
+                                                        ", expected: one of {1 .. 256}");
+            }
+            ctx->objectStore = true;
+        }
+
+        if (readerJson.HasMember("queue-depth")) {
+            ctx->readQueueDepth = Ctx::getJsonFieldU(configFileName, readerJson, "queue-depth");
+            if (ctx->readQueueDepth < 1 || ctx->readQueueDepth > 64)
+                throw ConfigurationException(30001, "bad JSON, invalid \"queue-depth\" value: " + std::to_string(ctx->readQueueDepth) +
+                                                    ", expected: one of {1 .. 64}");
+        }
+
+        if (readerJson.HasMember("arch-prefetch")) {
+            ctx->archPrefetch = Ctx::getJsonFieldU(configFileName, readerJson, "arch-prefetch");
+            if (ctx->archPrefetch > 4)
+                throw ConfigurationException(30001, "bad JSON, invalid \"arch-prefetch\" value: " + std::to_string(ctx->archPrefetch) +
+                                                    ", expected: one of {0 .. 4}");
+        }
+
+        if (readerJson.HasMember("arch-parsers")) {
+            ctx->archParsers = Ctx::getJsonFieldU(configFileName, readerJson, "arch-parsers");
+            if (ctx->archParsers > ctx->archPrefetch)
+                throw ConfigurationException(30001, "bad JSON, invalid \"arch-parsers\" value: " + std::to_string(ctx->archParsers) +
+                                                    ", expected: one of {0 .. " + std::to_string(ctx->archPrefetch) + "}, not more than \"arch-prefetch\"");
+        }
+
+        if (readerJson.HasMember("dictionary-threads")) {
+            ctx->dictionaryThreads = Ctx::getJsonFieldU(configFileName, readerJson, "dictionary-threads");
+            if (ctx->dictionaryThreads < 1 || ctx->dictionaryThreads > 32)
+                throw ConfigurationException(30001, "bad JSON, invalid \"dictionary-threads\" value: " + std::to_string(ctx->dictionaryThreads) +
+                                                    ", expected: one of {1 .. 32}");
+        }
+
+        if (readerJson.HasMember("dictionary-prefetch-rows")) {
+            ctx->dictionaryPrefetchRows = Ctx::getJsonFieldU(configFileName, readerJson, "dictionary-prefetch-rows");
+            if (ctx->dictionaryPrefetchRows > 1000000)
+                throw ConfigurationException(30001, "bad JSON, invalid \"dictionary-prefetch-rows\" value: " +
+                                                    std::to_string(ctx->dictionaryPrefetchRows) + ", expected: one of {0 .. 1000000}");
+        }
+
+        if (readerJson.HasMember("schema-verify-interval-s")) {
+            ctx->schemaVerifyIntervalS = Ctx::getJsonFieldU64(configFileName, readerJson, "schema-verify-interval-s");
+            if (ctx->schemaVerifyIntervalS > 86400)
+                throw ConfigurationException(30001, "bad JSON, invalid \"schema-verify-interval-s\" value: " +
+                                                    std::to_string(ctx->schemaVerifyIntervalS) + ", expected: one of {0 .. 86400}");
+        }
+
+        if (readerJson.HasMember("snapshot-threads")) {
+            ctx->snapshotThreads = Ctx::getJsonFieldU(configFileName, readerJson, "snapshot-threads");
+            if (ctx->snapshotThreads < 1 || ctx->snapshotThreads > 32)
+                throw ConfigurationException(30001, "bad JSON, invalid \"snapshot-threads\" value: " + std::to_string(ctx->snapshotThreads) +
+                                                    ", expected: one of {1 .. 32}");
+        }
+
         if (readerJson.HasMember("redo-copy-path"))
             ctx->redoCopyPath = Ctx::getJsonFieldS(configFileName, Ctx::MAX_PATH_LENGTH, readerJson,
                                                    "redo-copy-path");
 
+        if (readerJson.HasMember("redo-copy-compression")) {
+            const std::string redoCopyCompression = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, readerJson,
+                                                                       "redo-copy-compression");
+            if (redoCopyCompression == "lz4") {
+#ifdef LINK_LIBRARY_LZ4
+                ctx->redoCopyCompress = true;
+#else
+                throw ConfigurationException(30001, R"(bad JSON, invalid "redo-copy-compression" value: lz4, expected: not "lz4" since the code is not compiled)");
+#endif /* LINK_LIBRARY_LZ4 */
+            } else if (redoCopyCompression != "none")
+                throw ConfigurationException(30001, "bad JSON, invalid \"redo-copy-compression\" value: " + redoCopyCompression +
+                                                    R"(, expected: one of {"none", "lz4"})");
+        }
+
+        if (readerJson.HasMember("redo-relay")) {
+            const uint redoRelay = Ctx::getJsonFieldU(configFileName, readerJson, "redo-relay");
+            if (redoRelay > 1)
+                throw ConfigurationException(30001, "bad JSON, invalid \"redo-relay\" value: " + std::to_string(redoRelay) +
+                                                    ", expected: one of {0, 1}");
+            if (redoRelay == 1 && (ctx->redoCopyPath.empty() || ctx->redoCopyCompress))
+                throw ConfigurationException(30001, "bad JSON, invalid \"redo-relay\" value: 1, expected: 0 without \"redo-copy-path\" or with"
+                                                    " \"redo-copy-compression\" other than \"none\"");
+            ctx->redoRelay = (redoRelay == 1);
+        }
+
+        if (readerJson.HasMember("relay-url")) {
+            ctx->relayUrl = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, readerJson, "relay-url");
+            if (readerType != "offline")
+                throw ConfigurationException(30001, "bad JSON, invalid \"relay-url\" value: " + ctx->relayUrl +
+                                                    R"(, expected: unset for reader "type" other than "offline")");
+            if (ctx->relayUrl.rfind("http://", 0) != 0 && ctx->relayUrl.rfind("https://", 0) != 0)
+                throw ConfigurationException(30001, "bad JSON, invalid \"relay-url\" value: " + ctx->relayUrl +
+                                                    R"(, expected: "http://" or "https://" URL)");
+            while (ctx->relayUrl.back() == '/')
+                ctx->relayUrl.pop_back();
+        }
+
+        if (readerJson.HasMember("redo-cache-path"))
+            ctx->redoCachePath = Ctx::getJsonFieldS(configFileName, Ctx::MAX_PATH_LENGTH, readerJson,
+                                                    "redo-cache-path");
+
+        if (readerJson.HasMember("redo-cache-max-mb")) {
+            ctx->redoCacheMaxMb = Ctx::getJsonFieldU64(configFileName, readerJson, "redo-cache-max-mb");
+            if (ctx->redoCacheMaxMb < 16)
+                throw ConfigurationException(30001, "bad JSON, invalid \"redo-cache-max-mb\" value: " + std::to_string(ctx->redoCacheMaxMb) +
+                                                    ", expected: at least 16");
+        }
+
         if (readerJson.HasMember("db-timezone")) {
             const std::string dbTimezone = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH,
                                                               readerJson, "db-timezone");
@@ -733,15 +1068,124 @@ namespace OpenLogReplicator {
                     archGetLog = ReplicatorRacOnline::archGetLogOnline;
                 }
 
+            if (readerJson.HasMember("asm")) {
+                const rapidjson::Value& asmJson = Ctx::getJsonFieldO(configFileName, readerJson, "asm");
+
+                if (!ctx->isDisableChecksSet(Ctx::DISABLE_CHECKS::JSON_TAGS)) {
+                    static const std::vector<std::string> asmNames{
+                        "mode", "user", "password", "server", "sysasm", "sessions", "range-mb", "transport-compression", "transport-level",
+                        "transport-threads"
+                    };
+                    Ctx::checkJsonFields(configFileName, asmJson, asmNames);
+                }
+
+                if (asmJson.HasMember("mode")) {
+                    const std::string asmMode = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, asmJson, "mode");
+                    if (asmMode == "database")
+                        ctx->asmDatabase = true;
+                    else if (asmMode != "ssh")
+                        throw ConfigurationException(30001, "bad JSON, invalid \"mode\" value: " + asmMode +
+                                                            ", expected: one of {\"ssh\", \"database\"}");
+                }
+
+                // The database instance serves DBMS_DISKGROUP as well, the ASM instance needs its own user connecting as SYSASM
+                ctx->asmUser = user;
+                ctx->asmPassword = password;
+                ctx->asmServer = server;
+                if (asmJson.HasMember("user"))
+                    ctx->asmUser = Ctx::getJsonFieldS(configFileName, Ctx::JSON_USERNAME_LENGTH, asmJson, "user");
+                if (asmJson.HasMember("password"))
+                    ctx->asmPassword = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PASSWORD_LENGTH, asmJson, "password");
+                if (asmJson.HasMember("server"))
+                    ctx->asmServer = Ctx::getJsonFieldS(configFileName, Ctx::JSON_SERVER_LENGTH, asmJson, "server");
+
+                if (asmJson.HasMember("sysasm")) {
+                    const uint sysAsm = Ctx::getJsonFieldU(configFileName, asmJson, "sysasm");
+                    if (sysAsm > 1)
+                        throw ConfigurationException(30001, "bad JSON, invalid \"sysasm\" value: " + std::to_string(sysAsm) +
+                                                            ", expected: one of {0, 1}");
+                    ctx->asmSysAsm = sysAsm == 1;
+                }
+
+                if (asmJson.HasMember("sessions")) {
+                    ctx->asmSessions = Ctx::getJsonFieldU(configFileName, asmJson, "sessions");
+                    if (ctx->asmSessions > 32)
+                        throw ConfigurationException(30001, "bad JSON, invalid \"sessions\" value: " + std::to_string(ctx->asmSessions) +
+                                                            ", expected: one of {0 .. 32}");
+                }
+
+                if (asmJson.HasMember("range-mb")) {
+                    ctx->asmRangeMb = Ctx::getJsonFieldU64(configFileName, asmJson, "range-mb");
+                    if (ctx->asmRangeMb < 1 || ctx->asmRangeMb > 256)
+                        throw ConfigurationException(30001, "bad JSON, invalid \"range-mb\" value: " + std::to_string(ctx->asmRangeMb) +
+                                                            ", expected: one of {1 .. 256}");
+                }
+
+                uint transportLevelMax = 0;
+                if (asmJson.HasMember("transport-compression")) {
+                    const std::string transportCompression = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, asmJson,
+                                                                                "transport-compression");
+                    if (transportCompression == "zstd") {
+#ifdef LINK_LIBRARY_ZSTD
+                        ctx->asmTransportCompression = Ctx::TRANSPORT_COMPRESSION::ZSTD;
+                        transportLevelMax = 19;
+#else
+                        throw ConfigurationException(30001, R"(bad JSON, invalid "transport-compression" value: zstd, expected: not "zstd" since the code is not compiled)");
+#endif /* LINK_LIBRARY_ZSTD */
+                    } else if (transportCompression == "lz4") {
+#ifdef LINK_LIBRARY_LZ4
+                        ctx->asmTransportCompression = Ctx::TRANSPORT_COMPRESSION::LZ4;
+                        transportLevelMax = 12;
+#else
+                        throw ConfigurationException(30001, R"(bad JSON, invalid "transport-compression" value: lz4, expected: not "lz4" since the code is not compiled)");
+#endif /* LINK_LIBRARY_LZ4 */
+                    } else if (transportCompression != "none")
+                        throw ConfigurationException(30001, "bad JSON, invalid \"transport-compression\" value: " + transportCompression +
+                                                            R"(, expected: one of {"none", "zstd", "lz4"})");
+                }
+
+                if (asmJson.HasMember("transport-level")) {
+                    ctx->asmTransportLevel = Ctx::getJsonFieldU(configFileName, asmJson, "transport-level");
+                    if (ctx->asmTransportLevel > transportLevelMax)
+                        throw ConfigurationException(30001, "bad JSON, invalid \"transport-level\" value: " +
+                                                            std::to_string(ctx->asmTransportLevel) + ", expected: one of {0 .. " +
+                                                            std::to_string(transportLevelMax) + "}");
+                }
+
+                if (asmJson.HasMember("transport-threads")) {
+                    ctx->asmTransportThreads = Ctx::getJsonFieldU(configFileName, asmJson, "transport-threads");
+                    if (ctx->asmTransportThreads > 64)
+                        throw ConfigurationException(30001, "bad JSON, invalid \"transport-threads\" value: " +
+                                                            std::to_string(ctx->asmTransportThreads) + ", expected: one of {0 .. 64}");
+                }
+            }
+
             if (instId != -1) {
                 replicator = new ReplicatorRacOnline(instId, ctx, archGetLog, builder, metadata, transactionBuffer, alias, name,
                                                      user, password, server, keepConnection);
-                if (readerJson.HasMember("asm")) {
+                if (readerJson.HasMember("asm") && !ctx->asmDatabase) {
                     dynamic_cast<ReplicatorRacOnline*>(replicator)->setAsm(true);
                 }
+                replicator->racCoordinator = racCoordinator;
+                replicator->racInstance = racCoordinator->registerInstance();
+
+                RacArchiveLogList *&racArchiveLogList = racArchiveLogLists[racCoordinator];
+                if (racArchiveLogList == nullptr)
+                    racArchiveLogList = new RacArchiveLogList();
+                dynamic_cast<ReplicatorRacOnline*>(replicator)->racArchiveLogList = racArchiveLogList;
             } else
                 replicator = new ReplicatorOnline(ctx, archGetLog, builder, metadata, transactionBuffer, alias, name,
                                                   user, password, server, keepConnection);
+
+            if (readerJson.HasMember("online-redo-discovery")) {
+                const std::string onlineRedoDiscovery = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, readerJson,
+                                                                           "online-redo-discovery");
+                if (onlineRedoDiscovery == "header")
+                    dynamic_cast<ReplicatorOnline*>(replicator)->headerDiscovery = true;
+                else if (onlineRedoDiscovery != "database")
+                    throw ConfigurationException(30001, "bad JSON, invalid \"online-redo-discovery\" value: " + onlineRedoDiscovery +
+                                                        ", expected: one of {\"database\", \"header\"}");
+            }
             builder->initialize();
             replicator->initialize();
             mainProcessMapping(readerJson);
@@ -750,6 +1194,8 @@ namespace OpenLogReplicator {
                                                     ", expected: not \"online\" since the code is not compiled");
 #endif /*LINK_LIBRARY_OCI*/
         } else if (readerType == "offline") {
+            if (!ctx->relayUrl.empty())
+                archGetLog = Replicator::archGetLogRelay;
             replicator = new Replicator(ctx, archGetLog, builder, metadata, transactionBuffer, alias, name);
             builder->initialize();
             replicator->initialize();
@@ -757,6 +1203,8 @@ namespace OpenLogReplicator {
         } else if (readerType == "batch") {
             archGetLog = Replicator::archGetLogList;
             replicator = new ReplicatorBatch(ctx, archGetLog, builder, metadata, transactionBuffer, alias, name);
+            replicator->shardCoordinator = shardCoordinator;
+            replicator->shard = shard;
             builder->initialize();
             replicator->initialize();
 
@@ -766,12 +1214,36 @@ namespace OpenLogReplicator {
             for (rapidjson::SizeType k = 0; k < redoLogBatchArrayJson.Size(); ++k)
                 replicator->addRedoLogsBatch(
                     Ctx::getJsonFieldS(configFileName, Ctx::MAX_PATH_LENGTH, redoLogBatchArrayJson, "redo-log", k));
+
+            // The logs are only profiled, the report is written when all of them are processed
+            if (readerJson.HasMember("profile")) {
+                if (shardCoordinator != nullptr)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"profile\" value: set for a sharded source, expected: "
+                                                        "not used with \"shards\"");
+
+                const rapidjson::Value &profileJson = Ctx::getJsonFieldO(configFileName, readerJson, "profile");
+
+                if (!ctx->isDisableChecksSet(Ctx::DISABLE_CHECKS::JSON_TAGS)) {
+                    static const std::vector<std::string> profileNames{"output", "memory-max-mb"};
+                    Ctx::checkJsonFields(configFileName, profileJson, profileNames);
+                }
+
+                const std::string output = Ctx::getJsonFieldS(configFileName, Ctx::MAX_PATH_LENGTH, profileJson, "output");
+                uint64_t profileMemoryMaxMb = 0;
+                if (profileJson.HasMember("memory-max-mb"))
+                    profileMemoryMaxMb = Ctx::getJsonFieldU64(configFileName, profileJson, "memory-max-mb");
+                ctx->redoProfile = new RedoProfile(ctx, output, profileMemoryMaxMb);
+            }
         } else
             throw ConfigurationException(
                 30001,
                 "bad JSON, invalid \"type\" value: " + readerType +
                 R"(, expected: one of {"online", "offline", "batch"})");
 
+        if (readerJson.HasMember("profile") && readerType != "batch")
+            throw ConfigurationException(30001, "bad JSON, invalid \"profile\" value: set for reader type: " + readerType +
+                                                R"(, expected: only for "batch")");
+
         if (sourceJson.HasMember("filter")) {
             const rapidjson::Value &filterJson = Ctx::getJsonFieldO(configFileName, sourceJson, "filter");
 
@@ -794,7 +1266,7 @@ namespace OpenLogReplicator {
 
                     if (!ctx->isDisableChecksSet(Ctx::DISABLE_CHECKS::JSON_TAGS)) {
                         static const std::vector<std::string> tableElementNames{
-                            "owner", "table", "key", "condition", "tag"
+                            "owner", "table", "key", "condition", "tag", "columns", "skip-columns", "snapshot"
                         };
                         Ctx::checkJsonFields(configFileName, tableElementJson, tableElementNames);
                     }
@@ -822,6 +1294,26 @@ namespace OpenLogReplicator {
                                                           "tag");
                         element->parseTag(element->tag, separator);
                     }
+
+                    if (tableElementJson.HasMember("columns")) {
+                        element->columns = Ctx::getJsonFieldS(configFileName, Ctx::JSON_KEY_LENGTH, tableElementJson,
+                                                              "columns");
+                        SchemaElement::parseColumns(element->columns, separator, element->columnList);
+                    }
+
+                    if (tableElementJson.HasMember("skip-columns")) {
+                        element->skipColumns = Ctx::getJsonFieldS(configFileName, Ctx::JSON_KEY_LENGTH, tableElementJson,
+                                                                  "skip-columns");
+                        SchemaElement::parseColumns(element->skipColumns, separator, element->skipColumnList);
+                    }
+
+                    if (tableElementJson.HasMember("snapshot")) {
+                        const uint snapshot = Ctx::getJsonFieldU(configFileName, tableElementJson, "snapshot");
+                        if (snapshot > 1)
+                            throw ConfigurationException(30001, "bad JSON, invalid \"snapshot\" value: " + std::to_string(snapshot) +
+                                                                ", expected: one of {0, 1}");
+                        element->snapshot = snapshot == 1;
+                    }
                 }
             }
 
@@ -860,7 +1352,7 @@ namespace OpenLogReplicator {
         replicator = nullptr;
     }
 
-    Writer* OpenLogReplicator::createWriter(Replicator *replicator2, const rapidjson::Value &targetJson) {
+    Writer* OpenLogReplicator::createWriter(Replicator *replicator2, const rapidjson::Value &targetJson, int shard) {
         const std::string alias = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, targetJson,
                                                      "alias");
         const std::string source = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, targetJson,
@@ -878,7 +1370,13 @@ namespace OpenLogReplicator {
             static const std::vector<std::string> writerNames{
                 "type", "poll-interval-us", "queue-size", "max-file-size", "timestamp-format", "output",
                 "new-line", "append", "max-message-mb", "topic", "properties", "uri",
-                "write-buffer-flush-size"
+                "write-buffer-flush-size", "zero-copy", "fsync-interval-us", "fsync-size",
+                "compression", "compression-level", "compression-dictionary", "name", "ring-size-mb", "table-topics", "partition-by", "poll-messages",
+                "transaction-messages", "checkpoint-topic", "batch-bytes", "batch-latency-us",
+                "max-clients", "max-lag-messages", "tcp-nodelay", "tcp-cork", "send-buffer-bytes", "keepalive-s",
+                "tls-cert", "tls-key", "tls-ca", "tls-ktls", "row-group-rows", "max-file-age-s", "record-headers", "producers",
+                "buffer-mb", "client-buffer-mb", "preallocate", "direct-io", "partitions",
+                "io-threads", "rate-limit"
             };
             Ctx::checkJsonFields(configFileName, writerJson, writerNames);
         }
@@ -917,6 +1415,18 @@ namespace OpenLogReplicator {
                                                     ", expected: to be set when \"max-file-size\" is set (" +
                                                     std::to_string(maxFileSize) + ")");
 
+            // Every shard writes its own files, the shard number goes before the extension
+            if (shard >= 0) {
+                if (output.empty())
+                    throw ConfigurationException(30001, "bad JSON, invalid \"output\" value: " + output +
+                                                        ", expected: to be set for a source with \"shards\" set");
+                const size_t nameStart = output.find_last_of('/') == std::string::npos ? 0 : output.find_last_of('/') + 1;
+                size_t extension = output.find_last_of('.');
+                if (extension == std::string::npos || extension <= nameStart)
+                    extension = output.length();
+                output.insert(extension, "-shard" + std::to_string(shard));
+            }
+
             uint64_t newLine = 1;
             if (writerJson.HasMember("new-line")) {
                 newLine = Ctx::getJsonFieldU64(configFileName, writerJson, "new-line");
@@ -945,23 +1455,227 @@ namespace OpenLogReplicator {
                                                         std::to_string(writeBufferFlushSize) +
                                                         ", expected: one of {0 .. 1048576}");
             }
+
+            uint64_t zeroCopy = 0;
+            if (writerJson.HasMember("zero-copy")) {
+                zeroCopy = Ctx::getJsonFieldU64(configFileName, writerJson, "zero-copy");
+                if (zeroCopy > 1)
+                    throw ConfigurationException(
+                        30001,
+                        "bad JSON, invalid \"zero-copy\" value: " + std::to_string(zeroCopy) +
+                        ", expected: one of {0, 1}");
+            }
+
+            uint64_t fsyncIntervalUs = 0;
+            if (writerJson.HasMember("fsync-interval-us")) {
+                fsyncIntervalUs = Ctx::getJsonFieldU64(configFileName, writerJson, "fsync-interval-us");
+                if (fsyncIntervalUs < 100 || fsyncIntervalUs > 3600000000)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"fsync-interval-us\" value: " +
+                                                        std::to_string(fsyncIntervalUs) +
+                                                        ", expected: one of {100 .. 3600000000}");
+                if (output.empty())
+                    throw ConfigurationException(30001, "bad JSON, invalid \"output\" value: " + output +
+                                                        ", expected: to be set when \"fsync-interval-us\" is set (" +
+                                                        std::to_string(fsyncIntervalUs) + ")");
+            }
+
+            uint64_t fsyncSize = 0;
+            if (writerJson.HasMember("fsync-size")) {
+                fsyncSize = Ctx::getJsonFieldU64(configFileName, writerJson, "fsync-size");
+                if (fsyncIntervalUs == 0)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"fsync-size\" value: " +
+                                                        std::to_string(fsyncSize) +
+                                                        ", expected: \"fsync-interval-us\" to be set");
+            }
+
+            WriterFile::COMPRESSION compression = WriterFile::COMPRESSION::NONE;
+            if (writerJson.HasMember("compression")) {
+                const std::string compressionStr = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, writerJson,
+                                                                      "compression");
+                if (compressionStr == "lz4") {
+#ifdef LINK_LIBRARY_LZ4
+                    compression = WriterFile::COMPRESSION::LZ4;
+#else
+                    throw ConfigurationException(30001, R"(bad JSON, invalid "compression" value: lz4, expected: not "lz4" since the code is not compiled)");
+#endif /* LINK_LIBRARY_LZ4 */
+                } else if (compressionStr != "none")
+                    throw ConfigurationException(30001, "bad JSON, invalid \"compression\" value: " + compressionStr +
+                                                        R"(, expected: one of {"none", "lz4"})");
+                if (compression != WriterFile::COMPRESSION::NONE && zeroCopy == 1)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"compression\" value: " + compressionStr +
+                                                        ", expected: \"none\" when \"zero-copy\" is set");
+            }
+
+            uint64_t compressionLevel = 0;
+            if (writerJson.HasMember("compression-level")) {
+                compressionLevel = Ctx::getJsonFieldU64(configFileName, writerJson, "compression-level");
+                if (compressionLevel > 12)
+                    throw ConfigurationException(
+                        30001, "bad JSON, invalid \"compression-level\" value: " + std::to_string(compressionLevel) +
+                               ", expected: one of {0 .. 12}");
+            }
+
+            std::string compressionDictionary;
+            if (writerJson.HasMember("compression-dictionary"))
+                compressionDictionary = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, writerJson,
+                                                           "compression-dictionary");
+            uint64_t preallocate = 0;
+            if (writerJson.HasMember("preallocate")) {
+                preallocate = Ctx::getJsonFieldU64(configFileName, writerJson, "preallocate");
+                if (preallocate > 1)
+                    throw ConfigurationException(
+                        30001,
+                        "bad JSON, invalid \"preallocate\" value: " + std::to_string(preallocate) +
+                        ", expected: one of {0, 1}");
+                if (preallocate == 1 && output.empty())
+                    throw ConfigurationException(30001, "bad JSON, invalid \"preallocate\" value: 1, expected: \"output\" to be set");
+            }
+
+            uint64_t directIo = 0;
+            if (writerJson.HasMember("direct-io")) {
+                directIo = Ctx::getJsonFieldU64(configFileName, writerJson, "direct-io");
+                if (directIo > 1)
+                    throw ConfigurationException(
+                        30001,
+                        "bad JSON, invalid \"direct-io\" value: " + std::to_string(directIo) +
+                        ", expected: one of {0, 1}");
+                if (directIo == 1 && output.empty())
+                    throw ConfigurationException(30001, "bad JSON, invalid \"direct-io\" value: 1, expected: \"output\" to be set");
+                if (directIo == 1 && zeroCopy == 1)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"direct-io\" value: 1, expected: 0 when \"zero-copy\" is set");
+            }
+
+            std::string partitionBy;
+            if (writerJson.HasMember("partition-by")) {
+                partitionBy = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, writerJson, "partition-by");
+                if (partitionBy != "table" && partitionBy != "hash")
+                    throw ConfigurationException(30001, "bad JSON, invalid \"partition-by\" value: " + partitionBy +
+                                                        R"(, expected: one of {"table", "hash"})");
+                if (maxFileSize > 0 || zeroCopy == 1 || fsyncIntervalUs > 0 || compression != WriterFile::COMPRESSION::NONE ||
+                    preallocate == 1 || directIo == 1)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"partition-by\" value: " + partitionBy +
+                                                        ", expected: no \"max-file-size\", \"zero-copy\", \"fsync-interval-us\", "
+                                                        "\"compression\", \"preallocate\" or \"direct-io\" to be set");
+            }
+            if (partitionBy.empty() == (output.find("%p") != std::string::npos))
+                throw ConfigurationException(30001, "bad JSON, invalid \"output\" value: " + output +
+                                                    ", expected: \"%p\" in the file name if and only if \"partition-by\" is set");
+
+            uint64_t partitions = 0;
+            if (writerJson.HasMember("partitions")) {
+                partitions = Ctx::getJsonFieldU64(configFileName, writerJson, "partitions");
+                if (partitionBy != "hash")
+                    throw ConfigurationException(30001, "bad JSON, invalid \"partitions\" value: " + std::to_string(partitions) +
+                                                        R"(, expected: "partition-by" to be "hash")");
+                if (partitions < 1 || partitions > FilePartitioner::MAX_BUCKETS)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"partitions\" value: " + std::to_string(partitions) +
+                                                        ", expected: one of {1 .. " + std::to_string(FilePartitioner::MAX_BUCKETS) + "}");
+            } else if (partitionBy == "hash")
+                throw ConfigurationException(30001, R"(bad JSON, missing "partitions" value, expected: to be set when "partition-by" is "hash")");
+
+            uint64_t ioThreads = 4;
+            if (writerJson.HasMember("io-threads")) {
+                ioThreads = Ctx::getJsonFieldU64(configFileName, writerJson, "io-threads");
+                if (partitionBy.empty())
+                    throw ConfigurationException(30001, "bad JSON, invalid \"io-threads\" value: " + std::to_string(ioThreads) +
+                                                        ", expected: \"partition-by\" to be set");
+                if (ioThreads < 1 || ioThreads > FilePartitioner::MAX_IO_THREADS)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"io-threads\" value: " + std::to_string(ioThreads) +
+                                                        ", expected: one of {1 .. " + std::to_string(FilePartitioner::MAX_IO_THREADS) + "}");
+            }
+
             if (replicator2 == nullptr) {
-                 writer = new RacMergeWriterFile(ctx, alias + "-writer", "", nullptr,
+                 auto* racMergeWriterFile = new RacMergeWriterFile(ctx, alias + "-writer", "", nullptr,
                                          nullptr, output, timestampFormat,
-                                         maxFileSize, newLine, append, writeBufferFlushSize);
+                                         maxFileSize, newLine, append, writeBufferFlushSize, zeroCopy == 1,
+                                         fsyncIntervalUs, fsyncSize);
+                 racMergeWriterFile->setCompression(compression, static_cast<int>(compressionLevel), compressionDictionary);
+                 racMergeWriterFile->setFileIo(preallocate == 1, directIo == 1);
+                 if (!partitionBy.empty())
+                     racMergeWriterFile->setPartitions(partitionBy == "table", partitions, ioThreads);
+                 writer = racMergeWriterFile;
             }else {
                 if(typeid(*replicator2)==typeid(ReplicatorRacOnline))
                     writer = new RacWriterFile(ctx, alias + "-writer", replicator2->database, replicator2->builder,
                                         replicator2->metadata, output, timestampFormat,
-                                        maxFileSize, newLine, append, writeBufferFlushSize);
+                                        maxFileSize, newLine, append, writeBufferFlushSize, zeroCopy == 1);
                 else
                     writer = new RacWriterFile(ctx, alias + "-writer", replicator2->database, replicator2->builder,
                                         replicator2->metadata, output, timestampFormat,
-                                        maxFileSize, newLine, append, writeBufferFlushSize);
+                                        maxFileSize, newLine, append, writeBufferFlushSize, zeroCopy == 1);
             }
         } else if (writerType == "discard") {
             writer = new WriterDiscard(ctx, alias + "-writer", replicator2->database, replicator2->builder,
                                        replicator2->metadata);
+        } else if (writerType == "shm") {
+            const std::string name = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, writerJson, "name");
+            if (name.length() < 2 || name[0] != '/' || name.find('/', 1) != std::string::npos)
+                throw ConfigurationException(30001, "bad JSON, invalid \"name\" value: " + name +
+                                                    ", expected: shared memory object name starting with \"/\"");
+
+            uint64_t ringSizeMb = 64;
+            if (writerJson.HasMember("ring-size-mb")) {
+                ringSizeMb = Ctx::getJsonFieldU64(configFileName, writerJson, "ring-size-mb");
+                if (ringSizeMb < 1 || ringSizeMb > 65536)
+                    throw ConfigurationException(
+                        30001, "bad JSON, invalid \"ring-size-mb\" value: " + std::to_string(ringSizeMb) +
+                               ", expected: one of {1 .. 65536}");
+            }
+
+            writer = new WriterShm(ctx, alias + "-writer", replicator2->database, replicator2->builder,
+                                   replicator2->metadata, name, ringSizeMb * 1024 * 1024);
+        } else if (writerType == "sse") {
+            // Clients connect to the embedded HTTP server, which only exists under the replicator manager
+            if (ctx->tenant.empty())
+                throw ConfigurationException(30001, "bad JSON, invalid \"type\" value: " + writerType +
+                                                    ", expected: not \"sse\" outside of the replicator manager");
+
+            std::string name(alias);
+            if (writerJson.HasMember("name"))
+                name = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, writerJson, "name");
+
+            uint64_t bufferMb = 64;
+            if (writerJson.HasMember("buffer-mb")) {
+                bufferMb = Ctx::getJsonFieldU64(configFileName, writerJson, "buffer-mb");
+                if (bufferMb < 1 || bufferMb > 65536)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"buffer-mb\" value: " + std::to_string(bufferMb) +
+                                                        ", expected: one of {1 .. 65536}");
+            }
+
+            uint64_t clientBufferMb = 16;
+            if (writerJson.HasMember("client-buffer-mb")) {
+                clientBufferMb = Ctx::getJsonFieldU64(configFileName, writerJson, "client-buffer-mb");
+                if (clientBufferMb < 1 || clientBufferMb > 1024)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"client-buffer-mb\" value: " + std::to_string(clientBufferMb) +
+                                                        ", expected: one of {1 .. 1024}");
+            }
+
+            uint64_t batchBytes = 65536;
+            if (writerJson.HasMember("batch-bytes")) {
+                batchBytes = Ctx::getJsonFieldU64(configFileName, writerJson, "batch-bytes");
+                if (batchBytes > 1073741824)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"batch-bytes\" value: " + std::to_string(batchBytes) +
+                                                        ", expected: one of {0 .. 1073741824}");
+            }
+
+            uint64_t batchLatencyUs = 50000;
+            if (writerJson.HasMember("batch-latency-us")) {
+                batchLatencyUs = Ctx::getJsonFieldU64(configFileName, writerJson, "batch-latency-us");
+                if (batchLatencyUs > 1000000)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"batch-latency-us\" value: " + std::to_string(batchLatencyUs) +
+                                                        ", expected: one of {0 .. 1000000}");
+            }
+
+            uint64_t maxClients = 64;
+            if (writerJson.HasMember("max-clients")) {
+                maxClients = Ctx::getJsonFieldU64(configFileName, writerJson, "max-clients");
+                if (maxClients < 1 || maxClients > 1024)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"max-clients\" value: " + std::to_string(maxClients) +
+                                                        ", expected: one of {1 .. 1024}");
+            }
+
+            writer = new WriterSse(ctx, alias + "-writer", replicator2->database, replicator2->builder, replicator2->metadata, name,
+                                   bufferMb * 1024 * 1024, clientBufferMb * 1024 * 1024, batchBytes, batchLatencyUs, maxClients);
         } else if (writerType == "kafka") {
 #ifdef LINK_LIBRARY_RDKAFKA
             uint64_t maxMessageMb = 100;
@@ -992,15 +1706,154 @@ namespace OpenLogReplicator {
                     reinterpret_cast<WriterKafka *>(writer)->addProperty(key, value);
                 }
             }
+
+            if (writerJson.HasMember("table-topics")) {
+                const rapidjson::Value &tableTopicsJson = Ctx::getJsonFieldO(
+                    configFileName, writerJson, "table-topics");
+
+                for (rapidjson::Value::ConstMemberIterator itr = tableTopicsJson.MemberBegin();
+                     itr != tableTopicsJson.MemberEnd(); ++itr) {
+                    const std::string table = itr->name.GetString();
+                    const std::string tableTopic = Ctx::getJsonFieldS(configFileName, Ctx::JSON_TOPIC_LENGTH,
+                                                                      tableTopicsJson, table.c_str());
+                    reinterpret_cast<WriterKafka *>(writer)->addTableTopic(table, tableTopic);
+                }
+            }
+
+            if (writerJson.HasMember("partition-by")) {
+                const std::string partitionBy = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, writerJson,
+                                                                   "partition-by");
+                if (partitionBy == "table")
+                    reinterpret_cast<WriterKafka *>(writer)->setPartitionByTable(true);
+                else if (partitionBy != "key")
+                    throw ConfigurationException(30001, "bad JSON, invalid \"partition-by\" value: " + partitionBy +
+                                                        R"(, expected: one of {"key", "table"})");
+            }
+
+            if (writerJson.HasMember("producers")) {
+                const uint64_t producers = Ctx::getJsonFieldU64(configFileName, writerJson, "producers");
+                if (producers < 1 || producers > WriterKafka::MAX_PRODUCERS)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"producers\" value: " + std::to_string(producers) +
+                                                        ", expected: one of {1 .. " + std::to_string(WriterKafka::MAX_PRODUCERS) + "}");
+                reinterpret_cast<WriterKafka *>(writer)->setProducers(producers);
+            }
+
+            if (writerJson.HasMember("record-headers")) {
+                const uint64_t recordHeaders = Ctx::getJsonFieldU64(configFileName, writerJson, "record-headers");
+                if (recordHeaders > 1)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"record-headers\" value: " + std::to_string(recordHeaders) +
+                                                        ", expected: one of {0, 1}");
+                reinterpret_cast<WriterKafka *>(writer)->setRecordHeaders(recordHeaders == 1);
+            }
+
+            if (writerJson.HasMember("poll-messages")) {
+                const uint64_t pollMessages = Ctx::getJsonFieldU64(configFileName, writerJson, "poll-messages");
+                if (pollMessages < 1 || pollMessages > 1000000)
+                    throw ConfigurationException(
+                        30001, "bad JSON, invalid \"poll-messages\" value: " + std::to_string(pollMessages) +
+                               ", expected: one of {1 .. 1000000}");
+                reinterpret_cast<WriterKafka *>(writer)->setPollMessages(pollMessages);
+            }
+
+            uint64_t transactionMessages = 1000;
+            if (writerJson.HasMember("transaction-messages")) {
+                transactionMessages = Ctx::getJsonFieldU64(configFileName, writerJson, "transaction-messages");
+                if (transactionMessages < 1 || transactionMessages > 1000000)
+                    throw ConfigurationException(
+                        30001, "bad JSON, invalid \"transaction-messages\" value: " + std::to_string(transactionMessages) +
+                               ", expected: one of {1 .. 1000000}");
+            }
+
+            std::string checkpointTopic;
+            if (writerJson.HasMember("checkpoint-topic"))
+                checkpointTopic = Ctx::getJsonFieldS(configFileName, Ctx::JSON_TOPIC_LENGTH, writerJson, "checkpoint-topic");
+            reinterpret_cast<WriterKafka *>(writer)->setTransaction(transactionMessages, checkpointTopic);
 #else
                 throw ConfigurationException(30001, "bad JSON, invalid \"type\" value: " + writerType +
                                              ", expected: not \"kafka\" since the code is not compiled");
 #endif /* LINK_LIBRARY_RDKAFKA */
+        } else if (writerType == "parquet" || writerType == "arrow") {
+#ifdef LINK_LIBRARY_ARROW
+            if (replicator2 == nullptr || replicator2->builder->isProtobuf() || replicator2->builder->isAvro() ||
+                !replicator2->builder->isMessagePerRow())
+                throw ConfigurationException(30001, "bad JSON, invalid \"type\" value: " + writerType +
+                                                    ", expected: source with \"json\" format and a message per row");
+
+            const std::string output = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, writerJson, "output");
+
+            uint64_t rowGroupRows = 65536;
+            if (writerJson.HasMember("row-group-rows")) {
+                rowGroupRows = Ctx::getJsonFieldU64(configFileName, writerJson, "row-group-rows");
+                if (rowGroupRows < 1 || rowGroupRows > 10000000)
+                    throw ConfigurationException(
+                        30001, "bad JSON, invalid \"row-group-rows\" value: " + std::to_string(rowGroupRows) +
+                               ", expected: one of {1 .. 10000000}");
+            }
+
+            uint64_t maxFileSize = 134217728;
+            if (writerJson.HasMember("max-file-size")) {
+                maxFileSize = Ctx::getJsonFieldU64(configFileName, writerJson, "max-file-size");
+                if (maxFileSize < 1048576)
+                    throw ConfigurationException(
+                        30001, "bad JSON, invalid \"max-file-size\" value: " + std::to_string(maxFileSize) +
+                               ", expected: at least 1048576");
+            }
+
+            uint64_t maxFileAgeS = 60;
+            if (writerJson.HasMember("max-file-age-s")) {
+                maxFileAgeS = Ctx::getJsonFieldU64(configFileName, writerJson, "max-file-age-s");
+                if (maxFileAgeS < 1 || maxFileAgeS > 86400)
+                    throw ConfigurationException(
+                        30001, "bad JSON, invalid \"max-file-age-s\" value: " + std::to_string(maxFileAgeS) +
+                               ", expected: one of {1 .. 86400}");
+            }
+
+            arrow::Compression::type compression = arrow::Compression::UNCOMPRESSED;
+            if (writerJson.HasMember("compression")) {
+                const std::string compressionStr = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, writerJson,
+                                                                      "compression");
+                if (compressionStr == "snappy" && writerType == "parquet")
+                    compression = arrow::Compression::SNAPPY;
+                else if (compressionStr == "zstd" && writerType == "parquet")
+                    compression = arrow::Compression::ZSTD;
+                else if (compressionStr == "lz4" && writerType == "parquet")
+                    compression = arrow::Compression::LZ4;
+                else if (compressionStr != "none")
+                    throw ConfigurationException(30001, "bad JSON, invalid \"compression\" value: " + compressionStr +
+                                                        (writerType == "parquet" ? R"(, expected: one of {"none", "snappy", "zstd", "lz4"})" :
+                                                         R"(, expected: "none")"));
+            }
+
+            writer = new WriterParquet(ctx, alias + "-writer", replicator2->database, replicator2->builder, replicator2->metadata,
+                                       writerType == "parquet" ? WriterParquet::FILE_FORMAT::PARQUET : WriterParquet::FILE_FORMAT::ARROW,
+                                       output, rowGroupRows, maxFileSize, maxFileAgeS, compression,
+                                       replicator2->builder->getFormat().timestampFormat);
+#else
+            throw ConfigurationException(30001, "bad JSON, invalid \"type\" value: " + writerType +
+                                                ", expected: not \"" + writerType + "\" since the code is not compiled");
+#endif /* LINK_LIBRARY_ARROW */
         } else if (writerType == "zeromq") {
 #if defined(LINK_LIBRARY_PROTOBUF) && defined(LINK_LIBRARY_ZEROMQ)
                 const std::string uri = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, writerJson, "uri");
                 auto* stream = new StreamZeroMQ(ctx, uri);
                 stream->initialize();
+
+                if (writerJson.HasMember("batch-bytes")) {
+                    const uint64_t batchBytes = Ctx::getJsonFieldU64(configFileName, writerJson, "batch-bytes");
+                    if (batchBytes > 1073741824)
+                        throw ConfigurationException(30001, "bad JSON, invalid \"batch-bytes\" value: " + std::to_string(batchBytes) +
+                                                            ", expected: one of {0 .. 1073741824}");
+
+                    uint64_t batchLatencyUs = 1000;
+                    if (writerJson.HasMember("batch-latency-us")) {
+                        batchLatencyUs = Ctx::getJsonFieldU64(configFileName, writerJson, "batch-latency-us");
+                        if (batchLatencyUs > 1000000)
+                            throw ConfigurationException(
+                                30001, "bad JSON, invalid \"batch-latency-us\" value: " + std::to_string(batchLatencyUs) +
+                                       ", expected: one of {0 .. 1000000}");
+                    }
+                    stream->setBatch(batchBytes, batchLatencyUs);
+                }
                 writer = new WriterStream(ctx, alias + "-writer", replicator2->database, replicator2->builder, replicator2->metadata, stream);
 #else
             throw ConfigurationException(30001, "bad JSON, invalid \"type\" value: " + writerType +
@@ -1013,15 +1866,226 @@ namespace OpenLogReplicator {
 
             auto *stream = new StreamNetwork(ctx, uri);
             stream->initialize();
-            writer = new WriterStream(ctx, alias + "-writer", replicator2->database, replicator2->builder,
-                                      replicator2->metadata, stream);
+
+            if (writerJson.HasMember("batch-bytes")) {
+                const uint64_t batchBytes = Ctx::getJsonFieldU64(configFileName, writerJson, "batch-bytes");
+                if (batchBytes > 1073741824)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"batch-bytes\" value: " + std::to_string(batchBytes) +
+                                                        ", expected: one of {0 .. 1073741824}");
+
+                uint64_t batchLatencyUs = 1000;
+                if (writerJson.HasMember("batch-latency-us")) {
+                    batchLatencyUs = Ctx::getJsonFieldU64(configFileName, writerJson, "batch-latency-us");
+                    if (batchLatencyUs > 1000000)
+                        throw ConfigurationException(
+                            30001, "bad JSON, invalid \"batch-latency-us\" value: " + std::to_string(batchLatencyUs) +
+                                   ", expected: one of {0 .. 1000000}");
+                }
+                stream->setBatch(batchBytes, batchLatencyUs);
+            }
+
+            bool tcpNoDelay = true;
+            if (writerJson.HasMember("tcp-nodelay")) {
+                const uint64_t val = Ctx::getJsonFieldU64(configFileName, writerJson, "tcp-nodelay");
+                if (val > 1)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"tcp-nodelay\" value: " + std::to_string(val) +
+                                                        ", expected: one of {0, 1}");
+                tcpNoDelay = (val == 1);
+            }
+
+            bool tcpCork = false;
+            if (writerJson.HasMember("tcp-cork")) {
+                const uint64_t val = Ctx::getJsonFieldU64(configFileName, writerJson, "tcp-cork");
+                if (val > 1)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"tcp-cork\" value: " + std::to_string(val) +
+                                                        ", expected: one of {0, 1}");
+                tcpCork = (val == 1);
+            }
+
+            uint64_t sendBufferBytes = 0;
+            if (writerJson.HasMember("send-buffer-bytes")) {
+                sendBufferBytes = Ctx::getJsonFieldU64(configFileName, writerJson, "send-buffer-bytes");
+                if (sendBufferBytes > 1073741824)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"send-buffer-bytes\" value: " +
+                                                        std::to_string(sendBufferBytes) + ", expected: one of {0 .. 1073741824}");
+            }
+
+            uint64_t keepAliveS = 0;
+            if (writerJson.HasMember("keepalive-s")) {
+                keepAliveS = Ctx::getJsonFieldU64(configFileName, writerJson, "keepalive-s");
+                if (keepAliveS > 32767)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"keepalive-s\" value: " + std::to_string(keepAliveS) +
+                                                        ", expected: one of {0 .. 32767}");
+            }
+            stream->setTcp(tcpNoDelay, tcpCork, sendBufferBytes, keepAliveS);
+
+            if (writerJson.HasMember("tls-cert")) {
+#ifdef LINK_LIBRARY_OPENSSL
+                const std::string tlsCert = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, writerJson, "tls-cert");
+                std::string tlsKey;
+                if (writerJson.HasMember("tls-key"))
+                    tlsKey = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, writerJson, "tls-key");
+                std::string tlsCa;
+                if (writerJson.HasMember("tls-ca"))
+                    tlsCa = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, writerJson, "tls-ca");
+                bool tlsKtls = true;
+                if (writerJson.HasMember("tls-ktls")) {
+                    const uint64_t val = Ctx::getJsonFieldU64(configFileName, writerJson, "tls-ktls");
+                    if (val > 1)
+                        throw ConfigurationException(30001, "bad JSON, invalid \"tls-ktls\" value: " + std::to_string(val) +
+                                                            ", expected: one of {0, 1}");
+                    tlsKtls = (val == 1);
+                }
+                stream->setTls(tlsCert, tlsKey, tlsCa, tlsKtls);
+#else
+                throw ConfigurationException(30001, "bad JSON, invalid \"tls-cert\" value, expected: not set since the code is not compiled");
+#endif /* LINK_LIBRARY_OPENSSL */
+            } else if (writerJson.HasMember("tls-key") || writerJson.HasMember("tls-ca") || writerJson.HasMember("tls-ktls"))
+                throw ConfigurationException(30001, "bad JSON, \"tls-key\", \"tls-ca\" and \"tls-ktls\" require \"tls-cert\"");
+
+            uint64_t maxClients = 1;
+            if (writerJson.HasMember("max-clients")) {
+                maxClients = Ctx::getJsonFieldU64(configFileName, writerJson, "max-clients");
+                if (maxClients < 1 || maxClients > 1024)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"max-clients\" value: " + std::to_string(maxClients) +
+                                                        ", expected: one of {1 .. 1024}");
+            }
+
+            uint64_t maxLagMessages = 0;
+            if (writerJson.HasMember("max-lag-messages")) {
+                if (maxClients == 1)
+                    throw ConfigurationException(30001, "bad JSON, \"max-lag-messages\" requires \"max-clients\" greater than 1");
+                maxLagMessages = Ctx::getJsonFieldU64(configFileName, writerJson, "max-lag-messages");
+            }
+
+            if (maxClients > 1)
+                writer = new WriterFanout(ctx, alias + "-writer", replicator2->database, replicator2->builder,
+                                          replicator2->metadata, stream, maxClients, maxLagMessages);
+            else
+                writer = new WriterStream(ctx, alias + "-writer", replicator2->database, replicator2->builder,
+                                          replicator2->metadata, stream);
 #else
                 throw ConfigurationException(30001, "bad JSON, invalid \"type\" value: " + writerType +
                                              ", expected: not \"network\" since the code is not compiled");
 #endif /* LINK_LIBRARY_PROTOBUF */
+        } else if (writerType == "grpc") {
+#if defined(LINK_LIBRARY_PROTOBUF) && defined(LINK_LIBRARY_GRPC)
+            const std::string uri = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, writerJson, "uri");
+            auto* stream = new StreamGrpc(ctx, uri);
+            stream->initialize();
+
+            if (writerJson.HasMember("tls-cert")) {
+                const std::string tlsCert = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, writerJson, "tls-cert");
+                std::string tlsKey;
+                if (writerJson.HasMember("tls-key"))
+                    tlsKey = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, writerJson, "tls-key");
+                std::string tlsCa;
+                if (writerJson.HasMember("tls-ca"))
+                    tlsCa = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, writerJson, "tls-ca");
+                stream->setTls(tlsCert, tlsKey, tlsCa);
+            } else if (writerJson.HasMember("tls-key") || writerJson.HasMember("tls-ca"))
+                throw ConfigurationException(30001, "bad JSON, \"tls-key\" and \"tls-ca\" require \"tls-cert\"");
+
+            // Every call is a subscription of its own, even when several of them share one connection
+            uint64_t maxClients = 16;
+            if (writerJson.HasMember("max-clients")) {
+                maxClients = Ctx::getJsonFieldU64(configFileName, writerJson, "max-clients");
+                if (maxClients < 1 || maxClients > 1024)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"max-clients\" value: " + std::to_string(maxClients) +
+                                                        ", expected: one of {1 .. 1024}");
+            }
+
+            uint64_t maxLagMessages = 0;
+            if (writerJson.HasMember("max-lag-messages"))
+                maxLagMessages = Ctx::getJsonFieldU64(configFileName, writerJson, "max-lag-messages");
+
+            writer = new WriterFanout(ctx, alias + "-writer", replicator2->database, replicator2->builder,
+                                      replicator2->metadata, stream, maxClients, maxLagMessages);
+#else
+            throw ConfigurationException(30001, "bad JSON, invalid \"type\" value: " + writerType +
+                                                ", expected: not \"grpc\" since the code is not compiled");
+#endif /* defined(LINK_LIBRARY_PROTOBUF) && defined(LINK_LIBRARY_GRPC) */
         } else
             throw ConfigurationException(30001, "bad JSON, invalid \"type\" value: " + writerType +
-                                                R"(, expected: one of {"file", "kafka", "zeromq", "network", "discard"})");
+                                                R"(, expected: one of {"file", "kafka", "parquet", "arrow", "zeromq", "network", "grpc", "discard", "shm", "sse"})");
+
+        if (writerJson.HasMember("rate-limit")) {
+            const rapidjson::Value& rateLimitJson = Ctx::getJsonFieldO(configFileName, writerJson, "rate-limit");
+            if (!ctx->isDisableChecksSet(Ctx::DISABLE_CHECKS::JSON_TAGS)) {
+                static const std::vector<std::string> rateLimitNames{"bytes-per-s", "messages-per-s", "burst-ms", "priority",
+                                                                     "backfill-bytes-per-s", "backfill-messages-per-s", "table"};
+                Ctx::checkJsonFields(configFileName, rateLimitJson, rateLimitNames);
+            }
+
+            uint64_t burstMs = 1000;
+            if (rateLimitJson.HasMember("burst-ms")) {
+                burstMs = Ctx::getJsonFieldU64(configFileName, rateLimitJson, "burst-ms");
+                if (burstMs < 1 || burstMs > 60000)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"burst-ms\" value: " + std::to_string(burstMs) +
+                                                        ", expected: one of {1 .. 60000}");
+            }
+
+            RateLimit::PRIORITY priority = RateLimit::PRIORITY::REALTIME;
+            if (rateLimitJson.HasMember("priority")) {
+                const std::string priorityStr = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, rateLimitJson, "priority");
+                if (priorityStr == "backfill")
+                    priority = RateLimit::PRIORITY::BACKFILL;
+                else if (priorityStr != "realtime")
+                    throw ConfigurationException(30001, "bad JSON, invalid \"priority\" value: " + priorityStr +
+                                                        R"(, expected: one of {"realtime", "backfill"})");
+            }
+
+            uint64_t bytesPerS = 0;
+            if (rateLimitJson.HasMember("bytes-per-s"))
+                bytesPerS = Ctx::getJsonFieldU64(configFileName, rateLimitJson, "bytes-per-s");
+            uint64_t messagesPerS = 0;
+            if (rateLimitJson.HasMember("messages-per-s"))
+                messagesPerS = Ctx::getJsonFieldU64(configFileName, rateLimitJson, "messages-per-s");
+
+            // The backfill limits apply only while the real-time writers of the process are sending
+            uint64_t backfillBytesPerS = 0;
+            if (rateLimitJson.HasMember("backfill-bytes-per-s"))
+                backfillBytesPerS = Ctx::getJsonFieldU64(configFileName, rateLimitJson, "backfill-bytes-per-s");
+            uint64_t backfillMessagesPerS = 0;
+            if (rateLimitJson.HasMember("backfill-messages-per-s"))
+                backfillMessagesPerS = Ctx::getJsonFieldU64(configFileName, rateLimitJson, "backfill-messages-per-s");
+            if (priority == RateLimit::PRIORITY::BACKFILL) {
+                if (backfillBytesPerS == 0 && backfillMessagesPerS == 0)
+                    throw ConfigurationException(30001, R"(bad JSON, "priority" value "backfill" requires "backfill-bytes-per-s" or )"
+                                                        R"("backfill-messages-per-s")");
+            } else if (backfillBytesPerS != 0 || backfillMessagesPerS != 0)
+                throw ConfigurationException(30001, R"(bad JSON, "backfill-bytes-per-s" and "backfill-messages-per-s" require "priority" )"
+                                                    R"(value "backfill")");
+
+            auto* rateLimit = new RateLimit(priority);
+            writer->setRateLimit(rateLimit);
+            rateLimit->setWriter(bytesPerS, messagesPerS, burstMs);
+            rateLimit->setBackfill(backfillBytesPerS, backfillMessagesPerS, burstMs);
+
+            if (rateLimitJson.HasMember("table")) {
+                const rapidjson::Value& tableArrayJson = Ctx::getJsonFieldA(configFileName, rateLimitJson, "table");
+                for (rapidjson::SizeType i = 0; i < tableArrayJson.Size(); ++i) {
+                    const rapidjson::Value& tableJson = Ctx::getJsonFieldO(configFileName, tableArrayJson, "table", i);
+                    if (!ctx->isDisableChecksSet(Ctx::DISABLE_CHECKS::JSON_TAGS)) {
+                        static const std::vector<std::string> tableNames{"owner", "table", "bytes-per-s", "messages-per-s"};
+                        Ctx::checkJsonFields(configFileName, tableJson, tableNames);
+                    }
+
+                    const std::string owner = Ctx::getJsonFieldS(configFileName, SysUser::NAME_LENGTH, tableJson, "owner");
+                    const std::string table = Ctx::getJsonFieldS(configFileName, SysObj::NAME_LENGTH, tableJson, "table");
+                    uint64_t tableBytesPerS = 0;
+                    if (tableJson.HasMember("bytes-per-s"))
+                        tableBytesPerS = Ctx::getJsonFieldU64(configFileName, tableJson, "bytes-per-s");
+                    uint64_t tableMessagesPerS = 0;
+                    if (tableJson.HasMember("messages-per-s"))
+                        tableMessagesPerS = Ctx::getJsonFieldU64(configFileName, tableJson, "messages-per-s");
+                    if (tableBytesPerS == 0 && tableMessagesPerS == 0)
+                        throw ConfigurationException(30001, "bad JSON, \"table\" element of \"rate-limit\" requires \"bytes-per-s\" or "
+                                                            "\"messages-per-s\"");
+                    rateLimit->addGroup(owner, table, tableBytesPerS, tableMessagesPerS, burstMs);
+                }
+            }
+        }
 
         writers.push_back(writer);
         writer->initialize();
@@ -1051,7 +2115,8 @@ namespace OpenLogReplicator {
         if (!ctx->isDisableChecksSet(Ctx::DISABLE_CHECKS::JSON_TAGS)) {
             static const std::vector<std::string> documentNames{
                 "version", "dump-path", "dump-raw-data", "dump-redo-log", "log-level", "trace", "source",
-                "target"
+                "target", "clock-source", "log-format", "log-async", "log-rate-limit", "flight-recorder", "stall-timeout-s",
+                "stall-samples", "quota"
             };
             Ctx::checkJsonFields(configFileName, document, documentNames);
         }
@@ -1092,6 +2157,33 @@ namespace OpenLogReplicator {
                     ", expected: one of {0 .. 4}");
         }
 
+        LogSink::FORMAT logFormat = LogSink::FORMAT::TEXT;
+        if (document.HasMember("log-format")) {
+            const std::string logFormatStr = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, document, "log-format");
+            if (logFormatStr == "json")
+                logFormat = LogSink::FORMAT::JSON;
+            else if (logFormatStr != "text")
+                throw ConfigurationException(30001, "bad JSON, invalid \"log-format\" value: " + logFormatStr +
+                                                    R"(, expected: one of {"text", "json"})");
+        }
+
+        uint logAsync = 0;
+        if (document.HasMember("log-async")) {
+            logAsync = Ctx::getJsonFieldU(configFileName, document, "log-async");
+            if (logAsync > 1)
+                throw ConfigurationException(30001, "bad JSON, invalid \"log-async\" value: " + std::to_string(logAsync) +
+                                                    ", expected: one of {0, 1}");
+        }
+
+        uint64_t logRateLimit = 0;
+        if (document.HasMember("log-rate-limit")) {
+            logRateLimit = Ctx::getJsonFieldU64(configFileName, document, "log-rate-limit");
+            if (logRateLimit > 1000000)
+                throw ConfigurationException(30001, "bad JSON, invalid \"log-rate-limit\" value: " + std::to_string(logRateLimit) +
+                                                    ", expected: one of {0 .. 1000000}");
+        }
+        ctx->logSink.configure(logFormat, logAsync == 1, logRateLimit);
+
         if (document.HasMember("trace")) {
             ctx->trace = Ctx::getJsonFieldU64(configFileName, document, "trace");
             if (ctx->trace > 524287)
@@ -1099,6 +2191,80 @@ namespace OpenLogReplicator {
                                                     ", expected: one of {0 .. 524287}");
         }
 
+        if (document.HasMember("clock-source")) {
+            const std::string clockSource = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, document, "clock-source");
+            if (clockSource == "coarse") {
+                ctx->contextClock.setSource(ClockTsc::SOURCE::COARSE);
+            } else if (clockSource == "tsc") {
+                if (!ctx->contextClock.setSource(ClockTsc::SOURCE::TSC)) {
+                    ctx->warning(60050, "CPU counter has no constant rate, using coarse clock for thread context timing");
+                    ctx->contextClock.setSource(ClockTsc::SOURCE::COARSE);
+                }
+            } else if (clockSource != "hw")
+                throw ConfigurationException(30001, "bad JSON, invalid \"clock-source\" value: " + clockSource +
+                                                    R"(, expected: one of {"hw", "coarse", "tsc"})");
+        }
+
+        if (document.HasMember("flight-recorder")) {
+            const uint64_t flightRecorder = Ctx::getJsonFieldU64(configFileName, document, "flight-recorder");
+            if (flightRecorder > 1)
+                throw ConfigurationException(30001, "bad JSON, invalid \"flight-recorder\" value: " + std::to_string(flightRecorder) +
+                                                    ", expected: one of {0, 1}");
+            ctx->flightRecorder = (flightRecorder == 1);
+        }
+
+        if (document.HasMember("stall-timeout-s")) {
+            ctx->stallTimeoutS = Ctx::getJsonFieldU64(configFileName, document, "stall-timeout-s");
+            if (ctx->stallTimeoutS > 86400)
+                throw ConfigurationException(30001, "bad JSON, invalid \"stall-timeout-s\" value: " +
+                                                    std::to_string(ctx->stallTimeoutS) + ", expected: one of {0 .. 86400}");
+        }
+
+        if (document.HasMember("stall-samples")) {
+            ctx->stallSamples = Ctx::getJsonFieldU64(configFileName, document, "stall-samples");
+            if (ctx->stallSamples < 1 || ctx->stallSamples > 10)
+                throw ConfigurationException(30001, "bad JSON, invalid \"stall-samples\" value: " +
+                                                    std::to_string(ctx->stallSamples) + ", expected: one of {1 .. 10}");
+        }
+
+        // Weights of the tenant against the other tenants of the replicator manager
+        if (document.HasMember("quota")) {
+            const rapidjson::Value& quotaJson = Ctx::getJsonFieldO(configFileName, document, "quota");
+            if (!ctx->isDisableChecksSet(Ctx::DISABLE_CHECKS::JSON_TAGS)) {
+                static const std::vector<std::string> quotaNames{"memory-weight", "swap-weight", "cpu-weight"};
+                Ctx::checkJsonFields(configFileName, quotaJson, quotaNames);
+            }
+
+            if (ctx->tenant.empty())
+                throw ConfigurationException(30001, R"(bad JSON, invalid "quota" value, expected: not set outside of the replicator manager)");
+
+            if (quotaJson.HasMember("memory-weight")) {
+                ctx->memoryShare.memoryWeight = Ctx::getJsonFieldU64(configFileName, quotaJson, "memory-weight");
+                if (ctx->memoryShare.memoryWeight < 1 || ctx->memoryShare.memoryWeight > 10000)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"memory-weight\" value: " +
+                                                        std::to_string(ctx->memoryShare.memoryWeight) + ", expected: one of {1 .. 10000}");
+            }
+
+            if (quotaJson.HasMember("swap-weight")) {
+                ctx->memoryShare.swapWeight = Ctx::getJsonFieldU64(configFileName, quotaJson, "swap-weight");
+                if (ctx->memoryShare.swapWeight < 1 || ctx->memoryShare.swapWeight > 10000)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"swap-weight\" value: " +
+                                                        std::to_string(ctx->memoryShare.swapWeight) + ", expected: one of {1 .. 10000}");
+            }
+
+            if (quotaJson.HasMember("cpu-weight")) {
+                const uint64_t cpuWeight = Ctx::getJsonFieldU64(configFileName, quotaJson, "cpu-weight");
+                if (cpuWeight < 1 || cpuWeight > 10000)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"cpu-weight\" value: " + std::to_string(cpuWeight) +
+                                                        ", expected: one of {1 .. 10000}");
+#if __linux__
+                ctx->createCgroup(cpuWeight);
+#else
+                throw ConfigurationException(30001, R"(bad JSON, invalid "cpu-weight" value, expected: not set since not supported on this platform)");
+#endif
+            }
+        }
+
         // Iterate through sources
         const rapidjson::Value &sourceArrayJson = Ctx::getJsonFieldA(configFileName, document, "source");
         if (sourceArrayJson.Size() != 1) {
@@ -1112,9 +2278,11 @@ namespace OpenLogReplicator {
 
             if (!ctx->isDisableChecksSet(Ctx::DISABLE_CHECKS::JSON_TAGS)) {
                 static const std::vector<std::string> sourceNames{
-                    "alias", "memory", "name", "reader", "flags", "state", "debug", "transaction-max-mb",
-                    "metrics", "format", "redo-read-sleep-us", "arch-read-sleep-us", "arch-read-tries",
-                    "redo-verify-delay-us", "refresh-interval-us", "arch", "filter","rac"
+                    "alias", "memory", "name", "reader", "flags", "state", "debug", "transaction-max-mb", "transaction-stream-mb",
+                    "metrics", "format", "redo-read-sleep-us", "redo-read-sleep-max-us", "arch-read-sleep-us", "arch-read-tries",
+                    "redo-verify-delay-us", "refresh-interval-us", "arch", "filter","rac",
+                    "parser-threads", "lwn-prefetch", "commit-flush-queue", "cpu-affinity", "transaction-pool-size", "orphaned-lob-max-mb",
+                    "thread-priority", "partition", "tracing"
                 };
                 Ctx::checkJsonFields(configFileName, sourceJson, sourceNames);
             }
@@ -1140,7 +2308,10 @@ namespace OpenLogReplicator {
                 if (!ctx->isDisableChecksSet(Ctx::DISABLE_CHECKS::JSON_TAGS)) {
                     static const std::vector<std::string> memoryNames{
                         "min-mb", "max-mb", "read-buffer-max-mb", "read-buffer-min-mb", "swap-mb", "swap-path",
-                        "unswap-buffer-min-mb", "write-buffer-max-mb", "write-buffer-min-mb"
+                        "unswap-buffer-min-mb", "write-buffer-max-mb", "write-buffer-min-mb", "arch-prefetch-max-mb",
+                        "swap-compression", "swap-arena-mb", "numa", "huge-pages",
+                        "builder-chunk-mb", "swap-policy", "swap-transaction-mb", "write-credit-mb", "trim-idle-s",
+                        "transaction-map-mb", "transaction-map-path", "transaction-map-resident-mb"
                     };
                     Ctx::checkJsonFields(configFileName, memoryJson, memoryNames);
                 }
@@ -1182,6 +2353,33 @@ namespace OpenLogReplicator {
                                    ", expected maximum \"max-mb\"-1 value (" + std::to_string(memoryMaxMb - 4) + ")");
                 }
 
+                if (memoryJson.HasMember("transaction-map-mb")) {
+                    uint64_t transactionMapMb = Ctx::getJsonFieldU64(configFileName, memoryJson, "transaction-map-mb");
+                    transactionMapMb = (transactionMapMb / Ctx::MEMORY_CHUNK_SIZE_MB) * Ctx::MEMORY_CHUNK_SIZE_MB;
+                    if (transactionMapMb > 0 && transactionMapMb < Ctx::MEMORY_CHUNK_MIN_MB)
+                        throw ConfigurationException(30001, "bad JSON, invalid \"transaction-map-mb\" value: " + std::to_string(transactionMapMb) +
+                                                            ", expected: 0 or at least " + std::to_string(Ctx::MEMORY_CHUNK_MIN_MB));
+                    // The mapped chunks are paged by the kernel, they are never swapped explicitly
+                    if (transactionMapMb > 0 && memoryJson.HasMember("swap-mb") && memorySwapMb > 0)
+                        throw ConfigurationException(30001, "bad JSON, invalid \"swap-mb\" value: " + std::to_string(memorySwapMb) +
+                                                            R"(, expected: 0 with "transaction-map-mb" set)");
+                    if (transactionMapMb > 0)
+                        memorySwapMb = 0;
+                    ctx->transactionMapMb = transactionMapMb;
+                    ctx->transactionMapPath = ".";
+                    if (memoryJson.HasMember("transaction-map-path"))
+                        ctx->transactionMapPath = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, memoryJson, "transaction-map-path");
+                }
+
+                if (memoryJson.HasMember("transaction-map-resident-mb")) {
+                    const uint64_t transactionMapResidentMb = Ctx::getJsonFieldU64(configFileName, memoryJson, "transaction-map-resident-mb");
+                    if (transactionMapResidentMb > 0 && (ctx->transactionMapMb == 0 || transactionMapResidentMb > ctx->transactionMapMb))
+                        throw ConfigurationException(30001, "bad JSON, invalid \"transaction-map-resident-mb\" value: " +
+                                                            std::to_string(transactionMapResidentMb) + ", expected: 0 or not greater than " +
+                                                            "\"transaction-map-mb\" value (" + std::to_string(ctx->transactionMapMb) + ")");
+                    ctx->transactionMapResidentMb = transactionMapResidentMb;
+                }
+
                 if (memoryJson.HasMember("read-buffer-min-mb")) {
                     memoryReadBufferMinMb = Ctx::getJsonFieldU64(configFileName, memoryJson, "read-buffer-min-mb");
                     memoryReadBufferMinMb = (memoryReadBufferMinMb / Ctx::MEMORY_CHUNK_SIZE_MB) *
@@ -1213,6 +2411,17 @@ namespace OpenLogReplicator {
                                                             std::to_string(memoryReadBufferMinMb) + ")");
                 }
 
+                if (memoryJson.HasMember("arch-prefetch-max-mb")) {
+                    uint64_t archPrefetchMaxMb = Ctx::getJsonFieldU64(configFileName, memoryJson, "arch-prefetch-max-mb");
+                    archPrefetchMaxMb = (archPrefetchMaxMb / Ctx::MEMORY_CHUNK_SIZE_MB) * Ctx::MEMORY_CHUNK_SIZE_MB;
+                    if (archPrefetchMaxMb > memoryReadBufferMaxMb / 2)
+                        throw ConfigurationException(30001, "bad JSON, invalid \"arch-prefetch-max-mb\" value: " +
+                                                            std::to_string(archPrefetchMaxMb) +
+                                                            ", expected: not greater than half of \"read-buffer-max-mb\" value (" +
+                                                            std::to_string(memoryReadBufferMaxMb) + ")");
+                    ctx->archPrefetchBufferMax = archPrefetchMaxMb * 1024 * 1024;
+                }
+
                 if (memoryJson.HasMember("write-buffer-min-mb")) {
                     memoryWriteBufferMinMb = Ctx::getJsonFieldU64(configFileName, memoryJson, "write-buffer-min-mb");
                     memoryWriteBufferMinMb = (memoryWriteBufferMinMb / Ctx::MEMORY_CHUNK_SIZE_MB) *
@@ -1244,6 +2453,113 @@ namespace OpenLogReplicator {
                                                             std::to_string(memoryWriteBufferMinMb) + ")");
                 }
 
+                if (memoryJson.HasMember("swap-compression")) {
+                    const std::string swapCompression = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, memoryJson,
+                                                                           "swap-compression");
+                    if (swapCompression == "lz4") {
+#ifdef LINK_LIBRARY_LZ4
+                        ctx->swapCompress = true;
+#else
+                        throw ConfigurationException(30001, R"(bad JSON, invalid "swap-compression" value: lz4, expected: not "lz4" since the code is not compiled)");
+#endif /* LINK_LIBRARY_LZ4 */
+                    } else if (swapCompression != "none")
+                        throw ConfigurationException(30001, "bad JSON, invalid \"swap-compression\" value: " + swapCompression +
+                                                            R"(, expected: one of {"none", "lz4"})");
+                }
+
+                if (memoryJson.HasMember("huge-pages")) {
+                    const std::string hugePages = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, memoryJson, "huge-pages");
+                    if (hugePages == "none")
+                        ctx->hugePages = Ctx::HUGE_PAGES::NONE;
+                    else if (hugePages == "transparent")
+                        ctx->hugePages = Ctx::HUGE_PAGES::TRANSPARENT;
+                    else if (hugePages == "2mb")
+                        ctx->hugePages = Ctx::HUGE_PAGES::HUGE_2MB;
+                    else if (hugePages == "1gb")
+                        ctx->hugePages = Ctx::HUGE_PAGES::HUGE_1GB;
+                    else
+                        throw ConfigurationException(30001, "bad JSON, invalid \"huge-pages\" value: " + hugePages +
+                                                            R"(, expected: one of {"none", "transparent", "2mb", "1gb"})");
+                }
+
+                if (memoryJson.HasMember("numa")) {
+                    const uint numa = Ctx::getJsonFieldU(configFileName, memoryJson, "numa");
+                    if (numa > 1)
+                        throw ConfigurationException(30001, "bad JSON, invalid \"numa\" value: " + std::to_string(numa) +
+                                                            ", expected: one of {0, 1}");
+                    if (numa == 1) {
+#ifdef LINK_LIBRARY_NUMA
+                        if (numa_available() < 0)
+                            throw ConfigurationException(30001, R"(bad JSON, invalid "numa" value: 1, expected: 0 since NUMA is not available)");
+                        ctx->numa = true;
+                        ctx->numaNodes = std::min(static_cast<uint>(numa_max_node() + 1), Ctx::MEMORY_NODES_MAX);
+#else
+                        throw ConfigurationException(30001, R"(bad JSON, invalid "numa" value: 1, expected: 0 since the code is not compiled)");
+#endif /* LINK_LIBRARY_NUMA */
+                    }
+                }
+
+                if (memoryJson.HasMember("swap-arena-mb")) {
+                    uint64_t swapArenaMb = Ctx::getJsonFieldU64(configFileName, memoryJson, "swap-arena-mb");
+                    swapArenaMb = (swapArenaMb / Ctx::MEMORY_CHUNK_SIZE_MB) * Ctx::MEMORY_CHUNK_SIZE_MB;
+                    if (swapArenaMb > 0 && swapArenaMb < Ctx::MEMORY_CHUNK_MIN_MB)
+                        throw ConfigurationException(30001, "bad JSON, invalid \"swap-arena-mb\" value: " + std::to_string(swapArenaMb) +
+                                                            ", expected: 0 or at least " + std::to_string(Ctx::MEMORY_CHUNK_MIN_MB));
+                    ctx->swapArenaSize = swapArenaMb * 1024 * 1024;
+                }
+
+                if (memoryJson.HasMember("swap-policy")) {
+                    const std::string swapPolicy = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, memoryJson, "swap-policy");
+                    if (swapPolicy == "first")
+                        ctx->swapPolicy = Ctx::SWAP_POLICY::FIRST;
+                    else if (swapPolicy == "largest")
+                        ctx->swapPolicy = Ctx::SWAP_POLICY::LARGEST;
+                    else if (swapPolicy == "oldest")
+                        ctx->swapPolicy = Ctx::SWAP_POLICY::OLDEST;
+                    else if (swapPolicy == "cost")
+                        ctx->swapPolicy = Ctx::SWAP_POLICY::COST;
+                    else
+                        throw ConfigurationException(30001, "bad JSON, invalid \"swap-policy\" value: " + swapPolicy +
+                                                            R"(, expected: one of {"first", "largest", "oldest", "cost"})");
+                }
+
+                if (memoryJson.HasMember("swap-transaction-mb")) {
+                    uint64_t swapTransactionMb = Ctx::getJsonFieldU64(configFileName, memoryJson, "swap-transaction-mb");
+                    swapTransactionMb = (swapTransactionMb / Ctx::MEMORY_CHUNK_SIZE_MB) * Ctx::MEMORY_CHUNK_SIZE_MB;
+                    if (swapTransactionMb > 0 && (memorySwapMb == 0 || swapTransactionMb > memoryMaxMb))
+                        throw ConfigurationException(30001, "bad JSON, invalid \"swap-transaction-mb\" value: " + std::to_string(swapTransactionMb) +
+                                                            ", expected: 0 or not greater than \"max-mb\" value (" + std::to_string(memoryMaxMb) +
+                                                            ") with \"swap-mb\" set");
+                    ctx->swapTransactionChunksMax = swapTransactionMb / Ctx::MEMORY_CHUNK_SIZE_MB;
+                }
+
+                if (memoryJson.HasMember("trim-idle-s")) {
+                    ctx->memoryTrimIdleS = Ctx::getJsonFieldU64(configFileName, memoryJson, "trim-idle-s");
+                    if (ctx->memoryTrimIdleS > 86400)
+                        throw ConfigurationException(30001, "bad JSON, invalid \"trim-idle-s\" value: " + std::to_string(ctx->memoryTrimIdleS) +
+                                                            ", expected: one of {0 .. 86400}");
+                }
+
+                if (memoryJson.HasMember("builder-chunk-mb")) {
+                    const uint64_t builderChunkMb = Ctx::getJsonFieldU64(configFileName, memoryJson, "builder-chunk-mb");
+                    if (builderChunkMb < Ctx::MEMORY_CHUNK_SIZE_MB || builderChunkMb > Ctx::MEMORY_BLOCK_MAX_MB ||
+                        (builderChunkMb & (builderChunkMb - 1)) != 0 || builderChunkMb > memoryWriteBufferMaxMb)
+                        throw ConfigurationException(30001, "bad JSON, invalid \"builder-chunk-mb\" value: " + std::to_string(builderChunkMb) +
+                                                            ", expected: power of 2 from " + std::to_string(Ctx::MEMORY_CHUNK_SIZE_MB) + " to " +
+                                                            std::to_string(std::min(Ctx::MEMORY_BLOCK_MAX_MB, memoryWriteBufferMaxMb)));
+                    ctx->setMemoryChunkSizeMb(Ctx::MEMORY::BUILDER, builderChunkMb);
+                }
+
+                if (memoryJson.HasMember("write-credit-mb")) {
+                    const uint64_t writeCreditMb = Ctx::getJsonFieldU64(configFileName, memoryJson, "write-credit-mb");
+                    const uint64_t builderChunkMb = ctx->getMemoryChunkSize(Ctx::MEMORY::BUILDER) / 1024 / 1024;
+                    if (writeCreditMb > 0 && (writeCreditMb < builderChunkMb * 2 || writeCreditMb > memoryWriteBufferMaxMb))
+                        throw ConfigurationException(30001, "bad JSON, invalid \"write-credit-mb\" value: " + std::to_string(writeCreditMb) +
+                                                            ", expected: 0 or from " + std::to_string(builderChunkMb * 2) + " to " +
+                                                            std::to_string(memoryWriteBufferMaxMb));
+                    ctx->writeCreditMb = writeCreditMb;
+                }
+
                 if (memoryJson.HasMember("swap-path") && memorySwapMb > 0)
                     memorySwapPath = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, memoryJson,
                                                         "swap-path");
@@ -1258,6 +2574,103 @@ namespace OpenLogReplicator {
                         std::to_string(memoryMaxMb) + ")");
             }
 
+            // CPU AFFINITY
+#if __linux__
+            // The builder runs on the replicator thread, "default" covers the thread kinds not listed
+            static const std::vector<std::pair<std::string, std::string>> affinityKinds{
+                {"reader", "Reader"}, {"replicator", "Replicator"}, {"writer", "Writer"}, {"checkpoint", "Checkpoint"},
+                {"memory-manager", "MemoryManager"}, {"lwn-decoder", "LwnDecoder"}, {"lob-store", "LobStore"},
+                {"transaction-flusher", "TransactionFlusher"}, {"catch-up-decoder", "CatchUpDecoder"}, {"redo-copy", "RedoCopy"},
+                {"file-syncer", "FileSyncer"}, {"watchdog", "Watchdog"}, {"tracer", "Tracer"}, {"default", "default"}
+            };
+#endif
+            if (sourceJson.HasMember("cpu-affinity")) {
+                const rapidjson::Value& affinityJson = Ctx::getJsonFieldO(configFileName, sourceJson, "cpu-affinity");
+#if __linux__
+                if (!ctx->isDisableChecksSet(Ctx::DISABLE_CHECKS::JSON_TAGS)) {
+                    std::vector<std::string> affinityNames;
+                    for (const auto& [key, kind]: affinityKinds)
+                        affinityNames.push_back(key);
+                    Ctx::checkJsonFields(configFileName, affinityJson, affinityNames);
+                }
+
+                for (const auto& [key, kind]: affinityKinds) {
+                    if (!affinityJson.HasMember(key.c_str()))
+                        continue;
+
+                    const std::string cpus = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, affinityJson, key.c_str());
+                    cpu_set_t cpuSet;
+                    if (!Ctx::parseCpuList(cpus, cpuSet))
+                        throw ConfigurationException(30001, "bad JSON, invalid \"" + key + "\" value: " + cpus +
+                                                            ", expected: list of cpus and ranges, for example: 0-7,16");
+                    ctx->threadAffinity.insert_or_assign(kind, cpuSet);
+                }
+
+                // Core set of the tenant: threads started outside spawnThread(), like those of client libraries, inherit it from here
+                const auto& defaultIt = ctx->threadAffinity.find("default");
+                if (defaultIt != ctx->threadAffinity.end() && pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &defaultIt->second) != 0)
+                    ctx->warning(60053, "setting cpu affinity of the main thread failed");
+#else
+                if (affinityJson.MemberCount() > 0)
+                    throw ConfigurationException(30001, R"(bad JSON, invalid "cpu-affinity" value, expected: empty since not supported on this platform)");
+#endif
+            }
+
+            // THREAD PRIORITY
+            if (sourceJson.HasMember("thread-priority")) {
+                const rapidjson::Value& priorityJson = Ctx::getJsonFieldO(configFileName, sourceJson, "thread-priority");
+#if __linux__
+                if (!ctx->isDisableChecksSet(Ctx::DISABLE_CHECKS::JSON_TAGS)) {
+                    std::vector<std::string> priorityNames;
+                    for (const auto& [key, kind]: affinityKinds)
+                        priorityNames.push_back(key);
+                    Ctx::checkJsonFields(configFileName, priorityJson, priorityNames);
+                }
+
+                for (const auto& [key, kind]: affinityKinds) {
+                    if (!priorityJson.HasMember(key.c_str()))
+                        continue;
+
+                    const rapidjson::Value& kindJson = Ctx::getJsonFieldO(configFileName, priorityJson, key.c_str());
+                    if (!ctx->isDisableChecksSet(Ctx::DISABLE_CHECKS::JSON_TAGS)) {
+                        static const std::vector<std::string> kindNames{"policy", "priority", "nice"};
+                        Ctx::checkJsonFields(configFileName, kindJson, kindNames);
+                    }
+
+                    Ctx::ThreadPriority priority;
+                    if (kindJson.HasMember("policy")) {
+                        const std::string policy = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, kindJson, "policy");
+                        if (policy == "fifo")
+                            priority.policy = SCHED_FIFO;
+                        else if (policy == "rr")
+                            priority.policy = SCHED_RR;
+                        else if (policy != "other")
+                            throw ConfigurationException(30001, "bad JSON, invalid \"policy\" value: " + policy +
+                                                                R"(, expected: one of {"other", "fifo", "rr"})");
+                    }
+
+                    if (priority.policy != SCHED_OTHER) {
+                        priority.priority = Ctx::getJsonFieldI32(configFileName, kindJson, "priority");
+                        if (priority.priority < sched_get_priority_min(priority.policy) || priority.priority > sched_get_priority_max(priority.policy))
+                            throw ConfigurationException(30001, "bad JSON, invalid \"priority\" value: " + std::to_string(priority.priority) +
+                                                                ", expected: one of {" + std::to_string(sched_get_priority_min(priority.policy)) +
+                                                                " .. " + std::to_string(sched_get_priority_max(priority.policy)) + "}");
+                        if (kindJson.HasMember("nice"))
+                            throw ConfigurationException(30001, R"(bad JSON, invalid "nice" value, expected: not set with a real-time policy)");
+                    } else if (kindJson.HasMember("nice")) {
+                        priority.nice = Ctx::getJsonFieldI32(configFileName, kindJson, "nice");
+                        if (priority.nice < -20 || priority.nice > 19)
+                            throw ConfigurationException(30001, "bad JSON, invalid \"nice\" value: " + std::to_string(priority.nice) +
+                                                                ", expected: one of {-20 .. 19}");
+                        priority.niceSet = true;
+                    }
+                    ctx->threadPriority.insert_or_assign(kind, priority);
+                }
+#else
+                if (priorityJson.MemberCount() > 0)
+                    throw ConfigurationException(30001, R"(bad JSON, invalid "thread-priority" value, expected: empty since not supported on this platform)");
+#endif
+            }
 
             // MEMORY MANAGER
             ctx->initialize(memoryMinMb, memoryMaxMb, memoryReadBufferMaxMb, memoryReadBufferMinMb, memorySwapMb,
@@ -1269,45 +2682,154 @@ namespace OpenLogReplicator {
             memoryManager->initialize();
             memoryManagers.push_back(memoryManager);
             ctx->spawnThread(memoryManager);
-            if (sourceJson.HasMember("rac")) {
-                // do_work(1, locales, configFileStat, sourceJson, alias, memoryMaxMb);
-                do_work(2, locales, configFileStat, sourceJson, alias, memoryMaxMb);
-            }else {
-                do_work(-1, locales, configFileStat, sourceJson, alias, memoryMaxMb);
+
+            // A batch source split into shards of the sequence range, each with its own parser and builder
+            uint shards = 1;
+            uint shardOverlap = 2;
+            const rapidjson::Value &shardReaderJson = Ctx::getJsonFieldO(configFileName, sourceJson, "reader");
+            if (shardReaderJson.HasMember("shards")) {
+                shards = Ctx::getJsonFieldU(configFileName, shardReaderJson, "shards");
+                if (shards < 1 || shards > 256)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"shards\" value: " + std::to_string(shards) +
+                                                        ", expected: one of {1 .. 256}");
+                if (shards > 1 && Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, shardReaderJson, "type") != "batch")
+                    throw ConfigurationException(30001, "bad JSON, invalid \"shards\" value: " + std::to_string(shards) +
+                                                        ", expected: 1 when \"type\" is not \"batch\"");
+                if (shards > 1 && sourceJson.HasMember("rac"))
+                    throw ConfigurationException(30001, "bad JSON, invalid \"shards\" value: " + std::to_string(shards) +
+                                                        ", expected: 1 when \"rac\" is set");
+            }
+            if (shardReaderJson.HasMember("shard-overlap")) {
+                shardOverlap = Ctx::getJsonFieldU(configFileName, shardReaderJson, "shard-overlap");
+                if (shardOverlap > 1000)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"shard-overlap\" value: " + std::to_string(shardOverlap) +
+                                                        ", expected: one of {0 .. 1000}");
+            }
+
+            if (shards > 1) {
+                auto *shardCoordinator = new ShardCoordinator(ctx, shards, shardOverlap);
+                shardCoordinators.push_back(shardCoordinator);
+                for (uint shard = 0; shard < shards; ++shard)
+                    do_work(-1, locales, configFileStat, sourceJson, alias, memoryMaxMb, nullptr, shardCoordinator, shard);
+            } else if (sourceJson.HasMember("rac")) {
+                // One reader and parser per redo thread, all applying their LWNs in one scn order
+                const rapidjson::Value &racArrayJson = Ctx::getJsonFieldA(configFileName, sourceJson, "rac");
+                if (racArrayJson.Size() == 0)
+                    throw ConfigurationException(30001, R"(bad JSON, invalid "rac" value: empty list, expected: list of instance numbers)");
+
+                auto *racCoordinator = new RacCoordinator(ctx);
+                racCoordinators.push_back(racCoordinator);
+                std::set<uint> racInstances;
+                for (rapidjson::SizeType k = 0; k < racArrayJson.Size(); ++k) {
+                    const uint instId = Ctx::getJsonFieldU(configFileName, racArrayJson, "rac", k);
+                    if (instId == 0 || !racInstances.insert(instId).second)
+                        throw ConfigurationException(30001, "bad JSON, invalid \"rac\" value: " + std::to_string(instId) +
+                                                            ", expected: unique instance number greater than 0");
+                    do_work(static_cast<int>(instId), locales, configFileStat, sourceJson, alias, memoryMaxMb, racCoordinator, nullptr, 0);
+                }
+            } else {
+                do_work(-1, locales, configFileStat, sourceJson, alias, memoryMaxMb, nullptr, nullptr, 0);
             }
         }
 
         // Iterate through targets
         const rapidjson::Value &targetArrayJson = Ctx::getJsonFieldA(configFileName, document, "target");
-        if (targetArrayJson.Size() != 1) {
+        if (targetArrayJson.Size() < 1) {
             throw ConfigurationException(
                 30001, "bad JSON, invalid \"target\" value: " + std::to_string(targetArrayJson.Size()) +
-                       " elements, expected: 1 element");
+                       " elements, expected: at least 1 element");
         }
 
+        // Many targets of one source share its builder, all tables routed to some target are left out of the targets with no
+        // "tables" list
+        std::unordered_map<std::string, uint64_t> sourceTargets;
+        std::unordered_map<std::string, std::unordered_set<std::string>> sourceTables;
         for (rapidjson::SizeType j = 0; j < targetArrayJson.Size(); ++j) {
             const rapidjson::Value &targetJson = targetArrayJson[j];
             const std::string source = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, targetJson,
                                                       "source");
+            ++sourceTargets[source];
+            if (targetJson.HasMember("tables")) {
+                const rapidjson::Value &tablesJson = Ctx::getJsonFieldA(configFileName, targetJson, "tables");
+                for (rapidjson::SizeType k = 0; k < tablesJson.Size(); ++k)
+                    sourceTables[source].insert(Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, tablesJson,
+                                                                   "tables", k));
+            }
+        }
+
+        for (rapidjson::SizeType j = 0; j < targetArrayJson.Size(); ++j) {
+            const rapidjson::Value &targetJson = targetArrayJson[j];
+            const std::string alias = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, targetJson,
+                                                         "alias");
+            const std::string source = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, targetJson,
+                                                      "source");
+            const uint64_t targets = sourceTargets[source];
+            if (targets > 1) {
+                const rapidjson::Value &writerJson = Ctx::getJsonFieldO(configFileName, targetJson, "writer");
+                const std::string writerType = Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, writerJson,
+                                                                  "type");
+                // The start position of a stream writer is given by its client
+                if (writerType == "zeromq" || writerType == "network" || writerType == "grpc")
+                    throw ConfigurationException(30001, "bad JSON, invalid \"type\" value: " + writerType +
+                                                        ", expected: not a stream writer for a source with many targets");
+            }
+
             Replicator *replicator2 = nullptr;
-            Writer *mergeWriter = createWriter(nullptr, targetJson);
+            Writer *mergeWriter = nullptr;
             for (Replicator *replicatorTmp: replicators)
                 if (replicatorTmp->alias == source) {
                     replicator2 = replicatorTmp;
-                    Writer *writer = createWriter(replicator2, targetJson);
-                    // if (typeid(writer) == typeid(RacWriterFile)) {
-                        RacWriterFile *racWriterFile = reinterpret_cast<RacWriterFile *>(writer);
-                        racWriterFile->setRacMergeWriterFile(reinterpret_cast<RacMergeWriterFile *>(mergeWriter));
-                    // }
+                    replicator2->metadata->writers = targets;
+                    // The instances of a RAC source are merged into one output, the shards of a batch source are not
+                    const bool sharded = replicator2->shardCoordinator != nullptr;
+                    if (mergeWriter == nullptr)
+                        mergeWriter = createWriter(nullptr, targetJson, sharded ? static_cast<int>(replicator2->shard) : -1);
+                    Writer *writer = createWriter(replicator2, targetJson, -1);
+                    if (sharded)
+                        writer->setCheckpointName(replicator2->database + "-shard" + std::to_string(replicator2->shard) + "-" + alias +
+                                                  "-chkpt");
+                    else if (targets > 1)
+                        writer->setCheckpointName(replicator2->database + "-" + alias + "-chkpt");
+                    if (replicator2->metadata->lease != nullptr)
+                        replicator2->metadata->lease->addWriter(writer->getCheckpointName());
+                    if (targetJson.HasMember("tables")) {
+                        const rapidjson::Value &tablesJson = Ctx::getJsonFieldA(configFileName, targetJson, "tables");
+                        for (rapidjson::SizeType k = 0; k < tablesJson.Size(); ++k)
+                            writer->addRouteTable(Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, tablesJson,
+                                                                     "tables", k), true);
+                    } else {
+                        for (const std::string& table: sourceTables[source])
+                            writer->addRouteTable(table, false);
+                    }
+                    // Only the file writer merges the instances, the merge writer of the same target is a file writer too
+                    auto* racWriterFile = dynamic_cast<RacWriterFile*>(writer);
+                    if (racWriterFile != nullptr)
+                        racWriterFile->setRacMergeWriterFile(static_cast<RacMergeWriterFile*>(mergeWriter));
                     ctx->spawnThread(writer);
+                    if (sharded) {
+                        ctx->spawnThread(mergeWriter);
+                        mergeWriter = nullptr;
+                    }
                 }
             if (replicator2 == nullptr)
                 throw ConfigurationException(
                     30001,
                     "bad JSON, invalid \"source\" value: " + source +
                     ", expected: value used earlier in \"source\" field");
+
+            // All instance writers are registered, start merging their output
+            if (mergeWriter != nullptr)
+                ctx->spawnThread(mergeWriter);
         }
 
+        if (ctx->stallTimeoutS > 0) {
+            watchdog = new Watchdog(ctx, "watchdog");
+            ctx->spawnThread(watchdog);
+        }
+
+        if (tracer != nullptr)
+            ctx->spawnThread(tracer);
+
         ctx->mainLoop();
 
         if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
@@ -23,6 +23,7 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include <list>
 #include <rapidjson/document.h>
 #include <string>
+#include <unordered_map>
 
 #include "common/types/Types.h"
 
@@ -30,11 +31,17 @@ namespace OpenLogReplicator {
     class Builder;
     class Ctx;
     class Checkpoint;
+    class LobStore;
     class Locales;
     class MemoryManager;
     class Metadata;
+    class RacArchiveLogList;
+    class RacCoordinator;
     class Replicator;
+    class ShardCoordinator;
     class TransactionBuffer;
+    class Tracer;
+    class Watchdog;
     class Writer;
 
     static const std::string WEB_CONFIG_FILE_NAME = "WebRequest";
@@ -44,12 +51,19 @@ namespace OpenLogReplicator {
         std::vector<Checkpoint *> checkpoints;
         std::vector<Locales *> localess;
         std::vector<Builder *> builders;
+        std::vector<LobStore *> lobStores;
         std::vector<Metadata *> metadatas;
         std::vector<MemoryManager *> memoryManagers;
         std::vector<TransactionBuffer *> transactionBuffers;
         std::vector<Writer *> writers;
         std::vector<Replicator *> racReplicators;
+        std::vector<RacCoordinator *> racCoordinators;
+        std::vector<ShardCoordinator *> shardCoordinators;
+        // Archived log list shared by the instances of each RAC source
+        std::unordered_map<RacCoordinator *, RacArchiveLogList *> racArchiveLogLists;
         Replicator *replicator{nullptr};
+        Watchdog *watchdog{nullptr};
+        Tracer *tracer{nullptr};
         int fid{-1};
         char *configFileBuffer{nullptr};
         std::string configFileName;
@@ -72,9 +86,9 @@ namespace OpenLogReplicator {
 
         void do_work(int instId, Locales *locales, struct stat configFileStat, const rapidjson::Value &sourceJson,
                      std::string alias,
-                     uint64_t memoryMaxMb);
+                     uint64_t memoryMaxMb, RacCoordinator *racCoordinator, ShardCoordinator *shardCoordinator, uint shard);
 
-        Writer* createWriter(Replicator *replicator2, const rapidjson::Value &targetJson);
+        Writer* createWriter(Replicator *replicator2, const rapidjson::Value &targetJson, int shard);
     };
 }
 
@@ -1,6 +1,9 @@
 #include <hv/HttpServer.h>
+#include <mutex>
+#include <unordered_set>
 #include "ReplicatorHttpServer.h"
 #include "ReplicatorManager.h"
+#include "writer/WriterSse.h"
 #include <rapidjson/document.h>
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
@@ -10,6 +13,43 @@ namespace ReplicatorHttpServer {
     volatile bool serverRunning = true;
     hv::HttpServer* httpServer = nullptr;
 
+    // SSE 客户端：写线程通过 libhv 的响应写入器直接向连接推送事件
+    class HttpSseClient final : public OpenLogReplicator::SseClient {
+        HttpResponseWriterPtr writer;
+        // 响应头由订阅线程或第一次写入事件的写线程发送，只发送一次
+        std::mutex mtx;
+        bool begun{false};
+
+    public:
+        explicit HttpSseClient(HttpResponseWriterPtr newWriter) : writer(std::move(newWriter)) {}
+
+        void begin() {
+            std::unique_lock<std::mutex> const lck(mtx);
+            if (!begun) {
+                writer->EndHeaders("Content-Type", "text/event-stream");
+                begun = true;
+            }
+        }
+
+        [[nodiscard]] bool connected() const override {
+            return writer->isConnected();
+        }
+
+        [[nodiscard]] uint64_t backlog() const override {
+            return writer->writeBufsize();
+        }
+
+        void send(const std::string& frame) override {
+            begin();
+            writer->WriteBody(frame);
+        }
+
+        void close() override {
+            writer->End();
+            writer->close(true);
+        }
+    };
+
 
     void registerServer() {
         // 创建复制管理器和HTTP路由器
@@ -64,6 +104,43 @@ namespace ReplicatorHttpServer {
             return ctx->send(R"({"msg":"success"})", ctx->type());
         });
 
+        // 批量启动复制任务：{"parallelism":4,"tenants":{"任务ID":{配置}}}
+        // 同一源数据库的任务只由第一个任务查询数据字典，其余任务在它完成引导后复用，进度可通过 /status 查看
+        router.POST("/start-batch", [&replicator_manager](const HttpContextPtr &ctx) {
+            rapidjson::Document request;
+            if (request.Parse(ctx->body().c_str()).HasParseError() || !request.IsObject() || !request.HasMember("tenants") ||
+                !request["tenants"].IsObject()) {
+                return ctx->send(R"({"error":"expected object with \"tenants\""})", ctx->type());
+            }
+
+            uint64_t parallelism = 4;
+            if (request.HasMember("parallelism")) {
+                if (!request["parallelism"].IsUint64() || request["parallelism"].GetUint64() < 1 || request["parallelism"].GetUint64() > 64)
+                    return ctx->send(R"({"error":"invalid \"parallelism\" value, expected: one of {1 .. 64}"})", ctx->type());
+                parallelism = request["parallelism"].GetUint64();
+            }
+
+            // 每个任务的配置与 /start 一样和默认配置合并
+            std::vector<std::pair<std::string, std::string>> configs;
+            for (auto &tenant: request["tenants"].GetObject()) {
+                rapidjson::Document config;
+                config.Parse(DEFAULT_JSON_CONFIG.c_str());
+                mergeConfigJson(config, tenant.value, config.GetAllocator());
+                rapidjson::StringBuffer buffer;
+                rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+                config.Accept(writer);
+                configs.emplace_back(tenant.name.GetString(), buffer.GetString());
+            }
+
+            try {
+                return ctx->send(replicator_manager.startBatch(configs, parallelism), ctx->type());
+            } catch (const std::exception& ex) {
+                return ctx->send(
+                    R"({"error":")" + std::string(ex.what()) + R"("})",
+                    ctx->type());
+            }
+        });
+
         router.GET("/stop/{id}", [&replicator_manager](const HttpContextPtr &ctx) {
             // 1. 检查指定ID的任务是否存在
             auto it = replicator_manager.threads.find(ctx->param("id"));
@@ -130,6 +207,143 @@ namespace ReplicatorHttpServer {
             }
         });
 
+        // 飞行记录器：各线程最近的上下文切换、LWN 边界、交换与确认事件
+        router.GET("/flight-recorder/{id}", [&replicator_manager](const HttpContextPtr &ctx) {
+            try {
+                std::string events = replicator_manager.getFlightRecorder(ctx->param("id"));
+                return ctx->send(events, ctx->type());
+            } catch (const std::exception& ex) {
+                return ctx->send(
+                    R"({"error":")" + std::string(ex.what()) + R"("})", 
+                    ctx->type());
+            }
+        });
+
+        // 未提交事务：按占用内存排序的前 N 个事务，N 由查询参数 top 指定，默认 20
+        router.GET("/transactions/{id}", [&replicator_manager](const HttpContextPtr &ctx) {
+            try {
+                const std::string topStr = ctx->param("top");
+                const uint64_t top = topStr.empty() ? 20 : strtoull(topStr.c_str(), nullptr, 10);
+                std::string transactions = replicator_manager.getTransactions(ctx->param("id"), top);
+                return ctx->send(transactions, ctx->type());
+            } catch (const std::exception& ex) {
+                return ctx->send(
+                    R"({"error":")" + std::string(ex.what()) + R"("})", 
+                    ctx->type());
+            }
+        });
+
+        // 表开销：按构建耗时排序的前 N 张表，包括缓冲的重做字节、输出字节与消息数，N 由查询参数 top 指定，默认 20
+        router.GET("/tables/{id}", [&replicator_manager](const HttpContextPtr &ctx) {
+            try {
+                const std::string topStr = ctx->param("top");
+                const uint64_t top = topStr.empty() ? 20 : strtoull(topStr.c_str(), nullptr, 10);
+                std::string tables = replicator_manager.getTableCosts(ctx->param("id"), top);
+                return ctx->send(tables, ctx->type());
+            } catch (const std::exception& ex) {
+                return ctx->send(
+                    R"({"error":")" + std::string(ex.what()) + R"("})", 
+                    ctx->type());
+            }
+        });
+
+        // 重做日志中继：列出完整的日志副本，from 为起始序列号
+        router.GET("/redo/{id}", [&replicator_manager](const HttpContextPtr &ctx) {
+            try {
+                const std::string fromStr = ctx->param("from");
+                const uint64_t from = fromStr.empty() ? 0 : strtoull(fromStr.c_str(), nullptr, 10);
+                return ctx->send(replicator_manager.getRedoList(ctx->param("id"), from), ctx->type());
+            } catch (const std::exception& ex) {
+                return ctx->send(
+                    R"({"error":")" + std::string(ex.what()) + R"("})", 
+                    ctx->type());
+            }
+        });
+
+        // 重做日志中继：按 Range 请求头返回日志副本的一段，下游每次只请求有限个范围，实现流量控制
+        router.GET("/redo/{id}/{sequence}", [&replicator_manager](HttpRequest *req, HttpResponse *resp) {
+            static constexpr uint64_t RANGE_MAX = 256 * 1024 * 1024;
+            const uint64_t sequence = strtoull(req->GetParam("sequence").c_str(), nullptr, 10);
+            uint64_t first = 0;
+            uint64_t last = RANGE_MAX - 1;
+            const std::string range = req->GetHeader("Range");
+            if (range.rfind("bytes=", 0) == 0) {
+                char *end = nullptr;
+                first = strtoull(range.c_str() + 6, &end, 10);
+                if (end != nullptr && *end == '-' && *(end + 1) != 0)
+                    last = strtoull(end + 1, nullptr, 10);
+                else
+                    last = first + RANGE_MAX - 1;
+            }
+            if (last < first || last - first >= RANGE_MAX)
+                return 416;
+
+            std::string data;
+            uint64_t fileSize = 0;
+            if (!replicator_manager.getRedo(req->GetParam("id"), sequence, first, last - first + 1, data, fileSize))
+                return 404;
+
+            const int status = data.empty() && first >= fileSize && fileSize > 0 ? 416 : 206;
+            if (!data.empty())
+                resp->SetHeader("Content-Range", "bytes " + std::to_string(first) + "-" + std::to_string(first + data.size() - 1) + "/" +
+                                                 std::to_string(fileSize));
+            else
+                resp->SetHeader("Content-Range", "bytes */" + std::to_string(fileSize));
+            resp->SetContentType("application/octet-stream");
+            resp->body = std::move(data);
+            return status;
+        });
+
+        // 汇总的 Prometheus 指标，所有任务共用一个端口，不再各自启动监听线程
+        router.GET("/metrics", [&replicator_manager](HttpRequest *req, HttpResponse *resp) {
+            try {
+                resp->SetContentType("text/plain; version=0.0.4");
+                resp->body = replicator_manager.getMetrics();
+                return 200;
+            } catch (const std::exception& ex) {
+                resp->body = ex.what();
+                return 404;
+            }
+        });
+
+        // 变更事件的 SSE 订阅：name 为写入器名称，tables 为逗号分隔的 OWNER.TABLE 过滤，scn 为起始位置，
+        // 断线重连时由 Last-Event-ID 请求头从重放缓冲区续传
+        router.GET("/stream/{id}", [](const HttpContextPtr &ctx) {
+            std::unordered_set<std::string> tables;
+            const std::string tablesStr = ctx->param("tables");
+            size_t start = 0;
+            while (start < tablesStr.length()) {
+                size_t comma = tablesStr.find(',', start);
+                if (comma == std::string::npos)
+                    comma = tablesStr.length();
+                if (comma > start)
+                    tables.insert(tablesStr.substr(start, comma - start));
+                start = comma + 1;
+            }
+            const std::string scnStr = ctx->param("scn");
+            const OpenLogReplicator::Scn scn = scnStr.empty() ? OpenLogReplicator::Scn::none() :
+                                               OpenLogReplicator::Scn(strtoull(scnStr.c_str(), nullptr, 10));
+
+            // 订阅失败时返回普通的错误响应，成功后才发送事件流的响应头
+            auto client = std::make_shared<HttpSseClient>(ctx->writer);
+            switch (OpenLogReplicator::WriterSse::subscribe(ctx->param("id"), ctx->param("name"), client, tables, scn,
+                                                            ctx->header("Last-Event-ID"))) {
+                case OpenLogReplicator::WriterSse::SUBSCRIBE::NOT_FOUND:
+                    ctx->setStatus(404);
+                    return ctx->sendString("stream not found");
+                case OpenLogReplicator::WriterSse::SUBSCRIBE::TOO_MANY_CLIENTS:
+                    ctx->setStatus(503);
+                    return ctx->sendString("too many clients");
+                case OpenLogReplicator::WriterSse::SUBSCRIBE::POSITION_LOST:
+                    ctx->setStatus(410);
+                    return ctx->sendString("position no longer in the replay buffer");
+                case OpenLogReplicator::WriterSse::SUBSCRIBE::OK:
+                    break;
+            }
+            client->begin();
+            return HTTP_STATUS_UNFINISHED;
+        });
+
         router.POST("/echo", [](const HttpContextPtr &ctx) {
             return ctx->send(ctx->body(), ctx->type());
         });
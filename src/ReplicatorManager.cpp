@@ -20,10 +20,16 @@
 #include "OpenLogReplicator.h"
 #include "common/ClockHW.h"
 #include "common/Ctx.h"
+#include "common/MemoryPool.h"
 #include "common/Thread.h"
+#include "common/Tracer.h"
 #include "common/exception/ConfigurationException.h"
 #include "common/exception/RuntimeException.h"
+#ifdef LINK_LIBRARY_PROMETHEUS
+#include "common/metrics/MetricsPrometheus.h"
+#endif
 #include "metadata/Metadata.h"
+#include "reader/RedoRelay.h"
 
 #include "ReplicatorManager.h"
 #include "common/Ctx.h"
@@ -48,6 +54,12 @@
 #define HAS_ZEROMQ ""
 #endif /* LINK_LIBRARY_PROTOBUF */
 
+#ifdef LINK_LIBRARY_ARROW
+#define HAS_ARROW " Arrow"
+#else
+#define HAS_ARROW ""
+#endif /* LINK_LIBRARY_ARROW */
+
 #ifdef LINK_LIBRARY_RDKAFKA
 #define HAS_KAFKA " Kafka"
 #else
@@ -74,7 +86,7 @@
 
 namespace ReplicatorManager {
     // �߳�������
-    static void thread_task(std::string id, const ThreadInfo &info) {
+    static void thread_task(std::string id, ThreadInfo &info) {
         // const char *logTimezone = std::getenv("OLR_LOG_TIMEZONE");
         // if (logTimezone != nullptr)
         //     if (!OpenLogReplicator::Data::parseTimezone(logTimezone, ctx->logTimezone))
@@ -104,6 +116,7 @@ namespace ReplicatorManager {
         const char *ps[3] = {"main", "-f", fileName.c_str()};
         // std::thread threadF(mainFunction, argc, ps, &ctx);
         mainFunction(3, ps, info.ctx.get());
+        info.finished = true;
 
         // mainFunction(argc, ps, &ctx);
         // mainCtxMap[id] = &ctx;
@@ -208,6 +221,11 @@ namespace ReplicatorManager {
     }
 
     void ReplicatorManager::exit() {
+        // 先结束批量启动线程，它会持有 map_mutex 启动任务
+        batchStop = true;
+        if (batchThread != nullptr && batchThread->joinable())
+            batchThread->join();
+
         // ֹͣ�����߳�
         std::lock_guard<std::mutex> lock(map_mutex);
         for (auto &[id, info]: threads) {
@@ -242,6 +260,12 @@ namespace ReplicatorManager {
         这个配置定义了Oracle连接参数、过滤条件和输出目标等
         */
         info.ctx->config = config_basic_string;
+        // 任务不再各自预分配 memory-min-mb，而是从共享内存池按需获取，memory-max-mb 仍为单个任务的上限
+        configureMemoryPool();
+        info.ctx->memoryPool = &memoryPool;
+        info.ctx->schemaCache = &schemaCache;
+        info.ctx->tenant = id;
+        info.lastSample = StatsSample{std::chrono::steady_clock::now()};
         /*
         创建一个新的 std::thread 对象执行 thread_task 函数
         传递两个参数：任务ID和ThreadInfo结构体的引用
@@ -253,6 +277,168 @@ namespace ReplicatorManager {
         std::cout << "Started thread " << id << std::endl;
     }
 
+    // 按 source 的 name 与 reader 的 server 分组，同一分组的任务复用第一个任务读取的数据字典
+    std::string ReplicatorManager::startBatch(const std::vector<std::pair<std::string, std::string>> &configs, uint64_t parallelism) {
+        if (batchRunning.exchange(true))
+            throw std::runtime_error("another batch is being started");
+        if (batchThread != nullptr && batchThread->joinable())
+            batchThread->join();
+
+        rapidjson::Document result;
+        result.SetObject();
+        rapidjson::Document::AllocatorType &allocator = result.GetAllocator();
+        rapidjson::Value skipped(rapidjson::kObjectType);
+        std::vector<BatchGroup> groups;
+        std::unordered_map<std::string, size_t> groupIndex;
+        {
+            std::lock_guard<std::mutex> lock(map_mutex);
+            for (const auto &[id, config]: configs) {
+                if (threads.find(id) != threads.end()) {
+                    skipped.AddMember(rapidjson::Value(id.c_str(), allocator).Move(), "already exists", allocator);
+                    continue;
+                }
+
+                rapidjson::Document document;
+                if (document.Parse(config.c_str()).HasParseError() || !document.IsObject() || !document.HasMember("source") ||
+                    !document["source"].IsArray() || document["source"].Empty() || !document["source"][0].IsObject()) {
+                    skipped.AddMember(rapidjson::Value(id.c_str(), allocator).Move(), "invalid configuration", allocator);
+                    continue;
+                }
+
+                const rapidjson::Value &sourceJson = document["source"][0];
+                std::string database;
+                if (sourceJson.HasMember("name") && sourceJson["name"].IsString())
+                    database = sourceJson["name"].GetString();
+                bool pinnable = false;
+                if (sourceJson.HasMember("reader") && sourceJson["reader"].IsObject()) {
+                    const rapidjson::Value &readerJson = sourceJson["reader"];
+                    if (readerJson.HasMember("server") && readerJson["server"].IsString())
+                        database += std::string("@") + readerJson["server"].GetString();
+                    // 只有未指定起始位置的 online 任务可以改用组长的引导 SCN
+                    pinnable = readerJson.HasMember("type") && readerJson["type"].IsString() &&
+                               std::string(readerJson["type"].GetString()) == "online" && !readerJson.HasMember("start-scn") &&
+                               !readerJson.HasMember("start-seq") && !readerJson.HasMember("start-time") && !readerJson.HasMember("start-time-rel");
+                }
+                // 没有数据库名称的任务各自单独引导
+                if (database.empty())
+                    database = "#" + id;
+
+                auto groupIt = groupIndex.find(database);
+                if (groupIt == groupIndex.end()) {
+                    groupIt = groupIndex.emplace(database, groups.size()).first;
+                    groups.emplace_back();
+                    groups.back().database = database;
+                }
+                groups[groupIt->second].tenants.emplace_back(id, config);
+                groups[groupIt->second].pinnable.push_back(pinnable);
+            }
+        }
+
+        rapidjson::Value groupList(rapidjson::kArrayType);
+        for (const BatchGroup &group: groups) {
+            rapidjson::Value groupJson(rapidjson::kObjectType);
+            groupJson.AddMember("database", rapidjson::Value(group.database.c_str(), allocator).Move(), allocator);
+            rapidjson::Value tenantList(rapidjson::kArrayType);
+            for (const auto &tenant: group.tenants)
+                tenantList.PushBack(rapidjson::Value(tenant.first.c_str(), allocator).Move(), allocator);
+            groupJson.AddMember("tenants", tenantList, allocator);
+            groupList.PushBack(groupJson, allocator);
+        }
+        result.AddMember("parallelism", parallelism, allocator);
+        result.AddMember("groups", groupList, allocator);
+        result.AddMember("skipped", skipped, allocator);
+
+        batchStop = false;
+        batchThread = std::make_unique<std::thread>(&ReplicatorManager::runBatch, this, std::move(groups), parallelism);
+
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+        result.Accept(writer);
+        return buffer.GetString();
+    }
+
+    bool ReplicatorManager::isBootstrapped(const std::string &id) {
+        auto it = threads.find(id);
+        if (it == threads.end() || it->second.finished)
+            return true;
+        const OpenLogReplicator::RuntimeStats &stats = it->second.ctx->stats;
+        return OpenLogReplicator::RuntimeStats::get(stats.bootstrapScn) != OpenLogReplicator::Scn::none().getData() ||
+               OpenLogReplicator::RuntimeStats::get(stats.lwnScn) != OpenLogReplicator::Scn::none().getData();
+    }
+
+    // 各分组的第一个任务先启动，完成引导后其余任务以它的引导 SCN 启动，直接从共享缓存取得数据字典
+    void ReplicatorManager::runBatch(std::vector<BatchGroup> groups, uint64_t parallelism) {
+        std::vector<std::string> bootstrapping;
+        while (!batchStop) {
+            bool pending = false;
+            {
+                std::lock_guard<std::mutex> lock(map_mutex);
+                bootstrapping.erase(std::remove_if(bootstrapping.begin(), bootstrapping.end(),
+                                                   [this](const std::string &id) { return isBootstrapped(id); }), bootstrapping.end());
+
+                for (BatchGroup &group: groups) {
+                    if (group.started > 0 && !group.leaderReady && isBootstrapped(group.tenants[0].first)) {
+                        group.leaderReady = true;
+                        auto it = threads.find(group.tenants[0].first);
+                        if (it != threads.end() && !it->second.finished)
+                            group.leaderScn = OpenLogReplicator::RuntimeStats::get(it->second.ctx->stats.bootstrapScn);
+                    }
+
+                    while (group.started < group.tenants.size() && bootstrapping.size() < parallelism && (group.started == 0 || group.leaderReady)) {
+                        const std::string &id = group.tenants[group.started].first;
+                        std::string config = group.tenants[group.started].second;
+                        if (group.started > 0 && group.pinnable[group.started] && group.leaderScn != OpenLogReplicator::Scn::none().getData()) {
+                            rapidjson::Document document;
+                            document.Parse(config.c_str());
+                            document["source"][0]["reader"].AddMember("start-scn", group.leaderScn, document.GetAllocator());
+                            rapidjson::StringBuffer buffer;
+                            rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+                            document.Accept(writer);
+                            config = buffer.GetString();
+                        }
+
+                        ++group.started;
+                        if (threads.find(id) != threads.end()) {
+                            std::cout << "Batch: thread " << id << " already exists!" << std::endl;
+                            continue;
+                        }
+                        start(id, config);
+                        bootstrapping.push_back(id);
+                    }
+
+                    if (group.started < group.tenants.size())
+                        pending = true;
+                }
+            }
+
+            if (!pending && bootstrapping.empty())
+                break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        batchRunning = false;
+    }
+
+    void ReplicatorManager::configureMemoryPool() {
+        if (memoryPoolConfigured)
+            return;
+        memoryPoolConfigured = true;
+
+        const char *maxMbStr = getenv("OLR_SHARED_MEMORY_MAX_MB");
+        if (maxMbStr != nullptr) {
+            const uint64_t maxMb = strtoull(maxMbStr, nullptr, 10);
+            memoryPool.setMaxMb(maxMb);
+            std::cout << "Shared memory pool limit: " << maxMb << "MB" << std::endl;
+        }
+
+        // 所有任务合计的交换文件读写带宽，按各任务 quota 中的 swap-weight 分配
+        const char *swapMbStr = getenv("OLR_SHARED_SWAP_MB_S");
+        if (swapMbStr != nullptr) {
+            const uint64_t swapMbPerSecond = strtoull(swapMbStr, nullptr, 10);
+            memoryPool.setSwapMbPerSecond(swapMbPerSecond);
+            std::cout << "Shared swap bandwidth limit: " << swapMbPerSecond << "MB/s" << std::endl;
+        }
+    }
+
     void ReplicatorManager::stop(std::string id) {
         auto it = threads.find(id);
         it->second.running = false; // ����ֹͣ��־
@@ -320,6 +506,10 @@ namespace ReplicatorManager {
         runtimeInfo.AddMember("softShutdown", it->second.ctx->softShutdown, allocator);    // 使用 .load()
         
         status.AddMember("runtimeInfo", runtimeInfo, allocator);
+
+        rapidjson::Value stats(rapidjson::kObjectType);
+        addRuntimeStats(it->second, stats, allocator);
+        status.AddMember("stats", stats, allocator);
         
         // 序列化为JSON字符串
         rapidjson::StringBuffer buffer;
@@ -329,6 +519,298 @@ namespace ReplicatorManager {
         return buffer.GetString();
     }
 
+    // 环形缓冲区在写入时被复制，复制期间被覆盖的事件会被丢弃，读取不会阻塞复制线程
+    std::string ReplicatorManager::getFlightRecorder(const std::string& id) {
+        std::lock_guard<std::mutex> lock(map_mutex);
+
+        auto it = threads.find(id);
+        if (it == threads.end()) {
+            throw std::runtime_error("Thread " + id + " not found!");
+        }
+
+        using OpenLogReplicator::FlightRecorder;
+        OpenLogReplicator::Ctx *ctx = it->second.ctx.get();
+        const time_ut now = ctx->contextClock.nowUt();
+
+        rapidjson::Document result;
+        result.SetObject();
+        rapidjson::Document::AllocatorType& allocator = result.GetAllocator();
+        result.AddMember("id", rapidjson::Value(id.c_str(), allocator).Move(), allocator);
+        result.AddMember("enabled", ctx->flightRecorder, allocator);
+
+        rapidjson::Value threadList(rapidjson::kArrayType);
+        std::vector<FlightRecorder::Event> events;
+        ctx->forEachThread([&](const OpenLogReplicator::Thread *thread) {
+            events.clear();
+            thread->recorder.snapshot(events);
+
+            rapidjson::Value threadEvents(rapidjson::kObjectType);
+            threadEvents.AddMember("thread", rapidjson::Value(thread->alias.c_str(), allocator).Move(), allocator);
+            threadEvents.AddMember("recorded", thread->recorder.recorded(), allocator);
+            rapidjson::Value eventList(rapidjson::kArrayType);
+            for (const FlightRecorder::Event &event: events) {
+                rapidjson::Value eventJson(rapidjson::kObjectType);
+                eventJson.AddMember("ageUs", static_cast<uint64_t>(now > event.time ? now - event.time : 0), allocator);
+                eventJson.AddMember("event", rapidjson::Value(FlightRecorder::EVENT_NAMES[static_cast<uint>(event.event)], allocator).Move(), allocator);
+                eventJson.AddMember("arg1", event.arg1, allocator);
+                eventJson.AddMember("arg2", event.arg2, allocator);
+                eventJson.AddMember("detail", rapidjson::Value(FlightRecorder::describe(event, now).c_str(), allocator).Move(), allocator);
+                eventList.PushBack(eventJson, allocator);
+            }
+            threadEvents.AddMember("events", eventList, allocator);
+            threadList.PushBack(threadEvents, allocator);
+        });
+        result.AddMember("threads", threadList, allocator);
+
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+        result.Accept(writer);
+
+        return buffer.GetString();
+    }
+
+    // 中继模式下 redo-copy-path 中的完整副本，未开启中继的任务返回错误
+    std::string ReplicatorManager::getRedoList(const std::string& id, uint64_t from) {
+        std::lock_guard<std::mutex> lock(map_mutex);
+
+        auto it = threads.find(id);
+        if (it == threads.end()) {
+            throw std::runtime_error("Thread " + id + " not found!");
+        }
+
+        OpenLogReplicator::Ctx *ctx = it->second.ctx.get();
+        if (!ctx->redoRelay) {
+            throw std::runtime_error("Thread " + id + " is not a redo relay!");
+        }
+        return OpenLogReplicator::RedoRelay::listJson(ctx, OpenLogReplicator::Seq(static_cast<uint32_t>(from)));
+    }
+
+    bool ReplicatorManager::getRedo(const std::string& id, uint64_t sequence, uint64_t offset, uint64_t size, std::string& data,
+                                    uint64_t& fileSize) {
+        std::lock_guard<std::mutex> lock(map_mutex);
+
+        auto it = threads.find(id);
+        if (it == threads.end() || !it->second.ctx->redoRelay) {
+            return false;
+        }
+        return OpenLogReplicator::RedoRelay::read(it->second.ctx.get(), OpenLogReplicator::Seq(static_cast<uint32_t>(sequence)), offset,
+                                                  size, data, fileSize);
+    }
+
+    // 数据来自解析线程约每秒发布一次的快照，读取时不会获取事务缓冲区的锁
+    std::string ReplicatorManager::getMetrics() {
+#ifdef LINK_LIBRARY_PROMETHEUS
+        // 各任务的注册表由 MetricsPrometheus 登记，这里不需要持有 map_mutex
+        return OpenLogReplicator::MetricsPrometheus::serializeShared();
+#else
+        throw std::runtime_error("Prometheus support is not compiled");
+#endif
+    }
+
+    // 数据来自解析线程约每秒发布一次的快照，未启用 metrics 的 table-cost 时没有快照
+    std::string ReplicatorManager::getTableCosts(const std::string& id, uint64_t top) {
+        std::lock_guard<std::mutex> lock(map_mutex);
+
+        auto it = threads.find(id);
+        if (it == threads.end()) {
+            throw std::runtime_error("Thread " + id + " not found!");
+        }
+
+        using OpenLogReplicator::TableCostSnapshot;
+        OpenLogReplicator::Ctx *ctx = it->second.ctx.get();
+        const std::shared_ptr<const TableCostSnapshot> snapshot = ctx->stats.getTableCosts();
+
+        rapidjson::Document result;
+        result.SetObject();
+        rapidjson::Document::AllocatorType& allocator = result.GetAllocator();
+        result.AddMember("id", rapidjson::Value(id.c_str(), allocator).Move(), allocator);
+        if (snapshot == nullptr) {
+            result.AddMember("tables", 0, allocator);
+        } else {
+            const time_ut now = ctx->contextClock.nowUt();
+            result.AddMember("snapshotAgeUs", static_cast<uint64_t>(now > snapshot->published ? now - snapshot->published : 0), allocator);
+            result.AddMember("tables", snapshot->tables, allocator);
+
+            rapidjson::Value entries(rapidjson::kArrayType);
+            for (const TableCostSnapshot::Entry &entry: snapshot->entries) {
+                if (entries.Size() >= top)
+                    break;
+                rapidjson::Value entryJson(rapidjson::kObjectType);
+                entryJson.AddMember("owner", rapidjson::Value(entry.owner.c_str(), allocator).Move(), allocator);
+                entryJson.AddMember("table", rapidjson::Value(entry.table.c_str(), allocator).Move(), allocator);
+                entryJson.AddMember("bytesBuffered", entry.bytesBuffered, allocator);
+                entryJson.AddMember("buildNs", entry.buildNs, allocator);
+                entryJson.AddMember("bytesOut", entry.bytesOut, allocator);
+                entryJson.AddMember("messages", entry.messages, allocator);
+                entries.PushBack(entryJson, allocator);
+            }
+            result.AddMember("top", entries, allocator);
+        }
+
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+        result.Accept(writer);
+
+        return buffer.GetString();
+    }
+
+    std::string ReplicatorManager::getTransactions(const std::string& id, uint64_t top) {
+        std::lock_guard<std::mutex> lock(map_mutex);
+
+        auto it = threads.find(id);
+        if (it == threads.end()) {
+            throw std::runtime_error("Thread " + id + " not found!");
+        }
+
+        using OpenLogReplicator::TransactionSnapshot;
+        OpenLogReplicator::Ctx *ctx = it->second.ctx.get();
+        const std::shared_ptr<const TransactionSnapshot> snapshot = ctx->stats.getTransactions();
+
+        rapidjson::Document result;
+        result.SetObject();
+        rapidjson::Document::AllocatorType& allocator = result.GetAllocator();
+        result.AddMember("id", rapidjson::Value(id.c_str(), allocator).Move(), allocator);
+        if (snapshot == nullptr) {
+            result.AddMember("transactions", 0, allocator);
+        } else {
+            const time_ut now = ctx->contextClock.nowUt();
+            result.AddMember("snapshotAgeUs", static_cast<uint64_t>(now > snapshot->published ? now - snapshot->published : 0), allocator);
+            result.AddMember("transactions", snapshot->transactions, allocator);
+            result.AddMember("bytes", snapshot->bytes, allocator);
+
+            rapidjson::Value entries(rapidjson::kArrayType);
+            for (const TransactionSnapshot::Entry &entry: snapshot->entries) {
+                if (entries.Size() >= top)
+                    break;
+                rapidjson::Value entryJson(rapidjson::kObjectType);
+                entryJson.AddMember("xid", rapidjson::Value(entry.xid.toString().c_str(), allocator).Move(), allocator);
+                entryJson.AddMember("size", entry.size, allocator);
+                entryJson.AddMember("chunks", entry.chunks, allocator);
+                if (entry.swappedMin >= 0) {
+                    entryJson.AddMember("swappedMin", entry.swappedMin, allocator);
+                    entryJson.AddMember("swappedMax", entry.swappedMax, allocator);
+                }
+                entryJson.AddMember("firstSequence", entry.firstSequence.getData(), allocator);
+                entryJson.AddMember("firstOffset", entry.firstFileOffset.getData(), allocator);
+                // 以重做日志时间计算的事务持续时间
+                if (entry.beginEpoch > 0 && snapshot->lwnEpoch >= entry.beginEpoch)
+                    entryJson.AddMember("ageS", static_cast<int64_t>(snapshot->lwnEpoch - entry.beginEpoch), allocator);
+                entries.PushBack(entryJson, allocator);
+            }
+            result.AddMember("top", entries, allocator);
+        }
+
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+        result.Accept(writer);
+
+        return buffer.GetString();
+    }
+
+    // 所有计数均为无锁原子变量，轮询不会阻塞复制线程；仅遍历线程列表时短暂持有线程注册锁
+    void ReplicatorManager::addRuntimeStats(ThreadInfo &info, rapidjson::Value &stats, rapidjson::Document::AllocatorType &allocator) {
+        using OpenLogReplicator::RuntimeStats;
+        using OpenLogReplicator::Thread;
+        OpenLogReplicator::Ctx *ctx = info.ctx.get();
+        const RuntimeStats &counters = ctx->stats;
+
+        // 位置与延迟
+        const uint64_t lwnScn = RuntimeStats::get(counters.lwnScn);
+        const uint64_t confirmedScn = RuntimeStats::get(counters.confirmedScn);
+        if (lwnScn != OpenLogReplicator::Scn::none().getData())
+            stats.AddMember("scn", lwnScn, allocator);
+        if (confirmedScn != OpenLogReplicator::Scn::none().getData())
+            stats.AddMember("confirmedScn", confirmedScn, allocator);
+        const time_t lwnEpoch = RuntimeStats::get(counters.lwnEpoch);
+        if (lwnEpoch > 0)
+            stats.AddMember("lagS", static_cast<int64_t>(time(nullptr) - lwnEpoch), allocator);
+
+        // 累计计数与自上次查询以来的速率
+        const StatsSample sample{std::chrono::steady_clock::now(), RuntimeStats::get(counters.bytesRead), RuntimeStats::get(counters.bytesParsed),
+                                 RuntimeStats::get(counters.bytesSent), RuntimeStats::get(counters.messagesSent)};
+        const double elapsedS = std::chrono::duration<double>(sample.time - info.lastSample.time).count();
+        auto rate = [elapsedS](uint64_t now, uint64_t last) -> double {
+            return (elapsedS > 0 && now >= last) ? static_cast<double>(now - last) / elapsedS : 0;
+        };
+        stats.AddMember("bytesRead", sample.bytesRead, allocator);
+        stats.AddMember("bytesParsed", sample.bytesParsed, allocator);
+        stats.AddMember("recordsParsed", RuntimeStats::get(counters.recordsParsed), allocator);
+        stats.AddMember("creditWaits", RuntimeStats::get(counters.creditWaits), allocator);
+        stats.AddMember("creditWaitUs", RuntimeStats::get(counters.creditWaitUs), allocator);
+        stats.AddMember("messagesBuilt", RuntimeStats::get(counters.messagesBuilt), allocator);
+        stats.AddMember("bytesSent", sample.bytesSent, allocator);
+        stats.AddMember("messagesSent", sample.messagesSent, allocator);
+        stats.AddMember("messagesConfirmed", RuntimeStats::get(counters.messagesConfirmed), allocator);
+        stats.AddMember("readBytesPerS", rate(sample.bytesRead, info.lastSample.bytesRead), allocator);
+        stats.AddMember("parseBytesPerS", rate(sample.bytesParsed, info.lastSample.bytesParsed), allocator);
+        stats.AddMember("sendBytesPerS", rate(sample.bytesSent, info.lastSample.bytesSent), allocator);
+        stats.AddMember("sendMessagesPerS", rate(sample.messagesSent, info.lastSample.messagesSent), allocator);
+        stats.AddMember("writerQueue", RuntimeStats::get(counters.writerQueueSize), allocator);
+        stats.AddMember("rateLimitWaitUs", RuntimeStats::get(counters.rateLimitWaitUs), allocator);
+        info.lastSample = sample;
+
+        // 各模块内存与交换
+        rapidjson::Value memory(rapidjson::kObjectType);
+        for (uint module = 0; module < OpenLogReplicator::Ctx::MEMORY_COUNT; ++module) {
+            const auto memoryModule = static_cast<OpenLogReplicator::Ctx::MEMORY>(module);
+            rapidjson::Value moduleStats(rapidjson::kObjectType);
+            moduleStats.AddMember("usedMb", ctx->getMemoryModuleMb(memoryModule), allocator);
+            moduleStats.AddMember("hwmMb", ctx->getMemoryModuleHwmMb(memoryModule), allocator);
+            memory.AddMember(rapidjson::Value(OpenLogReplicator::Ctx::memoryModules[module].c_str(), allocator).Move(), moduleStats, allocator);
+        }
+        stats.AddMember("memory", memory, allocator);
+        stats.AddMember("swappedMb", ctx->swappedMB.load(std::memory_order_relaxed), allocator);
+        if (ctx->tracer != nullptr) {
+            stats.AddMember("tracesExported", ctx->tracer->tracesExported.load(std::memory_order_relaxed), allocator);
+            stats.AddMember("tracesDropped", ctx->tracer->tracesDropped.load(std::memory_order_relaxed), allocator);
+        }
+
+        // 各阶段抽样延迟分布，桶 n 统计小于 2^n 微秒的样本，只输出非空桶，最后一个桶无上限
+        rapidjson::Value latency(rapidjson::kObjectType);
+        for (uint stage = 0; stage < static_cast<uint>(RuntimeStats::LATENCY::NUM); ++stage) {
+            const OpenLogReplicator::LatencyHistogram &histogram = counters.latency[stage];
+            rapidjson::Value stageStats(rapidjson::kObjectType);
+            stageStats.AddMember("count", histogram.count.load(std::memory_order_relaxed), allocator);
+            stageStats.AddMember("sumUs", histogram.sumUs.load(std::memory_order_relaxed), allocator);
+            rapidjson::Value buckets(rapidjson::kObjectType);
+            for (uint num = 0; num < OpenLogReplicator::LatencyHistogram::BUCKETS; ++num) {
+                const uint64_t count = histogram.buckets[num].load(std::memory_order_relaxed);
+                if (count == 0)
+                    continue;
+                const std::string limit = (num == OpenLogReplicator::LatencyHistogram::BUCKETS - 1) ? "inf" :
+                                          std::to_string(OpenLogReplicator::LatencyHistogram::bucketLimit(num));
+                buckets.AddMember(rapidjson::Value(limit.c_str(), allocator).Move(), count, allocator);
+            }
+            stageStats.AddMember("bucketsUs", buckets, allocator);
+            latency.AddMember(rapidjson::Value(RuntimeStats::LATENCY_NAMES[stage], allocator).Move(), stageStats, allocator);
+        }
+        stats.AddMember("latency", latency, allocator);
+
+        // 各线程在每种上下文中的累计耗时（微秒）与次数，仅在编译时启用 THREAD_INFO 时统计
+        rapidjson::Value threadArray(rapidjson::kArrayType);
+        ctx->forEachThread([&threadArray, &allocator](const Thread *thread) {
+            rapidjson::Value threadStats(rapidjson::kObjectType);
+            threadStats.AddMember("name", rapidjson::Value(thread->getName().c_str(), allocator).Move(), allocator);
+            threadStats.AddMember("alias", rapidjson::Value(thread->alias.c_str(), allocator).Move(), allocator);
+            threadStats.AddMember("finished", thread->finished.load(), allocator);
+            if (Thread::contextCompiled) {
+                rapidjson::Value contextTime(rapidjson::kObjectType);
+                rapidjson::Value contextCnt(rapidjson::kObjectType);
+                for (uint context = static_cast<uint>(Thread::CONTEXT::CPU); context < static_cast<uint>(Thread::CONTEXT::NUM); ++context) {
+                    contextTime.AddMember(rapidjson::Value(Thread::contextNames[context].c_str(), allocator).Move(),
+                                          static_cast<int64_t>(thread->contextTime[context].load(std::memory_order_relaxed)), allocator);
+                    contextCnt.AddMember(rapidjson::Value(Thread::contextNames[context].c_str(), allocator).Move(),
+                                         static_cast<int64_t>(thread->contextCnt[context].load(std::memory_order_relaxed)), allocator);
+                }
+                threadStats.AddMember("contextTimeUs", contextTime, allocator);
+                threadStats.AddMember("contextCount", contextCnt, allocator);
+                threadStats.AddMember("switches", thread->contextSwitches.load(std::memory_order_relaxed), allocator);
+            }
+            threadArray.PushBack(threadStats, allocator);
+        });
+        stats.AddMember("threads", threadArray, allocator);
+    }
+
     int mainFunction(int argc, const char **argv, OpenLogReplicator::Ctx *mainCtx) {
         int ret = 1;
         struct utsname name{};
@@ -345,7 +827,7 @@ namespace ReplicatorManager {
                          ", release: " + name.release + ", build: " +
                          OpenLogReplicator_CMAKE_BUILD_TYPE + ", compiled: " + OpenLogReplicator_CMAKE_BUILD_TIMESTAMP +
                          ", modules:"
-                         HAS_KAFKA HAS_OCI HAS_PROMETHEUS HAS_PROTOBUF HAS_ZEROMQ HAS_STATIC HAS_THREAD_INFO);
+                         HAS_ARROW HAS_KAFKA HAS_OCI HAS_PROMETHEUS HAS_PROTOBUF HAS_ZEROMQ HAS_STATIC HAS_THREAD_INFO);
 
         const char *fileName = "scripts/OpenLogReplicator.json";
         try {
@@ -9,29 +9,75 @@
 #include <iostream>
 #include <thread>
 #include <atomic>
+#include <chrono>
 #include <unordered_map>
 #include <string>
 #include <sstream>
 #include <mutex>
+#include <vector>
 
 #include "common/Ctx.h"
+#include "common/MemoryPool.h"
+#include "metadata/SchemaCache.h"
 
 
 namespace ReplicatorManager {
     // 表示单个复制任务的线程信息结构体
+    // 上次查询状态时的累计计数，两次查询之间的差值用于计算速率
+    struct StatsSample {
+        std::chrono::steady_clock::time_point time;
+        uint64_t bytesRead{0};
+        uint64_t bytesParsed{0};
+        uint64_t bytesSent{0};
+        uint64_t messagesSent{0};
+    };
+
     struct ThreadInfo {
         std::atomic<bool> running; // // 线程运行状态标志
         std::unique_ptr<std::thread> thread; // 实际线程对象
         std::unique_ptr<OpenLogReplicator::Ctx> ctx;  // 复制任务上下文
+        StatsSample lastSample; // 受 map_mutex 保护
+        std::atomic<bool> finished{false}; // 复制任务已退出（正常结束或启动失败）
     };
 
-    static void thread_task(std::string id, const ThreadInfo &info);
+    static void thread_task(std::string id, ThreadInfo &info);
+
+    // 批量启动中的一个源数据库：第一个任务先完成引导，其余任务复用它从数据库读取的数据字典
+    struct BatchGroup {
+        std::string database;
+        std::vector<std::pair<std::string, std::string>> tenants; // 任务ID与配置
+        std::vector<bool> pinnable; // 未指定起始位置的在线任务，可使用第一个任务的引导 SCN
+        size_t started{0};
+        bool leaderReady{false};
+        uint64_t leaderScn{OpenLogReplicator::Scn::none().getData()};
+    };
 
     int mainFunction(int argc, const char **argv, OpenLogReplicator::Ctx *mainCtx);
 
     class ReplicatorManager final {
     protected:
         std::mutex map_mutex; //// 保护线程map的互斥锁
+        // 所有复制任务共享的内存块池，空闲任务释放的内存可被其他任务复用
+        OpenLogReplicator::MemoryPool memoryPool;
+        bool memoryPoolConfigured{false};
+        // 所有复制任务共享的数据字典快照，同一数据库、同一 SCN 的任务只保留一份，发生 DDL 时各自复制
+        OpenLogReplicator::SchemaCache schemaCache;
+
+        // 读取环境变量 OLR_SHARED_MEMORY_MAX_MB 与 OLR_SHARED_SWAP_MB_S，限制所有任务合计使用的内存与交换带宽，
+        // 各任务按 quota 中的权重分配
+        void configureMemoryPool();
+
+        // 批量启动线程，同一时间只运行一个批次
+        std::unique_ptr<std::thread> batchThread;
+        std::atomic<bool> batchRunning{false};
+        std::atomic<bool> batchStop{false};
+
+        // 已启动的任务完成引导（数据字典已加载）或已退出，调用时持有 map_mutex
+        bool isBootstrapped(const std::string &id);
+        void runBatch(std::vector<BatchGroup> groups, uint64_t parallelism);
+
+        // 生成任务的运行统计：SCN 与延迟、读取/解析/发送速率、各模块内存、写入队列深度以及各线程的上下文耗时
+        void addRuntimeStats(ThreadInfo &info, rapidjson::Value &stats, rapidjson::Document::AllocatorType &allocator);
 
     public:
         // 存储所有复制任务的哈希表，键为任务ID
@@ -40,12 +86,26 @@ namespace ReplicatorManager {
         void process_command(const std::string &cmd);
         // 启动新复制任务，参数为任务ID和JSON配置
         void start(std::string id, const std::string &config_basic_string);
+        // 批量启动：按源数据库分组，同时引导的任务数不超过 parallelism，返回分组结果
+        std::string startBatch(const std::vector<std::pair<std::string, std::string>> &configs, uint64_t parallelism);
         // 停止指定ID的复制任务
         void stop(std::string id);
         // 更新运行中任务的配置
         void updateConfig(std::string id, const std::string &newConfig);
         // 获取指定任务的状态信息（包括配置）
         std::string getStatus(const std::string& id);
+        // 获取指定任务各线程飞行记录器中最近的事件
+        std::string getFlightRecorder(const std::string& id);
+        // 获取指定任务中占用内存最多的前 top 个未提交事务
+        std::string getTransactions(const std::string& id, uint64_t top);
+        // 获取指定任务中构建耗时最多的前 top 张表的开销
+        std::string getTableCosts(const std::string& id, uint64_t top);
+        // 中继：列出从 from 开始已完整复制的重做日志
+        std::string getRedoList(const std::string& id, uint64_t from);
+        // 中继：读取重做日志副本的一段，没有完整副本时返回 false
+        bool getRedo(const std::string& id, uint64_t sequence, uint64_t offset, uint64_t size, std::string& data, uint64_t& fileSize);
+        // 所有未单独配置监听地址的任务的 Prometheus 指标，每个序列带 tenant 标签
+        std::string getMetrics();
         // 退出，停止所有任务
         void exit();
     };
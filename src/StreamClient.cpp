@@ -18,6 +18,10 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 <http://www.gnu.org/licenses/>.  */
 
 #include <atomic>
+#include <cstdlib>
+#include <thread>
+#include <unistd.h>
+#include <vector>
 
 #include "common/ClockHW.h"
 #include "common/Ctx.h"
@@ -62,58 +66,84 @@ static uint64_t receive(OpenLogReplicator::pb::RedoResponse& response, OpenLogRe
     return length;
 }
 
-int main(int argc, char** argv) {
-    std::string olrLocales;
-    const char* olrLocalesStr = getenv("OLR_LOCALES");
-    if (olrLocalesStr != nullptr)
-        olrLocales = olrLocalesStr;
-    if (olrLocales == "MOCK")
-        OLR_LOCALES = OpenLogReplicator::Ctx::LOCALES::MOCK;
-
-    OpenLogReplicator::Ctx ctx;
-    const char* logTimezone = std::getenv("OLR_LOG_TIMEZONE");
-    if (logTimezone != nullptr)
-        if (!OpenLogReplicator::Data::parseTimezone(logTimezone, ctx.logTimezone))
-            ctx.error(10070, "invalid environment variable OLR_LOG_TIMEZONE value: " + std::string(logTimezone));
+// Benchmark mode: parallel clients receive and confirm at full speed, shared counters are reported every second
+struct Bench {
+    static constexpr uint64_t LATENCY_BUCKETS{40};
+
+    uint64_t clients{1};
+    uint64_t seconds{60};
+    uint64_t minRate{0};
+    std::atomic<bool> started{false};
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> running{0};
+    std::atomic<uint64_t> failed{0};
+    std::atomic<uint64_t> messages{0};
+    std::atomic<uint64_t> bytes{0};
+    // Microseconds from the message timestamp to its receive time, bucket n counts values below 2^n
+    std::atomic<uint64_t> latency[LATENCY_BUCKETS]{};
+
+    // The timestamp unit depends on the server's timestamp format, it is recognized by its magnitude
+    void add(uint64_t length, uint64_t tm, time_ut now) {
+        messages.fetch_add(1, std::memory_order_relaxed);
+        bytes.fetch_add(length, std::memory_order_relaxed);
+        if (tm == 0)
+            return;
+
+        uint64_t tmUs;
+        if (tm > 100000000000000000UL)
+            tmUs = tm / 1000;
+        else if (tm > 100000000000000UL)
+            tmUs = tm;
+        else if (tm > 100000000000UL)
+            tmUs = tm * 1000;
+        else
+            tmUs = tm * 1000000;
 
-    ctx.welcome("OpenLogReplicator v." + std::to_string(OpenLogReplicator_VERSION_MAJOR) + "." +
-                std::to_string(OpenLogReplicator_VERSION_MINOR) + "." + std::to_string(OpenLogReplicator_VERSION_PATCH) +
-                " StreamClient (C) 2018-2025 by Adam Leszczynski (aleszczynski@bersler.com), see LICENSE file for licensing information");
+        const uint64_t us = static_cast<uint64_t>(now) > tmUs ? static_cast<uint64_t>(now) - tmUs : 0;
+        uint64_t bucket = 0;
+        while (bucket < LATENCY_BUCKETS - 1 && (1UL << bucket) <= us)
+            ++bucket;
+        latency[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
 
-    // Run arguments:
-    // 1. network|zeromq - type of communication protocol
-    // 2. uri - network: host:port, zeromq: tcp://host:port
-    // 3. database - database name
-    // 4. format - protobuf|json
-    // 5. The fifth parameter defines mode to start. If OpenLogReplicator is started for the first time, it would expect to define the position to start
-    //    replication from. If it is running, it would expect the client to provide c:<scn>,<idx> - position of last confirmed message.
-    //    Possible values are:
-    //      now - start from NOW
-    //      now,<seq> - start from NOW but start parsing redo log from sequence <seq>
-    //      scn:<scn> - start from given SCN
-    //      scn:<scn>,<seq> - start from given SCN but start parsing redo log from sequence <seq>
-    //      time_rel:<time> - start from given time (relative to current time)
-    //      time_rel:<time>,<seq> - start from given time (relative to current time) but start parsing redo log from sequence <seq>
-    //      time:<time> - start from given time (absolute)
-    //      time:<time>,<seq> - start from given time (absolute) but start parsing redo log from sequence <seq>
-    //      c:<scn>,<idx> - continue from given SCN and IDX
-    //      next - continue with next message, from the last position
-    if (argc != 6) {
-        ctx.info(0, "use: ClientNetwork [network|zeromq] <uri> <database> <format> [now{,<seq>}|scn:<scn>{,<seq>}|time_rel:<time>{,<seq>}|"
-                    "time:<time>{,<seq>}|c:<scn>,<idx>|next]");
-        return 0;
+    // Upper bound of the bucket holding the given fraction of the samples
+    [[nodiscard]] uint64_t percentile(double fraction) const {
+        uint64_t total = 0;
+        for (const auto& bucket: latency)
+            total += bucket.load(std::memory_order_relaxed);
+        if (total == 0)
+            return 0;
+
+        const auto limit = static_cast<uint64_t>(static_cast<double>(total) * fraction);
+        uint64_t count = 0;
+        for (uint64_t bucket = 0; bucket < LATENCY_BUCKETS; ++bucket) {
+            count += latency[bucket].load(std::memory_order_relaxed);
+            if (count > limit)
+                return 1UL << bucket;
+        }
+        return 1UL << (LATENCY_BUCKETS - 1);
     }
+};
 
-    bool formatProtobuf;
+static void runClient(OpenLogReplicator::Ctx& ctx, char** argv, Bench* bench) {
+    bool formatProtobuf = true;
     OpenLogReplicator::pb::RedoRequest request;
     OpenLogReplicator::pb::RedoResponse response;
     OpenLogReplicator::Stream* stream = nullptr;
     auto* buffer = new uint8_t[MAX_CLIENT_MESSAGE_SIZE];
+    bool failed = false;
 
     try {
         const std::string arg1 = argv[1];
         if (arg1 == "network") {
             stream = new OpenLogReplicator::StreamNetwork(&ctx, argv[2]);
+        } else if (arg1 == "network-tls") {
+            auto* streamNetwork = new OpenLogReplicator::StreamNetwork(&ctx, argv[2]);
+            stream = streamNetwork;
+            const char* tlsCert = getenv("OLR_TLS_CERT");
+            const char* tlsKey = getenv("OLR_TLS_KEY");
+            const char* tlsCa = getenv("OLR_TLS_CA");
+            streamNetwork->setTls(tlsCert != nullptr ? tlsCert : "", tlsKey != nullptr ? tlsKey : "", tlsCa != nullptr ? tlsCa : "", true);
         } else if (arg1 == "zeromq") {
 #ifdef LINK_LIBRARY_ZEROMQ
             stream = new OpenLogReplicator::StreamZeroMQ(&ctx, argv[2]);
@@ -121,7 +151,7 @@ int main(int argc, char** argv) {
             throw OpenLogReplicator::RuntimeException(1, "ZeroMQ is not compiled");
 #endif /* LINK_LIBRARY_ZEROMQ */
         } else {
-            throw OpenLogReplicator::RuntimeException(1, "incorrect transport, expected: [network|zeromq]");
+            throw OpenLogReplicator::RuntimeException(1, "incorrect transport, expected: [network|network-tls|zeromq]");
         }
         stream->initialize();
         stream->initializeClient();
@@ -148,7 +178,8 @@ int main(int argc, char** argv) {
         const std::string arg5 = argv[5];
         if (response.code() == OpenLogReplicator::pb::ResponseCode::REPLICATE) {
             request.set_code(OpenLogReplicator::pb::RequestCode::CONTINUE);
-            if (arg5 == "next") {
+            // Benchmark clients joining a running stream continue with the next message
+            if (arg5 == "next" || (bench != nullptr && arg5.substr(0, 2) != "c:")) {
                 request.set_c_scn(OpenLogReplicator::Scn::none().getData());
                 request.set_c_idx(0);
             } else {
@@ -192,26 +223,51 @@ int main(int argc, char** argv) {
             throw OpenLogReplicator::RuntimeException(1, "server returned code: " + std::to_string(response.code()) +
                                                          " for request code: " + std::to_string(request.code()));
 
-        // Index to count messages, to confirm after 1000th
+        // Compressed batches are decoded by the stream, the server only needs to be asked for them
+        const char* compression = getenv("OLR_STREAM_COMPRESSION");
+        if (compression != nullptr && compression[0] != 0) {
+            OpenLogReplicator::pb::SchemaRequest* option = request.add_schema();
+            option->set_mask("@compression");
+            option->set_filter(compression);
+        }
+
+        // Confirmations are cumulative, so the server is told the last position every n messages or after the interval
+        uint64_t confirmMessages = 1000;
+        uint64_t confirmIntervalUs = (bench != nullptr) ? 100000 : 10000000;
+        const char* confirmMessagesStr = getenv("OLR_CONFIRM_MESSAGES");
+        if (confirmMessagesStr != nullptr && atoll(confirmMessagesStr) > 0)
+            confirmMessages = atoll(confirmMessagesStr);
+        const char* confirmIntervalStr = getenv("OLR_CONFIRM_INTERVAL_MS");
+        if (confirmIntervalStr != nullptr && atoll(confirmIntervalStr) > 0)
+            confirmIntervalUs = atoll(confirmIntervalStr) * 1000;
+
+        // Index to count messages since the last confirmation
         uint64_t num = 0;
         uint64_t last = ctx.clock->getTimeUt();
 
         send(request, stream, &ctx);
         receive(response, stream, &ctx, buffer, true);
         ctx.info(0, "- code: " + std::to_string(static_cast<uint>(response.code())));
+        if (response.attributes().count("compression") > 0)
+            ctx.info(0, "- compression: " + response.attributes().at("compression"));
 
         // Either after start or after continue, the server is expected to start streaming
         if (response.code() != OpenLogReplicator::pb::ResponseCode::REPLICATE)
             throw OpenLogReplicator::RuntimeException(1, "server returned code: " + std::to_string(response.code()) +
                                                          " for request code: " + std::to_string(request.code()));
+        if (bench != nullptr)
+            bench->started = true;
 
-        for (;;) {
+        while (bench == nullptr || !bench->stop) {
             const uint64_t length = receive(response, stream, &ctx, buffer, formatProtobuf);
 
             OpenLogReplicator::Scn cScn;
             uint64_t cIdx;
+            uint64_t tm = 0;
             if (formatProtobuf) {
-                if (response.payload_size() == 1) {
+                if (bench != nullptr)
+                    tm = response.tm();
+                else if (response.payload_size() == 1) {
                     const char* msg;
                     switch (response.payload(0).op()) {
                         case OpenLogReplicator::pb::BEGIN:
@@ -257,7 +313,8 @@ int main(int argc, char** argv) {
                 cIdx = response.c_idx();
             } else {
                 buffer[length] = 0;
-                ctx.info(0, std::string("message: ") + reinterpret_cast<const char*>(buffer));
+                if (bench == nullptr)
+                    ctx.info(0, std::string("message: ") + reinterpret_cast<const char*>(buffer));
 
                 rapidjson::Document document;
                 if (document.Parse(reinterpret_cast<const char*>(buffer)).HasParseError())
@@ -266,21 +323,24 @@ int main(int argc, char** argv) {
 
                 cScn = OpenLogReplicator::Ctx::getJsonFieldU64("network", document, "c_scn");
                 cIdx = OpenLogReplicator::Ctx::getJsonFieldU64("network", document, "c_idx");
+                if (bench != nullptr && document.HasMember("tm") && document["tm"].IsUint64())
+                    tm = document["tm"].GetUint64();
             }
 
             ++num;
             const time_ut now = ctx.clock->getTimeUt();
-            const double timeDelta = static_cast<double>(now - last) / 1000000.0;
+            if (bench != nullptr)
+                bench->add(length, tm, now);
 
-            // Confirm every 1000 messages or every 10 seconds
-            if (num > 1000 || timeDelta > 10) {
+            if (num >= confirmMessages || static_cast<uint64_t>(now - last) >= confirmIntervalUs) {
                 request.Clear();
                 request.set_code(OpenLogReplicator::pb::RequestCode::CONFIRM);
                 request.set_c_scn(cScn.getData());
                 request.set_c_idx(cIdx);
                 request.set_database_name(argv[3]);
-                ctx.info(0, "CONFIRM scn: " + std::to_string(request.c_scn()) + ", idx: " + std::to_string(request.c_idx()) +
-                            ", database: " + request.database_name());
+                if (bench == nullptr)
+                    ctx.info(0, "CONFIRM scn: " + std::to_string(request.c_scn()) + ", idx: " + std::to_string(request.c_idx()) +
+                                ", database: " + request.database_name());
                 send(request, stream, &ctx);
                 num = 0;
                 last = now;
@@ -289,18 +349,158 @@ int main(int argc, char** argv) {
 
     } catch (OpenLogReplicator::DataException& ex) {
         ctx.error(ex.code, "error: " + ex.msg);
+        failed = true;
     } catch (OpenLogReplicator::RuntimeException& ex) {
         ctx.error(ex.code, "error: " + ex.msg);
+        failed = true;
     } catch (OpenLogReplicator::NetworkException& ex) {
         ctx.error(ex.code, "error: " + ex.msg);
+        failed = true;
     } catch (OpenLogReplicator::ConfigurationException& ex) {
         ctx.error(ex.code, "error: " + ex.msg);
+        failed = true;
     } catch (std::bad_alloc& ex) {
         ctx.error(0, "memory allocation failed: " + std::string(ex.what()));
+        failed = true;
     }
+    if (bench != nullptr && failed)
+        ++bench->failed;
+
 
     delete[] buffer;
     delete stream;
+}
+
+static bool parseBench(const std::string& arg, Bench& bench) {
+    if (arg.substr(0, 6) != "bench:")
+        return false;
+
+    char* end;
+    bench.clients = strtoull(arg.c_str() + 6, &end, 10);
+    if (*end == ',') {
+        bench.seconds = strtoull(end + 1, &end, 10);
+        if (*end == ',')
+            bench.minRate = strtoull(end + 1, &end, 10);
+    }
+    return *end == 0 && bench.clients > 0 && bench.seconds > 0;
+}
+
+// Returns 1 when the rate stays below the required minimum or a client fails, so the run can gate CI
+static int runBench(OpenLogReplicator::Ctx& ctx, char** argv, Bench& bench) {
+    std::vector<std::thread> threads;
+    auto client = [&ctx, argv, &bench]() {
+        runClient(ctx, argv, &bench);
+        --bench.running;
+    };
+
+    // The first client may have to start replication, the others join the running stream
+    ++bench.running;
+    threads.emplace_back(client);
+    while (!bench.started && bench.running > 0)
+        usleep(10000);
+    for (uint64_t i = 1; i < bench.clients && bench.running > 0; ++i) {
+        ++bench.running;
+        threads.emplace_back(client);
+    }
+
+    const time_ut start = ctx.clock->getTimeUt();
+    time_ut last = start;
+    uint64_t lastMessages = 0;
+    uint64_t lastBytes = 0;
+    while (bench.running > 0 && static_cast<uint64_t>(last - start) < bench.seconds * 1000000) {
+        usleep(1000000);
+        const time_ut now = ctx.clock->getTimeUt();
+        const uint64_t messages = bench.messages;
+        const uint64_t bytes = bench.bytes;
+        const double seconds = static_cast<double>(now - last) / 1000000.0;
+        ctx.info(0, "bench: " + std::to_string(static_cast<uint64_t>(static_cast<double>(messages - lastMessages) / seconds)) +
+                    " msg/s, " + std::to_string(static_cast<uint64_t>(static_cast<double>(bytes - lastBytes) / seconds)) +
+                    " B/s, clients: " + std::to_string(bench.running));
+        last = now;
+        lastMessages = messages;
+        lastBytes = bytes;
+    }
+    bench.stop = true;
+
+    const double seconds = static_cast<double>(last - start) / 1000000.0;
+    const auto rate = static_cast<uint64_t>(static_cast<double>(bench.messages) / (seconds > 0 ? seconds : 1));
+    ctx.info(0, "bench total: " + std::to_string(bench.messages) + " messages, " + std::to_string(bench.bytes) + " bytes in " +
+                std::to_string(seconds) + " s, " + std::to_string(rate) + " msg/s, " +
+                std::to_string(static_cast<uint64_t>(static_cast<double>(bench.bytes) / (seconds > 0 ? seconds : 1))) + " B/s");
+    ctx.info(0, "bench latency (us): p50 < " + std::to_string(bench.percentile(0.5)) + ", p90 < " +
+                std::to_string(bench.percentile(0.9)) + ", p99 < " + std::to_string(bench.percentile(0.99)) + ", max < " +
+                std::to_string(bench.percentile(1.0)));
+
+    int ret = 0;
+    if (bench.failed > 0) {
+        ctx.error(0, "bench: " + std::to_string(bench.failed) + " clients failed");
+        ret = 1;
+    }
+    if (bench.minRate > 0 && rate < bench.minRate) {
+        ctx.error(0, "bench: " + std::to_string(rate) + " msg/s is below the required " + std::to_string(bench.minRate) + " msg/s");
+        ret = 1;
+    }
+
+    // A client waiting for a message that never comes is not waited for
+    for (uint64_t i = 0; i < 100 && bench.running > 0; ++i)
+        usleep(10000);
+    if (bench.running > 0)
+        std::_Exit(ret);
+    for (std::thread& thread: threads)
+        thread.join();
+    return ret;
+}
+
+int main(int argc, char** argv) {
+    std::string olrLocales;
+    const char* olrLocalesStr = getenv("OLR_LOCALES");
+    if (olrLocalesStr != nullptr)
+        olrLocales = olrLocalesStr;
+    if (olrLocales == "MOCK")
+        OLR_LOCALES = OpenLogReplicator::Ctx::LOCALES::MOCK;
+
+    OpenLogReplicator::Ctx ctx;
+    const char* logTimezone = std::getenv("OLR_LOG_TIMEZONE");
+    if (logTimezone != nullptr)
+        if (!OpenLogReplicator::Data::parseTimezone(logTimezone, ctx.logTimezone))
+            ctx.error(10070, "invalid environment variable OLR_LOG_TIMEZONE value: " + std::string(logTimezone));
+
+    ctx.welcome("OpenLogReplicator v." + std::to_string(OpenLogReplicator_VERSION_MAJOR) + "." +
+                std::to_string(OpenLogReplicator_VERSION_MINOR) + "." + std::to_string(OpenLogReplicator_VERSION_PATCH) +
+                " StreamClient (C) 2018-2025 by Adam Leszczynski (aleszczynski@bersler.com), see LICENSE file for licensing information");
+
+    // Run arguments:
+    // 1. network|network-tls|zeromq - type of communication protocol, network-tls verifies the server against OLR_TLS_CA or the
+    //    system certificates and presents OLR_TLS_CERT/OLR_TLS_KEY when set, OLR_STREAM_COMPRESSION=lz4 asks for compressed batches,
+    //    OLR_CONFIRM_MESSAGES (default 1000) and OLR_CONFIRM_INTERVAL_MS (default 10000, 100 in benchmark) set how often to confirm
+    // 2. uri - network: host:port, zeromq: tcp://host:port
+    // 3. database - database name
+    // 4. format - protobuf|json
+    // 5. The fifth parameter defines mode to start. If OpenLogReplicator is started for the first time, it would expect to define the position to start
+    //    replication from. If it is running, it would expect the client to provide c:<scn>,<idx> - position of last confirmed message.
+    //    Possible values are:
+    //      now - start from NOW
+    //      now,<seq> - start from NOW but start parsing redo log from sequence <seq>
+    //      scn:<scn> - start from given SCN
+    //      scn:<scn>,<seq> - start from given SCN but start parsing redo log from sequence <seq>
+    //      time_rel:<time> - start from given time (relative to current time)
+    //      time_rel:<time>,<seq> - start from given time (relative to current time) but start parsing redo log from sequence <seq>
+    //      time:<time> - start from given time (absolute)
+    //      time:<time>,<seq> - start from given time (absolute) but start parsing redo log from sequence <seq>
+    //      c:<scn>,<idx> - continue from given SCN and IDX
+    //      next - continue with next message, from the last position
+    // 6. optional bench:<clients>,<seconds>{,<min msg/s>} - receive and confirm at full speed, report throughput and
+    //    latency from the message timestamp, fail when the rate is below the minimum
+    Bench bench;
+    if ((argc != 6 && argc != 7) || (argc == 7 && !parseBench(argv[6], bench))) {
+        ctx.info(0, "use: ClientNetwork [network|network-tls|zeromq] <uri> <database> <format> [now{,<seq>}|scn:<scn>{,<seq>}|time_rel:<time>{,<seq>}|"
+                    "time:<time>{,<seq>}|c:<scn>,<idx>|next] {bench:<clients>,<seconds>{,<min msg/s>}}");
+        return 0;
+    }
+
+    if (argc == 7)
+        return runBench(ctx, argv, bench);
 
+    runClient(ctx, argv, nullptr);
     return 0;
 }
@@ -17,7 +17,12 @@ You should have received a copy of the GNU General Public License
 along with OpenLogReplicator; see the file LICENSE;  If not see
 <http://www.gnu.org/licenses/>.  */
 
+#include <algorithm>
+#include <cinttypes>
 #include <cmath>
+#include <cstdio>
+#include <sstream>
+#include <utility>
 #include <vector>
 
 #include "../common/DbColumn.h"
@@ -30,15 +35,18 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include "../metadata/Metadata.h"
 #include "../metadata/Schema.h"
 #include "Builder.h"
+#include "LobStore.h"
 #include "SystemTransaction.h"
 
 namespace OpenLogReplicator {
     Builder::Builder(Ctx* newCtx, Locales* newLocales, Metadata* newMetadata, Format& newFormat, uint64_t newFlushBuffer) :
+            outputBufferDataSize(newCtx->getMemoryChunkSize(Ctx::MEMORY::BUILDER) - sizeof(struct BuilderQueue)),
             ctx(newCtx),
             locales(newLocales),
             metadata(newMetadata),
             format(newFormat),
-            flushBuffer(newFlushBuffer) {
+            flushBuffer(newFlushBuffer),
+            creditBuffers(newCtx->writeCreditMb * 1024 * 1024 / newCtx->getMemoryChunkSize(Ctx::MEMORY::BUILDER)) {
         memset(reinterpret_cast<void*>(valuesSet), 0, sizeof(valuesSet));
         memset(reinterpret_cast<void*>(valuesMerge), 0, sizeof(valuesMerge));
         memset(reinterpret_cast<void*>(values), 0, sizeof(values));
@@ -46,10 +54,13 @@ namespace OpenLogReplicator {
     }
 
     Builder::~Builder() {
+        delete formatPending;
+        formatPending = nullptr;
         releaseValues();
         if (ctx->isFlagSet(Ctx::REDO_FLAGS::SHOW_DDL))
             releaseDdl();
         tables.clear();
+        schemaVersions.clear();
 
         while (firstBuilderQueue != nullptr) {
             BuilderQueue* nextBuffer = firstBuilderQueue->next;
@@ -86,8 +97,292 @@ namespace OpenLogReplicator {
         valueBufferSize = VALUE_BUFFER_MIN;
     }
 
+    void Builder::projectValues(const DbTable* table) {
+        for (const typeCol column: table->columnsSkipped) {
+            const typeMask base = static_cast<uint64_t>(column) >> 6;
+            const typeMask mask = static_cast<uint64_t>(1) << (column & 0x3F);
+            if ((valuesSet[base] & mask) == 0)
+                continue;
+            valuesSet[base] &= ~mask;
+
+            values[column][static_cast<uint>(Format::VALUE_TYPE::BEFORE)] = nullptr;
+            values[column][static_cast<uint>(Format::VALUE_TYPE::BEFORE_SUPP)] = nullptr;
+            values[column][static_cast<uint>(Format::VALUE_TYPE::AFTER)] = nullptr;
+            values[column][static_cast<uint>(Format::VALUE_TYPE::AFTER_SUPP)] = nullptr;
+        }
+    }
+
+    // The lengths of the columns form a chain, every one is found only after the one before it. The row is walked once in a tight loop and the
+    // values are then taken by the column index, columns not output are not touched. Returns the position after the last column
+    typePos Builder::scanRow(const RedoLogRecord* redoLogRecord, typePos pos, typeCC columns) {
+        const uint8_t* data = redoLogRecord->data(pos);
+        typePos offset = 0;
+        for (typeCC i = 0; i < columns; ++i) {
+            const uint8_t lengthByte = data[offset++];
+            typeSize colSize = lengthByte;
+            if (unlikely(lengthByte >= 0xFE)) {
+                if (lengthByte == 0xFF)
+                    colSize = 0;
+                else {
+                    colSize = ctx->read16(data + offset);
+                    offset += 2;
+                }
+            }
+            rowColumnPos[i] = pos + offset;
+            rowColumnSize[i] = colSize;
+            offset += colSize;
+        }
+        return pos + offset;
+    }
+
+    Builder::CompactImage Builder::compactCopy(const uint8_t* data, int64_t size) {
+        if (data == nullptr)
+            return {0, -1};
+
+        const uint64_t pos = compactData.size();
+        if (size > 0)
+            compactData.insert(compactData.end(), data, data + size);
+        return {pos, size};
+    }
+
+    // The first before image and the last after image of every column are kept
+    void Builder::compactMerge(CompactRow& row, bool mergeBefore, bool mergeAfter) {
+        std::vector<CompactColumn> merged;
+        merged.reserve(row.columns.size() + compactChange.size());
+        auto oldIt = row.columns.cbegin();
+        auto newIt = compactChange.cbegin();
+        while (oldIt != row.columns.cend() || newIt != compactChange.cend()) {
+            if (newIt == compactChange.cend() || (oldIt != row.columns.cend() && oldIt->column < newIt->column)) {
+                merged.push_back(*oldIt);
+                ++oldIt;
+                continue;
+            }
+
+            CompactColumn column{newIt->column, {0, -1}, {0, -1}};
+            if (oldIt != row.columns.cend() && oldIt->column == newIt->column) {
+                column = *oldIt;
+                ++oldIt;
+            }
+            if (mergeBefore && column.before.size < 0)
+                column.before = newIt->before;
+            if (mergeAfter && newIt->after.size >= 0)
+                column.after = newIt->after;
+            merged.push_back(column);
+            ++newIt;
+        }
+        row.columns.swap(merged);
+    }
+
+    // Values of the row are copied, the redo they point to is released before the transaction ends
+    void Builder::compactStore(Format::TRANSACTION_TYPE type, Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx,
+                               const DbTable* table, typeObj obj, typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset) {
+        compactSequence = sequence;
+        compactTimestamp = timestamp;
+        compactLobCtx = lobCtx;
+        compactXmlCtx = xmlCtx;
+
+        compactChange.clear();
+        const typeCol baseMax = valuesMax >> 6;
+        for (typeCol base = 0; base <= baseMax; ++base) {
+            const auto columnBase = static_cast<typeCol>(base << 6);
+            typeMask set = valuesSet[base];
+            while (set != 0) {
+                const typeCol pos = ffsll(set) - 1;
+                set &= ~(1ULL << pos);
+                const typeCol column = columnBase + pos;
+                compactChange.push_back({column,
+                                         compactCopy(values[column][static_cast<uint>(Format::VALUE_TYPE::BEFORE)],
+                                                     sizes[column][static_cast<uint>(Format::VALUE_TYPE::BEFORE)]),
+                                         compactCopy(values[column][static_cast<uint>(Format::VALUE_TYPE::AFTER)],
+                                                     sizes[column][static_cast<uint>(Format::VALUE_TYPE::AFTER)])});
+            }
+        }
+
+        const RowId rowId(dataObj, bdba, slot);
+        // A row which can't be decoded again from its images keeps its place in the order, unmerged
+        if (table == nullptr || compressedBefore || compressedAfter) {
+            compactRows.push_back({type, table, obj, rowId, scn, fileOffset, compressedBefore, compressedAfter, compactChange});
+            return;
+        }
+
+        auto compactIndexIt = compactIndex.find(rowId);
+        if (compactIndexIt != compactIndex.end() && compactRows[compactIndexIt->second].table == table) {
+            CompactRow& row = compactRows[compactIndexIt->second];
+            const Format::TRANSACTION_TYPE rowType = row.type;
+            row.scn = scn;
+            row.fileOffset = fileOffset;
+
+            if (rowType == Format::TRANSACTION_TYPE::INSERT && type == Format::TRANSACTION_TYPE::UPDATE) {
+                compactMerge(row, false, true);
+                return;
+            }
+            if (rowType == Format::TRANSACTION_TYPE::INSERT && type == Format::TRANSACTION_TYPE::DELETE) {
+                row.type = Format::TRANSACTION_TYPE::T_NONE;
+                row.columns.clear();
+                return;
+            }
+            if (rowType == Format::TRANSACTION_TYPE::UPDATE && type == Format::TRANSACTION_TYPE::UPDATE) {
+                compactMerge(row, true, true);
+                return;
+            }
+            if (rowType == Format::TRANSACTION_TYPE::UPDATE && type == Format::TRANSACTION_TYPE::DELETE) {
+                compactMerge(row, true, false);
+                for (CompactColumn& column: row.columns)
+                    column.after = {0, -1};
+                row.type = Format::TRANSACTION_TYPE::DELETE;
+                return;
+            }
+            if (rowType == Format::TRANSACTION_TYPE::DELETE && type == Format::TRANSACTION_TYPE::INSERT) {
+                compactMerge(row, false, true);
+                row.type = Format::TRANSACTION_TYPE::UPDATE;
+                return;
+            }
+            // Any other sequence, like a row inserted again after it was removed, starts a new row
+        }
+
+        compactIndex.insert_or_assign(rowId, compactRows.size());
+        compactRows.push_back({type, table, obj, rowId, scn, fileOffset, false, false, compactChange});
+    }
+
+    void Builder::compactEmit(const CompactRow& row) {
+        compressedBefore = row.compressedBefore;
+        compressedAfter = row.compressedAfter;
+        // Columns which got their first value back are not a change any more
+        const bool update = row.type == Format::TRANSACTION_TYPE::UPDATE && row.table != nullptr && !row.compressedBefore && !row.compressedAfter;
+        const bool dropUnchanged = update && format.columnFormat < Format::COLUMN_FORMAT::FULL_UPD;
+        bool changed = !dropUnchanged;
+
+        for (const CompactColumn& column: row.columns) {
+            CompactImage before = column.before;
+            CompactImage after = column.after;
+            if (before.size < 0 && after.size < 0)
+                continue;
+
+            // For update assume null for missing columns
+            if (update) {
+                if (before.size < 0)
+                    before = {0, 0};
+                if (after.size < 0)
+                    after = {0, 0};
+            }
+
+            if (dropUnchanged && row.table->columns[column.column]->numPk == 0) {
+                if (before.size == after.size && (before.size == 0 ||
+                        memcmp(compactData.data() + before.pos, compactData.data() + after.pos, before.size) == 0))
+                    continue;
+                changed = true;
+            }
+
+            const typeMask base = static_cast<uint64_t>(column.column) >> 6;
+            const typeMask mask = static_cast<uint64_t>(1) << (column.column & 0x3F);
+            valuesSet[base] |= mask;
+            if (column.column >= valuesMax)
+                valuesMax = column.column + 1;
+            if (before.size >= 0) {
+                values[column.column][static_cast<uint>(Format::VALUE_TYPE::BEFORE)] =
+                        before.size > 0 ? compactData.data() + before.pos : reinterpret_cast<const uint8_t*>(1);
+                sizes[column.column][static_cast<uint>(Format::VALUE_TYPE::BEFORE)] = before.size;
+            }
+            if (after.size >= 0) {
+                values[column.column][static_cast<uint>(Format::VALUE_TYPE::AFTER)] =
+                        after.size > 0 ? compactData.data() + after.pos : reinterpret_cast<const uint8_t*>(1);
+                sizes[column.column][static_cast<uint>(Format::VALUE_TYPE::AFTER)] = after.size;
+            }
+        }
+
+        if (changed) {
+            switch (row.type) {
+                case Format::TRANSACTION_TYPE::INSERT:
+                    processInsert(row.scn, compactSequence, compactTimestamp, compactLobCtx, compactXmlCtx, row.table, row.obj, row.rowId.dataObj,
+                                  row.rowId.dba, row.rowId.slot, row.fileOffset);
+                    if (ctx->metrics != nullptr)
+                        emitDmlOps(Metrics::DML_OPS::INSERT_OUT, row.table);
+                    break;
+
+                case Format::TRANSACTION_TYPE::UPDATE:
+                    processUpdate(row.scn, compactSequence, compactTimestamp, compactLobCtx, compactXmlCtx, row.table, row.obj, row.rowId.dataObj,
+                                  row.rowId.dba, row.rowId.slot, row.fileOffset);
+                    if (ctx->metrics != nullptr)
+                        emitDmlOps(Metrics::DML_OPS::UPDATE_OUT, row.table);
+                    break;
+
+                case Format::TRANSACTION_TYPE::DELETE:
+                    processDelete(row.scn, compactSequence, compactTimestamp, compactLobCtx, compactXmlCtx, row.table, row.obj, row.rowId.dataObj,
+                                  row.rowId.dba, row.rowId.slot, row.fileOffset);
+                    if (ctx->metrics != nullptr)
+                        emitDmlOps(Metrics::DML_OPS::DELETE_OUT, row.table);
+                    break;
+
+                case Format::TRANSACTION_TYPE::T_NONE:
+                    break;
+            }
+        }
+
+        releaseValues();
+    }
+
+    // Sends the net changes collected so far, called when nothing else is being built: before a DDL, the commit and a forced split
+    void Builder::compactFlush() {
+        if (compactRows.empty())
+            return;
+
+        for (const CompactRow& row: compactRows)
+            if (row.type != Format::TRANSACTION_TYPE::T_NONE)
+                compactEmit(row);
+
+        compactRows.clear();
+        compactIndex.clear();
+        compactData.clear();
+        compactLobCtx = nullptr;
+        compactXmlCtx = nullptr;
+    }
+
+    bool Builder::lobStreamStart(const std::string& columnName, bool isClob) {
+        // The size of a streamed value is known only at the end, so it can't be passed to the LOB store
+        if (!ctx->isFlagSet(Ctx::REDO_FLAGS::LOB_STREAM) || !isStreamSupported() || lobStore != nullptr)
+            return false;
+
+        lobStreamColumn = &columnName;
+        lobStreamClob = isClob;
+        lobStreamStarted = false;
+        return true;
+    }
+
+    // A LOB shorter than one fragment is output as a regular value, a longer one is closed with what was written so far
+    void Builder::lobStreamFinish(bool found, FileOffset fileOffset) {
+        const std::string& columnName = *lobStreamColumn;
+        if (!lobStreamStarted) {
+            lobStreamColumn = nullptr;
+            if (!found)
+                return;
+            if (lobStreamClob)
+                columnString(columnName);
+            else
+                columnRaw(columnName, reinterpret_cast<const uint8_t*>(valueBuffer), valueSize);
+            return;
+        }
+
+        lobStreamFlush(true);
+        columnStreamEnd();
+        lobStreamColumn = nullptr;
+        if (unlikely(!found))
+            ctx->warning(60042, "incomplete LOB for xid: " + lastXid.toString() + ", column: " + columnName + ", streamed value truncated at offset: " +
+                                fileOffset.toString());
+        valueBufferPurge();
+    }
+
+    bool Builder::lobExternalize(const std::string& columnName) {
+        if (lobStore == nullptr || valueSize < lobStore->sizeMin)
+            return false;
+
+        const std::string hash = lobStore->store(buildThread(), reinterpret_cast<const uint8_t*>(valueBuffer), valueSize);
+        columnLobRef(columnName, hash, valueSize);
+        return true;
+    }
+
     void Builder::processValue(LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table, typeCol col, const uint8_t* data, uint32_t size,
                                FileOffset fileOffset, bool after, bool compressed) {
+        valueColumn = nullptr;
         if (compressed) {
             const std::string columnName("COMPRESSED");
             columnRaw(columnName, data, size);
@@ -99,6 +394,7 @@ namespace OpenLogReplicator {
             return;
         }
         DbColumn* column = table->columns[col];
+        valueColumn = column;
         if (ctx->isFlagSet(Ctx::REDO_FLAGS::RAW_COLUMN_DATA)) {
             columnRaw(column->name, data, size);
             return;
@@ -133,19 +429,31 @@ namespace OpenLogReplicator {
                 break;
 
             case SysCol::COLTYPE::NUMBER:
-                parseNumber(data, size, fileOffset);
-                columnNumber(column->name, column->precision, column->scale);
+                columnNumberData(column->name, column->precision, column->scale, data, size, fileOffset);
                 break;
 
             case SysCol::COLTYPE::BLOB:
                 if (after) {
-                    if (parseLob(lobCtx, data, size, 0, table->obj, fileOffset, false, table->sys)) {
-                        if (column->xmlType && ctx->isFlagSet(Ctx::REDO_FLAGS::EXPERIMENTAL_XMLTYPE)) {
-                            if (parseXml(xmlCtx, reinterpret_cast<const uint8_t*>(valueBuffer), valueSize, fileOffset))
-                                columnString(column->name);
-                            else
+                    if (column->xmlType && ctx->isFlagSet(Ctx::REDO_FLAGS::EXPERIMENTAL_XMLTYPE)) {
+                        // The encoded value is reassembled whole, only the decoded text may be streamed
+                        if (parseLob(lobCtx, data, size, 0, table->obj, fileOffset, false, table->sys)) {
+                            const bool stream = lobStreamStart(column->name, true);
+                            if (parseXml(xmlCtx, reinterpret_cast<const uint8_t*>(valueBuffer), valueSize, fileOffset)) {
+                                if (stream)
+                                    lobStreamFinish(true, fileOffset);
+                                else
+                                    columnString(column->name);
+                            } else if (stream && lobStreamStarted) {
+                                lobStreamFinish(false, fileOffset);
+                            } else {
+                                lobStreamColumn = nullptr;
                                 columnRaw(column->name, reinterpret_cast<const uint8_t*>(valueBufferOld), valueSizeOld);
-                        } else
+                            }
+                        }
+                    } else if (lobStreamStart(column->name, false)) {
+                        lobStreamFinish(parseLob(lobCtx, data, size, 0, table->obj, fileOffset, false, table->sys), fileOffset);
+                    } else if (parseLob(lobCtx, data, size, 0, table->obj, fileOffset, false, table->sys)) {
+                        if (!lobExternalize(column->name))
                             columnRaw(column->name, reinterpret_cast<const uint8_t*>(valueBuffer), valueSize);
                     }
                 }
@@ -154,13 +462,18 @@ namespace OpenLogReplicator {
             case SysCol::COLTYPE::JSON:
                 if (ctx->isFlagSet(Ctx::REDO_FLAGS::EXPERIMENTAL_JSON))
                     if (parseLob(lobCtx, data, size, 0, table->obj, fileOffset, false, table->sys))
-                        columnRaw(column->name, reinterpret_cast<const uint8_t*>(valueBuffer), valueSize);
+                        columnJson(column->name, reinterpret_cast<const uint8_t*>(valueBuffer), valueSize, fileOffset);
                 break;
 
             case SysCol::COLTYPE::CLOB:
                 if (after) {
-                    if (parseLob(lobCtx, data, size, column->charsetId, table->obj, fileOffset, true, table->systemTable > DbTable::TABLE::NONE))
-                        columnString(column->name);
+                    if (lobStreamStart(column->name, true))
+                        lobStreamFinish(parseLob(lobCtx, data, size, column->charsetId, table->obj, fileOffset, true,
+                                                 table->systemTable > DbTable::TABLE::NONE), fileOffset);
+                    else if (parseLob(lobCtx, data, size, column->charsetId, table->obj, fileOffset, true, table->systemTable > DbTable::TABLE::NONE)) {
+                        if (!lobExternalize(column->name))
+                            columnString(column->name);
+                    }
                 }
                 break;
 
@@ -331,10 +644,8 @@ namespace OpenLogReplicator {
                         tz = std::string_view(tz2, 6);
                     } else {
                         const uint16_t tzKey = (data[11] << 8) | data[12];
-                        auto timeZoneMapIt = locales->timeZoneMap.find(tzKey);
-                        if (timeZoneMapIt != locales->timeZoneMap.end())
-                            tz = timeZoneMapIt->second;
-                        else
+                        tz = locales->getTimeZone(tzKey);
+                        if (unlikely(tz.empty()))
                             tz = "TZ?";
                     }
 
@@ -684,34 +995,92 @@ namespace OpenLogReplicator {
         return maxMessageMb;
     }
 
+    void Builder::emitDmlOps(Metrics::DML_OPS op, const DbTable* table) {
+        if (table != nullptr && ((ctx->metrics->isTagNamesFilter() && !DbTable::isSystemTable(table->options) && !DbTable::isDebugTable(table->options)) ||
+                                 (ctx->metrics->isTagNamesSys() && DbTable::isSystemTable(table->options)))) {
+            MetricsCounter*& counter = table->dmlOpsCounters[static_cast<uint>(op)];
+            if (unlikely(counter == nullptr))
+                counter = ctx->metrics->getDmlOpsCounter(op, table->owner, table->name);
+            counter->increment(1);
+        } else
+            ctx->metrics->emitDmlOps(op, 1);
+    }
+
+    // Output of the message is counted for its table, a batch of rows of many tables has no table
+    void Builder::tableCostOutput() {
+        const DbTable* table = metadata->schema->checkTableDict(msg->obj);
+        if (table == nullptr)
+            return;
+        tableCostLocal.add(table, Metrics::TABLE_COST::BYTES_OUT, msg->size);
+        tableCostLocal.add(table, Metrics::TABLE_COST::MESSAGES, 1);
+    }
+
     void Builder::setMaxMessageMb(uint64_t maxMessageMb_) {
         maxMessageMb = maxMessageMb_;
     }
 
+    // Caller holds Metadata::mtxTransaction, so no transaction is being built while the format is replaced
+    void Builder::setFormat(const Format& newFormat) {
+        delete formatPending;
+        formatPending = new Format(newFormat);
+    }
+
     void Builder::processBegin(Xid xid, Scn scn, Scn newLwnScn, const std::unordered_map<std::string, std::string>* newAttributes) {
         lastXid = xid;
         commitScn = scn;
+        LogSink::setXid(xid);
+        LogSink::setScn(scn);
         if (lwnScn != newLwnScn) {
             lwnScn = newLwnScn;
             lwnIdx = 0;
         }
         newTran = true;
         attributes = newAttributes;
+        conditionContext.begin(newAttributes);
+        // Left over only when the previous transaction failed
+        compactRows.clear();
+        compactIndex.clear();
+        compactData.clear();
+        commitTime = ctx->isLatencySampled(latencySampleCnt) ? ctx->clock->getTimeUt() : 0;
+        trace = nullptr;
+
+        if (unlikely(formatPending != nullptr)) {
+            batchClose();
+            format = *formatPending;
+            delete formatPending;
+            formatPending = nullptr;
+            formatChanged();
+        }
 
         if (attributes->empty()) {
             metadata->ctx->warning(50065, "empty attributes for XID: " + lastXid.toString());
         }
     }
 
+    // Messages built outside of a transaction, like checkpoints, are not timed against its commit
+    void Builder::processEnd() {
+        commitTime = 0;
+        trace = nullptr;
+
+        if (unlikely(ctx->tableCost != nullptr)) {
+            const time_ut now = ctx->clock->getTimeUt();
+            if (tableCostLocal.mergeDue(now))
+                ctx->tableCost->merge(buildThread(), tableCostLocal, now);
+        }
+    }
+
     // 0x05010B0B
     void Builder::processInsertMultiple(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx,
                                         const RedoLogRecord* redoLogRecord1, const RedoLogRecord* redoLogRecord2, bool system, bool schema, bool dump) {
+        if (unlikely(compactData.size() > COMPACT_DATA_MAX))
+            compactFlush();
         typePos fieldPos = 0;
         typePos fieldPosStart;
         typeField fieldNum = 0;
         typeSize fieldSize = 0;
         typeSize colSize;
         const DbTable* table = metadata->schema->checkTableDict(redoLogRecord1->obj);
+        const BuildTimer buildTimer(this, table);
         if (format.isScnTypeCommitValue())
             scn = commitScn;
 
@@ -739,23 +1108,23 @@ namespace OpenLogReplicator {
             else
                 maxI = jcc;
 
+            // Columns not output are dropped here already, they are never referenced by the condition
+            const typeCC present = static_cast<typeCC>(std::min<typeCol>(jcc, maxI));
+            const typePos rowEnd = scanRow(redoLogRecord2, fieldPos + pos, present);
+            const bool skipColumns = table != nullptr && !table->columnsSkippedMask.empty() && !DbTable::isSystemTable(table->options);
             for (typeCol i = 0; i < maxI; ++i) {
-                if (i >= jcc) {
-                    colSize = 0;
-                } else {
-                    colSize = *redoLogRecord2->data(fieldPos + pos);
-                    ++pos;
-                    if (colSize == 0xFF) {
-                        colSize = 0;
-                    } else if (colSize == 0xFE) {
-                        colSize = ctx->read16(redoLogRecord2->data(fieldPos + pos));
-                        pos += 2;
-                    }
+                if (skipColumns && table->isColumnSkipped(i))
+                    continue;
+
+                typePos colPos = rowEnd;
+                colSize = 0;
+                if (i < present) {
+                    colPos = rowColumnPos[i];
+                    colSize = rowColumnSize[i];
                 }
 
                 if (colSize > 0 || format.columnFormat >= Format::COLUMN_FORMAT::FULL_INS_DEC || table == nullptr || table->columns[i]->numPk > 0)
-                    valueSet(Format::VALUE_TYPE::AFTER, i, redoLogRecord2->data(fieldPos + pos), colSize, 0, dump);
-                pos += colSize;
+                    valueSet(Format::VALUE_TYPE::AFTER, i, redoLogRecord2->data(colPos), colSize, 0, dump);
             }
 
             if (system && table != nullptr && DbTable::isSystemTable(table->options))
@@ -763,31 +1132,18 @@ namespace OpenLogReplicator {
                                                  ctx->read16(redoLogRecord2->data(redoLogRecord2->slotsDelta + (r * 2))),
                                                  redoLogRecord1->fileOffset);
 
+            conditionContext.setRow(values, sizes, Format::VALUE_TYPE::AFTER, Format::VALUE_TYPE::AFTER);
             if ((!schema && table != nullptr && !DbTable::isSystemTable(table->options) && !DbTable::isDebugTable(table->options) &&
-                 table->matchesCondition(ctx, 'i', attributes)) || ctx->isFlagSet(Ctx::REDO_FLAGS::SHOW_SYSTEM_TRANSACTIONS) ||
+                 table->matchesCondition(ctx, 'i', conditionContext)) || ctx->isFlagSet(Ctx::REDO_FLAGS::SHOW_SYSTEM_TRANSACTIONS) ||
                 ctx->isFlagSet(Ctx::REDO_FLAGS::SCHEMALESS)) {
+                if (table != nullptr && !table->columnsSkipped.empty())
+                    projectValues(table);
 
-                processInsert(scn, sequence, timestamp, lobCtx, xmlCtx, table, redoLogRecord2->obj, redoLogRecord2->dataObj, redoLogRecord2->bdba,
-                              ctx->read16(redoLogRecord2->data(redoLogRecord2->slotsDelta + (r * 2))), redoLogRecord1->fileOffset);
-                if (ctx->metrics != nullptr) {
-                    if (ctx->metrics->isTagNamesFilter() && table != nullptr &&
-                            !DbTable::isSystemTable(table->options) && !DbTable::isDebugTable(table->options))
-                        ctx->metrics->emitDmlOpsInsertOut(1, table->owner, table->name);
-                    else if (ctx->metrics->isTagNamesSys() && table != nullptr && DbTable::isSystemTable(table->options))
-                        ctx->metrics->emitDmlOpsInsertOut(1, table->owner, table->name);
-                    else
-                        ctx->metrics->emitDmlOpsInsertOut(1);
-                }
+                emitInsert(scn, sequence, timestamp, lobCtx, xmlCtx, table, redoLogRecord2->obj, redoLogRecord2->dataObj, redoLogRecord2->bdba,
+                           ctx->read16(redoLogRecord2->data(redoLogRecord2->slotsDelta + (r * 2))), redoLogRecord1->fileOffset);
             } else {
-                if (ctx->metrics != nullptr) {
-                    if (ctx->metrics->isTagNamesFilter() && table != nullptr &&
-                            !DbTable::isSystemTable(table->options) && !DbTable::isDebugTable(table->options))
-                        ctx->metrics->emitDmlOpsInsertSkip(1, table->owner, table->name);
-                    else if (ctx->metrics->isTagNamesSys() && table != nullptr && DbTable::isSystemTable(table->options))
-                        ctx->metrics->emitDmlOpsInsertSkip(1, table->owner, table->name);
-                    else
-                        ctx->metrics->emitDmlOpsInsertSkip(1);
-                }
+                if (ctx->metrics != nullptr)
+                    emitDmlOps(Metrics::DML_OPS::INSERT_SKIP, table);
             }
 
             releaseValues();
@@ -796,15 +1152,49 @@ namespace OpenLogReplicator {
         }
     }
 
+    // Row read from the table by the initial snapshot, the values are in the on-disk format; nullptr for a column which was not read
+    void Builder::processSnapshotInsert(Scn scn, Seq sequence, time_t timestamp, const DbTable* table, typeObj obj, RowId rowId, const uint8_t* const* data,
+                                        const typeSize* size) {
+        if (format.isScnTypeCommitValue())
+            scn = commitScn;
+
+        const auto maxI = static_cast<typeCol>(table->columns.size());
+        for (typeCol i = 0; i < maxI; ++i) {
+            if (data[i] == nullptr)
+                continue;
+            if (size[i] > 0 || format.columnFormat >= Format::COLUMN_FORMAT::FULL_INS_DEC || table->columns[i]->numPk > 0)
+                valueSet(Format::VALUE_TYPE::AFTER, i, data[i], size[i], 0, false);
+        }
+
+        conditionContext.setRow(values, sizes, Format::VALUE_TYPE::AFTER, Format::VALUE_TYPE::AFTER);
+        if (table->matchesCondition(ctx, 'i', conditionContext)) {
+            if (!table->columnsSkipped.empty())
+                projectValues(table);
+
+            // LOB and XML columns are never read by the snapshot, so no context is needed to decode them
+            processInsert(scn, sequence, timestamp, nullptr, nullptr, table, obj, rowId.dataObj, rowId.dba, rowId.slot, FileOffset::zero());
+            if (ctx->metrics != nullptr)
+                emitDmlOps(Metrics::DML_OPS::INSERT_OUT, table);
+        } else {
+            if (ctx->metrics != nullptr)
+                emitDmlOps(Metrics::DML_OPS::INSERT_SKIP, table);
+        }
+
+        releaseValues();
+    }
+
     // 0x05010B0C
     void Builder::processDeleteMultiple(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx,
                                         const RedoLogRecord* redoLogRecord1, const RedoLogRecord* redoLogRecord2, bool system, bool schema, bool dump) {
+        if (unlikely(compactData.size() > COMPACT_DATA_MAX))
+            compactFlush();
         typePos fieldPos = 0;
         typePos fieldPosStart;
         typeField fieldNum = 0;
         typeSize fieldSize = 0;
         typeSize colSize;
         const DbTable* table = metadata->schema->checkTableDict(redoLogRecord1->obj);
+        const BuildTimer buildTimer(this, table);
         if (format.isScnTypeCommitValue())
             scn = commitScn;
 
@@ -832,23 +1222,23 @@ namespace OpenLogReplicator {
             else
                 maxI = jcc;
 
+            // Columns not output are dropped here already, they are never referenced by the condition
+            const typeCC present = static_cast<typeCC>(std::min<typeCol>(jcc, maxI));
+            const typePos rowEnd = scanRow(redoLogRecord1, fieldPos + pos, present);
+            const bool skipColumns = table != nullptr && !table->columnsSkippedMask.empty() && !DbTable::isSystemTable(table->options);
             for (typeCol i = 0; i < maxI; ++i) {
-                if (i >= jcc) {
-                    colSize = 0;
-                } else {
-                    colSize = *redoLogRecord1->data(fieldPos + pos);
-                    ++pos;
-                    if (colSize == 0xFF) {
-                        colSize = 0;
-                    } else if (colSize == 0xFE) {
-                        colSize = ctx->read16(redoLogRecord1->data(fieldPos + pos));
-                        pos += 2;
-                    }
+                if (skipColumns && table->isColumnSkipped(i))
+                    continue;
+
+                typePos colPos = rowEnd;
+                colSize = 0;
+                if (i < present) {
+                    colPos = rowColumnPos[i];
+                    colSize = rowColumnSize[i];
                 }
 
                 if (colSize > 0 || format.columnFormat >= Format::COLUMN_FORMAT::FULL_INS_DEC || table == nullptr || table->columns[i]->numPk > 0)
-                    valueSet(Format::VALUE_TYPE::BEFORE, i, redoLogRecord1->data(fieldPos + pos), colSize, 0, dump);
-                pos += colSize;
+                    valueSet(Format::VALUE_TYPE::BEFORE, i, redoLogRecord1->data(colPos), colSize, 0, dump);
             }
 
             if (system && table != nullptr && DbTable::isSystemTable(table->options))
@@ -856,31 +1246,18 @@ namespace OpenLogReplicator {
                                                  ctx->read16(redoLogRecord1->data(redoLogRecord1->slotsDelta + (r * 2))),
                                                  redoLogRecord1->fileOffset);
 
+            conditionContext.setRow(values, sizes, Format::VALUE_TYPE::BEFORE, Format::VALUE_TYPE::BEFORE);
             if ((!schema && table != nullptr && !DbTable::isSystemTable(table->options) && !DbTable::isDebugTable(table->options) &&
-                 table->matchesCondition(ctx, 'd', attributes)) || ctx->isFlagSet(Ctx::REDO_FLAGS::SHOW_SYSTEM_TRANSACTIONS) ||
+                 table->matchesCondition(ctx, 'd', conditionContext)) || ctx->isFlagSet(Ctx::REDO_FLAGS::SHOW_SYSTEM_TRANSACTIONS) ||
                 ctx->isFlagSet(Ctx::REDO_FLAGS::SCHEMALESS)) {
+                if (table != nullptr && !table->columnsSkipped.empty())
+                    projectValues(table);
 
-                processDelete(scn, sequence, timestamp, lobCtx, xmlCtx, table, redoLogRecord2->obj, redoLogRecord2->dataObj, redoLogRecord2->bdba,
-                              ctx->read16(redoLogRecord1->data(redoLogRecord1->slotsDelta + (r * 2))), redoLogRecord1->fileOffset);
-                if (ctx->metrics != nullptr) {
-                    if (ctx->metrics->isTagNamesFilter() && table != nullptr &&
-                            !DbTable::isSystemTable(table->options) && !DbTable::isDebugTable(table->options))
-                        ctx->metrics->emitDmlOpsDeleteOut(1, table->owner, table->name);
-                    else if (ctx->metrics->isTagNamesSys() && table != nullptr && DbTable::isSystemTable(table->options))
-                        ctx->metrics->emitDmlOpsDeleteOut(1, table->owner, table->name);
-                    else
-                        ctx->metrics->emitDmlOpsDeleteOut(1);
-                }
+                emitDelete(scn, sequence, timestamp, lobCtx, xmlCtx, table, redoLogRecord2->obj, redoLogRecord2->dataObj, redoLogRecord2->bdba,
+                           ctx->read16(redoLogRecord1->data(redoLogRecord1->slotsDelta + (r * 2))), redoLogRecord1->fileOffset);
             } else {
-                if (ctx->metrics != nullptr) {
-                    if (ctx->metrics->isTagNamesFilter() && table != nullptr &&
-                            !DbTable::isSystemTable(table->options) && !DbTable::isDebugTable(table->options))
-                        ctx->metrics->emitDmlOpsDeleteSkip(1, table->owner, table->name);
-                    else if (ctx->metrics->isTagNamesSys() && table != nullptr && DbTable::isSystemTable(table->options))
-                        ctx->metrics->emitDmlOpsDeleteSkip(1, table->owner, table->name);
-                    else
-                        ctx->metrics->emitDmlOpsDeleteSkip(1);
-                }
+                if (ctx->metrics != nullptr)
+                    emitDmlOps(Metrics::DML_OPS::DELETE_SKIP, table);
             }
 
             releaseValues();
@@ -890,8 +1267,10 @@ namespace OpenLogReplicator {
     }
 
     void Builder::processDml(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx,
-                             const std::deque<const RedoLogRecord*>& redo1, const std::deque<const RedoLogRecord*>& redo2,
+                             const std::vector<const RedoLogRecord*>& redo1, const std::vector<const RedoLogRecord*>& redo2,
                              Format::TRANSACTION_TYPE transactionType, bool system, bool schema, bool dump) {
+        if (unlikely(compactData.size() > COMPACT_DATA_MAX))
+            compactFlush();
         uint8_t fb;
         typeObj obj;
         typeDataObj dataObj;
@@ -905,6 +1284,7 @@ namespace OpenLogReplicator {
         const RedoLogRecord* redoLogRecord2 = *it2;
 
         DbTable* table = metadata->schema->checkTableDict(redoLogRecord1->obj);
+        const BuildTimer buildTimer(this, table);
         if (format.isScnTypeCommitValue())
             scn = commitScn;
 
@@ -1544,30 +1924,17 @@ namespace OpenLogReplicator {
             if (system && table != nullptr && DbTable::isSystemTable(table->options))
                 systemTransaction->processUpdate(table, dataObj, bdba, slot, redoLogRecord1->fileOffset);
 
+            conditionContext.setRow(values, sizes, Format::VALUE_TYPE::AFTER, Format::VALUE_TYPE::BEFORE);
             if ((!schema && table != nullptr && !DbTable::isSystemTable(table->options) && !DbTable::isDebugTable(table->options) &&
-                 table->matchesCondition(ctx, 'u', attributes)) || ctx->isFlagSet(Ctx::REDO_FLAGS::SHOW_SYSTEM_TRANSACTIONS) ||
+                 table->matchesCondition(ctx, 'u', conditionContext)) || ctx->isFlagSet(Ctx::REDO_FLAGS::SHOW_SYSTEM_TRANSACTIONS) ||
                 ctx->isFlagSet(Ctx::REDO_FLAGS::SCHEMALESS)) {
+                if (table != nullptr && !table->columnsSkipped.empty())
+                    projectValues(table);
 
-                processUpdate(scn, sequence, timestamp, lobCtx, xmlCtx, table, obj, dataObj, bdba, slot, redoLogRecord1->fileOffset);
-                if (ctx->metrics != nullptr) {
-                    if (ctx->metrics->isTagNamesFilter() && table != nullptr &&
-                            !DbTable::isSystemTable(table->options) && !DbTable::isDebugTable(table->options))
-                        ctx->metrics->emitDmlOpsUpdateOut(1, table->owner, table->name);
-                    else if (ctx->metrics->isTagNamesSys() && table != nullptr && DbTable::isSystemTable(table->options))
-                        ctx->metrics->emitDmlOpsUpdateOut(1, table->owner, table->name);
-                    else
-                        ctx->metrics->emitDmlOpsUpdateOut(1);
-                }
+                emitUpdate(scn, sequence, timestamp, lobCtx, xmlCtx, table, obj, dataObj, bdba, slot, redoLogRecord1->fileOffset);
             } else {
-                if (ctx->metrics != nullptr) {
-                    if (ctx->metrics->isTagNamesFilter() && table != nullptr &&
-                            !DbTable::isSystemTable(table->options) && !DbTable::isDebugTable(table->options))
-                        ctx->metrics->emitDmlOpsUpdateSkip(1, table->owner, table->name);
-                    else if (ctx->metrics->isTagNamesSys() && table != nullptr && DbTable::isSystemTable(table->options))
-                        ctx->metrics->emitDmlOpsUpdateSkip(1, table->owner, table->name);
-                    else
-                        ctx->metrics->emitDmlOpsUpdateSkip(1);
-                }
+                if (ctx->metrics != nullptr)
+                    emitDmlOps(Metrics::DML_OPS::UPDATE_SKIP, table);
             }
 
         } else if (transactionType == Format::TRANSACTION_TYPE::INSERT) {
@@ -1626,30 +1993,17 @@ namespace OpenLogReplicator {
             if (system && table != nullptr && DbTable::isSystemTable(table->options))
                 systemTransaction->processInsert(table, dataObj, bdba, slot, redoLogRecord1->fileOffset);
 
+            conditionContext.setRow(values, sizes, Format::VALUE_TYPE::AFTER, Format::VALUE_TYPE::AFTER);
             if ((!schema && table != nullptr && !DbTable::isSystemTable(table->options) && !DbTable::isDebugTable(table->options) &&
-                 table->matchesCondition(ctx, 'i', attributes)) || ctx->isFlagSet(Ctx::REDO_FLAGS::SHOW_SYSTEM_TRANSACTIONS) ||
+                 table->matchesCondition(ctx, 'i', conditionContext)) || ctx->isFlagSet(Ctx::REDO_FLAGS::SHOW_SYSTEM_TRANSACTIONS) ||
                 ctx->isFlagSet(Ctx::REDO_FLAGS::SCHEMALESS)) {
+                if (table != nullptr && !table->columnsSkipped.empty())
+                    projectValues(table);
 
-                processInsert(scn, sequence, timestamp, lobCtx, xmlCtx, table, obj, dataObj, bdba, slot, redoLogRecord1->fileOffset);
-                if (ctx->metrics != nullptr) {
-                    if (ctx->metrics->isTagNamesFilter() && table != nullptr &&
-                            !DbTable::isSystemTable(table->options) && !DbTable::isDebugTable(table->options))
-                        ctx->metrics->emitDmlOpsInsertOut(1, table->owner, table->name);
-                    else if (ctx->metrics->isTagNamesSys() && table != nullptr && DbTable::isSystemTable(table->options))
-                        ctx->metrics->emitDmlOpsInsertOut(1, table->owner, table->name);
-                    else
-                        ctx->metrics->emitDmlOpsInsertOut(1);
-                }
+                emitInsert(scn, sequence, timestamp, lobCtx, xmlCtx, table, obj, dataObj, bdba, slot, redoLogRecord1->fileOffset);
             } else {
-                if (ctx->metrics != nullptr) {
-                    if (ctx->metrics->isTagNamesFilter() && table != nullptr &&
-                            !DbTable::isSystemTable(table->options) && !DbTable::isDebugTable(table->options))
-                        ctx->metrics->emitDmlOpsInsertSkip(1, table->owner, table->name);
-                    else if (ctx->metrics->isTagNamesSys() && table != nullptr && DbTable::isSystemTable(table->options))
-                        ctx->metrics->emitDmlOpsInsertSkip(1, table->owner, table->name);
-                    else
-                        ctx->metrics->emitDmlOpsInsertSkip(1);
-                }
+                if (ctx->metrics != nullptr)
+                    emitDmlOps(Metrics::DML_OPS::INSERT_SKIP, table);
             }
 
         } else if (transactionType == Format::TRANSACTION_TYPE::DELETE) {
@@ -1704,30 +2058,17 @@ namespace OpenLogReplicator {
             if (system && table != nullptr && DbTable::isSystemTable(table->options))
                 systemTransaction->processDelete(table, dataObj, bdba, slot, redoLogRecord1->fileOffset);
 
+            conditionContext.setRow(values, sizes, Format::VALUE_TYPE::BEFORE, Format::VALUE_TYPE::BEFORE);
             if ((!schema && table != nullptr && !DbTable::isSystemTable(table->options) && !DbTable::isDebugTable(table->options) &&
-                 table->matchesCondition(ctx, 'd', attributes)) || ctx->isFlagSet(Ctx::REDO_FLAGS::SHOW_SYSTEM_TRANSACTIONS) ||
+                 table->matchesCondition(ctx, 'd', conditionContext)) || ctx->isFlagSet(Ctx::REDO_FLAGS::SHOW_SYSTEM_TRANSACTIONS) ||
                 ctx->isFlagSet(Ctx::REDO_FLAGS::SCHEMALESS)) {
+                if (table != nullptr && !table->columnsSkipped.empty())
+                    projectValues(table);
 
-                processDelete(scn, sequence, timestamp, lobCtx, xmlCtx, table, obj, dataObj, bdba, slot, redoLogRecord1->fileOffset);
-                if (ctx->metrics != nullptr) {
-                    if (ctx->metrics->isTagNamesFilter() && table != nullptr &&
-                            !DbTable::isSystemTable(table->options) && !DbTable::isDebugTable(table->options))
-                        ctx->metrics->emitDmlOpsDeleteOut(1, table->owner, table->name);
-                    else if (ctx->metrics->isTagNamesSys() && table != nullptr && DbTable::isSystemTable(table->options))
-                        ctx->metrics->emitDmlOpsDeleteOut(1, table->owner, table->name);
-                    else
-                        ctx->metrics->emitDmlOpsDeleteOut(1);
-                }
+                emitDelete(scn, sequence, timestamp, lobCtx, xmlCtx, table, obj, dataObj, bdba, slot, redoLogRecord1->fileOffset);
             } else {
-                if (ctx->metrics != nullptr) {
-                    if (ctx->metrics->isTagNamesFilter() && table != nullptr &&
-                            !DbTable::isSystemTable(table->options) && !DbTable::isDebugTable(table->options))
-                        ctx->metrics->emitDmlOpsDeleteSkip(1, table->owner, table->name);
-                    else if (ctx->metrics->isTagNamesSys() && table != nullptr && DbTable::isSystemTable(table->options))
-                        ctx->metrics->emitDmlOpsDeleteSkip(1, table->owner, table->name);
-                    else
-                        ctx->metrics->emitDmlOpsDeleteSkip(1);
-                }
+                if (ctx->metrics != nullptr)
+                    emitDmlOps(Metrics::DML_OPS::DELETE_SKIP, table);
             }
         }
 
@@ -1736,10 +2077,12 @@ namespace OpenLogReplicator {
 
     // 0x18010000
     void Builder::processDdl(Scn scn, Seq sequence, time_t timestamp, const RedoLogRecord* redoLogRecord1) {
+        compactFlush();
         typePos fieldPos = 0;
         typeField fieldNum = 0;
         typeSize fieldSize = 0;
         const DbTable* table = metadata->schema->checkTableDict(redoLogRecord1->obj);
+        const BuildTimer buildTimer(this, table);
         if (format.isScnTypeCommitValue())
             scn = commitScn;
 
@@ -1840,30 +2183,41 @@ namespace OpenLogReplicator {
         }
     }
 
-    // Parse binary XML format
-    bool Builder::parseXml(const XmlCtx* xmlCtx, const uint8_t* data, uint64_t size, FileOffset fileOffset) {
-        if (valueBufferOld != nullptr) {
+    // The encoded value is kept in the old buffer for the raw output when decoding fails, both buffers are reused for the next values
+    void Builder::valueBufferSwap() {
+        if (valueBufferOld != nullptr && valueBufferOldSize > VALUE_BUFFER_MIN) {
             delete[] valueBufferOld;
             valueBufferOld = nullptr;
+            valueBufferOldSize = 0;
         }
-
-        valueBufferOld = valueBuffer;
+        std::swap(valueBufferOld, valueBuffer);
+        std::swap(valueBufferOldSize, valueBufferSize);
         valueSizeOld = valueSize;
-        valueBuffer = new char[VALUE_BUFFER_MIN];
-        valueBufferSize = VALUE_BUFFER_MIN;
+        if (valueBuffer == nullptr) {
+            valueBuffer = new char[VALUE_BUFFER_MIN];
+            valueBufferSize = VALUE_BUFFER_MIN;
+        }
         valueSize = 0;
+    }
+
+    // Parse binary XML format. Names are resolved by numeric id through the token arrays of the XML context and text is copied
+    // in bulk. When the column is streamed, decoded text is written to the output in fragments while the value is decoded
+    bool Builder::parseXml(const XmlCtx* xmlCtx, const uint8_t* data, uint64_t size, FileOffset fileOffset) {
+        valueBufferSwap();
 
         // bool bigint = false;
-        std::string out;
-        uint pos = 0;
-        std::vector<std::string> tags;
-        std::map<std::string, std::string> dictNmSpcMap;
-        std::map<std::string, std::string> nmSpcPrefixMap;
+        uint64_t pos = 0;
+        xmlTags.clear();
+        xmlDictNmSpc.clear();
+        xmlNmSpcPrefix.clear();
         bool tagOpen = false;
         bool attributeOpen = false;
-        std::string lastTag;
+        XmlTag lastTag;
 
         while (pos < size) {
+            if (unlikely(lobStreamColumn != nullptr) && valueSize >= LOB_STREAM_FRAGMENT)
+                lobStreamFlush(false);
+
             // Header
             if (data[pos] == 0x9E) {
                 bool xmlDecl = false;
@@ -1901,16 +2255,14 @@ namespace OpenLogReplicator {
                 }
 
                 if (xmlDecl) {
-                    valueBufferCheck(100, fileOffset);
-
-                    valueBufferAppend("<?xml", 5);
+                    valueBufferWrite("<?xml", 5, fileOffset);
                     if (version != nullptr) {
-                        valueBufferAppend(" version=", 9);
-                        valueBufferAppend(version, strlen(version));
+                        valueBufferWrite(" version=", 9, fileOffset);
+                        valueBufferWrite(version, strlen(version), fileOffset);
                     }
-                    valueBufferAppend(standalone, strlen(standalone));
-                    valueBufferAppend(encoding, strlen(encoding));
-                    valueBufferAppend("?>", 2);
+                    valueBufferWrite(standalone, strlen(standalone), fileOffset);
+                    valueBufferWrite(encoding, strlen(encoding), fileOffset);
+                    valueBufferWrite("?>", 2, fileOffset);
                 }
 
                 continue;
@@ -2056,61 +2408,33 @@ namespace OpenLogReplicator {
                     isSingle = true;
                 }
 
-                std::string codeStr;
-                if (code < 0x100)
-                    codeStr = {Data::map16U((code >> 4) & 0x0F), Data::map16U(code & 0x0F)};
-                else if (code < 0x10000)
-                    codeStr = {Data::map16U((code >> 12) & 0x0F), Data::map16U((code >> 8) & 0x0F),
-                               Data::map16U((code >> 4) & 0x0F), Data::map16U(code & 0x0F)};
-                else if (code < 0x1000000)
-                    codeStr = {Data::map16U((code >> 20) & 0x0F), Data::map16U((code >> 16) & 0x0F),
-                               Data::map16U((code >> 12) & 0x0F), Data::map16U((code >> 8) & 0x0F),
-                               Data::map16U((code >> 4) & 0x0F), Data::map16U(code & 0x0F)};
-                else
-                    codeStr = {Data::map16U((code >> 28) & 0x0F), Data::map16U((code >> 24) & 0x0F),
-                               Data::map16U((code >> 20) & 0x0F), Data::map16U((code >> 16) & 0x0F),
-                               Data::map16U((code >> 12) & 0x0F), Data::map16U((code >> 8) & 0x0F),
-                               Data::map16U((code >> 4) & 0x0F), Data::map16U(code & 0x0F)};
-
-                auto xdbXQnMapIdIt = xmlCtx->xdbXQnPack.unorderedMapKey.find(XdbXQnKey(codeStr));
-                if (xdbXQnMapIdIt == xmlCtx->xdbXQnPack.unorderedMapKey.end()) {
-                    ctx->warning(60036, "incorrect XML data: string too short, can't decode qn   " + codeStr);
+                const XmlCtx::QnToken* token = xmlCtx->qnToken(code);
+                if (unlikely(token == nullptr)) {
+                    std::ostringstream ss;
+                    ss << std::uppercase << std::hex << code;
+                    ctx->warning(60036, "incorrect XML data: string too short, can't decode qn   " + ss.str());
                     return false;
                 }
 
-                std::string tag = xdbXQnMapIdIt->second->localName;
-                // not very efficient, but it's not a problem
-                const uint64_t flagsSize = xdbXQnMapIdIt->second->flags.length();
-                const bool isAttribute = (((xdbXQnMapIdIt->second->flags.at(flagsSize - 1) - '0') & XdbXQn::FLAG_ISATTRIBUTE) != 0);
-
-                if (isAttribute) {
-                    out = " " + tag + "=\"";
-                    valueBufferCheck(out.length(), fileOffset);
-                    valueBufferAppend(out.c_str(), out.length());
+                // Namespace prefix is known only for the document, attributes are written without it
+                const XmlTag tag{token->attribute ? std::string_view() : xmlPrefix(token->nmSpc), token->qn->localName};
+                if (token->attribute) {
+                    xmlAppendTag(" ", tag, fileOffset);
+                    valueBufferWrite("=\"", 2, fileOffset);
                 } else {
                     if (attributeOpen) {
-                        valueBufferCheck(2, fileOffset);
-                        valueBufferAppend("\">", 2);
+                        valueBufferWrite("\">", 2, fileOffset);
                         attributeOpen = false;
                     } else if (tagOpen) {
-                        valueBufferCheck(1, fileOffset);
-                        valueBufferAppend('>');
+                        valueBufferWrite(">", 1, fileOffset);
                         tagOpen = false;
                     }
 
-                    // append namespace to tag name
-                    const std::string nmSpcId = xdbXQnMapIdIt->second->nmSpcId;
-                    auto nmSpcPrefixMapIt = nmSpcPrefixMap.find(nmSpcId);
-                    if (nmSpcPrefixMapIt != nmSpcPrefixMap.end())
-                        tag = nmSpcPrefixMapIt->second + ":" + tag;
-
-                    if (tagSize == 0 && !isSingle) {
-                        out = "<" + tag;
+                    xmlAppendTag("<", tag, fileOffset);
+                    if (tagSize == 0 && !isSingle)
                         tagOpen = true;
-                    } else
-                        out = "<" + tag + ">";
-                    valueBufferCheck(out.length(), fileOffset);
-                    valueBufferAppend(out.c_str(), out.length());
+                    else
+                        valueBufferWrite(">", 1, fileOffset);
                 }
 
                 if (tagSize > 0) {
@@ -2118,24 +2442,21 @@ namespace OpenLogReplicator {
                         ctx->warning(60036, "incorrect XML data: string too short, can't read 0xC1xxxx data (2)");
                         return false;
                     }
-                    valueBufferCheck(tagSize, fileOffset);
-                    valueBufferAppend(reinterpret_cast<const char*>(data + pos), tagSize);
+                    valueBufferWrite(reinterpret_cast<const char*>(data + pos), tagSize, fileOffset);
                     pos += tagSize;
                 }
 
-                if (isAttribute) {
-                    if (isSingle) {
-                        valueBufferCheck(1, fileOffset);
-                        valueBufferAppend('"');
-                    } else
+                if (token->attribute) {
+                    if (isSingle)
+                        valueBufferWrite("\"", 1, fileOffset);
+                    else
                         attributeOpen = true;
                 } else {
                     if (isSingle) {
-                        out = "</" + tag + ">";
-                        valueBufferCheck(out.length(), fileOffset);
-                        valueBufferAppend(out.c_str(), out.length());
+                        xmlAppendTag("</", tag, fileOffset);
+                        valueBufferWrite(">", 1, fileOffset);
                     } else
-                        tags.push_back(tag);
+                        xmlTags.push_back(tag);
                 }
 
                 continue;
@@ -2158,37 +2479,31 @@ namespace OpenLogReplicator {
                 const uint16_t dict = Ctx::read16Big(data + pos);
                 pos += 2;
 
-                std::string nmSpcId;
-                if (nmSpc < 256)
-                    nmSpcId = {Data::map16U((nmSpc >> 4) & 0x0F), Data::map16U(nmSpc & 0x0F)};
-                else
-                    nmSpcId = {Data::map16U((nmSpc >> 12) & 0x0F), Data::map16U((nmSpc >> 8) & 0x0F),
-                               Data::map16U((nmSpc >> 4) & 0x0F), Data::map16U(nmSpc & 0x0F)};
-
-                std::string dictId;
-                if (dict < 256)
-                    dictId = {Data::map16U((dict >> 4) & 0x0F), Data::map16U(dict & 0x0F)};
-                else
-                    dictId = {Data::map16U((dict >> 12) & 0x0F), Data::map16U((dict >> 8) & 0x0F),
-                              Data::map16U((dict >> 4) & 0x0F), Data::map16U(dict & 0x0F)};
-
-                auto dictNmSpcMapIt = dictNmSpcMap.find(dictId);
-                if (dictNmSpcMapIt != dictNmSpcMap.end()) {
-                    ctx->warning(60036, "incorrect XML data: namespace " + dictId + " duplicated dict");
-                    return false;
+                for (const auto& [dictId, _]: xmlDictNmSpc) {
+                    if (dictId == dict) {
+                        std::ostringstream ss;
+                        ss << std::uppercase << std::hex << dict;
+                        ctx->warning(60036, "incorrect XML data: namespace " + ss.str() + " duplicated dict");
+                        return false;
+                    }
                 }
-                dictNmSpcMap.insert_or_assign(dictId, nmSpcId);
+                xmlDictNmSpc.emplace_back(dict, nmSpc);
 
                 if (tagSize > 0) {
-                    const std::string prefix(reinterpret_cast<const char*>(data + pos), tagSize);
+                    if (pos + tagSize > size) {
+                        ctx->warning(60036, "incorrect XML data: string too short, can't read B2 prefix");
+                        return false;
+                    }
+                    const std::string_view prefix(reinterpret_cast<const char*>(data + pos), tagSize);
                     pos += tagSize;
 
-                    auto nmSpcPrefixMapIt = nmSpcPrefixMap.find(nmSpcId);
-                    if (nmSpcPrefixMapIt != nmSpcPrefixMap.end()) {
-                        ctx->warning(60036, "incorrect XML data: namespace " + nmSpcId + " duplicated prefix");
+                    if (!xmlPrefix(nmSpc).empty()) {
+                        std::ostringstream ss;
+                        ss << std::uppercase << std::hex << nmSpc;
+                        ctx->warning(60036, "incorrect XML data: namespace " + ss.str() + " duplicated prefix");
                         return false;
                     }
-                    nmSpcPrefixMap.insert_or_assign(nmSpcId, prefix);
+                    xmlNmSpcPrefix.emplace_back(nmSpc, prefix);
                 }
 
                 continue;
@@ -2205,47 +2520,39 @@ namespace OpenLogReplicator {
                 const uint16_t dict = Ctx::read16Big(data + pos);
                 pos += 2;
 
-                std::string dictId;
-                if (dict < 256)
-                    dictId = {Data::map16U((dict >> 4) & 0x0F), Data::map16U(dict & 0x0F)};
-                else
-                    dictId = {Data::map16U((dict >> 12) & 0x0F), Data::map16U((dict >> 8) & 0x0F),
-                              Data::map16U((dict >> 4) & 0x0F), Data::map16U(dict & 0x0F)};
-
-                auto dictNmSpcMapIt = dictNmSpcMap.find(dictId);
-                if (dictNmSpcMapIt == dictNmSpcMap.end()) {
-                    ctx->warning(60036, "incorrect XML data: namespace " + dictId + " not found for namespace");
+                uint64_t nmSpc = XmlCtx::NMSPC_NONE;
+                for (const auto& [dictId, dictNmSpc]: xmlDictNmSpc) {
+                    if (dictId == dict) {
+                        nmSpc = dictNmSpc;
+                        break;
+                    }
+                }
+                if (nmSpc == XmlCtx::NMSPC_NONE) {
+                    std::ostringstream ss;
+                    ss << std::uppercase << std::hex << dict;
+                    ctx->warning(60036, "incorrect XML data: namespace " + ss.str() + " not found for namespace");
                     return false;
                 }
-                const std::string nmSpcId = dictNmSpcMapIt->second;
 
                 // search url
-                auto xdbXNmMapIdIt = xmlCtx->xdbXNmPack.unorderedMapKey.find(XdbXNmKey(nmSpcId));
-                if (xdbXNmMapIdIt == xmlCtx->xdbXNmPack.unorderedMapKey.end()) {
-                    ctx->warning(60036, "incorrect XML data: namespace " + nmSpcId + " not found");
+                const XdbXNm* xdbXNm = xmlCtx->nmToken(nmSpc);
+                if (xdbXNm == nullptr) {
+                    std::ostringstream ss;
+                    ss << std::uppercase << std::hex << nmSpc;
+                    ctx->warning(60036, "incorrect XML data: namespace " + ss.str() + " not found");
                     return false;
                 }
 
-                valueBufferCheck(7, fileOffset);
-                valueBufferAppend(" xmlns", 6);
-
-                auto nmSpcPrefixMapIt = nmSpcPrefixMap.find(nmSpcId);
-                if (nmSpcPrefixMapIt != nmSpcPrefixMap.end()) {
-                    valueBufferCheck(1, fileOffset);
-                    valueBufferAppend(':');
-
-                    valueBufferCheck(nmSpcPrefixMapIt->second.length(), fileOffset);
-                    valueBufferAppend(nmSpcPrefixMapIt->second.c_str(), nmSpcPrefixMapIt->second.length());
+                const XmlTag attribute{xmlPrefix(nmSpc), xdbXNm->nmSpcUri};
+                if (attribute.prefix.empty())
+                    valueBufferWrite(" xmlns", 6, fileOffset);
+                else {
+                    valueBufferWrite(" xmlns:", 7, fileOffset);
+                    valueBufferWrite(attribute.prefix, fileOffset);
                 }
-
-                valueBufferCheck(2, fileOffset);
-                valueBufferAppend("=\"", 2);
-
-                valueBufferCheck(xdbXNmMapIdIt->second->nmSpcUri.length(), fileOffset);
-                valueBufferAppend(xdbXNmMapIdIt->second->nmSpcUri.c_str(), xdbXNmMapIdIt->second->nmSpcUri.length());
-
-                valueBufferCheck(1, fileOffset);
-                valueBufferAppend('"');
+                valueBufferWrite("=\"", 2, fileOffset);
+                valueBufferWrite(attribute.name, fileOffset);
+                valueBufferWrite("\"", 1, fileOffset);
 
                 continue;
             }
@@ -2253,8 +2560,7 @@ namespace OpenLogReplicator {
             // chunk of data 64bit
             if (data[pos] == 0x8B) {
                 if (tagOpen && !attributeOpen) {
-                    valueBufferCheck(1, fileOffset);
-                    valueBufferAppend('>');
+                    valueBufferWrite(">", 1, fileOffset);
                     tagOpen = false;
                 }
                 ++pos;
@@ -2272,16 +2578,14 @@ namespace OpenLogReplicator {
                     return false;
                 }
 
-                valueBufferCheck(tagSize, fileOffset);
-                valueBufferAppend(reinterpret_cast<const char*>(data + pos), tagSize);
+                valueBufferWrite(reinterpret_cast<const char*>(data + pos), tagSize, fileOffset);
                 pos += tagSize;
                 continue;
             }
 
             if (data[pos] < 128) {
                 if (tagOpen && !attributeOpen) {
-                    valueBufferCheck(1, fileOffset);
-                    valueBufferAppend('>');
+                    valueBufferWrite(">", 1, fileOffset);
                     tagOpen = false;
                 }
 
@@ -2293,8 +2597,7 @@ namespace OpenLogReplicator {
                     return false;
                 }
 
-                valueBufferCheck(tagSize, fileOffset);
-                valueBufferAppend(reinterpret_cast<const char*>(data + pos), tagSize);
+                valueBufferWrite(reinterpret_cast<const char*>(data + pos), tagSize, fileOffset);
                 pos += tagSize;
                 continue;
             }
@@ -2302,21 +2605,20 @@ namespace OpenLogReplicator {
             // end tag
             if (data[pos] == 0xD9) {
                 if (attributeOpen) {
-                    out = "\"";
+                    valueBufferWrite("\"", 1, fileOffset);
                     attributeOpen = false;
                     tagOpen = true;
                 } else {
-                    if (tags.empty()) {
+                    if (xmlTags.empty()) {
                         ctx->warning(60036, "incorrect XML data: end tag found, but no tags open");
                         return false;
                     }
-                    lastTag = tags.back();
-                    tags.pop_back();
-                    out = "</" + lastTag + ">";
+                    lastTag = xmlTags.back();
+                    xmlTags.pop_back();
+                    xmlAppendTag("</", lastTag, fileOffset);
+                    valueBufferWrite(">", 1, fileOffset);
                 }
 
-                valueBufferCheck(out.length(), fileOffset);
-                valueBufferAppend(out.c_str(), out.length());
                 ++pos;
                 continue;
             }
@@ -2329,11 +2631,9 @@ namespace OpenLogReplicator {
 
             // repeat last tag
             if (data[pos] >= 0xD4 && data[pos] <= 0xD5) {
-                tags.push_back(lastTag);
-                out = "<" + lastTag;
+                xmlTags.push_back(lastTag);
+                xmlAppendTag("<", lastTag, fileOffset);
                 tagOpen = true;
-                valueBufferCheck(out.length(), fileOffset);
-                valueBufferAppend(out.c_str(), out.length());
                 ++pos;
                 continue;
             }
@@ -2350,33 +2650,522 @@ namespace OpenLogReplicator {
         return true;
     }
 
-    void Builder::releaseBuffers(Thread* t, uint64_t maxId) {
-        BuilderQueue* builderQueue;
+    // Parse OSON, the binary JSON format of 21c, into compact JSON text. The field name dictionary is read once, the tree segment
+    // is walked in document order
+    bool Builder::parseOson(const uint8_t* data, uint64_t size, FileOffset fileOffset) {
+        valueBufferSwap();
+        osonNames.clear();
+
+        if (size < 6 || data[0] != 0xFF || data[1] != 0x4A || data[2] != 0x5A) {
+            ctx->warning(60058, "incorrect JSON data: missing OSON header");
+            return false;
+        }
+        const uint8_t version = data[3];
+        if (version != OSON_VERSION_MAX_FNAME_255 && version != OSON_VERSION_MAX_FNAME_65535) {
+            ctx->warning(60058, "incorrect JSON data: unsupported OSON version: " + std::to_string(version));
+            return false;
+        }
+        const uint16_t flags = Ctx::read16Big(data + 4);
+        uint64_t pos = 6;
+
+        OsonImage image{data, size, 0, 1, (flags & OSON_FLAG_REL_OFFSET_MODE) != 0};
+        if ((flags & OSON_FLAG_IS_SCALAR) != 0) {
+            pos += (flags & OSON_FLAG_TREE_SEG_UINT32) != 0 ? 4 : 2;
+            image.tree = pos;
+            return osonNode(image, pos, 0, fileOffset);
+        }
+
+        // Header with the sizes of the segments
+        const uint64_t fieldIdSize = (flags & OSON_FLAG_NUM_FNAMES_UINT32) != 0 ? 4 : ((flags & OSON_FLAG_NUM_FNAMES_UINT16) != 0 ? 2 : 1);
+        const uint64_t shortOffsetSize = (flags & OSON_FLAG_FNAMES_SEG_UINT32) != 0 ? 4 : 2;
+        image.fieldIdSize = static_cast<uint8_t>(fieldIdSize);
+        uint64_t headerSize = fieldIdSize + shortOffsetSize + ((flags & OSON_FLAG_TREE_SEG_UINT32) != 0 ? 4 : 2) + 2;
+        if (version == OSON_VERSION_MAX_FNAME_65535)
+            headerSize += 11;
+        if (pos + headerSize > size) {
+            ctx->warning(60058, "incorrect JSON data: OSON header too short");
+            return false;
+        }
+
+        const uint64_t shortNames = fieldIdSize == 4 ? Ctx::read32Big(data + pos) : (fieldIdSize == 2 ? Ctx::read16Big(data + pos) : data[pos]);
+        pos += fieldIdSize;
+        const uint64_t shortNamesSize = shortOffsetSize == 4 ? Ctx::read32Big(data + pos) : Ctx::read16Big(data + pos);
+        pos += shortOffsetSize;
+
+        uint64_t longNames = 0;
+        uint64_t longNamesSize = 0;
+        uint64_t longOffsetSize = 4;
+        if (version == OSON_VERSION_MAX_FNAME_65535) {
+            if ((Ctx::read16Big(data + pos) & OSON_FLAG_SEC_FNAMES_SEG_UINT16) != 0)
+                longOffsetSize = 2;
+            pos += 3;
+            longNames = Ctx::read32Big(data + pos);
+            pos += 4;
+            longNamesSize = Ctx::read32Big(data + pos);
+            pos += 4;
+        }
+
+        pos += (flags & OSON_FLAG_TREE_SEG_UINT32) != 0 ? 4 : 2;
+        // Tiny nodes count
+        pos += 2;
+
+        // Field names: hash ids, offsets, then the names, each prefixed by its length
+        const uint64_t names[2][4]{{shortNames, 1, shortOffsetSize, shortNamesSize}, {longNames, 2, longOffsetSize, longNamesSize}};
+        for (const auto& [count, hashSize, offsetSize, segmentSize]: names) {
+            if (count == 0)
+                continue;
+
+            const uint64_t offsets = pos + (count * hashSize);
+            const uint64_t segment = offsets + (count * offsetSize);
+            if (segment + segmentSize > size) {
+                ctx->warning(60058, "incorrect JSON data: OSON field names too short");
+                return false;
+            }
+
+            osonNames.reserve(osonNames.size() + count);
+            for (uint64_t i = 0; i < count; ++i) {
+                const uint64_t offset = offsetSize == 4 ? Ctx::read32Big(data + offsets + (i * 4)) : Ctx::read16Big(data + offsets + (i * 2));
+                const uint64_t lengthSize = hashSize;
+                if (offset + lengthSize > segmentSize) {
+                    ctx->warning(60058, "incorrect JSON data: OSON field name offset out of range");
+                    return false;
+                }
+                const uint64_t length = lengthSize == 2 ? Ctx::read16Big(data + segment + offset) : data[segment + offset];
+                if (offset + lengthSize + length > segmentSize) {
+                    ctx->warning(60058, "incorrect JSON data: OSON field name too long");
+                    return false;
+                }
+                osonNames.emplace_back(reinterpret_cast<const char*>(data + segment + offset + lengthSize), length);
+            }
+            pos = segment + segmentSize;
+        }
+
+        image.tree = pos;
+        return osonNode(image, pos, 0, fileOffset);
+    }
+
+    bool Builder::osonNode(const OsonImage& image, uint64_t& pos, uint depth, FileOffset fileOffset) {
+        if (pos >= image.size) {
+            ctx->warning(60058, "incorrect JSON data: OSON node out of range");
+            return false;
+        }
+        const uint8_t nodeType = image.data[pos++];
+
+        if ((nodeType & 0x80) != 0) {
+            if (depth >= OSON_DEPTH_MAX) {
+                ctx->warning(60058, "incorrect JSON data: OSON nesting exceeds " + std::to_string(OSON_DEPTH_MAX));
+                return false;
+            }
+            return osonContainer(image, nodeType, pos, depth + 1, fileOffset);
+        }
+
+        // Length of the value which follows the node type
+        uint64_t length;
+        switch (nodeType) {
+            case 0x30:
+                valueBufferWrite("null", 4, fileOffset);
+                return true;
+
+            case 0x31:
+                valueBufferWrite("true", 4, fileOffset);
+                return true;
+
+            case 0x32:
+                valueBufferWrite("false", 5, fileOffset);
+                return true;
+
+            // Date and timestamps of 7, 11 and 13 bytes
+            case 0x3C:
+            case 0x7D:
+                length = 7;
+                break;
+
+            case 0x39:
+            case 0x3E:
+                length = 11;
+                break;
+
+            case 0x7C:
+                length = 13;
+                break;
+
+            case 0x3D:
+                length = 5;
+                break;
+
+            case 0x7F:
+                length = 4;
+                break;
+
+            case 0x36:
+                length = 8;
+                break;
+
+            // Length of 1, 2 or 4 bytes before the value
+            case 0x33:
+            case 0x34:
+            case 0x7E:
+                if (pos + 1 > image.size)
+                    length = image.size;
+                else
+                    length = image.data[pos++];
+                break;
+
+            case 0x37:
+            case 0x3A:
+                if (pos + 2 > image.size)
+                    length = image.size;
+                else {
+                    length = Ctx::read16Big(image.data + pos);
+                    pos += 2;
+                }
+                break;
+
+            case 0x38:
+            case 0x3B:
+                if (pos + 4 > image.size)
+                    length = image.size;
+                else {
+                    length = Ctx::read32Big(image.data + pos);
+                    pos += 4;
+                }
+                break;
+
+            default:
+                // Number or integer with the length in the node type, a short string
+                if ((nodeType & 0xF0) == 0x20 || (nodeType & 0xF0) == 0x60)
+                    length = (nodeType & 0x0F) + 1;
+                else if ((nodeType & 0xF0) == 0x40 || (nodeType & 0xF0) == 0x50)
+                    length = nodeType & 0x0F;
+                else if ((nodeType & 0xE0) == 0)
+                    length = nodeType;
+                else {
+                    ctx->warning(60058, "incorrect JSON data: unsupported OSON node type: " + std::to_string(nodeType));
+                    return false;
+                }
+        }
+
+        if (pos + length > image.size) {
+            ctx->warning(60058, "incorrect JSON data: OSON value out of range");
+            return false;
+        }
+        const uint8_t* value = image.data + pos;
+        pos += length;
+
+        switch (nodeType) {
+            case 0x3C:
+            case 0x7D:
+            case 0x39:
+                osonAppendDateTime(value, length, false, fileOffset);
+                return true;
+
+            case 0x7C:
+                osonAppendDateTime(value, length, true, fileOffset);
+                return true;
+
+            case 0x7F:
+            case 0x36: {
+                std::ostringstream ss;
+                if (nodeType == 0x7F)
+                    ss << decodeFloat(value);
+                else
+                    ss << decodeDouble(value);
+                const std::string text = ss.str();
+                // NaN and infinity have no JSON number form
+                if (text.find_first_of("ni") != std::string::npos) {
+                    valueBufferWrite("\"", 1, fileOffset);
+                    valueBufferWrite(text, fileOffset);
+                    valueBufferWrite("\"", 1, fileOffset);
+                } else
+                    valueBufferWrite(text, fileOffset);
+                return true;
+            }
+
+            case 0x3D: {
+                const int64_t years = static_cast<int64_t>(Ctx::read32Big(value)) - 0x80000000;
+                const int64_t months = static_cast<int64_t>(value[4]) - 60;
+                const bool negative = years < 0 || months < 0;
+                const std::string text = std::string(negative ? "\"-P" : "\"P") + std::to_string(std::abs(years)) + "Y" + std::to_string(std::abs(months)) +
+                                         "M\"";
+                valueBufferWrite(text, fileOffset);
+                return true;
+            }
+
+            case 0x3E: {
+                const int64_t days = static_cast<int64_t>(Ctx::read32Big(value)) - 0x80000000;
+                const int64_t hours = static_cast<int64_t>(value[4]) - 60;
+                const int64_t minutes = static_cast<int64_t>(value[5]) - 60;
+                const int64_t seconds = static_cast<int64_t>(value[6]) - 60;
+                const int64_t fraction = static_cast<int64_t>(Ctx::read32Big(value + 7)) - 0x80000000;
+                const bool negative = days < 0 || hours < 0 || minutes < 0 || seconds < 0 || fraction < 0;
+                std::string text = std::string(negative ? "\"-P" : "\"P") + std::to_string(std::abs(days)) + "DT" + std::to_string(std::abs(hours)) + "H" +
+                                   std::to_string(std::abs(minutes)) + "M" + std::to_string(std::abs(seconds));
+                if (fraction != 0) {
+                    std::string digits = std::to_string(std::abs(fraction));
+                    digits.insert(0, 9 - std::min<size_t>(digits.length(), 9), '0');
+                    digits.erase(digits.find_last_not_of('0') + 1);
+                    text += "." + digits;
+                }
+                text += "S\"";
+                valueBufferWrite(text, fileOffset);
+                return true;
+            }
+
+            case 0x34:
+                if (length == 0) {
+                    ctx->warning(60058, "incorrect JSON data: empty OSON number");
+                    return false;
+                }
+                appendNumber(value, length, fileOffset);
+                return true;
+
+            case 0x7E:
+            case 0x3A:
+            case 0x3B:
+                valueBufferCheck((length * 2) + 2, fileOffset);
+                valueBufferAppend('"');
+                for (uint64_t i = 0; i < length; ++i) {
+                    valueBufferAppend(Data::map16U(value[i] >> 4));
+                    valueBufferAppend(Data::map16U(value[i] & 0x0F));
+                }
+                valueBufferAppend('"');
+                return true;
+
+            default:
+                break;
+        }
+
+        if ((nodeType & 0xF0) == 0x20 || (nodeType & 0xF0) == 0x60 || (nodeType & 0xF0) == 0x40 || (nodeType & 0xF0) == 0x50) {
+            if (length == 0)
+                valueBufferWrite("0", 1, fileOffset);
+            else
+                appendNumber(value, length, fileOffset);
+            return true;
+        }
+
+        osonAppendString(value, length, fileOffset);
+        return true;
+    }
+
+    // Objects and arrays: the number of children, field ids of an object and the offsets of the children in the tree segment.
+    // An object sharing the field ids of another one points to it instead
+    bool Builder::osonContainer(const OsonImage& image, uint8_t nodeType, uint64_t& pos, uint depth, FileOffset fileOffset) {
+        const bool isObject = (nodeType & 0x40) == 0;
+        const uint64_t offsetSize = (nodeType & 0x20) != 0 ? 4 : 2;
+        const uint64_t containerOffset = pos - image.tree - 1;
+
+        auto readCount = [&image](uint8_t type, uint64_t& at, uint64_t& count) -> bool {
+            const uint8_t childrenBits = type & 0x18;
+            const uint64_t countSize = childrenBits == 0 ? 1 : (childrenBits == 0x08 ? 2 : 4);
+            if (at + countSize > image.size)
+                return false;
+            count = countSize == 1 ? image.data[at] : (countSize == 2 ? Ctx::read16Big(image.data + at) : Ctx::read32Big(image.data + at));
+            at += countSize;
+            return true;
+        };
+        auto readOffset = [&image, offsetSize](uint64_t at) -> uint64_t {
+            return offsetSize == 4 ? Ctx::read32Big(image.data + at) : Ctx::read16Big(image.data + at);
+        };
+
+        uint64_t children = 0;
+        uint64_t fieldIds = 0;
+        uint64_t offsets;
+        if ((nodeType & 0x18) == 0x18) {
+            // Shared field ids
+            if (pos + offsetSize > image.size) {
+                ctx->warning(60058, "incorrect JSON data: OSON container out of range");
+                return false;
+            }
+            uint64_t shared = image.tree + readOffset(pos);
+            offsets = pos + offsetSize;
+            const uint8_t sharedType = shared < image.size ? image.data[shared] : 0;
+            ++shared;
+            if (shared > image.size || !readCount(sharedType, shared, children)) {
+                ctx->warning(60058, "incorrect JSON data: OSON shared field ids out of range");
+                return false;
+            }
+            fieldIds = shared;
+        } else {
+            if (!readCount(nodeType, pos, children)) {
+                ctx->warning(60058, "incorrect JSON data: OSON container out of range");
+                return false;
+            }
+            if (isObject) {
+                fieldIds = pos;
+                pos += children * image.fieldIdSize;
+            }
+            offsets = pos;
+        }
+
+        if ((isObject && fieldIds + (children * image.fieldIdSize) > image.size) || offsets + (children * offsetSize) > image.size) {
+            ctx->warning(60058, "incorrect JSON data: OSON container out of range");
+            return false;
+        }
+
+        valueBufferWrite(isObject ? "{" : "[", 1, fileOffset);
+        for (uint64_t i = 0; i < children; ++i) {
+            if (i > 0)
+                valueBufferWrite(",", 1, fileOffset);
+
+            if (isObject) {
+                const uint8_t* fieldId = image.data + fieldIds + (i * image.fieldIdSize);
+                const uint64_t fieldNumber = image.fieldIdSize == 4 ? Ctx::read32Big(fieldId) : (image.fieldIdSize == 2 ? Ctx::read16Big(fieldId) : fieldId[0]);
+                if (fieldNumber == 0 || fieldNumber > osonNames.size()) {
+                    ctx->warning(60058, "incorrect JSON data: OSON field id out of range: " + std::to_string(fieldNumber));
+                    return false;
+                }
+                const std::string_view& name = osonNames[fieldNumber - 1];
+                osonAppendString(reinterpret_cast<const uint8_t*>(name.data()), name.size(), fileOffset);
+                valueBufferWrite(":", 1, fileOffset);
+            }
+
+            uint64_t child = readOffset(offsets + (i * offsetSize));
+            if (image.relativeOffsets)
+                child += containerOffset;
+            uint64_t childPos = image.tree + child;
+            if (!osonNode(image, childPos, depth, fileOffset))
+                return false;
+        }
+        valueBufferWrite(isObject ? "}" : "]", 1, fileOffset);
+
+        // The tree position after the container is not used, siblings are reached through the offsets of the parent
+        pos = offsets + (children * offsetSize);
+        return true;
+    }
+
+    void Builder::osonAppendString(const uint8_t* text, uint64_t size, FileOffset fileOffset) {
+        valueBufferCheck((size * 6) + 2, fileOffset);
+        valueBufferAppend('"');
+        for (uint64_t i = 0; i < size; ++i) {
+            const uint8_t character = text[i];
+            switch (character) {
+                case '"':
+                case '\\':
+                    valueBufferAppend('\\');
+                    valueBufferAppend(character);
+                    break;
+
+                case '\n':
+                    valueBufferAppend('\\');
+                    valueBufferAppend('n');
+                    break;
+
+                case '\r':
+                    valueBufferAppend('\\');
+                    valueBufferAppend('r');
+                    break;
+
+                case '\t':
+                    valueBufferAppend('\\');
+                    valueBufferAppend('t');
+                    break;
+
+                default:
+                    if (character < 0x20) {
+                        valueBufferAppend("\\u00", 4);
+                        valueBufferAppend(Data::map16U(character >> 4));
+                        valueBufferAppend(Data::map16U(character & 0x0F));
+                    } else
+                        valueBufferAppend(character);
+            }
+        }
+        valueBufferAppend('"');
+    }
+
+    // ISO 8601 text, a timestamp with time zone is stored in UTC
+    void Builder::osonAppendDateTime(const uint8_t* data, uint64_t size, bool utc, FileOffset fileOffset) {
+        int year;
+        if (data[0] >= 100 && data[1] >= 100)
+            year = ((data[0] - 100) * 100) + (data[1] - 100);
+        else
+            year = -(((100 - data[0]) * 100) + (100 - data[1]));
+
+        char buffer[64];
+        int length = snprintf(buffer, sizeof(buffer), "\"%04d-%02d-%02dT%02d:%02d:%02d", year, data[2], data[3], data[4] - 1, data[5] - 1, data[6] - 1);
+        if (size >= 11) {
+            uint64_t fraction = Ctx::read32Big(data + 7);
+            if (fraction != 0 && fraction <= 999999999) {
+                int digits = 9;
+                while (fraction % 10 == 0) {
+                    fraction /= 10;
+                    --digits;
+                }
+                length += snprintf(buffer + length, sizeof(buffer) - length, ".%0*" PRIu64, digits, fraction);
+            }
+        }
+        if (utc)
+            buffer[length++] = 'Z';
+        buffer[length++] = '"';
+        valueBufferWrite(buffer, length, fileOffset);
+    }
+
+    // Called for every writer when the configuration is read, before any thread is started
+    uint Builder::registerWriter() {
+        writerReleaseIds.push_back(0);
+        return writerReleaseIds.size() - 1;
+    }
+
+    // Buffers below maxId are already read by the writer, each one not pinned by an unconfirmed message is unlinked,
+    // so a single slow message holds only its own buffer; returns the number of buffers freed behind a pinned one.
+    // With many writers a buffer is freed in order, once the slowest of them has confirmed all of its messages
+    uint64_t Builder::releaseBuffers(Thread* t, uint writer, uint64_t maxId, const std::map<uint64_t, uint64_t>& pinned) {
+        BuilderQueue* released = nullptr;
+        uint64_t outOfOrder = 0;
         {
             t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::BUILDER_RELEASE);
             std::unique_lock<std::mutex> const lck(mtx);
-            builderQueue = firstBuilderQueue;
-            while (firstBuilderQueue->id < maxId) {
-                firstBuilderQueue = firstBuilderQueue->next;
-                --buffersAllocated;
+            if (writerReleaseIds.size() > 1) {
+                uint64_t releaseId = maxId;
+                if (!pinned.empty() && pinned.begin()->first < releaseId)
+                    releaseId = pinned.begin()->first;
+                writerReleaseIds[writer] = releaseId;
+                releaseId = *std::min_element(writerReleaseIds.begin(), writerReleaseIds.end());
+
+                while (firstBuilderQueue->id < releaseId) {
+                    BuilderQueue* nextBuffer = firstBuilderQueue->next;
+                    --buffersAllocated;
+                    firstBuilderQueue->next = released;
+                    released = firstBuilderQueue;
+                    firstBuilderQueue = nextBuffer;
+                }
             }
+
+            BuilderQueue* prevBuffer = nullptr;
+            BuilderQueue* builderQueue = firstBuilderQueue;
+            while (writerReleaseIds.size() <= 1 && builderQueue->id < maxId) {
+                BuilderQueue* nextBuffer = builderQueue->next;
+                if (pinned.find(builderQueue->id) != pinned.end()) {
+                    prevBuffer = builderQueue;
+                } else {
+                    if (prevBuffer == nullptr)
+                        firstBuilderQueue = nextBuffer;
+                    else {
+                        prevBuffer->next = nextBuffer;
+                        ++outOfOrder;
+                    }
+                    --buffersAllocated;
+                    builderQueue->next = released;
+                    released = builderQueue;
+                }
+                builderQueue = nextBuffer;
+            }
+            if (released != nullptr && creditBuffers > 0)
+                condCredit.notify_all();
         }
         t->contextSet(Thread::CONTEXT::CPU);
 
-        if (builderQueue == nullptr)
-            return;
-
-        while (builderQueue->id < maxId) {
-            BuilderQueue* nextBuffer = builderQueue->next;
-            ctx->freeMemoryChunk(ctx->parserThread, Ctx::MEMORY::BUILDER, reinterpret_cast<uint8_t*>(builderQueue));
-            builderQueue = nextBuffer;
+        while (released != nullptr) {
+            BuilderQueue* nextBuffer = released->next;
+            ctx->freeMemoryChunk(ctx->parserThread, Ctx::MEMORY::BUILDER, reinterpret_cast<uint8_t*>(released));
+            released = nextBuffer;
         }
+        return outOfOrder;
     }
 
     void Builder::releaseDdl() {
         while (ddlFirst != nullptr) {
             uint8_t* next = *reinterpret_cast<uint8_t**>(ddlFirst);
-            ctx->freeMemoryChunk(ctx->parserThread, Ctx::MEMORY::MISC, ddlFirst);
+            ctx->freeMemoryChunk(buildThread(), Ctx::MEMORY::MISC, ddlFirst);
             ddlFirst = next;
         }
         ddlLast = nullptr;
@@ -2395,7 +3184,7 @@ namespace OpenLogReplicator {
             }
 
             if (left == 0) {
-                uint8_t* ddlNew = ctx->getMemoryChunk(ctx->parserThread, Ctx::MEMORY::MISC, false);
+                uint8_t* ddlNew = ctx->getMemoryChunk(buildThread(), Ctx::MEMORY::MISC, false);
 
                 if (ddlLast != nullptr) {
                     auto** ddlNext = reinterpret_cast<uint8_t**>(ddlLast);
@@ -2421,18 +3210,25 @@ namespace OpenLogReplicator {
         }
     }
 
-    void Builder::sleepForWriterWork(Thread* t, uint64_t queueSize, uint64_t nanoseconds) {
+    // The writer publishes that it is parking before checking the queue a last time, a commit either sees the flag
+    // and wakes it up or is seen by the check, so no message waits for the timeout
+    void Builder::sleepForWriterWork(Thread* t, uint64_t queueSize, uint64_t nanoseconds, const BuilderQueue* queue,
+                                     uint64_t position) {
         if (unlikely(ctx->isTraceSet(Ctx::TRACE::SLEEP)))
             ctx->logTrace(Ctx::TRACE::SLEEP, "Builder:sleepForWriterWork");
 
         {
             t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::WRITER_DONE);
             std::unique_lock<std::mutex> lck(mtx);
-            t->contextSet(Thread::CONTEXT::WAIT, Thread::REASON::WRITER_NO_WORK);
-            if (queueSize > 0)
-                condNoWriterWork.wait_for(lck, std::chrono::nanoseconds(nanoseconds));
-            else
-                condNoWriterWork.wait_for(lck, std::chrono::seconds(5));
+            writersSleeping.fetch_add(1, std::memory_order_seq_cst);
+            if (queue->next == nullptr && queue->confirmedSize.load(std::memory_order_seq_cst) <= position + sizeof(struct BuilderMsg)) {
+                t->contextSet(Thread::CONTEXT::WAIT, Thread::REASON::WRITER_NO_WORK);
+                if (queueSize > 0)
+                    condNoWriterWork.wait_for(lck, std::chrono::nanoseconds(nanoseconds));
+                else
+                    condNoWriterWork.wait_for(lck, std::chrono::seconds(5));
+            }
+            writersSleeping.fetch_sub(1, std::memory_order_relaxed);
         }
         t->contextSet(Thread::CONTEXT::CPU);
     }
@@ -2441,4 +3237,33 @@ namespace OpenLogReplicator {
         std::unique_lock<std::mutex> const lck(mtx);
         condNoWriterWork.notify_all();
     }
+
+    // Called by the parser between LWNs, when no transaction is being built, so that it never waits holding a transaction. The writers
+    // are woken up first as the output waiting for them may be below their flush threshold
+    void Builder::waitForCredit(Thread* t) {
+        if (creditBuffers == 0)
+            return;
+
+        time_ut waitStart = 0;
+        {
+            t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::BUILDER_CREDIT);
+            std::unique_lock<std::mutex> lck(mtx);
+            if (buffersAllocated >= creditBuffers) {
+                waitStart = ctx->clock->getTimeUt();
+                condNoWriterWork.notify_all();
+                if (unlikely(ctx->isTraceSet(Ctx::TRACE::SLEEP)))
+                    ctx->logTrace(Ctx::TRACE::SLEEP, "Builder:waitForCredit buffers: " + std::to_string(buffersAllocated));
+                while (buffersAllocated >= creditBuffers && !ctx->softShutdown) {
+                    t->contextSet(Thread::CONTEXT::WAIT, Thread::REASON::BUILDER_CREDIT_WAIT);
+                    condCredit.wait_for(lck, std::chrono::milliseconds(100));
+                }
+            }
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
+
+        if (waitStart != 0) {
+            RuntimeStats::add(ctx->stats.creditWaits, 1);
+            RuntimeStats::add(ctx->stats.creditWaitUs, ctx->clock->getTimeUt() - waitStart);
+        }
+    }
 }
@@ -22,22 +22,31 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <cmath>
 #include <cstring>
 #include <deque>
 #include <map>
 #include <mutex>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
+#include "../common/Clock.h"
 #include "../common/Ctx.h"
 #include "../common/Format.h"
 #include "../common/LobCtx.h"
 #include "../common/LobData.h"
 #include "../common/LobKey.h"
+#include "../common/Probes.h"
 #include "../common/RedoLogRecord.h"
+#include "../common/TableCost.h"
 #include "../common/Thread.h"
+#include "../common/Tracer.h"
 #include "../common/exception/RedoLogException.h"
+#include "../common/expression/Condition.h"
+#include "../common/metrics/Metrics.h"
 #include "../common/table/SysUser.h"
 #include "../common/types/Data.h"
 #include "../common/types/FileOffset.h"
@@ -54,7 +63,9 @@ namespace OpenLogReplicator {
     class Builder;
     class Ctx;
     class CharacterSet;
+    class DbColumn;
     class DbTable;
+    class LobStore;
     class Locales;
     class Metadata;
     class SystemTransaction;
@@ -70,7 +81,20 @@ namespace OpenLogReplicator {
 
     struct BuilderMsg {
         enum class OUTPUT_BUFFER : unsigned char {
-            NONE = 0, ALLOCATED = 1 << 0, CONFIRMED = 1 << 1, CHECKPOINT = 1 << 2, REDO = 1 << 3
+            NONE = 0, ALLOCATED = 1 << 0, CONFIRMED = 1 << 1, CHECKPOINT = 1 << 2, REDO = 1 << 3,
+            // Spread over many builder buffers and forwarded by the writer part by part, without a merged copy
+            FRAGMENTED = 1 << 4,
+            // Checkpoint at the end of the last redo log of a closed RAC thread
+            CLOSED = 1 << 5,
+            // Merged copy of header and data owned by one of many writers reading the same output
+            COPY = 1 << 6,
+            // Built for a transaction sampled by the tracer, the writer reports its confirmation
+            TRACED = 1 << 7
+        };
+
+        // Kind of change in the message, MIXED for a batch holding more than one kind
+        enum class OP : unsigned char {
+            NONE, BEGIN, COMMIT, ROLLBACK, INSERT, UPDATE, DELETE, DDL, MIXED
         };
 
         void* ptr;
@@ -84,7 +108,13 @@ namespace OpenLogReplicator {
         Seq sequence;
         typeObj obj;
         typeTag tagSize;
+        // Hash of the raw values of the tag columns, for routing of keyed messages without hashing the rendered key
+        uint64_t tagHash;
+        Xid xid;
+        OP op;
         OUTPUT_BUFFER flags;
+        // Time the message was built, 0 when it is not sampled for the latency histograms
+        time_ut buildTime;
 
         bool isFlagSet(OUTPUT_BUFFER flag) const {
             return (static_cast<uint>(flags) & static_cast<uint>(flag)) != 0;
@@ -97,17 +127,48 @@ namespace OpenLogReplicator {
         void unsetFlag(OUTPUT_BUFFER flag) {
             flags = static_cast<OUTPUT_BUFFER>(static_cast<uint>(flags) & ~static_cast<uint>(flag));
         }
+
+        // Values of the "op" field of the JSON format
+        static const char* opName(OP op) {
+            switch (op) {
+                case OP::BEGIN:
+                    return "begin";
+                case OP::COMMIT:
+                    return "commit";
+                case OP::ROLLBACK:
+                    return "rollback";
+                case OP::INSERT:
+                    return "c";
+                case OP::UPDATE:
+                    return "u";
+                case OP::DELETE:
+                    return "d";
+                case OP::DDL:
+                    return "ddl";
+                case OP::MIXED:
+                    return "mixed";
+                case OP::NONE:
+                    break;
+            }
+            return "";
+        }
     };
 
     class Builder {
     public:
-        static constexpr uint64_t OUTPUT_BUFFER_DATA_SIZE = Ctx::MEMORY_CHUNK_SIZE - sizeof(struct BuilderQueue);
+        // Usable part of one output buffer, the buffer size is the builder memory chunk size
+        const uint64_t outputBufferDataSize;
 
     protected:
         static constexpr uint64_t BUFFER_START_UNDEFINED{0xFFFFFFFFFFFFFFFF};
+        // A row image of an array insert or delete has at most that many columns, the count is one byte
+        static constexpr uint64_t ROW_COLUMNS_MAX{256};
 
         static constexpr uint64_t VALUE_BUFFER_MIN{1048576};
         static constexpr uint64_t VALUE_BUFFER_MAX{4294967296};
+        // Decoded LOB data kept in the value buffer before it is written to the message when streaming
+        static constexpr uint64_t LOB_STREAM_FRAGMENT{VALUE_BUFFER_MIN / 2};
+        static constexpr int64_t SECONDS_PER_DAY{24 * 60 * 60};
 
         static constexpr uint8_t XML_HEADER_STANDALONE{0x01};
         static constexpr uint8_t XML_HEADER_XMLDECL{0x02};
@@ -121,23 +182,96 @@ namespace OpenLogReplicator {
         static constexpr uint8_t XML_PROLOG_PATHID{0x10};
         static constexpr uint8_t XML_PROLOG_BIGINT{0x40};
 
+        static constexpr uint16_t OSON_FLAG_REL_OFFSET_MODE{0x0001};
+        static constexpr uint16_t OSON_FLAG_NUM_FNAMES_UINT32{0x0008};
+        static constexpr uint16_t OSON_FLAG_IS_SCALAR{0x0010};
+        static constexpr uint16_t OSON_FLAG_NUM_FNAMES_UINT16{0x0400};
+        static constexpr uint16_t OSON_FLAG_FNAMES_SEG_UINT32{0x0800};
+        static constexpr uint16_t OSON_FLAG_TREE_SEG_UINT32{0x1000};
+        static constexpr uint16_t OSON_FLAG_SEC_FNAMES_SEG_UINT16{0x0100};
+        static constexpr uint8_t OSON_VERSION_MAX_FNAME_255{1};
+        static constexpr uint8_t OSON_VERSION_MAX_FNAME_65535{3};
+        // Nesting of a malformed image must not exhaust the stack
+        static constexpr uint OSON_DEPTH_MAX{1000};
+
         Ctx* ctx;
         Locales* locales;
         Metadata* metadata;
         BuilderMsg* msg{nullptr};
 
         Format format;
+        // Format of a reloaded configuration, taken over at the next transaction start, guarded by Metadata::mtxTransaction
+        Format* formatPending{nullptr};
         uint64_t unconfirmedSize{0};
         uint64_t messageSize{0};
         uint64_t messagePosition{0};
         uint64_t flushBuffer;
+        // Column of the value being processed, so that column callbacks may use its precomputed fragments
+        const DbColumn* valueColumn{nullptr};
         char* valueBuffer{nullptr};
         uint64_t valueSize{0};
         uint64_t valueBufferSize{0};
         char* valueBufferOld{nullptr};
         uint64_t valueSizeOld{0};
+        uint64_t valueBufferOldSize{0};
+        // Binary XML decoding state, kept between values to reuse the allocations. Names point to the dictionary or to the decoded value
+        struct XmlTag {
+            std::string_view prefix;
+            std::string_view name;
+        };
+        std::vector<XmlTag> xmlTags;
+        std::vector<std::pair<uint64_t, uint64_t>> xmlDictNmSpc;
+        std::vector<std::pair<uint64_t, std::string_view>> xmlNmSpcPrefix;
+        // Field names of the OSON image being decoded, pointing to its dictionary segment
+        std::vector<std::string_view> osonNames;
+        struct OsonImage {
+            const uint8_t* data;
+            uint64_t size;
+            uint64_t tree;
+            uint8_t fieldIdSize;
+            bool relativeOffsets;
+        };
         std::unordered_set<const DbTable*> tables;
+        std::unordered_set<uint64_t> schemaVersions;
+        // Last rendered date and second, consecutive rows almost always share the day
+        int64_t isoCacheDay{INT64_MIN};
+        char isoCacheDate[10]{};
+        time_t isoCacheSecond{0};
+        uint64_t isoCacheLength{0};
+        char isoCacheBuffer[22]{};
+        bool isoCacheT{false};
+        bool isoCacheZ{false};
         uint64_t lastBuilderSize{0};
+        // Start of output of the transaction being timed for the latency histograms, 0 when it is not sampled
+        time_ut commitTime{0};
+        // Costs of the tables built here, added to the totals of the source at the end of a transaction once a second
+        TableCost::Local tableCostLocal;
+
+        // Time of building one row, counted for its table when the table cost is collected
+        class BuildTimer final {
+        protected:
+            Builder* builder;
+            const DbTable* table;
+            std::chrono::steady_clock::time_point start;
+
+        public:
+            BuildTimer(Builder* newBuilder, const DbTable* newTable) :
+                    builder(newBuilder),
+                    table(newBuilder->ctx->tableCost != nullptr ? newTable : nullptr) {
+                if (unlikely(table != nullptr))
+                    start = std::chrono::steady_clock::now();
+            }
+
+            ~BuildTimer() {
+                if (unlikely(table != nullptr))
+                    builder->tableCostLocal.add(table, Metrics::TABLE_COST::BUILD_NS, static_cast<uint64_t>(
+                            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+            }
+
+            BuildTimer(const BuildTimer&) = delete;
+            BuildTimer& operator=(const BuildTimer&) = delete;
+        };
+        uint64_t latencySampleCnt{0};
         Scn commitScn{Scn::none()};
         Xid lastXid;
         typeMask valuesSet[Ctx::COLUMN_LIMIT_23_0 / sizeof(uint64_t)]{};
@@ -149,6 +283,9 @@ namespace OpenLogReplicator {
         typeCol valuesMax{0};
         uint8_t* merges[Ctx::COLUMN_LIMIT_23_0 * static_cast<int>(Format::VALUE_TYPE::LENGTH)]{};
         typeCol mergesMax{0};
+        // Positions and sizes of the columns of one row of an array insert or delete, see scanRow()
+        typePos rowColumnPos[ROW_COLUMNS_MAX]{};
+        typeSize rowColumnSize[ROW_COLUMNS_MAX]{};
         uint8_t* ddlFirst{nullptr};
         uint8_t* ddlLast{nullptr};
         uint64_t ddlSize{0};
@@ -156,14 +293,68 @@ namespace OpenLogReplicator {
         uint64_t num{0};
         uint64_t maxMessageMb{0};      // Maximum message size able to handle by writer
         bool newTran{false};
+        // Output message open for more row messages when batching, with the number of rows and the table it holds
+        bool batchOpen{false};
+        uint64_t batchCount{0};
+        typeObj batchObj{0};
         bool compressedBefore{false};
         bool compressedAfter{false};
         uint8_t prevChars[CharacterSet::MAX_CHARACTER_LENGTH * 2]{};
         uint64_t prevCharsSize{0};
         const std::unordered_map<std::string, std::string>* attributes{};
+        ConditionContext conditionContext;
+        // Copy of a column image in compactData, size -1 when the image does not contain the column
+        struct CompactImage {
+            uint64_t pos;
+            int64_t size;
+        };
+
+        struct CompactColumn {
+            typeCol column;
+            CompactImage before;
+            CompactImage after;
+        };
+
+        // Net change of a row collected with compaction on, T_NONE after an insert followed by a delete
+        struct CompactRow {
+            Format::TRANSACTION_TYPE type;
+            const DbTable* table;
+            typeObj obj;
+            RowId rowId;
+            Scn scn;
+            FileOffset fileOffset;
+            bool compressedBefore;
+            bool compressedAfter;
+            // Sorted by column
+            std::vector<CompactColumn> columns;
+        };
+
+        // Copies of the values above this size are sent before the transaction ends
+        static constexpr uint64_t COMPACT_DATA_MAX{64 * 1024 * 1024};
+
+        // Rows in order of their first change, a row without a table or compressed is kept as is
+        std::vector<CompactRow> compactRows;
+        std::unordered_map<RowId, size_t> compactIndex;
+        std::vector<uint8_t> compactData;
+        std::vector<CompactColumn> compactChange;
+        LobCtx* compactLobCtx{nullptr};
+        const XmlCtx* compactXmlCtx{nullptr};
+        Seq compactSequence{Seq::zero()};
+        time_t compactTimestamp{0};
+        // Column of the LOB being streamed, nullptr when the LOB is reassembled whole in the value buffer
+        const std::string* lobStreamColumn{nullptr};
+        bool lobStreamClob{false};
+        bool lobStreamStarted{false};
 
         std::mutex mtx;
         std::condition_variable condNoWriterWork;
+        // Flow control: the buffers are the credits, the writers grant them back by releasing the buffers they are done with
+        const uint64_t creditBuffers;
+        std::condition_variable condCredit;
+        // Writers parked in sleepForWriterWork(), every commit then wakes them up
+        std::atomic<uint64_t> writersSleeping{0};
+        // For every writer: buffers with a lower id are read and confirmed by it, used when more than one writer reads the output
+        std::vector<uint64_t> writerReleaseIds;
         char ddlSchemaName[SysUser::NAME_LENGTH]{};
         typeSize ddlSchemaSize{0};
 
@@ -177,8 +368,8 @@ namespace OpenLogReplicator {
                                               std::to_string(ctx->memoryChunksWriteBufferMax * Ctx::MEMORY_CHUNK_SIZE_MB) +
                                               ") is too small to fit a message with size: " +
                                               std::to_string(messageSize));
-            auto* nextBuffer = reinterpret_cast<BuilderQueue*>(ctx->getMemoryChunk(ctx->parserThread, Ctx::MEMORY::BUILDER));
-            ctx->parserThread->contextSet(Thread::CONTEXT::TRAN, Thread::REASON::TRAN);
+            auto* nextBuffer = reinterpret_cast<BuilderQueue*>(ctx->getMemoryChunk(buildThread(), Ctx::MEMORY::BUILDER));
+            buildThread()->contextSet(Thread::CONTEXT::TRAN, Thread::REASON::TRAN);
             nextBuffer->next = nullptr;
             nextBuffer->id = lastBuilderQueue->id + 1;
             nextBuffer->data = reinterpret_cast<uint8_t*>(nextBuffer) + sizeof(struct BuilderQueue);
@@ -186,7 +377,7 @@ namespace OpenLogReplicator {
             lastBuilderSize = 0;
 
             // Message could potentially fit in one buffer
-            if (likely(copy && msg != nullptr && messageSize + messagePosition < OUTPUT_BUFFER_DATA_SIZE)) {
+            if (likely(copy && msg != nullptr && messageSize + messagePosition < outputBufferDataSize)) {
                 memcpy(reinterpret_cast<void*>(nextBuffer->data), msg, messagePosition);
                 msg = reinterpret_cast<BuilderMsg*>(nextBuffer->data);
                 msg->data = nextBuffer->data + sizeof(struct BuilderMsg);
@@ -199,13 +390,13 @@ namespace OpenLogReplicator {
             }
 
             {
-                ctx->parserThread->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::BUILDER_ROTATE);
+                buildThread()->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::BUILDER_ROTATE);
                 std::unique_lock<std::mutex> const lck(mtx);
                 lastBuilderQueue->next = nextBuffer;
                 ++buffersAllocated;
                 lastBuilderQueue = nextBuffer;
             }
-            ctx->parserThread->contextSet(Thread::CONTEXT::TRAN, Thread::REASON::TRAN);
+            buildThread()->contextSet(Thread::CONTEXT::TRAN, Thread::REASON::TRAN);
         }
 
         void processValue(LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table, typeCol col, const uint8_t* data, uint32_t size, FileOffset fileOffset,
@@ -235,6 +426,52 @@ namespace OpenLogReplicator {
             compressedAfter = false;
         }
 
+        // Dropped after the condition is evaluated, so that neither the value nor the LOB it points to is decoded
+        void projectValues(const DbTable* table);
+        [[nodiscard]] typePos scanRow(const RedoLogRecord* redoLogRecord, typePos pos, typeCC columns);
+        CompactImage compactCopy(const uint8_t* data, int64_t size);
+        void compactMerge(CompactRow& row, bool mergeBefore, bool mergeAfter);
+        void compactStore(Format::TRANSACTION_TYPE type, Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx,
+                          const DbTable* table, typeObj obj, typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset);
+        void compactEmit(const CompactRow& row);
+
+        [[nodiscard]] bool isCompacting() const {
+            return format.compactFormat == Format::COMPACT_FORMAT::ROW;
+        }
+
+        void emitInsert(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table, typeObj obj,
+                        typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset) {
+            if (isCompacting()) {
+                compactStore(Format::TRANSACTION_TYPE::INSERT, scn, sequence, timestamp, lobCtx, xmlCtx, table, obj, dataObj, bdba, slot, fileOffset);
+                return;
+            }
+            processInsert(scn, sequence, timestamp, lobCtx, xmlCtx, table, obj, dataObj, bdba, slot, fileOffset);
+            if (ctx->metrics != nullptr)
+                emitDmlOps(Metrics::DML_OPS::INSERT_OUT, table);
+        }
+
+        void emitUpdate(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table, typeObj obj,
+                        typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset) {
+            if (isCompacting()) {
+                compactStore(Format::TRANSACTION_TYPE::UPDATE, scn, sequence, timestamp, lobCtx, xmlCtx, table, obj, dataObj, bdba, slot, fileOffset);
+                return;
+            }
+            processUpdate(scn, sequence, timestamp, lobCtx, xmlCtx, table, obj, dataObj, bdba, slot, fileOffset);
+            if (ctx->metrics != nullptr)
+                emitDmlOps(Metrics::DML_OPS::UPDATE_OUT, table);
+        }
+
+        void emitDelete(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table, typeObj obj,
+                        typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset) {
+            if (isCompacting()) {
+                compactStore(Format::TRANSACTION_TYPE::DELETE, scn, sequence, timestamp, lobCtx, xmlCtx, table, obj, dataObj, bdba, slot, fileOffset);
+                return;
+            }
+            processDelete(scn, sequence, timestamp, lobCtx, xmlCtx, table, obj, dataObj, bdba, slot, fileOffset);
+            if (ctx->metrics != nullptr)
+                emitDmlOps(Metrics::DML_OPS::DELETE_OUT, table);
+        }
+
         void valueSet(Format::VALUE_TYPE type, uint16_t column, const uint8_t* data, typeSize size, uint8_t fb, bool dump) {
             if (unlikely(ctx->isTraceSet(Ctx::TRACE::DML) || dump)) {
                 std::ostringstream ss;
@@ -287,9 +524,9 @@ namespace OpenLogReplicator {
         void builderShift() {
             ++messagePosition;
 
-            if (unlikely(lastBuilderSize + messagePosition >= OUTPUT_BUFFER_DATA_SIZE))
+            if (unlikely(lastBuilderSize + messagePosition >= outputBufferDataSize))
                 builderRotate<copy>();
-            ctx->assertDebug(lastBuilderSize + messagePosition < OUTPUT_BUFFER_DATA_SIZE);
+            ctx->assertDebug(lastBuilderSize + messagePosition < outputBufferDataSize);
         }
 
         void builderShiftFast(uint64_t bytes) {
@@ -302,21 +539,27 @@ namespace OpenLogReplicator {
             if (format.isScnTypeCommitValue())
                 scn = commitScn;
 
-            if (unlikely(lastBuilderSize + messagePosition + sizeof(struct BuilderMsg) >= OUTPUT_BUFFER_DATA_SIZE))
+            if (unlikely(lastBuilderSize + messagePosition + sizeof(struct BuilderMsg) >= outputBufferDataSize))
                 builderRotate<true>();
 
             msg = reinterpret_cast<BuilderMsg*>(lastBuilderQueue->data + lastBuilderSize);
             builderShiftFast(sizeof(struct BuilderMsg));
-            ctx->assertDebug(lastBuilderSize + messagePosition < OUTPUT_BUFFER_DATA_SIZE);
+            ctx->assertDebug(lastBuilderSize + messagePosition < outputBufferDataSize);
             msg->scn = scn;
             msg->lwnScn = lwnScn;
             msg->lwnIdx = lwnIdx++;
             msg->sequence = sequence;
             msg->size = 0;
             msg->tagSize = 0;
+            msg->tagHash = 0;
             msg->id = id++;
             msg->obj = obj;
+            msg->xid = lastXid;
+            msg->op = BuilderMsg::OP::NONE;
             msg->flags = flags;
+            if (unlikely(threadClosed) && msg->isFlagSet(BuilderMsg::OUTPUT_BUFFER::REDO))
+                msg->setFlag(BuilderMsg::OUTPUT_BUFFER::CLOSED);
+            msg->buildTime = 0;
             msg->data = lastBuilderQueue->data + lastBuilderSize + sizeof(struct BuilderMsg);
         }
 
@@ -326,25 +569,108 @@ namespace OpenLogReplicator {
                 throw RedoLogException(50058, "output buffer - commit of empty transaction");
 
             msg->queueId = lastBuilderQueue->id;
+            if (unlikely(commitTime != 0)) {
+                msg->buildTime = ctx->clock->getTimeUt();
+                ctx->recordLatency(RuntimeStats::LATENCY::COMMIT_BUILD, commitTime, msg->buildTime);
+            }
+            if (unlikely(trace != nullptr)) {
+                msg->setFlag(BuilderMsg::OUTPUT_BUFFER::TRACED);
+                const time_ut now = msg->buildTime != 0 ? msg->buildTime : ctx->clock->getTimeUt();
+                if (trace->messages == 0) {
+                    trace->buildFirstUt = now;
+                    trace->firstMessageId = msg->id;
+                }
+                trace->buildLastUt = now;
+                trace->lastMessageId = msg->id;
+                ++trace->messages;
+            }
             builderShiftFast((8 - (messagePosition & 7)) & 7);
             unconfirmedSize += messageSize;
             msg->size = messageSize - sizeof(struct BuilderMsg);
+            // message id, scn, obj, size
+            OLR_PROBE4(builder_message, msg->id, msg->scn.getData(), msg->obj, messageSize - sizeof(struct BuilderMsg));
+            RuntimeStats::add(ctx->stats.messagesBuilt, 1);
+            RuntimeStats::add(ctx->stats.bytesBuilt, msg->size);
+            if (unlikely(ctx->tableCost != nullptr) && msg->obj != 0)
+                tableCostOutput();
             msg = nullptr;
             lastBuilderQueue->confirmedSize += messagePosition;
             lastBuilderSize += messagePosition;
             if (unlikely(lastBuilderQueue->start == BUFFER_START_UNDEFINED))
                 lastBuilderQueue->start = static_cast<uint64_t>(lastBuilderQueue->confirmedSize);
 
-            if (flushBuffer == 0 || unconfirmedSize > flushBuffer)
+            if (flushBuffer == 0 || unconfirmedSize > flushBuffer || writersSleeping.load(std::memory_order_seq_cst) != 0)
                 flush();
         }
 
+        // Starts a message, or continues the open batch. Messages of another table and rows with tag data, which is used as the
+        // message key, are not mixed into one batch. The batch takes the position of its last message, so that it is confirmed as a whole
+        void messageBegin(Scn scn, Seq sequence, typeObj obj, bool batchable, BuilderMsg::OP op) {
+            if (batchOpen) {
+                if (batchable && (obj == 0 || batchObj == 0 || obj == batchObj)) {
+                    if (format.isScnTypeCommitValue())
+                        scn = commitScn;
+                    msg->scn = scn;
+                    msg->lwnScn = lwnScn;
+                    msg->lwnIdx = lwnIdx++;
+                    msg->sequence = sequence;
+                    msg->xid = lastXid;
+                    messageOp(op);
+                    if (obj != 0) {
+                        msg->obj = obj;
+                        batchObj = obj;
+                    }
+                    batchSeparator(false);
+                    return;
+                }
+                batchClose();
+            }
+
+            builderBegin(scn, sequence, obj, BuilderMsg::OUTPUT_BUFFER::NONE);
+            messageOp(op);
+            if (batchable && format.isMessageFormatBatch()) {
+                batchOpen = true;
+                batchCount = 0;
+                batchObj = obj;
+                batchSeparator(true);
+            }
+        }
+
+        void messageOp(BuilderMsg::OP op) {
+            msg->op = (msg->op == BuilderMsg::OP::NONE || msg->op == op) ? op : BuilderMsg::OP::MIXED;
+        }
+
+        void messageCommit(bool row) {
+            if (!batchOpen) {
+                builderCommit();
+                return;
+            }
+
+            if (row)
+                ++batchCount;
+            if (batchCount >= format.batchRows || messageSize + messagePosition >= format.batchBytes)
+                batchClose();
+        }
+
+        void batchClose() {
+            if (!batchOpen)
+                return;
+            batchOpen = false;
+            batchEnd();
+            builderCommit();
+        }
+
+        virtual void batchSeparator(bool first __attribute__((unused))) {}
+        virtual void batchEnd() {}
+        // Called after a reloaded format took effect, at the start of a transaction
+        virtual void formatChanged() {}
+
         template<bool fast = false>
         void append(char character) {
             lastBuilderQueue->data[lastBuilderSize + messagePosition] = character;
             if constexpr (fast) {
                 ++messagePosition;
-                ctx->assertDebug(lastBuilderSize + messagePosition < OUTPUT_BUFFER_DATA_SIZE);
+                ctx->assertDebug(lastBuilderSize + messagePosition < outputBufferDataSize);
             } else {
                 builderShift<true>();
             }
@@ -352,11 +678,11 @@ namespace OpenLogReplicator {
 
         template<bool fast = false>
         void appendArr(const char* str, uint64_t size) {
-            if (fast || likely(lastBuilderSize + messagePosition + size < OUTPUT_BUFFER_DATA_SIZE)) {
+            if (fast || likely(lastBuilderSize + messagePosition + size < outputBufferDataSize)) {
                 memcpy(reinterpret_cast<void*>(lastBuilderQueue->data + lastBuilderSize + messagePosition),
                        reinterpret_cast<const void*>(str), size);
                 messagePosition += size;
-                ctx->assertDebug(lastBuilderSize + messagePosition < OUTPUT_BUFFER_DATA_SIZE);
+                ctx->assertDebug(lastBuilderSize + messagePosition < outputBufferDataSize);
             } else {
                 for (uint64_t i = 0; i < size; ++i)
                     append(*str++);
@@ -371,11 +697,11 @@ namespace OpenLogReplicator {
         template<bool fast = false>
         void append(const std::string& str) {
             const size_t size = str.length();
-            if (unlikely(lastBuilderSize + messagePosition + size < OUTPUT_BUFFER_DATA_SIZE)) {
+            if (unlikely(lastBuilderSize + messagePosition + size < outputBufferDataSize)) {
                 memcpy(reinterpret_cast<void*>(lastBuilderQueue->data + lastBuilderSize + messagePosition),
                        reinterpret_cast<const void*>(str.c_str()), size);
                 messagePosition += size;
-                ctx->assertDebug(lastBuilderSize + messagePosition < OUTPUT_BUFFER_DATA_SIZE);
+                ctx->assertDebug(lastBuilderSize + messagePosition < outputBufferDataSize);
             } else {
                 const char* charStr = str.c_str();
                 for (size_t i = 0; i < size; ++i)
@@ -404,6 +730,37 @@ namespace OpenLogReplicator {
             valueBuffer[valueSize++] = static_cast<char>(value);
         }
 
+        void valueBufferWrite(const char* text, uint64_t size, FileOffset fileOffset) {
+            valueBufferCheck(size, fileOffset);
+            memcpy(reinterpret_cast<void*>(valueBuffer + valueSize), reinterpret_cast<const void*>(text), size);
+            valueSize += size;
+        }
+
+        void valueBufferWrite(std::string_view text, FileOffset fileOffset) {
+            valueBufferWrite(text.data(), text.size(), fileOffset);
+        }
+
+        void xmlAppendTag(const char* start, const XmlTag& tag, FileOffset fileOffset) {
+            const uint64_t startSize = strlen(start);
+            valueBufferCheck(startSize + tag.prefix.size() + tag.name.size() + 2, fileOffset);
+            memcpy(reinterpret_cast<void*>(valueBuffer + valueSize), reinterpret_cast<const void*>(start), startSize);
+            valueSize += startSize;
+            if (!tag.prefix.empty()) {
+                memcpy(reinterpret_cast<void*>(valueBuffer + valueSize), reinterpret_cast<const void*>(tag.prefix.data()), tag.prefix.size());
+                valueSize += tag.prefix.size();
+                valueBuffer[valueSize++] = ':';
+            }
+            memcpy(reinterpret_cast<void*>(valueBuffer + valueSize), reinterpret_cast<const void*>(tag.name.data()), tag.name.size());
+            valueSize += tag.name.size();
+        }
+
+        [[nodiscard]] std::string_view xmlPrefix(uint64_t nmSpc) const {
+            for (const auto& [prefixNmSpc, prefix]: xmlNmSpcPrefix)
+                if (prefixNmSpc == nmSpc)
+                    return prefix;
+            return {};
+        }
+
         void valueBufferAppendHex(uint8_t value, FileOffset fileOffset) {
             valueBufferCheck(2, fileOffset);
             valueBuffer[valueSize++] = Data::map16((value >> 4) & 0x0F);
@@ -412,12 +769,27 @@ namespace OpenLogReplicator {
 
         void parseNumber(const uint8_t* data, uint64_t size, FileOffset fileOffset) {
             valueBufferPurge();
-            valueBufferCheck((size * 2) + 2, fileOffset);
+            appendNumber(data, size, fileOffset);
+        }
+
+        // Longest text of a NUMBER of the given redo length, also a large exponent padded by zeros fits
+        [[nodiscard]] static constexpr uint64_t numberMaxLength(uint64_t size) {
+            return (size * 2) + 132;
+        }
+
+        // Appends the text of the number to the value buffer
+        void appendNumber(const uint8_t* data, uint64_t size, FileOffset fileOffset) {
+            valueBufferCheck(numberMaxLength(size), fileOffset);
+            valueSize += numberToChars(data, size, valueBuffer + valueSize, fileOffset);
+        }
 
+        // Writes the text of the number to out, which has room for numberMaxLength(size) characters, and returns its length
+        uint64_t numberToChars(const uint8_t* data, uint64_t size, char* out, FileOffset fileOffset) const {
+            const char* begin = out;
             uint8_t digits = data[0];
             // Just zero
             if (digits == 0x80) {
-                valueBufferAppend('0');
+                *out++ = '0';
             } else {
                 uint64_t j = 1;
                 uint64_t jMax = size - 1;
@@ -428,17 +800,17 @@ namespace OpenLogReplicator {
                     uint64_t zeros = 0;
                     // Part of the total
                     if (digits <= 0xC0) {
-                        valueBufferAppend('0');
+                        *out++ = '0';
                         zeros = 0xC0 - digits;
                     } else {
                         digits -= 0xC0;
                         // Part of the total - omitting first zero for a first digit
                         value = data[j] - 1;
                         if (value < 10)
-                            valueBufferAppend(Data::map10(value));
+                            *out++ = Data::map10(value);
                         else {
-                            valueBufferAppend(Data::map10(value / 10));
-                            valueBufferAppend(Data::map10(value % 10));
+                            *out++ = Data::map10(value / 10);
+                            *out++ = Data::map10(value % 10);
                         }
 
                         ++j;
@@ -447,12 +819,12 @@ namespace OpenLogReplicator {
                         while (digits > 0) {
                             value = data[j] - 1;
                             if (j <= jMax) {
-                                valueBufferAppend(Data::map10(value / 10));
-                                valueBufferAppend(Data::map10(value % 10));
+                                *out++ = Data::map10(value / 10);
+                                *out++ = Data::map10(value % 10);
                                 ++j;
                             } else {
-                                valueBufferAppend('0');
-                                valueBufferAppend('0');
+                                *out++ = '0';
+                                *out++ = '0';
                             }
                             --digits;
                         }
@@ -460,49 +832,49 @@ namespace OpenLogReplicator {
 
                     // Fraction part
                     if (j <= jMax) {
-                        valueBufferAppend('.');
+                        *out++ = '.';
 
                         while (zeros > 0) {
-                            valueBufferAppend('0');
-                            valueBufferAppend('0');
+                            *out++ = '0';
+                            *out++ = '0';
                             --zeros;
                         }
 
                         while (j <= jMax - 1U) {
                             value = data[j] - 1;
-                            valueBufferAppend(Data::map10(value / 10));
-                            valueBufferAppend(Data::map10(value % 10));
+                            *out++ = Data::map10(value / 10);
+                            *out++ = Data::map10(value % 10);
                             ++j;
                         }
 
                         // Last digit - omitting 0 at the end
                         value = data[j] - 1;
-                        valueBufferAppend(Data::map10(value / 10));
+                        *out++ = Data::map10(value / 10);
                         if ((value % 10) != 0)
-                            valueBufferAppend(Data::map10(value % 10));
+                            *out++ = Data::map10(value % 10);
                     }
                 } else if (digits < 0x80 && jMax >= 1) {
                     // Negative number
                     uint64_t value;
                     uint64_t zeros = 0;
-                    valueBufferAppend('-');
+                    *out++ = '-';
 
                     if (data[jMax] == 0x66)
                         --jMax;
 
                     // Part of the total
                     if (digits >= 0x3F) {
-                        valueBufferAppend('0');
+                        *out++ = '0';
                         zeros = digits - 0x3F;
                     } else {
                         digits = 0x3F - digits;
 
                         value = 101 - data[j];
                         if (value < 10)
-                            valueBufferAppend(Data::map10(value));
+                            *out++ = Data::map10(value);
                         else {
-                            valueBufferAppend(Data::map10(value / 10));
-                            valueBufferAppend(Data::map10(value % 10));
+                            *out++ = Data::map10(value / 10);
+                            *out++ = Data::map10(value % 10);
                         }
                         ++j;
                         --digits;
@@ -510,41 +882,41 @@ namespace OpenLogReplicator {
                         while (digits > 0) {
                             if (j <= jMax) {
                                 value = 101 - data[j];
-                                valueBufferAppend(Data::map10(value / 10));
-                                valueBufferAppend(Data::map10(value % 10));
+                                *out++ = Data::map10(value / 10);
+                                *out++ = Data::map10(value % 10);
                                 ++j;
                             } else {
-                                valueBufferAppend('0');
-                                valueBufferAppend('0');
+                                *out++ = '0';
+                                *out++ = '0';
                             }
                             --digits;
                         }
                     }
 
                     if (j <= jMax) {
-                        valueBufferAppend('.');
+                        *out++ = '.';
 
                         while (zeros > 0) {
-                            valueBufferAppend('0');
-                            valueBufferAppend('0');
+                            *out++ = '0';
+                            *out++ = '0';
                             --zeros;
                         }
 
                         while (j <= jMax - 1U) {
                             value = 101 - data[j];
-                            valueBufferAppend(Data::map10(value / 10));
-                            valueBufferAppend(Data::map10(value % 10));
+                            *out++ = Data::map10(value / 10);
+                            *out++ = Data::map10(value % 10);
                             ++j;
                         }
 
                         value = 101 - data[j];
-                        valueBufferAppend(Data::map10(value / 10));
+                        *out++ = Data::map10(value / 10);
                         if ((value % 10) != 0)
-                            valueBufferAppend(Data::map10(value % 10));
+                            *out++ = Data::map10(value % 10);
                     }
                 } else {
                     if (digits == 0) {
-                        valueBufferAppend('0');
+                        *out++ = '0';
                     } else {
                         if (unlikely(format.unknownFormat == Format::UNKNOWN_FORMAT::DUMP)) {
                             std::ostringstream ss;
@@ -556,6 +928,7 @@ namespace OpenLogReplicator {
                     }
                 }
             }
+            return static_cast<uint64_t>(out - begin);
         }
 
         static std::string dumpLob(const uint8_t* data, uint64_t size) {
@@ -575,8 +948,28 @@ namespace OpenLogReplicator {
                        reinterpret_cast<const void*>(data), size);
                 valueSize += size;
             }
+
+            if (unlikely(lobStreamColumn != nullptr) && valueSize >= LOB_STREAM_FRAGMENT)
+                lobStreamFlush(false);
+        }
+
+        void lobStreamFlush(bool last) {
+            if (!lobStreamStarted) {
+                columnStreamBegin(*lobStreamColumn);
+                lobStreamStarted = true;
+            }
+
+            // Bytes which can't be encoded yet are moved to the start of the value buffer
+            const uint64_t written = columnStreamAppend(lobStreamClob, last);
+            if (written < valueSize)
+                memmove(reinterpret_cast<void*>(valueBuffer), reinterpret_cast<const void*>(valueBuffer + written), valueSize - written);
+            valueSize -= written;
         }
 
+        bool lobStreamStart(const std::string& columnName, bool isClob);
+        bool lobExternalize(const std::string& columnName);
+        void lobStreamFinish(bool found, FileOffset fileOffset);
+
         bool parseLob(LobCtx* lobCtx, const uint8_t* data, uint64_t size, uint64_t charsetId, typeObj obj, FileOffset fileOffset, bool isClob, bool isSystem) {
             bool appendData = false;
             bool hasPrev = false;
@@ -604,7 +997,8 @@ namespace OpenLogReplicator {
                     return true;
                 }
                 LobData* lobData = lobsIt->second;
-                valueBufferCheck(static_cast<uint64_t>((lobData->pageSize) * static_cast<uint64_t>(lobData->sizePages)) + lobData->sizeRest, fileOffset);
+                if (lobStreamColumn == nullptr)
+                    valueBufferCheck(static_cast<uint64_t>((lobData->pageSize) * static_cast<uint64_t>(lobData->sizePages)) + lobData->sizeRest, fileOffset);
 
                 typeDba pageNo = 0;
                 for (const auto& [pageNoLob, page]: lobData->indexMap) {
@@ -1079,7 +1473,7 @@ namespace OpenLogReplicator {
 
         void parseString(const uint8_t* data, uint64_t size, uint64_t charsetId, FileOffset fileOffset, bool appendData, bool hasPrev, bool hasNext,
                          bool isSystem) {
-            const CharacterSet* characterSet = locales->characterMap[charsetId];
+            const CharacterSet* characterSet = locales->getCharacterSet(charsetId);
             if (unlikely(characterSet == nullptr && !format.isCharFormatNoMapping()))
                 throw RedoLogException(50010, "can't find character set map for id = " + std::to_string(charsetId) + " at offset: " + fileOffset.toString());
             if (!appendData)
@@ -1118,6 +1512,22 @@ namespace OpenLogReplicator {
                 typeUnicode unicodeCharacter;
 
                 if (!format.isCharFormatNoMapping()) {
+                    // Plain ASCII run copied in one go, with the same tail left for the next run as the per character loop
+                    if (overlap == 0 && (!format.isCharFormatHex() || isSystem)) {
+                        uint64_t run = parseSize;
+                        if (hasNext)
+                            run = parseSize >= CharacterSet::MAX_CHARACTER_LENGTH ? parseSize - (CharacterSet::MAX_CHARACTER_LENGTH - 1) : 0;
+                        run = characterSet->decodeRun(parseData, run);
+                        if (run > 0) {
+                            valueBufferCheck(run, fileOffset);
+                            memcpy(reinterpret_cast<void*>(valueBuffer + valueSize), reinterpret_cast<const void*>(parseData), run);
+                            valueSize += run;
+                            parseData += run;
+                            parseSize -= run;
+                            continue;
+                        }
+                    }
+
                     unicodeCharacter = characterSet->decode(ctx, lastXid, parseData, parseSize);
 
                     if (likely(!format.isCharFormatHex() || isSystem)) {
@@ -1184,6 +1594,50 @@ namespace OpenLogReplicator {
             }
         }
 
+        // Data::epochToIso8601 with the date part reused while the day does not change, BC dates are not cached
+        uint64_t epochToIso8601(time_t timestamp, char* buffer, bool addT, bool addZ) {
+            if (timestamp == isoCacheSecond && addT == isoCacheT && addZ == isoCacheZ && isoCacheLength > 0) {
+                memcpy(buffer, isoCacheBuffer, isoCacheLength + 1);
+                return isoCacheLength;
+            }
+
+            const int64_t day = (timestamp >= 0 ? timestamp : timestamp - (SECONDS_PER_DAY - 1)) / SECONDS_PER_DAY;
+            uint64_t length;
+            if (day == isoCacheDay) {
+                int64_t seconds = timestamp - (day * SECONDS_PER_DAY);
+                memcpy(buffer, isoCacheDate, 10);
+                buffer[10] = addT ? 'T' : ' ';
+                buffer[11] = Data::map10(seconds / 36000);
+                buffer[12] = Data::map10((seconds / 3600) % 10);
+                buffer[13] = ':';
+                seconds %= 3600;
+                buffer[14] = Data::map10(seconds / 600);
+                buffer[15] = Data::map10((seconds / 60) % 10);
+                buffer[16] = ':';
+                seconds %= 60;
+                buffer[17] = Data::map10(seconds / 10);
+                buffer[18] = Data::map10(seconds % 10);
+                length = 19;
+                if (addZ)
+                    buffer[length++] = 'Z';
+                buffer[length] = 0;
+            } else {
+                length = Data::epochToIso8601(timestamp, buffer, addT, addZ);
+                if (buffer[0] != '-') {
+                    memcpy(isoCacheDate, buffer, 10);
+                    isoCacheDay = day;
+                } else
+                    isoCacheDay = INT64_MIN;
+            }
+
+            memcpy(isoCacheBuffer, buffer, length + 1);
+            isoCacheLength = length;
+            isoCacheSecond = timestamp;
+            isoCacheT = addT;
+            isoCacheZ = addZ;
+            return length;
+        }
+
         void valueBufferCheck(uint64_t size, FileOffset fileOffset) {
             if (unlikely(valueSize + size > VALUE_BUFFER_MAX))
                 throw RedoLogException(50012, "trying to allocate length for value: " + std::to_string(valueSize + size) +
@@ -1217,7 +1671,32 @@ namespace OpenLogReplicator {
         virtual void columnDouble(const std::string& columnName, long double value) = 0;
         virtual void columnString(const std::string& columnName) = 0;
         virtual void columnNumber(const std::string& columnName, int precision, int scale) = 0;
+        // Default converts the NUMBER to text first, binary formats may decode the redo bytes directly
+        virtual void columnNumberData(const std::string& columnName, int precision, int scale, const uint8_t* data, uint64_t size, FileOffset fileOffset) {
+            parseNumber(data, size, fileOffset);
+            columnNumber(columnName, precision, scale);
+        }
         virtual void columnRaw(const std::string& columnName, const uint8_t* data, uint64_t size) = 0;
+        // Value of a JSON column in the OSON format, formats without JSON text output pass the binary image through as raw
+        virtual void columnJson(const std::string& columnName, const uint8_t* data, uint64_t size, FileOffset fileOffset __attribute__((unused))) {
+            columnRaw(columnName, data, size);
+        }
+        // LOB value written to the message in parts as the pages are decoded, for formats which don't need the whole value at once
+        [[nodiscard]] virtual bool isStreamSupported() const {
+            return false;
+        }
+        virtual void columnStreamBegin(const std::string& columnName __attribute__((unused))) {}
+        // Returns the number of bytes of the value buffer written, the rest is kept for the next part
+        virtual uint64_t columnStreamAppend(bool isClob __attribute__((unused)), bool last __attribute__((unused))) {
+            return valueSize;
+        }
+        virtual void columnStreamEnd() {}
+        // LOB value written to the LOB store, the message carries the hash of the content and its length
+        virtual void columnLobRef(const std::string& columnName, const std::string& hash, uint64_t size __attribute__((unused))) {
+            valueBufferPurge();
+            valueBufferAppend(hash.c_str(), hash.size());
+            columnString(columnName);
+        }
         virtual void columnRowId(const std::string& columnName, RowId rowId) = 0;
         virtual void columnTimestamp(const std::string& columnName, time_t timestamp, uint64_t fraction) = 0;
         virtual void columnTimestampTz(const std::string& columnName, time_t timestamp, uint64_t fraction, const std::string_view& tz) = 0;
@@ -1229,10 +1708,30 @@ namespace OpenLogReplicator {
                                    typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset) = 0;
         virtual void processDdl(Scn scn, Seq sequence, time_t timestamp, const DbTable* table, typeObj obj) = 0;
         virtual void processBeginMessage(Scn scn, Seq sequence, time_t timestamp) = 0;
+        void valueBufferSwap();
         bool parseXml(const XmlCtx* xmlCtx, const uint8_t* data, uint64_t size, FileOffset fileOffset);
+        bool parseOson(const uint8_t* data, uint64_t size, FileOffset fileOffset);
+        bool osonNode(const OsonImage& image, uint64_t& pos, uint depth, FileOffset fileOffset);
+        bool osonContainer(const OsonImage& image, uint8_t nodeType, uint64_t& pos, uint depth, FileOffset fileOffset);
+        void osonAppendString(const uint8_t* text, uint64_t size, FileOffset fileOffset);
+        void osonAppendDateTime(const uint8_t* data, uint64_t size, bool utc, FileOffset fileOffset);
+        void emitDmlOps(Metrics::DML_OPS op, const DbTable* table);
+        void tableCostOutput();
 
     public:
         SystemTransaction* systemTransaction{nullptr};
+        // Set when large LOB values are stored outside the message
+        LobStore* lobStore{nullptr};
+        // Set by the transaction flusher for the time it builds messages instead of the parser thread
+        Thread* flushThread{nullptr};
+        // Rows of a transaction which is not committed yet, the part ends with a provisional marker instead of a commit
+        bool provisional{false};
+        // Commit of a transaction sent before as provisional, not skipped when no rows are left
+        bool provisionalCommit{false};
+        // Set by the parser for the log switch checkpoint when the redo thread was closed
+        bool threadClosed{false};
+        // Times of the transaction being built when it is traced, set after processBegin()
+        Tracer::Trace* trace{nullptr};
         uint64_t buffersAllocated{0};
         BuilderQueue* firstBuilderQueue{nullptr};
         BuilderQueue* lastBuilderQueue{nullptr};
@@ -1242,38 +1741,70 @@ namespace OpenLogReplicator {
         Builder(Ctx* newCtx, Locales* newLocales, Metadata* newMetadata, Format& newFormat, uint64_t newFlushBuffer);
         virtual ~Builder();
 
+        [[nodiscard]] Thread* buildThread() const {
+            return flushThread != nullptr ? flushThread : ctx->parserThread;
+        }
+
         [[nodiscard]] uint64_t builderSize() const;
+        // Output messages are serialized pb::RedoResponse
+        [[nodiscard]] virtual bool isProtobuf() const {
+            return false;
+        }
+        // Output messages are Avro single-object encoded records
+        [[nodiscard]] virtual bool isAvro() const {
+            return false;
+        }
+        // Every row change is a message of its own, tagged with the object it belongs to
+        [[nodiscard]] bool isMessagePerRow() const {
+            return !format.isMessageFormatFull();
+        }
+        [[nodiscard]] const Format& getFormat() const {
+            return format;
+        }
         [[nodiscard]] uint64_t getMaxMessageMb() const;
         void setMaxMessageMb(uint64_t maxMessageMb);
+        void setFormat(const Format& newFormat);
         void processBegin(Xid xid, Scn scn, Scn newLwnScn, const std::unordered_map<std::string, std::string>* newAttributes);
+        void processEnd();
         void processInsertMultiple(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx, const RedoLogRecord* redoLogRecord1,
                                    const RedoLogRecord* redoLogRecord2, bool system, bool schema, bool dump);
         void processDeleteMultiple(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx, const RedoLogRecord* redoLogRecord1,
                                    const RedoLogRecord* redoLogRecord2, bool system, bool schema, bool dump);
-        void processDml(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx, const std::deque<const RedoLogRecord*>& redo1,
-                        const std::deque<const RedoLogRecord*>& redo2, Format::TRANSACTION_TYPE transactionType, bool system, bool schema, bool dump);
+        void processSnapshotInsert(Scn scn, Seq sequence, time_t timestamp, const DbTable* table, typeObj obj, RowId rowId, const uint8_t* const* data,
+                                   const typeSize* size);
+        void processDml(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx, const std::vector<const RedoLogRecord*>& redo1,
+                        const std::vector<const RedoLogRecord*>& redo2, Format::TRANSACTION_TYPE transactionType, bool system, bool schema, bool dump);
         void processDdl(Scn scn, Seq sequence, time_t timestamp, const RedoLogRecord* redoLogRecord1);
+        void compactFlush();
         virtual void initialize();
         virtual void processCommit(Scn scn, Seq sequence, time_t timestamp) = 0;
+        virtual void processRollback(Scn scn, Seq sequence, time_t timestamp) = 0;
         virtual void processCheckpoint(Scn scn, Seq sequence, time_t timestamp, FileOffset fileOffset, bool redo) = 0;
-        void releaseBuffers(Thread* t, uint64_t maxId);
+        uint registerWriter();
+        [[nodiscard]] uint64_t getWriters() const {
+            return writerReleaseIds.size();
+        }
+        uint64_t releaseBuffers(Thread* t, uint writer, uint64_t maxId, const std::map<uint64_t, uint64_t>& pinned);
         void releaseDdl();
         void appendDdlChunk(const uint8_t* data, typeTransactionSize size);
-        void sleepForWriterWork(Thread* t, uint64_t queueSize, uint64_t nanoseconds);
+        void sleepForWriterWork(Thread* t, uint64_t queueSize, uint64_t nanoseconds, const BuilderQueue* queue,
+                                uint64_t position);
         void wakeUp();
+        void waitForCredit(Thread* t);
 
         void flush() {
             {
-                ctx->parserThread->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::BUILDER_COMMIT);
+                buildThread()->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::BUILDER_COMMIT);
                 std::unique_lock<std::mutex> const lck(mtx);
                 condNoWriterWork.notify_all();
             }
-            ctx->parserThread->contextSet(Thread::CONTEXT::TRAN, Thread::REASON::TRAN);
+            buildThread()->contextSet(Thread::CONTEXT::TRAN, Thread::REASON::TRAN);
             unconfirmedSize = 0;
         }
 
 
         friend class SystemTransaction;
+        friend class BuilderBench;
     };
 }
 
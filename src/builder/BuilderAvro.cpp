@@ -0,0 +1,674 @@
+/* Class to build Avro binary output
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <cerrno>
+#include <cinttypes>
+#include <cstdlib>
+#include <sstream>
+#include <unordered_set>
+
+#include "../common/types/Data.h"
+#include "../common/types/RowId.h"
+#include "../metadata/Metadata.h"
+#include "../metadata/Schema.h"
+#include "BuilderAvro.h"
+
+namespace OpenLogReplicator {
+    // Schemas are given in the Parsing Canonical Form, the fingerprint is computed over the text as it is
+    const char* BuilderAvro::CONTROL_SCHEMA =
+            R"({"name":"OpenLogReplicator.Control","type":"record","fields":[{"name":"op","type":"string"},{"name":"scn","type":"long"},)"
+            R"({"name":"tm","type":"long"},{"name":"c_scn","type":"long"},{"name":"c_idx","type":"long"},{"name":"xid","type":"string"},)"
+            R"({"name":"obj","type":"long"},{"name":"owner","type":["null","string"]},{"name":"table","type":["null","string"]},)"
+            R"({"name":"text","type":["null","string"]},{"name":"fingerprint","type":["null","long"]},{"name":"seq","type":["null","long"]},)"
+            R"({"name":"offset","type":["null","long"]}]})";
+
+    const char* BuilderAvro::RAW_SCHEMA =
+            R"({"name":"OpenLogReplicator.Raw","type":"record","fields":[{"name":"op","type":"string"},{"name":"scn","type":"long"},)"
+            R"({"name":"tm","type":"long"},{"name":"c_scn","type":"long"},{"name":"c_idx","type":"long"},{"name":"xid","type":"string"},)"
+            R"({"name":"obj","type":"long"},{"name":"rid","type":["null","string"]},{"name":"before","type":["null",{"type":"map","values":"bytes"}]},)"
+            R"({"name":"after","type":["null",{"type":"map","values":"bytes"}]}]})";
+
+    BuilderAvro::BuilderAvro(Ctx* newCtx, Locales* newLocales, Metadata* newMetadata, Format& newFormat, uint64_t newFlushBuffer) :
+            Builder(newCtx, newLocales, newMetadata, newFormat, newFlushBuffer) {
+        for (uint64_t i = 0; i < 256; ++i) {
+            uint64_t value = i;
+            for (uint j = 0; j < 8; ++j)
+                value = (value >> 1) ^ (FINGERPRINT_EMPTY & (0 - (value & 1)));
+            fingerprintTable[i] = value;
+        }
+        controlFingerprint = fingerprint(CONTROL_SCHEMA);
+        rawFingerprint = fingerprint(RAW_SCHEMA);
+    }
+
+    BuilderAvro::~BuilderAvro() {
+        for (auto& [version, schema]: avroSchemas)
+            delete schema;
+        avroSchemas.clear();
+    }
+
+    // CRC-64-AVRO (Rabin) of the schema text
+    uint64_t BuilderAvro::fingerprint(const std::string& text) const {
+        uint64_t value = FINGERPRINT_EMPTY;
+        for (const char character: text)
+            value = (value >> 8) ^ fingerprintTable[(value ^ static_cast<uint8_t>(character)) & 0xFF];
+        return value;
+    }
+
+    std::string BuilderAvro::avroName(const std::string& name) {
+        std::string result(name);
+        for (char& character: result) {
+            if ((character < 'a' || character > 'z') && (character < 'A' || character > 'Z') && (character < '0' || character > '9'))
+                character = '_';
+        }
+        if (result.empty() || (result[0] >= '0' && result[0] <= '9'))
+            result.insert(0, 1, '_');
+        return result;
+    }
+
+    bool BuilderAvro::parseLong(const char* text, uint64_t size, int64_t& value) {
+        char buffer[24];
+        if (size == 0 || size >= sizeof(buffer))
+            return false;
+        memcpy(buffer, text, size);
+        buffer[size] = 0;
+
+        char* end = nullptr;
+        errno = 0;
+        value = strtoll(buffer, &end, 10);
+        return end == buffer + size && errno == 0;
+    }
+
+    bool BuilderAvro::encodeDecimal(const char* text, uint64_t size, int scale, uint8_t* out, uint64_t& outSize) {
+        // 38 digits need 127 bits, one more byte holds the sign
+        uint8_t magnitude[17]{};
+        bool negative = false;
+        bool fraction = false;
+        int fractionDigits = 0;
+        uint64_t digits = 0;
+        uint64_t pos = 0;
+
+        const auto addDigit = [&magnitude](uint digit) {
+            uint carry = digit;
+            for (int i = 16; i >= 0; --i) {
+                const uint value = (magnitude[i] * 10) + carry;
+                magnitude[i] = static_cast<uint8_t>(value & 0xFF);
+                carry = value >> 8;
+            }
+        };
+
+        if (pos < size && text[pos] == '-') {
+            negative = true;
+            ++pos;
+        }
+        for (; pos < size; ++pos) {
+            const char character = text[pos];
+            if (character == '.' && !fraction) {
+                fraction = true;
+                continue;
+            }
+            if (character < '0' || character > '9')
+                return false;
+            if (fraction) {
+                if (fractionDigits == scale) {
+                    // Digits beyond the scale of the column are accepted only as trailing zeros
+                    if (character != '0')
+                        return false;
+                    continue;
+                }
+                ++fractionDigits;
+            }
+            if (digits > 0 || character != '0')
+                ++digits;
+            addDigit(character - '0');
+        }
+        for (; fractionDigits < scale; ++fractionDigits) {
+            if (digits > 0)
+                ++digits;
+            addDigit(0);
+        }
+        if (digits > 38)
+            return false;
+
+        if (negative) {
+            uint carry = 1;
+            for (int i = 16; i >= 0; --i) {
+                const uint value = static_cast<uint8_t>(~magnitude[i]) + carry;
+                magnitude[i] = static_cast<uint8_t>(value & 0xFF);
+                carry = value >> 8;
+            }
+        }
+
+        // Shortest form which keeps the sign bit
+        uint64_t first = 0;
+        while (first < 16 && ((magnitude[first] == 0x00 && (magnitude[first + 1] & 0x80) == 0) ||
+                              (magnitude[first] == 0xFF && (magnitude[first + 1] & 0x80) != 0)))
+            ++first;
+        outSize = 17 - first;
+        memcpy(out, magnitude + first, outSize);
+        return true;
+    }
+
+    const BuilderAvro::AvroSchema* BuilderAvro::getSchema(const DbTable* table, typeObj obj, Scn scn, Seq sequence, time_t timestamp) {
+        AvroSchema* schema;
+        const auto& it = avroSchemas.find(table->schemaVersion);
+        if (it != avroSchemas.end()) {
+            schema = it->second;
+        } else {
+            schema = new AvroSchema();
+            const std::string recordName("OpenLogReplicator." + avroName(table->owner) + "." + avroName(table->name));
+            std::string canonicalColumns;
+            std::string columns;
+            std::unordered_set<std::string> names;
+
+            for (typeCol col = 0; col < table->maxSegCol && col < static_cast<typeCol>(table->columns.size()); ++col) {
+                const DbColumn* column = table->columns[col];
+                if (column == nullptr)
+                    continue;
+                if (column->guard && !ctx->isFlagSet(Ctx::REDO_FLAGS::SHOW_GUARD_COLUMNS))
+                    continue;
+                if (column->nested && !ctx->isFlagSet(Ctx::REDO_FLAGS::SHOW_NESTED_COLUMNS))
+                    continue;
+                if (column->hidden && !ctx->isFlagSet(Ctx::REDO_FLAGS::SHOW_HIDDEN_COLUMNS))
+                    continue;
+                if (column->unused && !ctx->isFlagSet(Ctx::REDO_FLAGS::SHOW_UNUSED_COLUMNS))
+                    continue;
+
+                AVRO_TYPE type = AVRO_TYPE::STRING;
+                if (ctx->isFlagSet(Ctx::REDO_FLAGS::RAW_COLUMN_DATA)) {
+                    type = AVRO_TYPE::BYTES;
+                } else {
+                    switch (column->type) {
+                        case SysCol::COLTYPE::NUMBER:
+                            if (column->precision > 0 && column->precision <= 18 && column->scale == 0)
+                                type = AVRO_TYPE::LONG;
+                            else if (column->precision > 0 && column->precision <= 38 && column->scale >= 0 && column->scale <= column->precision)
+                                type = AVRO_TYPE::DECIMAL;
+                            break;
+
+                        case SysCol::COLTYPE::FLOAT:
+                            type = AVRO_TYPE::FLOAT;
+                            break;
+
+                        case SysCol::COLTYPE::DOUBLE:
+                            type = AVRO_TYPE::DOUBLE;
+                            break;
+
+                        case SysCol::COLTYPE::BOOLEAN:
+                            type = AVRO_TYPE::BOOLEAN;
+                            break;
+
+                        case SysCol::COLTYPE::DATE:
+                        case SysCol::COLTYPE::TIMESTAMP:
+                            type = AVRO_TYPE::TIMESTAMP;
+                            break;
+
+                        case SysCol::COLTYPE::RAW:
+                        case SysCol::COLTYPE::LONG_RAW:
+                        case SysCol::COLTYPE::BLOB:
+                            type = AVRO_TYPE::BYTES;
+                            break;
+
+                        default:
+                            break;
+                    }
+                }
+
+                std::string name(avroName(column->name));
+                if (!names.insert(name).second) {
+                    name += "_" + std::to_string(col);
+                    names.insert(name);
+                }
+
+                if (!schema->columns.empty()) {
+                    canonicalColumns.push_back(',');
+                    columns.push_back(',');
+                }
+                canonicalColumns.append(R"({"name":")" + name + R"(","type":)");
+                columns.append(R"({"name":")" + name + R"(","type":)");
+                switch (type) {
+                    case AVRO_TYPE::STRING:
+                        canonicalColumns.append(R"(["null","string"])");
+                        columns.append(R"(["null","string"])");
+                        break;
+
+                    case AVRO_TYPE::BYTES:
+                        canonicalColumns.append(R"(["null","bytes","string"])");
+                        columns.append(R"(["null","bytes","string"])");
+                        break;
+
+                    case AVRO_TYPE::LONG:
+                        canonicalColumns.append(R"(["null","long","string"])");
+                        columns.append(R"(["null","long","string"])");
+                        break;
+
+                    case AVRO_TYPE::DECIMAL:
+                        canonicalColumns.append(R"(["null","bytes","string"])");
+                        columns.append(R"(["null",{"type":"bytes","logicalType":"decimal","precision":)" + std::to_string(column->precision) +
+                                       R"(,"scale":)" + std::to_string(column->scale) + R"(},"string"])");
+                        break;
+
+                    case AVRO_TYPE::FLOAT:
+                        canonicalColumns.append(R"(["null","float","string"])");
+                        columns.append(R"(["null","float","string"])");
+                        break;
+
+                    case AVRO_TYPE::DOUBLE:
+                        canonicalColumns.append(R"(["null","double","string"])");
+                        columns.append(R"(["null","double","string"])");
+                        break;
+
+                    case AVRO_TYPE::BOOLEAN:
+                        canonicalColumns.append(R"(["null","boolean","string"])");
+                        columns.append(R"(["null","boolean","string"])");
+                        break;
+
+                    case AVRO_TYPE::TIMESTAMP:
+                        canonicalColumns.append(R"(["null","long","string"])");
+                        columns.append(R"(["null",{"type":"long","logicalType":"timestamp-micros"},"string"])");
+                        break;
+                }
+                canonicalColumns.push_back('}');
+                columns.push_back('}');
+                schema->columns.push_back(AvroColumn{col, type, column->scale});
+            }
+
+            const std::string header(R"({"name":")" + recordName + R"(","type":"record","fields":[{"name":"op","type":"string"},)"
+                                     R"({"name":"scn","type":"long"},{"name":"tm","type":"long"},{"name":"c_scn","type":"long"},)"
+                                     R"({"name":"c_idx","type":"long"},{"name":"xid","type":"string"},{"name":"obj","type":"long"},)"
+                                     R"({"name":"rid","type":["null","string"]},{"name":"before","type":["null",{"name":")" + recordName +
+                                     R"(.Row","type":"record","fields":[)");
+            const std::string footer(R"(]}]},{"name":"after","type":["null",")" + recordName + R"(.Row"]}]})");
+            schema->fingerprint = fingerprint(header + canonicalColumns + footer);
+            schema->text = header + columns + footer;
+            avroSchemas.insert_or_assign(table->schemaVersion, schema);
+        }
+
+        // Announced once, the consumer keeps the schema by its fingerprint
+        if (schemaVersions.insert(table->schemaVersion).second) {
+            builderBegin(scn, sequence, obj, BuilderMsg::OUTPUT_BUFFER::NONE);
+            appendControl("schema", scn, timestamp, table, obj, &schema->text, schema->fingerprint, false, sequence, FileOffset());
+            builderCommit();
+        }
+        return schema;
+    }
+
+    void BuilderAvro::appendControl(const char* op, Scn scn, time_t timestamp, const DbTable* table, typeObj obj, const std::string* text,
+                                    uint64_t schemaFingerprint, bool position, Seq sequence, FileOffset fileOffset) {
+        appendMarker(controlFingerprint);
+        appendAvroBytes(op, strlen(op));
+        appendAvroLong(static_cast<int64_t>(scn.getData()));
+        appendAvroLong(timestamp);
+        appendAvroLong(static_cast<int64_t>(lwnScn.getData()));
+        appendAvroLong(static_cast<int64_t>(lwnIdx));
+        appendAvroString(lastXid.toString());
+        appendAvroLong(obj);
+
+        if (table != nullptr) {
+            appendAvroLong(1);
+            appendAvroString(table->owner);
+            appendAvroLong(1);
+            appendAvroString(table->name);
+        } else {
+            appendAvroLong(0);
+            appendAvroLong(0);
+        }
+
+        if (text != nullptr) {
+            appendAvroLong(1);
+            appendAvroString(*text);
+        } else
+            appendAvroLong(0);
+
+        if (schemaFingerprint != 0) {
+            appendAvroLong(1);
+            appendAvroLong(static_cast<int64_t>(schemaFingerprint));
+        } else
+            appendAvroLong(0);
+
+        if (position) {
+            appendAvroLong(1);
+            appendAvroLong(static_cast<int64_t>(sequence.getData()));
+            appendAvroLong(1);
+            appendAvroLong(static_cast<int64_t>(fileOffset.getData()));
+        } else {
+            appendAvroLong(0);
+            appendAvroLong(0);
+        }
+    }
+
+    void BuilderAvro::appendRowHeader(uint64_t schemaFingerprint, const char* op, Scn scn, time_t timestamp, typeObj obj, const DbTable* table,
+                                      typeDataObj dataObj, typeDba bdba, typeSlot slot) {
+        appendMarker(schemaFingerprint);
+        appendAvroBytes(op, 1);
+        appendAvroLong(static_cast<int64_t>(scn.getData()));
+        appendAvroLong(timestamp);
+        appendAvroLong(static_cast<int64_t>(lwnScn.getData()));
+        appendAvroLong(static_cast<int64_t>(lwnIdx));
+        appendAvroString(lastXid.toString());
+        appendAvroLong(table != nullptr ? table->obj : obj);
+
+        if (format.ridFormat == Format::RID_FORMAT::TEXT) {
+            const RowId rowId(dataObj, bdba, slot);
+            char str[RowId::SIZE + 1];
+            rowId.toString(str);
+            appendAvroLong(1);
+            appendAvroBytes(str, RowId::SIZE);
+        } else
+            appendAvroLong(0);
+    }
+
+    void BuilderAvro::appendImage(LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table, const AvroSchema* schema, Format::VALUE_TYPE valueType,
+                                  FileOffset fileOffset) {
+        const uint image = static_cast<uint>(valueType);
+        const bool after = valueType == Format::VALUE_TYPE::AFTER;
+        const bool compressed = after ? compressedAfter : compressedBefore;
+
+        if (schema == nullptr) {
+            avroMap = true;
+            const typeCol baseMax = valuesMax >> 6;
+            for (typeCol base = 0; base <= baseMax; ++base) {
+                const auto columnBase = static_cast<typeCol>(base << 6);
+                typeMask set = valuesSet[base];
+                while (set != 0) {
+                    const typeCol pos = ffsll(set) - 1;
+                    set &= ~(1ULL << pos);
+                    const typeCol column = columnBase + pos;
+                    if (values[column][image] != nullptr && sizes[column][image] > 0)
+                        processValue(lobCtx, xmlCtx, table, column, values[column][image], static_cast<uint32_t>(sizes[column][image]), fileOffset,
+                                     after, compressed);
+                }
+            }
+            avroMap = false;
+            appendAvroLong(0);
+            return;
+        }
+
+        // Every field of the record is written, a column with no value in the redo is null
+        for (const AvroColumn& column: schema->columns) {
+            avroColumn = &column;
+            avroWritten = false;
+            if (values[column.col][image] != nullptr && sizes[column.col][image] > 0)
+                processValue(lobCtx, xmlCtx, table, column.col, values[column.col][image], static_cast<uint32_t>(sizes[column.col][image]), fileOffset,
+                             after, compressed);
+            if (!avroWritten)
+                appendAvroLong(0);
+        }
+        avroColumn = nullptr;
+    }
+
+    void BuilderAvro::processRow(const char* op, Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table,
+                                 typeObj obj, typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset, bool before, bool after) {
+        if (newTran)
+            processBeginMessage(scn, sequence, timestamp);
+
+        const AvroSchema* schema = nullptr;
+        uint64_t schemaFingerprint = rawFingerprint;
+        if (table != nullptr) {
+            schema = getSchema(table, obj, scn, sequence, timestamp);
+            schemaFingerprint = schema->fingerprint;
+        }
+
+        builderBegin(scn, sequence, obj, BuilderMsg::OUTPUT_BUFFER::NONE);
+        messageOp(before ? (after ? BuilderMsg::OP::UPDATE : BuilderMsg::OP::DELETE) : BuilderMsg::OP::INSERT);
+        appendRowHeader(schemaFingerprint, op, scn, timestamp, obj, table, dataObj, bdba, slot);
+        if (before) {
+            appendAvroLong(1);
+            appendImage(lobCtx, xmlCtx, table, schema, Format::VALUE_TYPE::BEFORE, fileOffset);
+        } else
+            appendAvroLong(0);
+        if (after) {
+            appendAvroLong(1);
+            appendImage(lobCtx, xmlCtx, table, schema, Format::VALUE_TYPE::AFTER, fileOffset);
+        } else
+            appendAvroLong(0);
+        builderCommit();
+        ++num;
+    }
+
+    void BuilderAvro::columnFloat(const std::string& columnName __attribute__((unused)), double value) {
+        if (!valueStart())
+            return;
+
+        if (avroColumn->type == AVRO_TYPE::FLOAT) {
+            appendAvroLong(1);
+            appendAvroFloat(static_cast<float>(value));
+        } else if (avroColumn->type == AVRO_TYPE::DOUBLE) {
+            appendAvroLong(1);
+            appendAvroDouble(value);
+        } else {
+            std::ostringstream ss;
+            ss << value;
+            const std::string text(ss.str());
+            valueText(text.c_str(), text.length());
+        }
+    }
+
+    void BuilderAvro::columnDouble(const std::string& columnName __attribute__((unused)), long double value) {
+        if (!valueStart())
+            return;
+
+        if (avroColumn->type == AVRO_TYPE::DOUBLE) {
+            appendAvroLong(1);
+            appendAvroDouble(static_cast<double>(value));
+        } else if (avroColumn->type == AVRO_TYPE::FLOAT) {
+            appendAvroLong(1);
+            appendAvroFloat(static_cast<float>(value));
+        } else {
+            std::ostringstream ss;
+            ss << value;
+            const std::string text(ss.str());
+            valueText(text.c_str(), text.length());
+        }
+    }
+
+    void BuilderAvro::columnString(const std::string& columnName __attribute__((unused))) {
+        if (!valueStart())
+            return;
+
+        valueText(valueBuffer, valueSize);
+    }
+
+    void BuilderAvro::columnNumber(const std::string& columnName __attribute__((unused)), int precision __attribute__((unused)),
+                                   int scale __attribute__((unused))) {
+        if (!valueStart())
+            return;
+
+        switch (avroColumn->type) {
+            case AVRO_TYPE::LONG: {
+                int64_t value;
+                if (parseLong(valueBuffer, valueSize, value)) {
+                    appendAvroLong(1);
+                    appendAvroLong(value);
+                    return;
+                }
+                break;
+            }
+
+            case AVRO_TYPE::DECIMAL: {
+                uint8_t decimal[17];
+                uint64_t decimalSize;
+                if (encodeDecimal(valueBuffer, valueSize, avroColumn->scale, decimal, decimalSize)) {
+                    appendAvroLong(1);
+                    appendAvroBytes(reinterpret_cast<const char*>(decimal), decimalSize);
+                    return;
+                }
+                break;
+            }
+
+            case AVRO_TYPE::BOOLEAN:
+                appendAvroLong(1);
+                append(static_cast<char>(valueSize == 1 && valueBuffer[0] == '0' ? 0 : 1));
+                return;
+
+            default:
+                break;
+        }
+        valueText(valueBuffer, valueSize);
+    }
+
+    void BuilderAvro::columnRaw(const std::string& columnName, const uint8_t* data, uint64_t size) {
+        if (avroMap) {
+            appendAvroLong(1);
+            appendAvroString(columnName);
+            appendAvroBytes(reinterpret_cast<const char*>(data), size);
+            return;
+        }
+        if (!valueStart())
+            return;
+
+        if (avroColumn->type == AVRO_TYPE::BYTES) {
+            appendAvroLong(1);
+            appendAvroBytes(reinterpret_cast<const char*>(data), size);
+            return;
+        }
+        std::string text(size * 2, '0');
+        Data::hexEncode(data, size, text.data());
+        valueText(text.c_str(), text.length());
+    }
+
+    void BuilderAvro::columnRowId(const std::string& columnName __attribute__((unused)), RowId rowId) {
+        if (!valueStart())
+            return;
+
+        char str[RowId::SIZE + 1];
+        rowId.toHex(str);
+        valueText(str, 18);
+    }
+
+    void BuilderAvro::columnTimestamp(const std::string& columnName __attribute__((unused)), time_t timestamp, uint64_t fraction) {
+        if (!valueStart())
+            return;
+
+        if (avroColumn->type == AVRO_TYPE::TIMESTAMP) {
+            appendAvroLong(1);
+            appendAvroLong((timestamp * 1000000L) + static_cast<int64_t>(fraction / 1000));
+            return;
+        }
+
+        char buffer[48];
+        uint64_t length = epochToIso8601(timestamp, buffer, true, false);
+        length += snprintf(buffer + length, sizeof(buffer) - length, ".%09" PRIu64 "Z", fraction);
+        valueText(buffer, length);
+    }
+
+    void BuilderAvro::columnTimestampTz(const std::string& columnName __attribute__((unused)), time_t timestamp, uint64_t fraction,
+                                        const std::string_view& tz) {
+        if (!valueStart())
+            return;
+
+        char buffer[48];
+        uint64_t length = epochToIso8601(timestamp, buffer, true, false);
+        length += snprintf(buffer + length, sizeof(buffer) - length, ".%09" PRIu64 " ", fraction);
+        std::string text(buffer, length);
+        text.append(tz);
+        valueText(text.c_str(), text.length());
+    }
+
+    void BuilderAvro::processBeginMessage(Scn scn, Seq sequence, time_t timestamp) {
+        newTran = false;
+
+        if (format.isMessageFormatSkipBegin())
+            return;
+
+        builderBegin(scn, sequence, 0, BuilderMsg::OUTPUT_BUFFER::NONE);
+        messageOp(BuilderMsg::OP::BEGIN);
+        appendControl("begin", scn, timestamp, nullptr, 0, nullptr, 0, false, sequence, FileOffset());
+        builderCommit();
+    }
+
+    void BuilderAvro::processCommit(Scn scn, Seq sequence, time_t timestamp) {
+        // Skip empty transaction
+        if (newTran) {
+            if (!provisionalCommit) {
+                newTran = false;
+                return;
+            }
+            // No rows left after the provisional ones, the commit is sent anyway
+            processBeginMessage(scn, sequence, timestamp);
+        }
+
+        if (!format.isMessageFormatSkipCommit()) {
+            builderBegin(scn, sequence, 0, BuilderMsg::OUTPUT_BUFFER::NONE);
+            messageOp(BuilderMsg::OP::COMMIT);
+            appendControl(provisional ? "provisional" : "commit", scn, timestamp, nullptr, 0, nullptr, 0, false, sequence, FileOffset());
+            builderCommit();
+        }
+        num = 0;
+    }
+
+    // Rows sent before as provisional are discarded by the consumer
+    void BuilderAvro::processRollback(Scn scn, Seq sequence, time_t timestamp) {
+        newTran = false;
+
+        builderBegin(scn, sequence, 0, BuilderMsg::OUTPUT_BUFFER::NONE);
+        messageOp(BuilderMsg::OP::ROLLBACK);
+        appendControl("rollback", scn, timestamp, nullptr, 0, nullptr, 0, false, sequence, FileOffset());
+        builderCommit();
+        num = 0;
+    }
+
+    void BuilderAvro::processInsert(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table,
+                                    typeObj obj, typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset) {
+        processRow("c", scn, sequence, timestamp, lobCtx, xmlCtx, table, obj, dataObj, bdba, slot, fileOffset, false, true);
+    }
+
+    void BuilderAvro::processUpdate(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table,
+                                    typeObj obj, typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset) {
+        processRow("u", scn, sequence, timestamp, lobCtx, xmlCtx, table, obj, dataObj, bdba, slot, fileOffset, true, true);
+    }
+
+    void BuilderAvro::processDelete(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table,
+                                    typeObj obj, typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset) {
+        processRow("d", scn, sequence, timestamp, lobCtx, xmlCtx, table, obj, dataObj, bdba, slot, fileOffset, true, false);
+    }
+
+    void BuilderAvro::processDdl(Scn scn, Seq sequence, time_t timestamp, const DbTable* table, typeObj obj) {
+        if (newTran)
+            processBeginMessage(scn, sequence, timestamp);
+
+        std::string sql;
+        uint8_t* chunk = ddlFirst;
+        while (chunk != nullptr) {
+            uint8_t* chunkNext = *reinterpret_cast<uint8_t**>(chunk);
+            const typeTransactionSize* chunkSize = reinterpret_cast<typeTransactionSize*>(chunk + sizeof(uint8_t*));
+            sql.append(reinterpret_cast<const char*>(chunk + sizeof(uint8_t*) + sizeof(uint64_t)), *chunkSize);
+            chunk = chunkNext;
+        }
+
+        builderBegin(scn, sequence, obj, BuilderMsg::OUTPUT_BUFFER::NONE);
+        messageOp(BuilderMsg::OP::DDL);
+        appendControl("ddl", scn, timestamp, table, obj, &sql, 0, false, sequence, FileOffset());
+        builderCommit();
+        ++num;
+    }
+
+    void BuilderAvro::processCheckpoint(Scn scn, Seq sequence, time_t timestamp, FileOffset fileOffset, bool redo) {
+        if (lwnScn != scn) {
+            lwnScn = scn;
+            lwnIdx = 0;
+        }
+
+        BuilderMsg::OUTPUT_BUFFER flags = BuilderMsg::OUTPUT_BUFFER::CHECKPOINT;
+        if (redo)
+            flags = static_cast<BuilderMsg::OUTPUT_BUFFER>(static_cast<uint>(flags) | static_cast<uint>(BuilderMsg::OUTPUT_BUFFER::REDO));
+        builderBegin(scn, sequence, 0, flags);
+        appendControl(redo ? "chkpt-redo" : "chkpt", scn, timestamp, nullptr, 0, nullptr, 0, true, sequence, fileOffset);
+        builderCommit();
+    }
+}
@@ -0,0 +1,177 @@
+/* Header for BuilderAvro class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef BUILDER_AVRO_H_
+#define BUILDER_AVRO_H_
+
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include "Builder.h"
+#include "../common/DbColumn.h"
+#include "../common/DbTable.h"
+
+namespace OpenLogReplicator {
+    // Avro binary messages in the single-object encoding: the C3 01 marker, the CRC-64-AVRO fingerprint of the writer schema
+    // (little-endian) and the record. Every table layout has a record schema of its own, announced once in a "schema" control
+    // message with the schema text and its fingerprint before the first row using it. Messages without rows use the fixed
+    // control schema, see CONTROL_SCHEMA
+    class BuilderAvro final : public Builder {
+    protected:
+        enum class AVRO_TYPE : unsigned char {
+            STRING, BYTES, LONG, DECIMAL, FLOAT, DOUBLE, BOOLEAN, TIMESTAMP
+        };
+
+        struct AvroColumn {
+            typeCol col;
+            AVRO_TYPE type;
+            int scale;
+        };
+
+        struct AvroSchema {
+            uint64_t fingerprint;
+            std::vector<AvroColumn> columns;
+            std::string text;
+        };
+
+        static const char* CONTROL_SCHEMA;
+        static const char* RAW_SCHEMA;
+        static constexpr uint64_t FINGERPRINT_EMPTY{0xC15D213AA4D7A795ULL};
+
+        uint64_t fingerprintTable[256]{};
+        uint64_t controlFingerprint{0};
+        uint64_t rawFingerprint{0};
+        std::unordered_map<uint64_t, AvroSchema*> avroSchemas;
+        // Column of the value being written, values of other columns or repeated ones are not expected
+        const AvroColumn* avroColumn{nullptr};
+        bool avroWritten{false};
+        // Values of a table missing in the schema are written as a map of column name to the redo bytes
+        bool avroMap{false};
+
+        uint64_t fingerprint(const std::string& text) const;
+        static std::string avroName(const std::string& name);
+        const AvroSchema* getSchema(const DbTable* table, typeObj obj, Scn scn, Seq sequence, time_t timestamp);
+        void appendControl(const char* op, Scn scn, time_t timestamp, const DbTable* table, typeObj obj, const std::string* text, uint64_t schemaFingerprint,
+                           bool position, Seq sequence, FileOffset fileOffset);
+        void appendRowHeader(uint64_t schemaFingerprint, const char* op, Scn scn, time_t timestamp, typeObj obj, const DbTable* table, typeDataObj dataObj,
+                             typeDba bdba, typeSlot slot);
+        void appendImage(LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table, const AvroSchema* schema, Format::VALUE_TYPE valueType,
+                         FileOffset fileOffset);
+        // Unscaled value of a decimal as big-endian two's complement, false when it does not fit the column scale or 38 digits
+        static bool encodeDecimal(const char* text, uint64_t size, int scale, uint8_t* out, uint64_t& outSize);
+        static bool parseLong(const char* text, uint64_t size, int64_t& value);
+        void processRow(const char* op, Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table, typeObj obj,
+                        typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset, bool before, bool after);
+
+        void appendAvroLong(int64_t value) {
+            uint64_t zigzag = (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+            while (zigzag >= 0x80) {
+                append(static_cast<char>((zigzag & 0x7F) | 0x80));
+                zigzag >>= 7;
+            }
+            append(static_cast<char>(zigzag));
+        }
+
+        void appendAvroBytes(const char* data, uint64_t size) {
+            appendAvroLong(static_cast<int64_t>(size));
+            appendArr(data, size);
+        }
+
+        void appendAvroString(const std::string& value) {
+            appendAvroBytes(value.c_str(), value.length());
+        }
+
+        void appendAvroFixed64(uint64_t value) {
+            for (uint i = 0; i < 8; ++i) {
+                append(static_cast<char>(value & 0xFF));
+                value >>= 8;
+            }
+        }
+
+        void appendAvroFloat(float value) {
+            uint32_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            for (uint i = 0; i < 4; ++i) {
+                append(static_cast<char>(bits & 0xFF));
+                bits >>= 8;
+            }
+        }
+
+        void appendAvroDouble(double value) {
+            uint64_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            appendAvroFixed64(bits);
+        }
+
+        void appendMarker(uint64_t schemaFingerprint) {
+            append(static_cast<char>(0xC3));
+            append(static_cast<char>(0x01));
+            appendAvroFixed64(schemaFingerprint);
+        }
+
+        // Union of the column is [null, type, string], a value of another type is written as text
+        [[nodiscard]] uint64_t stringBranch() const {
+            return avroColumn->type == AVRO_TYPE::STRING ? 1 : 2;
+        }
+
+        bool valueStart() {
+            if (avroColumn == nullptr || avroWritten)
+                return false;
+            avroWritten = true;
+            return true;
+        }
+
+        void valueText(const char* text, uint64_t size) {
+            appendAvroLong(static_cast<int64_t>(stringBranch()));
+            appendAvroBytes(text, size);
+        }
+
+        void columnFloat(const std::string& columnName, double value) override;
+        void columnDouble(const std::string& columnName, long double value) override;
+        void columnString(const std::string& columnName) override;
+        void columnNumber(const std::string& columnName, int precision, int scale) override;
+        void columnRaw(const std::string& columnName, const uint8_t* data, uint64_t size) override;
+        void columnRowId(const std::string& columnName, RowId rowId) override;
+        void columnTimestamp(const std::string& columnName, time_t timestamp, uint64_t fraction) override;
+        void columnTimestampTz(const std::string& columnName, time_t timestamp, uint64_t fraction, const std::string_view& tz) override;
+        void processInsert(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table, typeObj obj,
+                           typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset) override;
+        void processUpdate(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table, typeObj obj,
+                           typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset) override;
+        void processDelete(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table, typeObj obj,
+                           typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset) override;
+        void processDdl(Scn scn, Seq sequence, time_t timestamp, const DbTable* table, typeObj obj) override;
+        void processBeginMessage(Scn scn, Seq sequence, time_t timestamp) override;
+
+    public:
+        BuilderAvro(Ctx* newCtx, Locales* newLocales, Metadata* newMetadata, Format& newFormat, uint64_t newFlushBuffer);
+        ~BuilderAvro() override;
+
+        void processCommit(Scn scn, Seq sequence, time_t timestamp) override;
+        void processRollback(Scn scn, Seq sequence, time_t timestamp) override;
+        void processCheckpoint(Scn scn, Seq sequence, time_t timestamp, FileOffset fileOffset, bool redo) override;
+
+        [[nodiscard]] bool isAvro() const override {
+            return true;
+        }
+    };
+}
+
+#endif
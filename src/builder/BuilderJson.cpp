@@ -28,15 +28,37 @@ namespace OpenLogReplicator {
             Builder(newCtx, newLocales, newMetadata, newFormat, newFlushBuffer) {
     }
 
+    void BuilderJson::initialize() {
+        Builder::initialize();
+        selectFormatSpec();
+    }
+
+    // The most common formats get an instance with the options bound at compile time, any other format uses the generic one
+    void BuilderJson::selectFormatSpec() {
+        using SpecDefault = BuilderJsonSpec<Format::MESSAGE_FORMAT::DEFAULT, Format::RID_FORMAT::SKIP, Format::COLUMN_FORMAT::CHANGED>;
+        using SpecFull = BuilderJsonSpec<Format::MESSAGE_FORMAT::FULL, Format::RID_FORMAT::SKIP, Format::COLUMN_FORMAT::CHANGED>;
+        using SpecRid = BuilderJsonSpec<Format::MESSAGE_FORMAT::DEFAULT, Format::RID_FORMAT::TEXT, Format::COLUMN_FORMAT::CHANGED>;
+        using SpecFullUpd = BuilderJsonSpec<Format::MESSAGE_FORMAT::DEFAULT, Format::RID_FORMAT::SKIP, Format::COLUMN_FORMAT::FULL_UPD>;
+
+        if (SpecDefault::matches(format))
+            useFormatSpec<SpecDefault>();
+        else if (SpecFull::matches(format))
+            useFormatSpec<SpecFull>();
+        else if (SpecRid::matches(format))
+            useFormatSpec<SpecRid>();
+        else if (SpecFullUpd::matches(format))
+            useFormatSpec<SpecFullUpd>();
+        else
+            useFormatSpec<BuilderJsonGeneric>();
+    }
+
     void BuilderJson::columnFloat(const std::string& columnName, double value) {
         if (hasPreviousColumn)
             append(',');
         else
             hasPreviousColumn = true;
 
-        append('"');
-        appendEscape(columnName);
-        append(std::string_view(R"(":)"));
+        appendColumnName(columnName);
 
         std::ostringstream ss;
         ss << value;
@@ -49,9 +71,7 @@ namespace OpenLogReplicator {
         else
             hasPreviousColumn = true;
 
-        append('"');
-        appendEscape(columnName);
-        append(std::string_view(R"(":)"));
+        appendColumnName(columnName);
 
         std::ostringstream ss;
         ss << value;
@@ -64,9 +84,8 @@ namespace OpenLogReplicator {
         else
             hasPreviousColumn = true;
 
+        appendColumnName(columnName);
         append('"');
-        appendEscape(columnName);
-        append(std::string_view(R"(":")"));
         appendEscape(valueBuffer, valueSize);
         append('"');
     }
@@ -77,9 +96,41 @@ namespace OpenLogReplicator {
         else
             hasPreviousColumn = true;
 
-        append('"');
-        appendEscape(columnName);
-        append(std::string_view(R"(":)"));
+        appendColumnName(columnName);
+        appendArr(valueBuffer, valueSize);
+    }
+
+    // NUMBER text needs no escaping, when its longest form fits it is rendered straight into the output buffer instead of the value buffer
+    void BuilderJson::columnNumberData(const std::string& columnName, int precision, int scale, const uint8_t* data, uint64_t size, FileOffset fileOffset) {
+        if (unlikely(lastBuilderSize + messagePosition + numberMaxLength(size) + columnName.size() * 6 + 8 >= outputBufferDataSize)) {
+            Builder::columnNumberData(columnName, precision, scale, data, size, fileOffset);
+            return;
+        }
+
+        if (hasPreviousColumn)
+            append<true>(',');
+        else
+            hasPreviousColumn = true;
+
+        appendColumnName<true>(columnName);
+        char* ptr = reinterpret_cast<char*>(lastBuilderQueue->data + lastBuilderSize + messagePosition);
+        messagePosition += numberToChars(data, size, ptr, fileOffset);
+        ctx->assertDebug(lastBuilderSize + messagePosition < outputBufferDataSize);
+    }
+
+    // Decoded OSON is valid JSON and is written as a nested value, an image which can't be decoded is written as raw data
+    void BuilderJson::columnJson(const std::string& columnName, const uint8_t* data, uint64_t size, FileOffset fileOffset) {
+        if (!parseOson(data, size, fileOffset)) {
+            columnRaw(columnName, data, size);
+            return;
+        }
+
+        if (hasPreviousColumn)
+            append(',');
+        else
+            hasPreviousColumn = true;
+
+        appendColumnName(columnName);
         appendArr(valueBuffer, valueSize);
     }
 
@@ -89,9 +140,18 @@ namespace OpenLogReplicator {
         else
             hasPreviousColumn = true;
 
+        // Fixed length, written in place when the output buffer has room for it and its terminator
+        if (likely(lastBuilderSize + messagePosition + columnName.size() * 6 + RowId::SIZE + 8 < outputBufferDataSize)) {
+            appendColumnName<true>(columnName);
+            append<true>('"');
+            rowId.toHex(reinterpret_cast<char*>(lastBuilderQueue->data + lastBuilderSize + messagePosition));
+            messagePosition += RowId::SIZE;
+            append<true>('"');
+            return;
+        }
+
+        appendColumnName(columnName);
         append('"');
-        appendEscape(columnName);
-        append(std::string_view(R"(":")"));
         char str[RowId::SIZE + 1];
         rowId.toHex(str);
         appendArr(str, 18);
@@ -99,17 +159,23 @@ namespace OpenLogReplicator {
     }
 
     void BuilderJson::columnRaw(const std::string& columnName, const uint8_t* data, uint64_t size) {
-        if (likely(lastBuilderSize + messagePosition + size * 2 + columnName.size() * 3 + 8 < OUTPUT_BUFFER_DATA_SIZE)) {
+        const bool base64 = format.rawFormat == Format::RAW_FORMAT::BASE64;
+        const uint64_t encodedSize = base64 ? Data::base64Size(size) : size * 2;
+
+        if (likely(lastBuilderSize + messagePosition + encodedSize + columnName.size() * 6 + 8 < outputBufferDataSize)) {
             if (hasPreviousColumn)
                 append<true>(',');
             else
                 hasPreviousColumn = true;
 
+            appendColumnName<true>(columnName);
             append<true>('"');
-            appendEscape<true>(columnName);
-            append<true>(std::string_view(R"(":")"));
-            for (uint64_t j = 0; j < size; ++j)
-                appendHex2<true>(*(data + j));
+            char* ptr = reinterpret_cast<char*>(lastBuilderQueue->data + lastBuilderSize + messagePosition);
+            if (base64)
+                Data::base64Encode(data, size, ptr);
+            else
+                Data::hexEncode(data, size, ptr);
+            messagePosition += encodedSize;
             append<true>('"');
         } else {
             if (hasPreviousColumn)
@@ -117,24 +183,91 @@ namespace OpenLogReplicator {
             else
                 hasPreviousColumn = true;
 
+            appendColumnName(columnName);
             append('"');
-            appendEscape(columnName);
-            append(std::string_view(R"(":")"));
-            for (uint64_t j = 0; j < size; ++j)
-                appendHex2(*(data + j));
+            // Encode in pieces, base64 needs whole groups of 3 bytes
+            char buffer[RAW_ENCODE_CHUNK * 2];
+            while (size > 0) {
+                const uint64_t chunk = std::min(size, RAW_ENCODE_CHUNK);
+                if (base64) {
+                    Data::base64Encode(data, chunk, buffer);
+                    appendArr(buffer, Data::base64Size(chunk));
+                } else {
+                    Data::hexEncode(data, chunk, buffer);
+                    appendArr(buffer, chunk * 2);
+                }
+                data += chunk;
+                size -= chunk;
+            }
             append('"');
         }
     }
 
-    void BuilderJson::columnTimestamp(const std::string& columnName, time_t timestamp, uint64_t fraction) {
+    void BuilderJson::columnStreamBegin(const std::string& columnName) {
         if (hasPreviousColumn)
             append(',');
         else
             hasPreviousColumn = true;
 
+        appendColumnName(columnName);
+        append('"');
+    }
+
+    uint64_t BuilderJson::columnStreamAppend(bool isClob, bool last) {
+        if (isClob) {
+            appendEscape(valueBuffer, valueSize);
+            return valueSize;
+        }
+
+        // Base64 groups of 3 bytes must not be split between parts
+        const bool base64 = format.rawFormat == Format::RAW_FORMAT::BASE64;
+        uint64_t size = valueSize;
+        if (base64 && !last)
+            size -= size % 3;
+
+        const auto* data = reinterpret_cast<const uint8_t*>(valueBuffer);
+        char buffer[RAW_ENCODE_CHUNK * 2];
+        uint64_t left = size;
+        while (left > 0) {
+            const uint64_t chunk = std::min(left, RAW_ENCODE_CHUNK);
+            if (base64) {
+                Data::base64Encode(data, chunk, buffer);
+                appendArr(buffer, Data::base64Size(chunk));
+            } else {
+                Data::hexEncode(data, chunk, buffer);
+                appendArr(buffer, chunk * 2);
+            }
+            data += chunk;
+            left -= chunk;
+        }
+        return size;
+    }
+
+    void BuilderJson::columnStreamEnd() {
         append('"');
-        appendEscape(columnName);
-        append(std::string_view(R"(":)"));
+    }
+
+    void BuilderJson::columnLobRef(const std::string& columnName, const std::string& hash, uint64_t size) {
+        if (hasPreviousColumn)
+            append(',');
+        else
+            hasPreviousColumn = true;
+
+        appendColumnName(columnName);
+        append(std::string_view(R"({"lob-ref":")"));
+        appendArr(hash.c_str(), hash.size());
+        append(std::string_view(R"(","length":)"));
+        appendDec(size);
+        append('}');
+    }
+
+    void BuilderJson::columnTimestamp(const std::string& columnName, time_t timestamp, uint64_t fraction) {
+        if (hasPreviousColumn)
+            append(',');
+        else
+            hasPreviousColumn = true;
+
+        appendColumnName(columnName);
         char buffer[22];
 
         switch (format.timestampFormat) {
@@ -213,7 +346,7 @@ namespace OpenLogReplicator {
             case Format::TIMESTAMP_FORMAT::ISO8601_NANO_TZ:
                 // "2024-04-05T19:34:38.123456789Z"
                 append('"');
-                appendArr(buffer, Data::epochToIso8601(timestamp, buffer, true, false));
+                appendArr(buffer, epochToIso8601(timestamp, buffer, true, false));
                 append('.');
                 appendDecN<9>(fraction);
                 append(std::string_view(R"(Z")"));
@@ -228,7 +361,7 @@ namespace OpenLogReplicator {
                     ++timestamp;
                 }
                 append('"');
-                appendArr(buffer, Data::epochToIso8601(timestamp, buffer, true, false));
+                appendArr(buffer, epochToIso8601(timestamp, buffer, true, false));
                 append('.');
                 appendDecN<6>(fraction);
                 append(std::string_view(R"(Z")"));
@@ -243,7 +376,7 @@ namespace OpenLogReplicator {
                     ++timestamp;
                 }
                 append('"');
-                appendArr(buffer, Data::epochToIso8601(timestamp, buffer, true, false));
+                appendArr(buffer, epochToIso8601(timestamp, buffer, true, false));
                 append('.');
                 appendDecN<3>(fraction);
                 append(std::string_view(R"(Z")"));
@@ -254,13 +387,13 @@ namespace OpenLogReplicator {
                 if (fraction >= 500000000)
                     ++timestamp;
                 append('"');
-                appendArr(buffer, Data::epochToIso8601(timestamp, buffer, true, false));
+                appendArr(buffer, epochToIso8601(timestamp, buffer, true, false));
                 append(std::string_view(R"(Z")"));
                 break;
             case Format::TIMESTAMP_FORMAT::ISO8601_NANO:
                 // "2024-04-05 19:34:38.123456789"
                 append('"');
-                appendArr(buffer, Data::epochToIso8601(timestamp, buffer, false, false));
+                appendArr(buffer, epochToIso8601(timestamp, buffer, false, false));
                 append('.');
                 appendDecN<9>(fraction);
                 append('"');
@@ -275,7 +408,7 @@ namespace OpenLogReplicator {
                     ++timestamp;
                 }
                 append('"');
-                appendArr(buffer, Data::epochToIso8601(timestamp, buffer, false, false));
+                appendArr(buffer, epochToIso8601(timestamp, buffer, false, false));
                 append('.');
                 appendDecN<6>(fraction);
                 append('"');
@@ -290,7 +423,7 @@ namespace OpenLogReplicator {
                     ++timestamp;
                 }
                 append('"');
-                appendArr(buffer, Data::epochToIso8601(timestamp, buffer, false, false));
+                appendArr(buffer, epochToIso8601(timestamp, buffer, false, false));
                 append('.');
                 appendDecN<3>(fraction);
                 append('"');
@@ -301,7 +434,7 @@ namespace OpenLogReplicator {
                 if (fraction >= 500000000)
                     ++timestamp;
                 append('"');
-                appendArr(buffer, Data::epochToIso8601(timestamp, buffer, false, false));
+                appendArr(buffer, epochToIso8601(timestamp, buffer, false, false));
                 append('"');
                 break;
         }
@@ -313,9 +446,7 @@ namespace OpenLogReplicator {
         else
             hasPreviousColumn = true;
 
-        append('"');
-        appendEscape(columnName);
-        append(std::string_view(R"(":)"));
+        appendColumnName(columnName);
         char buffer[22];
 
         switch (format.timestampTzFormat) {
@@ -370,7 +501,7 @@ namespace OpenLogReplicator {
             case Format::TIMESTAMP_TZ_FORMAT::ISO8601_NANO_TZ:
                 // "2024-04-05T19:34:38.123456789Z Europe/Warsaw"
                 append('"');
-                appendArr(buffer, Data::epochToIso8601(timestamp, buffer, true, false));
+                appendArr(buffer, epochToIso8601(timestamp, buffer, true, false));
                 append('.');
                 appendDecN<9>(fraction);
                 append(std::string_view("Z "));
@@ -387,7 +518,7 @@ namespace OpenLogReplicator {
                     ++timestamp;
                 }
                 append('"');
-                appendArr(buffer, Data::epochToIso8601(timestamp, buffer, true, false));
+                appendArr(buffer, epochToIso8601(timestamp, buffer, true, false));
                 append('.');
                 appendDecN<6>(fraction);
                 append(std::string_view("Z "));
@@ -404,7 +535,7 @@ namespace OpenLogReplicator {
                     ++timestamp;
                 }
                 append('"');
-                appendArr(buffer, Data::epochToIso8601(timestamp, buffer, true, false));
+                appendArr(buffer, epochToIso8601(timestamp, buffer, true, false));
                 append('.');
                 appendDecN<3>(fraction);
                 append(std::string_view("Z "));
@@ -417,7 +548,7 @@ namespace OpenLogReplicator {
                 if (fraction >= 500000000)
                     ++timestamp;
                 append('"');
-                appendArr(buffer, Data::epochToIso8601(timestamp, buffer, true, false));
+                appendArr(buffer, epochToIso8601(timestamp, buffer, true, false));
                 append(std::string_view("Z "));
                 append(tz);
                 append('"');
@@ -426,7 +557,7 @@ namespace OpenLogReplicator {
             case Format::TIMESTAMP_TZ_FORMAT::ISO8601_NANO:
                 // "2024-04-05 19:34:38.123456789,Europe/Warsaw"
                 append('"');
-                appendArr(buffer, Data::epochToIso8601(timestamp, buffer, false, false));
+                appendArr(buffer, epochToIso8601(timestamp, buffer, false, false));
                 append('.');
                 appendDecN<9>(fraction);
                 append(' ');
@@ -443,7 +574,7 @@ namespace OpenLogReplicator {
                     ++timestamp;
                 }
                 append('"');
-                appendArr(buffer, Data::epochToIso8601(timestamp, buffer, false, false));
+                appendArr(buffer, epochToIso8601(timestamp, buffer, false, false));
                 append('.');
                 appendDecN<6>(fraction);
                 append(' ');
@@ -460,7 +591,7 @@ namespace OpenLogReplicator {
                     ++timestamp;
                 }
                 append('"');
-                appendArr(buffer, Data::epochToIso8601(timestamp, buffer, false, false));
+                appendArr(buffer, epochToIso8601(timestamp, buffer, false, false));
                 append('.');
                 appendDecN<3>(fraction);
                 append(' ');
@@ -473,7 +604,7 @@ namespace OpenLogReplicator {
                 if (fraction >= 500000000)
                     ++timestamp;
                 append('"');
-                appendArr(buffer, Data::epochToIso8601(timestamp, buffer, false, false));
+                appendArr(buffer, epochToIso8601(timestamp, buffer, false, false));
                 append(' ');
                 append(tz);
                 append('"');
@@ -481,203 +612,213 @@ namespace OpenLogReplicator {
         }
     }
 
-    void BuilderJson::processBeginMessage(Scn scn, Seq sequence, time_t timestamp) {
+    template<class Spec>
+    void BuilderJson::processBeginMessageFormat(Scn scn, Seq sequence, time_t timestamp) {
+        const Format& rowFormat = formatOf<Spec>();
         newTran = false;
         hasPreviousRedo = false;
+        rowHeaderValid = false;
 
-        if (format.isMessageFormatSkipBegin())
+        if (rowFormat.isMessageFormatSkipBegin())
             return;
 
-        builderBegin(scn, sequence, 0, BuilderMsg::OUTPUT_BUFFER::NONE);
+        messageBegin(scn, sequence, 0, true, BuilderMsg::OP::BEGIN);
         append('{');
         hasPreviousValue = false;
-        appendHeader(scn, timestamp, true, format.isDbFormatAddDml(), true);
+        appendHeader<Spec>(scn, timestamp, true, rowFormat.isDbFormatAddDml(), true);
 
         if (hasPreviousValue)
             append(',');
         else
             hasPreviousValue = true;
 
-        if (format.isAttributesFormatBegin())
+        if (provisional)
+            append(std::string_view(R"("provisional":true,)"));
+
+        if (rowFormat.isAttributesFormatBegin())
             appendAttributes();
 
-        if (format.isMessageFormatFull()) {
+        if (rowFormat.isMessageFormatFull()) {
             append(std::string_view(R"("payload":)"));
         } else {
             append(std::string_view(R"("payload":{"op":"begin"}})"));
-            builderCommit();
+            messageCommit(false);
         }
     }
 
-    void BuilderJson::processCommit(Scn scn, Seq sequence, time_t timestamp) {
+    template<class Spec>
+    void BuilderJson::processCommitFormat(Scn scn, Seq sequence, time_t timestamp) {
+        const Format& rowFormat = formatOf<Spec>();
         // Skip empty transaction
         if (newTran) {
-            newTran = false;
-            return;
+            if (!provisionalCommit) {
+                newTran = false;
+                return;
+            }
+            // No rows left after the provisional ones, the commit is sent anyway
+            processBeginMessageFormat<Spec>(scn, sequence, timestamp);
+            if (rowFormat.isMessageFormatFull())
+                append(std::string_view(R"({"op":"commit"})"));
         }
 
-        if (format.isMessageFormatFull()) {
+        if (rowFormat.isMessageFormatFull()) {
             append(std::string_view("}"));
             builderCommit();
-        } else if (!format.isMessageFormatSkipCommit()) {
-            builderBegin(scn, sequence, 0, BuilderMsg::OUTPUT_BUFFER::NONE);
+        } else if (!rowFormat.isMessageFormatSkipCommit()) {
+            messageBegin(scn, sequence, 0, true, BuilderMsg::OP::COMMIT);
             append('{');
 
             hasPreviousValue = false;
-            appendHeader(scn, timestamp, false, format.isDbFormatAddDml(), true);
+            appendHeader<Spec>(scn, timestamp, false, rowFormat.isDbFormatAddDml(), true);
 
             if (hasPreviousValue)
                 append(',');
             else
                 hasPreviousValue = true;
 
-            if (format.isAttributesFormatCommit())
+            if (rowFormat.isAttributesFormatCommit())
                 appendAttributes();
 
-            append(std::string_view(R"("payload":{"op":"commit"}})"));
-            builderCommit();
+            if (provisional)
+                append(std::string_view(R"("payload":{"op":"provisional"}})"));
+            else
+                append(std::string_view(R"("payload":{"op":"commit"}})"));
+            messageCommit(false);
         }
         num = 0;
     }
 
-    void BuilderJson::processInsert(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table,
-                                    typeObj obj, typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset) {
+    // Rows sent before as provisional are discarded by the consumer
+    void BuilderJson::processRollback(Scn scn, Seq sequence, time_t timestamp) {
+        newTran = false;
+
+        messageBegin(scn, sequence, 0, true, BuilderMsg::OP::ROLLBACK);
+        append('{');
+
+        hasPreviousValue = false;
+        appendHeader(scn, timestamp, false, format.isDbFormatAddDml(), true);
+
+        if (hasPreviousValue)
+            append(',');
+        else
+            hasPreviousValue = true;
+
+        append(std::string_view(R"("payload":{"op":"rollback"}})"));
+        messageCommit(false);
+        num = 0;
+    }
+
+    template<class Spec>
+    void BuilderJson::processInsertFormat(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table,
+                                          typeObj obj, typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset) {
+        const Format& rowFormat = formatOf<Spec>();
         if (newTran)
-            processBeginMessage(scn, sequence, timestamp);
+            processBeginMessageFormat<Spec>(scn, sequence, timestamp);
 
-        if (format.isMessageFormatFull()) {
+        if (rowFormat.isMessageFormatFull()) {
             if (hasPreviousRedo)
                 append(',');
             else
                 hasPreviousRedo = true;
         } else {
-            builderBegin(scn, sequence, obj, BuilderMsg::OUTPUT_BUFFER::NONE);
+            messageBegin(scn, sequence, obj, table == nullptr || table->tagCols.empty(), BuilderMsg::OP::INSERT);
             addTagData(lobCtx, xmlCtx, table, Format::VALUE_TYPE::AFTER, fileOffset);
 
             append('{');
-            hasPreviousValue = false;
-            appendHeader(scn, timestamp, false, format.isDbFormatAddDml(), true);
-
-            if (hasPreviousValue)
-                append(',');
-            else
-                hasPreviousValue = true;
-
-            if (format.isAttributesFormatDml())
-                appendAttributes();
-
-            append(std::string_view(R"("payload":)"));
+            appendRowHeader<Spec>(scn, timestamp);
         }
 
         append(std::string_view(R"({"op":"c",)"));
-        if (format.isMessageFormatAddOffset()) {
+        if (rowFormat.isMessageFormatAddOffset()) {
             append(std::string_view(R"("offset":)"));
             appendDec(fileOffset.getData());
             append(',');
         }
         appendSchema(table, obj);
-        appendRowid(dataObj, bdba, slot);
-        appendAfter(lobCtx, xmlCtx, table, fileOffset);
+        appendRowid<Spec>(dataObj, bdba, slot);
+        appendAfter<Spec>(lobCtx, xmlCtx, table, fileOffset);
         append('}');
 
-        if (!format.isMessageFormatFull()) {
+        if (!rowFormat.isMessageFormatFull()) {
             append(std::string_view("}"));
-            builderCommit();
+            messageCommit(true);
         }
         ++num;
     }
 
-    void BuilderJson::processUpdate(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table,
-                                    typeObj obj, typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset) {
+    template<class Spec>
+    void BuilderJson::processUpdateFormat(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table,
+                                          typeObj obj, typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset) {
+        const Format& rowFormat = formatOf<Spec>();
         if (newTran)
-            processBeginMessage(scn, sequence, timestamp);
+            processBeginMessageFormat<Spec>(scn, sequence, timestamp);
 
-        if (format.isMessageFormatFull()) {
+        if (rowFormat.isMessageFormatFull()) {
             if (hasPreviousRedo)
                 append(',');
             else
                 hasPreviousRedo = true;
         } else {
-            builderBegin(scn, sequence, obj, BuilderMsg::OUTPUT_BUFFER::NONE);
+            messageBegin(scn, sequence, obj, table == nullptr || table->tagCols.empty(), BuilderMsg::OP::UPDATE);
             addTagData(lobCtx, xmlCtx, table, Format::VALUE_TYPE::AFTER, fileOffset);
 
             append('{');
-            hasPreviousValue = false;
-            appendHeader(scn, timestamp, false, format.isDbFormatAddDml(), true);
-
-            if (hasPreviousValue)
-                append(',');
-            else
-                hasPreviousValue = true;
-
-            if (format.isAttributesFormatDml())
-                appendAttributes();
-
-            append(std::string_view(R"("payload":)"));
+            appendRowHeader<Spec>(scn, timestamp);
         }
 
         append(std::string_view(R"({"op":"u",)"));
-        if (format.isMessageFormatAddOffset()) {
+        if (rowFormat.isMessageFormatAddOffset()) {
             append(std::string_view(R"("offset":)"));
             appendDec(fileOffset.getData());
             append(',');
         }
         appendSchema(table, obj);
-        appendRowid(dataObj, bdba, slot);
-        appendBefore(lobCtx, xmlCtx, table, fileOffset);
-        appendAfter(lobCtx, xmlCtx, table, fileOffset);
+        appendRowid<Spec>(dataObj, bdba, slot);
+        appendBefore<Spec>(lobCtx, xmlCtx, table, fileOffset);
+        appendAfter<Spec>(lobCtx, xmlCtx, table, fileOffset);
         append('}');
 
-        if (!format.isMessageFormatFull()) {
+        if (!rowFormat.isMessageFormatFull()) {
             append(std::string_view("}"));
-            builderCommit();
+            messageCommit(true);
         }
         ++num;
     }
 
-    void BuilderJson::processDelete(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table,
-                                    typeObj obj, typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset) {
+    template<class Spec>
+    void BuilderJson::processDeleteFormat(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table,
+                                          typeObj obj, typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset) {
+        const Format& rowFormat = formatOf<Spec>();
         if (newTran)
-            processBeginMessage(scn, sequence, timestamp);
+            processBeginMessageFormat<Spec>(scn, sequence, timestamp);
 
-        if (format.isMessageFormatFull()) {
+        if (rowFormat.isMessageFormatFull()) {
             if (hasPreviousRedo)
                 append(',');
             else
                 hasPreviousRedo = true;
         } else {
-            builderBegin(scn, sequence, obj, BuilderMsg::OUTPUT_BUFFER::NONE);
+            messageBegin(scn, sequence, obj, table == nullptr || table->tagCols.empty(), BuilderMsg::OP::DELETE);
             addTagData(lobCtx, xmlCtx, table, Format::VALUE_TYPE::BEFORE, fileOffset);
 
             append('{');
-            hasPreviousValue = false;
-            appendHeader(scn, timestamp, false, format.isDbFormatAddDml(), true);
-
-            if (hasPreviousValue)
-                append(',');
-            else
-                hasPreviousValue = true;
-
-            if (format.isAttributesFormatDml())
-                appendAttributes();
-
-            append(std::string_view(R"("payload":)"));
+            appendRowHeader<Spec>(scn, timestamp);
         }
 
         append(std::string_view(R"({"op":"d",)"));
-        if (format.isMessageFormatAddOffset()) {
+        if (rowFormat.isMessageFormatAddOffset()) {
             append(std::string_view(R"("offset":)"));
             appendDec(fileOffset.getData());
             append(',');
         }
         appendSchema(table, obj);
-        appendRowid(dataObj, bdba, slot);
-        appendBefore(lobCtx, xmlCtx, table, fileOffset);
+        appendRowid<Spec>(dataObj, bdba, slot);
+        appendBefore<Spec>(lobCtx, xmlCtx, table, fileOffset);
         append('}');
 
-        if (!format.isMessageFormatFull()) {
+        if (!rowFormat.isMessageFormatFull()) {
             append(std::string_view("}"));
-            builderCommit();
+            messageCommit(true);
         }
         ++num;
     }
@@ -692,7 +833,7 @@ namespace OpenLogReplicator {
             else
                 hasPreviousRedo = true;
         } else {
-            builderBegin(scn, sequence, obj, BuilderMsg::OUTPUT_BUFFER::NONE);
+            messageBegin(scn, sequence, obj, true, BuilderMsg::OP::DDL);
             append('{');
             hasPreviousValue = false;
             appendHeader(scn, timestamp, false, format.isDbFormatAddDdl(), true);
@@ -725,12 +866,13 @@ namespace OpenLogReplicator {
 
         if (!format.isMessageFormatFull()) {
             append(std::string_view("}"));
-            builderCommit();
+            messageCommit(true);
         }
         ++num;
     }
 
     void BuilderJson::processCheckpoint(Scn scn, Seq sequence, time_t timestamp, FileOffset fileOffset, bool redo) {
+        batchClose();
         if (lwnScn != scn) {
             lwnScn = scn;
             lwnIdx = 0;
@@ -759,22 +901,55 @@ namespace OpenLogReplicator {
         builderCommit();
     }
 
+    // The key is rendered from the tag columns of the table plan. The raw values are hashed for routing, and when they equal the
+    // ones of the previous keyed row the rendered key is copied instead of formatting the values again
     void BuilderJson::addTagData(LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table, Format::VALUE_TYPE valueType, FileOffset fileOffset) {
-        if (unlikely(table == nullptr || table->tagCols.empty()))
+        if (unlikely(table == nullptr || table->tagPlan.empty()))
             return;
 
+        tagRaw.clear();
+        for (const typeCol column: table->tagPlan) {
+            const uint8_t* data = values[column][static_cast<uint>(valueType)];
+            const uint32_t size = data != nullptr ? sizes[column][static_cast<uint>(valueType)] : UINT32_MAX;
+            tagRaw.append(reinterpret_cast<const char*>(&size), sizeof(size));
+            if (data != nullptr)
+                tagRaw.append(reinterpret_cast<const char*>(data), size);
+        }
+
+        // FNV-1a
+        uint64_t hash = 0xCBF29CE484222325ULL;
+        for (const char byte: tagRaw) {
+            hash ^= static_cast<uint8_t>(byte);
+            hash *= 0x100000001B3ULL;
+        }
+        msg->tagHash = hash;
+
         const uint64_t messagePositionOld = messagePosition;
-        hasPreviousColumn = false;
-        for (uint x = 0; x < table->tagCols.size(); ++x) {
-            const typeCol column = table->tagCols[x] - 1;
-            if (values[column][static_cast<uint>(valueType)] == nullptr)
-                continue;
-
-            if (sizes[column][static_cast<uint>(valueType)] > 0)
-                processValue(lobCtx, xmlCtx, table, column, values[column][static_cast<uint>(valueType)], sizes[column][static_cast<uint>(valueType)],
-                             fileOffset, true, compressedAfter);
-            else
-                columnNull(table, column, true);
+        if (table->tagPlanScalar && tagKeyTable == table && tagKeyVersion == table->schemaVersion && tagKeyType == valueType && tagKeyRaw == tagRaw) {
+            appendArr(tagKey.data(), tagKey.size());
+        } else {
+            const BuilderQueue* queue = lastBuilderQueue;
+            hasPreviousColumn = false;
+            for (const typeCol column: table->tagPlan) {
+                if (values[column][static_cast<uint>(valueType)] == nullptr)
+                    continue;
+
+                if (sizes[column][static_cast<uint>(valueType)] > 0)
+                    processValue(lobCtx, xmlCtx, table, column, values[column][static_cast<uint>(valueType)], sizes[column][static_cast<uint>(valueType)],
+                                 fileOffset, true, compressedAfter);
+                else
+                    columnNull(table, column, true);
+            }
+
+            tagKeyTable = nullptr;
+            if (table->tagPlanScalar && queue == lastBuilderQueue) {
+                tagKey.assign(reinterpret_cast<const char*>(lastBuilderQueue->data + lastBuilderSize + messagePositionOld),
+                              messagePosition - messagePositionOld);
+                tagKeyRaw.swap(tagRaw);
+                tagKeyTable = table;
+                tagKeyVersion = table->schemaVersion;
+                tagKeyType = valueType;
+            }
         }
 
         if (messagePosition >= messagePositionOld)
@@ -20,6 +20,12 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #ifndef BUILDER_JSON_H_
 #define BUILDER_JSON_H_
 
+#if defined(__x86_64__)
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 #include "Builder.h"
 #include "../common/DbColumn.h"
 #include "../common/DbTable.h"
@@ -29,14 +35,104 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include "../metadata/Schema.h"
 
 namespace OpenLogReplicator {
+    // Row message path with every option read from the runtime format
+    struct BuilderJsonGeneric {
+        static constexpr bool GENERIC{true};
+    };
+
+    // Row message path with the options bound at compile time, options not listed are left at their defaults.
+    // Used only when the runtime format has the same values of all options the row path reads
+    template<Format::MESSAGE_FORMAT MESSAGE, Format::RID_FORMAT RID, Format::COLUMN_FORMAT COLUMN>
+    struct BuilderJsonSpec {
+        static constexpr bool GENERIC{false};
+        static constexpr Format FORMAT{Format::DB_FORMAT::DEFAULT, Format::ATTRIBUTES_FORMAT::DEFAULT, Format::INTERVAL_DTS_FORMAT::UNIX_NANO,
+                                       Format::INTERVAL_YTM_FORMAT::MONTHS, MESSAGE, RID, Format::XID_FORMAT::TEXT_HEX,
+                                       Format::TIMESTAMP_FORMAT::UNIX_NANO, Format::TIMESTAMP_TZ_FORMAT::UNIX_NANO_STRING,
+                                       Format::TIMESTAMP_ALL::JUST_BEGIN, Format::CHAR_FORMAT::UTF8, Format::SCN_FORMAT::NUMERIC, Format::SCN_TYPE::NONE,
+                                       Format::UNKNOWN_FORMAT::QUESTION_MARK, Format::SCHEMA_FORMAT::DEFAULT, COLUMN, Format::UNKNOWN_TYPE::HIDE,
+                                       Format::RAW_FORMAT::HEX, Format::COMPACT_FORMAT::NONE, 0, 0};
+
+        [[nodiscard]] static bool matches(const Format& format) {
+            return format.dbFormat == FORMAT.dbFormat && format.attributesFormat == FORMAT.attributesFormat && format.messageFormat == FORMAT.messageFormat &&
+                   format.ridFormat == FORMAT.ridFormat && format.xidFormat == FORMAT.xidFormat && format.timestampFormat == FORMAT.timestampFormat &&
+                   format.timestampAll == FORMAT.timestampAll && format.scnFormat == FORMAT.scnFormat && format.scnType == FORMAT.scnType &&
+                   format.schemaFormat == FORMAT.schemaFormat && format.columnFormat == FORMAT.columnFormat && format.unknownType == FORMAT.unknownType;
+        }
+    };
+
     class BuilderJson final : public Builder {
     protected:
+        // Multiple of 3, so that base64 pieces need no padding in between
+        static constexpr uint64_t RAW_ENCODE_CHUNK{3 * 1024};
+        static constexpr std::string_view RID_PREFIX{R"(,"rid":")"};
+        static constexpr uint64_t RID_TEXT_SIZE{RID_PREFIX.size() + RowId::SIZE + 1};
+
         bool hasPreviousValue{false};
         bool hasPreviousRedo{false};
         bool hasPreviousColumn{false};
 
+        // Header of the row messages of the transaction up to the "payload" tag, with the digits of c_idx cut out at rowHeaderIdx.
+        // Rows with the same scn and timestamp copy it instead of formatting the header again
+        std::string rowHeader;
+        uint64_t rowHeaderIdx{0};
+        bool rowHeaderValid{false};
+        Scn rowHeaderScn{Scn::none()};
+        Scn rowHeaderLwnScn{Scn::none()};
+        time_t rowHeaderTimestamp{0};
+        Xid rowHeaderXid;
+        // Raw tag values and the rendered key of the last keyed row
+        std::string tagKeyRaw;
+        std::string tagKey;
+        const DbTable* tagKeyTable{nullptr};
+        uint64_t tagKeyVersion{0};
+        Format::VALUE_TYPE tagKeyType{Format::VALUE_TYPE::LENGTH};
+        std::string tagRaw;
+        // Output buffer positions of the c_idx value written by the last appendHeader()
+        uint64_t headerIdxBegin{0};
+        uint64_t headerIdxEnd{0};
+        // The "rid" tag of the last row, rows of the same block render only the digits of the slot
+        char ridText[RID_TEXT_SIZE]{};
+        typeDataObj ridDataObj{0};
+        typeDba ridBdba{0};
+        bool ridValid{false};
+
+        // Row messages are built by the instance selected for the current format, see selectFormatSpec()
+        void (BuilderJson::*beginMessageSpec)(Scn scn, Seq sequence, time_t timestamp){&BuilderJson::processBeginMessageFormat<BuilderJsonGeneric>};
+        void (BuilderJson::*commitSpec)(Scn scn, Seq sequence, time_t timestamp){&BuilderJson::processCommitFormat<BuilderJsonGeneric>};
+        void (BuilderJson::*insertSpec)(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table, typeObj obj,
+                                        typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset){
+                &BuilderJson::processInsertFormat<BuilderJsonGeneric>};
+        void (BuilderJson::*updateSpec)(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table, typeObj obj,
+                                        typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset){
+                &BuilderJson::processUpdateFormat<BuilderJsonGeneric>};
+        void (BuilderJson::*deleteSpec)(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table, typeObj obj,
+                                        typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset){
+                &BuilderJson::processDeleteFormat<BuilderJsonGeneric>};
+
+        // A specialized instance sees its format as a constant, so the option checks fold away
+        template<class Spec>
+        [[nodiscard]] const Format& formatOf() const {
+            if constexpr (Spec::GENERIC)
+                return format;
+            else
+                return Spec::FORMAT;
+        }
+
+        template<class Spec>
+        void useFormatSpec() {
+            beginMessageSpec = &BuilderJson::processBeginMessageFormat<Spec>;
+            commitSpec = &BuilderJson::processCommitFormat<Spec>;
+            insertSpec = &BuilderJson::processInsertFormat<Spec>;
+            updateSpec = &BuilderJson::processUpdateFormat<Spec>;
+            deleteSpec = &BuilderJson::processDeleteFormat<Spec>;
+        }
+
+        void selectFormatSpec();
+
+        template<class Spec = BuilderJsonGeneric>
         void columnNull(const DbTable* table, typeCol col, bool after) {
-            if (unlikely(table != nullptr && format.unknownType == Format::UNKNOWN_TYPE::HIDE)) {
+            const Format& rowFormat = formatOf<Spec>();
+            if (unlikely(table != nullptr && rowFormat.unknownType == Format::UNKNOWN_TYPE::HIDE)) {
                 const DbColumn* column = table->columns[col];
                 if (column->guard && !ctx->isFlagSet(Ctx::REDO_FLAGS::SHOW_GUARD_COLUMNS))
                     return;
@@ -72,47 +168,61 @@ namespace OpenLogReplicator {
             else
                 hasPreviousColumn = true;
 
-            append('"');
             if (likely(table != nullptr))
-                appendEscape(table->columns[col]->name);
+                append(table->columns[col]->jsonName);
             else {
+                append('"');
                 const std::string columnName("COL_" + std::to_string(col));
                 append(columnName);
+                append(std::string_view(R"(":)"));
             }
-            append(std::string_view(R"(":null)"));
+            append(std::string_view("null"));
         }
 
+        template<class Spec = BuilderJsonGeneric>
         void appendRowid(typeDataObj dataObj, typeDba bdba, typeSlot slot) {
-            if (format.isMessageFormatAddSequences()) {
+            const Format& rowFormat = formatOf<Spec>();
+            if (rowFormat.isMessageFormatAddSequences()) {
                 append(std::string_view(R"(,"num":)"));
                 appendDec(num);
             }
 
-            if (format.ridFormat == Format::RID_FORMAT::SKIP)
+            if (rowFormat.ridFormat == Format::RID_FORMAT::SKIP)
                 return;
 
-            if (format.ridFormat == Format::RID_FORMAT::TEXT) {
-                const RowId rowId(dataObj, bdba, slot);
-                char str[RowId::SIZE + 1];
-                rowId.toString(str);
-                append(std::string_view(R"(,"rid":")"));
-                appendArr(str, 18);
-                append('"');
+            if (rowFormat.ridFormat == Format::RID_FORMAT::TEXT) {
+                char* str = ridText + RID_PREFIX.size();
+                if (unlikely(!ridValid || dataObj != ridDataObj || bdba != ridBdba)) {
+                    const RowId rowId(dataObj, bdba, slot);
+                    memcpy(reinterpret_cast<void*>(ridText), reinterpret_cast<const void*>(RID_PREFIX.data()), RID_PREFIX.size());
+                    rowId.toString(str);
+                    ridText[RID_TEXT_SIZE - 1] = '"';
+                    ridDataObj = dataObj;
+                    ridBdba = bdba;
+                    ridValid = true;
+                } else {
+                    str[15] = Data::map64((slot >> 12) & 0x3F);
+                    str[16] = Data::map64((slot >> 6) & 0x3F);
+                    str[17] = Data::map64(slot & 0x3F);
+                }
+                appendArr(ridText, RID_TEXT_SIZE);
             }
         }
 
+        template<class Spec = BuilderJsonGeneric>
         void appendHeader(Scn scn, time_t timestamp, bool first, bool showDb, bool showXid) {
+            const Format& rowFormat = formatOf<Spec>();
             __builtin_prefetch(&lastBuilderQueue->data[lastBuilderSize + messagePosition], 1, 0);
             __builtin_prefetch(&lastBuilderQueue->data[lastBuilderSize + messagePosition] + 64, 1, 0);
             __builtin_prefetch(&lastBuilderQueue->data[lastBuilderSize + messagePosition] + 128, 1, 0);
             __builtin_prefetch(&lastBuilderQueue->data[lastBuilderSize + messagePosition] + 192, 1, 0);
-            if (first || format.isScnTypeAllPayloads()) {
+            if (first || rowFormat.isScnTypeAllPayloads()) {
                 if (hasPreviousValue)
                     append(',');
                 else
                     hasPreviousValue = true;
 
-                if (format.scnFormat == Format::SCN_FORMAT::TEXT_HEX) {
+                if (rowFormat.scnFormat == Format::SCN_FORMAT::TEXT_HEX) {
                     append(std::string_view(R"("scns":"0x)"));
                     appendHex16(scn.getData());
                     append('"');
@@ -122,14 +232,14 @@ namespace OpenLogReplicator {
                 }
             }
 
-            if (first || (static_cast<uint>(format.timestampAll) & static_cast<uint>(Format::TIMESTAMP_ALL::ALL_PAYLOADS)) != 0) {
+            if (first || (static_cast<uint>(rowFormat.timestampAll) & static_cast<uint>(Format::TIMESTAMP_ALL::ALL_PAYLOADS)) != 0) {
                 if (hasPreviousValue)
                     append(',');
                 else
                     hasPreviousValue = true;
 
                 char buffer[22];
-                switch (format.timestampFormat) {
+                switch (rowFormat.timestampFormat) {
                     case Format::TIMESTAMP_FORMAT::UNIX_NANO:
                         append(std::string_view(R"("tm":)"));
                         appendDec(timestamp);
@@ -188,49 +298,49 @@ namespace OpenLogReplicator {
 
                     case Format::TIMESTAMP_FORMAT::ISO8601_NANO_TZ:
                         append(std::string_view(R"("tms":")"));
-                        appendArr(buffer, Data::epochToIso8601(timestamp, buffer, true, false));
+                        appendArr(buffer, epochToIso8601(timestamp, buffer, true, false));
                         append(std::string_view(R"(.000000000Z")"));
                         break;
 
                     case Format::TIMESTAMP_FORMAT::ISO8601_MICRO_TZ:
                         append(std::string_view(R"("tms":")"));
-                        appendArr(buffer, Data::epochToIso8601(timestamp, buffer, true, true));
+                        appendArr(buffer, epochToIso8601(timestamp, buffer, true, true));
                         append(std::string_view(R"(.000000Z")"));
                         break;
 
                     case Format::TIMESTAMP_FORMAT::ISO8601_MILLI_TZ:
                         append(std::string_view(R"("tms":")"));
-                        appendArr(buffer, Data::epochToIso8601(timestamp, buffer, true, false));
+                        appendArr(buffer, epochToIso8601(timestamp, buffer, true, false));
                         append(std::string_view(R"(.000Z")"));
                         break;
 
                     case Format::TIMESTAMP_FORMAT::ISO8601_TZ:
                         append(std::string_view(R"("tms":")"));
-                        appendArr(buffer, Data::epochToIso8601(timestamp, buffer, true, true));
+                        appendArr(buffer, epochToIso8601(timestamp, buffer, true, true));
                         append('"');
                         break;
 
                     case Format::TIMESTAMP_FORMAT::ISO8601_NANO:
                         append(std::string_view(R"("tms":")"));
-                        appendArr(buffer, Data::epochToIso8601(timestamp, buffer, false, false));
+                        appendArr(buffer, epochToIso8601(timestamp, buffer, false, false));
                         append(std::string_view(R"(.000000000")"));
                         break;
 
                     case Format::TIMESTAMP_FORMAT::ISO8601_MICRO:
                         append(std::string_view(R"("tms":")"));
-                        appendArr(buffer, Data::epochToIso8601(timestamp, buffer, false, false));
+                        appendArr(buffer, epochToIso8601(timestamp, buffer, false, false));
                         append(std::string_view(R"(.000000")"));
                         break;
 
                     case Format::TIMESTAMP_FORMAT::ISO8601_MILLI:
                         append(std::string_view(R"("tms":")"));
-                        appendArr(buffer, Data::epochToIso8601(timestamp, buffer, false, false));
+                        appendArr(buffer, epochToIso8601(timestamp, buffer, false, false));
                         append(std::string_view(R"(.000")"));
                         break;
 
                     case Format::TIMESTAMP_FORMAT::ISO8601:
                         append(std::string_view(R"("tms":")"));
-                        appendArr(buffer, Data::epochToIso8601(timestamp, buffer, false, false));
+                        appendArr(buffer, epochToIso8601(timestamp, buffer, false, false));
                         append('"');
                         break;
                 }
@@ -243,7 +353,9 @@ namespace OpenLogReplicator {
             append(std::string_view(R"("c_scn":)"));
             appendDec(lwnScn.getData());
             append(std::string_view(R"(,"c_idx":)"));
+            headerIdxBegin = lastBuilderSize + messagePosition;
             appendDec(lwnIdx);
+            headerIdxEnd = lastBuilderSize + messagePosition;
 
             if (showXid) {
                 if (hasPreviousValue)
@@ -251,7 +363,7 @@ namespace OpenLogReplicator {
                 else
                     hasPreviousValue = true;
 
-                switch (format.xidFormat) {
+                switch (rowFormat.xidFormat) {
                     case Format::XID_FORMAT::TEXT_HEX:
                         append(std::string_view(R"("xid":"0x)"));
                         appendHex4(lastXid.usn());
@@ -288,6 +400,47 @@ namespace OpenLogReplicator {
             }
         }
 
+        // Everything of a row message between the opening brace and the payload
+        template<class Spec>
+        void appendRowHeader(Scn scn, time_t timestamp) {
+            hasPreviousValue = true;
+            if (likely(rowHeaderValid && scn == rowHeaderScn && timestamp == rowHeaderTimestamp && lwnScn == rowHeaderLwnScn && lastXid == rowHeaderXid)) {
+                appendArr(rowHeader.data(), rowHeaderIdx);
+                appendDec(lwnIdx);
+                appendArr(rowHeader.data() + rowHeaderIdx, rowHeader.size() - rowHeaderIdx);
+                return;
+            }
+
+            const Format& rowFormat = formatOf<Spec>();
+            const BuilderQueue* queue = lastBuilderQueue;
+            const uint64_t begin = lastBuilderSize + messagePosition;
+            hasPreviousValue = false;
+            appendHeader<Spec>(scn, timestamp, false, rowFormat.isDbFormatAddDml(), true);
+
+            if (hasPreviousValue)
+                append(',');
+            else
+                hasPreviousValue = true;
+
+            if (rowFormat.isAttributesFormatDml())
+                appendAttributes();
+
+            append(std::string_view(R"("payload":)"));
+
+            // A header split by a buffer rotation is not kept, the next row tries again
+            if (queue != lastBuilderQueue)
+                return;
+            const char* data = reinterpret_cast<const char*>(lastBuilderQueue->data);
+            rowHeader.assign(data + begin, headerIdxBegin - begin);
+            rowHeader.append(data + headerIdxEnd, lastBuilderSize + messagePosition - headerIdxEnd);
+            rowHeaderIdx = headerIdxBegin - begin;
+            rowHeaderScn = scn;
+            rowHeaderLwnScn = lwnScn;
+            rowHeaderTimestamp = timestamp;
+            rowHeaderXid = lastXid;
+            rowHeaderValid = true;
+        }
+
         void appendAttributes() {
             append(std::string_view(R"("attributes":{)"));
             bool hasPreviousAttribute = false;
@@ -339,11 +492,7 @@ namespace OpenLogReplicator {
                 return;
             }
 
-            append(std::string_view(R"("schema":{"owner":")"));
-            appendEscape(table->owner);
-            append(std::string_view(R"(","table":")"));
-            appendEscape(table->name);
-            append('"');
+            append(table->jsonSchema);
 
             if (format.isSchemaFormatObj()) {
                 append(std::string_view(R"(,"obj":)"));
@@ -351,7 +500,16 @@ namespace OpenLogReplicator {
             }
 
             if (format.isSchemaFormatFull()) {
-                if (!format.isSchemaFormatRepeated()) {
+                // Full column list once per layout, after that only the version the consumer has cached
+                if (format.isSchemaFormatVersioned()) {
+                    append(std::string_view(R"(,"version":")"));
+                    appendHex16(table->schemaVersion);
+                    append('"');
+                    if (!format.isSchemaFormatRepeated() && !schemaVersions.insert(table->schemaVersion).second) {
+                        append('}');
+                        return;
+                    }
+                } else if (!format.isSchemaFormatRepeated()) {
                     if (tables.count(table) > 0) {
                         append('}');
                         return;
@@ -476,183 +634,89 @@ namespace OpenLogReplicator {
             append('}');
         }
 
-        template<bool fast = false>
-        void appendHex2(uint8_t value) {
-            if (likely(fast || lastBuilderSize + messagePosition + 2 < OUTPUT_BUFFER_DATA_SIZE)) {
-                append<true>(Data::map16((value >> 4) & 0xF));
-                append<true>(Data::map16(value & 0xF));
+        template<uint size, bool fast = false>
+        void appendHexN(uint64_t value) {
+            if (likely(fast || lastBuilderSize + messagePosition + size < outputBufferDataSize)) {
+                char* ptr = reinterpret_cast<char*>(lastBuilderQueue->data + lastBuilderSize + messagePosition);
+                Data::hexToChars(value, ptr + size, size);
+                messagePosition += size;
+                ctx->assertDebug(lastBuilderSize + messagePosition < outputBufferDataSize);
             } else {
-                append(Data::map16((value >> 4) & 0xF));
-                append(Data::map16(value & 0xF));
+                char buffer[16];
+                Data::hexToChars(value, buffer + size, size);
+                appendArr(buffer, size);
             }
         }
 
+        template<bool fast = false>
+        void appendHex2(uint8_t value) {
+            appendHexN<2, fast>(value);
+        }
+
         void appendHex3(uint16_t value) {
-            if (likely(lastBuilderSize + messagePosition + 3 < OUTPUT_BUFFER_DATA_SIZE)) {
-                append<true>(Data::map16((value >> 8) & 0xF));
-                append<true>(Data::map16((value >> 4) & 0xF));
-                append<true>(Data::map16(value & 0xF));
-            } else {
-                append(Data::map16((value >> 8) & 0xF));
-                append(Data::map16((value >> 4) & 0xF));
-                append(Data::map16(value & 0xF));
-            }
+            appendHexN<3>(value);
         }
 
         void appendHex4(uint16_t value) {
-            if (likely(lastBuilderSize + messagePosition + 4 < OUTPUT_BUFFER_DATA_SIZE)) {
-                append<true>(Data::map16((value >> 12) & 0xF));
-                append<true>(Data::map16((value >> 8) & 0xF));
-                append<true>(Data::map16((value >> 4) & 0xF));
-                append<true>(Data::map16(value & 0xF));
-            } else {
-                append(Data::map16((value >> 12) & 0xF));
-                append(Data::map16((value >> 8) & 0xF));
-                append(Data::map16((value >> 4) & 0xF));
-                append(Data::map16(value & 0xF));
-            };
+            appendHexN<4>(value);
         }
 
         void appendHex8(uint32_t value) {
-            if (likely(lastBuilderSize + messagePosition + 8 < OUTPUT_BUFFER_DATA_SIZE)) {
-                append<true>(Data::map16((value >> 28) & 0xF));
-                append<true>(Data::map16((value >> 24) & 0xF));
-                append<true>(Data::map16((value >> 20) & 0xF));
-                append<true>(Data::map16((value >> 16) & 0xF));
-                append<true>(Data::map16((value >> 12) & 0xF));
-                append<true>(Data::map16((value >> 8) & 0xF));
-                append<true>(Data::map16((value >> 4) & 0xF));
-                append<true>(Data::map16(value & 0xF));
-            } else {
-                append(Data::map16((value >> 28) & 0xF));
-                append(Data::map16((value >> 24) & 0xF));
-                append(Data::map16((value >> 20) & 0xF));
-                append(Data::map16((value >> 16) & 0xF));
-                append(Data::map16((value >> 12) & 0xF));
-                append(Data::map16((value >> 8) & 0xF));
-                append(Data::map16((value >> 4) & 0xF));
-                append(Data::map16(value & 0xF));
-            }
+            appendHexN<8>(value);
         }
 
         void appendHex16(uint64_t value) {
-            if (likely(lastBuilderSize + messagePosition + 16 < OUTPUT_BUFFER_DATA_SIZE)) {
-                append<true>(Data::map16((value >> 60) & 0xF));
-                append<true>(Data::map16((value >> 56) & 0xF));
-                append<true>(Data::map16((value >> 52) & 0xF));
-                append<true>(Data::map16((value >> 48) & 0xF));
-                append<true>(Data::map16((value >> 44) & 0xF));
-                append<true>(Data::map16((value >> 40) & 0xF));
-                append<true>(Data::map16((value >> 36) & 0xF));
-                append<true>(Data::map16((value >> 32) & 0xF));
-                append<true>(Data::map16((value >> 28) & 0xF));
-                append<true>(Data::map16((value >> 24) & 0xF));
-                append<true>(Data::map16((value >> 20) & 0xF));
-                append<true>(Data::map16((value >> 16) & 0xF));
-                append<true>(Data::map16((value >> 12) & 0xF));
-                append<true>(Data::map16((value >> 8) & 0xF));
-                append<true>(Data::map16((value >> 4) & 0xF));
-                append<true>(Data::map16(value & 0xF));
-            } else {
-                append(Data::map16((value >> 60) & 0xF));
-                append(Data::map16((value >> 56) & 0xF));
-                append(Data::map16((value >> 52) & 0xF));
-                append(Data::map16((value >> 48) & 0xF));
-                append(Data::map16((value >> 44) & 0xF));
-                append(Data::map16((value >> 40) & 0xF));
-                append(Data::map16((value >> 36) & 0xF));
-                append(Data::map16((value >> 32) & 0xF));
-                append(Data::map16((value >> 28) & 0xF));
-                append(Data::map16((value >> 24) & 0xF));
-                append(Data::map16((value >> 20) & 0xF));
-                append(Data::map16((value >> 16) & 0xF));
-                append(Data::map16((value >> 12) & 0xF));
-                append(Data::map16((value >> 8) & 0xF));
-                append(Data::map16((value >> 4) & 0xF));
-                append(Data::map16(value & 0xF));
-            }
+            appendHexN<16>(value);
         }
 
         template<uint size, bool fast = false>
         void appendDecN(uint64_t value) {
-            char buffer[21];
-
-            for (uint i = 0; i < size; ++i) {
-                buffer[i] = Data::map10(value % 10);
-                value /= 10;
-            }
-
-            if (likely(fast || lastBuilderSize + messagePosition + size < OUTPUT_BUFFER_DATA_SIZE)) {
-                uint8_t* ptr = lastBuilderQueue->data + lastBuilderSize + messagePosition;
-                for (uint i = 0; i < size; ++i)
-                    *ptr++ = buffer[size - i - 1];
+            if (likely(fast || lastBuilderSize + messagePosition + size < outputBufferDataSize)) {
+                char* ptr = reinterpret_cast<char*>(lastBuilderQueue->data + lastBuilderSize + messagePosition);
+                Data::decToChars(value, ptr + size, size);
                 messagePosition += size;
-                ctx->assertDebug(lastBuilderSize + messagePosition < OUTPUT_BUFFER_DATA_SIZE);
+                ctx->assertDebug(lastBuilderSize + messagePosition < outputBufferDataSize);
             } else {
-                for (uint i = 0; i < size; ++i)
-                    append(buffer[size - i - 1]);
+                char buffer[21];
+                Data::decToChars(value, buffer + size, size);
+                appendArr(buffer, size);
             }
         }
 
+        // Length is computed first, so the digits are written in place, in order
         template<bool fast = false>
         void appendDec(uint64_t value) {
-            char buffer[21];
-            uint size = 0;
+            const uint size = Data::decLength(value);
 
-            if (value == 0) {
-                buffer[0] = '0';
-                size = 1;
-            } else {
-                while (value > 0) {
-                    buffer[size++] = Data::map10(value % 10);
-                    value /= 10;
-                }
-            }
-
-            if (likely(fast || lastBuilderSize + messagePosition + size < OUTPUT_BUFFER_DATA_SIZE)) {
-                uint8_t* ptr = lastBuilderQueue->data + lastBuilderSize + messagePosition;
-                for (uint i = 0; i < size; ++i)
-                    *ptr++ = buffer[size - i - 1];
+            if (likely(fast || lastBuilderSize + messagePosition + size < outputBufferDataSize)) {
+                char* ptr = reinterpret_cast<char*>(lastBuilderQueue->data + lastBuilderSize + messagePosition);
+                Data::decToChars(value, ptr + size, size);
                 messagePosition += size;
-                ctx->assertDebug(lastBuilderSize + messagePosition < OUTPUT_BUFFER_DATA_SIZE);
+                ctx->assertDebug(lastBuilderSize + messagePosition < outputBufferDataSize);
             } else {
-                for (uint i = 0; i < size; ++i)
-                    append(buffer[size - i - 1]);
+                char buffer[21];
+                Data::decToChars(value, buffer + size, size);
+                appendArr(buffer, size);
             }
         }
 
         void appendSDec(int64_t value) {
-            char buffer[22];
-            uint size = 0;
-
-            if (value == 0) {
-                buffer[0] = '0';
-                size = 1;
-            } else {
-                if (value < 0) {
-                    value = -value;
-                    while (value > 0) {
-                        buffer[size++] = Data::map10(value % 10);
-                        value /= 10;
-                    }
-                    buffer[size++] = '-';
-                } else {
-                    while (value > 0) {
-                        buffer[size++] = Data::map10(value % 10);
-                        value /= 10;
-                    }
-                }
-            }
+            if (value < 0) {
+                append('-');
+                appendDec(0 - static_cast<uint64_t>(value));
+            } else
+                appendDec(static_cast<uint64_t>(value));
+        }
 
-            if (likely(lastBuilderSize + messagePosition + size < OUTPUT_BUFFER_DATA_SIZE)) {
-                uint8_t* ptr = lastBuilderQueue->data + lastBuilderSize + messagePosition;
-                for (uint i = 0; i < size; ++i)
-                    *ptr++ = buffer[size - i - 1];
-                messagePosition += size;
-                ctx->assertDebug(lastBuilderSize + messagePosition < OUTPUT_BUFFER_DATA_SIZE);
-            } else {
-                for (uint i = 0; i < size; ++i)
-                    append(buffer[size - i - 1]);
+        // Column values name the column by its DbColumn::name, whose fragment is already escaped; other names are escaped here
+        template<bool fast = false>
+        void appendColumnName(const std::string& columnName) {
+            if (likely(valueColumn != nullptr && &valueColumn->name == &columnName))
+                append<fast>(valueColumn->jsonName);
+            else {
+                append<fast>('"');
+                appendEscape<fast>(columnName);
+                append<fast>(std::string_view(R"(":)"));
             }
         }
 
@@ -663,16 +727,65 @@ namespace OpenLogReplicator {
 
         template<bool fast = false>
         void appendEscape(const char* str, uint64_t size) {
-            if (fast || likely(lastBuilderSize + messagePosition + size * 5 < OUTPUT_BUFFER_DATA_SIZE)) {
+            if (fast || likely(lastBuilderSize + messagePosition + size * 5 < outputBufferDataSize)) {
                 appendEscapeInternal<true>(str, size);
             } else {
                 appendEscapeInternal<false>(str, size);
             }
         }
 
+        static bool isEscapeFree(char character) {
+            const auto byte = static_cast<uint8_t>(character);
+            return byte >= 0x20 && byte != '"' && byte != '\\' && byte != '/';
+        }
+
+        // Length of the leading run that can be copied without escaping, 16 bytes per step with SSE2 or NEON
+        static uint64_t escapeFreePrefix(const char* str, uint64_t size) {
+            uint64_t pos = 0;
+#if defined(__x86_64__)
+            const __m128i control = _mm_set1_epi8(0x1F);
+            const __m128i quote = _mm_set1_epi8('"');
+            const __m128i backslash = _mm_set1_epi8('\\');
+            const __m128i slash = _mm_set1_epi8('/');
+            for (; pos + 16 <= size; pos += 16) {
+                const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + pos));
+                const __m128i special = _mm_or_si128(
+                        _mm_or_si128(_mm_cmpeq_epi8(_mm_max_epu8(chunk, control), control), _mm_cmpeq_epi8(chunk, quote)),
+                        _mm_or_si128(_mm_cmpeq_epi8(chunk, backslash), _mm_cmpeq_epi8(chunk, slash)));
+                const int mask = _mm_movemask_epi8(special);
+                if (mask != 0)
+                    return pos + __builtin_ctz(static_cast<uint>(mask));
+            }
+#elif defined(__aarch64__)
+            const uint8x16_t control = vdupq_n_u8(0x20);
+            const uint8x16_t quote = vdupq_n_u8('"');
+            const uint8x16_t backslash = vdupq_n_u8('\\');
+            const uint8x16_t slash = vdupq_n_u8('/');
+            for (; pos + 16 <= size; pos += 16) {
+                const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(str + pos));
+                const uint8x16_t special = vorrq_u8(vorrq_u8(vcltq_u8(chunk, control), vceqq_u8(chunk, quote)),
+                                                    vorrq_u8(vceqq_u8(chunk, backslash), vceqq_u8(chunk, slash)));
+                if (vmaxvq_u8(special) != 0)
+                    break;
+            }
+#endif
+            while (pos < size && isEscapeFree(str[pos]))
+                ++pos;
+            return pos;
+        }
+
         template<bool fast = false>
         void appendEscapeInternal(const char* str, uint64_t size) {
             while (size > 0) {
+                const uint64_t clean = escapeFreePrefix(str, size);
+                if (clean > 0) {
+                    appendArr<fast>(str, clean);
+                    str += clean;
+                    size -= clean;
+                    if (size == 0)
+                        break;
+                }
+
                 switch (*str) {
                     case '\t':
                         append<fast>(std::string_view("\\t"));
@@ -737,11 +850,13 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<class Spec = BuilderJsonGeneric>
         void appendAfter(LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table, FileOffset fileOffset) {
+            const Format& rowFormat = formatOf<Spec>();
             append(std::string_view(R"(,"after":{)"));
 
             hasPreviousColumn = false;
-            if (format.columnFormat > Format::COLUMN_FORMAT::CHANGED && table != nullptr) {
+            if (rowFormat.columnFormat > Format::COLUMN_FORMAT::CHANGED && table != nullptr) {
                 for (typeCol column = 0; column < table->maxSegCol; ++column) {
                     if (values[column][static_cast<uint>(Format::VALUE_TYPE::AFTER)] == nullptr)
                         continue;
@@ -750,7 +865,7 @@ namespace OpenLogReplicator {
                         processValue(lobCtx, xmlCtx, table, column, values[column][static_cast<uint>(Format::VALUE_TYPE::AFTER)],
                                      sizes[column][static_cast<uint>(Format::VALUE_TYPE::AFTER)], fileOffset, true, compressedAfter);
                     else
-                        columnNull(table, column, true);
+                        columnNull<Spec>(table, column, true);
                 }
             } else {
                 const typeCol baseMax = valuesMax >> 6;
@@ -767,7 +882,7 @@ namespace OpenLogReplicator {
                                 processValue(lobCtx, xmlCtx, table, column, values[column][static_cast<uint>(Format::VALUE_TYPE::AFTER)],
                                              sizes[column][static_cast<uint>(Format::VALUE_TYPE::AFTER)], fileOffset, true, compressedAfter);
                             else
-                                columnNull(table, column, true);
+                                columnNull<Spec>(table, column, true);
                         }
                     }
                 }
@@ -775,11 +890,13 @@ namespace OpenLogReplicator {
             append('}');
         }
 
+        template<class Spec = BuilderJsonGeneric>
         void appendBefore(LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table, FileOffset fileOffset) {
+            const Format& rowFormat = formatOf<Spec>();
             append(std::string_view(R"(,"before":{)"));
 
             hasPreviousColumn = false;
-            if (format.columnFormat > Format::COLUMN_FORMAT::CHANGED && table != nullptr) {
+            if (rowFormat.columnFormat > Format::COLUMN_FORMAT::CHANGED && table != nullptr) {
                 for (typeCol column = 0; column < table->maxSegCol; ++column) {
                     if (values[column][static_cast<uint>(Format::VALUE_TYPE::BEFORE)] == nullptr)
                         continue;
@@ -788,7 +905,7 @@ namespace OpenLogReplicator {
                         processValue(lobCtx, xmlCtx, table, column, values[column][static_cast<uint>(Format::VALUE_TYPE::BEFORE)],
                                      sizes[column][static_cast<uint>(Format::VALUE_TYPE::BEFORE)], fileOffset, false, compressedBefore);
                     else
-                        columnNull(table, column, false);
+                        columnNull<Spec>(table, column, false);
                 }
             } else {
                 const typeCol baseMax = valuesMax >> 6;
@@ -805,7 +922,7 @@ namespace OpenLogReplicator {
                                 processValue(lobCtx, xmlCtx, table, column, values[column][static_cast<uint>(Format::VALUE_TYPE::BEFORE)],
                                              sizes[column][static_cast<uint>(Format::VALUE_TYPE::BEFORE)], fileOffset, false, compressedBefore);
                             else
-                                columnNull(table, column, false);
+                                columnNull<Spec>(table, column, false);
                         }
                     }
                 }
@@ -818,25 +935,82 @@ namespace OpenLogReplicator {
         void columnDouble(const std::string& columnName, long double value) override;
         void columnString(const std::string& columnName) override;
         void columnNumber(const std::string& columnName, int precision, int scale) override;
+        void columnNumberData(const std::string& columnName, int precision, int scale, const uint8_t* data, uint64_t size, FileOffset fileOffset) override;
         void columnRaw(const std::string& columnName, const uint8_t* data, uint64_t size) override;
+        void columnJson(const std::string& columnName, const uint8_t* data, uint64_t size, FileOffset fileOffset) override;
+        [[nodiscard]] bool isStreamSupported() const override {
+            return true;
+        }
+        void columnStreamBegin(const std::string& columnName) override;
+        uint64_t columnStreamAppend(bool isClob, bool last) override;
+        void columnStreamEnd() override;
+        void columnLobRef(const std::string& columnName, const std::string& hash, uint64_t size) override;
         void columnRowId(const std::string& columnName, RowId rowId) override;
         void columnTimestamp(const std::string& columnName, time_t timestamp, uint64_t fraction) override;
         void columnTimestampTz(const std::string& columnName, time_t timestamp, uint64_t fraction, const std::string_view& tz) override;
         void processInsert(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table, typeObj obj,
-                           typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset) override;
+                           typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset) override {
+            (this->*insertSpec)(scn, sequence, timestamp, lobCtx, xmlCtx, table, obj, dataObj, bdba, slot, fileOffset);
+        }
+
         void processUpdate(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table, typeObj obj,
-                           typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset) override;
+                           typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset) override {
+            (this->*updateSpec)(scn, sequence, timestamp, lobCtx, xmlCtx, table, obj, dataObj, bdba, slot, fileOffset);
+        }
+
         void processDelete(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table, typeObj obj,
-                           typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset) override;
+                           typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset) override {
+            (this->*deleteSpec)(scn, sequence, timestamp, lobCtx, xmlCtx, table, obj, dataObj, bdba, slot, fileOffset);
+        }
+
+        void processBeginMessage(Scn scn, Seq sequence, time_t timestamp) override {
+            (this->*beginMessageSpec)(scn, sequence, timestamp);
+        }
+
+        template<class Spec>
+        void processInsertFormat(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table, typeObj obj,
+                                 typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset);
+        template<class Spec>
+        void processUpdateFormat(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table, typeObj obj,
+                                 typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset);
+        template<class Spec>
+        void processDeleteFormat(Scn scn, Seq sequence, time_t timestamp, LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table, typeObj obj,
+                                 typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset);
+        template<class Spec>
+        void processBeginMessageFormat(Scn scn, Seq sequence, time_t timestamp);
+        template<class Spec>
+        void processCommitFormat(Scn scn, Seq sequence, time_t timestamp);
         void processDdl(Scn scn, Seq sequence, time_t timestamp, const DbTable* table, typeObj obj) override;
-        void processBeginMessage(Scn scn, Seq sequence, time_t timestamp) override;
+
+        void formatChanged() override {
+            rowHeaderValid = false;
+            tagKeyTable = nullptr;
+            selectFormatSpec();
+        }
         void addTagData(LobCtx* lobCtx, const XmlCtx* xmlCtx, const DbTable* table, Format::VALUE_TYPE valueType, FileOffset fileOffset);
 
+        // A batch is a JSON array of the messages it holds
+        void batchSeparator(bool first) override {
+            append(first ? '[' : ',');
+        }
+
+        void batchEnd() override {
+            append(']');
+        }
+
     public:
         BuilderJson(Ctx* newCtx, Locales* newLocales, Metadata* newMetadata, Format& newFormat, uint64_t newFlushBuffer);
 
-        void processCommit(Scn scn, Seq sequence, time_t timestamp) override;
+        void initialize() override;
+
+        void processCommit(Scn scn, Seq sequence, time_t timestamp) override {
+            (this->*commitSpec)(scn, sequence, timestamp);
+        }
+
+        void processRollback(Scn scn, Seq sequence, time_t timestamp) override;
         void processCheckpoint(Scn scn, Seq sequence, time_t timestamp, FileOffset fileOffset, bool redo) override;
+
+        friend class BuilderBench;
     };
 }
 
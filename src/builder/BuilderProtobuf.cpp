@@ -21,6 +21,7 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include "../common/DbTable.h"
 #include "../common/exception/RuntimeException.h"
 #include "../common/table/SysCol.h"
+#include "../common/types/OraNumber.h"
 #include "../common/types/RowId.h"
 #include "../metadata/Metadata.h"
 #include "../metadata/Schema.h"
@@ -28,14 +29,14 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 
 namespace OpenLogReplicator {
     BuilderProtobuf::BuilderProtobuf(Ctx* newCtx, Locales* newLocales, Metadata* newMetadata, Format& newFormat, uint64_t newFlushBuffer) :
-            Builder(newCtx, newLocales, newMetadata, newFormat, newFlushBuffer) {
+            Builder(newCtx, newLocales, newMetadata, newFormat, newFlushBuffer),
+            arenaBlock(new char[ARENA_BLOCK_SIZE]),
+            arena(arenaOptions(arenaBlock.get())) {
     }
 
     BuilderProtobuf::~BuilderProtobuf() {
-        if (redoResponsePB != nullptr) {
-            delete redoResponsePB;
-            redoResponsePB = nullptr;
-        }
+        redoResponsePB = nullptr;
+        arena.Reset();
         google::protobuf::ShutdownProtobufLibrary();
     }
 
@@ -74,6 +75,38 @@ namespace OpenLogReplicator {
         }
     }
 
+    void BuilderProtobuf::columnNumberData(const std::string& columnName, int precision, int scale, const uint8_t* data, uint64_t size,
+                                           FileOffset fileOffset) {
+        OraNumber number;
+        if (number.decode(data, size)) {
+            if (scale == 0 && precision <= 17) {
+                int64_t value;
+                if (number.toInt64(value)) {
+                    valuePB->set_name(columnName);
+                    valuePB->set_value_int(value);
+                    return;
+                }
+            } else if (precision <= 6 && scale < 38) {
+                float value;
+                if (number.toFloat(value)) {
+                    valuePB->set_name(columnName);
+                    valuePB->set_value_float(value);
+                    return;
+                }
+            } else if (precision <= 15 && scale <= 307) {
+                double value;
+                if (number.toDouble(value)) {
+                    valuePB->set_name(columnName);
+                    valuePB->set_value_double(value);
+                    return;
+                }
+            }
+        }
+
+        // Values not exactly representable by the fast path go through the text conversion
+        Builder::columnNumberData(columnName, precision, scale, data, size, fileOffset);
+    }
+
     void BuilderProtobuf::columnRowId(const std::string& columnName, RowId rowId) {
         char str[RowId::SIZE + 1];
         rowId.toHex(str);
@@ -81,26 +114,61 @@ namespace OpenLogReplicator {
         valuePB->set_value_string(str, 18);
     }
 
-    void BuilderProtobuf::columnRaw(const std::string& columnName, const uint8_t* data __attribute__((unused)), uint64_t size __attribute__((unused))) {
+    void BuilderProtobuf::columnRaw(const std::string& columnName, const uint8_t* data, uint64_t size) {
         valuePB->set_name(columnName);
-        // TODO: implement
+        valuePB->set_value_bytes(reinterpret_cast<const char*>(data), size);
     }
 
-    void BuilderProtobuf::columnTimestamp(const std::string& columnName, time_t timestamp __attribute__((unused)),
-                                          uint64_t fraction __attribute__((unused))) {
+    // Epoch nanoseconds fit int64 for years 1677 to 2262, values outside that range are sent as ISO 8601 text
+    bool BuilderProtobuf::timestampToNano(time_t timestamp, uint64_t fraction, int64_t& value) {
+        if (timestamp < -TIMESTAMP_NANO_MAX_SECONDS || timestamp > TIMESTAMP_NANO_MAX_SECONDS)
+            return false;
+        value = (static_cast<int64_t>(timestamp) * 1000000000L) + static_cast<int64_t>(fraction);
+        return true;
+    }
+
+    void BuilderProtobuf::timestampToIso8601(time_t timestamp, uint64_t fraction, std::string& value) {
+        char buffer[22];
+        value.assign(buffer, Data::epochToIso8601(timestamp, buffer, true, false));
+        value.push_back('.');
+        const uint64_t pos = value.size();
+        value.append(9, '0');
+        for (uint64_t i = 0; i < 9; ++i) {
+            value[pos + 8 - i] = static_cast<char>('0' + (fraction % 10));
+            fraction /= 10;
+        }
+        value.push_back('Z');
+    }
+
+    void BuilderProtobuf::columnTimestamp(const std::string& columnName, time_t timestamp, uint64_t fraction) {
         valuePB->set_name(columnName);
-        // TODO: implement
+        int64_t value;
+        if (likely(timestampToNano(timestamp, fraction, value)))
+            valuePB->set_value_int(value);
+        else {
+            std::string str;
+            timestampToIso8601(timestamp, fraction, str);
+            valuePB->set_value_string(std::move(str));
+        }
     }
 
-    void BuilderProtobuf::columnTimestampTz(const std::string& columnName, time_t timestamp __attribute__((unused)),
-                                            uint64_t fraction __attribute__((unused)), const std::string_view& tz __attribute__((unused))) {
+    void BuilderProtobuf::columnTimestampTz(const std::string& columnName, time_t timestamp, uint64_t fraction, const std::string_view& tz) {
         valuePB->set_name(columnName);
-        // TODO: implement
+        // "1700000000123456789,Europe/Warsaw", the Value message has no separate time zone field
+        std::string str;
+        int64_t value;
+        if (likely(timestampToNano(timestamp, fraction, value)))
+            str = std::to_string(value);
+        else
+            timestampToIso8601(timestamp, fraction, str);
+        str.push_back(',');
+        str.append(tz);
+        valuePB->set_value_string(std::move(str));
     }
 
     void BuilderProtobuf::processBeginMessage(Scn scn, Seq sequence, time_t timestamp) {
         newTran = false;
-        builderBegin(scn, sequence, 0, BuilderMsg::OUTPUT_BUFFER::NONE);
+        messageBegin(scn, sequence, 0, true, BuilderMsg::OP::BEGIN);
         createResponse();
         appendHeader(scn, timestamp, true, format.isDbFormatAddDml(), true);
 
@@ -109,15 +177,9 @@ namespace OpenLogReplicator {
             payloadPB = redoResponsePB->mutable_payload(redoResponsePB->payload_size() - 1);
             payloadPB->set_op(pb::BEGIN);
 
-            std::string output;
-            const bool ret = redoResponsePB->SerializeToString(&output);
-            delete redoResponsePB;
-            redoResponsePB = nullptr;
-
-            if (unlikely(!ret))
+            if (unlikely(!serializeResponse()))
                 throw RuntimeException(50017, "PB begin processing failed, error serializing to string");
-            append(output);
-            builderCommit();
+            messageCommit(false);
         }
     }
 
@@ -130,7 +192,7 @@ namespace OpenLogReplicator {
             if (unlikely(redoResponsePB == nullptr))
                 throw RuntimeException(50018, "PB insert processing failed, a message is missing");
         } else {
-            builderBegin(scn, sequence, obj, BuilderMsg::OUTPUT_BUFFER::NONE);
+            messageBegin(scn, sequence, obj, true, BuilderMsg::OP::INSERT);
             createResponse();
             appendHeader(scn, timestamp, true, format.isDbFormatAddDml(), true);
         }
@@ -145,15 +207,9 @@ namespace OpenLogReplicator {
         appendAfter(lobCtx, xmlCtx, table, fileOffset);
 
         if (!format.isMessageFormatFull()) {
-            std::string output;
-            const bool ret = redoResponsePB->SerializeToString(&output);
-            delete redoResponsePB;
-            redoResponsePB = nullptr;
-
-            if (unlikely(!ret))
+            if (unlikely(!serializeResponse()))
                 throw RuntimeException(50017, "PB insert processing failed, error serializing to string");
-            append(output);
-            builderCommit();
+            messageCommit(true);
         }
         ++num;
     }
@@ -167,7 +223,7 @@ namespace OpenLogReplicator {
             if (unlikely(redoResponsePB == nullptr))
                 throw RuntimeException(50018, "PB update processing failed, a message is missing");
         } else {
-            builderBegin(scn, sequence, obj, BuilderMsg::OUTPUT_BUFFER::NONE);
+            messageBegin(scn, sequence, obj, true, BuilderMsg::OP::UPDATE);
             createResponse();
             appendHeader(scn, timestamp, true, format.isDbFormatAddDml(), true);
         }
@@ -183,15 +239,9 @@ namespace OpenLogReplicator {
         appendAfter(lobCtx, xmlCtx, table, fileOffset);
 
         if (!format.isMessageFormatFull()) {
-            std::string output;
-            const bool ret = redoResponsePB->SerializeToString(&output);
-            delete redoResponsePB;
-            redoResponsePB = nullptr;
-
-            if (unlikely(!ret))
+            if (unlikely(!serializeResponse()))
                 throw RuntimeException(50017, "PB update processing failed, error serializing to string");
-            append(output);
-            builderCommit();
+            messageCommit(true);
         }
         ++num;
     }
@@ -205,7 +255,7 @@ namespace OpenLogReplicator {
             if (unlikely(redoResponsePB == nullptr))
                 throw RuntimeException(50018, "PB delete processing failed, a message is missing");
         } else {
-            builderBegin(scn, sequence, obj, BuilderMsg::OUTPUT_BUFFER::NONE);
+            messageBegin(scn, sequence, obj, true, BuilderMsg::OP::DELETE);
             createResponse();
             appendHeader(scn, timestamp, true, format.isDbFormatAddDml(), true);
         }
@@ -220,15 +270,9 @@ namespace OpenLogReplicator {
         appendBefore(lobCtx, xmlCtx, table, fileOffset);
 
         if (!format.isMessageFormatFull()) {
-            std::string output;
-            const bool ret = redoResponsePB->SerializeToString(&output);
-            delete redoResponsePB;
-            redoResponsePB = nullptr;
-
-            if (unlikely(!ret))
+            if (unlikely(!serializeResponse()))
                 throw RuntimeException(50017, "PB delete processing failed, error serializing to string");
-            append(output);
-            builderCommit();
+            messageCommit(true);
         }
         ++num;
     }
@@ -241,7 +285,7 @@ namespace OpenLogReplicator {
             if (unlikely(redoResponsePB == nullptr))
                 throw RuntimeException(50018, "PB commit processing failed, a message is missing");
         } else {
-            builderBegin(scn, sequence, obj, BuilderMsg::OUTPUT_BUFFER::NONE);
+            messageBegin(scn, sequence, obj, true, BuilderMsg::OP::DDL);
             createResponse();
             appendHeader(scn, timestamp, true, format.isDbFormatAddDdl(), true);
 
@@ -258,15 +302,9 @@ namespace OpenLogReplicator {
         }
 
         if (!format.isMessageFormatFull()) {
-            std::string output;
-            const bool ret = redoResponsePB->SerializeToString(&output);
-            delete redoResponsePB;
-            redoResponsePB = nullptr;
-
-            if (unlikely(!ret))
+            if (unlikely(!serializeResponse()))
                 throw RuntimeException(50017, "PB commit processing failed, error serializing to string");
-            append(output);
-            builderCommit();
+            messageCommit(true);
         }
         ++num;
     }
@@ -288,7 +326,7 @@ namespace OpenLogReplicator {
             if (unlikely(redoResponsePB == nullptr))
                 throw RuntimeException(50018, "PB commit processing failed, a message is missing");
         } else {
-            builderBegin(scn, sequence, 0, BuilderMsg::OUTPUT_BUFFER::NONE);
+            messageBegin(scn, sequence, 0, true, BuilderMsg::OP::COMMIT);
             createResponse();
             appendHeader(scn, timestamp, true, format.isDbFormatAddDml(), true);
 
@@ -297,20 +335,21 @@ namespace OpenLogReplicator {
             payloadPB->set_op(pb::COMMIT);
         }
 
-        std::string output;
-        const bool ret = redoResponsePB->SerializeToString(&output);
-        delete redoResponsePB;
-        redoResponsePB = nullptr;
-
-        if (unlikely(!ret))
+        if (unlikely(!serializeResponse()))
             throw RuntimeException(50017, "PB commit processing failed, error serializing to string");
-        append(output);
-        builderCommit();
+        messageCommit(false);
 
         num = 0;
     }
 
+    // Provisional rows are refused with this format when the configuration is read
+    void BuilderProtobuf::processRollback(Scn scn __attribute__((unused)), Seq sequence __attribute__((unused)),
+                                          time_t timestamp __attribute__((unused))) {
+        newTran = false;
+    }
+
     void BuilderProtobuf::processCheckpoint(Scn scn, Seq sequence, time_t timestamp __attribute__((unused)), FileOffset fileOffset, bool redo) {
+        batchClose();
         if (lwnScn != scn) {
             lwnScn = scn;
             lwnIdx = 0;
@@ -330,14 +369,8 @@ namespace OpenLogReplicator {
         payloadPB->set_offset(fileOffset.getData());
         payloadPB->set_redo(redo);
 
-        std::string output;
-        const bool ret = redoResponsePB->SerializeToString(&output);
-        delete redoResponsePB;
-        redoResponsePB = nullptr;
-
-        if (unlikely(!ret))
+        if (unlikely(!serializeResponse()))
             throw RuntimeException(50017, "PB commit processing failed, error serializing to string");
-        append(output);
         builderCommit();
     }
 }
@@ -20,6 +20,8 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #ifndef BUILDER_PROTOBUF_H_
 #define BUILDER_PROTOBUF_H_
 
+#include <memory>
+
 #include "../common/DbTable.h"
 #include "../common/OraProtoBuf.pb.h"
 #include "../metadata/Metadata.h"
@@ -29,6 +31,12 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 namespace OpenLogReplicator {
     class BuilderProtobuf final : public Builder {
     protected:
+        // First arena block, kept across messages so that a typical message needs no heap allocation
+        static constexpr uint64_t ARENA_BLOCK_SIZE{1024 * 1024};
+
+        std::unique_ptr<char[]> arenaBlock;
+        google::protobuf::Arena arena;
+        std::string serializeBuffer;
         pb::RedoResponse* redoResponsePB{nullptr};
         pb::Value* valuePB{nullptr};
         pb::Payload* payloadPB{nullptr};
@@ -144,7 +152,7 @@ namespace OpenLogReplicator {
 
                     case Format::TIMESTAMP_FORMAT::ISO8601:
                         char buffer[22];
-                        str.assign(buffer, Data::epochToIso8601(timestamp, buffer, true, true));
+                        str.assign(buffer, epochToIso8601(timestamp, buffer, true, true));
                         redoResponsePB->set_tms(str);
                         break;
 
@@ -401,10 +409,53 @@ namespace OpenLogReplicator {
             }
         }
 
+        static constexpr time_t TIMESTAMP_NANO_MAX_SECONDS{9223372035};
+
+        static bool timestampToNano(time_t timestamp, uint64_t fraction, int64_t& value);
+        static void timestampToIso8601(time_t timestamp, uint64_t fraction, std::string& value);
+
         void createResponse() {
             if (unlikely(redoResponsePB != nullptr))
                 throw RuntimeException(50016, "PB commit processing failed, message already exists");
-            redoResponsePB = new pb::RedoResponse;
+            redoResponsePB = google::protobuf::Arena::CreateMessage<pb::RedoResponse>(&arena);
+        }
+
+        static google::protobuf::ArenaOptions arenaOptions(char* block) {
+            google::protobuf::ArenaOptions options;
+            options.initial_block = block;
+            options.initial_block_size = ARENA_BLOCK_SIZE;
+            return options;
+        }
+
+        // Serializes the message straight into the output buffer when it fits, then releases all arena memory but the first block
+        bool serializeResponse() {
+            const uint64_t size = redoResponsePB->ByteSizeLong();
+            bool ret = true;
+            // Messages of a batch are length-delimited, as read by parseDelimitedFrom()
+            if (batchOpen) {
+                char prefix[10];
+                uint64_t prefixSize = 0;
+                uint64_t value = size;
+                while (value >= 0x80) {
+                    prefix[prefixSize++] = static_cast<char>((value & 0x7F) | 0x80);
+                    value >>= 7;
+                }
+                prefix[prefixSize++] = static_cast<char>(value);
+                appendArr(prefix, prefixSize);
+            }
+
+            if (likely(lastBuilderSize + messagePosition + size < outputBufferDataSize)) {
+                redoResponsePB->SerializeWithCachedSizesToArray(lastBuilderQueue->data + lastBuilderSize + messagePosition);
+                messagePosition += size;
+            } else {
+                ret = redoResponsePB->SerializeToString(&serializeBuffer);
+                if (likely(ret))
+                    append(serializeBuffer);
+            }
+
+            redoResponsePB = nullptr;
+            arena.Reset();
+            return ret;
         }
 
         static void numToString(uint64_t value, char* buf, uint64_t size) {
@@ -420,6 +471,7 @@ namespace OpenLogReplicator {
         void columnDouble(const std::string& columnName, long double value) override;
         void columnString(const std::string& columnName) override;
         void columnNumber(const std::string& columnName, int precision, int scale) override;
+        void columnNumberData(const std::string& columnName, int precision, int scale, const uint8_t* data, uint64_t size, FileOffset fileOffset) override;
         void columnRaw(const std::string& columnName, const uint8_t* data, uint64_t size) override;
         void columnRowId(const std::string& columnName, RowId rowId) override;
         void columnTimestamp(const std::string& columnName, time_t timestamp, uint64_t fraction) override;
@@ -438,8 +490,15 @@ namespace OpenLogReplicator {
         ~BuilderProtobuf() override;
 
         void initialize() override;
+
+        [[nodiscard]] bool isProtobuf() const override {
+            return true;
+        }
         void processCommit(Scn scn, Seq sequence, time_t timestamp) override;
+        void processRollback(Scn scn, Seq sequence, time_t timestamp) override;
         void processCheckpoint(Scn scn, Seq sequence, time_t timestamp, FileOffset fileOffset, bool redo) override;
+
+        friend class BuilderBench;
     };
 }
 
@@ -0,0 +1,216 @@
+/* Background writer of large LOB values
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+#include "../common/Ctx.h"
+#include "../common/Sha256.h"
+#include "../common/exception/ConfigurationException.h"
+#include "../common/exception/RuntimeException.h"
+#include "LobStore.h"
+
+namespace OpenLogReplicator {
+    LobStore::LobStore(Ctx* newCtx, std::string newAlias, std::string newPath, uint64_t newSizeMin, uint64_t newQueueSizeMax) :
+            Thread(newCtx, std::move(newAlias)),
+            path(std::move(newPath)),
+            queueSizeMax(newQueueSizeMax),
+            sizeMin(newSizeMin) {
+    }
+
+    LobStore::~LobStore() {
+        for (const Lob& lob: queue)
+            delete[] lob.data;
+        queue.clear();
+    }
+
+    void LobStore::initialize() const {
+        struct stat fileStat{};
+        if (stat(path.c_str(), &fileStat) != 0 || !S_ISDIR(fileStat.st_mode))
+            throw ConfigurationException(30001, "bad JSON, invalid \"lob-store\" \"path\" value: " + path + ", expected: existing directory");
+    }
+
+    // Called by the builder, the hash is known at once and the file is written later. Waits when the queue is full,
+    // so that a slow disk bounds the memory used by queued values
+    std::string LobStore::store(Thread* t, const uint8_t* data, uint64_t size) {
+        Lob lob{Sha256::hex(data, size), new uint8_t[size], size};
+        memcpy(lob.data, data, size);
+        std::string hash = lob.hash;
+
+        {
+            if (t != nullptr)
+                t->contextSet(CONTEXT::MUTEX, REASON::LOB_STORE);
+            std::unique_lock<std::mutex> lck(mtx);
+            while (!done && !stopped && !ctx->hardShutdown && queueSize > 0 && queueSize + size > queueSizeMax) {
+                if (t != nullptr)
+                    t->contextSet(CONTEXT::WAIT, REASON::LOB_STORE_FULL);
+                condFree.wait_for(lck, std::chrono::milliseconds(100));
+            }
+
+            if (!done && !stopped) {
+                queueSize += size;
+                queue.push_back(std::move(lob));
+                condWork.notify_all();
+                if (t != nullptr)
+                    t->contextSet(CONTEXT::CPU);
+                return hash;
+            }
+        }
+
+        if (t != nullptr)
+            t->contextSet(CONTEXT::CPU);
+        try {
+            storeFile(t, lob);
+        } catch (RuntimeException&) {
+            delete[] lob.data;
+            throw;
+        }
+        delete[] lob.data;
+        return hash;
+    }
+
+    void LobStore::stop() {
+        std::unique_lock<std::mutex> const lck(mtx);
+        stopped = true;
+        condWork.notify_all();
+    }
+
+    void LobStore::wakeUp() {
+        std::unique_lock<std::mutex> const lck(mtx);
+        condWork.notify_all();
+        condFree.notify_all();
+    }
+
+    // Written to a temporary name and renamed when synced, so a file with the final name is always complete
+    void LobStore::storeFile(Thread* t, const Lob& lob) {
+        const std::string dirName = path + "/" + lob.hash.substr(0, 2);
+        const std::string fileName = dirName + "/" + lob.hash;
+
+        struct stat fileStat{};
+        if (stat(fileName.c_str(), &fileStat) == 0 && static_cast<uint64_t>(fileStat.st_size) == lob.size) {
+            if (unlikely(ctx->isTraceSet(Ctx::TRACE::LOB)))
+                ctx->logTrace(Ctx::TRACE::LOB, "lob store: " + lob.hash + " already stored");
+            return;
+        }
+
+        if (t != nullptr)
+            t->contextSet(CONTEXT::OS, REASON::OS);
+        if (mkdir(dirName.c_str(), 0755) != 0 && errno != EEXIST)
+            throw RuntimeException(10087, "lob store: " + dirName + " - mkdir returned: " + strerror(errno));
+
+        const std::string tmpName = fileName + ".tmp";
+        const int fd = open(tmpName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd == -1)
+            throw RuntimeException(10087, "lob store: " + tmpName + " - open returned: " + strerror(errno));
+
+        uint64_t written = 0;
+        while (written < lob.size) {
+            const ssize_t bytes = write(fd, lob.data + written, lob.size - written);
+            if (bytes < 0) {
+                if (errno == EINTR)
+                    continue;
+                const std::string error = strerror(errno);
+                close(fd);
+                throw RuntimeException(10087, "lob store: " + tmpName + " - write returned: " + error);
+            }
+            written += bytes;
+        }
+
+        if (fdatasync(fd) != 0) {
+            const std::string error = strerror(errno);
+            close(fd);
+            throw RuntimeException(10087, "lob store: " + tmpName + " - fdatasync returned: " + error);
+        }
+        close(fd);
+
+        if (rename(tmpName.c_str(), fileName.c_str()) != 0)
+            throw RuntimeException(10087, "lob store: " + fileName + " - rename returned: " + strerror(errno));
+        if (t != nullptr)
+            t->contextSet(CONTEXT::CPU);
+
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::LOB)))
+            ctx->logTrace(Ctx::TRACE::LOB, "lob store: " + lob.hash + " size: " + std::to_string(lob.size));
+    }
+
+    void LobStore::run() {
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
+            std::ostringstream ss;
+            ss << std::this_thread::get_id();
+            ctx->logTrace(Ctx::TRACE::THREADS, "lob store (" + ss.str() + ") start");
+        }
+
+        try {
+            while (!ctx->hardShutdown) {
+                Lob lob;
+                {
+                    contextSet(CONTEXT::MUTEX, REASON::LOB_STORE);
+                    std::unique_lock<std::mutex> lck(mtx);
+                    if (queue.empty()) {
+                        // Queued values are written before the thread exits
+                        if (stopped || ctx->softShutdown)
+                            break;
+                        if (unlikely(ctx->isTraceSet(Ctx::TRACE::SLEEP)))
+                            ctx->logTrace(Ctx::TRACE::SLEEP, "LobStore:run");
+                        contextSet(CONTEXT::WAIT, REASON::LOB_STORE_NO_WORK);
+                        condWork.wait_for(lck, std::chrono::milliseconds(100));
+                        continue;
+                    }
+                    lob = std::move(queue.front());
+                    queue.pop_front();
+                }
+                contextSet(CONTEXT::CPU);
+
+                try {
+                    storeFile(this, lob);
+                } catch (RuntimeException&) {
+                    delete[] lob.data;
+                    throw;
+                }
+                delete[] lob.data;
+
+                {
+                    contextSet(CONTEXT::MUTEX, REASON::LOB_STORE);
+                    std::unique_lock<std::mutex> const lck(mtx);
+                    queueSize -= lob.size;
+                    condFree.notify_all();
+                }
+                contextSet(CONTEXT::CPU);
+            }
+        } catch (RuntimeException& ex) {
+            ctx->error(ex.code, ex.msg);
+            ctx->stopHard();
+        }
+
+        {
+            std::unique_lock<std::mutex> const lck(mtx);
+            done = true;
+            condFree.notify_all();
+        }
+
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
+            std::ostringstream ss;
+            ss << std::this_thread::get_id();
+            ctx->logTrace(Ctx::TRACE::THREADS, "lob store (" + ss.str() + ") stop");
+        }
+    }
+}
@@ -0,0 +1,73 @@
+/* Header for LobStore class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef LOB_STORE_H_
+#define LOB_STORE_H_
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#include "../common/Thread.h"
+
+namespace OpenLogReplicator {
+    // Background thread writing large LOB values to a content-addressed directory, the message carries only the hash and the length.
+    // Files are named by the SHA-256 of the value, so a value stored before is not written again
+    class LobStore final : public Thread {
+    protected:
+        struct Lob {
+            std::string hash;
+            uint8_t* data{nullptr};
+            uint64_t size{0};
+        };
+
+        std::string path;
+        uint64_t queueSizeMax;
+
+        std::mutex mtx;
+        std::condition_variable condWork;
+        std::condition_variable condFree;
+        std::deque<Lob> queue;
+        uint64_t queueSize{0};
+        bool stopped{false};
+        // Set when the thread has exited, later values are written by the caller
+        bool done{false};
+
+        void run() override;
+        void storeFile(Thread* t, const Lob& lob);
+
+    public:
+        // Values shorter than that stay in the message
+        uint64_t sizeMin;
+
+        LobStore(Ctx* newCtx, std::string newAlias, std::string newPath, uint64_t newSizeMin, uint64_t newQueueSizeMax);
+        ~LobStore() override;
+
+        void initialize() const;
+        std::string store(Thread* t, const uint8_t* data, uint64_t size);
+        void stop();
+        void wakeUp() override;
+
+        std::string getName() const override {
+            return {"LobStore: " + alias};
+        }
+    };
+}
+
+#endif
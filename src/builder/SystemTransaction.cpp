@@ -384,8 +384,8 @@ namespace OpenLogReplicator {
         }
     }
 
-    template<class TABLE, class TABLEKEY, class TABLEUNORDEREDKEY>
-    void SystemTransaction::updateAllValues(TablePack<TABLE, TABLEKEY, TABLEUNORDEREDKEY>* pack, const DbTable* table, TABLE* row, FileOffset fileOffset) {
+    template<class TABLE, class TABLEKEY, class TABLEUNORDEREDKEY, template<class, class> class TABLEMAP>
+    void SystemTransaction::updateAllValues(TablePack<TABLE, TABLEKEY, TABLEUNORDEREDKEY, TABLEMAP>* pack, const DbTable* table, TABLE* row, FileOffset fileOffset) {
         const typeCol baseMax = builder->valuesMax >> 6;
         for (typeCol base = 0; base <= baseMax; ++base) {
             const auto columnBase = static_cast<typeCol>(base << 6);
@@ -424,6 +424,7 @@ namespace OpenLogReplicator {
     }
 
     void SystemTransaction::processInsert(const DbTable* table, typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset) {
+        metadata->schema->dictForUpdate();
         const RowId rowId(dataObj, bdba, slot);
         char str[RowId::SIZE + 1];
         rowId.toString(str);
@@ -435,69 +436,69 @@ namespace OpenLogReplicator {
                 break;
 
             case DbTable::TABLE::SYS_CCOL:
-                updateAllValues(&metadata->schema->sysCColPack, table, metadata->schema->sysCColPack.forInsert(ctx, rowId, fileOffset), fileOffset);
+                updateAllValues(&metadata->schema->dict->sysCColPack, table, metadata->schema->dict->sysCColPack.forInsert(ctx, rowId, fileOffset), fileOffset);
                 break;
 
             case DbTable::TABLE::SYS_CDEF:
-                updateAllValues(&metadata->schema->sysCDefPack, table, metadata->schema->sysCDefPack.forInsert(ctx, rowId, fileOffset), fileOffset);
+                updateAllValues(&metadata->schema->dict->sysCDefPack, table, metadata->schema->dict->sysCDefPack.forInsert(ctx, rowId, fileOffset), fileOffset);
                 break;
 
             case DbTable::TABLE::SYS_COL:
-                updateAllValues(&metadata->schema->sysColPack, table, metadata->schema->sysColPack.forInsert(ctx, rowId, fileOffset), fileOffset);
+                updateAllValues(&metadata->schema->dict->sysColPack, table, metadata->schema->dict->sysColPack.forInsert(ctx, rowId, fileOffset), fileOffset);
                 break;
 
             case DbTable::TABLE::SYS_DEFERRED_STG:
-                updateAllValues(&metadata->schema->sysDeferredStgPack, table, metadata->schema->sysDeferredStgPack.forInsert(ctx, rowId, fileOffset),
+                updateAllValues(&metadata->schema->dict->sysDeferredStgPack, table, metadata->schema->dict->sysDeferredStgPack.forInsert(ctx, rowId, fileOffset),
                                 fileOffset);
                 break;
 
             case DbTable::TABLE::SYS_ECOL:
-                updateAllValues(&metadata->schema->sysEColPack, table, metadata->schema->sysEColPack.forInsert(ctx, rowId, fileOffset), fileOffset);
+                updateAllValues(&metadata->schema->dict->sysEColPack, table, metadata->schema->dict->sysEColPack.forInsert(ctx, rowId, fileOffset), fileOffset);
                 break;
 
             case DbTable::TABLE::SYS_LOB:
-                updateAllValues(&metadata->schema->sysLobPack, table, metadata->schema->sysLobPack.forInsert(ctx, rowId, fileOffset), fileOffset);
+                updateAllValues(&metadata->schema->dict->sysLobPack, table, metadata->schema->dict->sysLobPack.forInsert(ctx, rowId, fileOffset), fileOffset);
                 break;
 
             case DbTable::TABLE::SYS_LOB_COMP_PART:
-                updateAllValues(&metadata->schema->sysLobCompPartPack, table, metadata->schema->sysLobCompPartPack.forInsert(ctx, rowId, fileOffset),
+                updateAllValues(&metadata->schema->dict->sysLobCompPartPack, table, metadata->schema->dict->sysLobCompPartPack.forInsert(ctx, rowId, fileOffset),
                                 fileOffset);
                 break;
 
             case DbTable::TABLE::SYS_LOB_FRAG:
-                updateAllValues(&metadata->schema->sysLobFragPack, table, metadata->schema->sysLobFragPack.forInsert(ctx, rowId, fileOffset), fileOffset);
+                updateAllValues(&metadata->schema->dict->sysLobFragPack, table, metadata->schema->dict->sysLobFragPack.forInsert(ctx, rowId, fileOffset), fileOffset);
                 break;
 
             case DbTable::TABLE::SYS_OBJ:
-                updateAllValues(&metadata->schema->sysObjPack, table, metadata->schema->sysObjPack.forInsert(ctx, rowId, fileOffset), fileOffset);
+                updateAllValues(&metadata->schema->dict->sysObjPack, table, metadata->schema->dict->sysObjPack.forInsert(ctx, rowId, fileOffset), fileOffset);
                 break;
 
             case DbTable::TABLE::SYS_TAB:
-                updateAllValues(&metadata->schema->sysTabPack, table, metadata->schema->sysTabPack.forInsert(ctx, rowId, fileOffset), fileOffset);
+                updateAllValues(&metadata->schema->dict->sysTabPack, table, metadata->schema->dict->sysTabPack.forInsert(ctx, rowId, fileOffset), fileOffset);
                 break;
 
             case DbTable::TABLE::SYS_TABCOMPART:
-                updateAllValues(&metadata->schema->sysTabComPartPack, table, metadata->schema->sysTabComPartPack.forInsert(ctx, rowId, fileOffset), fileOffset);
+                updateAllValues(&metadata->schema->dict->sysTabComPartPack, table, metadata->schema->dict->sysTabComPartPack.forInsert(ctx, rowId, fileOffset), fileOffset);
                 break;
 
             case DbTable::TABLE::SYS_TABPART:
-                updateAllValues(&metadata->schema->sysTabPartPack, table, metadata->schema->sysTabPartPack.forInsert(ctx, rowId, fileOffset), fileOffset);
+                updateAllValues(&metadata->schema->dict->sysTabPartPack, table, metadata->schema->dict->sysTabPartPack.forInsert(ctx, rowId, fileOffset), fileOffset);
                 break;
 
             case DbTable::TABLE::SYS_TABSUBPART:
-                updateAllValues(&metadata->schema->sysTabSubPartPack, table, metadata->schema->sysTabSubPartPack.forInsert(ctx, rowId, fileOffset), fileOffset);
+                updateAllValues(&metadata->schema->dict->sysTabSubPartPack, table, metadata->schema->dict->sysTabSubPartPack.forInsert(ctx, rowId, fileOffset), fileOffset);
                 break;
 
             case DbTable::TABLE::SYS_TS:
-                updateAllValues(&metadata->schema->sysTsPack, table, metadata->schema->sysTsPack.forInsert(ctx, rowId, fileOffset), fileOffset);
+                updateAllValues(&metadata->schema->dict->sysTsPack, table, metadata->schema->dict->sysTsPack.forInsert(ctx, rowId, fileOffset), fileOffset);
                 break;
 
             case DbTable::TABLE::SYS_USER:
-                updateAllValues(&metadata->schema->sysUserPack, table, metadata->schema->sysUserPack.forInsert(ctx, rowId, fileOffset), fileOffset);
+                updateAllValues(&metadata->schema->dict->sysUserPack, table, metadata->schema->dict->sysUserPack.forInsert(ctx, rowId, fileOffset), fileOffset);
                 break;
 
             case DbTable::TABLE::XDB_TTSET:
-                updateAllValues(&metadata->schema->xdbTtSetPack, table, metadata->schema->xdbTtSetPack.forInsert(ctx, rowId, fileOffset), fileOffset);
+                updateAllValues(&metadata->schema->dict->xdbTtSetPack, table, metadata->schema->dict->xdbTtSetPack.forInsert(ctx, rowId, fileOffset), fileOffset);
                 break;
 
             case DbTable::TABLE::XDB_XNM: {
@@ -522,6 +523,7 @@ namespace OpenLogReplicator {
     }
 
     void SystemTransaction::processUpdate(const DbTable* table, typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset) {
+        metadata->schema->dictForUpdate();
         const RowId rowId(dataObj, bdba, slot);
         char str[RowId::SIZE + 1];
         rowId.toString(str);
@@ -533,84 +535,84 @@ namespace OpenLogReplicator {
                 break;
 
             case DbTable::TABLE::SYS_CCOL:
-                if (auto* sysCCol = metadata->schema->sysCColPack.forUpdate(ctx, rowId, fileOffset))
-                    updateAllValues(&metadata->schema->sysCColPack, table, sysCCol, fileOffset);
+                if (auto* sysCCol = metadata->schema->dict->sysCColPack.forUpdate(ctx, rowId, fileOffset))
+                    updateAllValues(&metadata->schema->dict->sysCColPack, table, sysCCol, fileOffset);
                 break;
 
             case DbTable::TABLE::SYS_CDEF:
-                if (auto* sysCDef = metadata->schema->sysCDefPack.forUpdate(ctx, rowId, fileOffset))
-                    updateAllValues(&metadata->schema->sysCDefPack, table, sysCDef, fileOffset);
+                if (auto* sysCDef = metadata->schema->dict->sysCDefPack.forUpdate(ctx, rowId, fileOffset))
+                    updateAllValues(&metadata->schema->dict->sysCDefPack, table, sysCDef, fileOffset);
                 break;
 
             case DbTable::TABLE::SYS_COL:
-                if (auto* sysCol = metadata->schema->sysColPack.forUpdate(ctx, rowId, fileOffset))
-                    updateAllValues(&metadata->schema->sysColPack, table, sysCol, fileOffset);
+                if (auto* sysCol = metadata->schema->dict->sysColPack.forUpdate(ctx, rowId, fileOffset))
+                    updateAllValues(&metadata->schema->dict->sysColPack, table, sysCol, fileOffset);
                 break;
 
             case DbTable::TABLE::SYS_DEFERRED_STG:
-                if (auto* sysDeferredStg = metadata->schema->sysDeferredStgPack.forUpdate(ctx, rowId, fileOffset))
-                    updateAllValues(&metadata->schema->sysDeferredStgPack, table, sysDeferredStg, fileOffset);
+                if (auto* sysDeferredStg = metadata->schema->dict->sysDeferredStgPack.forUpdate(ctx, rowId, fileOffset))
+                    updateAllValues(&metadata->schema->dict->sysDeferredStgPack, table, sysDeferredStg, fileOffset);
                 break;
 
             case DbTable::TABLE::SYS_ECOL:
-                if (auto* sysECol = metadata->schema->sysEColPack.forUpdate(ctx, rowId, fileOffset))
-                    updateAllValues(&metadata->schema->sysEColPack, table, sysECol, fileOffset);
+                if (auto* sysECol = metadata->schema->dict->sysEColPack.forUpdate(ctx, rowId, fileOffset))
+                    updateAllValues(&metadata->schema->dict->sysEColPack, table, sysECol, fileOffset);
                 break;
 
             case DbTable::TABLE::SYS_LOB:
-                if (auto* sysLob = metadata->schema->sysLobPack.forUpdate(ctx, rowId, fileOffset))
-                    updateAllValues(&metadata->schema->sysLobPack, table, sysLob, fileOffset);
+                if (auto* sysLob = metadata->schema->dict->sysLobPack.forUpdate(ctx, rowId, fileOffset))
+                    updateAllValues(&metadata->schema->dict->sysLobPack, table, sysLob, fileOffset);
                 break;
 
             case DbTable::TABLE::SYS_LOB_COMP_PART:
-                if (auto* sysLobCompPart = metadata->schema->sysLobCompPartPack.forUpdate(ctx, rowId, fileOffset))
-                    updateAllValues(&metadata->schema->sysLobCompPartPack, table, sysLobCompPart, fileOffset);
+                if (auto* sysLobCompPart = metadata->schema->dict->sysLobCompPartPack.forUpdate(ctx, rowId, fileOffset))
+                    updateAllValues(&metadata->schema->dict->sysLobCompPartPack, table, sysLobCompPart, fileOffset);
                 break;
 
             case DbTable::TABLE::SYS_LOB_FRAG:
-                if (auto* sysLobFrag = metadata->schema->sysLobFragPack.forUpdate(ctx, rowId, fileOffset))
-                    updateAllValues(&metadata->schema->sysLobFragPack, table, sysLobFrag, fileOffset);
+                if (auto* sysLobFrag = metadata->schema->dict->sysLobFragPack.forUpdate(ctx, rowId, fileOffset))
+                    updateAllValues(&metadata->schema->dict->sysLobFragPack, table, sysLobFrag, fileOffset);
                 break;
 
             case DbTable::TABLE::SYS_OBJ:
-                if (auto* sysObj = metadata->schema->sysObjPack.forUpdate(ctx, rowId, fileOffset))
-                    updateAllValues(&metadata->schema->sysObjPack, table, sysObj, fileOffset);
+                if (auto* sysObj = metadata->schema->dict->sysObjPack.forUpdate(ctx, rowId, fileOffset))
+                    updateAllValues(&metadata->schema->dict->sysObjPack, table, sysObj, fileOffset);
                 break;
 
             case DbTable::TABLE::SYS_TAB:
-                if (auto* sysTab = metadata->schema->sysTabPack.forUpdate(ctx, rowId, fileOffset))
-                    updateAllValues(&metadata->schema->sysTabPack, table, sysTab, fileOffset);
+                if (auto* sysTab = metadata->schema->dict->sysTabPack.forUpdate(ctx, rowId, fileOffset))
+                    updateAllValues(&metadata->schema->dict->sysTabPack, table, sysTab, fileOffset);
                 break;
 
 
             case DbTable::TABLE::SYS_TABCOMPART:
-                if (auto* sysTabComPart = metadata->schema->sysTabComPartPack.forUpdate(ctx, rowId, fileOffset))
-                    updateAllValues(&metadata->schema->sysTabComPartPack, table, sysTabComPart, fileOffset);
+                if (auto* sysTabComPart = metadata->schema->dict->sysTabComPartPack.forUpdate(ctx, rowId, fileOffset))
+                    updateAllValues(&metadata->schema->dict->sysTabComPartPack, table, sysTabComPart, fileOffset);
                 break;
 
             case DbTable::TABLE::SYS_TABPART:
-                if (auto* sysTabPart = metadata->schema->sysTabPartPack.forUpdate(ctx, rowId, fileOffset))
-                    updateAllValues(&metadata->schema->sysTabPartPack, table, sysTabPart, fileOffset);
+                if (auto* sysTabPart = metadata->schema->dict->sysTabPartPack.forUpdate(ctx, rowId, fileOffset))
+                    updateAllValues(&metadata->schema->dict->sysTabPartPack, table, sysTabPart, fileOffset);
                 break;
 
             case DbTable::TABLE::SYS_TABSUBPART:
-                if (auto* sysTabSubPart = metadata->schema->sysTabSubPartPack.forUpdate(ctx, rowId, fileOffset))
-                    updateAllValues(&metadata->schema->sysTabSubPartPack, table, sysTabSubPart, fileOffset);
+                if (auto* sysTabSubPart = metadata->schema->dict->sysTabSubPartPack.forUpdate(ctx, rowId, fileOffset))
+                    updateAllValues(&metadata->schema->dict->sysTabSubPartPack, table, sysTabSubPart, fileOffset);
                 break;
 
             case DbTable::TABLE::SYS_TS:
-                if (auto* sysTs = metadata->schema->sysTsPack.forUpdate(ctx, rowId, fileOffset))
-                    updateAllValues(&metadata->schema->sysTsPack, table, sysTs, fileOffset);
+                if (auto* sysTs = metadata->schema->dict->sysTsPack.forUpdate(ctx, rowId, fileOffset))
+                    updateAllValues(&metadata->schema->dict->sysTsPack, table, sysTs, fileOffset);
                 break;
 
             case DbTable::TABLE::SYS_USER:
-                if (auto* sysUser = metadata->schema->sysUserPack.forUpdate(ctx, rowId, fileOffset))
-                    updateAllValues(&metadata->schema->sysUserPack, table, sysUser, fileOffset);
+                if (auto* sysUser = metadata->schema->dict->sysUserPack.forUpdate(ctx, rowId, fileOffset))
+                    updateAllValues(&metadata->schema->dict->sysUserPack, table, sysUser, fileOffset);
                 break;
 
             case DbTable::TABLE::XDB_TTSET:
-                if (auto* xdbTtSet = metadata->schema->xdbTtSetPack.forUpdate(ctx, rowId, fileOffset))
-                    updateAllValues(&metadata->schema->xdbTtSetPack, table, xdbTtSet, fileOffset);
+                if (auto* xdbTtSet = metadata->schema->dict->xdbTtSetPack.forUpdate(ctx, rowId, fileOffset))
+                    updateAllValues(&metadata->schema->dict->xdbTtSetPack, table, xdbTtSet, fileOffset);
                 break;
 
             case DbTable::TABLE::XDB_XNM: {
@@ -637,6 +639,7 @@ namespace OpenLogReplicator {
     }
 
     void SystemTransaction::processDelete(const DbTable* table, typeDataObj dataObj, typeDba bdba, typeSlot slot, FileOffset fileOffset) {
+        metadata->schema->dictForUpdate();
         const RowId rowId(dataObj, bdba, slot);
         char str[RowId::SIZE + 1];
         rowId.toString(str);
@@ -648,67 +651,67 @@ namespace OpenLogReplicator {
                 break;
 
             case DbTable::TABLE::SYS_CCOL:
-                metadata->schema->sysCColPack.drop(ctx, rowId, fileOffset, true);
+                metadata->schema->dict->sysCColPack.drop(ctx, rowId, fileOffset, true);
                 break;
 
             case DbTable::TABLE::SYS_CDEF:
-                metadata->schema->sysCDefPack.drop(ctx, rowId, fileOffset, true);
+                metadata->schema->dict->sysCDefPack.drop(ctx, rowId, fileOffset, true);
                 break;
 
             case DbTable::TABLE::SYS_COL:
-                metadata->schema->sysColPack.drop(ctx, rowId, fileOffset, true);
+                metadata->schema->dict->sysColPack.drop(ctx, rowId, fileOffset, true);
                 break;
 
             case DbTable::TABLE::SYS_DEFERRED_STG:
-                metadata->schema->sysDeferredStgPack.drop(ctx, rowId, fileOffset, true);
+                metadata->schema->dict->sysDeferredStgPack.drop(ctx, rowId, fileOffset, true);
                 break;
 
             case DbTable::TABLE::SYS_ECOL:
-                metadata->schema->sysEColPack.drop(ctx, rowId, fileOffset, true);
+                metadata->schema->dict->sysEColPack.drop(ctx, rowId, fileOffset, true);
                 break;
 
             case DbTable::TABLE::SYS_LOB:
-                metadata->schema->sysLobPack.drop(ctx, rowId, fileOffset, true);
+                metadata->schema->dict->sysLobPack.drop(ctx, rowId, fileOffset, true);
                 break;
 
             case DbTable::TABLE::SYS_LOB_COMP_PART:
-                metadata->schema->sysLobCompPartPack.drop(ctx, rowId, fileOffset, true);
+                metadata->schema->dict->sysLobCompPartPack.drop(ctx, rowId, fileOffset, true);
                 break;
 
             case DbTable::TABLE::SYS_LOB_FRAG:
-                metadata->schema->sysLobFragPack.drop(ctx, rowId, fileOffset, true);
+                metadata->schema->dict->sysLobFragPack.drop(ctx, rowId, fileOffset, true);
                 break;
 
             case DbTable::TABLE::SYS_OBJ:
-                metadata->schema->sysObjPack.drop(ctx, rowId, fileOffset, true);
+                metadata->schema->dict->sysObjPack.drop(ctx, rowId, fileOffset, true);
                 break;
 
             case DbTable::TABLE::SYS_TAB:
-                metadata->schema->sysTabPack.drop(ctx, rowId, fileOffset, true);
+                metadata->schema->dict->sysTabPack.drop(ctx, rowId, fileOffset, true);
                 break;
 
             case DbTable::TABLE::SYS_TABCOMPART:
-                metadata->schema->sysTabComPartPack.drop(ctx, rowId, fileOffset, true);
+                metadata->schema->dict->sysTabComPartPack.drop(ctx, rowId, fileOffset, true);
                 break;
 
             case DbTable::TABLE::SYS_TABPART:
-                metadata->schema->sysTabPartPack.drop(ctx, rowId, fileOffset, true);
+                metadata->schema->dict->sysTabPartPack.drop(ctx, rowId, fileOffset, true);
                 break;
 
             case DbTable::TABLE::SYS_TABSUBPART:
-                metadata->schema->sysTabSubPartPack.drop(ctx, rowId, fileOffset, true);
+                metadata->schema->dict->sysTabSubPartPack.drop(ctx, rowId, fileOffset, true);
                 break;
 
             case DbTable::TABLE::SYS_TS:
-                metadata->schema->sysTsPack.drop(ctx, rowId, fileOffset, true);
+                metadata->schema->dict->sysTsPack.drop(ctx, rowId, fileOffset, true);
                 break;
 
             case DbTable::TABLE::SYS_USER:
-                metadata->schema->sysUserPack.drop(ctx, rowId, fileOffset, true);
+                metadata->schema->dict->sysUserPack.drop(ctx, rowId, fileOffset, true);
                 break;
 
             case DbTable::TABLE::XDB_TTSET:
-                metadata->schema->xdbTtSetPack.drop(ctx, rowId, fileOffset, true);
+                metadata->schema->dict->xdbTtSetPack.drop(ctx, rowId, fileOffset, true);
                 break;
 
             case DbTable::TABLE::XDB_XNM:
@@ -732,26 +735,8 @@ namespace OpenLogReplicator {
         if (!metadata->schema->touched)
             return;
 
-        std::vector<std::string> msgs;
-        std::unordered_map<typeObj, std::string> tablesDropped;
-        std::unordered_map<typeObj, std::string> tablesUpdated;
+        // The maps are rebuilt once for a run of system transactions, e.g. a partition maintenance batch, see Metadata::rebuildSchemaMaps
         metadata->schema->scn = scn;
-        metadata->schema->dropUnusedMetadata(metadata->users, metadata->schemaElements, tablesDropped);
-
-        metadata->buildMaps(msgs, tablesUpdated);
-        metadata->schema->resetTouched();
-
-        for (const auto& msg: msgs)
-            ctx->info(0, msg);
-        for (const auto& [obj, tableName]: tablesDropped) {
-            if (tablesUpdated.find(obj) != tablesUpdated.end())
-                continue;
-            ctx->info(0, "dropped metadata: " + tableName);
-        }
-        for (const auto& [_, tableName]: tablesUpdated) {
-            ctx->info(0, "updated metadata: " + tableName);
-        }
-
-        metadata->schema->updateXmlCtx();
+        metadata->schemaMapsPending = true;
     }
 }
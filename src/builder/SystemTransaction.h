@@ -64,8 +64,8 @@ namespace OpenLogReplicator {
         void updateValue(VALUE& val, typeCol column, const DbTable* table, FileOffset fileOffset, int defVal = 0, uint maxLength = 0);
         template<class TABLE>
         void updateValues(const DbTable* table, TABLE* row, typeCol column, FileOffset fileOffset);
-        template<class TABLE, class TABLEKEY, class TABLEUNORDEREDKEY>
-        void updateAllValues(TablePack<TABLE, TABLEKEY, TABLEUNORDEREDKEY>* pack, const DbTable* table, TABLE* row, FileOffset fileOffset);
+        template<class TABLE, class TABLEKEY, class TABLEUNORDEREDKEY, template<class, class> class TABLEMAP>
+        void updateAllValues(TablePack<TABLE, TABLEKEY, TABLEUNORDEREDKEY, TABLEMAP>* pack, const DbTable* table, TABLE* row, FileOffset fileOffset);
 
         XmlCtx* findMatchingXmlCtx(const DbTable* table) const;
 
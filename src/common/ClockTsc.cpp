@@ -0,0 +1,92 @@
+/* Calibrated CPU counter clock
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <chrono>
+#include <thread>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+#include "ClockTsc.h"
+
+namespace OpenLogReplicator {
+    bool ClockTsc::counterInvariant() {
+#if defined(__x86_64__) || defined(__i386__)
+        uint eax = 0;
+        uint ebx = 0;
+        uint ecx = 0;
+        uint edx = 0;
+        // Invariant TSC: constant rate in all power states, synchronized between cores
+        if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) == 0)
+            return false;
+        return (edx & (1 << 8)) != 0;
+#elif defined(__aarch64__)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    uint64_t ClockTsc::counterFrequency() {
+#if defined(__aarch64__)
+        uint64_t frequency;
+        asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+        return frequency;
+#else
+        // Measured over a short sleep against the raw monotonic clock
+        struct timespec start = {0, 0};
+        struct timespec end = {0, 0};
+        clock_gettime(CLOCK_MONOTONIC_RAW, &start);
+        const uint64_t startTicks = readCounter();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        clock_gettime(CLOCK_MONOTONIC_RAW, &end);
+        const uint64_t endTicks = readCounter();
+
+        const uint64_t elapsedNs = ((end.tv_sec - start.tv_sec) * 1000000000L) + end.tv_nsec - start.tv_nsec;
+        if (elapsedNs == 0 || endTicks <= startTicks)
+            return 0;
+        return (endTicks - startTicks) * 1000000000 / elapsedNs;
+#endif
+    }
+
+    bool ClockTsc::setSource(SOURCE newSource) {
+        switch (newSource) {
+            case SOURCE::TSC: {
+                if (!counterInvariant())
+                    return false;
+                const uint64_t frequency = counterFrequency();
+                if (frequency < 1000000)
+                    return false;
+                multiplier = (1000000ULL << SHIFT) / frequency;
+                baseTicks = readCounter();
+                baseTime = readHw();
+                break;
+            }
+
+            case SOURCE::COARSE:
+                baseTime = readHw() - readCoarse();
+                break;
+
+            case SOURCE::HW:
+                break;
+        }
+        source = newSource;
+        return true;
+    }
+}
@@ -0,0 +1,110 @@
+/* Header for ClockTsc class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <ctime>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "Clock.h"
+
+#ifndef CLOCK_TSC_H_
+#define CLOCK_TSC_H_
+
+namespace OpenLogReplicator {
+    // Clock for timing on hot paths. Called directly, not through Clock, so that the call is inlined.
+    // The CPU counter is calibrated against the wall clock once, values stay comparable with ClockHW
+    class ClockTsc final : public Clock {
+    public:
+        enum class SOURCE : unsigned char {
+            HW, COARSE, TSC
+        };
+
+    protected:
+        static constexpr uint SHIFT = 32;
+
+        SOURCE source{SOURCE::HW};
+        uint64_t baseTicks{0};
+        time_ut baseTime{0};
+        // Microseconds per counter tick, fixed point with SHIFT fraction bits
+        uint64_t multiplier{0};
+
+        static uint64_t readCounter() {
+#if defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#elif defined(__aarch64__)
+            uint64_t value;
+            asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+            return value;
+#else
+            return 0;
+#endif
+        }
+
+        static time_ut readHw() {
+            struct timeval tv = {0, 0};
+            gettimeofday(&tv, nullptr);
+            return (1000000 * tv.tv_sec) + tv.tv_usec;
+        }
+
+        static time_ut readCoarse() {
+            struct timespec ts = {0, 0};
+            clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+            return (1000000 * ts.tv_sec) + (ts.tv_nsec / 1000);
+        }
+
+        static bool counterInvariant();
+        static uint64_t counterFrequency();
+
+    public:
+        // False when the CPU has no constant rate counter, the source is then left unchanged
+        bool setSource(SOURCE newSource);
+
+        [[nodiscard]] SOURCE getSource() const {
+            return source;
+        }
+
+        [[nodiscard]] time_ut nowUt() const {
+            switch (source) {
+                case SOURCE::TSC: {
+                    // Split multiplication, the frequency is at least 1 MHz so the multiplier is at most 1 << SHIFT
+                    const uint64_t ticks = readCounter() - baseTicks;
+                    return baseTime + static_cast<time_ut>(((ticks >> SHIFT) * multiplier) + (((ticks & ((1ULL << SHIFT) - 1)) * multiplier) >> SHIFT));
+                }
+
+                case SOURCE::COARSE:
+                    return baseTime + readCoarse();
+
+                case SOURCE::HW:
+                    break;
+            }
+            return readHw();
+        }
+
+        [[nodiscard]] time_ut getTimeUt() const override {
+            return nowUt();
+        }
+
+        [[nodiscard]] time_t getTimeT() const override {
+            return static_cast<time_t>(nowUt() / 1000000);
+        }
+    };
+}
+
+#endif
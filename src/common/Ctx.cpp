@@ -22,14 +22,25 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include <algorithm>
 #include <cstdlib>
 #include <csignal>
+#include <cstring>
 #include <execinfo.h>
 #include <iostream>
 #include <set>
 #include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
 #include <unistd.h>
+#ifdef LINK_LIBRARY_NUMA
+#include <numa.h>
+#include <sched.h>
+#endif /* LINK_LIBRARY_NUMA */
 
 #include "ClockHW.h"
 #include "Ctx.h"
+#include "MemoryPool.h"
+#include "TableCost.h"
 #include "Thread.h"
 #include "exception/DataException.h"
 #include "exception/RuntimeException.h"
@@ -40,7 +51,8 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 OpenLogReplicator::Ctx::LOCALES OLR_LOCALES = OpenLogReplicator::Ctx::LOCALES::TIMESTAMP;
 
 namespace OpenLogReplicator {
-    const std::string Ctx::memoryModules[MEMORY_COUNT]{"builder", "parser", "reader", "transaction", "writer"};
+    const std::string Ctx::memoryModules[MEMORY_COUNT]{"builder", "misc", "parser", "reader", "transaction", "writer"};
+    std::atomic<uint64_t> Ctx::flightRecorderRequests{0};
 
     IntX IntX::BASE10[IntX::DIGITS][10];
 
@@ -56,17 +68,63 @@ namespace OpenLogReplicator {
     Ctx::~Ctx() {
         lobIdToXidMap.clear();
 
+        for (Thread* t: memoryCacheThreads) {
+            memoryCacheDrain(t);
+            t->memoryCacheRegistered = false;
+        }
+        memoryCacheThreads.clear();
+
+        for (uint module = 0; module < MEMORY_COUNT; ++module) {
+            if (memoryRegion == nullptr)
+                for (uint8_t* block: memoryBlocksFree[module])
+                    releaseMemoryBlock(block, memoryModuleChunks[module]);
+            memoryBlocksFree[module].clear();
+        }
+
+        if (memoryRegion != nullptr) {
+            munmap(memoryRegion, memoryRegionSize);
+            memoryRegion = nullptr;
+            memoryChunksAllocated = 0;
+        }
+
+        if (transactionMap != nullptr) {
+            munmap(transactionMap, transactionMapChunks * MEMORY_CHUNK_SIZE);
+            transactionMap = nullptr;
+            transactionMapFree.clear();
+        }
+
         while (memoryChunksAllocated > 0) {
             --memoryChunksAllocated;
-            free(memoryChunks[memoryChunksAllocated]);
+            releaseMemoryChunk(memoryChunks[memoryChunksAllocated]);
             memoryChunks[memoryChunksAllocated] = nullptr;
         }
 
+        if (memoryPool != nullptr && memoryPoolKeep > 0) {
+            memoryPool->removeKeep(memoryPoolKeep);
+            memoryPoolKeep = 0;
+        }
+        if (memoryPool != nullptr)
+            memoryPool->removeShare(&memoryShare);
+#if __linux__
+        removeCgroup();
+#endif
+
+        memoryChunkNodes.clear();
+        if (memoryChunksNode != nullptr) {
+            delete[] memoryChunksNode;
+            memoryChunksNode = nullptr;
+        }
+
         if (memoryChunks != nullptr) {
             delete[] memoryChunks;
             memoryChunks = nullptr;
         }
 
+        if (tableCost != nullptr) {
+            delete tableCost;
+            tableCost = nullptr;
+        }
+
         if (metrics != nullptr) {
             metrics->shutdown();
             delete metrics;
@@ -317,8 +375,114 @@ namespace OpenLogReplicator {
         return {ret.GetString()};
     }
 
+#if __linux__
+    bool Ctx::parseCpuList(const std::string& cpus, cpu_set_t& cpuSet) {
+        CPU_ZERO(&cpuSet);
+        uint count = 0;
+        size_t pos = 0;
+        while (pos <= cpus.length()) {
+            size_t end = cpus.find(',', pos);
+            if (end == std::string::npos)
+                end = cpus.length();
+            const std::string item = cpus.substr(pos, end - pos);
+            pos = end + 1;
+
+            const size_t dash = item.find('-');
+            const std::string firstStr = item.substr(0, dash);
+            const std::string lastStr = dash == std::string::npos ? firstStr : item.substr(dash + 1);
+            if (firstStr.empty() || lastStr.empty() || firstStr.find_first_not_of("0123456789") != std::string::npos ||
+                lastStr.find_first_not_of("0123456789") != std::string::npos || firstStr.length() > 4 || lastStr.length() > 4)
+                return false;
+
+            const uint first = std::stoul(firstStr);
+            const uint last = std::stoul(lastStr);
+            if (first > last || last >= CPU_SETSIZE)
+                return false;
+            for (uint cpu = first; cpu <= last; ++cpu) {
+                CPU_SET(cpu, &cpuSet);
+                ++count;
+            }
+        }
+        return count > 0;
+    }
+
+    static bool writeCgroupFile(const std::string& fileName, const std::string& value) {
+        const int fileDes = open(fileName.c_str(), O_WRONLY);
+        if (fileDes == -1)
+            return false;
+        const bool done = write(fileDes, value.c_str(), value.length()) == static_cast<ssize_t>(value.length());
+        close(fileDes);
+        return done;
+    }
+
+    // The group is a threaded child of the cgroup the process runs in, so that the threads of one process can be split between tenants.
+    // The cgroup of the process must be delegated to the user running it, without that the tenant runs with no CPU weight
+    bool Ctx::createCgroup(uint64_t cpuWeight) {
+        std::ifstream cgroupFile("/proc/self/cgroup");
+        std::string line;
+        std::string processPath;
+        while (std::getline(cgroupFile, line)) {
+            if (line.rfind("0::", 0) == 0) {
+                processPath = line.substr(3);
+                break;
+            }
+        }
+        if (processPath.empty()) {
+            warning(60062, "tenant: " + tenant + " - cgroup v2 not available, cpu weight ignored");
+            return false;
+        }
+
+        const std::string parentPath = "/sys/fs/cgroup" + (processPath == "/" ? std::string() : processPath);
+        const std::string path = parentPath + "/olr-" + tenant;
+        if (mkdir(path.c_str(), 0755) != 0 && errno != EEXIST) {
+            warning(60062, "tenant: " + tenant + " - creating cgroup: " + path + " failed: " + strerror(errno) + ", cpu weight ignored");
+            return false;
+        }
+
+        // The cpu controller may already be enabled for the children by another tenant
+        if (!writeCgroupFile(path + "/cgroup.type", "threaded") || !writeCgroupFile(parentPath + "/cgroup.subtree_control", "+cpu") ||
+            !writeCgroupFile(path + "/cpu.weight", std::to_string(cpuWeight))) {
+            warning(60062, "tenant: " + tenant + " - configuring cgroup: " + path + " failed: " + strerror(errno) + ", cpu weight ignored");
+            rmdir(path.c_str());
+            return false;
+        }
+
+        cgroupPath = path;
+        cgroupParentPath = parentPath;
+        info(0, "tenant: " + tenant + " - cgroup: " + cgroupPath + ", cpu weight: " + std::to_string(cpuWeight));
+        joinCgroup();
+        return true;
+    }
+
+    // Called by the thread itself, threads created later by the thread, like those of client libraries, stay in the group
+    void Ctx::joinCgroup() {
+        if (cgroupPath.empty())
+            return;
+        if (!writeCgroupFile(cgroupPath + "/cgroup.threads", std::to_string(syscall(SYS_gettid))))
+            warning(60062, "tenant: " + tenant + " - moving thread to cgroup: " + cgroupPath + " failed: " + strerror(errno));
+    }
+
+    // The group can only be removed once all threads left it, a thread of a client library still running keeps it until the next start
+    void Ctx::removeCgroup() {
+        if (cgroupPath.empty())
+            return;
+        writeCgroupFile(cgroupParentPath + "/cgroup.threads", std::to_string(syscall(SYS_gettid)));
+        rmdir(cgroupPath.c_str());
+        cgroupPath.clear();
+    }
+#endif
+
     void Ctx::initialize(uint64_t memoryMinMb, uint64_t memoryMaxMb, uint64_t memoryReadBufferMaxMb, uint64_t memoryReadBufferMinMb, uint64_t memorySwapMb,
                          uint64_t memoryUnswapBufferMinMb, uint64_t memoryWriteBufferMaxMb, uint64_t memoryWriteBufferMinMb) {
+        if (hugePages != HUGE_PAGES::NONE) {
+            memoryRegionSize = memoryMaxMb / MEMORY_CHUNK_SIZE_MB * MEMORY_CHUNK_SIZE;
+            mapMemoryRegion();
+        }
+        if (transactionMapMb > 0) {
+            mapTransactionMemory();
+            memorySwapMb = 0;
+        }
+
         {
             std::unique_lock<std::mutex> const lck(memoryMtx);
             memoryChunksMin = memoryMinMb / MEMORY_CHUNK_SIZE_MB;
@@ -333,14 +497,24 @@ namespace OpenLogReplicator {
             bufferSizeMax = memoryReadBufferMaxMb * 1024 * 1024;
             bufferSizeFree = memoryReadBufferMaxMb / MEMORY_CHUNK_SIZE_MB;
 
+            // With a shared pool the reserve is kept by the pool, where the other tenants can borrow it while this one is idle
+            if (memoryPool != nullptr && memoryRegion == nullptr) {
+                memoryPoolKeep = memoryChunksMin;
+                memoryPool->addKeep(memoryPoolKeep);
+                memoryPool->addShare(&memoryShare);
+                memoryChunksMin = 0;
+            }
+
             memoryChunks = new uint8_t* [memoryChunksMax];
+            if (numa)
+                memoryChunksNode = new uint8_t[memoryChunksMax];
             for (uint64_t i = 0; i < memoryChunksMin; ++i) {
-                memoryChunks[i] = reinterpret_cast<uint8_t*>(aligned_alloc(MEMORY_ALIGNMENT, MEMORY_CHUNK_SIZE));
-                if (unlikely(memoryChunks[i] == nullptr))
+                uint8_t* chunk = allocateMemoryChunk(i % numaNodes);
+                if (unlikely(chunk == nullptr))
                     throw RuntimeException(10016, "couldn't allocate " + std::to_string(MEMORY_CHUNK_SIZE_MB) +
                                                   " bytes memory for: memory chunks#2");
                 ++memoryChunksAllocated;
-                ++memoryChunksFree;
+                pushFreeChunk(chunk, false);
             }
             memoryChunksHWM = memoryChunksMin;
         }
@@ -361,7 +535,7 @@ namespace OpenLogReplicator {
         {
             t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::CTX_NOTHING_TO_SWAP);
             std::unique_lock<std::mutex> const lck(memoryMtx);
-            ret = memoryChunksSwap == 0 || (memoryChunksAllocated - memoryChunksFree < memoryChunksSwap);
+            ret = memoryChunksSwap == 0 || (memoryChunksAllocated - memoryChunksFree - memoryChunksCached - memoryBlockChunksFree < memoryChunksSwap);
         }
         t->contextSet(Thread::CONTEXT::CPU);
         return ret;
@@ -388,6 +562,15 @@ namespace OpenLogReplicator {
         return memoryChunksAllocated * MEMORY_CHUNK_SIZE_MB;
     }
 
+    // Lock-free, module counters are atomic and may be read while the pipeline runs
+    uint64_t Ctx::getMemoryModuleMb(MEMORY module) const {
+        return memoryModulesAllocated[static_cast<uint>(module)].load(std::memory_order_relaxed) * MEMORY_CHUNK_SIZE_MB;
+    }
+
+    uint64_t Ctx::getMemoryModuleHwmMb(MEMORY module) const {
+        return memoryModulesHWM[static_cast<uint>(module)].load(std::memory_order_relaxed) * MEMORY_CHUNK_SIZE_MB;
+    }
+
     uint64_t Ctx::getSwapMemory(Thread* t) const {
         uint64_t ret;
         {
@@ -399,16 +582,289 @@ namespace OpenLogReplicator {
         return ret;
     }
 
-    uint8_t* Ctx::getMemoryChunk(Thread* t, MEMORY module, bool swap) {
+    void Ctx::emitMemoryUsedModule(MEMORY module, uint64_t allocatedModule) {
+        switch (module) {
+            case MEMORY::BUILDER:
+                metrics->emitMemoryUsedMbBuilder(allocatedModule * MEMORY_CHUNK_SIZE_MB);
+                break;
+
+            case MEMORY::MISC:
+                metrics->emitMemoryUsedMbMisc(allocatedModule * MEMORY_CHUNK_SIZE_MB);
+                break;
+
+            case MEMORY::PARSER:
+                metrics->emitMemoryUsedMbParser(allocatedModule * MEMORY_CHUNK_SIZE_MB);
+                break;
+
+            case MEMORY::READER:
+                metrics->emitMemoryUsedMbReader(allocatedModule * MEMORY_CHUNK_SIZE_MB);
+                break;
+
+            case MEMORY::TRANSACTIONS:
+                metrics->emitMemoryUsedMbTransactions(allocatedModule * MEMORY_CHUNK_SIZE_MB);
+                break;
+
+            case MEMORY::WRITER:
+                metrics->emitMemoryUsedMbWriter(allocatedModule * MEMORY_CHUNK_SIZE_MB);
+        }
+    }
+
+    void Ctx::updateMemoryModuleHWM(MEMORY module, uint64_t allocatedModule) {
+        uint64_t hwm = memoryModulesHWM[static_cast<uint>(module)].load(std::memory_order_relaxed);
+        while (hwm < allocatedModule && !memoryModulesHWM[static_cast<uint>(module)].compare_exchange_weak(hwm, allocatedModule,
+                                                                                                            std::memory_order_relaxed)) {
+        }
+    }
+
+    uint Ctx::memoryNode(const Thread* t) const {
+        if (!numa)
+            return 0;
+        if (t->numaNode >= 0)
+            return t->numaNode;
+#ifdef LINK_LIBRARY_NUMA
+        const int cpu = sched_getcpu();
+        if (cpu >= 0) {
+            const int node = numa_node_of_cpu(cpu);
+            if (node >= 0 && static_cast<uint>(node) < numaNodes)
+                return node;
+        }
+#endif /* LINK_LIBRARY_NUMA */
+        return 0;
+    }
+
+    void Ctx::mapMemoryRegion() {
+        // Try the requested page size first and fall back to smaller pages
+        HUGE_PAGES pages = hugePages;
+#ifdef MAP_HUGETLB
+        while (pages == HUGE_PAGES::HUGE_1GB || pages == HUGE_PAGES::HUGE_2MB) {
+            const uint64_t pageSize = pages == HUGE_PAGES::HUGE_1GB ? 1024 * 1024 * 1024 : 2 * 1024 * 1024;
+            const int pageFlag = (pages == HUGE_PAGES::HUGE_1GB ? 30 : 21) << MAP_HUGE_SHIFT;
+            const uint64_t size = (memoryRegionSize + pageSize - 1) / pageSize * pageSize;
+            void* region = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | pageFlag, -1, 0);
+            if (region != MAP_FAILED) {
+                memoryRegion = reinterpret_cast<uint8_t*>(region);
+                memoryRegionSize = size;
+                memoryPages = pages;
+                return;
+            }
+
+            warning(10074, "can't map " + std::to_string(size / 1024 / 1024) + "MB of " + memoryPagesName(pages) + " huge pages: " +
+                           strerror(errno) + ", falling back to smaller pages");
+            pages = pages == HUGE_PAGES::HUGE_1GB ? HUGE_PAGES::HUGE_2MB : HUGE_PAGES::TRANSPARENT;
+        }
+#else
+        pages = HUGE_PAGES::TRANSPARENT;
+#endif
+
+        void* region = mmap(nullptr, memoryRegionSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (unlikely(region == MAP_FAILED))
+            throw RuntimeException(10016, "couldn't allocate " + std::to_string(memoryRegionSize) + " bytes memory for: memory chunks#3");
+        memoryRegion = reinterpret_cast<uint8_t*>(region);
+        memoryPages = HUGE_PAGES::NONE;
+
+#ifdef MADV_HUGEPAGE
+        if (madvise(memoryRegion, memoryRegionSize, MADV_HUGEPAGE) == 0)
+            memoryPages = HUGE_PAGES::TRANSPARENT;
+        else
+            warning(10074, "can't use transparent huge pages: " + std::string(strerror(errno)) + ", using standard pages");
+#endif
+    }
+
+    // The file is unlinked as soon as it is mapped, nothing is left behind after a crash. It is sparse, only chunks in use take disk space
+    void Ctx::mapTransactionMemory() {
+        const std::string fileName = transactionMapPath + "/" + TRANSACTION_MAP_FILE_NAME;
+        const uint64_t size = transactionMapMb / MEMORY_CHUNK_SIZE_MB * MEMORY_CHUNK_SIZE;
+        const int fileDes = open(fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IWUSR | S_IRUSR);
+        if (unlikely(fileDes == -1))
+            throw RuntimeException(10099, "file: " + fileName + " - open for transaction memory returned: " + strerror(errno));
+        unlink(fileName.c_str());
+
+        if (unlikely(ftruncate(fileDes, static_cast<off_t>(size)) != 0)) {
+            const std::string err(strerror(errno));
+            close(fileDes);
+            throw RuntimeException(10099, "file: " + fileName + " - resize to " + std::to_string(transactionMapMb) + "MB returned: " + err);
+        }
+
+        void* region = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fileDes, 0);
+        const std::string err(strerror(errno));
+        close(fileDes);
+        if (unlikely(region == MAP_FAILED))
+            throw RuntimeException(10099, "file: " + fileName + " - mapping " + std::to_string(transactionMapMb) + "MB returned: " + err);
+
+        transactionMap = reinterpret_cast<uint8_t*>(region);
+        transactionMapChunks = size / MEMORY_CHUNK_SIZE;
+        transactionMapFree.reserve(transactionMapChunks);
+        info(0, "transaction memory: " + std::to_string(transactionMapMb) + "MB mapped from: " + fileName);
+    }
+
+    std::string Ctx::memoryPagesName(HUGE_PAGES pages) {
+        switch (pages) {
+            case HUGE_PAGES::TRANSPARENT:
+                return "transparent";
+            case HUGE_PAGES::HUGE_2MB:
+                return "2MB";
+            case HUGE_PAGES::HUGE_1GB:
+                return "1GB";
+            default:
+                return "4KB";
+        }
+    }
+
+    uint8_t* Ctx::allocateMemoryChunk(uint node) {
+        uint8_t* chunk;
+        if (memoryRegion != nullptr)
+            chunk = memoryRegion + memoryChunksAllocated * MEMORY_CHUNK_SIZE;
+        else if (memoryPool != nullptr)
+            chunk = memoryPool->acquireChunk(&memoryShare);
+        else
+            chunk = reinterpret_cast<uint8_t*>(aligned_alloc(MEMORY_ALIGNMENT, MEMORY_CHUNK_SIZE));
+        if (chunk == nullptr || !numa)
+            return chunk;
+
+#ifdef LINK_LIBRARY_NUMA
+        // The pages are not touched yet, binding places them on the node on first use
+        numa_tonode_memory(chunk, MEMORY_CHUNK_SIZE, static_cast<int>(node));
+#endif /* LINK_LIBRARY_NUMA */
+        memoryChunkNodes.insert_or_assign(chunk, node);
+        return chunk;
+    }
+
+    void Ctx::releaseMemoryChunkNode(uint8_t* chunk) {
+        if (!numa)
+            return;
+
+        const auto& it = memoryChunkNodes.find(chunk);
+        if (it == memoryChunkNodes.end())
+            return;
+        --memoryNodeUsed[it->second];
+        memoryChunkNodes.erase(it);
+    }
+
+    void Ctx::releaseMemoryChunk(uint8_t* chunk) {
+        if (memoryPool != nullptr)
+            memoryPool->releaseChunk(&memoryShare, chunk);
+        else
+            free(chunk);
+    }
+
+    uint8_t* Ctx::allocateMemoryBlock(uint64_t chunks) {
+        if (memoryRegion != nullptr)
+            return memoryRegion + memoryChunksAllocated * MEMORY_CHUNK_SIZE;
+
+        if (memoryPool != nullptr && !memoryPool->reserveChunks(&memoryShare, chunks))
+            return nullptr;
+        auto* block = reinterpret_cast<uint8_t*>(aligned_alloc(MEMORY_ALIGNMENT, chunks * MEMORY_CHUNK_SIZE));
+        if (block == nullptr && memoryPool != nullptr)
+            memoryPool->unreserveChunks(&memoryShare, chunks);
+        return block;
+    }
+
+    void Ctx::releaseMemoryBlock(uint8_t* block, uint64_t chunks) {
+        free(block);
+        if (memoryPool != nullptr)
+            memoryPool->unreserveChunks(&memoryShare, chunks);
+    }
+
+    void Ctx::pushFreeChunk(uint8_t* chunk, bool used) {
+        if (numa) {
+            const uint8_t node = memoryChunkNodes.at(chunk);
+            memoryChunksNode[memoryChunksFree] = node;
+            if (used)
+                --memoryNodeUsed[node];
+        }
+        memoryChunks[memoryChunksFree++] = chunk;
+    }
+
+    uint8_t* Ctx::popFreeChunk(const Thread* t, int64_t& nodeHwm) {
+        if (numa) {
+            // Prefer a chunk from the node of the caller, looking only at the top of the free stack
+            const uint8_t node = memoryNode(t);
+            const uint64_t last = memoryChunksFree > NUMA_SCAN_CHUNKS ? memoryChunksFree - NUMA_SCAN_CHUNKS : 0;
+            for (uint64_t i = memoryChunksFree; i > last; --i) {
+                if (memoryChunksNode[i - 1] != node)
+                    continue;
+                std::swap(memoryChunks[i - 1], memoryChunks[memoryChunksFree - 1]);
+                std::swap(memoryChunksNode[i - 1], memoryChunksNode[memoryChunksFree - 1]);
+                break;
+            }
+
+            const uint8_t chunkNode = memoryChunksNode[memoryChunksFree - 1];
+            if (++memoryNodeUsed[chunkNode] > memoryNodeHWM[chunkNode]) {
+                memoryNodeHWM[chunkNode] = memoryNodeUsed[chunkNode];
+                nodeHwm = chunkNode;
+            }
+        }
+        uint8_t* chunk = memoryChunks[--memoryChunksFree];
+        memoryChunksFreeLow = std::min(memoryChunksFreeLow, memoryChunksFree);
+        return chunk;
+    }
+
+    void Ctx::memoryCacheRegister(Thread* t) {
+        if (t->memoryCacheRegistered || t->finished)
+            return;
+        memoryCacheThreads.push_back(t);
+        t->memoryCacheRegistered = true;
+    }
+
+    bool Ctx::memoryCacheDrain(Thread* t) {
+        bool drained = false;
+        for (auto& slot: t->memoryCache) {
+            uint8_t* chunk = slot.exchange(nullptr);
+            if (chunk == nullptr)
+                continue;
+            pushFreeChunk(chunk, true);
+            --memoryChunksCached;
+            drained = true;
+        }
+        return drained;
+    }
+
+    void Ctx::memoryCacheRelease(Thread* t) {
+        std::unique_lock<std::mutex> const lck(memoryMtx);
+        if (!t->memoryCacheRegistered)
+            return;
+
+        if (memoryCacheDrain(t))
+            condOutOfMemory.notify_all();
+        memoryCacheThreads.erase(std::remove(memoryCacheThreads.begin(), memoryCacheThreads.end(), t), memoryCacheThreads.end());
+        t->memoryCacheRegistered = false;
+    }
+
+    uint8_t* Ctx::getMemoryChunk(Thread* t, MEMORY module, bool swap, bool wait) {
         uint64_t allocatedModule = 0;
         uint64_t usedTotal = 0;
         uint64_t allocatedTotal = 0;
         uint8_t* chunk = nullptr;
+        int64_t nodeHwm = -1;
+        uint64_t nodeHwmMb = 0;
+        time_ut stallUs = 0;
+
+        if (memoryModuleChunks[static_cast<uint>(module)] > 1)
+            return getMemoryBlock(t, module);
+
+        // Fast path: reuse a chunk this thread released before, as long as nobody is waiting for memory
+        if (memoryWaiters.load() == 0 && (module != MEMORY::BUILDER ||
+                                          memoryModulesAllocated[static_cast<uint>(MEMORY::BUILDER)] < memoryChunksWriteBufferMax)) {
+            for (auto& slot: t->memoryCache) {
+                chunk = slot.exchange(nullptr);
+                if (chunk == nullptr)
+                    continue;
+
+                --memoryChunksCached;
+                allocatedModule = ++memoryModulesAllocated[static_cast<uint>(module)];
+                updateMemoryModuleHWM(module, allocatedModule);
+                if (metrics != nullptr)
+                    emitMemoryUsedModule(module, allocatedModule);
+                return chunk;
+            }
+        }
 
         t->contextSet(Thread::CONTEXT::MEM, Thread::REASON::MEM);
         {
             std::unique_lock<std::mutex> lck(memoryMtx);
+            memoryCacheRegister(t);
             while (true) {
+                bool poolExhausted = false;
                 if (module == MEMORY::READER) {
                     if (memoryModulesAllocated[static_cast<uint>(MEMORY::READER)] < memoryChunksReadBufferMin)
                         break;
@@ -431,17 +887,30 @@ namespace OpenLogReplicator {
 
                     if (memoryChunksAllocated < memoryChunksMax) {
                         t->contextSet(Thread::CONTEXT::OS, Thread::REASON::OS);
-                        memoryChunks[memoryChunksFree] = reinterpret_cast<uint8_t*>(aligned_alloc(MEMORY_ALIGNMENT, MEMORY_CHUNK_SIZE));
+                        chunk = allocateMemoryChunk(memoryNode(t));
                         t->contextSet(Thread::CONTEXT::MEM, Thread::REASON::MEM);
-                        if (unlikely(memoryChunks[memoryChunksFree] == nullptr))
+                        if (chunk != nullptr) {
+                            pushFreeChunk(chunk, false);
+                            allocatedTotal = ++memoryChunksAllocated;
+
+                            memoryChunksHWM = std::max(memoryChunksAllocated, memoryChunksHWM);
+                            break;
+                        }
+
+                        if (memoryPool == nullptr || memoryRegion != nullptr)
                             throw RuntimeException(10016, "couldn't allocate " + std::to_string(MEMORY_CHUNK_SIZE_MB) +
                                                           " bytes memory for: " + memoryModules[static_cast<uint>(module)]);
-                        ++memoryChunksFree;
-                        allocatedTotal = ++memoryChunksAllocated;
-
-                        memoryChunksHWM = std::max(memoryChunksAllocated, memoryChunksHWM);
-                        break;
+                        poolExhausted = true;
                     }
+
+                    // Make room by returning the blocks nobody uses
+                    if (releaseMemoryBlocks())
+                        continue;
+                }
+
+                if (!wait) {
+                    t->contextSet(Thread::CONTEXT::CPU);
+                    return nullptr;
                 }
 
                 if (module == MEMORY::PARSER)
@@ -450,21 +919,39 @@ namespace OpenLogReplicator {
                 if (hardShutdown)
                     return nullptr;
 
+                // Stop the fast paths and take back what the threads keep in their caches before waiting
+                ++memoryWaiters;
+                bool drained = false;
+                for (Thread* thread: memoryCacheThreads)
+                    drained |= memoryCacheDrain(thread);
+                if (drained) {
+                    --memoryWaiters;
+                    continue;
+                }
+
                 if (unlikely(isTraceSet(TRACE::SLEEP)))
                     logTrace(TRACE::SLEEP, "Ctx:getMemoryChunk");
                 t->contextSet(Thread::CONTEXT::WAIT, Thread::REASON::MEMORY_EXHAUSTED);
-                condOutOfMemory.wait(lck);
+                const time_ut stallStart = (t == parserThread && metrics != nullptr) ? clock->getTimeUt() : 0;
+                if (poolExhausted)
+                    condOutOfMemory.wait_for(lck, std::chrono::microseconds(MEMORY_POOL_WAIT_US));
+                else
+                    condOutOfMemory.wait(lck);
+                if (stallStart != 0)
+                    stallUs += clock->getTimeUt() - stallStart;
+                --memoryWaiters;
                 t->contextSet(Thread::CONTEXT::MEM, Thread::REASON::MEM);
             }
 
             if (module == MEMORY::PARSER)
                 outOfMemoryParser = false;
 
-            --memoryChunksFree;
-            usedTotal = memoryChunksAllocated - memoryChunksFree;
+            chunk = popFreeChunk(t, nodeHwm);
+            if (nodeHwm >= 0)
+                nodeHwmMb = memoryNodeHWM[nodeHwm] * MEMORY_CHUNK_SIZE_MB;
+            usedTotal = memoryChunksAllocated - memoryChunksFree - memoryChunksCached - memoryBlockChunksFree;
             allocatedModule = ++memoryModulesAllocated[static_cast<uint>(module)];
-            memoryModulesHWM[static_cast<uint>(module)] = std::max(memoryModulesAllocated[static_cast<uint>(module)], memoryModulesHWM[static_cast<uint>(module)]);
-            chunk = memoryChunks[memoryChunksFree];
+            updateMemoryModuleHWM(module, allocatedModule);
         }
         t->contextSet(Thread::CONTEXT::CPU);
 
@@ -477,30 +964,13 @@ namespace OpenLogReplicator {
 
             metrics->emitMemoryUsedTotalMb(usedTotal * MEMORY_CHUNK_SIZE_MB);
 
-            switch (module) {
-                case MEMORY::BUILDER:
-                    metrics->emitMemoryUsedMbBuilder(allocatedModule * MEMORY_CHUNK_SIZE_MB);
-                    break;
-
-                case MEMORY::MISC:
-                    metrics->emitMemoryUsedMbMisc(allocatedModule * MEMORY_CHUNK_SIZE_MB);
-                    break;
+            emitMemoryUsedModule(module, allocatedModule);
 
-                case MEMORY::PARSER:
-                    metrics->emitMemoryUsedMbParser(allocatedModule * MEMORY_CHUNK_SIZE_MB);
-                    break;
-
-                case MEMORY::READER:
-                    metrics->emitMemoryUsedMbReader(allocatedModule * MEMORY_CHUNK_SIZE_MB);
-                    break;
+            if (nodeHwm >= 0)
+                metrics->emitMemoryNodeHwmMb(nodeHwm, nodeHwmMb);
 
-                case MEMORY::TRANSACTIONS:
-                    metrics->emitMemoryUsedMbTransactions(allocatedModule * MEMORY_CHUNK_SIZE_MB);
-                    break;
-
-                case MEMORY::WRITER:
-                    metrics->emitMemoryUsedMbWriter(allocatedModule * MEMORY_CHUNK_SIZE_MB);
-            }
+            if (stallUs > 0)
+                metrics->emitParserStallUs(stallUs);
         }
 
         return chunk;
@@ -510,22 +980,57 @@ namespace OpenLogReplicator {
         uint64_t allocatedModule = 0;
         uint64_t usedTotal = 0;
         uint64_t allocatedTotal = 0;
+
+        if (memoryModuleChunks[static_cast<uint>(module)] > 1) {
+            freeMemoryBlock(t, module, chunk);
+            return;
+        }
+
+        // Fast path: keep the chunk for the next allocation of this thread
+        if (t->memoryCacheRegistered && memoryWaiters.load() == 0) {
+            for (auto& slot: t->memoryCache) {
+                uint8_t* empty = nullptr;
+                ++memoryChunksCached;
+                if (!slot.compare_exchange_strong(empty, chunk)) {
+                    --memoryChunksCached;
+                    continue;
+                }
+
+                allocatedModule = --memoryModulesAllocated[static_cast<uint>(module)];
+                if (likely(memoryWaiters.load() == 0)) {
+                    if (metrics != nullptr)
+                        emitMemoryUsedModule(module, allocatedModule);
+                    return;
+                }
+
+                // A thread started waiting meanwhile, it either drained the chunk already or it gets it through the slow path
+                uint8_t* back = slot.exchange(nullptr);
+                if (back == nullptr)
+                    return;
+                --memoryChunksCached;
+                ++memoryModulesAllocated[static_cast<uint>(module)];
+                break;
+            }
+        }
+
         t->contextSet(Thread::CONTEXT::MEM, Thread::REASON::MEM);
         {
             std::unique_lock<std::mutex> const lck(memoryMtx);
 
-            if (unlikely(memoryChunksFree == memoryChunksAllocated))
+            if (unlikely(memoryChunksFree + memoryChunksCached + memoryBlockChunks == memoryChunksAllocated))
                 throw RuntimeException(50001, "trying to free unknown memory block for: " + memoryModules[static_cast<uint>(module)]);
 
-            // Keep memoryChunksMin reserved
-            if (memoryChunksFree >= memoryChunksMin)
+            // Keep memoryChunksMin reserved, chunks from the huge page region are always kept. Kept are also all chunks while they are
+            // trimmed after being idle, by memoryTrim()
+            if (memoryChunksFree >= memoryChunksMin && memoryRegion == nullptr && memoryTrimIdleS == 0) {
                 allocatedTotal = --memoryChunksAllocated;
-            else {
-                memoryChunks[memoryChunksFree++] = chunk;
+                releaseMemoryChunkNode(chunk);
+            } else {
+                pushFreeChunk(chunk, true);
                 chunk = nullptr;
             }
 
-            usedTotal = memoryChunksAllocated - memoryChunksFree;
+            usedTotal = memoryChunksAllocated - memoryChunksFree - memoryChunksCached - memoryBlockChunksFree;
             allocatedModule = --memoryModulesAllocated[static_cast<uint>(module)];
 
             condOutOfMemory.notify_all();
@@ -533,7 +1038,7 @@ namespace OpenLogReplicator {
 
         if (chunk != nullptr) {
             t->contextSet(Thread::CONTEXT::OS, Thread::REASON::OS);
-            free(chunk);
+            releaseMemoryChunk(chunk);
         }
 
         t->contextSet(Thread::CONTEXT::CPU);
@@ -543,31 +1048,229 @@ namespace OpenLogReplicator {
 
             metrics->emitMemoryUsedTotalMb(usedTotal * MEMORY_CHUNK_SIZE_MB);
 
-            switch (module) {
-                case MEMORY::BUILDER:
-                    metrics->emitMemoryUsedMbBuilder(allocatedModule * MEMORY_CHUNK_SIZE_MB);
-                    break;
+            emitMemoryUsedModule(module, allocatedModule);
+        }
+    }
 
-                case MEMORY::MISC:
-                    metrics->emitMemoryUsedMbMisc(allocatedModule * MEMORY_CHUNK_SIZE_MB);
-                    break;
+    // Free chunks above memoryChunksMin which were not taken for a whole idle period are released, half of them at a time, so that bursts
+    // are served from the free stack while an idle tenant gives the memory back. Called by the memory manager thread
+    void Ctx::memoryTrim(Thread* t) {
+        if (memoryTrimIdleS == 0 || memoryRegion != nullptr)
+            return;
+        const time_ut now = clock->getTimeUt();
+        if (now - memoryTrimTime < static_cast<time_ut>(memoryTrimIdleS) * 1000000)
+            return;
+        memoryTrimTime = now;
 
-                case MEMORY::PARSER:
-                    metrics->emitMemoryUsedMbParser(allocatedModule * MEMORY_CHUNK_SIZE_MB);
-                    break;
+        std::vector<uint8_t*> released;
+        uint64_t allocatedTotal = 0;
+        t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::MEMORY_TRIM);
+        {
+            std::unique_lock<std::mutex> const lck(memoryMtx);
+            if (memoryChunksFreeLow > memoryChunksMin) {
+                // The bottom of the free stack is what was not used for the longest time
+                const uint64_t trim = (memoryChunksFreeLow - memoryChunksMin + 1) / 2;
+                released.assign(memoryChunks, memoryChunks + trim);
+                memmove(reinterpret_cast<void*>(memoryChunks), reinterpret_cast<const void*>(memoryChunks + trim),
+                        (memoryChunksFree - trim) * sizeof(uint8_t*));
+                if (numa) {
+                    memmove(reinterpret_cast<void*>(memoryChunksNode), reinterpret_cast<const void*>(memoryChunksNode + trim),
+                            memoryChunksFree - trim);
+                    for (uint8_t* chunk: released)
+                        memoryChunkNodes.erase(chunk);
+                }
+                memoryChunksFree -= trim;
+                memoryChunksAllocated -= trim;
+                allocatedTotal = memoryChunksAllocated;
+            }
+            memoryChunksFreeLow = memoryChunksFree;
+        }
 
-                case MEMORY::READER:
-                    metrics->emitMemoryUsedMbReader(allocatedModule * MEMORY_CHUNK_SIZE_MB);
-                    break;
+        t->contextSet(Thread::CONTEXT::OS, Thread::REASON::OS);
+        for (uint8_t* chunk: released) {
+            // Memory kept by the allocator or by the shared pool is still given back to the system
+            madvise(chunk, MEMORY_CHUNK_SIZE, MADV_FREE);
+            releaseMemoryChunk(chunk);
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
+
+        if (released.empty())
+            return;
+        if (unlikely(isTraceSet(TRACE::SLEEP)))
+            logTrace(TRACE::SLEEP, "memory trim: " + std::to_string(released.size() * MEMORY_CHUNK_SIZE_MB) + "MB");
+        if (metrics != nullptr) {
+            metrics->emitMemoryTrims(1);
+            metrics->emitMemoryTrimmedMb(released.size() * MEMORY_CHUNK_SIZE_MB);
+            metrics->emitMemoryAllocatedMb(allocatedTotal * MEMORY_CHUNK_SIZE_MB);
+        }
+    }
+
+    void Ctx::setMemoryChunkSizeMb(MEMORY module, uint64_t sizeMb) {
+        memoryModuleChunks[static_cast<uint>(module)] = std::max<uint64_t>(sizeMb / MEMORY_CHUNK_SIZE_MB, 1);
+    }
+
+    uint8_t* Ctx::getMemoryBlock(Thread* t, MEMORY module) {
+        const uint64_t chunks = memoryModuleChunks[static_cast<uint>(module)];
+        uint64_t allocatedModule;
+        uint64_t usedTotal;
+        uint64_t allocatedTotal = 0;
+        uint8_t* block = nullptr;
+        time_ut stallUs = 0;
 
-                case MEMORY::TRANSACTIONS:
-                    metrics->emitMemoryUsedMbTransactions(allocatedModule * MEMORY_CHUNK_SIZE_MB);
+        t->contextSet(Thread::CONTEXT::MEM, Thread::REASON::MEM);
+        {
+            std::unique_lock<std::mutex> lck(memoryMtx);
+            while (true) {
+                bool poolExhausted = false;
+                std::vector<uint8_t*>& blocks = memoryBlocksFree[static_cast<uint>(module)];
+                const bool underLimit = module != MEMORY::BUILDER ||
+                                        memoryModulesAllocated[static_cast<uint>(MEMORY::BUILDER)] < memoryChunksWriteBufferMin ||
+                                        memoryModulesAllocated[static_cast<uint>(MEMORY::BUILDER)] + chunks <= memoryChunksWriteBufferMax;
+
+                if (underLimit && !blocks.empty()) {
+                    block = blocks.back();
+                    blocks.pop_back();
+                    memoryBlockChunksFree -= chunks;
                     break;
+                }
+
+                if (underLimit) {
+                    // Free chunks above the reserve give way to the block
+                    while (memoryChunksAllocated + chunks > memoryChunksMax && memoryChunksFree > memoryChunksMin && memoryRegion == nullptr) {
+                        uint8_t* chunk = memoryChunks[memoryChunksFree - 1];
+                        releaseMemoryChunkNode(chunk);
+                        --memoryChunksFree;
+                        memoryChunksFreeLow = std::min(memoryChunksFreeLow, memoryChunksFree);
+                        --memoryChunksAllocated;
+                        releaseMemoryChunk(chunk);
+                    }
+
+                    if (memoryChunksAllocated + chunks <= memoryChunksMax) {
+                        t->contextSet(Thread::CONTEXT::OS, Thread::REASON::OS);
+                        block = allocateMemoryBlock(chunks);
+                        t->contextSet(Thread::CONTEXT::MEM, Thread::REASON::MEM);
+                        if (block != nullptr) {
+                            memoryChunksAllocated += chunks;
+                            memoryBlockChunks += chunks;
+                            allocatedTotal = memoryChunksAllocated;
+                            memoryChunksHWM = std::max(memoryChunksAllocated, memoryChunksHWM);
+                            break;
+                        }
+
+                        if (memoryPool == nullptr || memoryRegion != nullptr)
+                            throw RuntimeException(10016, "couldn't allocate " + std::to_string(chunks * MEMORY_CHUNK_SIZE) +
+                                                          " bytes memory for: " + memoryModules[static_cast<uint>(module)]);
+                        poolExhausted = true;
+                        if (releaseMemoryBlocks())
+                            continue;
+                    }
+                }
+
+                if (hardShutdown)
+                    return nullptr;
+
+                ++memoryWaiters;
+                bool drained = false;
+                for (Thread* thread: memoryCacheThreads)
+                    drained |= memoryCacheDrain(thread);
+                if (drained) {
+                    --memoryWaiters;
+                    continue;
+                }
+
+                if (unlikely(isTraceSet(TRACE::SLEEP)))
+                    logTrace(TRACE::SLEEP, "Ctx:getMemoryBlock");
+                t->contextSet(Thread::CONTEXT::WAIT, Thread::REASON::MEMORY_EXHAUSTED);
+                const time_ut stallStart = (t == parserThread && metrics != nullptr) ? clock->getTimeUt() : 0;
+                if (poolExhausted)
+                    condOutOfMemory.wait_for(lck, std::chrono::microseconds(MEMORY_POOL_WAIT_US));
+                else
+                    condOutOfMemory.wait(lck);
+                if (stallStart != 0)
+                    stallUs += clock->getTimeUt() - stallStart;
+                --memoryWaiters;
+                t->contextSet(Thread::CONTEXT::MEM, Thread::REASON::MEM);
+            }
+
+            usedTotal = memoryChunksAllocated - memoryChunksFree - memoryChunksCached - memoryBlockChunksFree;
+            allocatedModule = memoryModulesAllocated[static_cast<uint>(module)] += chunks;
+            updateMemoryModuleHWM(module, allocatedModule);
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
+
+        if (unlikely(hardShutdown))
+            throw RuntimeException(10018, "shutdown during memory allocation");
+
+        if (metrics != nullptr) {
+            if (allocatedTotal > 0)
+                metrics->emitMemoryAllocatedMb(allocatedTotal * MEMORY_CHUNK_SIZE_MB);
+            metrics->emitMemoryUsedTotalMb(usedTotal * MEMORY_CHUNK_SIZE_MB);
+            emitMemoryUsedModule(module, allocatedModule);
+
+            if (stallUs > 0)
+                metrics->emitParserStallUs(stallUs);
+        }
+
+        return block;
+    }
+
+    void Ctx::freeMemoryBlock(Thread* t, MEMORY module, uint8_t* block) {
+        const uint64_t chunks = memoryModuleChunks[static_cast<uint>(module)];
+        uint64_t allocatedModule;
+        uint64_t usedTotal;
+        uint64_t allocatedTotal = 0;
+
+        t->contextSet(Thread::CONTEXT::MEM, Thread::REASON::MEM);
+        {
+            std::unique_lock<std::mutex> const lck(memoryMtx);
+            if (unlikely(memoryBlockChunks < memoryBlockChunksFree + chunks))
+                throw RuntimeException(50001, "trying to free unknown memory block for: " + memoryModules[static_cast<uint>(module)]);
+
+            std::vector<uint8_t*>& blocks = memoryBlocksFree[static_cast<uint>(module)];
+            if (blocks.size() < MEMORY_BLOCKS_KEEP || memoryRegion != nullptr) {
+                blocks.push_back(block);
+                memoryBlockChunksFree += chunks;
+                block = nullptr;
+            } else {
+                memoryChunksAllocated -= chunks;
+                memoryBlockChunks -= chunks;
+                allocatedTotal = memoryChunksAllocated;
+            }
+
+            usedTotal = memoryChunksAllocated - memoryChunksFree - memoryChunksCached - memoryBlockChunksFree;
+            allocatedModule = memoryModulesAllocated[static_cast<uint>(module)] -= chunks;
+
+            condOutOfMemory.notify_all();
+        }
+
+        if (block != nullptr) {
+            t->contextSet(Thread::CONTEXT::OS, Thread::REASON::OS);
+            releaseMemoryBlock(block, chunks);
+        }
+
+        t->contextSet(Thread::CONTEXT::CPU);
+        if (metrics != nullptr) {
+            if (allocatedTotal > 0)
+                metrics->emitMemoryAllocatedMb(allocatedTotal * MEMORY_CHUNK_SIZE_MB);
+            metrics->emitMemoryUsedTotalMb(usedTotal * MEMORY_CHUNK_SIZE_MB);
+            emitMemoryUsedModule(module, allocatedModule);
+        }
+    }
+
+    bool Ctx::releaseMemoryBlocks() {
+        if (memoryRegion != nullptr || memoryBlockChunksFree == 0)
+            return false;
 
-                case MEMORY::WRITER:
-                    metrics->emitMemoryUsedMbWriter(allocatedModule * MEMORY_CHUNK_SIZE_MB);
+        for (uint module = 0; module < MEMORY_COUNT; ++module) {
+            for (uint8_t* block: memoryBlocksFree[module]) {
+                memoryChunksAllocated -= memoryModuleChunks[module];
+                memoryBlockChunks -= memoryModuleChunks[module];
+                releaseMemoryBlock(block, memoryModuleChunks[module]);
             }
+            memoryBlocksFree[module].clear();
         }
+        memoryBlockChunksFree = 0;
+        return true;
     }
 
     void Ctx::swappedMemoryInit(Thread* t, Xid xid) {
@@ -587,6 +1290,7 @@ namespace OpenLogReplicator {
                 t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::CTX_MEMORY_INIT);
             }
 
+            sc->sequence = ++swapChunkSequence;
             swapChunks.insert_or_assign(xid, sc);
         }
         t->contextSet(Thread::CONTEXT::CPU);
@@ -594,6 +1298,57 @@ namespace OpenLogReplicator {
             logTrace(Ctx::TRACE::TRANSACTION, "swap memory stalled transaction xid: " + xid.toString());
     }
 
+    // One lock for all entries, transactions holding only slab memory have no swap chunk
+    void Ctx::swappedMemorySnapshot(Thread* t, std::vector<TransactionSnapshot::Entry>& entries) const {
+        {
+            t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::CTX_SWAPPED_SNAPSHOT);
+            std::unique_lock<std::mutex> const lck(swapMtx);
+            for (TransactionSnapshot::Entry& entry: entries) {
+                const auto& it = swapChunks.find(entry.xid);
+                if (it == swapChunks.end())
+                    continue;
+                const SwapChunk* sc = it->second;
+                entry.chunks = sc->chunks.size();
+                entry.swappedMin = sc->swappedMin;
+                entry.swappedMax = sc->swappedMax;
+            }
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
+    }
+
+    // Only a transaction with all chunks in memory is pinned, the chunks stay in place until unpinned
+    bool Ctx::swappedMemoryPin(Thread* t, Xid xid, std::vector<uint8_t*>& tcs) {
+        {
+            t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::CTX_SWAPPED_PIN);
+            std::unique_lock<std::mutex> const lck(swapMtx);
+            const auto& it = swapChunks.find(xid);
+            if (unlikely(it == swapChunks.end()))
+                throw RuntimeException(50070, "swap chunk not found for xid: " + xid.toString() + " during memory pin");
+            SwapChunk* sc = it->second;
+            if (sc->swappedMin != -1) {
+                t->contextSet(Thread::CONTEXT::CPU);
+                return false;
+            }
+            sc->pinned = true;
+            tcs = sc->chunks;
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
+        return true;
+    }
+
+    void Ctx::swappedMemoryUnpin(Thread* t, Xid xid) {
+        {
+            t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::CTX_SWAPPED_PIN);
+            std::unique_lock<std::mutex> const lck(swapMtx);
+            const auto& it = swapChunks.find(xid);
+            if (unlikely(it == swapChunks.end()))
+                throw RuntimeException(50070, "swap chunk not found for xid: " + xid.toString() + " during memory unpin");
+            it->second->pinned = false;
+            chunksMemoryManager.notify_all();
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
+    }
+
     uint64_t Ctx::swappedMemorySize(Thread* t, Xid xid) const {
         uint64_t ret;
         {
@@ -618,6 +1373,21 @@ namespace OpenLogReplicator {
                 throw RuntimeException(50070, "swap chunk not found for xid: " + xid.toString() + " during memory get");
             SwapChunk* sc = it->second;
 
+            // Nothing is swapped, a chunk paged out ahead of the one read is paged in while this one is used
+            if (transactionMap != nullptr) {
+                uint8_t* tc = sc->chunks.at(index);
+                const int64_t ahead = index + static_cast<int64_t>(TRANSACTION_MAP_READ_AHEAD);
+                uint8_t* tcAhead = ahead <= sc->pagedOutMax ? sc->chunks[ahead] : nullptr;
+                lck.unlock();
+
+                if (tcAhead != nullptr) {
+                    t->contextSet(Thread::CONTEXT::OS, Thread::REASON::OS);
+                    madvise(tcAhead, MEMORY_CHUNK_SIZE, MADV_WILLNEED);
+                }
+                t->contextSet(Thread::CONTEXT::CPU);
+                return tc;
+            }
+
             while (!hardShutdown) {
                 if (index < sc->swappedMin || index > sc->swappedMax) {
                     t->contextSet(Thread::CONTEXT::CPU);
@@ -647,11 +1417,95 @@ namespace OpenLogReplicator {
         }
         t->contextSet(Thread::CONTEXT::CPU);
 
-        freeMemoryChunk(t, Ctx::MEMORY::TRANSACTIONS, tc);
+        freeTransactionChunk(t, tc);
+    }
+
+    // Chunks already flushed, taken out under one lock
+    void Ctx::swappedMemoryRelease(Thread* t, Xid xid, const std::vector<uint64_t>& indexes) {
+        uint8_t* tcs[MEMORY_RELEASE_BATCH];
+        for (uint64_t first = 0; first < indexes.size(); first += MEMORY_RELEASE_BATCH) {
+            const uint64_t count = std::min<uint64_t>(MEMORY_RELEASE_BATCH, indexes.size() - first);
+            {
+                t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::CTX_SWAPPED_RELEASE);
+                std::unique_lock<std::mutex> const lck(swapMtx);
+                const auto& it = swapChunks.find(xid);
+                if (unlikely(it == swapChunks.end()))
+                    throw RuntimeException(50070, "swap chunk not found for xid: " + xid.toString() + " during memory release");
+                SwapChunk* sc = it->second;
+                for (uint64_t i = 0; i < count; ++i) {
+                    tcs[i] = sc->chunks.at(indexes[first + i]);
+                    sc->chunks[indexes[first + i]] = nullptr;
+                }
+            }
+            t->contextSet(Thread::CONTEXT::CPU);
+
+            for (uint64_t i = 0; i < count; ++i)
+                freeTransactionChunk(t, tcs[i]);
+        }
+    }
+
+    uint8_t* Ctx::getTransactionChunk(Thread* t) {
+        if (transactionMap == nullptr)
+            return getMemoryChunk(t, Ctx::MEMORY::TRANSACTIONS);
+
+        uint8_t* tc = nullptr;
+        {
+            t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::CTX_SWAPPED_GROW1);
+            std::unique_lock<std::mutex> const lck(swapMtx);
+            if (!transactionMapFree.empty()) {
+                tc = transactionMapFree.back();
+                transactionMapFree.pop_back();
+            } else if (transactionMapCarved < transactionMapChunks) {
+                tc = transactionMap + transactionMapCarved * MEMORY_CHUNK_SIZE;
+                ++transactionMapCarved;
+            }
+            if (tc != nullptr)
+                ++transactionMapResident;
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
+
+        if (unlikely(tc == nullptr)) {
+            hint("try to restart with higher value of 'transaction-map-mb' parameter or if big transaction - add to 'skip-xid' list");
+            throw RuntimeException(10100, "transaction memory of " + std::to_string(transactionMapMb) + "MB exhausted");
+        }
+
+        const uint64_t allocatedModule = ++memoryModulesAllocated[static_cast<uint>(MEMORY::TRANSACTIONS)];
+        updateMemoryModuleHWM(MEMORY::TRANSACTIONS, allocatedModule);
+        if (metrics != nullptr)
+            emitMemoryUsedModule(MEMORY::TRANSACTIONS, allocatedModule);
+        return tc;
+    }
+
+    // Punching the chunk out of the file drops its pages without writing them back, the chunk is reused from the free list
+    void Ctx::freeTransactionChunk(Thread* t, uint8_t* tc) {
+        if (transactionMap == nullptr || tc < transactionMap || tc >= transactionMap + transactionMapChunks * MEMORY_CHUNK_SIZE) {
+            freeMemoryChunk(t, Ctx::MEMORY::TRANSACTIONS, tc);
+            return;
+        }
+
+        t->contextSet(Thread::CONTEXT::OS, Thread::REASON::OS);
+#ifdef MADV_REMOVE
+        if (unlikely(madvise(tc, MEMORY_CHUNK_SIZE, MADV_REMOVE) != 0))
+            madvise(tc, MEMORY_CHUNK_SIZE, MADV_DONTNEED);
+#else
+        madvise(tc, MEMORY_CHUNK_SIZE, MADV_DONTNEED);
+#endif
+
+        {
+            t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::CTX_SWAPPED_RELEASE);
+            std::unique_lock<std::mutex> const lck(swapMtx);
+            transactionMapFree.push_back(tc);
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
+
+        const uint64_t allocatedModule = --memoryModulesAllocated[static_cast<uint>(MEMORY::TRANSACTIONS)];
+        if (metrics != nullptr)
+            emitMemoryUsedModule(MEMORY::TRANSACTIONS, allocatedModule);
     }
 
     [[nodiscard]] uint8_t* Ctx::swappedMemoryGrow(Thread* t, Xid xid) {
         SwapChunk* sc;
+        bool overBudget;
         {
             t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::CTX_SWAPPED_GROW1);
             std::unique_lock<std::mutex> const lck(swapMtx);
@@ -662,13 +1516,37 @@ namespace OpenLogReplicator {
         }
         t->contextSet(Thread::CONTEXT::CPU);
 
-        uint8_t* tc = getMemoryChunk(t, Ctx::MEMORY::TRANSACTIONS);
+        uint8_t* tc = getTransactionChunk(t);
         memset(tc, 0, sizeof(uint64_t) + sizeof(uint32_t));
 
+        uint8_t* cold = nullptr;
         {
             t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::CTX_SWAPPED_GROW2);
             std::unique_lock<std::mutex> const lck(swapMtx);
             sc->chunks.push_back(tc);
+            overBudget = swapTransactionChunksMax > 0 && sc->chunks.size() - (sc->swappedMax + 1) > swapTransactionChunksMax;
+            if (transactionMap != nullptr) {
+                overBudget = transactionMapResidentMb > 0 && transactionMapResident * MEMORY_CHUNK_SIZE_MB > transactionMapResidentMb;
+                // The last two chunks are still written to and rolled back, the one before is not touched again until the flush
+                if (sc->chunks.size() > 2)
+                    cold = sc->chunks[sc->chunks.size() - 3];
+            }
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
+
+#ifdef MADV_COLD
+        if (cold != nullptr) {
+            t->contextSet(Thread::CONTEXT::OS, Thread::REASON::OS);
+            madvise(cold, MEMORY_CHUNK_SIZE, MADV_COLD);
+            t->contextSet(Thread::CONTEXT::CPU);
+        }
+#endif
+
+        // Start swapping before the parser runs out of memory instead of waiting for the periodic check
+        if (overBudget || !nothingToSwap(t)) {
+            t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::CTX_SWAPPED_GROW2);
+            std::unique_lock<std::mutex> const lck(swapMtx);
+            chunksMemoryManager.notify_all();
         }
         t->contextSet(Thread::CONTEXT::CPU);
         return tc;
@@ -686,9 +1564,11 @@ namespace OpenLogReplicator {
             sc = it->second;
             tc = sc->chunks.back();
             sc->chunks.pop_back();
+            if (sc->pagedOutMax >= static_cast<int64_t>(sc->chunks.size()))
+                sc->pagedOutMax = static_cast<int64_t>(sc->chunks.size()) - 1;
         }
 
-        freeMemoryChunk(t, Ctx::MEMORY::TRANSACTIONS, tc);
+        freeTransactionChunk(t, tc);
 
         {
             t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::CTX_SWAPPED_SHRINK2);
@@ -715,10 +1595,28 @@ namespace OpenLogReplicator {
     }
 
     void Ctx::swappedMemoryFlush(Thread* t, Xid xid) {
+        uint8_t* tcs[TRANSACTION_MAP_READ_AHEAD];
+        uint64_t count = 0;
         {
             t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::CTX_SWAPPED_FLUSH1);
             std::unique_lock<std::mutex> const lck(swapMtx);
             swappedFlushXid = xid;
+
+            // The flush reads the chunks in order, the first paged out ones are paged in before they are needed
+            if (transactionMap != nullptr) {
+                const auto& it = swapChunks.find(xid);
+                if (it != swapChunks.end()) {
+                    const SwapChunk* sc = it->second;
+                    for (int64_t index = 0; index <= sc->pagedOutMax && count < TRANSACTION_MAP_READ_AHEAD; ++index)
+                        if (sc->chunks[index] != nullptr)
+                            tcs[count++] = sc->chunks[index];
+                }
+            }
+        }
+
+        for (uint64_t i = 0; i < count; ++i) {
+            t->contextSet(Thread::CONTEXT::OS, Thread::REASON::OS);
+            madvise(tcs[i], MEMORY_CHUNK_SIZE, MADV_WILLNEED);
         }
         t->contextSet(Thread::CONTEXT::CPU);
     }
@@ -733,13 +1631,15 @@ namespace OpenLogReplicator {
                 throw RuntimeException(50070, "swap chunk not found for xid: " + xid.toString() + " during memory remove");
             sc = it->second;
             sc->release = true;
-            swappedFlushXid = 0;
+            // A transaction released by the parser thread while the flusher thread is building another one
+            if (swappedFlushXid == xid)
+                swappedFlushXid = 0;
         }
         t->contextSet(Thread::CONTEXT::CPU);
 
         for (auto* tc: sc->chunks)
             if (tc != nullptr)
-                freeMemoryChunk(t, Ctx::MEMORY::TRANSACTIONS, tc);
+                freeTransactionChunk(t, tc);
 
         {
             t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::CTX_SWAPPED_FLUSH2);
@@ -751,6 +1651,28 @@ namespace OpenLogReplicator {
         t->contextSet(Thread::CONTEXT::CPU);
     }
 
+    // All chunks are flushed and released, nothing is swapped, the transaction goes on with no chunks and may be swapped again
+    void Ctx::swappedMemoryClear(Thread* t, Xid xid) {
+        {
+            t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::CTX_SWAPPED_FLUSH2);
+            std::unique_lock<std::mutex> const lck(swapMtx);
+            const auto& it = swapChunks.find(xid);
+            if (unlikely(it == swapChunks.end()))
+                throw RuntimeException(50070, "swap chunk not found for xid: " + xid.toString() + " during memory clear");
+            SwapChunk* sc = it->second;
+            if (unlikely(sc->swappedMin != -1))
+                throw RuntimeException(50070, "swap chunk of xid: " + xid.toString() + " not read back during memory clear");
+            for (const auto* tc: sc->chunks)
+                if (unlikely(tc != nullptr))
+                    throw RuntimeException(50070, "swap chunk of xid: " + xid.toString() + " not released during memory clear");
+            sc->chunks.clear();
+            sc->pagedOutMax = -1;
+            if (swappedFlushXid == xid)
+                swappedFlushXid = 0;
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
+    }
+
     void Ctx::wontSwap(Thread* t) {
         t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::CTX_SWAPPED_WONT);
         std::unique_lock<std::mutex> const lck(memoryMtx);
@@ -831,7 +1753,20 @@ namespace OpenLogReplicator {
             if (!hardShutdown) {
                 if (unlikely(isTraceSet(TRACE::SLEEP)))
                     logTrace(TRACE::SLEEP, "Ctx:mainLoop");
-                condMainLoop.wait(lck);
+                if (!flightRecorder) {
+                    condMainLoop.wait(lck);
+                } else {
+                    // Woken up every second to serve flight recorder dumps, returns on the shutdown notification as before
+                    flightRecorderRequestsDone = flightRecorderRequests.load(std::memory_order_relaxed);
+                    const bool softShutdownStart = softShutdown;
+                    while (!hardShutdown && softShutdown == softShutdownStart) {
+                        if (condMainLoop.wait_for(lck, std::chrono::seconds(1)) == std::cv_status::no_timeout)
+                            break;
+                        lck.unlock();
+                        checkFlightRecorder();
+                        lck.lock();
+                    }
+                }
             }
         }
 
@@ -892,7 +1827,59 @@ namespace OpenLogReplicator {
     void Ctx::spawnThread(Thread* t) {
         logTrace(TRACE::THREADS, "spawn: " + t->alias);
 
-        if (unlikely(pthread_create(&t->pthread, nullptr, &Thread::runStatic, reinterpret_cast<void*>(t))))
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+#if __linux__
+        // Thread kind is the part of the name before the colon, for example "Reader"
+        std::string kind = t->getName();
+        kind = kind.substr(0, kind.find(':'));
+        auto it = threadAffinity.find(kind);
+        if (it == threadAffinity.end())
+            it = threadAffinity.find("default");
+        if (it != threadAffinity.end()) {
+            if (unlikely(pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &it->second) != 0))
+                throw RuntimeException(10013, "spawning thread: " + t->alias + " - setting cpu affinity failed");
+#ifdef LINK_LIBRARY_NUMA
+            if (numa) {
+                for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                    if (!CPU_ISSET(cpu, &it->second))
+                        continue;
+                    const int node = numa_node_of_cpu(cpu);
+                    if (node >= 0 && static_cast<uint>(node) < numaNodes)
+                        t->numaNode = node;
+                    break;
+                }
+            }
+#endif /* LINK_LIBRARY_NUMA */
+        }
+
+        auto priorityIt = threadPriority.find(kind);
+        if (priorityIt == threadPriority.end())
+            priorityIt = threadPriority.find("default");
+        const bool realTime = priorityIt != threadPriority.end() && priorityIt->second.policy != SCHED_OTHER;
+        if (realTime) {
+            struct sched_param param{};
+            param.sched_priority = priorityIt->second.priority;
+            pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+            pthread_attr_setschedpolicy(&attr, priorityIt->second.policy);
+            pthread_attr_setschedparam(&attr, &param);
+        } else if (priorityIt != threadPriority.end() && priorityIt->second.niceSet) {
+            // Nice is per thread on Linux and can only be set by the thread itself
+            t->niceSet = true;
+            t->nice = priorityIt->second.nice;
+        }
+#endif
+        int ret = pthread_create(&t->pthread, &attr, &Thread::runStatic, reinterpret_cast<void*>(t));
+#if __linux__
+        // Real-time policies need CAP_SYS_NICE, without it the thread runs with the inherited policy
+        if (ret == EPERM && realTime) {
+            warning(60053, "spawning thread: " + t->alias + " - no permission for real-time scheduling, using inherited policy");
+            pthread_attr_setinheritsched(&attr, PTHREAD_INHERIT_SCHED);
+            ret = pthread_create(&t->pthread, &attr, &Thread::runStatic, reinterpret_cast<void*>(t));
+        }
+#endif
+        pthread_attr_destroy(&attr);
+        if (unlikely(ret != 0))
             throw RuntimeException(10013, "spawning thread: " + t->alias);
         {
             std::unique_lock<std::mutex> const lck(mtx);
@@ -910,6 +1897,45 @@ namespace OpenLogReplicator {
         pthread_join(t->pthread, nullptr);
     }
 
+    // The thread registry lock only keeps threads from being joined and deleted while visited
+    void Ctx::forEachThread(const std::function<void(const Thread*)>& visit) {
+        std::unique_lock<std::mutex> const lck(mtx);
+        for (const Thread* thread: threads)
+            visit(thread);
+    }
+
+    // Context profile of every running thread, counters are cumulative and read without stopping the threads
+    void Ctx::emitThreadMetrics() {
+        if constexpr (!Thread::contextCompiled)
+            return;
+        if (metrics == nullptr)
+            return;
+
+        std::unique_lock<std::mutex> const lck(mtx);
+        for (const Thread* thread: threads) {
+            for (uint context = static_cast<uint>(Thread::CONTEXT::CPU); context < static_cast<uint>(Thread::CONTEXT::NUM); ++context) {
+                metrics->emitThreadContextUs(thread->alias, Thread::contextNames[context],
+                                             static_cast<uint64_t>(thread->contextTime[context].load(std::memory_order_relaxed)));
+                metrics->emitThreadContextCount(thread->alias, Thread::contextNames[context],
+                                                static_cast<uint64_t>(thread->contextCnt[context].load(std::memory_order_relaxed)));
+            }
+
+            for (uint reason = static_cast<uint>(Thread::REASON::NONE); reason < static_cast<uint>(Thread::REASON::NUM); ++reason) {
+                const uint64_t count = thread->reasonCnt[reason].load(std::memory_order_relaxed);
+                if (count > 0)
+                    metrics->emitThreadReasonCount(thread->alias, reason, count);
+            }
+        }
+    }
+
+    // Clock skew between the database host and this host shows up as a zero latency rather than a huge one
+    void Ctx::recordLatency(RuntimeStats::LATENCY stage, time_ut start, time_ut end) {
+        const uint64_t us = end > start ? static_cast<uint64_t>(end - start) : 0;
+        stats.latency[static_cast<uint>(stage)].record(us);
+        if (metrics != nullptr)
+            metrics->emitLatencyUs(stage, us);
+    }
+
     void Ctx::signalDump() {
         if (mainThread != pthread_self())
             return;
@@ -925,108 +1951,84 @@ namespace OpenLogReplicator {
         }
     }
 
-    void Ctx::welcome(const std::string& message) const {
-        const int code = 0;
-        if (OLR_LOCALES == LOCALES::TIMESTAMP) {
-            std::ostringstream s;
-            char timestamp[30];
-            Data::epochToIso8601(clock->getTimeT() + logTimezone, timestamp, false, false);
-            s << timestamp << " INFO  " << std::setw(5) << std::setfill('0') << std::dec << code << " " << message << std::endl;
-            std::cerr << s.str();
-        } else {
-            std::ostringstream s;
-            s << " INFO  " << std::setw(5) << std::setfill('0') << std::dec << code << " " << message << std::endl;
-            std::cerr << s.str();
+    // Called from the signal handler, only bumps a lock-free counter polled by the main loop of every tenant
+    void Ctx::requestFlightRecorderDump() {
+        flightRecorderRequests.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Ctx::checkFlightRecorder() {
+        const uint64_t requests = flightRecorderRequests.load(std::memory_order_relaxed);
+        if (requests != flightRecorderRequestsDone) {
+            flightRecorderRequestsDone = requests;
+            dumpFlightRecorder("signal");
         }
     }
 
+    void Ctx::dumpFlightRecorder(const std::string& reason) {
+        const time_ut now = contextClock.nowUt();
+        warning(60051, "flight recorder dump (" + reason + "), lwn scn: " + Scn(RuntimeStats::get(stats.lwnScn)).toString() +
+                       " confirmed scn: " + Scn(RuntimeStats::get(stats.confirmedScn)).toString() +
+                       " bytes read: " + std::to_string(RuntimeStats::get(stats.bytesRead)) +
+                       " parsed: " + std::to_string(RuntimeStats::get(stats.bytesParsed)) +
+                       " messages built: " + std::to_string(RuntimeStats::get(stats.messagesBuilt)) +
+                       " confirmed: " + std::to_string(RuntimeStats::get(stats.messagesConfirmed)));
+
+        std::vector<FlightRecorder::Event> events;
+        forEachThread([&](const Thread* thread) {
+            events.clear();
+            thread->recorder.snapshot(events);
+            std::string msg = "flight recorder: " + thread->alias + " events: " + std::to_string(events.size());
+            for (const FlightRecorder::Event& event: events)
+                msg += "\n" + FlightRecorder::describe(event, now);
+            warning(60051, msg);
+        });
+    }
+
+    void Ctx::log(const char* level, const char* tag, int code, LogSink::KIND kind, const std::string& message) const {
+        logSink.write(level, tag, code, clock->getTimeT() + logTimezone, OLR_LOCALES == LOCALES::TIMESTAMP, kind, message);
+    }
+
+    void Ctx::welcome(const std::string& message) const {
+        log(OLR_LOCALES == LOCALES::TIMESTAMP ? "INFO " : " INFO ", nullptr, 0, LogSink::KIND::NORMAL, message);
+    }
+
     void Ctx::hint(const std::string& message) const {
         if (logLevel < LOG::ERROR)
             return;
 
-        if (OLR_LOCALES == LOCALES::TIMESTAMP) {
-            std::ostringstream s;
-            char timestamp[30];
-            Data::epochToIso8601(clock->getTimeT() + logTimezone, timestamp, false, false);
-            s << timestamp << " HINT  " << message << std::endl;
-            std::cerr << s.str();
-        } else {
-            std::ostringstream s;
-            s << "HINT  " << message << std::endl;
-            std::cerr << s.str();
-        }
+        log("HINT ", nullptr, -1, LogSink::KIND::NORMAL, message);
     }
 
     void Ctx::error(int code, const std::string& message) const {
         if (logLevel < LOG::ERROR)
             return;
 
-        if (OLR_LOCALES == LOCALES::TIMESTAMP) {
-            std::ostringstream s;
-            char timestamp[30];
-            Data::epochToIso8601(clock->getTimeT() + logTimezone, timestamp, false, false);
-            s << timestamp << " ERROR " << std::setw(5) << std::setfill('0') << std::dec << code << " " << message << std::endl;
-            std::cerr << s.str();
-        } else {
-            std::ostringstream s;
-            s << "ERROR " << std::setw(5) << std::setfill('0') << std::dec << code << " " << message << std::endl;
-            std::cerr << s.str();
-        }
+        log("ERROR", nullptr, code, LogSink::KIND::URGENT, message);
     }
 
     void Ctx::warning(int code, const std::string& message) const {
         if (logLevel < LOG::WARNING)
             return;
 
-        if (OLR_LOCALES == LOCALES::TIMESTAMP) {
-            std::ostringstream s;
-            char timestamp[30];
-            Data::epochToIso8601(clock->getTimeT() + logTimezone, timestamp, false, false);
-            s << timestamp << " WARN  " << std::setw(5) << std::setfill('0') << std::dec << code << " " << message << std::endl;
-            std::cerr << s.str();
-        } else {
-            std::ostringstream s;
-            s << "WARN  " << std::setw(5) << std::setfill('0') << std::dec << code << " " << message << std::endl;
-            std::cerr << s.str();
-        }
+        log("WARN ", nullptr, code, LogSink::KIND::LIMITED, message);
     }
 
     void Ctx::info(int code, const std::string& message) const {
         if (logLevel < LOG::INFO)
             return;
 
-        if (OLR_LOCALES == LOCALES::TIMESTAMP) {
-            std::ostringstream s;
-            char timestamp[30];
-            Data::epochToIso8601(clock->getTimeT() + logTimezone, timestamp, false, false);
-            s << timestamp << " INFO  " << std::setw(5) << std::setfill('0') << std::dec << code << " " << message << std::endl;
-            std::cerr << s.str();
-        } else {
-            std::ostringstream s;
-            s << "INFO  " << std::setw(5) << std::setfill('0') << std::dec << code << " " << message << std::endl;
-            std::cerr << s.str();
-        }
+        log("INFO ", nullptr, code, LogSink::KIND::LIMITED, message);
     }
 
     void Ctx::debug(int code, const std::string& message) const {
         if (logLevel < LOG::DEBUG)
             return;
 
-        if (OLR_LOCALES == LOCALES::TIMESTAMP) {
-            std::ostringstream s;
-            char timestamp[30];
-            Data::epochToIso8601(clock->getTimeT() + logTimezone, timestamp, false, false);
-            s << timestamp << " DEBUG " << std::setw(5) << std::setfill('0') << std::dec << code << " " << message << std::endl;
-            std::cerr << s.str();
-        } else {
-            std::ostringstream s;
-            s << "DEBUG " << std::setw(5) << std::setfill('0') << std::dec << code << " " << message << std::endl;
-            std::cerr << s.str();
-        }
+        log("DEBUG", nullptr, code, LogSink::KIND::LIMITED, message);
     }
 
     void Ctx::logTraceInt(TRACE mask, const std::string& message) const {
-        std::string code;
+        const char* code = "";
         switch (mask) {
             case TRACE::DML:
                 code = "DML  ";
@@ -1105,17 +2107,7 @@ namespace OpenLogReplicator {
                 break;
         }
 
-        if (OLR_LOCALES == LOCALES::TIMESTAMP) {
-            std::ostringstream s;
-            char timestamp[30];
-            Data::epochToIso8601(clock->getTimeT() + logTimezone, timestamp, false, false);
-            s << timestamp << " TRACE " << code << " " << message << '\n';
-            std::cerr << s.str();
-        } else {
-            std::ostringstream s;
-            s << "TRACE " << code << " " << message << '\n';
-            std::cerr << s.str();
-        }
+        log("TRACE", code, 0, LogSink::KIND::NORMAL, message);
     }
 
     void Ctx::printMemoryUsageHWM() const {
@@ -1125,8 +2117,16 @@ namespace OpenLogReplicator {
                 std::to_string(memoryModulesHWM[static_cast<uint>(Ctx::MEMORY::PARSER)] * MEMORY_CHUNK_SIZE_MB) + "MB, disk read buffer HWM: " +
                 std::to_string(memoryModulesHWM[static_cast<uint>(Ctx::MEMORY::READER)] * MEMORY_CHUNK_SIZE_MB) + "MB, transaction HWM: " +
                 std::to_string(memoryModulesHWM[static_cast<uint>(Ctx::MEMORY::TRANSACTIONS)] * MEMORY_CHUNK_SIZE_MB) + "MB, swapped: " +
-                std::to_string(swappedMB) + "MB, disk write buffer HWM: " +
+                std::to_string(swappedMB) + "MB" + (swapCompress ? " (" + std::to_string(swappedDiskBytes / 1024 / 1024) + "MB on disk)" : "") +
+                ", disk write buffer HWM: " +
                 std::to_string(memoryModulesHWM[static_cast<uint>(Ctx::MEMORY::WRITER)] * MEMORY_CHUNK_SIZE_MB) + "MB");
+
+        if (numa) {
+            std::string nodes;
+            for (uint node = 0; node < numaNodes; ++node)
+                nodes += (node > 0 ? ", node " : "node ") + std::to_string(node) + ": " + std::to_string(memoryNodeHWM[node] * MEMORY_CHUNK_SIZE_MB) + "MB";
+            info(0, "Memory HWM per NUMA " + nodes);
+        }
     }
 
     void Ctx::printMemoryUsageCurrent() const {
@@ -1139,6 +2139,7 @@ namespace OpenLogReplicator {
                 std::to_string(memoryModulesAllocated[static_cast<uint>(Ctx::MEMORY::READER)] * MEMORY_CHUNK_SIZE_MB) + "MB, transaction: " +
                 std::to_string(memoryModulesAllocated[static_cast<uint>(Ctx::MEMORY::TRANSACTIONS)] * MEMORY_CHUNK_SIZE_MB) + "MB, swapped: " +
                 std::to_string(swappedMB) + "MB, disk write buffer: " +
-                std::to_string(memoryModulesAllocated[static_cast<uint>(Ctx::MEMORY::WRITER)] * MEMORY_CHUNK_SIZE_MB) + "MB");
+                std::to_string(memoryModulesAllocated[static_cast<uint>(Ctx::MEMORY::WRITER)] * MEMORY_CHUNK_SIZE_MB) + "MB, pages: " +
+                memoryPagesName(memoryPages));
     }
 }
@@ -21,15 +21,21 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include <condition_variable>
 #include <cstddef>
 #include <fstream>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <rapidjson/document.h>
 #include <rapidjson/error/en.h>
+#include <sched.h>
 #include <set>
 #include <thread>
 #include <unordered_map>
 #include <vector>
 
+#include "ClockTsc.h"
+#include "LogSink.h"
+#include "MemoryPool.h"
+#include "RuntimeStats.h"
 #include "types/LobId.h"
 #include "types/Scn.h"
 #include "types/Xid.h"
@@ -40,14 +46,24 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 namespace OpenLogReplicator {
     class Clock;
     class Metrics;
+    class SchemaCache;
+    class RedoProfile;
+    class TableCost;
     class Thread;
+    class Tracer;
 
     class SwapChunk final {
     public:
         std::vector<uint8_t*> chunks;
         int64_t swappedMin{-1};
         int64_t swappedMax{-1};
+        // Order in which the transactions started to use memory, lower is older
+        uint64_t sequence{0};
         bool release{false};
+        // Chunks are being read by the parser thread, none of them is swapped out meanwhile
+        bool pinned{false};
+        // Chunks up to this one were advised to be paged out, only with the file backed transaction memory
+        int64_t pagedOutMax{-1};
     };
 
     class Ctx final {
@@ -62,6 +78,15 @@ namespace OpenLogReplicator {
             BUILDER, MISC, PARSER, READER, TRANSACTIONS, WRITER
         };
         static constexpr uint MEMORY_COUNT{6};
+        enum class HUGE_PAGES : unsigned char {
+            NONE, TRANSPARENT, HUGE_2MB, HUGE_1GB
+        };
+        enum class SWAP_POLICY : unsigned char {
+            FIRST, LARGEST, OLDEST, COST
+        };
+        enum class TRANSPORT_COMPRESSION : unsigned char {
+            NONE, ZSTD, LZ4
+        };
         enum class DISABLE_CHECKS : unsigned char {
             GRANTS = 1 << 0, SUPPLEMENTAL_LOG = 1 << 1, BLOCK_SUM = 1 << 2, JSON_TAGS = 1 << 3
         };
@@ -70,7 +95,7 @@ namespace OpenLogReplicator {
             SHOW_DDL = 1 << 5, SHOW_HIDDEN_COLUMNS = 1 << 6, SHOW_GUARD_COLUMNS = 1 << 7, SHOW_NESTED_COLUMNS = 1 << 8, SHOW_UNUSED_COLUMNS = 1 << 9,
             SHOW_INCOMPLETE_TRANSACTIONS = 1 << 10, SHOW_SYSTEM_TRANSACTIONS = 1 << 11, SHOW_CHECKPOINT = 1 << 12, CHECKPOINT_KEEP = 1 << 13,
             VERIFY_SCHEMA = 1 << 14, RAW_COLUMN_DATA = 1 << 15, EXPERIMENTAL_XMLTYPE = 1 << 16, EXPERIMENTAL_JSON = 1 << 17,
-            EXPERIMENTAL_NOT_NULL_MISSING = 1 << 18
+            EXPERIMENTAL_NOT_NULL_MISSING = 1 << 18, LOB_STREAM = 1 << 19, LAZY_SCHEMA = 1 << 20
         };
         enum class TRACE : unsigned int {
             DML = 1 << 0, DUMP = 1 << 1, LOB = 1 << 2, LWN = 1 << 3, THREADS = 1 << 4, SQL = 1 << 5, FILE = 1 << 6, DISK = 1 << 7, PERFORMANCE = 1 << 8,
@@ -81,6 +106,8 @@ namespace OpenLogReplicator {
         static constexpr uint64_t MEMORY_CHUNK_SIZE_MB{1};
         static constexpr uint64_t MEMORY_CHUNK_SIZE{MEMORY_CHUNK_SIZE_MB * 1024 * 1024};
         static constexpr uint64_t MEMORY_CHUNK_MIN_MB{32};
+        // Swapped chunks released under one lock
+        static constexpr uint64_t MEMORY_RELEASE_BATCH{64};
 
         static constexpr typeBlk ZERO_BLK{0xFFFFFFFF};
 
@@ -104,6 +131,17 @@ namespace OpenLogReplicator {
         static constexpr uint JSON_TAG_LENGTH{4096};
 
         static const std::string memoryModules[MEMORY_COUNT];
+        static constexpr uint MEMORY_NODES_MAX{16};
+        // Free chunks looked at when searching for one from the node of the caller
+        static constexpr uint64_t NUMA_SCAN_CHUNKS{64};
+        static constexpr uint64_t MEMORY_BLOCK_MAX_MB{64};
+        // Released blocks kept per module for reuse
+        static constexpr uint64_t MEMORY_BLOCKS_KEEP{4};
+        // File backed transaction chunks read ahead of the one being flushed
+        static constexpr uint64_t TRANSACTION_MAP_READ_AHEAD{4};
+        static constexpr const char* TRANSACTION_MAP_FILE_NAME{"transactions.map"};
+        // Wait time when the shared pool is exhausted, a release by another tenant does not notify this one
+        static constexpr uint64_t MEMORY_POOL_WAIT_US{10000};
 
         uint trace{0};
         uint flags{0};
@@ -120,23 +158,127 @@ namespace OpenLogReplicator {
         uint64_t memoryChunksAllocated{0};
         uint64_t memoryChunksFree{0};
         uint64_t memoryChunksHWM{0};
-        uint64_t memoryModulesAllocated[MEMORY_COUNT]{0, 0, 0, 0, 0, 0};
+        std::atomic<uint64_t> memoryModulesAllocated[MEMORY_COUNT]{0, 0, 0, 0, 0, 0};
+        // Chunks held in the per-thread caches, counted neither as free nor as used by a module
+        std::atomic<uint64_t> memoryChunksCached{0};
+        std::atomic<uint64_t> memoryWaiters{0};
+        std::vector<Thread*> memoryCacheThreads;
+        // NUMA node of every allocated chunk and of the entries of the free stack, only maintained when numa is set
+        std::unordered_map<uint8_t*, uint8_t> memoryChunkNodes;
+        uint8_t* memoryChunksNode{nullptr};
+        // Lowest number of free chunks since the last trim and when it was, only used by the memory manager thread
+        uint64_t memoryChunksFreeLow{0};
+        time_ut memoryTrimTime{0};
+        uint64_t memoryNodeUsed[MEMORY_NODES_MAX]{};
+        uint64_t memoryNodeHWM[MEMORY_NODES_MAX]{};
+        // Single mapping holding all chunks when huge pages are requested, chunks are carved in order and never returned to the OS
+        uint8_t* memoryRegion{nullptr};
+        uint64_t memoryRegionSize{0};
+        HUGE_PAGES memoryPages{HUGE_PAGES::NONE};
+        // Shared mapping of a file holding the transaction chunks instead of the explicit swap, guarded by swapMtx. Chunks are carved in
+        // order, the released ones are punched out of the file and reused
+        uint8_t* transactionMap{nullptr};
+        uint64_t transactionMapChunks{0};
+        uint64_t transactionMapCarved{0};
+        std::vector<uint8_t*> transactionMapFree;
+        // Modules using blocks of many contiguous chunks, allocated outside the free stack and the per-thread caches
+        uint64_t memoryModuleChunks[MEMORY_COUNT]{1, 1, 1, 1, 1, 1};
+        std::vector<uint8_t*> memoryBlocksFree[MEMORY_COUNT];
+        uint64_t memoryBlockChunks{0};
+        uint64_t memoryBlockChunksFree{0};
+        // Share of memory-min-mb handed over to the shared pool instead of being preallocated
+        uint64_t memoryPoolKeep{0};
 
         std::mutex mtx;
         std::condition_variable condMainLoop;
         std::set<Thread*> threads;
         pthread_t mainThread;
+        uint64_t flightRecorderRequestsDone{0};
         bool outOfMemoryParser{false};
         bool bigEndian{false};
 
+        void emitMemoryUsedModule(MEMORY module, uint64_t allocatedModule);
+        void updateMemoryModuleHWM(MEMORY module, uint64_t allocatedModule);
+        void memoryCacheRegister(Thread* t);
+        bool memoryCacheDrain(Thread* t);
+        [[nodiscard]] uint memoryNode(const Thread* t) const;
+        uint8_t* allocateMemoryChunk(uint node);
+        void releaseMemoryChunkNode(uint8_t* chunk);
+        void releaseMemoryChunk(uint8_t* chunk);
+        uint8_t* allocateMemoryBlock(uint64_t chunks);
+        void releaseMemoryBlock(uint8_t* block, uint64_t chunks);
+        void pushFreeChunk(uint8_t* chunk, bool used);
+        uint8_t* popFreeChunk(const Thread* t, int64_t& nodeHwm);
+        void mapMemoryRegion();
+        void mapTransactionMemory();
+        [[nodiscard]] uint8_t* getTransactionChunk(Thread* t);
+        void freeTransactionChunk(Thread* t, uint8_t* tc);
+        uint8_t* getMemoryBlock(Thread* t, MEMORY module);
+        void freeMemoryBlock(Thread* t, MEMORY module, uint8_t* block);
+        bool releaseMemoryBlocks();
+        [[nodiscard]] static std::string memoryPagesName(HUGE_PAGES pages);
+
     public:
         //配置更新标志
         std::atomic<bool> configUpdated = false;
 
-        uint64_t memoryModulesHWM[MEMORY_COUNT]{0, 0, 0, 0, 0, 0};
+        // Page type requested for the memory chunks, falls back to smaller pages when not available
+        HUGE_PAGES hugePages{HUGE_PAGES::NONE};
+
+        // Chunks shared with the other tenants of the process, set before initialize(), unused with huge pages
+        MemoryPool* memoryPool{nullptr};
+        // Weights of the tenant in the shared pool, set before initialize()
+        MemoryPool::Share memoryShare;
+
+        // System dictionaries shared with the other tenants of the process, set before the schema is loaded
+        SchemaCache* schemaCache{nullptr};
+
+        // Id of the tenant when run by the replicator manager, empty for a standalone process
+        std::string tenant;
+
+        // NUMA aware memory chunk pools
+        bool numa{false};
+        uint numaNodes{1};
+#if __linux__
+        // Scheduling of a thread kind, real-time policies take priority, SCHED_OTHER takes the nice value
+        struct ThreadPriority {
+            int policy{SCHED_OTHER};
+            int priority{0};
+            int nice{0};
+            bool niceSet{false};
+        };
+
+        // CPU sets and scheduling by thread kind (first word of Thread::getName()), "default" applies to kinds not listed
+        std::unordered_map<std::string, cpu_set_t> threadAffinity;
+        std::unordered_map<std::string, ThreadPriority> threadPriority;
+        // Threaded cgroup v2 group of the tenant, every thread moves itself there when it starts, empty when not used
+        std::string cgroupPath;
+        std::string cgroupParentPath;
+#endif
+
+        std::atomic<uint64_t> memoryModulesHWM[MEMORY_COUNT]{0, 0, 0, 0, 0, 0};
 
         Metrics* metrics{nullptr};
+        // Set when sampled transactions are traced
+        Tracer* tracer{nullptr};
+        // Set when the cost of the tables is collected
+        TableCost* tableCost{nullptr};
+        // Set when the redo of a batch run is profiled instead of replicated, owned by the replicator
+        RedoProfile* redoProfile{nullptr};
+        RuntimeStats stats;
+        // One in that many LWNs, transactions and messages is timed for the latency histograms, 0 disables sampling
+        uint64_t latencySample{100};
         Clock* clock{nullptr};
+        // Timing of thread contexts, called without virtual dispatch
+        ClockTsc contextClock;
+        mutable LogSink logSink;
+        // Per-thread rings of the last events, dumped on SIGUSR2, by the watchdog on a stall and on request
+        bool flightRecorder{true};
+        // Watchdog: seconds without progress of the parser or the writer while they have input, 0 disables it
+        uint64_t stallTimeoutS{60};
+        uint64_t stallSamples{3};
+        // Dump requests of all tenants, raised from the signal handler
+        static std::atomic<uint64_t> flightRecorderRequests;
         std::string versionStr;
         std::string config;
         std::unique_ptr<std::ofstream> dumpStream;
@@ -150,6 +292,15 @@ namespace OpenLogReplicator {
         uint64_t memoryChunksUnswapBufferMin{0};
         uint64_t memoryChunksWriteBufferMax{0};
         uint64_t memoryChunksWriteBufferMin{0};
+        // Free chunks above the minimum are kept for bursts and released after being idle for that long, 0 - released at once
+        uint64_t memoryTrimIdleS{30};
+        // Output not yet released by the writers above which the parser waits at the LWN boundary, 0 - no flow control
+        uint64_t writeCreditMb{0};
+        // Transaction chunks taken from a file mapped in this directory and paged by the kernel instead of swapped, 0 MB - not used
+        std::string transactionMapPath;
+        uint64_t transactionMapMb{0};
+        // Transaction chunks not advised to be paged out above which the oldest transactions are paged out, 0 - left to the kernel
+        uint64_t transactionMapResidentMb{0};
 
         // Disk read buffers
         uint64_t bufferSizeMax{0};
@@ -161,11 +312,62 @@ namespace OpenLogReplicator {
         uint64_t checkpointIntervalMb{500};
         uint64_t checkpointKeep{100};
         uint64_t schemaForceInterval{20};
+        uint64_t schemaDeltaMax{10};
+        // Transactions open longer are written with the checkpoint and don't hold the restart position back, 0 - disabled
+        uint64_t transactionPersistS{0};
         // Reader
         uint64_t redoReadSleepUs{50000};
+        // Longest sleep between polls of an idle online redo log
+        uint64_t redoReadSleepMaxUs{1000000};
         uint64_t redoVerifyDelayUs{0};
         uint64_t archReadSleepUs{10000000};
         uint64_t refreshIntervalUs{10000000};
+        bool readIoUring{false};
+        // Archived redo logs are mapped and parsed in place instead of read to memory chunks
+        bool readMmap{false};
+        // Online redo logs are read from two members of the group at once
+        bool readHedged{false};
+        // Redo log headers are kept in a catalog used to find the start sequence
+        bool positionCatalog{true};
+        // Archived redo logs may be compressed with zstd or gzip
+        bool archCompressed{false};
+        // Archived redo logs may be read from S3 compatible object storage
+        bool objectStore{false};
+        std::string objectStoreEndpoint;
+        std::string objectStoreRegion{"us-east-1"};
+        std::string objectStoreAccessKey;
+        std::string objectStoreSecretKey;
+        uint objectStoreStreams{4};
+        uint64_t objectStoreRangeMb{8};
+        // Redo logs in ASM are read with DBMS_DISKGROUP over a database connection instead of asmcmd over SSH
+        bool asmDatabase{false};
+        bool asmSysAsm{false};
+        std::string asmUser;
+        std::string asmPassword;
+        std::string asmServer;
+        uint asmSessions{4};
+        uint64_t asmRangeMb{4};
+        // Compressor run on the database host for redo transferred over SSH, level 0 is the compressor default
+        TRANSPORT_COMPRESSION asmTransportCompression{TRANSPORT_COMPRESSION::NONE};
+        uint asmTransportLevel{0};
+        uint asmTransportThreads{1};
+        uint readQueueDepth{4};
+        uint archPrefetch{0};
+        // Archived logs read ahead which are also decoded ahead of the parser
+        uint archParsers{0};
+        uint64_t archPrefetchBufferMax{0};
+        uint dictionaryThreads{1};
+        uint32_t dictionaryPrefetchRows{1000};
+        // Least time between two background schema verifications, with the VERIFY_SCHEMA flag
+        uint64_t schemaVerifyIntervalS{600};
+        // Sessions reading the tables marked for the initial snapshot
+        uint snapshotThreads{1};
+        // Parser
+        uint parserThreads{0};
+        // LWN members prefetched ahead of the one being decoded, 0 - disabled
+        uint lwnPrefetch{4};
+        // Committed transactions queued for the flusher thread, 0 when they are flushed by the parser thread
+        uint64_t commitFlushQueue{0};
         // Writer
         uint64_t pollIntervalUs{100000};
         uint64_t queueSize{65536};
@@ -180,10 +382,24 @@ namespace OpenLogReplicator {
         // Transaction buffer
         std::string dumpPath{"."};
         std::string redoCopyPath;
+        // Complete copies are compressed with lz4
+        bool redoCopyCompress{false};
+        // Complete copies are served to other instances, a copy being written has the ".part" suffix
+        bool redoRelay{false};
+        // Archived redo logs are read from the relay at this URL instead of the database
+        std::string relayUrl;
+        std::string redoCachePath;
+        uint64_t redoCacheMaxMb{4096};
         uint64_t stopLogSwitches{0};
         uint64_t stopCheckpoints{0};
         uint64_t stopTransactions{0};
         typeTransactionSize transactionSizeMax{0};
+        // Rows of a bigger uncommitted transaction are sent as provisional, 0 when transactions are sent at commit only
+        typeTransactionSize transactionStreamSize{0};
+        // Released Transaction objects kept for reuse
+        uint64_t transactionPoolSize{1024};
+        // Total size of LOB pages waiting for their transaction, 0 - unlimited
+        uint64_t orphanedLobSizeMax{256 * 1024 * 1024};
         std::unordered_map<LobId, Xid> lobIdToXidMap;
         Thread* parserThread{nullptr};
         Thread* writerThread{nullptr};
@@ -192,7 +408,19 @@ namespace OpenLogReplicator {
         std::vector<Xid> commitedXids;
         std::condition_variable chunksMemoryManager;
         std::condition_variable chunksTransaction;
-        uint64_t swappedMB{0};
+        std::atomic<uint64_t> swappedMB{0};
+        // Compressed size of the swapped chunks when swap compression is enabled
+        std::atomic<uint64_t> swappedDiskBytes{0};
+        bool swapCompress{false};
+        // Size of the single swap arena file, 0 for one swap file per transaction
+        uint64_t swapArenaSize{0};
+        // Which transaction is swapped first when memory is short
+        SWAP_POLICY swapPolicy{SWAP_POLICY::FIRST};
+        // Chunks a single transaction may keep in memory before it is swapped regardless of the total usage, 0 - unlimited
+        uint64_t swapTransactionChunksMax{0};
+        uint64_t swapChunkSequence{0};
+        // File backed transaction chunks not advised to be paged out, recounted by the memory manager
+        uint64_t transactionMapResident{0};
         Xid swappedFlushXid{0, 0, 0};
         Xid swappedShrinkXid{0, 0, 0};
         mutable std::mutex swapMtx;
@@ -512,6 +740,9 @@ namespace OpenLogReplicator {
         [[nodiscard]] static int32_t getJsonFieldI32(const std::string& fileName, const rapidjson::Value& value, const char* field);
         [[nodiscard]] static uint64_t getJsonFieldU64(const std::string& fileName, const rapidjson::Value& value, const char* field);
         [[nodiscard]] static int64_t getJsonFieldI64(const std::string& fileName, const rapidjson::Value& value, const char* field);
+#if __linux__
+        [[nodiscard]] static bool parseCpuList(const std::string& cpus, cpu_set_t& cpuSet);
+#endif
         [[nodiscard]] static uint getJsonFieldU(const std::string& fileName, const rapidjson::Value& value, const char* field);
         [[nodiscard]] static int getJsonFieldI(const std::string& fileName, const rapidjson::Value& value, const char* field);
         [[nodiscard]] static const rapidjson::Value& getJsonFieldO(const std::string& fileName, const rapidjson::Value& value, const char* field);
@@ -536,19 +767,44 @@ namespace OpenLogReplicator {
         [[nodiscard]] bool nothingToSwap(Thread* t) const;
         [[nodiscard]] uint64_t getMemoryHWM() const;
         [[nodiscard]] uint64_t getAllocatedMemory() const;
+        [[nodiscard]] uint64_t getMemoryModuleMb(MEMORY module) const;
+        [[nodiscard]] uint64_t getMemoryModuleHwmMb(MEMORY module) const;
+        void forEachThread(const std::function<void(const Thread*)>& visit);
+        void emitThreadMetrics();
+        [[nodiscard]] bool isLatencySampled(uint64_t& sampleCnt) const {
+            if (latencySample == 0 || ++sampleCnt < latencySample)
+                return false;
+            sampleCnt = 0;
+            return true;
+        }
+        void recordLatency(RuntimeStats::LATENCY stage, time_ut start, time_ut end);
         [[nodiscard]] uint64_t getSwapMemory(Thread* t) const;
         [[nodiscard]] uint64_t getFreeMemory(Thread* t) const;
-        [[nodiscard]] uint8_t* getMemoryChunk(Thread* t, MEMORY module, bool swap = false);
+        [[nodiscard]] uint8_t* getMemoryChunk(Thread* t, MEMORY module, bool swap = false, bool wait = true);
+        void setMemoryChunkSizeMb(MEMORY module, uint64_t sizeMb);
+        [[nodiscard]] uint64_t getMemoryChunkSize(MEMORY module) const {
+            return memoryModuleChunks[static_cast<uint>(module)] * MEMORY_CHUNK_SIZE;
+        }
+        void memoryCacheRelease(Thread* t);
+        void memoryTrim(Thread* t);
+        [[nodiscard]] bool isTransactionMapped() const {
+            return transactionMap != nullptr;
+        }
         void freeMemoryChunk(Thread* t, MEMORY module, uint8_t* chunk);
         void swappedMemoryInit(Thread* t, Xid xid);
         [[nodiscard]] uint64_t swappedMemorySize(Thread* t, Xid xid) const;
         [[nodiscard]] uint8_t* swappedMemoryGet(Thread* t, Xid xid, int64_t index);
         void swappedMemoryRelease(Thread* t, Xid xid, int64_t index);
+        void swappedMemoryRelease(Thread* t, Xid xid, const std::vector<uint64_t>& indexes);
         [[nodiscard]] uint8_t* swappedMemoryGrow(Thread* t, Xid xid);
         [[nodiscard]] uint8_t* swappedMemoryShrink(Thread* t, Xid xid);
         void swappedMemoryFlush(Thread* t, Xid xid);
         void swappedMemoryRemove(Thread* t, Xid xid);
+        void swappedMemoryClear(Thread* t, Xid xid);
         void wontSwap(Thread* t);
+        void swappedMemorySnapshot(Thread* t, std::vector<TransactionSnapshot::Entry>& entries) const;
+        [[nodiscard]] bool swappedMemoryPin(Thread* t, Xid xid, std::vector<uint8_t*>& tcs);
+        void swappedMemoryUnpin(Thread* t, Xid xid);
 
         void stopHard();
         void stopSoft();
@@ -560,8 +816,17 @@ namespace OpenLogReplicator {
         bool wakeThreads();
         void spawnThread(Thread* t);
         void finishThread(Thread* t);
+#if __linux__
+        bool createCgroup(uint64_t cpuWeight);
+        void joinCgroup();
+        void removeCgroup();
+#endif
         void signalDump();
+        static void requestFlightRecorderDump();
+        void checkFlightRecorder();
+        void dumpFlightRecorder(const std::string& reason);
 
+        void log(const char* level, const char* tag, int code, LogSink::KIND kind, const std::string& message) const;
         void welcome(const std::string& message) const;
         void hint(const std::string& message) const;
         void error(int code, const std::string& message) const;
@@ -48,6 +48,8 @@ namespace OpenLogReplicator {
         bool guard;
         bool xmlType;
         bool nullWarning{false};
+        // Escaped and quoted JSON key with the colon: "NAME":
+        std::string jsonName;
 
         DbColumn(typeCol newCol, typeCol newGuardSeg, typeCol newSegCol, std::string newName, SysCol::COLTYPE newType, uint newLength,
                  int newPrecision, int newScale, uint64_t newCharsetId, typeCol newNumPk, bool newNullable, bool newHidden,
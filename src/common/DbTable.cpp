@@ -26,7 +26,9 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include "DbTable.h"
 #include "exception/RuntimeException.h"
 #include "expression/BoolValue.h"
+#include "expression/Condition.h"
 #include "expression/Token.h"
+#include "types/Data.h"
 
 namespace OpenLogReplicator {
     DbTable::DbTable(typeObj newObj, typeDataObj newDataObj, typeUser newUser, typeCol newCluCols, DbTable::OPTIONS newOptions, std::string newOwner,
@@ -110,8 +112,73 @@ namespace OpenLogReplicator {
             delete token;
         tokens.clear();
 
-        delete conditionValue;
-        conditionValue = nullptr;
+        delete conditionCompiled;
+        conditionCompiled = nullptr;
+    }
+
+    void DbTable::buildJsonFragments() {
+        jsonSchema.assign(R"("schema":{"owner":")");
+        Data::appendJsonEscape(jsonSchema, owner);
+        jsonSchema.append(R"(","table":")");
+        Data::appendJsonEscape(jsonSchema, name);
+        jsonSchema.push_back('"');
+
+        // FNV-1a
+        schemaVersion = 0xCBF29CE484222325ULL;
+        const auto hashAdd = [this](const void* data, uint64_t size) {
+            const auto* bytes = reinterpret_cast<const uint8_t*>(data);
+            for (uint64_t i = 0; i < size; ++i) {
+                schemaVersion ^= bytes[i];
+                schemaVersion *= 0x100000001B3ULL;
+            }
+        };
+        hashAdd(owner.data(), owner.size() + 1);
+        hashAdd(name.data(), name.size() + 1);
+
+        for (DbColumn* column: columns) {
+            if (column == nullptr)
+                continue;
+            hashAdd(column->name.data(), column->name.size() + 1);
+            const int64_t layout[5]{static_cast<int64_t>(column->type), static_cast<int64_t>(column->length), column->precision, column->scale,
+                                    column->nullable ? 1 : 0};
+            hashAdd(layout, sizeof(layout));
+
+            column->jsonName.assign(1, '"');
+            Data::appendJsonEscape(column->jsonName, column->name);
+            column->jsonName.append("\":");
+        }
+    }
+
+    void DbTable::buildTagPlan() {
+        tagPlan.clear();
+        tagPlanScalar = true;
+        for (const typeCol segCol: tagCols) {
+            const typeCol col = segCol - 1;
+            if (col < 0 || col >= static_cast<typeCol>(columns.size()) || columns[col] == nullptr)
+                continue;
+            tagPlan.push_back(col);
+            if (columns[col]->storedAsLob)
+                tagPlanScalar = false;
+
+            switch (columns[col]->type) {
+                case SysCol::COLTYPE::VARCHAR:
+                case SysCol::COLTYPE::CHAR:
+                case SysCol::COLTYPE::NUMBER:
+                case SysCol::COLTYPE::DATE:
+                case SysCol::COLTYPE::RAW:
+                case SysCol::COLTYPE::FLOAT:
+                case SysCol::COLTYPE::DOUBLE:
+                case SysCol::COLTYPE::TIMESTAMP:
+                case SysCol::COLTYPE::TIMESTAMP_WITH_TZ:
+                case SysCol::COLTYPE::INTERVAL_YEAR_TO_MONTH:
+                case SysCol::COLTYPE::INTERVAL_DAY_TO_SECOND:
+                case SysCol::COLTYPE::UROWID:
+                    break;
+                default:
+                    // LOB locators and object types may stand for different content with the same raw value
+                    tagPlanScalar = false;
+            }
+        }
     }
 
     void DbTable::addColumn(DbColumn* column) {
@@ -142,10 +209,18 @@ namespace OpenLogReplicator {
         tablePartitions.push_back(objx);
     }
 
-    bool DbTable::matchesCondition(const Ctx* ctx, char op, const std::unordered_map<std::string, std::string>* attributes) const {
+    bool DbTable::matchesCondition(const Ctx* ctx, char op, ConditionContext& context) const {
         bool result = true;
-        if (conditionValue != nullptr)
-            result = conditionValue->evaluateToBool(op, attributes);
+        if (conditionCompiled != nullptr) {
+            const uint index = op == 'i' ? 0 : (op == 'u' ? 1 : 2);
+            if (!conditionCompiled->rowDependent && context.transaction != 0 && conditionTransaction[index] == context.transaction) {
+                result = conditionResult[index];
+            } else {
+                result = conditionCompiled->evaluate(op, context);
+                conditionTransaction[index] = context.transaction;
+                conditionResult[index] = result;
+            }
+        }
 
         if (unlikely(ctx->isTraceSet(Ctx::TRACE::CONDITION)))
             ctx->logTrace(Ctx::TRACE::CONDITION, "matchesCondition: table: " + owner + "." + name + ", condition: " + condition + ", result: " +
@@ -153,13 +228,49 @@ namespace OpenLogReplicator {
         return result;
     }
 
-    void DbTable::setCondition(const std::string& newCondition) {
+    void DbTable::setCondition(const std::string& newCondition, const Locales* locales) {
         this->condition = newCondition;
         if (newCondition.empty())
             return;
 
         Expression::buildTokens(newCondition, tokens);
-        conditionValue = Expression::buildCondition(newCondition, tokens, stack);
+        const BoolValue* conditionValue = Expression::buildCondition(newCondition, tokens, stack);
+        try {
+            conditionCompiled = new Condition(newCondition, conditionValue, this, locales);
+        } catch (RuntimeException&) {
+            delete conditionValue;
+            throw;
+        }
+        delete conditionValue;
+    }
+
+    bool DbTable::hasColumn(const std::string& columnName) const {
+        return std::any_of(columns.begin(), columns.end(), [&columnName](const DbColumn* column) { return column->name == columnName; });
+    }
+
+    // Key, tag and condition columns are always kept, they are needed to identify and filter the row
+    void DbTable::setColumnsSkipped(const std::vector<std::string>& columnList, const std::vector<std::string>& skipColumnList) {
+        columnsSkipped.clear();
+        columnsSkippedMask.clear();
+        if (columnList.empty() && skipColumnList.empty())
+            return;
+
+        for (typeCol col = 0; col < static_cast<typeCol>(columns.size()); ++col) {
+            const DbColumn* column = columns[col];
+            bool skip = std::find(skipColumnList.begin(), skipColumnList.end(), column->name) != skipColumnList.end();
+            if (!columnList.empty() && std::find(columnList.begin(), columnList.end(), column->name) == columnList.end())
+                skip = true;
+            if (!skip || column->numPk > 0)
+                continue;
+            if (std::find(tagCols.begin(), tagCols.end(), column->segCol) != tagCols.end())
+                continue;
+            if (conditionCompiled != nullptr && conditionCompiled->references(col))
+                continue;
+            columnsSkipped.push_back(col);
+            if (columnsSkippedMask.size() <= (static_cast<uint64_t>(col) >> 6))
+                columnsSkippedMask.resize((static_cast<uint64_t>(col) >> 6) + 1, 0);
+            columnsSkippedMask[static_cast<uint64_t>(col) >> 6] |= static_cast<typeMask>(1) << (col & 0x3F);
+        }
     }
 
     std::ostream& operator<<(std::ostream& os, const DbTable& table) {
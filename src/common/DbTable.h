@@ -24,10 +24,13 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include <vector>
 
 #include "expression/Token.h"
+#include "metrics/Metrics.h"
 #include "types/Types.h"
 
 namespace OpenLogReplicator {
-    class BoolValue;
+    class Condition;
+    class ConditionContext;
+    class Locales;
     class Ctx;
     class DbColumn;
     class DbLob;
@@ -61,26 +64,54 @@ namespace OpenLogReplicator {
         std::string name;
         std::string tokSuf;
         std::string condition;
-        BoolValue* conditionValue{nullptr};
+        // Escaped JSON schema prefix: "schema":{"owner":"OWNER","table":"NAME"
+        std::string jsonSchema;
+        // Hash of the column layout, the same layout always gets the same version
+        uint64_t schemaVersion{0};
+        Condition* conditionCompiled{nullptr};
+        // Attributes do not change within a transaction, so the result is kept per operation for the transaction it was evaluated for
+        mutable uint64_t conditionTransaction[3]{};
+        mutable bool conditionResult[3]{};
         std::vector<DbColumn*> columns;
         std::vector<DbLob*> lobs;
         std::vector<typeObj2> tablePartitions;
         std::vector<typeCol> pk;
         std::vector<typeCol> tagCols;
+        // Value indexes of the tag columns present in the table, resolved once. When every one is a scalar type the rendered key
+        // depends only on the raw values, so a row with the same raw values reuses the key of the previous one
+        std::vector<typeCol> tagPlan;
+        bool tagPlanScalar{false};
+        // Columns not output, cleared from the row values before the builder formats them
+        std::vector<typeCol> columnsSkipped;
+        // The same columns as a bit mask, looked up while the values of array inserts and deletes are taken
+        std::vector<typeMask> columnsSkippedMask;
         std::vector<Token*> tokens;
         std::vector<Expression*> stack;
         TABLE systemTable;
         bool sys;
+        // Built with REDO_FLAGS::LAZY_SCHEMA, the columns are added by Schema::materializeTable before the first DML is parsed
+        bool columnsPending{false};
+        // Per-table metrics counters, resolved on first use; a table rebuilt after DDL is a new object and resolves them again
+        mutable MetricsCounter* dmlOpsCounters[static_cast<uint>(Metrics::DML_OPS::NUM)]{};
 
         DbTable(typeObj newObj, typeDataObj newDataObj, typeUser newUser, typeCol newCluCols, OPTIONS newOptions, std::string newOwner,
                 std::string newName);
         ~DbTable();
 
         void addColumn(DbColumn* column);
+
+        [[nodiscard]] bool isColumnSkipped(typeCol col) const {
+            const uint64_t base = static_cast<uint64_t>(col) >> 6;
+            return base < columnsSkippedMask.size() && (columnsSkippedMask[base] & (static_cast<typeMask>(1) << (col & 0x3F))) != 0;
+        }
+        void buildJsonFragments();
+        void buildTagPlan();
         void addLob(DbLob* lob);
         void addTablePartition(typeObj newObj, typeDataObj newDataObj);
-        bool matchesCondition(const Ctx* ctx, char op, const std::unordered_map<std::string, std::string>* attributes) const;
-        void setCondition(const std::string& newCondition);
+        bool matchesCondition(const Ctx* ctx, char op, ConditionContext& context) const;
+        void setCondition(const std::string& newCondition, const Locales* locales);
+        [[nodiscard]] bool hasColumn(const std::string& columnName) const;
+        void setColumnsSkipped(const std::vector<std::string>& columnList, const std::vector<std::string>& skipColumnList);
 
         static bool isDebugTable(OPTIONS options) {
             return (static_cast<uint>(options) & static_cast<uint>(OPTIONS::DEBUG_TABLE)) != 0;
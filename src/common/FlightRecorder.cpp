@@ -0,0 +1,93 @@
+/* Ring of the last events of a thread
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include "FlightRecorder.h"
+#include "Thread.h"
+#include "types/Scn.h"
+#include "types/Xid.h"
+
+namespace OpenLogReplicator {
+    thread_local FlightRecorder* FlightRecorder::current{nullptr};
+
+    FlightRecorder::FlightRecorder(const ClockTsc* newClock) :
+            clock(newClock) {
+    }
+
+    void FlightRecorder::snapshot(std::vector<Event>& events) const {
+        const uint64_t end = head.load(std::memory_order_acquire);
+        const uint64_t begin = end > RING_SIZE ? end - RING_SIZE : 0;
+        events.reserve(events.size() + (end - begin));
+
+        for (uint64_t position = begin; position < end; ++position) {
+            const Slot& slot = slots[position & (RING_SIZE - 1)];
+            const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence != 2 * (position + 1))
+                continue;
+
+            Event event{};
+            event.time = slot.time.load(std::memory_order_relaxed);
+            event.event = static_cast<EVENT>(slot.event.load(std::memory_order_relaxed));
+            event.arg1 = slot.arg1.load(std::memory_order_relaxed);
+            event.arg2 = slot.arg2.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            // Overwritten by the owning thread while copied
+            if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+                continue;
+            events.push_back(event);
+        }
+    }
+
+    std::string FlightRecorder::describe(const Event& event, time_ut now) {
+        const uint64_t ageUs = now > event.time ? static_cast<uint64_t>(now - event.time) : 0;
+        std::string result = "-" + std::to_string(ageUs) + "us " + EVENT_NAMES[static_cast<uint>(event.event)];
+
+        switch (event.event) {
+            case EVENT::CONTEXT:
+                if (event.arg1 < static_cast<uint64_t>(Thread::CONTEXT::NUM))
+                    result += " context: " + Thread::contextNames[event.arg1];
+                else
+                    result += " context: " + std::to_string(event.arg1);
+                result += " reason: " + std::to_string(event.arg2);
+                break;
+
+            case EVENT::LWN_BEGIN:
+                result += " scn: " + Scn(event.arg1).toString() + " seq: " + std::to_string(event.arg2);
+                break;
+
+            case EVENT::LWN_END:
+                result += " scn: " + Scn(event.arg1).toString() + " bytes: " + std::to_string(event.arg2);
+                break;
+
+            case EVENT::SWAP:
+            case EVENT::UNSWAP:
+                result += " xid: " + Xid(event.arg1).toString() + " chunks: " + std::to_string(event.arg2);
+                break;
+
+            case EVENT::WRITER_CONFIRM:
+                result += " scn: " + Scn(event.arg1).toString() + " id: " + std::to_string(event.arg2);
+                break;
+
+            case EVENT::NONE:
+            case EVENT::NUM:
+                break;
+        }
+        return result;
+    }
+}
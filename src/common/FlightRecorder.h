@@ -0,0 +1,103 @@
+/* Header for FlightRecorder class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "ClockTsc.h"
+#include "types/Types.h"
+
+#ifndef FLIGHT_RECORDER_H_
+#define FLIGHT_RECORDER_H_
+
+namespace OpenLogReplicator {
+    // Last events of one thread, kept always so that the seconds before a stall can be reconstructed without tracing.
+    // Only the owning thread writes, readers copy the ring while it is written and drop the slots overwritten during the copy
+    class FlightRecorder final {
+    public:
+        enum class EVENT : unsigned char {
+            NONE, CONTEXT, LWN_BEGIN, LWN_END, SWAP, UNSWAP, WRITER_CONFIRM, NUM
+        };
+        static constexpr const char* EVENT_NAMES[static_cast<uint>(EVENT::NUM)]{"none", "context", "lwn-begin", "lwn-end", "swap",
+                                                                             "unswap", "writer-confirm"};
+        static constexpr uint64_t RING_SIZE{1024};
+
+        struct Event {
+            time_ut time;
+            EVENT event;
+            uint64_t arg1;
+            uint64_t arg2;
+        };
+
+    protected:
+        // Sequence is odd while the slot is written and 2 * (position + 1) once written
+        struct Slot {
+            std::atomic<uint64_t> sequence{0};
+            std::atomic<time_ut> time{0};
+            std::atomic<uint64_t> event{0};
+            std::atomic<uint64_t> arg1{0};
+            std::atomic<uint64_t> arg2{0};
+        };
+
+        static thread_local FlightRecorder* current;
+
+        const ClockTsc* clock;
+        std::atomic<uint64_t> head{0};
+        Slot slots[RING_SIZE];
+
+    public:
+        explicit FlightRecorder(const ClockTsc* newClock);
+
+        // Events recorded by the calling thread end up in this ring, nullptr stops recording
+        static void setCurrent(FlightRecorder* recorder) {
+            current = recorder;
+        }
+
+        static void record(EVENT event, uint64_t arg1, uint64_t arg2) {
+            FlightRecorder* recorder = current;
+            if (recorder != nullptr)
+                recorder->add(event, arg1, arg2);
+        }
+
+        void add(EVENT event, uint64_t arg1, uint64_t arg2) {
+            const uint64_t position = head.load(std::memory_order_relaxed);
+            Slot& slot = slots[position & (RING_SIZE - 1)];
+            slot.sequence.store((2 * position) + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.time.store(clock->nowUt(), std::memory_order_relaxed);
+            slot.event.store(static_cast<uint64_t>(event), std::memory_order_relaxed);
+            slot.arg1.store(arg1, std::memory_order_relaxed);
+            slot.arg2.store(arg2, std::memory_order_relaxed);
+            slot.sequence.store(2 * (position + 1), std::memory_order_release);
+            head.store(position + 1, std::memory_order_release);
+        }
+
+        [[nodiscard]] uint64_t recorded() const {
+            return head.load(std::memory_order_acquire);
+        }
+
+        // Oldest event first
+        void snapshot(std::vector<Event>& events) const;
+        // Arguments named after the event, time relative to the dump
+        [[nodiscard]] static std::string describe(const Event& event, time_ut now);
+    };
+}
+
+#endif
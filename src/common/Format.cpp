@@ -0,0 +1,268 @@
+/* Parsing of the output format section of the configuration
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include "Ctx.h"
+#include "Format.h"
+#include "exception/ConfigurationException.h"
+
+namespace OpenLogReplicator {
+    Format Format::parseJson(const Ctx* ctx, const std::string& fileName, const rapidjson::Value& formatJson) {
+        Format::DB_FORMAT dbFormat = Format::DB_FORMAT::DEFAULT;
+        if (formatJson.HasMember("db")) {
+            const uint val = Ctx::getJsonFieldU64(fileName, formatJson, "db");
+            if (val > 3)
+                throw ConfigurationException(
+                    30001,
+                    "bad JSON, invalid \"db\" value: " + std::to_string(val) + ", expected: one of {0 .. 3}");
+            dbFormat = static_cast<Format::DB_FORMAT>(val);
+        }
+
+        Format::ATTRIBUTES_FORMAT attributesFormat = Format::ATTRIBUTES_FORMAT::DEFAULT;
+        if (formatJson.HasMember("attributes")) {
+            const uint val = Ctx::getJsonFieldU64(fileName, formatJson, "attributes");
+            if (val > 7)
+                throw ConfigurationException(
+                    30001,
+                    "bad JSON, invalid \"attributes\" value: " + std::to_string(val) +
+                    ", expected: one of {0 .. 7}");
+            attributesFormat = static_cast<Format::ATTRIBUTES_FORMAT>(val);
+        }
+
+        Format::INTERVAL_DTS_FORMAT intervalDtsFormat = Format::INTERVAL_DTS_FORMAT::UNIX_NANO;
+        if (formatJson.HasMember("interval-dts")) {
+            const uint val = Ctx::getJsonFieldU(fileName, formatJson, "interval-dts");
+            if (val > 10)
+                throw ConfigurationException(
+                    30001,
+                    "bad JSON, invalid \"interval-dts\" value: " + std::to_string(val) +
+                    ", expected: one of {0 .. 10}");
+            intervalDtsFormat = static_cast<Format::INTERVAL_DTS_FORMAT>(val);
+        }
+
+        Format::INTERVAL_YTM_FORMAT intervalYtmFormat = Format::INTERVAL_YTM_FORMAT::MONTHS;
+        if (formatJson.HasMember("interval-ytm")) {
+            const uint val = Ctx::getJsonFieldU(fileName, formatJson, "interval-ytm");
+            if (val > 4)
+                throw ConfigurationException(
+                    30001,
+                    "bad JSON, invalid \"interval-ytm\" value: " + std::to_string(val) +
+                    ", expected: one of {0 .. 4}");
+            intervalYtmFormat = static_cast<Format::INTERVAL_YTM_FORMAT>(val);
+        }
+
+        Format::MESSAGE_FORMAT messageFormat = Format::MESSAGE_FORMAT::DEFAULT;
+        if (formatJson.HasMember("message")) {
+            const uint val = Ctx::getJsonFieldU(fileName, formatJson, "message");
+            if (val > 31)
+                throw ConfigurationException(
+                    30001,
+                    "bad JSON, invalid \"message\" value: " + std::to_string(val) + ", expected: one of {0 .. 31}");
+            if ((val & static_cast<uint>(Format::MESSAGE_FORMAT::FULL)) != 0 &&
+                (val & (static_cast<uint>(Format::MESSAGE_FORMAT::SKIP_BEGIN) |
+                        static_cast<uint>(Format::MESSAGE_FORMAT::SKIP_COMMIT))) != 0)
+                throw ConfigurationException(30001, "bad JSON, invalid \"message\" value: " + std::to_string(val) +
+                                                    ", expected: BEGIN/COMMIT flag is unset (" +
+                                                    std::to_string(
+                                                        static_cast<uint>(Format::MESSAGE_FORMAT::SKIP_BEGIN)) +
+                                                    "/" + std::to_string(
+                                                        static_cast<uint>(Format::MESSAGE_FORMAT::SKIP_COMMIT)) +
+                                                    ") together with FULL mode (" +
+                                                    std::to_string(static_cast<uint>(Format::MESSAGE_FORMAT::FULL))
+                                                    + ")");
+            messageFormat = static_cast<Format::MESSAGE_FORMAT>(val);
+        }
+
+        Format::RID_FORMAT ridFormat = Format::RID_FORMAT::SKIP;
+        if (formatJson.HasMember("rid")) {
+            const uint val = Ctx::getJsonFieldU(fileName, formatJson, "rid");
+            if (val > 1)
+                throw ConfigurationException(
+                    30001, "bad JSON, invalid \"rid\" value: " + std::to_string(val) + ", expected: one of {0, 1}");
+            ridFormat = static_cast<Format::RID_FORMAT>(val);
+        }
+
+        Format::XID_FORMAT xidFormat = Format::XID_FORMAT::TEXT_HEX;
+        if (formatJson.HasMember("xid")) {
+            const uint val = Ctx::getJsonFieldU(fileName, formatJson, "xid");
+            if (val > 2)
+                throw ConfigurationException(
+                    30001,
+                    "bad JSON, invalid \"xid\" value: " + std::to_string(val) + ", expected: one of {0 .. 2}");
+            xidFormat = static_cast<Format::XID_FORMAT>(val);
+        }
+
+        Format::TIMESTAMP_FORMAT timestampFormat = Format::TIMESTAMP_FORMAT::UNIX_NANO;
+        if (formatJson.HasMember("timestamp")) {
+            const uint val = Ctx::getJsonFieldU(fileName, formatJson, "timestamp");
+            if (val > 15)
+                throw ConfigurationException(
+                    30001,
+                    "bad JSON, invalid \"timestamp\" value: " + std::to_string(val) +
+                    ", expected: one of {0 .. 15}");
+            timestampFormat = static_cast<Format::TIMESTAMP_FORMAT>(val);
+        }
+
+        Format::TIMESTAMP_TZ_FORMAT timestampTzFormat = Format::TIMESTAMP_TZ_FORMAT::UNIX_NANO_STRING;
+        if (formatJson.HasMember("timestamp-tz")) {
+            const uint val = Ctx::getJsonFieldU(fileName, formatJson, "timestamp-tz");
+            if (val > 11)
+                throw ConfigurationException(
+                    30001,
+                    "bad JSON, invalid \"timestamp-tz\" value: " + std::to_string(val) +
+                    ", expected: one of {0 .. 11}");
+            timestampTzFormat = static_cast<Format::TIMESTAMP_TZ_FORMAT>(val);
+        }
+
+        Format::TIMESTAMP_ALL timestampAll = Format::TIMESTAMP_ALL::JUST_BEGIN;
+        if (formatJson.HasMember("timestamp-all")) {
+            const uint val = Ctx::getJsonFieldU64(fileName, formatJson, "timestamp-all");
+            if (val > 1)
+                throw ConfigurationException(
+                    30001,
+                    "bad JSON, invalid \"timestamp-all\" value: " + std::to_string(val) +
+                    ", expected: one of {0, 1}");
+            timestampAll = static_cast<Format::TIMESTAMP_ALL>(val);
+        }
+
+        Format::CHAR_FORMAT charFormat = Format::CHAR_FORMAT::UTF8;
+        if (formatJson.HasMember("char")) {
+            const uint val = Ctx::getJsonFieldU(fileName, formatJson, "char");
+            if (val > 3)
+                throw ConfigurationException(
+                    30001,
+                    "bad JSON, invalid \"char\" value: " + std::to_string(val) + ", expected: one of {0 .. 3}");
+            charFormat = static_cast<Format::CHAR_FORMAT>(val);
+        }
+
+        Format::SCN_FORMAT scnFormat = Format::SCN_FORMAT::NUMERIC;
+        if (formatJson.HasMember("scn")) {
+            const uint val = Ctx::getJsonFieldU(fileName, formatJson, "scn");
+            if (val > 1)
+                throw ConfigurationException(
+                    30001, "bad JSON, invalid \"scn\" value: " + std::to_string(val) + ", expected: one of {0, 1}");
+            scnFormat = static_cast<Format::SCN_FORMAT>(val);
+        }
+
+        Format::SCN_TYPE scnType = Format::SCN_TYPE::NONE;
+        if (formatJson.HasMember("scn-type")) {
+            const uint val = Ctx::getJsonFieldU64(fileName, formatJson, "scn-type");
+            if (val > 3)
+                throw ConfigurationException(
+                    30001,
+                    "bad JSON, invalid \"scn-type\" value: " + std::to_string(val) + ", expected: one of {0, 3}");
+            scnType = static_cast<Format::SCN_TYPE>(val);
+        }
+
+        Format::UNKNOWN_FORMAT unknownFormat = Format::UNKNOWN_FORMAT::QUESTION_MARK;
+        if (formatJson.HasMember("unknown")) {
+            const uint val = Ctx::getJsonFieldU(fileName, formatJson, "unknown");
+            if (val > 1)
+                throw ConfigurationException(
+                    30001,
+                    "bad JSON, invalid \"unknown\" value: " + std::to_string(val) + ", expected: one of {0, 1}");
+            unknownFormat = static_cast<Format::UNKNOWN_FORMAT>(val);
+        }
+
+        Format::SCHEMA_FORMAT schemaFormat = Format::SCHEMA_FORMAT::DEFAULT;
+        if (formatJson.HasMember("schema")) {
+            const uint val = Ctx::getJsonFieldU(fileName, formatJson, "schema");
+            if (val > 15)
+                throw ConfigurationException(
+                    30001,
+                    "bad JSON, invalid \"schema\" value: " + std::to_string(val) + ", expected: one of {0 .. 15}");
+            schemaFormat = static_cast<Format::SCHEMA_FORMAT>(val);
+        }
+
+        Format::COLUMN_FORMAT columnFormat = Format::COLUMN_FORMAT::CHANGED;
+        if (formatJson.HasMember("column")) {
+            const uint val = Ctx::getJsonFieldU(fileName, formatJson, "column");
+            if (val > 2)
+                throw ConfigurationException(
+                    30001,
+                    "bad JSON, invalid \"column\" value: " + std::to_string(val) + ", expected: one of {0 .. 2}");
+
+            if (ctx->isFlagSet(Ctx::REDO_FLAGS::SCHEMALESS) && val != 0)
+                throw ConfigurationException(30001, "bad JSON, invalid \"column\" value: " + std::to_string(val) +
+                                                    ", expected: not used when flags has set schemaless mode (flags: "
+                                                    + std::to_string(ctx->flags) + ")");
+            columnFormat = static_cast<Format::COLUMN_FORMAT>(val);
+        }
+
+        Format::UNKNOWN_TYPE unknownType = Format::UNKNOWN_TYPE::HIDE;
+        if (formatJson.HasMember("unknown-type")) {
+            const uint val = Ctx::getJsonFieldU(fileName, formatJson, "unknown-type");
+            if (val > 1)
+                throw ConfigurationException(
+                    30001,
+                    "bad JSON, invalid \"unknown-type\" value: " + std::to_string(val) +
+                    ", expected: one of {0, 1}");
+            unknownType = static_cast<Format::UNKNOWN_TYPE>(val);
+        }
+
+        Format::RAW_FORMAT rawFormat = Format::RAW_FORMAT::HEX;
+        if (formatJson.HasMember("raw")) {
+            const uint val = Ctx::getJsonFieldU(fileName, formatJson, "raw");
+            if (val > 1)
+                throw ConfigurationException(
+                    30001,
+                    "bad JSON, invalid \"raw\" value: " + std::to_string(val) +
+                    ", expected: one of {0, 1}");
+            rawFormat = static_cast<Format::RAW_FORMAT>(val);
+        }
+
+        Format::COMPACT_FORMAT compactFormat = Format::COMPACT_FORMAT::NONE;
+        if (formatJson.HasMember("compact")) {
+            const uint val = Ctx::getJsonFieldU(fileName, formatJson, "compact");
+            if (val > 1)
+                throw ConfigurationException(
+                    30001,
+                    "bad JSON, invalid \"compact\" value: " + std::to_string(val) +
+                    ", expected: one of {0, 1}");
+            compactFormat = static_cast<Format::COMPACT_FORMAT>(val);
+        }
+
+        uint64_t batchRows = 0;
+        if (formatJson.HasMember("batch-rows")) {
+            batchRows = Ctx::getJsonFieldU64(fileName, formatJson, "batch-rows");
+            if (batchRows > 1000000)
+                throw ConfigurationException(
+                    30001,
+                    "bad JSON, invalid \"batch-rows\" value: " + std::to_string(batchRows) +
+                    ", expected: one of {0 .. 1000000}");
+            if (batchRows > 1 && (static_cast<uint>(messageFormat) & static_cast<uint>(Format::MESSAGE_FORMAT::FULL)) != 0)
+                throw ConfigurationException(30001, "bad JSON, invalid \"batch-rows\" value: " + std::to_string(batchRows) +
+                                                    ", expected: 0 together with FULL mode (" +
+                                                    std::to_string(static_cast<uint>(Format::MESSAGE_FORMAT::FULL)) + ")");
+        }
+
+        uint64_t batchBytes = 1048576;
+        if (formatJson.HasMember("batch-bytes")) {
+            batchBytes = Ctx::getJsonFieldU64(fileName, formatJson, "batch-bytes");
+            if (batchBytes < 1024 || batchBytes > 1073741824)
+                throw ConfigurationException(
+                    30001,
+                    "bad JSON, invalid \"batch-bytes\" value: " + std::to_string(batchBytes) +
+                    ", expected: one of {1024 .. 1073741824}");
+        }
+
+        return {dbFormat, attributesFormat, intervalDtsFormat, intervalYtmFormat, messageFormat, ridFormat, xidFormat, timestampFormat, timestampTzFormat,
+                timestampAll, charFormat, scnFormat, scnType, unknownFormat, schemaFormat, columnFormat, unknownType, rawFormat,
+                compactFormat, batchRows, batchBytes};
+    }
+}
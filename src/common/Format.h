@@ -20,9 +20,13 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #ifndef FORMAT_H_
 #define FORMAT_H_
 
+#include <rapidjson/document.h>
+#include <string>
+
 #include "../common/types/Types.h"
 
 namespace OpenLogReplicator {
+    class Ctx;
 
     class Format final {
     public:
@@ -30,6 +34,11 @@ namespace OpenLogReplicator {
             DEFAULT = 0, BEGIN = 1UL << 0, DML = 1UL << 1, COMMIT = 1UL << 2
         };
 
+        enum class COMPACT_FORMAT : unsigned char {
+            NONE = 0,           // Default, every change is sent
+            ROW = 1             // Changes of the same row in a transaction are sent as one net change
+        };
+
         enum class DB_FORMAT : unsigned char {
             DEFAULT = 0, ADD_DML = 1, ADD_DDL = 2
         };
@@ -59,6 +68,10 @@ namespace OpenLogReplicator {
             SKIP_BEGIN = 1 << 2, SKIP_COMMIT = 1 << 3, ADD_OFFSET = 1 << 4
         };
 
+        enum class RAW_FORMAT : unsigned char {
+            HEX, BASE64
+        };
+
         enum class RID_FORMAT : unsigned char {
             SKIP, TEXT
         };
@@ -72,7 +85,7 @@ namespace OpenLogReplicator {
         };
 
         enum class SCHEMA_FORMAT : unsigned char {
-            DEFAULT = 0, FULL = 1 << 0, REPEATED = 1 << 1, OBJ = 1 << 2
+            DEFAULT = 0, FULL = 1 << 0, REPEATED = 1 << 1, OBJ = 1 << 2, VERSIONED = 1 << 3
         };
 
         enum class TIMESTAMP_ALL : unsigned char {
@@ -126,12 +139,18 @@ namespace OpenLogReplicator {
         SCHEMA_FORMAT schemaFormat;
         COLUMN_FORMAT columnFormat;
         UNKNOWN_TYPE unknownType;
+        RAW_FORMAT rawFormat;
+        COMPACT_FORMAT compactFormat;
+        // Row messages packed into one output message, 0 when every row is sent alone
+        uint64_t batchRows;
+        uint64_t batchBytes;
 
-        Format(DB_FORMAT newDbFormat, ATTRIBUTES_FORMAT newAttributesFormat, INTERVAL_DTS_FORMAT newIntervalDtsFormat,
+        constexpr Format(DB_FORMAT newDbFormat, ATTRIBUTES_FORMAT newAttributesFormat, INTERVAL_DTS_FORMAT newIntervalDtsFormat,
                INTERVAL_YTM_FORMAT newIntervalYtmFormat, MESSAGE_FORMAT newMessageFormat, RID_FORMAT newRidFormat, XID_FORMAT newXidFormat,
                TIMESTAMP_FORMAT newTimestampFormat, TIMESTAMP_TZ_FORMAT newTimestampTzFormat, TIMESTAMP_ALL newTimestampAll, CHAR_FORMAT newCharFormat,
                SCN_FORMAT newScnFormat, SCN_TYPE newScnType, UNKNOWN_FORMAT newUnknownFormat, SCHEMA_FORMAT newSchemaFormat, COLUMN_FORMAT newColumnFormat,
-               UNKNOWN_TYPE newUnknownType) :
+               UNKNOWN_TYPE newUnknownType, RAW_FORMAT newRawFormat, COMPACT_FORMAT newCompactFormat, uint64_t newBatchRows,
+               uint64_t newBatchBytes) :
                 dbFormat(newDbFormat),
                 attributesFormat(newAttributesFormat),
                 intervalDtsFormat(newIntervalDtsFormat),
@@ -148,74 +167,89 @@ namespace OpenLogReplicator {
                 unknownFormat(newUnknownFormat),
                 schemaFormat(newSchemaFormat),
                 columnFormat(newColumnFormat),
-                unknownType(newUnknownType) {
+                unknownType(newUnknownType),
+                rawFormat(newRawFormat),
+                compactFormat(newCompactFormat),
+                batchRows(newBatchRows),
+                batchBytes(newBatchBytes) {
         }
 
-        [[nodiscard]] bool isAttributesFormatBegin() const {
+        // Reads the "format" object of a source, used at startup and when the configuration file is reloaded
+        [[nodiscard]] static Format parseJson(const Ctx* ctx, const std::string& fileName, const rapidjson::Value& formatJson);
+
+        [[nodiscard]] constexpr bool isAttributesFormatBegin() const {
             return (static_cast<uint>(attributesFormat) & static_cast<uint>(ATTRIBUTES_FORMAT::BEGIN)) != 0;
         };
 
-        [[nodiscard]] bool isAttributesFormatDml() const {
+        [[nodiscard]] constexpr bool isAttributesFormatDml() const {
             return (static_cast<uint>(attributesFormat) & static_cast<uint>(ATTRIBUTES_FORMAT::DML)) != 0;
         };
 
-        [[nodiscard]] bool isAttributesFormatCommit() const {
+        [[nodiscard]] constexpr bool isAttributesFormatCommit() const {
             return (static_cast<uint>(attributesFormat) & static_cast<uint>(ATTRIBUTES_FORMAT::COMMIT)) != 0;
         };
 
-        [[nodiscard]] bool isCharFormatNoMapping() const {
+        [[nodiscard]] constexpr bool isCharFormatNoMapping() const {
             return (static_cast<uint>(charFormat) & static_cast<uint>(CHAR_FORMAT::NOMAPPING)) != 0;
         };
 
-        [[nodiscard]] bool isCharFormatHex() const {
+        [[nodiscard]] constexpr bool isCharFormatHex() const {
             return (static_cast<uint>(charFormat) & static_cast<uint>(CHAR_FORMAT::HEX)) != 0;
         };
 
-        [[nodiscard]] bool isScnTypeAllPayloads() const {
+        [[nodiscard]] constexpr bool isScnTypeAllPayloads() const {
             return (static_cast<uint>(scnType) & static_cast<uint>(SCN_TYPE::ALL_PAYLOADS)) != 0;
         };
 
-        [[nodiscard]] bool isScnTypeCommitValue() const {
+        [[nodiscard]] constexpr bool isScnTypeCommitValue() const {
             return (static_cast<uint>(scnType) & static_cast<uint>(SCN_TYPE::COMMIT_VALUE)) != 0;
         };
 
-        [[nodiscard]] bool isSchemaFormatFull() const {
+        [[nodiscard]] constexpr bool isSchemaFormatFull() const {
             return (static_cast<uint>(schemaFormat) & static_cast<uint>(SCHEMA_FORMAT::FULL)) != 0;
         };
 
-        [[nodiscard]] bool isSchemaFormatRepeated() const {
+        [[nodiscard]] constexpr bool isSchemaFormatRepeated() const {
             return (static_cast<uint>(schemaFormat) & static_cast<uint>(SCHEMA_FORMAT::REPEATED)) != 0;
         };
 
-        [[nodiscard]] bool isSchemaFormatObj() const {
+        [[nodiscard]] constexpr bool isSchemaFormatObj() const {
             return (static_cast<uint>(schemaFormat) & static_cast<uint>(SCHEMA_FORMAT::OBJ)) != 0;
         };
 
-        [[nodiscard]] bool isMessageFormatFull() const {
+        [[nodiscard]] constexpr bool isSchemaFormatVersioned() const {
+            return (static_cast<uint>(schemaFormat) & static_cast<uint>(SCHEMA_FORMAT::VERSIONED)) != 0;
+        };
+
+        [[nodiscard]] constexpr bool isMessageFormatFull() const {
             return (static_cast<uint>(messageFormat) & static_cast<uint>(MESSAGE_FORMAT::FULL)) != 0;
         }
 
-        [[nodiscard]] bool isMessageFormatAddSequences() const {
+        [[nodiscard]] constexpr bool isMessageFormatBatch() const {
+            return batchRows > 1;
+        }
+
+        [[nodiscard]] constexpr bool isMessageFormatAddSequences() const {
             return (static_cast<uint>(messageFormat) & static_cast<uint>(MESSAGE_FORMAT::ADD_SEQUENCES)) != 0;
         }
 
-        [[nodiscard]] bool isMessageFormatSkipBegin() const {
+        [[nodiscard]] constexpr bool isMessageFormatSkipBegin() const {
             return (static_cast<uint>(messageFormat) & static_cast<uint>(MESSAGE_FORMAT::SKIP_BEGIN)) != 0;
         }
 
-        [[nodiscard]] bool isMessageFormatSkipCommit() const {
+        [[nodiscard]] constexpr bool isMessageFormatSkipCommit() const {
             return (static_cast<uint>(messageFormat) & static_cast<uint>(MESSAGE_FORMAT::SKIP_COMMIT)) != 0;
         }
 
-        [[nodiscard]] bool isMessageFormatAddOffset() const {
+        [[nodiscard]] constexpr bool isMessageFormatAddOffset() const {
             return (static_cast<uint>(messageFormat) & static_cast<uint>(MESSAGE_FORMAT::ADD_OFFSET)) != 0;
         }
 
-        [[nodiscard]] bool isDbFormatAddDml() const {
+        [[nodiscard]] constexpr bool isDbFormatAddDml() const {
             return (static_cast<uint>(dbFormat) & static_cast<uint>(DB_FORMAT::ADD_DML)) != 0;
         }
 
-        [[nodiscard]] bool isDbFormatAddDdl() const {
+        [[nodiscard]] constexpr bool isDbFormatAddDdl() const {
             return (static_cast<uint>(dbFormat) & static_cast<uint>(DB_FORMAT::ADD_DDL)) != 0;
         }
     };
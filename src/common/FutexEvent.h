@@ -0,0 +1,101 @@
+/* Futex based event for lock-free handoff between threads
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#if __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#endif
+
+#include "types/Types.h"
+
+#ifndef FUTEX_EVENT_H_
+#define FUTEX_EVENT_H_
+
+namespace OpenLogReplicator {
+    // Event count: the waiter takes a key, checks its condition again and parks only if nothing was signalled since the
+    // key was taken. The data itself is passed through atomics of the caller, notify() enters the kernel only when some
+    // thread is parked, so the fast path of the producer is two atomic operations instead of a mutex and a
+    // condition variable
+    class FutexEvent final {
+    public:
+        // Spin before parking, long enough to cover the gap between two reads of the same redo log
+        static constexpr uint SPIN_COUNT = 2000;
+
+    protected:
+        std::atomic<uint32_t> epoch{0};
+        std::atomic<uint32_t> waiters{0};
+#if !__linux__
+        std::mutex mtx;
+        std::condition_variable cond;
+#endif
+
+        void sleep(uint32_t key) {
+#if __linux__
+            static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be 32 bits");
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch), FUTEX_WAIT_PRIVATE, key, nullptr, nullptr, 0);
+#else
+            std::unique_lock<std::mutex> lck(mtx);
+            if (epoch.load() == key)
+                cond.wait(lck);
+#endif
+        }
+
+    public:
+        template<typename Ready>
+        [[nodiscard]] static bool spin(Ready ready) {
+            for (uint i = 0; i < SPIN_COUNT; ++i) {
+                if (ready())
+                    return true;
+                CPU_RELAX();
+            }
+            return ready();
+        }
+
+        // Returns after a notify() or a spurious wakeup, the caller re-checks its condition
+        template<typename Ready>
+        void park(Ready ready) {
+            waiters.fetch_add(1);
+            const uint32_t key = epoch.load();
+            if (!ready())
+                sleep(key);
+            waiters.fetch_sub(1);
+        }
+
+        void notify() {
+            epoch.fetch_add(1);
+            if (waiters.load() == 0)
+                return;
+#if __linux__
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#else
+            std::unique_lock<std::mutex> const lck(mtx);
+            cond.notify_all();
+#endif
+        }
+    };
+}
+
+#endif
@@ -21,22 +21,18 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 
 #include "LobCtx.h"
 #include "LobData.h"
+#include "OrphanedLobs.h"
 #include "RedoLogRecord.h"
 #include "exception/RedoLogException.h"
 
 namespace OpenLogReplicator {
     void LobCtx::checkOrphanedLobs(const Ctx* ctx, const LobId& lobId, Xid xid, FileOffset fileOffset) {
-        const LobKey lobKey(lobId, 0);
-        for (auto orphanedLobsIt = orphanedLobs->upper_bound(lobKey);
-             orphanedLobsIt != orphanedLobs->end() && orphanedLobsIt->first.lobId == lobId;) {
-
-            addLob(ctx, lobId, orphanedLobsIt->first.page, 0, orphanedLobsIt->second, xid, fileOffset);
+        orphanedLobs->take(lobId, [&](typeDba page, uint8_t* data) {
+            addLob(ctx, lobId, page, 0, data, xid, fileOffset);
 
             if (unlikely(ctx->isTraceSet(Ctx::TRACE::LOB)))
-                ctx->logTrace(Ctx::TRACE::LOB, "id: " + lobId.lower() + " page: " + std::to_string(orphanedLobsIt->first.page));
-
-            orphanedLobsIt = orphanedLobs->erase(orphanedLobsIt);
-        }
+                ctx->logTrace(Ctx::TRACE::LOB, "id: " + lobId.lower() + " page: " + std::to_string(page));
+        });
     }
 
     void LobCtx::addLob(const Ctx* ctx, const LobId& lobId, typeDba page, uint16_t pageOffset, uint8_t* data, Xid xid, FileOffset fileOffset) {
@@ -20,7 +20,6 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #ifndef LOB_CTX_H_
 #define LOB_CTX_H_
 
-#include <map>
 #include <unordered_map>
 
 #include "LobData.h"
@@ -31,13 +30,14 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 
 namespace OpenLogReplicator {
     class Ctx;
+    class OrphanedLobs;
     class Schema;
 
     class LobCtx final {
     public:
         std::unordered_map<LobId, LobData*> lobs;
-        std::map<LobKey, uint8_t*>* orphanedLobs;
-        std::map<typeDba, uint8_t*> listMap;
+        OrphanedLobs* orphanedLobs;
+        LobIndex<typeDba, uint8_t*> listMap;
 
         void checkOrphanedLobs(const Ctx* ctx, const LobId& lobId, Xid xid, FileOffset fileOffset);
         void addLob(const Ctx* ctx, const LobId& lobId, typeDba page, uint16_t pageOffset, uint8_t* data, Xid xid, FileOffset fileOffset);
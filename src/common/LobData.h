@@ -20,8 +20,7 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #ifndef LOB_DATA_H_
 #define LOB_DATA_H_
 
-#include <map>
-
+#include "LobIndex.h"
 #include "types/Types.h"
 
 namespace OpenLogReplicator {
@@ -40,8 +39,8 @@ namespace OpenLogReplicator {
         LobData();
         ~LobData();
 
-        std::map<LobDataElement, uint8_t*> dataMap;
-        std::map<uint32_t, typeDba> indexMap;
+        LobIndex<LobDataElement, uint8_t*> dataMap;
+        LobIndex<uint32_t, typeDba> indexMap;
 
         uint32_t pageSize;
         uint32_t sizePages;
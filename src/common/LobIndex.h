@@ -0,0 +1,116 @@
+/* Header for LobIndex class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef LOB_INDEX_H_
+#define LOB_INDEX_H_
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace OpenLogReplicator {
+    // Sorted vector of pages used instead of std::map: one allocation per growth step instead of one node per page,
+    // and lookups walk contiguous memory. LOB pages mostly arrive in ascending order, so insertion is usually an append
+    template<typename Key, typename Value>
+    class LobIndex final {
+    public:
+        using value_type = std::pair<Key, Value>;
+        using iterator = typename std::vector<value_type>::iterator;
+        using const_iterator = typename std::vector<value_type>::const_iterator;
+
+    protected:
+        // First allocation, later growth is geometric
+        static constexpr size_t CHUNK_ELEMENTS = 64;
+
+        std::vector<value_type> elements;
+
+        static bool less(const value_type& element, const Key& key) {
+            return element.first < key;
+        }
+
+    public:
+        iterator begin() {
+            return elements.begin();
+        }
+
+        iterator end() {
+            return elements.end();
+        }
+
+        const_iterator begin() const {
+            return elements.begin();
+        }
+
+        const_iterator end() const {
+            return elements.end();
+        }
+
+        [[nodiscard]] size_t size() const {
+            return elements.size();
+        }
+
+        [[nodiscard]] bool empty() const {
+            return elements.empty();
+        }
+
+        void clear() {
+            elements.clear();
+        }
+
+        iterator lower_bound(const Key& key) {
+            return std::lower_bound(elements.begin(), elements.end(), key, less);
+        }
+
+        iterator find(const Key& key) {
+            auto it = lower_bound(key);
+            if (it != elements.end() && !(key < it->first))
+                return it;
+            return elements.end();
+        }
+
+        const_iterator find(const Key& key) const {
+            auto it = std::lower_bound(elements.begin(), elements.end(), key, less);
+            if (it != elements.end() && !(key < it->first))
+                return it;
+            return elements.end();
+        }
+
+        void insert_or_assign(const Key& key, Value value) {
+            if (elements.capacity() == 0)
+                elements.reserve(CHUNK_ELEMENTS);
+
+            if (elements.empty() || elements.back().first < key) {
+                elements.emplace_back(key, value);
+                return;
+            }
+
+            auto it = lower_bound(key);
+            if (it != elements.end() && !(key < it->first))
+                it->second = value;
+            else
+                elements.emplace(it, key, value);
+        }
+
+        iterator erase(iterator it) {
+            return elements.erase(it);
+        }
+    };
+}
+
+#endif
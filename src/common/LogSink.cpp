@@ -0,0 +1,297 @@
+/* Asynchronous output of log messages
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+#include "LogSink.h"
+#include "types/Data.h"
+
+namespace OpenLogReplicator {
+    thread_local char LogSink::threadName[THREAD_NAME_LENGTH]{};
+    thread_local Scn LogSink::threadScn{Scn::none()};
+    thread_local Xid LogSink::threadXid;
+
+    LogSink::~LogSink() {
+        stop();
+    }
+
+    void LogSink::setThread(const std::string& name) {
+        const uint64_t length = std::min<uint64_t>(name.length(), THREAD_NAME_LENGTH - 1);
+        memcpy(threadName, name.c_str(), length);
+        threadName[length] = 0;
+    }
+
+    void LogSink::configure(FORMAT newFormat, bool newAsync, uint64_t newRateLimit) {
+        format = newFormat;
+        rateLimit = newRateLimit;
+
+        if (newAsync && !async) {
+            ring = new Record[RING_SIZE];
+            for (uint64_t i = 0; i < RING_SIZE; ++i)
+                ring[i].sequence.store(i, std::memory_order_relaxed);
+            ringTail.store(0, std::memory_order_relaxed);
+            ringHead = 0;
+            stopping = false;
+            async = true;
+            flusher = std::thread(&LogSink::flushLoop, this);
+        }
+    }
+
+    void LogSink::stop() {
+        if (!async)
+            return;
+
+        {
+            std::unique_lock<std::mutex> const lck(mtx);
+            stopping = true;
+            condFlush.notify_all();
+        }
+        if (flusher.joinable())
+            flusher.join();
+
+        // Messages logged after this point are written directly
+        async = false;
+        drain();
+        delete[] ring;
+        ring = nullptr;
+    }
+
+    void LogSink::write(const char* level, const char* tag, int code, time_t timestamp, bool withTime, KIND kind, const std::string& message) {
+        if (kind == KIND::LIMITED && rateLimit > 0 && code > 0 && !allow(code, timestamp, withTime))
+            return;
+
+        if (async) {
+            const bool queued = enqueue(level, tag, code, timestamp, withTime, message);
+            if (kind == KIND::URGENT)
+                drain();
+            if (queued)
+                return;
+            if (kind != KIND::URGENT) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+
+        std::string line;
+        formatLine(line, level, tag, code, timestamp, withTime, threadName, threadScn, threadXid, message);
+        std::cerr << line;
+    }
+
+    bool LogSink::allow(int code, time_t timestamp, bool withTime) {
+        CodeLimit& limit = limits[static_cast<uint64_t>(code) % LIMIT_SLOTS];
+        if (limit.code.load(std::memory_order_relaxed) != code) {
+            limit.code.store(code, std::memory_order_relaxed);
+            limit.window.store(timestamp, std::memory_order_relaxed);
+            limit.count.store(0, std::memory_order_relaxed);
+            limit.suppressed.store(0, std::memory_order_relaxed);
+        }
+
+        if (limit.window.load(std::memory_order_relaxed) != timestamp) {
+            limit.window.store(timestamp, std::memory_order_relaxed);
+            limit.count.store(0, std::memory_order_relaxed);
+            const uint64_t suppressed = limit.suppressed.exchange(0, std::memory_order_relaxed);
+            if (suppressed > 0)
+                write("INFO ", nullptr, 0, timestamp, withTime, KIND::NORMAL,
+                      "suppressed " + std::to_string(suppressed) + " messages with code " + std::to_string(code));
+        }
+
+        if (limit.count.fetch_add(1, std::memory_order_relaxed) < rateLimit)
+            return true;
+        limit.suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Bounded queue with a sequence number per slot, producers reserve a slot with one compare-and-swap
+    bool LogSink::enqueue(const char* level, const char* tag, int code, time_t timestamp, bool withTime, const std::string& message) {
+        uint64_t pos = ringTail.load(std::memory_order_relaxed);
+        Record* record;
+        while (true) {
+            record = &ring[pos % RING_SIZE];
+            const uint64_t sequence = record->sequence.load(std::memory_order_acquire);
+            const int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos);
+            if (diff == 0) {
+                if (ringTail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = ringTail.load(std::memory_order_relaxed);
+            }
+        }
+
+        record->level = level;
+        record->tag = tag;
+        record->code = code;
+        record->timestamp = timestamp;
+        record->withTime = withTime;
+        memcpy(record->thread, threadName, THREAD_NAME_LENGTH);
+        record->scn = threadScn;
+        record->xid = threadXid;
+        record->message = message;
+        record->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Single consumer at a time, the flusher or a thread logging an error
+    void LogSink::drain() {
+        if (ring == nullptr)
+            return;
+
+        std::string out;
+        {
+            std::unique_lock<std::mutex> const lck(mtx);
+            while (true) {
+                Record& record = ring[ringHead % RING_SIZE];
+                if (record.sequence.load(std::memory_order_acquire) != ringHead + 1)
+                    break;
+                formatLine(out, record.level, record.tag, record.code, record.timestamp, record.withTime, record.thread, record.scn, record.xid,
+                           record.message);
+                record.message.clear();
+                record.sequence.store(ringHead + RING_SIZE, std::memory_order_release);
+                ++ringHead;
+            }
+
+            const uint64_t droppedCount = dropped.exchange(0, std::memory_order_relaxed);
+            if (droppedCount > 0)
+                formatLine(out, "WARN ", nullptr, 0, 0, false, "", Scn::none(), Xid(), "log ring full, dropped " +
+                                                                                         std::to_string(droppedCount) + " messages");
+        }
+        if (!out.empty())
+            std::cerr << out;
+    }
+
+    void LogSink::flushLoop() {
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lck(mtx);
+                if (stopping)
+                    break;
+                condFlush.wait_for(lck, std::chrono::milliseconds(FLUSH_INTERVAL_MS));
+            }
+            drain();
+        }
+    }
+
+    void LogSink::formatLine(std::string& out, const char* level, const char* tag, int code, time_t timestamp, bool withTime, const char* thread,
+                             Scn scn, Xid xid, const std::string& message) const {
+        char buffer[32];
+
+        if (format == FORMAT::TEXT) {
+            if (withTime) {
+                Data::epochToIso8601(timestamp, buffer, false, false);
+                out.append(buffer);
+                out.push_back(' ');
+            }
+            out.append(level);
+            out.push_back(' ');
+            if (tag != nullptr) {
+                out.append(tag);
+                out.push_back(' ');
+            } else if (code >= 0) {
+                snprintf(buffer, sizeof(buffer), "%05d ", code);
+                out.append(buffer);
+            }
+            out.append(message);
+            out.push_back('\n');
+            return;
+        }
+
+        out.push_back('{');
+        if (withTime) {
+            Data::epochToIso8601(timestamp, buffer, false, false);
+            out.append(R"("time":")");
+            out.append(buffer);
+            out.append(R"(",)");
+        }
+        const char* levelStart = level;
+        while (*levelStart == ' ')
+            ++levelStart;
+        uint64_t levelLength = strlen(levelStart);
+        while (levelLength > 0 && levelStart[levelLength - 1] == ' ')
+            --levelLength;
+        out.append(R"("level":)");
+        appendJsonString(out, levelStart, levelLength);
+        if (tag != nullptr) {
+            uint64_t tagLength = strlen(tag);
+            while (tagLength > 0 && tag[tagLength - 1] == ' ')
+                --tagLength;
+            out.append(R"(,"trace":)");
+            appendJsonString(out, tag, tagLength);
+        } else if (code >= 0) {
+            out.append(R"(,"code":)");
+            out.append(std::to_string(code));
+        }
+        if (thread[0] != 0) {
+            out.append(R"(,"thread":)");
+            appendJsonString(out, thread, strlen(thread));
+        }
+        if (scn != Scn::none()) {
+            out.append(R"(,"scn":)");
+            out.append(scn.toString());
+        }
+        if (xid.getData() != 0) {
+            out.append(R"(,"xid":")");
+            out.append(xid.toString());
+            out.push_back('"');
+        }
+        out.append(R"(,"message":)");
+        appendJsonString(out, message.c_str(), message.length());
+        out.append("}\n");
+    }
+
+    void LogSink::appendJsonString(std::string& out, const char* text, uint64_t length) {
+        static constexpr char HEX[]{"0123456789abcdef"};
+        out.push_back('"');
+        for (uint64_t i = 0; i < length; ++i) {
+            const auto character = static_cast<unsigned char>(text[i]);
+            switch (character) {
+                case '"':
+                    out.append("\\\"");
+                    break;
+
+                case '\\':
+                    out.append("\\\\");
+                    break;
+
+                case '\n':
+                    out.append("\\n");
+                    break;
+
+                case '\r':
+                    out.append("\\r");
+                    break;
+
+                case '\t':
+                    out.append("\\t");
+                    break;
+
+                default:
+                    if (character < 0x20) {
+                        out.append("\\u00");
+                        out.push_back(HEX[character >> 4]);
+                        out.push_back(HEX[character & 0x0F]);
+                    } else
+                        out.push_back(static_cast<char>(character));
+            }
+        }
+        out.push_back('"');
+    }
+}
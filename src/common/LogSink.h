@@ -0,0 +1,126 @@
+/* Header for LogSink class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "types/Scn.h"
+#include "types/Xid.h"
+
+#ifndef LOG_SINK_H_
+#define LOG_SINK_H_
+
+namespace OpenLogReplicator {
+    // Output of log messages. Synchronous by default. In async mode hot threads only put the message into a bounded ring
+    // and a background thread formats and writes it. A full ring drops messages and counts them instead of blocking.
+    // Error messages drain the ring before returning, so that nothing is lost when the process stops on an error
+    class LogSink final {
+    public:
+        enum class FORMAT : unsigned char {
+            TEXT, JSON
+        };
+
+        // Messages with a code may be rate limited, urgent ones are written before the call returns
+        enum class KIND : unsigned char {
+            NORMAL, LIMITED, URGENT
+        };
+
+        static constexpr uint64_t RING_SIZE{8192};
+        static constexpr uint64_t FLUSH_INTERVAL_MS{20};
+        static constexpr uint64_t THREAD_NAME_LENGTH{32};
+
+    protected:
+        static constexpr uint64_t LIMIT_SLOTS{1024};
+
+        struct Record {
+            std::atomic<uint64_t> sequence{0};
+            const char* level{nullptr};
+            const char* tag{nullptr};
+            int code{0};
+            time_t timestamp{0};
+            bool withTime{false};
+            char thread[THREAD_NAME_LENGTH]{};
+            Scn scn;
+            Xid xid;
+            std::string message;
+        };
+
+        // Messages of one code within the current second, approximate: a slot is shared by codes with the same hash
+        struct CodeLimit {
+            std::atomic<int> code{0};
+            std::atomic<time_t> window{0};
+            std::atomic<uint64_t> count{0};
+            std::atomic<uint64_t> suppressed{0};
+        };
+
+        static thread_local char threadName[THREAD_NAME_LENGTH];
+        static thread_local Scn threadScn;
+        static thread_local Xid threadXid;
+
+        FORMAT format{FORMAT::TEXT};
+        uint64_t rateLimit{0};
+        bool async{false};
+
+        Record* ring{nullptr};
+        std::atomic<uint64_t> ringTail{0};
+        uint64_t ringHead{0};
+        std::atomic<uint64_t> dropped{0};
+        CodeLimit limits[LIMIT_SLOTS];
+
+        std::mutex mtx;
+        std::condition_variable condFlush;
+        bool stopping{false};
+        std::thread flusher;
+
+        void formatLine(std::string& out, const char* level, const char* tag, int code, time_t timestamp, bool withTime, const char* thread, Scn scn,
+                        Xid xid, const std::string& message) const;
+        [[nodiscard]] bool allow(int code, time_t timestamp, bool withTime);
+        [[nodiscard]] bool enqueue(const char* level, const char* tag, int code, time_t timestamp, bool withTime, const std::string& message);
+        void drain();
+        void flushLoop();
+        static void appendJsonString(std::string& out, const char* text, uint64_t length);
+
+    public:
+        LogSink() = default;
+        ~LogSink();
+        LogSink(const LogSink&) = delete;
+        LogSink& operator=(const LogSink&) = delete;
+
+        // Fields of the current thread, added to the JSON format
+        static void setThread(const std::string& name);
+        static void setScn(Scn scn) {
+            threadScn = scn;
+        }
+        static void setXid(Xid xid) {
+            threadXid = xid;
+        }
+
+        // Called once at startup, before the threads are spawned
+        void configure(FORMAT newFormat, bool newAsync, uint64_t newRateLimit);
+        void stop();
+        // The level is padded to 5 characters for the text format, the tag replaces the code in trace messages, a code
+        // below 0 is not printed
+        void write(const char* level, const char* tag, int code, time_t timestamp, bool withTime, KIND kind, const std::string& message);
+    };
+}
+
+#endif
@@ -17,13 +17,22 @@ You should have received a copy of the GNU General Public License
 along with OpenLogReplicator; see the file LICENSE;  If not see
 <http://www.gnu.org/licenses/>.  */
 
+#include <algorithm>
 #include <dirent.h>
 #include <fcntl.h>
+#include <iterator>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <unistd.h>
+#ifdef LINK_LIBRARY_LZ4
+#include <lz4.h>
+#endif /* LINK_LIBRARY_LZ4 */
 
 #include "Ctx.h"
+#include "FlightRecorder.h"
 #include "MemoryManager.h"
+#include "Probes.h"
 #include "exception/RuntimeException.h"
 #include "metrics/Metrics.h"
 
@@ -31,10 +40,32 @@ namespace OpenLogReplicator {
     MemoryManager::MemoryManager(Ctx* newCtx, std::string newAlias, std::string newSwapPath) :
             Thread(newCtx, std::move(newAlias)),
             swapPath(std::move(newSwapPath)) {
+        if (ctx->swapCompress) {
+            swapBuffer = reinterpret_cast<uint8_t*>(aligned_alloc(Ctx::MEMORY_ALIGNMENT, SWAP_BATCH_CHUNKS * Ctx::MEMORY_CHUNK_SIZE));
+            if (unlikely(swapBuffer == nullptr))
+                throw RuntimeException(10016, "couldn't allocate " + std::to_string(SWAP_BATCH_CHUNKS * Ctx::MEMORY_CHUNK_SIZE) +
+                                              " bytes memory for: swap compression");
+        }
     }
 
     MemoryManager::~MemoryManager() {
+        for (const auto& [xid, fileDes]: swapFiles)
+            close(fileDes);
+        swapFiles.clear();
+        swapSegments.clear();
         cleanup(true);
+
+        if (arenaFileDes != -1) {
+            close(arenaFileDes);
+            arenaFileDes = -1;
+            const std::string fileName = swapPath + "/" + ARENA_FILE_NAME;
+            unlink(fileName.c_str());
+        }
+
+        if (swapBuffer != nullptr) {
+            free(swapBuffer);
+            swapBuffer = nullptr;
+        }
     }
 
     void MemoryManager::wakeUp() {
@@ -54,6 +85,17 @@ namespace OpenLogReplicator {
                 const uint64_t discard = cleanOldTransactions();
                 if (discard > 0 && ctx->metrics != nullptr)
                     ctx->metrics->emitSwapOperationsMbDiscard(discard);
+                ctx->memoryTrim(this);
+
+                // File backed transaction memory is never swapped, the kernel pages it and is told which chunks go first
+                if (ctx->isTransactionMapped() && ctx->transactionMapResidentMb > 0) {
+                    const uint64_t chunks = pageOut();
+                    if (chunks > 0) {
+                        if (ctx->metrics != nullptr)
+                            ctx->metrics->emitSwapOperationsMbWrite(chunks * Ctx::MEMORY_CHUNK_SIZE_MB);
+                        continue;
+                    }
+                }
 
                 if (ctx->softShutdown && ctx->replicatorFinished) {
                     if (!ctx->swapChunks.empty())
@@ -65,11 +107,12 @@ namespace OpenLogReplicator {
                 int64_t swapIndex = -1;
                 Xid unswapXid;
                 int64_t unswapIndex = -1;
+                uint64_t unswapCount = 0;
 
                 {
                     contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::MEMORY_RUN1);
                     std::unique_lock<std::mutex> lck(ctx->swapMtx);
-                    getChunkToUnswap(unswapXid, unswapIndex);
+                    getChunkToUnswap(unswapXid, unswapIndex, unswapCount);
                     getChunkToSwap(swapXid, swapIndex);
 
                     if (swapIndex == -1)
@@ -85,8 +128,10 @@ namespace OpenLogReplicator {
                 contextSet(Thread::CONTEXT::CPU);
 
                 if (unswapIndex != -1) {
-                    if (unswap(unswapXid, unswapIndex) && ctx->metrics != nullptr)
-                        ctx->metrics->emitSwapOperationsMbRead(1);
+                    const uint64_t chunks = unswap(unswapXid, unswapIndex, unswapCount);
+                    if (chunks > 0 && ctx->metrics != nullptr)
+                        ctx->metrics->emitSwapOperationsMbRead(chunks * Ctx::MEMORY_CHUNK_SIZE_MB);
+                    paceSwap(chunks);
                     {
                         contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::MEMORY_RUN2);
                         std::unique_lock<std::mutex> const lck(ctx->swapMtx);
@@ -94,8 +139,12 @@ namespace OpenLogReplicator {
                     }
                     contextSet(Thread::CONTEXT::CPU);
                 }
-                if (swapIndex != -1 && swap(swapXid, swapIndex) && ctx->metrics != nullptr)
-                    ctx->metrics->emitSwapOperationsMbWrite(1);
+                if (swapIndex != -1) {
+                    const uint64_t chunks = swap(swapXid, swapIndex);
+                    if (chunks > 0 && ctx->metrics != nullptr)
+                        ctx->metrics->emitSwapOperationsMbWrite(chunks * Ctx::MEMORY_CHUNK_SIZE_MB);
+                    paceSwap(chunks);
+                }
             }
         } catch (RuntimeException& ex) {
             ctx->error(ex.code, ex.msg);
@@ -111,6 +160,8 @@ namespace OpenLogReplicator {
 
     void MemoryManager::initialize() {
         cleanup();
+        if (ctx->swapArenaSize > 0 && ctx->getSwapMemory(this) > 0)
+            openArena();
     }
 
     uint64_t MemoryManager::cleanOldTransactions() {
@@ -139,6 +190,9 @@ namespace OpenLogReplicator {
             }
             contextSet(Thread::CONTEXT::CPU);
             delete sc;
+            closeSwapFile(xid);
+            if (arenaFileDes != -1)
+                continue;
 
             struct stat fileStat{};
             const std::string fileName(swapPath + "/" + xid.toString() + ".swap");
@@ -195,14 +249,16 @@ namespace OpenLogReplicator {
         closedir(dir);
     }
 
-    void MemoryManager::getChunkToUnswap(Xid& xid, int64_t& index) {
+    void MemoryManager::getChunkToUnswap(Xid& xid, int64_t& index, uint64_t& count) {
         if (ctx->swappedFlushXid.toUint() != 0) {
             const auto& it = ctx->swapChunks.find(ctx->swappedFlushXid);
             if (unlikely(it == ctx->swapChunks.end()))
                 throw RuntimeException(50070, "swap chunk not found for xid: " + ctx->swappedFlushXid.toString() + " during unswap");
             const SwapChunk* sc = it->second;
             if (sc->swappedMin > -1) {
+                // Flush consumes the chunks in order, read ahead of it
                 index = sc->swappedMin;
+                count = std::min(SWAP_BATCH_CHUNKS, static_cast<uint64_t>(sc->swappedMax - sc->swappedMin + 1));
                 xid = ctx->swappedFlushXid;
                 return;
             }
@@ -219,67 +275,427 @@ namespace OpenLogReplicator {
             return;
 
         index = sc->swappedMax;
+        count = 1;
         xid = ctx->swappedShrinkXid;
     }
 
     void MemoryManager::getChunkToSwap(Xid& xid, int64_t& index) {
-        if (ctx->nothingToSwap(this))
-            return;
+        // A transaction over its own budget is swapped even when the total usage is low
+        const bool memoryShort = !ctx->nothingToSwap(this);
+        const SwapChunk* best = nullptr;
+        bool bestOverBudget = false;
+        uint64_t bestScore = 0;
 
         for (const auto& [swapXid, sc]: ctx->swapChunks) {
-            if (ctx->swappedFlushXid == swapXid || sc->release || sc->chunks.size() <= 1)
+            if (ctx->swappedFlushXid == swapXid || sc->release || sc->pinned || sc->chunks.size() <= 1)
                 continue;
 
-            if (sc->swappedMax < static_cast<int64_t>(sc->chunks.size() - 2)) {
+            if (sc->swappedMax >= static_cast<int64_t>(sc->chunks.size() - 2))
+                continue;
+
+            const uint64_t resident = sc->chunks.size() - (sc->swappedMax + 1);
+            const bool overBudget = ctx->swapTransactionChunksMax > 0 && resident > ctx->swapTransactionChunksMax;
+            if (!memoryShort && !overBudget)
+                continue;
+            if (bestOverBudget && !overBudget)
+                continue;
+
+            uint64_t score;
+            switch (ctx->swapPolicy) {
+                case Ctx::SWAP_POLICY::LARGEST:
+                    score = resident;
+                    break;
+
+                case Ctx::SWAP_POLICY::OLDEST:
+                    score = ctx->swapChunkSequence - sc->sequence;
+                    break;
+
+                case Ctx::SWAP_POLICY::COST:
+                    // Young transactions are likely to commit soon and give the memory back without any disk write
+                    score = resident * (ctx->swapChunkSequence - sc->sequence + 1);
+                    break;
+
+                default:
+                    score = 0;
+            }
+
+            if (best == nullptr || (overBudget && !bestOverBudget) || score > bestScore) {
+                best = sc;
+                bestOverBudget = overBudget;
+                bestScore = score;
                 index = sc->swappedMax + 1;
                 xid = swapXid;
-                return;
+                if (ctx->swapPolicy == Ctx::SWAP_POLICY::FIRST && (overBudget || ctx->swapTransactionChunksMax == 0))
+                    return;
             }
         }
     }
 
-    bool MemoryManager::unswap(Xid xid, int64_t index) {
-        uint8_t* tc = ctx->getMemoryChunk(this, Ctx::MEMORY::TRANSACTIONS, true);
-        if (tc == nullptr)
-            return false;
+    int MemoryManager::openSwapFile(Xid xid, const std::string& fileName) {
+        if (arenaFileDes != -1)
+            return arenaFileDes;
 
-        const std::string fileName = swapPath + "/" + xid.toString() + ".swap";
-        struct stat fileStat{};
+        const auto& it = swapFiles.find(xid);
+        if (it != swapFiles.end())
+            return it->second;
 
-        if (stat(fileName.c_str(), &fileStat) != 0)
-            throw RuntimeException(50072, "swap file: " + fileName + " - get metadata returned: " + strerror(errno));
+        int flags = O_RDWR | O_CREAT;
+#if __linux__
+        if (!ctx->isFlagSet(Ctx::REDO_FLAGS::DIRECT_DISABLE))
+            flags |= O_DIRECT;
+#endif
 
-        int flags = O_RDONLY;
-        const uint64_t fileSize = fileStat.st_size;
-        if ((fileSize & (Ctx::MEMORY_CHUNK_SIZE - 1)) != 0)
-            throw RuntimeException(50072, "swap file: " + fileName + " - wrong file size: " + std::to_string(fileSize));
+        const int mode = S_IWUSR | S_IRUSR;
+        const int fileDes = open(fileName.c_str(), flags, mode);
+        if (fileDes == -1)
+            throw RuntimeException(50072, "swap file: " + fileName + " - open returned: " + strerror(errno));
 
-        if (fileSize < (index + 1) * Ctx::MEMORY_CHUNK_SIZE)
-            throw RuntimeException(50072, "swap file: " + fileName + " - too small file size: " + std::to_string(fileSize) + " to read chunk: " +
-                                          std::to_string(index));
+#if __APPLE__
+        if (!ctx->isFlagSet(Ctx::REDO_FLAGS::DIRECT_DISABLE)) {
+            if (fcntl(fileDes, F_GLOBAL_NOCACHE, 1) < 0)
+                ctx->error(10008, "file: " + fileName + " - set no cache for file returned: " + strerror(errno));
+        }
+#endif
+
+        swapFiles.insert_or_assign(xid, fileDes);
+        return fileDes;
+    }
+
+    void MemoryManager::closeSwapFile(Xid xid) {
+        releaseSegments(xid, 0);
+        swapSegments.erase(xid);
+
+        const auto& it = swapFiles.find(xid);
+        if (it == swapFiles.end())
+            return;
+        close(it->second);
+        swapFiles.erase(it);
+    }
 
+    void MemoryManager::removeSwapFile(Xid xid, const std::string& fileName) {
+        closeSwapFile(xid);
+        if (arenaFileDes == -1 && unlink(fileName.c_str()) != 0)
+            throw RuntimeException(50072, "swap file: " + fileName + " - delete returned: " + strerror(errno));
+    }
+
+    void MemoryManager::openArena() {
+        const std::string fileName = swapPath + "/" + ARENA_FILE_NAME;
+        int flags = O_RDWR | O_CREAT;
 #if __linux__
         if (!ctx->isFlagSet(Ctx::REDO_FLAGS::DIRECT_DISABLE))
             flags |= O_DIRECT;
 #endif
 
-        const int fileDes = open(fileName.c_str(), flags);
-        if (fileDes == -1)
-            throw RuntimeException(50072, "swap file: " + fileName + " - open for read returned: " + strerror(errno));
+        const int mode = S_IWUSR | S_IRUSR;
+        arenaFileDes = open(fileName.c_str(), flags, mode);
+        if (arenaFileDes == -1)
+            throw RuntimeException(10012, "swap arena: " + fileName + " - open returned: " + strerror(errno));
+
+#if __linux__
+        if (fallocate(arenaFileDes, 0, 0, static_cast<off_t>(ctx->swapArenaSize)) != 0)
+            throw RuntimeException(10012, "swap arena: " + fileName + " - allocate of " + std::to_string(ctx->swapArenaSize) +
+                                          " bytes returned: " + strerror(errno));
+#else
+        if (ftruncate(arenaFileDes, static_cast<off_t>(ctx->swapArenaSize)) != 0)
+            throw RuntimeException(10012, "swap arena: " + fileName + " - resize to " + std::to_string(ctx->swapArenaSize) +
+                                          " bytes returned: " + strerror(errno));
+#endif
 
 #if __APPLE__
         if (!ctx->isFlagSet(Ctx::REDO_FLAGS::DIRECT_DISABLE)) {
-            if (fcntl(fileDes, F_GLOBAL_NOCACHE, 1) < 0)
+            if (fcntl(arenaFileDes, F_GLOBAL_NOCACHE, 1) < 0)
                 ctx->error(10008, "file: " + fileName + " - set no cache for file returned: " + strerror(errno));
         }
 #endif
 
-        const uint64_t bytes = pread(fileDes, tc, Ctx::MEMORY_CHUNK_SIZE, index * Ctx::MEMORY_CHUNK_SIZE);
-        close(fileDes);
+        arenaFree.clear();
+        arenaFree.emplace(0, ctx->swapArenaSize);
+        ctx->info(0, "swap arena: " + fileName + ", size: " + std::to_string(ctx->swapArenaSize / 1024 / 1024) + "MB");
+    }
+
+    uint64_t MemoryManager::arenaAllocate(uint64_t length) {
+        for (auto it = arenaFree.begin(); it != arenaFree.end(); ++it) {
+            if (it->second < length)
+                continue;
+
+            const uint64_t offset = it->first;
+            const uint64_t rest = it->second - length;
+            arenaFree.erase(it);
+            if (rest > 0)
+                arenaFree.emplace(offset + length, rest);
+            return offset;
+        }
+        return ARENA_NONE;
+    }
+
+    void MemoryManager::arenaRelease(uint64_t offset, uint64_t length) {
+        auto next = arenaFree.lower_bound(offset);
+        if (next != arenaFree.end() && offset + length == next->first) {
+            length += next->second;
+            next = arenaFree.erase(next);
+        }
+
+        if (next != arenaFree.begin()) {
+            auto prev = std::prev(next);
+            if (prev->first + prev->second == offset) {
+                prev->second += length;
+                return;
+            }
+        }
+        arenaFree.emplace(offset, length);
+    }
+
+    uint64_t MemoryManager::alignSize(uint64_t size) {
+        return (size + Ctx::MEMORY_ALIGNMENT - 1) & ~static_cast<uint64_t>(Ctx::MEMORY_ALIGNMENT - 1);
+    }
+
+    uint64_t MemoryManager::segmentOffset(const std::vector<SwapSegment>& segments, int64_t index) {
+        if (index == 0)
+            return 0;
+        const SwapSegment& segment = segments[index - 1];
+        return segment.offset + alignSize(segment.size);
+    }
+
+    void MemoryManager::releaseSegments(Xid xid, int64_t index) {
+        const auto& it = swapSegments.find(xid);
+        if (it == swapSegments.end())
+            return;
+
+        std::vector<SwapSegment>& segments = it->second;
+        if (static_cast<int64_t>(segments.size()) <= index)
+            return;
+
+        if (arenaFileDes != -1) {
+            for (uint64_t i = index; i < segments.size(); ++i)
+                if (segments[i].size > 0)
+                    arenaRelease(segments[i].offset, alignSize(segments[i].size));
+        }
+        segments.resize(index);
+    }
+
+    void MemoryManager::writeChunks(Xid xid, int fileDes, const std::string& fileName, int64_t index, uint8_t** tcs, uint64_t chunks) {
+        struct iovec iov[SWAP_BATCH_CHUNKS];
+        if (arenaFileDes == -1 && swapBuffer == nullptr) {
+            for (uint64_t i = 0; i < chunks; ++i) {
+                iov[i].iov_base = tcs[i];
+                iov[i].iov_len = Ctx::MEMORY_CHUNK_SIZE;
+            }
+
+            const int64_t bytes = pwritev(fileDes, iov, static_cast<int>(chunks), index * Ctx::MEMORY_CHUNK_SIZE);
+            if (bytes != static_cast<int64_t>(chunks * Ctx::MEMORY_CHUNK_SIZE))
+                throw RuntimeException(50072, "swap file: " + fileName + " - write returned: " + strerror(errno));
+            return;
+        }
+
+        std::vector<SwapSegment>& segments = swapSegments[xid];
+        if (unlikely(static_cast<int64_t>(segments.size()) < index))
+            throw RuntimeException(50072, "swap file: " + fileName + " - writing chunk: " + std::to_string(index) + " with only " +
+                                          std::to_string(segments.size()) + " chunks indexed");
+        releaseSegments(xid, index);
+
+        // Segments are packed one after another, each padded to the alignment required for direct I/O
+        uint64_t length = 0;
+        for (uint64_t i = 0; i < chunks; ++i) {
+            uint64_t size = Ctx::MEMORY_CHUNK_SIZE;
+            iov[i].iov_base = tcs[i];
+#ifdef LINK_LIBRARY_LZ4
+            if (swapBuffer != nullptr) {
+                uint8_t* data = swapBuffer + length;
+                const int compressed = LZ4_compress_default(reinterpret_cast<const char*>(tcs[i]), reinterpret_cast<char*>(data),
+                                                            static_cast<int>(Ctx::MEMORY_CHUNK_SIZE), static_cast<int>(Ctx::MEMORY_CHUNK_SIZE - 1));
+                // Not compressible chunks are kept raw
+                if (compressed > 0) {
+                    size = compressed;
+                    memset(data + size, 0, alignSize(size) - size);
+                    iov[i].iov_base = data;
+                }
+            }
+#endif /* LINK_LIBRARY_LZ4 */
+            iov[i].iov_len = alignSize(size);
+            segments.push_back({0, size});
+            length += iov[i].iov_len;
+        }
+
+        uint64_t offset;
+        if (arenaFileDes == -1)
+            offset = segmentOffset(segments, index);
+        else
+            offset = arenaAllocate(length);
+
+        if (offset != ARENA_NONE) {
+            for (uint64_t i = 0; i < chunks; ++i) {
+                segments[index + i].offset = offset;
+                offset += iov[i].iov_len;
+            }
+        } else {
+            // No room for the whole batch in one extent, place the chunks one by one
+            for (uint64_t i = 0; i < chunks; ++i) {
+                segments[index + i].offset = arenaAllocate(iov[i].iov_len);
+                if (segments[index + i].offset == ARENA_NONE) {
+                    segments.resize(index + i);
+                    throw RuntimeException(50072, "swap arena: " + swapPath + "/" + ARENA_FILE_NAME + " - no free space for " +
+                                                  std::to_string(iov[i].iov_len) + " bytes, increase \"swap-arena-mb\"");
+                }
+            }
+        }
+
+        uint64_t first = 0;
+        while (first < chunks) {
+            uint64_t last = first;
+            uint64_t runLength = iov[first].iov_len;
+            while (last + 1 < chunks && segments[index + last + 1].offset == segments[index + last].offset + iov[last].iov_len) {
+                ++last;
+                runLength += iov[last].iov_len;
+            }
+
+            const int64_t bytes = pwritev(fileDes, iov + first, static_cast<int>(last - first + 1), segments[index + first].offset);
+            if (bytes != static_cast<int64_t>(runLength))
+                throw RuntimeException(50072, "swap file: " + fileName + " - write returned: " + strerror(errno));
+            first = last + 1;
+        }
+        ctx->swappedDiskBytes += length;
+    }
+
+    void MemoryManager::readChunks(Xid xid, int fileDes, const std::string& fileName, int64_t index, uint8_t** tcs, uint64_t chunks) {
+        struct iovec iov[SWAP_BATCH_CHUNKS];
+        uint64_t fileSize = ctx->swapArenaSize;
+        if (arenaFileDes == -1) {
+            struct stat fileStat{};
+            if (fstat(fileDes, &fileStat) != 0)
+                throw RuntimeException(50072, "swap file: " + fileName + " - get metadata returned: " + strerror(errno));
+            fileSize = fileStat.st_size;
+        }
+
+        if (arenaFileDes == -1 && swapBuffer == nullptr) {
+            if ((fileSize & (Ctx::MEMORY_CHUNK_SIZE - 1)) != 0)
+                throw RuntimeException(50072, "swap file: " + fileName + " - wrong file size: " + std::to_string(fileSize));
+
+            if (fileSize < (index + chunks) * Ctx::MEMORY_CHUNK_SIZE)
+                throw RuntimeException(50072, "swap file: " + fileName + " - too small file size: " + std::to_string(fileSize) + " to read chunk: " +
+                                              std::to_string(index + chunks - 1));
+
+            for (uint64_t i = 0; i < chunks; ++i) {
+                iov[i].iov_base = tcs[i];
+                iov[i].iov_len = Ctx::MEMORY_CHUNK_SIZE;
+            }
+
+            const int64_t bytes = preadv(fileDes, iov, static_cast<int>(chunks), index * Ctx::MEMORY_CHUNK_SIZE);
+            if (bytes != static_cast<int64_t>(chunks * Ctx::MEMORY_CHUNK_SIZE))
+                throw RuntimeException(50072, "swap file: " + fileName + " - read returned: " + strerror(errno));
+            return;
+        }
+
+        const auto& it = swapSegments.find(xid);
+        if (unlikely(it == swapSegments.end() || static_cast<int64_t>(it->second.size()) < index + static_cast<int64_t>(chunks)))
+            throw RuntimeException(50072, "swap file: " + fileName + " - chunk: " + std::to_string(index + chunks - 1) + " not indexed");
+        const std::vector<SwapSegment>& segments = it->second;
+
+        uint64_t first = 0;
+        while (first < chunks) {
+            // Read every run of adjacent segments with one call, raw runs go straight to the chunks
+            uint64_t last = first;
+            uint64_t runLength = alignSize(segments[index + first].size);
+            bool raw = segments[index + first].size == Ctx::MEMORY_CHUNK_SIZE;
+            while (last + 1 < chunks &&
+                   segments[index + last + 1].offset == segments[index + last].offset + alignSize(segments[index + last].size)) {
+                ++last;
+                runLength += alignSize(segments[index + last].size);
+                raw = raw && segments[index + last].size == Ctx::MEMORY_CHUNK_SIZE;
+            }
 
-        if (bytes != Ctx::MEMORY_CHUNK_SIZE)
-            throw RuntimeException(50072, "swap file: " + fileName + " - read returned: " + strerror(errno));
+            const uint64_t offset = segments[index + first].offset;
+            if (unlikely(segments[index + first].size == 0 || segments[index + last].size == 0 || fileSize < offset + runLength))
+                throw RuntimeException(50072, "swap file: " + fileName + " - too small file size: " + std::to_string(fileSize) + " to read chunk: " +
+                                              std::to_string(index + last));
 
+            int64_t bytes;
+            if (raw || swapBuffer == nullptr) {
+                for (uint64_t i = first; i <= last; ++i) {
+                    iov[i - first].iov_base = tcs[i];
+                    iov[i - first].iov_len = Ctx::MEMORY_CHUNK_SIZE;
+                }
+                bytes = preadv(fileDes, iov, static_cast<int>(last - first + 1), static_cast<off_t>(offset));
+            } else
+                bytes = pread(fileDes, swapBuffer, runLength, static_cast<off_t>(offset));
+            if (bytes != static_cast<int64_t>(runLength))
+                throw RuntimeException(50072, "swap file: " + fileName + " - read returned: " + strerror(errno));
+
+#ifdef LINK_LIBRARY_LZ4
+            if (!raw && swapBuffer != nullptr) {
+                for (uint64_t i = first; i <= last; ++i) {
+                    const SwapSegment& segment = segments[index + i];
+                    const uint8_t* data = swapBuffer + (segment.offset - offset);
+                    if (segment.size == Ctx::MEMORY_CHUNK_SIZE) {
+                        memcpy(tcs[i], data, Ctx::MEMORY_CHUNK_SIZE);
+                        continue;
+                    }
+
+                    const int size = LZ4_decompress_safe(reinterpret_cast<const char*>(data), reinterpret_cast<char*>(tcs[i]),
+                                                         static_cast<int>(segment.size), static_cast<int>(Ctx::MEMORY_CHUNK_SIZE));
+                    if (size != static_cast<int>(Ctx::MEMORY_CHUNK_SIZE))
+                        throw RuntimeException(50072, "swap file: " + fileName + " - decompression of chunk: " + std::to_string(index + i) +
+                                                      " returned: " + std::to_string(size));
+                }
+            }
+#endif /* LINK_LIBRARY_LZ4 */
+            first = last + 1;
+        }
+    }
+
+    void MemoryManager::dropChunks(Xid xid, int64_t index, uint64_t chunks) {
+        if (arenaFileDes == -1)
+            return;
+
+        const auto& it = swapSegments.find(xid);
+        if (it == swapSegments.end())
+            return;
+
+        // Chunks read back from the front are not needed on disk anymore, return their extents
+        for (uint64_t i = index; i < index + chunks && i < it->second.size(); ++i) {
+            SwapSegment& segment = it->second[i];
+            if (segment.size == 0)
+                continue;
+            arenaRelease(segment.offset, alignSize(segment.size));
+            segment.size = 0;
+        }
+    }
+
+    void MemoryManager::truncateChunks(Xid xid, int fileDes, const std::string& fileName, int64_t index) {
+        if (arenaFileDes != -1) {
+            releaseSegments(xid, index);
+            return;
+        }
+
+        uint64_t size = index * Ctx::MEMORY_CHUNK_SIZE;
+        if (swapBuffer != nullptr) {
+            releaseSegments(xid, index);
+            size = segmentOffset(swapSegments[xid], index);
+        }
+
+        if (ftruncate(fileDes, size) != 0)
+            throw RuntimeException(50072, "swap file: " + fileName + " - truncate returned: " + strerror(errno));
+    }
+
+    uint64_t MemoryManager::unswap(Xid xid, int64_t index, uint64_t count) {
+        uint8_t* tcs[SWAP_BATCH_CHUNKS];
+        tcs[0] = ctx->getMemoryChunk(this, Ctx::MEMORY::TRANSACTIONS, true);
+        if (tcs[0] == nullptr)
+            return 0;
+
+        // Read ahead only as far as there is free memory, never wait for it
+        uint64_t chunks = 1;
+        while (chunks < count) {
+            tcs[chunks] = ctx->getMemoryChunk(this, Ctx::MEMORY::TRANSACTIONS, true, false);
+            if (tcs[chunks] == nullptr)
+                break;
+            ++chunks;
+        }
+
+        const std::string fileName = swapPath + "/" + xid.toString() + ".swap";
+        const int fileDes = openSwapFile(xid, fileName);
+        readChunks(xid, fileDes, fileName, index, tcs, chunks);
+
+        uint64_t unused = 0;
         {
             contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::MEMORY_UNSWAP);
             std::unique_lock<std::mutex> const lck(ctx->swapMtx);
@@ -288,38 +704,119 @@ namespace OpenLogReplicator {
                 throw RuntimeException(50070, "swap chunk not found for xid: " + xid.toString() + " during unswap read");
             SwapChunk* sc = it->second;
             if (sc->swappedMin == index) {
-                sc->chunks[sc->swappedMin] = tc;
-                if (sc->swappedMin == sc->swappedMax)
+                if (index + static_cast<int64_t>(chunks) > sc->swappedMax + 1) {
+                    unused = chunks;
+                    chunks = sc->swappedMax + 1 - index;
+                    unused -= chunks;
+                }
+
+                for (uint64_t i = 0; i < chunks; ++i)
+                    sc->chunks[index + i] = tcs[i];
+                dropChunks(xid, index, chunks);
+                if (sc->swappedMin + static_cast<int64_t>(chunks) > sc->swappedMax)
                     sc->swappedMin = sc->swappedMax = -1;
                 else
-                    ++sc->swappedMin;
-                contextSet(Thread::CONTEXT::CPU);
-                return true;
-            }
-
-            if (sc->swappedMax == index) {
-                sc->chunks[sc->swappedMax] = tc;
+                    sc->swappedMin += chunks;
+            } else if (sc->swappedMax == index) {
+                unused = chunks - 1;
+                chunks = 1;
+                sc->chunks[sc->swappedMax] = tcs[0];
                 if (sc->swappedMin == sc->swappedMax) {
                     sc->swappedMin = sc->swappedMax = -1;
-                    if (unlink(fileName.c_str()) != 0)
-                        throw RuntimeException(50072, "swap file: " + fileName + " - delete returned: " + strerror(errno));
+                    removeSwapFile(xid, fileName);
                 } else {
                     --sc->swappedMax;
-                    if (truncate(fileName.c_str(), (sc->swappedMax + 1) * Ctx::MEMORY_CHUNK_SIZE) != 0)
-                        throw RuntimeException(50072, "swap file: " + fileName + " - truncate returned: " + strerror(errno));
+                    truncateChunks(xid, fileDes, fileName, sc->swappedMax + 1);
                 }
+            } else
+                throw RuntimeException(50072, "swap file: " + fileName + " - unswapping: " + std::to_string(index) + " not in range " +
+                                              std::to_string(sc->swappedMin) + "-" + std::to_string(sc->swappedMax));
+        }
+        contextSet(Thread::CONTEXT::CPU);
+
+        for (uint64_t i = chunks; i < chunks + unused; ++i)
+            ctx->freeMemoryChunk(this, Ctx::MEMORY::TRANSACTIONS, tcs[i]);
+        // xid, first chunk, chunks, bytes
+        OLR_PROBE4(memory_unswap, xid.getData(), index, chunks, chunks * Ctx::MEMORY_CHUNK_SIZE);
+        FlightRecorder::record(FlightRecorder::EVENT::UNSWAP, xid.getData(), chunks);
+        return chunks;
+    }
 
-                contextSet(Thread::CONTEXT::CPU);
-                return true;
+    // Holds the swap reads and writes of the tenant to its weighted part of the swap bandwidth of the process, the wait is taken after
+    // the transfer so that a single batch is never delayed when the tenant has been idle
+    // The oldest transaction is likely to commit the last, its chunks are written back and dropped from the page cache first. The last two
+    // chunks of a transaction are still written to and are left alone, like with the explicit swap
+    uint64_t MemoryManager::pageOut() {
+        uint8_t* tcs[SWAP_BATCH_CHUNKS];
+        uint64_t chunks = 0;
+        {
+            contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::MEMORY_RUN1);
+            std::unique_lock<std::mutex> const lck(ctx->swapMtx);
+            uint64_t resident = 0;
+            SwapChunk* oldest = nullptr;
+            for (const auto& [xid, sc]: ctx->swapChunks) {
+                if (sc->release)
+                    continue;
+                resident += sc->chunks.size() - (sc->pagedOutMax + 1);
+                if (ctx->swappedFlushXid == xid || sc->pinned || sc->pagedOutMax >= static_cast<int64_t>(sc->chunks.size()) - 3)
+                    continue;
+                if (oldest == nullptr || sc->sequence < oldest->sequence)
+                    oldest = sc;
             }
+            ctx->transactionMapResident = resident;
+
+            const uint64_t residentMax = ctx->transactionMapResidentMb / Ctx::MEMORY_CHUNK_SIZE_MB;
+            if (oldest != nullptr && resident > residentMax) {
+                const uint64_t excess = std::min(SWAP_BATCH_CHUNKS, resident - residentMax);
+                while (chunks < excess && oldest->pagedOutMax < static_cast<int64_t>(oldest->chunks.size()) - 3) {
+                    ++oldest->pagedOutMax;
+                    if (oldest->chunks[oldest->pagedOutMax] != nullptr)
+                        tcs[chunks++] = oldest->chunks[oldest->pagedOutMax];
+                }
+                ctx->transactionMapResident -= chunks;
+            }
+        }
+        contextSet(Thread::CONTEXT::CPU);
+
+        // A chunk released meanwhile gets a useless hint, the data of a reused one stays valid since the mapping is shared
+        for (uint64_t i = 0; i < chunks; ++i) {
+            contextSet(Thread::CONTEXT::OS, Thread::REASON::OS);
+#if defined(MADV_PAGEOUT)
+            madvise(tcs[i], Ctx::MEMORY_CHUNK_SIZE, MADV_PAGEOUT);
+#elif defined(MADV_COLD)
+            madvise(tcs[i], Ctx::MEMORY_CHUNK_SIZE, MADV_COLD);
+#endif
+        }
+        contextSet(Thread::CONTEXT::CPU);
+        return chunks;
+    }
 
-            throw RuntimeException(50072, "swap file: " + fileName + " - unswapping: " + std::to_string(index) + " not in range " +
-                                          std::to_string(sc->swappedMin) + "-" + std::to_string(sc->swappedMax));
+    void MemoryManager::paceSwap(uint64_t chunks) {
+        if (chunks == 0 || ctx->memoryPool == nullptr)
+            return;
+        const uint64_t bytesPerSecond = ctx->memoryPool->getSwapBytesPerSecond(&ctx->memoryShare);
+        if (bytesPerSecond == 0)
+            return;
+
+        time_ut now = ctx->clock->getTimeUt();
+        swapPaceUt = std::max(swapPaceUt, now) + static_cast<time_ut>(chunks * Ctx::MEMORY_CHUNK_SIZE * 1000000 / bytesPerSecond);
+        if (swapPaceUt <= now)
+            return;
+
+        contextSet(CONTEXT::SLEEP, REASON::MEMORY_SWAP_QUOTA);
+        {
+            std::unique_lock<std::mutex> lck(ctx->swapMtx);
+            while (!ctx->hardShutdown && now < swapPaceUt) {
+                ctx->chunksMemoryManager.wait_for(lck, std::chrono::microseconds(swapPaceUt - now));
+                now = ctx->clock->getTimeUt();
+            }
         }
+        contextSet(CONTEXT::CPU);
     }
 
-    bool MemoryManager::swap(Xid xid, int64_t index) {
-        uint8_t* tc;
+    uint64_t MemoryManager::swap(Xid xid, int64_t index) {
+        uint8_t* tcs[SWAP_BATCH_CHUNKS];
+        uint64_t chunks;
         SwapChunk* sc;
         {
             contextSet(CONTEXT::MUTEX, REASON::MEMORY_SWAP1);
@@ -331,62 +828,45 @@ namespace OpenLogReplicator {
 
             if (sc->chunks.size() <= 1 || index >= static_cast<int64_t>(sc->chunks.size() - 1) || sc->swappedMax != index - 1) {
                 contextSet(CONTEXT::CPU);
-                return false;
+                return 0;
             }
 
-            tc = sc->chunks[index];
+            // The last chunk is still being appended to, everything before it can go at once
+            chunks = std::min(SWAP_BATCH_CHUNKS, static_cast<uint64_t>(sc->chunks.size() - 1 - index));
+            for (uint64_t i = 0; i < chunks; ++i) {
+                tcs[i] = sc->chunks[index + i];
+                sc->chunks[index + i] = nullptr;
+            }
 
-            sc->swappedMax = index;
+            sc->swappedMax = index + chunks - 1;
             if (sc->swappedMin == -1)
-                sc->swappedMin = sc->swappedMax;
-
-            sc->chunks[index] = nullptr;
+                sc->swappedMin = index;
         }
         contextSet(CONTEXT::CPU);
 
         const std::string fileName = swapPath + "/" + xid.toString() + ".swap";
+        const int fileDes = openSwapFile(xid, fileName);
 
-        int flags = O_WRONLY | O_CREAT;
-#if __linux__
-        if (!ctx->isFlagSet(Ctx::REDO_FLAGS::DIRECT_DISABLE))
-            flags |= O_DIRECT;
-#endif
-
-        const int mode = S_IWUSR | S_IRUSR;
-        const int fileDes = open(fileName.c_str(), flags, mode);
-        if (fileDes == -1)
-            throw RuntimeException(50072, "swap file: " + fileName + " - open for writing returned: " + strerror(errno));
-
-#if __APPLE__
-        if (!ctx->isFlagSet(Ctx::REDO_FLAGS::DIRECT_DISABLE)) {
-            if (fcntl(fileDes, F_GLOBAL_NOCACHE, 1) < 0)
-                ctx->error(10008, "file: " + fileName + " - set no cache for file returned: " + strerror(errno));
-        }
-#endif
-
-        const uint64_t bytes = pwrite(fileDes, tc, Ctx::MEMORY_CHUNK_SIZE, index * Ctx::MEMORY_CHUNK_SIZE);
-        if (bytes != Ctx::MEMORY_CHUNK_SIZE) {
-            close(fileDes);
-            throw RuntimeException(50072, "swap file: " + fileName + " - write returned: " + strerror(errno));
-        }
-        close(fileDes);
-        ++ctx->swappedMB;
+        writeChunks(xid, fileDes, fileName, index, tcs, chunks);
+        ctx->swappedMB += chunks * Ctx::MEMORY_CHUNK_SIZE_MB;
         bool remove = false;
-        uint64_t truncateSize(0);
+        bool shrink = false;
 
         {
             contextSet(CONTEXT::MUTEX, REASON::MEMORY_SWAP2);
             std::unique_lock<std::mutex> const lck(ctx->swapMtx);
 
             if (ctx->swappedShrinkXid == xid) {
-                sc->chunks[index] = tc;
+                // The transaction is shrinking, give the whole batch back
+                for (uint64_t i = 0; i < chunks; ++i)
+                    sc->chunks[index + i] = tcs[i];
 
-                if (sc->swappedMax == 0) {
+                if (sc->swappedMin == index) {
                     sc->swappedMin = sc->swappedMax = -1;
                     remove = true;
                 } else {
-                    --sc->swappedMax;
-                    truncateSize = (sc->swappedMax + 1) * Ctx::MEMORY_CHUNK_SIZE;
+                    sc->swappedMax = index - 1;
+                    shrink = true;
                 }
                 ctx->chunksTransaction.notify_all();
             }
@@ -395,17 +875,19 @@ namespace OpenLogReplicator {
 
         // discard writes
         if (remove) {
-            if (unlink(fileName.c_str()) != 0)
-                throw RuntimeException(50072, "swap file: " + fileName + " - delete returned: " + strerror(errno));
-            return false;
+            removeSwapFile(xid, fileName);
+            return 0;
         }
-        if (truncateSize > 0) {
-            if (truncate(fileName.c_str(), truncateSize) != 0)
-                throw RuntimeException(50072, "swap file: " + fileName + " - truncate returned: " + strerror(errno));
-            return false;
+        if (shrink) {
+            truncateChunks(xid, fileDes, fileName, index);
+            return 0;
         }
 
-        ctx->freeMemoryChunk(this, Ctx::MEMORY::TRANSACTIONS, tc);
-        return true;
+        for (uint64_t i = 0; i < chunks; ++i)
+            ctx->freeMemoryChunk(this, Ctx::MEMORY::TRANSACTIONS, tcs[i]);
+        // xid, first chunk, chunks, bytes
+        OLR_PROBE4(memory_swap, xid.getData(), index, chunks, chunks * Ctx::MEMORY_CHUNK_SIZE);
+        FlightRecorder::record(FlightRecorder::EVENT::SWAP, xid.getData(), chunks);
+        return chunks;
     }
 }
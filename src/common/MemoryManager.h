@@ -20,13 +20,39 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #ifndef MEMORY_MANAGER_H_
 #define MEMORY_MANAGER_H_
 
+#include <map>
+#include <unordered_map>
+#include <vector>
+
 #include "../common/Thread.h"
+#include "../common/types/Xid.h"
 
 namespace OpenLogReplicator {
 
     class MemoryManager final : public Thread {
     protected:
+        // Consecutive chunks moved to or from the swap file with one vectored call
+        static constexpr uint64_t SWAP_BATCH_CHUNKS{8};
+        static constexpr uint64_t ARENA_NONE{0xFFFFFFFFFFFFFFFF};
+        static constexpr const char* ARENA_FILE_NAME{"swap.arena"};
+
         std::string swapPath;
+        // Swap files kept open for the whole life of the transaction, only used by the manager thread
+        std::unordered_map<Xid, int> swapFiles;
+
+        // Place of a compressed chunk in the swap file, chunks which did not compress are stored raw with full size
+        struct SwapSegment {
+            uint64_t offset;
+            uint64_t size;
+        };
+        std::unordered_map<Xid, std::vector<SwapSegment>> swapSegments;
+        // Staging area for compressed batches, only allocated when swap compression is enabled
+        uint8_t* swapBuffer{nullptr};
+        // Single preallocated file shared by all transactions, free extents by offset
+        int arenaFileDes{-1};
+        std::map<uint64_t, uint64_t> arenaFree;
+        // Time when the swap reads and writes done so far fit into the tenant's part of the swap bandwidth
+        time_ut swapPaceUt{0};
 
     public:
         MemoryManager(Ctx* newCtx, std::string newAlias, std::string newSwapPath);
@@ -39,10 +65,25 @@ namespace OpenLogReplicator {
     private:
         uint64_t cleanOldTransactions();
         void cleanup(bool silent = false);
-        void getChunkToUnswap(Xid& xid, int64_t& index);
+        void getChunkToUnswap(Xid& xid, int64_t& index, uint64_t& count);
         void getChunkToSwap(Xid& xid, int64_t& index);
-        bool unswap(Xid xid, int64_t index);
-        bool swap(Xid xid, int64_t index);
+        int openSwapFile(Xid xid, const std::string& fileName);
+        void closeSwapFile(Xid xid);
+        void removeSwapFile(Xid xid, const std::string& fileName);
+        void openArena();
+        uint64_t arenaAllocate(uint64_t length);
+        void arenaRelease(uint64_t offset, uint64_t length);
+        static uint64_t alignSize(uint64_t size);
+        static uint64_t segmentOffset(const std::vector<SwapSegment>& segments, int64_t index);
+        void releaseSegments(Xid xid, int64_t index);
+        void dropChunks(Xid xid, int64_t index, uint64_t chunks);
+        void writeChunks(Xid xid, int fileDes, const std::string& fileName, int64_t index, uint8_t** tcs, uint64_t chunks);
+        void readChunks(Xid xid, int fileDes, const std::string& fileName, int64_t index, uint8_t** tcs, uint64_t chunks);
+        void truncateChunks(Xid xid, int fileDes, const std::string& fileName, int64_t index);
+        uint64_t unswap(Xid xid, int64_t index, uint64_t count);
+        uint64_t swap(Xid xid, int64_t index);
+        void paceSwap(uint64_t chunks);
+        uint64_t pageOut();
 
         std::string getName() const override {
             return {"MemoryManager"};
@@ -0,0 +1,178 @@
+/* Memory chunks shared by all tenants of the process
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "Ctx.h"
+#include "MemoryPool.h"
+
+namespace OpenLogReplicator {
+    MemoryPool::~MemoryPool() {
+        for (uint8_t* chunk: chunksFree)
+            free(chunk);
+        chunksFree.clear();
+    }
+
+    void MemoryPool::setMaxMb(uint64_t maxMb) {
+        std::unique_lock<std::mutex> const lck(mtx);
+        chunksMax = maxMb / Ctx::MEMORY_CHUNK_SIZE_MB;
+    }
+
+    void MemoryPool::setSwapMbPerSecond(uint64_t mbPerSecond) {
+        std::unique_lock<std::mutex> const lck(mtx);
+        swapBytesPerSecond = mbPerSecond * 1024 * 1024;
+    }
+
+    void MemoryPool::addKeep(uint64_t chunks) {
+        std::unique_lock<std::mutex> const lck(mtx);
+        chunksKeep += chunks;
+    }
+
+    // An idle tenant leaving returns its share of kept chunks to the OS
+    void MemoryPool::removeKeep(uint64_t chunks) {
+        std::unique_lock<std::mutex> const lck(mtx);
+        chunksKeep -= std::min(chunks, chunksKeep);
+        while (chunksFree.size() > chunksKeep) {
+            free(chunksFree.back());
+            chunksFree.pop_back();
+            --chunksAllocated;
+        }
+    }
+
+    void MemoryPool::addShare(Share* share) {
+        std::unique_lock<std::mutex> const lck(mtx);
+        if (!shares.insert(share).second)
+            return;
+        memoryWeights += share->memoryWeight;
+        swapWeights += share->swapWeight;
+    }
+
+    void MemoryPool::removeShare(Share* share) {
+        std::unique_lock<std::mutex> const lck(mtx);
+        if (shares.erase(share) == 0)
+            return;
+        memoryWeights -= share->memoryWeight;
+        swapWeights -= share->swapWeight;
+    }
+
+    // Within its weighted part of the limit a tenant always gets memory. Above it, the tenant may only borrow what is not still due
+    // to the tenants below their part, so one busy tenant can't take the memory the idle ones would need to resume
+    bool MemoryPool::allowed(const Share* share, uint64_t chunks) const {
+        if (chunksMax == 0)
+            return true;
+
+        const uint64_t chunksUsed = chunksAllocated - chunksFree.size();
+        if (chunksUsed + chunks > chunksMax)
+            return false;
+        if (memoryWeights == 0 || share->chunks + chunks <= chunksMax * share->memoryWeight / memoryWeights)
+            return true;
+
+        uint64_t chunksDue = 0;
+        for (const Share* other: shares) {
+            if (other == share)
+                continue;
+            const uint64_t otherPart = chunksMax * other->memoryWeight / memoryWeights;
+            if (other->chunks < otherPart)
+                chunksDue += otherPart - other->chunks;
+        }
+        return chunksUsed + chunks + chunksDue <= chunksMax;
+    }
+
+    // Returns nullptr when the process-wide limit or the share is reached, the caller waits for another tenant to release memory
+    uint8_t* MemoryPool::acquireChunk(Share* share) {
+        std::unique_lock<std::mutex> const lck(mtx);
+        if (!allowed(share, 1))
+            return nullptr;
+
+        if (!chunksFree.empty()) {
+            uint8_t* chunk = chunksFree.back();
+            chunksFree.pop_back();
+            ++share->chunks;
+            return chunk;
+        }
+
+        auto* chunk = reinterpret_cast<uint8_t*>(aligned_alloc(Ctx::MEMORY_ALIGNMENT, Ctx::MEMORY_CHUNK_SIZE));
+        if (chunk == nullptr)
+            return nullptr;
+        chunksHWM = std::max(++chunksAllocated, chunksHWM);
+        ++share->chunks;
+        return chunk;
+    }
+
+    void MemoryPool::releaseChunk(Share* share, uint8_t* chunk) {
+        {
+            std::unique_lock<std::mutex> const lck(mtx);
+            share->chunks -= std::min<uint64_t>(1, share->chunks);
+            if (chunksFree.size() < chunksKeep) {
+                chunksFree.push_back(chunk);
+                return;
+            }
+            --chunksAllocated;
+        }
+        free(chunk);
+    }
+
+    // Multi-chunk blocks are allocated by the tenant, they are only counted against the process-wide limit
+    bool MemoryPool::reserveChunks(Share* share, uint64_t chunks) {
+        std::unique_lock<std::mutex> const lck(mtx);
+        if (!allowed(share, chunks))
+            return false;
+
+        while (chunksMax > 0 && chunksAllocated + chunks > chunksMax && !chunksFree.empty()) {
+            free(chunksFree.back());
+            chunksFree.pop_back();
+            --chunksAllocated;
+        }
+
+        chunksAllocated += chunks;
+        chunksHWM = std::max(chunksAllocated, chunksHWM);
+        share->chunks += chunks;
+        return true;
+    }
+
+    void MemoryPool::unreserveChunks(Share* share, uint64_t chunks) {
+        std::unique_lock<std::mutex> const lck(mtx);
+        chunksAllocated -= std::min(chunks, chunksAllocated);
+        share->chunks -= std::min(chunks, share->chunks);
+    }
+
+    // The tenant's weighted part of the process-wide swap bandwidth, recomputed as tenants come and go
+    uint64_t MemoryPool::getSwapBytesPerSecond(const Share* share) const {
+        std::unique_lock<std::mutex> const lck(mtx);
+        if (swapBytesPerSecond == 0 || swapWeights == 0 || shares.find(share) == shares.end())
+            return 0;
+        return std::max<uint64_t>(swapBytesPerSecond * share->swapWeight / swapWeights, 1);
+    }
+
+    uint64_t MemoryPool::getAllocatedMb() const {
+        std::unique_lock<std::mutex> const lck(mtx);
+        return chunksAllocated * Ctx::MEMORY_CHUNK_SIZE_MB;
+    }
+
+    uint64_t MemoryPool::getFreeMb() const {
+        std::unique_lock<std::mutex> const lck(mtx);
+        return chunksFree.size() * Ctx::MEMORY_CHUNK_SIZE_MB;
+    }
+
+    uint64_t MemoryPool::getHWMMb() const {
+        std::unique_lock<std::mutex> const lck(mtx);
+        return chunksHWM * Ctx::MEMORY_CHUNK_SIZE_MB;
+    }
+}
@@ -0,0 +1,83 @@
+/* Header for MemoryPool class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef MEMORY_POOL_H_
+#define MEMORY_POOL_H_
+
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace OpenLogReplicator {
+    // Process-wide source of memory chunks shared by all tenants of one process, every tenant keeps its own quota (memory-max-mb)
+    // and chunks released by one tenant are reused by the others instead of going back to the OS
+    class MemoryPool final {
+    public:
+        // Claim of one tenant, the weights split the process-wide limits between the registered tenants
+        struct Share {
+            uint64_t memoryWeight{100};
+            uint64_t swapWeight{100};
+            // Chunks and blocks in use by the tenant, guarded by the pool
+            uint64_t chunks{0};
+        };
+
+    protected:
+        mutable std::mutex mtx;
+        std::vector<uint8_t*> chunksFree;
+        // Limit of chunks in use by all tenants together, 0 means only the tenant quotas apply
+        uint64_t chunksMax{0};
+        uint64_t chunksAllocated{0};
+        // Sum of memory-min-mb of the registered tenants, that many idle chunks are kept for reuse
+        uint64_t chunksKeep{0};
+        uint64_t chunksHWM{0};
+        std::set<const Share*> shares;
+        uint64_t memoryWeights{0};
+        uint64_t swapWeights{0};
+        // Swap reads and writes of all tenants together, 0 means unlimited
+        uint64_t swapBytesPerSecond{0};
+
+        [[nodiscard]] bool allowed(const Share* share, uint64_t chunks) const;
+
+    public:
+        MemoryPool() = default;
+        ~MemoryPool();
+        MemoryPool(const MemoryPool&) = delete;
+        MemoryPool& operator=(const MemoryPool&) = delete;
+
+        void setMaxMb(uint64_t maxMb);
+        void setSwapMbPerSecond(uint64_t mbPerSecond);
+        void addKeep(uint64_t chunks);
+        void removeKeep(uint64_t chunks);
+        void addShare(Share* share);
+        void removeShare(Share* share);
+
+        [[nodiscard]] uint8_t* acquireChunk(Share* share);
+        void releaseChunk(Share* share, uint8_t* chunk);
+        [[nodiscard]] bool reserveChunks(Share* share, uint64_t chunks);
+        void unreserveChunks(Share* share, uint64_t chunks);
+        [[nodiscard]] uint64_t getSwapBytesPerSecond(const Share* share) const;
+
+        [[nodiscard]] uint64_t getAllocatedMb() const;
+        [[nodiscard]] uint64_t getFreeMb() const;
+        [[nodiscard]] uint64_t getHWMMb() const;
+    };
+}
+
+#endif
@@ -0,0 +1,76 @@
+/* Definition of OrphanedLobs
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include "Ctx.h"
+#include "OrphanedLobs.h"
+
+namespace OpenLogReplicator {
+    OrphanedLobs::~OrphanedLobs() {
+        purge();
+    }
+
+    void OrphanedLobs::add(const Ctx* ctx, const LobKey& lobKey, uint8_t* data) {
+        lobs.insert_or_assign(lobKey, Element{data, ++sequence});
+        order.emplace_back(lobKey, sequence);
+        size += *reinterpret_cast<const typeTransactionSize*>(data);
+
+        if (ctx->orphanedLobSizeMax > 0)
+            while (size > ctx->orphanedLobSizeMax && !lobs.empty())
+                evict(ctx);
+
+        if (order.size() > (lobs.size() * 2) + 64)
+            compact();
+    }
+
+    void OrphanedLobs::evict(const Ctx* ctx) {
+        while (!order.empty()) {
+            const auto [lobKey, lobSequence] = order.front();
+            order.pop_front();
+
+            auto lobsIt = lobs.find(lobKey);
+            if (lobsIt == lobs.end() || lobsIt->second.sequence != lobSequence)
+                continue;
+
+            ctx->warning(60043, "orphaned lob dropped, size limit (parameter \"orphaned-lob-max-mb\") reached, lob: " + lobKey.lobId.lower() +
+                                ", page: " + std::to_string(lobKey.page));
+            size -= *reinterpret_cast<const typeTransactionSize*>(lobsIt->second.data);
+            delete[] lobsIt->second.data;
+            lobs.erase(lobsIt);
+            return;
+        }
+    }
+
+    void OrphanedLobs::compact() {
+        std::deque<std::pair<LobKey, uint64_t>> newOrder;
+        for (const auto& [lobKey, lobSequence]: order) {
+            auto lobsIt = lobs.find(lobKey);
+            if (lobsIt != lobs.end() && lobsIt->second.sequence == lobSequence)
+                newOrder.emplace_back(lobKey, lobSequence);
+        }
+        order.swap(newOrder);
+    }
+
+    void OrphanedLobs::purge() {
+        for (const auto& [_, element]: lobs)
+            delete[] element.data;
+        lobs.clear();
+        order.clear();
+        size = 0;
+    }
+}
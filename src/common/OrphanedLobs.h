@@ -0,0 +1,71 @@
+/* Header for OrphanedLobs class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef ORPHANED_LOBS_H_
+#define ORPHANED_LOBS_H_
+
+#include <deque>
+#include <map>
+
+#include "LobKey.h"
+#include "types/Types.h"
+
+namespace OpenLogReplicator {
+    class Ctx;
+
+    // LOB pages found before the transaction they belong to is known, kept until the LOB index matches them.
+    // Pages which never get matched would stay forever, so the total size is bounded and the oldest pages are dropped first
+    class OrphanedLobs final {
+    protected:
+        struct Element {
+            uint8_t* data;
+            uint64_t sequence;
+        };
+
+        std::map<LobKey, Element> lobs;
+        // Insertion order, entries of pages already matched or replaced are skipped when found at the front
+        std::deque<std::pair<LobKey, uint64_t>> order;
+        uint64_t sequence{0};
+        uint64_t size{0};
+
+        void evict(const Ctx* ctx);
+        void compact();
+
+    public:
+        ~OrphanedLobs();
+
+        [[nodiscard]] bool contains(const LobKey& lobKey) const {
+            return lobs.find(lobKey) != lobs.end();
+        }
+
+        void add(const Ctx* ctx, const LobKey& lobKey, uint8_t* data);
+        // Calls fn(page, data) for all pages of the LOB, ownership of data is passed to the caller
+        template<typename Fn>
+        void take(const LobId& lobId, Fn fn) {
+            for (auto lobsIt = lobs.upper_bound(LobKey(lobId, 0)); lobsIt != lobs.end() && lobsIt->first.lobId == lobId;) {
+                size -= *reinterpret_cast<const typeTransactionSize*>(lobsIt->second.data);
+                fn(lobsIt->first.page, lobsIt->second.data);
+                lobsIt = lobs.erase(lobsIt);
+            }
+        }
+        void purge();
+    };
+}
+
+#endif
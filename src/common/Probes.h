@@ -0,0 +1,38 @@
+/* Static probes for perf and bpftrace
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef PROBES_H_
+#define PROBES_H_
+
+// USDT probes of provider "openlogreplicator", listed by: bpftrace -l 'usdt:/path/to/OpenLogReplicator:*'.
+// A probe compiles to a single nop, the kernel patches it only while a tracer is attached. Arguments are plain
+// integers which are already at hand, so that nothing is computed for an unattached probe
+#ifdef LINK_LIBRARY_USDT
+#include <sys/sdt.h>
+
+#define OLR_PROBE2(name, a1, a2) DTRACE_PROBE2(openlogreplicator, name, a1, a2)
+#define OLR_PROBE3(name, a1, a2, a3) DTRACE_PROBE3(openlogreplicator, name, a1, a2, a3)
+#define OLR_PROBE4(name, a1, a2, a3, a4) DTRACE_PROBE4(openlogreplicator, name, a1, a2, a3, a4)
+#else
+#define OLR_PROBE2(name, a1, a2) do {} while (false)
+#define OLR_PROBE3(name, a1, a2, a3) do {} while (false)
+#define OLR_PROBE4(name, a1, a2, a3, a4) do {} while (false)
+#endif
+
+#endif
@@ -137,6 +137,7 @@ namespace OpenLogReplicator {
         LobId lobId;
         bool compressed;
         // other
+        bool partial;             // Only the header fields decoded, the object can't reach the output
         uint32_t vectorNo;
         typeSlt slt;
         uint16_t cls;
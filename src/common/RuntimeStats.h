@@ -0,0 +1,204 @@
+/* Header for RuntimeStats class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef RUNTIME_STATS_H_
+#define RUNTIME_STATS_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "types/FileOffset.h"
+#include "types/Scn.h"
+#include "types/Seq.h"
+#include "types/Types.h"
+#include "types/Xid.h"
+
+namespace OpenLogReplicator {
+    // Latency distribution of one pipeline stage, bucket n counts samples below 2^n microseconds
+    class alignas(64) LatencyHistogram final {
+    public:
+        static constexpr uint BUCKETS{32};
+
+        std::atomic<uint64_t> buckets[BUCKETS]{};
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> sumUs{0};
+
+        [[nodiscard]] static uint bucket(uint64_t us) {
+            uint num = 0;
+            while (num < BUCKETS - 1 && (1UL << num) <= us)
+                ++num;
+            return num;
+        }
+
+        // Upper bound of the bucket in microseconds, the last bucket is open
+        [[nodiscard]] static uint64_t bucketLimit(uint num) {
+            return 1UL << num;
+        }
+
+        void record(uint64_t us) {
+            buckets[bucket(us)].fetch_add(1, std::memory_order_relaxed);
+            count.fetch_add(1, std::memory_order_relaxed);
+            sumUs.fetch_add(us, std::memory_order_relaxed);
+        }
+    };
+
+    // Largest live transactions of the parser, copied from its transaction map so that readers never touch the map
+    class TransactionSnapshot final {
+    public:
+        static constexpr uint64_t TOP{100};
+        static constexpr time_ut INTERVAL_US{1000000};
+
+        struct Entry {
+            Xid xid;
+            uint64_t size;
+            // Memory chunks of the transaction and the range of them swapped to disk, -1 when none is swapped
+            uint64_t chunks;
+            int64_t swappedMin;
+            int64_t swappedMax;
+            Seq firstSequence;
+            FileOffset firstFileOffset;
+            // Redo time of the LWN which started the transaction
+            time_t beginEpoch;
+        };
+
+        time_ut published{0};
+        time_t lwnEpoch{0};
+        uint64_t transactions{0};
+        uint64_t bytes{0};
+        // Largest first
+        std::vector<Entry> entries;
+    };
+
+    // Cost of the tables since start, the totals are added up from the counters of the threads about once a second
+    class TableCostSnapshot final {
+    public:
+        static constexpr uint64_t TOP{100};
+
+        struct Entry {
+            std::string owner;
+            std::string table;
+            uint64_t bytesBuffered;
+            uint64_t buildNs;
+            uint64_t bytesOut;
+            uint64_t messages;
+        };
+
+        time_ut published{0};
+        uint64_t tables{0};
+        // Longest build time first
+        std::vector<Entry> entries;
+    };
+
+    // Progress counters of one replication pipeline, read by the status endpoint. Counters are relaxed atomics grouped by the thread
+    // updating them, so polling neither takes a lock nor bounces a cache line written by another stage
+    class RuntimeStats final {
+    protected:
+        static constexpr uint64_t CACHE_LINE_SIZE{64};
+
+    public:
+        // Pipeline stages measured by sampled latency: redo block timestamp to read, read to LWN parsed, commit to message built
+        // and message built to confirmed by the client
+        enum class LATENCY : unsigned char {
+            REDO_READ, READ_PARSE, COMMIT_BUILD, BUILD_CONFIRM, NUM
+        };
+        static constexpr const char* LATENCY_NAMES[static_cast<uint>(LATENCY::NUM)]{"redo_read", "read_parse", "commit_build",
+                                                                                 "build_confirm"};
+
+        // Reader threads
+        alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> bytesRead{0};
+
+        // Parser thread, position of the last LWN and its redo timestamp
+        alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> bytesParsed{0};
+        std::atomic<uint64_t> recordsParsed{0};
+        std::atomic<uint64_t> lwnScn{Scn::none().getData()};
+        std::atomic<time_t> lwnEpoch{0};
+        // Waits at the LWN boundary for the writers to release output
+        std::atomic<uint64_t> creditWaits{0};
+        std::atomic<uint64_t> creditWaitUs{0};
+
+        // Replicator thread, SCN of the dictionaries read from the database at startup, none when the schema came from a checkpoint
+        std::atomic<uint64_t> bootstrapScn{Scn::none().getData()};
+
+        // Builder, run by the parser thread but kept apart as it is updated per message
+        alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> messagesBuilt{0};
+        std::atomic<uint64_t> bytesBuilt{0};
+
+        // Writer thread
+        alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> bytesSent{0};
+        std::atomic<uint64_t> messagesSent{0};
+        std::atomic<uint64_t> messagesConfirmed{0};
+        std::atomic<uint64_t> writerQueueSize{0};
+        std::atomic<uint64_t> confirmedScn{Scn::none().getData()};
+        std::atomic<uint64_t> rateLimitWaitUs{0};
+
+        // One histogram per stage, each written by the thread owning the stage
+        LatencyHistogram latency[static_cast<uint>(LATENCY::NUM)];
+
+        static void add(std::atomic<uint64_t>& counter, uint64_t value) {
+            counter.fetch_add(value, std::memory_order_relaxed);
+        }
+
+        template<typename T>
+        static void set(std::atomic<T>& counter, T value) {
+            counter.store(value, std::memory_order_relaxed);
+        }
+
+        template<typename T>
+        [[nodiscard]] static T get(const std::atomic<T>& counter) {
+            return counter.load(std::memory_order_relaxed);
+        }
+
+        // The lock only guards the pointer, the previous snapshot is released after it
+        void publishTransactions(std::shared_ptr<const TransactionSnapshot> snapshot) {
+            {
+                std::unique_lock<std::mutex> const lck(transactionsMtx);
+                transactions.swap(snapshot);
+            }
+        }
+
+        [[nodiscard]] std::shared_ptr<const TransactionSnapshot> getTransactions() const {
+            std::unique_lock<std::mutex> const lck(transactionsMtx);
+            return transactions;
+        }
+
+        void publishTableCosts(std::shared_ptr<const TableCostSnapshot> snapshot) {
+            {
+                std::unique_lock<std::mutex> const lck(transactionsMtx);
+                tableCosts.swap(snapshot);
+            }
+        }
+
+        [[nodiscard]] std::shared_ptr<const TableCostSnapshot> getTableCosts() const {
+            std::unique_lock<std::mutex> const lck(transactionsMtx);
+            return tableCosts;
+        }
+
+    protected:
+        // Guards both snapshot pointers
+        mutable std::mutex transactionsMtx;
+        std::shared_ptr<const TransactionSnapshot> transactions;
+        std::shared_ptr<const TableCostSnapshot> tableCosts;
+    };
+}
+
+#endif
@@ -0,0 +1,152 @@
+/* Definition of Sha256 class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <cstring>
+
+#include "Sha256.h"
+#include "types/Data.h"
+
+namespace OpenLogReplicator {
+    static constexpr uint32_t SHA256_K[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+
+    static inline uint32_t rotr(uint32_t value, uint32_t bits) {
+        return (value >> bits) | (value << (32 - bits));
+    }
+
+    Sha256::Sha256() :
+            state{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19} {
+    }
+
+    void Sha256::transform(const uint8_t* data) {
+        uint32_t w[64];
+        for (uint i = 0; i < 16; ++i)
+            w[i] = (static_cast<uint32_t>(data[i * 4]) << 24) | (static_cast<uint32_t>(data[(i * 4) + 1]) << 16) |
+                   (static_cast<uint32_t>(data[(i * 4) + 2]) << 8) | static_cast<uint32_t>(data[(i * 4) + 3]);
+        for (uint i = 16; i < 64; ++i) {
+            const uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            const uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t a = state[0];
+        uint32_t b = state[1];
+        uint32_t c = state[2];
+        uint32_t d = state[3];
+        uint32_t e = state[4];
+        uint32_t f = state[5];
+        uint32_t g = state[6];
+        uint32_t h = state[7];
+
+        for (uint i = 0; i < 64; ++i) {
+            const uint32_t s1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+            const uint32_t ch = (e & f) ^ (~e & g);
+            const uint32_t temp1 = h + s1 + ch + SHA256_K[i] + w[i];
+            const uint32_t s0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+            const uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+            const uint32_t temp2 = s0 + maj;
+
+            h = g;
+            g = f;
+            f = e;
+            e = d + temp1;
+            d = c;
+            c = b;
+            b = a;
+            a = temp1 + temp2;
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+
+    void Sha256::update(const uint8_t* data, uint64_t size) {
+        totalSize += size;
+
+        if (blockSize > 0) {
+            const uint64_t copy = std::min(size, sizeof(block) - blockSize);
+            memcpy(block + blockSize, data, copy);
+            blockSize += copy;
+            data += copy;
+            size -= copy;
+            if (blockSize < sizeof(block))
+                return;
+            transform(block);
+            blockSize = 0;
+        }
+
+        while (size >= sizeof(block)) {
+            transform(data);
+            data += sizeof(block);
+            size -= sizeof(block);
+        }
+
+        if (size > 0) {
+            memcpy(block, data, size);
+            blockSize = size;
+        }
+    }
+
+    void Sha256::final(uint8_t* digest) {
+        const uint64_t bits = totalSize * 8;
+
+        block[blockSize++] = 0x80;
+        if (blockSize > 56) {
+            memset(block + blockSize, 0, sizeof(block) - blockSize);
+            transform(block);
+            blockSize = 0;
+        }
+        memset(block + blockSize, 0, 56 - blockSize);
+        for (uint i = 0; i < 8; ++i)
+            block[56 + i] = static_cast<uint8_t>(bits >> (56 - (i * 8)));
+        transform(block);
+
+        for (uint i = 0; i < 8; ++i) {
+            digest[i * 4] = static_cast<uint8_t>(state[i] >> 24);
+            digest[(i * 4) + 1] = static_cast<uint8_t>(state[i] >> 16);
+            digest[(i * 4) + 2] = static_cast<uint8_t>(state[i] >> 8);
+            digest[(i * 4) + 3] = static_cast<uint8_t>(state[i]);
+        }
+    }
+
+    std::string Sha256::hex(const uint8_t* data, uint64_t size) {
+        Sha256 sha256;
+        sha256.update(data, size);
+        uint8_t digest[DIGEST_SIZE];
+        sha256.final(digest);
+
+        std::string result(DIGEST_SIZE * 2, '0');
+        Data::hexEncode(digest, DIGEST_SIZE, result.data());
+        return result;
+    }
+}
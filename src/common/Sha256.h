@@ -0,0 +1,50 @@
+/* Header for Sha256 class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef SHA256_H_
+#define SHA256_H_
+
+#include <cstdint>
+#include <string>
+
+namespace OpenLogReplicator {
+    // FIPS 180-4 SHA-256, used only to name content-addressed files, so no dependency on a crypto library
+    class Sha256 final {
+    public:
+        static constexpr uint64_t DIGEST_SIZE = 32;
+
+    protected:
+        uint32_t state[8];
+        uint8_t block[64]{};
+        uint64_t blockSize{0};
+        uint64_t totalSize{0};
+
+        void transform(const uint8_t* data);
+
+    public:
+        Sha256();
+
+        void update(const uint8_t* data, uint64_t size);
+        void final(uint8_t* digest);
+
+        static std::string hex(const uint8_t* data, uint64_t size);
+    };
+}
+
+#endif
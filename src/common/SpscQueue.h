@@ -0,0 +1,114 @@
+/* Header for SpscQueue class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef SPSC_QUEUE_H_
+#define SPSC_QUEUE_H_
+
+#include <atomic>
+#include <cstdint>
+
+#include "types/Types.h"
+
+namespace OpenLogReplicator {
+    // Bounded lock-free ring for exactly one producer thread and one consumer thread
+    template<typename T>
+    class SpscQueue final {
+    protected:
+        static constexpr uint64_t CACHE_LINE_SIZE{64};
+
+        T* ring;
+        uint64_t mask;
+        alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> head{0};
+        uint64_t cachedTail{0};
+        alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> tail{0};
+        uint64_t cachedHead{0};
+
+        static uint64_t roundCapacity(uint64_t capacity) {
+            uint64_t size = 2;
+            while (size < capacity)
+                size <<= 1;
+            return size;
+        }
+
+    public:
+        explicit SpscQueue(uint64_t capacity) :
+                ring(new T[roundCapacity(capacity)]),
+                mask(roundCapacity(capacity) - 1) {
+        }
+
+        ~SpscQueue() {
+            delete[] ring;
+            ring = nullptr;
+        }
+
+        SpscQueue(const SpscQueue&) = delete;
+        SpscQueue& operator=(const SpscQueue&) = delete;
+
+        // Producer side
+        bool push(const T& value) {
+            const uint64_t tailPos = tail.load(std::memory_order_relaxed);
+            if (tailPos - cachedHead > mask) {
+                cachedHead = head.load(std::memory_order_acquire);
+                if (tailPos - cachedHead > mask)
+                    return false;
+            }
+            ring[tailPos & mask] = value;
+            tail.store(tailPos + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer side
+        [[nodiscard]] T* front() {
+            const uint64_t headPos = head.load(std::memory_order_relaxed);
+            if (headPos == cachedTail) {
+                cachedTail = tail.load(std::memory_order_acquire);
+                if (headPos == cachedTail)
+                    return nullptr;
+            }
+            return &ring[headPos & mask];
+        }
+
+        void pop() {
+            head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        bool pop(T& value) {
+            T* ptr = front();
+            if (ptr == nullptr)
+                return false;
+            value = *ptr;
+            pop();
+            return true;
+        }
+
+        [[nodiscard]] bool empty() const {
+            return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+        }
+
+        [[nodiscard]] uint64_t size() const {
+            return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+        }
+
+        [[nodiscard]] uint64_t capacity() const {
+            return mask + 1;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,112 @@
+/* Per-table cost accounting
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <algorithm>
+#include <memory>
+
+#include "Ctx.h"
+#include "DbTable.h"
+#include "RuntimeStats.h"
+#include "TableCost.h"
+#include "Thread.h"
+
+namespace OpenLogReplicator {
+    TableCost::TableCost(Ctx* newCtx) :
+            ctx(newCtx) {
+    }
+
+    TableCost::Local::Entry* TableCost::Local::find(const DbTable* table) {
+        auto it = entries.find(table->obj);
+        if (it == entries.end())
+            it = entries.emplace(table->obj, Entry{table, table->owner, table->name, {}}).first;
+        else if (it->second.table != table) {
+            it->second.table = table;
+            it->second.owner = table->owner;
+            it->second.name = table->name;
+        }
+        lastEntry = &it->second;
+        return lastEntry;
+    }
+
+    // The local counts are cleared, the thread starts counting from zero again
+    void TableCost::merge(Thread* t, Local& local, time_ut now) {
+        local.merged = now;
+        if (local.entries.empty())
+            return;
+
+        t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::TABLE_COST);
+        {
+            std::unique_lock<std::mutex> const lck(mtx);
+            for (const auto& [_, entry]: local.entries) {
+                Total& total = totals[entry.owner + "." + entry.name];
+                if (unlikely(total.name.empty())) {
+                    total.owner = entry.owner;
+                    total.name = entry.name;
+                }
+
+                for (uint cost = 0; cost < COUNTERS; ++cost) {
+                    if (entry.counters[cost] == 0)
+                        continue;
+                    total.counters[cost] += entry.counters[cost];
+                    if (ctx->metrics != nullptr) {
+                        MetricsCounter*& counter = total.metricsCounters[cost];
+                        if (unlikely(counter == nullptr))
+                            counter = ctx->metrics->getTableCostCounter(static_cast<Metrics::TABLE_COST>(cost), total.owner, total.name);
+                        counter->increment(entry.counters[cost]);
+                    }
+                }
+            }
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
+
+        local.entries.clear();
+        local.lastEntry = nullptr;
+    }
+
+    // Copies the totals for the status endpoint, so that it never takes the lock of the counting threads
+    void TableCost::publish(Thread* t, time_ut now) {
+        auto snapshot = std::make_shared<TableCostSnapshot>();
+        snapshot->published = now;
+
+        t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::TABLE_COST);
+        {
+            std::unique_lock<std::mutex> const lck(mtx);
+            snapshot->tables = totals.size();
+            snapshot->entries.reserve(totals.size());
+            for (const auto& [_, total]: totals)
+                snapshot->entries.push_back({total.owner, total.name, total.counters[static_cast<uint>(Metrics::TABLE_COST::BYTES_BUFFERED)],
+                                             total.counters[static_cast<uint>(Metrics::TABLE_COST::BUILD_NS)],
+                                             total.counters[static_cast<uint>(Metrics::TABLE_COST::BYTES_OUT)],
+                                             total.counters[static_cast<uint>(Metrics::TABLE_COST::MESSAGES)]});
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
+
+        std::vector<TableCostSnapshot::Entry>& entries = snapshot->entries;
+        auto larger = [](const TableCostSnapshot::Entry& a, const TableCostSnapshot::Entry& b) {
+            return a.buildNs > b.buildNs || (a.buildNs == b.buildNs && a.bytesBuffered > b.bytesBuffered);
+        };
+        if (entries.size() > TableCostSnapshot::TOP) {
+            std::partial_sort(entries.begin(), entries.begin() + TableCostSnapshot::TOP, entries.end(), larger);
+            entries.resize(TableCostSnapshot::TOP);
+        } else
+            std::sort(entries.begin(), entries.end(), larger);
+
+        ctx->stats.publishTableCosts(std::move(snapshot));
+    }
+}
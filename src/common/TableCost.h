@@ -0,0 +1,93 @@
+/* Header for TableCost class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef TABLE_COST_H_
+#define TABLE_COST_H_
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "metrics/Metrics.h"
+#include "types/Types.h"
+
+namespace OpenLogReplicator {
+    class Ctx;
+    class DbTable;
+    class Thread;
+
+    // Cost of the tables of one source. Every thread counts into its own TableCost::Local without locking and adds it to the totals
+    // about once a second, the totals feed the metrics and the snapshot read by the status endpoint
+    class TableCost final {
+    public:
+        static constexpr uint COUNTERS{static_cast<uint>(Metrics::TABLE_COST::NUM)};
+        static constexpr time_ut MERGE_INTERVAL_US{1000000};
+
+        class Local final {
+            friend class TableCost;
+
+        protected:
+            struct Entry {
+                // Only compared, the names are copied again when a table is rebuilt after DDL
+                const DbTable* table;
+                std::string owner;
+                std::string name;
+                uint64_t counters[COUNTERS];
+            };
+
+            // By object id, so that the counts of a table rebuilt after DDL stay with it
+            std::unordered_map<typeObj, Entry> entries;
+            Entry* lastEntry{nullptr};
+            time_ut merged{0};
+
+            Entry* find(const DbTable* table);
+
+        public:
+            void add(const DbTable* table, Metrics::TABLE_COST cost, uint64_t value) {
+                Entry* entry = (lastEntry != nullptr && lastEntry->table == table) ? lastEntry : find(table);
+                entry->counters[static_cast<uint>(cost)] += value;
+            }
+
+            [[nodiscard]] bool mergeDue(time_ut now) const {
+                return now - merged >= MERGE_INTERVAL_US;
+            }
+        };
+
+    protected:
+        struct Total {
+            std::string owner;
+            std::string name;
+            uint64_t counters[COUNTERS]{};
+            MetricsCounter* metricsCounters[COUNTERS]{};
+        };
+
+        Ctx* ctx;
+        std::mutex mtx;
+        // By owner and name
+        std::unordered_map<std::string, Total> totals;
+
+    public:
+        explicit TableCost(Ctx* newCtx);
+
+        void merge(Thread* t, Local& local, time_ut now);
+        void publish(Thread* t, time_ut now);
+    };
+}
+
+#endif
@@ -20,13 +20,27 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include "Ctx.h"
 #include "Thread.h"
 
+#include <cstring>
+#include <execinfo.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 #include <utility>
 #include "exception/RuntimeException.h"
 
 namespace OpenLogReplicator {
+    thread_local Thread* Thread::current{nullptr};
+
+    const std::string Thread::contextNames[static_cast<uint>(CONTEXT::NUM)]{"none", "cpu", "os", "mutex", "wait", "sleep", "mem", "tran", "chkpt"};
+
     Thread::Thread(Ctx* newCtx, std::string newAlias) :
             ctx(newCtx),
-            alias(std::move(newAlias)) {
+            alias(std::move(newAlias)),
+            recorder(&newCtx->contextClock) {
+    }
+
+    Thread::~Thread() {
+        ctx->memoryCacheRelease(this);
     }
 
     void Thread::wakeUp() {
@@ -37,10 +51,34 @@ namespace OpenLogReplicator {
         }
     }
 
+    void Thread::sampleStack(int sig __attribute__((unused))) {
+        Thread* thread = current;
+        if (thread == nullptr)
+            return;
+
+        const int savedErrno = errno;
+        thread->stackSize.store(backtrace(thread->stackFrames, STACK_FRAMES), std::memory_order_relaxed);
+        thread->stackSamples.fetch_add(1, std::memory_order_release);
+        errno = savedErrno;
+    }
+
     void* Thread::runStatic(void* voidThread) {
         auto* thread = reinterpret_cast<Thread*>(voidThread);
+        current = thread;
+        LogSink::setThread(thread->alias);
+#if __linux__
+        thread->ctx->joinCgroup();
+        if (thread->niceSet && setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), thread->nice) != 0)
+            thread->ctx->warning(60053, "thread: " + thread->alias + " - setting nice value " + std::to_string(thread->nice) + " failed: " +
+                                        strerror(errno));
+#endif
+        if (thread->ctx->flightRecorder)
+            FlightRecorder::setCurrent(&thread->recorder);
         thread->contextRun();
+        FlightRecorder::setCurrent(nullptr);
+        current = nullptr;
         thread->finished = true;
+        thread->ctx->memoryCacheRelease(thread);
         return nullptr;
     }
 }
@@ -25,6 +25,7 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 
 #include "Clock.h"
 #include "Ctx.h"
+#include "FlightRecorder.h"
 #include "types/Types.h"
 
 namespace OpenLogReplicator {
@@ -32,6 +33,8 @@ namespace OpenLogReplicator {
 
     class Thread {
     protected:
+        static thread_local Thread* current;
+
         virtual void run() = 0;
 
     public:
@@ -53,26 +56,54 @@ namespace OpenLogReplicator {
             READER_SET_READ, READER_SLEEP1, READER_SLEEP2, READER_UPDATE_REDO1, READER_UPDATE_REDO2, // 40
             READER_UPDATE_REDO3, READER_WAKE_UP, REPLICATOR_ARCH, REPLICATOR_SCHEMA, REPLICATOR_UPDATE, // 45
             TRANSACTION_DROP, TRANSACTION_FIND, TRANSACTION_SYSTEM, WRITER_CONFIRM, WRITER_DONE, // 50
+            WRITER_MERGE, READER_SSH, PARSER_DECODE, WRITER_SYNC, LOB_STORE, // 55
+            TRANSACTION_FLUSH, RAC_COORDINATOR, REDO_COPY, REDO_CACHE, CATCH_UP_DECODER, // 56
+            REPLICATOR_SNAPSHOT, CTX_SWAPPED_SNAPSHOT, READER_MEMBER, READER_FETCH, CTX_SWAPPED_PIN,
+            WRITER_PARTITION, BUILDER_CREDIT, MEMORY_TRIM, TRACER, TABLE_COST, PARSER_SCHEMA, WRITER_SCHEMA,
             // SLEEP
-            CHECKPOINT_NO_WORK, MEMORY_EXHAUSTED, METADATA_WAIT_WRITER, METADATA_WAIT_FOR_REPLICATOR, READER_CHECK, // 55
-            READER_EMPTY, READER_BUFFER_FULL, READER_FINISHED, READER_NO_WORK, MEMORY_NO_WORK, // 60
-            WRITER_NO_WORK, MEMORY_BLOCKED, // 65
+            CHECKPOINT_NO_WORK, MEMORY_EXHAUSTED, METADATA_WAIT_WRITER, METADATA_WAIT_FOR_REPLICATOR, READER_CHECK, // 59
+            READER_EMPTY, READER_BUFFER_FULL, READER_FINISHED, READER_NO_WORK, MEMORY_NO_WORK, // 64
+            WRITER_NO_WORK, MEMORY_BLOCKED, WRITER_MERGE_NO_WORK, PARSER_DECODE_NO_WORK, WRITER_SYNC_NO_WORK, // 70
+            LOB_STORE_NO_WORK, LOB_STORE_FULL, TRANSACTION_FLUSH_NO_WORK, TRANSACTION_FLUSH_FULL, RAC_COORDINATOR_WAIT, // 72
+            REDO_COPY_NO_WORK, REDO_COPY_FULL, CATCH_UP_DECODER_FULL, CATCH_UP_DECODER_EMPTY, // 77
+            REPLICATOR_SNAPSHOT_EMPTY, METADATA_WAIT_WRITERS, WATCHDOG_NO_WORK, READER_MEMBER_NO_WORK, READER_MEMBER_WAIT,
+            READER_FETCH_NO_WORK, READER_FETCH_WAIT, PARSER_STANDBY, MEMORY_SWAP_QUOTA, WRITER_PARTITION_NO_WORK,
+            WRITER_PARTITION_FULL, BUILDER_CREDIT_WAIT, TRACER_NO_WORK, WRITER_RATE_LIMIT,
             // OTHER
-            OS, MEM, TRAN, CHKPT, // 67
+            OS, MEM, TRAN, CHKPT, // 79
             // END
             NUM = 255
         };
 
+        static const std::string contextNames[static_cast<uint>(CONTEXT::NUM)];
+        static constexpr uint MEMORY_CACHE_CHUNKS{2};
+        static constexpr int STACK_FRAMES{32};
+
         Ctx* ctx;
         pthread_t pthread{0};
         std::string alias;
         std::atomic<bool> finished{false};
+        // Memory chunks released by the thread and kept for its next allocation, taken back by Ctx when memory runs out
+        std::atomic<uint8_t*> memoryCache[MEMORY_CACHE_CHUNKS]{};
+        std::atomic<bool> memoryCacheRegistered{false};
+        // Node to take memory chunks from, -1 for the node of the cpu the thread runs on
+        int numaNode{-1};
+        // Nice value applied by the thread when it starts
+        int nice{0};
+        bool niceSet{false};
+        FlightRecorder recorder;
+        // Stack taken by the thread itself in sampleStack(), stackSamples is raised once the frames are stored
+        void* stackFrames[STACK_FRAMES]{};
+        std::atomic<int> stackSize{0};
+        std::atomic<uint64_t> stackSamples{0};
 
         explicit Thread(Ctx* newCtx, std::string newAlias);
-        virtual ~Thread() = default;
+        virtual ~Thread();
 
         virtual void wakeUp();
         static void* runStatic(void* thread);
+        // Signal handler, only the frames are stored, symbols are resolved by the requesting thread
+        static void sampleStack(int sig);
 
 #ifdef THREAD_INFO
         static constexpr bool contextCompiled = true;
@@ -80,12 +111,19 @@ namespace OpenLogReplicator {
         static constexpr bool contextCompiled = false;
 #endif
         time_ut contextTimeLast{0};
-        time_ut contextTime[static_cast<uint>(CONTEXT::NUM)]{0};
-        time_ut contextCnt[static_cast<uint>(CONTEXT::NUM)]{0};
-        uint64_t reasonCnt[static_cast<uint>(REASON::NUM)]{0};
+        // Written only by the thread itself, atomic so that status polling may read them while the thread runs
+        std::atomic<time_ut> contextTime[static_cast<uint>(CONTEXT::NUM)]{};
+        std::atomic<time_ut> contextCnt[static_cast<uint>(CONTEXT::NUM)]{};
+        std::atomic<uint64_t> reasonCnt[static_cast<uint>(REASON::NUM)]{};
         REASON curReason{REASON::NONE};
         CONTEXT curContext{CONTEXT::NONE};
-        uint64_t contextSwitches{0};
+        std::atomic<uint64_t> contextSwitches{0};
+
+        // Single writer, so a relaxed load and store is enough and keeps the locked instruction out of contextSet
+        template<typename T>
+        static void counterAdd(std::atomic<T>& counter, T value) {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
 
         virtual std::string getName() const = 0;
 
@@ -97,17 +135,18 @@ namespace OpenLogReplicator {
 
         void contextStart() {
             if constexpr  (contextCompiled) {
-                contextTimeLast = ctx->clock->getTimeUt();
+                contextTimeLast = ctx->contextClock.nowUt();
             }
         }
 
         void contextSet(CONTEXT context, REASON reason = REASON::NONE) {
+            FlightRecorder::record(FlightRecorder::EVENT::CONTEXT, static_cast<uint64_t>(context), static_cast<uint64_t>(reason));
             if constexpr (contextCompiled) {
-                ++contextSwitches;
-                const time_ut contextTimeNow = ctx->clock->getTimeUt();
-                contextTime[static_cast<uint>(curContext)] += contextTimeNow - contextTimeLast;
-                ++contextCnt[static_cast<uint>(curContext)];
-                ++reasonCnt[static_cast<uint>(reason)];
+                counterAdd<uint64_t>(contextSwitches, 1);
+                const time_ut contextTimeNow = ctx->contextClock.nowUt();
+                counterAdd<time_ut>(contextTime[static_cast<uint>(curContext)], contextTimeNow - contextTimeLast);
+                counterAdd<time_ut>(contextCnt[static_cast<uint>(curContext)], 1);
+                counterAdd<uint64_t>(reasonCnt[static_cast<uint>(reason)], 1);
                 curReason = reason;
                 curContext = context;
                 contextTimeLast = contextTimeNow;
@@ -116,10 +155,10 @@ namespace OpenLogReplicator {
 
         void contextStop() {
             if constexpr (contextCompiled) {
-                ++contextSwitches;
-                const time_ut contextTimeNow = ctx->clock->getTimeUt();
-                contextTime[static_cast<uint>(curContext)] += contextTimeNow - contextTimeLast;
-                ++contextCnt[static_cast<uint>(curContext)];
+                counterAdd<uint64_t>(contextSwitches, 1);
+                const time_ut contextTimeNow = ctx->contextClock.nowUt();
+                counterAdd<time_ut>(contextTime[static_cast<uint>(curContext)], contextTimeNow - contextTimeLast);
+                counterAdd<time_ut>(contextCnt[static_cast<uint>(curContext)], 1);
 
                 std::string msg =
                         "thread: " + alias +
@@ -0,0 +1,285 @@
+/* Exporter of sampled transaction traces
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <functional>
+#include <hv/HttpClient.h>
+#include <regex>
+#include <thread>
+
+#include "Ctx.h"
+#include "DbTable.h"
+#include "Tracer.h"
+#include "exception/ConfigurationException.h"
+
+namespace OpenLogReplicator {
+    Tracer::Tracer(Ctx* newCtx, std::string newAlias, std::string newEndpoint, const std::string& database, uint64_t newIntervalMs) :
+            Thread(newCtx, std::move(newAlias)),
+            endpoint(std::move(newEndpoint)),
+            intervalMs(newIntervalMs),
+            spanSequence(static_cast<uint64_t>(newCtx->clock->getTimeUt()) << 16) {
+        const std::string suffix("/v1/traces");
+        if (endpoint.size() < suffix.size() || endpoint.compare(endpoint.size() - suffix.size(), suffix.size(), suffix) != 0)
+            endpoint += suffix;
+
+        // Traces of the same xid from two databases or tenants don't collide
+        traceIdPrefix = hex(std::hash<std::string>{}(database + "/" + ctx->tenant));
+        resource = R"({"key":"service.name","value":{"stringValue":"OpenLogReplicator"}},{"key":"olr.database","value":{"stringValue":")" +
+                   database + R"("}})";
+        if (!ctx->tenant.empty())
+            resource += R"(,{"key":"olr.tenant","value":{"stringValue":")" + ctx->tenant + R"("}})";
+    }
+
+    void Tracer::wakeUp() {
+        std::unique_lock<std::mutex> const lck(mtx);
+        condLoop.notify_all();
+    }
+
+    // Applied at start and again when the configuration is reloaded, the endpoint stays until restart
+    void Tracer::configure(const std::string& configFileName, const rapidjson::Value& tracingJson) {
+        uint64_t newSample = 0;
+        if (tracingJson.HasMember("sample"))
+            newSample = Ctx::getJsonFieldU64(configFileName, tracingJson, "sample");
+
+        std::vector<TableRule> newRules;
+        if (tracingJson.HasMember("table")) {
+            const rapidjson::Value& tableArrayJson = Ctx::getJsonFieldA(configFileName, tracingJson, "table");
+            for (rapidjson::SizeType i = 0; i < tableArrayJson.Size(); ++i) {
+                const rapidjson::Value& tableJson = Ctx::getJsonFieldO(configFileName, tableArrayJson, "table", i);
+
+                if (!ctx->isDisableChecksSet(Ctx::DISABLE_CHECKS::JSON_TAGS)) {
+                    static const std::vector<std::string> tableNames{"owner", "table", "sample"};
+                    Ctx::checkJsonFields(configFileName, tableJson, tableNames);
+                }
+
+                TableRule rule{Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, tableJson, "owner"),
+                               Ctx::getJsonFieldS(configFileName, Ctx::JSON_PARAMETER_LENGTH, tableJson, "table"),
+                               Ctx::getJsonFieldU64(configFileName, tableJson, "sample")};
+                if (rule.sample == 0)
+                    throw ConfigurationException(30001, "bad JSON, invalid \"sample\" value: 0 for table: " + rule.owner + "." + rule.table +
+                                                        ", expected: at least 1");
+                newRules.push_back(std::move(rule));
+            }
+        }
+
+        sample = newSample;
+        {
+            std::unique_lock<std::mutex> const lck(rulesMtx);
+            rules.swap(newRules);
+            tableRules = !rules.empty();
+        }
+        ++rulesVersion;
+    }
+
+    // The first matching rule wins, 0 when no rule matches the table
+    uint64_t Tracer::tableSample(const DbTable* table) const {
+        std::unique_lock<std::mutex> const lck(rulesMtx);
+        for (const TableRule& rule: rules) {
+            const std::regex regexOwner(rule.owner);
+            const std::regex regexTable(rule.table);
+            if (std::regex_match(table->owner, regexOwner) && std::regex_match(table->name, regexTable))
+                return rule.sample;
+        }
+        return 0;
+    }
+
+    // Called with mtx held
+    void Tracer::queueTrace(const Trace& trace) {
+        if (queue.size() >= QUEUE_MAX_TRACES) {
+            ++tracesDropped;
+            return;
+        }
+        queue.push_back(trace);
+        if (queue.size() >= EXPORT_BATCH_TRACES)
+            condLoop.notify_all();
+    }
+
+    // Called by the builder once the transaction is built, the trace is complete when the writer confirms its last message
+    void Tracer::built(Thread* t, const Trace& trace) {
+        t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::TRACER);
+        {
+            std::unique_lock<std::mutex> const lck(mtx);
+            if (trace.messages == 0) {
+                queueTrace(trace);
+            } else {
+                lastBuiltId = trace.lastMessageId;
+                const auto& it = confirmedEarly.find(trace.lastMessageId);
+                if (it != confirmedEarly.end()) {
+                    Trace complete(trace);
+                    complete.confirmUt = it->second;
+                    queueTrace(complete);
+                } else {
+                    pending.insert_or_assign(trace.lastMessageId, trace);
+                    if (pending.size() > PENDING_MAX_TRACES) {
+                        queueTrace(pending.begin()->second);
+                        pending.erase(pending.begin());
+                    }
+                }
+
+                for (auto early = confirmedEarly.begin(); early != confirmedEarly.end();) {
+                    if (early->first <= trace.lastMessageId)
+                        early = confirmedEarly.erase(early);
+                    else
+                        ++early;
+                }
+            }
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
+    }
+
+    // Called by the writer for every confirmed message of a traced transaction. Messages past the last built transaction belong to one
+    // which is still being built and are kept until it ends
+    void Tracer::confirmed(Thread* t, uint64_t messageId, time_ut confirmUt) {
+        t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::TRACER);
+        {
+            std::unique_lock<std::mutex> const lck(mtx);
+            const auto& it = pending.find(messageId);
+            if (it != pending.end()) {
+                it->second.confirmUt = confirmUt;
+                queueTrace(it->second);
+                pending.erase(it);
+            } else if (messageId > lastBuiltId) {
+                if (confirmedEarly.size() >= PENDING_MAX_TRACES)
+                    confirmedEarly.clear();
+                confirmedEarly.insert_or_assign(messageId, confirmUt);
+            }
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
+    }
+
+    std::string Tracer::hex(uint64_t value) {
+        static constexpr char digits[]{"0123456789abcdef"};
+        std::string str(16, '0');
+        for (int i = 15; i >= 0; --i) {
+            str[i] = digits[value & 0xF];
+            value >>= 4;
+        }
+        return str;
+    }
+
+    void Tracer::appendSpan(std::ostringstream& ss, const std::string& traceId, uint64_t spanId, uint64_t parentId, const char* name,
+                            time_ut startUt, time_ut endUt, const Trace& trace, bool& firstSpan) const {
+        if (!firstSpan)
+            ss << ',';
+        firstSpan = false;
+        ss << R"({"traceId":")" << traceId << R"(","spanId":")" << hex(spanId) << '"';
+        if (parentId != 0)
+            ss << R"(,"parentSpanId":")" << hex(parentId) << '"';
+        ss << R"(,"name":")" << name << R"(","kind":1,"startTimeUnixNano":")" << static_cast<uint64_t>(startUt) * 1000 <<
+           R"(","endTimeUnixNano":")" << static_cast<uint64_t>(std::max(startUt, endUt)) * 1000 << '"';
+        // The attributes of the transaction are only on the root span
+        if (parentId == 0)
+            ss << R"(,"attributes":[{"key":"olr.xid","value":{"stringValue":")" << trace.xid.toString() <<
+               R"("}},{"key":"olr.commit_scn","value":{"intValue":")" << trace.commitScn.getData() <<
+               R"("}},{"key":"olr.messages","value":{"intValue":")" << trace.messages << R"("}}])";
+        ss << '}';
+    }
+
+    void Tracer::exportTraces(hv::HttpClient& client, const std::vector<Trace>& traces, uint64_t first, uint64_t count) {
+        std::ostringstream ss;
+        ss << R"({"resourceSpans":[{"resource":{"attributes":[)" << resource << R"(]},"scopeSpans":[{"scope":{"name":"OpenLogReplicator"},"spans":[)";
+        bool firstSpan = true;
+        for (uint64_t i = first; i < first + count; ++i) {
+            const Trace& trace = traces[i];
+            const std::string traceId = traceIdPrefix + hex(trace.xid.getData());
+            const uint64_t rootId = ++spanSequence;
+            const time_ut endUt = trace.confirmUt != 0 ? trace.confirmUt : trace.flushEndUt;
+
+            appendSpan(ss, traceId, rootId, 0, "transaction", trace.beginUt, endUt, trace, firstSpan);
+            if (trace.commitUt != 0)
+                appendSpan(ss, traceId, ++spanSequence, rootId, "redo", trace.beginUt, trace.commitUt, trace, firstSpan);
+            if (trace.commitUt != 0)
+                appendSpan(ss, traceId, ++spanSequence, rootId, "queue", trace.commitUt, trace.flushUt, trace, firstSpan);
+            appendSpan(ss, traceId, ++spanSequence, rootId, "flush", trace.flushUt, trace.flushEndUt, trace, firstSpan);
+            if (trace.messages > 0)
+                appendSpan(ss, traceId, ++spanSequence, rootId, "build", trace.buildFirstUt, trace.buildLastUt, trace, firstSpan);
+            if (trace.confirmUt != 0)
+                appendSpan(ss, traceId, ++spanSequence, rootId, "confirm", trace.buildLastUt, trace.confirmUt, trace, firstSpan);
+        }
+        ss << "]}]}]}";
+
+        HttpRequest httpRequest;
+        httpRequest.method = HTTP_POST;
+        httpRequest.url = endpoint;
+        httpRequest.timeout = EXPORT_TIMEOUT_S;
+        httpRequest.headers["Content-Type"] = "application/json";
+        httpRequest.body = ss.str();
+
+        HttpResponse httpResponse;
+        contextSet(Thread::CONTEXT::OS, Thread::REASON::OS);
+        const int ret = client.send(&httpRequest, &httpResponse);
+        contextSet(Thread::CONTEXT::CPU);
+        if (ret != 0 || httpResponse.status_code < 200 || httpResponse.status_code >= 300) {
+            tracesDropped += count;
+            // Reported once until an export succeeds again
+            if (!exportFailing)
+                ctx->warning(60066, "tracing: " + endpoint + " - export of " + std::to_string(count) + " traces returned: " +
+                                    (ret != 0 ? "error " + std::to_string(ret) : "status " + std::to_string(httpResponse.status_code)));
+            exportFailing = true;
+            return;
+        }
+        if (exportFailing)
+            ctx->info(0, "tracing: " + endpoint + " - export resumed");
+        exportFailing = false;
+        tracesExported += count;
+    }
+
+    void Tracer::run() {
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
+            std::ostringstream ss;
+            ss << std::this_thread::get_id();
+            ctx->logTrace(Ctx::TRACE::THREADS, "tracer (" + ss.str() + ") start");
+        }
+
+        hv::HttpClient client;
+        std::vector<Trace> traces;
+        while (true) {
+            bool shutdown;
+            {
+                contextSet(CONTEXT::MUTEX, REASON::TRACER);
+                std::unique_lock<std::mutex> lck(mtx);
+                if (queue.size() < EXPORT_BATCH_TRACES && !ctx->softShutdown) {
+                    contextSet(CONTEXT::WAIT, REASON::TRACER_NO_WORK);
+                    condLoop.wait_for(lck, std::chrono::milliseconds(intervalMs));
+                }
+                shutdown = ctx->softShutdown;
+                // Traces still waiting for the writer are sent without the confirmation at shutdown
+                if (shutdown) {
+                    for (const auto& [_, trace]: pending)
+                        queue.push_back(trace);
+                    pending.clear();
+                }
+                traces.swap(queue);
+            }
+            contextSet(CONTEXT::CPU);
+
+            for (uint64_t first = 0; first < traces.size() && !ctx->hardShutdown; first += EXPORT_BATCH_TRACES)
+                exportTraces(client, traces, first, std::min<uint64_t>(EXPORT_BATCH_TRACES, traces.size() - first));
+            traces.clear();
+
+            if (shutdown)
+                break;
+        }
+
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
+            std::ostringstream ss;
+            ss << std::this_thread::get_id();
+            ctx->logTrace(Ctx::TRACE::THREADS, "tracer (" + ss.str() + ") stop");
+        }
+    }
+}
@@ -0,0 +1,137 @@
+/* Header for Tracer class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef TRACER_H_
+#define TRACER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <rapidjson/document.h>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Thread.h"
+#include "types/Scn.h"
+#include "types/Types.h"
+#include "types/Xid.h"
+
+namespace hv {
+    class HttpClient;
+}
+
+namespace OpenLogReplicator {
+    class DbTable;
+
+    // Sampled transactions are followed from their first redo record to the confirmation of their last message by the writer. The pipeline
+    // threads only note the times, the spans are made from them and exported in batches over OTLP/HTTP with JSON encoding by this thread
+    class Tracer final : public Thread {
+    public:
+        // Times of one sampled transaction, 0 for a stage it did not pass
+        struct Trace {
+            Xid xid;
+            Scn commitScn{Scn::none()};
+            time_ut beginUt{0};
+            time_ut commitUt{0};
+            time_ut flushUt{0};
+            time_ut flushEndUt{0};
+            time_ut buildFirstUt{0};
+            time_ut buildLastUt{0};
+            time_ut confirmUt{0};
+            uint64_t messages{0};
+            uint64_t firstMessageId{0};
+            uint64_t lastMessageId{0};
+        };
+
+    protected:
+        static constexpr uint64_t EXPORT_BATCH_TRACES{256};
+        static constexpr uint64_t QUEUE_MAX_TRACES{4096};
+        // Traces waiting for the confirmation of their last message, the oldest are exported without it when there are more
+        static constexpr uint64_t PENDING_MAX_TRACES{4096};
+        static constexpr uint16_t EXPORT_TIMEOUT_S{5};
+
+        struct TableRule {
+            std::string owner;
+            std::string table;
+            uint64_t sample;
+        };
+
+        std::string endpoint;
+        uint64_t intervalMs;
+        std::string traceIdPrefix;
+        std::string resource;
+        std::mutex mtx;
+        std::condition_variable condLoop;
+        std::vector<Trace> queue;
+        std::map<uint64_t, Trace> pending;
+        // Traced messages confirmed before the end of their transaction was known, by message id
+        std::unordered_map<uint64_t, time_ut> confirmedEarly;
+        mutable std::mutex rulesMtx;
+        std::vector<TableRule> rules;
+        // Only used by the parser thread
+        uint64_t sampleCnt{0};
+        // Id of the last message of the last built transaction
+        uint64_t lastBuiltId{0};
+        // Only used by the tracer thread
+        uint64_t spanSequence;
+        bool exportFailing{false};
+
+        void run() override;
+        void queueTrace(const Trace& trace);
+        void exportTraces(hv::HttpClient& client, const std::vector<Trace>& traces, uint64_t first, uint64_t count);
+        void appendSpan(std::ostringstream& ss, const std::string& traceId, uint64_t spanId, uint64_t parentId, const char* name, time_ut startUt,
+                        time_ut endUt, const Trace& trace, bool& firstSpan) const;
+        [[nodiscard]] static std::string hex(uint64_t value);
+
+    public:
+        // One in that many transactions is traced, 0 - only the transactions sampled by the table rules
+        std::atomic<uint64_t> sample{0};
+        // Raised when the table rules change, the parser looks the rates of the tables up again
+        std::atomic<uint64_t> rulesVersion{0};
+        std::atomic<bool> tableRules{false};
+        std::atomic<uint64_t> tracesExported{0};
+        std::atomic<uint64_t> tracesDropped{0};
+
+        Tracer(Ctx* newCtx, std::string newAlias, std::string newEndpoint, const std::string& database, uint64_t newIntervalMs);
+
+        void wakeUp() override;
+        void configure(const std::string& configFileName, const rapidjson::Value& tracingJson);
+        [[nodiscard]] uint64_t tableSample(const DbTable* table) const;
+        void built(Thread* t, const Trace& trace);
+        void confirmed(Thread* t, uint64_t messageId, time_ut confirmUt);
+
+        // Called by the parser thread for every new transaction
+        [[nodiscard]] bool sampled() {
+            const uint64_t rate = sample.load(std::memory_order_relaxed);
+            if (rate == 0 || ++sampleCnt < rate)
+                return false;
+            sampleCnt = 0;
+            return true;
+        }
+
+        std::string getName() const override {
+            return {"Tracer: " + alias};
+        }
+    };
+}
+
+#endif
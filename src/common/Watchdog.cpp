@@ -0,0 +1,191 @@
+/* Thread detecting stalls of the pipeline
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <algorithm>
+#include <csignal>
+#include <execinfo.h>
+#include <thread>
+#include <unistd.h>
+
+#include "Watchdog.h"
+#include "metrics/Metrics.h"
+
+namespace OpenLogReplicator {
+    Watchdog::Watchdog(Ctx* newCtx, std::string newAlias) :
+            Thread(newCtx, std::move(newAlias)) {
+    }
+
+    void Watchdog::wakeUp() {
+        std::unique_lock<std::mutex> const lck(mtx);
+        condLoop.notify_all();
+    }
+
+    int Watchdog::sampleSignal() {
+        return SIGRTMIN + 1;
+    }
+
+    // A stage is stalled when it has input and neither its scn nor its output moved, reported once per stall
+    bool Watchdog::stalled(Stage& stage, uint64_t scn, uint64_t in, uint64_t out, time_t now) {
+        if (in <= out || scn != stage.scn || out != stage.out || stage.since == 0) {
+            stage.scn = scn;
+            stage.out = out;
+            stage.since = now;
+            stage.reported = false;
+            return false;
+        }
+        return !stage.reported && now - stage.since >= static_cast<time_t>(ctx->stallTimeoutS);
+    }
+
+    // The threads take their own stack in the signal handler, a thread not answering in time is reported without a stack
+    void Watchdog::sample(std::map<std::string, ThreadSamples>& samples) {
+        ctx->forEachThread([&](const Thread* thread) {
+            if (thread == this || thread->finished)
+                return;
+
+            ThreadSamples& threadSamples = samples[thread->alias];
+            threadSamples.contexts.push_back(Thread::contextNames[static_cast<uint>(thread->curContext)] + "/" +
+                                             std::to_string(static_cast<uint>(thread->curReason)));
+
+            std::vector<void*> stack;
+            const uint64_t taken = thread->stackSamples.load(std::memory_order_acquire);
+            if (pthread_kill(thread->pthread, sampleSignal()) == 0) {
+                for (uint64_t waited = 0; waited < SAMPLE_WAIT_US; waited += 100) {
+                    if (thread->stackSamples.load(std::memory_order_acquire) != taken) {
+                        const int size = thread->stackSize.load(std::memory_order_relaxed);
+                        for (int frame = STACK_SKIP; frame < size && frame < STACK_SKIP + STACK_PRINT; ++frame)
+                            stack.push_back(thread->stackFrames[frame]);
+                        break;
+                    }
+                    usleep(100);
+                }
+            }
+            threadSamples.stacks.push_back(std::move(stack));
+        });
+    }
+
+    void Watchdog::report(const Stage& stage, time_t now) {
+        ctx->warning(60052, std::string("stall: ") + stage.name + " made no progress for " + std::to_string(now - stage.since) +
+                            "s, lwn scn: " + Scn(RuntimeStats::get(ctx->stats.lwnScn)).toString() +
+                            " confirmed scn: " + Scn(RuntimeStats::get(ctx->stats.confirmedScn)).toString() +
+                            ", sampling stacks " + std::to_string(ctx->stallSamples) + " times");
+        if (ctx->metrics != nullptr)
+            ctx->metrics->emitStalls(1);
+
+        std::map<std::string, ThreadSamples> samples;
+        for (uint64_t num = 0; num < ctx->stallSamples; ++num) {
+            if (num > 0)
+                usleep(SAMPLE_INTERVAL_US);
+            sample(samples);
+        }
+
+        for (const auto& [name, threadSamples]: samples) {
+            std::string msg = "stall: " + name + " contexts:";
+            for (const std::string& context: threadSamples.contexts) {
+                msg += " " + context;
+                if (ctx->metrics != nullptr)
+                    ctx->metrics->emitStallSamples(name, context.substr(0, context.find('/')), 1);
+            }
+
+            // Identical stacks are printed once with the number of samples
+            std::vector<std::pair<const std::vector<void*>*, uint64_t>> distinct;
+            for (const std::vector<void*>& stack: threadSamples.stacks) {
+                auto it = std::find_if(distinct.begin(), distinct.end(), [&stack](const auto& entry) {
+                    return *entry.first == stack;
+                });
+                if (it == distinct.end())
+                    distinct.emplace_back(&stack, 1);
+                else
+                    ++it->second;
+            }
+
+            for (const auto& [stack, count]: distinct) {
+                msg += "\n  stack x" + std::to_string(count) + ":";
+                if (stack->empty()) {
+                    msg += " not sampled";
+                    continue;
+                }
+                char** symbols = backtrace_symbols(stack->data(), static_cast<int>(stack->size()));
+                if (symbols == nullptr) {
+                    msg += " no symbols";
+                    continue;
+                }
+                for (size_t frame = 0; frame < stack->size(); ++frame)
+                    msg += "\n    " + std::string(symbols[frame]);
+                free(symbols);
+            }
+            ctx->warning(60052, msg);
+        }
+
+        ctx->dumpFlightRecorder(std::string(stage.name) + " stall");
+    }
+
+    void Watchdog::run() {
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
+            std::ostringstream ss;
+            ss << std::this_thread::get_id();
+            ctx->logTrace(Ctx::TRACE::THREADS, "watchdog (" + ss.str() + ") start");
+        }
+
+        static std::once_flag signalInstalled;
+        std::call_once(signalInstalled, [] {
+            // The first call loads the unwinder, which must not happen in the signal handler
+            void* frames[1];
+            backtrace(frames, 1);
+
+            struct sigaction action{};
+            action.sa_handler = Thread::sampleStack;
+            sigemptyset(&action.sa_mask);
+            action.sa_flags = SA_RESTART;
+            sigaction(sampleSignal(), &action, nullptr);
+        });
+
+        while (!ctx->softShutdown) {
+            {
+                std::unique_lock<std::mutex> lck(mtx);
+                if (!ctx->softShutdown) {
+                    if (unlikely(ctx->isTraceSet(Ctx::TRACE::SLEEP)))
+                        ctx->logTrace(Ctx::TRACE::SLEEP, "Watchdog:run");
+                    contextSet(CONTEXT::WAIT, REASON::WATCHDOG_NO_WORK);
+                    condLoop.wait_for(lck, std::chrono::microseconds(CHECK_INTERVAL_US));
+                }
+            }
+            contextSet(CONTEXT::CPU);
+            if (ctx->softShutdown)
+                break;
+
+            const time_t now = ctx->contextClock.getTimeT();
+            const RuntimeStats& stats = ctx->stats;
+            if (stalled(parser, RuntimeStats::get(stats.lwnScn), RuntimeStats::get(stats.bytesRead), RuntimeStats::get(stats.bytesParsed), now)) {
+                report(parser, now);
+                parser.reported = true;
+            }
+            if (stalled(writer, RuntimeStats::get(stats.confirmedScn), RuntimeStats::get(stats.messagesBuilt),
+                        RuntimeStats::get(stats.messagesConfirmed), now)) {
+                report(writer, now);
+                writer.reported = true;
+            }
+        }
+
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
+            std::ostringstream ss;
+            ss << std::this_thread::get_id();
+            ctx->logTrace(Ctx::TRACE::THREADS, "watchdog (" + ss.str() + ") stop");
+        }
+    }
+}
@@ -0,0 +1,79 @@
+/* Header for Watchdog class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef WATCHDOG_H_
+#define WATCHDOG_H_
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Thread.h"
+
+namespace OpenLogReplicator {
+    // Detects a parser or writer making no progress while it has input and reports where the threads are at that point.
+    // Only reads the progress counters, so the replication threads pay nothing until their stacks are sampled
+    class Watchdog final : public Thread {
+    protected:
+        static constexpr uint64_t CHECK_INTERVAL_US{1000000};
+        static constexpr uint64_t SAMPLE_INTERVAL_US{100000};
+        static constexpr uint64_t SAMPLE_WAIT_US{20000};
+        // Frames of the signal handler itself
+        static constexpr int STACK_SKIP{2};
+        static constexpr int STACK_PRINT{16};
+
+        // Progress of one stage, out is the cumulative counter of its output
+        struct Stage {
+            const char* name;
+            uint64_t scn{0};
+            uint64_t out{0};
+            time_t since{0};
+            bool reported{false};
+        };
+
+        struct ThreadSamples {
+            std::vector<std::string> contexts;
+            std::vector<std::vector<void*>> stacks;
+        };
+
+        std::mutex mtx;
+        std::condition_variable condLoop;
+        Stage parser{"parser"};
+        Stage writer{"writer"};
+
+        void run() override;
+        bool stalled(Stage& stage, uint64_t scn, uint64_t in, uint64_t out, time_t now);
+        void sample(std::map<std::string, ThreadSamples>& samples);
+        void report(const Stage& stage, time_t now);
+        static int sampleSignal();
+
+    public:
+        Watchdog(Ctx* newCtx, std::string newAlias);
+
+        void wakeUp() override;
+
+        std::string getName() const override {
+            return {"Watchdog: " + alias};
+        }
+    };
+}
+
+#endif
@@ -19,6 +19,7 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 
 #include "XmlCtx.h"
 
+#include <algorithm>
 #include <utility>
 
 namespace OpenLogReplicator {
@@ -37,4 +38,77 @@ namespace OpenLogReplicator {
         xdbXQnPack.clear(ctx);
         xdbXPtPack.clear(ctx);
     }
+
+    // Ids are stored as hexadecimal text
+    bool XmlCtx::parseId(const std::string& id, uint64_t& value) {
+        if (id.empty() || id.length() > 16)
+            return false;
+
+        value = 0;
+        for (const char c: id) {
+            value <<= 4;
+            if (c >= '0' && c <= '9')
+                value |= static_cast<uint64_t>(c - '0');
+            else if (c >= 'A' && c <= 'F')
+                value |= static_cast<uint64_t>(c - 'A' + 10);
+            else if (c >= 'a' && c <= 'f')
+                value |= static_cast<uint64_t>(c - 'a' + 10);
+            else
+                return false;
+        }
+        return true;
+    }
+
+    void XmlCtx::buildQnTokens() const {
+        qnDense.clear();
+        qnSparse.clear();
+
+        for (const auto& [_, xdbXQn]: xdbXQnPack.unorderedMapKey) {
+            uint64_t code;
+            if (!parseId(xdbXQn->id, code))
+                continue;
+
+            QnToken token;
+            token.qn = xdbXQn;
+            if (!parseId(xdbXQn->nmSpcId, token.nmSpc))
+                token.nmSpc = NMSPC_NONE;
+            if (!xdbXQn->flags.empty())
+                token.attribute = (((xdbXQn->flags.back() - '0') & XdbXQn::FLAG_ISATTRIBUTE) != 0);
+
+            if (code < TOKENS_DENSE) {
+                if (code >= qnDense.size())
+                    qnDense.resize(code + 1);
+                qnDense[code] = token;
+            } else
+                qnSparse.emplace_back(code, token);
+        }
+
+        std::sort(qnSparse.begin(), qnSparse.end(), [](const std::pair<uint64_t, QnToken>& a, const std::pair<uint64_t, QnToken>& b) {
+            return a.first < b.first;
+        });
+        qnVersion = xdbXQnPack.version;
+    }
+
+    void XmlCtx::buildNmTokens() const {
+        nmDense.clear();
+        nmSparse.clear();
+
+        for (const auto& [_, xdbXNm]: xdbXNmPack.unorderedMapKey) {
+            uint64_t id;
+            if (!parseId(xdbXNm->id, id))
+                continue;
+
+            if (id < TOKENS_DENSE) {
+                if (id >= nmDense.size())
+                    nmDense.resize(id + 1, nullptr);
+                nmDense[id] = xdbXNm;
+            } else
+                nmSparse.emplace_back(id, xdbXNm);
+        }
+
+        std::sort(nmSparse.begin(), nmSparse.end(), [](const std::pair<uint64_t, const XdbXNm*>& a, const std::pair<uint64_t, const XdbXNm*>& b) {
+            return a.first < b.first;
+        });
+        nmVersion = xdbXNmPack.version;
+    }
 }
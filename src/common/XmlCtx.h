@@ -20,8 +20,11 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #ifndef XML_CTX_H_
 #define XML_CTX_H_
 
+#include <algorithm>
 #include <map>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "../common/Ctx.h"
 #include "../common/table/TablePack.h"
@@ -34,6 +37,31 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 namespace OpenLogReplicator {
 
     class XmlCtx final {
+    public:
+        // Tag or attribute name of the binary XML, resolved once per dictionary change instead of formatting and hashing the id per node
+        struct QnToken {
+            const XdbXQn* qn{nullptr};
+            uint64_t nmSpc{NMSPC_NONE};
+            bool attribute{false};
+        };
+
+        static constexpr uint64_t NMSPC_NONE{0xFFFFFFFFFFFFFFFF};
+
+    protected:
+        // Ids below are looked up by index, the rest by binary search
+        static constexpr uint64_t TOKENS_DENSE{0x10000};
+
+        mutable std::vector<QnToken> qnDense;
+        mutable std::vector<std::pair<uint64_t, QnToken>> qnSparse;
+        mutable uint64_t qnVersion{0xFFFFFFFFFFFFFFFF};
+        mutable std::vector<const XdbXNm*> nmDense;
+        mutable std::vector<std::pair<uint64_t, const XdbXNm*>> nmSparse;
+        mutable uint64_t nmVersion{0xFFFFFFFFFFFFFFFF};
+
+        static bool parseId(const std::string& id, uint64_t& value);
+        void buildQnTokens() const;
+        void buildNmTokens() const;
+
     public:
         TablePack<XdbXNm, TabRowIdKeyDefault, XdbXNmKey> xdbXNmPack;
         TablePack<XdbXQn, TabRowIdKeyDefault, XdbXQnKey> xdbXQnPack;
@@ -47,6 +75,36 @@ namespace OpenLogReplicator {
         ~XmlCtx();
 
         void purgeDicts() noexcept;
+
+        [[nodiscard]] const QnToken* qnToken(uint64_t code) const {
+            if (unlikely(qnVersion != xdbXQnPack.version))
+                buildQnTokens();
+
+            if (code < qnDense.size())
+                return qnDense[code].qn != nullptr ? &qnDense[code] : nullptr;
+
+            auto it = std::lower_bound(qnSparse.begin(), qnSparse.end(), code, [](const std::pair<uint64_t, QnToken>& token, uint64_t value) {
+                return token.first < value;
+            });
+            if (it == qnSparse.end() || it->first != code)
+                return nullptr;
+            return &it->second;
+        }
+
+        [[nodiscard]] const XdbXNm* nmToken(uint64_t id) const {
+            if (unlikely(nmVersion != xdbXNmPack.version))
+                buildNmTokens();
+
+            if (id < nmDense.size())
+                return nmDense[id];
+
+            auto it = std::lower_bound(nmSparse.begin(), nmSparse.end(), id, [](const std::pair<uint64_t, const XdbXNm*>& token, uint64_t value) {
+                return token.first < value;
+            });
+            if (it == nmSparse.end() || it->first != id)
+                return nullptr;
+            return it->second;
+        }
     };
 }
 #endif
@@ -67,6 +67,13 @@ namespace OpenLogReplicator {
 
             case VALUE::OPERATOR_NOT_EQUAL:
                 return (left->evaluateToString(op, attributes) != right->evaluateToString(op, attributes));
+
+            // Only valid for column values, evaluated by the compiled Condition
+            case VALUE::OPERATOR_LESS:
+            case VALUE::OPERATOR_LESS_EQUAL:
+            case VALUE::OPERATOR_GREATER:
+            case VALUE::OPERATOR_GREATER_EQUAL:
+                break;
         }
         throw RuntimeException(50066, "invalid expression evaluation: invalid bool type");
     }
@@ -26,7 +26,8 @@ namespace OpenLogReplicator {
     class BoolValue : public Expression {
     public:
         enum class VALUE : unsigned char {
-            FALSE, TRUE, OPERATOR_AND, OPERATOR_OR, OPERATOR_NOT, OPERATOR_EQUAL, OPERATOR_NOT_EQUAL
+            FALSE, TRUE, OPERATOR_AND, OPERATOR_OR, OPERATOR_NOT, OPERATOR_EQUAL, OPERATOR_NOT_EQUAL, OPERATOR_LESS, OPERATOR_LESS_EQUAL,
+            OPERATOR_GREATER, OPERATOR_GREATER_EQUAL
         };
 
     protected:
@@ -42,6 +43,8 @@ namespace OpenLogReplicator {
 
         bool evaluateToBool(char op, const std::unordered_map<std::string, std::string>* attributes) override;
         std::string evaluateToString(char op, const std::unordered_map<std::string, std::string>* attributes) override;
+
+        friend class Condition;
     };
 }
 
@@ -0,0 +1,562 @@
+/* Condition expressions compiled for evaluation
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+#include "../../locales/CharacterSet.h"
+#include "../../locales/Locales.h"
+#include "../DbColumn.h"
+#include "../DbTable.h"
+#include "../exception/RuntimeException.h"
+#include "BoolValue.h"
+#include "Condition.h"
+#include "StringValue.h"
+
+namespace OpenLogReplicator {
+    std::atomic<uint64_t> ConditionContext::transactionNext{0};
+
+    Condition::Condition(const std::string& newCondition, const BoolValue* root, const DbTable* newTable, const Locales* newLocales) :
+            condition(newCondition),
+            table(newTable),
+            locales(newLocales) {
+        compileBool(root);
+    }
+
+    // Attribute names share one slot numbering, so the values of a transaction are looked up once for all tables
+    uint32_t Condition::internAttribute(const std::string& name) {
+        static std::mutex mtx;
+        static std::unordered_map<std::string, uint32_t> slots;
+
+        std::unique_lock<std::mutex> const lck(mtx);
+        auto slotsIt = slots.find(name);
+        if (slotsIt != slots.end())
+            return slotsIt->second;
+        const auto slot = static_cast<uint32_t>(slots.size());
+        slots.insert_or_assign(name, slot);
+        return slot;
+    }
+
+    // Oracle NUMBER: base-100 exponent and digits, the format is designed to be ordered by byte comparison
+    bool Condition::encodeNumber(const std::string& text, std::string& out) {
+        uint64_t i = 0;
+        bool negative = false;
+        if (i < text.length() && (text[i] == '-' || text[i] == '+')) {
+            negative = text[i] == '-';
+            ++i;
+        }
+
+        // Value is 0.digits * 10^exponent
+        std::string digits;
+        int64_t exponent = 0;
+        bool dot = false;
+        bool any = false;
+        for (; i < text.length() && text[i] != 'e' && text[i] != 'E'; ++i) {
+            if (text[i] == '.') {
+                if (dot)
+                    return false;
+                dot = true;
+                continue;
+            }
+            if (text[i] < '0' || text[i] > '9')
+                return false;
+            any = true;
+            if (text[i] == '0' && digits.empty()) {
+                if (dot)
+                    --exponent;
+                continue;
+            }
+            digits.push_back(text[i]);
+            if (!dot)
+                ++exponent;
+        }
+        if (!any)
+            return false;
+
+        if (i < text.length()) {
+            ++i;
+            bool exponentNegative = false;
+            if (i < text.length() && (text[i] == '-' || text[i] == '+')) {
+                exponentNegative = text[i] == '-';
+                ++i;
+            }
+            if (i == text.length())
+                return false;
+            int64_t exponentValue = 0;
+            for (; i < text.length(); ++i) {
+                if (text[i] < '0' || text[i] > '9' || exponentValue > 1000)
+                    return false;
+                exponentValue = exponentValue * 10 + (text[i] - '0');
+            }
+            exponent += exponentNegative ? -exponentValue : exponentValue;
+        }
+
+        while (!digits.empty() && digits.back() == '0')
+            digits.pop_back();
+
+        out.clear();
+        if (digits.empty()) {
+            out.push_back(static_cast<char>(0x80));
+            return true;
+        }
+
+        // Align to base-100 digits
+        if ((exponent & 1) != 0) {
+            digits.insert(digits.begin(), '0');
+            ++exponent;
+        }
+        if ((digits.length() & 1) != 0)
+            digits.push_back('0');
+        if (digits.length() > 40)
+            return false;
+
+        const int64_t exponent100 = exponent / 2;
+        if (exponent100 < -63 || exponent100 > 63)
+            return false;
+
+        const auto exponentByte = static_cast<uint8_t>(0xC0 + exponent100);
+        out.push_back(static_cast<char>(negative ? static_cast<uint8_t>(~exponentByte) : exponentByte));
+        for (uint64_t j = 0; j < digits.length(); j += 2) {
+            const int value = (digits[j] - '0') * 10 + (digits[j + 1] - '0');
+            out.push_back(static_cast<char>(negative ? 101 - value : value + 1));
+        }
+        if (negative && out.length() < 21)
+            out.push_back(static_cast<char>(0x66));
+        return true;
+    }
+
+    // Oracle DATE and TIMESTAMP: YYYY-MM-DD[ HH:MI:SS[.FFFFFFFFF]], the fraction is not present when zero
+    bool Condition::encodeDate(const std::string& text, bool fraction, std::string& out) {
+        uint64_t i = 0;
+        auto number = [&text, &i](uint64_t length, uint64_t& value) -> bool {
+            value = 0;
+            for (uint64_t j = 0; j < length; ++j, ++i) {
+                if (i >= text.length() || text[i] < '0' || text[i] > '9')
+                    return false;
+                value = value * 10 + (text[i] - '0');
+            }
+            return true;
+        };
+        auto separator = [&text, &i](char c) -> bool {
+            if (i >= text.length() || text[i] != c)
+                return false;
+            ++i;
+            return true;
+        };
+
+        uint64_t year;
+        uint64_t month;
+        uint64_t day;
+        uint64_t hour = 0;
+        uint64_t minute = 0;
+        uint64_t second = 0;
+        uint64_t nanosecond = 0;
+        if (!number(4, year) || !separator('-') || !number(2, month) || !separator('-') || !number(2, day))
+            return false;
+        if (i < text.length()) {
+            if ((text[i] != ' ' && text[i] != 'T') || (++i, !number(2, hour)) || !separator(':') || !number(2, minute) || !separator(':') ||
+                !number(2, second))
+                return false;
+            if (i < text.length()) {
+                if (!fraction || !separator('.') || i == text.length())
+                    return false;
+                uint64_t digits = 0;
+                for (; i < text.length(); ++i, ++digits) {
+                    if (text[i] < '0' || text[i] > '9' || digits == 9)
+                        return false;
+                    nanosecond = nanosecond * 10 + (text[i] - '0');
+                }
+                for (; digits < 9; ++digits)
+                    nanosecond *= 10;
+            }
+        }
+        if (year == 0 || month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 59)
+            return false;
+
+        out.clear();
+        out.push_back(static_cast<char>(year / 100 + 100));
+        out.push_back(static_cast<char>(year % 100 + 100));
+        out.push_back(static_cast<char>(month));
+        out.push_back(static_cast<char>(day));
+        out.push_back(static_cast<char>(hour + 1));
+        out.push_back(static_cast<char>(minute + 1));
+        out.push_back(static_cast<char>(second + 1));
+        if (nanosecond != 0) {
+            out.push_back(static_cast<char>(nanosecond >> 24));
+            out.push_back(static_cast<char>((nanosecond >> 16) & 0xFF));
+            out.push_back(static_cast<char>((nanosecond >> 8) & 0xFF));
+            out.push_back(static_cast<char>(nanosecond & 0xFF));
+        }
+        return true;
+    }
+
+    bool Condition::encodeRaw(const std::string& text, std::string& out) {
+        if ((text.length() & 1) != 0)
+            return false;
+
+        auto nibble = [](char c) -> int {
+            if (c >= '0' && c <= '9')
+                return c - '0';
+            if (c >= 'A' && c <= 'F')
+                return c - 'A' + 10;
+            if (c >= 'a' && c <= 'f')
+                return c - 'a' + 10;
+            return -1;
+        };
+
+        out.clear();
+        for (uint64_t i = 0; i < text.length(); i += 2) {
+            const int high = nibble(text[i]);
+            const int low = nibble(text[i + 1]);
+            if (high < 0 || low < 0)
+                return false;
+            out.push_back(static_cast<char>((high << 4) | low));
+        }
+        return true;
+    }
+
+    // The condition text is UTF-8, other character sets accept constants which are plain ASCII on both sides
+    bool Condition::encodeString(const std::string& text, uint64_t charsetId, std::string& out) const {
+        out.clear();
+        if (charsetId == 871 || charsetId == 873 || charsetId == 2000) {
+            uint64_t i = 0;
+            while (i < text.length()) {
+                const auto byte1 = static_cast<uint8_t>(text[i]);
+                uint64_t length;
+                typeUnicode character;
+                if (byte1 < 0x80) {
+                    length = 1;
+                    character = byte1;
+                } else if ((byte1 & 0xE0) == 0xC0) {
+                    length = 2;
+                    character = byte1 & 0x1F;
+                } else if ((byte1 & 0xF0) == 0xE0) {
+                    length = 3;
+                    character = byte1 & 0x0F;
+                } else if ((byte1 & 0xF8) == 0xF0) {
+                    length = 4;
+                    character = byte1 & 0x07;
+                } else
+                    return false;
+
+                if (i + length > text.length())
+                    return false;
+                for (uint64_t j = 1; j < length; ++j) {
+                    const auto byteN = static_cast<uint8_t>(text[i + j]);
+                    if ((byteN & 0xC0) != 0x80)
+                        return false;
+                    character = (character << 6) | (byteN & 0x3F);
+                }
+
+                if (charsetId == 2000) {
+                    if (character >= 0x10000) {
+                        const typeUnicode high = 0xD800 + ((character - 0x10000) >> 10);
+                        const typeUnicode low = 0xDC00 + ((character - 0x10000) & 0x3FF);
+                        out.push_back(static_cast<char>(high >> 8));
+                        out.push_back(static_cast<char>(high & 0xFF));
+                        out.push_back(static_cast<char>(low >> 8));
+                        out.push_back(static_cast<char>(low & 0xFF));
+                    } else {
+                        out.push_back(static_cast<char>(character >> 8));
+                        out.push_back(static_cast<char>(character & 0xFF));
+                    }
+                } else {
+                    // UTF8 stores supplementary characters as surrogate pairs
+                    if (charsetId == 871 && length == 4)
+                        return false;
+                    out.append(text, i, length);
+                }
+                i += length;
+            }
+            return true;
+        }
+
+        const CharacterSet* characterSet = locales->getCharacterSet(charsetId);
+        if (characterSet == nullptr)
+            return false;
+        if (characterSet->decodeRun(reinterpret_cast<const uint8_t*>(text.data()), text.length()) != text.length())
+            return false;
+        out = text;
+        return true;
+    }
+
+    uint32_t Condition::compileOperand(const Expression* expression) {
+        const auto* value = dynamic_cast<const StringValue*>(expression);
+        if (unlikely(value == nullptr))
+            throw RuntimeException(50066, "invalid expression evaluation: bool to string");
+
+        switch (value->stringType) {
+            case StringValue::TYPE::SESSION_ATTRIBUTE:
+                operands.push_back({OPERAND::ATTRIBUTE, internAttribute(value->stringValue), value->stringValue});
+                break;
+
+            case StringValue::TYPE::OP:
+                operands.push_back({OPERAND::OP, 0, ""});
+                break;
+
+            case StringValue::TYPE::VALUE:
+                operands.push_back({OPERAND::VALUE, 0, value->stringValue});
+                break;
+
+            case StringValue::TYPE::COLUMN:
+                throw RuntimeException(50067, "invalid condition: " + condition + " column: " + value->stringValue + " not compared with a constant");
+        }
+        return static_cast<uint32_t>(operands.size() - 1);
+    }
+
+    uint32_t Condition::compilePredicate(const StringValue* columnValue, const StringValue* constValue, COMPARE compare) {
+        if (unlikely(constValue->stringType != StringValue::TYPE::VALUE))
+            throw RuntimeException(50067, "invalid condition: " + condition + " column: " + columnValue->stringValue + " not compared with a constant");
+
+        const DbColumn* column = nullptr;
+        typeCol col = 0;
+        if (table != nullptr) {
+            for (; col < static_cast<typeCol>(table->columns.size()); ++col) {
+                if (table->columns[col]->name == columnValue->stringValue) {
+                    column = table->columns[col];
+                    break;
+                }
+            }
+        }
+        if (unlikely(column == nullptr))
+            throw RuntimeException(50067, "invalid condition: " + condition + " unknown column: " + columnValue->stringValue);
+
+        Predicate predicate{col, compare, 0, ""};
+        bool valid;
+        switch (column->type) {
+            case SysCol::COLTYPE::NUMBER:
+                valid = encodeNumber(constValue->stringValue, predicate.value);
+                break;
+
+            case SysCol::COLTYPE::DATE:
+                valid = encodeDate(constValue->stringValue, false, predicate.value);
+                break;
+
+            case SysCol::COLTYPE::TIMESTAMP:
+                valid = encodeDate(constValue->stringValue, true, predicate.value);
+                break;
+
+            case SysCol::COLTYPE::RAW:
+                valid = encodeRaw(constValue->stringValue, predicate.value);
+                break;
+
+            case SysCol::COLTYPE::CHAR:
+                predicate.padLength = column->charsetId == 2000 ? 2 : 1;
+                [[fallthrough]];
+
+            case SysCol::COLTYPE::VARCHAR:
+                valid = encodeString(constValue->stringValue, column->charsetId, predicate.value);
+                break;
+
+            default:
+                throw RuntimeException(50067, "invalid condition: " + condition + " column: " + columnValue->stringValue + " has unsupported type: " +
+                                              std::to_string(static_cast<uint>(column->type)));
+        }
+        if (unlikely(!valid))
+            throw RuntimeException(50067, "invalid condition: " + condition + " invalid constant: '" + constValue->stringValue + "' for column: " +
+                                          columnValue->stringValue);
+
+        // Blank-padded comparison, the trailing space of the row value is ignored as well
+        if (predicate.padLength == 1) {
+            while (!predicate.value.empty() && predicate.value.back() == ' ')
+                predicate.value.pop_back();
+        } else if (predicate.padLength == 2) {
+            while (predicate.value.length() >= 2 && predicate.value[predicate.value.length() - 2] == 0 && predicate.value.back() == ' ')
+                predicate.value.resize(predicate.value.length() - 2);
+        }
+
+        predicates.push_back(std::move(predicate));
+        rowDependent = true;
+        return static_cast<uint32_t>(predicates.size() - 1);
+    }
+
+    void Condition::compileBool(const Expression* expression) {
+        const auto* value = dynamic_cast<const BoolValue*>(expression);
+        if (unlikely(value == nullptr))
+            throw RuntimeException(50066, "invalid expression evaluation: string to bool");
+
+        switch (value->boolType) {
+            case BoolValue::VALUE::FALSE:
+                program.push_back({OPCODE::LOAD_FALSE, 0, 0});
+                return;
+
+            case BoolValue::VALUE::TRUE:
+                program.push_back({OPCODE::LOAD_TRUE, 0, 0});
+                return;
+
+            case BoolValue::VALUE::OPERATOR_AND:
+            case BoolValue::VALUE::OPERATOR_OR: {
+                compileBool(value->left);
+                const uint64_t jump = program.size();
+                program.push_back({value->boolType == BoolValue::VALUE::OPERATOR_AND ? OPCODE::JUMP_IF_FALSE : OPCODE::JUMP_IF_TRUE, 0, 0});
+                compileBool(value->right);
+                program[jump].arg1 = static_cast<uint32_t>(program.size());
+                return;
+            }
+
+            case BoolValue::VALUE::OPERATOR_NOT:
+                compileBool(value->left);
+                program.push_back({OPCODE::NOT, 0, 0});
+                return;
+
+            case BoolValue::VALUE::OPERATOR_EQUAL:
+            case BoolValue::VALUE::OPERATOR_NOT_EQUAL:
+            case BoolValue::VALUE::OPERATOR_LESS:
+            case BoolValue::VALUE::OPERATOR_LESS_EQUAL:
+            case BoolValue::VALUE::OPERATOR_GREATER:
+            case BoolValue::VALUE::OPERATOR_GREATER_EQUAL: {
+                const auto* leftValue = dynamic_cast<const StringValue*>(value->left);
+                const auto* rightValue = dynamic_cast<const StringValue*>(value->right);
+                if (unlikely(leftValue == nullptr || rightValue == nullptr))
+                    throw RuntimeException(50066, "invalid expression evaluation: bool to string");
+
+                COMPARE compare;
+                COMPARE mirrored;
+                switch (value->boolType) {
+                    case BoolValue::VALUE::OPERATOR_EQUAL:
+                        compare = mirrored = COMPARE::EQUAL;
+                        break;
+                    case BoolValue::VALUE::OPERATOR_NOT_EQUAL:
+                        compare = mirrored = COMPARE::NOT_EQUAL;
+                        break;
+                    case BoolValue::VALUE::OPERATOR_LESS:
+                        compare = COMPARE::LESS;
+                        mirrored = COMPARE::GREATER;
+                        break;
+                    case BoolValue::VALUE::OPERATOR_LESS_EQUAL:
+                        compare = COMPARE::LESS_EQUAL;
+                        mirrored = COMPARE::GREATER_EQUAL;
+                        break;
+                    case BoolValue::VALUE::OPERATOR_GREATER:
+                        compare = COMPARE::GREATER;
+                        mirrored = COMPARE::LESS;
+                        break;
+                    default:
+                        compare = COMPARE::GREATER_EQUAL;
+                        mirrored = COMPARE::LESS_EQUAL;
+                }
+
+                if (leftValue->stringType == StringValue::TYPE::COLUMN) {
+                    program.push_back({OPCODE::COLUMN, compilePredicate(leftValue, rightValue, compare), 0});
+                    return;
+                }
+                if (rightValue->stringType == StringValue::TYPE::COLUMN) {
+                    program.push_back({OPCODE::COLUMN, compilePredicate(rightValue, leftValue, mirrored), 0});
+                    return;
+                }
+                if (unlikely(compare != COMPARE::EQUAL && compare != COMPARE::NOT_EQUAL))
+                    throw RuntimeException(50067, "invalid condition: " + condition + " ordering is only defined for column values");
+
+                const uint32_t left = compileOperand(value->left);
+                const uint32_t right = compileOperand(value->right);
+                program.push_back({value->boolType == BoolValue::VALUE::OPERATOR_EQUAL ? OPCODE::EQUAL : OPCODE::NOT_EQUAL, left, right});
+                return;
+            }
+        }
+        throw RuntimeException(50066, "invalid expression evaluation: invalid bool type");
+    }
+
+    bool Condition::evaluatePredicate(const Predicate& predicate, const ConditionContext& context) {
+        // Any comparison with NULL is false, as in SQL
+        const uint8_t* data;
+        uint64_t size;
+        if (!context.column(predicate.col, data, size))
+            return false;
+
+        if (predicate.padLength == 1) {
+            while (size > 0 && data[size - 1] == ' ')
+                --size;
+        } else if (predicate.padLength == 2) {
+            while (size >= 2 && data[size - 2] == 0 && data[size - 1] == ' ')
+                size -= 2;
+        }
+
+        const uint64_t valueSize = predicate.value.length();
+        int result = memcmp(data, predicate.value.data(), std::min(size, valueSize));
+        if (result == 0)
+            result = size < valueSize ? -1 : (size > valueSize ? 1 : 0);
+
+        switch (predicate.compare) {
+            case COMPARE::EQUAL:
+                return result == 0;
+
+            case COMPARE::NOT_EQUAL:
+                return result != 0;
+
+            case COMPARE::LESS:
+                return result < 0;
+
+            case COMPARE::LESS_EQUAL:
+                return result <= 0;
+
+            case COMPARE::GREATER:
+                return result > 0;
+
+            case COMPARE::GREATER_EQUAL:
+                return result >= 0;
+        }
+        return false;
+    }
+
+    bool Condition::evaluate(char op, ConditionContext& context) const {
+        bool result = false;
+        const uint64_t size = program.size();
+        uint64_t pc = 0;
+        while (pc < size) {
+            const Instruction& instruction = program[pc++];
+            switch (instruction.code) {
+                case OPCODE::LOAD_FALSE:
+                    result = false;
+                    break;
+
+                case OPCODE::LOAD_TRUE:
+                    result = true;
+                    break;
+
+                case OPCODE::EQUAL:
+                    result = operand(operands[instruction.arg1], op, context) == operand(operands[instruction.arg2], op, context);
+                    break;
+
+                case OPCODE::NOT_EQUAL:
+                    result = operand(operands[instruction.arg1], op, context) != operand(operands[instruction.arg2], op, context);
+                    break;
+
+                case OPCODE::COLUMN:
+                    result = evaluatePredicate(predicates[instruction.arg1], context);
+                    break;
+
+                case OPCODE::NOT:
+                    result = !result;
+                    break;
+
+                case OPCODE::JUMP_IF_FALSE:
+                    if (!result)
+                        pc = instruction.arg1;
+                    break;
+
+                case OPCODE::JUMP_IF_TRUE:
+                    if (result)
+                        pc = instruction.arg1;
+                    break;
+            }
+        }
+        return result;
+    }
+}
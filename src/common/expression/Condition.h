@@ -0,0 +1,195 @@
+/* Header for Condition class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../Format.h"
+#include "../types/Types.h"
+
+#ifndef EXPRESSION_CONDITION_H_
+#define EXPRESSION_CONDITION_H_
+
+namespace OpenLogReplicator {
+    class BoolValue;
+    class DbTable;
+    class Expression;
+    class Locales;
+    class StringValue;
+
+    // Attribute values of the transaction being output, every attribute is looked up at most once per transaction
+    class ConditionContext final {
+    protected:
+        static std::atomic<uint64_t> transactionNext;
+
+        const std::unordered_map<std::string, std::string>* attributes{nullptr};
+        std::vector<std::pair<uint64_t, std::string_view>> slotValues;
+
+        // Raw column values of the row being output, before any formatting
+        const uint8_t* const (*rowValues)[static_cast<uint>(Format::VALUE_TYPE::LENGTH)]{nullptr};
+        const int64_t (*rowSizes)[static_cast<uint>(Format::VALUE_TYPE::LENGTH)]{nullptr};
+        uint rowImage{0};
+        uint rowImageFallback{0};
+
+    public:
+        // Unique across all builders, so that results cached on a table never match a different transaction
+        uint64_t transaction{0};
+
+        void begin(const std::unordered_map<std::string, std::string>* newAttributes) {
+            attributes = newAttributes;
+            transaction = transactionNext.fetch_add(1, std::memory_order_relaxed) + 1;
+        }
+
+        std::string_view attribute(uint32_t slot, const std::string& name) {
+            if (unlikely(slot >= slotValues.size()))
+                slotValues.resize(slot + 1, {0, std::string_view()});
+
+            auto& [slotTransaction, value] = slotValues[slot];
+            if (slotTransaction != transaction) {
+                slotTransaction = transaction;
+                value = std::string_view();
+                if (attributes != nullptr) {
+                    auto attributesIt = attributes->find(name);
+                    if (attributesIt != attributes->end())
+                        value = attributesIt->second;
+                }
+            }
+            return value;
+        }
+
+        void setRow(const uint8_t* const (*newValues)[static_cast<uint>(Format::VALUE_TYPE::LENGTH)],
+                    const int64_t (*newSizes)[static_cast<uint>(Format::VALUE_TYPE::LENGTH)], Format::VALUE_TYPE image, Format::VALUE_TYPE imageFallback) {
+            rowValues = newValues;
+            rowSizes = newSizes;
+            rowImage = static_cast<uint>(image);
+            rowImageFallback = static_cast<uint>(imageFallback);
+        }
+
+        // False for NULL, also when the column is not present in the redo record
+        bool column(typeCol col, const uint8_t*& data, uint64_t& size) const {
+            if (unlikely(rowValues == nullptr))
+                return false;
+
+            const uint8_t* value = rowValues[col][rowImage];
+            int64_t valueSize = rowSizes[col][rowImage];
+            if (value == nullptr) {
+                value = rowValues[col][rowImageFallback];
+                valueSize = rowSizes[col][rowImageFallback];
+            }
+            if (value == nullptr || valueSize <= 0)
+                return false;
+
+            data = value;
+            size = static_cast<uint64_t>(valueSize);
+            return true;
+        }
+    };
+
+    // Condition expression compiled to a flat program, evaluated without virtual calls and string copies.
+    // Comparisons never take a bool operand, so a single result register is enough: && and || jump over
+    // the right side when the left side decides the result.
+    // Constants compared with a column are encoded once to the on-disk format of the column, so that the
+    // raw bytes of the row are compared without decoding
+    class Condition final {
+    protected:
+        enum class OPCODE : unsigned char {
+            LOAD_FALSE, LOAD_TRUE, EQUAL, NOT_EQUAL, NOT, JUMP_IF_FALSE, JUMP_IF_TRUE, COLUMN
+        };
+
+        enum class COMPARE : unsigned char {
+            EQUAL, NOT_EQUAL, LESS, LESS_EQUAL, GREATER, GREATER_EQUAL
+        };
+
+        enum class OPERAND : unsigned char {
+            OP, ATTRIBUTE, VALUE
+        };
+
+        struct Operand {
+            OPERAND type;
+            uint32_t slot;
+            std::string value;
+        };
+
+        struct Predicate {
+            typeCol col;
+            COMPARE compare;
+            // Length of the trailing space of CHAR columns, ignored in comparison
+            uint8_t padLength;
+            std::string value;
+        };
+
+        struct Instruction {
+            OPCODE code;
+            // Operands of a comparison, the predicate of a column comparison or the target of a jump
+            uint32_t arg1;
+            uint32_t arg2;
+        };
+
+        std::vector<Instruction> program;
+        std::vector<Operand> operands;
+        std::vector<Predicate> predicates;
+        std::string condition;
+        const DbTable* table;
+        const Locales* locales;
+
+        static uint32_t internAttribute(const std::string& name);
+        static bool encodeNumber(const std::string& text, std::string& out);
+        static bool encodeDate(const std::string& text, bool fraction, std::string& out);
+        static bool encodeRaw(const std::string& text, std::string& out);
+        bool encodeString(const std::string& text, uint64_t charsetId, std::string& out) const;
+        uint32_t compileOperand(const Expression* expression);
+        uint32_t compilePredicate(const StringValue* columnValue, const StringValue* constValue, COMPARE compare);
+        void compileBool(const Expression* expression);
+        [[nodiscard]] static bool evaluatePredicate(const Predicate& predicate, const ConditionContext& context);
+
+        std::string_view operand(const Operand& value, const char& op, ConditionContext& context) const {
+            switch (value.type) {
+                case OPERAND::OP:
+                    return {&op, 1};
+
+                case OPERAND::ATTRIBUTE:
+                    return context.attribute(value.slot, value.value);
+
+                case OPERAND::VALUE:
+                    break;
+            }
+            return value.value;
+        }
+
+    public:
+        // Set when the result depends on column values and can't be reused for other rows of the same transaction
+        bool rowDependent{false};
+
+        Condition(const std::string& newCondition, const BoolValue* root, const DbTable* newTable, const Locales* newLocales);
+
+        [[nodiscard]] bool evaluate(char op, ConditionContext& context) const;
+
+        [[nodiscard]] bool references(typeCol col) const {
+            for (const Predicate& predicate: predicates)
+                if (predicate.col == col)
+                    return true;
+            return false;
+        }
+    };
+}
+
+#endif
@@ -27,6 +27,7 @@ namespace OpenLogReplicator {
     void Expression::buildTokens(const std::string& condition, std::vector<Token*>& tokens) {
         Token::TYPE expressionType = Token::TYPE::NONE;
         uint64_t tokenIndex = 0;
+        bool quoted = false;
 
         uint64_t i = 0;
         while (i < condition.length()) {
@@ -51,7 +52,8 @@ namespace OpenLogReplicator {
                         expressionType = Token::TYPE::IDENTIFIER;
                         tokenIndex = ++i;
                         continue;
-                    } else if (condition[i] == '|' || condition[i] == '&' || condition[i] == '!' || condition[i] == '=') {
+                    } else if (condition[i] == '|' || condition[i] == '&' || condition[i] == '!' || condition[i] == '=' || condition[i] == '<' ||
+                               condition[i] == '>') {
                         expressionType = Token::TYPE::OPERATOR;
                         tokenIndex = i++;
                         continue;
@@ -63,6 +65,15 @@ namespace OpenLogReplicator {
                         expressionType = Token::TYPE::STRING;
                         tokenIndex = ++i;
                         continue;
+                    } else if ((condition[i] >= 'A' && condition[i] <= 'Z') || (condition[i] >= 'a' && condition[i] <= 'z') || condition[i] == '_') {
+                        expressionType = Token::TYPE::COLUMN;
+                        tokenIndex = i++;
+                        continue;
+                    } else if (condition[i] == '"') {
+                        expressionType = Token::TYPE::COLUMN;
+                        quoted = true;
+                        tokenIndex = ++i;
+                        continue;
                     }
                     throw RuntimeException(50067, "invalid condition: " + condition + " position: " + std::to_string(i));
 
@@ -86,11 +97,18 @@ namespace OpenLogReplicator {
                     continue;
 
                 case Token::TYPE::OPERATOR:
-                    if (tokenIndex + 1 == i && condition[tokenIndex] == '!') {
+                    if (tokenIndex + 1 == i && (condition[tokenIndex] == '!' || condition[tokenIndex] == '>')) {
                         if (condition[i] == '=') {
                             ++i;
                             continue;
                         }
+                    } else if (tokenIndex + 1 == i && condition[tokenIndex] == '<') {
+                        if (condition[i] == '=' || condition[i] == '>') {
+                            ++i;
+                            continue;
+                        }
+                    } else if (condition[tokenIndex] == '<' || condition[tokenIndex] == '>') {
+                        // <=, <> and >= are complete
                     } else if (condition[i] == '|' || condition[i] == '&' || condition[i] == '!' || condition[i] == '=') {
                         ++i;
                         continue;
@@ -112,6 +130,32 @@ namespace OpenLogReplicator {
                     ++i;
                     continue;
 
+                case Token::TYPE::COLUMN:
+                    if (quoted) {
+                        if (condition[i] != '"') {
+                            ++i;
+                            continue;
+                        }
+
+                        // ends with quotation mark, the name is case-sensitive
+                        tokens.push_back(new Token(expressionType, condition.substr(tokenIndex, i - tokenIndex)));
+                        expressionType = Token::TYPE::NONE;
+                        quoted = false;
+                        ++i;
+                        continue;
+                    }
+
+                    if ((condition[i] >= 'A' && condition[i] <= 'Z') || (condition[i] >= 'a' && condition[i] <= 'z') || (condition[i] >= '0' && condition[i] <= '9') ||
+                        condition[i] == '_' || condition[i] == '$' || condition[i] == '#') {
+                        ++i;
+                        continue;
+                    }
+
+                    // Not quoted names are stored in upper case in the dictionary
+                    tokens.push_back(new Token(expressionType, upperName(condition.substr(tokenIndex, i - tokenIndex))));
+                    expressionType = Token::TYPE::NONE;
+                    continue;
+
                 case Token::TYPE::NUMBER:
                     if ((condition[i] >= '0' && condition[i] <= '9') || condition[i] == '.' || condition[i] == 'e' || condition[i] == 'E') {
                         ++i;
@@ -126,10 +170,12 @@ namespace OpenLogReplicator {
         }
 
         // Reached end and the token is not finished
-        if (expressionType == Token::TYPE::STRING || expressionType == Token::TYPE::IDENTIFIER)
+        if (expressionType == Token::TYPE::STRING || expressionType == Token::TYPE::IDENTIFIER || quoted)
             throw RuntimeException(50067, "invalid condition: " + condition + " unfinished token: " + condition.substr(tokenIndex, i - tokenIndex));
 
-        if (expressionType != Token::TYPE::NONE)
+        if (expressionType == Token::TYPE::COLUMN)
+            tokens.push_back(new Token(expressionType, upperName(condition.substr(tokenIndex, i - tokenIndex))));
+        else if (expressionType != Token::TYPE::NONE)
             tokens.push_back(new Token(expressionType, condition.substr(tokenIndex, i - tokenIndex)));
     }
 
@@ -179,7 +225,7 @@ namespace OpenLogReplicator {
                     const Token* middleToken = dynamic_cast<Token*>(middle);
 
                     // A == B
-                    if (middleToken->stringValue == "==") {
+                    if (middleToken->stringValue == "==" || middleToken->stringValue == "=") {
                         stack.pop_back();
                         stack.pop_back();
                         stack.pop_back();
@@ -188,13 +234,35 @@ namespace OpenLogReplicator {
                     }
 
                     // A != B
-                    if (middleToken->stringValue == "!=") {
+                    if (middleToken->stringValue == "!=" || middleToken->stringValue == "<>") {
                         stack.pop_back();
                         stack.pop_back();
                         stack.pop_back();
                         stack.push_back(new BoolValue(BoolValue::VALUE::OPERATOR_NOT_EQUAL, left, right));
                         continue;
                     }
+
+                    // A < B, A <= B, A > B, A >= B - only defined for column values
+                    if (dynamic_cast<StringValue*>(left)->stringType == StringValue::TYPE::COLUMN ||
+                        dynamic_cast<StringValue*>(right)->stringType == StringValue::TYPE::COLUMN) {
+                        BoolValue::VALUE compare;
+                        if (middleToken->stringValue == "<")
+                            compare = BoolValue::VALUE::OPERATOR_LESS;
+                        else if (middleToken->stringValue == "<=")
+                            compare = BoolValue::VALUE::OPERATOR_LESS_EQUAL;
+                        else if (middleToken->stringValue == ">")
+                            compare = BoolValue::VALUE::OPERATOR_GREATER;
+                        else if (middleToken->stringValue == ">=")
+                            compare = BoolValue::VALUE::OPERATOR_GREATER_EQUAL;
+                        else
+                            throw RuntimeException(50067, "invalid condition: " + condition + " operator: " + middleToken->stringValue);
+
+                        stack.pop_back();
+                        stack.pop_back();
+                        stack.pop_back();
+                        stack.push_back(new BoolValue(compare, left, right));
+                        continue;
+                    }
                 }
 
                 if (left->isBool() && middle->isToken() && right->isBool()) {
@@ -245,13 +313,15 @@ namespace OpenLogReplicator {
                         stack.push_back(token);
                         continue;
 
-                    // Unsupported
+                    // Numbers are constants compared with column values
                     case Token::TYPE::NUMBER:
-                        break;
-
                     case Token::TYPE::STRING:
                         stack.push_back(new StringValue(StringValue::TYPE::VALUE, token->stringValue));
                         continue;
+
+                    case Token::TYPE::COLUMN:
+                        stack.push_back(new StringValue(StringValue::TYPE::COLUMN, token->stringValue));
+                        continue;
                 }
             }
 
@@ -278,5 +348,12 @@ namespace OpenLogReplicator {
         return root;
     }
 
+    std::string Expression::upperName(std::string name) {
+        for (char& c: name)
+            if (c >= 'a' && c <= 'z')
+                c = static_cast<char>(c - 'a' + 'A');
+        return name;
+    }
+
     Expression::Expression() = default;
 }
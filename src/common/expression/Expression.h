@@ -30,6 +30,9 @@ namespace OpenLogReplicator {
     class Token;
 
     class Expression {
+    protected:
+        static std::string upperName(std::string name);
+
     public:
         static void buildTokens(const std::string& condition, std::vector<Token*>& tokens);
         static BoolValue* buildCondition(const std::string& condition, std::vector<Token*>& tokens, std::vector<Expression*>& stack);
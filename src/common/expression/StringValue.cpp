@@ -46,6 +46,9 @@ namespace OpenLogReplicator {
 
             case TYPE::VALUE:
                 return stringValue;
+
+            case TYPE::COLUMN:
+                break;
         }
 
         throw RuntimeException(50066, "invalid expression evaluation: invalid string type");
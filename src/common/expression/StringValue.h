@@ -26,7 +26,7 @@ namespace OpenLogReplicator {
     class StringValue : public Expression {
     public:
         enum class TYPE : unsigned char {
-            SESSION_ATTRIBUTE, OP, VALUE
+            SESSION_ATTRIBUTE, OP, VALUE, COLUMN
         };
 
         TYPE stringType;
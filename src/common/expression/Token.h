@@ -30,7 +30,7 @@ namespace OpenLogReplicator {
     class Token : public Expression {
     public:
         enum class TYPE : unsigned char {
-            NONE, IDENTIFIER, LEFT_PARENTHESIS, RIGHT_PARENTHESIS, COMMA, OPERATOR, NUMBER, STRING
+            NONE, IDENTIFIER, LEFT_PARENTHESIS, RIGHT_PARENTHESIS, COMMA, OPERATOR, NUMBER, STRING, COLUMN
         };
 
         TYPE tokenType;
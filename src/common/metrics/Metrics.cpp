@@ -34,4 +34,29 @@ namespace OpenLogReplicator {
     bool Metrics::isTagNamesSys() {
         return (static_cast<uint>(tagNames) & static_cast<uint>(TAG_NAMES::SYS)) != 0;
     }
+
+    void Metrics::emitDmlOps(DML_OPS op, uint64_t counter) {
+        switch (op) {
+            case DML_OPS::DELETE_OUT:
+                emitDmlOpsDeleteOut(counter);
+                break;
+            case DML_OPS::INSERT_OUT:
+                emitDmlOpsInsertOut(counter);
+                break;
+            case DML_OPS::UPDATE_OUT:
+                emitDmlOpsUpdateOut(counter);
+                break;
+            case DML_OPS::DELETE_SKIP:
+                emitDmlOpsDeleteSkip(counter);
+                break;
+            case DML_OPS::INSERT_SKIP:
+                emitDmlOpsInsertSkip(counter);
+                break;
+            case DML_OPS::UPDATE_SKIP:
+                emitDmlOpsUpdateSkip(counter);
+                break;
+            case DML_OPS::NUM:
+                break;
+        }
+    }
 }
@@ -22,15 +22,34 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #ifndef METRICS_H_
 #define METRICS_H_
 
+#include "../RuntimeStats.h"
+
 namespace OpenLogReplicator {
     class Ctx;
 
+    // Handle of one labelled counter, resolved once and kept by the caller, owned by the metrics
+    class MetricsCounter {
+    public:
+        virtual ~MetricsCounter() = default;
+
+        virtual void increment(uint64_t counter) = 0;
+    };
+
     class Metrics {
     public:
         enum class TAG_NAMES : unsigned char {
             NONE = 0, FILTER = 1 << 0, SYS = 1 << 2
         };
 
+        enum class DML_OPS : unsigned char {
+            DELETE_OUT, INSERT_OUT, UPDATE_OUT, DELETE_SKIP, INSERT_SKIP, UPDATE_SKIP, NUM
+        };
+
+        // Redo bytes buffered for the table, time spent building its rows, output bytes and messages
+        enum class TABLE_COST : unsigned char {
+            BYTES_BUFFERED, BUILD_NS, BYTES_OUT, MESSAGES, NUM
+        };
+
     protected:
         TAG_NAMES tagNames;
 
@@ -43,6 +62,13 @@ namespace OpenLogReplicator {
         bool isTagNamesFilter();
         bool isTagNamesSys();
 
+        // builder_chunks_pinned
+        virtual void emitBuilderChunksPinned(int64_t gauge) = 0;
+        virtual void emitBuilderChunksPinnedMessages(int64_t gauge) = 0;
+
+        // builder_chunks_released_out_of_order
+        virtual void emitBuilderChunksReleasedOutOfOrder(uint64_t counter) = 0;
+
         // bytes_confirmed
         virtual void emitBytesConfirmed(uint64_t counter) = 0;
 
@@ -62,6 +88,9 @@ namespace OpenLogReplicator {
         // checkpoint_lag
         virtual void emitCheckpointLag(int64_t gauge) = 0;
 
+        // checkpoint_duration_us
+        virtual void emitCheckpointDurationUs(int64_t gauge) = 0;
+
         // ddl_ops
         virtual void emitDdlOpsAlter(uint64_t counter) = 0;
         virtual void emitDdlOpsCreate(uint64_t counter) = 0;
@@ -77,12 +106,9 @@ namespace OpenLogReplicator {
         virtual void emitDmlOpsDeleteSkip(uint64_t counter) = 0;
         virtual void emitDmlOpsInsertSkip(uint64_t counter) = 0;
         virtual void emitDmlOpsUpdateSkip(uint64_t counter) = 0;
-        virtual void emitDmlOpsDeleteOut(uint64_t counter, const std::string& owner, const std::string& table) = 0;
-        virtual void emitDmlOpsInsertOut(uint64_t counter, const std::string& owner, const std::string& table) = 0;
-        virtual void emitDmlOpsUpdateOut(uint64_t counter, const std::string& owner, const std::string& table) = 0;
-        virtual void emitDmlOpsDeleteSkip(uint64_t counter, const std::string& owner, const std::string& table) = 0;
-        virtual void emitDmlOpsInsertSkip(uint64_t counter, const std::string& owner, const std::string& table) = 0;
-        virtual void emitDmlOpsUpdateSkip(uint64_t counter, const std::string& owner, const std::string& table) = 0;
+        // Counter of a single table, looked up once per table instead of once per row
+        [[nodiscard]] virtual MetricsCounter* getDmlOpsCounter(DML_OPS op, const std::string& owner, const std::string& table) = 0;
+        void emitDmlOps(DML_OPS op, uint64_t counter);
 
         // log_switches
         virtual void emitLogSwitchesArchived(uint64_t counter) = 0;
@@ -106,12 +132,34 @@ namespace OpenLogReplicator {
         virtual void emitMemoryUsedMbTransactions(int64_t gauge) = 0;
         virtual void emitMemoryUsedMbWriter(int64_t gauge) = 0;
 
+        // memory_node_hwm_mb
+        virtual void emitMemoryNodeHwmMb(int64_t node, int64_t gauge) = 0;
+
+        // memory_trims
+        virtual void emitMemoryTrims(uint64_t counter) = 0;
+
+        // memory_trimmed_mb
+        virtual void emitMemoryTrimmedMb(uint64_t counter) = 0;
+
         // messages_confirmed
         virtual void emitMessagesConfirmed(uint64_t counter) = 0;
 
         // messages sent
         virtual void emitMessagesSent(uint64_t counter) = 0;
 
+        // parser_stall_us
+        virtual void emitParserStallUs(uint64_t counter) = 0;
+
+        // rate_limit_wait_us
+        virtual void emitRateLimitWaitUsBackfill(uint64_t counter) = 0;
+        virtual void emitRateLimitWaitUsTable(uint64_t counter) = 0;
+        virtual void emitRateLimitWaitUsWriter(uint64_t counter) = 0;
+
+        // rate_limit_waits
+        virtual void emitRateLimitWaitsBackfill(uint64_t counter) = 0;
+        virtual void emitRateLimitWaitsTable(uint64_t counter) = 0;
+        virtual void emitRateLimitWaitsWriter(uint64_t counter) = 0;
+
         // swap_operations
         virtual void emitSwapOperationsMbDiscard(uint64_t counter) = 0;
         virtual void emitSwapOperationsMbRead(uint64_t counter) = 0;
@@ -120,6 +168,9 @@ namespace OpenLogReplicator {
         // swap_usage_mb
         virtual void emitSwapUsageMb(int64_t gauge) = 0;
 
+        // table_cost
+        [[nodiscard]] virtual MetricsCounter* getTableCostCounter(TABLE_COST cost, const std::string& owner, const std::string& table) = 0;
+
         // transactions
         virtual void emitTransactionsCommitOut(uint64_t counter) = 0;
         virtual void emitTransactionsRollbackOut(uint64_t counter) = 0;
@@ -127,6 +178,22 @@ namespace OpenLogReplicator {
         virtual void emitTransactionsRollbackPartial(uint64_t counter) = 0;
         virtual void emitTransactionsCommitSkip(uint64_t counter) = 0;
         virtual void emitTransactionsRollbackSkip(uint64_t counter) = 0;
+
+        // thread_context_us, thread_context_count, thread_reason_count - totals of a thread since its start
+        virtual void emitThreadContextUs(const std::string& thread, const std::string& context, uint64_t total) = 0;
+        virtual void emitThreadContextCount(const std::string& thread, const std::string& context, uint64_t total) = 0;
+        virtual void emitThreadReasonCount(const std::string& thread, uint reason, uint64_t total) = 0;
+
+        // latency_us - sampled duration of a pipeline stage
+        virtual void emitLatencyUs(RuntimeStats::LATENCY stage, uint64_t us) = 0;
+
+        // transaction_pool
+        virtual void emitTransactionPoolHit(uint64_t counter) = 0;
+        virtual void emitTransactionPoolMiss(uint64_t counter) = 0;
+
+        // stalls, stall_samples - stalls found by the watchdog and the contexts of the threads sampled during them
+        virtual void emitStalls(uint64_t counter) = 0;
+        virtual void emitStallSamples(const std::string& thread, const std::string& context, uint64_t counter) = 0;
     };
 }
 
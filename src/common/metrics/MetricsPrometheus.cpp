@@ -17,27 +17,86 @@ You should have received a copy of the GNU General Public License
 along with OpenLogReplicator; see the file LICENSE;  If not see
 <http://www.gnu.org/licenses/>.  */
 
+#include <prometheus/text_serializer.h>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
 #include "MetricsPrometheus.h"
 #include "../Ctx.h"
 
 namespace OpenLogReplicator {
-    MetricsPrometheus::MetricsPrometheus(TAG_NAMES newTagNames, std::string newBind) :
+    std::mutex MetricsPrometheus::sharedMtx;
+    std::map<std::string, std::shared_ptr<prometheus::Registry>> MetricsPrometheus::sharedRegistries;
+
+    MetricsPrometheus::MetricsPrometheus(TAG_NAMES newTagNames, std::string newBind, std::string newTenant) :
             Metrics(newTagNames),
-            bind(std::move(newBind)) {
+            bind(std::move(newBind)),
+            tenant(std::move(newTenant)) {
     }
 
     MetricsPrometheus::~MetricsPrometheus() {
         if (exposer != nullptr) {
             delete exposer;
             exposer = nullptr;
+        } else if (registry != nullptr) {
+            std::unique_lock<std::mutex> const lck(sharedMtx);
+            auto sharedRegistriesIt = sharedRegistries.find(tenant);
+            if (sharedRegistriesIt != sharedRegistries.end() && sharedRegistriesIt->second == registry)
+                sharedRegistries.erase(sharedRegistriesIt);
         }
     }
 
+    // Families of the same name from all tenants are merged, a scrape sees every family once with one series per tenant
+    std::string MetricsPrometheus::serializeShared() {
+        std::vector<std::pair<std::string, std::shared_ptr<prometheus::Registry>>> registries;
+        {
+            std::unique_lock<std::mutex> const lck(sharedMtx);
+            registries.assign(sharedRegistries.begin(), sharedRegistries.end());
+        }
+
+        std::vector<prometheus::MetricFamily> families;
+        std::unordered_map<std::string, size_t> familyIndex;
+        for (const auto& [registryTenant, sharedRegistry]: registries) {
+            for (auto& family: sharedRegistry->Collect()) {
+                for (auto& metric: family.metric)
+                    metric.label.push_back({"tenant", registryTenant});
+
+                auto familyIndexIt = familyIndex.find(family.name);
+                if (familyIndexIt == familyIndex.end()) {
+                    familyIndex.insert_or_assign(family.name, families.size());
+                    families.push_back(std::move(family));
+                } else {
+                    auto& metrics = families[familyIndexIt->second].metric;
+                    metrics.insert(metrics.end(), std::make_move_iterator(family.metric.begin()), std::make_move_iterator(family.metric.end()));
+                }
+            }
+        }
+
+        std::ostringstream ss;
+        prometheus::TextSerializer().Serialize(ss, families);
+        return ss.str();
+    }
+
     void MetricsPrometheus::initialize(const Ctx* ctx) {
-        ctx->info(0, "starting Prometheus metrics, listening on: " + bind);
-        exposer = new prometheus::Exposer(bind);
+        if (bind.empty())
+            ctx->info(0, "starting Prometheus metrics, served by the HTTP server with tenant: " + tenant);
+        else {
+            ctx->info(0, "starting Prometheus metrics, listening on: " + bind);
+            exposer = new prometheus::Exposer(bind);
+        }
         registry = std::make_shared<prometheus::Registry>();
 
+        // builder_chunks_pinned
+        builderChunksPinned = &prometheus::BuildGauge().Name("builder_chunks_pinned").Help("Number of builder chunks already passed by the writer and held by unconfirmed messages").Register(*registry);
+        builderChunksPinnedGauge = &builderChunksPinned->Add({});
+        builderChunksPinnedMessages = &prometheus::BuildGauge().Name("builder_chunks_pinned_messages").Help("Number of unconfirmed messages holding pinned builder chunks").Register(*registry);
+        builderChunksPinnedMessagesGauge = &builderChunksPinnedMessages->Add({});
+
+        // builder_chunks_released_out_of_order
+        builderChunksReleasedOutOfOrder = &prometheus::BuildCounter().Name("builder_chunks_released_out_of_order").Help("Number of builder chunks released while an older chunk was still pinned").Register(*registry);
+        builderChunksReleasedOutOfOrderCounter = &builderChunksReleasedOutOfOrder->Add({});
+
         // bytes_confirmed
         bytesConfirmed = &prometheus::BuildCounter().Name("bytes_confirmed").Help("Number of bytes confirmed by output").Register(*registry);
         bytesConfirmedCounter = &bytesConfirmed->Add({});
@@ -64,6 +123,10 @@ namespace OpenLogReplicator {
         checkpointLag = &prometheus::BuildGauge().Name("checkpoint_lag").Help("Checkpoint processing lag in seconds").Register(*registry);
         checkpointLagGauge = &checkpointLag->Add({});
 
+        // checkpoint_duration_us
+        checkpointDurationUs = &prometheus::BuildGauge().Name("checkpoint_duration_us").Help("Time of the last checkpoint serialization and write in microseconds").Register(*registry);
+        checkpointDurationUsGauge = &checkpointDurationUs->Add({});
+
         // ddl_ops
         ddlOps = &prometheus::BuildCounter().Name("ddl_ops").Help("Number of DDL operations").Register(*registry);
         ddlOpsAlterCounter = &ddlOps->Add({{"type", "alter"}});
@@ -119,11 +182,41 @@ namespace OpenLogReplicator {
         memoryUsedMbTransactionsGauge = &memoryUsedMb->Add({{"type", "transactions"}});
         memoryUsedMbWriterGauge = &memoryUsedMb->Add({{"type", "writer"}});
 
+        // memory_node_hwm_mb
+        memoryNodeHwmMb = &prometheus::BuildGauge().Name("memory_node_hwm_mb").Help("Memory HWM per NUMA node in MB").Register(*registry);
+
+        // memory_trims
+        memoryTrims = &prometheus::BuildCounter().Name("memory_trims").Help("Number of times idle free memory was released").Register(*registry);
+        memoryTrimsCounter = &memoryTrims->Add({});
+
+        // memory_trimmed_mb
+        memoryTrimmedMb = &prometheus::BuildCounter().Name("memory_trimmed_mb").Help("Idle free memory released in MB").Register(*registry);
+        memoryTrimmedMbCounter = &memoryTrimmedMb->Add({});
+
         // messages_sent
         messagesSent = &prometheus::BuildCounter().Name("messages_sent").Help("Number of messages sent to output (for example to Kafka or network writer)")
                 .Register(*registry);
         messagesSentCounter = &messagesSent->Add({});
 
+        // parser_stall_us
+        parserStallUs = &prometheus::BuildCounter().Name("parser_stall_us").Help("Time the parser waited for free memory in microseconds")
+                .Register(*registry);
+        parserStallUsCounter = &parserStallUs->Add({});
+
+        // rate_limit_wait_us
+        rateLimitWaitUs = &prometheus::BuildCounter().Name("rate_limit_wait_us").Help("Time the writers waited for the output rate limits in "
+                                                                                      "microseconds").Register(*registry);
+        rateLimitWaitUsBackfillCounter = &rateLimitWaitUs->Add({{"type", "backfill"}});
+        rateLimitWaitUsTableCounter = &rateLimitWaitUs->Add({{"type", "table"}});
+        rateLimitWaitUsWriterCounter = &rateLimitWaitUs->Add({{"type", "writer"}});
+
+        // rate_limit_waits
+        rateLimitWaits = &prometheus::BuildCounter().Name("rate_limit_waits").Help("Number of messages held back by the output rate limits")
+                .Register(*registry);
+        rateLimitWaitsBackfillCounter = &rateLimitWaits->Add({{"type", "backfill"}});
+        rateLimitWaitsTableCounter = &rateLimitWaits->Add({{"type", "table"}});
+        rateLimitWaitsWriterCounter = &rateLimitWaits->Add({{"type", "writer"}});
+
         // swap_operations_mb
         swapOperationsMb = &prometheus::BuildCounter().Name("swap_operations_mb").Help("Operations on swap space in MB").Register(*registry);
         swapOperationsMbDiscardCounter = &swapOperationsMb->Add({{"type", "discard"}});
@@ -134,6 +227,10 @@ namespace OpenLogReplicator {
         swapUsageMb = &prometheus::BuildGauge().Name("swap_usage_mb").Help("Swap usage in MB").Register(*registry);
         swapUsageMbGauge = &swapUsageMb->Add({});
 
+        // table_cost
+        tableCost = &prometheus::BuildCounter().Name("table_cost").Help("Cost of a table: redo bytes buffered, build time in nanoseconds, output bytes "
+                                                                        "and messages").Register(*registry);
+
         memoryUsedTotalMb = &prometheus::BuildGauge().Name("memory_used_total_mb").Help("Total used memory").Register(*registry);
         memoryUsedTotalMbGauge = &memoryUsedTotalMb->Add({});
 
@@ -152,12 +249,54 @@ namespace OpenLogReplicator {
         transactionsRollbackSkipCounter = &transactions->Add({{"type",   "rollback"},
                                                               {"filter", "skip"}});
 
-        exposer->RegisterCollectable(registry);
+        // transaction_pool
+        transactionPool = &prometheus::BuildCounter().Name("transaction_pool").Help("Transaction objects taken from the pool").Register(*registry);
+        transactionPoolHitCounter = &transactionPool->Add({{"type", "hit"}});
+        transactionPoolMissCounter = &transactionPool->Add({{"type", "miss"}});
+
+        // stalls, stall_samples
+        stalls = &prometheus::BuildCounter().Name("stalls").Help("Number of parser or writer stalls found by the watchdog").Register(*registry);
+        stallsCounter = &stalls->Add({});
+        stallSamples = &prometheus::BuildCounter().Name("stall_samples").Help("Contexts of the threads sampled during stalls").Register(*registry);
+
+        // thread_context_us, thread_context_count, thread_reason_count
+        threadContextUs = &prometheus::BuildCounter().Name("thread_context_us").Help("Time spent by a thread in a context in microseconds").Register(*registry);
+        threadContextCount = &prometheus::BuildCounter().Name("thread_context_count").Help("Number of times a thread left a context").Register(*registry);
+        threadReasonCount = &prometheus::BuildCounter().Name("thread_reason_count").Help("Number of context switches of a thread by reason").Register(*registry);
+
+        // latency_us
+        prometheus::Histogram::BucketBoundaries latencyBoundaries;
+        for (uint num = 0; num < LatencyHistogram::BUCKETS - 1; ++num)
+            latencyBoundaries.push_back(static_cast<double>(LatencyHistogram::bucketLimit(num)));
+        latencyUs = &prometheus::BuildHistogram().Name("latency_us").Help("Sampled latency of a pipeline stage in microseconds").Register(*registry);
+        for (uint stage = 0; stage < static_cast<uint>(RuntimeStats::LATENCY::NUM); ++stage)
+            latencyUsHistogram[stage] = &latencyUs->Add({{"stage", RuntimeStats::LATENCY_NAMES[stage]}}, latencyBoundaries);
+
+        if (exposer != nullptr)
+            exposer->RegisterCollectable(registry);
+        else {
+            std::unique_lock<std::mutex> const lck(sharedMtx);
+            sharedRegistries.insert_or_assign(tenant, registry);
+        }
     }
 
     void MetricsPrometheus::shutdown() {
     }
 
+    // builder_chunks_pinned
+    void MetricsPrometheus::emitBuilderChunksPinned(int64_t gauge) {
+        builderChunksPinnedGauge->Set(gauge);
+    }
+
+    void MetricsPrometheus::emitBuilderChunksPinnedMessages(int64_t gauge) {
+        builderChunksPinnedMessagesGauge->Set(gauge);
+    }
+
+    // builder_chunks_released_out_of_order
+    void MetricsPrometheus::emitBuilderChunksReleasedOutOfOrder(uint64_t counter) {
+        builderChunksReleasedOutOfOrderCounter->Increment(counter);
+    }
+
     // bytes_confirmed
     void MetricsPrometheus::emitBytesConfirmed(uint64_t counter) {
         bytesConfirmedCounter->Increment(counter);
@@ -192,6 +331,11 @@ namespace OpenLogReplicator {
         checkpointLagGauge->Set(gauge);
     }
 
+    // checkpoint_duration_us
+    void MetricsPrometheus::emitCheckpointDurationUs(int64_t gauge) {
+        checkpointDurationUsGauge->Set(gauge);
+    }
+
     // ddl_ops
     void MetricsPrometheus::emitDdlOpsAlter(uint64_t counter) {
         ddlOpsAlterCounter->Increment(counter);
@@ -242,100 +386,23 @@ namespace OpenLogReplicator {
         dmlOpsUpdateSkipCounter->Increment(counter);
     }
 
-    void MetricsPrometheus::emitDmlOpsDeleteOut(uint64_t counter, const std::string& owner, const std::string& table) {
-        const std::string key(owner + "." + table);
-        prometheus::Counter* cnt;
-        const auto& it = dmlOpsDeleteOutCounterMap.find(key);
-
-        if (it != dmlOpsDeleteOutCounterMap.end())
-            cnt = it->second;
-        else
-            cnt = &dmlOps->Add({{"type",   "delete"},
-                                {"filter", "out"},
-                                {"owner",  owner},
-                                {"table",  table}});
-
-        cnt->Increment(counter);
-    }
-
-    void MetricsPrometheus::emitDmlOpsInsertOut(uint64_t counter, const std::string& owner, const std::string& table) {
-        const std::string key(owner + "." + table);
-        prometheus::Counter* cnt;
-        const auto& it = dmlOpsInsertOutCounterMap.find(key);
-
-        if (it != dmlOpsInsertOutCounterMap.end())
-            cnt = it->second;
-        else
-            cnt = &dmlOps->Add({{"type",   "insert"},
-                                {"filter", "out"},
-                                {"owner",  owner},
-                                {"table",  table}});
-
-        cnt->Increment(counter);
-    }
-
-    void MetricsPrometheus::emitDmlOpsUpdateOut(uint64_t counter, const std::string& owner, const std::string& table) {
-        const std::string key(owner + "." + table);
-        prometheus::Counter* cnt;
-        const auto& it = dmlOpsUpdateOutCounterMap.find(key);
-
-        if (it != dmlOpsUpdateOutCounterMap.end())
-            cnt = it->second;
-        else
-            cnt = &dmlOps->Add({{"type",   "update"},
-                                {"filter", "out"},
-                                {"owner",  owner},
-                                {"table",  table}});
+    MetricsCounter* MetricsPrometheus::getDmlOpsCounter(DML_OPS op, const std::string& owner, const std::string& table) {
+        static const char* const opType[]{"delete", "insert", "update", "delete", "insert", "update"};
+        static const char* const opFilter[]{"out", "out", "out", "skip", "skip", "skip"};
 
-        cnt->Increment(counter);
-    }
-
-    void MetricsPrometheus::emitDmlOpsDeleteSkip(uint64_t counter, const std::string& owner, const std::string& table) {
+        std::unique_lock<std::mutex> const lck(dmlOpsCounterMtx);
+        auto& counterMap = dmlOpsCounterMap[static_cast<uint>(op)];
         const std::string key(owner + "." + table);
-        prometheus::Counter* cnt;
-        const auto& it = dmlOpsDeleteSkipCounterMap.find(key);
-
-        if (it != dmlOpsDeleteSkipCounterMap.end())
-            cnt = it->second;
-        else
-            cnt = &dmlOps->Add({{"type",   "delete"},
-                                {"filter", "skip"},
-                                {"owner",  owner},
-                                {"table",  table}});
+        const auto& it = counterMap.find(key);
+        if (it != counterMap.end())
+            return it->second.get();
 
-        cnt->Increment(counter);
-    }
-
-    void MetricsPrometheus::emitDmlOpsInsertSkip(uint64_t counter, const std::string& owner, const std::string& table) {
-        const std::string key(owner + "." + table);
-        prometheus::Counter* cnt;
-        const auto& it = dmlOpsInsertSkipCounterMap.find(key);
-
-        if (it != dmlOpsInsertSkipCounterMap.end())
-            cnt = it->second;
-        else
-            cnt = &dmlOps->Add({{"type",   "insert"},
-                                {"filter", "skip"},
-                                {"owner",  owner},
-                                {"table",  table}});
-
-        cnt->Increment(counter);
-    }
-
-    void MetricsPrometheus::emitDmlOpsUpdateSkip(uint64_t counter, const std::string& owner, const std::string& table) {
-        const std::string key(owner + "." + table);
-        prometheus::Counter* cnt;
-        const auto& it = dmlOpsUpdateSkipCounterMap.find(key);
-
-        if (it != dmlOpsUpdateSkipCounterMap.end())
-            cnt = it->second;
-        else
-            cnt = &dmlOps->Add({{"type",   "update"},
-                                {"filter", "skip"},
-                                {"owner",  owner},
-                                {"table",  table}});
-
-        cnt->Increment(counter);
+        auto* counter = new MetricsCounterPrometheus(&dmlOps->Add({{"type",   opType[static_cast<uint>(op)]},
+                                                                   {"filter", opFilter[static_cast<uint>(op)]},
+                                                                   {"owner",  owner},
+                                                                   {"table",  table}}));
+        counterMap.emplace(key, std::unique_ptr<MetricsCounterPrometheus>(counter));
+        return counter;
     }
 
     // log_switches
@@ -391,6 +458,33 @@ namespace OpenLogReplicator {
         memoryUsedMbWriterGauge->Set(gauge);
     }
 
+    // memory_node_hwm_mb
+    void MetricsPrometheus::emitMemoryNodeHwmMb(int64_t node, int64_t gauge) {
+        // Called by every thread allocating memory
+        std::unique_lock<std::mutex> const lck(memoryNodeHwmMbMtx);
+        prometheus::Gauge* gau;
+        const auto& it = memoryNodeHwmMbGaugeMap.find(node);
+
+        if (it != memoryNodeHwmMbGaugeMap.end())
+            gau = it->second;
+        else {
+            gau = &memoryNodeHwmMb->Add({{"node", std::to_string(node)}});
+            memoryNodeHwmMbGaugeMap.insert_or_assign(node, gau);
+        }
+
+        gau->Set(gauge);
+    }
+
+    // memory_trims
+    void MetricsPrometheus::emitMemoryTrims(uint64_t counter) {
+        memoryTrimsCounter->Increment(counter);
+    }
+
+    // memory_trimmed_mb
+    void MetricsPrometheus::emitMemoryTrimmedMb(uint64_t counter) {
+        memoryTrimmedMbCounter->Increment(counter);
+    }
+
     // messages_confirmed
     void MetricsPrometheus::emitMessagesConfirmed(uint64_t counter) {
         messagesConfirmedCounter->Increment(counter);
@@ -401,6 +495,37 @@ namespace OpenLogReplicator {
         messagesSentCounter->Increment(counter);
     }
 
+    // parser_stall_us
+    void MetricsPrometheus::emitParserStallUs(uint64_t counter) {
+        parserStallUsCounter->Increment(counter);
+    }
+
+    // rate_limit_wait_us
+    void MetricsPrometheus::emitRateLimitWaitUsBackfill(uint64_t counter) {
+        rateLimitWaitUsBackfillCounter->Increment(counter);
+    }
+
+    void MetricsPrometheus::emitRateLimitWaitUsTable(uint64_t counter) {
+        rateLimitWaitUsTableCounter->Increment(counter);
+    }
+
+    void MetricsPrometheus::emitRateLimitWaitUsWriter(uint64_t counter) {
+        rateLimitWaitUsWriterCounter->Increment(counter);
+    }
+
+    // rate_limit_waits
+    void MetricsPrometheus::emitRateLimitWaitsBackfill(uint64_t counter) {
+        rateLimitWaitsBackfillCounter->Increment(counter);
+    }
+
+    void MetricsPrometheus::emitRateLimitWaitsTable(uint64_t counter) {
+        rateLimitWaitsTableCounter->Increment(counter);
+    }
+
+    void MetricsPrometheus::emitRateLimitWaitsWriter(uint64_t counter) {
+        rateLimitWaitsWriterCounter->Increment(counter);
+    }
+
     // swap_operations_mb
     void MetricsPrometheus::emitSwapOperationsMbDiscard(uint64_t counter) {
         swapOperationsMbDiscardCounter->Increment(counter);
@@ -419,6 +544,24 @@ namespace OpenLogReplicator {
         swapUsageMbGauge->Set(gauge);
     }
 
+    // table_cost
+    MetricsCounter* MetricsPrometheus::getTableCostCounter(TABLE_COST cost, const std::string& owner, const std::string& table) {
+        static const char* const costType[]{"bytes_buffered", "build_ns", "bytes_out", "messages"};
+
+        std::unique_lock<std::mutex> const lck(tableCostCounterMtx);
+        auto& counterMap = tableCostCounterMap[static_cast<uint>(cost)];
+        const std::string key(owner + "." + table);
+        const auto& it = counterMap.find(key);
+        if (it != counterMap.end())
+            return it->second.get();
+
+        auto* counter = new MetricsCounterPrometheus(&tableCost->Add({{"type",  costType[static_cast<uint>(cost)]},
+                                                                      {"owner", owner},
+                                                                      {"table", table}}));
+        counterMap.emplace(key, std::unique_ptr<MetricsCounterPrometheus>(counter));
+        return counter;
+    }
+
     // transactions
     void MetricsPrometheus::emitTransactionsCommitOut(uint64_t counter) {
         transactionsCommitOutCounter->Increment(counter);
@@ -443,4 +586,56 @@ namespace OpenLogReplicator {
     void MetricsPrometheus::emitTransactionsRollbackSkip(uint64_t counter) {
         transactionsRollbackSkipCounter->Increment(counter);
     }
+
+    // thread_context_us, thread_context_count, thread_reason_count
+    void MetricsPrometheus::incrementThreadCounter(prometheus::Family<prometheus::Counter>* family, const std::string& key,
+                                                   const prometheus::Labels& labels, uint64_t total) {
+        std::unique_lock<std::mutex> const lck(threadCountersMtx);
+        auto it = threadCountersMap.find(key);
+        if (it == threadCountersMap.end())
+            it = threadCountersMap.emplace(key, std::make_pair(&family->Add(labels), 0)).first;
+
+        auto& [counter, exported] = it->second;
+        if (total > exported) {
+            counter->Increment(static_cast<double>(total - exported));
+            exported = total;
+        }
+    }
+
+    void MetricsPrometheus::emitThreadContextUs(const std::string& thread, const std::string& context, uint64_t total) {
+        incrementThreadCounter(threadContextUs, "us/" + thread + "/" + context, {{"thread", thread}, {"context", context}}, total);
+    }
+
+    void MetricsPrometheus::emitThreadContextCount(const std::string& thread, const std::string& context, uint64_t total) {
+        incrementThreadCounter(threadContextCount, "count/" + thread + "/" + context, {{"thread", thread}, {"context", context}}, total);
+    }
+
+    void MetricsPrometheus::emitThreadReasonCount(const std::string& thread, uint reason, uint64_t total) {
+        const std::string reasonStr = std::to_string(reason);
+        incrementThreadCounter(threadReasonCount, "reason/" + thread + "/" + reasonStr, {{"thread", thread}, {"reason", reasonStr}}, total);
+    }
+
+    // latency_us
+    void MetricsPrometheus::emitLatencyUs(RuntimeStats::LATENCY stage, uint64_t us) {
+        latencyUsHistogram[static_cast<uint>(stage)]->Observe(static_cast<double>(us));
+    }
+
+    // transaction_pool
+    void MetricsPrometheus::emitTransactionPoolHit(uint64_t counter) {
+        transactionPoolHitCounter->Increment(counter);
+    }
+
+    void MetricsPrometheus::emitTransactionPoolMiss(uint64_t counter) {
+        transactionPoolMissCounter->Increment(counter);
+    }
+
+    // stalls, stall_samples
+    void MetricsPrometheus::emitStalls(uint64_t counter) {
+        stallsCounter->Increment(counter);
+    }
+
+    // Rare, the series is looked up by its labels every time
+    void MetricsPrometheus::emitStallSamples(const std::string& thread, const std::string& context, uint64_t counter) {
+        stallSamples->Add({{"thread", thread}, {"context", context}}).Increment(counter);
+    }
 }
@@ -18,9 +18,13 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 <http://www.gnu.org/licenses/>.  */
 
 #include <map>
+#include <memory>
+#include <mutex>
 #include <prometheus/counter.h>
 #include <prometheus/exposer.h>
+#include <prometheus/histogram.h>
 #include <prometheus/registry.h>
+#include <string>
 
 #include "Metrics.h"
 
@@ -28,12 +32,41 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #define METRICS_PROMETHEUS_H_
 
 namespace OpenLogReplicator {
+    class MetricsCounterPrometheus final : public MetricsCounter {
+    protected:
+        prometheus::Counter* counter;
+
+    public:
+        explicit MetricsCounterPrometheus(prometheus::Counter* newCounter) :
+                counter(newCounter) {
+        }
+
+        void increment(uint64_t value) override {
+            counter->Increment(static_cast<double>(value));
+        }
+    };
+
     class MetricsPrometheus final : public Metrics {
     protected:
+        // Registries of the tenants without an own listener, served together with a tenant label by the embedded HTTP server
+        static std::mutex sharedMtx;
+        static std::map<std::string, std::shared_ptr<prometheus::Registry>> sharedRegistries;
+
         std::string bind;
+        std::string tenant;
         prometheus::Exposer* exposer{nullptr};
         std::shared_ptr<prometheus::Registry> registry;
 
+        // builder_chunks_pinned
+        prometheus::Family<prometheus::Gauge>* builderChunksPinned{nullptr};
+        prometheus::Gauge* builderChunksPinnedGauge{nullptr};
+        prometheus::Family<prometheus::Gauge>* builderChunksPinnedMessages{nullptr};
+        prometheus::Gauge* builderChunksPinnedMessagesGauge{nullptr};
+
+        // builder_chunks_released_out_of_order
+        prometheus::Family<prometheus::Counter>* builderChunksReleasedOutOfOrder{nullptr};
+        prometheus::Counter* builderChunksReleasedOutOfOrderCounter{nullptr};
+
         // bytes_confirmed
         prometheus::Family<prometheus::Counter>* bytesConfirmed{nullptr};
         prometheus::Counter* bytesConfirmedCounter{nullptr};
@@ -59,6 +92,10 @@ namespace OpenLogReplicator {
         prometheus::Family<prometheus::Gauge>* checkpointLag{nullptr};
         prometheus::Gauge* checkpointLagGauge{nullptr};
 
+        // checkpoint_duration_us
+        prometheus::Family<prometheus::Gauge>* checkpointDurationUs{nullptr};
+        prometheus::Gauge* checkpointDurationUsGauge{nullptr};
+
         // ddl_ops
         prometheus::Family<prometheus::Counter>* ddlOps{nullptr};
         prometheus::Counter* ddlOpsAlterCounter{nullptr};
@@ -76,12 +113,8 @@ namespace OpenLogReplicator {
         prometheus::Counter* dmlOpsDeleteSkipCounter{nullptr};
         prometheus::Counter* dmlOpsInsertSkipCounter{nullptr};
         prometheus::Counter* dmlOpsUpdateSkipCounter{nullptr};
-        std::unordered_map<std::string, prometheus::Counter*> dmlOpsDeleteOutCounterMap;
-        std::unordered_map<std::string, prometheus::Counter*> dmlOpsInsertOutCounterMap;
-        std::unordered_map<std::string, prometheus::Counter*> dmlOpsUpdateOutCounterMap;
-        std::unordered_map<std::string, prometheus::Counter*> dmlOpsDeleteSkipCounterMap;
-        std::unordered_map<std::string, prometheus::Counter*> dmlOpsInsertSkipCounterMap;
-        std::unordered_map<std::string, prometheus::Counter*> dmlOpsUpdateSkipCounterMap;
+        std::mutex dmlOpsCounterMtx;
+        std::unordered_map<std::string, std::unique_ptr<MetricsCounterPrometheus>> dmlOpsCounterMap[static_cast<uint>(DML_OPS::NUM)];
 
         // log_switches
         prometheus::Family<prometheus::Counter>* logSwitches{nullptr};
@@ -110,6 +143,19 @@ namespace OpenLogReplicator {
         prometheus::Gauge* memoryUsedMbTransactionsGauge{nullptr};
         prometheus::Gauge* memoryUsedMbWriterGauge{nullptr};
 
+        // memory_node_hwm_mb
+        prometheus::Family<prometheus::Gauge>* memoryNodeHwmMb{nullptr};
+        std::mutex memoryNodeHwmMbMtx;
+        std::map<int64_t, prometheus::Gauge*> memoryNodeHwmMbGaugeMap;
+
+        // memory_trims
+        prometheus::Family<prometheus::Counter>* memoryTrims{nullptr};
+        prometheus::Counter* memoryTrimsCounter{nullptr};
+
+        // memory_trimmed_mb
+        prometheus::Family<prometheus::Counter>* memoryTrimmedMb{nullptr};
+        prometheus::Counter* memoryTrimmedMbCounter{nullptr};
+
         // messages_confirmed
         prometheus::Family<prometheus::Counter>* messagesConfirmed{nullptr};
         prometheus::Counter* messagesConfirmedCounter{nullptr};
@@ -118,6 +164,22 @@ namespace OpenLogReplicator {
         prometheus::Family<prometheus::Counter>* messagesSent{nullptr};
         prometheus::Counter* messagesSentCounter{nullptr};
 
+        // parser_stall_us
+        prometheus::Family<prometheus::Counter>* parserStallUs{nullptr};
+        prometheus::Counter* parserStallUsCounter{nullptr};
+
+        // rate_limit_wait_us
+        prometheus::Family<prometheus::Counter>* rateLimitWaitUs{nullptr};
+        prometheus::Counter* rateLimitWaitUsBackfillCounter{nullptr};
+        prometheus::Counter* rateLimitWaitUsTableCounter{nullptr};
+        prometheus::Counter* rateLimitWaitUsWriterCounter{nullptr};
+
+        // rate_limit_waits
+        prometheus::Family<prometheus::Counter>* rateLimitWaits{nullptr};
+        prometheus::Counter* rateLimitWaitsBackfillCounter{nullptr};
+        prometheus::Counter* rateLimitWaitsTableCounter{nullptr};
+        prometheus::Counter* rateLimitWaitsWriterCounter{nullptr};
+
         // swap_operations
         prometheus::Family<prometheus::Counter>* swapOperationsMb{nullptr};
         prometheus::Counter* swapOperationsMbDiscardCounter{nullptr};
@@ -128,6 +190,11 @@ namespace OpenLogReplicator {
         prometheus::Family<prometheus::Gauge>* swapUsageMb{nullptr};
         prometheus::Gauge* swapUsageMbGauge{nullptr};
 
+        // table_cost
+        prometheus::Family<prometheus::Counter>* tableCost{nullptr};
+        std::mutex tableCostCounterMtx;
+        std::unordered_map<std::string, std::unique_ptr<MetricsCounterPrometheus>> tableCostCounterMap[static_cast<uint>(TABLE_COST::NUM)];
+
         // transactions
         prometheus::Family<prometheus::Counter>* transactions{nullptr};
         prometheus::Counter* transactionsCommitOutCounter{nullptr};
@@ -137,13 +204,46 @@ namespace OpenLogReplicator {
         prometheus::Counter* transactionsCommitSkipCounter{nullptr};
         prometheus::Counter* transactionsRollbackSkipCounter{nullptr};
 
+        // thread_context_us, thread_context_count, thread_reason_count
+        prometheus::Family<prometheus::Counter>* threadContextUs{nullptr};
+        prometheus::Family<prometheus::Counter>* threadContextCount{nullptr};
+        prometheus::Family<prometheus::Counter>* threadReasonCount{nullptr};
+        std::mutex threadCountersMtx;
+        // Series with the total already exported, the thread reports totals and only the growth is added
+        std::unordered_map<std::string, std::pair<prometheus::Counter*, uint64_t>> threadCountersMap;
+
+        // transaction_pool
+        prometheus::Family<prometheus::Histogram>* latencyUs{nullptr};
+        prometheus::Histogram* latencyUsHistogram[static_cast<uint>(RuntimeStats::LATENCY::NUM)]{};
+
+        prometheus::Family<prometheus::Counter>* transactionPool{nullptr};
+        prometheus::Counter* transactionPoolHitCounter{nullptr};
+        prometheus::Counter* transactionPoolMissCounter{nullptr};
+
+        prometheus::Family<prometheus::Counter>* stalls{nullptr};
+        prometheus::Counter* stallsCounter{nullptr};
+        prometheus::Family<prometheus::Counter>* stallSamples{nullptr};
+
+        void incrementThreadCounter(prometheus::Family<prometheus::Counter>* family, const std::string& key, const prometheus::Labels& labels,
+                                    uint64_t total);
+
     public:
-        MetricsPrometheus(TAG_NAMES newTagNames, std::string newBind);
+        // With an empty bind address the metrics are not exposed by the tenant, see serializeShared()
+        MetricsPrometheus(TAG_NAMES newTagNames, std::string newBind, std::string newTenant);
         ~MetricsPrometheus() override;
 
+        [[nodiscard]] static std::string serializeShared();
+
         void initialize(const Ctx* ctx) override;
         void shutdown() override;
 
+        // builder_chunks_pinned
+        void emitBuilderChunksPinned(int64_t gauge) override;
+        void emitBuilderChunksPinnedMessages(int64_t gauge) override;
+
+        // builder_chunks_released_out_of_order
+        void emitBuilderChunksReleasedOutOfOrder(uint64_t counter) override;
+
         // bytes_confirmed
         void emitBytesConfirmed(uint64_t counter) override;
 
@@ -163,6 +263,9 @@ namespace OpenLogReplicator {
         // checkpoint_lag
         void emitCheckpointLag(int64_t gauge) override;
 
+        // checkpoint_duration_us
+        void emitCheckpointDurationUs(int64_t gauge) override;
+
         // ddl_ops
         void emitDdlOpsAlter(uint64_t counter) override;
         void emitDdlOpsCreate(uint64_t counter) override;
@@ -178,12 +281,7 @@ namespace OpenLogReplicator {
         void emitDmlOpsDeleteSkip(uint64_t counter) override;
         void emitDmlOpsInsertSkip(uint64_t counter) override;
         void emitDmlOpsUpdateSkip(uint64_t counter) override;
-        void emitDmlOpsDeleteOut(uint64_t counter, const std::string& owner, const std::string& table) override;
-        void emitDmlOpsInsertOut(uint64_t counter, const std::string& owner, const std::string& table) override;
-        void emitDmlOpsUpdateOut(uint64_t counter, const std::string& owner, const std::string& table) override;
-        void emitDmlOpsDeleteSkip(uint64_t counter, const std::string& owner, const std::string& table) override;
-        void emitDmlOpsInsertSkip(uint64_t counter, const std::string& owner, const std::string& table) override;
-        void emitDmlOpsUpdateSkip(uint64_t counter, const std::string& owner, const std::string& table) override;
+        [[nodiscard]] MetricsCounter* getDmlOpsCounter(DML_OPS op, const std::string& owner, const std::string& table) override;
 
         // log_switches
         void emitLogSwitchesArchived(uint64_t counter) override;
@@ -207,12 +305,34 @@ namespace OpenLogReplicator {
         void emitMemoryUsedMbTransactions(int64_t gauge) override;
         void emitMemoryUsedMbWriter(int64_t gauge) override;
 
+        // memory_node_hwm_mb
+        void emitMemoryNodeHwmMb(int64_t node, int64_t gauge) override;
+
+        // memory_trims
+        void emitMemoryTrims(uint64_t counter) override;
+
+        // memory_trimmed_mb
+        void emitMemoryTrimmedMb(uint64_t counter) override;
+
         // messages_confirmed
         void emitMessagesConfirmed(uint64_t counter) override;
 
         // messages sent
         void emitMessagesSent(uint64_t counter) override;
 
+        // parser_stall_us
+        void emitParserStallUs(uint64_t counter) override;
+
+        // rate_limit_wait_us
+        void emitRateLimitWaitUsBackfill(uint64_t counter) override;
+        void emitRateLimitWaitUsTable(uint64_t counter) override;
+        void emitRateLimitWaitUsWriter(uint64_t counter) override;
+
+        // rate_limit_waits
+        void emitRateLimitWaitsBackfill(uint64_t counter) override;
+        void emitRateLimitWaitsTable(uint64_t counter) override;
+        void emitRateLimitWaitsWriter(uint64_t counter) override;
+
         // swap_operations
         void emitSwapOperationsMbDiscard(uint64_t counter) override;
         void emitSwapOperationsMbRead(uint64_t counter) override;
@@ -221,6 +341,9 @@ namespace OpenLogReplicator {
         // swap_usage_mb
         void emitSwapUsageMb(int64_t gauge) override;
 
+        // table_cost
+        [[nodiscard]] MetricsCounter* getTableCostCounter(TABLE_COST cost, const std::string& owner, const std::string& table) override;
+
         // transactions
         void emitTransactionsCommitOut(uint64_t counter) override;
         void emitTransactionsRollbackOut(uint64_t counter) override;
@@ -228,6 +351,22 @@ namespace OpenLogReplicator {
         void emitTransactionsRollbackPartial(uint64_t counter) override;
         void emitTransactionsCommitSkip(uint64_t counter) override;
         void emitTransactionsRollbackSkip(uint64_t counter) override;
+
+        // thread_context_us, thread_context_count, thread_reason_count
+        void emitThreadContextUs(const std::string& thread, const std::string& context, uint64_t total) override;
+        void emitThreadContextCount(const std::string& thread, const std::string& context, uint64_t total) override;
+        void emitThreadReasonCount(const std::string& thread, uint reason, uint64_t total) override;
+
+        // latency_us
+        void emitLatencyUs(RuntimeStats::LATENCY stage, uint64_t us) override;
+
+        // transaction_pool
+        void emitTransactionPoolHit(uint64_t counter) override;
+        void emitTransactionPoolMiss(uint64_t counter) override;
+
+        // stalls, stall_samples
+        void emitStalls(uint64_t counter) override;
+        void emitStallSamples(const std::string& thread, const std::string& context, uint64_t counter) override;
     };
 }
 
@@ -0,0 +1,333 @@
+/* Definition of flat map template class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifndef FLAT_MAP_H_
+#define FLAT_MAP_H_
+
+namespace OpenLogReplicator {
+    // Ordered map kept in sorted blocks of contiguous pairs instead of one tree node per entry. Lookups are two binary searches,
+    // iteration walks memory linearly and appending past the last key (checkpoint load order) costs no search or node allocation.
+    // A block is split when it grows over BLOCK_MAX, so an insert in the middle moves at most one block, not the whole map.
+    // The subset of the std::map interface used by TablePack and its readers is provided; any insert or erase invalidates iterators.
+    template<class Key, class Value>
+    class FlatMap final {
+    public:
+        using value_type = std::pair<Key, Value>;
+        using size_type = size_t;
+
+    protected:
+        static constexpr size_t BLOCK_MAX{512};
+        using Block = std::vector<value_type>;
+
+        // Blocks are never empty and hold consecutive key ranges
+        std::vector<Block> blocks;
+        size_t count{0};
+
+        template<bool isConst>
+        class Iterator final {
+            friend class FlatMap;
+            friend class Iterator<!isConst>;
+            using Blocks = std::conditional_t<isConst, const std::vector<Block>, std::vector<Block>>;
+
+            Blocks* blocks;
+            size_t block;
+            size_t pos;
+
+            Iterator(Blocks* newBlocks, size_t newBlock, size_t newPos) :
+                    blocks(newBlocks),
+                    block(newBlock),
+                    pos(newPos) {
+            }
+
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = FlatMap::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = std::conditional_t<isConst, const value_type*, value_type*>;
+            using reference = std::conditional_t<isConst, const value_type&, value_type&>;
+
+            Iterator() :
+                    blocks(nullptr),
+                    block(0),
+                    pos(0) {
+            }
+
+            template<bool otherConst, typename = std::enable_if_t<isConst && !otherConst>>
+            // NOLINTNEXTLINE(google-explicit-constructor)
+            Iterator(const Iterator<otherConst>& other) :
+                    blocks(other.blocks),
+                    block(other.block),
+                    pos(other.pos) {
+            }
+
+            reference operator*() const {
+                return (*blocks)[block][pos];
+            }
+
+            pointer operator->() const {
+                return &(*blocks)[block][pos];
+            }
+
+            Iterator& operator++() {
+                if (++pos == (*blocks)[block].size()) {
+                    ++block;
+                    pos = 0;
+                }
+                return *this;
+            }
+
+            Iterator operator++(int) {
+                Iterator it = *this;
+                ++*this;
+                return it;
+            }
+
+            Iterator& operator--() {
+                if (pos == 0) {
+                    --block;
+                    pos = (*blocks)[block].size();
+                }
+                --pos;
+                return *this;
+            }
+
+            Iterator operator--(int) {
+                Iterator it = *this;
+                --*this;
+                return it;
+            }
+
+            bool operator==(const Iterator& other) const {
+                return block == other.block && pos == other.pos;
+            }
+
+            bool operator!=(const Iterator& other) const {
+                return block != other.block || pos != other.pos;
+            }
+        };
+
+        static bool lessKey(const value_type& entry, const Key& key) {
+            return entry.first < key;
+        }
+
+        static bool lessEntry(const Key& key, const value_type& entry) {
+            return key < entry.first;
+        }
+
+        // First block whose last key is not less than the key
+        [[nodiscard]] size_t lowerBlock(const Key& key) const {
+            const auto it = std::lower_bound(blocks.cbegin(), blocks.cend(), key, [](const Block& block, const Key& k) {
+                return block.back().first < k;
+            });
+            return it - blocks.cbegin();
+        }
+
+        // First block whose last key is greater than the key
+        [[nodiscard]] size_t upperBlock(const Key& key) const {
+            const auto it = std::upper_bound(blocks.cbegin(), blocks.cend(), key, [](const Key& k, const Block& block) {
+                return k < block.back().first;
+            });
+            return it - blocks.cbegin();
+        }
+
+        [[nodiscard]] std::pair<size_t, size_t> lowerPos(const Key& key) const {
+            const size_t block = lowerBlock(key);
+            if (block == blocks.size())
+                return {block, 0};
+            const Block& entries = blocks[block];
+            return {block, std::lower_bound(entries.cbegin(), entries.cend(), key, lessKey) - entries.cbegin()};
+        }
+
+        [[nodiscard]] std::pair<size_t, size_t> upperPos(const Key& key) const {
+            const size_t block = upperBlock(key);
+            if (block == blocks.size())
+                return {block, 0};
+            const Block& entries = blocks[block];
+            return {block, std::upper_bound(entries.cbegin(), entries.cend(), key, lessEntry) - entries.cbegin()};
+        }
+
+        [[nodiscard]] bool isEqual(std::pair<size_t, size_t> where, const Key& key) const {
+            return where.first < blocks.size() && !(key < blocks[where.first][where.second].first);
+        }
+
+        template<class V>
+        std::pair<size_t, size_t> insertAt(std::pair<size_t, size_t> where, const Key& key, V&& value) {
+            auto [block, pos] = where;
+            if (blocks.empty()) {
+                blocks.emplace_back();
+                blocks.back().reserve(BLOCK_MAX);
+            } else if (block == blocks.size()) {
+                // Past the last key
+                --block;
+                pos = blocks[block].size();
+            }
+
+            Block& entries = blocks[block];
+            entries.emplace(entries.begin() + pos, key, std::forward<V>(value));
+            ++count;
+
+            if (entries.size() > BLOCK_MAX) {
+                const size_t half = entries.size() / 2;
+                Block upper;
+                upper.reserve(BLOCK_MAX);
+                std::move(entries.begin() + half, entries.end(), std::back_inserter(upper));
+                entries.erase(entries.begin() + half, entries.end());
+                blocks.insert(blocks.begin() + block + 1, std::move(upper));
+                if (pos >= half)
+                    return {block + 1, pos - half};
+            }
+            return {block, pos};
+        }
+
+        template<class V>
+        std::pair<size_t, size_t> append(const Key& key, V&& value) {
+            if (blocks.empty() || blocks.back().size() >= BLOCK_MAX) {
+                blocks.emplace_back();
+                blocks.back().reserve(BLOCK_MAX);
+            }
+            blocks.back().emplace_back(key, std::forward<V>(value));
+            ++count;
+            return {blocks.size() - 1, blocks.back().size() - 1};
+        }
+
+    public:
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+        iterator begin() {
+            return iterator(&blocks, 0, 0);
+        }
+
+        iterator end() {
+            return iterator(&blocks, blocks.size(), 0);
+        }
+
+        const_iterator begin() const {
+            return const_iterator(&blocks, 0, 0);
+        }
+
+        const_iterator end() const {
+            return const_iterator(&blocks, blocks.size(), 0);
+        }
+
+        const_iterator cbegin() const {
+            return begin();
+        }
+
+        const_iterator cend() const {
+            return end();
+        }
+
+        [[nodiscard]] bool empty() const {
+            return count == 0;
+        }
+
+        [[nodiscard]] size_t size() const {
+            return count;
+        }
+
+        iterator find(const Key& key) {
+            const auto where = lowerPos(key);
+            if (!isEqual(where, key))
+                return end();
+            return iterator(&blocks, where.first, where.second);
+        }
+
+        const_iterator find(const Key& key) const {
+            const auto where = lowerPos(key);
+            if (!isEqual(where, key))
+                return end();
+            return const_iterator(&blocks, where.first, where.second);
+        }
+
+        iterator lower_bound(const Key& key) {
+            const auto where = lowerPos(key);
+            return iterator(&blocks, where.first, where.second);
+        }
+
+        const_iterator lower_bound(const Key& key) const {
+            const auto where = lowerPos(key);
+            return const_iterator(&blocks, where.first, where.second);
+        }
+
+        iterator upper_bound(const Key& key) {
+            const auto where = upperPos(key);
+            return iterator(&blocks, where.first, where.second);
+        }
+
+        const_iterator upper_bound(const Key& key) const {
+            const auto where = upperPos(key);
+            return const_iterator(&blocks, where.first, where.second);
+        }
+
+        template<class V>
+        std::pair<iterator, bool> insert_or_assign(const Key& key, V&& value) {
+            const auto where = lowerPos(key);
+            if (isEqual(where, key)) {
+                blocks[where.first][where.second].second = std::forward<V>(value);
+                return {iterator(&blocks, where.first, where.second), false};
+            }
+            const auto inserted = insertAt(where, key, std::forward<V>(value));
+            return {iterator(&blocks, inserted.first, inserted.second), true};
+        }
+
+        // The hint is only used to recognize an append past the last key, an existing key is left unchanged
+        template<class V>
+        iterator emplace_hint(const_iterator hint, const Key& key, V&& value) {
+            if (hint == cend() && (blocks.empty() || blocks.back().back().first < key)) {
+                const auto appended = append(key, std::forward<V>(value));
+                return iterator(&blocks, appended.first, appended.second);
+            }
+
+            const auto where = lowerPos(key);
+            if (isEqual(where, key))
+                return iterator(&blocks, where.first, where.second);
+            const auto inserted = insertAt(where, key, std::forward<V>(value));
+            return iterator(&blocks, inserted.first, inserted.second);
+        }
+
+        iterator erase(const_iterator it) {
+            Block& entries = blocks[it.block];
+            entries.erase(entries.begin() + it.pos);
+            --count;
+
+            if (entries.empty()) {
+                blocks.erase(blocks.begin() + it.block);
+                return iterator(&blocks, it.block, 0);
+            }
+            if (it.pos == entries.size())
+                return iterator(&blocks, it.block + 1, 0);
+            return iterator(&blocks, it.block, it.pos);
+        }
+
+        void clear() {
+            blocks.clear();
+            count = 0;
+        }
+    };
+}
+
+#endif
@@ -17,6 +17,7 @@ You should have received a copy of the GNU General Public License
 along with OpenLogReplicator; see the file LICENSE;  If not see
 <http://www.gnu.org/licenses/>.  */
 
+#include <iterator>
 #include <map>
 #include <memory>
 #include <set>
@@ -26,24 +27,34 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include "../types/FileOffset.h"
 #include "../types/RowId.h"
 #include "../types/Types.h"
+#include "FlatMap.h"
 
 #ifndef TABLE_PACK_H_
 #define TABLE_PACK_H_
 
 namespace OpenLogReplicator {
+    template<class Key, class Value>
+    using TreeMap = std::map<Key, Value>;
 
-    template<class Data, class KeyMap = TabRowIdKeyDefault, class KeyUnorderedMap = TabRowIdUnorderedKeyDefault>
+    // Large dictionaries which are mostly bulk loaded use FlatMap for the ordered maps, the rest keep node based TreeMap
+    template<class Data, class KeyMap = TabRowIdKeyDefault, class KeyUnorderedMap = TabRowIdUnorderedKeyDefault,
+             template<class, class> class OrderedMap = TreeMap>
     class TablePack final {
     public:
-        std::map<RowId, Data*> mapRowId;
-        std::map<KeyMap, Data*> mapKey;
+        OrderedMap<RowId, Data*> mapRowId;
+        OrderedMap<KeyMap, Data*> mapKey;
         std::unordered_map<KeyUnorderedMap, Data*> unorderedMapKey;
         std::set<Data*> setTouched;
+        // Rows inserted, updated or deleted since the last full schema checkpoint
+        std::set<RowId> setChanged;
+        // Bumped on every change of the key maps, lookup tables derived from them are rebuilt when it differs
+        uint64_t version{0};
 
         [[nodiscard]] Data* forUpdate(const Ctx* ctx, RowId rowId, FileOffset fileOffset) {
             auto mapRowIdIt = mapRowId.find(rowId);
             if (likely(mapRowIdIt != mapRowId.end())) {
                 dropKeys(mapRowIdIt->second);
+                setChanged.insert(rowId);
                 return mapRowIdIt->second;
             }
 
@@ -55,6 +66,7 @@ namespace OpenLogReplicator {
             }
             auto data = new Data(rowId);
             mapRowId.insert_or_assign(rowId, data);
+            setChanged.insert(rowId);
             return data;
         }
 
@@ -81,6 +93,8 @@ namespace OpenLogReplicator {
                 delete data;
             }
             mapRowId.clear();
+            setChanged.clear();
+            ++version;
 
             if constexpr (!std::is_same_v<KeyMap, TabRowIdKeyDefault>) {
                 if (!mapKey.empty())
@@ -95,6 +109,28 @@ namespace OpenLogReplicator {
             }
         }
 
+        // Deep copy of the rows with their keys. Touched rows are not carried over, a copied pack is never touched
+        void copyFrom(const TablePack& other) {
+            for (const auto& [rowId, data]: other.mapRowId) {
+                auto copy = new Data(*data);
+                mapRowId.emplace_hint(mapRowId.end(), rowId, copy);
+                addKeys(copy);
+            }
+            setChanged = other.setChanged;
+            version = other.version + 1;
+        }
+
+        // Frees the rows without checking the keys, used when the pack is destroyed without a context
+        void release() {
+            for (auto& [_, data]: mapRowId)
+                delete data;
+            mapRowId.clear();
+            mapKey.clear();
+            unorderedMapKey.clear();
+            setTouched.clear();
+            setChanged.clear();
+        }
+
         bool compareTo(const TablePack& other, std::string& msgs) const {
             for (const auto& [_, data]: mapRowId) {
                 const auto& it = other.mapRowId.find(data->rowId);
@@ -135,6 +171,7 @@ namespace OpenLogReplicator {
                 mapRowId.insert_or_assign(rowId, data);
             }
             setTouched.insert(data);
+            setChanged.insert(rowId);
             return data;
         }
 
@@ -142,11 +179,17 @@ namespace OpenLogReplicator {
             if (unlikely(ctx->isTraceSet(Ctx::TRACE::SYSTEM)))
                 ctx->logTrace(Ctx::TRACE::SYSTEM, "add: " + Data::tableName() + " (" + data->toString() + ")");
 
-            const auto& it = mapRowId.find(data->rowId);
-            if (unlikely(it != mapRowId.end()))
-                throw RuntimeException(50022, "duplicate " + Data::tableName() + " (" + data->toString() + ") for insert");
-            mapRowId.insert_or_assign(data->rowId, data);
+            // Checkpoints are loaded in ROWID order, a row past the last one is appended without a lookup
+            if (mapRowId.empty() || std::prev(mapRowId.cend())->first < data->rowId) {
+                mapRowId.emplace_hint(mapRowId.end(), data->rowId, data);
+            } else {
+                const auto& it = mapRowId.find(data->rowId);
+                if (unlikely(it != mapRowId.end()))
+                    throw RuntimeException(50022, "duplicate " + Data::tableName() + " (" + data->toString() + ") for insert");
+                mapRowId.insert_or_assign(data->rowId, data);
+            }
             setTouched.insert(data);
+            setChanged.emplace_hint(setChanged.end(), data->rowId);
         }
 
         void addWithKeys(const Ctx* ctx, Data* data) {
@@ -166,12 +209,14 @@ namespace OpenLogReplicator {
 
             if (deleteTouched)
                 setTouched.erase(it->second);
+            setChanged.insert(rowId);
             dropKeys(it->second);
             delete it->second;
             mapRowId.erase(it);
         }
 
         void addKeys(Data* data) {
+            ++version;
             if constexpr (!std::is_same_v<KeyMap, TabRowIdKeyDefault>) {
                 KeyMap key(data);
                 const auto& it = mapKey.find(key);
@@ -190,6 +235,7 @@ namespace OpenLogReplicator {
         }
 
         void dropKeys(Data* data) {
+            ++version;
             if constexpr (!std::is_same_v<KeyMap, TabRowIdKeyDefault>) {
                 KeyMap key(data);
                 const auto& it = mapKey.find(key);
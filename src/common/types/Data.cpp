@@ -20,6 +20,12 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include <cctype>
 #include <string>
 
+#if defined(__x86_64__)
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 #include "Data.h"
 #include "Types.h"
 #include "../exception/DataException.h"
@@ -46,6 +52,25 @@ namespace OpenLogReplicator {
             0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
             0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
 
+    const char Data::map100[201]{
+        "0001020304050607080910111213141516171819"
+        "2021222324252627282930313233343536373839"
+        "4041424344454647484950515253545556575859"
+        "6061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899"
+    };
+
+    const char Data::map256[513]{
+        "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+        "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+        "404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f"
+        "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+        "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+        "a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+        "c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+        "e0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff"
+    };
+
     const int64_t Data::cumDays[12]{0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
     const int64_t Data::cumDaysLeap[12]{0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335};
 
@@ -342,6 +367,108 @@ namespace OpenLogReplicator {
         return 20;
     }
 
+    // Lower case hex, 16 input bytes per step with SSE2 or NEON, writes exactly size * 2 characters
+    void Data::hexEncode(const uint8_t* data, uint64_t size, char* out) {
+        uint64_t pos = 0;
+#if defined(__x86_64__)
+        const __m128i mask = _mm_set1_epi8(0x0F);
+        const __m128i nine = _mm_set1_epi8(9);
+        const __m128i zero = _mm_set1_epi8('0');
+        const __m128i letter = _mm_set1_epi8('a' - '0' - 10);
+        for (; pos + 16 <= size; pos += 16) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+            const __m128i high = _mm_and_si128(_mm_srli_epi16(chunk, 4), mask);
+            const __m128i low = _mm_and_si128(chunk, mask);
+            const __m128i first = _mm_unpacklo_epi8(high, low);
+            const __m128i second = _mm_unpackhi_epi8(high, low);
+            const __m128i firstChars = _mm_add_epi8(_mm_add_epi8(first, zero), _mm_and_si128(_mm_cmpgt_epi8(first, nine), letter));
+            const __m128i secondChars = _mm_add_epi8(_mm_add_epi8(second, zero), _mm_and_si128(_mm_cmpgt_epi8(second, nine), letter));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + (pos * 2)), firstChars);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + (pos * 2) + 16), secondChars);
+        }
+#elif defined(__aarch64__)
+        const uint8x16_t mask = vdupq_n_u8(0x0F);
+        const uint8x16_t nine = vdupq_n_u8(9);
+        const uint8x16_t zero = vdupq_n_u8('0');
+        const uint8x16_t letter = vdupq_n_u8('a' - '0' - 10);
+        for (; pos + 16 <= size; pos += 16) {
+            const uint8x16_t chunk = vld1q_u8(data + pos);
+            const uint8x16_t high = vshrq_n_u8(chunk, 4);
+            const uint8x16_t low = vandq_u8(chunk, mask);
+            uint8x16x2_t chars;
+            chars.val[0] = vaddq_u8(vaddq_u8(high, zero), vandq_u8(vcgtq_u8(high, nine), letter));
+            chars.val[1] = vaddq_u8(vaddq_u8(low, zero), vandq_u8(vcgtq_u8(low, nine), letter));
+            vst2q_u8(reinterpret_cast<uint8_t*>(out + (pos * 2)), chars);
+        }
+#endif
+        for (; pos < size; ++pos) {
+            out[pos * 2] = map256[data[pos] * 2];
+            out[(pos * 2) + 1] = map256[(data[pos] * 2) + 1];
+        }
+    }
+
+    // Standard alphabet with padding, writes exactly base64Size(size) characters
+    void Data::base64Encode(const uint8_t* data, uint64_t size, char* out) {
+        uint64_t pos = 0;
+        for (; pos + 3 <= size; pos += 3) {
+            const uint32_t triple = (static_cast<uint32_t>(data[pos]) << 16) | (static_cast<uint32_t>(data[pos + 1]) << 8) | data[pos + 2];
+            *out++ = map64L[(triple >> 18) & 0x3F];
+            *out++ = map64L[(triple >> 12) & 0x3F];
+            *out++ = map64L[(triple >> 6) & 0x3F];
+            *out++ = map64L[triple & 0x3F];
+        }
+
+        if (pos + 1 == size) {
+            const uint32_t triple = static_cast<uint32_t>(data[pos]) << 16;
+            *out++ = map64L[(triple >> 18) & 0x3F];
+            *out++ = map64L[(triple >> 12) & 0x3F];
+            *out++ = '=';
+            *out++ = '=';
+        } else if (pos + 2 == size) {
+            const uint32_t triple = (static_cast<uint32_t>(data[pos]) << 16) | (static_cast<uint32_t>(data[pos + 1]) << 8);
+            *out++ = map64L[(triple >> 18) & 0x3F];
+            *out++ = map64L[(triple >> 12) & 0x3F];
+            *out++ = map64L[(triple >> 6) & 0x3F];
+            *out++ = '=';
+        }
+    }
+
+    // Same escaping as BuilderJson::appendEscape, used for the precomputed name fragments
+    void Data::appendJsonEscape(std::string& out, const std::string& str) {
+        for (const char character: str) {
+            switch (character) {
+                case '\t':
+                    out.append("\\t");
+                    break;
+                case '\r':
+                    out.append("\\r");
+                    break;
+                case '\n':
+                    out.append("\\n");
+                    break;
+                case '\f':
+                    out.append("\\f");
+                    break;
+                case '\b':
+                    out.append("\\b");
+                    break;
+                case '"':
+                case '\\':
+                case '/':
+                    out.push_back('\\');
+                    out.push_back(character);
+                    break;
+                default:
+                    if (character >= 0 && character < 31) {
+                        out.append("\\u00");
+                        out.push_back(map10((character / 10) % 10));
+                        out.push_back(map10(character % 10));
+                    } else
+                        out.push_back(character);
+            }
+        }
+    }
+
     std::ostringstream& Data::writeEscapeValue(std::ostringstream& ss, const std::string& str) {
         const char* c_str = str.c_str();
         for (uint i = 0; i < str.length(); ++i) {
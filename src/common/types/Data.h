@@ -52,6 +52,10 @@ namespace OpenLogReplicator {
         static const char map64L[65];
         static const char map64R[256];
 
+        // Two decimal digits of 0-99 and two lower case hex digits of 0-255 per entry
+        static const char map100[201];
+        static const char map256[513];
+
         static const int64_t cumDays[12];
         static const int64_t cumDaysLeap[12];
 
@@ -59,6 +63,48 @@ namespace OpenLogReplicator {
             return static_cast<char>('0' + x);
         }
 
+        static uint decLength(uint64_t value) {
+            uint length = 1;
+            while (true) {
+                if (value < 10)
+                    return length;
+                if (value < 100)
+                    return length + 1;
+                if (value < 1000)
+                    return length + 2;
+                if (value < 10000)
+                    return length + 3;
+                value /= 10000;
+                length += 4;
+            }
+        }
+
+        // Writes exactly length digits of value ending just before end, two digits per step
+        static void decToChars(uint64_t value, char* end, uint length) {
+            while (length >= 2) {
+                const uint pair = static_cast<uint>(value % 100) * 2;
+                value /= 100;
+                *--end = map100[pair + 1];
+                *--end = map100[pair];
+                length -= 2;
+            }
+            if (length > 0)
+                *--end = map10(value % 10);
+        }
+
+        // Writes exactly length hex digits of value ending just before end, one byte per step
+        static void hexToChars(uint64_t value, char* end, uint length) {
+            while (length >= 2) {
+                const uint pair = static_cast<uint>(value & 0xFF) * 2;
+                value >>= 8;
+                *--end = map256[pair + 1];
+                *--end = map256[pair];
+                length -= 2;
+            }
+            if (length > 0)
+                *--end = map16(value & 0xF);
+        }
+
         static char map16(uint x) {
             if (x < 10)
                 return static_cast<char>('0' + x);
@@ -79,7 +125,13 @@ namespace OpenLogReplicator {
         static std::string timezoneToString(int64_t tz);
         static time_t valuesToEpoch(int year, int month, int day, int hour, int minute, int second, int tz);
         static uint64_t epochToIso8601(time_t timestamp, char* buffer, bool addT, bool addZ);
+        static void hexEncode(const uint8_t* data, uint64_t size, char* out);
+        static uint64_t base64Size(uint64_t size) {
+            return ((size + 2) / 3) * 4;
+        }
+        static void base64Encode(const uint8_t* data, uint64_t size, char* out);
         static std::ostringstream& writeEscapeValue(std::ostringstream& ss, const std::string& str);
+        static void appendJsonEscape(std::string& out, const std::string& str);
         static bool checkNameCase(const std::string& name);
     };
 }
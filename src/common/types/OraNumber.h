@@ -0,0 +1,169 @@
+/* Definition of type OraNumber
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef ORA_NUMBER_H_
+#define ORA_NUMBER_H_
+
+#include <cstdint>
+
+namespace OpenLogReplicator {
+    // Oracle NUMBER decoded to sign, 128-bit decimal mantissa and decimal exponent: (-1)^negative * mantissa * 10^exponent
+    class OraNumber final {
+    public:
+        static constexpr uint32_t DIGITS_MAX{38};
+
+    protected:
+        static constexpr uint64_t DOUBLE_EXACT_MAX{1ULL << 53};
+        static constexpr uint64_t FLOAT_EXACT_MAX{1ULL << 24};
+        static constexpr int32_t DOUBLE_POW10_MAX{22};
+        static constexpr int32_t FLOAT_POW10_MAX{10};
+
+        static void mulAdd(uint64_t& high, uint64_t& low, uint32_t mul, uint32_t add) {
+            const uint64_t lowLo = (low & 0xFFFFFFFF) * mul + add;
+            const uint64_t lowHi = (low >> 32) * mul + (lowLo >> 32);
+            low = (lowHi << 32) | (lowLo & 0xFFFFFFFF);
+            high = high * mul + (lowHi >> 32);
+        }
+
+        static double pow10d(int32_t exp) {
+            static constexpr double POW10[DOUBLE_POW10_MAX + 1]{
+                1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+            };
+            return POW10[exp];
+        }
+
+        static float pow10f(int32_t exp) {
+            static constexpr float POW10[FLOAT_POW10_MAX + 1]{
+                1e0F, 1e1F, 1e2F, 1e3F, 1e4F, 1e5F, 1e6F, 1e7F, 1e8F, 1e9F, 1e10F
+            };
+            return POW10[exp];
+        }
+
+    public:
+        uint64_t mantissaHigh{0};
+        uint64_t mantissaLow{0};
+        int32_t exponent{0};
+        uint32_t digits{0};
+        bool negative{false};
+
+        // Returns false for a malformed value or a mantissa longer than DIGITS_MAX, the caller falls back to the text conversion
+        [[nodiscard]] bool decode(const uint8_t* data, uint64_t size) {
+            mantissaHigh = 0;
+            mantissaLow = 0;
+            exponent = 0;
+            digits = 0;
+            negative = false;
+
+            if (size == 0)
+                return false;
+
+            // Just zero
+            if (data[0] == 0x80)
+                return size == 1;
+
+            uint64_t pairs = size - 1;
+            int32_t pairExponent;
+            if (data[0] > 0x80) {
+                pairExponent = static_cast<int32_t>(data[0]) - 0xC1;
+            } else {
+                negative = true;
+                if (pairs > 0 && data[pairs] == 0x66)
+                    --pairs;
+                pairExponent = 0x3E - static_cast<int32_t>(data[0]);
+            }
+            if (pairs == 0)
+                return false;
+
+            for (uint64_t i = 1; i <= pairs; ++i) {
+                const int32_t pair = negative ? 101 - static_cast<int32_t>(data[i]) : static_cast<int32_t>(data[i]) - 1;
+                if (pair < 0 || pair > 99)
+                    return false;
+
+                if (i == 1) {
+                    digits = pair < 10 ? 1 : 2;
+                    mantissaLow = pair;
+                } else if (i == pairs && pair % 10 == 0) {
+                    // Drop the trailing zero of the last pair
+                    digits += 1;
+                    mulAdd(mantissaHigh, mantissaLow, 10, pair / 10);
+                    ++exponent;
+                } else {
+                    digits += 2;
+                    if (digits > DIGITS_MAX)
+                        return false;
+                    mulAdd(mantissaHigh, mantissaLow, 100, pair);
+                }
+            }
+            if (digits > DIGITS_MAX)
+                return false;
+
+            exponent += 2 * (pairExponent - static_cast<int32_t>(pairs) + 1);
+            return true;
+        }
+
+        [[nodiscard]] bool toInt64(int64_t& value) const {
+            if (mantissaHigh != 0 || exponent < 0)
+                return false;
+
+            uint64_t magnitude = mantissaLow;
+            const uint64_t limit = negative ? 0x8000000000000000ULL : 0x7FFFFFFFFFFFFFFFULL;
+            if (magnitude > limit)
+                return false;
+            for (int32_t i = 0; i < exponent; ++i) {
+                if (magnitude > limit / 10)
+                    return false;
+                magnitude *= 10;
+            }
+
+            value = negative ? static_cast<int64_t>(0 - magnitude) : static_cast<int64_t>(magnitude);
+            return true;
+        }
+
+        // Only converts when the result is the correctly rounded one, that is when both the mantissa and the power of 10 are exact
+        [[nodiscard]] bool toDouble(double& value) const {
+            if (mantissaHigh != 0 || mantissaLow > DOUBLE_EXACT_MAX || exponent > DOUBLE_POW10_MAX || exponent < -DOUBLE_POW10_MAX)
+                return false;
+
+            value = static_cast<double>(mantissaLow);
+            if (exponent >= 0)
+                value *= pow10d(exponent);
+            else
+                value /= pow10d(-exponent);
+            if (negative)
+                value = -value;
+            return true;
+        }
+
+        [[nodiscard]] bool toFloat(float& value) const {
+            if (mantissaHigh != 0 || mantissaLow > FLOAT_EXACT_MAX || exponent > FLOAT_POW10_MAX || exponent < -FLOAT_POW10_MAX)
+                return false;
+
+            value = static_cast<float>(mantissaLow);
+            if (exponent >= 0)
+                value *= pow10f(exponent);
+            else
+                value /= pow10f(-exponent);
+            if (negative)
+                value = -value;
+            return true;
+        }
+    };
+}
+
+#endif
@@ -72,6 +72,13 @@ using uint = unsigned int;
 
 #define likely(x)                               __builtin_expect(!!(x),1)
 #define unlikely(x)                             __builtin_expect(!!(x),0)
+#if defined(__x86_64__)
+#define CPU_RELAX()                             __builtin_ia32_pause()
+#elif defined(__aarch64__)
+#define CPU_RELAX()                             asm volatile("yield" ::: "memory")
+#else
+#define CPU_RELAX()                             asm volatile("" ::: "memory")
+#endif
 
 #define BLOCK(__uba)                            (static_cast<uint32_t>((__uba)&0xFFFFFFFF))
 #define SEQUENCE(__uba)                         (static_cast<uint16_t>(((static_cast<uint64_t>(__uba))>>32)&0xFFFF))
@@ -17,6 +17,12 @@ You should have received a copy of the GNU General Public License
 along with OpenLogReplicator; see the file LICENSE;  If not see
 <http://www.gnu.org/licenses/>.  */
 
+#if defined(__x86_64__)
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 #include "CharacterSet.h"
 #include "../common/Ctx.h"
 #include "../common/types/Types.h"
@@ -26,6 +32,35 @@ namespace OpenLogReplicator {
             name(std::move(newName)) {
     }
 
+    // Offset of every byte within the range multiplied by the stride, INDEX_INVALID outside of it. A sum of such entries for all bytes of
+    // a sequence is the map index, or at least INDEX_INVALID when any of the bytes is out of range
+    void CharacterSet::buildIndex(uint32_t* index, uint64_t min, uint64_t max, uint64_t stride) {
+        for (uint64_t i = 0; i < 256; ++i)
+            index[i] = (i >= min && i <= max) ? static_cast<uint32_t>((i - min) * stride) : INDEX_INVALID;
+    }
+
+    uint64_t CharacterSet::decodeRun(const uint8_t* str, uint64_t length) const {
+        if (!asciiCompatible)
+            return 0;
+
+        uint64_t pos = 0;
+#if defined(__x86_64__)
+        for (; pos + 16 <= length; pos += 16) {
+            const int mask = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(str + pos)));
+            if (mask != 0)
+                return pos + __builtin_ctz(static_cast<uint>(mask));
+        }
+#elif defined(__aarch64__)
+        for (; pos + 16 <= length; pos += 16) {
+            if (vmaxvq_u8(vld1q_u8(str + pos)) >= 0x80)
+                break;
+        }
+#endif
+        while (pos < length && str[pos] < 0x80)
+            ++pos;
+        return pos;
+    }
+
     uint64_t CharacterSet::badChar(const Ctx* ctx, Xid xid, uint64_t byte1) const {
         ctx->warning(60008, "can't decode character: (" + std::to_string(byte1) + ") using character set " + name + ", xid: " +
                             xid.toString());
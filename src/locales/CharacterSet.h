@@ -32,6 +32,13 @@ namespace OpenLogReplicator {
         static constexpr uint64_t UNICODE_UNKNOWN_CHARACTER{0xFFFD};
 
     protected:
+        static constexpr uint32_t INDEX_INVALID{0x40000000};
+
+        // Bytes 0x00 - 0x7F decode to the same code point
+        bool asciiCompatible{false};
+
+        static void buildIndex(uint32_t* index, uint64_t min, uint64_t max, uint64_t stride);
+
         [[nodiscard]] uint64_t badChar(const Ctx* ctx, Xid xid, uint64_t byte1) const;
         [[nodiscard]] uint64_t badChar(const Ctx* ctx, Xid xid, uint64_t byte1, uint64_t byte2) const;
         [[nodiscard]] uint64_t badChar(const Ctx* ctx, Xid xid, uint64_t byte1, uint64_t byte2, uint64_t byte3) const;
@@ -47,6 +54,8 @@ namespace OpenLogReplicator {
         virtual ~CharacterSet() = default;
 
         virtual typeUnicode decode(const Ctx* ctx, Xid xid, const uint8_t*& str, uint64_t& length) const = 0;
+        // Length of the leading run that decodes to itself, so it can be copied without calling decode per character
+        [[nodiscard]] uint64_t decodeRun(const uint8_t* str, uint64_t length) const;
     };
 }
 
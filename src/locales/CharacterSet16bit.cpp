@@ -30,6 +30,9 @@ namespace OpenLogReplicator {
             byte1max(newByte1max),
             byte2min(newByte2min),
             byte2max(newByte2max) {
+        asciiCompatible = true;
+        buildIndex(byte1Index, byte1min, byte1max, byte2max - byte2min + 1);
+        buildIndex(byte2Index, byte2min, byte2max, 1);
     }
 
     typeUnicode CharacterSet16bit::decode(const Ctx* ctx, Xid xid, const uint8_t*& str, uint64_t& length) const {
@@ -44,14 +47,14 @@ namespace OpenLogReplicator {
         const uint64_t byte2 = *str++;
         --length;
 
-        if (byte1 < byte1min || byte1 > byte1max || byte2 < byte2min || byte2 > byte2max)
+        if (mapIndex(byte1, byte2) >= INDEX_INVALID)
             return badChar(ctx, xid, byte1, byte2);
 
         return readMap(byte1, byte2);
     }
 
     uint64_t CharacterSet16bit::readMap(uint64_t byte1, uint64_t byte2) const {
-        return map[((byte1 - byte1min) * (byte2max - byte2min + 1)) + (byte2 - byte2min)];
+        return map[mapIndex(byte1, byte2)];
     }
 
     typeUnicode16 CharacterSet16bit::unicode_map_JA16VMS[(JA16VMS_b1_max - JA16VMS_b1_min + 1) *
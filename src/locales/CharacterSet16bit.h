@@ -71,6 +71,15 @@ namespace OpenLogReplicator {
         uint64_t byte1max;
         uint64_t byte2min;
         uint64_t byte2max;
+        // Row offset for every lead byte and column for every trail byte, built from the ranges, the sum is the map index
+        uint32_t byte1Index[256];
+        uint32_t byte2Index[256];
+
+        // At least INDEX_INVALID when any of the bytes is out of range
+        [[nodiscard]] uint64_t mapIndex(uint64_t byte1, uint64_t byte2) const {
+            return static_cast<uint64_t>(byte1Index[byte1]) + byte2Index[byte2];
+        }
+
         [[nodiscard]] virtual typeUnicode readMap(uint64_t byte1, uint64_t byte2) const;
 
     public:
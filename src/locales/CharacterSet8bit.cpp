@@ -22,11 +22,13 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 namespace OpenLogReplicator {
     CharacterSet8bit::CharacterSet8bit(std::string newName, const typeUnicode16* newMap) :
             CharacterSet7bit(std::move(newName), newMap) {
+        asciiCompatible = true;
     }
 
     CharacterSet8bit::CharacterSet8bit(std::string newName, const typeUnicode16* newMap, bool newCustomAscii) :
             CharacterSet7bit(std::move(newName), newMap),
             customAscii(newCustomAscii) {
+        asciiCompatible = !customAscii;
     }
 
     typeUnicode CharacterSet8bit::decode(const Ctx* ctx __attribute__((unused)), Xid xid __attribute__((unused)), const uint8_t*& str, uint64_t& length) const {
@@ -22,6 +22,7 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 namespace OpenLogReplicator {
     CharacterSetAL32UTF8::CharacterSetAL32UTF8() :
             CharacterSet("AL32UTF8") {
+        asciiCompatible = true;
     }
 
     typeUnicode CharacterSetAL32UTF8::decode(const Ctx* ctx, Xid xid, const uint8_t*& str, uint64_t& length) const {
@@ -22,10 +22,12 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 namespace OpenLogReplicator {
     CharacterSetJA16EUC::CharacterSetJA16EUC() :
             CharacterSet("JA16EUC") {
+        asciiCompatible = true;
     }
 
     CharacterSetJA16EUC::CharacterSetJA16EUC(std::string newName) :
             CharacterSet(std::move(newName)) {
+        asciiCompatible = true;
     }
 
     uint64_t CharacterSetJA16EUC::decode(const Ctx* ctx, Xid xid, const uint8_t*& str, uint64_t& length) const {
@@ -22,6 +22,7 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 namespace OpenLogReplicator {
     CharacterSetUTF8::CharacterSetUTF8() :
             CharacterSet("UTF8") {
+        asciiCompatible = true;
     }
 
     typeUnicode CharacterSetUTF8::decode(const Ctx* ctx, Xid xid, const uint8_t*& str, uint64_t& length) const {
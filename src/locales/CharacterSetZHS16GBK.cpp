@@ -40,7 +40,7 @@ namespace OpenLogReplicator {
         const uint64_t byte2 = *str++;
         --length;
 
-        if (byte1 < byte1min || byte1 > byte1max || byte2 < byte2min || byte2 > byte2max)
+        if (mapIndex(byte1, byte2) >= INDEX_INVALID)
             return badChar(ctx, xid, byte1, byte2);
 
         return readMap(byte1, byte2);
@@ -22,6 +22,22 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 namespace OpenLogReplicator {
     CharacterSetZHS32GB18030::CharacterSetZHS32GB18030() :
         CharacterSet("ZHS32GB18030") {
+        static_assert(ZHS32GB18030_41_b2_min == ZHS32GB18030_42_b2_min && ZHS32GB18030_41_b2_max == ZHS32GB18030_42_b2_max &&
+                      ZHS32GB18030_41_b3_min == ZHS32GB18030_42_b3_min && ZHS32GB18030_41_b3_max == ZHS32GB18030_42_b3_max &&
+                      ZHS32GB18030_41_b4_min == ZHS32GB18030_42_b4_min && ZHS32GB18030_41_b4_max == ZHS32GB18030_42_b4_max);
+        asciiCompatible = true;
+
+        buildIndex(byte1Index2b, ZHS32GB18030_2_b1_min, ZHS32GB18030_2_b1_max, ZHS32GB18030_2_b2_max - ZHS32GB18030_2_b2_min + 1);
+        buildIndex(byte2Index2b, ZHS32GB18030_2_b2_min, ZHS32GB18030_2_b2_max, 1);
+        byte2Index2b[0x7F] = INDEX_INVALID;
+
+        buildIndex(byte1Index4b1, ZHS32GB18030_41_b1_min, ZHS32GB18030_41_b1_max,
+                   ZHS32GB18030_4_b2_size * ZHS32GB18030_4_b3_size * ZHS32GB18030_4_b4_size);
+        buildIndex(byte1Index4b2, ZHS32GB18030_42_b1_min, ZHS32GB18030_42_b1_max,
+                   ZHS32GB18030_4_b2_size * ZHS32GB18030_4_b3_size * ZHS32GB18030_4_b4_size);
+        buildIndex(byte2Index4b, ZHS32GB18030_41_b2_min, ZHS32GB18030_41_b2_max, ZHS32GB18030_4_b3_size * ZHS32GB18030_4_b4_size);
+        buildIndex(byte3Index4b, ZHS32GB18030_41_b3_min, ZHS32GB18030_41_b3_max, ZHS32GB18030_4_b4_size);
+        buildIndex(byte4Index4b, ZHS32GB18030_41_b4_min, ZHS32GB18030_41_b4_max, 1);
     }
 
     typeUnicode CharacterSetZHS32GB18030::decode(const Ctx* ctx, Xid xid, const uint8_t*& str, uint64_t& length) const {
@@ -37,13 +53,11 @@ namespace OpenLogReplicator {
         --length;
 
         // 2 bytes sequence
-        if (byte2 >= ZHS32GB18030_2_b2_min && byte2 <= ZHS32GB18030_2_b2_max) {
-            if (byte2 == 0x7F)
-                return badChar(ctx, xid, byte1, byte2);
-
-            return unicode_map_ZHS32GB18030_2b[(byte1 - ZHS32GB18030_2_b1_min) * (ZHS32GB18030_2_b2_max - ZHS32GB18030_2_b2_min + 1)
-                              + (byte2 - ZHS32GB18030_2_b2_min)];
-        }
+        const uint64_t index2 = static_cast<uint64_t>(byte1Index2b[byte1]) + byte2Index2b[byte2];
+        if (index2 < INDEX_INVALID)
+            return unicode_map_ZHS32GB18030_2b[index2];
+        if (byte2 == 0x7F)
+            return badChar(ctx, xid, byte1, byte2);
 
         // 4 bytes sequence
         if (length == 0)
@@ -58,32 +72,21 @@ namespace OpenLogReplicator {
         const uint64_t byte4 = *str++;
         --length;
 
-        // 4 bytes group 1
-        if (byte1 >= ZHS32GB18030_41_b1_min && byte1 <= ZHS32GB18030_41_b1_max &&
-                byte2 >= ZHS32GB18030_41_b2_min && byte2 <= ZHS32GB18030_41_b2_max &&
-                byte3 >= ZHS32GB18030_41_b3_min && byte3 <= ZHS32GB18030_41_b3_max &&
-                byte4 >= ZHS32GB18030_41_b4_min && byte4 <= ZHS32GB18030_41_b4_max) {
-            return unicode_map_ZHS32GB18030_4b1[(byte1 - ZHS32GB18030_41_b1_min) * (ZHS32GB18030_41_b4_max - ZHS32GB18030_41_b4_min + 1) * (ZHS32GB18030_41_b3_max - ZHS32GB18030_41_b3_min + 1) * (ZHS32GB18030_41_b2_max - ZHS32GB18030_41_b2_min + 1) +
-                                                (byte2 - ZHS32GB18030_41_b2_min) * (ZHS32GB18030_41_b4_max - ZHS32GB18030_41_b4_min + 1) * (ZHS32GB18030_41_b3_max - ZHS32GB18030_41_b3_min + 1) +
-                                                (byte3 - ZHS32GB18030_41_b3_min) * (ZHS32GB18030_41_b4_max - ZHS32GB18030_41_b4_min + 1) +
-                                                (byte4 - ZHS32GB18030_41_b4_min)];
-        }
+        const uint64_t index4 = static_cast<uint64_t>(byte2Index4b[byte2]) + byte3Index4b[byte3] + byte4Index4b[byte4];
+        if (index4 < INDEX_INVALID) {
+            // 4 bytes group 1
+            if (byte1Index4b1[byte1] < INDEX_INVALID)
+                return unicode_map_ZHS32GB18030_4b1[byte1Index4b1[byte1] + index4];
 
-        // 4 bytes group 2
-        if (byte1 >= ZHS32GB18030_42_b1_min && byte1 <= ZHS32GB18030_42_b1_max &&
-                byte2 >= ZHS32GB18030_42_b2_min && byte2 <= ZHS32GB18030_42_b2_max &&
-                byte3 >= ZHS32GB18030_42_b3_min && byte3 <= ZHS32GB18030_42_b3_max &&
-                byte4 >= ZHS32GB18030_42_b4_min && byte4 <= ZHS32GB18030_42_b4_max) {
-            return unicode_map_ZHS32GB18030_4b2[(byte1 - ZHS32GB18030_42_b1_min) * (ZHS32GB18030_42_b4_max - ZHS32GB18030_42_b4_min + 1) * (ZHS32GB18030_42_b3_max - ZHS32GB18030_42_b3_min + 1) * (ZHS32GB18030_42_b2_max - ZHS32GB18030_42_b2_min + 1) +
-                                                (byte2 - ZHS32GB18030_42_b2_min) * (ZHS32GB18030_42_b4_max - ZHS32GB18030_42_b4_min + 1) * (ZHS32GB18030_42_b3_max - ZHS32GB18030_42_b3_min + 1) +
-                                                (byte3 - ZHS32GB18030_42_b3_min) * (ZHS32GB18030_42_b4_max - ZHS32GB18030_42_b4_min + 1) +
-                                                (byte4 - ZHS32GB18030_42_b4_min)];
+            // 4 bytes group 2
+            if (byte1Index4b2[byte1] < INDEX_INVALID)
+                return unicode_map_ZHS32GB18030_4b2[byte1Index4b2[byte1] + index4];
         }
 
         return badChar(ctx, xid, byte1, byte2, byte3, byte4);
     }
 
-    typeUnicode16 CharacterSetZHS32GB18030::unicode_map_ZHS32GB18030_2b[(ZHS32GB18030_2_b1_max - ZHS32GB18030_2_b1_min + 1) *
+    const typeUnicode16 CharacterSetZHS32GB18030::unicode_map_ZHS32GB18030_2b[(ZHS32GB18030_2_b1_max - ZHS32GB18030_2_b1_min + 1) *
                                                                         (ZHS32GB18030_2_b2_max - ZHS32GB18030_2_b2_min + 1)] {
         0x4E02, 0x4E04, 0x4E05, 0x4E06, 0x4E0F, 0x4E12, 0x4E17, 0x4E1F, 0x4E20, 0x4E21, 0x4E23, 0x4E26, 0x4E29, 0x4E2E, 0x4E2F, 0x4E31, 0x4E33, 0x4E35, 0x4E37, 0x4E3C, 0x4E40, 0x4E41, 0x4E42, 0x4E44, 0x4E46, 0x4E4A, 0x4E51, 0x4E55, 0x4E57, 0x4E5A, 0x4E5B, 0x4E62, 0x4E63, 0x4E64, 0x4E65, 0x4E67, 0x4E68, 0x4E6A, 0x4E6B, 0x4E6C, 0x4E6D, 0x4E6E, 0x4E6F, 0x4E72, 0x4E74, 0x4E75, 0x4E76, 0x4E77, 0x4E78, 0x4E79, 0x4E7A, 0x4E7B, 0x4E7C, 0x4E7D, 0x4E7F, 0x4E80, 0x4E81, 0x4E82, 0x4E83, 0x4E84, 0x4E85, 0x4E87, 0x4E8A, 0x2170, 0x4E90, 0x4E96, 0x4E97, 0x4E99, 0x4E9C, 0x4E9D, 0x4E9E, 0x4EA3, 0x4EAA, 0x4EAF, 0x4EB0, 0x4EB1, 0x4EB4, 0x4EB6, 0x4EB7, 0x4EB8, 0x4EB9, 0x4EBC, 0x4EBD, 0x4EBE, 0x4EC8, 0x4ECC, 0x4ECF, 0x4ED0, 0x4ED2, 0x4EDA, 0x4EDB, 0x4EDC, 0x4EE0, 0x4EE2, 0x4EE6, 0x4EE7, 0x4EE9, 0x4EED, 0x4EEE, 0x4EEF, 0x4EF1, 0x4EF4, 0x4EF8, 0x4EF9, 0x4EFA, 0x4EFC, 0x4EFE, 0x4F00, 0x4F02, 0x4F03, 0x4F04, 0x4F05, 0x4F06, 0x4F07, 0x4F08, 0x4F0B, 0x4F0C, 0x4F12, 0x4F13, 0x4F14, 0x4F15, 0x4F16, 0x4F1C, 0x4F1D, 0x4F21, 0x4F23, 0x4F28, 0x4F29, 0x4F2C, 0x4F2D, 0x4F2E, 0x4F31, 0x4F33, 0x4F35, 0x4F37, 0x4F39, 0x4F3B, 0x4F3E, 0x4F3F, 0x4F40, 0x4F41, 0x4F42, 0x4F44, 0x4F45, 0x4F47, 0x4F48, 0x4F49, 0x4F4A, 0x4F4B, 0x4F4C, 0x4F52, 0x4F54, 0x4F56, 0x4F61, 0x4F62, 0x4F66, 0x4F68, 0x4F6A, 0x4F6B, 0x4F6D, 0x4F6E, 0x4F71, 0x4F72, 0x4F75, 0x4F77, 0x4F78, 0x4F79, 0x4F7A, 0x4F7D, 0x4F80, 0x4F81, 0x4F82, 0x4F85, 0x4F86, 0x4F87, 0x4F8A, 0x4F8C, 0x4F8E, 0x4F90, 0x4F92, 0x4F93, 0x4F95, 0x4F96, 0x4F98, 0x4F99, 0x4F9A, 0x4F9C, 0x4F9E, 0x4F9F, 0x4FA1, 0x4FA2,
         0x4FA4, 0x4FAB, 0x4FAD, 0x4FB0, 0x4FB1, 0x4FB2, 0x4FB3, 0x4FB4, 0x4FB6, 0x4FB7, 0x4FB8, 0x4FB9, 0x4FBA, 0x4FBB, 0x4FBC, 0x4FBD, 0x4FBE, 0x4FC0, 0x4FC1, 0x4FC2, 0x4FC6, 0x4FC7, 0x4FC8, 0x4FC9, 0x4FCB, 0x4FCC, 0x4FCD, 0x4FD2, 0x4FD3, 0x4FD4, 0x4FD5, 0x4FD6, 0x4FD9, 0x4FDB, 0x4FE0, 0x4FE2, 0x4FE4, 0x4FE5, 0x4FE7, 0x4FEB, 0x4FEC, 0x4FF0, 0x4FF2, 0x4FF4, 0x4FF5, 0x4FF6, 0x4FF7, 0x4FF9, 0x4FFB, 0x4FFC, 0x4FFD, 0x4FFF, 0x5000, 0x5001, 0x5002, 0x5003, 0x5004, 0x5005, 0x5006, 0x5007, 0x5008, 0x5009, 0x500A, 0x2170, 0x500B, 0x500E, 0x5010, 0x5011, 0x5013, 0x5015, 0x5016, 0x5017, 0x501B, 0x501D, 0x501E, 0x5020, 0x5022, 0x5023, 0x5024, 0x5027, 0x502B, 0x502F, 0x5030, 0x5031, 0x5032, 0x5033, 0x5034, 0x5035, 0x5036, 0x5037, 0x5038, 0x5039, 0x503B, 0x503D, 0x503F, 0x5040, 0x5041, 0x5042, 0x5044, 0x5045, 0x5046, 0x5049, 0x504A, 0x504B, 0x504D, 0x5050, 0x5051, 0x5052, 0x5053, 0x5054, 0x5056, 0x5057, 0x5058, 0x5059, 0x505B, 0x505D, 0x505E, 0x505F, 0x5060, 0x5061, 0x5062, 0x5063, 0x5064, 0x5066, 0x5067, 0x5068, 0x5069, 0x506A, 0x506B, 0x506D, 0x506E, 0x506F, 0x5070, 0x5071, 0x5072, 0x5073, 0x5074, 0x5075, 0x5078, 0x5079, 0x507A, 0x507C, 0x507D, 0x5081, 0x5082, 0x5083, 0x5084, 0x5086, 0x5087, 0x5089, 0x508A, 0x508B, 0x508C, 0x508E, 0x508F, 0x5090, 0x5091, 0x5092, 0x5093, 0x5094, 0x5095, 0x5096, 0x5097, 0x5098, 0x5099, 0x509A, 0x509B, 0x509C, 0x509D, 0x509E, 0x509F, 0x50A0, 0x50A1, 0x50A2, 0x50A4, 0x50A6, 0x50AA, 0x50AB, 0x50AD, 0x50AE, 0x50AF, 0x50B0, 0x50B1, 0x50B3, 0x50B4, 0x50B5, 0x50B6, 0x50B7, 0x50B8, 0x50B9, 0x50BC,
@@ -213,7 +216,7 @@ namespace OpenLogReplicator {
         0xFA0C, 0xFA0D, 0xFA0E, 0xFA0F, 0xFA11, 0xFA13, 0xFA14, 0xFA18, 0xFA1F, 0xFA20, 0xFA21, 0xFA23, 0xFA24, 0xFA27, 0xFA28, 0xFA29, 0x2E81, 0xE816, 0xE817, 0xE818, 0x2E84, 0x3473, 0x3447, 0x2E88, 0x2E8B, 0xE81E, 0x359E, 0x361A, 0x360E, 0x2E8C, 0x2E97, 0x396E, 0x3918, 0xE826, 0x39CF, 0x39DF, 0x3A73, 0x39D0, 0xE82B, 0xE82C, 0x3B4E, 0x3C6E, 0x3CE0, 0x2EA7, 0xE831, 0xE832, 0x2EAA, 0x4056, 0x415F, 0x2EAE, 0x4337, 0x2EB3, 0x2EB6, 0x2EB7, 0xE83B, 0x43B1, 0x43AC, 0x2EBB, 0x43DD, 0x44D6, 0x4661, 0x464C, 0xE843, 0x2170, 0x4723, 0x4729, 0x477C, 0x478D, 0x2ECA, 0x4947, 0x497A, 0x497D, 0x4982, 0x4983, 0x4985, 0x4986, 0x499F, 0x499B, 0x49B7, 0x49B6, 0xE854, 0xE855, 0x4CA3, 0x4C9F, 0x4CA0, 0x4CA1, 0x4C77, 0x4CA2, 0x4D13, 0x4D14, 0x4D15, 0x4D16, 0x4D17, 0x4D18, 0x4D19, 0x4DAE, 0xE864, 0xE468, 0xE469, 0xE46A, 0xE46B, 0xE46C, 0xE46D, 0xE46E, 0xE46F, 0xE470, 0xE471, 0xE472, 0xE473, 0xE474, 0xE475, 0xE476, 0xE477, 0xE478, 0xE479, 0xE47A, 0xE47B, 0xE47C, 0xE47D, 0xE47E, 0xE47F, 0xE480, 0xE481, 0xE482, 0xE483, 0xE484, 0xE485, 0xE486, 0xE487, 0xE488, 0xE489, 0xE48A, 0xE48B, 0xE48C, 0xE48D, 0xE48E, 0xE48F, 0xE490, 0xE491, 0xE492, 0xE493, 0xE494, 0xE495, 0xE496, 0xE497, 0xE498, 0xE499, 0xE49A, 0xE49B, 0xE49C, 0xE49D, 0xE49E, 0xE49F, 0xE4A0, 0xE4A1, 0xE4A2, 0xE4A3, 0xE4A4, 0xE4A5, 0xE4A6, 0xE4A7, 0xE4A8, 0xE4A9, 0xE4AA, 0xE4AB, 0xE4AC, 0xE4AD, 0xE4AE, 0xE4AF, 0xE4B0, 0xE4B1, 0xE4B2, 0xE4B3, 0xE4B4, 0xE4B5, 0xE4B6, 0xE4B7, 0xE4B8, 0xE4B9, 0xE4BA, 0xE4BB, 0xE4BC, 0xE4BD, 0xE4BE, 0xE4BF, 0xE4C0, 0xE4C1, 0xE4C2, 0xE4C3, 0xE4C4, 0xE4C5
     };
 
-    typeUnicode16 CharacterSetZHS32GB18030::unicode_map_ZHS32GB18030_4b1[(ZHS32GB18030_41_b1_max - ZHS32GB18030_41_b1_min + 1) *
+    const typeUnicode16 CharacterSetZHS32GB18030::unicode_map_ZHS32GB18030_4b1[(ZHS32GB18030_41_b1_max - ZHS32GB18030_41_b1_min + 1) *
                                                                          (ZHS32GB18030_41_b2_max - ZHS32GB18030_41_b2_min + 1) *
                                                                          (ZHS32GB18030_41_b3_max - ZHS32GB18030_41_b3_min + 1) *
                                                                          (ZHS32GB18030_41_b4_max - ZHS32GB18030_41_b4_min + 1)] {
@@ -379,7 +382,7 @@ namespace OpenLogReplicator {
         0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD
     };
 
-    typeUnicode32 CharacterSetZHS32GB18030::unicode_map_ZHS32GB18030_4b2[(ZHS32GB18030_42_b1_max - ZHS32GB18030_42_b1_min + 1) *
+    const typeUnicode32 CharacterSetZHS32GB18030::unicode_map_ZHS32GB18030_4b2[(ZHS32GB18030_42_b1_max - ZHS32GB18030_42_b1_min + 1) *
                                                                          (ZHS32GB18030_42_b2_max - ZHS32GB18030_42_b2_min + 1) *
                                                                          (ZHS32GB18030_42_b3_max - ZHS32GB18030_42_b3_min + 1) *
                                                                          (ZHS32GB18030_42_b4_max - ZHS32GB18030_42_b4_min + 1)] {
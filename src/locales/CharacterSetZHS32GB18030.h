@@ -49,13 +49,26 @@ namespace OpenLogReplicator {
         static constexpr uint64_t ZHS32GB18030_42_b4_max{0x39};
 
     protected:
-        static typeUnicode16 unicode_map_ZHS32GB18030_2b[(ZHS32GB18030_2_b1_max - ZHS32GB18030_2_b1_min + 1) *
+        static constexpr uint64_t ZHS32GB18030_4_b4_size{ZHS32GB18030_41_b4_max - ZHS32GB18030_41_b4_min + 1};
+        static constexpr uint64_t ZHS32GB18030_4_b3_size{ZHS32GB18030_41_b3_max - ZHS32GB18030_41_b3_min + 1};
+        static constexpr uint64_t ZHS32GB18030_4_b2_size{ZHS32GB18030_41_b2_max - ZHS32GB18030_41_b2_min + 1};
+
+        // Map offsets of every byte, 2 bytes sequences and the trailing bytes of the 4 bytes groups which have the same ranges
+        uint32_t byte1Index2b[256];
+        uint32_t byte2Index2b[256];
+        uint32_t byte1Index4b1[256];
+        uint32_t byte1Index4b2[256];
+        uint32_t byte2Index4b[256];
+        uint32_t byte3Index4b[256];
+        uint32_t byte4Index4b[256];
+
+        static const typeUnicode16 unicode_map_ZHS32GB18030_2b[(ZHS32GB18030_2_b1_max - ZHS32GB18030_2_b1_min + 1) *
                                                          (ZHS32GB18030_2_b2_max - ZHS32GB18030_2_b2_min + 1)];
-        static typeUnicode16 unicode_map_ZHS32GB18030_4b1[(ZHS32GB18030_41_b1_max - ZHS32GB18030_41_b1_min + 1) *
+        static const typeUnicode16 unicode_map_ZHS32GB18030_4b1[(ZHS32GB18030_41_b1_max - ZHS32GB18030_41_b1_min + 1) *
                                                           (ZHS32GB18030_41_b2_max - ZHS32GB18030_41_b2_min + 1) *
                                                           (ZHS32GB18030_41_b3_max - ZHS32GB18030_41_b3_min + 1) *
                                                           (ZHS32GB18030_41_b4_max - ZHS32GB18030_41_b4_min + 1)];
-        static typeUnicode32 unicode_map_ZHS32GB18030_4b2[(ZHS32GB18030_42_b1_max - ZHS32GB18030_42_b1_min + 1) *
+        static const typeUnicode32 unicode_map_ZHS32GB18030_4b2[(ZHS32GB18030_42_b1_max - ZHS32GB18030_42_b1_min + 1) *
                                                           (ZHS32GB18030_42_b2_max - ZHS32GB18030_42_b2_min + 1) *
                                                           (ZHS32GB18030_42_b3_max - ZHS32GB18030_42_b3_min + 1) *
                                                           (ZHS32GB18030_42_b4_max - ZHS32GB18030_42_b4_min + 1)];
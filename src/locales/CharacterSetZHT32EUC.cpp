@@ -22,6 +22,14 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 namespace OpenLogReplicator {
     CharacterSetZHT32EUC::CharacterSetZHT32EUC() :
             CharacterSet("ZHT32EUC") {
+        asciiCompatible = true;
+
+        buildIndex(byte1Index2b, ZHT32EUC_2_b1_min, ZHT32EUC_2_b1_max, ZHT32EUC_2_b2_max - ZHT32EUC_2_b2_min + 1);
+        buildIndex(byte2Index2b, ZHT32EUC_2_b2_min, ZHT32EUC_2_b2_max, 1);
+        buildIndex(byte2Index4b, ZHT32EUC_4_b2_min, ZHT32EUC_4_b2_max,
+                   (ZHT32EUC_4_b3_max - ZHT32EUC_4_b3_min + 1) * (ZHT32EUC_4_b4_max - ZHT32EUC_4_b4_min + 1));
+        buildIndex(byte3Index4b, ZHT32EUC_4_b3_min, ZHT32EUC_4_b3_max, ZHT32EUC_4_b4_max - ZHT32EUC_4_b4_min + 1);
+        buildIndex(byte4Index4b, ZHT32EUC_4_b4_min, ZHT32EUC_4_b4_max, 1);
     }
 
     typeUnicode CharacterSetZHT32EUC::decode(const Ctx* ctx, Xid xid, const uint8_t*& str, uint64_t& length) const {
@@ -34,8 +42,17 @@ namespace OpenLogReplicator {
         if (length == 0)
             return badChar(ctx, xid, byte1);
 
-        // 4 bytes sequence
+        // 4 bytes sequence, a malformed one is taken byte by byte to report the bytes consumed
         if (byte1 == ZHT32EUC_4_b1) {
+            if (length >= 3) {
+                const uint64_t index = static_cast<uint64_t>(byte2Index4b[str[0]]) + byte3Index4b[str[1]] + byte4Index4b[str[2]];
+                if (index < INDEX_INVALID) {
+                    str += 3;
+                    length -= 3;
+                    return unicode_map_ZHT32EUC_4b[index];
+                }
+            }
+
             const uint64_t byte2 = *str++;
             --length;
 
@@ -67,14 +84,14 @@ namespace OpenLogReplicator {
         const uint64_t byte2 = *str++;
         --length;
 
-        if (byte2 < ZHT32EUC_2_b2_min || byte2 > ZHT32EUC_2_b2_max)
+        const uint64_t index = static_cast<uint64_t>(byte1Index2b[byte1]) + byte2Index2b[byte2];
+        if (index >= INDEX_INVALID)
             return badChar(ctx, xid, byte1, byte2);
 
-        return unicode_map_ZHT32EUC_2b[((byte1 - ZHT32EUC_2_b1_min) * (ZHT32EUC_2_b2_max - ZHT32EUC_2_b2_min + 1)) +
-                                       (byte2 - ZHT32EUC_2_b2_min)];
+        return unicode_map_ZHT32EUC_2b[index];
     }
 
-    typeUnicode16 CharacterSetZHT32EUC::unicode_map_ZHT32EUC_2b[(ZHT32EUC_2_b1_max - ZHT32EUC_2_b1_min + 1) *
+    const typeUnicode16 CharacterSetZHT32EUC::unicode_map_ZHT32EUC_2b[(ZHT32EUC_2_b1_max - ZHT32EUC_2_b1_min + 1) *
                                                                 (ZHT32EUC_2_b2_max - ZHT32EUC_2_b2_min + 1)]{
             0x3000, 0xFF0C, 0x3001, 0x3002, 0xFF0E, 0x30FB, 0xFF1B, 0xFF1A, 0xFF1F, 0xFF01, 0xFE30, 0x2026, 0x2025, 0xFE50, 0xFE51, 0xFE52, 0x00B7, 0xFE54,
             0xFE55, 0xFE56, 0xFE57, 0xFE31, 0x2014, 0xFFFD, 0x2013, 0xFE33, 0xFFFD, 0xFFFD, 0xFFFD, 0xFF08, 0xFF09, 0xFE35, 0xFE36, 0xFF5B, 0xFF5D, 0xFE37,
@@ -642,7 +659,7 @@ namespace OpenLogReplicator {
             0xFFFD, 0xFFFD, 0xFFFD
     };
 
-    typeUnicode16 CharacterSetZHT32EUC::unicode_map_ZHT32EUC_4b[(ZHT32EUC_4_b2_max - ZHT32EUC_4_b2_min + 1) *
+    const typeUnicode16 CharacterSetZHT32EUC::unicode_map_ZHT32EUC_4b[(ZHT32EUC_4_b2_max - ZHT32EUC_4_b2_min + 1) *
                                                                 (ZHT32EUC_4_b3_max - ZHT32EUC_4_b3_min + 1) *
                                                                 (ZHT32EUC_4_b4_max - ZHT32EUC_4_b4_min + 1)]{
             0x4E42, 0x4E5C, 0x51F5, 0x531A, 0x5382, 0x4E07, 0x4E0C, 0x4E47, 0x4E8D, 0x56D7, 0x5C6E, 0x5F73, 0x4E0F, 0x5187, 0x4E0E, 0x4E2E, 0x4E93, 0x4EC2,
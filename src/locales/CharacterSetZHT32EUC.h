@@ -39,9 +39,16 @@ namespace OpenLogReplicator {
         static constexpr uint64_t ZHT32EUC_4_b4_max{0xFE};
 
     protected:
-        static typeUnicode16 unicode_map_ZHT32EUC_2b[(ZHT32EUC_2_b1_max - ZHT32EUC_2_b1_min + 1) *
+        // Map offsets of every byte, a sequence with all of them in range is looked up at once
+        uint32_t byte1Index2b[256];
+        uint32_t byte2Index2b[256];
+        uint32_t byte2Index4b[256];
+        uint32_t byte3Index4b[256];
+        uint32_t byte4Index4b[256];
+
+        static const typeUnicode16 unicode_map_ZHT32EUC_2b[(ZHT32EUC_2_b1_max - ZHT32EUC_2_b1_min + 1) *
                                                      (ZHT32EUC_2_b2_max - ZHT32EUC_2_b2_min + 1)];
-        static typeUnicode16 unicode_map_ZHT32EUC_4b[(ZHT32EUC_4_b2_max - ZHT32EUC_4_b2_min + 1) *
+        static const typeUnicode16 unicode_map_ZHT32EUC_4b[(ZHT32EUC_4_b2_max - ZHT32EUC_4_b2_min + 1) *
                                                      (ZHT32EUC_4_b3_max - ZHT32EUC_4_b3_min + 1) *
                                                      (ZHT32EUC_4_b4_max - ZHT32EUC_4_b4_min + 1)];
 
@@ -22,6 +22,11 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 namespace OpenLogReplicator {
     CharacterSetZHT32TRIS::CharacterSetZHT32TRIS() :
             CharacterSet("ZHT32TRIS") {
+        asciiCompatible = true;
+
+        buildIndex(byte2Index, ZHT32TRIS_b2_min, ZHT32TRIS_b2_max, (ZHT32TRIS_b3_max - ZHT32TRIS_b3_min + 1) * (ZHT32TRIS_b4_max - ZHT32TRIS_b4_min + 1));
+        buildIndex(byte3Index, ZHT32TRIS_b3_min, ZHT32TRIS_b3_max, ZHT32TRIS_b4_max - ZHT32TRIS_b4_min + 1);
+        buildIndex(byte4Index, ZHT32TRIS_b4_min, ZHT32TRIS_b4_max, 1);
     }
 
     typeUnicode CharacterSetZHT32TRIS::decode(const Ctx* ctx, Xid xid, const uint8_t*& str, uint64_t& length) const {
@@ -33,6 +38,16 @@ namespace OpenLogReplicator {
         if (byte1 != ZHT32TRIS_b1 || length == 0)
             return badChar(ctx, xid, byte1);
 
+        // A malformed sequence is taken byte by byte to report the bytes consumed
+        if (length >= 3) {
+            const uint64_t index = static_cast<uint64_t>(byte2Index[str[0]]) + byte3Index[str[1]] + byte4Index[str[2]];
+            if (index < INDEX_INVALID) {
+                str += 3;
+                length -= 3;
+                return unicode_map_ZHT32TRIS_4b[index];
+            }
+        }
+
         const uint64_t byte2 = *str++;
         --length;
 
@@ -56,7 +71,7 @@ namespace OpenLogReplicator {
                                         + (byte4 - ZHT32TRIS_b4_min)];
     }
 
-    typeUnicode16 CharacterSetZHT32TRIS::unicode_map_ZHT32TRIS_4b[(ZHT32TRIS_b2_max - ZHT32TRIS_b2_min + 1) *
+    const typeUnicode16 CharacterSetZHT32TRIS::unicode_map_ZHT32TRIS_4b[(ZHT32TRIS_b2_max - ZHT32TRIS_b2_min + 1) *
                                                                   (ZHT32TRIS_b3_max - ZHT32TRIS_b3_min + 1) *
                                                                   (ZHT32TRIS_b4_max - ZHT32TRIS_b4_min + 1)]{
             0x3000, 0xFF0C, 0x3001, 0x3002, 0xFF0E, 0x30FB, 0xFF1B, 0xFF1A, 0xFF1F, 0xFF01, 0xFE30, 0x2026, 0x2025, 0xFE50, 0xFE51, 0xFE52, 0x00B7, 0xFE54,
@@ -34,7 +34,12 @@ namespace OpenLogReplicator {
         static constexpr uint64_t ZHT32TRIS_b4_max{0xFE};
 
     protected:
-        static typeUnicode16 unicode_map_ZHT32TRIS_4b[(ZHT32TRIS_b2_max - ZHT32TRIS_b2_min + 1) *
+        // Map offsets of every trailing byte, a sequence with all of them in range is looked up at once
+        uint32_t byte2Index[256];
+        uint32_t byte3Index[256];
+        uint32_t byte4Index[256];
+
+        static const typeUnicode16 unicode_map_ZHT32TRIS_4b[(ZHT32TRIS_b2_max - ZHT32TRIS_b2_min + 1) *
                                                       (ZHT32TRIS_b3_max - ZHT32TRIS_b3_min + 1) *
                                                       (ZHT32TRIS_b4_max - ZHT32TRIS_b4_min + 1)];
 
@@ -20,7 +20,13 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #ifndef LOCALES_H_
 #define LOCALES_H_
 
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <string_view>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "../common/types/Types.h"
 
@@ -28,14 +34,59 @@ namespace OpenLogReplicator {
     class CharacterSet;
 
     class Locales final {
-    public:
-        std::unordered_map<uint64_t, CharacterSet*> characterMap;
-        std::unordered_map<uint16_t, std::string_view> timeZoneMap;
+    protected:
+        using CharacterSetFactory = CharacterSet* (*)(const char* name);
+
+        // The database uses only a few of the character sets, each one is built on first lookup
+        struct CharacterSetEntry {
+            const char* name;
+            CharacterSetFactory factory;
+            mutable std::atomic<CharacterSet*> characterSet{nullptr};
+
+            CharacterSetEntry(const char* newName, CharacterSetFactory newFactory) :
+                    name(newName),
+                    factory(newFactory) {
+            }
+        };
+
+        std::unordered_map<uint64_t, CharacterSetEntry> characterMap;
+        mutable std::mutex mtx;
+
+        // Region ids are dense enough to be indexed directly, 0 marks an unknown id and otherwise it is the position in timeZoneNames + 1
+        static const std::pair<uint16_t, std::string_view> timeZoneNames[];
+        std::vector<uint16_t> timeZoneIndex;
+        uint16_t timeZoneFirst{0};
 
+        void addCharacterSet(uint64_t id, const char* name, CharacterSetFactory factory);
+        CharacterSet* buildCharacterSet(const CharacterSetEntry& entry) const;
+
+    public:
         Locales();
         ~Locales();
 
         void initialize();
+
+        // Null for an unknown id
+        [[nodiscard]] const CharacterSet* getCharacterSet(uint64_t id) const {
+            auto characterMapIt = characterMap.find(id);
+            if (unlikely(characterMapIt == characterMap.end()))
+                return nullptr;
+            CharacterSet* characterSet = characterMapIt->second.characterSet.load(std::memory_order_acquire);
+            if (likely(characterSet != nullptr))
+                return characterSet;
+            return buildCharacterSet(characterMapIt->second);
+        }
+
+        // Empty for an unknown region id
+        [[nodiscard]] std::string_view getTimeZone(uint16_t key) const {
+            const uint16_t pos = key - timeZoneFirst;
+            if (unlikely(pos >= timeZoneIndex.size() || timeZoneIndex[pos] == 0))
+                return {};
+            return timeZoneNames[timeZoneIndex[pos] - 1].second;
+        }
+
+        // 0 for an unknown name, the character set is not built
+        [[nodiscard]] uint64_t findCharacterSet(const std::string& name) const;
     };
 }
 
@@ -55,6 +55,12 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #define HAS_ZEROMQ ""
 #endif /* LINK_LIBRARY_PROTOBUF */
 
+#ifdef LINK_LIBRARY_ARROW
+#define HAS_ARROW " Arrow"
+#else
+#define HAS_ARROW ""
+#endif /* LINK_LIBRARY_ARROW */
+
 #ifdef LINK_LIBRARY_RDKAFKA
 #define HAS_KAFKA " Kafka"
 #else
@@ -116,11 +122,17 @@ namespace {
         }
     }
 
+    // 飞行记录器转储请求，由各任务的主循环处理
+    void signalFlightRecorder(int sig __attribute__((unused))) {
+        OpenLogReplicator::Ctx::requestFlightRecorderDump();
+    }
+
 int main(int argc, char **argv) {
     signal(SIGINT, signalHandler);
     signal(SIGPIPE, signalHandler);
     signal(SIGSEGV, signalCrash);
     signal(SIGUSR1, signalDump);
+    signal(SIGUSR2, signalFlightRecorder);
     
     // 在独立线程中启动HTTP服务器
     std::thread httpThread([]() {
@@ -182,6 +194,7 @@ int main(int argc, char **argv) {
     signal(SIGPIPE, nullptr);
     signal(SIGSEGV, nullptr);
     signal(SIGUSR1, nullptr);
+    signal(SIGUSR2, nullptr);
     mainCtxMap.clear();
     //exit(0);
     return 0;
@@ -19,21 +19,27 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 
 #include <algorithm>
 #include <fcntl.h>
+#include <memory>
 #include <sys/stat.h>
 #include <thread>
 #include <utility>
 #include <unistd.h>
 
+#include "../builder/Builder.h"
 #include "../common/Ctx.h"
 #include "../common/exception/ConfigurationException.h"
 #include "../common/exception/RuntimeException.h"
 #include "../common/DbTable.h"
+#include "../common/Format.h"
+#include "../common/Tracer.h"
 #include "../common/table/SysObj.h"
 #include "../common/table/SysUser.h"
+#include "../replicator/PartitionCoordinator.h"
 #include "Checkpoint.h"
 #include "Metadata.h"
 #include "Schema.h"
 #include "SchemaElement.h"
+#include "StandbyLease.h"
 #include "../OpenLogReplicator.h"
 
 namespace OpenLogReplicator {
@@ -49,6 +55,10 @@ namespace OpenLogReplicator {
         configFileBuffer = nullptr;
     }
 
+    void Checkpoint::setBuilder(Builder* newBuilder) {
+        builder.store(newBuilder, std::memory_order_release);
+    }
+
     void Checkpoint::wakeUp() {
         {
             contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::CHECKPOINT_WAKEUP);
@@ -127,16 +137,34 @@ namespace OpenLogReplicator {
                                                 " elements, expected: 1 element");
         }
 
+        std::unique_ptr<Format> format;
+        Builder* currentBuilder = builder.load(std::memory_order_acquire);
+
         for (rapidjson::SizeType j = 0; j < sourceArrayJson.Size(); ++j) {
             const rapidjson::Value& sourceJson = Ctx::getJsonFieldO(configFileName, sourceArrayJson, "source", j);
 
             if (!metadata->ctx->isDisableChecksSet(Ctx::DISABLE_CHECKS::JSON_TAGS)) {
                 static const std::vector<std::string> sourceNames {"alias", "memory", "name", "reader", "flags", "state", "debug", "transaction-max-mb",
                                                                    "metrics", "format", "redo-read-sleep-us", "arch-read-sleep-us", "arch-read-tries",
-                                                                   "redo-verify-delay-us", "refresh-interval-us", "arch", "filter"};
+                                                                   "redo-verify-delay-us", "refresh-interval-us", "arch", "filter", "tracing"};
                 Ctx::checkJsonFields(configFileName, sourceJson, sourceNames);
             }
 
+            // Flush buffer size and output type are fixed at startup, the remaining fields are applied from the next transaction
+            if (currentBuilder != nullptr) {
+                const rapidjson::Value& formatJson = Ctx::getJsonFieldO(configFileName, sourceJson, "format");
+                format = std::make_unique<Format>(Format::parseJson(ctx, configFileName, formatJson));
+                if (unlikely(format->isMessageFormatFull() == currentBuilder->isMessagePerRow()))
+                    throw ConfigurationException(30001, "bad JSON, invalid \"message\" value: " +
+                                                        std::to_string(static_cast<uint>(format->messageFormat)) +
+                                                        ", expected: FULL mode (" + std::to_string(static_cast<uint>(Format::MESSAGE_FORMAT::FULL)) +
+                                                        ") unchanged until restart");
+            }
+
+            // Sampling of the tracer follows the file, the endpoint is kept until restart
+            if (ctx->tracer != nullptr && sourceJson.HasMember("tracing"))
+                ctx->tracer->configure(configFileName, Ctx::getJsonFieldO(configFileName, sourceJson, "tracing"));
+
             metadata->resetElements();
 
             std::string debugOwner;
@@ -202,6 +230,16 @@ namespace OpenLogReplicator {
                             element->tag = Ctx::getJsonFieldS(configFileName, Ctx::JSON_TAG_LENGTH, tableElementJson, "tag");
                             element->parseTag(element->tag, separator);
                         }
+
+                        if (tableElementJson.HasMember("columns")) {
+                            element->columns = Ctx::getJsonFieldS(configFileName, Ctx::JSON_KEY_LENGTH, tableElementJson, "columns");
+                            SchemaElement::parseColumns(element->columns, separator, element->columnList);
+                        }
+
+                        if (tableElementJson.HasMember("skip-columns")) {
+                            element->skipColumns = Ctx::getJsonFieldS(configFileName, Ctx::JSON_KEY_LENGTH, tableElementJson, "skip-columns");
+                            SchemaElement::parseColumns(element->skipColumns, separator, element->skipColumnList);
+                        }
                     }
 
                     for (const auto& user: metadata->users)
@@ -222,12 +260,21 @@ namespace OpenLogReplicator {
         {
             contextSet(Thread::CONTEXT::TRAN, Thread::REASON::TRAN);
             std::unique_lock<std::mutex> const lckTransaction(metadata->mtxTransaction);
+            const bool appendOnly = metadata->isElementsAppendOnly();
             metadata->commitElements();
-            metadata->schema->purgeMetadata();
 
-            // Mark all tables as touched to force a schema update
-            for (const auto& [_, sysObj]: metadata->schema->sysObjPack.mapRowId)
-                metadata->schema->touchTable(sysObj->obj);
+            if (appendOnly) {
+                // Tables already replicated are kept, only the remaining objects are matched against the added rules
+                for (const auto& [_, sysObj]: metadata->schema->dict->sysObjPack.mapRowId)
+                    if (metadata->schema->checkTableDict(sysObj->obj) == nullptr)
+                        metadata->schema->touchTable(sysObj->obj);
+            } else {
+                metadata->schema->purgeMetadata();
+
+                // Mark all tables as touched to force a schema update
+                for (const auto& [_, sysObj]: metadata->schema->dict->sysObjPack.mapRowId)
+                    metadata->schema->touchTable(sysObj->obj);
+            }
 
             std::vector<std::string> msgs;
             std::unordered_map<typeObj, std::string> tablesUpdated;
@@ -238,10 +285,57 @@ namespace OpenLogReplicator {
                 ctx->info(0, "- found: " + tableName);
 
             metadata->schema->resetTouched();
+
+            if (format != nullptr)
+                currentBuilder->setFormat(*format);
         }
         contextSet(Thread::CONTEXT::CPU);
     }
 
+    // Renewed a few times per lease period, so that a single delayed write doesn't hand the output over
+    void Checkpoint::checkLease() {
+        StandbyLease* lease = metadata->lease;
+        const time_t now = time(nullptr);
+        if (lease == nullptr || now - leaseLast < static_cast<time_t>(std::max<uint64_t>(1, lease->leaseS / 3)))
+            return;
+        leaseLast = now;
+
+        if (!metadata->standby) {
+            if (!lease->renew(now))
+                throw RuntimeException(10097, "lease lost to: " + lease->holder + ", stopping output");
+            return;
+        }
+
+        if (!lease->acquire(now)) {
+            const Scn scn = lease->confirmedScn();
+            if (scn != Scn::none())
+                metadata->standbyScn = scn.getData();
+            return;
+        }
+
+        // Last position confirmed by the client of the previous holder, the output resumes after it
+        const Scn scn = lease->confirmedScn();
+        if (scn != Scn::none())
+            metadata->standbyScn = scn.getData();
+        metadata->standby = false;
+        ctx->info(0, "lease taken over from: " + lease->holder + ", output starts after scn: " + Scn(metadata->standbyScn.load()).toString());
+    }
+
+    // A changed split is applied by restarting, the partitions moved continue from their own checkpoints
+    void Checkpoint::checkPartitions() {
+        PartitionCoordinator* partitions = metadata->partitions;
+        const time_t now = time(nullptr);
+        if (partitions == nullptr || now - partitionsLast < static_cast<time_t>(std::max<uint64_t>(1, partitions->timeoutS / 3)))
+            return;
+        partitionsLast = now;
+
+        partitions->heartbeat(now);
+        if (partitions->assign(now)) {
+            ctx->warning(60060, "partition assignment changed, stopping to continue with the new split after restart");
+            ctx->stopSoft();
+        }
+    }
+
     void Checkpoint::run() {
         if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
             std::ostringstream ss;
@@ -253,6 +347,8 @@ namespace OpenLogReplicator {
             while (!ctx->hardShutdown) {
                 metadata->writeCheckpoint(this, false);
                 metadata->deleteOldCheckpoints(this);
+                checkLease();
+                checkPartitions();
 
                 if (ctx->hardShutdown)
                     break;
@@ -278,6 +374,14 @@ namespace OpenLogReplicator {
                 }
                 trackConfigFile();
 
+                if (contextCompiled && ctx->metrics != nullptr) {
+                    const time_ut now = ctx->clock->getTimeUt();
+                    if (now - threadMetricsLast >= THREAD_METRICS_INTERVAL_US) {
+                        ctx->emitThreadMetrics();
+                        threadMetricsLast = now;
+                    }
+                }
+
                 {
                     if (unlikely(ctx->isTraceSet(Ctx::TRACE::SLEEP)))
                         ctx->logTrace(Ctx::TRACE::SLEEP, "Checkpoint:run lastCheckpointScn: " + metadata->lastCheckpointScn.toString() +
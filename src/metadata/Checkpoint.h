@@ -20,6 +20,7 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #ifndef CHECKPOINT_H_
 #define CHECKPOINT_H_
 
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 #include <set>
@@ -31,6 +32,7 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include "../common/types/Xid.h"
 
 namespace OpenLogReplicator {
+    class Builder;
     class Metadata;
     class DbIncarnation;
     class TransactionBuffer;
@@ -38,15 +40,24 @@ namespace OpenLogReplicator {
     class Checkpoint final : public Thread {
     public:
         static constexpr off_t CONFIG_FILE_MAX_SIZE = 1048576;
+        // Period of publishing the thread context profile to metrics
+        static constexpr time_ut THREAD_METRICS_INTERVAL_US{1000000};
 
     protected:
         Metadata* metadata;
+        // Set once the builder is created, a reloaded format is handed over to it
+        std::atomic<Builder*> builder{nullptr};
         std::mutex mtx;
         std::condition_variable condLoop;
         char* configFileBuffer{nullptr};
         std::string configFileName;
         time_t configFileChange;
+        time_ut threadMetricsLast{0};
+        time_t leaseLast{0};
+        time_t partitionsLast{0};
 
+        void checkLease();
+        void checkPartitions();
         void trackConfigFile();
         void updateConfigFile();
 
@@ -54,6 +65,7 @@ namespace OpenLogReplicator {
         Checkpoint(Ctx* newCtx, Metadata* newMetadata, std::string newAlias, std::string newConfigFileName, time_t newConfigFileChange);
         ~Checkpoint() override;
 
+        void setBuilder(Builder* newBuilder);
         void wakeUp() override;
         void run() override;
 
@@ -17,14 +17,17 @@ You should have received a copy of the GNU General Public License
 along with OpenLogReplicator; see the file LICENSE;  If not see
 <http://www.gnu.org/licenses/>.  */
 
+#include <chrono>
 #include <vector>
 
+#include "../common/Clock.h"
 #include "../common/Ctx.h"
 #include "../common/DbIncarnation.h"
 #include "../common/DbTable.h"
 #include "../common/Thread.h"
 #include "../common/exception/ConfigurationException.h"
 #include "../common/exception/RuntimeException.h"
+#include "../common/metrics/Metrics.h"
 #include "../common/table/SysCCol.h"
 #include "../common/table/SysCDef.h"
 #include "../common/table/SysCol.h"
@@ -38,12 +41,14 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include "../common/table/SysUser.h"
 #include "../locales/CharacterSet.h"
 #include "../locales/Locales.h"
+#include "../replicator/PartitionCoordinator.h"
 #include "../state/StateDisk.h"
 #include "RedoLog.h"
 #include "Metadata.h"
 #include "Schema.h"
 #include "SchemaElement.h"
 #include "Serializer.h"
+#include "StandbyLease.h"
 
 namespace OpenLogReplicator {
     Metadata::Metadata(Ctx *newCtx, Locales *newLocales, std::string newDatabase, typeConId newConId, Scn newStartScn,
@@ -70,6 +75,16 @@ namespace OpenLogReplicator {
             serializer = nullptr;
         }
 
+        if (lease != nullptr) {
+            delete lease;
+            lease = nullptr;
+        }
+
+        if (partitions != nullptr) {
+            delete partitions;
+            partitions = nullptr;
+        }
+
         if (state != nullptr) {
             delete state;
             state = nullptr;
@@ -98,23 +113,11 @@ namespace OpenLogReplicator {
     }
 
     void Metadata::setNlsCharset(const std::string &nlsCharset, const std::string &nlsNcharCharset) {
-        for (const auto &[mapId, characterSet]: locales->characterMap) {
-            if (nlsCharset == characterSet->name) {
-                defaultCharacterMapId = mapId;
-                break;
-            }
-        }
-
+        defaultCharacterMapId = locales->findCharacterSet(nlsCharset);
         if (unlikely(defaultCharacterMapId == 0))
             throw RuntimeException(10042, "unsupported NLS_CHARACTERSET value: " + nlsCharset);
 
-        for (const auto &[characterNcharMapId, characterSet]: locales->characterMap) {
-            if (nlsNcharCharset == characterSet->name) {
-                defaultCharacterNcharMapId = characterNcharMapId;
-                break;
-            }
-        }
-
+        defaultCharacterNcharMapId = locales->findCharacterSet(nlsNcharCharset);
         if (unlikely(defaultCharacterNcharMapId == 0))
             throw RuntimeException(10046, "unsupported NLS_NCHAR_CHARACTERSET value: " + nlsNcharCharset);
     }
@@ -169,6 +172,15 @@ namespace OpenLogReplicator {
         return false;
     }
 
+    bool Metadata::stateMap(const std::string &name, uint64_t maxSize, StateImage &image) const {
+        try {
+            return state->map(name, maxSize, image);
+        } catch (RuntimeException &ex) {
+            ctx->error(ex.code, ex.msg);
+        }
+        return false;
+    }
+
     bool Metadata::stateDiskRead(const std::string &name, uint64_t maxSize, std::string &in) const {
         try {
             return stateDisk->read(name, maxSize, in);
@@ -180,7 +192,7 @@ namespace OpenLogReplicator {
 
     bool Metadata::stateWrite(const std::string &name, Scn scn, const std::ostringstream &out) const {
         try {
-            // state->write(name, scn, out);
+            state->write(name, scn, out);
             return true;
         } catch (RuntimeException &ex) {
             ctx->error(ex.code, ex.msg);
@@ -249,6 +261,22 @@ namespace OpenLogReplicator {
         newSchemaElements.clear();
     }
 
+    // The first matching rule wins, so when the new rules only extend the current list, tables already built keep their rule
+    bool Metadata::isElementsAppendOnly() const {
+        if (newSchemaElements.size() < schemaElements.size())
+            return false;
+
+        for (size_t i = 0; i < schemaElements.size(); ++i) {
+            const SchemaElement* element = schemaElements[i];
+            const SchemaElement* newElement = newSchemaElements[i];
+            if (element->owner != newElement->owner || element->table != newElement->table || element->options != newElement->options ||
+                element->key != newElement->key || element->condition != newElement->condition || element->tag != newElement->tag ||
+                element->columns != newElement->columns || element->skipColumns != newElement->skipColumns)
+                return false;
+        }
+        return true;
+    }
+
     void Metadata::buildMaps(std::vector<std::string> &msgs, std::unordered_map<typeObj, std::string> &tablesUpdated) {
         for (const SchemaElement *element: schemaElements) {
             if (ctx->isLogLevelAt(Ctx::LOG::DEBUG))
@@ -259,12 +287,53 @@ namespace OpenLogReplicator {
 
             schema->buildMaps(element->owner, element->table, element->keyList, element->key, element->tagType,
                               element->tagList, element->tag,
-                              element->condition, element->options, tablesUpdated, suppLogDbPrimary, suppLogDbAll,
+                              element->condition, element->columnList, element->skipColumnList, element->options, tablesUpdated,
+                              suppLogDbPrimary, suppLogDbAll,
                               defaultCharacterMapId,
                               defaultCharacterNcharMapId);
         }
     }
 
+    // Caller holds mtxTransaction and mtxSchema. Touched tables and objects of all pending system transactions are rebuilt together,
+    // a lookup that could see a different answer after the rebuild forces it first, see Schema::isLookupStale
+    void Metadata::rebuildSchemaMaps() {
+        schemaMapsPending = false;
+
+        std::vector<std::string> msgs;
+        std::unordered_map<typeObj, std::string> tablesDropped;
+        std::unordered_map<typeObj, std::string> tablesUpdated;
+        schema->dropUnusedMetadata(users, schemaElements, tablesDropped);
+
+        buildMaps(msgs, tablesUpdated);
+        schema->resetTouched();
+
+        for (const auto& msg: msgs)
+            ctx->info(0, msg);
+        for (const auto& [obj, tableName]: tablesDropped) {
+            if (tablesUpdated.find(obj) != tablesUpdated.end())
+                continue;
+            ctx->info(0, "dropped metadata: " + tableName);
+        }
+        for (const auto& [_, tableName]: tablesUpdated) {
+            ctx->info(0, "updated metadata: " + tableName);
+        }
+
+        schema->updateXmlCtx();
+    }
+
+    void Metadata::flushSchemaMaps(Thread* t) {
+        if (likely(!schemaMapsPending.load(std::memory_order_acquire)))
+            return;
+
+        t->contextSet(Thread::CONTEXT::TRAN, Thread::REASON::TRAN);
+        std::unique_lock<std::mutex> const lckTransaction(mtxTransaction);
+        t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::TRANSACTION_SYSTEM);
+        std::unique_lock<std::mutex> const lckSchema(mtxSchema);
+        if (schemaMapsPending)
+            rebuildSchemaMaps();
+        t->contextSet(Thread::CONTEXT::CPU);
+    }
+
     void Metadata::waitForWriter(Thread *t) { {
             t->contextSet(Thread::CONTEXT::CHKPT, Thread::REASON::CHKPT);
             std::unique_lock<std::mutex> lck(mtxCheckpoint);
@@ -293,6 +362,41 @@ namespace OpenLogReplicator {
         t->contextSet(Thread::CONTEXT::CPU);
     }
 
+    // All writers sharing the source have read their checkpoints before the replication start is decided
+    void Metadata::waitForWriters(Thread *t) { {
+            t->contextSet(Thread::CONTEXT::CHKPT, Thread::REASON::CHKPT);
+            std::unique_lock<std::mutex> lck(mtxCheckpoint);
+
+            ++writersStarted;
+            if (writersStarted >= writers)
+                condWriter.notify_all();
+            while (writersStarted < writers && !ctx->hardShutdown) {
+                if (unlikely(ctx->isTraceSet(Ctx::TRACE::SLEEP)))
+                    ctx->logTrace(Ctx::TRACE::SLEEP, "Metadata:waitForWriters");
+                t->contextSet(Thread::CONTEXT::WAIT, Thread::REASON::METADATA_WAIT_WRITERS);
+                condWriter.wait_for(lck, std::chrono::milliseconds(100));
+            }
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
+    }
+
+    // The replication starts at the oldest checkpoint of the writers
+    void Metadata::setWriterCheckpoint(Thread *t, Scn scn, typeIdx idx) { {
+            t->contextSet(Thread::CONTEXT::CHKPT, Thread::REASON::CHKPT);
+            std::unique_lock<std::mutex> const lck(mtxCheckpoint);
+
+            if (clientScn == Scn::none() || scn < clientScn || (scn == clientScn && idx < clientIdx)) {
+                clientScn = scn;
+                clientIdx = idx;
+                startScn = scn;
+                startSequence = Seq::none();
+                startTime.clear();
+                startTimeRel = 0;
+            }
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
+    }
+
     void Metadata::setStatusReady(Thread *t) { {
             t->contextSet(Thread::CONTEXT::CHKPT, Thread::REASON::CHKPT);
             std::unique_lock<std::mutex> const lck(mtxCheckpoint);
@@ -357,9 +461,24 @@ namespace OpenLogReplicator {
         t->contextSet(Thread::CONTEXT::CPU);
     }
 
+    // Scn of the last checkpoint written to the state
+    Scn Metadata::getLastCheckpointScn(Thread* t) {
+        Scn scn; {
+            t->contextSet(Thread::CONTEXT::CHKPT, Thread::REASON::CHKPT);
+            std::unique_lock<std::mutex> const lck(mtxCheckpoint);
+            scn = lastCheckpointScn;
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
+        return scn;
+    }
+
+    // Only the position is taken under mtxCheckpoint, the parser updating it is not held up while the schema is serialized. The
+    // schema is serialized under mtxSchema afterwards and may already contain later DDL, which is skipped by schema scn on restart
     void Metadata::writeCheckpoint(Thread *t, bool force) {
         if (!writeCheckPoint)
             return;
+        const time_ut writeStartTime = ctx->clock->getTimeUt();
+        Scn scn;
         std::ostringstream ss; {
             t->contextSet(Thread::CONTEXT::CHKPT, Thread::REASON::CHKPT);
             std::unique_lock<std::mutex> const lck(mtxCheckpoint);
@@ -376,8 +495,21 @@ namespace OpenLogReplicator {
                 (checkpointBytes - lastCheckpointBytes) / 1024 / 1024 < ctx->checkpointIntervalMb)
                 return;
 
+            serializer->serializeMetadata(this, ss);
+
+            scn = checkpointScn;
+            lastCheckpointScn = checkpointScn;
+            lastSequence = sequence;
+            lastCheckpointFileOffset = checkpointFileOffset;
+            lastCheckpointTime = checkpointTime;
+            lastCheckpointBytes = checkpointBytes;
+        }
+
+        bool storeSchema = true;
+        bool storeDelta = false; {
+            std::unique_lock<std::mutex> const lck(mtxSchema);
+
             // Schema did not change
-            bool storeSchema = true;
             if (schema->refScn != Scn::none() && schema->refScn >= schema->scn) {
                 if (schemaInterval < ctx->schemaForceInterval) {
                     storeSchema = false;
@@ -387,29 +519,40 @@ namespace OpenLogReplicator {
             } else
                 schemaInterval = 0;
 
-            serializer->serialize(this, ss, storeSchema);
-
-            lastCheckpointScn = checkpointScn;
-            lastSequence = sequence;
-            lastCheckpointFileOffset = checkpointFileOffset;
-            lastCheckpointTime = checkpointTime;
-            lastCheckpointBytes = checkpointBytes;
+            // Only rows changed since the last full schema, every schemaDeltaMax deltas the full schema is stored again
+            storeDelta = storeSchema && serializer->isDeltaSupported() && schemaBaseScn != Scn::none() && schemaDeltas < ctx->schemaDeltaMax;
+            if (storeDelta) {
+                serializer->serializeSchemaDelta(this, ss, scn);
+                ++schemaDeltas;
+            } else {
+                serializer->serializeSchema(this, ss, scn, storeSchema);
+                if (storeSchema) {
+                    schemaBaseScn = scn;
+                    schemaDeltas = 0;
+                    schema->resetChanged();
+                }
+            }
+        } {
+            std::unique_lock<std::mutex> const lck(mtxCheckpoint);
             ++checkpoints;
-            checkpointScnList.insert(checkpointScn);
-            checkpointSchemaMap.insert_or_assign(checkpointScn, storeSchema);
+            checkpointScnList.insert(scn);
+            checkpointSchemaMap.insert_or_assign(scn, storeSchema && !storeDelta);
         }
         t->contextSet(Thread::CONTEXT::CPU);
 
-        const std::string checkpointName = database + "-chkpt-" + lastCheckpointScn.toString();
+        const std::string checkpointName = database + "-chkpt-" + scn.toString();
 
         if (unlikely(ctx->isTraceSet(Ctx::TRACE::CHECKPOINT)))
-            ctx->logTrace(Ctx::TRACE::CHECKPOINT, "write scn: " + lastCheckpointScn.toString() + " time: " +
+            ctx->logTrace(Ctx::TRACE::CHECKPOINT, "write scn: " + scn.toString() + " time: " +
                                                   std::to_string(lastCheckpointTime.getVal()) + " seq: " + lastSequence.
                                                   toString() + " offset: " +
                                                   lastCheckpointFileOffset.toString() + " name: " + checkpointName);
 
-        if (!stateWrite(checkpointName, lastCheckpointScn, ss))
+        if (!stateWrite(checkpointName, scn, ss))
             ctx->warning(60018, "file: " + checkpointName + " - couldn't write checkpoint");
+
+        if (ctx->metrics != nullptr)
+            ctx->metrics->emitCheckpointDurationUs(static_cast<int64_t>(ctx->clock->getTimeUt() - writeStartTime));
     }
 
     void Metadata::readCheckpoints() {
@@ -463,17 +606,17 @@ namespace OpenLogReplicator {
         std::vector<std::string> msgs;
         std::unordered_map<typeObj, std::string> tablesUpdated;
         ctx->info(0, "reading metadata for " + database + " for scn: " + scn.toString());
-        std::string ss;
+        StateImage image;
 
         const std::string name1(database + "-chkpt-" + scn.toString());
-        if (!stateRead(name1, CHECKPOINT_SCHEMA_FILE_MAX_SIZE, ss)) {
+        if (!stateMap(name1, CHECKPOINT_SCHEMA_FILE_MAX_SIZE, image)) {
             if (unlikely(ctx->isTraceSet(Ctx::TRACE::CHECKPOINT)))
                 ctx->logTrace(Ctx::TRACE::CHECKPOINT, "no checkpoint file found, setting unknown sequence");
 
             sequence = Seq::none();
             return;
         }
-        if (!serializer->deserialize(this, ss, name1, msgs, tablesUpdated, true, true)) {
+        if (!serializer->deserialize(this, image.data, name1, msgs, tablesUpdated, true, true)) {
             for (const auto &[_, tableName]: tablesUpdated) {
                 ctx->info(0, tableName);
             }
@@ -487,21 +630,27 @@ namespace OpenLogReplicator {
         }
         tablesUpdated.clear();
 
-        // Schema missing
-        if (schema->scn == Scn::none()) {
+        // Schema missing, a reference can lead to a delta checkpoint which refers to its base
+        uint hops = 0;
+        while (schema->scn == Scn::none()) {
             if (schema->refScn == Scn::none()) {
                 ctx->warning(60019, "file: " + name1 + " - load checkpoint failed, reference SCN missing");
                 return;
             }
+            if (++hops > MAX_SCHEMA_REFERENCES) {
+                ctx->warning(60019, "file: " + name1 + " - load checkpoint failed, too many schema references");
+                return;
+            }
 
-            ss.clear();
             const std::string name2(database + "-chkpt-" + schema->refScn.toString());
             ctx->info(0, "reading schema for " + database + " for scn: " + schema->refScn.toString());
 
-            if (!stateRead(name2, CHECKPOINT_SCHEMA_FILE_MAX_SIZE, ss))
+            if (!stateMap(name2, CHECKPOINT_SCHEMA_FILE_MAX_SIZE, image))
                 return;
 
-            if (!serializer->deserialize(this, ss, name2, msgs, tablesUpdated, false, true)) {
+            msgs.clear();
+            tablesUpdated.clear();
+            if (!serializer->deserialize(this, image.data, name2, msgs, tablesUpdated, false, true)) {
                 for (const auto &msg: msgs) {
                     ctx->info(0, msg);
                 }
@@ -515,9 +664,18 @@ namespace OpenLogReplicator {
                 ctx->info(0, "- found: " + tableName);
             }
         }
+        // The next schema checkpoint is a full one
+        schema->resetChanged();
 
-        if (schema->scn != Scn::none())
+        if (schema->scn != Scn::none()) {
             firstSchemaScn = schema->scn;
+
+            // Rows of other users are dropped from the dictionary, only sources replicating the same users may share it
+            std::string key(database + "-" + schema->scn.toString());
+            for (const auto& user: users)
+                key.append("-" + user);
+            schema->shareDict(key);
+        }
     }
 
     void Metadata::deleteOldCheckpoints(Thread *t) {
@@ -41,12 +41,15 @@ namespace OpenLogReplicator {
     class Ctx;
     class DbIncarnation;
     class Locales;
+    class PartitionCoordinator;
     class RedoLog;
     class Schema;
     class SchemaElement;
     class Serializer;
+    class StandbyLease;
     class State;
     class StateDisk;
+    class StateImage;
     class Thread;
 
     class Metadata final {
@@ -54,6 +57,8 @@ namespace OpenLogReplicator {
         std::condition_variable condReplicator;
         std::condition_variable condWriter;
         static constexpr uint64_t CHECKPOINT_SCHEMA_FILE_MAX_SIZE = 2147483648;
+        // Schema reference to a delta checkpoint, which refers to the full schema
+        static constexpr uint MAX_SCHEMA_REFERENCES = 2;
 
     public:
         enum class STATUS : unsigned char {
@@ -68,7 +73,17 @@ namespace OpenLogReplicator {
         State* state{nullptr};
         State* stateDisk{nullptr};
         Serializer* serializer{nullptr};
+        StandbyLease* lease{nullptr};
+        // Set when the tables are split between instances, only the rows of the owned partitions are kept
+        PartitionCoordinator* partitions{nullptr};
         std::atomic<STATUS> status{STATUS::READY};
+        // The lease is held by another instance: parse without output up to the position confirmed by its client
+        std::atomic<bool> standby{false};
+        std::atomic<uint64_t> standbyScn{Scn::none().getData()};
+        // Writer checkpoints kept in a ring of binary slots in that directory instead of the state, not used with 0 slots
+        std::string checkpointRingPath;
+        uint64_t checkpointRingSlots{0};
+        bool checkpointRingSync{true};
 
         // Startup parameters
         std::string database;
@@ -119,6 +134,9 @@ namespace OpenLogReplicator {
         Scn nextScn{Scn::none()};
         Scn clientScn{Scn::none()};
         typeIdx clientIdx{0};
+        // Writers reading the output of this source, each one with its own checkpoint
+        uint64_t writers{1};
+        uint64_t writersStarted{0};
         uint64_t checkpoints{0};
         Scn checkpointScn{Scn::none()};
         Scn lastCheckpointScn{Scn::none()};
@@ -133,6 +151,9 @@ namespace OpenLogReplicator {
         FileOffset minFileOffset;
         Xid minXid;
         uint64_t schemaInterval{0};
+        // Last checkpoint with the full schema and number of delta checkpoints written on top of it
+        Scn schemaBaseScn{Scn::none()};
+        uint64_t schemaDeltas{0};
         std::set<Scn> checkpointScnList;
         std::unordered_map<Scn, bool> checkpointSchemaMap;
 
@@ -140,6 +161,8 @@ namespace OpenLogReplicator {
 
         // Schema information
         std::mutex mtxSchema;
+        // Dictionary changed by committed system transactions, the table maps are not rebuilt yet
+        std::atomic<bool> schemaMapsPending{false};
         std::vector<SchemaElement*> schemaElements;
         std::set<std::string> users;
 
@@ -155,6 +178,7 @@ namespace OpenLogReplicator {
         void setFirstNextScn(Scn newFirstScn, Scn newNextScn);
         void setNextSequence();
         [[nodiscard]] bool stateRead(const std::string& name, uint64_t maxSize, std::string& in) const;
+        [[nodiscard]] bool stateMap(const std::string& name, uint64_t maxSize, StateImage& image) const;
         [[nodiscard]] bool stateDiskRead(const std::string& name, uint64_t maxSize, std::string& in) const;
         [[nodiscard]] bool stateWrite(const std::string& name, Scn scn, const std::ostringstream& out) const;
         [[nodiscard]] bool stateDrop(const std::string& name) const;
@@ -162,10 +186,15 @@ namespace OpenLogReplicator {
         SchemaElement* addElement(const std::string& owner, const std::string& table, DbTable::OPTIONS options);
         void resetElements();
         void commitElements();
+        [[nodiscard]] bool isElementsAppendOnly() const;
         void buildMaps(std::vector<std::string>& msgs, std::unordered_map<typeObj, std::string>& tablesUpdated);
+        void rebuildSchemaMaps();
+        void flushSchemaMaps(Thread* t);
 
         void waitForWriter(Thread* t);
         void waitForReplicator(Thread* t);
+        void waitForWriters(Thread* t);
+        void setWriterCheckpoint(Thread* t, Scn scn, typeIdx idx);
         void setStatusReady(Thread* t);
         void setStatusStart(Thread* t);
         void setStatusReplicate(Thread* t);
@@ -173,6 +202,7 @@ namespace OpenLogReplicator {
         void checkpoint(Thread* t, Scn newCheckpointScn, Time newCheckpointTime, Seq newCheckpointSequence, FileOffset newCheckpointFileOffset,
                         uint64_t newCheckpointBytes, Seq newMinSequence, FileOffset newMinFileOffset, Xid newMinXid);
         void writeCheckpoint(Thread* t, bool force);
+        [[nodiscard]] Scn getLastCheckpointScn(Thread* t);
         void readCheckpoints();
         void readCheckpoint(Scn scn);
         void deleteOldCheckpoints(Thread* t);
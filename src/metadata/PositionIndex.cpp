@@ -0,0 +1,203 @@
+/* Catalog of redo log headers used for positioning
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+#include "../common/Ctx.h"
+#include "../common/exception/DataException.h"
+#include "../common/exception/RuntimeException.h"
+#include "../state/State.h"
+#include "PositionIndex.h"
+
+namespace OpenLogReplicator {
+    PositionIndex::PositionIndex(Ctx* newCtx, State* newState, std::string newName) :
+            ctx(newCtx),
+            state(newState),
+            name(std::move(newName)) {
+    }
+
+    void PositionIndex::load() {
+        std::string ss;
+        try {
+            if (!state->read(name, POSITION_INDEX_FILE_MAX_SIZE, ss))
+                return;
+        } catch (RuntimeException& ex) {
+            ctx->error(ex.code, ex.msg);
+            return;
+        }
+
+        std::vector<Entry> loaded;
+        try {
+            rapidjson::Document document;
+            if (unlikely(ss.empty() || document.Parse(ss.c_str()).HasParseError()))
+                throw DataException(20001, "file: " + name + " offset: " + std::to_string(document.GetErrorOffset()) +
+                                           " - parse error: " + GetParseError_En(document.GetParseError()));
+
+            const rapidjson::Value& logsJson = Ctx::getJsonFieldA(name, document, "logs");
+            loaded.reserve(logsJson.Size());
+            for (rapidjson::SizeType i = 0; i < logsJson.Size(); ++i) {
+                Entry entry;
+                entry.resetlogs = Ctx::getJsonFieldU32(name, logsJson[i], "resetlogs");
+                entry.sequence = Ctx::getJsonFieldU32(name, logsJson[i], "seq");
+                entry.firstScn = Ctx::getJsonFieldU64(name, logsJson[i], "first-scn");
+                entry.nextScn = Ctx::getJsonFieldU64(name, logsJson[i], "next-scn");
+                entry.firstTime = Ctx::getJsonFieldU32(name, logsJson[i], "first-time");
+                loaded.push_back(entry);
+            }
+        } catch (DataException& ex) {
+            ctx->warning(60056, "file: " + name + " - position index ignored: " + ex.msg);
+            return;
+        }
+
+        std::sort(loaded.begin(), loaded.end(), [](const Entry& a, const Entry& b) {
+            return less(a, {b.resetlogs, b.sequence});
+        });
+
+        std::unique_lock<std::mutex> const lck(mtx);
+        entries = std::move(loaded);
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::CHECKPOINT)))
+            ctx->logTrace(Ctx::TRACE::CHECKPOINT, "position index: " + name + " logs: " + std::to_string(entries.size()));
+    }
+
+    void PositionIndex::store() const {
+        std::ostringstream ss;
+        ss << R"({"logs":[)";
+        bool first = true;
+        Scn scnMax = Scn::zero();
+        for (const Entry& entry: entries) {
+            if (!first)
+                ss << ",";
+            first = false;
+            ss << R"({"resetlogs":)" << std::dec << entry.resetlogs << R"(,"seq":)" << entry.sequence.getData() << R"(,"first-scn":)" <<
+               entry.firstScn.getData() << R"(,"next-scn":)" << entry.nextScn.getData() << R"(,"first-time":)" << entry.firstTime.getVal() << "}";
+            if (entry.firstScn > scnMax)
+                scnMax = entry.firstScn;
+        }
+        ss << "]}";
+
+        try {
+            state->write(name, scnMax, ss);
+        } catch (RuntimeException& ex) {
+            ctx->error(ex.code, ex.msg);
+        }
+    }
+
+    // Called for every header read, the index is only written when a log is new or its next SCN becomes known
+    void PositionIndex::add(typeResetlogs resetlogs, Seq sequence, Scn firstScn, Scn nextScn, Time firstTime) {
+        if (resetlogs == 0 || sequence == Seq::none() || sequence == Seq::zero() || firstScn == Scn::none())
+            return;
+
+        std::unique_lock<std::mutex> const lck(mtx);
+        auto it = std::lower_bound(entries.begin(), entries.end(), std::make_pair(resetlogs, sequence), less);
+        if (it != entries.end() && it->resetlogs == resetlogs && it->sequence == sequence) {
+            if (it->firstScn == firstScn && it->nextScn == nextScn)
+                return;
+            it->firstScn = firstScn;
+            it->nextScn = nextScn;
+            it->firstTime = firstTime;
+        } else {
+            entries.insert(it, Entry{resetlogs, sequence, firstScn, nextScn, firstTime});
+            if (entries.size() > ENTRIES_MAX)
+                entries.erase(entries.begin(), entries.begin() + static_cast<int64_t>(entries.size() - ENTRIES_MAX));
+        }
+
+        // A log still written changes once more at the log switch
+        if (nextScn != Scn::none())
+            store();
+    }
+
+    bool PositionIndex::incarnation(typeResetlogs resetlogs, std::vector<Entry>::const_iterator& begin, std::vector<Entry>::const_iterator& end) const {
+        if (entries.empty())
+            return false;
+        if (resetlogs == 0)
+            resetlogs = entries.back().resetlogs;
+
+        begin = std::lower_bound(entries.begin(), entries.end(), std::make_pair(resetlogs, Seq::zero()), less);
+        end = begin;
+        while (end != entries.end() && end->resetlogs == resetlogs)
+            ++end;
+        return begin != end;
+    }
+
+    // The log holding the SCN: the last one starting at or before it, as long as no log is missing up to the SCN
+    bool PositionIndex::findScn(typeResetlogs resetlogs, Scn scn, Seq& sequence) const {
+        std::unique_lock<std::mutex> const lck(mtx);
+        std::vector<Entry>::const_iterator begin;
+        std::vector<Entry>::const_iterator end;
+        if (!incarnation(resetlogs, begin, end))
+            return false;
+
+        auto it = std::upper_bound(begin, end, scn, [](Scn value, const Entry& entry) {
+            return value < entry.firstScn;
+        });
+        if (it == begin)
+            return false;
+        --it;
+
+        if (scn >= it->nextScn) {
+            // Between two logs of the index, or after the last one
+            auto next = it + 1;
+            if (next == end || next->sequence.getData() != it->sequence.getData() + 1)
+                return false;
+            it = next;
+        }
+
+        sequence = it->sequence;
+        return true;
+    }
+
+    // The log being written at the time, the position is its first SCN: nothing after the time is skipped
+    bool PositionIndex::findTime(typeResetlogs resetlogs, Time time, Seq& sequence, Scn& scn) const {
+        std::unique_lock<std::mutex> const lck(mtx);
+        std::vector<Entry>::const_iterator begin;
+        std::vector<Entry>::const_iterator end;
+        if (!incarnation(resetlogs, begin, end))
+            return false;
+
+        auto it = std::upper_bound(begin, end, time.getVal(), [](uint32_t value, const Entry& entry) {
+            return value < entry.firstTime.getVal();
+        });
+        if (it == begin)
+            return false;
+        --it;
+
+        sequence = it->sequence;
+        scn = it->firstScn;
+        return true;
+    }
+
+    // "YYYY-MM-DD HH24:MI:SS" in the time zone of the database host, encoded as in the redo log header
+    bool PositionIndex::parseTime(const std::string& text, Time& time) {
+        uint year;
+        uint month;
+        uint day;
+        uint hour;
+        uint minute;
+        uint second;
+        if (sscanf(text.c_str(), "%4u-%2u-%2u %2u:%2u:%2u", &year, &month, &day, &hour, &minute, &second) != 6)
+            return false;
+        if (year < 1988 || month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 59)
+            return false;
+
+        time = ((((((year - 1988) * 12 + (month - 1)) * 31 + (day - 1)) * 24 + hour) * 60 + minute) * 60) + second;
+        return true;
+    }
+}
@@ -0,0 +1,81 @@
+/* Header for PositionIndex class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef POSITION_INDEX_H_
+#define POSITION_INDEX_H_
+
+#include <mutex>
+#include <vector>
+
+#include "../common/types/Scn.h"
+#include "../common/types/Seq.h"
+#include "../common/types/Time.h"
+#include "../common/types/Types.h"
+
+namespace OpenLogReplicator {
+    class Ctx;
+    class State;
+
+    // First and next SCN and first time of every redo log header seen by the readers, kept in the state next to the checkpoints.
+    // Finding the log of a start SCN or start time is then a binary search instead of a database query, which also works in
+    // offline and batch mode where no query is possible
+    class PositionIndex final {
+    protected:
+        static constexpr uint64_t POSITION_INDEX_FILE_MAX_SIZE{16 * 1024 * 1024};
+        // Oldest logs are dropped above this count
+        static constexpr size_t ENTRIES_MAX{100000};
+
+        struct Entry {
+            typeResetlogs resetlogs;
+            Seq sequence;
+            Scn firstScn;
+            // Scn::none() while the log is still written
+            Scn nextScn;
+            Time firstTime;
+        };
+
+        Ctx* ctx;
+        State* state;
+        std::string name;
+
+        mutable std::mutex mtx;
+        // Sorted by resetlogs and sequence
+        std::vector<Entry> entries;
+
+        static bool less(const Entry& entry, std::pair<typeResetlogs, Seq> key) {
+            return entry.resetlogs < key.first || (entry.resetlogs == key.first && entry.sequence < key.second);
+        }
+
+        void store() const;
+        [[nodiscard]] bool incarnation(typeResetlogs resetlogs, std::vector<Entry>::const_iterator& begin, std::vector<Entry>::const_iterator& end) const;
+
+    public:
+        PositionIndex(Ctx* newCtx, State* newState, std::string newName);
+
+        void load();
+        void add(typeResetlogs resetlogs, Seq sequence, Scn firstScn, Scn nextScn, Time firstTime);
+        // Resetlogs 0 searches the newest incarnation
+        [[nodiscard]] bool findScn(typeResetlogs resetlogs, Scn scn, Seq& sequence) const;
+        [[nodiscard]] bool findTime(typeResetlogs resetlogs, Time time, Seq& sequence, Scn& scn) const;
+
+        [[nodiscard]] static bool parseTime(const std::string& text, Time& time);
+    };
+}
+
+#endif
@@ -29,13 +29,15 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include "../common/exception/DataException.h"
 #include "../locales/Locales.h"
 #include "Schema.h"
+#include "SchemaCache.h"
 #include "SchemaElement.h"
 
 namespace OpenLogReplicator {
     Schema::Schema(Ctx* newCtx, Locales* newLocales) :
             ctx(newCtx),
             locales(newLocales),
-            sysUserAdaptive(sysUserRowId, 0, "", 0, 0, false) {
+            sysUserAdaptive(sysUserRowId, 0, "", 0, 0, false),
+            dict(std::make_shared<SchemaDict>()) {
     }
 
     // FIXME: throws exception
@@ -80,28 +82,18 @@ namespace OpenLogReplicator {
         if (!tablePartitionMap.empty())
             ctx->error(50029, "schema table partition map not empty, left: " + std::to_string(tablePartitionMap.size()) + " at exit");
         tablePartitionMap.clear();
+        ++tablePartitionVersion;
 
         tablesTouched.clear();
         identifiersTouched.clear();
     }
 
     void Schema::purgeDicts() {
-        sysCColPack.clear(ctx);
-        sysCDefPack.clear(ctx);
-        sysColPack.clear(ctx);
-        sysDeferredStgPack.clear(ctx);
-        sysEColPack.clear(ctx);
-        sysLobPack.clear(ctx);
-        sysLobCompPartPack.clear(ctx);
-        sysLobFragPack.clear(ctx);
-        sysObjPack.clear(ctx);
-        sysTabPack.clear(ctx);
-        sysTabComPartPack.clear(ctx);
-        sysTabPartPack.clear(ctx);
-        sysTabSubPartPack.clear(ctx);
-        sysTsPack.clear(ctx);
-        sysUserPack.clear(ctx);
-        xdbTtSetPack.clear(ctx);
+        // A shared dictionary is only released, the last schema holding it frees the rows
+        if (dict->key.empty())
+            dict->purge(ctx);
+        else
+            dict = std::make_shared<SchemaDict>();
 
         while (!schemaXmlMap.empty()) {
             auto schemaXmlMapIt = schemaXmlMap.cbegin();
@@ -115,22 +107,8 @@ namespace OpenLogReplicator {
     }
 
     bool Schema::compare(Schema* otherSchema, std::string& msgs) const {
-        if (!sysCColPack.compareTo(otherSchema->sysCColPack, msgs)) return false;
-        if (!sysCDefPack.compareTo(otherSchema->sysCDefPack, msgs)) return false;
-        if (!sysColPack.compareTo(otherSchema->sysColPack, msgs)) return false;
-        if (!sysDeferredStgPack.compareTo(otherSchema->sysDeferredStgPack, msgs)) return false;
-        if (!sysEColPack.compareTo(otherSchema->sysEColPack, msgs)) return false;
-        if (!sysLobPack.compareTo(otherSchema->sysLobPack, msgs)) return false;
-        if (!sysLobCompPartPack.compareTo(otherSchema->sysLobCompPartPack, msgs)) return false;
-        if (!sysLobFragPack.compareTo(otherSchema->sysLobFragPack, msgs)) return false;
-        if (!sysObjPack.compareTo(otherSchema->sysObjPack, msgs)) return false;
-        if (!sysTabPack.compareTo(otherSchema->sysTabPack, msgs)) return false;
-        if (!sysTabComPartPack.compareTo(otherSchema->sysTabComPartPack, msgs)) return false;
-        if (!sysTabPartPack.compareTo(otherSchema->sysTabPartPack, msgs)) return false;
-        if (!sysTabSubPartPack.compareTo(otherSchema->sysTabSubPartPack, msgs)) return false;
-        if (!sysTsPack.compareTo(otherSchema->sysTsPack, msgs)) return false;
-        if (!sysUserPack.compareTo(otherSchema->sysUserPack, msgs)) return false;
-        if (!xdbTtSetPack.compareTo(otherSchema->xdbTtSetPack, msgs)) return false;
+        if (!dict->compare(*otherSchema->dict, msgs))
+            return false;
         for (const auto& [tokSuf, xmlCtx]: schemaXmlMap) {
             auto otherXmlCtxIt = otherSchema->schemaXmlMap.find(tokSuf);
             if (otherXmlCtxIt == otherSchema->schemaXmlMap.end())
@@ -147,6 +125,51 @@ namespace OpenLogReplicator {
         return true;
     }
 
+    // Called before every change of the dictionary rows, a dictionary shared with other sources is copied first unless this schema
+    // is its last user
+    void Schema::dictForUpdate() {
+        if (likely(dict->key.empty()))
+            return;
+        if (ctx->schemaCache != nullptr && ctx->schemaCache->withdraw(dict))
+            return;
+
+        ctx->info(0, "copying shared schema dictionary (" + std::to_string(dict->countRows()) + " rows) before change at scn: " + scn.toString());
+        auto copy = std::make_shared<SchemaDict>();
+        copy->copyFrom(*dict);
+        dict = std::move(copy);
+    }
+
+    // Called after the schema is loaded, when another source has already loaded the same dictionary it is used instead of the own copy
+    void Schema::shareDict(const std::string& key) {
+        if (ctx->schemaCache == nullptr || !dict->key.empty())
+            return;
+
+        std::shared_ptr<SchemaDict> shared = ctx->schemaCache->share(key, dict);
+        if (shared == dict)
+            return;
+
+        ctx->info(0, "using schema dictionary shared with other sources (" + std::to_string(shared->countRows()) + " rows) for scn: " + scn.toString());
+        dict = std::move(shared);
+    }
+
+    // Called before the dictionaries are read from the database, when another source already read them for the same tables at the same
+    // SCN they are used without running the queries. Dictionaries with XML token sets are read again, the XML contexts are per schema
+    bool Schema::adoptDict(const std::string& key) {
+        if (ctx->schemaCache == nullptr)
+            return false;
+
+        std::shared_ptr<SchemaDict> shared = ctx->schemaCache->find(key);
+        if (shared == nullptr || !shared->xdbTtSetPack.mapRowId.empty())
+            return false;
+
+        ctx->info(0, "using schema dictionary read by another source (" + std::to_string(shared->countRows()) + " rows) for scn: " + scn.toString());
+        dict = std::move(shared);
+        // The maps are built from the touched objects, like after reading the rows
+        for (const auto& [_, sysObj]: dict->sysObjPack.mapRowId)
+            touchTable(sysObj->obj);
+        return true;
+    }
+
     void Schema::touchTable(typeObj obj) {
         if (obj == 0)
             return;
@@ -164,23 +187,23 @@ namespace OpenLogReplicator {
     }
 
     void Schema::touchTableLob(typeObj lobObj) {
-        const auto& it = sysLobPack.unorderedMapKey.find(SysLobLObj(lobObj));
-        if (it != sysLobPack.unorderedMapKey.end())
+        const auto& it = dict->sysLobPack.unorderedMapKey.find(SysLobLObj(lobObj));
+        if (it != dict->sysLobPack.unorderedMapKey.end())
             touchTable(it->second->obj);
     }
 
     void Schema::touchTableLobFrag(typeObj lobFragObj) {
-        const auto& it = sysLobCompPartPack.unorderedMapKey.find(SysLobCompPartPartObj(lobFragObj));
-        if (it != sysLobCompPartPack.unorderedMapKey.end()) {
-            const auto& it2 = sysLobPack.unorderedMapKey.find(SysLobLObj(it->second->lObj));
-            if (it2 != sysLobPack.unorderedMapKey.end())
+        const auto& it = dict->sysLobCompPartPack.unorderedMapKey.find(SysLobCompPartPartObj(lobFragObj));
+        if (it != dict->sysLobCompPartPack.unorderedMapKey.end()) {
+            const auto& it2 = dict->sysLobPack.unorderedMapKey.find(SysLobLObj(it->second->lObj));
+            if (it2 != dict->sysLobPack.unorderedMapKey.end())
                 touchTable(it2->second->obj);
         }
     }
 
     void Schema::touchTablePart(typeObj obj) {
-        const auto& it = sysObjPack.unorderedMapKey.find(SysObjObj(obj));
-        if (it != sysObjPack.unorderedMapKey.end())
+        const auto& it = dict->sysObjPack.unorderedMapKey.find(SysObjObj(obj));
+        if (it != dict->sysObjPack.unorderedMapKey.end())
             touchTable(it->second->obj);
     }
 
@@ -193,13 +216,13 @@ namespace OpenLogReplicator {
     }
 
     bool Schema::checkTableDictUncommitted(typeObj obj, std::string& owner, std::string& table) const {
-        const auto& objIt = sysObjPack.unorderedMapKey.find(SysObjObj(obj));
-        if (objIt == sysObjPack.unorderedMapKey.end())
+        const auto& objIt = dict->sysObjPack.unorderedMapKey.find(SysObjObj(obj));
+        if (objIt == dict->sysObjPack.unorderedMapKey.end())
             return false;
         const SysObj* sysObj = objIt->second;
 
-        const auto& userIt = sysUserPack.unorderedMapKey.find(SysUserUser(sysObj->owner));
-        if (userIt == sysUserPack.unorderedMapKey.end())
+        const auto& userIt = dict->sysUserPack.unorderedMapKey.find(SysUserUser(sysObj->owner));
+        if (userIt == dict->sysUserPack.unorderedMapKey.end())
             return false;
         const SysUser* sysUser = userIt->second;
 
@@ -224,6 +247,24 @@ namespace OpenLogReplicator {
         return nullptr;
     }
 
+    // Whether the answer of checkTableDict may change with the pending map rebuild
+    bool Schema::isLookupStale(typeObj obj, const DbTable* table) const {
+        if (table != nullptr)
+            return tablesTouched.find(const_cast<DbTable*>(table)) != tablesTouched.end();
+        if (ctx->isFlagSet(Ctx::REDO_FLAGS::ADAPTIVE_SCHEMA))
+            return true;
+
+        // A table or partition the rebuild could add has its row in SYS.OBJ$ already
+        return dict->sysObjPack.unorderedMapKey.find(SysObjObj(obj)) != dict->sysObjPack.unorderedMapKey.end();
+    }
+
+    bool Schema::isSystemTableTouched() const {
+        for (const DbTable* table: tablesTouched)
+            if (DbTable::isSystemTable(table->options))
+                return true;
+        return false;
+    }
+
     void Schema::addTableToDict(DbTable* table) {
         if (unlikely(tableMap.find(table->obj) != tableMap.end()))
             throw DataException(50031, "can't add table (obj: " + std::to_string(table->obj) + ", dataobj: " + std::to_string(table->dataObj) + ")");
@@ -244,6 +285,7 @@ namespace OpenLogReplicator {
             }
         }
 
+        ++tablePartitionVersion;
         if (likely(tablePartitionMap.find(table->obj) == tablePartitionMap.end()))
             tablePartitionMap.insert_or_assign(table->obj, table);
         else
@@ -263,6 +305,7 @@ namespace OpenLogReplicator {
     }
 
     void Schema::removeTableFromDict(DbTable* table) {
+        ++tablePartitionVersion;
         auto tablePartitionMapIt = tablePartitionMap.find(table->obj);
         if (likely(tablePartitionMapIt != tablePartitionMap.end()))
             tablePartitionMap.erase(tablePartitionMapIt);
@@ -298,6 +341,7 @@ namespace OpenLogReplicator {
             }
         }
 
+        tablesLazy.erase(table->obj);
         auto tableMapIt = tableMap.find(table->obj);
         if (likely(tableMapIt != tableMap.end()))
             tableMap.erase(tableMapIt);
@@ -316,19 +360,23 @@ namespace OpenLogReplicator {
         }
         tablesTouched.clear();
 
+        // Nothing is touched in a shared dictionary
+        if (!dict->key.empty())
+            return;
+
         // SYS.USER$
-        for (auto* sysUser: sysUserPack.setTouched) {
+        for (auto* sysUser: dict->sysUserPack.setTouched) {
             if (users.find(sysUser->name) != users.end())
                 continue;
-            sysUserPack.drop(ctx, sysUser->rowId);
+            dict->sysUserPack.drop(ctx, sysUser->rowId);
         }
 
         // SYS.OBJ$
         if (!ctx->isFlagSet(Ctx::REDO_FLAGS::ADAPTIVE_SCHEMA)) {
             // delete objects owned by users that are not in the list of users
-            for (auto* sysObj: sysObjPack.setTouched) {
-                auto sysUserMapUserIt = sysUserPack.unorderedMapKey.find(SysUserUser(sysObj->owner));
-                if (sysUserMapUserIt != sysUserPack.unorderedMapKey.end()) {
+            for (auto* sysObj: dict->sysObjPack.setTouched) {
+                auto sysUserMapUserIt = dict->sysUserPack.unorderedMapKey.find(SysUserUser(sysObj->owner));
+                if (sysUserMapUserIt != dict->sysUserPack.unorderedMapKey.end()) {
                     SysUser* sysUser = sysUserMapUserIt->second;
                     if (sysUser->name == "SYS" || sysUser->name == "XDB") {
                         if (!sysUser->single)
@@ -347,141 +395,193 @@ namespace OpenLogReplicator {
                     }
                 }
 
-                sysObjPack.drop(ctx, sysObj->rowId);
+                dict->sysObjPack.drop(ctx, sysObj->rowId);
                 touched = true;
             }
-            sysObjPack.setTouched.clear();
+            dict->sysObjPack.setTouched.clear();
         }
 
         // SYS.CCOL$
-        for (auto* sysCCol: sysCColPack.setTouched) {
-            if (sysObjPack.unorderedMapKey.find(SysObjObj(sysCCol->obj)) != sysObjPack.unorderedMapKey.end())
+        for (auto* sysCCol: dict->sysCColPack.setTouched) {
+            if (dict->sysObjPack.unorderedMapKey.find(SysObjObj(sysCCol->obj)) != dict->sysObjPack.unorderedMapKey.end())
                 continue;
-            sysCColPack.drop(ctx, sysCCol->rowId);
+            dict->sysCColPack.drop(ctx, sysCCol->rowId);
             touched = true;
         }
-        sysCColPack.setTouched.clear();
+        dict->sysCColPack.setTouched.clear();
 
         // SYS.CDEF$
-        for (auto* sysCDef: sysCDefPack.setTouched) {
-            if (sysObjPack.unorderedMapKey.find(SysObjObj(sysCDef->obj)) != sysObjPack.unorderedMapKey.end())
+        for (auto* sysCDef: dict->sysCDefPack.setTouched) {
+            if (dict->sysObjPack.unorderedMapKey.find(SysObjObj(sysCDef->obj)) != dict->sysObjPack.unorderedMapKey.end())
                 continue;
-            sysCDefPack.drop(ctx, sysCDef->rowId);
+            dict->sysCDefPack.drop(ctx, sysCDef->rowId);
             touched = true;
         }
-        sysCDefPack.setTouched.clear();
+        dict->sysCDefPack.setTouched.clear();
 
         // SYS.COL$
-        for (auto* sysCol: sysColPack.setTouched) {
-            if (sysObjPack.unorderedMapKey.find(SysObjObj(sysCol->obj)) != sysObjPack.unorderedMapKey.end())
+        for (auto* sysCol: dict->sysColPack.setTouched) {
+            if (dict->sysObjPack.unorderedMapKey.find(SysObjObj(sysCol->obj)) != dict->sysObjPack.unorderedMapKey.end())
                 continue;
-            sysColPack.drop(ctx, sysCol->rowId);
+            dict->sysColPack.drop(ctx, sysCol->rowId);
             touched = true;
         }
-        sysColPack.setTouched.clear();
+        dict->sysColPack.setTouched.clear();
 
         // SYS.DEFERRED_STG$
-        for (auto* sysDeferredStg: sysDeferredStgPack.setTouched) {
-            if (sysObjPack.unorderedMapKey.find(SysObjObj(sysDeferredStg->obj)) != sysObjPack.unorderedMapKey.end())
+        for (auto* sysDeferredStg: dict->sysDeferredStgPack.setTouched) {
+            if (dict->sysObjPack.unorderedMapKey.find(SysObjObj(sysDeferredStg->obj)) != dict->sysObjPack.unorderedMapKey.end())
                 continue;
-            sysDeferredStgPack.drop(ctx, sysDeferredStg->rowId);
+            dict->sysDeferredStgPack.drop(ctx, sysDeferredStg->rowId);
             touched = true;
         }
-        sysDeferredStgPack.setTouched.clear();
+        dict->sysDeferredStgPack.setTouched.clear();
 
         // SYS.ECOL$
-        for (auto* sysECol: sysEColPack.setTouched) {
-            if (sysObjPack.unorderedMapKey.find(SysObjObj(sysECol->tabObj)) != sysObjPack.unorderedMapKey.end())
+        for (auto* sysECol: dict->sysEColPack.setTouched) {
+            if (dict->sysObjPack.unorderedMapKey.find(SysObjObj(sysECol->tabObj)) != dict->sysObjPack.unorderedMapKey.end())
                 continue;
-            sysEColPack.drop(ctx, sysECol->rowId);
+            dict->sysEColPack.drop(ctx, sysECol->rowId);
             touched = true;
         }
-        sysEColPack.setTouched.clear();
+        dict->sysEColPack.setTouched.clear();
 
         // SYS.LOB$
-        for (auto* sysLob: sysLobPack.setTouched) {
-            if (sysObjPack.unorderedMapKey.find(SysObjObj(sysLob->obj)) != sysObjPack.unorderedMapKey.end())
+        for (auto* sysLob: dict->sysLobPack.setTouched) {
+            if (dict->sysObjPack.unorderedMapKey.find(SysObjObj(sysLob->obj)) != dict->sysObjPack.unorderedMapKey.end())
                 continue;
-            sysLobPack.drop(ctx, sysLob->rowId);
+            dict->sysLobPack.drop(ctx, sysLob->rowId);
             touched = true;
         }
-        sysLobPack.setTouched.clear();
+        dict->sysLobPack.setTouched.clear();
 
         // SYS.LOBCOMPPART$
-        for (auto* sysLobCompPart: sysLobCompPartPack.setTouched) {
-            if (sysLobPack.unorderedMapKey.find(SysLobLObj(sysLobCompPart->lObj)) != sysLobPack.unorderedMapKey.end())
+        for (auto* sysLobCompPart: dict->sysLobCompPartPack.setTouched) {
+            if (dict->sysLobPack.unorderedMapKey.find(SysLobLObj(sysLobCompPart->lObj)) != dict->sysLobPack.unorderedMapKey.end())
                 continue;
-            sysLobCompPartPack.drop(ctx, sysLobCompPart->rowId);
+            dict->sysLobCompPartPack.drop(ctx, sysLobCompPart->rowId);
             touched = true;
         }
-        sysLobCompPartPack.setTouched.clear();
+        dict->sysLobCompPartPack.setTouched.clear();
 
         // SYS.LOBFRAG$
-        for (auto* sysLobFrag: sysLobFragPack.setTouched) {
-            if (sysLobCompPartPack.unorderedMapKey.find(SysLobCompPartPartObj(sysLobFrag->parentObj)) != sysLobCompPartPack.unorderedMapKey.end())
+        for (auto* sysLobFrag: dict->sysLobFragPack.setTouched) {
+            if (dict->sysLobCompPartPack.unorderedMapKey.find(SysLobCompPartPartObj(sysLobFrag->parentObj)) != dict->sysLobCompPartPack.unorderedMapKey.end())
                 continue;
-            if (sysLobPack.unorderedMapKey.find(SysLobLObj(sysLobFrag->parentObj)) != sysLobPack.unorderedMapKey.end())
+            if (dict->sysLobPack.unorderedMapKey.find(SysLobLObj(sysLobFrag->parentObj)) != dict->sysLobPack.unorderedMapKey.end())
                 continue;
-            sysLobFragPack.drop(ctx, sysLobFrag->rowId);
+            dict->sysLobFragPack.drop(ctx, sysLobFrag->rowId);
             touched = true;
         }
-        sysLobFragPack.setTouched.clear();
+        dict->sysLobFragPack.setTouched.clear();
 
         // SYS.TAB$
-        for (auto* sysTab: sysTabPack.setTouched) {
-            if (sysObjPack.unorderedMapKey.find(SysObjObj(sysTab->obj)) != sysObjPack.unorderedMapKey.end())
+        for (auto* sysTab: dict->sysTabPack.setTouched) {
+            if (dict->sysObjPack.unorderedMapKey.find(SysObjObj(sysTab->obj)) != dict->sysObjPack.unorderedMapKey.end())
                 continue;
-            sysTabPartPack.drop(ctx, sysTab->rowId);
+            dict->sysTabPartPack.drop(ctx, sysTab->rowId);
             touched = true;
         }
-        sysTabPack.setTouched.clear();
+        dict->sysTabPack.setTouched.clear();
 
         // SYS.TABCOMPART$
-        for (auto* sysTabComPart: sysTabComPartPack.setTouched) {
-            if (sysObjPack.unorderedMapKey.find(SysObjObj(sysTabComPart->obj)) != sysObjPack.unorderedMapKey.end())
+        for (auto* sysTabComPart: dict->sysTabComPartPack.setTouched) {
+            if (dict->sysObjPack.unorderedMapKey.find(SysObjObj(sysTabComPart->obj)) != dict->sysObjPack.unorderedMapKey.end())
                 continue;
-            sysTabComPartPack.drop(ctx, sysTabComPart->rowId);
+            dict->sysTabComPartPack.drop(ctx, sysTabComPart->rowId);
             touched = true;
         }
-        sysTabComPartPack.setTouched.clear();
+        dict->sysTabComPartPack.setTouched.clear();
 
         // SYS.TABPART$
-        for (auto* sysTabPart: sysTabPartPack.setTouched) {
-            if (sysObjPack.unorderedMapKey.find(SysObjObj(sysTabPart->bo)) != sysObjPack.unorderedMapKey.end())
+        for (auto* sysTabPart: dict->sysTabPartPack.setTouched) {
+            if (dict->sysObjPack.unorderedMapKey.find(SysObjObj(sysTabPart->bo)) != dict->sysObjPack.unorderedMapKey.end())
                 continue;
-            sysTabPartPack.drop(ctx, sysTabPart->rowId);
+            dict->sysTabPartPack.drop(ctx, sysTabPart->rowId);
             touched = true;
         }
-        sysTabPartPack.setTouched.clear();
+        dict->sysTabPartPack.setTouched.clear();
 
         // SYS.TABSUBPART$
-        for (auto* sysTabSubPart: sysTabSubPartPack.setTouched) {
-            if (sysObjPack.unorderedMapKey.find(SysObjObj(sysTabSubPart->obj)) != sysObjPack.unorderedMapKey.end())
+        for (auto* sysTabSubPart: dict->sysTabSubPartPack.setTouched) {
+            if (dict->sysObjPack.unorderedMapKey.find(SysObjObj(sysTabSubPart->obj)) != dict->sysObjPack.unorderedMapKey.end())
                 continue;
-            sysTabSubPartPack.drop(ctx, sysTabSubPart->rowId);
+            dict->sysTabSubPartPack.drop(ctx, sysTabSubPart->rowId);
             touched = true;
         }
-        sysTabSubPartPack.setTouched.clear();
+        dict->sysTabSubPartPack.setTouched.clear();
     }
 
     void Schema::resetTouched() {
         tablesTouched.clear();
         identifiersTouched.clear();
-        sysCColPack.setTouched.clear();
-        sysCDefPack.setTouched.clear();
-        sysColPack.setTouched.clear();
-        sysDeferredStgPack.setTouched.clear();
-        sysEColPack.setTouched.clear();
-        sysLobPack.setTouched.clear();
-        sysLobCompPartPack.setTouched.clear();
-        sysLobFragPack.setTouched.clear();
-        sysObjPack.setTouched.clear();
-        sysTabPack.setTouched.clear();
-        sysTabComPartPack.setTouched.clear();
-        sysTabPartPack.setTouched.clear();
-        sysTabSubPartPack.setTouched.clear();
-        sysUserPack.setTouched.clear();
         touched = false;
+        if (!dict->key.empty())
+            return;
+
+        dict->sysCColPack.setTouched.clear();
+        dict->sysCDefPack.setTouched.clear();
+        dict->sysColPack.setTouched.clear();
+        dict->sysDeferredStgPack.setTouched.clear();
+        dict->sysEColPack.setTouched.clear();
+        dict->sysLobPack.setTouched.clear();
+        dict->sysLobCompPartPack.setTouched.clear();
+        dict->sysLobFragPack.setTouched.clear();
+        dict->sysObjPack.setTouched.clear();
+        dict->sysTabPack.setTouched.clear();
+        dict->sysTabComPartPack.setTouched.clear();
+        dict->sysTabPartPack.setTouched.clear();
+        dict->sysTabSubPartPack.setTouched.clear();
+        dict->sysUserPack.setTouched.clear();
+    }
+
+    void Schema::resetChanged() {
+        for (const auto& [_, xmlCtx]: schemaXmlMap) {
+            xmlCtx->xdbXNmPack.setChanged.clear();
+            xmlCtx->xdbXPtPack.setChanged.clear();
+            xmlCtx->xdbXQnPack.setChanged.clear();
+        }
+        if (!dict->key.empty())
+            return;
+
+        dict->sysCColPack.setChanged.clear();
+        dict->sysCDefPack.setChanged.clear();
+        dict->sysColPack.setChanged.clear();
+        dict->sysDeferredStgPack.setChanged.clear();
+        dict->sysEColPack.setChanged.clear();
+        dict->sysLobPack.setChanged.clear();
+        dict->sysLobCompPartPack.setChanged.clear();
+        dict->sysLobFragPack.setChanged.clear();
+        dict->sysObjPack.setChanged.clear();
+        dict->sysTabPack.setChanged.clear();
+        dict->sysTabComPartPack.setChanged.clear();
+        dict->sysTabPartPack.setChanged.clear();
+        dict->sysTabSubPartPack.setChanged.clear();
+        dict->sysTsPack.setChanged.clear();
+        dict->sysUserPack.setChanged.clear();
+        dict->xdbTtSetPack.setChanged.clear();
+    }
+
+    uint64_t Schema::countChanged() const {
+        uint64_t count = dict->sysCColPack.setChanged.size() +
+                         dict->sysCDefPack.setChanged.size() +
+                         dict->sysColPack.setChanged.size() +
+                         dict->sysDeferredStgPack.setChanged.size() +
+                         dict->sysEColPack.setChanged.size() +
+                         dict->sysLobPack.setChanged.size() +
+                         dict->sysLobCompPartPack.setChanged.size() +
+                         dict->sysLobFragPack.setChanged.size() +
+                         dict->sysObjPack.setChanged.size() +
+                         dict->sysTabPack.setChanged.size() +
+                         dict->sysTabComPartPack.setChanged.size() +
+                         dict->sysTabPartPack.setChanged.size() +
+                         dict->sysTabSubPartPack.setChanged.size() +
+                         dict->sysTsPack.setChanged.size() +
+                         dict->sysUserPack.setChanged.size() +
+                         dict->xdbTtSetPack.setChanged.size();
+        for (const auto& [_, xmlCtx]: schemaXmlMap)
+            count += xmlCtx->xdbXNmPack.setChanged.size() + xmlCtx->xdbXPtPack.setChanged.size() + xmlCtx->xdbXQnPack.setChanged.size();
+        return count;
     }
 
     void Schema::updateXmlCtx() {
@@ -502,31 +602,43 @@ namespace OpenLogReplicator {
 
     void Schema::buildMaps(const std::string& owner, const std::string& table, const std::vector<std::string>& keyList, const std::string& key,
                            SchemaElement::TAG_TYPE tagType, const std::vector<std::string>& tagList, const std::string& tag __attribute__((unused)),
-                           const std::string& condition, DbTable::OPTIONS options, std::unordered_map<typeObj, std::string>& tablesUpdated, bool suppLogDbPrimary,
+                           const std::string& condition, const std::vector<std::string>& columnList, const std::vector<std::string>& skipColumnList,
+                           DbTable::OPTIONS options, std::unordered_map<typeObj, std::string>& tablesUpdated, bool suppLogDbPrimary,
                            bool suppLogDbAll, uint64_t defaultCharacterMapId, uint64_t defaultCharacterNcharMapId) {
+        if (identifiersTouched.empty())
+            return;
+
         const std::regex regexOwner(owner);
         const std::regex regexTable(table);
         char sysLobConstraintName[26]{"SYS_LOB0000000000C00000$$"};
+        // The owner is matched once per user, at startup most objects are rejected before matching the table name
+        std::unordered_map<typeUser, bool> ownerMatch;
+        // With REDO_FLAGS::LAZY_SCHEMA the partitions, LOBs and the supplemental logging check are done here, the columns are added on the
+        // first DML of the table. LOB redo often comes before it and is found through lobIndexMap and lobPartitionMap
+        const TableRule rule{keyList, tagType, tagList, condition, columnList, skipColumnList, defaultCharacterMapId, defaultCharacterNcharMapId};
 
         for (auto obj: identifiersTouched) {
-            auto sysObjMapObjTouchedIt = sysObjPack.unorderedMapKey.find(SysObjObj(obj));
-            if (sysObjMapObjTouchedIt == sysObjPack.unorderedMapKey.end())
+            auto sysObjMapObjTouchedIt = dict->sysObjPack.unorderedMapKey.find(SysObjObj(obj));
+            if (sysObjMapObjTouchedIt == dict->sysObjPack.unorderedMapKey.end())
                 continue;
             SysObj* sysObj = sysObjMapObjTouchedIt->second;
 
-            if (sysObj->isDropped() || !sysObj->isTable() || !regex_match(sysObj->name, regexTable))
+            if (sysObj->isDropped() || !sysObj->isTable())
                 continue;
 
             SysUser* sysUser = nullptr;
-            auto sysUserMapUserIt = sysUserPack.unorderedMapKey.find(SysUserUser(sysObj->owner));
-            if (sysUserMapUserIt == sysUserPack.unorderedMapKey.end()) {
-                if (!ctx->isFlagSet(Ctx::REDO_FLAGS::ADAPTIVE_SCHEMA))
+            auto sysUserMapUserIt = dict->sysUserPack.unorderedMapKey.find(SysUserUser(sysObj->owner));
+            if (sysUserMapUserIt == dict->sysUserPack.unorderedMapKey.end()) {
+                if (!ctx->isFlagSet(Ctx::REDO_FLAGS::ADAPTIVE_SCHEMA) || !regex_match(sysObj->name, regexTable))
                     continue;
                 sysUserAdaptive.name = "USER_" + std::to_string(sysObj->obj);
                 sysUser = &sysUserAdaptive;
             } else {
                 sysUser = sysUserMapUserIt->second;
-                if (!regex_match(sysUser->name, regexOwner))
+                auto ownerMatchIt = ownerMatch.find(sysObj->owner);
+                if (ownerMatchIt == ownerMatch.end())
+                    ownerMatchIt = ownerMatch.emplace(sysObj->owner, regex_match(sysUser->name, regexOwner)).first;
+                if (!ownerMatchIt->second || !regex_match(sysObj->name, regexTable))
                     continue;
             }
 
@@ -538,8 +650,8 @@ namespace OpenLogReplicator {
             }
 
             // Object without SYS.TAB$
-            auto sysTabMapObjIt = sysTabPack.unorderedMapKey.find(SysTabObj(sysObj->obj));
-            if (sysTabMapObjIt == sysTabPack.unorderedMapKey.end()) {
+            auto sysTabMapObjIt = dict->sysTabPack.unorderedMapKey.find(SysTabObj(sysObj->obj));
+            if (sysTabMapObjIt == dict->sysTabPack.unorderedMapKey.end()) {
                 if (ctx->isLogLevelAt(Ctx::LOG::DEBUG))
                     tablesUpdated[sysObj->obj] = sysUser->name + "." + sysObj->name + " (obj: " + std::to_string(sysObj->obj) + ") - " + SysTab::tableName() +
                             " entry missing (skipped)";
@@ -579,8 +691,8 @@ namespace OpenLogReplicator {
             if (sysTab->isPartitioned())
                 compressed = false;
             else if (sysTab->isInitial()) {
-                const auto& it = sysDeferredStgPack.unorderedMapKey.find(SysDeferredStgObj(sysObj->obj));
-                if (it != sysDeferredStgPack.unorderedMapKey.end())
+                const auto& it = dict->sysDeferredStgPack.unorderedMapKey.find(SysDeferredStgObj(sysObj->obj));
+                if (it != dict->sysDeferredStgPack.unorderedMapKey.end())
                     compressed = it->second->isCompressed();
             }
 
@@ -591,7 +703,6 @@ namespace OpenLogReplicator {
                 continue;
             }
 
-            typeCol keysCnt = 0;
             bool suppLogTablePrimary = false;
             bool suppLogTableAll = false;
             bool supLogColMissing = false;
@@ -607,8 +718,8 @@ namespace OpenLogReplicator {
 
             if (sysTab->isPartitioned()) {
                 const SysTabPartKey sysTabPartKey(sysObj->obj, 0);
-                for (auto sysTabPartMapKeyIt = sysTabPartPack.mapKey.upper_bound(sysTabPartKey);
-                     sysTabPartMapKeyIt != sysTabPartPack.mapKey.end() && sysTabPartMapKeyIt->first.bo == sysObj->obj; ++sysTabPartMapKeyIt) {
+                for (auto sysTabPartMapKeyIt = dict->sysTabPartPack.mapKey.upper_bound(sysTabPartKey);
+                     sysTabPartMapKeyIt != dict->sysTabPartPack.mapKey.end() && sysTabPartMapKeyIt->first.bo == sysObj->obj; ++sysTabPartMapKeyIt) {
 
                     const SysTabPart* sysTabPart = sysTabPartMapKeyIt->second;
                     tableTmp->addTablePartition(sysTabPart->obj, sysTabPart->dataObj);
@@ -616,12 +727,12 @@ namespace OpenLogReplicator {
                 }
 
                 const SysTabComPartKey sysTabComPartKey(sysObj->obj, 0);
-                for (auto sysTabComPartMapKeyIt = sysTabComPartPack.mapKey.upper_bound(sysTabComPartKey);
-                     sysTabComPartMapKeyIt != sysTabComPartPack.mapKey.end() && sysTabComPartMapKeyIt->first.bo == sysObj->obj; ++sysTabComPartMapKeyIt) {
+                for (auto sysTabComPartMapKeyIt = dict->sysTabComPartPack.mapKey.upper_bound(sysTabComPartKey);
+                     sysTabComPartMapKeyIt != dict->sysTabComPartPack.mapKey.end() && sysTabComPartMapKeyIt->first.bo == sysObj->obj; ++sysTabComPartMapKeyIt) {
 
                     const SysTabSubPartKey sysTabSubPartKeyFirst(sysTabComPartMapKeyIt->second->obj, 0);
-                    for (auto sysTabSubPartMapKeyIt = sysTabSubPartPack.mapKey.upper_bound(sysTabSubPartKeyFirst);
-                         sysTabSubPartMapKeyIt != sysTabSubPartPack.mapKey.end() && sysTabSubPartMapKeyIt->first.pObj == sysTabComPartMapKeyIt->second->obj;
+                    for (auto sysTabSubPartMapKeyIt = dict->sysTabSubPartPack.mapKey.upper_bound(sysTabSubPartKeyFirst);
+                         sysTabSubPartMapKeyIt != dict->sysTabSubPartPack.mapKey.end() && sysTabSubPartMapKeyIt->first.pObj == sysTabComPartMapKeyIt->second->obj;
                          ++sysTabSubPartMapKeyIt) {
 
                         const SysTabSubPart* sysTabSubPart = sysTabSubPartMapKeyIt->second;
@@ -635,8 +746,8 @@ namespace OpenLogReplicator {
                 !suppLogDbAll && !sysUser->isSuppLogAll()) {
 
                 const SysCDefKey sysCDefKeyFirst(sysObj->obj, 0);
-                for (auto sysCDefMapKeyIt = sysCDefPack.mapKey.upper_bound(sysCDefKeyFirst);
-                     sysCDefMapKeyIt != sysCDefPack.mapKey.end() && sysCDefMapKeyIt->first.obj == sysObj->obj;
+                for (auto sysCDefMapKeyIt = dict->sysCDefPack.mapKey.upper_bound(sysCDefKeyFirst);
+                     sysCDefMapKeyIt != dict->sysCDefPack.mapKey.end() && sysCDefMapKeyIt->first.obj == sysObj->obj;
                      ++sysCDefMapKeyIt) {
                     const SysCDef* sysCDef = sysCDefMapKeyIt->second;
                     if (sysCDef->isSupplementalLogPK())
@@ -646,160 +757,22 @@ namespace OpenLogReplicator {
                 }
             }
 
-            const RowId rowId;
-            const SysColSeg sysColSegFirst(sysObj->obj, 0, rowId);
-            for (auto sysColMapSegIt = sysColPack.mapKey.upper_bound(sysColSegFirst); sysColMapSegIt != sysColPack.mapKey.end() &&
-                                                                                 sysColMapSegIt->first.obj == sysObj->obj; ++sysColMapSegIt) {
-                SysCol* sysCol = sysColMapSegIt->second;
-                if (sysCol->segCol == 0)
-                    continue;
-
-                uint64_t charmapId = 0;
-                typeCol numPk = 0;
-                typeCol numSup = 0;
-                typeCol guardSeg = -1;
-
-                const SysEColKey sysEColKey(sysObj->obj, sysCol->intCol);
-                auto sysEColIt = sysEColPack.unorderedMapKey.find(sysEColKey);
-                if (sysEColIt != sysEColPack.unorderedMapKey.end())
-                    guardSeg = sysEColIt->second->guardId;
-
-                if (sysCol->charsetForm == 1) {
-                    if (sysCol->type == SysCol::COLTYPE::CLOB) {
-                        charmapId = defaultCharacterNcharMapId;
-                    } else
-                        charmapId = defaultCharacterMapId;
-                } else if (sysCol->charsetForm == 2)
-                    charmapId = defaultCharacterNcharMapId;
-                else
-                    charmapId = sysCol->charsetId;
-
-                if (sysCol->type == SysCol::COLTYPE::VARCHAR || sysCol->type == SysCol::COLTYPE::CHAR || sysCol->type == SysCol::COLTYPE::CLOB) {
-                    auto characterMapIt = locales->characterMap.find(charmapId);
-                    if (unlikely(characterMapIt == locales->characterMap.end())) {
-                        ctx->hint("check in database for name: SELECT NLS_CHARSET_NAME(" + std::to_string(charmapId) + ") FROM DUAL;");
-                        throw DataException(50026, "table " + std::string(sysUser->name) + "." + sysObj->name +
-                                                   " - unsupported character set id: " + std::to_string(charmapId) + " for column: " + sysCol->name);
-                    }
-                }
-
-                if (tagType == SchemaElement::TAG_TYPE::LIST)
-                    tableTmp->tagCols.resize(tagList.size());
-
-                const SysCColKey sysCColKeyFirst(sysObj->obj, 0, sysCol->intCol);
-                for (auto sysCColMapKeyIt = sysCColPack.mapKey.upper_bound(sysCColKeyFirst);
-                     sysCColMapKeyIt != sysCColPack.mapKey.end() && sysCColMapKeyIt->first.obj == sysObj->obj && sysCColMapKeyIt->first.intCol == sysCol->intCol;
-                     ++sysCColMapKeyIt) {
-                    SysCCol* sysCCol = sysCColMapKeyIt->second;
-
-                    // Count the number of PKs the column is part of
-                    auto sysCDefMapConIt = sysCDefPack.unorderedMapKey.find(SysCDefCon(sysCCol->con));
-                    if (sysCDefMapConIt == sysCDefPack.unorderedMapKey.end()) {
-                        ctx->warning(70005, "data in " + SysCDef::tableName() + " missing for CON#: " + std::to_string(sysCCol->con));
-                        continue;
-                    }
-                    const SysCDef* sysCDef = sysCDefMapConIt->second;
-                    if (sysCDef->isPK())
-                        ++numPk;
-
-                    // Supplemental logging
-                    if (sysCCol->spare1.isZero() && sysCDef->isSupplementalLog())
-                        ++numSup;
-                }
-
-                // Part of a defined primary key
-                if (!keyList.empty()) {
-                    // Manually defined PK overlaps with table PK
-                    if (numPk > 0 && (suppLogTablePrimary || sysUser->isSuppLogPrimary() || suppLogDbPrimary))
-                        numSup = 1;
-                    numPk = 0;
-                    for (const auto& val: keyList) {
-                        if (sysCol->name == val) {
-                            numPk = 1;
-                            ++keysCnt;
-                            if (numSup == 0)
-                                supLogColMissing = true;
-                            break;
-                        }
-                    }
-                } else {
-                    if (numPk > 0 && numSup == 0)
-                        supLogColMissing = true;
-                }
-
-                //typeCol tagCol = -1;
-                // Part of a defined tag
-                switch (tagType) {
-                    case SchemaElement::TAG_TYPE::NONE:
-                        break;
-
-                    case SchemaElement::TAG_TYPE::PK:
-                        if (numPk > 0) {
-                            //tagCol = tableTmp->tagCols.size();
-                            tableTmp->tagCols.push_back(sysCol->segCol);
-                        }
-                        break;
-
-                    case SchemaElement::TAG_TYPE::LIST: {
-                        for (uint x = 0; x < tagList.size(); ++x) {
-                            if (sysCol->name !=  tagList[x])
-                                continue;
-
-                            //tagCol = x;
-                            tableTmp->tagCols[x] = sysCol->segCol;
-                            break;
-                        }
-                        break;
-                    }
-
-                    case SchemaElement::TAG_TYPE::ALL:
-                        //tagCol = tableTmp->tagCols.size();
-                        tableTmp->tagCols.push_back(sysCol->segCol);
-                        break;
-                }
-
-                bool xmlType = false;
-                // For system-generated columns, check column name from base column
-                std::string columnName = sysCol->name;
-                if (sysCol->isSystemGenerated()) {
-                    //RowId rid2(0, 0, 0);
-                    //SysColSeg sysColSegFirst2(sysObj->obj - 1, 0, rid2);
-                    for (auto sysColMapSegIt2 = sysColPack.mapKey.upper_bound(sysColSegFirst); sysColMapSegIt2 != sysColPack.mapKey.end() &&
-                                                                                          sysColMapSegIt2->first.obj <= sysObj->obj; ++sysColMapSegIt2) {
-                        const SysCol* sysCol2 = sysColMapSegIt2->second;
-                        if (sysCol->col == sysCol2->col && sysCol2->segCol == 0) {
-                            columnName = sysCol2->name;
-                            xmlType = true;
-                            break;
-                        }
-                    }
-                }
-
-                columnTmp = new DbColumn(sysCol->col, guardSeg, sysCol->segCol, columnName,
-                                         sysCol->type, sysCol->length, sysCol->precision, sysCol->scale,
-                                         charmapId, numPk, sysCol->isNullable(), sysCol->isHidden() &&
-                                                                                 !(xmlType && ctx->isFlagSet(Ctx::REDO_FLAGS::EXPERIMENTAL_XMLTYPE)),
-                                         sysCol->isStoredAsLob(), sysCol->isSystemGenerated(), sysCol->isNested(),
-                                         sysCol->isUnused(), sysCol->isAdded(), sysCol->isGuard(), xmlType);
-
-                tableTmp->addColumn(columnTmp);
-                columnTmp = nullptr;
-            }
-            if (unlikely(tableTmp->columns.size() < static_cast<size_t>(tableTmp->maxSegCol))) {
-                ctx->warning(50073, "table " + std::string(sysUser->name) + "." + sysObj->name + " - missmatch in column details: " +
-                                    std::to_string(tableTmp->columns.size()) + " < " + std::to_string(tableTmp->maxSegCol));
-                tableTmp->maxSegCol = tableTmp->columns.size();
-            }
+            // Only tables sent to the output are built lazily, the system tables are read by the schema updates
+            const bool lazy = ctx->isFlagSet(Ctx::REDO_FLAGS::LAZY_SCHEMA) && options == DbTable::OPTIONS::DEFAULT;
+            typeCol columnsCnt = 0;
+            typeCol pkCnt = 0;
+            const typeCol keysCnt = buildColumns(tableTmp, rule, suppLogTablePrimary || sysUser->isSuppLogPrimary() || suppLogDbPrimary, !lazy,
+                                                 columnsCnt, pkCnt, supLogColMissing);
 
             if (!DbTable::isSystemTable(options)) {
                 const SysLobKey sysLobKeyFirst(sysObj->obj, 0);
-                for (auto sysLobMapKeyIt = sysLobPack.mapKey.upper_bound(sysLobKeyFirst);
-                     sysLobMapKeyIt != sysLobPack.mapKey.end() && sysLobMapKeyIt->first.obj == sysObj->obj; ++sysLobMapKeyIt) {
+                for (auto sysLobMapKeyIt = dict->sysLobPack.mapKey.upper_bound(sysLobKeyFirst);
+                     sysLobMapKeyIt != dict->sysLobPack.mapKey.end() && sysLobMapKeyIt->first.obj == sysObj->obj; ++sysLobMapKeyIt) {
 
                     const SysLob* sysLob = sysLobMapKeyIt->second;
 
-                    auto sysObjMapObjIt = sysObjPack.unorderedMapKey.find(SysObjObj(sysLob->lObj));
-                    if (unlikely(sysObjMapObjIt == sysObjPack.unorderedMapKey.end()))
+                    auto sysObjMapObjIt = dict->sysObjPack.unorderedMapKey.find(SysObjObj(sysLob->lObj));
+                    if (unlikely(sysObjMapObjIt == dict->sysObjPack.unorderedMapKey.end()))
                         throw DataException(50027, "table " + std::string(sysUser->name) + "." + sysObj->name + " couldn't find obj for lob " +
                                                    std::to_string(sysLob->lObj));
                     const typeObj lobDataObj = sysObjMapObjIt->second->dataObj;
@@ -818,8 +791,8 @@ namespace OpenLogReplicator {
                     const std::string lobIndexName = str.str();
 
                     const SysObjNameKey sysObjNameKeyFirst(sysObj->owner, lobIndexName, 0, 0);
-                    for (auto sysObjMapNameIt = sysObjPack.mapKey.upper_bound(sysObjNameKeyFirst);
-                         sysObjMapNameIt != sysObjPack.mapKey.end() &&
+                    for (auto sysObjMapNameIt = dict->sysObjPack.mapKey.upper_bound(sysObjNameKeyFirst);
+                         sysObjMapNameIt != dict->sysObjPack.mapKey.end() &&
                          sysObjMapNameIt->first.name == lobIndexName &&
                          sysObjMapNameIt->first.owner == sysObj->owner; ++sysObjMapNameIt) {
 
@@ -841,13 +814,13 @@ namespace OpenLogReplicator {
                     if (sysTab->isPartitioned()) {
                         // Partitions
                         const SysLobFragKey sysLobFragKey(sysLob->lObj, 0);
-                        for (auto sysLobFragMapKeyIt = sysLobFragPack.mapKey.upper_bound(sysLobFragKey);
-                             sysLobFragMapKeyIt != sysLobFragPack.mapKey.end() &&
+                        for (auto sysLobFragMapKeyIt = dict->sysLobFragPack.mapKey.upper_bound(sysLobFragKey);
+                             sysLobFragMapKeyIt != dict->sysLobFragPack.mapKey.end() &&
                              sysLobFragMapKeyIt->first.parentObj == sysLob->lObj; ++sysLobFragMapKeyIt) {
 
                             const SysLobFrag* sysLobFrag = sysLobFragMapKeyIt->second;
-                            auto sysObjMapObjIt2 = sysObjPack.unorderedMapKey.find(SysObjObj(sysLobFrag->fragObj));
-                            if (unlikely(sysObjMapObjIt2 == sysObjPack.unorderedMapKey.end()))
+                            auto sysObjMapObjIt2 = dict->sysObjPack.unorderedMapKey.find(SysObjObj(sysLobFrag->fragObj));
+                            if (unlikely(sysObjMapObjIt2 == dict->sysObjPack.unorderedMapKey.end()))
                                 throw DataException(50028, "table " + std::string(sysUser->name) + "." + sysObj->name +
                                                            " couldn't find obj for lob frag " + std::to_string(sysLobFrag->fragObj));
                             const typeObj lobFragDataObj = sysObjMapObjIt2->second->dataObj;
@@ -858,20 +831,20 @@ namespace OpenLogReplicator {
 
                         // Subpartitions
                         const SysLobCompPartKey sysLobCompPartKey(sysLob->lObj, 0);
-                        for (auto sysLobCompPartMapKeyIt = sysLobCompPartPack.mapKey.upper_bound(sysLobCompPartKey);
-                             sysLobCompPartMapKeyIt != sysLobCompPartPack.mapKey.end() &&
+                        for (auto sysLobCompPartMapKeyIt = dict->sysLobCompPartPack.mapKey.upper_bound(sysLobCompPartKey);
+                             sysLobCompPartMapKeyIt != dict->sysLobCompPartPack.mapKey.end() &&
                              sysLobCompPartMapKeyIt->first.lObj == sysLob->lObj; ++sysLobCompPartMapKeyIt) {
 
                             const SysLobCompPart* sysLobCompPart = sysLobCompPartMapKeyIt->second;
 
                             const SysLobFragKey sysLobFragKey2(sysLobCompPart->partObj, 0);
-                            for (auto sysLobFragMapKeyIt = sysLobFragPack.mapKey.upper_bound(sysLobFragKey2);
-                                 sysLobFragMapKeyIt != sysLobFragPack.mapKey.end() &&
+                            for (auto sysLobFragMapKeyIt = dict->sysLobFragPack.mapKey.upper_bound(sysLobFragKey2);
+                                 sysLobFragMapKeyIt != dict->sysLobFragPack.mapKey.end() &&
                                  sysLobFragMapKeyIt->first.parentObj == sysLobCompPart->partObj; ++sysLobFragMapKeyIt) {
 
                                 const SysLobFrag* sysLobFrag = sysLobFragMapKeyIt->second;
-                                auto sysObjMapObjIt2 = sysObjPack.unorderedMapKey.find(SysObjObj(sysLobFrag->fragObj));
-                                if (unlikely(sysObjMapObjIt2 == sysObjPack.unorderedMapKey.end()))
+                                auto sysObjMapObjIt2 = dict->sysObjPack.unorderedMapKey.find(SysObjObj(sysLobFrag->fragObj));
+                                if (unlikely(sysObjMapObjIt2 == dict->sysObjPack.unorderedMapKey.end()))
                                     throw DataException(50028, "table " + std::string(sysUser->name) + "." + sysObj->name +
                                                                " couldn't find obj for lob frag " + std::to_string(sysLobFrag->fragObj));
                                 const typeObj lobFragDataObj = sysObjMapObjIt2->second->dataObj;
@@ -898,7 +871,7 @@ namespace OpenLogReplicator {
                 }
 
                 const SysObjNameKey sysObjNameKeyName(sysObj->owner, sysLobConstraintName, 0, 0);
-                for (auto sysObjMapNameIt = sysObjPack.mapKey.upper_bound(sysObjNameKeyName); sysObjMapNameIt != sysObjPack.mapKey.end();
+                for (auto sysObjMapNameIt = dict->sysObjPack.mapKey.upper_bound(sysObjNameKeyName); sysObjMapNameIt != dict->sysObjPack.mapKey.end();
                      ++sysObjMapNameIt) {
                     SysObj* sysObjLob = sysObjMapNameIt->second;
                     const char* colStr = sysObjLob->name.c_str();
@@ -938,15 +911,9 @@ namespace OpenLogReplicator {
                 throw DataException(10041, "table " + std::string(sysUser->name) + "." + sysObj->name + " - couldn't find all column sets (" +
                                            key + ")");
 
-            if (tagType == SchemaElement::TAG_TYPE::LIST)
-                for (uint x = 0; x < tableTmp->tagCols.size(); ++x)
-                    if (tableTmp->tagCols[x] == 0)
-                        throw DataException(10041, "table " + std::string(sysUser->name) + "." + sysObj->name + " - couldn't find all tag sets (" +
-                                                   tagList[x] + ")");
-
             std::ostringstream ss;
             ss << sysUser->name << "." << sysObj->name << " (dataobj: " << std::dec << sysTab->dataObj << ", obj: " << std::dec << sysObj->obj <<
-               ", columns: " << std::dec << tableTmp->maxSegCol << ", lobs: " << std::dec << tableTmp->totalLobs << lobList.str() <<
+               ", columns: " << std::dec << columnsCnt << ", lobs: " << std::dec << tableTmp->totalLobs << lobList.str() <<
                ", lob-idx: " << std::dec << lobIndexes << lobIndexesList.str() << ")";
             if (sysTab->isClustered())
                 ss << ", part of cluster";
@@ -960,7 +927,7 @@ namespace OpenLogReplicator {
             if (!ctx->isDisableChecksSet(Ctx::DISABLE_CHECKS::SUPPLEMENTAL_LOG) && !DbTable::isSystemTable(options)) {
                 // Use a default primary key
                 if (keyList.empty()) {
-                    if (tableTmp->totalPk == 0)
+                    if (pkCnt == 0)
                         ss << ", primary key missing";
                     else if (!suppLogTablePrimary && !suppLogTableAll && !sysUser->isSuppLogPrimary() && !sysUser->isSuppLogAll() &&
                              !suppLogDbPrimary && !suppLogDbAll && supLogColMissing)
@@ -976,15 +943,216 @@ namespace OpenLogReplicator {
             }
             tablesUpdated[sysObj->obj] = ss.str();
 
-            tableTmp->setCondition(condition);
+            if (!lazy)
+                finishColumns(tableTmp, rule);
+            tableTmp->columnsPending = lazy;
             addTableToDict(tableTmp);
             tableTmp = nullptr;
+            if (lazy)
+                tablesLazy.insert_or_assign(sysObj->obj, rule);
         }
     }
 
+    // Counts the key columns of a table, which the supplemental logging check needs, and with build set also adds the columns. Tables built
+    // lazily are counted when the maps are built and get the columns on their first DML, see materializeTable
+    typeCol Schema::buildColumns(DbTable* table, const TableRule& rule, bool suppLogPrimary, bool build, typeCol& columnsCnt, typeCol& pkCnt,
+                                 bool& supLogColMissing) {
+        typeCol keysCnt = 0;
+        const RowId rowId;
+        const SysColSeg sysColSegFirst(table->obj, 0, rowId);
+        for (auto sysColMapSegIt = dict->sysColPack.mapKey.upper_bound(sysColSegFirst); sysColMapSegIt != dict->sysColPack.mapKey.end() &&
+                                                                             sysColMapSegIt->first.obj == table->obj; ++sysColMapSegIt) {
+            SysCol* sysCol = sysColMapSegIt->second;
+            if (sysCol->segCol == 0)
+                continue;
+
+            uint64_t charmapId = 0;
+            typeCol numPk = 0;
+            typeCol numSup = 0;
+            typeCol guardSeg = -1;
+
+            const SysEColKey sysEColKey(table->obj, sysCol->intCol);
+            auto sysEColIt = dict->sysEColPack.unorderedMapKey.find(sysEColKey);
+            if (sysEColIt != dict->sysEColPack.unorderedMapKey.end())
+                guardSeg = sysEColIt->second->guardId;
+
+            if (sysCol->charsetForm == 1) {
+                if (sysCol->type == SysCol::COLTYPE::CLOB) {
+                    charmapId = rule.defaultCharacterNcharMapId;
+                } else
+                    charmapId = rule.defaultCharacterMapId;
+            } else if (sysCol->charsetForm == 2)
+                charmapId = rule.defaultCharacterNcharMapId;
+            else
+                charmapId = sysCol->charsetId;
+
+            if (sysCol->type == SysCol::COLTYPE::VARCHAR || sysCol->type == SysCol::COLTYPE::CHAR || sysCol->type == SysCol::COLTYPE::CLOB) {
+                if (unlikely(locales->getCharacterSet(charmapId) == nullptr)) {
+                    ctx->hint("check in database for name: SELECT NLS_CHARSET_NAME(" + std::to_string(charmapId) + ") FROM DUAL;");
+                    throw DataException(50026, "table " + table->owner + "." + table->name +
+                                               " - unsupported character set id: " + std::to_string(charmapId) + " for column: " + sysCol->name);
+                }
+            }
+
+            const SysCColKey sysCColKeyFirst(table->obj, 0, sysCol->intCol);
+            for (auto sysCColMapKeyIt = dict->sysCColPack.mapKey.upper_bound(sysCColKeyFirst);
+                 sysCColMapKeyIt != dict->sysCColPack.mapKey.end() && sysCColMapKeyIt->first.obj == table->obj && sysCColMapKeyIt->first.intCol == sysCol->intCol;
+                 ++sysCColMapKeyIt) {
+                SysCCol* sysCCol = sysCColMapKeyIt->second;
+
+                // Count the number of PKs the column is part of
+                auto sysCDefMapConIt = dict->sysCDefPack.unorderedMapKey.find(SysCDefCon(sysCCol->con));
+                if (sysCDefMapConIt == dict->sysCDefPack.unorderedMapKey.end()) {
+                    ctx->warning(70005, "data in " + SysCDef::tableName() + " missing for CON#: " + std::to_string(sysCCol->con));
+                    continue;
+                }
+                const SysCDef* sysCDef = sysCDefMapConIt->second;
+                if (sysCDef->isPK())
+                    ++numPk;
+
+                // Supplemental logging
+                if (sysCCol->spare1.isZero() && sysCDef->isSupplementalLog())
+                    ++numSup;
+            }
+
+            // Part of a defined primary key
+            if (!rule.keyList.empty()) {
+                // Manually defined PK overlaps with table PK
+                if (numPk > 0 && suppLogPrimary)
+                    numSup = 1;
+                numPk = 0;
+                for (const auto& val: rule.keyList) {
+                    if (sysCol->name == val) {
+                        numPk = 1;
+                        ++keysCnt;
+                        if (numSup == 0)
+                            supLogColMissing = true;
+                        break;
+                    }
+                }
+            } else {
+                if (numPk > 0 && numSup == 0)
+                    supLogColMissing = true;
+            }
+
+            ++columnsCnt;
+            pkCnt += numPk;
+            if (!build)
+                continue;
+
+            if (rule.tagType == SchemaElement::TAG_TYPE::LIST)
+                table->tagCols.resize(rule.tagList.size());
+
+            //typeCol tagCol = -1;
+            // Part of a defined tag
+            switch (rule.tagType) {
+                case SchemaElement::TAG_TYPE::NONE:
+                    break;
+
+                case SchemaElement::TAG_TYPE::PK:
+                    if (numPk > 0) {
+                        //tagCol = table->tagCols.size();
+                        table->tagCols.push_back(sysCol->segCol);
+                    }
+                    break;
+
+                case SchemaElement::TAG_TYPE::LIST: {
+                    for (uint x = 0; x < rule.tagList.size(); ++x) {
+                        if (sysCol->name !=  rule.tagList[x])
+                            continue;
+
+                        //tagCol = x;
+                        table->tagCols[x] = sysCol->segCol;
+                        break;
+                    }
+                    break;
+                }
+
+                case SchemaElement::TAG_TYPE::ALL:
+                    //tagCol = table->tagCols.size();
+                    table->tagCols.push_back(sysCol->segCol);
+                    break;
+            }
+
+            bool xmlType = false;
+            // For system-generated columns, check column name from base column
+            std::string columnName = sysCol->name;
+            if (sysCol->isSystemGenerated()) {
+                //RowId rid2(0, 0, 0);
+                //SysColSeg sysColSegFirst2(table->obj - 1, 0, rid2);
+                for (auto sysColMapSegIt2 = dict->sysColPack.mapKey.upper_bound(sysColSegFirst); sysColMapSegIt2 != dict->sysColPack.mapKey.end() &&
+                                                                                      sysColMapSegIt2->first.obj <= table->obj; ++sysColMapSegIt2) {
+                    const SysCol* sysCol2 = sysColMapSegIt2->second;
+                    if (sysCol->col == sysCol2->col && sysCol2->segCol == 0) {
+                        columnName = sysCol2->name;
+                        xmlType = true;
+                        break;
+                    }
+                }
+            }
+
+            columnTmp = new DbColumn(sysCol->col, guardSeg, sysCol->segCol, columnName,
+                                     sysCol->type, sysCol->length, sysCol->precision, sysCol->scale,
+                                     charmapId, numPk, sysCol->isNullable(), sysCol->isHidden() &&
+                                                                             !(xmlType && ctx->isFlagSet(Ctx::REDO_FLAGS::EXPERIMENTAL_XMLTYPE)),
+                                     sysCol->isStoredAsLob(), sysCol->isSystemGenerated(), sysCol->isNested(),
+                                     sysCol->isUnused(), sysCol->isAdded(), sysCol->isGuard(), xmlType);
+
+            table->addColumn(columnTmp);
+            columnTmp = nullptr;
+        }
+        return keysCnt;
+    }
+
+    // Checks of the rule made against the columns, and the per-table state derived from them
+    void Schema::finishColumns(DbTable* table, const TableRule& rule) {
+        if (unlikely(table->columns.size() < static_cast<size_t>(table->maxSegCol))) {
+            ctx->warning(50073, "table " + table->owner + "." + table->name + " - missmatch in column details: " +
+                                std::to_string(table->columns.size()) + " < " + std::to_string(table->maxSegCol));
+            table->maxSegCol = table->columns.size();
+        }
+
+        if (rule.tagType == SchemaElement::TAG_TYPE::LIST)
+            for (uint x = 0; x < table->tagCols.size(); ++x)
+                if (table->tagCols[x] == 0)
+                    throw DataException(10041, "table " + table->owner + "." + table->name + " - couldn't find all tag sets (" +
+                                               rule.tagList[x] + ")");
+
+        table->setCondition(rule.condition, locales);
+        for (const auto& columnName: rule.columnList)
+            if (unlikely(!table->hasColumn(columnName)))
+                throw DataException(10041, "table " + table->owner + "." + table->name + " - couldn't find column (" + columnName +
+                                           ") of columns list");
+        for (const auto& columnName: rule.skipColumnList)
+            if (unlikely(!table->hasColumn(columnName)))
+                throw DataException(10041, "table " + table->owner + "." + table->name + " - couldn't find column (" + columnName +
+                                           ") of skip-columns list");
+        table->setColumnsSkipped(rule.columnList, rule.skipColumnList);
+        table->buildJsonFragments();
+        table->buildTagPlan();
+    }
+
+    // Caller holds mtxSchema, and mtxTransaction when the parser may run. The table keeps its place in the maps, LOB and partition lookups
+    // made before stay valid. A table changed by DDL is dropped with its rule and built again by the map rebuild
+    void Schema::materializeTable(typeObj obj) {
+        const auto& tableMapIt = tableMap.find(obj);
+        const auto& tablesLazyIt = tablesLazy.find(obj);
+        if (tableMapIt == tableMap.end() || tablesLazyIt == tablesLazy.end())
+            return;
+        DbTable* table = tableMapIt->second;
+
+        typeCol columnsCnt = 0;
+        typeCol pkCnt = 0;
+        bool supLogColMissing = false;
+        buildColumns(table, tablesLazyIt->second, false, true, columnsCnt, pkCnt, supLogColMissing);
+        finishColumns(table, tablesLazyIt->second);
+        table->columnsPending = false;
+        tablesLazy.erase(tablesLazyIt);
+    }
+
     uint16_t Schema::getLobBlockSize(typeTs ts) const {
-        const auto& it = sysTsPack.unorderedMapKey.find(SysTsTs(ts));
-        if (it != sysTsPack.unorderedMapKey.end()) {
+        const auto& it = dict->sysTsPack.unorderedMapKey.find(SysTsTs(ts));
+        if (it != dict->sysTsPack.unorderedMapKey.end()) {
             const typeDba pageSize = it->second->blockSize;
             if (pageSize == 8192)
                 return 8132;
@@ -20,37 +20,25 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #ifndef SCHEMA_H_
 #define SCHEMA_H_
 
+#include <atomic>
 #include <list>
 #include <map>
+#include <memory>
 #include <rapidjson/document.h>
 #include <rapidjson/error/en.h>
 #include <set>
 #include <unordered_map>
 #include <vector>
 
-#include "../common/table/SysCCol.h"
-#include "../common/table/SysCDef.h"
-#include "../common/table/SysCol.h"
-#include "../common/table/SysDeferredStg.h"
-#include "../common/table/SysECol.h"
-#include "../common/table/SysLob.h"
-#include "../common/table/SysLobCompPart.h"
-#include "../common/table/SysLobFrag.h"
-#include "../common/table/SysObj.h"
-#include "../common/table/SysTab.h"
-#include "../common/table/SysTabComPart.h"
-#include "../common/table/SysTabPart.h"
-#include "../common/table/SysTabSubPart.h"
-#include "../common/table/SysTs.h"
 #include "../common/table/SysUser.h"
 #include "../common/table/TablePack.h"
-#include "../common/table/XdbTtSet.h"
 #include "../common/table/XdbXNm.h"
 #include "../common/table/XdbXPt.h"
 #include "../common/table/XdbXQn.h"
 #include "../common/types/RowId.h"
 #include "../common/types/Types.h"
 #include "../common/types/Xid.h"
+#include "SchemaDict.h"
 #include "SchemaElement.h"
 
 namespace OpenLogReplicator {
@@ -62,6 +50,19 @@ namespace OpenLogReplicator {
     class XmlCtx;
 
     class Schema final {
+    public:
+        // Rule a table was matched with, kept for the tables which get their columns on the first DML
+        struct TableRule {
+            std::vector<std::string> keyList;
+            SchemaElement::TAG_TYPE tagType;
+            std::vector<std::string> tagList;
+            std::string condition;
+            std::vector<std::string> columnList;
+            std::vector<std::string> skipColumnList;
+            uint64_t defaultCharacterMapId;
+            uint64_t defaultCharacterNcharMapId;
+        };
+
     protected:
         Ctx* ctx;
         Locales* locales;
@@ -70,6 +71,9 @@ namespace OpenLogReplicator {
 
         void addTableToDict(DbTable* table);
         void removeTableFromDict(DbTable* table);
+        typeCol buildColumns(DbTable* table, const TableRule& rule, bool suppLogPrimary, bool build, typeCol& columnsCnt, typeCol& pkCnt,
+                             bool& supLogColMissing);
+        void finishColumns(DbTable* table, const TableRule& rule);
         [[nodiscard]] uint16_t getLobBlockSize(typeTs ts) const;
 
     public:
@@ -81,6 +85,10 @@ namespace OpenLogReplicator {
         std::unordered_map<typeDataObj, DbLob*> lobIndexMap;
         std::unordered_map<typeObj, DbTable*> tableMap;
         std::unordered_map<typeObj, DbTable*> tablePartitionMap;
+        // Tables of tableMap without columns yet, see materializeTable
+        std::unordered_map<typeObj, TableRule> tablesLazy;
+        // Bumped on every change of tablePartitionMap, lets readers cache lookups outside of the transaction mutex
+        std::atomic<uint64_t> tablePartitionVersion{0};
         XmlCtx* xmlCtxDefault{nullptr};
         DbColumn* columnTmp{nullptr};
         DbLob* lobTmp{nullptr};
@@ -89,22 +97,8 @@ namespace OpenLogReplicator {
         std::set<typeObj> identifiersTouched;
         bool touched{false};
 
-        TablePack<SysCCol, SysCColKey, TabRowIdUnorderedKeyDefault> sysCColPack;
-        TablePack<SysCDef, SysCDefKey, SysCDefCon> sysCDefPack;
-        TablePack<SysCol, SysColSeg, TabRowIdUnorderedKeyDefault> sysColPack;
-        TablePack<SysDeferredStg, TabRowIdKeyDefault, SysDeferredStgObj> sysDeferredStgPack;
-        TablePack<SysECol, TabRowIdKeyDefault, SysEColKey> sysEColPack;
-        TablePack<SysLob, SysLobKey, SysLobLObj> sysLobPack;
-        TablePack<SysLobCompPart, SysLobCompPartKey, SysLobCompPartPartObj> sysLobCompPartPack;
-        TablePack<SysLobFrag, SysLobFragKey, TabRowIdUnorderedKeyDefault> sysLobFragPack;
-        TablePack<SysObj, SysObjNameKey, SysObjObj> sysObjPack;
-        TablePack<SysTab, TabRowIdKeyDefault, SysTabObj> sysTabPack;
-        TablePack<SysTabComPart, SysTabComPartKey, SysTabComPartObj> sysTabComPartPack;
-        TablePack<SysTabPart, SysTabPartKey, TabRowIdUnorderedKeyDefault> sysTabPartPack;
-        TablePack<SysTabSubPart, SysTabSubPartKey, TabRowIdUnorderedKeyDefault> sysTabSubPartPack;
-        TablePack<SysTs, TabRowIdKeyDefault, SysTsTs> sysTsPack;
-        TablePack<SysUser, TabRowIdKeyDefault, SysUserUser> sysUserPack;
-        TablePack<XdbTtSet, TabRowIdKeyDefault, XdbTtSetTokSuf> xdbTtSetPack;
+        // Shared with other sources replicating the same database until the first change
+        std::shared_ptr<SchemaDict> dict;
 
         // XDB.X$yyxxx
         std::map<std::string, XmlCtx*> schemaXmlMap;
@@ -115,6 +109,9 @@ namespace OpenLogReplicator {
         void purgeMetadata();
         void purgeDicts();
         [[nodiscard]] bool compare(Schema* otherSchema, std::string& msgs) const;
+        void dictForUpdate();
+        void shareDict(const std::string& key);
+        [[nodiscard]] bool adoptDict(const std::string& key);
 
         void touchTable(typeObj obj);
         void touchTableLob(typeObj lobObj);
@@ -124,13 +121,18 @@ namespace OpenLogReplicator {
         [[nodiscard]] bool checkTableDictUncommitted(typeObj obj, std::string& owner, std::string& table) const;
         [[nodiscard]] DbLob* checkLobDict(typeDataObj dataObj) const;
         [[nodiscard]] DbLob* checkLobIndexDict(typeDataObj dataObj) const;
+        [[nodiscard]] bool isLookupStale(typeObj obj, const DbTable* table) const;
+        [[nodiscard]] bool isSystemTableTouched() const;
+        void materializeTable(typeObj obj);
         void dropUnusedMetadata(const std::set<std::string>& users, const std::vector<SchemaElement*>& schemaElements, std::unordered_map<typeObj,
                                 std::string>& tablesDropped);
         void buildMaps(const std::string& owner, const std::string& table, const std::vector<std::string>& keyList, const std::string& key,
                        SchemaElement::TAG_TYPE tagType, const std::vector<std::string>& tagList, const std::string& tag, const std::string& condition,
-                       DbTable::OPTIONS options, std::unordered_map<typeObj, std::string>& tablesUpdated, bool suppLogDbPrimary, bool suppLogDbAll,
+                       const std::vector<std::string>& columnList, const std::vector<std::string>& skipColumnList, DbTable::OPTIONS options, std::unordered_map<typeObj, std::string>& tablesUpdated, bool suppLogDbPrimary, bool suppLogDbAll,
                        uint64_t defaultCharacterMapId, uint64_t defaultCharacterNcharMapId);
         void resetTouched();
+        void resetChanged();
+        [[nodiscard]] uint64_t countChanged() const;
         void updateXmlCtx();
     };
 }
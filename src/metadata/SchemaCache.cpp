@@ -0,0 +1,75 @@
+/* Process wide cache of system dictionaries
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include "SchemaCache.h"
+#include "SchemaDict.h"
+
+namespace OpenLogReplicator {
+    // Returns the dictionary already shared under the key when it has the same rows, otherwise the given one, which is
+    // published when the key is free. Both dictionaries are compared outside of the lock: the cached one is immutable and the
+    // given one is still private to the caller
+    std::shared_ptr<SchemaDict> SchemaCache::share(const std::string& key, const std::shared_ptr<SchemaDict>& dict) {
+        std::shared_ptr<SchemaDict> cached;
+        {
+            std::unique_lock<std::mutex> const lck(mtx);
+            for (auto dictsIt = dicts.begin(); dictsIt != dicts.end();) {
+                if (dictsIt->second.expired())
+                    dictsIt = dicts.erase(dictsIt);
+                else
+                    ++dictsIt;
+            }
+
+            auto dictsIt = dicts.find(key);
+            if (dictsIt == dicts.end()) {
+                dict->key = key;
+                dicts.insert_or_assign(key, dict);
+                return dict;
+            }
+            cached = dictsIt->second.lock();
+        }
+
+        std::string msgs;
+        if (cached != nullptr && cached->countRows() == dict->countRows() && cached->compare(*dict, msgs))
+            return cached;
+        return dict;
+    }
+
+    // The dictionary shared under the key, nullptr when there is none or its last user released it
+    std::shared_ptr<SchemaDict> SchemaCache::find(const std::string& key) {
+        std::unique_lock<std::mutex> const lck(mtx);
+        auto dictsIt = dicts.find(key);
+        if (dictsIt == dicts.end())
+            return nullptr;
+        return dictsIt->second.lock();
+    }
+
+    // Takes the dictionary out of the cache when the caller holds the only reference, it may be modified in place then. The
+    // count is exact under the lock, no other reference can be taken from the cache meanwhile
+    bool SchemaCache::withdraw(const std::shared_ptr<SchemaDict>& dict) {
+        std::unique_lock<std::mutex> const lck(mtx);
+        if (dict.use_count() != 1)
+            return false;
+
+        auto dictsIt = dicts.find(dict->key);
+        if (dictsIt != dicts.end() && dictsIt->second.lock() == dict)
+            dicts.erase(dictsIt);
+        dict->key.clear();
+        return true;
+    }
+}
@@ -0,0 +1,45 @@
+/* Header for SchemaCache class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef SCHEMA_CACHE_H_
+#define SCHEMA_CACHE_H_
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace OpenLogReplicator {
+    class SchemaDict;
+
+    // Process wide set of the system dictionaries loaded by the sources, keyed by database, schema SCN and the replicated users.
+    // The cache holds no reference itself, a dictionary is freed when the last schema using it releases it
+    class SchemaCache final {
+    protected:
+        std::mutex mtx;
+        std::unordered_map<std::string, std::weak_ptr<SchemaDict>> dicts;
+
+    public:
+        [[nodiscard]] std::shared_ptr<SchemaDict> share(const std::string& key, const std::shared_ptr<SchemaDict>& dict);
+        [[nodiscard]] std::shared_ptr<SchemaDict> find(const std::string& key);
+        [[nodiscard]] bool withdraw(const std::shared_ptr<SchemaDict>& dict);
+    };
+}
+
+#endif
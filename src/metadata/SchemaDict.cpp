@@ -0,0 +1,121 @@
+/* Rows of the system dictionary tables
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include "../common/Ctx.h"
+#include "SchemaDict.h"
+
+namespace OpenLogReplicator {
+    // The last schema holding a shared dictionary may belong to a source which has already stopped, so the rows are freed
+    // without a context
+    SchemaDict::~SchemaDict() {
+        sysCColPack.release();
+        sysCDefPack.release();
+        sysColPack.release();
+        sysDeferredStgPack.release();
+        sysEColPack.release();
+        sysLobPack.release();
+        sysLobCompPartPack.release();
+        sysLobFragPack.release();
+        sysObjPack.release();
+        sysTabPack.release();
+        sysTabComPartPack.release();
+        sysTabPartPack.release();
+        sysTabSubPartPack.release();
+        sysTsPack.release();
+        sysUserPack.release();
+        xdbTtSetPack.release();
+    }
+
+    void SchemaDict::purge(const Ctx* ctx) {
+        sysCColPack.clear(ctx);
+        sysCDefPack.clear(ctx);
+        sysColPack.clear(ctx);
+        sysDeferredStgPack.clear(ctx);
+        sysEColPack.clear(ctx);
+        sysLobPack.clear(ctx);
+        sysLobCompPartPack.clear(ctx);
+        sysLobFragPack.clear(ctx);
+        sysObjPack.clear(ctx);
+        sysTabPack.clear(ctx);
+        sysTabComPartPack.clear(ctx);
+        sysTabPartPack.clear(ctx);
+        sysTabSubPartPack.clear(ctx);
+        sysTsPack.clear(ctx);
+        sysUserPack.clear(ctx);
+        xdbTtSetPack.clear(ctx);
+    }
+
+    void SchemaDict::copyFrom(const SchemaDict& other) {
+        sysCColPack.copyFrom(other.sysCColPack);
+        sysCDefPack.copyFrom(other.sysCDefPack);
+        sysColPack.copyFrom(other.sysColPack);
+        sysDeferredStgPack.copyFrom(other.sysDeferredStgPack);
+        sysEColPack.copyFrom(other.sysEColPack);
+        sysLobPack.copyFrom(other.sysLobPack);
+        sysLobCompPartPack.copyFrom(other.sysLobCompPartPack);
+        sysLobFragPack.copyFrom(other.sysLobFragPack);
+        sysObjPack.copyFrom(other.sysObjPack);
+        sysTabPack.copyFrom(other.sysTabPack);
+        sysTabComPartPack.copyFrom(other.sysTabComPartPack);
+        sysTabPartPack.copyFrom(other.sysTabPartPack);
+        sysTabSubPartPack.copyFrom(other.sysTabSubPartPack);
+        sysTsPack.copyFrom(other.sysTsPack);
+        sysUserPack.copyFrom(other.sysUserPack);
+        xdbTtSetPack.copyFrom(other.xdbTtSetPack);
+    }
+
+    bool SchemaDict::compare(const SchemaDict& other, std::string& msgs) const {
+        if (!sysCColPack.compareTo(other.sysCColPack, msgs)) return false;
+        if (!sysCDefPack.compareTo(other.sysCDefPack, msgs)) return false;
+        if (!sysColPack.compareTo(other.sysColPack, msgs)) return false;
+        if (!sysDeferredStgPack.compareTo(other.sysDeferredStgPack, msgs)) return false;
+        if (!sysEColPack.compareTo(other.sysEColPack, msgs)) return false;
+        if (!sysLobPack.compareTo(other.sysLobPack, msgs)) return false;
+        if (!sysLobCompPartPack.compareTo(other.sysLobCompPartPack, msgs)) return false;
+        if (!sysLobFragPack.compareTo(other.sysLobFragPack, msgs)) return false;
+        if (!sysObjPack.compareTo(other.sysObjPack, msgs)) return false;
+        if (!sysTabPack.compareTo(other.sysTabPack, msgs)) return false;
+        if (!sysTabComPartPack.compareTo(other.sysTabComPartPack, msgs)) return false;
+        if (!sysTabPartPack.compareTo(other.sysTabPartPack, msgs)) return false;
+        if (!sysTabSubPartPack.compareTo(other.sysTabSubPartPack, msgs)) return false;
+        if (!sysTsPack.compareTo(other.sysTsPack, msgs)) return false;
+        if (!sysUserPack.compareTo(other.sysUserPack, msgs)) return false;
+        if (!xdbTtSetPack.compareTo(other.xdbTtSetPack, msgs)) return false;
+        return true;
+    }
+
+    uint64_t SchemaDict::countRows() const {
+        return sysCColPack.mapRowId.size() +
+               sysCDefPack.mapRowId.size() +
+               sysColPack.mapRowId.size() +
+               sysDeferredStgPack.mapRowId.size() +
+               sysEColPack.mapRowId.size() +
+               sysLobPack.mapRowId.size() +
+               sysLobCompPartPack.mapRowId.size() +
+               sysLobFragPack.mapRowId.size() +
+               sysObjPack.mapRowId.size() +
+               sysTabPack.mapRowId.size() +
+               sysTabComPartPack.mapRowId.size() +
+               sysTabPartPack.mapRowId.size() +
+               sysTabSubPartPack.mapRowId.size() +
+               sysTsPack.mapRowId.size() +
+               sysUserPack.mapRowId.size() +
+               xdbTtSetPack.mapRowId.size();
+    }
+}
@@ -0,0 +1,83 @@
+/* Header for SchemaDict class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef SCHEMA_DICT_H_
+#define SCHEMA_DICT_H_
+
+#include <string>
+
+#include "../common/table/SysCCol.h"
+#include "../common/table/SysCDef.h"
+#include "../common/table/SysCol.h"
+#include "../common/table/SysDeferredStg.h"
+#include "../common/table/SysECol.h"
+#include "../common/table/SysLob.h"
+#include "../common/table/SysLobCompPart.h"
+#include "../common/table/SysLobFrag.h"
+#include "../common/table/SysObj.h"
+#include "../common/table/SysTab.h"
+#include "../common/table/SysTabComPart.h"
+#include "../common/table/SysTabPart.h"
+#include "../common/table/SysTabSubPart.h"
+#include "../common/table/SysTs.h"
+#include "../common/table/SysUser.h"
+#include "../common/table/TablePack.h"
+#include "../common/table/XdbTtSet.h"
+
+namespace OpenLogReplicator {
+    class Ctx;
+
+    // Rows of the system dictionary tables, the largest part of the schema. Sources replicating the same database can share one
+    // instance through SchemaCache, a shared instance is never modified: the schema copies it before the first change, see
+    // Schema::dictForUpdate
+    class SchemaDict final {
+    public:
+        // Key in SchemaCache, empty when the dictionary is private to one schema
+        std::string key;
+
+        TablePack<SysCCol, SysCColKey, TabRowIdUnorderedKeyDefault, FlatMap> sysCColPack;
+        TablePack<SysCDef, SysCDefKey, SysCDefCon> sysCDefPack;
+        TablePack<SysCol, SysColSeg, TabRowIdUnorderedKeyDefault, FlatMap> sysColPack;
+        TablePack<SysDeferredStg, TabRowIdKeyDefault, SysDeferredStgObj> sysDeferredStgPack;
+        TablePack<SysECol, TabRowIdKeyDefault, SysEColKey> sysEColPack;
+        TablePack<SysLob, SysLobKey, SysLobLObj> sysLobPack;
+        TablePack<SysLobCompPart, SysLobCompPartKey, SysLobCompPartPartObj> sysLobCompPartPack;
+        TablePack<SysLobFrag, SysLobFragKey, TabRowIdUnorderedKeyDefault> sysLobFragPack;
+        TablePack<SysObj, SysObjNameKey, SysObjObj, FlatMap> sysObjPack;
+        TablePack<SysTab, TabRowIdKeyDefault, SysTabObj, FlatMap> sysTabPack;
+        TablePack<SysTabComPart, SysTabComPartKey, SysTabComPartObj> sysTabComPartPack;
+        TablePack<SysTabPart, SysTabPartKey, TabRowIdUnorderedKeyDefault> sysTabPartPack;
+        TablePack<SysTabSubPart, SysTabSubPartKey, TabRowIdUnorderedKeyDefault> sysTabSubPartPack;
+        TablePack<SysTs, TabRowIdKeyDefault, SysTsTs> sysTsPack;
+        TablePack<SysUser, TabRowIdKeyDefault, SysUserUser> sysUserPack;
+        TablePack<XdbTtSet, TabRowIdKeyDefault, XdbTtSetTokSuf> xdbTtSetPack;
+
+        SchemaDict() = default;
+        SchemaDict(const SchemaDict&) = delete;
+        SchemaDict& operator=(const SchemaDict&) = delete;
+        ~SchemaDict();
+
+        void purge(const Ctx* ctx);
+        void copyFrom(const SchemaDict& other);
+        [[nodiscard]] bool compare(const SchemaDict& other, std::string& msgs) const;
+        [[nodiscard]] uint64_t countRows() const;
+    };
+}
+
+#endif
@@ -34,14 +34,20 @@ namespace OpenLogReplicator {
             NONE, ALL, PK, LIST
         };
 
+        std::string columns;
         std::string condition;
         std::string key;
         std::string owner;
+        std::string skipColumns;
         std::string table;
         std::string tag;
         DbTable::OPTIONS options;
         TAG_TYPE tagType{TAG_TYPE::NONE};
+        // Rows present at the first start are read from the table and sent before redo replication begins
+        bool snapshot{false};
+        std::vector<std::string> columnList;
         std::vector<std::string> keyList;
+        std::vector<std::string> skipColumnList;
         std::vector<std::string> tagList;
 
         SchemaElement(std::string newOwner, std::string newTable, DbTable::OPTIONS newOptions) :
@@ -80,6 +86,16 @@ namespace OpenLogReplicator {
             }
             tagList.push_back(value);
         }
+
+        static void parseColumns(std::string value, const std::string& separator, std::vector<std::string>& list) {
+            size_t pos = 0;
+            while ((pos = value.find(separator)) != std::string::npos) {
+                const std::string val = value.substr(0, pos);
+                list.push_back(val);
+                value.erase(0, pos + separator.length());
+            }
+            list.push_back(value);
+        }
     };
 }
 
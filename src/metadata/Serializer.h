@@ -22,9 +22,11 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 
 #include <rapidjson/document.h>
 #include <rapidjson/error/en.h>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
+#include "../common/types/Scn.h"
 #include "../common/types/Types.h"
 
 namespace OpenLogReplicator {
@@ -35,9 +37,21 @@ namespace OpenLogReplicator {
         Serializer();
         virtual ~Serializer() = default;
 
-        [[nodiscard]] virtual bool deserialize(Metadata* metadata, const std::string& ss, const std::string& fileName, std::vector<std::string>& msgs,
+        [[nodiscard]] virtual bool deserialize(Metadata* metadata, std::string_view ss, const std::string& fileName, std::vector<std::string>& msgs,
                                                std::unordered_map<typeObj, std::string>& tablesUpdated, bool loadMetadata, bool storeSchema) = 0;
-        virtual void serialize(Metadata* metadata, std::ostringstream& ss, bool noSchema) = 0;
+        // Checkpoint position and database parameters, called with mtxCheckpoint held
+        virtual void serializeMetadata(Metadata* metadata, std::ostringstream& ss) = 0;
+        // Schema of the checkpoint at scn appended to serializeMetadata() output, called with mtxSchema held only
+        virtual void serializeSchema(Metadata* metadata, std::ostringstream& ss, Scn scn, bool storeSchema) = 0;
+
+        // Stores only the schema rows changed since the last full checkpoint, formats without it store the full schema
+        [[nodiscard]] virtual bool isDeltaSupported() const {
+            return false;
+        }
+
+        virtual void serializeSchemaDelta(Metadata* metadata, std::ostringstream& ss, Scn scn) {
+            serializeSchema(metadata, ss, scn, true);
+        }
     };
 }
 
@@ -0,0 +1,1058 @@
+/* Base class for serialization of metadata to a binary format
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include "../common/Ctx.h"
+#include "../common/DbIncarnation.h"
+#include "../common/DbTable.h"
+#include "../common/XmlCtx.h"
+#include "../common/exception/DataException.h"
+#include "../common/table/SysCCol.h"
+#include "../common/table/SysCDef.h"
+#include "../common/table/SysCol.h"
+#include "../common/table/SysDeferredStg.h"
+#include "../common/table/SysECol.h"
+#include "../common/table/SysLob.h"
+#include "../common/table/SysLobCompPart.h"
+#include "../common/table/SysLobFrag.h"
+#include "../common/table/SysObj.h"
+#include "../common/table/SysTab.h"
+#include "../common/table/SysTabComPart.h"
+#include "../common/table/SysTabPart.h"
+#include "../common/table/SysTabSubPart.h"
+#include "../common/table/SysTs.h"
+#include "../common/table/SysUser.h"
+#include "../common/table/XdbTtSet.h"
+#include "../common/table/XdbXNm.h"
+#include "../common/table/XdbXQn.h"
+#include "../common/table/XdbXPt.h"
+#include "RedoLog.h"
+#include "Metadata.h"
+#include "Schema.h"
+#include "SerializerBinary.h"
+
+namespace OpenLogReplicator {
+    SerializerBinary::Cursor::Cursor(const uint8_t* newData, uint64_t newPos, uint64_t newEnd, const std::string& newFileName) :
+            data(newData),
+            pos(newPos),
+            end(newEnd),
+            fileName(newFileName) {
+    }
+
+    void SerializerBinary::Cursor::need(uint64_t length) const {
+        if (unlikely(end - pos < length))
+            throw DataException(20009, "file: " + fileName + " offset: " + std::to_string(pos) + " - binary checkpoint truncated, " +
+                                       std::to_string(length) + " bytes expected, " + std::to_string(end - pos) + " left");
+    }
+
+    uint8_t SerializerBinary::Cursor::get8() {
+        need(1);
+        return data[pos++];
+    }
+
+    uint16_t SerializerBinary::Cursor::get16() {
+        need(2);
+        const uint16_t value = static_cast<uint16_t>(data[pos]) | static_cast<uint16_t>(static_cast<uint16_t>(data[pos + 1]) << 8);
+        pos += 2;
+        return value;
+    }
+
+    uint32_t SerializerBinary::Cursor::get32() {
+        need(4);
+        uint32_t value = 0;
+        for (uint i = 0; i < 4; ++i)
+            value |= static_cast<uint32_t>(data[pos + i]) << (i * 8);
+        pos += 4;
+        return value;
+    }
+
+    uint64_t SerializerBinary::Cursor::get64() {
+        need(8);
+        uint64_t value = 0;
+        for (uint i = 0; i < 8; ++i)
+            value |= static_cast<uint64_t>(data[pos + i]) << (i * 8);
+        pos += 8;
+        return value;
+    }
+
+    std::string SerializerBinary::Cursor::getString(uint64_t maxLength) {
+        const uint32_t length = get32();
+        if (unlikely(length > maxLength))
+            throw DataException(20009, "file: " + fileName + " offset: " + std::to_string(pos) + " - string of " + std::to_string(length) +
+                                       " bytes exceeds the limit of " + std::to_string(maxLength));
+        need(length);
+        std::string value(reinterpret_cast<const char*>(data + pos), length);
+        pos += length;
+        return value;
+    }
+
+    RowId SerializerBinary::Cursor::getRowId() {
+        const typeDataObj dataObj = get32();
+        const typeDba dba = get32();
+        const typeSlot slot = get16();
+        return {dataObj, dba, slot};
+    }
+
+    SerializerBinary::Cursor SerializerBinary::Cursor::section(uint64_t length) {
+        need(length);
+        Cursor sectionCursor(data, pos, pos + length, fileName);
+        pos += length;
+        return sectionCursor;
+    }
+
+    void SerializerBinary::put8(std::string& out, uint8_t value) {
+        out.push_back(static_cast<char>(value));
+    }
+
+    void SerializerBinary::put16(std::string& out, uint16_t value) {
+        out.push_back(static_cast<char>(value & 0xFF));
+        out.push_back(static_cast<char>(value >> 8));
+    }
+
+    void SerializerBinary::put32(std::string& out, uint32_t value) {
+        for (uint i = 0; i < 4; ++i)
+            out.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+    }
+
+    void SerializerBinary::put64(std::string& out, uint64_t value) {
+        for (uint i = 0; i < 8; ++i)
+            out.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+    }
+
+    void SerializerBinary::putString(std::string& out, const std::string& value) {
+        put32(out, static_cast<uint32_t>(value.length()));
+        out.append(value);
+    }
+
+    void SerializerBinary::putRowId(std::string& out, RowId rowId) {
+        put32(out, rowId.dataObj);
+        put32(out, rowId.dba);
+        put16(out, rowId.slot);
+    }
+
+    void SerializerBinary::putIntX(std::string& out, const IntX& value) {
+        put64(out, value.getData(0));
+        put64(out, value.getData(1));
+    }
+
+    // The length is patched in by endSection(), a reader skips sections it does not know
+    uint64_t SerializerBinary::beginSection(std::string& out, SECTION section) {
+        put32(out, static_cast<uint32_t>(section));
+        put64(out, 0);
+        return out.length();
+    }
+
+    void SerializerBinary::endSection(std::string& out, uint64_t start) {
+        const uint64_t length = out.length() - start;
+        for (uint i = 0; i < 8; ++i)
+            out[start - 8 + i] = static_cast<char>((length >> (i * 8)) & 0xFF);
+    }
+
+    bool SerializerBinary::isBinary(std::string_view ss) {
+        if (ss.length() < 8)
+            return false;
+        uint32_t magic = 0;
+        for (uint i = 0; i < 4; ++i)
+            magic |= static_cast<uint32_t>(static_cast<uint8_t>(ss[i])) << (i * 8);
+        return magic == MAGIC;
+    }
+
+    void SerializerBinary::putRow(std::string& out, const SysCCol* sysCCol) {
+        putRowId(out, sysCCol->rowId);
+        put32(out, sysCCol->con);
+        put16(out, static_cast<uint16_t>(sysCCol->intCol));
+        put32(out, sysCCol->obj);
+        putIntX(out, sysCCol->spare1);
+    }
+
+    void SerializerBinary::putRow(std::string& out, const SysCDef* sysCDef) {
+        putRowId(out, sysCDef->rowId);
+        put32(out, sysCDef->con);
+        put32(out, sysCDef->obj);
+        put16(out, static_cast<uint16_t>(sysCDef->type));
+    }
+
+    void SerializerBinary::putRow(std::string& out, const SysCol* sysCol) {
+        putRowId(out, sysCol->rowId);
+        put32(out, sysCol->obj);
+        put16(out, static_cast<uint16_t>(sysCol->col));
+        put16(out, static_cast<uint16_t>(sysCol->segCol));
+        put16(out, static_cast<uint16_t>(sysCol->intCol));
+        putString(out, sysCol->name);
+        put16(out, static_cast<uint16_t>(sysCol->type));
+        put32(out, sysCol->length);
+        put32(out, static_cast<uint32_t>(sysCol->precision));
+        put32(out, static_cast<uint32_t>(sysCol->scale));
+        put32(out, sysCol->charsetForm);
+        put32(out, sysCol->charsetId);
+        put32(out, static_cast<uint32_t>(sysCol->null_));
+        putIntX(out, sysCol->property);
+    }
+
+    void SerializerBinary::putRow(std::string& out, const SysDeferredStg* sysDeferredStg) {
+        putRowId(out, sysDeferredStg->rowId);
+        put32(out, sysDeferredStg->obj);
+        putIntX(out, sysDeferredStg->flagsStg);
+    }
+
+    void SerializerBinary::putRow(std::string& out, const SysECol* sysECol) {
+        putRowId(out, sysECol->rowId);
+        put32(out, sysECol->tabObj);
+        put16(out, static_cast<uint16_t>(sysECol->colNum));
+        put16(out, static_cast<uint16_t>(sysECol->guardId));
+    }
+
+    void SerializerBinary::putRow(std::string& out, const SysLob* sysLob) {
+        putRowId(out, sysLob->rowId);
+        put32(out, sysLob->obj);
+        put16(out, static_cast<uint16_t>(sysLob->col));
+        put16(out, static_cast<uint16_t>(sysLob->intCol));
+        put32(out, sysLob->lObj);
+        put32(out, sysLob->ts);
+    }
+
+    void SerializerBinary::putRow(std::string& out, const SysLobCompPart* sysLobCompPart) {
+        putRowId(out, sysLobCompPart->rowId);
+        put32(out, sysLobCompPart->partObj);
+        put32(out, sysLobCompPart->lObj);
+    }
+
+    void SerializerBinary::putRow(std::string& out, const SysLobFrag* sysLobFrag) {
+        putRowId(out, sysLobFrag->rowId);
+        put32(out, sysLobFrag->fragObj);
+        put32(out, sysLobFrag->parentObj);
+        put32(out, sysLobFrag->ts);
+    }
+
+    void SerializerBinary::putRow(std::string& out, const SysObj* sysObj) {
+        putRowId(out, sysObj->rowId);
+        put32(out, sysObj->owner);
+        put32(out, sysObj->obj);
+        put32(out, sysObj->dataObj);
+        putString(out, sysObj->name);
+        put16(out, static_cast<uint16_t>(sysObj->type));
+        putIntX(out, sysObj->flags);
+        put8(out, sysObj->single ? 1 : 0);
+    }
+
+    void SerializerBinary::putRow(std::string& out, const SysTab* sysTab) {
+        putRowId(out, sysTab->rowId);
+        put32(out, sysTab->obj);
+        put32(out, sysTab->dataObj);
+        put32(out, sysTab->ts);
+        put16(out, static_cast<uint16_t>(sysTab->cluCols));
+        putIntX(out, sysTab->flags);
+        putIntX(out, sysTab->property);
+    }
+
+    void SerializerBinary::putRow(std::string& out, const SysTabComPart* sysTabComPart) {
+        putRowId(out, sysTabComPart->rowId);
+        put32(out, sysTabComPart->obj);
+        put32(out, sysTabComPart->dataObj);
+        put32(out, sysTabComPart->bo);
+    }
+
+    void SerializerBinary::putRow(std::string& out, const SysTabPart* sysTabPart) {
+        putRowId(out, sysTabPart->rowId);
+        put32(out, sysTabPart->obj);
+        put32(out, sysTabPart->dataObj);
+        put32(out, sysTabPart->bo);
+    }
+
+    void SerializerBinary::putRow(std::string& out, const SysTabSubPart* sysTabSubPart) {
+        putRowId(out, sysTabSubPart->rowId);
+        put32(out, sysTabSubPart->obj);
+        put32(out, sysTabSubPart->dataObj);
+        put32(out, sysTabSubPart->pObj);
+    }
+
+    void SerializerBinary::putRow(std::string& out, const SysTs* sysTs) {
+        putRowId(out, sysTs->rowId);
+        put32(out, sysTs->ts);
+        putString(out, sysTs->name);
+        put32(out, sysTs->blockSize);
+    }
+
+    void SerializerBinary::putRow(std::string& out, const SysUser* sysUser) {
+        putRowId(out, sysUser->rowId);
+        put32(out, sysUser->user);
+        putString(out, sysUser->name);
+        putIntX(out, sysUser->spare1);
+        put8(out, sysUser->single ? 1 : 0);
+    }
+
+    void SerializerBinary::putRow(std::string& out, const XdbTtSet* xdbTtSet) {
+        putRowId(out, xdbTtSet->rowId);
+        putString(out, xdbTtSet->guid);
+        putString(out, xdbTtSet->tokSuf);
+        put64(out, xdbTtSet->flags);
+        put32(out, xdbTtSet->obj);
+    }
+
+    void SerializerBinary::putRow(std::string& out, const XdbXNm* xdbXNm) {
+        putRowId(out, xdbXNm->rowId);
+        putString(out, xdbXNm->nmSpcUri);
+        putString(out, xdbXNm->id);
+    }
+
+    void SerializerBinary::putRow(std::string& out, const XdbXPt* xdbXPt) {
+        putRowId(out, xdbXPt->rowId);
+        putString(out, xdbXPt->path);
+        putString(out, xdbXPt->id);
+    }
+
+    void SerializerBinary::putRow(std::string& out, const XdbXQn* xdbXQn) {
+        putRowId(out, xdbXQn->rowId);
+        putString(out, xdbXQn->nmSpcId);
+        putString(out, xdbXQn->localName);
+        putString(out, xdbXQn->flags);
+        putString(out, xdbXQn->id);
+    }
+
+    // With the deleted buffer only the changed rows are written, rows that no longer exist are listed in it instead
+    template<class Pack>
+    void SerializerBinary::putPack(std::string& out, SECTION section, const Pack& pack, const std::string& tokSuf, std::string* deleted) {
+        const uint64_t start = beginSection(out, section);
+        // Every XML context section starts with the token suffix it belongs to
+        if (section == SECTION::XDB_XNM || section == SECTION::XDB_XPT || section == SECTION::XDB_XQN)
+            putString(out, tokSuf);
+
+        if (deleted == nullptr) {
+            for (const auto& [_, data]: pack.mapRowId)
+                putRow(out, data);
+        } else {
+            for (const RowId rowId: pack.setChanged) {
+                auto it = pack.mapRowId.find(rowId);
+                if (it != pack.mapRowId.end()) {
+                    putRow(out, it->second);
+                    continue;
+                }
+                put32(*deleted, static_cast<uint32_t>(section));
+                putString(*deleted, tokSuf);
+                putRowId(*deleted, rowId);
+            }
+        }
+        endSection(out, start);
+    }
+
+    void SerializerBinary::putMetadata(Metadata* metadata, std::string& out) {
+        put32(out, MAGIC);
+        put32(out, VERSION);
+
+        uint64_t start = beginSection(out, SECTION::CHECKPOINT);
+        putString(out, metadata->database);
+        put64(out, metadata->checkpointScn.getData());
+        put32(out, metadata->resetlogs);
+        put32(out, metadata->activation);
+        put32(out, metadata->checkpointTime.getVal());
+        put32(out, metadata->checkpointSequence.getData());
+        put64(out, metadata->checkpointFileOffset.getData());
+        if (metadata->minSequence != Seq::none()) {
+            put8(out, 1);
+            put32(out, metadata->minSequence.getData());
+            put64(out, metadata->minFileOffset.getData());
+            put64(out, metadata->minXid.getData());
+        } else
+            put8(out, 0);
+        put8(out, metadata->ctx->isBigEndian() ? 1 : 0);
+        putString(out, metadata->context);
+        put16(out, static_cast<uint16_t>(metadata->conId));
+        putString(out, metadata->conName);
+        putString(out, metadata->dbTimezoneStr);
+        putString(out, metadata->dbRecoveryFileDest);
+        putString(out, metadata->dbBlockChecksum);
+        putString(out, metadata->logArchiveDest);
+        putString(out, metadata->logArchiveFormat);
+        putString(out, metadata->nlsCharacterSet);
+        putString(out, metadata->nlsNcharCharacterSet);
+        put8(out, metadata->suppLogDbPrimary ? 1 : 0);
+        put8(out, metadata->suppLogDbAll ? 1 : 0);
+        endSection(out, start);
+
+        start = beginSection(out, SECTION::ONLINE_REDO);
+        for (const RedoLog* redoLog: metadata->redoLogs) {
+            if (redoLog->group == 0)
+                continue;
+            put32(out, static_cast<uint32_t>(redoLog->group));
+            putString(out, redoLog->path);
+        }
+        endSection(out, start);
+
+        start = beginSection(out, SECTION::INCARNATIONS);
+        for (const DbIncarnation* oi: metadata->dbIncarnations) {
+            put32(out, oi->incarnation);
+            put64(out, oi->resetlogsScn.getData());
+            put64(out, oi->priorResetlogsScn.getData());
+            putString(out, oi->status);
+            put32(out, oi->resetlogs);
+            put32(out, oi->priorIncarnation);
+        }
+        endSection(out, start);
+
+        start = beginSection(out, SECTION::USERS);
+        for (const std::string& user: metadata->users)
+            putString(out, user);
+        endSection(out, start);
+    }
+
+    void SerializerBinary::putSchema(Metadata* metadata, std::string& out, std::string* deleted) {
+        const Schema* schema = metadata->schema;
+        const std::string noTokSuf;
+        putPack(out, SECTION::SYS_CCOL, schema->dict->sysCColPack, noTokSuf, deleted);
+        putPack(out, SECTION::SYS_CDEF, schema->dict->sysCDefPack, noTokSuf, deleted);
+        putPack(out, SECTION::SYS_COL, schema->dict->sysColPack, noTokSuf, deleted);
+        putPack(out, SECTION::SYS_DEFERRED_STG, schema->dict->sysDeferredStgPack, noTokSuf, deleted);
+        putPack(out, SECTION::SYS_ECOL, schema->dict->sysEColPack, noTokSuf, deleted);
+        putPack(out, SECTION::SYS_LOB, schema->dict->sysLobPack, noTokSuf, deleted);
+        putPack(out, SECTION::SYS_LOB_COMP_PART, schema->dict->sysLobCompPartPack, noTokSuf, deleted);
+        putPack(out, SECTION::SYS_LOB_FRAG, schema->dict->sysLobFragPack, noTokSuf, deleted);
+        putPack(out, SECTION::SYS_OBJ, schema->dict->sysObjPack, noTokSuf, deleted);
+        putPack(out, SECTION::SYS_TAB, schema->dict->sysTabPack, noTokSuf, deleted);
+        putPack(out, SECTION::SYS_TAB_COM_PART, schema->dict->sysTabComPartPack, noTokSuf, deleted);
+        putPack(out, SECTION::SYS_TAB_PART, schema->dict->sysTabPartPack, noTokSuf, deleted);
+        putPack(out, SECTION::SYS_TAB_SUB_PART, schema->dict->sysTabSubPartPack, noTokSuf, deleted);
+        putPack(out, SECTION::SYS_TS, schema->dict->sysTsPack, noTokSuf, deleted);
+        putPack(out, SECTION::SYS_USER, schema->dict->sysUserPack, noTokSuf, deleted);
+        putPack(out, SECTION::XDB_TTSET, schema->dict->xdbTtSetPack, noTokSuf, deleted);
+
+        for (const auto& [tokSuf, xmlCtx]: schema->schemaXmlMap) {
+            putPack(out, SECTION::XDB_XNM, xmlCtx->xdbXNmPack, tokSuf, deleted);
+            putPack(out, SECTION::XDB_XPT, xmlCtx->xdbXPtPack, tokSuf, deleted);
+            putPack(out, SECTION::XDB_XQN, xmlCtx->xdbXQnPack, tokSuf, deleted);
+        }
+    }
+
+    void SerializerBinary::serializeMetadata(Metadata* metadata, std::ostringstream& ss) {
+        // Assuming the caller holds mtxCheckpoint
+        std::string out;
+        putMetadata(metadata, out);
+        ss.write(out.data(), static_cast<std::streamsize>(out.length()));
+    }
+
+    void SerializerBinary::serializeSchema(Metadata* metadata, std::ostringstream& ss, Scn scn, bool storeSchema) {
+        // Assuming the caller holds mtxSchema
+        std::string out;
+
+        // The schema has not changed since the last checkpoint file
+        if (!storeSchema) {
+            const uint64_t start = beginSection(out, SECTION::SCHEMA_REF);
+            put64(out, metadata->schema->refScn.getData());
+            endSection(out, start);
+        } else {
+            metadata->schema->refScn = scn;
+            const uint64_t start = beginSection(out, SECTION::SCHEMA);
+            put64(out, metadata->schema->scn.getData());
+            endSection(out, start);
+            putSchema(metadata, out, nullptr);
+        }
+
+        beginSection(out, SECTION::END);
+        ss.write(out.data(), static_cast<std::streamsize>(out.length()));
+    }
+
+    void SerializerBinary::serializeSchemaDelta(Metadata* metadata, std::ostringstream& ss, Scn scn) {
+        // Assuming the caller holds mtxSchema
+        std::string out;
+
+        metadata->schema->refScn = scn;
+        uint64_t start = beginSection(out, SECTION::SCHEMA_DELTA);
+        put64(out, metadata->schemaBaseScn.getData());
+        put64(out, metadata->schema->scn.getData());
+        endSection(out, start);
+
+        std::string deleted;
+        putSchema(metadata, out, &deleted);
+
+        start = beginSection(out, SECTION::DELETED);
+        out.append(deleted);
+        endSection(out, start);
+
+        beginSection(out, SECTION::END);
+        ss.write(out.data(), static_cast<std::streamsize>(out.length()));
+    }
+
+    bool SerializerBinary::deserialize(Metadata* metadata, std::string_view ss, const std::string& fileName, std::vector<std::string>& msgs,
+                                       std::unordered_map<typeObj, std::string>& tablesUpdated, bool loadMetadata, bool loadSchema) {
+        // Checkpoints written before switching the format, the next checkpoint replaces them
+        if (!isBinary(ss))
+            return serializerJson.deserialize(metadata, ss, fileName, msgs, tablesUpdated, loadMetadata, loadSchema);
+
+        if (loadSchema)
+            metadata->schema->dictForUpdate();
+
+        try {
+            Cursor cursor(reinterpret_cast<const uint8_t*>(ss.data()), 4, ss.length(), fileName);
+            const uint32_t version = cursor.get32();
+            if (unlikely(version > VERSION))
+                throw DataException(20009, "file: " + fileName + " - unsupported binary checkpoint version: " + std::to_string(version) +
+                                           ", expected: at most " + std::to_string(VERSION));
+
+            std::unique_lock<std::mutex> const lckCheckpoint(metadata->mtxCheckpoint);
+            std::unique_lock<std::mutex> const lckSchema(metadata->mtxSchema);
+            if (loadMetadata)
+                pendingDelta.clear();
+
+            bool schemaRef = false;
+            bool schemaFull = false;
+            bool ended = false;
+            while (!ended) {
+                const auto section = static_cast<SECTION>(cursor.get32());
+                const uint64_t length = cursor.get64();
+                Cursor sectionCursor = cursor.section(length);
+
+                switch (section) {
+                    case SECTION::END:
+                        ended = true;
+                        break;
+
+                    case SECTION::CHECKPOINT:
+                        if (loadMetadata)
+                            readCheckpoint(metadata, sectionCursor, fileName);
+                        break;
+
+                    case SECTION::ONLINE_REDO:
+                        if (loadMetadata && !metadata->onlineData)
+                            readOnlineRedo(metadata, sectionCursor);
+                        break;
+
+                    case SECTION::INCARNATIONS:
+                        if (loadMetadata && !metadata->onlineData)
+                            readIncarnations(metadata, sectionCursor);
+                        break;
+
+                    case SECTION::USERS:
+                        if (loadMetadata && !metadata->ctx->isFlagSet(Ctx::REDO_FLAGS::ADAPTIVE_SCHEMA))
+                            readUsers(metadata, sectionCursor, fileName);
+                        break;
+
+                    case SECTION::SCHEMA_REF:
+                        if (loadSchema) {
+                            // Schema referenced to other checkpoint file
+                            metadata->schema->scn = Scn::none();
+                            metadata->schema->refScn = Scn(sectionCursor.get64());
+                            schemaRef = true;
+                        }
+                        break;
+
+                    case SECTION::SCHEMA:
+                        if (loadSchema) {
+                            metadata->schema->scn = Scn(sectionCursor.get64());
+                            metadata->schema->refScn = Scn::none();
+                            schemaFull = true;
+                        }
+                        break;
+
+                    case SECTION::SCHEMA_DELTA:
+                        if (loadSchema) {
+                            // Only the changed rows, replayed when the base schema they refer to is loaded
+                            metadata->schema->scn = Scn::none();
+                            metadata->schema->refScn = Scn(sectionCursor.get64());
+                            pendingDeltaScn = Scn(sectionCursor.get64());
+                            pendingDelta = std::string(ss);
+                            pendingDeltaFileName = fileName;
+                            schemaRef = true;
+                        }
+                        break;
+
+                    default:
+                        // Dictionary tables, sections added by a later minor version of the format are skipped
+                        if (schemaFull && isTableSection(section))
+                            readTable(metadata, section, sectionCursor, fileName, false);
+                        break;
+                }
+            }
+
+            if (schemaFull && !pendingDelta.empty())
+                applyDelta(metadata);
+
+            if (loadSchema) {
+                if (unlikely(!schemaRef && !schemaFull))
+                    throw DataException(20009, "file: " + fileName + " - schema and schema reference missing");
+
+                if (schemaFull)
+                    metadata->schema->touched = true;
+
+                // Loading schema from configuration file
+                metadata->buildMaps(msgs, tablesUpdated);
+                metadata->schema->resetTouched();
+                metadata->schema->loaded = true;
+            }
+        } catch (DataException& ex) {
+            metadata->ctx->error(ex.code, ex.msg);
+            return false;
+        }
+        return true;
+    }
+
+    void SerializerBinary::readCheckpoint(Metadata* metadata, Cursor& cursor, const std::string& fileName) {
+        const std::string newDatabase = cursor.getString(Ctx::JSON_PARAMETER_LENGTH);
+        metadata->checkpointScn = Scn(cursor.get64());
+        const typeResetlogs resetlogs = cursor.get32();
+        const typeActivation activation = cursor.get32();
+        cursor.get32(); // time, not read
+        Seq sequence(cursor.get32());
+        FileOffset fileOffset(cursor.get64());
+        if (cursor.get8() != 0) {
+            sequence = Seq(cursor.get32());
+            fileOffset = FileOffset(cursor.get64());
+            cursor.get64(); // xid, not read
+        }
+        metadata->sequence = sequence;
+        metadata->fileOffset = fileOffset;
+
+        if (unlikely(!metadata->fileOffset.matchesBlockSize(Ctx::MIN_BLOCK_SIZE)))
+            throw DataException(20006, "file: " + fileName + " - invalid offset: " + metadata->fileOffset.toString() +
+                                       " is not a multiplication of " + std::to_string(Ctx::MIN_BLOCK_SIZE));
+
+        metadata->minSequence = Seq::none();
+        metadata->minFileOffset = FileOffset::zero();
+        metadata->minXid = Xid::zero();
+        metadata->lastCheckpointScn = Scn::none();
+        metadata->lastSequence = Seq::none();
+        metadata->lastCheckpointFileOffset = FileOffset::zero();
+        metadata->lastCheckpointTime = 0;
+        metadata->lastCheckpointBytes = 0;
+
+        const bool bigEndian = cursor.get8() != 0;
+        const std::string context = cursor.getString(DbTable::VCONTEXT_LENGTH);
+        const auto conId = static_cast<typeConId>(cursor.get16());
+        const std::string conName = cursor.getString(DbTable::VCONTEXT_LENGTH);
+        const std::string dbTimezoneStr = cursor.getString(DbTable::VCONTEXT_LENGTH);
+        const std::string dbRecoveryFileDest = cursor.getString(DbTable::VPARAMETER_LENGTH);
+        const std::string dbBlockChecksum = cursor.getString(DbTable::VPARAMETER_LENGTH);
+        const std::string logArchiveDest = cursor.getString(DbTable::VPARAMETER_LENGTH);
+        const std::string logArchiveFormat = cursor.getString(DbTable::VPARAMETER_LENGTH);
+        const std::string nlsCharacterSet = cursor.getString(DbTable::VPROPERTY_LENGTH);
+        const std::string nlsNcharCharacterSet = cursor.getString(DbTable::VPROPERTY_LENGTH);
+        const bool suppLogDbPrimary = cursor.get8() != 0;
+        const bool suppLogDbAll = cursor.get8() != 0;
+
+        if (metadata->onlineData)
+            return;
+
+        // Database metadata
+        if (metadata->database.empty()) {
+            metadata->database = newDatabase;
+        } else if (metadata->database != newDatabase) {
+            throw DataException(20001, "file: " + fileName + " - parse error of field \"database\", invalid value: " + newDatabase +
+                                       ", expected value: " + metadata->database);
+        }
+        metadata->resetlogs = resetlogs;
+        metadata->activation = activation;
+        if (bigEndian)
+            metadata->ctx->setBigEndian();
+        metadata->context = context;
+        metadata->conId = conId;
+        metadata->conName = conName;
+        metadata->dbTimezoneStr = dbTimezoneStr;
+        if (metadata->ctx->dbTimezone != Ctx::BAD_TIMEZONE) {
+            metadata->dbTimezone = metadata->ctx->dbTimezone;
+        } else {
+            if (unlikely(!Data::parseTimezone(metadata->dbTimezoneStr, metadata->dbTimezone)))
+                throw DataException(20001, "file: " + fileName + " - parse error of field \"db-timezone\", invalid value: " +
+                                           metadata->dbTimezoneStr);
+        }
+        metadata->dbRecoveryFileDest = dbRecoveryFileDest;
+        metadata->dbBlockChecksum = dbBlockChecksum;
+        if (!metadata->logArchiveFormatCustom)
+            metadata->logArchiveFormat = logArchiveFormat;
+        metadata->logArchiveDest = logArchiveDest;
+        metadata->nlsCharacterSet = nlsCharacterSet;
+        metadata->nlsNcharCharacterSet = nlsNcharCharacterSet;
+        metadata->setNlsCharset(metadata->nlsCharacterSet, metadata->nlsNcharCharacterSet);
+        metadata->suppLogDbPrimary = suppLogDbPrimary;
+        metadata->suppLogDbAll = suppLogDbAll;
+    }
+
+    void SerializerBinary::readOnlineRedo(Metadata* metadata, Cursor& cursor) {
+        while (!cursor.atEnd()) {
+            const int group = static_cast<int>(cursor.get32());
+            auto* redoLog = new RedoLog(group, cursor.getString(Ctx::MAX_PATH_LENGTH));
+            metadata->redoLogs.insert(redoLog);
+        }
+    }
+
+    void SerializerBinary::readIncarnations(Metadata* metadata, Cursor& cursor) {
+        while (!cursor.atEnd()) {
+            const uint32_t incarnation = cursor.get32();
+            const Scn resetlogsScn(cursor.get64());
+            const Scn priorResetlogsScn(cursor.get64());
+            const std::string status = cursor.getString(128);
+            const typeResetlogs resetlogs = cursor.get32();
+            const uint32_t priorIncarnation = cursor.get32();
+
+            auto* oi = new DbIncarnation(incarnation, resetlogsScn, priorResetlogsScn, status, resetlogs, priorIncarnation);
+            metadata->dbIncarnations.insert(oi);
+
+            if (oi->current)
+                metadata->dbIncarnationCurrent = oi;
+            else
+                metadata->dbIncarnationCurrent = nullptr;
+        }
+    }
+
+    void SerializerBinary::readUsers(Metadata* metadata, Cursor& cursor, const std::string& fileName) {
+        std::set<std::string> users;
+        while (!cursor.atEnd())
+            users.insert(cursor.getString(SysUser::NAME_LENGTH));
+
+        for (const auto& user: metadata->users) {
+            if (unlikely(users.find(user) == users.end()))
+                throw DataException(20007, "file: " + fileName + " - " + user + " is missing");
+        }
+        for (const auto& user: users) {
+            if (unlikely(metadata->users.find(user) == metadata->users.end()))
+                throw DataException(20007, "file: " + fileName + " - " + user + " is redundant");
+        }
+    }
+
+    template<class Pack, class Data>
+    void SerializerBinary::addRow(const Ctx* ctx, Pack& pack, Data* data, bool replace) {
+        if (replace)
+            pack.drop(ctx, data->rowId, FileOffset::zero(), true);
+        pack.addWithKeys(ctx, data);
+    }
+
+    bool SerializerBinary::isTableSection(SECTION section) {
+        return section >= SECTION::SYS_CCOL && section <= SECTION::XDB_XQN;
+    }
+
+    void SerializerBinary::readTable(Metadata* metadata, SECTION section, Cursor& cursor, const std::string& fileName, bool replace) {
+        Schema* schema = metadata->schema;
+        Ctx* ctx = metadata->ctx;
+
+        XmlCtx* xmlCtx = nullptr;
+        if (section == SECTION::XDB_XNM || section == SECTION::XDB_XPT || section == SECTION::XDB_XQN) {
+            const std::string tokSuf = cursor.getString(XdbTtSet::TOKSUF_LENGTH);
+            auto it = schema->schemaXmlMap.find(tokSuf);
+            if (unlikely(it == schema->schemaXmlMap.end()))
+                throw DataException(20009, "file: " + fileName + " - xml context for token suffix " + tokSuf + " missing in xdb-ttset");
+            xmlCtx = it->second;
+        }
+
+        while (!cursor.atEnd()) {
+            const RowId rowId = cursor.getRowId();
+            switch (section) {
+                case SECTION::SYS_CCOL: {
+                    const typeCon con = cursor.get32();
+                    const auto intCol = static_cast<typeCol>(cursor.get16());
+                    const typeObj obj = cursor.get32();
+                    const uint64_t spare11 = cursor.get64();
+                    const uint64_t spare12 = cursor.get64();
+                    addRow(ctx, schema->dict->sysCColPack, new SysCCol(rowId, con, intCol, obj, spare11, spare12), replace);
+                    schema->touchTable(obj);
+                    break;
+                }
+
+                case SECTION::SYS_CDEF: {
+                    const typeCon con = cursor.get32();
+                    const typeObj obj = cursor.get32();
+                    const auto type = static_cast<SysCDef::CDEFTYPE>(cursor.get16());
+                    addRow(ctx, schema->dict->sysCDefPack, new SysCDef(rowId, con, obj, type), replace);
+                    schema->touchTable(obj);
+                    break;
+                }
+
+                case SECTION::SYS_COL: {
+                    const typeObj obj = cursor.get32();
+                    const auto col = static_cast<typeCol>(cursor.get16());
+                    const auto segCol = static_cast<typeCol>(cursor.get16());
+                    const auto intCol = static_cast<typeCol>(cursor.get16());
+                    const std::string name = cursor.getString(SysCol::NAME_LENGTH);
+                    const auto type = static_cast<SysCol::COLTYPE>(cursor.get16());
+                    const uint length = cursor.get32();
+                    const auto precision = static_cast<int>(cursor.get32());
+                    const auto scale = static_cast<int>(cursor.get32());
+                    const uint charsetForm = cursor.get32();
+                    const uint charsetId = cursor.get32();
+                    const auto null_ = static_cast<int>(cursor.get32());
+                    const uint64_t property1 = cursor.get64();
+                    const uint64_t property2 = cursor.get64();
+                    addRow(ctx, schema->dict->sysColPack, new SysCol(rowId, obj, col, segCol, intCol, name, type, length, precision, scale,
+                                                               charsetForm, charsetId, null_, property1, property2), replace);
+                    schema->touchTable(obj);
+                    break;
+                }
+
+                case SECTION::SYS_DEFERRED_STG: {
+                    const typeObj obj = cursor.get32();
+                    const uint64_t flagsStg1 = cursor.get64();
+                    const uint64_t flagsStg2 = cursor.get64();
+                    addRow(ctx, schema->dict->sysDeferredStgPack, new SysDeferredStg(rowId, obj, flagsStg1, flagsStg2), replace);
+                    schema->touchTable(obj);
+                    break;
+                }
+
+                case SECTION::SYS_ECOL: {
+                    const typeObj tabObj = cursor.get32();
+                    const auto colNum = static_cast<typeCol>(cursor.get16());
+                    const auto guardId = static_cast<typeCol>(cursor.get16());
+                    addRow(ctx, schema->dict->sysEColPack, new SysECol(rowId, tabObj, colNum, guardId), replace);
+                    schema->touchTable(tabObj);
+                    break;
+                }
+
+                case SECTION::SYS_LOB: {
+                    const typeObj obj = cursor.get32();
+                    const auto col = static_cast<typeCol>(cursor.get16());
+                    const auto intCol = static_cast<typeCol>(cursor.get16());
+                    const typeObj lObj = cursor.get32();
+                    const uint32_t ts = cursor.get32();
+                    addRow(ctx, schema->dict->sysLobPack, new SysLob(rowId, obj, col, intCol, lObj, ts), replace);
+                    schema->touchTable(obj);
+                    break;
+                }
+
+                case SECTION::SYS_LOB_COMP_PART: {
+                    const typeObj partObj = cursor.get32();
+                    const typeObj lObj = cursor.get32();
+                    addRow(ctx, schema->dict->sysLobCompPartPack, new SysLobCompPart(rowId, partObj, lObj), replace);
+                    schema->touchTableLob(lObj);
+                    break;
+                }
+
+                case SECTION::SYS_LOB_FRAG: {
+                    const typeObj fragObj = cursor.get32();
+                    const typeObj parentObj = cursor.get32();
+                    const uint32_t ts = cursor.get32();
+                    addRow(ctx, schema->dict->sysLobFragPack, new SysLobFrag(rowId, fragObj, parentObj, ts), replace);
+                    schema->touchTableLobFrag(parentObj);
+                    schema->touchTableLob(parentObj);
+                    break;
+                }
+
+                case SECTION::SYS_OBJ: {
+                    const typeUser owner = cursor.get32();
+                    const typeObj obj = cursor.get32();
+                    const typeDataObj dataObj = cursor.get32();
+                    const std::string name = cursor.getString(SysObj::NAME_LENGTH);
+                    const auto type = static_cast<SysObj::OBJTYPE>(cursor.get16());
+                    const uint64_t flags1 = cursor.get64();
+                    const uint64_t flags2 = cursor.get64();
+                    const bool single = cursor.get8() != 0;
+                    addRow(ctx, schema->dict->sysObjPack, new SysObj(rowId, owner, obj, dataObj, type, name, flags1, flags2, single), replace);
+                    schema->touchTable(obj);
+                    break;
+                }
+
+                case SECTION::SYS_TAB: {
+                    const typeObj obj = cursor.get32();
+                    const typeDataObj dataObj = cursor.get32();
+                    const typeTs ts = cursor.get32();
+                    const auto cluCols = static_cast<typeCol>(cursor.get16());
+                    const uint64_t flags1 = cursor.get64();
+                    const uint64_t flags2 = cursor.get64();
+                    const uint64_t property1 = cursor.get64();
+                    const uint64_t property2 = cursor.get64();
+                    addRow(ctx, schema->dict->sysTabPack, new SysTab(rowId, obj, dataObj, ts, cluCols, flags1, flags2, property1, property2), replace);
+                    schema->touchTable(obj);
+                    break;
+                }
+
+                case SECTION::SYS_TAB_COM_PART: {
+                    const typeObj obj = cursor.get32();
+                    const typeDataObj dataObj = cursor.get32();
+                    const typeObj bo = cursor.get32();
+                    addRow(ctx, schema->dict->sysTabComPartPack, new SysTabComPart(rowId, obj, dataObj, bo), replace);
+                    schema->touchTable(bo);
+                    break;
+                }
+
+                case SECTION::SYS_TAB_PART: {
+                    const typeObj obj = cursor.get32();
+                    const typeDataObj dataObj = cursor.get32();
+                    const typeObj bo = cursor.get32();
+                    addRow(ctx, schema->dict->sysTabPartPack, new SysTabPart(rowId, obj, dataObj, bo), replace);
+                    schema->touchTable(bo);
+                    break;
+                }
+
+                case SECTION::SYS_TAB_SUB_PART: {
+                    const typeObj obj = cursor.get32();
+                    const typeDataObj dataObj = cursor.get32();
+                    const typeObj pObj = cursor.get32();
+                    addRow(ctx, schema->dict->sysTabSubPartPack, new SysTabSubPart(rowId, obj, dataObj, pObj), replace);
+                    schema->touchTablePart(obj);
+                    break;
+                }
+
+                case SECTION::SYS_TS: {
+                    const typeTs ts = cursor.get32();
+                    const std::string name = cursor.getString(SysTs::NAME_LENGTH);
+                    const uint32_t blockSize = cursor.get32();
+                    addRow(ctx, schema->dict->sysTsPack, new SysTs(rowId, ts, name, blockSize), replace);
+                    break;
+                }
+
+                case SECTION::SYS_USER: {
+                    const typeUser user = cursor.get32();
+                    const std::string name = cursor.getString(SysUser::NAME_LENGTH);
+                    const uint64_t spare11 = cursor.get64();
+                    const uint64_t spare12 = cursor.get64();
+                    const bool single = cursor.get8() != 0;
+                    addRow(ctx, schema->dict->sysUserPack, new SysUser(rowId, user, name, spare11, spare12, single), replace);
+                    break;
+                }
+
+                case SECTION::XDB_TTSET: {
+                    const std::string guid = cursor.getString(XdbTtSet::GUID_LENGTH);
+                    const std::string tokSuf = cursor.getString(XdbTtSet::TOKSUF_LENGTH);
+                    const uint64_t flags = cursor.get64();
+                    const uint32_t obj = cursor.get32();
+                    addRow(ctx, schema->dict->xdbTtSetPack, new XdbTtSet(rowId, guid, tokSuf, flags, obj), replace);
+
+                    // A replayed row keeps the context and its tables
+                    if (schema->schemaXmlMap.find(tokSuf) == schema->schemaXmlMap.end())
+                        schema->schemaXmlMap.insert_or_assign(tokSuf, new XmlCtx(ctx, tokSuf, flags));
+                    break;
+                }
+
+                case SECTION::XDB_XNM: {
+                    const std::string nmSpcUri = cursor.getString(XdbXNm::NMSPCURI_LENGTH);
+                    const std::string id = cursor.getString(XdbXNm::ID_LENGTH);
+                    addRow(ctx, xmlCtx->xdbXNmPack, new XdbXNm(rowId, nmSpcUri, id), replace);
+                    break;
+                }
+
+                case SECTION::XDB_XPT: {
+                    const std::string path = cursor.getString(XdbXPt::PATH_LENGTH);
+                    const std::string id = cursor.getString(XdbXPt::ID_LENGTH);
+                    addRow(ctx, xmlCtx->xdbXPtPack, new XdbXPt(rowId, path, id), replace);
+                    break;
+                }
+
+                case SECTION::XDB_XQN: {
+                    const std::string nmSpcId = cursor.getString(XdbXQn::NMSPCID_LENGTH);
+                    const std::string localName = cursor.getString(XdbXQn::LOCALNAME_LENGTH);
+                    const std::string flags = cursor.getString(XdbXQn::FLAGS_LENGTH);
+                    const std::string id = cursor.getString(XdbXQn::ID_LENGTH);
+                    addRow(ctx, xmlCtx->xdbXQnPack, new XdbXQn(rowId, nmSpcId, localName, flags, id), replace);
+                    break;
+                }
+
+                default:
+                    return;
+            }
+        }
+    }
+
+    void SerializerBinary::readDeleted(Metadata* metadata, Cursor& cursor) {
+        Schema* schema = metadata->schema;
+        const Ctx* ctx = metadata->ctx;
+
+        while (!cursor.atEnd()) {
+            const auto section = static_cast<SECTION>(cursor.get32());
+            const std::string tokSuf = cursor.getString(XdbTtSet::TOKSUF_LENGTH);
+            const RowId rowId = cursor.getRowId();
+            const FileOffset fileOffset = FileOffset::zero();
+
+            switch (section) {
+                case SECTION::SYS_CCOL:
+                    schema->dict->sysCColPack.drop(ctx, rowId, fileOffset, true);
+                    break;
+                case SECTION::SYS_CDEF:
+                    schema->dict->sysCDefPack.drop(ctx, rowId, fileOffset, true);
+                    break;
+                case SECTION::SYS_COL:
+                    schema->dict->sysColPack.drop(ctx, rowId, fileOffset, true);
+                    break;
+                case SECTION::SYS_DEFERRED_STG:
+                    schema->dict->sysDeferredStgPack.drop(ctx, rowId, fileOffset, true);
+                    break;
+                case SECTION::SYS_ECOL:
+                    schema->dict->sysEColPack.drop(ctx, rowId, fileOffset, true);
+                    break;
+                case SECTION::SYS_LOB:
+                    schema->dict->sysLobPack.drop(ctx, rowId, fileOffset, true);
+                    break;
+                case SECTION::SYS_LOB_COMP_PART:
+                    schema->dict->sysLobCompPartPack.drop(ctx, rowId, fileOffset, true);
+                    break;
+                case SECTION::SYS_LOB_FRAG:
+                    schema->dict->sysLobFragPack.drop(ctx, rowId, fileOffset, true);
+                    break;
+                case SECTION::SYS_OBJ:
+                    schema->dict->sysObjPack.drop(ctx, rowId, fileOffset, true);
+                    break;
+                case SECTION::SYS_TAB:
+                    schema->dict->sysTabPack.drop(ctx, rowId, fileOffset, true);
+                    break;
+                case SECTION::SYS_TAB_COM_PART:
+                    schema->dict->sysTabComPartPack.drop(ctx, rowId, fileOffset, true);
+                    break;
+                case SECTION::SYS_TAB_PART:
+                    schema->dict->sysTabPartPack.drop(ctx, rowId, fileOffset, true);
+                    break;
+                case SECTION::SYS_TAB_SUB_PART:
+                    schema->dict->sysTabSubPartPack.drop(ctx, rowId, fileOffset, true);
+                    break;
+                case SECTION::SYS_TS:
+                    schema->dict->sysTsPack.drop(ctx, rowId, fileOffset, true);
+                    break;
+                case SECTION::SYS_USER:
+                    schema->dict->sysUserPack.drop(ctx, rowId, fileOffset, true);
+                    break;
+                case SECTION::XDB_TTSET:
+                    schema->dict->xdbTtSetPack.drop(ctx, rowId, fileOffset, true);
+                    break;
+                case SECTION::XDB_XNM:
+                case SECTION::XDB_XPT:
+                case SECTION::XDB_XQN: {
+                    auto it = schema->schemaXmlMap.find(tokSuf);
+                    if (it == schema->schemaXmlMap.end())
+                        break;
+                    if (section == SECTION::XDB_XNM)
+                        it->second->xdbXNmPack.drop(ctx, rowId, fileOffset, true);
+                    else if (section == SECTION::XDB_XPT)
+                        it->second->xdbXPtPack.drop(ctx, rowId, fileOffset, true);
+                    else
+                        it->second->xdbXQnPack.drop(ctx, rowId, fileOffset, true);
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+    }
+
+    // The base schema sections are loaded, the changed rows replace them and the deleted rows are removed
+    void SerializerBinary::applyDelta(Metadata* metadata) {
+        const std::string delta(std::move(pendingDelta));
+        const std::string fileName(std::move(pendingDeltaFileName));
+        pendingDelta.clear();
+        pendingDeltaFileName.clear();
+        metadata->ctx->info(0, "replaying schema changes from: " + fileName);
+
+        Cursor cursor(reinterpret_cast<const uint8_t*>(delta.data()), 8, delta.length(), fileName);
+        bool ended = false;
+        while (!ended) {
+            const auto section = static_cast<SECTION>(cursor.get32());
+            const uint64_t length = cursor.get64();
+            Cursor sectionCursor = cursor.section(length);
+
+            if (section == SECTION::END)
+                ended = true;
+            else if (section == SECTION::DELETED)
+                readDeleted(metadata, sectionCursor);
+            else if (isTableSection(section))
+                readTable(metadata, section, sectionCursor, fileName, true);
+        }
+        metadata->schema->scn = pendingDeltaScn;
+        pendingDeltaScn = Scn::none();
+    }
+}
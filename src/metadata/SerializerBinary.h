@@ -0,0 +1,165 @@
+/* Header for SerializerBinary class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef SERIALIZER_BINARY_H_
+#define SERIALIZER_BINARY_H_
+
+#include "../common/types/IntX.h"
+#include "../common/types/RowId.h"
+#include "../common/types/Scn.h"
+#include "Serializer.h"
+#include "SerializerJson.h"
+
+namespace OpenLogReplicator {
+    class Ctx;
+    class SysCCol;
+    class SysCDef;
+    class SysCol;
+    class SysDeferredStg;
+    class SysECol;
+    class SysLob;
+    class SysLobCompPart;
+    class SysLobFrag;
+    class SysObj;
+    class SysTab;
+    class SysTabComPart;
+    class SysTabPart;
+    class SysTabSubPart;
+    class SysTs;
+    class SysUser;
+    class XdbTtSet;
+    class XdbXNm;
+    class XdbXPt;
+    class XdbXQn;
+    class XmlCtx;
+
+    // Versioned, length-prefixed sections of fixed-width little-endian fields, nothing needs parsing beyond bounds checks so the
+    // file can be decoded straight from a mapped buffer; checkpoints written in JSON are still read and replaced on the next write.
+    // A delta checkpoint holds only the rows changed since the last full schema and refers to it, loading replays it on top of the base
+    class SerializerBinary final : public Serializer {
+    protected:
+        static constexpr uint32_t MAGIC{0x42524C4F};    // "OLRB"
+        static constexpr uint32_t VERSION{1};
+
+        enum class SECTION : uint32_t {
+            END = 0, CHECKPOINT = 1, ONLINE_REDO = 2, INCARNATIONS = 3, USERS = 4, SCHEMA_REF = 5, SCHEMA = 6, DELETED = 7, SCHEMA_DELTA = 8,
+            SYS_CCOL = 10, SYS_CDEF = 11, SYS_COL = 12, SYS_DEFERRED_STG = 13, SYS_ECOL = 14, SYS_LOB = 15, SYS_LOB_COMP_PART = 16,
+            SYS_LOB_FRAG = 17, SYS_OBJ = 18, SYS_TAB = 19, SYS_TAB_COM_PART = 20, SYS_TAB_PART = 21, SYS_TAB_SUB_PART = 22,
+            SYS_TS = 23, SYS_USER = 24, XDB_TTSET = 25, XDB_XNM = 26, XDB_XPT = 27, XDB_XQN = 28
+        };
+
+        // Bounds-checked read position in the serialized buffer
+        class Cursor final {
+        protected:
+            const uint8_t* data;
+            uint64_t pos;
+            uint64_t end;
+            const std::string& fileName;
+
+            void need(uint64_t length) const;
+
+        public:
+            Cursor(const uint8_t* newData, uint64_t newPos, uint64_t newEnd, const std::string& newFileName);
+
+            [[nodiscard]] bool atEnd() const {
+                return pos >= end;
+            }
+
+            [[nodiscard]] uint64_t getPos() const {
+                return pos;
+            }
+
+            uint8_t get8();
+            uint16_t get16();
+            uint32_t get32();
+            uint64_t get64();
+            std::string getString(uint64_t maxLength);
+            RowId getRowId();
+            Cursor section(uint64_t length);
+        };
+
+        SerializerJson serializerJson;
+        // Delta checkpoint waiting for its base schema to be loaded
+        std::string pendingDelta;
+        std::string pendingDeltaFileName;
+        Scn pendingDeltaScn{Scn::none()};
+
+        static void put8(std::string& out, uint8_t value);
+        static void put16(std::string& out, uint16_t value);
+        static void put32(std::string& out, uint32_t value);
+        static void put64(std::string& out, uint64_t value);
+        static void putString(std::string& out, const std::string& value);
+        static void putRowId(std::string& out, RowId rowId);
+        static void putIntX(std::string& out, const IntX& value);
+        static uint64_t beginSection(std::string& out, SECTION section);
+        static void endSection(std::string& out, uint64_t start);
+        static void putRow(std::string& out, const SysCCol* sysCCol);
+        static void putRow(std::string& out, const SysCDef* sysCDef);
+        static void putRow(std::string& out, const SysCol* sysCol);
+        static void putRow(std::string& out, const SysDeferredStg* sysDeferredStg);
+        static void putRow(std::string& out, const SysECol* sysECol);
+        static void putRow(std::string& out, const SysLob* sysLob);
+        static void putRow(std::string& out, const SysLobCompPart* sysLobCompPart);
+        static void putRow(std::string& out, const SysLobFrag* sysLobFrag);
+        static void putRow(std::string& out, const SysObj* sysObj);
+        static void putRow(std::string& out, const SysTab* sysTab);
+        static void putRow(std::string& out, const SysTabComPart* sysTabComPart);
+        static void putRow(std::string& out, const SysTabPart* sysTabPart);
+        static void putRow(std::string& out, const SysTabSubPart* sysTabSubPart);
+        static void putRow(std::string& out, const SysTs* sysTs);
+        static void putRow(std::string& out, const SysUser* sysUser);
+        static void putRow(std::string& out, const XdbTtSet* xdbTtSet);
+        static void putRow(std::string& out, const XdbXNm* xdbXNm);
+        static void putRow(std::string& out, const XdbXPt* xdbXPt);
+        static void putRow(std::string& out, const XdbXQn* xdbXQn);
+        template<class Pack>
+        static void putPack(std::string& out, SECTION section, const Pack& pack, const std::string& tokSuf, std::string* deleted);
+        static void putMetadata(Metadata* metadata, std::string& out);
+        static void putSchema(Metadata* metadata, std::string& out, std::string* deleted);
+
+        static void readCheckpoint(Metadata* metadata, Cursor& cursor, const std::string& fileName);
+        static void readOnlineRedo(Metadata* metadata, Cursor& cursor);
+        static void readIncarnations(Metadata* metadata, Cursor& cursor);
+        static void readUsers(Metadata* metadata, Cursor& cursor, const std::string& fileName);
+        template<class Pack, class Data>
+        static void addRow(const Ctx* ctx, Pack& pack, Data* data, bool replace);
+        static void readTable(Metadata* metadata, SECTION section, Cursor& cursor, const std::string& fileName, bool replace);
+        static void readDeleted(Metadata* metadata, Cursor& cursor);
+        [[nodiscard]] static bool isTableSection(SECTION section);
+        void applyDelta(Metadata* metadata);
+
+    public:
+        SerializerBinary() = default;
+        ~SerializerBinary() override = default;
+        SerializerBinary(const SerializerBinary&) = delete;
+        SerializerBinary& operator=(const SerializerBinary&) = delete;
+
+        [[nodiscard]] static bool isBinary(std::string_view ss);
+        [[nodiscard]] bool deserialize(Metadata* metadata, std::string_view ss, const std::string& fileName, std::vector<std::string>& msgs,
+                                       std::unordered_map<typeObj, std::string>& tablesUpdated, bool loadMetadata, bool loadSchema) override;
+        void serializeMetadata(Metadata* metadata, std::ostringstream& ss) override;
+        void serializeSchema(Metadata* metadata, std::ostringstream& ss, Scn scn, bool storeSchema) override;
+        [[nodiscard]] bool isDeltaSupported() const override {
+            return true;
+        }
+        void serializeSchemaDelta(Metadata* metadata, std::ostringstream& ss, Scn scn) override;
+    };
+}
+
+#endif
@@ -49,8 +49,8 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include "SerializerJson.h"
 
 namespace OpenLogReplicator {
-    void SerializerJson::serialize(Metadata* metadata, std::ostringstream& ss, bool storeSchema) {
-        // Assuming the caller holds all locks
+    void SerializerJson::serializeMetadata(Metadata* metadata, std::ostringstream& ss) {
+        // Assuming the caller holds mtxCheckpoint
         ss << R"({"database":")";
         Data::writeEscapeValue(ss, metadata->database);
         ss << R"(","scn":)" << metadata->checkpointScn.toString() <<
@@ -138,6 +138,10 @@ namespace OpenLogReplicator {
         }
 
         ss << "]," SERIALIZER_ENDL;
+    }
+
+    void SerializerJson::serializeSchema(Metadata* metadata, std::ostringstream& ss, Scn scn, bool storeSchema) {
+        // Assuming the caller holds mtxSchema
 
         // The schema has not changed since the last checkpoint file
         if (!storeSchema) {
@@ -145,13 +149,13 @@ namespace OpenLogReplicator {
             return;
         }
 
-        metadata->schema->refScn = metadata->checkpointScn;
+        metadata->schema->refScn = scn;
         ss << R"("schema-scn":)" << metadata->schema->scn.toString() << "," SERIALIZER_ENDL;
 
         // SYS.CCOL$
         ss << R"("sys-ccol":[)";
-        hasPrev = false;
-        for (const auto& [_,sysCCol]: metadata->schema->sysCColPack.mapRowId) {
+        bool hasPrev = false;
+        for (const auto& [_,sysCCol]: metadata->schema->dict->sysCColPack.mapRowId) {
             if (hasPrev)
                 ss << ",";
             else
@@ -167,7 +171,7 @@ namespace OpenLogReplicator {
         // SYS.CDEF$
         ss << "]," SERIALIZER_ENDL << R"("sys-cdef":[)";
         hasPrev = false;
-        for (const auto& [_, sysCDef]: metadata->schema->sysCDefPack.mapRowId) {
+        for (const auto& [_, sysCDef]: metadata->schema->dict->sysCDefPack.mapRowId) {
             if (hasPrev)
                 ss << ",";
             else
@@ -182,7 +186,7 @@ namespace OpenLogReplicator {
         // SYS.COL$
         ss << "]," SERIALIZER_ENDL << R"("sys-col":[)";
         hasPrev = false;
-        for (const auto& [_, sysCol]: metadata->schema->sysColPack.mapRowId) {
+        for (const auto& [_, sysCol]: metadata->schema->dict->sysColPack.mapRowId) {
             if (hasPrev)
                 ss << ",";
             else
@@ -208,7 +212,7 @@ namespace OpenLogReplicator {
         // SYS.DEFERRED_STG$
         ss << "]," SERIALIZER_ENDL << R"("sys-deferredstg":[)";
         hasPrev = false;
-        for (const auto& [_, sysDeferredStg]: metadata->schema->sysDeferredStgPack.mapRowId) {
+        for (const auto& [_, sysDeferredStg]: metadata->schema->dict->sysDeferredStgPack.mapRowId) {
             if (hasPrev)
                 ss << ",";
             else
@@ -222,7 +226,7 @@ namespace OpenLogReplicator {
         // SYS.ECOL$
         ss << "]," SERIALIZER_ENDL << R"("sys-ecol":[)";
         hasPrev = false;
-        for (const auto& [_, sysECol]: metadata->schema->sysEColPack.mapRowId) {
+        for (const auto& [_, sysECol]: metadata->schema->dict->sysEColPack.mapRowId) {
             if (hasPrev)
                 ss << ",";
             else
@@ -237,7 +241,7 @@ namespace OpenLogReplicator {
         // SYS.LOB$
         ss << "]," SERIALIZER_ENDL << R"("sys-lob":[)";
         hasPrev = false;
-        for (const auto& [_, sysLob]: metadata->schema->sysLobPack.mapRowId) {
+        for (const auto& [_, sysLob]: metadata->schema->dict->sysLobPack.mapRowId) {
             if (hasPrev)
                 ss << ",";
             else
@@ -254,7 +258,7 @@ namespace OpenLogReplicator {
         // SYS.LOBCOMPPART$
         ss << "]," SERIALIZER_ENDL << R"("sys-lob-comp-part":[)";
         hasPrev = false;
-        for (const auto& [_, sysLobCompPart]: metadata->schema->sysLobCompPartPack.mapRowId) {
+        for (const auto& [_, sysLobCompPart]: metadata->schema->dict->sysLobCompPartPack.mapRowId) {
             if (hasPrev)
                 ss << ",";
             else
@@ -268,7 +272,7 @@ namespace OpenLogReplicator {
         // SYS.LOBFRAG$
         ss << "]," SERIALIZER_ENDL << R"("sys-lob-frag":[)";
         hasPrev = false;
-        for (const auto& [_, sysLobFrag]: metadata->schema->sysLobFragPack.mapRowId) {
+        for (const auto& [_, sysLobFrag]: metadata->schema->dict->sysLobFragPack.mapRowId) {
             if (hasPrev)
                 ss << ",";
             else
@@ -283,7 +287,7 @@ namespace OpenLogReplicator {
         // SYS.OBJ$
         ss << "]," SERIALIZER_ENDL << R"("sys-obj":[)";
         hasPrev = false;
-        for (const auto& [_, sysObj]: metadata->schema->sysObjPack.mapRowId) {
+        for (const auto& [_, sysObj]: metadata->schema->dict->sysObjPack.mapRowId) {
             if (hasPrev)
                 ss << ",";
             else
@@ -303,7 +307,7 @@ namespace OpenLogReplicator {
         // SYS.TAB$
         ss << "]," SERIALIZER_ENDL << R"("sys-tab":[)";
         hasPrev = false;
-        for (const auto& [_, sysTab]: metadata->schema->sysTabPack.mapRowId) {
+        for (const auto& [_, sysTab]: metadata->schema->dict->sysTabPack.mapRowId) {
             if (hasPrev)
                 ss << ",";
             else
@@ -321,7 +325,7 @@ namespace OpenLogReplicator {
         // SYS.TABCOMPART$
         ss << "]," SERIALIZER_ENDL << R"("sys-tabcompart":[)";
         hasPrev = false;
-        for (const auto& [_, sysTabComPart]: metadata->schema->sysTabComPartPack.mapRowId) {
+        for (const auto& [_, sysTabComPart]: metadata->schema->dict->sysTabComPartPack.mapRowId) {
             if (hasPrev)
                 ss << ",";
             else
@@ -336,7 +340,7 @@ namespace OpenLogReplicator {
         // SYS.TABPART$
         ss << "]," SERIALIZER_ENDL << R"("sys-tabpart":[)";
         hasPrev = false;
-        for (const auto& [_, sysTabPart]: metadata->schema->sysTabPartPack.mapRowId) {
+        for (const auto& [_, sysTabPart]: metadata->schema->dict->sysTabPartPack.mapRowId) {
             if (hasPrev)
                 ss << ",";
             else
@@ -351,7 +355,7 @@ namespace OpenLogReplicator {
         // SYS.TABSUBPART$
         ss << "]," SERIALIZER_ENDL << R"("sys-tabsubpart":[)";
         hasPrev = false;
-        for (const auto& [_, sysTabSubPart]: metadata->schema->sysTabSubPartPack.mapRowId) {
+        for (const auto& [_, sysTabSubPart]: metadata->schema->dict->sysTabSubPartPack.mapRowId) {
             if (hasPrev)
                 ss << ",";
             else
@@ -366,7 +370,7 @@ namespace OpenLogReplicator {
         // SYS.TS$
         ss << "]," SERIALIZER_ENDL << R"("sys-ts":[)";
         hasPrev = false;
-        for (const auto& [_, sysTs]: metadata->schema->sysTsPack.mapRowId) {
+        for (const auto& [_, sysTs]: metadata->schema->dict->sysTsPack.mapRowId) {
             if (hasPrev)
                 ss << ",";
             else
@@ -382,7 +386,7 @@ namespace OpenLogReplicator {
         // SYS.USER$
         ss << "]," SERIALIZER_ENDL << R"("sys-user":[)";
         hasPrev = false;
-        for (const auto& [_, sysUser]: metadata->schema->sysUserPack.mapRowId) {
+        for (const auto& [_, sysUser]: metadata->schema->dict->sysUserPack.mapRowId) {
             if (hasPrev)
                 ss << ",";
             else
@@ -399,7 +403,7 @@ namespace OpenLogReplicator {
         // XDB.XDB$TTSET
         ss << "]," SERIALIZER_ENDL << R"("xdb-ttset":[)";
         hasPrev = false;
-        for (const auto& [_, xdbTtSet]: metadata->schema->xdbTtSetPack.mapRowId) {
+        for (const auto& [_, xdbTtSet]: metadata->schema->dict->xdbTtSetPack.mapRowId) {
             if (hasPrev)
                 ss << ",";
             else
@@ -467,11 +471,14 @@ namespace OpenLogReplicator {
         ss << "]}";
     }
 
-    bool SerializerJson::deserialize(Metadata* metadata, const std::string& ss, const std::string& fileName, std::vector<std::string>& msgs,
+    bool SerializerJson::deserialize(Metadata* metadata, std::string_view ss, const std::string& fileName, std::vector<std::string>& msgs,
                                      std::unordered_map<typeObj, std::string>& tablesUpdated, bool loadMetadata, bool loadSchema) {
+        if (loadSchema)
+            metadata->schema->dictForUpdate();
+
         try {
             rapidjson::Document document;
-            if (unlikely(ss.empty() || document.Parse(ss.c_str()).HasParseError()))
+            if (unlikely(ss.empty() || document.Parse(ss.data(), ss.length()).HasParseError()))
                 throw DataException(20001, "file: " + fileName + " offset: " + std::to_string(document.GetErrorOffset()) +
                                            " - parse error: " + GetParseError_En(document.GetParseError()));
 
@@ -652,7 +659,7 @@ namespace OpenLogReplicator {
                     if (document.HasMember("xdb-ttset"))
                         deserializeXdbTtSet(metadata, fileName, Ctx::getJsonFieldA(fileName, document, "xdb-ttset"));
 
-                    for (const auto& [key, xdbTtSet]: metadata->schema->xdbTtSetPack.mapRowId) {
+                    for (const auto& [key, xdbTtSet]: metadata->schema->dict->xdbTtSetPack.mapRowId) {
                         auto* xmlCtx = new XmlCtx(metadata->ctx, xdbTtSet->tokSuf, xdbTtSet->flags);
                         metadata->schema->schemaXmlMap.insert_or_assign(xdbTtSet->tokSuf, xmlCtx);
 
@@ -696,7 +703,7 @@ namespace OpenLogReplicator {
             const uint64_t spare11 = Ctx::getJsonFieldU64(fileName, spare1Json, "spare1", 0);
             const uint64_t spare12 = Ctx::getJsonFieldU64(fileName, spare1Json, "spare1", 1);
 
-            metadata->schema->sysCColPack.addWithKeys(metadata->ctx, new SysCCol(RowId(rowIdStr), con, intCol, obj, spare11, spare12));
+            metadata->schema->dict->sysCColPack.addWithKeys(metadata->ctx, new SysCCol(RowId(rowIdStr), con, intCol, obj, spare11, spare12));
             metadata->schema->touchTable(obj);
         }
     }
@@ -713,7 +720,7 @@ namespace OpenLogReplicator {
             const typeObj obj = Ctx::getJsonFieldU32(fileName, sysCDefJson[i], "obj");
             const auto type = static_cast<SysCDef::CDEFTYPE>(Ctx::getJsonFieldU16(fileName, sysCDefJson[i], "type"));
 
-            metadata->schema->sysCDefPack.addWithKeys(metadata->ctx, new SysCDef(RowId(rowIdStr), con, obj, type));
+            metadata->schema->dict->sysCDefPack.addWithKeys(metadata->ctx, new SysCDef(RowId(rowIdStr), con, obj, type));
             metadata->schema->touchTable(obj);
         }
     }
@@ -745,7 +752,7 @@ namespace OpenLogReplicator {
             const uint64_t property1 = Ctx::getJsonFieldU64(fileName, propertyJson, "property", 0);
             const uint64_t property2 = Ctx::getJsonFieldU64(fileName, propertyJson, "property", 1);
 
-            metadata->schema->sysColPack.addWithKeys(metadata->ctx, new SysCol(RowId(rowIdStr), obj, col, segCol, intCol, name_, type, length, precision,
+            metadata->schema->dict->sysColPack.addWithKeys(metadata->ctx, new SysCol(RowId(rowIdStr), obj, col, segCol, intCol, name_, type, length, precision,
                                                                                scale, charsetForm, charsetId, null_, property1, property2));
             metadata->schema->touchTable(obj);
         }
@@ -767,7 +774,7 @@ namespace OpenLogReplicator {
             const uint64_t flagsStg1 = Ctx::getJsonFieldU64(fileName, flagsStgJson, "flags-stg", 0);
             const uint64_t flagsStg2 = Ctx::getJsonFieldU64(fileName, flagsStgJson, "flags-stg", 1);
 
-            metadata->schema->sysDeferredStgPack.addWithKeys(metadata->ctx, new SysDeferredStg(RowId(rowIdStr), obj, flagsStg1, flagsStg2));
+            metadata->schema->dict->sysDeferredStgPack.addWithKeys(metadata->ctx, new SysDeferredStg(RowId(rowIdStr), obj, flagsStg1, flagsStg2));
             metadata->schema->touchTable(obj);
         }
     }
@@ -784,7 +791,7 @@ namespace OpenLogReplicator {
             const typeCol colNum = Ctx::getJsonFieldI16(fileName, sysEColJson[i], "col-num");
             const typeCol guardId = Ctx::getJsonFieldI16(fileName, sysEColJson[i], "guard-id");
 
-            metadata->schema->sysEColPack.addWithKeys(metadata->ctx, new SysECol(RowId(rowIdStr), tabObj, colNum, guardId));
+            metadata->schema->dict->sysEColPack.addWithKeys(metadata->ctx, new SysECol(RowId(rowIdStr), tabObj, colNum, guardId));
             metadata->schema->touchTable(tabObj);
         }
     }
@@ -803,7 +810,7 @@ namespace OpenLogReplicator {
             const typeObj lObj = Ctx::getJsonFieldU32(fileName, sysLobJson[i], "l-obj");
             const uint32_t ts = Ctx::getJsonFieldU32(fileName, sysLobJson[i], "ts");
 
-            metadata->schema->sysLobPack.addWithKeys(metadata->ctx, new SysLob(RowId(rowIdStr), obj, col, intCol, lObj, ts));
+            metadata->schema->dict->sysLobPack.addWithKeys(metadata->ctx, new SysLob(RowId(rowIdStr), obj, col, intCol, lObj, ts));
             metadata->schema->touchTable(obj);
         }
     }
@@ -819,7 +826,7 @@ namespace OpenLogReplicator {
             const typeObj partObj = Ctx::getJsonFieldU32(fileName, sysLobCompPartJson[i], "part-obj");
             const typeObj lObj = Ctx::getJsonFieldU32(fileName, sysLobCompPartJson[i], "l-obj");
 
-            metadata->schema->sysLobCompPartPack.addWithKeys(metadata->ctx, new SysLobCompPart(RowId(rowIdStr), partObj, lObj));
+            metadata->schema->dict->sysLobCompPartPack.addWithKeys(metadata->ctx, new SysLobCompPart(RowId(rowIdStr), partObj, lObj));
             metadata->schema->touchTableLob(lObj);
         }
     }
@@ -836,7 +843,7 @@ namespace OpenLogReplicator {
             const typeObj parentObj = Ctx::getJsonFieldU32(fileName, sysLobFragJson[i], "parent-obj");
             const uint32_t ts = Ctx::getJsonFieldU32(fileName, sysLobFragJson[i], "ts");
 
-            metadata->schema->sysLobFragPack.addWithKeys(metadata->ctx, new SysLobFrag(RowId(rowIdStr), fragObj, parentObj, ts));
+            metadata->schema->dict->sysLobFragPack.addWithKeys(metadata->ctx, new SysLobFrag(RowId(rowIdStr), fragObj, parentObj, ts));
             metadata->schema->touchTableLobFrag(parentObj);
             metadata->schema->touchTableLob(parentObj);
         }
@@ -863,7 +870,7 @@ namespace OpenLogReplicator {
             const uint64_t flags2 = Ctx::getJsonFieldU64(fileName, flagsJson, "flags", 1);
             const uint64_t single = Ctx::getJsonFieldU64(fileName, sysObjJson[i], "single");
 
-            metadata->schema->sysObjPack.addWithKeys(metadata->ctx, new SysObj(RowId(rowIdStr), owner, obj, dataObj, type, name_, flags1, flags2,
+            metadata->schema->dict->sysObjPack.addWithKeys(metadata->ctx, new SysObj(RowId(rowIdStr), owner, obj, dataObj, type, name_, flags1, flags2,
                                                                                single != 0U));
             metadata->schema->touchTable(obj);
         }
@@ -897,7 +904,7 @@ namespace OpenLogReplicator {
             const uint64_t property1 = Ctx::getJsonFieldU64(fileName, propertyJson, "property", 0);
             const uint64_t property2 = Ctx::getJsonFieldU64(fileName, propertyJson, "property", 1);
 
-            metadata->schema->sysTabPack.addWithKeys(metadata->ctx, new SysTab(RowId(rowIdStr), obj, dataObj, ts, cluCols, flags1, flags2, property1,
+            metadata->schema->dict->sysTabPack.addWithKeys(metadata->ctx, new SysTab(RowId(rowIdStr), obj, dataObj, ts, cluCols, flags1, flags2, property1,
                                                                                property2));
             metadata->schema->touchTable(obj);
         }
@@ -915,7 +922,7 @@ namespace OpenLogReplicator {
             const typeDataObj dataObj = Ctx::getJsonFieldU32(fileName, sysTabComPartJson[i], "data-obj");
             const typeObj bo = Ctx::getJsonFieldU32(fileName, sysTabComPartJson[i], "bo");
 
-            metadata->schema->sysTabComPartPack.addWithKeys(metadata->ctx, new SysTabComPart(RowId(rowIdStr), obj, dataObj, bo));
+            metadata->schema->dict->sysTabComPartPack.addWithKeys(metadata->ctx, new SysTabComPart(RowId(rowIdStr), obj, dataObj, bo));
             metadata->schema->touchTable(bo);
         }
     }
@@ -932,7 +939,7 @@ namespace OpenLogReplicator {
             const typeDataObj dataObj = Ctx::getJsonFieldU32(fileName, sysTabPartJson[i], "data-obj");
             const typeObj bo = Ctx::getJsonFieldU32(fileName, sysTabPartJson[i], "bo");
 
-            metadata->schema->sysTabPartPack.addWithKeys(metadata->ctx, new SysTabPart(RowId(rowIdStr), obj, dataObj, bo));
+            metadata->schema->dict->sysTabPartPack.addWithKeys(metadata->ctx, new SysTabPart(RowId(rowIdStr), obj, dataObj, bo));
             metadata->schema->touchTable(bo);
         }
     }
@@ -949,7 +956,7 @@ namespace OpenLogReplicator {
             const typeDataObj dataObj = Ctx::getJsonFieldU32(fileName, sysTabSubPartJson[i], "data-obj");
             const typeObj pObj = Ctx::getJsonFieldU32(fileName, sysTabSubPartJson[i], "p-obj");
 
-            metadata->schema->sysTabSubPartPack.addWithKeys(metadata->ctx, new SysTabSubPart(RowId(rowIdStr), obj, dataObj, pObj));
+            metadata->schema->dict->sysTabSubPartPack.addWithKeys(metadata->ctx, new SysTabSubPart(RowId(rowIdStr), obj, dataObj, pObj));
             metadata->schema->touchTablePart(obj);
         }
     }
@@ -966,7 +973,7 @@ namespace OpenLogReplicator {
             const std::string name_ = Ctx::getJsonFieldS(fileName, SysTs::NAME_LENGTH, sysTsJson[i], "name");
             const uint32_t blockSize = Ctx::getJsonFieldU32(fileName, sysTsJson[i], "block-size");
 
-            metadata->schema->sysTsPack.addWithKeys(metadata->ctx, new SysTs(RowId(rowIdStr), ts, name_, blockSize));
+            metadata->schema->dict->sysTsPack.addWithKeys(metadata->ctx, new SysTs(RowId(rowIdStr), ts, name_, blockSize));
         }
     }
 
@@ -988,7 +995,7 @@ namespace OpenLogReplicator {
             const uint64_t spare12 = Ctx::getJsonFieldU64(fileName, spare1Json, "spare1", 1);
             const uint64_t single = Ctx::getJsonFieldU64(fileName, sysUserJson[i], "single");
 
-            metadata->schema->sysUserPack.addWithKeys(metadata->ctx, new SysUser(RowId(rowIdStr), user, name_, spare11, spare12, single != 0U));
+            metadata->schema->dict->sysUserPack.addWithKeys(metadata->ctx, new SysUser(RowId(rowIdStr), user, name_, spare11, spare12, single != 0U));
         }
     }
 
@@ -1005,7 +1012,7 @@ namespace OpenLogReplicator {
             const uint64_t flags = Ctx::getJsonFieldU64(fileName, xdbTtSetJson[i], "flags");
             const uint32_t obj = Ctx::getJsonFieldU32(fileName, xdbTtSetJson[i], "obj");
 
-            metadata->schema->xdbTtSetPack.addWithKeys(metadata->ctx, new XdbTtSet(RowId(rowIdStr), guid, tokSuf, flags, obj));
+            metadata->schema->dict->xdbTtSetPack.addWithKeys(metadata->ctx, new XdbTtSet(RowId(rowIdStr), guid, tokSuf, flags, obj));
         }
     }
 
@@ -59,9 +59,10 @@ namespace OpenLogReplicator {
         SerializerJson(const SerializerJson&) = delete;
         SerializerJson& operator=(const SerializerJson&) = delete;
 
-        [[nodiscard]] bool deserialize(Metadata* metadata, const std::string& ss, const std::string& fileName, std::vector<std::string>& msgs,
+        [[nodiscard]] bool deserialize(Metadata* metadata, std::string_view ss, const std::string& fileName, std::vector<std::string>& msgs,
                                        std::unordered_map<typeObj, std::string>& tablesUpdated, bool loadMetadata, bool loadSchema) override;
-        void serialize(Metadata* metadata, std::ostringstream& ss, bool storeSchema) override;
+        void serializeMetadata(Metadata* metadata, std::ostringstream& ss) override;
+        void serializeSchema(Metadata* metadata, std::ostringstream& ss, Scn scn, bool storeSchema) override;
     };
 }
 
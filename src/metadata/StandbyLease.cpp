@@ -0,0 +1,143 @@
+/* Lease of the output shared by the instances of one source
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <sstream>
+#include <utility>
+
+#include "../common/Ctx.h"
+#include "../common/exception/DataException.h"
+#include "../common/exception/RuntimeException.h"
+#include "../common/types/Data.h"
+#include "../state/State.h"
+#include "StandbyLease.h"
+
+namespace OpenLogReplicator {
+    StandbyLease::StandbyLease(Ctx* newCtx, State* newState, const std::string& database, std::string newOwner, uint64_t newLeaseS) :
+            ctx(newCtx),
+            state(newState),
+            name(database + "-lease"),
+            writerNames{database + "-chkpt"},
+            owner(std::move(newOwner)),
+            leaseS(newLeaseS) {
+    }
+
+    // The default name is replaced by the names given to the writers
+    void StandbyLease::addWriter(const std::string& checkpointName) {
+        if (!writersAdded) {
+            writerNames.clear();
+            writersAdded = true;
+        }
+        writerNames.push_back(checkpointName);
+    }
+
+    bool StandbyLease::read(std::string& leaseOwner, time_t& leaseTime) const {
+        std::string ss;
+        if (!state->read(name, LEASE_FILE_MAX_SIZE, ss))
+            return false;
+
+        rapidjson::Document document;
+        if (unlikely(ss.empty() || document.Parse(ss.c_str()).HasParseError()))
+            throw DataException(20001, "file: " + name + " offset: " + std::to_string(document.GetErrorOffset()) +
+                                       " - parse error: " + GetParseError_En(document.GetParseError()));
+
+        leaseOwner = Ctx::getJsonFieldS(name, Ctx::JSON_PARAMETER_LENGTH, document, "owner");
+        leaseTime = static_cast<time_t>(Ctx::getJsonFieldU64(name, document, "time"));
+        return true;
+    }
+
+    void StandbyLease::write(time_t now) {
+        std::ostringstream ss;
+        ss << R"({"owner":")";
+        Data::writeEscapeValue(ss, owner);
+        ss << R"(","time":)" << std::dec << now << "}";
+        state->write(name, Scn::zero(), ss);
+    }
+
+    // Taken when nobody holds it or the holder has not renewed it in time. Read back after the write, of two instances taking
+    // over at once only the one written last goes on
+    bool StandbyLease::acquire(time_t now) {
+        try {
+            std::string leaseOwner;
+            time_t leaseTime;
+            if (read(leaseOwner, leaseTime) && leaseOwner != owner && now < leaseTime + static_cast<time_t>(leaseS)) {
+                holder = leaseOwner;
+                return false;
+            }
+
+            write(now);
+            if (!read(leaseOwner, leaseTime) || leaseOwner != owner) {
+                holder = leaseOwner;
+                return false;
+            }
+        } catch (DataException& ex) {
+            ctx->error(ex.code, ex.msg);
+            return false;
+        } catch (RuntimeException& ex) {
+            ctx->error(ex.code, ex.msg);
+            return false;
+        }
+        holder = owner;
+        return true;
+    }
+
+    // False only when another instance took the lease over, a state which can't be read keeps the current holder
+    bool StandbyLease::renew(time_t now) {
+        try {
+            std::string leaseOwner;
+            time_t leaseTime;
+            if (read(leaseOwner, leaseTime) && leaseOwner != owner) {
+                holder = leaseOwner;
+                return false;
+            }
+            write(now);
+        } catch (DataException& ex) {
+            ctx->error(ex.code, ex.msg);
+        } catch (RuntimeException& ex) {
+            ctx->error(ex.code, ex.msg);
+        }
+        return true;
+    }
+
+    // Position confirmed by the clients of the holder, taken from the checkpoints of its writers. Until every writer has written one
+    // nothing is known to be confirmed
+    Scn StandbyLease::confirmedScn() const {
+        try {
+            Scn scn = Scn::none();
+            for (const std::string& writerName: writerNames) {
+                std::string ss;
+                if (!state->read(writerName, CHECKPOINT_FILE_MAX_SIZE, ss))
+                    return Scn::none();
+
+                rapidjson::Document document;
+                if (unlikely(ss.empty() || document.Parse(ss.c_str()).HasParseError()))
+                    throw DataException(20001, "file: " + writerName + " offset: " + std::to_string(document.GetErrorOffset()) +
+                                               " - parse error: " + GetParseError_En(document.GetParseError()));
+                const Scn writerScn(Ctx::getJsonFieldU64(writerName, document, "scn"));
+                if (scn == Scn::none() || writerScn < scn)
+                    scn = writerScn;
+            }
+            return scn;
+        } catch (DataException& ex) {
+            ctx->error(ex.code, ex.msg);
+        } catch (RuntimeException& ex) {
+            ctx->error(ex.code, ex.msg);
+        }
+        return Scn::none();
+    }
+}
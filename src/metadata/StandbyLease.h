@@ -0,0 +1,67 @@
+/* Header for StandbyLease class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef STANDBY_LEASE_H_
+#define STANDBY_LEASE_H_
+
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "../common/types/Scn.h"
+
+namespace OpenLogReplicator {
+    class Ctx;
+    class State;
+
+    // Lease kept in the state shared by the instances of one source. The holder produces the output and renews the lease, the
+    // others stay standby: they parse behind the position confirmed by the holder without output and take over when the lease is
+    // not renewed in time. The lease is a plain state entry compared by wall clock time, not a consensus protocol, the clocks of
+    // the hosts must be synchronized
+    class StandbyLease final {
+    protected:
+        static constexpr uint64_t LEASE_FILE_MAX_SIZE{4096};
+        static constexpr uint64_t CHECKPOINT_FILE_MAX_SIZE{1024};
+
+        Ctx* ctx;
+        State* state;
+        std::string name;
+        // Checkpoints of all writers of the source, the standby stays behind the lowest of them
+        std::vector<std::string> writerNames;
+        bool writersAdded{false};
+
+        [[nodiscard]] bool read(std::string& leaseOwner, time_t& leaseTime) const;
+        void write(time_t now);
+
+    public:
+        const std::string owner;
+        const uint64_t leaseS;
+        // Holder seen by the last failed acquire or renewal
+        std::string holder;
+
+        StandbyLease(Ctx* newCtx, State* newState, const std::string& database, std::string newOwner, uint64_t newLeaseS);
+
+        void addWriter(const std::string& checkpointName);
+        [[nodiscard]] bool acquire(time_t now);
+        [[nodiscard]] bool renew(time_t now);
+        [[nodiscard]] Scn confirmedScn() const;
+    };
+}
+
+#endif
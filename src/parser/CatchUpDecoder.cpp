@@ -0,0 +1,153 @@
+/* Thread decoding archived redo logs ahead of the parser
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <thread>
+
+#include "../common/Ctx.h"
+#include "../common/exception/RuntimeException.h"
+#include "../reader/Reader.h"
+#include "CatchUpDecoder.h"
+#include "Parser.h"
+
+namespace OpenLogReplicator {
+    CatchUpDecoder::CatchUpDecoder(Ctx* newCtx, std::string newAlias, Parser* newParser) :
+            Thread(newCtx, std::move(newAlias)),
+            parser(newParser) {
+    }
+
+    CatchUpDecoder::~CatchUpDecoder() {
+        for (DecodedLwn* lwn: queue)
+            release(lwn);
+        queue.clear();
+
+        delete parser;
+        parser = nullptr;
+    }
+
+    void CatchUpDecoder::release(DecodedLwn* lwn) {
+        for (uint8_t* chunk: lwn->chunks)
+            ctx->freeMemoryChunk(ctx->parserThread, Ctx::MEMORY::PARSER, chunk);
+        delete lwn;
+    }
+
+    // Waits when the queue is full, returns false when the decoding is stopped and the LWN was dropped
+    bool CatchUpDecoder::push(Thread* t, DecodedLwn* lwn) {
+        {
+            t->contextSet(CONTEXT::MUTEX, REASON::CATCH_UP_DECODER);
+            std::unique_lock<std::mutex> lck(mtx);
+            while (!stopped && !ctx->softShutdown && queueChunks > 0 && queueChunks + lwn->chunks.size() > QUEUE_CHUNKS_MAX) {
+                t->contextSet(CONTEXT::WAIT, REASON::CATCH_UP_DECODER_FULL);
+                condFree.wait_for(lck, std::chrono::milliseconds(100));
+            }
+
+            if (!stopped && !ctx->softShutdown) {
+                queueChunks += lwn->chunks.size();
+                queue.push_back(lwn);
+                condQueue.notify_all();
+                t->contextSet(CONTEXT::CPU);
+                return true;
+            }
+        }
+        t->contextSet(CONTEXT::CPU);
+        release(lwn);
+        return false;
+    }
+
+    // Passes the next LWN to the parser of the log, returns false when all were taken and sets the position where the log ended
+    bool CatchUpDecoder::take(Thread* t, Parser* consumer, typeBlk& lwnEndBlock) {
+        DecodedLwn* lwn;
+        {
+            t->contextSet(CONTEXT::MUTEX, REASON::CATCH_UP_DECODER);
+            std::unique_lock<std::mutex> lck(mtx);
+            while (queue.empty()) {
+                if (finished) {
+                    t->contextSet(CONTEXT::CPU);
+                    if (error != nullptr)
+                        std::rethrow_exception(error);
+                    lwnEndBlock = endBlock;
+                    return false;
+                }
+                if (ctx->softShutdown) {
+                    t->contextSet(CONTEXT::CPU);
+                    return false;
+                }
+                t->contextSet(CONTEXT::WAIT, REASON::CATCH_UP_DECODER_EMPTY);
+                condQueue.wait_for(lck, std::chrono::milliseconds(100));
+            }
+
+            lwn = queue.front();
+            queue.pop_front();
+            queueChunks -= lwn->chunks.size();
+            condFree.notify_all();
+        }
+        t->contextSet(CONTEXT::CPU);
+
+        lwnEndBlock = lwn->endBlock;
+        consumer->adoptLwn(lwn);
+        delete lwn;
+        return true;
+    }
+
+    void CatchUpDecoder::stop() {
+        std::unique_lock<std::mutex> const lck(mtx);
+        stopped = true;
+        condFree.notify_all();
+    }
+
+    bool CatchUpDecoder::isStopped() {
+        std::unique_lock<std::mutex> const lck(mtx);
+        return stopped;
+    }
+
+    void CatchUpDecoder::wakeUp() {
+        std::unique_lock<std::mutex> const lck(mtx);
+        condQueue.notify_all();
+        condFree.notify_all();
+    }
+
+    void CatchUpDecoder::run() {
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
+            std::ostringstream ss;
+            ss << std::this_thread::get_id();
+            ctx->logTrace(Ctx::TRACE::THREADS, "catch-up decoder (" + ss.str() + ") start");
+        }
+
+        typeBlk lastBlock = 0;
+        std::exception_ptr runError;
+        try {
+            lastBlock = parser->decodeAhead(this, this);
+        } catch (...) {
+            runError = std::current_exception();
+        }
+
+        {
+            std::unique_lock<std::mutex> const lck(mtx);
+            endBlock = lastBlock;
+            error = runError;
+            finished = true;
+            condQueue.notify_all();
+        }
+
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
+            std::ostringstream ss;
+            ss << std::this_thread::get_id();
+            ctx->logTrace(Ctx::TRACE::THREADS, "catch-up decoder (" + ss.str() + ") stop");
+        }
+    }
+}
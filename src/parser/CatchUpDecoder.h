@@ -0,0 +1,74 @@
+/* Header for CatchUpDecoder class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef CATCH_UP_DECODER_H_
+#define CATCH_UP_DECODER_H_
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+
+#include "../common/Thread.h"
+#include "../common/types/Types.h"
+
+namespace OpenLogReplicator {
+    class Parser;
+    struct DecodedLwn;
+
+    // Thread assembling and decoding the LWNs of an archived redo log read ahead, while the parser is still busy with an earlier
+    // log. Several logs are decoded at once during the catch-up, the parser takes the LWNs in order and only applies them to the
+    // transactions, so that the transaction buffer sees the same sequence of changes as when parsing serially
+    class CatchUpDecoder final : public Thread {
+    protected:
+        // Memory chunks held by the queued LWNs, bounds how far decoding runs ahead of the parser
+        static constexpr uint64_t QUEUE_CHUNKS_MAX{32};
+
+        Parser* parser;
+        std::mutex mtx;
+        std::condition_variable condQueue;
+        std::condition_variable condFree;
+        std::deque<DecodedLwn*> queue;
+        uint64_t queueChunks{0};
+        typeBlk endBlock{0};
+        // First error of the decoding, thrown to the parser thread after the LWNs decoded before
+        std::exception_ptr error;
+        bool stopped{false};
+        bool finished{false};
+
+        void run() override;
+        void release(DecodedLwn* lwn);
+
+    public:
+        CatchUpDecoder(Ctx* newCtx, std::string newAlias, Parser* newParser);
+        ~CatchUpDecoder() override;
+
+        bool push(Thread* t, DecodedLwn* lwn);
+        bool take(Thread* t, Parser* consumer, typeBlk& lwnEndBlock);
+        void stop();
+        [[nodiscard]] bool isStopped();
+        void wakeUp() override;
+
+        std::string getName() const override {
+            return {"CatchUpDecoder: " + alias};
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,155 @@
+/* Thread pool decoding LWN records
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <thread>
+
+#include "../common/exception/RuntimeException.h"
+#include "LwnDecoder.h"
+#include "Parser.h"
+
+namespace OpenLogReplicator {
+    LwnDecoder::LwnDecoder(Ctx* newCtx, std::string newAlias, LwnDecoderPool* newPool, uint newWorker) :
+            Thread(newCtx, std::move(newAlias)),
+            pool(newPool),
+            worker(newWorker) {
+    }
+
+    void LwnDecoder::wakeUp() {
+        pool->wakeUp();
+    }
+
+    void LwnDecoder::run() {
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
+            std::ostringstream ss;
+            ss << std::this_thread::get_id();
+            ctx->logTrace(Ctx::TRACE::THREADS, "lwn decoder (" + ss.str() + ") start");
+        }
+
+        try {
+            pool->work(this, worker);
+        } catch (RuntimeException& ex) {
+            ctx->error(ex.code, ex.msg);
+            ctx->stopHard();
+        }
+
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
+            std::ostringstream ss;
+            ss << std::this_thread::get_id();
+            ctx->logTrace(Ctx::TRACE::THREADS, "lwn decoder (" + ss.str() + ") stop");
+        }
+    }
+
+    LwnDecoderPool::LwnDecoderPool(Ctx* newCtx, const std::string& alias, uint threads) :
+            ctx(newCtx) {
+        for (uint worker = 1; worker <= threads; ++worker)
+            decoders.push_back(new LwnDecoder(ctx, alias + "-decoder-" + std::to_string(worker), this, worker));
+    }
+
+    LwnDecoderPool::~LwnDecoderPool() {
+        {
+            std::unique_lock<std::mutex> const lck(mtx);
+            stopped = true;
+            condJob.notify_all();
+        }
+        for (LwnDecoder* decoder: decoders) {
+            ctx->finishThread(decoder);
+            delete decoder;
+        }
+        decoders.clear();
+    }
+
+    void LwnDecoderPool::initialize() {
+        for (LwnDecoder* decoder: decoders)
+            ctx->spawnThread(decoder);
+    }
+
+    void LwnDecoderPool::wakeUp() {
+        std::unique_lock<std::mutex> const lck(mtx);
+        condJob.notify_all();
+        condDone.notify_all();
+    }
+
+    uint LwnDecoderPool::getWorkers() const {
+        return decoders.size();
+    }
+
+    void LwnDecoderPool::decodeJob(uint worker) {
+        for (uint64_t num = jobNext.fetch_add(1); num < jobCount; num = jobNext.fetch_add(1))
+            jobParser->decodeLwn(num, worker);
+    }
+
+    void LwnDecoderPool::decode(Thread* t, Parser* parser, uint64_t count) {
+        {
+            t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::PARSER_DECODE);
+            std::unique_lock<std::mutex> const lck(mtx);
+            jobParser = parser;
+            jobCount = count;
+            jobNext = 0;
+            ++jobId;
+            condJob.notify_all();
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
+
+        decodeJob(0);
+
+        {
+            t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::PARSER_DECODE);
+            std::unique_lock<std::mutex> lck(mtx);
+            while (jobActive > 0) {
+                t->contextSet(Thread::CONTEXT::WAIT, Thread::REASON::PARSER_DECODE);
+                condDone.wait(lck);
+            }
+            jobParser = nullptr;
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
+    }
+
+    void LwnDecoderPool::work(LwnDecoder* decoder, uint worker) {
+        uint64_t lastJobId = 0;
+
+        while (!ctx->softShutdown && !stopped) {
+            {
+                decoder->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::PARSER_DECODE);
+                std::unique_lock<std::mutex> lck(mtx);
+                while (!ctx->softShutdown && !stopped && (jobParser == nullptr || jobId == lastJobId)) {
+                    if (unlikely(ctx->isTraceSet(Ctx::TRACE::SLEEP)))
+                        ctx->logTrace(Ctx::TRACE::SLEEP, "LwnDecoder:work");
+                    decoder->contextSet(Thread::CONTEXT::WAIT, Thread::REASON::PARSER_DECODE_NO_WORK);
+                    condJob.wait(lck);
+                }
+                if (ctx->softShutdown || stopped)
+                    break;
+                lastJobId = jobId;
+                ++jobActive;
+            }
+            decoder->contextSet(Thread::CONTEXT::CPU);
+
+            decodeJob(worker);
+
+            {
+                decoder->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::PARSER_DECODE);
+                std::unique_lock<std::mutex> const lck(mtx);
+                if (--jobActive == 0)
+                    condDone.notify_all();
+            }
+            decoder->contextSet(Thread::CONTEXT::CPU);
+        }
+        decoder->contextSet(Thread::CONTEXT::CPU);
+    }
+}
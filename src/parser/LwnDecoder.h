@@ -0,0 +1,85 @@
+/* Header for LwnDecoder class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef LWN_DECODER_H_
+#define LWN_DECODER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include "../common/Thread.h"
+
+namespace OpenLogReplicator {
+    class LwnDecoderPool;
+    class Parser;
+
+    // Worker thread decoding records of one LWN on behalf of the parser
+    class LwnDecoder final : public Thread {
+    protected:
+        LwnDecoderPool* pool;
+        uint worker;
+
+        void run() override;
+
+    public:
+        LwnDecoder(Ctx* newCtx, std::string newAlias, LwnDecoderPool* newPool, uint newWorker);
+
+        void wakeUp() override;
+
+        std::string getName() const override {
+            return {"LwnDecoder: " + alias};
+        }
+    };
+
+    // Decoding is shared by the workers and the parser thread itself, which never waits for a record nobody has started
+    class LwnDecoderPool final {
+    public:
+        // Smaller LWNs are decoded by the parser thread alone
+        static constexpr uint64_t MIN_PARALLEL_MEMBERS{16};
+
+    protected:
+        Ctx* ctx;
+        std::vector<LwnDecoder*> decoders;
+        std::mutex mtx;
+        std::condition_variable condJob;
+        std::condition_variable condDone;
+        Parser* jobParser{nullptr};
+        uint64_t jobId{0};
+        uint64_t jobCount{0};
+        std::atomic<uint64_t> jobNext{0};
+        uint jobActive{0};
+        bool stopped{false};
+
+        void decodeJob(uint worker);
+
+    public:
+        LwnDecoderPool(Ctx* newCtx, const std::string& alias, uint threads);
+        ~LwnDecoderPool();
+
+        void initialize();
+        void wakeUp();
+        [[nodiscard]] uint getWorkers() const;
+        void decode(Thread* t, Parser* parser, uint64_t count);
+        void work(LwnDecoder* decoder, uint worker);
+    };
+}
+
+#endif
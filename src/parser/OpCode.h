@@ -20,6 +20,7 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include <algorithm>
 #include <cstring>
 
+#include "../common/Ctx.h"
 #include "../common/RedoLogRecord.h"
 #include "../common/types/Types.h"
 
@@ -27,9 +28,68 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #define OP_CODE_H_
 
 namespace OpenLogReplicator {
-    class Ctx;
     class RedoLogRecord;
 
+    // Byte order and redo log dump are fixed for the whole run, the decoders are instantiated for each combination
+    // so that field reads don't test them again for every field
+    template<bool BIG_ENDIAN_MODE, bool DUMP_MODE>
+    struct OpCodeMode final {
+        static constexpr bool bigEndian = BIG_ENDIAN_MODE;
+        static constexpr bool dump = DUMP_MODE;
+
+        static uint16_t read16(const uint8_t* buf) {
+            if constexpr (bigEndian)
+                return Ctx::read16Big(buf);
+            return Ctx::read16Little(buf);
+        }
+
+        static uint32_t read32(const uint8_t* buf) {
+            if constexpr (bigEndian)
+                return Ctx::read32Big(buf);
+            return Ctx::read32Little(buf);
+        }
+
+        static uint64_t read56(const uint8_t* buf) {
+            if constexpr (bigEndian)
+                return Ctx::read56Big(buf);
+            return Ctx::read56Little(buf);
+        }
+
+        static uint64_t read64(const uint8_t* buf) {
+            if constexpr (bigEndian)
+                return Ctx::read64Big(buf);
+            return Ctx::read64Little(buf);
+        }
+
+        static Scn readScn(const uint8_t* buf) {
+            if constexpr (bigEndian)
+                return Ctx::readScnBig(buf);
+            return Ctx::readScnLittle(buf);
+        }
+
+        static Scn readScnR(const uint8_t* buf) {
+            if constexpr (bigEndian)
+                return Ctx::readScnRBig(buf);
+            return Ctx::readScnRLittle(buf);
+        }
+    };
+
+    // For the few decoder calls outside of the vector loop, where the mode is not known at compile time
+    template<typename Call>
+    void opCodeModeCall(const Ctx* ctx, Call call) {
+        if (ctx->isBigEndian()) {
+            if (unlikely(ctx->dumpRedoLog >= 1))
+                call(OpCodeMode<true, true>());
+            else
+                call(OpCodeMode<true, false>());
+        } else {
+            if (unlikely(ctx->dumpRedoLog >= 1))
+                call(OpCodeMode<false, true>());
+            else
+                call(OpCodeMode<false, false>());
+        }
+    }
+
     class OpCode {
     public:
         static constexpr uint16_t FLG_MULTIBLOCKUNDOHEAD{0x0001};
@@ -115,11 +175,12 @@ namespace OpenLogReplicator {
 
         static constexpr uint8_t OPFLAG_BEGIN_TRANS{0x01};
 
+        template<typename Mode>
         static void ktbRedo(const Ctx* ctx, RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize)  {
             if (fieldSize < 8)
                 return;
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 if (redoLogRecord->opc == 0x0A16)
                     *ctx->dumpStream << "index undo for leaf key operations\n";
                 else if (redoLogRecord->opc == 0x0B01)
@@ -129,7 +190,7 @@ namespace OpenLogReplicator {
             const auto ktbOp = *redoLogRecord->data(fieldPos + 0);
             const uint8_t flg = *redoLogRecord->data(fieldPos + 1);
             const uint8_t ver = flg & 0x03;
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 *ctx->dumpStream << "KTB Redo \n";
                 *ctx->dumpStream << "op: 0x" << std::setfill('0') << std::setw(2) << std::hex << static_cast<int>(ktbOp) << " " <<
                                  " ver: 0x" << std::setfill('0') << std::setw(2) << std::hex << static_cast<uint>(ver) << "  \n";
@@ -154,15 +215,15 @@ namespace OpenLogReplicator {
                     throw RedoLogException(50061, "too short field KTP Redo C: " + std::to_string(fieldSize) + " offset: " +
                                                   redoLogRecord->fileOffset.toString());
 
-                if (unlikely(ctx->dumpRedoLog >= 1)) {
-                    const typeUba uba = ctx->read56(redoLogRecord->data(fieldPos + startPos));
+                if constexpr (Mode::dump) {
+                    const typeUba uba = Mode::read56(redoLogRecord->data(fieldPos + startPos));
                     *ctx->dumpStream << "op: " << opCode << " " << " uba: " << PRINTUBA(uba) << '\n';
                 }
 
             } else if ((ktbOp & 0x0F) == KTBOP_Z) {
                 opCode = 'Z';
 
-                if (unlikely(ctx->dumpRedoLog >= 1)) {
+                if constexpr (Mode::dump) {
                     *ctx->dumpStream << "op: " << opCode << '\n';
                 }
 
@@ -173,11 +234,11 @@ namespace OpenLogReplicator {
                     throw RedoLogException(50061, "too short field KTP Redo L2: " + std::to_string(fieldSize) + " offset: " +
                                                   redoLogRecord->fileOffset.toString());
 
-                if (unlikely(ctx->dumpRedoLog >= 1)) {
-                    const Xid itlXid = Xid(static_cast<typeUsn>(ctx->read16(redoLogRecord->data(fieldPos + startPos))),
-                                                   ctx->read16(redoLogRecord->data(fieldPos + startPos + 2)),
-                                                   ctx->read32(redoLogRecord->data(fieldPos + startPos + 4)));
-                    const typeUba uba = ctx->read56(redoLogRecord->data(fieldPos + startPos + 8));
+                if constexpr (Mode::dump) {
+                    const Xid itlXid = Xid(static_cast<typeUsn>(Mode::read16(redoLogRecord->data(fieldPos + startPos))),
+                                                   Mode::read16(redoLogRecord->data(fieldPos + startPos + 2)),
+                                                   Mode::read32(redoLogRecord->data(fieldPos + startPos + 4)));
+                    const typeUba uba = Mode::read56(redoLogRecord->data(fieldPos + startPos + 8));
 
                     *ctx->dumpStream << "op: " << opCode << " " <<
                                      " itl:" <<
@@ -186,7 +247,7 @@ namespace OpenLogReplicator {
 
                     uint8_t lkc;
                     uint8_t flag;
-                    if (ctx->isBigEndian()) {
+                    if constexpr (Mode::bigEndian) {
                         lkc = *redoLogRecord->data(fieldPos + startPos + 17);
                         flag = *redoLogRecord->data(fieldPos + startPos + 16);
                     } else {
@@ -202,7 +263,7 @@ namespace OpenLogReplicator {
                         flagStr[1] = 'B';
                     if ((flag & 0x80) != 0)
                         flagStr[0] = 'C';
-                    const Scn scnx = ctx->readScnR(redoLogRecord->data(fieldPos + startPos + 18));
+                    const Scn scnx = Mode::readScnR(redoLogRecord->data(fieldPos + startPos + 18));
 
                     if (ctx->version < RedoLogRecord::REDO_VERSION_12_2)
                         *ctx->dumpStream << "                     " <<
@@ -219,8 +280,8 @@ namespace OpenLogReplicator {
             } else if ((ktbOp & 0x0F) == KTBOP_R) {
                 opCode = 'R';
 
-                if (unlikely(ctx->dumpRedoLog >= 1)) {
-                    int16_t itc = ctx->read16(redoLogRecord->data(fieldPos + startPos + 2));
+                if constexpr (Mode::dump) {
+                    int16_t itc = Mode::read16(redoLogRecord->data(fieldPos + startPos + 2));
                     *ctx->dumpStream << "op: " << opCode << "  itc: " << std::dec << itc << '\n';
                     itc = std::max<int>(itc, 0);
 
@@ -230,15 +291,15 @@ namespace OpenLogReplicator {
 
                     *ctx->dumpStream << " Itl           Xid                  Uba         Flag  Lck        Scn/Fsc\n";
                     for (int16_t i = 0; i < itc; ++i) {
-                        const Xid itcXid = Xid(static_cast<typeUsn>(ctx->read16(redoLogRecord->data(fieldPos + startPos + 12 + (i * 24)))),
-                                                       ctx->read16(redoLogRecord->data(fieldPos + startPos + 12 + 2 + (i * 24))),
-                                                       ctx->read32(redoLogRecord->data(fieldPos + startPos + 12 + 4 + (i * 24))));
+                        const Xid itcXid = Xid(static_cast<typeUsn>(Mode::read16(redoLogRecord->data(fieldPos + startPos + 12 + (i * 24)))),
+                                                       Mode::read16(redoLogRecord->data(fieldPos + startPos + 12 + 2 + (i * 24))),
+                                                       Mode::read32(redoLogRecord->data(fieldPos + startPos + 12 + 4 + (i * 24))));
 
-                        const typeUba itcUba = ctx->read56(redoLogRecord->data(fieldPos + startPos + 12 + 8 + (i * 24)));
+                        const typeUba itcUba = Mode::read56(redoLogRecord->data(fieldPos + startPos + 12 + 8 + (i * 24)));
                         char flagsStr[5]{"----"};
                         Scn scnfsc;
                         std::string scnfscStr = "fsc";
-                        uint16_t lck = ctx->read16(redoLogRecord->data(fieldPos + startPos + 12 + 16 + (i * 24)));
+                        uint16_t lck = Mode::read16(redoLogRecord->data(fieldPos + startPos + 12 + 16 + (i * 24)));
                         if ((lck & 0x1000) != 0)
                             flagsStr[3] = 'T';
                         if ((lck & 0x2000) != 0)
@@ -249,10 +310,10 @@ namespace OpenLogReplicator {
                             flagsStr[0] = 'C';
                             scnfscStr = "scn";
                             lck = 0;
-                            scnfsc = ctx->readScn(redoLogRecord->data(fieldPos + startPos + 12 + 18 + (i * 24)));
+                            scnfsc = Mode::readScn(redoLogRecord->data(fieldPos + startPos + 12 + 18 + (i * 24)));
                         } else
-                            scnfsc = Scn(ctx->read16(redoLogRecord->data(fieldPos + startPos + 12 + 18 + (i * 24))),
-                                         ctx->read32(redoLogRecord->data(fieldPos + startPos + 12 + 20 + (i * 24))));
+                            scnfsc = Scn(Mode::read16(redoLogRecord->data(fieldPos + startPos + 12 + 18 + (i * 24))),
+                                         Mode::read32(redoLogRecord->data(fieldPos + startPos + 12 + 20 + (i * 24))));
                         lck &= 0x0FFF;
 
                         *ctx->dumpStream << "0x" << std::setfill('0') << std::setw(2) << std::hex << (i + 1) << "   " <<
@@ -266,7 +327,7 @@ namespace OpenLogReplicator {
             } else if ((ktbOp & 0x0F) == KTBOP_N) {
                 opCode = 'N';
 
-                if (unlikely(ctx->dumpRedoLog >= 1)) {
+                if constexpr (Mode::dump) {
                     *ctx->dumpStream << "op: " << opCode << '\n';
                 }
 
@@ -277,12 +338,12 @@ namespace OpenLogReplicator {
                     throw RedoLogException(50061, "too short field KTB Redo F: " + std::to_string(fieldSize) + " offset: " +
                                                   redoLogRecord->fileOffset.toString());
 
-                redoLogRecord->xid = Xid(static_cast<typeUsn>(ctx->read16(redoLogRecord->data(fieldPos + startPos))),
-                                             ctx->read16(redoLogRecord->data(fieldPos + startPos + 2)),
-                                             ctx->read32(redoLogRecord->data(fieldPos + startPos + 4)));
+                redoLogRecord->xid = Xid(static_cast<typeUsn>(Mode::read16(redoLogRecord->data(fieldPos + startPos))),
+                                             Mode::read16(redoLogRecord->data(fieldPos + startPos + 2)),
+                                             Mode::read32(redoLogRecord->data(fieldPos + startPos + 4)));
 
-                if (unlikely(ctx->dumpRedoLog >= 1)) {
-                    const typeUba uba = ctx->read56(redoLogRecord->data(fieldPos + startPos + 8));
+                if constexpr (Mode::dump) {
+                    const typeUba uba = Mode::read56(redoLogRecord->data(fieldPos + startPos + 8));
                     *ctx->dumpStream << "op: " << opCode << " " <<
                                      " xid:  " << redoLogRecord->xid.toString() <<
                                      "    uba: " << PRINTUBA(uba) << '\n';
@@ -291,8 +352,8 @@ namespace OpenLogReplicator {
 
             // Block clean record
             if ((ktbOp & KTBOP_BLOCKCLEANOUT) != 0) {
-                if (unlikely(ctx->dumpRedoLog >= 1)) {
-                    const Scn scn = ctx->readScn(redoLogRecord->data(fieldPos + startPos + 40));
+                if constexpr (Mode::dump) {
+                    const Scn scn = Mode::readScn(redoLogRecord->data(fieldPos + startPos + 40));
                     const uint8_t opt = *redoLogRecord->data(fieldPos + startPos + 36);
                     uint8_t ver2 = *redoLogRecord->data(fieldPos + startPos + 38);
                     const typeCC entries = *redoLogRecord->data(fieldPos + startPos + 37);
@@ -329,7 +390,7 @@ namespace OpenLogReplicator {
                     for (typeCC j = 0; j < entries; ++j) {
                         const uint8_t itli = *redoLogRecord->data(fieldPos + startPos + 48 + (j * 8));
                         const uint8_t flg2 = *redoLogRecord->data(fieldPos + startPos + 49 + (j * 8));
-                        const Scn scnx = ctx->readScnR(redoLogRecord->data(fieldPos + startPos + 50 + (j * 8)));
+                        const Scn scnx = Mode::readScnR(redoLogRecord->data(fieldPos + startPos + 50 + (j * 8)));
                         if (ctx->version < RedoLogRecord::REDO_VERSION_12_1)
                             *ctx->dumpStream << "  itli: " << std::dec << static_cast<uint>(itli) << " " <<
                                              " flg: " << static_cast<uint>(flg2) << " " <<
@@ -350,6 +411,7 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void kdli(const Ctx* ctx, RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize) {
             if (unlikely(fieldSize < 1))
                 throw RedoLogException(50061, "too short field kdli: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
@@ -358,80 +420,81 @@ namespace OpenLogReplicator {
 
             switch (code) {
                 case KDLI_CODE_INFO:
-                    kdliInfo(ctx, redoLogRecord, fieldPos, fieldSize, code);
+                    kdliInfo<Mode>(ctx, redoLogRecord, fieldPos, fieldSize, code);
                     break;
 
                 case KDLI_CODE_LOAD_COMMON:
-                    kdliLoadCommon(ctx, /*redoLogRecord,  fieldPos, */ fieldSize, code);
+                    kdliLoadCommon<Mode>(ctx, /*redoLogRecord,  fieldPos, */ fieldSize, code);
                     break;
 
                 case KDLI_CODE_LOAD_DATA:
-                    kdliLoadData(ctx, redoLogRecord, fieldPos, fieldSize, code);
+                    kdliLoadData<Mode>(ctx, redoLogRecord, fieldPos, fieldSize, code);
                     break;
 
                 case KDLI_CODE_ZERO:
-                    kdliZero(ctx, redoLogRecord, fieldPos, fieldSize, code);
+                    kdliZero<Mode>(ctx, redoLogRecord, fieldPos, fieldSize, code);
                     break;
 
                 case KDLI_CODE_FILL:
-                    kdliFill(ctx, redoLogRecord, fieldPos, fieldSize, code);
+                    kdliFill<Mode>(ctx, redoLogRecord, fieldPos, fieldSize, code);
                     break;
 
                 case KDLI_CODE_LMAP:
-                    kdliLmap(ctx, redoLogRecord, fieldPos, fieldSize, code);
+                    kdliLmap<Mode>(ctx, redoLogRecord, fieldPos, fieldSize, code);
                     break;
 
                 case KDLI_CODE_LMAPX:
-                    kdliLmapx(ctx, redoLogRecord, fieldPos, fieldSize, code);
+                    kdliLmapx<Mode>(ctx, redoLogRecord, fieldPos, fieldSize, code);
                     break;
 
                 case KDLI_CODE_SUPLOG:
-                    kdliSuplog(ctx, redoLogRecord, fieldPos, fieldSize, code);
+                    kdliSuplog<Mode>(ctx, redoLogRecord, fieldPos, fieldSize, code);
                     break;
 
                 case KDLI_CODE_GMAP:
-                    kdliGmap(ctx /*, redoLogRecord, fieldPos, fieldSize, code*/);
+                    kdliGmap<Mode>(ctx /*, redoLogRecord, fieldPos, fieldSize, code*/);
                     break;
 
                 case KDLI_CODE_FPLOAD:
-                    kdliFpload(ctx, redoLogRecord, fieldPos, fieldSize, code);
+                    kdliFpload<Mode>(ctx, redoLogRecord, fieldPos, fieldSize, code);
                     break;
 
                 case KDLI_CODE_LOAD_LHB:
-                    kdliLoadLhb(ctx, redoLogRecord, fieldPos, fieldSize, code);
+                    kdliLoadLhb<Mode>(ctx, redoLogRecord, fieldPos, fieldSize, code);
                     break;
 
                 case KDLI_CODE_ALMAP:
-                    kdliAlmap(ctx, redoLogRecord, fieldPos, fieldSize, code);
+                    kdliAlmap<Mode>(ctx, redoLogRecord, fieldPos, fieldSize, code);
                     break;
 
                 case KDLI_CODE_ALMAPX:
-                    kdliAlmapx(ctx, /*redoLogRecord, fieldPos, */ fieldSize, code);
+                    kdliAlmapx<Mode>(ctx, /*redoLogRecord, fieldPos, */ fieldSize, code);
                     break;
 
                 case KDLI_CODE_LOAD_ITREE:
-                    kdliLoadItree(ctx, redoLogRecord, fieldPos, fieldSize, code);
+                    kdliLoadItree<Mode>(ctx, redoLogRecord, fieldPos, fieldSize, code);
                     break;
 
                 case KDLI_CODE_IMAP:
-                    kdliImap(ctx, redoLogRecord, fieldPos, fieldSize, code);
+                    kdliImap<Mode>(ctx, redoLogRecord, fieldPos, fieldSize, code);
                     break;
 
                 case KDLI_CODE_IMAPX:
-                    kdliImapx(ctx, /* redoLogRecord, fieldPos, */ fieldSize, code);
+                    kdliImapx<Mode>(ctx, /* redoLogRecord, fieldPos, */ fieldSize, code);
                     break;
                 default:
                     ;
             }
         }
 
+        template<typename Mode>
         static void kdliInfo(const Ctx* ctx, RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize, uint8_t code) {
             if (unlikely(fieldSize < 17))
                 throw RedoLogException(50061, "too short field kdli info: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
 
             redoLogRecord->lobId.set(redoLogRecord->data(fieldPos + 1));
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 const typeDba block = Ctx::read32Big(redoLogRecord->data(fieldPos + 11));
                 const uint16_t slot = Ctx::read16Big(redoLogRecord->data(fieldPos + 15));
 
@@ -442,13 +505,15 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void kdliLoadCommon(const Ctx* ctx, /*RedoLogRecord* redoLogRecord,  typePos fieldPos, */typeSize fieldSize, uint8_t code) {
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 *ctx->dumpStream << "KDLI load common [" << std::dec << static_cast<uint>(code) << "." << fieldSize << "]\n";
                 // TODO: finish
             }
         }
 
+        template<typename Mode>
         static void kdliLoadData(const Ctx* ctx, RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize, uint8_t code) {
             if (unlikely(fieldSize < 56))
                 throw RedoLogException(50061, "too short field kdli load data: " + std::to_string(fieldSize) + " offset: " +
@@ -456,8 +521,8 @@ namespace OpenLogReplicator {
 
             redoLogRecord->lobId.set(redoLogRecord->data(fieldPos + 12));
             redoLogRecord->lobPageNo = RedoLogRecord::INVALID_LOB_PAGE_NO;
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
-                const Scn scn = ctx->readScnR(redoLogRecord->data(fieldPos + 2));
+            if constexpr (Mode::dump) {
+                const Scn scn = Mode::readScnR(redoLogRecord->data(fieldPos + 2));
                 const uint8_t flg0 = *redoLogRecord->data(fieldPos + 10);
                 std::string flg0typ;
                 switch (flg0 & KDLI_TYPE_MASK) {
@@ -494,8 +559,8 @@ namespace OpenLogReplicator {
                 if ((flg0 & KDLI_TYPE_VER1) != 0)
                     flg0ver = "1";
                 const uint8_t flg1 = *redoLogRecord->data(fieldPos + 11);
-                const uint16_t rid1 = ctx->read16(redoLogRecord->data(fieldPos + 22));
-                const uint32_t rid2 = ctx->read32(redoLogRecord->data(fieldPos + 24));
+                const uint16_t rid1 = Mode::read16(redoLogRecord->data(fieldPos + 22));
+                const uint32_t rid2 = Mode::read32(redoLogRecord->data(fieldPos + 24));
                 const uint8_t flg2 = *redoLogRecord->data(fieldPos + 28);
                 std::string flg2pfill {"n"};
                 if ((flg2 & KDLI_FLG2_121_PFILL) != 0)
@@ -518,8 +583,8 @@ namespace OpenLogReplicator {
                 char hash[20];
                 memcpy(reinterpret_cast<void*>(hash),
                        reinterpret_cast<const void*>(redoLogRecord->data(fieldPos + 32)), 20);
-                const uint16_t hwm = ctx->read16(redoLogRecord->data(fieldPos + 52));
-                const uint16_t spr = ctx->read16(redoLogRecord->data(fieldPos + 54));
+                const uint16_t hwm = Mode::read16(redoLogRecord->data(fieldPos + 52));
+                const uint16_t spr = Mode::read16(redoLogRecord->data(fieldPos + 54));
 
                 *ctx->dumpStream << "KDLI load data [" << std::dec << static_cast<uint>(code) << "." << fieldSize << "]\n";
                 *ctx->dumpStream << "bdba    [0x" << std::setfill('0') << std::setw(8) << std::hex << redoLogRecord->dba << "]\n";
@@ -549,13 +614,14 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void kdliZero(const Ctx* ctx, const RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize, uint8_t code) {
             if (unlikely(fieldSize < 6))
                 throw RedoLogException(50061, "too short field kdli zero: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
-                const uint16_t zoff = ctx->read16(redoLogRecord->data(fieldPos + 2));
-                const uint16_t zsiz = ctx->read16(redoLogRecord->data(fieldPos + 4));
+            if constexpr (Mode::dump) {
+                const uint16_t zoff = Mode::read16(redoLogRecord->data(fieldPos + 2));
+                const uint16_t zsiz = Mode::read16(redoLogRecord->data(fieldPos + 4));
 
                 *ctx->dumpStream << "KDLI zero [" << std::dec << static_cast<uint>(code) << "." << fieldSize << "]\n";
                 *ctx->dumpStream << "  zoff  0x" << std::setfill('0') << std::setw(4) << std::hex << zoff << '\n';
@@ -563,17 +629,18 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void kdliFill(const Ctx* ctx, RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize, uint8_t code) {
             if (unlikely(fieldSize < 8))
                 throw RedoLogException(50061, "too short field kdli fill: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
 
             redoLogRecord->indKeyDataCode = code;
-            redoLogRecord->lobOffset = ctx->read16(redoLogRecord->data(fieldPos + 2));
+            redoLogRecord->lobOffset = Mode::read16(redoLogRecord->data(fieldPos + 2));
             redoLogRecord->lobData = fieldPos + 8;
-            redoLogRecord->lobDataSize = ctx->read16(redoLogRecord->data(fieldPos + 6));
+            redoLogRecord->lobDataSize = Mode::read16(redoLogRecord->data(fieldPos + 6));
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
-                const uint16_t fsiz = ctx->read16(redoLogRecord->data(fieldPos + 4));
+            if constexpr (Mode::dump) {
+                const uint16_t fsiz = Mode::read16(redoLogRecord->data(fieldPos + 4));
 
                 *ctx->dumpStream << "KDLI fill [" << std::dec << static_cast<uint>(code) << "." << fieldSize << "]\n";
                 *ctx->dumpStream << "  foff  0x" << std::setfill('0') << std::setw(4) << std::hex << redoLogRecord->lobOffset << '\n';
@@ -591,6 +658,7 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void kdliLmap(const Ctx* ctx, RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize, uint8_t code) {
             if (unlikely(fieldSize < 8))
                 throw RedoLogException(50061, "too short field kdli lmap: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
@@ -599,8 +667,8 @@ namespace OpenLogReplicator {
             redoLogRecord->indKeyData = fieldPos;
             redoLogRecord->indKeyDataSize = fieldSize;
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
-                const uint32_t asiz = ctx->read32(redoLogRecord->data(fieldPos + 4));
+            if constexpr (Mode::dump) {
+                const uint32_t asiz = Mode::read32(redoLogRecord->data(fieldPos + 4));
 
                 if (fieldSize < 8U + asiz * 8U)
                     ctx->warning(70001, "too short field kdli lmap asiz: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
@@ -611,8 +679,8 @@ namespace OpenLogReplicator {
                 for (uint32_t i = 0; i < asiz; ++i) {
                     const uint8_t num1 = *redoLogRecord->data(fieldPos + (i * 8) + 8 + 0);
                     const uint8_t num2 = *redoLogRecord->data(fieldPos + (i * 8) + 8 + 1);
-                    const uint16_t num3 = ctx->read16(redoLogRecord->data(fieldPos + (i * 8) + 8 + 2));
-                    const typeDba dba = ctx->read32(redoLogRecord->data(fieldPos + (i * 8) + 8 + 4));
+                    const uint16_t num3 = Mode::read16(redoLogRecord->data(fieldPos + (i * 8) + 8 + 2));
+                    const typeDba dba = Mode::read32(redoLogRecord->data(fieldPos + (i * 8) + 8 + 4));
 
                     *ctx->dumpStream << "    [" << std::dec << i << "] " <<
                                      "0x" << std::hex << std::setfill('0') << std::setw(2) << std::hex << static_cast<uint>(num1) << " " <<
@@ -623,6 +691,7 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void kdliLmapx(const Ctx* ctx, RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize, uint8_t code) {
             if (unlikely(fieldSize < 8))
                 throw RedoLogException(50061, "too short field kdli lmapx: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
@@ -631,8 +700,8 @@ namespace OpenLogReplicator {
             redoLogRecord->indKeyData = fieldPos;
             redoLogRecord->indKeyDataSize = fieldSize;
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
-                const uint32_t asiz = ctx->read32(redoLogRecord->data(fieldPos + 4));
+            if constexpr (Mode::dump) {
+                const uint32_t asiz = Mode::read32(redoLogRecord->data(fieldPos + 4));
 
                 if (fieldSize < 8U + asiz * 16U) {
                     ctx->warning(70001, "too short field kdli lmapx asiz: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
@@ -645,10 +714,10 @@ namespace OpenLogReplicator {
                 for (uint32_t i = 0; i < asiz; ++i) {
                     const uint8_t num1 = *redoLogRecord->data(fieldPos + (i * 16) + 8 + 0);
                     const uint8_t num2 = *redoLogRecord->data(fieldPos + (i * 16) + 8 + 1);
-                    const uint16_t num3 = ctx->read16(redoLogRecord->data(fieldPos + (i * 16) + 8 + 2));
-                    const typeDba dba = ctx->read32(redoLogRecord->data(fieldPos + (i * 16) + 8 + 4));
-                    const int32_t num4 = ctx->read32(redoLogRecord->data(fieldPos + (i * 16) + 8 + 8));
-                    const int32_t num5 = ctx->read32(redoLogRecord->data(fieldPos + (i * 16) + 8 + 12));
+                    const uint16_t num3 = Mode::read16(redoLogRecord->data(fieldPos + (i * 16) + 8 + 2));
+                    const typeDba dba = Mode::read32(redoLogRecord->data(fieldPos + (i * 16) + 8 + 4));
+                    const int32_t num4 = Mode::read32(redoLogRecord->data(fieldPos + (i * 16) + 8 + 8));
+                    const int32_t num5 = Mode::read32(redoLogRecord->data(fieldPos + (i * 16) + 8 + 12));
 
                     *ctx->dumpStream << "    [" << std::dec << i << "] " <<
                                      "0x" << std::hex << std::setfill('0') << std::setw(2) << std::hex << static_cast<uint>(num1) << " " <<
@@ -660,19 +729,20 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void kdliSuplog(const Ctx* ctx, RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize, uint8_t code) {
             if (unlikely(fieldSize < 24))
                 throw RedoLogException(50061, "too short field kdli suplog: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
 
-            redoLogRecord->xid = Xid(static_cast<typeUsn>(ctx->read16(redoLogRecord->data(fieldPos + 4))),
-                                         ctx->read16(redoLogRecord->data(fieldPos + 6)),
-                                         ctx->read32(redoLogRecord->data(fieldPos + 8)));
-            redoLogRecord->obj = ctx->read32(redoLogRecord->data(fieldPos + 12));
-            redoLogRecord->col = ctx->read16(redoLogRecord->data(fieldPos + 18));
+            redoLogRecord->xid = Xid(static_cast<typeUsn>(Mode::read16(redoLogRecord->data(fieldPos + 4))),
+                                         Mode::read16(redoLogRecord->data(fieldPos + 6)),
+                                         Mode::read32(redoLogRecord->data(fieldPos + 8)));
+            redoLogRecord->obj = Mode::read32(redoLogRecord->data(fieldPos + 12));
+            redoLogRecord->col = Mode::read16(redoLogRecord->data(fieldPos + 18));
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
-                const uint16_t objv = ctx->read16(redoLogRecord->data(fieldPos + 16));
-                const uint32_t flag = ctx->read32(redoLogRecord->data(fieldPos + 20));
+            if constexpr (Mode::dump) {
+                const uint16_t objv = Mode::read16(redoLogRecord->data(fieldPos + 16));
+                const uint32_t flag = Mode::read32(redoLogRecord->data(fieldPos + 20));
 
                 *ctx->dumpStream << "KDLI suplog [" << std::dec << static_cast<uint>(code) << "." << std::dec << fieldSize << "]\n";
                 *ctx->dumpStream << "  xid   " << redoLogRecord->xid.toString() << '\n';
@@ -683,25 +753,27 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void kdliGmap(const Ctx* ctx /*, RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize, uint8_t code*/) {
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 *ctx->dumpStream << "KDLI GMAP Generic/Auxiliary Mapping Change:\n";
                 // TODO: finish
             }
         }
 
+        template<typename Mode>
         static void kdliFpload(const Ctx* ctx, RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize, uint8_t code) {
             if (unlikely(fieldSize < 28))
                 throw RedoLogException(50061, "too short field kdli fpload: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
 
-            redoLogRecord->xid = Xid(static_cast<typeUsn>(ctx->read16(redoLogRecord->data(fieldPos + 16))),
-                                         ctx->read16(redoLogRecord->data(fieldPos + 18)),
-                                         ctx->read32(redoLogRecord->data(fieldPos + 20)));
-            redoLogRecord->dataObj = ctx->read32(redoLogRecord->data(fieldPos + 24));
+            redoLogRecord->xid = Xid(static_cast<typeUsn>(Mode::read16(redoLogRecord->data(fieldPos + 16))),
+                                         Mode::read16(redoLogRecord->data(fieldPos + 18)),
+                                         Mode::read32(redoLogRecord->data(fieldPos + 20)));
+            redoLogRecord->dataObj = Mode::read32(redoLogRecord->data(fieldPos + 24));
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
-                const uint32_t bsz = ctx->read32(redoLogRecord->data(fieldPos + 4));
-                const Scn scn = ctx->readScn(redoLogRecord->data(fieldPos + 8));
+            if constexpr (Mode::dump) {
+                const uint32_t bsz = Mode::read32(redoLogRecord->data(fieldPos + 4));
+                const Scn scn = Mode::readScn(redoLogRecord->data(fieldPos + 8));
 
                 *ctx->dumpStream << "KDLI fpload [" << std::dec << static_cast<uint>(code) << "." << fieldSize << "]\n";
                 *ctx->dumpStream << "  bsz   " << std::dec << bsz << '\n';
@@ -714,6 +786,7 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void kdliLoadLhb(const Ctx* ctx, RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize, uint8_t code) {
             if (unlikely(fieldSize < 112))
                 throw RedoLogException(50061, "too short field kdli load lhb: " + std::to_string(fieldSize) + " offset: " +
@@ -721,17 +794,17 @@ namespace OpenLogReplicator {
 
             redoLogRecord->lobId.set(redoLogRecord->data(fieldPos + 12));
             redoLogRecord->lobPageNo = RedoLogRecord::INVALID_LOB_PAGE_NO;
-            redoLogRecord->dba0 = ctx->read32(redoLogRecord->data(fieldPos + 64));
-            redoLogRecord->dba1 = ctx->read32(redoLogRecord->data(fieldPos + 68));
-            redoLogRecord->dba2 = ctx->read32(redoLogRecord->data(fieldPos + 72));
-            redoLogRecord->dba3 = ctx->read32(redoLogRecord->data(fieldPos + 76));
-
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
-                const Scn scn = Scn(ctx->read16(redoLogRecord->data(fieldPos + 8)),
-                                    ctx->read32(redoLogRecord->data(fieldPos + 4)));
+            redoLogRecord->dba0 = Mode::read32(redoLogRecord->data(fieldPos + 64));
+            redoLogRecord->dba1 = Mode::read32(redoLogRecord->data(fieldPos + 68));
+            redoLogRecord->dba2 = Mode::read32(redoLogRecord->data(fieldPos + 72));
+            redoLogRecord->dba3 = Mode::read32(redoLogRecord->data(fieldPos + 76));
+
+            if constexpr (Mode::dump) {
+                const Scn scn = Scn(Mode::read16(redoLogRecord->data(fieldPos + 8)),
+                                    Mode::read32(redoLogRecord->data(fieldPos + 4)));
                 const uint8_t flg0 = *redoLogRecord->data(fieldPos + 10);
                 const uint8_t flg1 = *redoLogRecord->data(fieldPos + 11);
-                const uint32_t spare = ctx->read32(redoLogRecord->data(fieldPos + 24));
+                const uint32_t spare = Mode::read32(redoLogRecord->data(fieldPos + 24));
                 std::string flg0typ = "???";
                 switch (flg0 & KDLI_TYPE_MASK) {
                     case KDLI_TYPE_NEW:
@@ -786,19 +859,19 @@ namespace OpenLogReplicator {
                 if ((flg3 & KDLI_FLG3_VLL) != 0) {
                     const uint8_t flg4 = *redoLogRecord->data(fieldPos + 30);
                     const uint8_t flg5 = *redoLogRecord->data(fieldPos + 31);
-                    const int32_t llen1 = ctx->read32(redoLogRecord->data(fieldPos + 32));
-                    const int32_t llen2 = ctx->read32(redoLogRecord->data(fieldPos + 36));
-                    const int32_t ver1 = ctx->read32(redoLogRecord->data(fieldPos + 40));
-                    const int32_t ver2 = ctx->read32(redoLogRecord->data(fieldPos + 44));
-                    const int32_t ext = ctx->read32(redoLogRecord->data(fieldPos + 48));
-                    const uint16_t asiz = ctx->read16(redoLogRecord->data(fieldPos + 52));
-                    const uint16_t hwm = ctx->read16(redoLogRecord->data(fieldPos + 54));
-                    const uint32_t ovr1 = ctx->read32(redoLogRecord->data(fieldPos + 56));
-                    const int32_t ovr2 = ctx->read32(redoLogRecord->data(fieldPos + 60));
-                    const typeDba ldba = ctx->read32(redoLogRecord->data(fieldPos + 80));
-                    const int32_t nblk = ctx->read32(redoLogRecord->data(fieldPos + 84));
+                    const int32_t llen1 = Mode::read32(redoLogRecord->data(fieldPos + 32));
+                    const int32_t llen2 = Mode::read32(redoLogRecord->data(fieldPos + 36));
+                    const int32_t ver1 = Mode::read32(redoLogRecord->data(fieldPos + 40));
+                    const int32_t ver2 = Mode::read32(redoLogRecord->data(fieldPos + 44));
+                    const int32_t ext = Mode::read32(redoLogRecord->data(fieldPos + 48));
+                    const uint16_t asiz = Mode::read16(redoLogRecord->data(fieldPos + 52));
+                    const uint16_t hwm = Mode::read16(redoLogRecord->data(fieldPos + 54));
+                    const uint32_t ovr1 = Mode::read32(redoLogRecord->data(fieldPos + 56));
+                    const int32_t ovr2 = Mode::read32(redoLogRecord->data(fieldPos + 60));
+                    const typeDba ldba = Mode::read32(redoLogRecord->data(fieldPos + 80));
+                    const int32_t nblk = Mode::read32(redoLogRecord->data(fieldPos + 84));
                     const Scn deScn1{};
-                    const Scn deScn2{ctx->read64(redoLogRecord->data(fieldPos + 88))};
+                    const Scn deScn2{Mode::read64(redoLogRecord->data(fieldPos + 88))};
                     char hash[16];
                     memcpy(reinterpret_cast<void*>(hash),
                            reinterpret_cast<const void*>(redoLogRecord->data(fieldPos + 96)), 16);
@@ -904,6 +977,7 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void kdliAlmap(const Ctx* ctx, RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize, uint8_t code) {
             if (unlikely(fieldSize < 12))
                 throw RedoLogException(50061, "too short field kdli kmap: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
@@ -912,9 +986,9 @@ namespace OpenLogReplicator {
             redoLogRecord->indKeyData = fieldPos;
             redoLogRecord->indKeyDataSize = fieldSize;
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
-                const uint32_t nent = ctx->read32(redoLogRecord->data(fieldPos + 4));
-                const uint32_t sidx = ctx->read32(redoLogRecord->data(fieldPos + 8));
+            if constexpr (Mode::dump) {
+                const uint32_t nent = Mode::read32(redoLogRecord->data(fieldPos + 4));
+                const uint32_t sidx = Mode::read32(redoLogRecord->data(fieldPos + 8));
 
                 if (unlikely(fieldSize < 12 + nent * 8))
                     throw RedoLogException(50061, "too short field kdli almap nent: " + std::to_string(fieldSize) + " offset: " +
@@ -927,8 +1001,8 @@ namespace OpenLogReplicator {
                 for (uint32_t i = 0; i < nent; ++i) {
                     const uint8_t num1 = *redoLogRecord->data(fieldPos + (i * 8) + 12 + 0);
                     const uint8_t num2 = *redoLogRecord->data(fieldPos + (i * 8) + 12 + 1);
-                    const uint16_t num3 = ctx->read16(redoLogRecord->data(fieldPos + (i * 8) + 12 + 2));
-                    const typeDba dba = ctx->read32(redoLogRecord->data(fieldPos + (i * 8) + 12 + 4));
+                    const uint16_t num3 = Mode::read16(redoLogRecord->data(fieldPos + (i * 8) + 12 + 2));
+                    const typeDba dba = Mode::read32(redoLogRecord->data(fieldPos + (i * 8) + 12 + 4));
 
                     *ctx->dumpStream << "    [" << std::dec << i << "] " <<
                                      "0x" << std::hex << std::setfill('0') << std::setw(2) << std::hex << static_cast<uint>(num1) << " " <<
@@ -939,13 +1013,15 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void kdliAlmapx(const Ctx* ctx, /* RedoLogRecord* redoLogRecord, typePos fieldPos, */ typeSize fieldSize, uint8_t code) {
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 *ctx->dumpStream << "KDLI almapx [" << std::dec << static_cast<uint>(code) << "." << fieldSize << "]\n";
                 // TODO: finish
             }
         }
 
+        template<typename Mode>
         static void kdliLoadItree(const Ctx* ctx, RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize, uint8_t code) {
             if (unlikely(fieldSize < 40))
                 throw RedoLogException(50061, "too short field kdli load itree: " + std::to_string(fieldSize) + " offset: " +
@@ -954,8 +1030,8 @@ namespace OpenLogReplicator {
             redoLogRecord->lobId.set(redoLogRecord->data(fieldPos + 12));
             redoLogRecord->lobPageNo = RedoLogRecord::INVALID_LOB_PAGE_NO;
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
-                const Scn scn = ctx->readScnR(redoLogRecord->data(fieldPos + 2));
+            if constexpr (Mode::dump) {
+                const Scn scn = Mode::readScnR(redoLogRecord->data(fieldPos + 2));
                 const uint8_t flg0 = *redoLogRecord->data(fieldPos + 10);
                 std::string flg0typ;
                 switch (flg0 & KDLI_TYPE_MASK) {
@@ -992,8 +1068,8 @@ namespace OpenLogReplicator {
                 if ((flg0 & KDLI_TYPE_VER1) != 0)
                     flg0ver = "1";
                 const uint8_t flg1 = *redoLogRecord->data(fieldPos + 11);
-                const uint16_t rid1 = ctx->read16(redoLogRecord->data(fieldPos + 22));
-                const uint32_t rid2 = ctx->read32(redoLogRecord->data(fieldPos + 24));
+                const uint16_t rid1 = Mode::read16(redoLogRecord->data(fieldPos + 22));
+                const uint32_t rid2 = Mode::read32(redoLogRecord->data(fieldPos + 24));
                 const uint8_t flg2 = *redoLogRecord->data(fieldPos + 28);
                 std::string flg2xfm {"n"};
                 if ((flg2 & KDLI_FLG2_122_XFM) != 0)
@@ -1002,10 +1078,10 @@ namespace OpenLogReplicator {
                 if ((flg2 & KDLI_FLG2_121_VER1) != 0)
                     flg2ver1 = "1";
                 const uint8_t flg3 = *redoLogRecord->data(fieldPos + 29);
-                const uint16_t lvl = ctx->read16(redoLogRecord->data(fieldPos + 30));
-                const uint16_t asiz = ctx->read16(redoLogRecord->data(fieldPos + 32));
-                const uint16_t hwm = ctx->read16(redoLogRecord->data(fieldPos + 34));
-                const uint16_t par = ctx->read32(redoLogRecord->data(fieldPos + 36));
+                const uint16_t lvl = Mode::read16(redoLogRecord->data(fieldPos + 30));
+                const uint16_t asiz = Mode::read16(redoLogRecord->data(fieldPos + 32));
+                const uint16_t hwm = Mode::read16(redoLogRecord->data(fieldPos + 34));
+                const uint16_t par = Mode::read32(redoLogRecord->data(fieldPos + 36));
 
                 *ctx->dumpStream << "KDLI load itree [" << std::dec << static_cast<uint>(code) << "." << fieldSize << "]\n";
                 *ctx->dumpStream << "bdba    [0x" << std::setfill('0') << std::setw(8) << std::hex << redoLogRecord->dba << "]\n";
@@ -1032,6 +1108,7 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void kdliImap(const Ctx* ctx, RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize, uint8_t code) {
             if (unlikely(fieldSize < 8))
                 throw RedoLogException(50061, "too short field kdli imap: " + std::to_string(fieldSize) + " offset: " +
@@ -1041,8 +1118,8 @@ namespace OpenLogReplicator {
             redoLogRecord->indKeyData = fieldPos;
             redoLogRecord->indKeyDataSize = fieldSize;
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
-                const uint32_t asiz = ctx->read32(redoLogRecord->data(fieldPos + 4));
+            if constexpr (Mode::dump) {
+                const uint32_t asiz = Mode::read32(redoLogRecord->data(fieldPos + 4));
 
                 if (fieldSize < 8 + asiz * 8)
                     ctx->warning(70001, "too short field kdli imap asiz: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
@@ -1053,8 +1130,8 @@ namespace OpenLogReplicator {
                 for (uint32_t i = 0; i < asiz; ++i) {
                     const uint8_t num1 = *redoLogRecord->data(fieldPos + (i * 8) + 8 + 0);
                     const uint8_t num2 = *redoLogRecord->data(fieldPos + (i * 8) + 8 + 1);
-                    const uint16_t num3 = ctx->read16(redoLogRecord->data(fieldPos + (i * 8) + 8 + 2));
-                    const typeDba dba = ctx->read32(redoLogRecord->data(fieldPos + (i * 8) + 8 + 4));
+                    const uint16_t num3 = Mode::read16(redoLogRecord->data(fieldPos + (i * 8) + 8 + 2));
+                    const typeDba dba = Mode::read32(redoLogRecord->data(fieldPos + (i * 8) + 8 + 4));
 
                     *ctx->dumpStream << "    [" << std::dec << i << "] " <<
                                      "0x" << std::hex << std::setfill('0') << std::setw(2) << std::hex << static_cast<uint>(num1) << " " <<
@@ -1065,18 +1142,20 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void kdliImapx(const Ctx* ctx, /* RedoLogRecord* redoLogRecord, typePos fieldPos, */ typeSize fieldSize, uint8_t code) {
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 *ctx->dumpStream << "KDLI imap [" << std::dec << static_cast<uint>(code) << "." << fieldSize << "]\n";
                 // TODO: finish
             }
         }
 
+        template<typename Mode>
         static void kdliDataLoad(const Ctx* ctx, RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize) {
             redoLogRecord->lobData = fieldPos;
             redoLogRecord->lobDataSize = fieldSize;
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 *ctx->dumpStream << "KDLI data load [0xXXXXXXXXXXXX." << std::dec << fieldSize << "]\n";
 
                 for (typeSize j = 0; j < fieldSize; ++j) {
@@ -1089,14 +1168,15 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void kdliCommon(const Ctx* ctx, RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize) {
             if (unlikely(fieldSize < 12))
                 throw RedoLogException(50061, "too short field kdli common: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
 
             redoLogRecord->opc = *redoLogRecord->data(fieldPos + 0);
-            redoLogRecord->dba = ctx->read32(redoLogRecord->data(fieldPos + 8));
+            redoLogRecord->dba = Mode::read32(redoLogRecord->data(fieldPos + 8));
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 std::string opCode {"????"};
                 switch (redoLogRecord->opc) {
                     case KDLI_OP_REDO:
@@ -1165,8 +1245,8 @@ namespace OpenLogReplicator {
 
                 const uint8_t flg0 = *redoLogRecord->data(fieldPos + 2);
                 const uint8_t flg1 = *redoLogRecord->data(fieldPos + 3);
-                const uint16_t psiz = ctx->read32(redoLogRecord->data(fieldPos + 4));
-                const uint16_t poff = ctx->read32(redoLogRecord->data(fieldPos + 6));
+                const uint16_t psiz = Mode::read32(redoLogRecord->data(fieldPos + 4));
+                const uint16_t poff = Mode::read32(redoLogRecord->data(fieldPos + 6));
 
                 *ctx->dumpStream << "KDLI common [" << std::dec << fieldSize << "]\n";
                 *ctx->dumpStream << "  op    0x" << std::setfill('0') << std::setw(2) << std::hex << static_cast<uint>(redoLogRecord->opc) <<
@@ -1181,17 +1261,18 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void kdoOpCode(const Ctx* ctx, RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize) {
             if (unlikely(fieldSize < 16))
                 throw RedoLogException(50061, "too short field kdo OpCode: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
 
-            redoLogRecord->bdba = ctx->read32(redoLogRecord->data(fieldPos + 0));
+            redoLogRecord->bdba = Mode::read32(redoLogRecord->data(fieldPos + 0));
             redoLogRecord->op = *redoLogRecord->data(fieldPos + 10);
             redoLogRecord->flags = *redoLogRecord->data(fieldPos + 11);
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
-                const typeDba hdba = ctx->read32(redoLogRecord->data(fieldPos + 4));
-                const uint16_t maxFr = ctx->read16(redoLogRecord->data(fieldPos + 8));
+            if constexpr (Mode::dump) {
+                const typeDba hdba = Mode::read32(redoLogRecord->data(fieldPos + 4));
+                const uint16_t maxFr = Mode::read16(redoLogRecord->data(fieldPos + 8));
                 const uint8_t itli = *redoLogRecord->data(fieldPos + 12);
                 const uint8_t ispac = *redoLogRecord->data(fieldPos + 13);
 
@@ -1291,7 +1372,7 @@ namespace OpenLogReplicator {
 
                     default:
                         opCode = "XXX";
-                        if (unlikely(ctx->dumpRedoLog >= 1))
+                        if constexpr (Mode::dump)
                             *ctx->dumpStream << "DEBUG op: " << std::dec << static_cast<uint>(redoLogRecord->op & 0x1F) << '\n';
                 }
 
@@ -1363,7 +1444,7 @@ namespace OpenLogReplicator {
 
                     case RedoLogRecord::OP_DSC:
                         if (fieldSize >= 24) {
-                            const uint16_t slot = ctx->read16(redoLogRecord->data(fieldPos + 16));
+                            const uint16_t slot = Mode::read16(redoLogRecord->data(fieldPos + 16));
                             const uint8_t tabn = *redoLogRecord->data(fieldPos + 18);
                             const uint8_t rel = *redoLogRecord->data(fieldPos + 19);
 
@@ -1379,42 +1460,43 @@ namespace OpenLogReplicator {
 
             switch (redoLogRecord->op & 0x1F) {
                 case RedoLogRecord::OP_IRP:
-                    kdoOpCodeIRP(ctx, redoLogRecord, fieldPos, fieldSize);
+                    kdoOpCodeIRP<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
                     break;
 
                 case RedoLogRecord::OP_DRP:
-                    kdoOpCodeDRP(ctx, redoLogRecord, fieldPos, fieldSize);
+                    kdoOpCodeDRP<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
                     break;
 
                 case RedoLogRecord::OP_LKR:
-                    kdoOpCodeLKR(ctx, redoLogRecord, fieldPos, fieldSize);
+                    kdoOpCodeLKR<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
                     break;
 
                 case RedoLogRecord::OP_URP:
-                    kdoOpCodeURP(ctx, redoLogRecord, fieldPos, fieldSize);
+                    kdoOpCodeURP<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
                     break;
 
                 case RedoLogRecord::OP_ORP:
-                    kdoOpCodeORP(ctx, redoLogRecord, fieldPos, fieldSize);
+                    kdoOpCodeORP<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
                     break;
 
                 case RedoLogRecord::OP_CKI:
-                    kdoOpCodeSKL(ctx, redoLogRecord, fieldPos, fieldSize);
+                    kdoOpCodeSKL<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
                     break;
 
                 case RedoLogRecord::OP_CFA:
-                    kdoOpCodeCFA(ctx, redoLogRecord, fieldPos, fieldSize);
+                    kdoOpCodeCFA<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
                     break;
 
                 case RedoLogRecord::OP_QMI:
                 case RedoLogRecord::OP_QMD:
-                    kdoOpCodeQM(ctx, redoLogRecord, fieldPos, fieldSize);
+                    kdoOpCodeQM<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
                     break;
                 default:
                     ;
             }
         }
 
+        template<typename Mode>
         static void kdoOpCodeIRP(const Ctx* ctx, RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize) {
             if (unlikely(fieldSize < 48))
                 throw RedoLogException(50061, "too short field kdo OpCode IRP: " + std::to_string(fieldSize) + " offset: " +
@@ -1422,14 +1504,14 @@ namespace OpenLogReplicator {
 
             redoLogRecord->fb = *redoLogRecord->data(fieldPos + 16);
             redoLogRecord->cc = *redoLogRecord->data(fieldPos + 18);
-            redoLogRecord->sizeDelt = ctx->read16(redoLogRecord->data(fieldPos + 40));
-            redoLogRecord->slot = ctx->read16(redoLogRecord->data(fieldPos + 42));
+            redoLogRecord->sizeDelt = Mode::read16(redoLogRecord->data(fieldPos + 40));
+            redoLogRecord->slot = Mode::read16(redoLogRecord->data(fieldPos + 42));
 
             typeDba nridBdba = 0;
             typeSlot nridSlot = 0;
             if ((redoLogRecord->fb & RedoLogRecord::FB_L) == 0) {
-                nridBdba = ctx->read32(redoLogRecord->data(fieldPos + 28));
-                nridSlot = ctx->read16(redoLogRecord->data(fieldPos + 32));
+                nridBdba = Mode::read32(redoLogRecord->data(fieldPos + 28));
+                nridSlot = Mode::read16(redoLogRecord->data(fieldPos + 32));
             }
 
             if (unlikely(fieldSize < 45U + (static_cast<typeSize>(redoLogRecord->cc) + 7U) / 8U))
@@ -1449,7 +1531,7 @@ namespace OpenLogReplicator {
                 }
             }
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 const uint8_t tabn = *redoLogRecord->data(fieldPos + 44);
 
                 *ctx->dumpStream << "tabn: " << static_cast<uint>(tabn) <<
@@ -1470,8 +1552,8 @@ namespace OpenLogReplicator {
                     *ctx->dumpStream << '\n';
 
                 if ((redoLogRecord->fb & RedoLogRecord::FB_F) != 0 && (redoLogRecord->fb & RedoLogRecord::FB_H) == 0) {
-                    const typeDba hrid1 = ctx->read32(redoLogRecord->data(fieldPos + 20));
-                    const typeSlot hrid2 = ctx->read16(redoLogRecord->data(fieldPos + 24));
+                    const typeDba hrid1 = Mode::read32(redoLogRecord->data(fieldPos + 20));
+                    const typeSlot hrid2 = Mode::read16(redoLogRecord->data(fieldPos + 24));
                     *ctx->dumpStream << "hrid: 0x" << std::setfill('0') << std::setw(8) << std::hex << hrid1 << "." << std::hex << hrid2 << '\n';
                 }
 
@@ -1483,10 +1565,10 @@ namespace OpenLogReplicator {
                 if ((redoLogRecord->fb & RedoLogRecord::FB_K) != 0) {
                     const uint8_t curc = 0; // TODO: find field position/size
                     const uint8_t comc = 0; // TODO: find field position/size
-                    const uint32_t pk = ctx->read32(redoLogRecord->data(fieldPos + 20));
-                    const uint16_t pk1 = ctx->read16(redoLogRecord->data(fieldPos + 24));
-                    const uint32_t nk = ctx->read32(redoLogRecord->data(fieldPos + 28));
-                    const uint16_t nk1 = ctx->read16(redoLogRecord->data(fieldPos + 32));
+                    const uint32_t pk = Mode::read32(redoLogRecord->data(fieldPos + 20));
+                    const uint16_t pk1 = Mode::read16(redoLogRecord->data(fieldPos + 24));
+                    const uint32_t nk = Mode::read32(redoLogRecord->data(fieldPos + 28));
+                    const uint16_t nk1 = Mode::read16(redoLogRecord->data(fieldPos + 32));
 
                     *ctx->dumpStream << "curc: " << std::dec << static_cast<uint>(curc) <<
                                      " comc: " << std::dec << static_cast<uint>(comc) <<
@@ -1521,14 +1603,15 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void kdoOpCodeDRP(const Ctx* ctx, RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize) {
             if (unlikely(fieldSize < 20))
                 throw RedoLogException(50061, "too short field kdo OpCode DRP: " + std::to_string(fieldSize) + " offset: " +
                                               redoLogRecord->fileOffset.toString());
 
-            redoLogRecord->slot = ctx->read16(redoLogRecord->data(fieldPos + 16));
+            redoLogRecord->slot = Mode::read16(redoLogRecord->data(fieldPos + 16));
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 const uint8_t tabn = *redoLogRecord->data(fieldPos + 18);
 
                 *ctx->dumpStream << "tabn: " << static_cast<uint>(tabn) <<
@@ -1536,14 +1619,15 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void kdoOpCodeLKR(const Ctx* ctx, RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize) {
             if (unlikely(fieldSize < 20))
                 throw RedoLogException(50061, "too short field KDO OpCode LKR: " + std::to_string(fieldSize) + " offset: " +
                                               redoLogRecord->fileOffset.toString());
 
-            redoLogRecord->slot = ctx->read16(redoLogRecord->data(fieldPos + 16));
+            redoLogRecord->slot = Mode::read16(redoLogRecord->data(fieldPos + 16));
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 const uint8_t tabn = *redoLogRecord->data(fieldPos + 18);
                 const uint8_t to = *redoLogRecord->data(fieldPos + 19);
 
@@ -1553,13 +1637,14 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void kdoOpCodeURP(const Ctx* ctx, RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize) {
             if (unlikely(fieldSize < 28))
                 throw RedoLogException(50061, "too short field kdo OpCode URP: " + std::to_string(fieldSize) + " offset: " +
                                               redoLogRecord->fileOffset.toString());
 
             redoLogRecord->fb = *redoLogRecord->data(fieldPos + 16);
-            redoLogRecord->slot = ctx->read16(redoLogRecord->data(fieldPos + 20));
+            redoLogRecord->slot = Mode::read16(redoLogRecord->data(fieldPos + 20));
             redoLogRecord->cc = *redoLogRecord->data(fieldPos + 23);
 
             if (unlikely(fieldSize < 26 + (static_cast<uint>(redoLogRecord->cc) + 7U) / 8U))
@@ -1579,12 +1664,12 @@ namespace OpenLogReplicator {
                 }
             }
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 const uint8_t lock = *redoLogRecord->data(fieldPos + 17);
                 const uint8_t ckix = *redoLogRecord->data(fieldPos + 18);
                 const uint8_t tabn = *redoLogRecord->data(fieldPos + 19);
                 const uint8_t ncol = *redoLogRecord->data(fieldPos + 22);
-                const auto size = static_cast<int16_t>(ctx->read16(redoLogRecord->data(fieldPos + 24))); // Signed
+                const auto size = static_cast<int16_t>(Mode::read16(redoLogRecord->data(fieldPos + 24))); // Signed
 
                 *ctx->dumpStream << "tabn: " << static_cast<uint>(tabn) <<
                                  " slot: " << std::dec << redoLogRecord->slot << "(0x" << std::hex << redoLogRecord->slot << ")" <<
@@ -1597,6 +1682,7 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void kdoOpCodeORP(const Ctx* ctx, RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize) {
             if (unlikely(fieldSize < 48))
                 throw RedoLogException(50061, "too short field kdo OpCode ORP: " + std::to_string(fieldSize) + " offset: " +
@@ -1604,7 +1690,7 @@ namespace OpenLogReplicator {
 
             redoLogRecord->fb = *redoLogRecord->data(fieldPos + 16);
             redoLogRecord->cc = *redoLogRecord->data(fieldPos + 18);
-            redoLogRecord->slot = ctx->read16(redoLogRecord->data(fieldPos + 42));
+            redoLogRecord->slot = Mode::read16(redoLogRecord->data(fieldPos + 42));
 
             if (unlikely(fieldSize < 45 + (static_cast<uint>(redoLogRecord->cc) + 7U) / 8U))
                 throw RedoLogException(50061, "too short field kdo OpCode ORP for nulls: " + std::to_string(fieldSize) + " offset: " +
@@ -1626,12 +1712,12 @@ namespace OpenLogReplicator {
             typeDba nridBdba = 0;
             typeSlot nridSlot = 0;
             if ((redoLogRecord->fb & RedoLogRecord::FB_L) == 0) {
-                nridBdba = ctx->read32(redoLogRecord->data(fieldPos + 28));
-                nridSlot = ctx->read16(redoLogRecord->data(fieldPos + 32));
+                nridBdba = Mode::read32(redoLogRecord->data(fieldPos + 28));
+                nridSlot = Mode::read16(redoLogRecord->data(fieldPos + 32));
             }
-            redoLogRecord->sizeDelt = ctx->read16(redoLogRecord->data(fieldPos + 40));
+            redoLogRecord->sizeDelt = Mode::read16(redoLogRecord->data(fieldPos + 40));
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 const uint8_t tabn = *redoLogRecord->data(fieldPos + 44);
 
                 *ctx->dumpStream << "tabn: " << static_cast<uint>(tabn) <<
@@ -1683,16 +1769,17 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void kdoOpCodeCFA(const Ctx* ctx, RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize) {
             if (unlikely(fieldSize < 32))
                 throw RedoLogException(50061, "too short field kdo OpCode ORP: " + std::to_string(fieldSize) + " offset: " +
                                               redoLogRecord->fileOffset.toString());
 
-            redoLogRecord->slot = ctx->read16(redoLogRecord->data(fieldPos + 24));
+            redoLogRecord->slot = Mode::read16(redoLogRecord->data(fieldPos + 24));
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
-                const typeDba nridBdba = ctx->read32(redoLogRecord->data(fieldPos + 16));
-                const typeSlot nridSlot = ctx->read16(redoLogRecord->data(fieldPos + 20));
+            if constexpr (Mode::dump) {
+                const typeDba nridBdba = Mode::read32(redoLogRecord->data(fieldPos + 16));
+                const typeSlot nridSlot = Mode::read16(redoLogRecord->data(fieldPos + 20));
                 const uint8_t flag = *redoLogRecord->data(fieldPos + 26);
                 const uint8_t tabn = *redoLogRecord->data(fieldPos + 27);
                 const uint8_t lock = *redoLogRecord->data(fieldPos + 28);
@@ -1705,6 +1792,7 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void kdoOpCodeSKL(const Ctx* ctx, RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize) {
             if (unlikely(fieldSize < 20))
                 throw RedoLogException(50061, "too short field kdo OpCode SKL: " + std::to_string(fieldSize) + " offset: " +
@@ -1712,7 +1800,7 @@ namespace OpenLogReplicator {
 
             redoLogRecord->slot = *redoLogRecord->data(fieldPos + 27);
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 char flagStr[3]{"--"};
                 const uint8_t lock = *redoLogRecord->data(fieldPos + 29);
                 const uint8_t flag = *redoLogRecord->data(fieldPos + 28);
@@ -1725,7 +1813,7 @@ namespace OpenLogReplicator {
 
                 if ((flag & 0x01) != 0) {
                     uint8_t fwd[4];
-                    const uint16_t fwd2 = ctx->read16(redoLogRecord->data(fieldPos + 20));
+                    const uint16_t fwd2 = Mode::read16(redoLogRecord->data(fieldPos + 20));
                     memcpy(reinterpret_cast<void*>(fwd),
                            reinterpret_cast<const void*>(redoLogRecord->data(fieldPos + 16)), 4);
                     *ctx->dumpStream << "fwd: 0x" <<
@@ -1738,7 +1826,7 @@ namespace OpenLogReplicator {
 
                 if ((flag & 0x02) != 0) {
                     uint8_t bkw[4];
-                    const uint16_t bkw2 = ctx->read16(redoLogRecord->data(fieldPos + 26));
+                    const uint16_t bkw2 = Mode::read16(redoLogRecord->data(fieldPos + 26));
                     memcpy(reinterpret_cast<void*>(bkw),
                            reinterpret_cast<const void*>(redoLogRecord->data(fieldPos + 22)), 4);
                     *ctx->dumpStream << "bkw: 0x" <<
@@ -1751,6 +1839,7 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void kdoOpCodeQM(const Ctx* ctx, RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize) {
             if (unlikely(fieldSize < 24))
                 throw RedoLogException(50061, "too short field kdo OpCode QMI (1): " + std::to_string(fieldSize) + " offset: " +
@@ -1759,7 +1848,7 @@ namespace OpenLogReplicator {
             redoLogRecord->nRow = *redoLogRecord->data(fieldPos + 18);
             redoLogRecord->slotsDelta = fieldPos + 20;
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 const uint8_t tabn = *redoLogRecord->data(fieldPos + 16);
                 const uint8_t lock = *redoLogRecord->data(fieldPos + 17);
 
@@ -1773,17 +1862,18 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void ktub(const Ctx* ctx, RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize, bool isKtubl) {
             if (unlikely(fieldSize < 24))
                 throw RedoLogException(50061, "too short field ktub (1): " + std::to_string(fieldSize) + " offset: " +
                                               redoLogRecord->fileOffset.toString());
 
-            redoLogRecord->obj = ctx->read32(redoLogRecord->data(fieldPos + 0));
-            redoLogRecord->dataObj = ctx->read32(redoLogRecord->data(fieldPos + 4));
-            const uint32_t undo = ctx->read32(redoLogRecord->data(fieldPos + 12));
+            redoLogRecord->obj = Mode::read32(redoLogRecord->data(fieldPos + 0));
+            redoLogRecord->dataObj = Mode::read32(redoLogRecord->data(fieldPos + 4));
+            const uint32_t undo = Mode::read32(redoLogRecord->data(fieldPos + 12));
             redoLogRecord->opc = (static_cast<typeOp1>(*redoLogRecord->data(fieldPos + 16)) << 8) | *redoLogRecord->data(fieldPos + 17);
             redoLogRecord->slt = *redoLogRecord->data(fieldPos + 18);
-            redoLogRecord->flg = ctx->read16(redoLogRecord->data(fieldPos + 20));
+            redoLogRecord->flg = Mode::read16(redoLogRecord->data(fieldPos + 20));
 
             std::string ktuType {"ktubu"};
             std::string prevObj;
@@ -1799,8 +1889,8 @@ namespace OpenLogReplicator {
                 }
             }
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
-                const uint32_t tsn = ctx->read32(redoLogRecord->data(fieldPos + 8));
+            if constexpr (Mode::dump) {
+                const uint32_t tsn = Mode::read32(redoLogRecord->data(fieldPos + 8));
                 const typeRci rci = *redoLogRecord->data(fieldPos + 19);
 
                 if (ctx->version < RedoLogRecord::REDO_VERSION_19_0) {
@@ -1814,8 +1904,8 @@ namespace OpenLogReplicator {
                                      " objd: " << std::dec << redoLogRecord->dataObj <<
                                      " tsn: " << std::dec << tsn << postObj << '\n';
                 } else {
-                    const typeDba prevDba = ctx->read32(redoLogRecord->data(fieldPos + 12));
-                    const uint16_t wrp = ctx->read16(redoLogRecord->data(fieldPos + 22));
+                    const typeDba prevDba = Mode::read32(redoLogRecord->data(fieldPos + 12));
+                    const uint16_t wrp = Mode::read16(redoLogRecord->data(fieldPos + 22));
 
                     *ctx->dumpStream <<
                                      ktuType << " redo:" <<
@@ -1912,7 +2002,7 @@ namespace OpenLogReplicator {
                     userOnly = " No";
             }
 
-            if (ctx->dumpRedoLog < 1)
+            if constexpr (!Mode::dump)
                 return;
 
             if (ktubl) {
@@ -1923,9 +2013,9 @@ namespace OpenLogReplicator {
                 }
 
                 if (fieldSize == 28) {
-                    if (unlikely(ctx->dumpRedoLog >= 1)) {
-                        const uint16_t flg2 = ctx->read16(redoLogRecord->data(fieldPos + 24));
-                        auto buExtIdx = static_cast<int16_t>(ctx->read16(redoLogRecord->data(fieldPos + 26)));
+                    if constexpr (Mode::dump) {
+                        const uint16_t flg2 = Mode::read16(redoLogRecord->data(fieldPos + 24));
+                        auto buExtIdx = static_cast<int16_t>(Mode::read16(redoLogRecord->data(fieldPos + 26)));
 
                         if (ctx->version < RedoLogRecord::REDO_VERSION_19_0) {
                             *ctx->dumpStream <<
@@ -1954,16 +2044,16 @@ namespace OpenLogReplicator {
                         }
                     }
                 } else if (fieldSize >= 76) {
-                    if (unlikely(ctx->dumpRedoLog >= 1)) {
-                        const uint16_t flg2 = ctx->read16(redoLogRecord->data(fieldPos + 24));
-                        const auto buExtIdx = static_cast<int16_t>(ctx->read16(redoLogRecord->data(fieldPos + 26)));
-                        const typeUba prevCtlUba = ctx->read56(redoLogRecord->data(fieldPos + 28));
-                        const Scn prevCtlMaxCmtScn = ctx->readScn(redoLogRecord->data(fieldPos + 36));
-                        const Scn prevTxCmtScn = ctx->readScn(redoLogRecord->data(fieldPos + 44));
-                        const Scn txStartScn = ctx->readScn(redoLogRecord->data(fieldPos + 56));
-                        const uint32_t prevBrb = ctx->read32(redoLogRecord->data(fieldPos + 64));
-                        const uint32_t prevBcl = ctx->read32(redoLogRecord->data(fieldPos + 68));
-                        const uint32_t logonUser = ctx->read32(redoLogRecord->data(fieldPos + 72));
+                    if constexpr (Mode::dump) {
+                        const uint16_t flg2 = Mode::read16(redoLogRecord->data(fieldPos + 24));
+                        const auto buExtIdx = static_cast<int16_t>(Mode::read16(redoLogRecord->data(fieldPos + 26)));
+                        const typeUba prevCtlUba = Mode::read56(redoLogRecord->data(fieldPos + 28));
+                        const Scn prevCtlMaxCmtScn = Mode::readScn(redoLogRecord->data(fieldPos + 36));
+                        const Scn prevTxCmtScn = Mode::readScn(redoLogRecord->data(fieldPos + 44));
+                        const Scn txStartScn = Mode::readScn(redoLogRecord->data(fieldPos + 56));
+                        const uint32_t prevBrb = Mode::read32(redoLogRecord->data(fieldPos + 64));
+                        const uint32_t prevBcl = Mode::read32(redoLogRecord->data(fieldPos + 68));
+                        const uint32_t logonUser = Mode::read32(redoLogRecord->data(fieldPos + 72));
 
                         if (ctx->version < RedoLogRecord::REDO_VERSION_12_2) {
                             *ctx->dumpStream <<
@@ -2032,7 +2122,7 @@ namespace OpenLogReplicator {
                 }
             } else {
                 // KTUBU
-                if (unlikely(ctx->dumpRedoLog >= 1)) {
+                if constexpr (Mode::dump) {
                     if (ctx->version < RedoLogRecord::REDO_VERSION_19_0) {
                         *ctx->dumpStream <<
                                          "Undo type:  " << undoType << " " <<
@@ -2047,8 +2137,8 @@ namespace OpenLogReplicator {
                                          "             0x" << std::setfill('0') << std::setw(8) << std::hex << undo << '\n';
 
                         if ((redoLogRecord->flg & FLG_BUEXT) != 0) {
-                            const uint16_t flg2 = ctx->read16(redoLogRecord->data(fieldPos + 24));
-                            auto buExtIdx = static_cast<int16_t>(ctx->read16(redoLogRecord->data(fieldPos + 26)));
+                            const uint16_t flg2 = Mode::read16(redoLogRecord->data(fieldPos + 24));
+                            auto buExtIdx = static_cast<int16_t>(Mode::read16(redoLogRecord->data(fieldPos + 26)));
 
                             *ctx->dumpStream <<
                                              "BuExt idx: " << std::dec << buExtIdx <<
@@ -2068,8 +2158,9 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void dumpMemory(const Ctx* ctx, const RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize) {
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 *ctx->dumpStream << "Dump of memory from 0xXXXXXXXXXXXXXXXX to 0xXXXXXXXXXXXXXXXX\n";
 
                 const typePos start = fieldPos & 0xFFF0;
@@ -2084,7 +2175,7 @@ namespace OpenLogReplicator {
                             if (first == -1)
                                 first = j;
                             last = j;
-                            const uint32_t val = ctx->read32(redoLogRecord->data(i + (j * 4)));
+                            const uint32_t val = Mode::read32(redoLogRecord->data(i + (j * 4)));
                             *ctx->dumpStream << " " << std::setfill('0') << std::setw(8) << std::hex << std::uppercase << val;
                         } else {
                             *ctx->dumpStream << "         ";
@@ -2104,6 +2195,7 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void dumpCols(const Ctx* ctx, const uint8_t* data, typeCCExt colNum, typeSize fieldSize, bool isNull, bool supp = false) {
             if (supp)
                 *ctx->dumpStream << "@@";
@@ -2138,6 +2230,7 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void dumpColVector(const Ctx* ctx, const RedoLogRecord* redoLogRecord, const uint8_t* data, typeCCExt colNum) {
             uint pos = 0;
 
@@ -2149,17 +2242,18 @@ namespace OpenLogReplicator {
                 const bool isNull = (fieldSize == 0xFF);
 
                 if (fieldSize == 0xFE) {
-                    fieldSize = ctx->read16(data + pos);
+                    fieldSize = Mode::read16(data + pos);
                     pos += 2;
                 }
 
-                dumpCols(ctx, data + pos, colNum + k, fieldSize, isNull);
+                dumpCols<Mode>(ctx, data + pos, colNum + k, fieldSize, isNull);
 
                 if (!isNull)
                     pos += fieldSize;
             }
         }
 
+        template<typename Mode>
         static void dumpCompressed(const Ctx* ctx, const RedoLogRecord* redoLogRecord, const uint8_t* data, typeSize fieldSize) {
             std::ostringstream ss;
             ss << "kdrhccnt=" << std::dec << static_cast<uint>(redoLogRecord->cc) << ",full row:";
@@ -2178,18 +2272,19 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void dumpRows(const Ctx* ctx, const RedoLogRecord* redoLogRecord, const uint8_t* data) {
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 typePos pos = 0;
                 char fbStr[9]{"--------"};
 
                 for (typeCC r = 0; r < redoLogRecord->nRow; ++r) {
                     *ctx->dumpStream << "slot[" << std::dec << static_cast<uint>(r) << "]: " << std::dec <<
-                                     ctx->read16(redoLogRecord->data(redoLogRecord->slotsDelta + (r * 2))) << '\n';
+                                     Mode::read16(redoLogRecord->data(redoLogRecord->slotsDelta + (r * 2))) << '\n';
                     processFbFlags(data[pos + 0], fbStr);
                     const uint8_t lb = data[pos + 1];
                     const typeCC jcc = data[pos + 2];
-                    const uint16_t tl = ctx->read16(redoLogRecord->data(redoLogRecord->rowSizesDelta + (r * 2)));
+                    const uint16_t tl = Mode::read16(redoLogRecord->data(redoLogRecord->rowSizesDelta + (r * 2)));
 
                     *ctx->dumpStream << "tl: " << std::dec << tl <<
                                      " fb: " << fbStr <<
@@ -2210,11 +2305,11 @@ namespace OpenLogReplicator {
                         const bool isNull = (fieldSize == 0xFF);
 
                         if (fieldSize == 0xFE) {
-                            fieldSize = ctx->read16(data + pos);
+                            fieldSize = Mode::read16(data + pos);
                             pos += 2;
                         }
 
-                        dumpCols(ctx, data + pos, k, fieldSize, isNull);
+                        dumpCols<Mode>(ctx, data + pos, k, fieldSize, isNull);
 
                         if (!isNull)
                             pos += fieldSize;
@@ -2223,6 +2318,7 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void dumpHex(const Ctx* ctx, const RedoLogRecord* redoLogRecord) {
             std::string header = "## 0: [" + redoLogRecord->fileOffset.toString() + "] " + std::to_string(redoLogRecord->fieldSizesDelta);
             *ctx->dumpStream << header;
@@ -2235,7 +2331,7 @@ namespace OpenLogReplicator {
 
             typePos fieldPosLocal = redoLogRecord->fieldPos;
             for (typeField i = 1; i <= redoLogRecord->fieldCnt; ++i) {
-                const typeSize fieldSize = ctx->read16(redoLogRecord->data(redoLogRecord->fieldSizesDelta + (i * 2)));
+                const typeSize fieldSize = Mode::read16(redoLogRecord->data(redoLogRecord->fieldSizesDelta + (i * 2)));
                 header = "## " + std::to_string(i) + ": [" + (redoLogRecord->fileOffset + fieldPosLocal).toString() + "] " + std::to_string(fieldSize) + "   ";
                 *ctx->dumpStream << header;
                 if (header.length() < 36)
@@ -2262,8 +2358,9 @@ namespace OpenLogReplicator {
         }
 
     public:
+        template<typename Mode>
         static void process(const Ctx* ctx, RedoLogRecord* redoLogRecord) {
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 bool encrypted = false;
                 if ((redoLogRecord->typ & 0x80) != 0)
                     encrypted = true;
@@ -2339,7 +2436,7 @@ namespace OpenLogReplicator {
                 }
 
                 if (ctx->dumpRawData != 0)
-                    dumpHex(ctx, redoLogRecord);
+                    dumpHex<Mode>(ctx, redoLogRecord);
             }
         }
     };
@@ -26,6 +26,7 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 namespace OpenLogReplicator {
     class OpCode0501 final : public OpCode {
     protected:
+        template<typename Mode>
         static void init(const Ctx* ctx, RedoLogRecord* redoLogRecord) {
             typePos fieldPos = 0;
             typeField fieldNum = 0;
@@ -40,23 +41,24 @@ namespace OpenLogReplicator {
             if (unlikely(fieldSize < 8))
                 throw RedoLogException(50061, "too short field 5.1.2: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
 
-            redoLogRecord->obj = ctx->read32(redoLogRecord->data(fieldPos + 0));
-            redoLogRecord->dataObj = ctx->read32(redoLogRecord->data(fieldPos + 4));
+            redoLogRecord->obj = Mode::read32(redoLogRecord->data(fieldPos + 0));
+            redoLogRecord->dataObj = Mode::read32(redoLogRecord->data(fieldPos + 4));
         }
 
+        template<typename Mode>
         static void ktudb(const Ctx* ctx, RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize) {
             if (unlikely(fieldSize < 20))
                 throw RedoLogException(50061, "too short field ktudb: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
 
-            redoLogRecord->xid = Xid(static_cast<typeUsn>(ctx->read16(redoLogRecord->data(fieldPos + 8))),
-                                         ctx->read16(redoLogRecord->data(fieldPos + 10)),
-                                         ctx->read32(redoLogRecord->data(fieldPos + 12)));
+            redoLogRecord->xid = Xid(static_cast<typeUsn>(Mode::read16(redoLogRecord->data(fieldPos + 8))),
+                                         Mode::read16(redoLogRecord->data(fieldPos + 10)),
+                                         Mode::read32(redoLogRecord->data(fieldPos + 12)));
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
-                const uint16_t siz = ctx->read16(redoLogRecord->data(fieldPos + 0));
-                const uint16_t spc = ctx->read16(redoLogRecord->data(fieldPos + 2));
-                const uint16_t flgKtudb = ctx->read16(redoLogRecord->data(fieldPos + 4));
-                const uint16_t seq = ctx->read16(redoLogRecord->data(fieldPos + 16));
+            if constexpr (Mode::dump) {
+                const uint16_t siz = Mode::read16(redoLogRecord->data(fieldPos + 0));
+                const uint16_t spc = Mode::read16(redoLogRecord->data(fieldPos + 2));
+                const uint16_t flgKtudb = Mode::read16(redoLogRecord->data(fieldPos + 4));
+                const uint16_t seq = Mode::read16(redoLogRecord->data(fieldPos + 16));
                 const uint8_t rec = *redoLogRecord->data(fieldPos + 18);
 
                 *ctx->dumpStream << "ktudb redo:" <<
@@ -70,28 +72,30 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void kteoputrn(const Ctx* ctx, const RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize) {
             if (unlikely(fieldSize < 4))
                 throw RedoLogException(50061, "too short field kteoputrn: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
-                const typeObj newDataObj = ctx->read32(redoLogRecord->data(fieldPos + 0));
+            if constexpr (Mode::dump) {
+                const typeObj newDataObj = Mode::read32(redoLogRecord->data(fieldPos + 0));
                 *ctx->dumpStream << "kteoputrn - undo operation for flush for truncate \n";
                 *ctx->dumpStream << "newobjd: 0x" << std::hex << newDataObj << " \n";
             }
         }
 
+        template<typename Mode>
         static void kdilk(const Ctx* ctx, const RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize) {
             if (unlikely(fieldSize < 20))
                 throw RedoLogException(50061, "too short field kdilk: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 const uint8_t code = *redoLogRecord->data(fieldPos + 0);
                 const uint8_t itl = *redoLogRecord->data(fieldPos + 1);
                 const uint8_t kdxlkflg = *redoLogRecord->data(fieldPos + 2);
-                const uint32_t indexid = ctx->read32(redoLogRecord->data(fieldPos + 4));
-                const uint32_t block = ctx->read32(redoLogRecord->data(fieldPos + 8));
-                const auto sdc = static_cast<int32_t>(ctx->read32(redoLogRecord->data(fieldPos + 12)));
+                const uint32_t indexid = Mode::read32(redoLogRecord->data(fieldPos + 4));
+                const uint32_t block = Mode::read32(redoLogRecord->data(fieldPos + 8));
+                const auto sdc = static_cast<int32_t>(Mode::read32(redoLogRecord->data(fieldPos + 12)));
 
                 if (ctx->version >= RedoLogRecord::REDO_VERSION_23_0)
                     *ctx->dumpStream << '\n';
@@ -125,7 +129,7 @@ namespace OpenLogReplicator {
                 }
 
                 if (fieldSize >= 24) {
-                    const uint16_t keySizes = ctx->read16(redoLogRecord->data(fieldPos + 20));
+                    const uint16_t keySizes = Mode::read16(redoLogRecord->data(fieldPos + 20));
 
                     if (fieldSize < keySizes * 2 + 24) {
                         ctx->warning(70001, "too short field kdilk key sizes(" + std::to_string(keySizes) + "): " +
@@ -135,7 +139,7 @@ namespace OpenLogReplicator {
                     *ctx->dumpStream << "number of keys: " << std::dec << keySizes << " \n";
                     *ctx->dumpStream << "key sizes:\n";
                     for (uint16_t j = 0; j < keySizes; ++j) {
-                        const uint16_t key = ctx->read16(redoLogRecord->data(fieldPos + 24 + (j * 2)));
+                        const uint16_t key = Mode::read16(redoLogRecord->data(fieldPos + 24 + (j * 2)));
                         *ctx->dumpStream << " " << std::dec << key;
                         if ((j % 128) == 127 && j != keySizes - 1)
                             *ctx->dumpStream << '\n';
@@ -145,12 +149,13 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void rowDeps(const Ctx* ctx, const RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize) {
             if (fieldSize < 8)
                 ctx->warning(70001, "too short field row dependencies: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
-                const Scn dscn = ctx->readScn(redoLogRecord->data(fieldPos + 0));
+            if constexpr (Mode::dump) {
+                const Scn dscn = Mode::readScn(redoLogRecord->data(fieldPos + 0));
                 if (ctx->version < RedoLogRecord::REDO_VERSION_12_2)
                     *ctx->dumpStream << "dscn: " << dscn.to48() << '\n';
                 else
@@ -158,6 +163,7 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void suppLog(Ctx* ctx, RedoLogRecord* redoLogRecord, typeField& fieldNum, typePos& fieldPos, typeSize& fieldSize) {
             typeSize suppLogSize = 0;
             typeField suppLogFieldCnt = 0;
@@ -171,11 +177,11 @@ namespace OpenLogReplicator {
             ++suppLogFieldCnt;
             suppLogSize += (fieldSize + 3) & 0xFFFC;
             redoLogRecord->suppLogFb = *redoLogRecord->data(fieldPos + 1);
-            redoLogRecord->suppLogCC = ctx->read16(redoLogRecord->data(fieldPos + 2));
-            redoLogRecord->suppLogBefore = ctx->read16(redoLogRecord->data(fieldPos + 6));
-            redoLogRecord->suppLogAfter = ctx->read16(redoLogRecord->data(fieldPos + 8));
+            redoLogRecord->suppLogCC = Mode::read16(redoLogRecord->data(fieldPos + 2));
+            redoLogRecord->suppLogBefore = Mode::read16(redoLogRecord->data(fieldPos + 6));
+            redoLogRecord->suppLogAfter = Mode::read16(redoLogRecord->data(fieldPos + 8));
 
-            if (unlikely(ctx->dumpRedoLog >= 2)) {
+            if (Mode::dump && ctx->dumpRedoLog >= 2) {
                 const uint8_t suppLogType = *redoLogRecord->data(fieldPos + 0);
 
                 *ctx->dumpStream <<
@@ -187,9 +193,9 @@ namespace OpenLogReplicator {
             }
 
             if (fieldSize >= 26) {
-                redoLogRecord->suppLogBdba = ctx->read32(redoLogRecord->data(fieldPos + 20));
-                redoLogRecord->suppLogSlot = ctx->read16(redoLogRecord->data(fieldPos + 24));
-                if (unlikely(ctx->dumpRedoLog >= 2)) {
+                redoLogRecord->suppLogBdba = Mode::read32(redoLogRecord->data(fieldPos + 20));
+                redoLogRecord->suppLogSlot = Mode::read16(redoLogRecord->data(fieldPos + 24));
+                if (Mode::dump && ctx->dumpRedoLog >= 2) {
                     *ctx->dumpStream <<
                                      "@@ supp log bdba: 0x" << std::setfill('0') << std::setw(8) << std::hex << redoLogRecord->suppLogBdba <<
                                      "." << std::hex << redoLogRecord->suppLogSlot << '\n';
@@ -221,8 +227,8 @@ namespace OpenLogReplicator {
 
                 ++suppLogFieldCnt;
                 suppLogSize += (fieldSize + 3) & 0xFFFC;
-                if (unlikely(ctx->dumpRedoLog >= 2))
-                    dumpCols(ctx, redoLogRecord->data(fieldPos), ctx->read16(colNumsSupp), fieldSize, false, true);
+                if (Mode::dump && ctx->dumpRedoLog >= 2)
+                    dumpCols<Mode>(ctx, redoLogRecord->data(fieldPos), Mode::read16(colNumsSupp), fieldSize, false, true);
                 colNumsSupp += 2;
             }
 
@@ -230,8 +236,9 @@ namespace OpenLogReplicator {
             ctx->suppLogSize += suppLogSize;
         }
 
+        template<typename Mode>
         static void opc0A16(const Ctx* ctx, RedoLogRecord* redoLogRecord, typeField& fieldNum, typePos& fieldPos, typeSize& fieldSize) {
-            kdilk(ctx, redoLogRecord, fieldPos, fieldSize);
+            kdilk<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
 
             if (!RedoLogRecord::nextFieldOpt(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x050103))
                 return;
@@ -240,7 +247,7 @@ namespace OpenLogReplicator {
             redoLogRecord->indKey = fieldPos;
             redoLogRecord->indKeySize = fieldSize;
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 *ctx->dumpStream << "key :(" << std::dec << fieldSize << "): ";
 
                 if (fieldSize > 20)
@@ -261,7 +268,7 @@ namespace OpenLogReplicator {
             redoLogRecord->indKeyData = fieldPos;
             redoLogRecord->indKeyDataSize = fieldSize;
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 *ctx->dumpStream << "keydata/bitmap: (" << std::dec << fieldSize << "): ";
 
                 if (fieldSize > 20)
@@ -279,7 +286,7 @@ namespace OpenLogReplicator {
                 return;
             // Field: 7
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 *ctx->dumpStream << "selflock: (" << std::dec << fieldSize << "): ";
 
                 if (fieldSize > 20)
@@ -297,7 +304,7 @@ namespace OpenLogReplicator {
                 return;
             // Field: 8
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 *ctx->dumpStream << "bitmap: (" << std::dec << fieldSize << "): ";
 
                 if (fieldSize > 20)
@@ -312,16 +319,17 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void opc0B01(Ctx* ctx, RedoLogRecord* redoLogRecord, typeField& fieldNum, typePos& fieldPos, typeSize& fieldSize) {
-            kdoOpCode(ctx, redoLogRecord, fieldPos, fieldSize);
+            kdoOpCode<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
             const typeCC* colNums = nullptr;
             const typeCC* nulls = redoLogRecord->data(redoLogRecord->nullsDelta);
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 if ((redoLogRecord->op & 0x1F) == RedoLogRecord::OP_QMD) {
                     for (typeCC i = 0; i < redoLogRecord->nRow; ++i)
                         *ctx->dumpStream << "slot[" << static_cast<uint>(i) << "]: " << std::dec <<
-                                         ctx->read16(redoLogRecord->data(redoLogRecord->slotsDelta + (i * 2))) << '\n';
+                                         Mode::read16(redoLogRecord->data(redoLogRecord->slotsDelta + (i * 2))) << '\n';
                 }
             }
 
@@ -337,8 +345,8 @@ namespace OpenLogReplicator {
                     RedoLogRecord::nextField(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x050108);
 
                     redoLogRecord->rowData = fieldPos;
-                    if (unlikely(ctx->dumpRedoLog >= 1)) {
-                        dumpColVector(ctx, redoLogRecord, redoLogRecord->data(fieldPos), ctx->read16(colNums));
+                    if constexpr (Mode::dump) {
+                        dumpColVector<Mode>(ctx, redoLogRecord, redoLogRecord->data(fieldPos), Mode::read16(colNums));
                     }
                 } else {
                     redoLogRecord->rowData = fieldNum + 1;
@@ -352,8 +360,8 @@ namespace OpenLogReplicator {
                             RedoLogRecord::nextField(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x050109);
                         }
 
-                        if (unlikely(ctx->dumpRedoLog >= 1))
-                            dumpCols(ctx, redoLogRecord->data(fieldPos), ctx->read16(colNums), fieldSize, (*nulls & bits) != 0);
+                        if constexpr (Mode::dump)
+                            dumpCols<Mode>(ctx, redoLogRecord->data(fieldPos), Mode::read16(colNums), fieldSize, (*nulls & bits) != 0);
                         colNums += 2;
                         bits <<= 1;
                         if (bits == 0) {
@@ -365,19 +373,19 @@ namespace OpenLogReplicator {
                     if ((redoLogRecord->op & RedoLogRecord::OP_ROWDEPENDENCIES) != 0) {
                         RedoLogRecord::skipEmptyFields(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize);
                         RedoLogRecord::nextField(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x05010A);
-                        rowDeps(ctx, redoLogRecord, fieldPos, fieldSize);
+                        rowDeps<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
                     }
 
-                    suppLog(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize);
+                    suppLog<Mode>(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize);
                 }
 
             } else if ((redoLogRecord->op & 0x1F) == RedoLogRecord::OP_DRP) {
                 if ((redoLogRecord->op & RedoLogRecord::OP_ROWDEPENDENCIES) != 0) {
                     RedoLogRecord::nextField(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x05010B);
-                    rowDeps(ctx, redoLogRecord, fieldPos, fieldSize);
+                    rowDeps<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
                 }
 
-                suppLog(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize);
+                suppLog<Mode>(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize);
 
             } else if ((redoLogRecord->op & 0x1F) == RedoLogRecord::OP_IRP || (redoLogRecord->op & 0x1F) == RedoLogRecord::OP_ORP) {
                 if (unlikely(nulls == nullptr))
@@ -391,8 +399,8 @@ namespace OpenLogReplicator {
 
                     if (fieldSize == redoLogRecord->sizeDelt && redoLogRecord->cc > 1) {
                         redoLogRecord->compressed = true;
-                        if (unlikely(ctx->dumpRedoLog >= 1))
-                            dumpCompressed(ctx, redoLogRecord, redoLogRecord->data(fieldPos), fieldSize);
+                        if constexpr (Mode::dump)
+                            dumpCompressed<Mode>(ctx, redoLogRecord, redoLogRecord->data(fieldPos), fieldSize);
                     } else {
                         uint8_t bits = 1;
                         for (typeCC i = 0; i < redoLogRecord->cc; ++i) {
@@ -405,8 +413,8 @@ namespace OpenLogReplicator {
                                 throw RedoLogException(50061, "too short field for nulls: " + std::to_string(fieldSize) + " offset: " +
                                                               redoLogRecord->fileOffset.toString());
 
-                            if (unlikely(ctx->dumpRedoLog >= 1))
-                                dumpCols(ctx, redoLogRecord->data(fieldPos), i, fieldSize, (*nulls & bits) != 0);
+                            if constexpr (Mode::dump)
+                                dumpCols<Mode>(ctx, redoLogRecord->data(fieldPos), i, fieldSize, (*nulls & bits) != 0);
                             bits <<= 1;
                             if (bits == 0) {
                                 bits = 1;
@@ -418,10 +426,10 @@ namespace OpenLogReplicator {
 
                 if ((redoLogRecord->op & RedoLogRecord::OP_ROWDEPENDENCIES) != 0) {
                     RedoLogRecord::nextField(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x05010E);
-                    rowDeps(ctx, redoLogRecord, fieldPos, fieldSize);
+                    rowDeps<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
                 }
 
-                suppLog(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize);
+                suppLog<Mode>(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize);
 
             } else if ((redoLogRecord->op & 0x1F) == RedoLogRecord::OP_QMI) {
                 RedoLogRecord::nextField(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x05010F);
@@ -429,30 +437,31 @@ namespace OpenLogReplicator {
 
                 RedoLogRecord::nextField(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x050110);
                 redoLogRecord->rowData = fieldNum;
-                if (unlikely(ctx->dumpRedoLog >= 1))
-                    dumpRows(ctx, redoLogRecord, redoLogRecord->data(fieldPos));
+                if constexpr (Mode::dump)
+                    dumpRows<Mode>(ctx, redoLogRecord, redoLogRecord->data(fieldPos));
 
             } else if ((redoLogRecord->op & 0x1F) == RedoLogRecord::OP_LMN) {
-                suppLog(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize);
+                suppLog<Mode>(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize);
 
             } else if ((redoLogRecord->op & 0x1F) == RedoLogRecord::OP_LKR) {
-                suppLog(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize);
+                suppLog<Mode>(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize);
 
             } else if ((redoLogRecord->op & 0x1F) == RedoLogRecord::OP_CFA) {
-                suppLog(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize);
+                suppLog<Mode>(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize);
             }
         }
 
+        template<typename Mode>
         static void opc0D17(const Ctx* ctx, RedoLogRecord* redoLogRecord, typeField& fieldNum, typePos& fieldPos, typeSize& fieldSize) {
             if (unlikely(fieldSize < 20))
                 throw RedoLogException(50061, "too short field OPC 0D17: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
-                redoLogRecord->bdba = ctx->read32(redoLogRecord->data(fieldPos + 0));
-                const uint32_t fcls = ctx->read32(redoLogRecord->data(fieldPos + 4));
-                const typeDba l2dba = ctx->read32(redoLogRecord->data(fieldPos + 8));
-                const uint32_t scls = ctx->read32(redoLogRecord->data(fieldPos + 12));
-                const uint32_t offset = ctx->read32(redoLogRecord->data(fieldPos + 16));
+            if constexpr (Mode::dump) {
+                redoLogRecord->bdba = Mode::read32(redoLogRecord->data(fieldPos + 0));
+                const uint32_t fcls = Mode::read32(redoLogRecord->data(fieldPos + 4));
+                const typeDba l2dba = Mode::read32(redoLogRecord->data(fieldPos + 8));
+                const uint32_t scls = Mode::read32(redoLogRecord->data(fieldPos + 12));
+                const uint32_t offset = Mode::read32(redoLogRecord->data(fieldPos + 16));
 
                 *ctx->dumpStream << "Undo for Lev1 Bitmap Block\n";
                 *ctx->dumpStream << "L1 DBA:  0x" << std::setfill('0') << std::setw(8) << std::hex << redoLogRecord->bdba <<
@@ -470,12 +479,12 @@ namespace OpenLogReplicator {
                 return;
             }
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 *ctx->dumpStream << "Redo on Level1 Bitmap Block\n";
 
                 if (fieldSize >= 16) {
-                    const uint32_t len = ctx->read32(redoLogRecord->data(fieldPos + 4));
-                    const uint32_t offset = ctx->read32(redoLogRecord->data(fieldPos + 12));
+                    const uint32_t len = Mode::read32(redoLogRecord->data(fieldPos + 4));
+                    const uint32_t offset = Mode::read32(redoLogRecord->data(fieldPos + 12));
                     const uint64_t netstate = 0; // Random value observed
 
                     *ctx->dumpStream << "Redo for state change\n";
@@ -487,69 +496,83 @@ namespace OpenLogReplicator {
         }
 
     public:
+        template<typename Mode>
         static void process0501(Ctx* ctx, RedoLogRecord* redoLogRecord) {
-            init(ctx, redoLogRecord);
-            OpCode::process(ctx, redoLogRecord);
+            process0501<Mode>(ctx, redoLogRecord, [](const RedoLogRecord*) {
+                return false;
+            });
+        }
+
+        // The undo data is decoded unless skip tells otherwise after the object is known
+        template<typename Mode, typename Skip>
+        static void process0501(Ctx* ctx, RedoLogRecord* redoLogRecord, Skip skip) {
+            init<Mode>(ctx, redoLogRecord);
+            OpCode::process<Mode>(ctx, redoLogRecord);
             typePos fieldPos = 0;
             typeField fieldNum = 0;
             typeSize fieldSize = 0;
 
             RedoLogRecord::nextField(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x050112);
             // Field: 1
-            ktudb(ctx, redoLogRecord, fieldPos, fieldSize);
+            ktudb<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
 
             if (!RedoLogRecord::nextFieldOpt(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x050113))
                 return;
             // Field: 2
-            ktub(ctx, redoLogRecord, fieldPos, fieldSize, true);
+            ktub<Mode>(ctx, redoLogRecord, fieldPos, fieldSize, true);
 
             // Incomplete ctx: don't analyze further
             if ((redoLogRecord->flg & (FLG_MULTIBLOCKUNDOHEAD | FLG_MULTIBLOCKUNDOTAIL | FLG_MULTIBLOCKUNDOMID)) != 0)
                 return;
 
+            if (skip(static_cast<const RedoLogRecord*>(redoLogRecord))) {
+                redoLogRecord->partial = true;
+                return;
+            }
+
             if (!RedoLogRecord::nextFieldOpt(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x050114))
                 return;
             // Field: 3
 
             switch (redoLogRecord->opc) {
                 case 0x0A16:
-                    ktbRedo(ctx, redoLogRecord, fieldPos, fieldSize);
+                    ktbRedo<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
 
                     if (!RedoLogRecord::nextFieldOpt(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x050115))
                         return;
                     // Field: 4
 
-                    opc0A16(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize);
+                    opc0A16<Mode>(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize);
                     break;
 
                 case 0x0B01:
-                    ktbRedo(ctx, redoLogRecord, fieldPos, fieldSize);
+                    ktbRedo<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
 
                     if (!RedoLogRecord::nextFieldOpt(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x050116))
                         return;
                     // Field: 4
 
-                    opc0B01(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize);
+                    opc0B01<Mode>(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize);
                     break;
 
                 case 0x1A01:
-                    if (unlikely(ctx->dumpRedoLog >= 1)) {
+                    if constexpr (Mode::dump) {
                         *ctx->dumpStream << "KDLI undo record:\n";
                     }
-                    ktbRedo(ctx, redoLogRecord, fieldPos, fieldSize);
+                    ktbRedo<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
 
                     if (!RedoLogRecord::nextFieldOpt(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x05011B))
                         return;
                     // Field: 4
-                    kdliCommon(ctx, redoLogRecord, fieldPos, fieldSize);
+                    kdliCommon<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
 
                     if (!RedoLogRecord::nextFieldOpt(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x05011C))
                         return;
-                    kdli(ctx, redoLogRecord, fieldPos, fieldSize);
+                    kdli<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
                     break;
 
                 case 0x0E08:
-                    kteoputrn(ctx, redoLogRecord, fieldPos, fieldSize);
+                    kteoputrn<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
                     break;
             }
         }
@@ -28,19 +28,20 @@ namespace OpenLogReplicator {
 
     class OpCode0502 final : public OpCode {
     protected:
+        template<typename Mode>
         static void kteop(const Ctx* ctx, const RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize) {
             if (unlikely(fieldSize < 36))
                 throw RedoLogException(50061, "too short field kteop: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
-                const uint32_t highwater = ctx->read32(redoLogRecord->data(fieldPos + 16));
-                const uint32_t ext = ctx->read32(redoLogRecord->data(fieldPos + 4));
+            if constexpr (Mode::dump) {
+                const uint32_t highwater = Mode::read32(redoLogRecord->data(fieldPos + 16));
+                const uint32_t ext = Mode::read32(redoLogRecord->data(fieldPos + 4));
                 const typeBlk blk = 0; // TODO: find field position/size
-                const uint32_t extSize = ctx->read32(redoLogRecord->data(fieldPos + 12));
+                const uint32_t extSize = Mode::read32(redoLogRecord->data(fieldPos + 12));
                 const uint32_t blocksFreelist = 0; // TODO: find field position/size
                 const uint32_t blocksBelow = 0; // TODO: find field position/size
                 const typeBlk mapblk = 0; // TODO: find field position/size
-                const uint32_t offset = ctx->read32(redoLogRecord->data(fieldPos + 24));
+                const uint32_t offset = Mode::read32(redoLogRecord->data(fieldPos + 24));
 
                 *ctx->dumpStream << "kteop redo - redo operation on extent map\n";
                 *ctx->dumpStream << "   SETHWM:      " <<
@@ -56,23 +57,24 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void ktudh(const Ctx* ctx, RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize) {
             if (unlikely(fieldSize < 32))
                 throw RedoLogException(50061, "too short field ktudh: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
 
             redoLogRecord->xid = Xid(redoLogRecord->usn,
-                                         ctx->read16(redoLogRecord->data(fieldPos + 0)),
-                                         ctx->read32(redoLogRecord->data(fieldPos + 4)));
-            redoLogRecord->flg = ctx->read16(redoLogRecord->data(fieldPos + 16));
+                                         Mode::read16(redoLogRecord->data(fieldPos + 0)),
+                                         Mode::read32(redoLogRecord->data(fieldPos + 4)));
+            redoLogRecord->flg = Mode::read16(redoLogRecord->data(fieldPos + 16));
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
-                const typeUba uba = ctx->read56(redoLogRecord->data(fieldPos + 8));
+            if constexpr (Mode::dump) {
+                const typeUba uba = Mode::read56(redoLogRecord->data(fieldPos + 8));
                 const uint8_t fbi = *redoLogRecord->data(fieldPos + 20);
-                const uint16_t siz = ctx->read16(redoLogRecord->data(fieldPos + 18));
+                const uint16_t siz = Mode::read16(redoLogRecord->data(fieldPos + 18));
 
-                const Xid pXid = Xid(static_cast<typeUsn>(ctx->read16(redoLogRecord->data(fieldPos + 24))),
-                                             ctx->read16(redoLogRecord->data(fieldPos + 26)),
-                                             ctx->read32(redoLogRecord->data(fieldPos + 28)));
+                const Xid pXid = Xid(static_cast<typeUsn>(Mode::read16(redoLogRecord->data(fieldPos + 24))),
+                                             Mode::read16(redoLogRecord->data(fieldPos + 26)),
+                                             Mode::read32(redoLogRecord->data(fieldPos + 28)));
 
                 *ctx->dumpStream << "ktudh redo:" <<
                                  " slt: 0x" << std::setfill('0') << std::setw(4) << std::hex << static_cast<uint>(redoLogRecord->xid.slt()) <<
@@ -93,12 +95,13 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void pdb(const Ctx* ctx, const RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize) {
             if (unlikely(fieldSize < 4))
                 throw RedoLogException(50061, "too short field pdb: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
-                const uint32_t pdbId = ctx->read32(redoLogRecord->data(fieldPos + 0));
+            if constexpr (Mode::dump) {
+                const uint32_t pdbId = Mode::read32(redoLogRecord->data(fieldPos + 0));
 
                 *ctx->dumpStream << "       " <<
                                  " pdbid:" << std::dec << pdbId;
@@ -106,33 +109,34 @@ namespace OpenLogReplicator {
         }
 
     public:
+        template<typename Mode>
         static void process0502(const Ctx* ctx, RedoLogRecord* redoLogRecord) {
-            OpCode::process(ctx, redoLogRecord);
+            OpCode::process<Mode>(ctx, redoLogRecord);
             typePos fieldPos = 0;
             typeField fieldNum = 0;
             typeSize fieldSize = 0;
 
             RedoLogRecord::nextField(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x050201);
             // Field: 1
-            ktudh(ctx, redoLogRecord, fieldPos, fieldSize);
+            ktudh<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
 
             if (ctx->version >= RedoLogRecord::REDO_VERSION_12_1) {
                 // Field: 2
                 if (RedoLogRecord::nextFieldOpt(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x050202)) {
                     if (fieldSize == 4) {
                         // Field: 2
-                        pdb(ctx, redoLogRecord, fieldPos, fieldSize);
+                        pdb<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
                     } else {
-                        kteop(ctx, redoLogRecord, fieldPos, fieldSize);
+                        kteop<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
 
                         // Field: 3
                         if (RedoLogRecord::nextFieldOpt(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x050203)) {
-                            pdb(ctx, redoLogRecord, fieldPos, fieldSize);
+                            pdb<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
                         }
                     }
                 }
 
-                if (unlikely(ctx->dumpRedoLog >= 1))
+                if constexpr (Mode::dump)
                     *ctx->dumpStream << '\n';
             }
         }
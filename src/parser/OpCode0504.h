@@ -26,18 +26,19 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 namespace OpenLogReplicator {
     class OpCode0504 final : public OpCode {
     protected:
+        template<typename Mode>
         static void ktucm(const Ctx* ctx, RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize) {
             if (unlikely(fieldSize < 20))
                 throw RedoLogException(50061, "too short field ktucm: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
 
             redoLogRecord->xid = Xid(redoLogRecord->usn,
-                                         ctx->read16(redoLogRecord->data(fieldPos + 0)),
-                                         ctx->read32(redoLogRecord->data(fieldPos + 4)));
+                                         Mode::read16(redoLogRecord->data(fieldPos + 0)),
+                                         Mode::read32(redoLogRecord->data(fieldPos + 4)));
             redoLogRecord->flg = *redoLogRecord->data(fieldPos + 16);
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
-                const uint16_t srt = ctx->read16(redoLogRecord->data(fieldPos + 8));  // TODO: find field position/size
-                const uint32_t sta = ctx->read32(redoLogRecord->data(fieldPos + 12));
+            if constexpr (Mode::dump) {
+                const uint16_t srt = Mode::read16(redoLogRecord->data(fieldPos + 8));  // TODO: find field position/size
+                const uint32_t sta = Mode::read32(redoLogRecord->data(fieldPos + 12));
 
                 *ctx->dumpStream << "ktucm redo: slt: 0x" << std::setfill('0') << std::setw(4) << std::hex <<
                                  static_cast<uint64_t>(redoLogRecord->xid.slt()) <<
@@ -48,14 +49,15 @@ namespace OpenLogReplicator {
             }
         }
 
+        template<typename Mode>
         static void ktucf(const Ctx* ctx, const RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize) {
             if (unlikely(fieldSize < 16))
                 throw RedoLogException(50061, "too short field ktucf: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
-                const typeUba uba = ctx->read56(redoLogRecord->data(fieldPos + 0));
-                const uint16_t ext = ctx->read16(redoLogRecord->data(fieldPos + 8));
-                const uint16_t spc = ctx->read16(redoLogRecord->data(fieldPos + 10));
+            if constexpr (Mode::dump) {
+                const typeUba uba = Mode::read56(redoLogRecord->data(fieldPos + 0));
+                const uint16_t ext = Mode::read16(redoLogRecord->data(fieldPos + 8));
+                const uint16_t spc = Mode::read16(redoLogRecord->data(fieldPos + 10));
                 const uint8_t fbi = *redoLogRecord->data(fieldPos + 12);
 
                 *ctx->dumpStream << "ktucf redo:" <<
@@ -68,23 +70,24 @@ namespace OpenLogReplicator {
         }
 
     public:
+        template<typename Mode>
         static void process0504(const Ctx* ctx, RedoLogRecord* redoLogRecord) {
-            OpCode::process(ctx, redoLogRecord);
+            OpCode::process<Mode>(ctx, redoLogRecord);
             typePos fieldPos = 0;
             typeField fieldNum = 0;
             typeSize fieldSize = 0;
 
             RedoLogRecord::nextField(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x050401);
             // Field: 1
-            ktucm(ctx, redoLogRecord, fieldPos, fieldSize);
+            ktucm<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
 
             if (!RedoLogRecord::nextFieldOpt(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x050402))
                 return;
             // Field: 2
             if ((redoLogRecord->flg & FLG_KTUCF_OP0504) != 0)
-                ktucf(ctx, redoLogRecord, fieldPos, fieldSize);
+                ktucf<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 *ctx->dumpStream << '\n';
                 if ((redoLogRecord->flg & FLG_ROLLBACK_OP0504) != 0)
                     *ctx->dumpStream << "rolled back transaction\n";
@@ -26,45 +26,48 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 namespace OpenLogReplicator {
     class OpCode0506 final : public OpCode {
     protected:
+        template<typename Mode>
         static void ktuxvoff(const Ctx* ctx, const RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize) {
             if (unlikely(fieldSize < 8))
                 throw RedoLogException(50061, "too short field ktuxvoff: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
-                const uint16_t off = ctx->read16(redoLogRecord->data(fieldPos + 0));
-                const uint16_t flg = ctx->read16(redoLogRecord->data(fieldPos + 4));
+            if constexpr (Mode::dump) {
+                const uint16_t off = Mode::read16(redoLogRecord->data(fieldPos + 0));
+                const uint16_t flg = Mode::read16(redoLogRecord->data(fieldPos + 4));
 
                 *ctx->dumpStream << "ktuxvoff: 0x" << std::setfill('0') << std::setw(4) << std::hex << off << " " <<
                                  " ktuxvflg: 0x" << std::setfill('0') << std::setw(4) << std::hex << flg << '\n';
             }
         }
 
-        static void init(const Ctx* ctx, RedoLogRecord* redoLogRecord) {
+        template<typename Mode>
+        static void init(RedoLogRecord* redoLogRecord) {
             const typePos fieldPos = redoLogRecord->fieldPos;
-            const typeSize fieldSize = ctx->read16(redoLogRecord->data(redoLogRecord->fieldSizesDelta + (1 * 2)));
+            const typeSize fieldSize = Mode::read16(redoLogRecord->data(redoLogRecord->fieldSizesDelta + (1 * 2)));
             if (unlikely(fieldSize < 8))
                 throw RedoLogException(50061, "too short field 5.6: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
 
-            redoLogRecord->obj = ctx->read32(redoLogRecord->data(fieldPos + 0));
-            redoLogRecord->dataObj = ctx->read32(redoLogRecord->data(fieldPos + 4));
+            redoLogRecord->obj = Mode::read32(redoLogRecord->data(fieldPos + 0));
+            redoLogRecord->dataObj = Mode::read32(redoLogRecord->data(fieldPos + 4));
         }
 
     public:
+        template<typename Mode>
         static void process0506(const Ctx* ctx, RedoLogRecord* redoLogRecord) {
-            init(ctx, redoLogRecord);
-            OpCode::process(ctx, redoLogRecord);
+            init<Mode>(redoLogRecord);
+            OpCode::process<Mode>(ctx, redoLogRecord);
             typePos fieldPos = 0;
             typeField fieldNum = 0;
             typeSize fieldSize = 0;
 
             RedoLogRecord::nextField(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x050601);
             // Field: 1
-            ktub(ctx, redoLogRecord, fieldPos, fieldSize, true);
+            ktub<Mode>(ctx, redoLogRecord, fieldPos, fieldSize, true);
 
             if (!RedoLogRecord::nextFieldOpt(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x050602))
                 return;
             // Field: 2
-            ktuxvoff(ctx, redoLogRecord, fieldPos, fieldSize);
+            ktuxvoff<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
         }
     };
 }
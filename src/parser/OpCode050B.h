@@ -26,22 +26,24 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 namespace OpenLogReplicator {
     class OpCode050B final : public OpCode {
     protected:
-        static void init(const Ctx* ctx, RedoLogRecord* redoLogRecord) {
+        template<typename Mode>
+        static void init(RedoLogRecord* redoLogRecord) {
             if (redoLogRecord->fieldCnt >= 1) {
                 const typePos fieldPos = redoLogRecord->fieldPos;
-                const typeSize fieldSize = ctx->read16(redoLogRecord->data(redoLogRecord->fieldSizesDelta + (1 * 2)));
+                const typeSize fieldSize = Mode::read16(redoLogRecord->data(redoLogRecord->fieldSizesDelta + (1 * 2)));
                 if (unlikely(fieldSize < 8))
                     throw RedoLogException(50061, "too short field 5.11: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
 
-                redoLogRecord->obj = ctx->read32(redoLogRecord->data(fieldPos + 0));
-                redoLogRecord->dataObj = ctx->read32(redoLogRecord->data(fieldPos + 4));
+                redoLogRecord->obj = Mode::read32(redoLogRecord->data(fieldPos + 0));
+                redoLogRecord->dataObj = Mode::read32(redoLogRecord->data(fieldPos + 4));
             }
         }
 
     public:
+        template<typename Mode>
         static void process050B(const Ctx* ctx, RedoLogRecord* redoLogRecord) {
-            init(ctx, redoLogRecord);
-            OpCode::process(ctx, redoLogRecord);
+            init<Mode>(redoLogRecord);
+            OpCode::process<Mode>(ctx, redoLogRecord);
             typePos fieldPos = 0;
             typeField fieldNum = 0;
             typeSize fieldSize = 0;
@@ -49,9 +51,9 @@ namespace OpenLogReplicator {
             RedoLogRecord::nextField(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x050B01);
             // Field: 1
             if (ctx->version < RedoLogRecord::REDO_VERSION_19_0)
-                ktub(ctx, redoLogRecord, fieldPos, fieldSize, false);
+                ktub<Mode>(ctx, redoLogRecord, fieldPos, fieldSize, false);
             else
-                ktub(ctx, redoLogRecord, fieldPos, fieldSize, true);
+                ktub<Mode>(ctx, redoLogRecord, fieldPos, fieldSize, true);
         }
     };
 }
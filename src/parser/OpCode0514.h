@@ -29,8 +29,9 @@ namespace OpenLogReplicator {
 
     class OpCode0514 final : public OpCode0513 {
     public:
+        template<typename Mode>
         static void process0514(const Ctx* ctx, RedoLogRecord* redoLogRecord, Transaction* transaction) {
-            OpCode::process(ctx, redoLogRecord);
+            OpCode::process<Mode>(ctx, redoLogRecord);
 
             if (unlikely(transaction == nullptr)) {
                 ctx->logTrace(Ctx::TRACE::TRANSACTION, "attributes with no transaction, offset: " + redoLogRecord->fileOffset.toString());
@@ -42,27 +43,27 @@ namespace OpenLogReplicator {
 
             RedoLogRecord::nextField(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x051401);
             // Field: 1
-            attributeSessionSerial(ctx, redoLogRecord, fieldPos, fieldSize, transaction);
+            attributeSessionSerial<Mode>(ctx, redoLogRecord, fieldPos, fieldSize, transaction);
 
             if (!RedoLogRecord::nextFieldOpt(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x051402))
                 return;
             // Field: 2
-            attribute(ctx, redoLogRecord, fieldPos, fieldSize, "transaction name = ", "transaction name", transaction);
+            attribute<Mode>(ctx, redoLogRecord, fieldPos, fieldSize, "transaction name = ", "transaction name", transaction);
 
             if (!RedoLogRecord::nextFieldOpt(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x051403))
                 return;
             // Field: 3
-            attributeFlags(ctx, redoLogRecord, fieldPos, fieldSize, transaction);
+            attributeFlags<Mode>(ctx, redoLogRecord, fieldPos, fieldSize, transaction);
 
             if (!RedoLogRecord::nextFieldOpt(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x051404))
                 return;
             // Field: 4
-            attributeVersion(ctx, redoLogRecord, fieldPos, fieldSize, transaction);
+            attributeVersion<Mode>(ctx, redoLogRecord, fieldPos, fieldSize, transaction);
 
             if (!RedoLogRecord::nextFieldOpt(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x051405))
                 return;
             // Field: 5
-            attributeAuditSessionId(ctx, redoLogRecord, fieldPos, fieldSize, transaction);
+            attributeAuditSessionId<Mode>(ctx, redoLogRecord, fieldPos, fieldSize, transaction);
 
             if (!RedoLogRecord::nextFieldOpt(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x051406))
                 return;
@@ -71,12 +72,12 @@ namespace OpenLogReplicator {
             if (!RedoLogRecord::nextFieldOpt(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x051407))
                 return;
             // Field: 7
-            attribute(ctx, redoLogRecord, fieldPos, fieldSize, "Client Id = ", "client id", transaction);
+            attribute<Mode>(ctx, redoLogRecord, fieldPos, fieldSize, "Client Id = ", "client id", transaction);
 
             if (!RedoLogRecord::nextFieldOpt(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x051408))
                 return;
             // Field: 8
-            attribute(ctx, redoLogRecord, fieldPos, fieldSize, "login   username = ", "login username", transaction);
+            attribute<Mode>(ctx, redoLogRecord, fieldPos, fieldSize, "login   username = ", "login username", transaction);
         }
     };
 }
@@ -26,33 +26,34 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 namespace OpenLogReplicator {
     class OpCode0A02 final : public OpCode {
     public:
+        template<typename Mode>
         static void process0A02(const Ctx* ctx, RedoLogRecord* redoLogRecord) {
-            OpCode::process(ctx, redoLogRecord);
+            OpCode::process<Mode>(ctx, redoLogRecord);
             typePos fieldPos = 0;
             typeField fieldNum = 0;
             typeSize fieldSize = 0;
             uint16_t keys = 0;
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 *ctx->dumpStream << "index redo (kdxlin):  insert leaf row\n";
             }
 
             RedoLogRecord::nextField(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x0A0201);
             // Field: 1
-            ktbRedo(ctx, redoLogRecord, fieldPos, fieldSize);
+            ktbRedo<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
 
             if (!RedoLogRecord::nextFieldOpt(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x0A0202))
                 return;
             // Field: 2
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 if (fieldSize < 6)
                     return;
 
                 const uint8_t itl = *redoLogRecord->data(fieldPos);
                 const uint8_t code = *redoLogRecord->data(fieldPos + 1);
-                const uint16_t sno = ctx->read16(redoLogRecord->data(fieldPos + 2));
-                const uint16_t rowSize = ctx->read16(redoLogRecord->data(fieldPos + 4));
+                const uint16_t sno = Mode::read16(redoLogRecord->data(fieldPos + 2));
+                const uint16_t rowSize = Mode::read16(redoLogRecord->data(fieldPos + 4));
                 std::string codeStr;
                 if (code == 0) {
                     codeStr = "SINGLE";
@@ -71,14 +72,14 @@ namespace OpenLogReplicator {
                 if (code == 0x20) {
                     if (fieldSize < 10)
                         return;
-                    keys = ctx->read16(redoLogRecord->data(fieldPos + 8));
+                    keys = Mode::read16(redoLogRecord->data(fieldPos + 8));
                     *ctx->dumpStream << "number of keys: " << std::dec << keys << '\n';
 
                     if (fieldSize < 12 + keys * 2)
                         return;
                     *ctx->dumpStream << "slots: \n";
                     for (uint i = 0; i < keys; ++i) {
-                        const uint16_t val = ctx->read16(redoLogRecord->data(fieldPos + 12 + (i * 2)));
+                        const uint16_t val = Mode::read16(redoLogRecord->data(fieldPos + 12 + (i * 2)));
                         *ctx->dumpStream << " " << std::dec << val;
                     }
                     *ctx->dumpStream << '\n';
@@ -92,7 +93,7 @@ namespace OpenLogReplicator {
             redoLogRecord->indKey = fieldPos;
             redoLogRecord->indKeySize = fieldSize;
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 *ctx->dumpStream << "insert key: (" << std::dec << fieldSize << "): ";
 
                 if (fieldSize > 20)
@@ -118,13 +119,13 @@ namespace OpenLogReplicator {
 
                 *ctx->dumpStream << "each key size is: \n";
                 for (uint i = 0; i < keys; ++i) {
-                    const uint16_t val = ctx->read16(redoLogRecord->data(fieldPos + (i * 2)));
+                    const uint16_t val = Mode::read16(redoLogRecord->data(fieldPos + (i * 2)));
                     *ctx->dumpStream << " " << std::dec << val;
                 }
                 *ctx->dumpStream << '\n';
             }
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 *ctx->dumpStream << "keydata: (" << std::dec << redoLogRecord->indKeyDataSize << "): ";
 
                 if (redoLogRecord->indKeyDataSize > 20)
@@ -26,8 +26,9 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 namespace OpenLogReplicator {
     class OpCode0A08 final : public OpCode {
     public:
+        template<typename Mode>
         static void process0A08(const Ctx* ctx, RedoLogRecord* redoLogRecord) {
-            OpCode::process(ctx, redoLogRecord);
+            OpCode::process<Mode>(ctx, redoLogRecord);
             typePos fieldPos = 0;
             typeField fieldNum = 0;
             typeSize fieldSize = 0;
@@ -35,17 +36,17 @@ namespace OpenLogReplicator {
             RedoLogRecord::nextField(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x0A0801);
             // Field: 1
             if (fieldSize > 0) {
-                if (unlikely(ctx->dumpRedoLog >= 1)) {
+                if constexpr (Mode::dump) {
                     *ctx->dumpStream << "index redo (kdxlne): (count=" << std::dec << redoLogRecord->fieldCnt << ") init header of newly allocated leaf block\n";
                 }
 
-                ktbRedo(ctx, redoLogRecord, fieldPos, fieldSize);
+                ktbRedo<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
 
                 RedoLogRecord::nextField(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x0A0802);
                 // Field: 2
-                kdxln(ctx, redoLogRecord, fieldPos, fieldSize);
+                kdxln<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
             } else {
-                if (unlikely(ctx->dumpRedoLog >= 1)) {
+                if constexpr (Mode::dump) {
                     *ctx->dumpStream << "index redo (kdxlne): (count=" << std::dec << redoLogRecord->fieldCnt << ") init leaf block being split\n";
                 }
 
@@ -57,8 +58,8 @@ namespace OpenLogReplicator {
                     return;
                 }
 
-                if (unlikely(ctx->dumpRedoLog >= 1)) {
-                    const uint32_t kdxlenxt = ctx->read32(redoLogRecord->data(fieldPos + 0));
+                if constexpr (Mode::dump) {
+                    const uint32_t kdxlenxt = Mode::read32(redoLogRecord->data(fieldPos + 0));
                     *ctx->dumpStream << "zeroed lock count and free space, kdxlenxt = 0x" << std::hex << kdxlenxt << '\n';
                 }
             }
@@ -66,11 +67,11 @@ namespace OpenLogReplicator {
             RedoLogRecord::nextField(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x0A0804);
             // Field: 3
             const typeSize rows = (fieldSize / 2) - 1;
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 *ctx->dumpStream << "new block has " << std::dec << rows << " rows\n";
                 *ctx->dumpStream << "dumping row index\n";
             }
-            dumpMemory(ctx, redoLogRecord, fieldPos, fieldSize);
+            dumpMemory<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
 
             RedoLogRecord::nextField(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x0A0805);
             // Field: 4
@@ -80,26 +81,27 @@ namespace OpenLogReplicator {
                 redoLogRecord->indKeySize = fieldSize;
             }
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 *ctx->dumpStream << "dumping rows\n";
             }
-            dumpMemory(ctx, redoLogRecord, fieldPos, fieldSize);
+            dumpMemory<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
         }
 
+        template<typename Mode>
         static void kdxln(const Ctx* ctx, const RedoLogRecord* redoLogRecord, typePos fieldPos, typeSize fieldSize) {
             if (fieldSize < 16) {
                 ctx->warning(70001, "too short field kdxln: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
                 return;
             }
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 const auto itl = static_cast<uint8_t>(*redoLogRecord->data(fieldPos));
                 const auto nco = static_cast<uint8_t>(*redoLogRecord->data(fieldPos + 1));
                 const auto dsz = static_cast<uint8_t>(*redoLogRecord->data(fieldPos + 2));
                 const auto col = static_cast<uint8_t>(*redoLogRecord->data(fieldPos + 3));
                 const auto flg = static_cast<uint8_t>(*redoLogRecord->data(fieldPos + 4));
-                const typeDba nxt = ctx->read32(redoLogRecord->data(fieldPos + 8));
-                const typeDba prv = ctx->read32(redoLogRecord->data(fieldPos + 12));
+                const typeDba nxt = Mode::read32(redoLogRecord->data(fieldPos + 8));
+                const typeDba prv = Mode::read32(redoLogRecord->data(fieldPos + 12));
 
                 *ctx->dumpStream << "kdxlnitl = " << std::dec << static_cast<uint>(itl) << '\n';
                 *ctx->dumpStream << "kdxlnnco = " << std::dec << static_cast<uint>(nco) << '\n';
@@ -26,32 +26,33 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 namespace OpenLogReplicator {
     class OpCode0A12 final : public OpCode {
     public:
+        template<typename Mode>
         static void process0A12(const Ctx* ctx, RedoLogRecord* redoLogRecord) {
-            OpCode::process(ctx, redoLogRecord);
+            OpCode::process<Mode>(ctx, redoLogRecord);
             typePos fieldPos = 0;
             typeField fieldNum = 0;
             typeSize fieldSize = 0;
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 const typeField count = redoLogRecord->fieldCnt;
                 *ctx->dumpStream << "index redo (kdxlup): update keydata, count=" << std::dec << count << '\n';
             }
 
             RedoLogRecord::nextField(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x0A1201);
             // Field: 1
-            ktbRedo(ctx, redoLogRecord, fieldPos, fieldSize);
+            ktbRedo<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
 
             if (!RedoLogRecord::nextFieldOpt(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x0A1202))
                 return;
             // Field: 2
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 if (fieldSize < 6)
                     return;
 
-                const uint16_t itl = ctx->read16(redoLogRecord->data(fieldPos));
-                const uint16_t sno = ctx->read16(redoLogRecord->data(fieldPos + 2));
-                const uint16_t rowSize = ctx->read16(redoLogRecord->data(fieldPos + 4));
+                const uint16_t itl = Mode::read16(redoLogRecord->data(fieldPos));
+                const uint16_t sno = Mode::read16(redoLogRecord->data(fieldPos + 2));
+                const uint16_t rowSize = Mode::read16(redoLogRecord->data(fieldPos + 4));
 
                 *ctx->dumpStream << "REDO: SINGLE / -- / -- \n";
                 *ctx->dumpStream << "itl: " << std::dec << itl <<
@@ -66,7 +67,7 @@ namespace OpenLogReplicator {
             redoLogRecord->indKeyData = fieldPos;
             redoLogRecord->indKeyDataSize = fieldSize;
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
+            if constexpr (Mode::dump) {
                 *ctx->dumpStream << "keydata : (" << std::dec << fieldSize << "): ";
 
                 if (fieldSize > 20)
@@ -26,20 +26,21 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 namespace OpenLogReplicator {
     class OpCode0B04 final : public OpCode {
     public:
+        template<typename Mode>
         static void process0B04(const Ctx* ctx, RedoLogRecord* redoLogRecord) {
-            OpCode::process(ctx, redoLogRecord);
+            OpCode::process<Mode>(ctx, redoLogRecord);
             typePos fieldPos = 0;
             typeField fieldNum = 0;
             typeSize fieldSize = 0;
 
             RedoLogRecord::nextField(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x0B0401);
             // Field: 1
-            ktbRedo(ctx, redoLogRecord, fieldPos, fieldSize);
+            ktbRedo<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
 
             if (!RedoLogRecord::nextFieldOpt(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x0B0402))
                 return;
             // Field: 2
-            kdoOpCode(ctx, redoLogRecord, fieldPos, fieldSize);
+            kdoOpCode<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
         }
     };
 }
@@ -26,20 +26,21 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 namespace OpenLogReplicator {
     class OpCode0B05 final : public OpCode {
     public:
+        template<typename Mode>
         static void process0B05(const Ctx* ctx, RedoLogRecord* redoLogRecord) {
-            OpCode::process(ctx, redoLogRecord);
+            OpCode::process<Mode>(ctx, redoLogRecord);
             typePos fieldPos = 0;
             typeField fieldNum = 0;
             typeSize fieldSize = 0;
 
             RedoLogRecord::nextField(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x0B0501);
             // Field: 1
-            ktbRedo(ctx, redoLogRecord, fieldPos, fieldSize);
+            ktbRedo<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
 
             if (!RedoLogRecord::nextFieldOpt(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x0B0502))
                 return;
             // Field: 2
-            kdoOpCode(ctx, redoLogRecord, fieldPos, fieldSize);
+            kdoOpCode<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
             const typeCC* nulls = redoLogRecord->data(redoLogRecord->nullsDelta);
 
             if (!RedoLogRecord::nextFieldOpt(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x0B0503))
@@ -55,8 +56,8 @@ namespace OpenLogReplicator {
                 RedoLogRecord::nextField(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x0B0504);
                 // Field: 4
                 redoLogRecord->rowData = fieldNum;
-                if (unlikely(ctx->dumpRedoLog >= 1))
-                    dumpColVector(ctx, redoLogRecord, redoLogRecord->data(fieldPos), ctx->read16(colNums));
+                if constexpr (Mode::dump)
+                    dumpColVector<Mode>(ctx, redoLogRecord, redoLogRecord->data(fieldPos), Mode::read16(colNums));
             } else if (colNums != nullptr) {
                 redoLogRecord->rowData = fieldNum + 1;
                 uint8_t bits = 1;
@@ -72,8 +73,8 @@ namespace OpenLogReplicator {
                         throw RedoLogException(50061, "too short field 11.5." + std::to_string(fieldNum) + ": " +
                                                       std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
 
-                    if (unlikely(ctx->dumpRedoLog >= 1))
-                        dumpCols(ctx, redoLogRecord->data(fieldPos), ctx->read16(colNums), fieldSize, (*nulls & bits) != 0);
+                    if constexpr (Mode::dump)
+                        dumpCols<Mode>(ctx, redoLogRecord->data(fieldPos), Mode::read16(colNums), fieldSize, (*nulls & bits) != 0);
 
                     bits <<= 1;
                     colNums += 2;
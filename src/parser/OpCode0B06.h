@@ -26,20 +26,21 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 namespace OpenLogReplicator {
     class OpCode0B06 final : public OpCode {
     public:
+        template<typename Mode>
         static void process0B06(const Ctx* ctx, RedoLogRecord* redoLogRecord) {
-            OpCode::process(ctx, redoLogRecord);
+            OpCode::process<Mode>(ctx, redoLogRecord);
             typePos fieldPos = 0;
             typeField fieldNum = 0;
             typeSize fieldSize = 0;
 
             RedoLogRecord::nextField(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x0B0601);
             // Field: 1
-            ktbRedo(ctx, redoLogRecord, fieldPos, fieldSize);
+            ktbRedo<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
 
             if (!RedoLogRecord::nextFieldOpt(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x0B0602))
                 return;
             // Field: 2
-            kdoOpCode(ctx, redoLogRecord, fieldPos, fieldSize);
+            kdoOpCode<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
             const uint8_t* nulls = redoLogRecord->data(redoLogRecord->nullsDelta);
             uint8_t bits = 1;
 
@@ -49,8 +50,8 @@ namespace OpenLogReplicator {
                 return;
             if (fieldSize == redoLogRecord->sizeDelt && (redoLogRecord->cc > 1 || redoLogRecord->cc == 0)) {
                 redoLogRecord->compressed = true;
-                if (unlikely(ctx->dumpRedoLog >= 1))
-                    dumpCompressed(ctx, redoLogRecord, redoLogRecord->data(fieldPos), fieldSize);
+                if constexpr (Mode::dump)
+                    dumpCompressed<Mode>(ctx, redoLogRecord, redoLogRecord->data(fieldPos), fieldSize);
             } else {
                 // Fields: 3 to 3 + cc - 1
                 for (typeCC i = 0; i < redoLogRecord->cc; ++i) {
@@ -58,8 +59,8 @@ namespace OpenLogReplicator {
                         throw RedoLogException(50061, "too short field 11.6." + std::to_string(fieldNum) + ": " + std::to_string(fieldSize) + " offset: " +
                                                       redoLogRecord->fileOffset.toString());
 
-                    if (unlikely(ctx->dumpRedoLog >= 1))
-                        dumpCols(ctx, redoLogRecord->data(fieldPos), i, fieldSize, (*nulls & bits) != 0);
+                    if constexpr (Mode::dump)
+                        dumpCols<Mode>(ctx, redoLogRecord->data(fieldPos), i, fieldSize, (*nulls & bits) != 0);
                     bits <<= 1;
                     if (bits == 0) {
                         bits = 1;
@@ -26,6 +26,7 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 namespace OpenLogReplicator {
     class OpCode1301 final : public OpCode {
     public:
+        template<typename Mode>
         static void process1301(const Ctx* ctx, RedoLogRecord* redoLogRecord) {
             typePos fieldPos = 0;
             typeField fieldNum = 0;
@@ -37,18 +38,18 @@ namespace OpenLogReplicator {
             if (unlikely(fieldSize < 36))
                 throw RedoLogException(50061, "too short field 19.1.1: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
 
-            redoLogRecord->dataObj = ctx->read32(redoLogRecord->data(fieldPos + 0));
+            redoLogRecord->dataObj = Mode::read32(redoLogRecord->data(fieldPos + 0));
             redoLogRecord->recordDataObj = redoLogRecord->dataObj;
             redoLogRecord->lobId.set(redoLogRecord->data(fieldPos + 4));
-            redoLogRecord->lobPageNo = ctx->read32(redoLogRecord->data(fieldPos + 24));
+            redoLogRecord->lobPageNo = Mode::read32(redoLogRecord->data(fieldPos + 24));
             redoLogRecord->lobData = fieldPos + 36;
             redoLogRecord->lobDataSize = fieldSize - 36;
-            OpCode::process(ctx, redoLogRecord);
+            OpCode::process<Mode>(ctx, redoLogRecord);
 
-            if (unlikely(ctx->dumpRedoLog >= 1)) {
-                const uint32_t v2 = ctx->read32(redoLogRecord->data(fieldPos + 16));
-                const uint16_t v1 = ctx->read16(redoLogRecord->data(fieldPos + 20));
-                const typeDba dba = ctx->read32(redoLogRecord->data(fieldPos + 28));
+            if constexpr (Mode::dump) {
+                const uint32_t v2 = Mode::read32(redoLogRecord->data(fieldPos + 16));
+                const uint16_t v1 = Mode::read16(redoLogRecord->data(fieldPos + 20));
+                const typeDba dba = Mode::read32(redoLogRecord->data(fieldPos + 28));
 
                 *ctx->dumpStream << "Direct Loader block redo entry\n";
                 *ctx->dumpStream << "Long field block dump:\n";
@@ -69,7 +70,7 @@ namespace OpenLogReplicator {
 
             RedoLogRecord::nextField(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x130102);
             // Field: 2
-            dumpMemory(ctx, redoLogRecord, fieldPos, fieldSize);
+            dumpMemory<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
         }
     };
 }
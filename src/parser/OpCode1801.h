@@ -26,10 +26,11 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 namespace OpenLogReplicator {
     class OpCode1801 final : public OpCode {
     public:
+        template<typename Mode>
         static void process1801(const Ctx* ctx, RedoLogRecord* redoLogRecord) {
             bool validDdl = false;
 
-            OpCode::process(ctx, redoLogRecord);
+            OpCode::process<Mode>(ctx, redoLogRecord);
             typePos fieldPos = 0;
             typeField fieldNum = 0;
             typeSize fieldSize = 0;
@@ -39,13 +40,13 @@ namespace OpenLogReplicator {
             if (unlikely(fieldSize < 18))
                 throw RedoLogException(50061, "too short field 24.1.1: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
 
-            redoLogRecord->xid = Xid(static_cast<typeUsn>(ctx->read16(redoLogRecord->data(fieldPos + 4))),
-                                         ctx->read16(redoLogRecord->data(fieldPos + 6)),
-                                         ctx->read32(redoLogRecord->data(fieldPos + 8)));
-            // uint16_t type = ctx->read16(redoLogRecord->ctx + fieldPos + 12);
-            const uint16_t ddlType = ctx->read16(redoLogRecord->data(fieldPos + 16));
-            // uint16_t seq = ctx->read16(redoLogRecord->ctx + fieldPos + 18);
-            // uint16_t cnt = ctx->read16(redoLogRecord->ctx + fieldPos + 20);
+            redoLogRecord->xid = Xid(static_cast<typeUsn>(Mode::read16(redoLogRecord->data(fieldPos + 4))),
+                                         Mode::read16(redoLogRecord->data(fieldPos + 6)),
+                                         Mode::read32(redoLogRecord->data(fieldPos + 8)));
+            // uint16_t type = Mode::read16(redoLogRecord->ctx + fieldPos + 12);
+            const uint16_t ddlType = Mode::read16(redoLogRecord->data(fieldPos + 16));
+            // uint16_t seq = Mode::read16(redoLogRecord->ctx + fieldPos + 18);
+            // uint16_t cnt = Mode::read16(redoLogRecord->ctx + fieldPos + 20);
 
             // Temporary object
             if (ddlType != 4 && ddlType != 5 && ddlType != 6 && ddlType != 8 && ddlType != 9 && ddlType != 10)
@@ -96,7 +97,7 @@ namespace OpenLogReplicator {
             // Field: 12
 
             if (validDdl)
-                redoLogRecord->obj = ctx->read32(redoLogRecord->data(fieldPos + 0));
+                redoLogRecord->obj = Mode::read32(redoLogRecord->data(fieldPos + 0));
         }
     };
 }
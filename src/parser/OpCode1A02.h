@@ -26,28 +26,29 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 namespace OpenLogReplicator {
     class OpCode1A02 final : public OpCode {
     public:
+        template<typename Mode>
         static void process1A02(const Ctx* ctx, RedoLogRecord* redoLogRecord) {
-            OpCode::process(ctx, redoLogRecord);
+            OpCode::process<Mode>(ctx, redoLogRecord);
             typePos fieldPos = 0;
             typeField fieldNum = 0;
             typeSize fieldSize = 0;
 
             RedoLogRecord::nextField(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x1A0201);
             // Field: 1
-            ktbRedo(ctx, redoLogRecord, fieldPos, fieldSize);
+            ktbRedo<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
 
             RedoLogRecord::nextField(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x1A0202);
             // Field: 2
-            kdliCommon(ctx, redoLogRecord, fieldPos, fieldSize);
+            kdliCommon<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
 
             RedoLogRecord::nextField(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x1A0203);
             // Field: 3`
-            kdli(ctx, redoLogRecord, fieldPos, fieldSize);
+            kdli<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
 
             if (!RedoLogRecord::nextFieldOpt(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x1A0204))
                 return;
             // Field: 4
-            kdli(ctx, redoLogRecord, fieldPos, fieldSize);
+            kdli<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
         }
     };
 }
@@ -26,6 +26,7 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 namespace OpenLogReplicator {
     class OpCode1A06 final : public OpCode {
     public:
+        template<typename Mode>
         static void process1A06(const Ctx* ctx, RedoLogRecord* redoLogRecord) {
             typePos fieldPos = 0;
             typeField fieldNum = 0;
@@ -41,38 +42,38 @@ namespace OpenLogReplicator {
             if (unlikely(fieldSize < 32))
                 throw RedoLogException(50061, "too short field 26.6.2: " + std::to_string(fieldSize) + " offset: " + redoLogRecord->fileOffset.toString());
 
-            redoLogRecord->recordDataObj = ctx->read32(redoLogRecord->data(fieldPos + 24));
+            redoLogRecord->recordDataObj = Mode::read32(redoLogRecord->data(fieldPos + 24));
 
-            OpCode::process(ctx, redoLogRecord);
+            OpCode::process<Mode>(ctx, redoLogRecord);
             fieldPos = 0;
             fieldNum = 0;
             fieldSize = 0;
 
             RedoLogRecord::nextField(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x1A0603);
             // Field: 1
-            kdliCommon(ctx, redoLogRecord, fieldPos, fieldSize);
+            kdliCommon<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
 
             RedoLogRecord::nextField(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x1A0604);
             // Field: 2
-            kdli(ctx, redoLogRecord, fieldPos, fieldSize);
+            kdli<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
 
             RedoLogRecord::nextField(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x1A0605);
             // Field: 3
-            kdli(ctx, redoLogRecord, fieldPos, fieldSize);
+            kdli<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
 
             if (!RedoLogRecord::nextFieldOpt(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x1A0606))
                 return;
             // Field: 4
 
             if (redoLogRecord->opc == KDLI_OP_BIMG) {
-                kdliDataLoad(ctx, redoLogRecord, fieldPos, fieldSize);
+                kdliDataLoad<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
 
                 if (!RedoLogRecord::nextFieldOpt(ctx, redoLogRecord, fieldNum, fieldPos, fieldSize, 0x1A0607))
                     return;
             }
 
             // Field: 4/5 - suplog?
-            kdli(ctx, redoLogRecord, fieldPos, fieldSize);
+            kdli<Mode>(ctx, redoLogRecord, fieldPos, fieldSize);
         }
     };
 }
@@ -19,17 +19,24 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 
 #include <algorithm>
 #include <utility>
+#include <unistd.h>
 
 #include "../builder/Builder.h"
 #include "../common/Clock.h"
 #include "../common/DbLob.h"
 #include "../common/DbTable.h"
+#include "../common/FlightRecorder.h"
+#include "../common/Probes.h"
+#include "../common/Tracer.h"
 #include "../common/XmlCtx.h"
 #include "../common/exception/RedoLogException.h"
 #include "../common/metrics/Metrics.h"
 #include "../metadata/Metadata.h"
 #include "../metadata/Schema.h"
 #include "../reader/Reader.h"
+#include "../replicator/PartitionCoordinator.h"
+#include "CatchUpDecoder.h"
+#include "LwnDecoder.h"
 #include "OpCode0501.h"
 #include "OpCode0502.h"
 #include "OpCode0504.h"
@@ -55,8 +62,11 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include "OpCode1A02.h"
 #include "OpCode1A06.h"
 #include "Parser.h"
+#include "RacCoordinator.h"
+#include "RedoProfile.h"
 #include "Transaction.h"
 #include "TransactionBuffer.h"
+#include "TransactionFlusher.h"
 
 namespace OpenLogReplicator {
     Parser::Parser(Ctx* newCtx, Builder* newBuilder, Metadata* newMetadata, TransactionBuffer* newTransactionBuffer, int newGroup,
@@ -69,6 +79,7 @@ namespace OpenLogReplicator {
             path(std::move(newPath)) {
 
         memset(reinterpret_cast<void*>(&zero), 0, sizeof(RedoLogRecord));
+        lwnThread = ctx->parserThread;
 
         lwnChunks[0] = ctx->getMemoryChunk(ctx->parserThread, Ctx::MEMORY::PARSER);
         ctx->parserThread->contextSet(Thread::CONTEXT::CPU);
@@ -76,7 +87,6 @@ namespace OpenLogReplicator {
         *size = sizeof(uint64_t);
         lwnAllocated = 1;
         lwnAllocatedMax = 1;
-        lwnMembers[0] = nullptr;
     }
 
     Parser::~Parser() {
@@ -92,17 +102,16 @@ namespace OpenLogReplicator {
 
         auto* size = reinterpret_cast<uint64_t*>(lwnChunks[0]);
         *size = sizeof(uint64_t);
+        lwnMembers.clear();
     }
 
-    void Parser::analyzeLwn(LwnMember* lwnMember) {
+    uint16_t Parser::decodeLwnHeader(const LwnMember* lwnMember) const {
         if (unlikely(ctx->isTraceSet(Ctx::TRACE::LWN)))
             ctx->logTrace(Ctx::TRACE::LWN, "analyze blk: " + std::to_string(lwnMember->block) + " offset: " +
                                            std::to_string(lwnMember->pageOffset) + " scn: " + lwnMember->scn.toString() + " subscn: " +
                                            std::to_string(lwnMember->subScn));
 
-        uint8_t* data = reinterpret_cast<uint8_t*>(lwnMember) + sizeof(struct LwnMember);
-        RedoLogRecord redoLogRecord[2];
-        int64_t vectorCur = -1;
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(lwnMember) + sizeof(struct LwnMember);
         if (unlikely(ctx->isTraceSet(Ctx::TRACE::LWN)))
             ctx->logTrace(Ctx::TRACE::LWN, "analyze size: " + std::to_string(lwnMember->size) + " scn: " + lwnMember->scn.toString() +
                                            " subscn: " + std::to_string(lwnMember->subScn));
@@ -187,361 +196,715 @@ namespace OpenLogReplicator {
                                           ", field size: " + std::to_string(recordSize));
         }
 
-        uint32_t offset = headerSize;
-        uint64_t vectors = 0;
+        return headerSize;
+    }
 
-        while (offset < recordSize) {
-            const int64_t vectorPrev = vectorCur;
-            if (vectorPrev == -1)
-                vectorCur = 0;
-            else
-                vectorCur = 1 - vectorPrev;
+    void Parser::decodeVectorSelect() {
+        static constexpr VectorDecoder vectorDecoders[2][2]{
+            {&Parser::decodeVectorMode<OpCodeMode<false, false>>, &Parser::decodeVectorMode<OpCodeMode<false, true>>},
+            {&Parser::decodeVectorMode<OpCodeMode<true, false>>, &Parser::decodeVectorMode<OpCodeMode<true, true>>}
+        };
+        vectorDecoder = vectorDecoders[ctx->isBigEndian() ? 1 : 0][ctx->dumpRedoLog >= 1 ? 1 : 0];
+    }
 
-            memset(reinterpret_cast<void*>(&redoLogRecord[vectorCur]), 0, sizeof(RedoLogRecord));
-            redoLogRecord[vectorCur].vectorNo = (++vectors);
-            redoLogRecord[vectorCur].cls = ctx->read16(data + offset + 2);
-            redoLogRecord[vectorCur].afn = static_cast<typeAfn>(ctx->read32(data + offset + 4) & 0xFFFF);
-            redoLogRecord[vectorCur].dba = ctx->read32(data + offset + 8);
-            redoLogRecord[vectorCur].scnRecord = ctx->readScn(data + offset + 12);
-            redoLogRecord[vectorCur].rbl = 0; // TODO: verify field size/position
-            redoLogRecord[vectorCur].seq = data[offset + 20];
-            redoLogRecord[vectorCur].typ = data[offset + 21];
-            const typeUsn usn = (redoLogRecord[vectorCur].cls >= 15) ? (redoLogRecord[vectorCur].cls - 15) / 2 : -1;
-
-            uint16_t fieldOffset;
-            if (ctx->version >= RedoLogRecord::REDO_VERSION_12_1) {
-                fieldOffset = 32;
-                redoLogRecord[vectorCur].flgRecord = ctx->read16(data + offset + 28);
-                redoLogRecord[vectorCur].conId = static_cast<typeConId>(ctx->read16(data + offset + 24));
-            } else {
-                fieldOffset = 24;
-                redoLogRecord[vectorCur].flgRecord = 0;
-                redoLogRecord[vectorCur].conId = 0;
-            }
+    template<typename Mode>
+    uint32_t Parser::decodeVectorMode(LwnMember* lwnMember, uint32_t offset, uint32_t vectorNo, RedoLogRecord* redoLogRecord,
+                                      const RedoLogRecord* redoLogRecordPrev) const {
+        uint8_t* data = reinterpret_cast<uint8_t*>(lwnMember) + sizeof(struct LwnMember);
+        const uint32_t recordSize = lwnMember->size;
+
+        memset(reinterpret_cast<void*>(redoLogRecord), 0, sizeof(RedoLogRecord));
+        redoLogRecord->vectorNo = vectorNo;
+        redoLogRecord->cls = Mode::read16(data + offset + 2);
+        redoLogRecord->afn = static_cast<typeAfn>(Mode::read32(data + offset + 4) & 0xFFFF);
+        redoLogRecord->dba = Mode::read32(data + offset + 8);
+        redoLogRecord->scnRecord = Mode::readScn(data + offset + 12);
+        redoLogRecord->rbl = 0; // TODO: verify field size/position
+        redoLogRecord->seq = data[offset + 20];
+        redoLogRecord->typ = data[offset + 21];
+        const typeUsn usn = (redoLogRecord->cls >= 15) ? (redoLogRecord->cls - 15) / 2 : -1;
+
+        uint16_t fieldOffset;
+        if (ctx->version >= RedoLogRecord::REDO_VERSION_12_1) {
+            fieldOffset = 32;
+            redoLogRecord->flgRecord = Mode::read16(data + offset + 28);
+            redoLogRecord->conId = static_cast<typeConId>(Mode::read16(data + offset + 24));
+        } else {
+            fieldOffset = 24;
+            redoLogRecord->flgRecord = 0;
+            redoLogRecord->conId = 0;
+        }
 
-            if (unlikely(offset + fieldOffset + 1U >= recordSize)) {
-                dumpRedoVector(data, recordSize);
-                throw RedoLogException(50046, "block: " + std::to_string(lwnMember->block) + ", offset: " +
-                                              std::to_string(lwnMember->pageOffset) + ": position of field list (" + std::to_string(offset + fieldOffset + 1) +
-                                              ") outside of record, size: " + std::to_string(recordSize));
-            }
+        if (unlikely(offset + fieldOffset + 1U >= recordSize)) {
+            dumpRedoVector(data, recordSize);
+            throw RedoLogException(50046, "block: " + std::to_string(lwnMember->block) + ", offset: " +
+                                          std::to_string(lwnMember->pageOffset) + ": position of field list (" + std::to_string(offset + fieldOffset + 1) +
+                                          ") outside of record, size: " + std::to_string(recordSize));
+        }
 
-            const uint8_t* fieldList = data + offset + fieldOffset;
-
-            redoLogRecord[vectorCur].opCode = (static_cast<typeOp1>(data[offset + 0]) << 8) | data[offset + 1];
-            redoLogRecord[vectorCur].size = fieldOffset + ((ctx->read16(fieldList) + 2) & 0xFFFC);
-            redoLogRecord[vectorCur].scn = lwnMember->scn;
-            redoLogRecord[vectorCur].subScn = lwnMember->subScn;
-            redoLogRecord[vectorCur].usn = usn;
-            redoLogRecord[vectorCur].dataExt = data + offset;
-            redoLogRecord[vectorCur].fileOffset = FileOffset(lwnMember->block, reader->getBlockSize()) + lwnMember->pageOffset + offset;
-            redoLogRecord[vectorCur].fieldSizesDelta = fieldOffset;
-            if (unlikely(redoLogRecord[vectorCur].fieldSizesDelta + 1U >= recordSize)) {
-                dumpRedoVector(data, recordSize);
-                throw RedoLogException(50046, "block: " + std::to_string(lwnMember->block) + ", offset: " +
-                                              std::to_string(lwnMember->pageOffset) + ": field size list (" +
-                                              std::to_string(redoLogRecord[vectorCur].fieldSizesDelta) +
-                                              ") outside of record, size: " + std::to_string(recordSize));
-            }
-            redoLogRecord[vectorCur].fieldCnt = (ctx->read16(redoLogRecord[vectorCur].data(redoLogRecord[vectorCur].fieldSizesDelta)) - 2) / 2;
-            redoLogRecord[vectorCur].fieldPos = fieldOffset +
-                                                ((ctx->read16(redoLogRecord[vectorCur].data(redoLogRecord[vectorCur].fieldSizesDelta)) + 2) & 0xFFFC);
-            if (unlikely(redoLogRecord[vectorCur].fieldPos >= recordSize)) {
-                dumpRedoVector(data, recordSize);
-                throw RedoLogException(50046, "block: " + std::to_string(lwnMember->block) + ", offset: " +
-                                              std::to_string(lwnMember->pageOffset) + ": fields (" + std::to_string(redoLogRecord[vectorCur].fieldPos) +
-                                              ") outside of record, size: " + std::to_string(recordSize));
-            }
+        const uint8_t* fieldList = data + offset + fieldOffset;
+
+        redoLogRecord->opCode = (static_cast<typeOp1>(data[offset + 0]) << 8) | data[offset + 1];
+        redoLogRecord->size = fieldOffset + ((Mode::read16(fieldList) + 2) & 0xFFFC);
+        redoLogRecord->scn = lwnMember->scn;
+        redoLogRecord->subScn = lwnMember->subScn;
+        redoLogRecord->usn = usn;
+        redoLogRecord->dataExt = data + offset;
+        redoLogRecord->fileOffset = FileOffset(lwnMember->block, reader->getBlockSize()) + lwnMember->pageOffset + offset;
+        redoLogRecord->fieldSizesDelta = fieldOffset;
+        if (unlikely(redoLogRecord->fieldSizesDelta + 1U >= recordSize)) {
+            dumpRedoVector(data, recordSize);
+            throw RedoLogException(50046, "block: " + std::to_string(lwnMember->block) + ", offset: " +
+                                          std::to_string(lwnMember->pageOffset) + ": field size list (" +
+                                          std::to_string(redoLogRecord->fieldSizesDelta) +
+                                          ") outside of record, size: " + std::to_string(recordSize));
+        }
+        redoLogRecord->fieldCnt = (Mode::read16(redoLogRecord->data(redoLogRecord->fieldSizesDelta)) - 2) / 2;
+        redoLogRecord->fieldPos = fieldOffset +
+                                            ((Mode::read16(redoLogRecord->data(redoLogRecord->fieldSizesDelta)) + 2) & 0xFFFC);
+        if (unlikely(redoLogRecord->fieldPos >= recordSize)) {
+            dumpRedoVector(data, recordSize);
+            throw RedoLogException(50046, "block: " + std::to_string(lwnMember->block) + ", offset: " +
+                                          std::to_string(lwnMember->pageOffset) + ": fields (" + std::to_string(redoLogRecord->fieldPos) +
+                                          ") outside of record, size: " + std::to_string(recordSize));
+        }
 
-            // typePos fieldPos = redoLogRecord[vectorCur].fieldPos;
-            for (typeField i = 1; i <= redoLogRecord[vectorCur].fieldCnt; ++i) {
-                redoLogRecord[vectorCur].size += (ctx->read16(fieldList + (i * 2)) + 3) & 0xFFFC;
-
-                if (unlikely(offset + redoLogRecord[vectorCur].size > recordSize)) {
-                    dumpRedoVector(data, recordSize);
-                    throw RedoLogException(50046, "block: " + std::to_string(lwnMember->block) + ", offset: " +
-                                                  std::to_string(lwnMember->pageOffset) + ": position of field list outside of record (" + "i: " +
-                                                  std::to_string(i) + " c: " + std::to_string(redoLogRecord[vectorCur].fieldCnt) + " " + " o: " +
-                                                  std::to_string(fieldOffset) + " p: " + std::to_string(offset) + " l: " +
-                                                  std::to_string(redoLogRecord[vectorCur].size) + " r: " + std::to_string(recordSize) + ")");
-                }
-            }
+        // typePos fieldPos = redoLogRecord->fieldPos;
+        for (typeField i = 1; i <= redoLogRecord->fieldCnt; ++i) {
+            redoLogRecord->size += (Mode::read16(fieldList + (i * 2)) + 3) & 0xFFFC;
 
-            if (unlikely(redoLogRecord[vectorCur].fieldPos > redoLogRecord[vectorCur].size)) {
+            if (unlikely(offset + redoLogRecord->size > recordSize)) {
                 dumpRedoVector(data, recordSize);
                 throw RedoLogException(50046, "block: " + std::to_string(lwnMember->block) + ", offset: " +
-                                              std::to_string(lwnMember->pageOffset) + ": incomplete record, offset: " +
-                                              std::to_string(redoLogRecord[vectorCur].fieldPos) + ", size: " +
-                                              std::to_string(redoLogRecord[vectorCur].size));
+                                              std::to_string(lwnMember->pageOffset) + ": position of field list outside of record (" + "i: " +
+                                              std::to_string(i) + " c: " + std::to_string(redoLogRecord->fieldCnt) + " " + " o: " +
+                                              std::to_string(fieldOffset) + " p: " + std::to_string(offset) + " l: " +
+                                              std::to_string(redoLogRecord->size) + " r: " + std::to_string(recordSize) + ")");
             }
+        }
 
-            redoLogRecord[vectorCur].recordObj = 0xFFFFFFFF;
-            redoLogRecord[vectorCur].recordDataObj = 0xFFFFFFFF;
-            offset += redoLogRecord[vectorCur].size;
+        if (unlikely(redoLogRecord->fieldPos > redoLogRecord->size)) {
+            dumpRedoVector(data, recordSize);
+            throw RedoLogException(50046, "block: " + std::to_string(lwnMember->block) + ", offset: " +
+                                          std::to_string(lwnMember->pageOffset) + ": incomplete record, offset: " +
+                                          std::to_string(redoLogRecord->fieldPos) + ", size: " +
+                                          std::to_string(redoLogRecord->size));
+        }
 
-            switch (redoLogRecord[vectorCur].opCode) {
-                case 0x0501:
-                    // Undo
-                    OpCode0501::process0501(ctx, &redoLogRecord[vectorCur]);
-                    break;
+        redoLogRecord->recordObj = 0xFFFFFFFF;
+        redoLogRecord->recordDataObj = 0xFFFFFFFF;
+        offset += redoLogRecord->size;
 
-                case 0x0502:
-                    // Begin transaction
-                    OpCode0502::process0502(ctx, &redoLogRecord[vectorCur]);
-                    break;
+        switch (redoLogRecord->opCode) {
+            case 0x0501:
+                // Undo
+                OpCode0501::process0501<Mode>(ctx, redoLogRecord, [this](const RedoLogRecord* redoLogRecordUndo) {
+                    return decodePlan.skipUndo(redoLogRecordUndo);
+                });
+                break;
 
-                case 0x0504:
-                    // Commit/rollback transaction
-                    OpCode0504::process0504(ctx, &redoLogRecord[vectorCur]);
-                    break;
+            case 0x0502:
+                // Begin transaction
+                OpCode0502::process0502<Mode>(ctx, redoLogRecord);
+                break;
 
-                case 0x0506:
-                    // Partial rollback
-                    OpCode0506::process0506(ctx, &redoLogRecord[vectorCur]);
-                    break;
+            case 0x0504:
+                // Commit/rollback transaction
+                OpCode0504::process0504<Mode>(ctx, redoLogRecord);
+                break;
 
-                case 0x050B:
-                    OpCode050B::process050B(ctx, &redoLogRecord[vectorCur]);
-                    break;
+            case 0x0506:
+                // Partial rollback
+                OpCode0506::process0506<Mode>(ctx, redoLogRecord);
+                break;
 
-                case 0x0513:
-                    // Session information
-                    OpCode0513::process0513(ctx, &redoLogRecord[vectorCur], lastTransaction);
-                    break;
+            case 0x050B:
+                OpCode050B::process050B<Mode>(ctx, redoLogRecord);
+                break;
 
-                    // Session information
-                case 0x0514:
-                    OpCode0514::process0514(ctx, &redoLogRecord[vectorCur], lastTransaction);
-                    break;
+            case 0x0513:
+            case 0x0514:
+                // Session information, depends on the transaction and is processed when applied
+                break;
 
-                case 0x0A02:
-                    // REDO: Insert leaf row
-                    if (vectorPrev != -1 && redoLogRecord[vectorPrev].opCode == 0x0501) {
-                        redoLogRecord[vectorCur].recordDataObj = redoLogRecord[vectorPrev].dataObj;
-                        redoLogRecord[vectorCur].recordObj = redoLogRecord[vectorPrev].obj;
-                    }
-                    OpCode0A02::process0A02(ctx, &redoLogRecord[vectorCur]);
-                    break;
+            case 0x0A02:
+                // REDO: Insert leaf row
+                if (redoLogRecordPrev != nullptr && redoLogRecordPrev->opCode == 0x0501) {
+                    redoLogRecord->recordDataObj = redoLogRecordPrev->dataObj;
+                    redoLogRecord->recordObj = redoLogRecordPrev->obj;
+                }
+                if (decodePlan.skipRedo(redoLogRecordPrev, true))
+                    redoLogRecord->partial = true;
+                else
+                    OpCode0A02::process0A02<Mode>(ctx, redoLogRecord);
+                break;
 
-                case 0x0A08:
-                    // REDO: Init header
-                    if (vectorPrev != -1 && redoLogRecord[vectorPrev].opCode == 0x0501) {
-                        redoLogRecord[vectorCur].recordDataObj = redoLogRecord[vectorPrev].dataObj;
-                        redoLogRecord[vectorCur].recordObj = redoLogRecord[vectorPrev].obj;
-                    }
-                    OpCode0A08::process0A08(ctx, &redoLogRecord[vectorCur]);
-                    break;
+            case 0x0A08:
+                // REDO: Init header
+                if (redoLogRecordPrev != nullptr && redoLogRecordPrev->opCode == 0x0501) {
+                    redoLogRecord->recordDataObj = redoLogRecordPrev->dataObj;
+                    redoLogRecord->recordObj = redoLogRecordPrev->obj;
+                }
+                if (decodePlan.skipRedo(redoLogRecordPrev, true))
+                    redoLogRecord->partial = true;
+                else
+                    OpCode0A08::process0A08<Mode>(ctx, redoLogRecord);
+                break;
 
-                case 0x0A12:
-                    // REDO: Update key data in row
-                    if (vectorPrev != -1 && redoLogRecord[vectorPrev].opCode == 0x0501) {
-                        redoLogRecord[vectorCur].recordDataObj = redoLogRecord[vectorPrev].dataObj;
-                        redoLogRecord[vectorCur].recordObj = redoLogRecord[vectorPrev].obj;
-                    }
-                    OpCode0A12::process0A12(ctx, &redoLogRecord[vectorCur]);
-                    break;
+            case 0x0A12:
+                // REDO: Update key data in row
+                if (redoLogRecordPrev != nullptr && redoLogRecordPrev->opCode == 0x0501) {
+                    redoLogRecord->recordDataObj = redoLogRecordPrev->dataObj;
+                    redoLogRecord->recordObj = redoLogRecordPrev->obj;
+                }
+                if (decodePlan.skipRedo(redoLogRecordPrev, true))
+                    redoLogRecord->partial = true;
+                else
+                    OpCode0A12::process0A12<Mode>(ctx, redoLogRecord);
+                break;
 
-                case 0x0B02:
-                    // REDO: Insert row piece
-                    if (vectorPrev != -1 && redoLogRecord[vectorPrev].opCode == 0x0501) {
-                        redoLogRecord[vectorCur].recordDataObj = redoLogRecord[vectorPrev].dataObj;
-                        redoLogRecord[vectorCur].recordObj = redoLogRecord[vectorPrev].obj;
-                    }
-                    OpCode0B02::process0B02(ctx, &redoLogRecord[vectorCur]);
-                    break;
+            case 0x0B02:
+                // REDO: Insert row piece
+                if (redoLogRecordPrev != nullptr && redoLogRecordPrev->opCode == 0x0501) {
+                    redoLogRecord->recordDataObj = redoLogRecordPrev->dataObj;
+                    redoLogRecord->recordObj = redoLogRecordPrev->obj;
+                }
+                if (decodePlan.skipRedo(redoLogRecordPrev, false))
+                    redoLogRecord->partial = true;
+                else
+                    OpCode0B02::process0B02<Mode>(ctx, redoLogRecord);
+                break;
 
-                case 0x0B03:
-                    // REDO: Delete row piece
-                    if (vectorPrev != -1 && redoLogRecord[vectorPrev].opCode == 0x0501) {
-                        redoLogRecord[vectorCur].recordDataObj = redoLogRecord[vectorPrev].dataObj;
-                        redoLogRecord[vectorCur].recordObj = redoLogRecord[vectorPrev].obj;
-                    }
-                    OpCode0B03::process0B03(ctx, &redoLogRecord[vectorCur]);
-                    break;
+            case 0x0B03:
+                // REDO: Delete row piece
+                if (redoLogRecordPrev != nullptr && redoLogRecordPrev->opCode == 0x0501) {
+                    redoLogRecord->recordDataObj = redoLogRecordPrev->dataObj;
+                    redoLogRecord->recordObj = redoLogRecordPrev->obj;
+                }
+                if (decodePlan.skipRedo(redoLogRecordPrev, false))
+                    redoLogRecord->partial = true;
+                else
+                    OpCode0B03::process0B03<Mode>(ctx, redoLogRecord);
+                break;
 
-                case 0x0B04:
-                    // REDO: Lock row piece
-                    if (vectorPrev != -1 && redoLogRecord[vectorPrev].opCode == 0x0501) {
-                        redoLogRecord[vectorCur].recordDataObj = redoLogRecord[vectorPrev].dataObj;
-                        redoLogRecord[vectorCur].recordObj = redoLogRecord[vectorPrev].obj;
-                    }
-                    OpCode0B04::process0B04(ctx, &redoLogRecord[vectorCur]);
-                    break;
+            case 0x0B04:
+                // REDO: Lock row piece
+                if (redoLogRecordPrev != nullptr && redoLogRecordPrev->opCode == 0x0501) {
+                    redoLogRecord->recordDataObj = redoLogRecordPrev->dataObj;
+                    redoLogRecord->recordObj = redoLogRecordPrev->obj;
+                }
+                OpCode0B04::process0B04<Mode>(ctx, redoLogRecord);
+                break;
 
-                case 0x0B05:
-                    // REDO: Update row piece
-                    if (vectorPrev != -1 && redoLogRecord[vectorPrev].opCode == 0x0501) {
-                        redoLogRecord[vectorCur].recordDataObj = redoLogRecord[vectorPrev].dataObj;
-                        redoLogRecord[vectorCur].recordObj = redoLogRecord[vectorPrev].obj;
-                    }
-                    OpCode0B05::process0B05(ctx, &redoLogRecord[vectorCur]);
-                    break;
+            case 0x0B05:
+                // REDO: Update row piece
+                if (redoLogRecordPrev != nullptr && redoLogRecordPrev->opCode == 0x0501) {
+                    redoLogRecord->recordDataObj = redoLogRecordPrev->dataObj;
+                    redoLogRecord->recordObj = redoLogRecordPrev->obj;
+                }
+                if (decodePlan.skipRedo(redoLogRecordPrev, false))
+                    redoLogRecord->partial = true;
+                else
+                    OpCode0B05::process0B05<Mode>(ctx, redoLogRecord);
+                break;
 
-                case 0x0B06:
-                    // REDO: Overwrite row piece
-                    if (vectorPrev != -1 && redoLogRecord[vectorPrev].opCode == 0x0501) {
-                        redoLogRecord[vectorCur].recordDataObj = redoLogRecord[vectorPrev].dataObj;
-                        redoLogRecord[vectorCur].recordObj = redoLogRecord[vectorPrev].obj;
-                    }
-                    OpCode0B06::process0B06(ctx, &redoLogRecord[vectorCur]);
-                    break;
+            case 0x0B06:
+                // REDO: Overwrite row piece
+                if (redoLogRecordPrev != nullptr && redoLogRecordPrev->opCode == 0x0501) {
+                    redoLogRecord->recordDataObj = redoLogRecordPrev->dataObj;
+                    redoLogRecord->recordObj = redoLogRecordPrev->obj;
+                }
+                if (decodePlan.skipRedo(redoLogRecordPrev, false))
+                    redoLogRecord->partial = true;
+                else
+                    OpCode0B06::process0B06<Mode>(ctx, redoLogRecord);
+                break;
 
-                case 0x0B08:
-                    // REDO: Change forwarding address
-                    if (vectorPrev != -1 && redoLogRecord[vectorPrev].opCode == 0x0501) {
-                        redoLogRecord[vectorCur].recordDataObj = redoLogRecord[vectorPrev].dataObj;
-                        redoLogRecord[vectorCur].recordObj = redoLogRecord[vectorPrev].obj;
-                    }
-                    OpCode0B08::process0B08(ctx, &redoLogRecord[vectorCur]);
-                    break;
+            case 0x0B08:
+                // REDO: Change forwarding address
+                if (redoLogRecordPrev != nullptr && redoLogRecordPrev->opCode == 0x0501) {
+                    redoLogRecord->recordDataObj = redoLogRecordPrev->dataObj;
+                    redoLogRecord->recordObj = redoLogRecordPrev->obj;
+                }
+                if (decodePlan.skipRedo(redoLogRecordPrev, false))
+                    redoLogRecord->partial = true;
+                else
+                    OpCode0B08::process0B08<Mode>(ctx, redoLogRecord);
+                break;
 
-                case 0x0B0B:
-                    // REDO: Insert multiple rows
-                    if (vectorPrev != -1 && redoLogRecord[vectorPrev].opCode == 0x0501) {
-                        redoLogRecord[vectorCur].recordDataObj = redoLogRecord[vectorPrev].dataObj;
-                        redoLogRecord[vectorCur].recordObj = redoLogRecord[vectorPrev].obj;
-                    }
-                    OpCode0B0B::process0B0B(ctx, &redoLogRecord[vectorCur]);
-                    break;
+            case 0x0B0B:
+                // REDO: Insert multiple rows
+                if (redoLogRecordPrev != nullptr && redoLogRecordPrev->opCode == 0x0501) {
+                    redoLogRecord->recordDataObj = redoLogRecordPrev->dataObj;
+                    redoLogRecord->recordObj = redoLogRecordPrev->obj;
+                }
+                if (decodePlan.skipRedo(redoLogRecordPrev, false))
+                    redoLogRecord->partial = true;
+                else
+                    OpCode0B0B::process0B0B<Mode>(ctx, redoLogRecord);
+                break;
 
-                case 0x0B0C:
-                    // REDO: Delete multiple rows
-                    if (vectorPrev != -1 && redoLogRecord[vectorPrev].opCode == 0x0501) {
-                        redoLogRecord[vectorCur].recordDataObj = redoLogRecord[vectorPrev].dataObj;
-                        redoLogRecord[vectorCur].recordObj = redoLogRecord[vectorPrev].obj;
-                    }
-                    OpCode0B0C::process0B0C(ctx, &redoLogRecord[vectorCur]);
-                    break;
+            case 0x0B0C:
+                // REDO: Delete multiple rows
+                if (redoLogRecordPrev != nullptr && redoLogRecordPrev->opCode == 0x0501) {
+                    redoLogRecord->recordDataObj = redoLogRecordPrev->dataObj;
+                    redoLogRecord->recordObj = redoLogRecordPrev->obj;
+                }
+                if (decodePlan.skipRedo(redoLogRecordPrev, false))
+                    redoLogRecord->partial = true;
+                else
+                    OpCode0B0C::process0B0C<Mode>(ctx, redoLogRecord);
+                break;
 
-                case 0x0B10:
-                    // REDO: Supplemental log for update
-                    if (vectorPrev != -1 && redoLogRecord[vectorPrev].opCode == 0x0501) {
-                        redoLogRecord[vectorCur].recordDataObj = redoLogRecord[vectorPrev].dataObj;
-                        redoLogRecord[vectorCur].recordObj = redoLogRecord[vectorPrev].obj;
-                    }
-                    OpCode0B10::process0B10(ctx, &redoLogRecord[vectorCur]);
-                    break;
+            case 0x0B10:
+                // REDO: Supplemental log for update
+                if (redoLogRecordPrev != nullptr && redoLogRecordPrev->opCode == 0x0501) {
+                    redoLogRecord->recordDataObj = redoLogRecordPrev->dataObj;
+                    redoLogRecord->recordObj = redoLogRecordPrev->obj;
+                }
+                if (decodePlan.skipRedo(redoLogRecordPrev, false))
+                    redoLogRecord->partial = true;
+                else
+                    OpCode0B10::process0B10<Mode>(ctx, redoLogRecord);
+                break;
 
-                case 0x0B16:
-                    // REDO: Logminer support - KDOCMP
-                    if (vectorPrev != -1 && redoLogRecord[vectorPrev].opCode == 0x0501) {
-                        redoLogRecord[vectorCur].recordDataObj = redoLogRecord[vectorPrev].dataObj;
-                        redoLogRecord[vectorCur].recordObj = redoLogRecord[vectorPrev].obj;
-                    }
-                    OpCode0B16::process0B16(ctx, &redoLogRecord[vectorCur]);
-                    break;
+            case 0x0B16:
+                // REDO: Logminer support - KDOCMP
+                if (redoLogRecordPrev != nullptr && redoLogRecordPrev->opCode == 0x0501) {
+                    redoLogRecord->recordDataObj = redoLogRecordPrev->dataObj;
+                    redoLogRecord->recordObj = redoLogRecordPrev->obj;
+                }
+                if (decodePlan.skipRedo(redoLogRecordPrev, false))
+                    redoLogRecord->partial = true;
+                else
+                    OpCode0B16::process0B16<Mode>(ctx, redoLogRecord);
+                break;
 
-                case 0x1301:
-                    // LOB
-                    OpCode1301::process1301(ctx, &redoLogRecord[vectorCur]);
-                    break;
+            case 0x1301:
+                // LOB
+                OpCode1301::process1301<Mode>(ctx, redoLogRecord);
+                break;
 
-                case 0x1A02:
-                    // LOB index 12+ and LOB redo
-                    if (vectorPrev != -1 && redoLogRecord[vectorPrev].opCode == 0x0501) {
-                        redoLogRecord[vectorCur].recordDataObj = redoLogRecord[vectorPrev].dataObj;
-                        redoLogRecord[vectorCur].recordObj = redoLogRecord[vectorPrev].obj;
-                    }
-                    OpCode1A02::process1A02(ctx, &redoLogRecord[vectorCur]);
-                    break;
+            case 0x1A02:
+                // LOB index 12+ and LOB redo
+                if (redoLogRecordPrev != nullptr && redoLogRecordPrev->opCode == 0x0501) {
+                    redoLogRecord->recordDataObj = redoLogRecordPrev->dataObj;
+                    redoLogRecord->recordObj = redoLogRecordPrev->obj;
+                }
+                OpCode1A02::process1A02<Mode>(ctx, redoLogRecord);
+                break;
 
-                case 0x1A06:
-                    OpCode1A06::process1A06(ctx, &redoLogRecord[vectorCur]);
-                    break;
+            case 0x1A06:
+                OpCode1A06::process1A06<Mode>(ctx, redoLogRecord);
+                break;
 
-                case 0x1801:
-                    // DDL
-                    OpCode1801::process1801(ctx, &redoLogRecord[vectorCur]);
-                    break;
+            case 0x1801:
+                // DDL
+                OpCode1801::process1801<Mode>(ctx, redoLogRecord);
+                break;
 
-                default:
-                    OpCode::process(ctx, &redoLogRecord[vectorCur]);
-                    break;
+            default:
+                OpCode::process<Mode>(ctx, redoLogRecord);
+                break;
+        }
+
+        return offset;
+    }
+
+    Parser::VECTOR Parser::vectorAction(const RedoLogRecord* redoLogRecordPrev, const RedoLogRecord* redoLogRecord) {
+        if (redoLogRecordPrev != nullptr) {
+            if (redoLogRecordPrev->opCode == 0x0501) {
+                if ((redoLogRecord->opCode & 0xFF00) == 0x0A00 || redoLogRecord->opCode == 0x1A02)
+                    return VECTOR::UNDO_INDEX;
+                if ((redoLogRecord->opCode & 0xFF00) == 0x0B00 || redoLogRecord->opCode == 0x0513 || redoLogRecord->opCode == 0x0514)
+                    return VECTOR::UNDO_DATA;
+                if (redoLogRecord->opCode == 0x0501)
+                    return VECTOR::UNDO_SINGLE;
+                return VECTOR::UNDO_UNKNOWN;
             }
 
-            if (vectorPrev != -1) {
-                if (redoLogRecord[vectorPrev].opCode == 0x0501) {
-                    if ((redoLogRecord[vectorCur].opCode & 0xFF00) == 0x0A00 || redoLogRecord[vectorCur].opCode == 0x1A02) {
-                        // UNDO - index
-                        appendToTransactionIndex(&redoLogRecord[vectorPrev], &redoLogRecord[vectorCur]);
-                    } else if ((redoLogRecord[vectorCur].opCode & 0xFF00) == 0x0B00 || redoLogRecord[vectorCur].opCode == 0x0513 ||
-                               redoLogRecord[vectorCur].opCode == 0x0514) {
-                        // UNDO - data
-                        appendToTransaction(&redoLogRecord[vectorPrev], &redoLogRecord[vectorCur]);
-                    } else if (redoLogRecord[vectorCur].opCode == 0x0501) {
-                        // Single 5.1
-                        appendToTransaction(&redoLogRecord[vectorPrev]);
-                        continue;
-                    } else if (redoLogRecord[vectorPrev].opc == 0x0B01)
-                        ctx->warning(70010, "unknown undo OP: " + std::to_string(static_cast<uint>(redoLogRecord[vectorCur].opCode >> 8)) +
-                                            "." + std::to_string(static_cast<uint>(redoLogRecord[vectorCur].opCode & 0xFF)) + ", opc: " +
-                                            std::to_string(redoLogRecord[vectorPrev].opc));
-
-                    vectorCur = -1;
-                    continue;
-                }
+            if (redoLogRecord->opCode == 0x0506 || redoLogRecord->opCode == 0x050B)
+                return VECTOR::ROLLBACK_PAIR;
+        }
 
-                if ((redoLogRecord[vectorCur].opCode == 0x0506 || redoLogRecord[vectorCur].opCode == 0x050B)) {
-                    if ((redoLogRecord[vectorPrev].opCode & 0xFF00) == 0x0B00)
-                        appendToTransactionRollback(&redoLogRecord[vectorPrev], &redoLogRecord[vectorCur]);
-                    else if (redoLogRecord[vectorCur].opc == 0x0B01)
-                        ctx->warning(70011, "unknown rollback OP: " + std::to_string(static_cast<uint>(redoLogRecord[vectorCur].opCode >> 8)) +
-                                            "." + std::to_string(static_cast<uint>(redoLogRecord[vectorCur].opCode & 0xFF)) + ", opc: " +
-                                            std::to_string(redoLogRecord[vectorPrev].opc));
+        if (redoLogRecord->opCode == 0x0501 && (redoLogRecord->flg & (OpCode::FLG_MULTIBLOCKUNDOTAIL | OpCode::FLG_MULTIBLOCKUNDOMID)) != 0)
+            return VECTOR::UNDO;
+        if (redoLogRecord->opCode == 0x0506 || redoLogRecord->opCode == 0x050B)
+            return VECTOR::ROLLBACK;
+        if (redoLogRecord->opCode == 0x0502)
+            return VECTOR::BEGIN;
+        if (redoLogRecord->opCode == 0x0504)
+            return VECTOR::COMMIT;
+        if (redoLogRecord->opCode == 0x1301 || redoLogRecord->opCode == 0x1A06)
+            return VECTOR::LOB;
+        if (redoLogRecord->opCode == 0x1801)
+            return VECTOR::DDL;
+        return VECTOR::KEEP;
+    }
 
-                    vectorCur = -1;
-                    continue;
-                }
-            }
+    bool Parser::applyVector(RedoLogRecord* redoLogRecordPrev, RedoLogRecord* redoLogRecord) {
+        // The schema changed since the record was decoded, the object might be replicated now
+        if (unlikely(redoLogRecord->partial) && (lwnPlanVersion != metadata->schema->tablePartitionVersion.load(std::memory_order_acquire) ||
+                                                 metadata->schemaMapsPending.load(std::memory_order_acquire)))
+            redecodeVector(redoLogRecordPrev, redoLogRecord);
+
+        if (unlikely(ctx->redoProfile != nullptr))
+            ctx->redoProfile->vector(redoLogRecord->opCode, redoLogRecord->size);
+
+        // Session information
+        if (redoLogRecord->opCode == 0x0513)
+            opCodeModeCall(ctx, [&](auto mode) {
+                OpCode0513::process0513<decltype(mode)>(ctx, redoLogRecord, lastTransaction);
+            });
+        else if (redoLogRecord->opCode == 0x0514)
+            opCodeModeCall(ctx, [&](auto mode) {
+                OpCode0514::process0514<decltype(mode)>(ctx, redoLogRecord, lastTransaction);
+            });
+
+        switch (vectorAction(redoLogRecordPrev, redoLogRecord)) {
+            case VECTOR::UNDO_INDEX:
+                // UNDO - index
+                appendToTransactionIndex(redoLogRecordPrev, redoLogRecord);
+                return false;
+
+            case VECTOR::UNDO_DATA:
+                // UNDO - data
+                appendToTransaction(redoLogRecordPrev, redoLogRecord);
+                return false;
+
+            case VECTOR::UNDO_SINGLE:
+                // Single 5.1
+                appendToTransaction(redoLogRecordPrev);
+                return true;
+
+            case VECTOR::UNDO_UNKNOWN:
+                if (redoLogRecordPrev->opc == 0x0B01)
+                    ctx->warning(70010, "unknown undo OP: " + std::to_string(static_cast<uint>(redoLogRecord->opCode >> 8)) +
+                                        "." + std::to_string(static_cast<uint>(redoLogRecord->opCode & 0xFF)) + ", opc: " +
+                                        std::to_string(redoLogRecordPrev->opc));
+                return false;
+
+            case VECTOR::ROLLBACK_PAIR:
+                if ((redoLogRecordPrev->opCode & 0xFF00) == 0x0B00)
+                    appendToTransactionRollback(redoLogRecordPrev, redoLogRecord);
+                else if (redoLogRecord->opc == 0x0B01)
+                    ctx->warning(70011, "unknown rollback OP: " + std::to_string(static_cast<uint>(redoLogRecord->opCode >> 8)) +
+                                        "." + std::to_string(static_cast<uint>(redoLogRecord->opCode & 0xFF)) + ", opc: " +
+                                        std::to_string(redoLogRecordPrev->opc));
+                return false;
+
+            case VECTOR::UNDO:
+                // UNDO - data
+                appendToTransaction(redoLogRecord);
+                return false;
+
+            case VECTOR::ROLLBACK:
+                // ROLLBACK - data
+                appendToTransactionRollback(redoLogRecord);
+                return false;
+
+            case VECTOR::BEGIN:
+                appendToTransactionBegin(redoLogRecord);
+                return false;
+
+            case VECTOR::COMMIT:
+                appendToTransactionCommit(redoLogRecord);
+                return false;
+
+            case VECTOR::LOB:
+                appendToTransactionLob(redoLogRecord);
+                return false;
+
+            case VECTOR::DDL:
+                appendToTransactionDdl(redoLogRecord);
+                return false;
 
-            // UNDO - data
-            if (redoLogRecord[vectorCur].opCode == 0x0501 &&
-                (redoLogRecord[vectorCur].flg & (OpCode::FLG_MULTIBLOCKUNDOTAIL | OpCode::FLG_MULTIBLOCKUNDOMID)) != 0) {
-                appendToTransaction(&redoLogRecord[vectorCur]);
-                vectorCur = -1;
-                continue;
-            }
+            default:
+                return true;
+        }
+    }
 
-            // ROLLBACK - data
-            if (redoLogRecord[vectorCur].opCode == 0x0506 || redoLogRecord[vectorCur].opCode == 0x050B) {
-                appendToTransactionRollback(&redoLogRecord[vectorCur]);
-                vectorCur = -1;
-                continue;
-            }
+    void Parser::analyzeLwn(LwnMember* lwnMember) {
+        const uint16_t headerSize = decodeLwnHeader(lwnMember);
+        RedoLogRecord redoLogRecord[2];
+        int64_t vectorCur = -1;
+        uint32_t offset = headerSize;
+        uint32_t vectors = 0;
+        lwnApplied = lwnMember;
 
-            // BEGIN
-            if (redoLogRecord[vectorCur].opCode == 0x0502) {
-                appendToTransactionBegin(&redoLogRecord[vectorCur]);
-                vectorCur = -1;
-                continue;
-            }
+        while (offset < lwnMember->size) {
+            const int64_t vectorPrev = vectorCur;
+            if (vectorPrev == -1)
+                vectorCur = 0;
+            else
+                vectorCur = 1 - vectorPrev;
 
-            // COMMIT
-            if (redoLogRecord[vectorCur].opCode == 0x0504) {
-                appendToTransactionCommit(&redoLogRecord[vectorCur]);
+            RedoLogRecord* redoLogRecordPrev = (vectorPrev == -1 ? nullptr : &redoLogRecord[vectorPrev]);
+            offset = decodeVector(lwnMember, offset, ++vectors, &redoLogRecord[vectorCur], redoLogRecordPrev);
+            if (!applyVector(redoLogRecordPrev, &redoLogRecord[vectorCur]))
                 vectorCur = -1;
-                continue;
-            }
+        }
 
-            // LOB
-            if (redoLogRecord[vectorCur].opCode == 0x1301 || redoLogRecord[vectorCur].opCode == 0x1A06) {
-                appendToTransactionLob(&redoLogRecord[vectorCur]);
-                vectorCur = -1;
-                continue;
+        // UNDO - data
+        if (vectorCur != -1 && redoLogRecord[vectorCur].opCode == 0x0501) {
+            appendToTransaction(&redoLogRecord[vectorCur]);
+        }
+    }
+
+    void Parser::decodeLwn(uint64_t num, uint worker) {
+        LwnDecoded& decoded = lwnDecoded[num];
+        std::vector<RedoLogRecord>& records = lwnDecodedRecords[worker];
+        decoded.worker = worker;
+        decoded.first = records.size();
+        decoded.count = 0;
+        decoded.error = nullptr;
+
+        try {
+            LwnMember* lwnMember = lwnMembers[num];
+            uint32_t offset = decodeLwnHeader(lwnMember);
+            uint32_t vectors = 0;
+            bool prevKept = false;
+
+            while (offset < lwnMember->size) {
+                records.emplace_back();
+                RedoLogRecord* redoLogRecord = &records.back();
+                const RedoLogRecord* redoLogRecordPrev = (prevKept ? redoLogRecord - 1 : nullptr);
+                offset = decodeVector(lwnMember, offset, ++vectors, redoLogRecord, redoLogRecordPrev);
+                ++decoded.count;
+
+                const VECTOR action = vectorAction(redoLogRecordPrev, redoLogRecord);
+                prevKept = (action == VECTOR::KEEP || action == VECTOR::UNDO_SINGLE);
             }
+        } catch (...) {
+            decoded.error = std::current_exception();
+        }
+    }
 
-            // DDL
-            if (redoLogRecord[vectorCur].opCode == 0x1801) {
-                appendToTransactionDdl(&redoLogRecord[vectorCur]);
-                vectorCur = -1;
+    // Vectors of the objects which can't reach the output are decoded only up to the header fields, which is all that the transaction
+    // bookkeeping needs. The plan is rebuilt on the thread decoding the LWNs whenever the table or LOB index maps change
+    void Parser::decodePlanRefresh() {
+        if (ctx->dumpRedoLog >= 1 || ctx->isFlagSet(Ctx::REDO_FLAGS::SCHEMALESS) || ctx->isFlagSet(Ctx::REDO_FLAGS::ADAPTIVE_SCHEMA) ||
+            metadata->schemaMapsPending.load(std::memory_order_acquire)) {
+            decodePlan.active = false;
+            return;
+        }
+        if (decodePlan.active && decodePlan.version == metadata->schema->tablePartitionVersion.load(std::memory_order_acquire))
+            return;
+
+        lwnThread->contextSet(Thread::CONTEXT::TRAN);
+        {
+            std::unique_lock<std::mutex> const lckTransaction(metadata->mtxTransaction);
+            decodePlan.version = metadata->schema->tablePartitionVersion.load(std::memory_order_relaxed);
+            decodePlan.tables.clear();
+            decodePlan.tables.reserve(metadata->schema->tablePartitionMap.size());
+            for (const auto& [obj, table]: metadata->schema->tablePartitionMap)
+                decodePlan.tables.insert(obj);
+            decodePlan.lobIndexes.clear();
+            decodePlan.lobIndexes.reserve(metadata->schema->lobIndexMap.size());
+            for (const auto& [dataObj, lob]: metadata->schema->lobIndexMap)
+                decodePlan.lobIndexes.insert(dataObj);
+        }
+        lwnThread->contextSet(Thread::CONTEXT::CPU);
+        decodePlan.active = true;
+    }
+
+    // Records decoded with a stale plan are decoded again in full before they are applied
+    void Parser::redecodeVector(const RedoLogRecord* redoLogRecordPrev, RedoLogRecord* redoLogRecord) {
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(lwnApplied) + sizeof(struct LwnMember);
+        const auto offset = static_cast<uint32_t>(redoLogRecord->dataExt - data);
+        const bool active = decodePlan.active;
+        decodePlan.active = false;
+        try {
+            decodeVector(lwnApplied, offset, redoLogRecord->vectorNo, redoLogRecord, redoLogRecordPrev);
+        } catch (...) {
+            decodePlan.active = active;
+            throw;
+        }
+        decodePlan.active = active;
+    }
+
+    void Parser::applyLwn(uint64_t num) {
+        const LwnDecoded& decoded = lwnDecoded[num];
+        RedoLogRecord* records = lwnDecodedRecords[decoded.worker].data() + decoded.first;
+        RedoLogRecord* redoLogRecordPrev = nullptr;
+        lwnApplied = lwnMembers[num];
+
+        for (uint64_t i = 0; i < decoded.count; ++i) {
+            if (applyVector(redoLogRecordPrev, &records[i]))
+                redoLogRecordPrev = &records[i];
+            else
+                redoLogRecordPrev = nullptr;
+        }
+
+        // Same point of failure as when decoding serially
+        if (decoded.error != nullptr)
+            std::rethrow_exception(decoded.error);
+
+        // UNDO - data
+        if (redoLogRecordPrev != nullptr && redoLogRecordPrev->opCode == 0x0501)
+            appendToTransaction(redoLogRecordPrev);
+    }
+
+    // Members are applied in scn order, which is not the order they were copied to the LWN chunks. The one a few places ahead and
+    // the transaction of the next one, known only when the records were decoded in parallel, are brought to the cache while the current
+    // member is processed
+    void Parser::prefetchLwn(uint64_t num, bool parallel) const {
+        const uint64_t ahead = num + ctx->lwnPrefetch;
+        if (ahead < lwnMembers.size()) {
+            const auto* data = reinterpret_cast<const uint8_t*>(lwnMembers[ahead]);
+            const uint64_t size = std::min<uint64_t>(sizeof(struct LwnMember) + lwnMembers[ahead]->size, LWN_PREFETCH_BYTES);
+            for (uint64_t pos = 0; pos < size; pos += 64)
+                __builtin_prefetch(data + pos, 0, 1);
+        }
+
+        if (!parallel || num + 1 >= lwnMembers.size())
+            return;
+        const LwnDecoded& decoded = lwnDecoded[num + 1];
+        if (decoded.count == 0)
+            return;
+        const RedoLogRecord& redoLogRecord = lwnDecodedRecords[decoded.worker][decoded.first];
+        transactionBuffer->prefetchTransaction(redoLogRecord.xid, redoLogRecord.conId);
+    }
+
+    uint8_t Parser::lwnSortByte(const LwnMember* lwnMember, uint pass) {
+        if (pass < sizeof(typeSubScn))
+            return static_cast<uint8_t>(lwnMember->subScn >> (pass * 8));
+        return static_cast<uint8_t>(lwnMember->scn.getData() >> ((pass - sizeof(typeSubScn)) * 8));
+    }
+
+    // Members are collected in block and offset order, so a stable sort by scn and subscn gives the LwnMember::operator< order
+    void Parser::sortLwn() {
+        const uint64_t count = lwnMembers.size();
+        uint64_t pos = 1;
+        while (pos < count && !(*lwnMembers[pos] < *lwnMembers[pos - 1]))
+            ++pos;
+        if (pos >= count)
+            return;
+
+        // LSD radix sort, bytes equal for all members are skipped
+        lwnMembersTmp.resize(count);
+        for (uint pass = 0; pass < sizeof(typeSubScn) + sizeof(uint64_t); ++pass) {
+            uint64_t buckets[257]{};
+            for (const LwnMember* lwnMember: lwnMembers)
+                ++buckets[lwnSortByte(lwnMember, pass) + 1];
+
+            if (buckets[lwnSortByte(lwnMembers[0], pass) + 1] == count)
                 continue;
+
+            for (uint bucket = 1; bucket < 257; ++bucket)
+                buckets[bucket] += buckets[bucket - 1];
+            for (LwnMember* lwnMember: lwnMembers)
+                lwnMembersTmp[buckets[lwnSortByte(lwnMember, pass)]++] = lwnMember;
+            lwnMembers.swap(lwnMembersTmp);
+        }
+    }
+
+    // Tables not being replicated are dropped before any data is buffered, the lookups are cached so that the transaction mutex
+    // is only taken for objects not seen since the last schema change. While a map rebuild is pending only lookups it would not change
+    // are answered without it
+    const DbTable* Parser::checkTable(typeObj obj) {
+        const bool mapsPending = metadata->schemaMapsPending.load(std::memory_order_acquire);
+        if (unlikely(tableCacheVersion != metadata->schema->tablePartitionVersion.load(std::memory_order_acquire))) {
+            tableCache.clear();
+            tableCacheVersion = metadata->schema->tablePartitionVersion.load(std::memory_order_acquire);
+        } else if (likely(!mapsPending)) {
+            const auto& it = tableCache.find(obj);
+            if (it != tableCache.end())
+                return it->second;
+        }
+
+        const DbTable* table;
+        ctx->parserThread->contextSet(Thread::CONTEXT::TRAN);
+        {
+            std::unique_lock<std::mutex> const lckTransaction(metadata->mtxTransaction);
+            table = metadata->schema->checkTableDict(obj);
+            if (unlikely(mapsPending)) {
+                ctx->parserThread->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::TRANSACTION_SYSTEM);
+                std::unique_lock<std::mutex> const lckSchema(metadata->mtxSchema);
+                ctx->parserThread->contextSet(Thread::CONTEXT::TRAN);
+                if (metadata->schemaMapsPending && metadata->schema->isLookupStale(obj, table)) {
+                    metadata->rebuildSchemaMaps();
+                    table = metadata->schema->checkTableDict(obj);
+                }
+            }
+            // The first DML of a table built lazily, the columns are added before anything is buffered for it
+            if (unlikely(table != nullptr && table->columnsPending)) {
+                ctx->parserThread->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::PARSER_SCHEMA);
+                std::unique_lock<std::mutex> const lckSchema(metadata->mtxSchema);
+                ctx->parserThread->contextSet(Thread::CONTEXT::TRAN);
+                metadata->schema->materializeTable(table->obj);
+            }
+            if (unlikely(tableCacheVersion != metadata->schema->tablePartitionVersion.load(std::memory_order_relaxed))) {
+                tableCache.clear();
+                tableCacheVersion = metadata->schema->tablePartitionVersion.load(std::memory_order_relaxed);
             }
         }
+        ctx->parserThread->contextSet(Thread::CONTEXT::CPU);
+
+        // Tables of partitions owned by other instances are dropped here like tables not replicated, the dictionary is followed by
+        // all instances
+        if (metadata->partitions != nullptr && table != nullptr && !DbTable::isSystemTable(table->options) &&
+            !DbTable::isSchemaTable(table->options) && !metadata->partitions->owns(table->obj))
+            table = nullptr;
+
+        if (tableCache.size() >= TABLE_CACHE_MAX)
+            tableCache.clear();
+        tableCache.insert_or_assign(obj, table);
+        return table;
+    }
+
+    // A transaction not sampled at start is traced when it changes a table with its own sampling, one in that many of the
+    // transactions changing the table
+    void Parser::traceTable(Transaction* transaction, const DbTable* table) {
+        if (transaction->traceTable == table)
+            return;
+        transaction->traceTable = table;
+
+        const uint64_t rulesVersion = ctx->tracer->rulesVersion.load(std::memory_order_relaxed);
+        if (traceSamplesTableVersion != tableCacheVersion || traceSamplesRulesVersion != rulesVersion || traceSamples.size() >= TABLE_CACHE_MAX) {
+            traceSamples.clear();
+            traceSamplesTableVersion = tableCacheVersion;
+            traceSamplesRulesVersion = rulesVersion;
+        }
 
-        // UNDO - data
-        if (vectorCur != -1 && redoLogRecord[vectorCur].opCode == 0x0501) {
-            appendToTransaction(&redoLogRecord[vectorCur]);
+        auto it = traceSamples.find(table);
+        if (it == traceSamples.end())
+            it = traceSamples.insert_or_assign(table, TraceSample{ctx->tracer->tableSample(table), 0}).first;
+        TraceSample& traceSample = it->second;
+        if (traceSample.sample == 0 || ++traceSample.cnt < traceSample.sample)
+            return;
+        traceSample.cnt = 0;
+        transaction->traced = true;
+    }
+
+    // Standby instance doesn't go ahead of the position confirmed by the client of the lease holder, everything up to it is
+    // already sent. The schema and open transactions are kept current, so that the output can start right after taking over
+    void Parser::standbyWait() {
+        while (metadata->standby && !ctx->hardShutdown) {
+            const Scn scn(metadata->standbyScn.load());
+            if (scn != Scn::none() && lwnScn <= scn)
+                break;
+
+            if (unlikely(ctx->isTraceSet(Ctx::TRACE::SLEEP)))
+                ctx->logTrace(Ctx::TRACE::SLEEP, "Parser:standbyWait lwnScn: " + lwnScn.toString() + " standbyScn: " + scn.toString());
+            ctx->parserThread->contextSet(Thread::CONTEXT::SLEEP, Thread::REASON::PARSER_STANDBY);
+            usleep(ctx->redoReadSleepUs);
+            ctx->parserThread->contextSet(Thread::CONTEXT::CPU);
         }
+
+        const Scn scn(metadata->standbyScn.load());
+        if (scn != Scn::none() && (metadata->firstDataScn == Scn::none() || metadata->firstDataScn < scn))
+            metadata->firstDataScn = scn;
+        if (!metadata->standby)
+            standbyPending = false;
+    }
+
+    // Redo read again after restart for a transaction restored from its image, the image already has its rows
+    bool Parser::replayed(const Transaction* transaction, const RedoLogRecord* redoLogRecord) const {
+        if (likely(transaction->persistSequence == Seq::none()))
+            return false;
+        return sequence < transaction->persistSequence ||
+               (sequence == transaction->persistSequence && redoLogRecord->fileOffset < transaction->persistFileOffset);
     }
 
     void Parser::appendToTransactionDdl(RedoLogRecord* redoLogRecord1) {
@@ -553,15 +916,11 @@ namespace OpenLogReplicator {
                                                                       true, ctx->isFlagSet(Ctx::REDO_FLAGS::SHOW_INCOMPLETE_TRANSACTIONS), false);
         if (transaction == nullptr)
             return;
+        if (replayed(transaction, redoLogRecord1))
+            return;
         lastTransaction = transaction;
 
-        const DbTable* table;
-        {
-            ctx->parserThread->contextSet(Thread::CONTEXT::TRAN);
-            std::unique_lock<std::mutex> const lckTransaction(metadata->mtxTransaction);
-            table = metadata->schema->checkTableDict(redoLogRecord1->obj);
-        }
-        ctx->parserThread->contextSet(Thread::CONTEXT::CPU);
+        const DbTable* table = checkTable(redoLogRecord1->obj);
 
         if (table == nullptr) {
             if (!ctx->isFlagSet(Ctx::REDO_FLAGS::SCHEMALESS) && !ctx->isFlagSet(Ctx::REDO_FLAGS::SHOW_DDL)) {
@@ -573,6 +932,8 @@ namespace OpenLogReplicator {
                 transaction->system = true;
             if (DbTable::isSchemaTable(table->options))
                 transaction->schema = true;
+            if (unlikely(ctx->tracer != nullptr) && ctx->tracer->tableRules && !transaction->traced)
+                traceTable(transaction, table);
         }
 
         // Transaction size limit
@@ -580,14 +941,16 @@ namespace OpenLogReplicator {
             transaction->size + redoLogRecord1->size + TransactionBuffer::ROW_HEADER_TOTAL >= ctx->transactionSizeMax) {
             transactionBuffer->skipXidList.insert(transaction->xid);
             transactionBuffer->dropTransaction(redoLogRecord1->xid, redoLogRecord1->conId);
-            transaction->purge(ctx);
+            transaction->purge(ctx, transactionBuffer);
             if (transaction == lastTransaction)
                 lastTransaction = nullptr;
-            delete transaction;
+            transactionBuffer->releaseTransaction(transaction);
             return;
         }
 
         transaction->add(metadata, transactionBuffer, redoLogRecord1, &zero);
+        if (unlikely(ctx->tableCost != nullptr) && table != nullptr)
+            tableCostLocal.add(table, Metrics::TABLE_COST::BYTES_BUFFERED, redoLogRecord1->size);
     }
 
     void Parser::appendToTransactionLob(RedoLogRecord* redoLogRecord1) {
@@ -596,6 +959,13 @@ namespace OpenLogReplicator {
         {
             std::unique_lock<std::mutex> const lckTransaction(metadata->mtxTransaction);
             lob = metadata->schema->checkLobDict(redoLogRecord1->dataObj);
+            if (unlikely(lob == nullptr && metadata->schemaMapsPending.load(std::memory_order_acquire))) {
+                std::unique_lock<std::mutex> const lckSchema(metadata->mtxSchema);
+                if (metadata->schemaMapsPending) {
+                    metadata->rebuildSchemaMaps();
+                    lob = metadata->schema->checkLobDict(redoLogRecord1->dataObj);
+                }
+            }
         }
         ctx->parserThread->contextSet(Thread::CONTEXT::CPU);
 
@@ -627,6 +997,11 @@ namespace OpenLogReplicator {
         if (transaction == nullptr)
             return;
         lastTransaction = transaction;
+        transaction->lobData = true;
+        if (unlikely(ctx->redoProfile != nullptr)) {
+            ctx->redoProfile->lob(redoLogRecord1->size);
+            transaction->profileBytes += redoLogRecord1->size;
+        }
 
         if (lob->table != nullptr && DbTable::isSystemTable(lob->table->options))
             transaction->system = true;
@@ -652,20 +1027,21 @@ namespace OpenLogReplicator {
                                                                       true, ctx->isFlagSet(Ctx::REDO_FLAGS::SHOW_INCOMPLETE_TRANSACTIONS), false);
         if (transaction == nullptr)
             return;
+        if (replayed(transaction, redoLogRecord1))
+            return;
         lastTransaction = transaction;
+        // Counted before the filter, the profile covers all objects
+        if (unlikely(ctx->redoProfile != nullptr)) {
+            ctx->redoProfile->object(redoLogRecord1->obj, redoLogRecord1->size);
+            transaction->profileBytes += redoLogRecord1->size;
+        }
 
         if (redoLogRecord1->opc != 0x0501 && redoLogRecord1->opc != 0x0A16 && redoLogRecord1->opc != 0x0B01) {
             transaction->log(ctx, "opc ", redoLogRecord1);
             return;
         }
 
-        const DbTable* table;
-        ctx->parserThread->contextSet(Thread::CONTEXT::TRAN);
-        {
-            std::unique_lock<std::mutex> const lckTransaction(metadata->mtxTransaction);
-            table = metadata->schema->checkTableDict(redoLogRecord1->obj);
-        }
-        ctx->parserThread->contextSet(Thread::CONTEXT::CPU);
+        const DbTable* table = checkTable(redoLogRecord1->obj);
 
         if (table == nullptr) {
             if (!ctx->isFlagSet(Ctx::REDO_FLAGS::SCHEMALESS)) {
@@ -677,6 +1053,8 @@ namespace OpenLogReplicator {
                 transaction->system = true;
             if (DbTable::isSchemaTable(table->options))
                 transaction->schema = true;
+            if (unlikely(ctx->tracer != nullptr) && ctx->tracer->tableRules && !transaction->traced)
+                traceTable(transaction, table);
         }
 
         // Transaction size limit
@@ -684,14 +1062,16 @@ namespace OpenLogReplicator {
             transaction->log(ctx, "siz ", redoLogRecord1);
             transactionBuffer->skipXidList.insert(transaction->xid);
             transactionBuffer->dropTransaction(redoLogRecord1->xid, redoLogRecord1->conId);
-            transaction->purge(ctx);
+            transaction->purge(ctx, transactionBuffer);
             if (transaction == lastTransaction)
                 lastTransaction = nullptr;
-            delete transaction;
+            transactionBuffer->releaseTransaction(transaction);
             return;
         }
 
         transaction->add(metadata, transactionBuffer, redoLogRecord1);
+        if (unlikely(ctx->tableCost != nullptr) && table != nullptr)
+            tableCostLocal.add(table, Metrics::TABLE_COST::BYTES_BUFFERED, redoLogRecord1->size);
     }
 
     void Parser::appendToTransactionRollback(RedoLogRecord* redoLogRecord1) {
@@ -716,14 +1096,10 @@ namespace OpenLogReplicator {
             return;
         }
         lastTransaction = transaction;
+        if (replayed(transaction, redoLogRecord1))
+            return;
 
-        const DbTable* table;
-        ctx->parserThread->contextSet(Thread::CONTEXT::TRAN);
-        {
-            std::unique_lock<std::mutex> const lckTransaction(metadata->mtxTransaction);
-            table = metadata->schema->checkTableDict(redoLogRecord1->obj);
-        }
-        ctx->parserThread->contextSet(Thread::CONTEXT::CPU);
+        const DbTable* table = checkTable(redoLogRecord1->obj);
 
         if (table == nullptr) {
             if (!ctx->isFlagSet(Ctx::REDO_FLAGS::SCHEMALESS)) {
@@ -740,6 +1116,13 @@ namespace OpenLogReplicator {
         if (redoLogRecord1->xid.sqn() == 0)
             return;
 
+        if (unlikely(!transactionBuffer->persistPath.empty())) {
+            const Transaction* restored = transactionBuffer->findTransaction(metadata->schema->xmlCtxDefault, redoLogRecord1->xid,
+                                                                             redoLogRecord1->conId, true, false, false);
+            if (restored != nullptr && replayed(restored, redoLogRecord1))
+                return;
+        }
+
         Transaction* transaction = transactionBuffer->findTransaction(metadata->schema->xmlCtxDefault, redoLogRecord1->xid, redoLogRecord1->conId,
                                                                       false, true, false);
         transaction->begin = true;
@@ -780,13 +1163,46 @@ namespace OpenLogReplicator {
         transaction->commitTimestamp = lwnTimestamp;
         transaction->commitScn = redoLogRecord1->scnRecord;
         transaction->commitSequence = sequence;
+        if (unlikely(transaction->traced))
+            transaction->traceCommitUt = ctx->clock->getTimeUt();
         if ((redoLogRecord1->flg & OpCode::FLG_ROLLBACK_OP0504) != 0)
             transaction->rollback = true;
+        // xid, commit scn, size in bytes
+        if (transaction->rollback)
+            OLR_PROBE3(transaction_rollback, transaction->xid.getData(), transaction->commitScn.getData(), transaction->size);
+        else
+            OLR_PROBE3(transaction_commit, transaction->xid.getData(), transaction->commitScn.getData(), transaction->size);
+        if (unlikely(ctx->redoProfile != nullptr) && transaction->begin) {
+            const time_t commitEpoch = lwnTimestamp.toEpoch(ctx->hostTimezone);
+            ctx->redoProfile->commit(transaction->profileBytes, transaction->size,
+                                     commitEpoch > transaction->beginEpoch ? commitEpoch - transaction->beginEpoch : 0, transaction->rollback);
+        }
 
         if ((transaction->commitScn > metadata->firstDataScn && !transaction->system) ||
             (transaction->commitScn > metadata->firstSchemaScn && transaction->system)) {
 
-            if (transaction->begin) {
+            if (unlikely(ctx->redoProfile != nullptr) && !transaction->system) {
+                // Only profiled, no output is built. System transactions are still applied to keep the schema current
+            } else if (transaction->begin) {
+                // System transactions change the schema and debug stops check the builder position, both are built by the parser thread
+                // once everything committed before is flushed
+                if (transactionFlusher != nullptr && !transaction->system && !transaction->shutdown && ctx->stopTransactions == 0 &&
+                    !metadata->schemaMapsPending.load(std::memory_order_acquire)) {
+                    if (transactionFlusher->commit(ctx->parserThread, transaction, lwnScn)) {
+                        if (ctx->metrics != nullptr) {
+                            if (transaction->rollback)
+                                ctx->metrics->emitTransactionsRollbackOut(1);
+                            else
+                                ctx->metrics->emitTransactionsCommitOut(1);
+                        }
+                        transactionBuffer->dropTransaction(redoLogRecord1->xid, redoLogRecord1->conId);
+                        lastTransaction = nullptr;
+                        return;
+                    }
+                }
+                if (transactionFlusher != nullptr)
+                    transactionFlusher->drain(ctx->parserThread);
+
                 transaction->flush(metadata, builder, lwnScn);
                 ctx->parserThread->contextSet(Thread::CONTEXT::CPU);
                 if (ctx->metrics != nullptr) {
@@ -830,9 +1246,9 @@ namespace OpenLogReplicator {
         }
 
         transactionBuffer->dropTransaction(redoLogRecord1->xid, redoLogRecord1->conId);
-        transaction->purge(ctx);
+        transaction->purge(ctx, transactionBuffer);
         lastTransaction = nullptr;
-        delete transaction;
+        transactionBuffer->releaseTransaction(transaction);
     }
 
     void Parser::appendToTransaction(RedoLogRecord* redoLogRecord1, RedoLogRecord* redoLogRecord2) {
@@ -848,6 +1264,8 @@ namespace OpenLogReplicator {
                                                                       true, ctx->isFlagSet(Ctx::REDO_FLAGS::SHOW_INCOMPLETE_TRANSACTIONS), false);
         if (transaction == nullptr)
             return;
+        if (replayed(transaction, redoLogRecord1))
+            return;
         lastTransaction = transaction;
 
         typeObj obj;
@@ -863,7 +1281,12 @@ namespace OpenLogReplicator {
         if (unlikely(redoLogRecord1->bdba != redoLogRecord2->bdba && redoLogRecord1->bdba != 0 && redoLogRecord2->bdba != 0))
             throw RedoLogException(50045, "bdba does not match (" + std::to_string(redoLogRecord1->bdba) + ", " +
                                           std::to_string(redoLogRecord2->bdba) + "), offset: " + redoLogRecord1->fileOffset.toString());
+        if (unlikely(ctx->redoProfile != nullptr)) {
+            ctx->redoProfile->object(obj, redoLogRecord1->size + redoLogRecord2->size);
+            transaction->profileBytes += redoLogRecord1->size + redoLogRecord2->size;
+        }
 
+        const DbTable* table = nullptr;
         switch (redoLogRecord2->opCode) {
             case 0x0513:
             case 0x0514:
@@ -888,13 +1311,7 @@ namespace OpenLogReplicator {
                 // Supp log for update
             case 0x0B16: {
                 // Logminer support - KDOCMP
-                const DbTable* table;
-                ctx->parserThread->contextSet(Thread::CONTEXT::TRAN);
-                {
-                    std::unique_lock<std::mutex> const lckTransaction(metadata->mtxTransaction);
-                    table = metadata->schema->checkTableDict(obj);
-                }
-                ctx->parserThread->contextSet(Thread::CONTEXT::CPU);
+                table = checkTable(obj);
 
                 if (table == nullptr) {
                     if (!ctx->isFlagSet(Ctx::REDO_FLAGS::SCHEMALESS)) {
@@ -909,6 +1326,8 @@ namespace OpenLogReplicator {
                         transaction->schema = true;
                     if (DbTable::isDebugTable(table->options) && redoLogRecord2->opCode == 0x0B02 && !ctx->softShutdown)
                         transaction->shutdown = true;
+                    if (unlikely(ctx->tracer != nullptr) && ctx->tracer->tableRules && !transaction->traced)
+                        traceTable(transaction, table);
                 }
             }
                 break;
@@ -926,14 +1345,34 @@ namespace OpenLogReplicator {
             transaction->log(ctx, "siz2", redoLogRecord2);
             transactionBuffer->skipXidList.insert(transaction->xid);
             transactionBuffer->dropTransaction(redoLogRecord1->xid, redoLogRecord1->conId);
-            transaction->purge(ctx);
+            transaction->purge(ctx, transactionBuffer);
             if (transaction == lastTransaction)
                 lastTransaction = nullptr;
-            delete transaction;
+            transactionBuffer->releaseTransaction(transaction);
             return;
         }
 
         transaction->add(metadata, transactionBuffer, redoLogRecord1, redoLogRecord2);
+        if (unlikely(ctx->tableCost != nullptr) && table != nullptr)
+            tableCostLocal.add(table, Metrics::TABLE_COST::BYTES_BUFFERED, redoLogRecord1->size + redoLogRecord2->size);
+
+        // Rows of a big transaction are sent before the commit, cut at the end of a row
+        if (unlikely(ctx->transactionStreamSize > 0 && transaction->size >= ctx->transactionStreamSize) &&
+            (redoLogRecord2->opCode == 0x0B0B || redoLogRecord2->opCode == 0x0B0C || (redoLogRecord1->suppLogFb & RedoLogRecord::FB_L) != 0))
+            streamTransaction(transaction);
+    }
+
+    void Parser::streamTransaction(Transaction* transaction) {
+        if (!transaction->begin || transaction->system || transaction->schema || transaction->shutdown || transaction->lobData ||
+            lwnScn <= metadata->firstDataScn || ctx->redoProfile != nullptr)
+            return;
+
+        // Provisional rows follow everything committed before
+        if (transactionFlusher != nullptr)
+            transactionFlusher->drain(ctx->parserThread);
+
+        transaction->stream(metadata, builder, transactionBuffer, lwnScn, lwnTimestamp, sequence);
+        ctx->parserThread->contextSet(Thread::CONTEXT::CPU);
     }
 
     void Parser::appendToTransactionRollback(RedoLogRecord* redoLogRecord1, RedoLogRecord* redoLogRecord2) {
@@ -956,6 +1395,8 @@ namespace OpenLogReplicator {
             return;
         }
         lastTransaction = transaction;
+        if (replayed(transaction, redoLogRecord1))
+            return;
         redoLogRecord1->xid = transaction->xid;
 
         // Skip list
@@ -976,13 +1417,7 @@ namespace OpenLogReplicator {
             throw RedoLogException(50045, "bdba does not match (" + std::to_string(redoLogRecord1->bdba) + ", " +
                                           std::to_string(redoLogRecord2->bdba) + "), offset: " + redoLogRecord1->fileOffset.toString());
 
-        const DbTable* table;
-        ctx->parserThread->contextSet(Thread::CONTEXT::TRAN);
-        {
-            std::unique_lock<std::mutex> const lckTransaction(metadata->mtxTransaction);
-            table = metadata->schema->checkTableDict(obj);
-        }
-        ctx->parserThread->contextSet(Thread::CONTEXT::CPU);
+        const DbTable* table = checkTable(obj);
 
         if (table == nullptr) {
             if (!ctx->isFlagSet(Ctx::REDO_FLAGS::SCHEMALESS)) {
@@ -1040,6 +1475,8 @@ namespace OpenLogReplicator {
                                                                       true, ctx->isFlagSet(Ctx::REDO_FLAGS::SHOW_INCOMPLETE_TRANSACTIONS), false);
         if (transaction == nullptr)
             return;
+        if (replayed(transaction, redoLogRecord1))
+            return;
         lastTransaction = transaction;
 
         typeDataObj dataObj;
@@ -1061,6 +1498,13 @@ namespace OpenLogReplicator {
         {
             std::unique_lock<std::mutex> const lckTransaction(metadata->mtxTransaction);
             lob = metadata->schema->checkLobIndexDict(dataObj);
+            if (unlikely(lob == nullptr && metadata->schemaMapsPending.load(std::memory_order_acquire))) {
+                std::unique_lock<std::mutex> const lckSchema(metadata->mtxSchema);
+                if (metadata->schemaMapsPending) {
+                    metadata->rebuildSchemaMaps();
+                    lob = metadata->schema->checkLobIndexDict(dataObj);
+                }
+            }
         }
         ctx->parserThread->contextSet(Thread::CONTEXT::CPU);
 
@@ -1192,13 +1636,14 @@ namespace OpenLogReplicator {
             transaction->size + redoLogRecord1->size + redoLogRecord2->size + TransactionBuffer::ROW_HEADER_TOTAL >= ctx->transactionSizeMax) {
             transactionBuffer->skipXidList.insert(transaction->xid);
             transactionBuffer->dropTransaction(redoLogRecord1->xid, redoLogRecord1->conId);
-            transaction->purge(ctx);
+            transaction->purge(ctx, transactionBuffer);
             if (transaction == lastTransaction)
                 lastTransaction = nullptr;
-            delete transaction;
+            transactionBuffer->releaseTransaction(transaction);
             return;
         }
 
+        transaction->lobData = true;
         transaction->add(metadata, transactionBuffer, redoLogRecord1, redoLogRecord2);
     }
 
@@ -1218,9 +1663,367 @@ namespace OpenLogReplicator {
         }
     }
 
+    // Copies the records of the next block to the LWN being assembled, returns true when the LWN is complete
+    bool Parser::readBlock(LwnCursor& cursor) {
+        uint64_t redoBufferPos = (static_cast<uint64_t>(cursor.currentBlock) * reader->getBlockSize()) % Ctx::MEMORY_CHUNK_SIZE;
+        const uint64_t redoBufferNum =
+                ((static_cast<uint64_t>(cursor.currentBlock) * reader->getBlockSize()) / Ctx::MEMORY_CHUNK_SIZE) % ctx->memoryChunksReadBufferMax;
+        const uint8_t* redoBlock = reader->redoBufferList[redoBufferNum] + redoBufferPos;
+
+        uint16_t blockOffset = 16U;
+        // New LWN block
+        if (cursor.currentBlock == cursor.lwnEndBlock) {
+            const uint8_t vld = redoBlock[blockOffset + 4U];
+
+            if (likely((vld & 0x04) != 0)) {
+                const uint16_t lwnNum = ctx->read16(redoBlock + blockOffset + 24U);
+                const uint32_t lwnSize = ctx->read32(redoBlock + blockOffset + 28U);
+                cursor.lwnEndBlock = cursor.currentBlock + lwnSize;
+                lwnScn = ctx->readScn(redoBlock + blockOffset + 40U);
+                LogSink::setScn(lwnScn);
+                lwnTimestamp = ctx->read32(redoBlock + blockOffset + 64U);
+
+                if (cursor.lwnNumCnt == 0) {
+                    if (ctx->isLatencySampled(latencySampleCnt)) {
+                        lwnReadTime = reader->getBufferTime(redoBufferNum);
+                        ctx->recordLatency(RuntimeStats::LATENCY::REDO_READ,
+                                           static_cast<time_ut>(lwnTimestamp.toEpoch(ctx->hostTimezone)) * 1000000, lwnReadTime);
+                    }
+                    lwnCheckpointBlock = cursor.currentBlock;
+                    cursor.lwnNumMax = ctx->read16(redoBlock + blockOffset + 26U);
+                    // Verify LWN header start
+                    if (unlikely(lwnScn < reader->getFirstScn() || (lwnScn > reader->getNextScn() && reader->getNextScn() != Scn::none())))
+                        throw RedoLogException(50049, "invalid lwn scn: " + lwnScn.toString());
+                } else {
+                    const typeLwn lwnNumCur = ctx->read16(redoBlock + blockOffset + 26U);
+                    if (unlikely(lwnNumCur != cursor.lwnNumMax))
+                        throw RedoLogException(50050, "invalid lwn max: " + std::to_string(lwnNum) + "/" +
+                                                      std::to_string(lwnNumCur) + "/" + std::to_string(cursor.lwnNumMax));
+                }
+                ++cursor.lwnNumCnt;
+
+                if (unlikely(ctx->isTraceSet(Ctx::TRACE::LWN))) {
+                    const typeBlk lwnStartBlock = cursor.currentBlock;
+                    ctx->logTrace(Ctx::TRACE::LWN, "at: " + std::to_string(lwnStartBlock) + " size: " + std::to_string(lwnSize) +
+                                                   " chk: " + std::to_string(lwnNum) + " max: " + std::to_string(cursor.lwnNumMax));
+                }
+            } else
+                throw RedoLogException(50051, "did not find lwn at offset: " + cursor.confirmedBufferStart.toString());
+        }
+
+        while (blockOffset < reader->getBlockSize()) {
+            // Next record
+            if (cursor.recordLeftToCopy == 0) {
+                if (blockOffset + 20U >= reader->getBlockSize())
+                    break;
+
+                const uint32_t recordSize4 = (static_cast<uint64_t>(ctx->read32(redoBlock + blockOffset)) + 3U) & 0xFFFFFFFC;
+                if (recordSize4 > 0) {
+                    auto* recordSize = reinterpret_cast<uint64_t*>(lwnChunks[lwnAllocated - 1]);
+
+                    if (((*recordSize + sizeof(struct LwnMember) + recordSize4 + 7) & 0xFFFFFFF8) > Ctx::MEMORY_CHUNK_SIZE_MB * 1024 * 1024) {
+                        if (unlikely(lwnAllocated == MAX_LWN_CHUNKS))
+                            throw RedoLogException(50052, "all " + std::to_string(MAX_LWN_CHUNKS) + " lwn buffers allocated");
+
+                        lwnChunks[lwnAllocated++] = ctx->getMemoryChunk(lwnThread, Ctx::MEMORY::PARSER);
+                        lwnThread->contextSet(Thread::CONTEXT::CPU);
+                        lwnAllocatedMax = std::max(lwnAllocated, lwnAllocatedMax);
+                        recordSize = reinterpret_cast<uint64_t*>(lwnChunks[lwnAllocated - 1]);
+                        *recordSize = sizeof(uint64_t);
+                    }
+
+                    if (unlikely(((*recordSize + sizeof(struct LwnMember) + recordSize4 + 7) & 0xFFFFFFF8) > Ctx::MEMORY_CHUNK_SIZE_MB * 1024 * 1024))
+                        throw RedoLogException(50053, "too big redo log record, size: " + std::to_string(recordSize4));
+
+                    cursor.lwnMember = reinterpret_cast<struct LwnMember*>(lwnChunks[lwnAllocated - 1] + *recordSize);
+                    *recordSize += (sizeof(struct LwnMember) + recordSize4 + 7) & 0xFFFFFFF8;
+                    cursor.lwnMember->pageOffset = blockOffset;
+                    cursor.lwnMember->scn = ctx->read32(redoBlock + blockOffset + 8U) |
+                                            (static_cast<uint64_t>(ctx->read16(redoBlock + blockOffset + 6U)) << 32);
+                    cursor.lwnMember->size = recordSize4;
+                    cursor.lwnMember->block = cursor.currentBlock;
+                    cursor.lwnMember->subScn = ctx->read16(redoBlock + blockOffset + 12U);
+
+                    if (unlikely(ctx->isTraceSet(Ctx::TRACE::LWN)))
+                        ctx->logTrace(Ctx::TRACE::LWN, "size: " + std::to_string(recordSize4) + " scn: " +
+                                                       cursor.lwnMember->scn.toString() + " subscn: " + std::to_string(cursor.lwnMember->subScn));
+
+                    if (unlikely(lwnMembers.size() + 1 >= MAX_RECORDS_IN_LWN))
+                        throw RedoLogException(50054, "all " + std::to_string(lwnMembers.size() + 1) + " records in lwn were used");
+                    lwnMembers.push_back(cursor.lwnMember);
+                }
+
+                cursor.recordLeftToCopy = recordSize4;
+                cursor.recordPos = 0;
+            }
+
+            // Nothing more
+            if (cursor.recordLeftToCopy == 0)
+                break;
+
+            uint32_t toCopy;
+            if (blockOffset + cursor.recordLeftToCopy > reader->getBlockSize())
+                toCopy = reader->getBlockSize() - blockOffset;
+            else
+                toCopy = cursor.recordLeftToCopy;
+
+            memcpy(reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(cursor.lwnMember) + sizeof(struct LwnMember) + cursor.recordPos),
+                   reinterpret_cast<const void*>(redoBlock + blockOffset), toCopy);
+            cursor.recordLeftToCopy -= toCopy;
+            blockOffset += toCopy;
+            cursor.recordPos += toCopy;
+        }
+
+        ++cursor.currentBlock;
+        cursor.confirmedBufferStart += reader->getBlockSize();
+        redoBufferPos += reader->getBlockSize();
+
+        // Checkpoint
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::LWN)))
+            ctx->logTrace(Ctx::TRACE::LWN, "checkpoint at " + std::to_string(cursor.currentBlock) + "/" + std::to_string(cursor.lwnEndBlock) +
+                                           " num: " + std::to_string(cursor.lwnNumCnt) + "/" + std::to_string(cursor.lwnNumMax));
+        bool complete = false;
+        if (cursor.currentBlock == cursor.lwnEndBlock && cursor.lwnNumCnt == cursor.lwnNumMax) {
+            cursor.lwnNumCnt = 0;
+            complete = true;
+        } else if (unlikely(cursor.lwnNumCnt > cursor.lwnNumMax))
+            throw RedoLogException(50055, "lwn overflow: " + std::to_string(cursor.lwnNumCnt) + "/" + std::to_string(cursor.lwnNumMax));
+
+        // Free memory, the records of the LWN are already copied
+        if (redoBufferPos == Ctx::MEMORY_CHUNK_SIZE) {
+            reader->bufferFree(lwnThread, redoBufferNum);
+            reader->confirmReadData(cursor.confirmedBufferStart);
+        }
+        return complete;
+    }
+
+    // Applies the complete LWN to the transactions, decoded is set when the records were decoded ahead and are only applied
+    void Parser::processLwn(typeBlk currentBlock, typeBlk& lwnConfirmedBlock, bool switchRedo, bool decoded) {
+        lastTransaction = nullptr;
+        if (unlikely(standbyPending))
+            standbyWait();
+        if (unlikely(vectorDecoder == nullptr))
+            decodeVectorSelect();
+
+        RuntimeStats::set<uint64_t>(ctx->stats.lwnScn, lwnScn.getData());
+        RuntimeStats::set<time_t>(ctx->stats.lwnEpoch, lwnTimestamp.toEpoch(ctx->hostTimezone));
+        if (ctx->metrics != nullptr) {
+            const int64_t diff = ctx->clock->getTimeT() - lwnTimestamp.toEpoch(ctx->hostTimezone);
+            ctx->metrics->emitCheckpointLag(diff);
+        }
+
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::LWN)))
+            ctx->logTrace(Ctx::TRACE::LWN, "* analyze: " + lwnScn.toString());
+        // scn, sequence, first block, last block
+        OLR_PROBE4(parser_lwn_begin, lwnScn.getData(), sequence.getData(), lwnConfirmedBlock, currentBlock);
+        FlightRecorder::record(FlightRecorder::EVENT::LWN_BEGIN, lwnScn.getData(), sequence.getData());
+
+        bool lwnParallel = decoded;
+        if (!decoded) {
+            decodePlanRefresh();
+            lwnPlanVersion = decodePlan.version;
+            sortLwn();
+
+            // Big LWNs are decoded in parallel and applied in order afterwards
+            lwnParallel = (lwnDecoderPool != nullptr && lwnMembers.size() >= LwnDecoderPool::MIN_PARALLEL_MEMBERS && ctx->dumpRedoLog == 0);
+            if (lwnParallel) {
+                lwnDecoded.resize(lwnMembers.size());
+                lwnDecodedRecords.resize(lwnDecoderPool->getWorkers() + 1);
+                for (std::vector<RedoLogRecord>& records: lwnDecodedRecords)
+                    records.clear();
+                lwnDecoderPool->decode(ctx->parserThread, this, lwnMembers.size());
+            }
+        }
+
+        // Decoding went in parallel with the other instances, the transactions are changed in global scn order
+        if (racCoordinator != nullptr)
+            racCoordinator->lwnBegin(ctx->parserThread, racInstance, lwnScn);
+
+        const bool prefetch = ctx->lwnPrefetch > 0;
+        for (uint64_t num = 0; num < lwnMembers.size(); ++num) {
+            if (prefetch)
+                prefetchLwn(num, lwnParallel);
+            try {
+                if (lwnParallel)
+                    applyLwn(num);
+                else
+                    analyzeLwn(lwnMembers[num]);
+            } catch (DataException& ex) {
+                if (ctx->isFlagSet(Ctx::REDO_FLAGS::IGNORE_DATA_ERRORS)) {
+                    ctx->error(ex.code, ex.msg);
+                    ctx->warning(60013, "forced to continue working in spite of error");
+                } else
+                    throw DataException(ex.code, "runtime error, aborting further redo log processing: " + ex.msg);
+            } catch (RedoLogException& ex) {
+                if (ctx->isFlagSet(Ctx::REDO_FLAGS::IGNORE_DATA_ERRORS)) {
+                    ctx->error(ex.code, ex.msg);
+                    ctx->warning(60013, "forced to continue working in spite of error");
+                } else
+                    throw RedoLogException(ex.code, "runtime error, aborting further redo log processing: " + ex.msg);
+            }
+        }
+        RuntimeStats::add(ctx->stats.recordsParsed, lwnMembers.size());
+        lwnMembers.clear();
+        if (transactionFlusher != nullptr)
+            transactionFlusher->reap(ctx->parserThread);
+        // DDL commits of one LWN share a single map rebuild
+        metadata->flushSchemaMaps(ctx->parserThread);
+
+        if (lwnScn > metadata->firstDataScn) {
+            if (unlikely(ctx->isTraceSet(Ctx::TRACE::CHECKPOINT)))
+                ctx->logTrace(Ctx::TRACE::CHECKPOINT, "on: " + lwnScn.toString());
+
+            // Transactions queued for flushing are already dropped from the buffer, they are flushed before the checkpoint
+            Seq minSequence = Seq::none();
+            FileOffset minFileOffset;
+            Xid minXid;
+            const FileOffset checkpointFileOffset(currentBlock, reader->getBlockSize());
+            if (!transactionBuffer->persistPath.empty())
+                transactionBuffer->persist(metadata, lwnScn, sequence, checkpointFileOffset);
+            transactionBuffer->checkpoint(minSequence, minFileOffset, minXid);
+            if (unlikely(ctx->isTraceSet(Ctx::TRACE::LWN)))
+                ctx->logTrace(Ctx::TRACE::LWN, "* checkpoint: " + lwnScn.toString());
+
+            const uint64_t checkpointBytes = static_cast<uint64_t>(currentBlock - lwnConfirmedBlock) * reader->getBlockSize();
+            if (transactionFlusher != nullptr && ctx->stopCheckpoints > 0)
+                transactionFlusher->drain(ctx->parserThread);
+            if (transactionFlusher == nullptr || ctx->stopCheckpoints > 0 ||
+                !transactionFlusher->checkpoint(ctx->parserThread, lwnScn, lwnTimestamp, sequence, checkpointFileOffset, switchRedo,
+                                                checkpointBytes, minSequence, minFileOffset, minXid)) {
+                builder->processCheckpoint(lwnScn, sequence, lwnTimestamp.toEpoch(ctx->hostTimezone), checkpointFileOffset, switchRedo);
+                metadata->checkpoint(ctx->parserThread, lwnScn, lwnTimestamp, sequence, checkpointFileOffset, checkpointBytes, minSequence,
+                                     minFileOffset, minXid);
+            }
+
+            if (ctx->stopCheckpoints > 0 && metadata->isNewData(lwnScn, builder->lwnIdx)) {
+                --ctx->stopCheckpoints;
+                if (ctx->stopCheckpoints == 0) {
+                    ctx->info(0, "shutdown started - exhausted number of checkpoints");
+                    ctx->stopSoft();
+                }
+            }
+            if (ctx->metrics != nullptr)
+                ctx->metrics->emitCheckpointsOut(1);
+        } else {
+            if (ctx->metrics != nullptr)
+                ctx->metrics->emitCheckpointsSkip(1);
+        }
+
+        if (racCoordinator != nullptr)
+            racCoordinator->lwnEnd(ctx->parserThread, racInstance);
+
+        freeLwn();
+
+        if (unlikely(lwnReadTime != 0)) {
+            ctx->recordLatency(RuntimeStats::LATENCY::READ_PARSE, lwnReadTime, ctx->clock->getTimeUt());
+            lwnReadTime = 0;
+        }
+
+        RuntimeStats::add(ctx->stats.bytesParsed, (currentBlock - lwnConfirmedBlock) * reader->getBlockSize());
+        if (ctx->metrics != nullptr)
+            ctx->metrics->emitBytesParsed((currentBlock - lwnConfirmedBlock) * reader->getBlockSize());
+        // scn, sequence, parsed bytes
+        OLR_PROBE3(parser_lwn_end, lwnScn.getData(), sequence.getData(), (currentBlock - lwnConfirmedBlock) * reader->getBlockSize());
+        FlightRecorder::record(FlightRecorder::EVENT::LWN_END, lwnScn.getData(), (currentBlock - lwnConfirmedBlock) * reader->getBlockSize());
+        lwnConfirmedBlock = currentBlock;
+
+        if (unlikely(ctx->redoProfile != nullptr))
+            transactionBuffer->sampleProfile(ctx->redoProfile);
+
+        const time_ut now = ctx->contextClock.nowUt();
+        if (now - transactionSnapshotTime >= TransactionSnapshot::INTERVAL_US) {
+            transactionSnapshotTime = now;
+            transactionBuffer->publishSnapshot(now);
+            if (ctx->tableCost != nullptr) {
+                ctx->tableCost->merge(ctx->parserThread, tableCostLocal, now);
+                ctx->tableCost->publish(ctx->parserThread, now);
+            }
+        }
+
+        // With too much output not taken by the writers yet the next LWN waits, no transaction is half built at this point
+        builder->waitForCredit(ctx->parserThread);
+    }
+
+    void Parser::adoptLwn(DecodedLwn* lwn) {
+        while (lwnAllocated > 0)
+            ctx->freeMemoryChunk(ctx->parserThread, Ctx::MEMORY::PARSER, lwnChunks[--lwnAllocated]);
+        for (uint8_t* chunk: lwn->chunks)
+            lwnChunks[lwnAllocated++] = chunk;
+        lwnAllocatedMax = std::max(lwnAllocated, lwnAllocatedMax);
+        lwn->chunks.clear();
+
+        lwnMembers.swap(lwn->members);
+        lwnDecoded.swap(lwn->decoded);
+        lwnDecodedRecords.resize(1);
+        lwnDecodedRecords[0].swap(lwn->records);
+        lwnScn = lwn->scn;
+        LogSink::setScn(lwnScn);
+        lwnTimestamp = lwn->timestamp;
+        lwnCheckpointBlock = lwn->checkpointBlock;
+        lwnReadTime = lwn->readTime;
+        lwnPlanVersion = lwn->planVersion;
+    }
+
+    // Runs on the thread of the catch-up decoder with a parser of its own, the LWNs of the whole log are assembled and decoded
+    // in the same way as by the parser, which then only applies them. Returns the block at which the reader stopped
+    typeBlk Parser::decodeAhead(Thread* t, CatchUpDecoder* decoder) {
+        lwnThread = t;
+        LwnCursor cursor;
+        cursor.confirmedBufferStart = reader->getBufferStart();
+        cursor.currentBlock = cursor.confirmedBufferStart.getBlock(reader->getBlockSize());
+        cursor.lwnEndBlock = cursor.currentBlock;
+
+        while (!ctx->softShutdown && !decoder->isStopped()) {
+            while (cursor.confirmedBufferStart < reader->getBufferEnd()) {
+                if (!readBlock(cursor))
+                    continue;
+
+                if (unlikely(vectorDecoder == nullptr))
+                    decodeVectorSelect();
+                decodePlanRefresh();
+                sortLwn();
+                lwnDecoded.resize(lwnMembers.size());
+                lwnDecodedRecords.resize(1);
+                lwnDecodedRecords[0].clear();
+                const bool prefetch = ctx->lwnPrefetch > 0;
+                for (uint64_t num = 0; num < lwnMembers.size(); ++num) {
+                    if (prefetch)
+                        prefetchLwn(num, false);
+                    decodeLwn(num, 0);
+                }
+
+                auto* lwn = new DecodedLwn();
+                lwn->chunks.assign(lwnChunks, lwnChunks + lwnAllocated);
+                lwn->members.swap(lwnMembers);
+                lwn->decoded.swap(lwnDecoded);
+                lwn->records.swap(lwnDecodedRecords[0]);
+                lwn->scn = lwnScn;
+                lwn->timestamp = lwnTimestamp;
+                lwn->checkpointBlock = lwnCheckpointBlock;
+                lwn->endBlock = cursor.currentBlock;
+                lwn->readTime = lwnReadTime;
+                lwn->planVersion = decodePlan.version;
+                lwnReadTime = 0;
+
+                // The chunks went with the LWN
+                lwnAllocated = 0;
+                lwnChunks[0] = ctx->getMemoryChunk(t, Ctx::MEMORY::PARSER);
+                t->contextSet(Thread::CONTEXT::CPU);
+                *reinterpret_cast<uint64_t*>(lwnChunks[0]) = sizeof(uint64_t);
+                lwnAllocated = 1;
+
+                if (!decoder->push(t, lwn))
+                    return cursor.currentBlock;
+            }
+
+            if (reader->checkFinished(t, cursor.confirmedBufferStart))
+                break;
+        }
+        return cursor.currentBlock;
+    }
+
     Reader::REDO_CODE Parser::parse() {
         typeBlk lwnConfirmedBlock = 2;
-        uint64_t lwnRecords = 0;
 
         if (firstScn == Scn::none() && nextScn == Scn::none() && reader->getFirstScn() != Scn::zero()) {
             firstScn = reader->getFirstScn();
@@ -1255,8 +2058,10 @@ namespace OpenLogReplicator {
                                                       std::to_string(lwnConfirmedBlock) + ")");
             metadata->fileOffset = FileOffset::zero();
         }
-        reader->setBufferStartEnd(FileOffset(lwnConfirmedBlock, reader->getBlockSize()),
-                                  FileOffset(lwnConfirmedBlock, reader->getBlockSize()));
+        // A reader which was started ahead already holds data from this position, keep it
+        if (catchUpDecoder == nullptr && reader->getBufferStart() != FileOffset(lwnConfirmedBlock, reader->getBlockSize()))
+            reader->setBufferStartEnd(FileOffset(lwnConfirmedBlock, reader->getBlockSize()),
+                                      FileOffset(lwnConfirmedBlock, reader->getBlockSize()));
 
         ctx->info(0, "processing redo log: " + toString() + " offset: " + reader->getBufferStart().toString());
         if (ctx->isFlagSet(Ctx::REDO_FLAGS::ADAPTIVE_SCHEMA) && !metadata->schema->loaded && !ctx->versionStr.empty()) {
@@ -1277,251 +2082,48 @@ namespace OpenLogReplicator {
         }
 
         const time_ut cStart = ctx->clock->getTimeUt();
-        reader->setStatusRead();
-        LwnMember* lwnMember;
-        uint16_t blockOffset;
-        FileOffset confirmedBufferStart = reader->getBufferStart();
-        uint64_t recordPos = 0;
-        uint32_t recordSize4;
-        uint32_t recordLeftToCopy = 0;
+        if (catchUpDecoder == nullptr)
+            reader->setStatusRead();
+        LwnCursor cursor;
+        cursor.confirmedBufferStart = reader->getBufferStart();
+        cursor.currentBlock = lwnConfirmedBlock;
+        cursor.lwnEndBlock = lwnConfirmedBlock;
         const typeBlk startBlock = lwnConfirmedBlock;
-        typeBlk currentBlock = lwnConfirmedBlock;
-        typeBlk lwnEndBlock = lwnConfirmedBlock;
-        typeLwn lwnNumMax = 0;
-        typeLwn lwnNumCnt = 0;
+        typeBlk& currentBlock = cursor.currentBlock;
         lwnCheckpointBlock = lwnConfirmedBlock;
         bool switchRedo = false;
 
         while (!ctx->softShutdown) {
-            // There is some work to do
-            while (confirmedBufferStart < reader->getBufferEnd()) {
-                uint64_t redoBufferPos = (static_cast<uint64_t>(currentBlock) * reader->getBlockSize()) % Ctx::MEMORY_CHUNK_SIZE;
-                const uint64_t redoBufferNum =
-                        ((static_cast<uint64_t>(currentBlock) * reader->getBlockSize()) / Ctx::MEMORY_CHUNK_SIZE) % ctx->memoryChunksReadBufferMax;
-                const uint8_t* redoBlock = reader->redoBufferList[redoBufferNum] + redoBufferPos;
-
-                blockOffset = 16U;
-                // New LWN block
-                if (currentBlock == lwnEndBlock) {
-                    const uint8_t vld = redoBlock[blockOffset + 4U];
-
-                    if (likely((vld & 0x04) != 0)) {
-                        const uint16_t lwnNum = ctx->read16(redoBlock + blockOffset + 24U);
-                        const uint32_t lwnSize = ctx->read32(redoBlock + blockOffset + 28U);
-                        lwnEndBlock = currentBlock + lwnSize;
-                        lwnScn = ctx->readScn(redoBlock + blockOffset + 40U);
-                        lwnTimestamp = ctx->read32(redoBlock + blockOffset + 64U);
-
-                        if (ctx->metrics != nullptr) {
-                            const int64_t diff = ctx->clock->getTimeT() - lwnTimestamp.toEpoch(ctx->hostTimezone);
-                            ctx->metrics->emitCheckpointLag(diff);
-                        }
-
-                        if (lwnNumCnt == 0) {
-                            lwnCheckpointBlock = currentBlock;
-                            lwnNumMax = ctx->read16(redoBlock + blockOffset + 26U);
-                            // Verify LWN header start
-                            if (unlikely(lwnScn < reader->getFirstScn() || (lwnScn > reader->getNextScn() && reader->getNextScn() != Scn::none())))
-                                throw RedoLogException(50049, "invalid lwn scn: " + lwnScn.toString());
-                        } else {
-                            const typeLwn lwnNumCur = ctx->read16(redoBlock + blockOffset + 26U);
-                            if (unlikely(lwnNumCur != lwnNumMax))
-                                throw RedoLogException(50050, "invalid lwn max: " + std::to_string(lwnNum) + "/" +
-                                                              std::to_string(lwnNumCur) + "/" + std::to_string(lwnNumMax));
-                        }
-                        ++lwnNumCnt;
-
-                        if (unlikely(ctx->isTraceSet(Ctx::TRACE::LWN))) {
-                            const typeBlk lwnStartBlock = currentBlock;
-                            ctx->logTrace(Ctx::TRACE::LWN, "at: " + std::to_string(lwnStartBlock) + " size: " + std::to_string(lwnSize) +
-                                                           " chk: " + std::to_string(lwnNum) + " max: " + std::to_string(lwnNumMax));
-                        }
-                    } else
-                        throw RedoLogException(50051, "did not find lwn at offset: " + confirmedBufferStart.toString());
-                }
-
-                while (blockOffset < reader->getBlockSize()) {
-                    // Next record
-                    if (recordLeftToCopy == 0) {
-                        if (blockOffset + 20U >= reader->getBlockSize())
-                            break;
-
-                        recordSize4 = (static_cast<uint64_t>(ctx->read32(redoBlock + blockOffset)) + 3U) & 0xFFFFFFFC;
-                        if (recordSize4 > 0) {
-                            auto* recordSize = reinterpret_cast<uint64_t*>(lwnChunks[lwnAllocated - 1]);
-
-                            if (((*recordSize + sizeof(struct LwnMember) + recordSize4 + 7) & 0xFFFFFFF8) > Ctx::MEMORY_CHUNK_SIZE_MB * 1024 * 1024) {
-                                if (unlikely(lwnAllocated == MAX_LWN_CHUNKS))
-                                    throw RedoLogException(50052, "all " + std::to_string(MAX_LWN_CHUNKS) + " lwn buffers allocated");
-
-                                lwnChunks[lwnAllocated++] = ctx->getMemoryChunk(ctx->parserThread, Ctx::MEMORY::PARSER);
-                                ctx->parserThread->contextSet(Thread::CONTEXT::CPU);
-                                lwnAllocatedMax = std::max(lwnAllocated, lwnAllocatedMax);
-                                recordSize = reinterpret_cast<uint64_t*>(lwnChunks[lwnAllocated - 1]);
-                                *recordSize = sizeof(uint64_t);
-                            }
-
-                            if (unlikely(((*recordSize + sizeof(struct LwnMember) + recordSize4 + 7) & 0xFFFFFFF8) > Ctx::MEMORY_CHUNK_SIZE_MB * 1024 * 1024))
-                                throw RedoLogException(50053, "too big redo log record, size: " + std::to_string(recordSize4));
-
-                            lwnMember = reinterpret_cast<struct LwnMember*>(lwnChunks[lwnAllocated - 1] + *recordSize);
-                            *recordSize += (sizeof(struct LwnMember) + recordSize4 + 7) & 0xFFFFFFF8;
-                            lwnMember->pageOffset = blockOffset;
-                            lwnMember->scn = ctx->read32(redoBlock + blockOffset + 8U) |
-                                             (static_cast<uint64_t>(ctx->read16(redoBlock + blockOffset + 6U)) << 32);
-                            lwnMember->size = recordSize4;
-                            lwnMember->block = currentBlock;
-                            lwnMember->subScn = ctx->read16(redoBlock + blockOffset + 12U);
-
-                            if (unlikely(ctx->isTraceSet(Ctx::TRACE::LWN)))
-                                ctx->logTrace(Ctx::TRACE::LWN, "size: " + std::to_string(recordSize4) + " scn: " +
-                                                               lwnMember->scn.toString() + " subscn: " + std::to_string(lwnMember->subScn));
-
-                            uint64_t lwnPos = ++lwnRecords;
-                            if (unlikely(lwnPos >= MAX_RECORDS_IN_LWN))
-                                throw RedoLogException(50054, "all " + std::to_string(lwnPos) + " records in lwn were used");
-
-                            while (lwnPos > 1 && *lwnMember < *lwnMembers[lwnPos / 2]) {
-                                lwnMembers[lwnPos] = lwnMembers[lwnPos / 2];
-                                lwnPos /= 2;
-                            }
-                            lwnMembers[lwnPos] = lwnMember;
-                        }
-
-                        recordLeftToCopy = recordSize4;
-                        recordPos = 0;
-                    }
-
-                    // Nothing more
-                    if (recordLeftToCopy == 0)
-                        break;
-
-                    uint32_t toCopy;
-                    if (blockOffset + recordLeftToCopy > reader->getBlockSize())
-                        toCopy = reader->getBlockSize() - blockOffset;
-                    else
-                        toCopy = recordLeftToCopy;
-
-                    memcpy(reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(lwnMember) + sizeof(struct LwnMember) + recordPos),
-                           reinterpret_cast<const void*>(redoBlock + blockOffset), toCopy);
-                    recordLeftToCopy -= toCopy;
-                    blockOffset += toCopy;
-                    recordPos += toCopy;
-                }
-
-                ++currentBlock;
-                confirmedBufferStart += reader->getBlockSize();
-                redoBufferPos += reader->getBlockSize();
-
-                // Checkpoint
-                if (unlikely(ctx->isTraceSet(Ctx::TRACE::LWN)))
-                    ctx->logTrace(Ctx::TRACE::LWN, "checkpoint at " + std::to_string(currentBlock) + "/" + std::to_string(lwnEndBlock) +
-                                                   " num: " + std::to_string(lwnNumCnt) + "/" + std::to_string(lwnNumMax));
-                if (currentBlock == lwnEndBlock && lwnNumCnt == lwnNumMax) {
-                    lastTransaction = nullptr;
-
-                    if (unlikely(ctx->isTraceSet(Ctx::TRACE::LWN)))
-                        ctx->logTrace(Ctx::TRACE::LWN, "* analyze: " + lwnScn.toString());
-
-                    while (lwnRecords > 0) {
-                        try {
-                            analyzeLwn(lwnMembers[1]);
-                        } catch (DataException& ex) {
-                            if (ctx->isFlagSet(Ctx::REDO_FLAGS::IGNORE_DATA_ERRORS)) {
-                                ctx->error(ex.code, ex.msg);
-                                ctx->warning(60013, "forced to continue working in spite of error");
-                            } else
-                                throw DataException(ex.code, "runtime error, aborting further redo log processing: " + ex.msg);
-                        } catch (RedoLogException& ex) {
-                            if (ctx->isFlagSet(Ctx::REDO_FLAGS::IGNORE_DATA_ERRORS)) {
-                                ctx->error(ex.code, ex.msg);
-                                ctx->warning(60013, "forced to continue working in spite of error");
-                            } else
-                                throw RedoLogException(ex.code, "runtime error, aborting further redo log processing: " + ex.msg);
-                        }
-
-                        if (lwnRecords == 1) {
-                            lwnRecords = 0;
-                            break;
-                        }
-
-                        uint64_t lwnPos = 1;
-                        while (true) {
-                            if (lwnPos * 2U < lwnRecords && *lwnMembers[lwnPos * 2U] < *lwnMembers[lwnRecords]) {
-                                if ((lwnPos * 2U) + 1U < lwnRecords && *lwnMembers[(lwnPos * 2U) + 1U] < *lwnMembers[lwnPos * 2U]) {
-                                    lwnMembers[lwnPos] = lwnMembers[(lwnPos * 2U) + 1U];
-                                    lwnPos *= 2U;
-                                    ++lwnPos;
-                                } else {
-                                    lwnMembers[lwnPos] = lwnMembers[lwnPos * 2U];
-                                    lwnPos *= 2U;
-                                }
-                            } else if ((lwnPos * 2U) + 1U < lwnRecords && *lwnMembers[(lwnPos * 2U) + 1U] < *lwnMembers[lwnRecords]) {
-                                lwnMembers[lwnPos] = lwnMembers[(lwnPos * 2U) + 1U];
-                                lwnPos *= 2U;
-                                ++lwnPos;
-                            } else
-                                break;
-                        }
-
-                        lwnMembers[lwnPos] = lwnMembers[lwnRecords];
-                        --lwnRecords;
-                    }
-
-                    if (lwnScn > metadata->firstDataScn) {
-                        if (unlikely(ctx->isTraceSet(Ctx::TRACE::CHECKPOINT)))
-                            ctx->logTrace(Ctx::TRACE::CHECKPOINT, "on: " + lwnScn.toString());
-                        builder->processCheckpoint(lwnScn, sequence, lwnTimestamp.toEpoch(ctx->hostTimezone),
-                                                   FileOffset(currentBlock, reader->getBlockSize()), switchRedo);
-
-                        Seq minSequence = Seq::none();
-                        FileOffset minFileOffset;
-                        Xid minXid;
-                        transactionBuffer->checkpoint(minSequence, minFileOffset, minXid);
-                        if (unlikely(ctx->isTraceSet(Ctx::TRACE::LWN)))
-                            ctx->logTrace(Ctx::TRACE::LWN, "* checkpoint: " + lwnScn.toString());
-                        metadata->checkpoint(ctx->parserThread, lwnScn, lwnTimestamp, sequence, FileOffset(currentBlock, reader->getBlockSize()),
-                                             static_cast<uint64_t>(currentBlock - lwnConfirmedBlock) * reader->getBlockSize(), minSequence,
-                                             minFileOffset, minXid);
-
-                        if (ctx->stopCheckpoints > 0 && metadata->isNewData(lwnScn, builder->lwnIdx)) {
-                            --ctx->stopCheckpoints;
-                            if (ctx->stopCheckpoints == 0) {
-                                ctx->info(0, "shutdown started - exhausted number of checkpoints");
-                                ctx->stopSoft();
-                            }
-                        }
-                        if (ctx->metrics != nullptr)
-                            ctx->metrics->emitCheckpointsOut(1);
-                    } else {
-                        if (ctx->metrics != nullptr)
-                            ctx->metrics->emitCheckpointsSkip(1);
-                    }
-
-                    lwnNumCnt = 0;
-                    freeLwn();
-
-                    if (ctx->metrics != nullptr)
-                        ctx->metrics->emitBytesParsed((currentBlock - lwnConfirmedBlock) * reader->getBlockSize());
-                    lwnConfirmedBlock = currentBlock;
-                } else if (unlikely(lwnNumCnt > lwnNumMax))
-                    throw RedoLogException(50055, "lwn overflow: " + std::to_string(lwnNumCnt) + "/" + std::to_string(lwnNumMax));
-
-                // Free memory
-                if (redoBufferPos == Ctx::MEMORY_CHUNK_SIZE) {
-                    reader->bufferFree(ctx->parserThread, redoBufferNum);
-                    reader->confirmReadData(confirmedBufferStart);
+            if (catchUpDecoder != nullptr) {
+                // The blocks were read and decoded by the catch-up decoder, only the LWNs are applied here
+                while (!ctx->softShutdown && catchUpDecoder->take(ctx->parserThread, this, currentBlock))
+                    processLwn(currentBlock, lwnConfirmedBlock, switchRedo, true);
+                cursor.confirmedBufferStart = FileOffset(currentBlock, reader->getBlockSize());
+            } else {
+                // There is some work to do
+                while (cursor.confirmedBufferStart < reader->getBufferEnd()) {
+                    if (readBlock(cursor))
+                        processLwn(currentBlock, lwnConfirmedBlock, switchRedo, false);
                 }
             }
 
             // Processing finished
-            if (!switchRedo && lwnScn > Scn::zero() && confirmedBufferStart == reader->getBufferEnd() && reader->getRet() == Reader::REDO_CODE::FINISHED) {
+            if (!switchRedo && lwnScn > Scn::zero() && cursor.confirmedBufferStart == reader->getBufferEnd() &&
+                reader->getRet() == Reader::REDO_CODE::FINISHED) {
+                if (racCoordinator != nullptr)
+                    racCoordinator->advance(ctx->parserThread, racInstance, reader->getNextScn(), reader->isClosedThread());
+
                 if (lwnScn > metadata->firstDataScn) {
                     switchRedo = true;
                     if (unlikely(ctx->isTraceSet(Ctx::TRACE::CHECKPOINT)))
                         ctx->logTrace(Ctx::TRACE::CHECKPOINT, "on: " + lwnScn.toString() + " with switch");
+                    if (transactionFlusher != nullptr)
+                        transactionFlusher->drain(ctx->parserThread);
+                    // The merge of the RAC output doesn't wait for this thread until it is opened again
+                    builder->threadClosed = racCoordinator != nullptr && reader->isClosedThread();
                     builder->processCheckpoint(lwnScn, sequence, lwnTimestamp.toEpoch(ctx->hostTimezone),
                                                FileOffset(currentBlock, reader->getBlockSize()), switchRedo);
+                    builder->threadClosed = false;
                     if (ctx->metrics != nullptr)
                         ctx->metrics->emitCheckpointsOut(1);
                 } else {
@@ -1533,6 +2135,8 @@ namespace OpenLogReplicator {
             if (ctx->softShutdown) {
                 if (unlikely(ctx->isTraceSet(Ctx::TRACE::CHECKPOINT)))
                     ctx->logTrace(Ctx::TRACE::CHECKPOINT, "on: " + lwnScn.toString() + " at exit");
+                if (transactionFlusher != nullptr)
+                    transactionFlusher->drain(ctx->parserThread);
                 builder->processCheckpoint(lwnScn, sequence, lwnTimestamp.toEpoch(ctx->hostTimezone),
                                            FileOffset(currentBlock, reader->getBlockSize()), false);
                 if (ctx->metrics != nullptr)
@@ -1540,7 +2144,7 @@ namespace OpenLogReplicator {
 
                 reader->setRet(Reader::REDO_CODE::SHUTDOWN);
             } else {
-                if (reader->checkFinished(ctx->parserThread, confirmedBufferStart)) {
+                if (reader->checkFinished(ctx->parserThread, cursor.confirmedBufferStart)) {
                     if (reader->getRet() == Reader::REDO_CODE::FINISHED && nextScn == Scn::none() && reader->getNextScn() != Scn::none())
                         nextScn = reader->getNextScn();
                     if (reader->getRet() == Reader::REDO_CODE::STOPPED || reader->getRet() == Reader::REDO_CODE::OVERWRITTEN)
@@ -1602,6 +2206,8 @@ namespace OpenLogReplicator {
             ctx->dumpStream->close();
         }
 
+        if (transactionFlusher != nullptr)
+            transactionFlusher->drain(ctx->parserThread);
         builder->flush();
         freeLwn();
         return reader->getRet();
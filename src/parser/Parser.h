@@ -21,9 +21,14 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #define PARSER_H_
 
 #include <cstddef>
+#include <exception>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "../common/Ctx.h"
 #include "../common/RedoLogRecord.h"
+#include "../common/TableCost.h"
 #include "../reader/Reader.h"
 #include "../common/types/Time.h"
 #include "../common/types/Types.h"
@@ -31,9 +36,14 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 
 namespace OpenLogReplicator {
     class Builder;
+    class CatchUpDecoder;
+    class DbTable;
+    class LwnDecoderPool;
     class Metadata;
     class Transaction;
     class TransactionBuffer;
+    class RacCoordinator;
+    class TransactionFlusher;
     class XmlCtx;
 
     struct LwnMember {
@@ -60,28 +70,158 @@ namespace OpenLogReplicator {
         }
     };
 
+    // Records of one LWN member decoded by a worker, kept in the worker's slots until applied
+    struct LwnDecoded {
+        uint worker;
+        uint64_t first;
+        uint64_t count;
+        std::exception_ptr error;
+    };
+
+    // LWN assembled and decoded ahead of the parser by a catch-up decoder, the records point to the chunks which go with it
+    struct DecodedLwn {
+        std::vector<uint8_t*> chunks;
+        std::vector<LwnMember*> members;
+        std::vector<LwnDecoded> decoded;
+        std::vector<RedoLogRecord> records;
+        Scn scn;
+        Time timestamp{0};
+        typeBlk checkpointBlock{0};
+        typeBlk endBlock{0};
+        time_ut readTime{0};
+        // Schema version of the decode plan the records were decoded with
+        uint64_t planVersion{0};
+    };
+
     class Parser final {
     protected:
+        enum class VECTOR : unsigned char {
+            KEEP, UNDO_INDEX, UNDO_DATA, UNDO_SINGLE, UNDO_UNKNOWN, ROLLBACK_PAIR, UNDO, ROLLBACK, BEGIN, COMMIT, LOB, DDL
+        };
+
         static constexpr uint64_t MAX_LWN_CHUNKS = static_cast<uint64_t>(512 * 2) / Ctx::MEMORY_CHUNK_SIZE_MB;
         static constexpr uint64_t MAX_RECORDS_IN_LWN = 1048576;
+        static constexpr uint64_t TABLE_CACHE_MAX = 1048576;
+        static constexpr uint64_t LWN_PREFETCH_BYTES = 256;
+
+        // Objects whose vectors can reach the output, the vectors of the other ones are decoded only up to the header fields. Built from
+        // the table and LOB index maps of one schema version, inactive when every object is replicated or the redo log is dumped
+        struct DecodePlan {
+            bool active{false};
+            uint64_t version{0};
+            std::unordered_set<typeObj> tables;
+            std::unordered_set<typeDataObj> lobIndexes;
+
+            // Undo of a row of a table not replicated or of an index which is not a LOB index
+            [[nodiscard]] bool skipUndo(const RedoLogRecord* redoLogRecord) const {
+                if (!active || redoLogRecord->dataObj == 0)
+                    return false;
+                if (redoLogRecord->opc == 0x0B01)
+                    return tables.find(redoLogRecord->obj) == tables.end();
+                if (redoLogRecord->opc == 0x0A16)
+                    return lobIndexes.find(redoLogRecord->dataObj) == lobIndexes.end();
+                return false;
+            }
+
+            // Redo following the undo, the object is taken from the undo
+            [[nodiscard]] bool skipRedo(const RedoLogRecord* redoLogRecordPrev, bool index) const {
+                if (!active || redoLogRecordPrev == nullptr || redoLogRecordPrev->opCode != 0x0501 || redoLogRecordPrev->dataObj == 0)
+                    return false;
+                if (index)
+                    return lobIndexes.find(redoLogRecordPrev->dataObj) == lobIndexes.end();
+                return tables.find(redoLogRecordPrev->obj) == tables.end();
+            }
+        };
+
+        // Position of the LWN being assembled from the blocks of the reader
+        struct LwnCursor {
+            LwnMember* lwnMember{nullptr};
+            FileOffset confirmedBufferStart;
+            uint64_t recordPos{0};
+            uint32_t recordLeftToCopy{0};
+            typeBlk currentBlock{0};
+            typeBlk lwnEndBlock{0};
+            typeLwn lwnNumMax{0};
+            typeLwn lwnNumCnt{0};
+        };
 
         Ctx* ctx;
         Builder* builder;
         Metadata* metadata;
         TransactionBuffer* transactionBuffer;
         RedoLogRecord zero;
+        // Thread assembling the LWNs, a catch-up decoder for a log decoded ahead
+        Thread* lwnThread;
         Transaction* lastTransaction{nullptr};
+        // Table filter results of the schema version tableCacheVersion, including misses for objects not replicated
+        std::unordered_map<typeObj, const DbTable*> tableCache;
+        uint64_t tableCacheVersion{0};
+        // Per-table sampling of the tracer by table, dropped with the table cache and when the tracer rules change
+        struct TraceSample {
+            uint64_t sample;
+            uint64_t cnt;
+        };
+        std::unordered_map<const DbTable*, TraceSample> traceSamples;
+        uint64_t traceSamplesTableVersion{0};
+        uint64_t traceSamplesRulesVersion{0};
+        // Until the lease is held, the output waits for the position of the standby to be taken over
+        bool standbyPending{true};
 
         uint8_t* lwnChunks[MAX_LWN_CHUNKS]{};
-        LwnMember* lwnMembers[MAX_RECORDS_IN_LWN + 1]{};
+        // Members in order of appearance in the redo log, sorted once the LWN is complete
+        std::vector<LwnMember*> lwnMembers;
+        std::vector<LwnMember*> lwnMembersTmp;
         uint64_t lwnAllocated{0};
         uint64_t lwnAllocatedMax{0};
         Time lwnTimestamp{0};
         Scn lwnScn;
         typeBlk lwnCheckpointBlock{0};
+        // Read time of the LWN being timed for the latency histograms, 0 when it is not sampled
+        time_ut lwnReadTime{0};
+        // Last publication of the live transactions for the status endpoint
+        time_ut transactionSnapshotTime{0};
+        // Redo bytes buffered for the tables, added to the totals with the transaction snapshot
+        TableCost::Local tableCostLocal;
+        uint64_t latencySampleCnt{0};
+        std::vector<LwnDecoded> lwnDecoded;
+        std::vector<std::vector<RedoLogRecord>> lwnDecodedRecords;
+        // Vector decoder specialized for the byte order and dump mode, chosen with the first LWN
+        using VectorDecoder = uint32_t (Parser::*)(LwnMember* lwnMember, uint32_t offset, uint32_t vectorNo, RedoLogRecord* redoLogRecord,
+                                                   const RedoLogRecord* redoLogRecordPrev) const;
+        VectorDecoder vectorDecoder{nullptr};
+        DecodePlan decodePlan;
+        // Member being applied and the schema version of the decode plan its records were decoded with
+        LwnMember* lwnApplied{nullptr};
+        uint64_t lwnPlanVersion{0};
 
         void freeLwn();
+        bool readBlock(LwnCursor& cursor);
+        void processLwn(typeBlk currentBlock, typeBlk& lwnConfirmedBlock, bool switchRedo, bool decoded);
+        void adoptLwn(DecodedLwn* lwn);
+        static uint8_t lwnSortByte(const LwnMember* lwnMember, uint pass);
+        void sortLwn();
+        uint16_t decodeLwnHeader(const LwnMember* lwnMember) const;
+        template<typename Mode>
+        uint32_t decodeVectorMode(LwnMember* lwnMember, uint32_t offset, uint32_t vectorNo, RedoLogRecord* redoLogRecord,
+                                  const RedoLogRecord* redoLogRecordPrev) const;
+        void decodeVectorSelect();
+        void decodePlanRefresh();
+        void redecodeVector(const RedoLogRecord* redoLogRecordPrev, RedoLogRecord* redoLogRecord);
+
+        uint32_t decodeVector(LwnMember* lwnMember, uint32_t offset, uint32_t vectorNo, RedoLogRecord* redoLogRecord,
+                              const RedoLogRecord* redoLogRecordPrev) const {
+            return (this->*vectorDecoder)(lwnMember, offset, vectorNo, redoLogRecord, redoLogRecordPrev);
+        }
+        static VECTOR vectorAction(const RedoLogRecord* redoLogRecordPrev, const RedoLogRecord* redoLogRecord);
+        bool applyVector(RedoLogRecord* redoLogRecordPrev, RedoLogRecord* redoLogRecord);
         void analyzeLwn(LwnMember* lwnMember);
+        void decodeLwn(uint64_t num, uint worker);
+        void applyLwn(uint64_t num);
+        void prefetchLwn(uint64_t num, bool parallel) const;
+        const DbTable* checkTable(typeObj obj);
+        void traceTable(Transaction* transaction, const DbTable* table);
+        [[nodiscard]] bool replayed(const Transaction* transaction, const RedoLogRecord* redoLogRecord) const;
+        void standbyWait();
         void appendToTransactionDdl(RedoLogRecord* redoLogRecord1);
         void appendToTransactionBegin(RedoLogRecord* redoLogRecord1);
         void appendToTransactionCommit(RedoLogRecord* redoLogRecord1);
@@ -91,6 +231,7 @@ namespace OpenLogReplicator {
         void appendToTransactionRollback(RedoLogRecord* redoLogRecord1);
         void appendToTransaction(RedoLogRecord* redoLogRecord1, RedoLogRecord* redoLogRecord2);
         void appendToTransactionRollback(RedoLogRecord* redoLogRecord1, RedoLogRecord* redoLogRecord2);
+        void streamTransaction(Transaction* transaction);
         void dumpRedoVector(const uint8_t* data, typeSize recordSize) const;
 
     public:
@@ -100,12 +241,23 @@ namespace OpenLogReplicator {
         Scn firstScn{Scn::none()};
         Scn nextScn{Scn::none()};
         Reader* reader{nullptr};
+        LwnDecoderPool* lwnDecoderPool{nullptr};
+        TransactionFlusher* transactionFlusher{nullptr};
+        // Source of the LWNs when the log was decoded ahead, nullptr when the parser reads the blocks itself
+        CatchUpDecoder* catchUpDecoder{nullptr};
+        // Orders the LWNs of all instances of a RAC database, nullptr for a single instance
+        RacCoordinator* racCoordinator{nullptr};
+        uint racInstance{0};
 
         Parser(Ctx* newCtx, Builder* newBuilder, Metadata* newMetadata, TransactionBuffer* newTransactionBuffer, int newGroup, std::string newPath);
         ~Parser();
 
         Reader::REDO_CODE parse();
+        typeBlk decodeAhead(Thread* t, CatchUpDecoder* decoder);
         [[nodiscard]] std::string toString() const;
+
+        friend class CatchUpDecoder;
+        friend class LwnDecoderPool;
     };
 }
 
@@ -0,0 +1,123 @@
+/* Global scn order of the LWNs of all instances of a RAC database
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include "../common/Clock.h"
+#include "../common/Ctx.h"
+#include "../common/Thread.h"
+#include "RacCoordinator.h"
+
+namespace OpenLogReplicator {
+    RacCoordinator::RacCoordinator(Ctx* newCtx) :
+            ctx(newCtx) {
+    }
+
+    uint RacCoordinator::registerInstance() {
+        std::unique_lock<std::mutex> const lck(mtx);
+        instances.emplace_back();
+        instances.back().lastActive = ctx->clock->getTimeUt();
+        return instances.size() - 1;
+    }
+
+    // Equal scn of two instances is decided by the order of registration. The turn of an instance whose parse was interrupted by an
+    // exception is not waited for by the instance itself
+    bool RacCoordinator::isTurn(uint instance, Scn lwnScn, time_ut now) const {
+        if (owner != -1 && owner != static_cast<int64_t>(instance))
+            return false;
+
+        for (uint other = 0; other < instances.size(); ++other) {
+            if (other == instance)
+                continue;
+
+            const Instance& otherInstance = instances[other];
+            if (otherInstance.finished || otherInstance.closed || otherInstance.floor > lwnScn)
+                continue;
+
+            if (otherInstance.floor == lwnScn && (other > instance || !otherInstance.pending))
+                continue;
+
+            if (!otherInstance.pending && now - otherInstance.lastActive > IDLE_INSTANCE_US)
+                continue;
+
+            return false;
+        }
+        return true;
+    }
+
+    void RacCoordinator::lwnBegin(Thread* t, uint instance, Scn lwnScn) {
+        t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::RAC_COORDINATOR);
+        std::unique_lock<std::mutex> lck(mtx);
+        Instance& current = instances[instance];
+        current.floor = lwnScn;
+        current.pending = true;
+        current.closed = false;
+        current.lastActive = ctx->clock->getTimeUt();
+        condTurn.notify_all();
+
+        while (!ctx->hardShutdown) {
+            if (isTurn(instance, lwnScn, ctx->clock->getTimeUt()))
+                break;
+
+            if (unlikely(ctx->isTraceSet(Ctx::TRACE::SLEEP)))
+                ctx->logTrace(Ctx::TRACE::SLEEP, "RacCoordinator:lwnBegin");
+            t->contextSet(Thread::CONTEXT::WAIT, Thread::REASON::RAC_COORDINATOR_WAIT);
+            condTurn.wait_for(lck, std::chrono::milliseconds(100));
+            t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::RAC_COORDINATOR);
+        }
+
+        owner = instance;
+        t->contextSet(Thread::CONTEXT::CPU);
+    }
+
+    // Scn of LWNs of one redo thread only grows, so the last applied one stays the floor of the instance
+    void RacCoordinator::lwnEnd(Thread* t, uint instance) {
+        t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::RAC_COORDINATOR);
+        std::unique_lock<std::mutex> const lck(mtx);
+        Instance& current = instances[instance];
+        current.pending = false;
+        current.lastActive = ctx->clock->getTimeUt();
+        if (owner == static_cast<int64_t>(instance))
+            owner = -1;
+        condTurn.notify_all();
+        t->contextSet(Thread::CONTEXT::CPU);
+    }
+
+    // A finished redo log moves the floor to its next scn, every following LWN of the thread has at least this scn. Published
+    // with no LWN at all, so that an instance with no DML doesn't hold the others until it is treated as idle
+    void RacCoordinator::advance(Thread* t, uint instance, Scn scn, bool closed) {
+        t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::RAC_COORDINATOR);
+        std::unique_lock<std::mutex> const lck(mtx);
+        Instance& current = instances[instance];
+        if (scn != Scn::none() && scn > current.floor)
+            current.floor = scn;
+        current.closed = closed;
+        current.lastActive = ctx->clock->getTimeUt();
+        condTurn.notify_all();
+        t->contextSet(Thread::CONTEXT::CPU);
+    }
+
+    void RacCoordinator::finish(uint instance) {
+        std::unique_lock<std::mutex> const lck(mtx);
+        Instance& current = instances[instance];
+        current.finished = true;
+        current.pending = false;
+        if (owner == static_cast<int64_t>(instance))
+            owner = -1;
+        condTurn.notify_all();
+    }
+}
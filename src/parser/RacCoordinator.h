@@ -0,0 +1,73 @@
+/* Header for RacCoordinator class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef RAC_COORDINATOR_H_
+#define RAC_COORDINATOR_H_
+
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include "../common/types/Scn.h"
+#include "../common/types/Types.h"
+
+namespace OpenLogReplicator {
+    class Ctx;
+    class Thread;
+
+    // Shared by the parsers of all instances of a RAC database. The redo threads are read and decoded in parallel, but an LWN is
+    // applied to the transactions only when no other instance can still deliver an LWN with a lower scn, so that all instances
+    // produce their output in one global scn order
+    class RacCoordinator final {
+    protected:
+        // An instance which did not move for so long has no redo to deliver and is not waited for
+        static constexpr time_ut IDLE_INSTANCE_US{1000000};
+
+        struct Instance {
+            // Lowest scn of an LWN the instance may still apply
+            Scn floor{Scn::zero()};
+            time_ut lastActive{0};
+            bool pending{false};
+            // The redo thread was closed by the instance shutdown, nothing comes until it is opened again
+            bool closed{false};
+            bool finished{false};
+        };
+
+        Ctx* ctx;
+        std::mutex mtx;
+        std::condition_variable condTurn;
+        std::vector<Instance> instances;
+        // Instance applying an LWN at the moment, -1 for none
+        int64_t owner{-1};
+
+        [[nodiscard]] bool isTurn(uint instance, Scn lwnScn, time_ut now) const;
+
+    public:
+        explicit RacCoordinator(Ctx* newCtx);
+
+        // Only called before the parsers are started
+        uint registerInstance();
+        void lwnBegin(Thread* t, uint instance, Scn lwnScn);
+        void lwnEnd(Thread* t, uint instance);
+        void advance(Thread* t, uint instance, Scn scn, bool closed);
+        void finish(uint instance);
+    };
+}
+
+#endif
@@ -0,0 +1,165 @@
+/* Profile of the redo workload read in batch mode
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "../common/Ctx.h"
+#include "../common/DbTable.h"
+#include "../common/exception/RuntimeException.h"
+#include "../common/types/Data.h"
+#include "../metadata/Metadata.h"
+#include "../metadata/Schema.h"
+#include "RedoProfile.h"
+
+namespace OpenLogReplicator {
+    RedoProfile::RedoProfile(Ctx* newCtx, std::string newFileName, uint64_t newMemoryMaxMb) :
+            ctx(newCtx),
+            fileName(std::move(newFileName)),
+            memoryMaxMb(newMemoryMaxMb) {
+    }
+
+    void RedoProfile::commit(uint64_t bytes, uint64_t buffered, uint64_t seconds, bool rollback) {
+        if (rollback)
+            ++rollbacks;
+        else
+            ++commits;
+        transactionBytes.add(bytes);
+        transactionBuffered.add(buffered);
+        transactionSeconds.add(seconds);
+    }
+
+    // Called at the end of every LWN, the memory of the transactions is taken as it is at that point
+    void RedoProfile::sample(uint64_t open, uint64_t openBytes, uint64_t bufferedBytes) {
+        openPeak = std::max(openPeak, open);
+        openBytesPeak = std::max(openBytesPeak, openBytes);
+        bufferedBytesPeak = std::max(bufferedBytesPeak, bufferedBytes);
+
+        const uint64_t swappedMb = ctx->swappedMB.load(std::memory_order_relaxed);
+        swappedMbPeak = std::max(swappedMbPeak, swappedMb);
+        transactionMbPeak = std::max(transactionMbPeak, ctx->getMemoryModuleMb(Ctx::MEMORY::TRANSACTIONS) + swappedMb);
+    }
+
+    void RedoProfile::writeHistogram(std::ostringstream& ss, const char* name, const Histogram& histogram) {
+        ss << R"(")" << name << R"(":{"count":)" << histogram.count << R"(,"sum":)" << histogram.sum << R"(,"max":)" << histogram.max <<
+           R"(,"buckets":[)";
+        bool first = true;
+        for (uint bucket = 0; bucket < BUCKETS; ++bucket) {
+            if (histogram.buckets[bucket] == 0)
+                continue;
+            if (!first)
+                ss << ',';
+            first = false;
+            if (bucket < BUCKETS - 1)
+                ss << R"({"below":)" << (1ULL << bucket);
+            else
+                ss << R"({"from":)" << (1ULL << (BUCKETS - 2));
+            ss << R"(,"count":)" << histogram.buckets[bucket] << '}';
+        }
+        ss << "]}";
+    }
+
+    void RedoProfile::write(Metadata* metadata) const {
+        std::ostringstream ss;
+        ss << R"({"opcodes":[)";
+        bool first = true;
+        for (uint opCode = 0; opCode < OPCODES; ++opCode) {
+            if (opCodes[opCode].count == 0)
+                continue;
+            if (!first)
+                ss << ',';
+            first = false;
+            ss << R"({"op":")" << (opCode >> 8) << '.' << (opCode & 0xFF) << R"(","count":)" << opCodes[opCode].count << R"(,"bytes":)" <<
+               opCodes[opCode].bytes << '}';
+        }
+
+        // The biggest objects first
+        std::vector<std::pair<typeObj, Counter>> sorted(objects.begin(), objects.end());
+        std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+            return a.second.bytes > b.second.bytes || (a.second.bytes == b.second.bytes && a.first < b.first);
+        });
+
+        ss << R"(],"objects":[)";
+        first = true;
+        {
+            std::unique_lock<std::mutex> const lck(metadata->mtxSchema);
+            for (const auto& [obj, counter]: sorted) {
+                if (!first)
+                    ss << ',';
+                first = false;
+                ss << R"({"obj":)" << obj;
+
+                // Objects of the users out of the filter are not in the dictionary and are listed by number only
+                std::string owner;
+                std::string table;
+                const DbTable* dbTable = metadata->schema->checkTableDict(obj);
+                if (dbTable != nullptr) {
+                    ss << R"(,"owner":")";
+                    Data::writeEscapeValue(ss, dbTable->owner);
+                    ss << R"(","table":")";
+                    Data::writeEscapeValue(ss, dbTable->name);
+                    ss << R"(","filter":1)";
+                } else if (metadata->schema->checkTableDictUncommitted(obj, owner, table)) {
+                    ss << R"(,"owner":")";
+                    Data::writeEscapeValue(ss, owner);
+                    ss << R"(","table":")";
+                    Data::writeEscapeValue(ss, table);
+                    ss << R"(","filter":0)";
+                }
+                ss << R"(,"count":)" << counter.count << R"(,"bytes":)" << counter.bytes << '}';
+            }
+        }
+
+        ss << R"(],"lob":{"count":)" << lobs.count << R"(,"bytes":)" << lobs.bytes << '}';
+
+        ss << R"(,"transactions":{"commits":)" << commits << R"(,"rollbacks":)" << rollbacks << ',';
+        writeHistogram(ss, "redo-bytes", transactionBytes);
+        ss << ',';
+        writeHistogram(ss, "buffered-bytes", transactionBuffered);
+        ss << ',';
+        writeHistogram(ss, "seconds", transactionSeconds);
+        ss << '}';
+
+        ss << R"(,"open":{"peak-count":)" << openPeak << R"(,"peak-redo-bytes":)" << openBytesPeak << R"(,"peak-buffered-bytes":)" <<
+           bufferedBytesPeak << '}';
+
+        ss << R"(,"memory":{"memory-hwm-mb":)" << ctx->getMemoryHWM() << R"(,"transactions-hwm-mb":)" <<
+           ctx->getMemoryModuleHwmMb(Ctx::MEMORY::TRANSACTIONS) << R"(,"transactions-peak-mb":)" << transactionMbPeak <<
+           R"(,"swapped-peak-mb":)" << swappedMbPeak;
+        // What would not fit in the given memory is swapped
+        if (memoryMaxMb > 0)
+            ss << R"(,"max-mb":)" << memoryMaxMb << R"(,"swap-projected-mb":)" <<
+               (transactionMbPeak > memoryMaxMb ? transactionMbPeak - memoryMaxMb : 0);
+        ss << "}}\n";
+
+        std::ofstream out(fileName, std::ios::trunc);
+        if (!out.is_open())
+            throw RuntimeException(10006, "file: " + fileName + " - open for writing returned: " + strerror(errno));
+        out << ss.str();
+        out.close();
+        if (out.fail())
+            throw RuntimeException(10007, "file: " + fileName + " - write returned: " + strerror(errno));
+
+        ctx->info(0, "redo profile written to: " + fileName + ", objects: " + std::to_string(objects.size()) + ", transactions: " +
+                     std::to_string(commits + rollbacks));
+    }
+}
@@ -0,0 +1,119 @@
+/* Header for RedoProfile class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef REDO_PROFILE_H_
+#define REDO_PROFILE_H_
+
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+#include "../common/types/Types.h"
+
+namespace OpenLogReplicator {
+    class Ctx;
+    class Metadata;
+
+    // Workload of the redo read in batch mode, collected by the parser thread only. The transactions are buffered as usual but no output
+    // is built, the report is written once all logs are processed and is used to size the memory and the filter before going live
+    class RedoProfile final {
+    public:
+        static constexpr uint OPCODES{0x10000};
+        // Powers of 2, the last bucket counts everything above
+        static constexpr uint BUCKETS{48};
+
+        struct Counter {
+            uint64_t count{0};
+            uint64_t bytes{0};
+        };
+
+        struct Histogram {
+            uint64_t buckets[BUCKETS]{};
+            uint64_t count{0};
+            uint64_t sum{0};
+            uint64_t max{0};
+
+            void add(uint64_t value) {
+                uint bucket = 0;
+                while (bucket < BUCKETS - 1 && value >= (1ULL << bucket))
+                    ++bucket;
+                ++buckets[bucket];
+                ++count;
+                sum += value;
+                if (value > max)
+                    max = value;
+            }
+        };
+
+    protected:
+        Ctx* ctx;
+        std::string fileName;
+        // Memory for the transactions the profiled run is compared to, 0 - not given
+        uint64_t memoryMaxMb;
+
+        Counter opCodes[OPCODES];
+        std::unordered_map<typeObj, Counter> objects;
+        Counter* lastObject{nullptr};
+        typeObj lastObj{0};
+        Counter lobs;
+        Histogram transactionBytes;
+        Histogram transactionBuffered;
+        Histogram transactionSeconds;
+        uint64_t commits{0};
+        uint64_t rollbacks{0};
+        uint64_t openPeak{0};
+        // Redo of all objects and the part kept for the tables of the filter, at their own peaks
+        uint64_t openBytesPeak{0};
+        uint64_t bufferedBytesPeak{0};
+        // Transactions in memory and swapped together
+        uint64_t transactionMbPeak{0};
+        uint64_t swappedMbPeak{0};
+
+        static void writeHistogram(std::ostringstream& ss, const char* name, const Histogram& histogram);
+
+    public:
+        RedoProfile(Ctx* newCtx, std::string newFileName, uint64_t newMemoryMaxMb);
+
+        void vector(typeOp2 opCode, uint64_t size) {
+            Counter& counter = opCodes[opCode & (OPCODES - 1)];
+            ++counter.count;
+            counter.bytes += size;
+        }
+
+        void object(typeObj obj, uint64_t size) {
+            if (lastObject == nullptr || lastObj != obj) {
+                lastObject = &objects[obj];
+                lastObj = obj;
+            }
+            ++lastObject->count;
+            lastObject->bytes += size;
+        }
+
+        void lob(uint64_t size) {
+            ++lobs.count;
+            lobs.bytes += size;
+        }
+
+        void commit(uint64_t bytes, uint64_t buffered, uint64_t seconds, bool rollback);
+        void sample(uint64_t open, uint64_t openBytes, uint64_t bufferedBytes);
+        void write(Metadata* metadata) const;
+    };
+}
+
+#endif
@@ -17,6 +17,8 @@ You should have received a copy of the GNU General Public License
 along with OpenLogReplicator; see the file LICENSE;  If not see
 <http://www.gnu.org/licenses/>.  */
 
+#include <iterator>
+
 #include "../builder/Builder.h"
 #include "../builder/SystemTransaction.h"
 #include "../common/DbLob.h"
@@ -32,16 +34,55 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include "TransactionBuffer.h"
 
 namespace OpenLogReplicator {
-    Transaction::Transaction(Xid newXid, std::map<LobKey, uint8_t*>* newOrphanedLobs, XmlCtx* newXmlCtx) :
+    Transaction::Transaction(Xid newXid, OrphanedLobs* newOrphanedLobs, XmlCtx* newXmlCtx) :
             xmlCtx(newXmlCtx),
             xid(newXid) {
         lobCtx.orphanedLobs = newOrphanedLobs;
+        redo1.reserve(REDO_PIECES);
+        redo2.reserve(REDO_PIECES);
+    }
+
+    // Prepare a purged object for reuse, the containers keep their capacity
+    void Transaction::reset(Xid newXid, XmlCtx* newXmlCtx) {
+        deallocChunks.clear();
+        opCodes = 0;
+        xmlCtx = newXmlCtx;
+        xid = newXid;
+        firstSequence = Seq();
+        firstFileOffset = FileOffset();
+        commitSequence = Seq();
+        commitScn = Scn();
+        lastTc = nullptr;
+        slabChunk = nullptr;
+        commitTimestamp = Time(0);
+        begin = false;
+        rollback = false;
+        system = false;
+        schema = false;
+        shutdown = false;
+        lastSplit = false;
+        dump = false;
+        lobData = false;
+        streamed = false;
+        size = 0;
+        profileBytes = 0;
+        persistSequence = Seq::none();
+        persistFileOffset = FileOffset();
+        persistDirty = false;
+        persistAttributes = 0;
+        attributes.clear();
+        traced = false;
+        traceBeginUt = 0;
+        traceCommitUt = 0;
+        traceTable = nullptr;
+        rollbackIndexDrop();
     }
 
     void Transaction::add(const Metadata* metadata, TransactionBuffer* transactionBuffer, RedoLogRecord* redoLogRecord1) {
         log(metadata->ctx, "add ", redoLogRecord1);
         transactionBuffer->addTransactionChunk(this, redoLogRecord1);
         ++opCodes;
+        persistDirty = true;
     }
 
     void Transaction::add(const Metadata* metadata, TransactionBuffer* transactionBuffer, RedoLogRecord* redoLogRecord1, const RedoLogRecord* redoLogRecord2) {
@@ -49,6 +90,101 @@ namespace OpenLogReplicator {
         log(metadata->ctx, "add2", redoLogRecord2);
         transactionBuffer->addTransactionChunk(this, redoLogRecord1, redoLogRecord2);
         ++opCodes;
+        persistDirty = true;
+    }
+
+    RedoLogRecord* Transaction::unpackedRecord() {
+        const uint64_t block = unpackedUsed / REDO_PIECES;
+        if (block == unpacked.size())
+            unpacked.push_back(std::make_unique<RedoLogRecord[]>(REDO_PIECES));
+        return &unpacked[block][unpackedUsed++ % REDO_PIECES];
+    }
+
+    // Op of the row undone by a rollback row, 0 for none
+    typeOp1 Transaction::rollbackTarget(typeOp1 opCode) {
+        switch (opCode) {
+            case 0x0B02:
+                return 0x0B03;
+            case 0x0B03:
+                return 0x0B02;
+            case 0x0B0B:
+                return 0x0B0C;
+            case 0x0B0C:
+                return 0x0B0B;
+            case 0x0B05:
+            case 0x0B06:
+            case 0x0B08:
+            case 0x0B16:
+                return opCode;
+            default:
+                return 0;
+        }
+    }
+
+    static uint64_t rollbackIndexKey(typeObj obj, typeDba bdba) {
+        return (static_cast<uint64_t>(obj) << 32) | bdba;
+    }
+
+    void Transaction::rollbackIndexAdd(uint32_t offset, const RedoLogRecord* redoLogRecord2) {
+        rollbackIndex[rollbackIndexKey(redoLogRecord2->obj, redoLogRecord2->bdba)].push_back(offset);
+    }
+
+    // Rows are removed from the end of the chunk, so the row is the last one of its block
+    void Transaction::rollbackIndexRemove(uint32_t offset, const RedoLogRecord* redoLogRecord2) {
+        auto it = rollbackIndex.find(rollbackIndexKey(redoLogRecord2->obj, redoLogRecord2->bdba));
+        if (it != rollbackIndex.end() && !it->second.empty() && it->second.back() == offset)
+            it->second.pop_back();
+    }
+
+    void Transaction::rollbackIndexBuild() {
+        rollbackIndex.clear();
+        rollbackIndexChunk = lastTc;
+
+        uint32_t pos = 0;
+        RedoLogRecord redoLogRecord1;
+        RedoLogRecord redoLogRecord2;
+        for (uint64_t i = 0; i < lastTc->elements; ++i) {
+            const typeOp2 op = *reinterpret_cast<const typeOp2*>(lastTc->buffer + pos + TransactionBuffer::ROW_HEADER_OP);
+            if (op != TransactionBuffer::ROW_OP_ROLLED_BACK) {
+                TransactionBuffer::unpackRow(lastTc->buffer + pos, &redoLogRecord1, &redoLogRecord2);
+                rollbackIndexAdd(pos, &redoLogRecord2);
+            }
+            pos += TransactionBuffer::rowSize(lastTc->buffer + pos);
+        }
+    }
+
+    // The row undone is not the last one, it is looked up among the rows of the last chunk. The chunks before may be swapped out and
+    // are not searched
+    bool Transaction::rollbackInPlace(const Ctx* ctx, const RedoLogRecord* redoLogRecord1) {
+        const typeOp1 target = rollbackTarget(redoLogRecord1->opCode);
+        if (target == 0 || lastTc == nullptr || lastTc->elements == 0)
+            return false;
+
+        if (rollbackIndexChunk != lastTc)
+            rollbackIndexBuild();
+
+        auto it = rollbackIndex.find(rollbackIndexKey(redoLogRecord1->obj, redoLogRecord1->bdba));
+        if (it == rollbackIndex.end())
+            return false;
+
+        std::vector<uint32_t>& offsets = it->second;
+        RedoLogRecord rowRedoLogRecord1;
+        RedoLogRecord rowRedoLogRecord2;
+        for (auto offsetIt = offsets.rbegin(); offsetIt != offsets.rend(); ++offsetIt) {
+            const uint32_t offset = *offsetIt;
+            TransactionBuffer::unpackRow(lastTc->buffer + offset, &rowRedoLogRecord1, &rowRedoLogRecord2);
+            if (rowRedoLogRecord2.opCode != target || rowRedoLogRecord2.slot != redoLogRecord1->slot)
+                continue;
+
+            *reinterpret_cast<typeOp2*>(lastTc->buffer + offset + TransactionBuffer::ROW_HEADER_OP) = TransactionBuffer::ROW_OP_ROLLED_BACK;
+            offsets.erase(std::next(offsetIt).base());
+            --opCodes;
+            if (unlikely(ctx->isTraceSet(Ctx::TRACE::TRANSACTION)))
+                ctx->logTrace(Ctx::TRACE::TRANSACTION, "rollback in place, offset: " + redoLogRecord1->fileOffset.toString() + ", xid: " +
+                                                       xid.toString());
+            return true;
+        }
+        return false;
     }
 
     void Transaction::rollbackLastOp(const Metadata* metadata, TransactionBuffer* transactionBuffer, const RedoLogRecord* redoLogRecord1,
@@ -56,12 +192,20 @@ namespace OpenLogReplicator {
         const Ctx* ctx = metadata->ctx;
         log(ctx, "rlb1", redoLogRecord1);
         log(ctx, "rlb2", redoLogRecord2);
+        persistDirty = true;
 
         while (lastTc != nullptr && lastTc->size > 0 && opCodes > 0) {
             auto sizeLast = *reinterpret_cast<typeChunkSize*>(lastTc->buffer + lastTc->size - sizeof(typeChunkSize));
-            const auto* lastRedoLogRecord1 = reinterpret_cast<const RedoLogRecord*>(lastTc->buffer + lastTc->size - sizeLast + TransactionBuffer::ROW_HEADER_DATA0);
-            const auto* lastRedoLogRecord2 = reinterpret_cast<const RedoLogRecord*>(lastTc->buffer + lastTc->size - sizeLast +
-                                                                                    TransactionBuffer::ROW_HEADER_DATA1 + lastRedoLogRecord1->size);
+            // Rolled back before, counted already
+            if (*reinterpret_cast<const typeOp2*>(lastTc->buffer + lastTc->size - sizeLast + TransactionBuffer::ROW_HEADER_OP) ==
+                    TransactionBuffer::ROW_OP_ROLLED_BACK) {
+                transactionBuffer->rollbackTransactionChunk(this);
+                continue;
+            }
+
+            RedoLogRecord lastRecords[2];
+            TransactionBuffer::unpackRow(lastTc->buffer + lastTc->size - sizeLast, &lastRecords[0], &lastRecords[1]);
+            const RedoLogRecord* lastRedoLogRecord2 = &lastRecords[1];
 
             bool ok = false;
             switch (lastRedoLogRecord2->opCode) {
@@ -73,46 +217,17 @@ namespace OpenLogReplicator {
                     --opCodes;
                     continue;
 
-                case 0x0B05:
-                    if (redoLogRecord1->opCode == 0x0B05)
-                        ok = true;
-                    break;
-                case 0x0B02:
-                    if (redoLogRecord1->opCode == 0x0B03)
-                        ok = true;
-                    break;
-                case 0x0B03:
-                    if (redoLogRecord1->opCode == 0x0B02)
-                        ok = true;
-                    break;
-                case 0x0B06:
-                    if (redoLogRecord1->opCode == 0x0B06)
-                        ok = true;
-                    break;
-                case 0x0B08:
-                    if (redoLogRecord1->opCode == 0x0B08)
-                        ok = true;
-                    break;
-                case 0x0B0B:
-                    if (redoLogRecord1->opCode == 0x0B0C)
-                        ok = true;
-                    break;
-                case 0x0B0C:
-                    if (redoLogRecord1->opCode == 0x0B0B)
-                        ok = true;
-                    break;
-                case 0x0B16:
-                    if (redoLogRecord1->opCode == 0x0B16)
-                        ok = true;
-                    break;
                 default:
-                    ;
+                    ok = lastRedoLogRecord2->opCode != 0 && lastRedoLogRecord2->opCode == rollbackTarget(redoLogRecord1->opCode);
             }
 
             if (lastRedoLogRecord2->obj != redoLogRecord1->obj)
                 ok = false;
 
             if (!ok) {
+                if (rollbackInPlace(ctx, redoLogRecord1))
+                    return;
+
                 ctx->warning(70003, "trying to rollback: " + std::to_string(lastRedoLogRecord2->opCode) + " with: " + std::to_string(redoLogRecord1->opCode) +
                                     ", offset: " + redoLogRecord1->fileOffset.toString() + ", xid: " + xid.toString() + ", pos: 2");
                 return;
@@ -123,19 +238,30 @@ namespace OpenLogReplicator {
             return;
         }
 
+        if (streamed) {
+            ctx->warning(60044, "rollback of a row already sent as provisional, offset: " + redoLogRecord1->fileOffset.toString() + ", xid: " +
+                                xid.toString());
+            return;
+        }
         ctx->warning(70004, "rollback failed for " + std::to_string(redoLogRecord1->opCode) + " empty buffer, offset: " +
                             redoLogRecord1->fileOffset.toString() + ", xid: " + xid.toString() + ", pos: 2");
     }
 
     void Transaction::rollbackLastOp(const Metadata* metadata, TransactionBuffer* transactionBuffer, const RedoLogRecord* redoLogRecord1) {
         log(metadata->ctx, "rlb ", redoLogRecord1);
+        persistDirty = true;
 
         while (lastTc != nullptr && lastTc->size > 0 && opCodes > 0) {
             auto sizeLast = *reinterpret_cast<const typeChunkSize*>(lastTc->buffer + lastTc->size - sizeof(typeChunkSize));
-            const auto* lastRedoLogRecord1 = reinterpret_cast<const RedoLogRecord*>(lastTc->buffer + lastTc->size - sizeLast +
-                                                                                    TransactionBuffer::ROW_HEADER_DATA0);
-            const auto* lastRedoLogRecord2 = reinterpret_cast<const RedoLogRecord*>(lastTc->buffer + lastTc->size - sizeLast +
-                                                                                    TransactionBuffer::ROW_HEADER_DATA1 + lastRedoLogRecord1->size);
+            if (*reinterpret_cast<const typeOp2*>(lastTc->buffer + lastTc->size - sizeLast + TransactionBuffer::ROW_HEADER_OP) ==
+                    TransactionBuffer::ROW_OP_ROLLED_BACK) {
+                transactionBuffer->rollbackTransactionChunk(this);
+                continue;
+            }
+            RedoLogRecord lastRecords[2];
+            TransactionBuffer::unpackRow(lastTc->buffer + lastTc->size - sizeLast, &lastRecords[0], &lastRecords[1]);
+            const RedoLogRecord* lastRedoLogRecord1 = &lastRecords[0];
+            const RedoLogRecord* lastRedoLogRecord2 = &lastRecords[1];
 
             bool ok = false;
             switch (lastRedoLogRecord2->opCode) {
@@ -172,56 +298,112 @@ namespace OpenLogReplicator {
             return;
         }
 
+        if (streamed) {
+            metadata->ctx->warning(60044, "rollback of a row already sent as provisional, offset: " + redoLogRecord1->fileOffset.toString() +
+                                          ", xid: " + xid.toString());
+            return;
+        }
         metadata->ctx->warning(70004, "rollback failed for " + std::to_string(redoLogRecord1->opCode) +
                                       " empty buffer, offset: " + redoLogRecord1->fileOffset.toString() + ", xid: " + xid.toString() + ", pos: 1");
     }
 
     void Transaction::flush(Metadata* metadata, Builder* builder, Scn lwnScn) {
-        metadata->ctx->swappedMemoryFlush(metadata->ctx->parserThread, xid);
+        Thread* const t = builder->buildThread();
+        metadata->ctx->swappedMemoryFlush(t, xid);
         bool opFlush;
         const uint64_t maxMessageMb = builder->getMaxMessageMb();
-        metadata->ctx->parserThread->contextSet(Thread::CONTEXT::TRAN, Thread::REASON::TRAN);
+        t->contextSet(Thread::CONTEXT::TRAN, Thread::REASON::TRAN);
         std::unique_lock<std::mutex> const lckTransaction(metadata->mtxTransaction);
         std::unique_lock<std::mutex> lckSchema(metadata->mtxSchema, std::defer_lock);
 
         if (opCodes == 0 || rollback) {
-            metadata->ctx->parserThread->contextSet(Thread::CONTEXT::CPU);
+            if (streamed) {
+                const time_t timestamp = commitTimestamp.toEpoch(metadata->ctx->hostTimezone);
+                builder->processBegin(xid, commitScn, lwnScn, &attributes);
+                if (rollback)
+                    builder->processRollback(commitScn, commitSequence, timestamp);
+                else {
+                    builder->provisionalCommit = true;
+                    builder->processCommit(commitScn, commitSequence, timestamp);
+                    builder->provisionalCommit = false;
+                }
+                builder->processEnd();
+            }
+            t->contextSet(Thread::CONTEXT::CPU);
             return;
         }
         if (unlikely(metadata->ctx->isTraceSet(Ctx::TRACE::TRANSACTION)))
             metadata->ctx->logTrace(Ctx::TRACE::TRANSACTION, toString(metadata->ctx));
 
-        if (system) {
-            metadata->ctx->parserThread->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::TRANSACTION_SYSTEM);
+        // User data is built with the maps of all previous system transactions, the next system transaction only needs them for touched
+        // system tables
+        if (unlikely(metadata->schemaMapsPending.load(std::memory_order_relaxed))) {
+            t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::TRANSACTION_SYSTEM);
             lckSchema.lock();
-            metadata->ctx->parserThread->contextSet(Thread::CONTEXT::TRAN, Thread::REASON::TRAN);
+            t->contextSet(Thread::CONTEXT::TRAN, Thread::REASON::TRAN);
+            if (!system || metadata->schema->isSystemTableTouched())
+                metadata->rebuildSchemaMaps();
+            if (!system)
+                lckSchema.unlock();
+        }
+
+        if (system) {
+            if (!lckSchema.owns_lock()) {
+                t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::TRANSACTION_SYSTEM);
+                lckSchema.lock();
+                t->contextSet(Thread::CONTEXT::TRAN, Thread::REASON::TRAN);
+            }
 
             if (unlikely(builder->systemTransaction != nullptr))
                 throw RedoLogException(50056, "system transaction already active");
             builder->systemTransaction = new SystemTransaction(builder, metadata);
             metadata->schema->scn = commitScn;
         }
+        Tracer::Trace trace;
+        Tracer* const tracer = traced ? metadata->ctx->tracer : nullptr;
+        if (unlikely(tracer != nullptr)) {
+            trace.xid = xid;
+            trace.commitScn = commitScn;
+            trace.beginUt = traceBeginUt;
+            trace.commitUt = traceCommitUt;
+            trace.flushUt = metadata->ctx->clock->getTimeUt();
+        }
         builder->processBegin(xid, commitScn, lwnScn, &attributes);
+        if (unlikely(tracer != nullptr))
+            builder->trace = &trace;
 
         Format::TRANSACTION_TYPE transactionType = Format::TRANSACTION_TYPE::T_NONE;
-        std::deque<const RedoLogRecord*> redo1;
-        std::deque<const RedoLogRecord*> redo2;
+        const time_t timestamp = commitTimestamp.toEpoch(metadata->ctx->hostTimezone);
+        redo1.clear();
+        redo2.clear();
 
-        const uint64_t mMax = metadata->ctx->swappedMemorySize(metadata->ctx->parserThread, xid);
+        // A transaction kept in a slab has no memory chunks, the slab is released on purge
+        const bool inSlab = slabChunk != nullptr;
+        const uint64_t mMax = inSlab ? 1 : metadata->ctx->swappedMemorySize(t, xid);
         for (uint64_t m = 0; m < mMax; ++m) {
-            auto* const tc = reinterpret_cast<TransactionChunk*>(metadata->ctx->swappedMemoryGet(metadata->ctx->parserThread, xid, m));
+            auto* const tc = inSlab ? lastTc : reinterpret_cast<TransactionChunk*>(metadata->ctx->swappedMemoryGet(t, xid, m));
             uint64_t pos = 0;
             for (uint64_t i = 0; i < tc->elements; ++i) {
-                typeOp2 const op = *reinterpret_cast<const typeOp2*>(tc->buffer + pos);
+                const uint8_t* row = tc->buffer + pos;
+                typeOp2 const op = *reinterpret_cast<const typeOp2*>(row + TransactionBuffer::ROW_HEADER_OP);
+
+                pos += TransactionBuffer::rowSize(row);
+                // Headers of the next pair are read right after this one is processed
+                if (likely(i + 1 < tc->elements))
+                    __builtin_prefetch(tc->buffer + pos, 0, 0);
+                if (unlikely(op == TransactionBuffer::ROW_OP_ROLLED_BACK))
+                    continue;
 
-                auto* redoLogRecord1 = reinterpret_cast<RedoLogRecord*>(tc->buffer + pos + TransactionBuffer::ROW_HEADER_DATA0);
-                auto* redoLogRecord2 = reinterpret_cast<RedoLogRecord*>(tc->buffer + pos + TransactionBuffer::ROW_HEADER_DATA1 + redoLogRecord1->size);
+                // Only the pieces of the row being matched refer to the records unpacked before
+                if (redo1.empty())
+                    unpackedUsed = 0;
+                auto* redoLogRecord1 = unpackedRecord();
+                auto* redoLogRecord2 = unpackedRecord();
+                TransactionBuffer::unpackRow(row, redoLogRecord1, redoLogRecord2);
 
                 log(metadata->ctx, "flu1", redoLogRecord1);
                 log(metadata->ctx, "flu2", redoLogRecord2);
 
-                pos += redoLogRecord1->size + redoLogRecord2->size + TransactionBuffer::ROW_HEADER_TOTAL;
-
                 if (unlikely(metadata->ctx->isTraceSet(Ctx::TRACE::TRANSACTION)))
                     metadata->ctx->logTrace(Ctx::TRACE::TRANSACTION, std::to_string(redoLogRecord1->size) + ":" + std::to_string(redoLogRecord2->size) +
                                                                      " fb: " + std::to_string(static_cast<uint>(redoLogRecord1->fb)) + ":" +
@@ -439,8 +621,9 @@ namespace OpenLogReplicator {
                             if (redo1.back()->suppLogBdba == redoLogRecord1->suppLogBdba && redo1.back()->suppLogSlot == redoLogRecord1->suppLogSlot &&
                                 redo1.front()->obj == redoLogRecord1->obj && redo2.front()->obj == redoLogRecord2->obj) {
                                 if (transactionType == Format::TRANSACTION_TYPE::INSERT) {
-                                    redo1.push_front(redoLogRecord1);
-                                    redo2.push_front(redoLogRecord2);
+                                    // Few pieces per row, inserting at the front is cheaper than a deque
+                                    redo1.insert(redo1.begin(), redoLogRecord1);
+                                    redo2.insert(redo2.begin(), redoLogRecord2);
                                 } else {
                                     if (op == 0x05010B06 && redo2.back()->opCode == 0x0B02) {
                                         const RedoLogRecord* prev = redo1.back();
@@ -463,7 +646,7 @@ namespace OpenLogReplicator {
                         }
 
                         if ((redoLogRecord1->suppLogFb & RedoLogRecord::FB_L) != 0) {
-                            builder->processDml(redo2.front()->scnRecord, commitSequence, commitTimestamp.toEpoch(metadata->ctx->hostTimezone),
+                            builder->processDml(redo2.front()->scnRecord, commitSequence, timestamp,
                                                 &lobCtx, xmlCtx, redo1, redo2, transactionType, system, schema, dump);
                             opFlush = true;
                         }
@@ -472,7 +655,7 @@ namespace OpenLogReplicator {
                     case 0x05010B0B:
                         // Insert multiple rows
                         builder->processInsertMultiple(redoLogRecord2->scnRecord, commitSequence,
-                                                       commitTimestamp.toEpoch(metadata->ctx->hostTimezone), &lobCtx, xmlCtx, redoLogRecord1,
+                                                       timestamp, &lobCtx, xmlCtx, redoLogRecord1,
                                                        redoLogRecord2, system, schema, dump);
                         opFlush = true;
                         break;
@@ -480,14 +663,14 @@ namespace OpenLogReplicator {
                     case 0x05010B0C:
                         // Delete multiple rows
                         builder->processDeleteMultiple(redoLogRecord2->scnRecord, commitSequence,
-                                                       commitTimestamp.toEpoch(metadata->ctx->hostTimezone), &lobCtx, xmlCtx, redoLogRecord1,
+                                                       timestamp, &lobCtx, xmlCtx, redoLogRecord1,
                                                        redoLogRecord2, system, schema, dump);
                         opFlush = true;
                         break;
 
                     case 0x18010000:
                         // DDL operation
-                        builder->processDdl(commitScn, commitSequence, commitTimestamp.toEpoch(metadata->ctx->hostTimezone), redoLogRecord1);
+                        builder->processDdl(commitScn, commitSequence, timestamp, redoLogRecord1);
                         opFlush = true;
                         break;
 
@@ -501,6 +684,7 @@ namespace OpenLogReplicator {
                     metadata->ctx->warning(60015, "big transaction divided (forced commit after " + std::to_string(builder->builderSize()) +
                                                   " bytes), xid: " + xid.toString());
 
+                    builder->compactFlush();
                     if (system) {
                         if (unlikely(metadata->ctx->isTraceSet(Ctx::TRACE::SYSTEM)))
                             metadata->ctx->logTrace(Ctx::TRACE::SYSTEM, "commit");
@@ -513,8 +697,10 @@ namespace OpenLogReplicator {
                         builder->systemTransaction = new SystemTransaction(builder, metadata);
                     }
 
-                    builder->processCommit(commitScn, commitSequence, commitTimestamp.toEpoch(metadata->ctx->hostTimezone));
+                    builder->processCommit(commitScn, commitSequence, timestamp);
                     builder->processBegin(xid, commitScn, lwnScn, &attributes);
+                    if (unlikely(tracer != nullptr))
+                        builder->trace = &trace;
                 }
 
                 if (opFlush) {
@@ -522,21 +708,28 @@ namespace OpenLogReplicator {
                     redo2.clear();
                     transactionType = Format::TRANSACTION_TYPE::T_NONE;
 
-                    for (auto k: deallocChunks)
-                        metadata->ctx->swappedMemoryRelease(metadata->ctx->parserThread, xid, k);
-                    deallocChunks.clear();
+                    if (unlikely(!deallocChunks.empty())) {
+                        metadata->ctx->swappedMemoryRelease(t, xid, deallocChunks);
+                        deallocChunks.clear();
+                    }
                 }
             }
 
-            deallocChunks.push_back(m);
+            if (!inSlab)
+                deallocChunks.push_back(m);
         }
 
-        for (auto k: deallocChunks)
-            metadata->ctx->swappedMemoryRelease(metadata->ctx->parserThread, xid, k);
-        deallocChunks.clear();
+        if (!deallocChunks.empty()) {
+            metadata->ctx->swappedMemoryRelease(t, xid, deallocChunks);
+            deallocChunks.clear();
+        }
+        redo1.clear();
+        redo2.clear();
 
         opCodes = 0;
 
+        // Rows held back refer to tables which the system transaction may be about to replace
+        builder->compactFlush();
         if (system) {
             builder->systemTransaction->commit(commitScn);
             delete builder->systemTransaction;
@@ -546,18 +739,48 @@ namespace OpenLogReplicator {
             // Unlock schema
             lckSchema.unlock();
         }
-        builder->processCommit(commitScn, commitSequence, commitTimestamp.toEpoch(metadata->ctx->hostTimezone));
-        metadata->ctx->parserThread->contextSet(Thread::CONTEXT::CPU);
+        builder->processCommit(commitScn, commitSequence, timestamp);
+        builder->processEnd();
+        if (unlikely(tracer != nullptr)) {
+            trace.flushEndUt = metadata->ctx->clock->getTimeUt();
+            tracer->built(t, trace);
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
     }
 
-    void Transaction::purge(Ctx* ctx) {
-        ctx->swappedMemoryRemove(ctx->parserThread, xid);
+    // Rows collected so far are sent as provisional at the position of the current LWN and their memory is released. The transaction goes
+    // on from empty storage, a row rolled back later can't be taken back any more
+    void Transaction::stream(Metadata* metadata, Builder* builder, TransactionBuffer* transactionBuffer, Scn lwnScn, Time lwnTimestamp,
+                             Seq sequence) {
+        if (unlikely(metadata->ctx->isTraceSet(Ctx::TRACE::TRANSACTION)))
+            metadata->ctx->logTrace(Ctx::TRACE::TRANSACTION, "provisional: " + toString(metadata->ctx));
+
+        commitScn = lwnScn;
+        commitTimestamp = lwnTimestamp;
+        commitSequence = sequence;
+        builder->provisional = true;
+        try {
+            flush(metadata, builder, lwnScn);
+        } catch (...) {
+            builder->provisional = false;
+            throw;
+        }
+        builder->provisional = false;
+        streamed = true;
+
+        transactionBuffer->releaseSlab(this);
+        metadata->ctx->swappedMemoryClear(builder->buildThread(), xid);
+        lastTc = nullptr;
+        rollbackIndexDrop();
         deallocChunks.clear();
+        size = 0;
+    }
 
-        if (mergeBuffer != nullptr) {
-            delete[] mergeBuffer;
-            mergeBuffer = nullptr;
-        }
+    void Transaction::purge(Ctx* ctx, TransactionBuffer* transactionBuffer) {
+        transactionBuffer->releaseSlab(this);
+        ctx->swappedMemoryRemove(ctx->parserThread, xid);
+        rollbackIndexDrop();
+        deallocChunks.clear();
 
         lobCtx.purge();
 
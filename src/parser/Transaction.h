@@ -21,11 +21,13 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #define TRANSACTION_H_
 
 #include <map>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
 #include "../common/LobKey.h"
 #include "../common/LobCtx.h"
+#include "../common/OrphanedLobs.h"
 #include "../common/RedoLogRecord.h"
 #include "../common/types/FileOffset.h"
 #include "../common/types/Time.h"
@@ -35,18 +37,34 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 
 namespace OpenLogReplicator {
     class Builder;
+    class DbTable;
     class Metadata;
     class TransactionBuffer;
     struct TransactionChunk;
+    struct TransactionSlabChunk;
     class XmlCtx;
 
     class Transaction final {
+        friend class TransactionBuffer;
+
     protected:
+        static constexpr uint64_t REDO_PIECES{16};
+
         std::vector<uint64_t> deallocChunks;
+        // Pieces of the row being matched by flush(), kept with their capacity for the next rows and transactions
+        std::vector<const RedoLogRecord*> redo1;
+        std::vector<const RedoLogRecord*> redo2;
+        // Records unpacked from the rows being flushed, they stay in place while the pieces of a row are matched
+        std::vector<std::unique_ptr<RedoLogRecord[]>> unpacked;
+        uint64_t unpackedUsed{0};
         uint64_t opCodes{0};
 
+        static typeOp1 rollbackTarget(typeOp1 opCode);
+        RedoLogRecord* unpackedRecord();
+        void rollbackIndexBuild();
+        bool rollbackInPlace(const Ctx* ctx, const RedoLogRecord* redoLogRecord1);
+
     public:
-        uint8_t* mergeBuffer{nullptr};
         LobCtx lobCtx;
         XmlCtx* xmlCtx;
         Xid xid;
@@ -55,6 +73,8 @@ namespace OpenLogReplicator {
         Seq commitSequence;
         Scn commitScn;
         TransactionChunk* lastTc{nullptr};
+        // Set while lastTc is a slab and the transaction has no memory chunks of its own
+        TransactionSlabChunk* slabChunk{nullptr};
         Time commitTimestamp{0};
         bool begin{false};
         bool rollback{false};
@@ -63,20 +83,54 @@ namespace OpenLogReplicator {
         bool shutdown{false};
         bool lastSplit{false};
         bool dump{false};
+        // LOB data may follow the row it belongs to, such a transaction is sent at commit only
+        bool lobData{false};
+        // Set once rows were sent as provisional, the commit or rollback is sent as a marker even with no rows left
+        bool streamed{false};
         typeTransactionSize size{0};
+        // Redo of all objects changed by the transaction, counted only when the redo is profiled
+        uint64_t profileBytes{0};
+        // Redo time of the LWN which started the transaction
+        time_t beginEpoch{0};
+        // Position of the checkpoint the transaction was persisted at, the rows of earlier redo are in the persisted image.
+        // Seq::none() - not persisted
+        Seq persistSequence{Seq::none()};
+        FileOffset persistFileOffset;
+        // Rows changed since the image was written
+        bool persistDirty{false};
+        uint64_t persistAttributes{0};
+        // Rows of the last chunk by object and block, for rollbacks which don't match the last row. Built at the first such rollback
+        // and dropped with the chunk, the rows found are marked as rolled back and left in place
+        std::unordered_map<uint64_t, std::vector<uint32_t>> rollbackIndex;
+        const TransactionChunk* rollbackIndexChunk{nullptr};
+        // Sampled by the tracer, the times of the transaction are exported as spans once it is confirmed
+        bool traced{false};
+        time_ut traceBeginUt{0};
+        time_ut traceCommitUt{0};
+        // Last table checked against the per-table sampling of the tracer
+        const DbTable* traceTable{nullptr};
 
         // Attributes
         std::unordered_map<std::string, std::string> attributes;
 
-        explicit Transaction(Xid newXid, std::map<LobKey, uint8_t*>* newOrphanedLobs, XmlCtx* newXmlCtx);
+        explicit Transaction(Xid newXid, OrphanedLobs* newOrphanedLobs, XmlCtx* newXmlCtx);
+
+        void reset(Xid newXid, XmlCtx* newXmlCtx);
 
         void add(const Metadata* metadata, TransactionBuffer* transactionBuffer, RedoLogRecord* redoLogRecord1);
         void add(const Metadata* metadata, TransactionBuffer* transactionBuffer, RedoLogRecord* redoLogRecord1, const RedoLogRecord* redoLogRecord2);
         void rollbackLastOp(const Metadata* metadata, TransactionBuffer* transactionBuffer, const RedoLogRecord* redoLogRecord1,
                             const RedoLogRecord* redoLogRecord2);
         void rollbackLastOp(const Metadata* metadata, TransactionBuffer* transactionBuffer, const RedoLogRecord* redoLogRecord1);
+        void rollbackIndexAdd(uint32_t offset, const RedoLogRecord* redoLogRecord2);
+        void rollbackIndexRemove(uint32_t offset, const RedoLogRecord* redoLogRecord2);
+        void rollbackIndexDrop() {
+            rollbackIndex.clear();
+            rollbackIndexChunk = nullptr;
+        }
         void flush(Metadata* metadata, Builder* builder, Scn lwnScn);
-        void purge(Ctx* ctx);
+        void stream(Metadata* metadata, Builder* builder, TransactionBuffer* transactionBuffer, Scn lwnScn, Time lwnTimestamp, Seq sequence);
+        void purge(Ctx* ctx, TransactionBuffer* transactionBuffer);
 
         void log(const Ctx* ctx, const char* msg, const RedoLogRecord* redoLogRecord1) const {
             if (likely(!dump && !ctx->isTraceSet(Ctx::TRACE::DUMP)))
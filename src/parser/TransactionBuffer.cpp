@@ -17,15 +17,29 @@ You should have received a copy of the GNU General Public License
 along with OpenLogReplicator; see the file LICENSE;  If not see
 <http://www.gnu.org/licenses/>.  */
 
+#include <algorithm>
+#include <cerrno>
 #include <cstddef>
 #include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
 
+#include "../common/Probes.h"
 #include "../common/RedoLogRecord.h"
 #include "../common/Thread.h"
+#include "../common/Tracer.h"
 #include "../common/exception/RedoLogException.h"
+#include "../common/exception/RuntimeException.h"
+#include "../common/metrics/Metrics.h"
 #include "../common/types/Seq.h"
+#include "../metadata/Metadata.h"
 #include "OpCode0501.h"
 #include "OpCode050B.h"
+#include "RedoProfile.h"
 #include "Transaction.h"
 #include "TransactionBuffer.h"
 
@@ -40,114 +54,150 @@ namespace OpenLogReplicator {
         dumpXidList.clear();
         brokenXidMapList.clear();
 
-        for (const auto& [_, data]: orphanedLobs)
-            delete[] data;
-        orphanedLobs.clear();
+        orphanedLobs.purge();
+
+        for (Transaction* transaction: transactionPool)
+            delete transaction;
+        transactionPool.clear();
+
+        for (TransactionSlabChunk* slabChunk: slabChunks) {
+            ctx->freeMemoryChunk(ctx->parserThread, Ctx::MEMORY::TRANSACTIONS, slabChunk->data);
+            delete slabChunk;
+        }
+        slabChunks.clear();
     }
 
     void TransactionBuffer::purge() {
         for (const auto& [_, transaction]: xidTransactionMap) {
-            transaction->purge(ctx);
-            delete transaction;
+            transaction->purge(ctx, this);
+            releaseTransaction(transaction);
         }
         xidTransactionMap.clear();
+        lastXidTransaction = nullptr;
     }
 
     Transaction* TransactionBuffer::findTransaction(XmlCtx* xmlCtx, Xid xid, typeConId conId, bool old, bool add, bool rollback) {
         const XidMap xidMap = (xid.getData() >> 32) | ((static_cast<uint64_t>(conId)) << 32);
-        Transaction* transaction;
+        Transaction* transaction = lastXidTransaction != nullptr && lastXidMap == xidMap ? lastXidTransaction : xidTransactionMap.find(xidMap);
 
-        auto xidTransactionMapIt = xidTransactionMap.find(xidMap);
-        if (xidTransactionMapIt != xidTransactionMap.end()) {
-            transaction = xidTransactionMapIt->second;
+        if (transaction != nullptr) {
             if (unlikely(!rollback && (!old || transaction->xid != xid)))
                 throw RedoLogException(50039, "transaction " + xid.toString() + " conflicts with " + transaction->xid.toString());
         } else {
             if (!add)
                 return nullptr;
 
-            transaction = new Transaction(xid, &orphanedLobs, xmlCtx);
+            transaction = newTransaction(xid, xmlCtx);
+            transaction->beginEpoch = RuntimeStats::get(ctx->stats.lwnEpoch);
             {
                 ctx->parserThread->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::TRANSACTION_FIND);
                 std::unique_lock<std::mutex> const lck(mtx);
-                xidTransactionMap.insert_or_assign(xidMap, transaction);
+                xidTransactionMap.insert(xidMap, transaction);
             }
             ctx->parserThread->contextSet(Thread::CONTEXT::CPU);
             ctx->swappedMemoryInit(ctx->parserThread, xid);
 
             if (dumpXidList.find(xid) != dumpXidList.end())
                 transaction->dump = true;
+
+            if (unlikely(ctx->tracer != nullptr)) {
+                transaction->traceBeginUt = ctx->clock->getTimeUt();
+                transaction->traced = ctx->tracer->sampled();
+            }
         }
 
+        lastXidMap = xidMap;
+        lastXidTransaction = transaction;
         return transaction;
     }
 
+    // The last row and the place of the next one, read and written when a record of the transaction is appended
+    void TransactionBuffer::prefetchTransaction(Xid xid, typeConId conId) const {
+        const XidMap xidMap = (xid.getData() >> 32) | ((static_cast<uint64_t>(conId)) << 32);
+        if (lastXidTransaction != nullptr && lastXidMap == xidMap)
+            return;
+        const Transaction* transaction = xidTransactionMap.find(xidMap);
+        if (transaction == nullptr || transaction->lastTc == nullptr)
+            return;
+        const TransactionChunk* lastTc = transaction->lastTc;
+        if (lastTc->size >= sizeof(typeChunkSize))
+            __builtin_prefetch(lastTc->buffer + lastTc->size - sizeof(typeChunkSize), 0, 1);
+        __builtin_prefetch(lastTc->buffer + lastTc->size, 1, 1);
+    }
+
     void TransactionBuffer::dropTransaction(Xid xid, typeConId conId) {
         const XidMap xidMap = (xid.getData() >> 32) | (static_cast<uint64_t>(conId) << 32);
+        if (unlikely(!persistPath.empty())) {
+            const Transaction* transaction = xidTransactionMap.find(xidMap);
+            if (transaction != nullptr && transaction->persistSequence != Seq::none())
+                persistRemoved.emplace_back(Scn::none(), persistFileName(transaction->xid, conId));
+        }
         {
             ctx->parserThread->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::TRANSACTION_DROP);
             std::unique_lock<std::mutex> const lck(mtx);
             xidTransactionMap.erase(xidMap);
+            if (lastXidMap == xidMap)
+                lastXidTransaction = nullptr;
         }
         ctx->parserThread->contextSet(Thread::CONTEXT::CPU);
     }
 
-    void TransactionBuffer::addTransactionChunk(Transaction* transaction, RedoLogRecord* redoLogRecord) {
-        const typeChunkSize chunkSize = redoLogRecord->size + ROW_HEADER_TOTAL;
+    Transaction* TransactionBuffer::newTransaction(Xid xid, XmlCtx* xmlCtx) {
+        // xid, pooled transactions available
+        OLR_PROBE2(transaction_begin, xid.getData(), transactionPool.size());
+        if (transactionPool.empty()) {
+            if (ctx->metrics != nullptr)
+                ctx->metrics->emitTransactionPoolMiss(1);
+            return new Transaction(xid, &orphanedLobs, xmlCtx);
+        }
 
-        if (unlikely(chunkSize > TransactionChunk::DATA_BUFFER_SIZE))
-            throw RedoLogException(50040, "block size (" + std::to_string(chunkSize) + ") exceeding max block size (" +
-                                          std::to_string(TransactionChunk::DATA_BUFFER_SIZE) + "), please report this issue");
+        Transaction* transaction = transactionPool.back();
+        transactionPool.pop_back();
+        transaction->reset(xid, xmlCtx);
+        if (ctx->metrics != nullptr)
+            ctx->metrics->emitTransactionPoolHit(1);
+        return transaction;
+    }
 
+    void TransactionBuffer::releaseTransaction(Transaction* transaction) {
+        if (transactionPool.size() >= ctx->transactionPoolSize) {
+            delete transaction;
+            return;
+        }
+        transactionPool.push_back(transaction);
+    }
+
+    void TransactionBuffer::addTransactionChunk(Transaction* transaction, RedoLogRecord* redoLogRecord) {
         if (unlikely(transaction->lastSplit)) {
             if (unlikely((redoLogRecord->flg & OpCode::FLG_MULTIBLOCKUNDOMID) == 0))
                 throw RedoLogException(50041, "bad split offset: " + redoLogRecord->fileOffset.toString() + " xid: " + transaction->xid.toString());
 
             auto* const lastTc = transaction->lastTc;
             auto lastSize = *reinterpret_cast<typeChunkSize*>(lastTc->buffer + lastTc->size - sizeof(typeChunkSize));
-            const auto* const last501 = reinterpret_cast<const RedoLogRecord*>(lastTc->buffer + lastTc->size - lastSize + ROW_HEADER_DATA0);
+            RedoLogRecord last501;
+            RedoLogRecord lastEmpty;
+            unpackRow(lastTc->buffer + lastTc->size - lastSize, &last501, &lastEmpty);
 
-            const uint32_t mergeSize = last501->size + redoLogRecord->size;
-            transaction->mergeBuffer = new uint8_t[mergeSize];
-            mergeBlocks(transaction->mergeBuffer, redoLogRecord, last501);
+            RecordFragments fragments;
+            mergeBlocks(fragments, redoLogRecord, &last501);
+
+            // The merged row takes the place of the last one. It is gathered straight from the pieces when the chunk stays the last one
+            // of the transaction, otherwise the pieces in the row could be released or swapped out before they are copied
+            const bool inPlace = transaction->slabChunk == nullptr && lastTc->elements > 1 &&
+                                 lastTc->size - lastSize + ROW_HEADER_TOTAL + redoLogRecord->size <= TransactionChunk::DATA_BUFFER_SIZE;
+            if (!inPlace)
+                mergeFlatten(fragments, redoLogRecord);
             rollbackTransactionChunk(transaction);
+            transaction->lastSplit = (redoLogRecord->flg & (OpCode::FLG_MULTIBLOCKUNDOTAIL | OpCode::FLG_MULTIBLOCKUNDOMID)) != 0;
+            appendRow(transaction, redoLogRecord->opCode << 16, redoLogRecord, nullptr, inPlace ? &fragments : nullptr);
+            return;
         }
         transaction->lastSplit = (redoLogRecord->flg & (OpCode::FLG_MULTIBLOCKUNDOTAIL | OpCode::FLG_MULTIBLOCKUNDOMID)) != 0;
 
-        // New block
-        if (transaction->lastTc == nullptr || transaction->lastTc->size + chunkSize > TransactionChunk::DATA_BUFFER_SIZE)
-            transaction->lastTc = reinterpret_cast<TransactionChunk*>(ctx->swappedMemoryGrow(ctx->parserThread, transaction->xid));
-
-        // Append to the chunk at the end
-        auto* lastTc = transaction->lastTc;
-        *reinterpret_cast<typeOp2*>(lastTc->buffer + lastTc->size + ROW_HEADER_OP) = redoLogRecord->opCode << 16;
-        auto* redoLogRecordTarget1 = reinterpret_cast<RedoLogRecord*>(lastTc->buffer + lastTc->size + ROW_HEADER_DATA0);
-        memcpy(reinterpret_cast<void*>(redoLogRecordTarget1),
-               reinterpret_cast<const void*>(redoLogRecord), sizeof(RedoLogRecord));
-        redoLogRecordTarget1->dataExt = nullptr;
-        memcpy(reinterpret_cast<void*>(lastTc->buffer + lastTc->size + ROW_HEADER_DATA1),
-               reinterpret_cast<const void*>(redoLogRecord->data()), redoLogRecord->size);
-        memset(reinterpret_cast<void*>(lastTc->buffer + lastTc->size + ROW_HEADER_DATA1 + redoLogRecord->size), 0, sizeof(RedoLogRecord));
-
-        *reinterpret_cast<typeChunkSize*>(lastTc->buffer + lastTc->size + ROW_HEADER_DATA2 + redoLogRecord->size) = chunkSize;
-
-        lastTc->size += chunkSize;
-        ++lastTc->elements;
-        transaction->size += chunkSize;
-
-        if (transaction->mergeBuffer != nullptr) {
-            delete[] transaction->mergeBuffer;
-            transaction->mergeBuffer = nullptr;
-        }
+        appendRow(transaction, redoLogRecord->opCode << 16, redoLogRecord, nullptr);
     }
 
     void TransactionBuffer::addTransactionChunk(Transaction* transaction, RedoLogRecord* redoLogRecord1, const RedoLogRecord* redoLogRecord2) {
-        typeChunkSize chunkSize = redoLogRecord1->size + redoLogRecord2->size + ROW_HEADER_TOTAL;
-
-        if (unlikely(chunkSize > TransactionChunk::DATA_BUFFER_SIZE))
-            throw RedoLogException(50040, "block size (" + std::to_string(chunkSize) + ") exceeding max block size (" +
-                                          std::to_string(TransactionChunk::DATA_BUFFER_SIZE) + "), please report this issue");
-
         if (unlikely(transaction->lastSplit)) {
             if (unlikely((redoLogRecord1->opCode) != 0x0501))
                 throw RedoLogException(50042, "split undo HEAD on 5.1 offset: " + redoLogRecord1->fileOffset.toString());
@@ -158,66 +208,277 @@ namespace OpenLogReplicator {
 
             auto* const lastTc = transaction->lastTc;
             const auto lastSize = *reinterpret_cast<typeChunkSize*>(lastTc->buffer + lastTc->size - sizeof(typeChunkSize));
-            const auto* last501 = reinterpret_cast<const RedoLogRecord*>(lastTc->buffer + lastTc->size - lastSize + ROW_HEADER_DATA0);
+            RedoLogRecord last501;
+            RedoLogRecord lastEmpty;
+            unpackRow(lastTc->buffer + lastTc->size - lastSize, &last501, &lastEmpty);
 
-            const uint32_t mergeSize = last501->size + redoLogRecord1->size;
-            transaction->mergeBuffer = new uint8_t[mergeSize];
-            mergeBlocks(transaction->mergeBuffer, redoLogRecord1, last501);
+            // The 5.1 is decoded again from the merged data, which needs to be flat
+            RecordFragments fragments;
+            mergeBlocks(fragments, redoLogRecord1, &last501);
+            mergeFlatten(fragments, redoLogRecord1);
 
             typePos fieldPos = redoLogRecord1->fieldPos;
             typeSize const fieldSize = ctx->read16(redoLogRecord1->data(redoLogRecord1->fieldSizesDelta + (1 * 2)));
             fieldPos += (fieldSize + 3) & 0xFFFC;
 
             ctx->write16(const_cast<uint8_t*>(redoLogRecord1->data(fieldPos + 20)), redoLogRecord1->flg);
-            OpCode0501::process0501(ctx, redoLogRecord1);
-            chunkSize = redoLogRecord1->size + redoLogRecord2->size + ROW_HEADER_TOTAL;
+            opCodeModeCall(ctx, [&](auto mode) {
+                OpCode0501::process0501<decltype(mode)>(ctx, redoLogRecord1);
+            });
 
             rollbackTransactionChunk(transaction);
             transaction->lastSplit = false;
         }
 
-        // New block
-        if (transaction->lastTc == nullptr || transaction->lastTc->size + chunkSize > TransactionChunk::DATA_BUFFER_SIZE)
-            transaction->lastTc = reinterpret_cast<TransactionChunk*>(ctx->swappedMemoryGrow(ctx->parserThread, transaction->xid));
+        const uint32_t offset = appendRow(transaction, (redoLogRecord1->opCode << 16) | redoLogRecord2->opCode, redoLogRecord1, redoLogRecord2);
+        if (transaction->rollbackIndexChunk == transaction->lastTc)
+            transaction->rollbackIndexAdd(offset, redoLogRecord2);
+    }
 
-        // Append to the chunk at the end
-        auto* lastTc = transaction->lastTc;
-        *reinterpret_cast<typeOp2*>(lastTc->buffer + lastTc->size + ROW_HEADER_OP) = (redoLogRecord1->opCode << 16) | redoLogRecord2->opCode;
+    // Appends the row at the end of the last chunk, returns its offset in the chunk. The vector data of the first record is gathered from
+    // the fragments when they are given, before anything else of the row is written
+    uint32_t TransactionBuffer::appendRow(Transaction* transaction, typeOp2 op, const RedoLogRecord* redoLogRecord1, const RedoLogRecord* redoLogRecord2,
+                                          const RecordFragments* fragments1) {
+        const uint32_t packed1 = packRecord(rowHeaders, redoLogRecord1);
+        const uint32_t packed2 = (redoLogRecord2 != nullptr) ? packRecord(rowHeaders + packed1, redoLogRecord2) : 0;
+        const uint32_t size2 = (redoLogRecord2 != nullptr) ? redoLogRecord2->size : 0;
+        const uint32_t dataOffset = ROW_HEADER_RECORDS + ((packed1 + packed2 + 3) & 0xFFFFFFFC);
+        const typeChunkSize chunkSize = dataOffset + redoLogRecord1->size + size2 + sizeof(typeChunkSize);
 
-        auto* redoLogRecordTarget1 = reinterpret_cast<RedoLogRecord*>(lastTc->buffer + lastTc->size + ROW_HEADER_DATA0);
-        memcpy(reinterpret_cast<void*>(redoLogRecordTarget1),
-               reinterpret_cast<const void*>(redoLogRecord1), sizeof(RedoLogRecord));
-        redoLogRecordTarget1->dataExt = nullptr;
-        memcpy(reinterpret_cast<void*>(lastTc->buffer + lastTc->size + ROW_HEADER_DATA1),
-               reinterpret_cast<const void*>(redoLogRecord1->data()), redoLogRecord1->size);
+        if (unlikely(chunkSize > TransactionChunk::DATA_BUFFER_SIZE))
+            throw RedoLogException(50040, "block size (" + std::to_string(chunkSize) + ") exceeding max block size (" +
+                                          std::to_string(TransactionChunk::DATA_BUFFER_SIZE) + "), please report this issue");
 
-        auto* redoLogRecordTarget2 = reinterpret_cast<RedoLogRecord*>(lastTc->buffer + lastTc->size + ROW_HEADER_DATA1 + redoLogRecord1->size);
-        memcpy(reinterpret_cast<void*>(redoLogRecordTarget2),
-               reinterpret_cast<const void*>(redoLogRecord2), sizeof(RedoLogRecord));
-        redoLogRecordTarget2->dataExt = nullptr;
-        memcpy(reinterpret_cast<void*>(lastTc->buffer + lastTc->size + ROW_HEADER_DATA2 + redoLogRecord1->size),
-               reinterpret_cast<const void*>(redoLogRecord2->data()), redoLogRecord2->size);
-        *reinterpret_cast<typeChunkSize*>(lastTc->buffer + lastTc->size + ROW_HEADER_DATA2 + redoLogRecord1->size + redoLogRecord2->size) = chunkSize;
+        newTransactionChunk(transaction, chunkSize);
+
+        // Append to the chunk at the end
+        auto* lastTc = transaction->lastTc;
+        const uint32_t offset = lastTc->size;
+        uint8_t* row = lastTc->buffer + offset;
+        if (fragments1 != nullptr)
+            fragments1->gather(row + dataOffset);
+        else
+            memcpy(reinterpret_cast<void*>(row + dataOffset), reinterpret_cast<const void*>(redoLogRecord1->data()), redoLogRecord1->size);
+        *reinterpret_cast<typeOp2*>(row + ROW_HEADER_OP) = op;
+        *reinterpret_cast<uint32_t*>(row + ROW_HEADER_SIZE1) = redoLogRecord1->size;
+        *reinterpret_cast<uint32_t*>(row + ROW_HEADER_SIZE2) = size2;
+        *reinterpret_cast<uint16_t*>(row + ROW_HEADER_PACKED1) = static_cast<uint16_t>(packed1);
+        *reinterpret_cast<uint16_t*>(row + ROW_HEADER_PACKED2) = static_cast<uint16_t>(packed2);
+        memcpy(reinterpret_cast<void*>(row + ROW_HEADER_RECORDS), reinterpret_cast<const void*>(rowHeaders), packed1 + packed2);
+        if (size2 > 0)
+            memcpy(reinterpret_cast<void*>(row + dataOffset + redoLogRecord1->size), reinterpret_cast<const void*>(redoLogRecord2->data()), size2);
+        *reinterpret_cast<typeChunkSize*>(row + chunkSize - sizeof(typeChunkSize)) = chunkSize;
 
         lastTc->size += chunkSize;
         ++lastTc->elements;
         transaction->size += chunkSize;
+        return offset;
+    }
 
-        if (transaction->mergeBuffer != nullptr) {
-            delete[] transaction->mergeBuffer;
-            transaction->mergeBuffer = nullptr;
+    // Fields of a record kept in the compact header, RECORD_FIELDS of them. Left out are the size, which is in the fixed part of the row,
+    // and the fields only the parser uses: the position of the vector in the redo log and the object taken from the undo
+    template<typename Record, typename Visitor>
+    static void recordFields(Record* redoLogRecord, Visitor visitor) {
+        visitor(redoLogRecord->fileOffset);
+        visitor(redoLogRecord->xid);
+        visitor(redoLogRecord->scnRecord);
+        visitor(redoLogRecord->scn);
+        visitor(redoLogRecord->subScn);
+        visitor(redoLogRecord->conId);
+        visitor(redoLogRecord->dba);
+        visitor(redoLogRecord->bdba);
+        visitor(redoLogRecord->obj);
+        visitor(redoLogRecord->dataObj);
+        visitor(redoLogRecord->col);
+        visitor(redoLogRecord->fieldCnt);
+        visitor(redoLogRecord->fieldPos);
+        visitor(redoLogRecord->rowData);
+        visitor(redoLogRecord->slotsDelta);
+        visitor(redoLogRecord->rowSizesDelta);
+        visitor(redoLogRecord->fieldSizesDelta);
+        visitor(redoLogRecord->nullsDelta);
+        visitor(redoLogRecord->colNumsDelta);
+        visitor(redoLogRecord->nRow);
+        visitor(redoLogRecord->flg);
+        visitor(redoLogRecord->opCode);
+        visitor(redoLogRecord->opc);
+        visitor(redoLogRecord->slot);
+        visitor(redoLogRecord->sizeDelt);
+        visitor(redoLogRecord->op);
+        visitor(redoLogRecord->ccData);
+        visitor(redoLogRecord->cc);
+        visitor(redoLogRecord->flags);
+        visitor(redoLogRecord->fb);
+        visitor(redoLogRecord->suppLogFb);
+        visitor(redoLogRecord->suppLogCC);
+        visitor(redoLogRecord->suppLogBefore);
+        visitor(redoLogRecord->suppLogAfter);
+        visitor(redoLogRecord->suppLogSlot);
+        visitor(redoLogRecord->suppLogBdba);
+        visitor(redoLogRecord->suppLogRowData);
+        visitor(redoLogRecord->suppLogNumsDelta);
+        visitor(redoLogRecord->suppLogLenDelta);
+        visitor(redoLogRecord->usn);
+        visitor(redoLogRecord->slt);
+        visitor(redoLogRecord->dba0);
+        visitor(redoLogRecord->dba1);
+        visitor(redoLogRecord->dba2);
+        visitor(redoLogRecord->dba3);
+        visitor(redoLogRecord->lobPageNo);
+        visitor(redoLogRecord->lobPageSize);
+        visitor(redoLogRecord->lobSizePages);
+        visitor(redoLogRecord->lobOffset);
+        visitor(redoLogRecord->lobData);
+        visitor(redoLogRecord->indKey);
+        visitor(redoLogRecord->indKeyData);
+        visitor(redoLogRecord->lobSizeRest);
+        visitor(redoLogRecord->lobDataSize);
+        visitor(redoLogRecord->indKeySize);
+        visitor(redoLogRecord->indKeyDataSize);
+        visitor(redoLogRecord->indKeyDataCode);
+        visitor(redoLogRecord->lobId);
+        visitor(redoLogRecord->compressed);
+    }
+
+    static void varintPut(uint8_t*& out, uint64_t value) {
+        while (value >= 0x80) {
+            *out++ = static_cast<uint8_t>(value) | 0x80;
+            value >>= 7;
+        }
+        *out++ = static_cast<uint8_t>(value);
+    }
+
+    static uint64_t varintGet(const uint8_t*& in) {
+        uint64_t value = 0;
+        for (uint shift = 0; ; shift += 7) {
+            const uint8_t byte = *in++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                return value;
         }
     }
 
+    template<typename T>
+    static bool fieldPut(uint8_t*& out, T value) {
+        const uint64_t raw = static_cast<std::make_unsigned_t<T>>(value);
+        if (raw == 0)
+            return false;
+        varintPut(out, raw);
+        return true;
+    }
+
+    static bool fieldPut(uint8_t*& out __attribute__((unused)), bool value) {
+        return value;
+    }
+
+    static bool fieldPut(uint8_t*& out, Scn value) {
+        return fieldPut(out, value.getData());
+    }
+
+    static bool fieldPut(uint8_t*& out, Xid value) {
+        return fieldPut(out, value.getData());
+    }
+
+    static bool fieldPut(uint8_t*& out, FileOffset value) {
+        return fieldPut(out, value.getData());
+    }
+
+    static bool fieldPut(uint8_t*& out, const LobId& value) {
+        bool present = false;
+        for (uint64_t i = 0; i < LobId::LENGTH; ++i)
+            present = present || value.data[i] != 0;
+        if (!present)
+            return false;
+        memcpy(reinterpret_cast<void*>(out), reinterpret_cast<const void*>(value.data), LobId::LENGTH);
+        out += LobId::LENGTH;
+        return true;
+    }
+
+    template<typename T>
+    static void fieldGet(const uint8_t*& in, T& value) {
+        value = static_cast<T>(static_cast<std::make_unsigned_t<T>>(varintGet(in)));
+    }
+
+    static void fieldGet(const uint8_t*& in __attribute__((unused)), bool& value) {
+        value = true;
+    }
+
+    static void fieldGet(const uint8_t*& in, Scn& value) {
+        value = Scn(varintGet(in));
+    }
+
+    static void fieldGet(const uint8_t*& in, Xid& value) {
+        value = Xid(varintGet(in));
+    }
+
+    static void fieldGet(const uint8_t*& in, FileOffset& value) {
+        value = FileOffset(varintGet(in));
+    }
+
+    static void fieldGet(const uint8_t*& in, LobId& value) {
+        memcpy(reinterpret_cast<void*>(value.data), reinterpret_cast<const void*>(in), LobId::LENGTH);
+        in += LobId::LENGTH;
+    }
+
+    uint32_t TransactionBuffer::packRecord(uint8_t* out, const RedoLogRecord* redoLogRecord) {
+        uint8_t* pos = out + sizeof(uint64_t);
+        uint64_t present = 0;
+        uint64_t bit = 1;
+        recordFields(redoLogRecord, [&](const auto& value) {
+            if (fieldPut(pos, value))
+                present |= bit;
+            bit <<= 1;
+        });
+        memcpy(reinterpret_cast<void*>(out), reinterpret_cast<const void*>(&present), sizeof(uint64_t));
+        return static_cast<uint32_t>(pos - out);
+    }
+
+    void TransactionBuffer::unpackRecord(const uint8_t* in, uint32_t size, RedoLogRecord* redoLogRecord) {
+        memset(reinterpret_cast<void*>(redoLogRecord), 0, sizeof(RedoLogRecord));
+        redoLogRecord->size = size;
+        if (in == nullptr)
+            return;
+
+        uint64_t present;
+        memcpy(reinterpret_cast<void*>(&present), reinterpret_cast<const void*>(in), sizeof(uint64_t));
+        in += sizeof(uint64_t);
+        uint64_t bit = 1;
+        recordFields(redoLogRecord, [&](auto& value) {
+            if ((present & bit) != 0)
+                fieldGet(in, value);
+            bit <<= 1;
+        });
+    }
+
+    // Both records point to their vector data in the row
+    void TransactionBuffer::unpackRow(const uint8_t* row, RedoLogRecord* redoLogRecord1, RedoLogRecord* redoLogRecord2) {
+        const uint16_t packed1 = *reinterpret_cast<const uint16_t*>(row + ROW_HEADER_PACKED1);
+        const uint16_t packed2 = *reinterpret_cast<const uint16_t*>(row + ROW_HEADER_PACKED2);
+        const uint32_t size1 = *reinterpret_cast<const uint32_t*>(row + ROW_HEADER_SIZE1);
+        auto* data = const_cast<uint8_t*>(row) + rowDataOffset(row);
+
+        unpackRecord(row + ROW_HEADER_RECORDS, size1, redoLogRecord1);
+        redoLogRecord1->dataExt = data;
+        unpackRecord(packed2 > 0 ? row + ROW_HEADER_RECORDS + packed1 : nullptr, *reinterpret_cast<const uint32_t*>(row + ROW_HEADER_SIZE2),
+                     redoLogRecord2);
+        redoLogRecord2->dataExt = data + size1;
+    }
+
     void TransactionBuffer::rollbackTransactionChunk(Transaction* transaction) {
         auto* lastTc = transaction->lastTc;
         if (unlikely(lastTc == nullptr))
             throw RedoLogException(50044, "trying to remove from empty buffer size: <null> elements: <null>");
-        if (unlikely(lastTc->size < ROW_HEADER_TOTAL || lastTc->elements == 0))
+        if (unlikely(lastTc->size < ROW_HEADER_MIN || lastTc->elements == 0))
             throw RedoLogException(50044, "trying to remove from empty buffer size: " + std::to_string(lastTc->size) +
                                           " elements: " + std::to_string(lastTc->elements));
 
         typeChunkSize const chunkSize = *reinterpret_cast<typeChunkSize*>(lastTc->buffer + lastTc->size - sizeof(typeChunkSize));
+        if (transaction->rollbackIndexChunk == lastTc) {
+            RedoLogRecord redoLogRecord1;
+            RedoLogRecord redoLogRecord2;
+            unpackRow(lastTc->buffer + lastTc->size - chunkSize, &redoLogRecord1, &redoLogRecord2);
+            transaction->rollbackIndexRemove(lastTc->size - chunkSize, &redoLogRecord2);
+        }
         lastTc->size -= chunkSize;
         --lastTc->elements;
         transaction->size -= chunkSize;
@@ -225,17 +486,90 @@ namespace OpenLogReplicator {
         if (likely(lastTc->elements > 0))
             return;
 
+        transaction->rollbackIndexDrop();
+
+        if (transaction->slabChunk != nullptr) {
+            releaseSlab(transaction);
+            return;
+        }
         transaction->lastTc = reinterpret_cast<TransactionChunk*>(ctx->swappedMemoryShrink(ctx->parserThread, transaction->xid));
     }
 
-    void TransactionBuffer::mergeBlocks(uint8_t* mergeBuffer, RedoLogRecord* redoLogRecord1, const RedoLogRecord* redoLogRecord2) {
-        memcpy(reinterpret_cast<void*>(mergeBuffer),
-               reinterpret_cast<const void*>(redoLogRecord1->data()), redoLogRecord1->fieldSizesDelta);
-        typePos pos = redoLogRecord1->fieldSizesDelta;
-        typeField fieldCnt;
-        typePos fieldPos1;
-        typePos fieldPos2;
+    void TransactionBuffer::newTransactionChunk(Transaction* transaction, typeChunkSize chunkSize) {
+        // The first data of a transaction goes to a slab, a dedicated memory chunk is taken only when it does not fit any more
+        if (transaction->lastTc == nullptr) {
+            if (chunkSize <= SLAB_DATA_SIZE)
+                allocateSlab(transaction);
+            else
+                transaction->lastTc = reinterpret_cast<TransactionChunk*>(ctx->swappedMemoryGrow(ctx->parserThread, transaction->xid));
+            return;
+        }
+
+        if (transaction->slabChunk != nullptr) {
+            if (transaction->lastTc->size + chunkSize <= SLAB_DATA_SIZE)
+                return;
+            transaction->rollbackIndexDrop();
+            promoteSlab(transaction);
+        }
+
+        if (transaction->lastTc->size + chunkSize > TransactionChunk::DATA_BUFFER_SIZE) {
+            transaction->rollbackIndexDrop();
+            transaction->lastTc = reinterpret_cast<TransactionChunk*>(ctx->swappedMemoryGrow(ctx->parserThread, transaction->xid));
+        }
+    }
+
+    void TransactionBuffer::allocateSlab(Transaction* transaction) {
+        if (slabChunks.empty()) {
+            auto* slabChunk = new TransactionSlabChunk();
+            slabChunk->data = ctx->getMemoryChunk(ctx->parserThread, Ctx::MEMORY::TRANSACTIONS);
+            slabChunk->freeSlabs.reserve(SLABS_PER_CHUNK);
+            for (uint32_t i = SLABS_PER_CHUNK; i > 0; --i)
+                slabChunk->freeSlabs.push_back(slabChunk->data + static_cast<uint64_t>(i - 1) * SLAB_SIZE);
+            slabChunks.push_back(slabChunk);
+        }
+
+        TransactionSlabChunk* slabChunk = slabChunks.back();
+        uint8_t* slab = slabChunk->freeSlabs.back();
+        slabChunk->freeSlabs.pop_back();
+        if (slabChunk->freeSlabs.empty())
+            slabChunks.pop_back();
+
+        memset(slab, 0, TransactionChunk::HEADER_BUFFER_SIZE);
+        transaction->lastTc = reinterpret_cast<TransactionChunk*>(slab);
+        transaction->slabChunk = slabChunk;
+    }
+
+    void TransactionBuffer::promoteSlab(Transaction* transaction) {
+        auto* tc = reinterpret_cast<TransactionChunk*>(ctx->swappedMemoryGrow(ctx->parserThread, transaction->xid));
+        memcpy(reinterpret_cast<void*>(tc), reinterpret_cast<const void*>(transaction->lastTc),
+               TransactionChunk::HEADER_BUFFER_SIZE + transaction->lastTc->size);
+        releaseSlab(transaction);
+        transaction->lastTc = tc;
+    }
+
+    void TransactionBuffer::releaseSlab(Transaction* transaction) {
+        TransactionSlabChunk* slabChunk = transaction->slabChunk;
+        if (slabChunk == nullptr)
+            return;
+
+        slabChunk->freeSlabs.push_back(reinterpret_cast<uint8_t*>(transaction->lastTc));
+        transaction->lastTc = nullptr;
+        transaction->slabChunk = nullptr;
+
+        if (slabChunk->freeSlabs.size() == 1)
+            slabChunks.push_back(slabChunk);
+
+        // Keep one slab chunk, return the other empty ones to the pool
+        if (slabChunk->freeSlabs.size() == SLABS_PER_CHUNK && slabChunks.size() > 1) {
+            slabChunks.erase(std::find(slabChunks.begin(), slabChunks.end(), slabChunk));
+            ctx->freeMemoryChunk(ctx->parserThread, Ctx::MEMORY::TRANSACTIONS, slabChunk->data);
+            delete slabChunk;
+        }
+    }
 
+    // Head of the first record, the joined field lists, the fields of the first record and the fields of the second one past the two
+    // leading ones, each padded to 4 bytes as in a flat record
+    void TransactionBuffer::mergeBlocks(RecordFragments& fragments, RedoLogRecord* redoLogRecord1, const RedoLogRecord* redoLogRecord2) {
         if ((redoLogRecord1->flg & OpCode::FLG_LASTBUFFERSPLIT) != 0) {
             redoLogRecord1->flg &= ~OpCode::FLG_LASTBUFFERSPLIT;
             const typeSize size1 = ctx->read16(redoLogRecord1->data(redoLogRecord1->fieldSizesDelta + (redoLogRecord1->fieldCnt * 2)));
@@ -244,49 +578,425 @@ namespace OpenLogReplicator {
             --redoLogRecord1->fieldCnt;
         }
 
+        fragments.add(redoLogRecord1->data(), redoLogRecord1->fieldSizesDelta, redoLogRecord1->fieldSizesDelta);
+
         // Field list
-        fieldCnt = redoLogRecord1->fieldCnt + redoLogRecord2->fieldCnt - 2;
-        ctx->write16(mergeBuffer + pos, fieldCnt);
-        memcpy(reinterpret_cast<void*>(mergeBuffer + pos + 2),
+        const typeField fieldCnt = redoLogRecord1->fieldCnt + redoLogRecord2->fieldCnt - 2;
+        const uint32_t fieldsSize = ((static_cast<uint32_t>(fieldCnt) + 1) * 2 + 2) & 0xFFFFFFFC;
+        if (mergeFields.size() < fieldsSize)
+            mergeFields.resize(fieldsSize);
+        ctx->write16(mergeFields.data(), fieldCnt);
+        memcpy(reinterpret_cast<void*>(mergeFields.data() + 2),
                reinterpret_cast<const void*>(redoLogRecord1->data(redoLogRecord1->fieldSizesDelta + 2)), static_cast<size_t>(redoLogRecord1->fieldCnt * 2));
-        memcpy(reinterpret_cast<void*>(mergeBuffer + pos + 2 + static_cast<ptrdiff_t>(redoLogRecord1->fieldCnt * 2)),
+        memcpy(reinterpret_cast<void*>(mergeFields.data() + 2 + static_cast<ptrdiff_t>(redoLogRecord1->fieldCnt * 2)),
                reinterpret_cast<const void*>(redoLogRecord2->data(redoLogRecord2->fieldSizesDelta + 6)), (redoLogRecord2->fieldCnt * 2) - 4);
-        pos += (((fieldCnt + 1) * 2) + 2) & (0xFFFC);
-        fieldPos1 = pos;
-
-        memcpy(reinterpret_cast<void*>(mergeBuffer + pos),
-               reinterpret_cast<const void*>(redoLogRecord1->data(redoLogRecord1->fieldPos)), redoLogRecord1->size - redoLogRecord1->fieldPos);
-        pos += (redoLogRecord1->size - redoLogRecord1->fieldPos + 3) & (0xFFFC);
-        fieldPos2 = redoLogRecord2->fieldPos +
-                    ((ctx->read16(redoLogRecord2->data(redoLogRecord2->fieldSizesDelta + 2)) + 3) & 0xFFFC) +
-                    ((ctx->read16(redoLogRecord2->data(redoLogRecord2->fieldSizesDelta + 4)) + 3) & 0xFFFC);
+        fragments.add(mergeFields.data(), (static_cast<uint32_t>(fieldCnt) + 1) * 2, fieldsSize);
+        const typePos fieldPos1 = redoLogRecord1->fieldSizesDelta + fieldsSize;
 
-        memcpy(reinterpret_cast<void*>(mergeBuffer + pos),
-               reinterpret_cast<const void*>(redoLogRecord2->data(fieldPos2)), redoLogRecord2->size - fieldPos2);
-        pos += (redoLogRecord2->size - fieldPos2 + 3) & (0xFFFC);
+        const uint32_t data1 = redoLogRecord1->size - redoLogRecord1->fieldPos;
+        fragments.add(redoLogRecord1->data(redoLogRecord1->fieldPos), data1, (data1 + 3) & 0xFFFFFFFC);
+        const typePos fieldPos2 = redoLogRecord2->fieldPos +
+                                  ((ctx->read16(redoLogRecord2->data(redoLogRecord2->fieldSizesDelta + 2)) + 3) & 0xFFFC) +
+                                  ((ctx->read16(redoLogRecord2->data(redoLogRecord2->fieldSizesDelta + 4)) + 3) & 0xFFFC);
+        const uint32_t data2 = redoLogRecord2->size - fieldPos2;
+        fragments.add(redoLogRecord2->data(fieldPos2), data2, (data2 + 3) & 0xFFFFFFFC);
 
-        redoLogRecord1->size = pos;
+        redoLogRecord1->size = fragments.size;
         redoLogRecord1->fieldCnt = fieldCnt;
         redoLogRecord1->fieldPos = fieldPos1;
-        redoLogRecord1->dataExt = mergeBuffer;
         redoLogRecord1->flg |= redoLogRecord2->flg;
         if ((redoLogRecord1->flg & OpCode::FLG_MULTIBLOCKUNDOTAIL) != 0)
             redoLogRecord1->flg &= ~(OpCode::FLG_MULTIBLOCKUNDOHEAD | OpCode::FLG_MULTIBLOCKUNDOMID | OpCode::FLG_MULTIBLOCKUNDOTAIL);
     }
 
+    // Reused for every merge, the merged record is valid until the next one
+    void TransactionBuffer::mergeFlatten(const RecordFragments& fragments, RedoLogRecord* redoLogRecord) {
+        if (mergeBuffer.size() < fragments.size)
+            mergeBuffer.resize(fragments.size);
+        fragments.gather(mergeBuffer.data());
+        redoLogRecord->dataExt = mergeBuffer.data();
+    }
+
+    // A persisted transaction needs the redo from the position of its image only, also when it has changed since: the image and
+    // the redo after it give the whole transaction
     void TransactionBuffer::checkpoint(Seq& minSequence, FileOffset& minFileOffset, Xid& minXid) {
         for (const auto& [_, transaction] : xidTransactionMap) {
-            if (transaction->firstSequence < minSequence) {
-                minSequence = transaction->firstSequence;
-                minFileOffset = transaction->firstFileOffset;
+            Seq firstSequence = transaction->firstSequence;
+            FileOffset firstFileOffset = transaction->firstFileOffset;
+            if (transaction->persistSequence != Seq::none()) {
+                firstSequence = transaction->persistSequence;
+                firstFileOffset = transaction->persistFileOffset;
+            }
+
+            if (firstSequence < minSequence) {
+                minSequence = firstSequence;
+                minFileOffset = firstFileOffset;
                 minXid = transaction->xid;
-            } else if (transaction->firstSequence == minSequence && transaction->firstFileOffset < minFileOffset) {
-                minFileOffset = transaction->firstFileOffset;
+            } else if (firstSequence == minSequence && firstFileOffset < minFileOffset) {
+                minFileOffset = firstFileOffset;
                 minXid = transaction->xid;
             }
         }
     }
 
+    std::string TransactionBuffer::persistFileName(Xid xid, typeConId conId) const {
+        return persistPath + "/" + persistPrefix + "-" + xid.toString() + "-" + std::to_string(conId) + PERSIST_SUFFIX;
+    }
+
+    // Only the rows are in the image, transactions with state kept elsewhere are replayed from their beginning
+    bool TransactionBuffer::persistEligible(const Transaction* transaction, time_t lwnEpoch) const {
+        return !transaction->system && !transaction->schema && !transaction->lastSplit && !transaction->lobData && !transaction->streamed &&
+               !transaction->dump && !transaction->shutdown &&
+               lwnEpoch - transaction->beginEpoch >= static_cast<time_t>(ctx->transactionPersistS);
+    }
+
+    static void persistWriteAll(int fd, const void* data, uint64_t length, const std::string& fileName) {
+        uint64_t written = 0;
+        while (written < length) {
+            const ssize_t bytes = ::write(fd, reinterpret_cast<const uint8_t*>(data) + written, length - written);
+            if (bytes < 0) {
+                if (errno == EINTR)
+                    continue;
+                const int err = errno;
+                close(fd);
+                throw RuntimeException(10007, "file: " + fileName + " - " + std::to_string(written) + " bytes written instead of " +
+                                              std::to_string(length) + ", code returned: " + strerror(err));
+            }
+            written += bytes;
+        }
+    }
+
+    template<typename T>
+    static void persistPut(std::string& out, T value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    // Run by the parser thread at a checkpoint, at most once per checkpoint interval. The image of a transaction open long enough
+    // is written with the position of the checkpoint, restart reads the redo of the transaction from there and not from its beginning
+    void TransactionBuffer::persist(Metadata* metadata, Scn lwnScn, Seq sequence, FileOffset fileOffset) {
+        const time_t lwnEpoch = RuntimeStats::get(ctx->stats.lwnEpoch);
+        if (lwnEpoch < persistEpoch + static_cast<time_t>(ctx->checkpointIntervalS))
+            return;
+        persistEpoch = lwnEpoch;
+
+        // Restart from a checkpoint written after the transaction was dropped doesn't need the image
+        const Scn lastCheckpointScn = metadata->getLastCheckpointScn(ctx->parserThread);
+        if (lastCheckpointScn != Scn::none()) {
+            persistRemoved.erase(std::remove_if(persistRemoved.begin(), persistRemoved.end(), [&](const std::pair<Scn, std::string>& removed) {
+                if (removed.first == Scn::none() || !(removed.first < lastCheckpointScn))
+                    return false;
+                if (unlink(removed.second.c_str()) != 0 && errno != ENOENT)
+                    ctx->error(10010, "file: " + removed.second + " - delete returned: " + strerror(errno));
+                return true;
+            }), persistRemoved.end());
+        }
+        for (auto& removed: persistRemoved)
+            if (removed.first == Scn::none())
+                removed.first = lwnScn;
+
+        bool written = false;
+        for (const auto& [xidMap, transaction] : xidTransactionMap) {
+            const auto conId = static_cast<typeConId>(xidMap >> 32);
+            if (transaction->persistSequence != Seq::none() && !transaction->persistDirty &&
+                transaction->persistAttributes == transaction->attributes.size()) {
+                persistUpdate(transaction, conId, sequence, fileOffset);
+                continue;
+            }
+
+            if (!persistEligible(transaction, lwnEpoch))
+                continue;
+            persistWrite(transaction, conId, sequence, fileOffset);
+            written = true;
+        }
+
+        if (!written)
+            return;
+        const int fd = open(persistPath.c_str(), O_RDONLY | O_DIRECTORY);
+        if (fd == -1)
+            throw RuntimeException(10012, "directory: " + persistPath + " - can't read");
+        if (fsync(fd) != 0) {
+            const int err = errno;
+            close(fd);
+            throw RuntimeException(10075, "directory: " + persistPath + " - fsync returned: " + strerror(err));
+        }
+        close(fd);
+    }
+
+    // Written to a temporary file and renamed over, a crash leaves the old or the new image. A transaction with chunks swapped
+    // out is not read back, it stays at its old position until the next checkpoint
+    void TransactionBuffer::persistWrite(Transaction* transaction, typeConId conId, Seq sequence, FileOffset fileOffset) {
+        std::vector<uint8_t*> tcs;
+        const bool inSlab = transaction->slabChunk != nullptr;
+        const bool pinned = !inSlab && transaction->lastTc != nullptr;
+        if (inSlab)
+            tcs.push_back(reinterpret_cast<uint8_t*>(transaction->lastTc));
+        else if (pinned && !ctx->swappedMemoryPin(ctx->parserThread, transaction->xid, tcs))
+            return;
+
+        std::string header;
+        persistPut(header, PERSIST_MAGIC);
+        persistPut(header, PERSIST_VERSION);
+        persistPut(header, sequence.getData());
+        persistPut(header, fileOffset.getData());
+        persistPut(header, transaction->xid.getData());
+        persistPut(header, static_cast<uint16_t>(conId));
+        persistPut(header, transaction->firstSequence.getData());
+        persistPut(header, transaction->firstFileOffset.getData());
+        persistPut(header, static_cast<int64_t>(transaction->beginEpoch));
+        persistPut(header, static_cast<uint8_t>(transaction->begin ? 1 : 0));
+        persistPut(header, static_cast<uint8_t>(inSlab ? 1 : 0));
+        persistPut(header, transaction->opCodes);
+        persistPut(header, transaction->size);
+        persistPut(header, static_cast<uint64_t>(tcs.size()));
+        persistPut(header, static_cast<uint32_t>(transaction->attributes.size()));
+        for (const auto& [name, value]: transaction->attributes) {
+            persistPut(header, static_cast<uint32_t>(name.length()));
+            header.append(name);
+            persistPut(header, static_cast<uint32_t>(value.length()));
+            header.append(value);
+        }
+
+        const std::string fileName(persistFileName(transaction->xid, conId));
+        const std::string tempFileName(fileName + ".tmp");
+        const int fd = open(tempFileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+        if (fd == -1) {
+            if (pinned)
+                ctx->swappedMemoryUnpin(ctx->parserThread, transaction->xid);
+            throw RuntimeException(10006, "file: " + tempFileName + " - open for writing returned: " + strerror(errno));
+        }
+
+        try {
+            persistWriteAll(fd, header.data(), header.length(), tempFileName);
+            for (const uint8_t* tc: tcs)
+                persistWriteAll(fd, tc, TransactionChunk::HEADER_BUFFER_SIZE + reinterpret_cast<const TransactionChunk*>(tc)->size,
+                                tempFileName);
+        } catch (RuntimeException&) {
+            if (pinned)
+                ctx->swappedMemoryUnpin(ctx->parserThread, transaction->xid);
+            throw;
+        }
+        if (pinned)
+            ctx->swappedMemoryUnpin(ctx->parserThread, transaction->xid);
+
+        if (fsync(fd) != 0) {
+            const int err = errno;
+            close(fd);
+            throw RuntimeException(10075, "file: " + tempFileName + " - fsync returned: " + strerror(err));
+        }
+        close(fd);
+
+        if (rename(tempFileName.c_str(), fileName.c_str()) != 0)
+            throw RuntimeException(10085, "file: " + tempFileName + " - rename to " + fileName + " returned: " + strerror(errno));
+
+        transaction->persistSequence = sequence;
+        transaction->persistFileOffset = fileOffset;
+        transaction->persistDirty = false;
+        transaction->persistAttributes = transaction->attributes.size();
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::TRANSACTION)))
+            ctx->logTrace(Ctx::TRACE::TRANSACTION, "persisted xid: " + transaction->xid.toString() + " chunks: " + std::to_string(tcs.size()) +
+                                                   " seq: " + sequence.toString() + " offset: " + fileOffset.toString());
+    }
+
+    // Nothing changed since the image was written, it is valid at the new position as well
+    void TransactionBuffer::persistUpdate(Transaction* transaction, typeConId conId, Seq sequence, FileOffset fileOffset) {
+        const std::string fileName(persistFileName(transaction->xid, conId));
+        const int fd = open(fileName.c_str(), O_WRONLY);
+        if (fd == -1)
+            throw RuntimeException(10006, "file: " + fileName + " - open for writing returned: " + strerror(errno));
+
+        std::string position;
+        persistPut(position, sequence.getData());
+        persistPut(position, fileOffset.getData());
+        if (pwrite(fd, position.data(), position.length(), PERSIST_HEADER_SEQUENCE) != static_cast<ssize_t>(position.length())) {
+            const int err = errno;
+            close(fd);
+            throw RuntimeException(10007, "file: " + fileName + " - write returned: " + strerror(err));
+        }
+        if (fsync(fd) != 0) {
+            const int err = errno;
+            close(fd);
+            throw RuntimeException(10075, "file: " + fileName + " - fsync returned: " + strerror(err));
+        }
+        close(fd);
+
+        transaction->persistSequence = sequence;
+        transaction->persistFileOffset = fileOffset;
+    }
+
+    // Run at startup before any redo is read. An image written before the restart position belongs to a transaction which ended
+    // before the checkpoint, since an open one holds the restart position at its image
+    void TransactionBuffer::restore(XmlCtx* xmlCtx, Seq sequence, FileOffset fileOffset) {
+        if (persistPath.empty())
+            return;
+
+        DIR* dir = opendir(persistPath.c_str());
+        if (dir == nullptr)
+            throw RuntimeException(10012, "directory: " + persistPath + " - can't read");
+
+        const std::string prefix(persistPrefix + "-0x");
+        const std::string suffix(PERSIST_SUFFIX);
+        std::vector<std::string> fileNames;
+        const struct dirent* ent;
+        while ((ent = readdir(dir)) != nullptr) {
+            const std::string name(ent->d_name);
+            if (name.length() <= prefix.length() + suffix.length() || name.compare(0, prefix.length(), prefix) != 0 ||
+                name.compare(name.length() - suffix.length(), suffix.length(), suffix) != 0)
+                continue;
+            fileNames.push_back(persistPath + "/" + name);
+        }
+        closedir(dir);
+
+        uint64_t restored = 0;
+        for (const std::string& fileName: fileNames) {
+            if (persistRead(xmlCtx, fileName, sequence, fileOffset)) {
+                ++restored;
+                continue;
+            }
+            if (unlink(fileName.c_str()) != 0)
+                ctx->error(10010, "file: " + fileName + " - delete returned: " + strerror(errno));
+        }
+
+        if (restored > 0)
+            ctx->info(0, "restored " + std::to_string(restored) + " persisted transactions");
+    }
+
+    bool TransactionBuffer::persistRead(XmlCtx* xmlCtx, const std::string& fileName, Seq sequence, FileOffset fileOffset) {
+        std::ifstream inputStream(fileName.c_str(), std::ios::in | std::ios::binary);
+        if (!inputStream.is_open())
+            throw RuntimeException(10001, "file: " + fileName + " - open for read returned: " + strerror(errno));
+
+        auto get = [&](void* data, uint64_t length) {
+            inputStream.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(length));
+            if (unlikely(!inputStream))
+                throw RuntimeException(10096, "persisted transaction: " + fileName + " - file truncated");
+        };
+
+        uint32_t magic;
+        uint32_t version;
+        uint32_t persistSequence;
+        uint64_t persistFileOffset;
+        get(&magic, sizeof(magic));
+        get(&version, sizeof(version));
+        if (unlikely(magic != PERSIST_MAGIC || version != PERSIST_VERSION))
+            throw RuntimeException(10096, "persisted transaction: " + fileName + " - invalid header");
+        get(&persistSequence, sizeof(persistSequence));
+        get(&persistFileOffset, sizeof(persistFileOffset));
+        if (Seq(persistSequence) < sequence || (Seq(persistSequence) == sequence && FileOffset(persistFileOffset) < fileOffset))
+            return false;
+
+        uint64_t xid;
+        uint16_t conId;
+        uint32_t firstSequence;
+        uint64_t firstFileOffset;
+        int64_t beginEpoch;
+        uint8_t begin;
+        uint8_t inSlab;
+        uint64_t opCodes;
+        uint64_t size;
+        uint64_t chunks;
+        uint32_t attributes;
+        get(&xid, sizeof(xid));
+        get(&conId, sizeof(conId));
+        get(&firstSequence, sizeof(firstSequence));
+        get(&firstFileOffset, sizeof(firstFileOffset));
+        get(&beginEpoch, sizeof(beginEpoch));
+        get(&begin, sizeof(begin));
+        get(&inSlab, sizeof(inSlab));
+        get(&opCodes, sizeof(opCodes));
+        get(&size, sizeof(size));
+        get(&chunks, sizeof(chunks));
+        get(&attributes, sizeof(attributes));
+        if (unlikely(inSlab != 0 && chunks != 1))
+            throw RuntimeException(10096, "persisted transaction: " + fileName + " - invalid number of chunks: " + std::to_string(chunks));
+
+        Transaction* transaction = findTransaction(xmlCtx, Xid(xid), static_cast<typeConId>(conId), false, true, false);
+        transaction->firstSequence = Seq(firstSequence);
+        transaction->firstFileOffset = FileOffset(firstFileOffset);
+        transaction->beginEpoch = static_cast<time_t>(beginEpoch);
+        transaction->begin = begin != 0;
+        transaction->opCodes = opCodes;
+        transaction->size = size;
+
+        for (uint32_t i = 0; i < attributes; ++i) {
+            std::string values[2];
+            for (std::string& value: values) {
+                uint32_t length;
+                get(&length, sizeof(length));
+                if (unlikely(length > Ctx::MEMORY_CHUNK_SIZE))
+                    throw RuntimeException(10096, "persisted transaction: " + fileName + " - invalid attribute length: " + std::to_string(length));
+                value.resize(length);
+                get(value.data(), length);
+            }
+            transaction->attributes.insert_or_assign(values[0], values[1]);
+        }
+
+        for (uint64_t i = 0; i < chunks; ++i) {
+            uint64_t elements;
+            uint32_t chunkSize;
+            get(&elements, sizeof(elements));
+            get(&chunkSize, sizeof(chunkSize));
+            if (unlikely(chunkSize > (inSlab != 0 ? SLAB_DATA_SIZE : TransactionChunk::DATA_BUFFER_SIZE)))
+                throw RuntimeException(10096, "persisted transaction: " + fileName + " - invalid chunk size: " + std::to_string(chunkSize));
+
+            if (inSlab != 0)
+                allocateSlab(transaction);
+            else
+                transaction->lastTc = reinterpret_cast<TransactionChunk*>(ctx->swappedMemoryGrow(ctx->parserThread, transaction->xid));
+            transaction->lastTc->elements = elements;
+            transaction->lastTc->size = chunkSize;
+            get(transaction->lastTc->buffer, chunkSize);
+        }
+
+        transaction->persistSequence = Seq(persistSequence);
+        transaction->persistFileOffset = FileOffset(persistFileOffset);
+        transaction->persistDirty = false;
+        transaction->persistAttributes = transaction->attributes.size();
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::TRANSACTION)))
+            ctx->logTrace(Ctx::TRACE::TRANSACTION, "restored xid: " + transaction->xid.toString() + " chunks: " + std::to_string(chunks) +
+                                                   " seq: " + transaction->persistSequence.toString() + " offset: " +
+                                                   transaction->persistFileOffset.toString());
+        return true;
+    }
+
+    // Run by the parser thread at the end of every LWN, the map is read without the lock
+    void TransactionBuffer::sampleProfile(RedoProfile* redoProfile) const {
+        uint64_t openBytes = 0;
+        uint64_t bufferedBytes = 0;
+        for (const auto& [_, transaction]: xidTransactionMap) {
+            openBytes += transaction->profileBytes;
+            bufferedBytes += transaction->size;
+        }
+        redoProfile->sample(xidTransactionMap.size(), openBytes, bufferedBytes);
+    }
+
+    // Run by the parser thread which owns the map, so the map is read without the lock
+    void TransactionBuffer::publishSnapshot(time_ut now) {
+        auto snapshot = std::make_shared<TransactionSnapshot>();
+        snapshot->published = now;
+        snapshot->lwnEpoch = RuntimeStats::get(ctx->stats.lwnEpoch);
+        snapshot->transactions = xidTransactionMap.size();
+
+        std::vector<TransactionSnapshot::Entry>& entries = snapshot->entries;
+        entries.reserve(xidTransactionMap.size());
+        for (const auto& [_, transaction] : xidTransactionMap) {
+            snapshot->bytes += transaction->size;
+            entries.push_back({transaction->xid, transaction->size, 0, -1, -1, transaction->firstSequence, transaction->firstFileOffset,
+                               transaction->beginEpoch});
+        }
+
+        auto larger = [](const TransactionSnapshot::Entry& a, const TransactionSnapshot::Entry& b) {
+            return a.size > b.size;
+        };
+        if (entries.size() > TransactionSnapshot::TOP) {
+            std::partial_sort(entries.begin(), entries.begin() + TransactionSnapshot::TOP, entries.end(), larger);
+            entries.resize(TransactionSnapshot::TOP);
+        } else
+            std::sort(entries.begin(), entries.end(), larger);
+
+        ctx->swappedMemorySnapshot(ctx->parserThread, entries);
+        ctx->stats.publishTransactions(std::move(snapshot));
+    }
+
     void TransactionBuffer::addOrphanedLob(RedoLogRecord* redoLogRecord1) {
         if (unlikely(ctx->isTraceSet(Ctx::TRACE::LOB)))
             ctx->logTrace(Ctx::TRACE::LOB, "id: " + redoLogRecord1->lobId.upper() + " page: " + std::to_string(redoLogRecord1->dba) +
@@ -294,13 +1004,13 @@ namespace OpenLogReplicator {
 
         const LobKey lobKey(redoLogRecord1->lobId, redoLogRecord1->dba);
 
-        if (orphanedLobs.find(lobKey) != orphanedLobs.end()) {
+        if (orphanedLobs.contains(lobKey)) {
             ctx->warning(60009, "duplicate orphaned lob: " + redoLogRecord1->lobId.lower() + ", page: " +
                                 std::to_string(redoLogRecord1->dba));
             return;
         }
 
-        orphanedLobs.insert_or_assign(lobKey, allocateLob(redoLogRecord1));
+        orphanedLobs.add(ctx, lobKey, allocateLob(redoLogRecord1));
     }
 
     uint8_t* TransactionBuffer::allocateLob(const RedoLogRecord* redoLogRecord1) {
@@ -20,20 +20,29 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #ifndef TRANSACTION_BUFFER_H_
 #define TRANSACTION_BUFFER_H_
 
+#include <cstring>
 #include <map>
 #include <mutex>
 #include <set>
+#include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "../common/Ctx.h"
 #include "../common/LobKey.h"
+#include "../common/OrphanedLobs.h"
 #include "../common/RedoLogRecord.h"
 #include "../common/types/FileOffset.h"
+#include "../common/types/Scn.h"
 #include "../common/types/Types.h"
 #include "../common/types/Seq.h"
 #include "../common/types/Xid.h"
+#include "TransactionMap.h"
 
 namespace OpenLogReplicator {
+    class Metadata;
+    class RedoProfile;
     class Transaction;
     class XmlCtx;
 
@@ -47,41 +56,153 @@ namespace OpenLogReplicator {
         uint8_t buffer[1];
     };
 
+    // Memory chunk carved into slabs for transactions holding little data
+    struct TransactionSlabChunk {
+        uint8_t* data;
+        std::vector<uint8_t*> freeSlabs;
+    };
+
+    // Vector data of a record merged from its pieces split across blocks. The pieces are referenced where they are, in the redo buffer and
+    // in the row of the transaction, and are gathered only when the merged row is written
+    struct RecordFragments {
+        static constexpr uint32_t FRAGMENTS_MAX = 4;
+
+        struct Fragment {
+            const uint8_t* data;
+            uint32_t size;
+            uint32_t padded;
+        };
+
+        Fragment fragments[FRAGMENTS_MAX];
+        uint32_t count{0};
+        uint32_t size{0};
+
+        void add(const uint8_t* data, uint32_t fragmentSize, uint32_t padded) {
+            fragments[count++] = Fragment{data, fragmentSize, padded};
+            size += padded;
+        }
+
+        // Backwards, so that the piece kept in the row being overwritten is moved before anything is written over it
+        void gather(uint8_t* out) const {
+            uint32_t pos = size;
+            for (uint32_t i = count; i > 0; --i) {
+                const Fragment& fragment = fragments[i - 1];
+                pos -= fragment.padded;
+                memmove(reinterpret_cast<void*>(out + pos), reinterpret_cast<const void*>(fragment.data), fragment.size);
+                if (fragment.padded > fragment.size)
+                    memset(reinterpret_cast<void*>(out + pos + fragment.size), 0, fragment.padded - fragment.size);
+            }
+        }
+    };
+
     class TransactionBuffer {
     public:
+        // Row: op, sizes of the vector data of both records, sizes of their compact headers, the headers padded to 4 bytes, the vector data
+        // of both records and the size of the whole row. A compact header is a bitmap of the fields which are not zero followed by those
+        // fields as varints, it is unpacked to a RedoLogRecord only when the row is flushed. The second one is empty for a single record
         static constexpr uint32_t ROW_HEADER_OP = 0;
-        static constexpr uint32_t ROW_HEADER_DATA0 = sizeof(typeOp2);
-        static constexpr uint32_t ROW_HEADER_DATA1 = sizeof(typeOp2) + sizeof(RedoLogRecord);
-        static constexpr uint32_t ROW_HEADER_DATA2 = sizeof(typeOp2) + sizeof(RedoLogRecord) + sizeof(RedoLogRecord);
-        static constexpr uint32_t ROW_HEADER_TOTAL = sizeof(typeOp2) + sizeof(RedoLogRecord) + sizeof(RedoLogRecord) + sizeof(typeChunkSize);
+        static constexpr uint32_t ROW_HEADER_SIZE1 = sizeof(typeOp2);
+        static constexpr uint32_t ROW_HEADER_SIZE2 = ROW_HEADER_SIZE1 + sizeof(uint32_t);
+        static constexpr uint32_t ROW_HEADER_PACKED1 = ROW_HEADER_SIZE2 + sizeof(uint32_t);
+        static constexpr uint32_t ROW_HEADER_PACKED2 = ROW_HEADER_PACKED1 + sizeof(uint16_t);
+        static constexpr uint32_t ROW_HEADER_RECORDS = ROW_HEADER_PACKED2 + sizeof(uint16_t);
+        static constexpr uint32_t RECORD_FIELDS = 59;
+        static constexpr uint32_t VARINT_MAX = 10;
+        static constexpr uint32_t RECORD_HEADER_MAX = sizeof(uint64_t) + ((RECORD_FIELDS - 1) * VARINT_MAX) + LobId::LENGTH;
+        static constexpr uint32_t ROW_HEADER_MIN = ROW_HEADER_RECORDS + sizeof(typeChunkSize);
+        // Upper bound of the space taken by a row besides the vector data
+        static constexpr uint32_t ROW_HEADER_TOTAL = ROW_HEADER_MIN + (2 * RECORD_HEADER_MAX) + 3;
+        // Op of a row rolled back but not removed since it is not the last one
+        static constexpr typeOp2 ROW_OP_ROLLED_BACK = 0;
+        static constexpr uint32_t SLAB_SIZE = 8192;
+        static constexpr uint32_t SLAB_DATA_SIZE = SLAB_SIZE - TransactionChunk::HEADER_BUFFER_SIZE;
+        static constexpr uint32_t SLABS_PER_CHUNK = Ctx::MEMORY_CHUNK_SIZE / SLAB_SIZE;
+        // Image of a persisted transaction: fixed header, attributes, then the used part of every chunk with its header
+        static constexpr uint32_t PERSIST_MAGIC = 0x544C524F;
+        static constexpr uint32_t PERSIST_VERSION = 1;
+        static constexpr uint32_t PERSIST_HEADER_SEQUENCE = 2 * sizeof(uint32_t);
+        static constexpr uint32_t PERSIST_HEADER_SIZE = PERSIST_HEADER_SEQUENCE + sizeof(uint32_t) + sizeof(uint64_t);
+        static constexpr const char* PERSIST_SUFFIX = ".tran";
 
     protected:
         Ctx* ctx;
         uint8_t buffer[TransactionChunk::DATA_BUFFER_SIZE]{};
+        uint8_t rowHeaders[2 * RECORD_HEADER_MAX]{};
+        // Field list of the record being merged, and the whole merged record when it needs to be flat
+        std::vector<uint8_t> mergeFields;
+        std::vector<uint8_t> mergeBuffer;
 
         std::mutex mtx;
-        std::unordered_map<XidMap, Transaction*> xidTransactionMap;
-        std::map<LobKey, uint8_t*> orphanedLobs;
+        TransactionMap xidTransactionMap;
+        // Most redo records belong to the transaction of the previous one
+        XidMap lastXidMap{0};
+        Transaction* lastXidTransaction{nullptr};
+        OrphanedLobs orphanedLobs;
+        // Slab chunks with at least one free slab
+        std::vector<TransactionSlabChunk*> slabChunks;
+
+        // Purged Transaction objects kept for reuse, up to Ctx::transactionPoolSize
+        std::vector<Transaction*> transactionPool;
+        // Redo time of the last persist, images of dropped transactions are removed once a later checkpoint is written
+        time_t persistEpoch{0};
+        std::vector<std::pair<Scn, std::string>> persistRemoved;
+
+        Transaction* newTransaction(Xid xid, XmlCtx* xmlCtx);
+        void newTransactionChunk(Transaction* transaction, typeChunkSize chunkSize);
+        void allocateSlab(Transaction* transaction);
+        void promoteSlab(Transaction* transaction);
+        uint32_t appendRow(Transaction* transaction, typeOp2 op, const RedoLogRecord* redoLogRecord1, const RedoLogRecord* redoLogRecord2,
+                           const RecordFragments* fragments1 = nullptr);
+        void mergeFlatten(const RecordFragments& fragments, RedoLogRecord* redoLogRecord);
+        [[nodiscard]] static uint32_t packRecord(uint8_t* out, const RedoLogRecord* redoLogRecord);
+        static void unpackRecord(const uint8_t* in, uint32_t size, RedoLogRecord* redoLogRecord);
+        [[nodiscard]] std::string persistFileName(Xid xid, typeConId conId) const;
+        [[nodiscard]] bool persistEligible(const Transaction* transaction, time_t lwnEpoch) const;
+        void persistWrite(Transaction* transaction, typeConId conId, Seq sequence, FileOffset fileOffset);
+        void persistUpdate(Transaction* transaction, typeConId conId, Seq sequence, FileOffset fileOffset);
+        [[nodiscard]] bool persistRead(XmlCtx* xmlCtx, const std::string& fileName, Seq sequence, FileOffset fileOffset);
 
     public:
         std::set<Xid> skipXidList;
         std::set<Xid> dumpXidList;
         std::set<XidMap> brokenXidMapList;
         std::string dumpPath;
+        // Directory and file name prefix of the persisted transactions, empty - not persisted
+        std::string persistPath;
+        std::string persistPrefix;
 
         explicit TransactionBuffer(Ctx* newCtx);
         ~TransactionBuffer();
 
         void purge();
         [[nodiscard]] Transaction* findTransaction(XmlCtx* xmlCtx, Xid xid, typeConId conId, bool old, bool add, bool rollback);
+        void prefetchTransaction(Xid xid, typeConId conId) const;
         void dropTransaction(Xid xid, typeConId conId);
+        void releaseTransaction(Transaction* transaction);
         void addTransactionChunk(Transaction* transaction, RedoLogRecord* redoLogRecord);
         void addTransactionChunk(Transaction* transaction, RedoLogRecord* redoLogRecord1, const RedoLogRecord* redoLogRecord2);
         void rollbackTransactionChunk(Transaction* transaction);
-        void mergeBlocks(uint8_t* mergeBuffer, RedoLogRecord* redoLogRecord1, const RedoLogRecord* redoLogRecord2);
+        void releaseSlab(Transaction* transaction);
+        void mergeBlocks(RecordFragments& fragments, RedoLogRecord* redoLogRecord1, const RedoLogRecord* redoLogRecord2);
         void checkpoint(Seq& minSequence, FileOffset& minFileOffset, Xid& minXid);
+        void persist(Metadata* metadata, Scn lwnScn, Seq sequence, FileOffset fileOffset);
+        void restore(XmlCtx* xmlCtx, Seq sequence, FileOffset fileOffset);
+        void publishSnapshot(time_ut now);
+        void sampleProfile(RedoProfile* redoProfile) const;
         void addOrphanedLob(RedoLogRecord* redoLogRecord1);
         static uint8_t* allocateLob(const RedoLogRecord* redoLogRecord1);
+        static void unpackRow(const uint8_t* row, RedoLogRecord* redoLogRecord1, RedoLogRecord* redoLogRecord2);
+
+        [[nodiscard]] static uint32_t rowDataOffset(const uint8_t* row) {
+            const uint32_t packed = static_cast<uint32_t>(*reinterpret_cast<const uint16_t*>(row + ROW_HEADER_PACKED1)) +
+                                    *reinterpret_cast<const uint16_t*>(row + ROW_HEADER_PACKED2);
+            return ROW_HEADER_RECORDS + ((packed + 3) & 0xFFFFFFFC);
+        }
+
+        [[nodiscard]] static typeChunkSize rowSize(const uint8_t* row) {
+            return rowDataOffset(row) + *reinterpret_cast<const uint32_t*>(row + ROW_HEADER_SIZE1) +
+                   *reinterpret_cast<const uint32_t*>(row + ROW_HEADER_SIZE2) + sizeof(typeChunkSize);
+        }
     };
 }
 
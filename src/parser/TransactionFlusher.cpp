@@ -0,0 +1,246 @@
+/* Thread building messages of committed transactions
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <thread>
+
+#include "../builder/Builder.h"
+#include "../common/exception/DataException.h"
+#include "../common/exception/RedoLogException.h"
+#include "../common/exception/RuntimeException.h"
+#include "../metadata/Metadata.h"
+#include "Transaction.h"
+#include "TransactionBuffer.h"
+#include "TransactionFlusher.h"
+
+namespace OpenLogReplicator {
+    TransactionFlusher::TransactionFlusher(Ctx* newCtx, std::string newAlias, Builder* newBuilder, Metadata* newMetadata,
+                                           TransactionBuffer* newTransactionBuffer, uint64_t newQueueMax) :
+            Thread(newCtx, std::move(newAlias)),
+            builder(newBuilder),
+            metadata(newMetadata),
+            transactionBuffer(newTransactionBuffer),
+            queueMax(newQueueMax) {
+    }
+
+    TransactionFlusher::~TransactionFlusher() {
+        std::vector<Transaction*> transactions;
+        transactions.swap(flushed);
+        for (const Job& job: queue)
+            if (job.type == JOB::COMMIT)
+                transactions.push_back(job.transaction);
+        queue.clear();
+        release(transactions);
+    }
+
+    void TransactionFlusher::release(const std::vector<Transaction*>& transactions) {
+        for (Transaction* transaction: transactions) {
+            transaction->purge(ctx, transactionBuffer);
+            transactionBuffer->releaseTransaction(transaction);
+        }
+    }
+
+    // Called by the parser thread, false when the thread has exited and the job is to be run by the caller
+    bool TransactionFlusher::push(Thread* t, const Job& job) {
+        {
+            t->contextSet(CONTEXT::MUTEX, REASON::TRANSACTION_FLUSH);
+            std::unique_lock<std::mutex> lck(mtx);
+            while (!done && !ctx->hardShutdown && queue.size() >= queueMax) {
+                if (unlikely(ctx->isTraceSet(Ctx::TRACE::SLEEP)))
+                    ctx->logTrace(Ctx::TRACE::SLEEP, "TransactionFlusher:push");
+                t->contextSet(CONTEXT::WAIT, REASON::TRANSACTION_FLUSH_FULL);
+                condDone.wait_for(lck, std::chrono::milliseconds(100));
+            }
+
+            if (done) {
+                t->contextSet(CONTEXT::CPU);
+                return false;
+            }
+            queue.push_back(job);
+            condWork.notify_all();
+        }
+        t->contextSet(CONTEXT::CPU);
+
+        reap(t);
+        return true;
+    }
+
+    bool TransactionFlusher::commit(Thread* t, Transaction* transaction, Scn lwnScn) {
+        return push(t, {JOB::COMMIT, transaction, lwnScn, Time(), Seq::none(), FileOffset(), false, 0, Seq::none(), FileOffset(), Xid()});
+    }
+
+    bool TransactionFlusher::checkpoint(Thread* t, Scn lwnScn, Time lwnTimestamp, Seq sequence, FileOffset fileOffset, bool redo,
+                                        uint64_t checkpointBytes, Seq minSequence, FileOffset minFileOffset, Xid minXid) {
+        return push(t, {JOB::CHECKPOINT, nullptr, lwnScn, lwnTimestamp, sequence, fileOffset, redo, checkpointBytes, minSequence, minFileOffset,
+                        minXid});
+    }
+
+    // Releases the flushed transactions and passes the error of a failed job to the parser thread
+    void TransactionFlusher::reap(Thread* t) {
+        std::vector<Transaction*> transactions;
+        std::exception_ptr jobError;
+        {
+            t->contextSet(CONTEXT::MUTEX, REASON::TRANSACTION_FLUSH);
+            std::unique_lock<std::mutex> const lck(mtx);
+            transactions.swap(flushed);
+            jobError = error;
+            error = nullptr;
+        }
+        t->contextSet(CONTEXT::CPU);
+
+        release(transactions);
+        if (jobError != nullptr)
+            std::rethrow_exception(jobError);
+    }
+
+    // Waits until every queued job is done, afterwards the caller owns the builder
+    void TransactionFlusher::drain(Thread* t) {
+        {
+            t->contextSet(CONTEXT::MUTEX, REASON::TRANSACTION_FLUSH);
+            std::unique_lock<std::mutex> lck(mtx);
+            while (active || (!done && !ctx->hardShutdown && !queue.empty())) {
+                if (unlikely(ctx->isTraceSet(Ctx::TRACE::SLEEP)))
+                    ctx->logTrace(Ctx::TRACE::SLEEP, "TransactionFlusher:drain");
+                t->contextSet(CONTEXT::WAIT, REASON::TRANSACTION_FLUSH);
+                condDone.wait_for(lck, std::chrono::milliseconds(100));
+            }
+        }
+        t->contextSet(CONTEXT::CPU);
+
+        reap(t);
+    }
+
+    void TransactionFlusher::stop() {
+        std::unique_lock<std::mutex> const lck(mtx);
+        stopped = true;
+        condWork.notify_all();
+    }
+
+    void TransactionFlusher::wakeUp() {
+        std::unique_lock<std::mutex> const lck(mtx);
+        condWork.notify_all();
+        condDone.notify_all();
+    }
+
+    void TransactionFlusher::runJob(const Job& job) {
+        builder->flushThread = this;
+        try {
+            switch (job.type) {
+                case JOB::COMMIT:
+                    job.transaction->flush(metadata, builder, job.lwnScn);
+                    break;
+
+                case JOB::CHECKPOINT:
+                    builder->processCheckpoint(job.lwnScn, job.sequence, job.lwnTimestamp.toEpoch(ctx->hostTimezone), job.fileOffset, job.redo);
+                    metadata->checkpoint(this, job.lwnScn, job.lwnTimestamp, job.sequence, job.fileOffset, job.checkpointBytes, job.minSequence,
+                                         job.minFileOffset, job.minXid);
+                    break;
+            }
+        } catch (...) {
+            builder->flushThread = nullptr;
+            throw;
+        }
+        builder->flushThread = nullptr;
+        contextSet(CONTEXT::CPU);
+    }
+
+    void TransactionFlusher::run() {
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
+            std::ostringstream ss;
+            ss << std::this_thread::get_id();
+            ctx->logTrace(Ctx::TRACE::THREADS, "transaction flusher (" + ss.str() + ") start");
+        }
+
+        try {
+            while (!ctx->hardShutdown) {
+                Job job;
+                bool skip;
+                {
+                    contextSet(CONTEXT::MUTEX, REASON::TRANSACTION_FLUSH);
+                    std::unique_lock<std::mutex> lck(mtx);
+                    if (queue.empty()) {
+                        // The parser drains the queue before it finishes
+                        if (stopped || ctx->softShutdown)
+                            break;
+                        if (unlikely(ctx->isTraceSet(Ctx::TRACE::SLEEP)))
+                            ctx->logTrace(Ctx::TRACE::SLEEP, "TransactionFlusher:run");
+                        contextSet(CONTEXT::WAIT, REASON::TRANSACTION_FLUSH_NO_WORK);
+                        condWork.wait_for(lck, std::chrono::milliseconds(100));
+                        continue;
+                    }
+                    job = queue.front();
+                    queue.pop_front();
+                    active = true;
+                    skip = failed;
+                }
+                contextSet(CONTEXT::CPU);
+
+                std::exception_ptr jobError;
+                if (!skip) {
+                    try {
+                        runJob(job);
+                    } catch (DataException& ex) {
+                        if (ctx->isFlagSet(Ctx::REDO_FLAGS::IGNORE_DATA_ERRORS)) {
+                            ctx->error(ex.code, ex.msg);
+                            ctx->warning(60013, "forced to continue working in spite of error");
+                        } else
+                            jobError = std::current_exception();
+                    } catch (RedoLogException& ex) {
+                        if (ctx->isFlagSet(Ctx::REDO_FLAGS::IGNORE_DATA_ERRORS)) {
+                            ctx->error(ex.code, ex.msg);
+                            ctx->warning(60013, "forced to continue working in spite of error");
+                        } else
+                            jobError = std::current_exception();
+                    } catch (...) {
+                        jobError = std::current_exception();
+                    }
+                }
+
+                {
+                    contextSet(CONTEXT::MUTEX, REASON::TRANSACTION_FLUSH);
+                    std::unique_lock<std::mutex> const lck(mtx);
+                    if (job.type == JOB::COMMIT)
+                        flushed.push_back(job.transaction);
+                    if (jobError != nullptr) {
+                        error = jobError;
+                        failed = true;
+                    }
+                    active = false;
+                    condDone.notify_all();
+                }
+                contextSet(CONTEXT::CPU);
+            }
+        } catch (RuntimeException& ex) {
+            ctx->error(ex.code, ex.msg);
+            ctx->stopHard();
+        }
+
+        {
+            std::unique_lock<std::mutex> const lck(mtx);
+            done = true;
+            active = false;
+            condDone.notify_all();
+        }
+
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
+            std::ostringstream ss;
+            ss << std::this_thread::get_id();
+            ctx->logTrace(Ctx::TRACE::THREADS, "transaction flusher (" + ss.str() + ") stop");
+        }
+    }
+}
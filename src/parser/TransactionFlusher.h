@@ -0,0 +1,109 @@
+/* Header for TransactionFlusher class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef TRANSACTION_FLUSHER_H_
+#define TRANSACTION_FLUSHER_H_
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <vector>
+
+#include "../common/Thread.h"
+#include "../common/types/FileOffset.h"
+#include "../common/types/Scn.h"
+#include "../common/types/Seq.h"
+#include "../common/types/Time.h"
+#include "../common/types/Types.h"
+#include "../common/types/Xid.h"
+
+namespace OpenLogReplicator {
+    class Builder;
+    class Metadata;
+    class Transaction;
+    class TransactionBuffer;
+
+    // Background thread building the messages of committed transactions, so that the parser reads on while a big transaction
+    // is flushed. There is a single builder and message ids are assigned in the order messages are built, so jobs are run one by
+    // one in commit order. Checkpoints are queued too, so the writer sees them after all transactions committed before
+    class TransactionFlusher final : public Thread {
+    protected:
+        enum class JOB : unsigned char {
+            COMMIT, CHECKPOINT
+        };
+
+        struct Job {
+            JOB type;
+            Transaction* transaction;
+            Scn lwnScn;
+            Time lwnTimestamp;
+            Seq sequence;
+            FileOffset fileOffset;
+            bool redo;
+            uint64_t checkpointBytes;
+            Seq minSequence;
+            FileOffset minFileOffset;
+            Xid minXid;
+        };
+
+        Builder* builder;
+        Metadata* metadata;
+        TransactionBuffer* transactionBuffer;
+        uint64_t queueMax;
+
+        std::mutex mtx;
+        std::condition_variable condWork;
+        std::condition_variable condDone;
+        std::deque<Job> queue;
+        // Flushed transactions, released by the parser thread which owns the transaction buffer
+        std::vector<Transaction*> flushed;
+        // First error of a job, thrown to the parser thread, later transactions are not built
+        std::exception_ptr error;
+        bool failed{false};
+        bool active{false};
+        bool stopped{false};
+        // Set when the thread has exited, later jobs are run by the caller
+        bool done{false};
+
+        void run() override;
+        bool push(Thread* t, const Job& job);
+        void runJob(const Job& job);
+        void release(const std::vector<Transaction*>& transactions);
+
+    public:
+        TransactionFlusher(Ctx* newCtx, std::string newAlias, Builder* newBuilder, Metadata* newMetadata, TransactionBuffer* newTransactionBuffer,
+                           uint64_t newQueueMax);
+        ~TransactionFlusher() override;
+
+        bool commit(Thread* t, Transaction* transaction, Scn lwnScn);
+        bool checkpoint(Thread* t, Scn lwnScn, Time lwnTimestamp, Seq sequence, FileOffset fileOffset, bool redo, uint64_t checkpointBytes,
+                        Seq minSequence, FileOffset minFileOffset, Xid minXid);
+        void reap(Thread* t);
+        void drain(Thread* t);
+        void stop();
+        void wakeUp() override;
+
+        std::string getName() const override {
+            return {"TransactionFlusher: " + alias};
+        }
+    };
+}
+
+#endif
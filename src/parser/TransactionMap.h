@@ -0,0 +1,174 @@
+/* Header for TransactionMap class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef TRANSACTION_MAP_H_
+#define TRANSACTION_MAP_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "../common/types/Types.h"
+
+namespace OpenLogReplicator {
+    class Transaction;
+
+    // Flat open-addressing map of XidMap to Transaction*, linear probing with backward shift deletion
+    class TransactionMap final {
+    public:
+        struct Entry {
+            XidMap xidMap;
+            Transaction* transaction;
+        };
+
+        class Iterator final {
+        protected:
+            const Entry* entry;
+            const Entry* last;
+
+            void skipEmpty() {
+                while (entry != last && entry->transaction == nullptr)
+                    ++entry;
+            }
+
+        public:
+            Iterator(const Entry* newEntry, const Entry* newLast) :
+                    entry(newEntry),
+                    last(newLast) {
+                skipEmpty();
+            }
+
+            const Entry& operator*() const {
+                return *entry;
+            }
+
+            Iterator& operator++() {
+                ++entry;
+                skipEmpty();
+                return *this;
+            }
+
+            bool operator!=(const Iterator& other) const {
+                return entry != other.entry;
+            }
+        };
+
+    protected:
+        static constexpr uint64_t CAPACITY_MIN{1024};
+
+        std::vector<Entry> entries;
+        uint64_t mask;
+        uint64_t count{0};
+
+        [[nodiscard]] uint64_t slot(XidMap xidMap) const {
+            return (xidMap * 0x9E3779B97F4A7C15ULL >> 17) & mask;
+        }
+
+        void grow() {
+            std::vector<Entry> oldEntries(entries.size() * 2, Entry{0, nullptr});
+            oldEntries.swap(entries);
+            mask = entries.size() - 1;
+            count = 0;
+            for (const Entry& entry: oldEntries)
+                if (entry.transaction != nullptr)
+                    insert(entry.xidMap, entry.transaction);
+        }
+
+    public:
+        TransactionMap() :
+                entries(CAPACITY_MIN, Entry{0, nullptr}),
+                mask(CAPACITY_MIN - 1) {
+        }
+
+        [[nodiscard]] Transaction* find(XidMap xidMap) const {
+            for (uint64_t i = slot(xidMap);; i = (i + 1) & mask) {
+                const Entry& entry = entries[i];
+                if (entry.transaction == nullptr)
+                    return nullptr;
+                if (entry.xidMap == xidMap)
+                    return entry.transaction;
+            }
+        }
+
+        void insert(XidMap xidMap, Transaction* transaction) {
+            // Keep the load factor below 1/2 so that probe sequences stay short
+            if ((count + 1) * 2 > entries.size())
+                grow();
+
+            for (uint64_t i = slot(xidMap);; i = (i + 1) & mask) {
+                Entry& entry = entries[i];
+                if (entry.transaction == nullptr) {
+                    entry.xidMap = xidMap;
+                    entry.transaction = transaction;
+                    ++count;
+                    return;
+                }
+                if (entry.xidMap == xidMap) {
+                    entry.transaction = transaction;
+                    return;
+                }
+            }
+        }
+
+        void erase(XidMap xidMap) {
+            uint64_t i = slot(xidMap);
+            while (true) {
+                if (entries[i].transaction == nullptr)
+                    return;
+                if (entries[i].xidMap == xidMap)
+                    break;
+                i = (i + 1) & mask;
+            }
+
+            // Move back the following entries of the cluster which would not be found any more
+            uint64_t j = i;
+            while (true) {
+                j = (j + 1) & mask;
+                if (entries[j].transaction == nullptr)
+                    break;
+                const uint64_t home = slot(entries[j].xidMap);
+                if (((j - home) & mask) >= ((j - i) & mask)) {
+                    entries[i] = entries[j];
+                    i = j;
+                }
+            }
+            entries[i] = Entry{0, nullptr};
+            --count;
+        }
+
+        void clear() {
+            for (Entry& entry: entries)
+                entry = Entry{0, nullptr};
+            count = 0;
+        }
+
+        [[nodiscard]] uint64_t size() const {
+            return count;
+        }
+
+        [[nodiscard]] Iterator begin() const {
+            return {entries.data(), entries.data() + entries.size()};
+        }
+
+        [[nodiscard]] Iterator end() const {
+            return {entries.data() + entries.size(), entries.data() + entries.size()};
+        }
+    };
+}
+
+#endif
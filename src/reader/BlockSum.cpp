@@ -0,0 +1,154 @@
+/* Redo block checksum verification
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <mutex>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include "BlockSum.h"
+
+namespace OpenLogReplicator {
+    BlockSum::verifyFunc BlockSum::verifyImpl{BlockSum::verifyScalar};
+    BlockSum::ENGINE BlockSum::engine{BlockSum::ENGINE::SCALAR};
+
+    void BlockSum::initialize() {
+        static std::once_flag initialized;
+        std::call_once(initialized, []() {
+#if defined(__x86_64__)
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f")) {
+                verifyImpl = verifyAvx512;
+                engine = ENGINE::AVX512;
+            } else if (__builtin_cpu_supports("avx2")) {
+                verifyImpl = verifyAvx2;
+                engine = ENGINE::AVX2;
+            }
+#elif defined(__aarch64__)
+            verifyImpl = verifyNeon;
+            engine = ENGINE::NEON;
+#endif
+        });
+    }
+
+    BlockSum::ENGINE BlockSum::getEngine() {
+        return engine;
+    }
+
+    const char* BlockSum::getEngineName() {
+        switch (engine) {
+            case ENGINE::AVX2:
+                return "avx2";
+            case ENGINE::AVX512:
+                return "avx512";
+            case ENGINE::NEON:
+                return "neon";
+            default:
+                return "scalar";
+        }
+    }
+
+    // Reference implementation, same arithmetic as Reader::calcChSum
+    uint BlockSum::verifyScalar(const uint8_t* buffer, uint blockSize, uint blocks) {
+        for (uint block = 0; block < blocks; ++block, buffer += blockSize) {
+            uint64_t sum = 0;
+            const auto* words = reinterpret_cast<const uint64_t*>(buffer);
+            for (uint i = 0; i < blockSize / sizeof(uint64_t); ++i)
+                sum ^= words[i];
+            sum ^= (sum >> 32);
+            sum ^= (sum >> 16);
+            if ((sum & 0xFFFF) != 0)
+                return block;
+        }
+        return blocks;
+    }
+
+#if defined(__x86_64__)
+    __attribute__((target("avx2")))
+    uint BlockSum::verifyAvx2(const uint8_t* buffer, uint blockSize, uint blocks) {
+        for (uint block = 0; block < blocks; ++block, buffer += blockSize) {
+            __m256i acc0 = _mm256_setzero_si256();
+            __m256i acc1 = _mm256_setzero_si256();
+            __m256i acc2 = _mm256_setzero_si256();
+            __m256i acc3 = _mm256_setzero_si256();
+            // Block size is at least 512 bytes and a multiple of 128
+            for (uint i = 0; i < blockSize; i += 128) {
+                acc0 = _mm256_xor_si256(acc0, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buffer + i)));
+                acc1 = _mm256_xor_si256(acc1, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buffer + i + 32)));
+                acc2 = _mm256_xor_si256(acc2, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buffer + i + 64)));
+                acc3 = _mm256_xor_si256(acc3, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buffer + i + 96)));
+            }
+            const __m256i acc = _mm256_xor_si256(_mm256_xor_si256(acc0, acc1), _mm256_xor_si256(acc2, acc3));
+            const __m128i half = _mm_xor_si128(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+            uint64_t sum = static_cast<uint64_t>(_mm_cvtsi128_si64(half)) ^ static_cast<uint64_t>(_mm_extract_epi64(half, 1));
+            sum ^= (sum >> 32);
+            sum ^= (sum >> 16);
+            if ((sum & 0xFFFF) != 0)
+                return block;
+        }
+        return blocks;
+    }
+
+    __attribute__((target("avx512f")))
+    uint BlockSum::verifyAvx512(const uint8_t* buffer, uint blockSize, uint blocks) {
+        for (uint block = 0; block < blocks; ++block, buffer += blockSize) {
+            __m512i acc0 = _mm512_setzero_si512();
+            __m512i acc1 = _mm512_setzero_si512();
+            for (uint i = 0; i < blockSize; i += 128) {
+                acc0 = _mm512_xor_si512(acc0, _mm512_loadu_si512(buffer + i));
+                acc1 = _mm512_xor_si512(acc1, _mm512_loadu_si512(buffer + i + 64));
+            }
+            const __m512i acc = _mm512_xor_si512(acc0, acc1);
+            const __m256i quarter = _mm256_xor_si256(_mm512_castsi512_si256(acc), _mm512_extracti64x4_epi64(acc, 1));
+            const __m128i half = _mm_xor_si128(_mm256_castsi256_si128(quarter), _mm256_extracti128_si256(quarter, 1));
+            uint64_t sum = static_cast<uint64_t>(_mm_cvtsi128_si64(half)) ^ static_cast<uint64_t>(_mm_extract_epi64(half, 1));
+            sum ^= (sum >> 32);
+            sum ^= (sum >> 16);
+            if ((sum & 0xFFFF) != 0)
+                return block;
+        }
+        return blocks;
+    }
+#elif defined(__aarch64__)
+    uint BlockSum::verifyNeon(const uint8_t* buffer, uint blockSize, uint blocks) {
+        for (uint block = 0; block < blocks; ++block, buffer += blockSize) {
+            uint64x2_t acc0 = vdupq_n_u64(0);
+            uint64x2_t acc1 = vdupq_n_u64(0);
+            uint64x2_t acc2 = vdupq_n_u64(0);
+            uint64x2_t acc3 = vdupq_n_u64(0);
+            for (uint i = 0; i < blockSize; i += 64) {
+                acc0 = veorq_u64(acc0, vld1q_u64(reinterpret_cast<const uint64_t*>(buffer + i)));
+                acc1 = veorq_u64(acc1, vld1q_u64(reinterpret_cast<const uint64_t*>(buffer + i + 16)));
+                acc2 = veorq_u64(acc2, vld1q_u64(reinterpret_cast<const uint64_t*>(buffer + i + 32)));
+                acc3 = veorq_u64(acc3, vld1q_u64(reinterpret_cast<const uint64_t*>(buffer + i + 48)));
+            }
+            const uint64x2_t acc = veorq_u64(veorq_u64(acc0, acc1), veorq_u64(acc2, acc3));
+            uint64_t sum = vgetq_lane_u64(acc, 0) ^ vgetq_lane_u64(acc, 1);
+            sum ^= (sum >> 32);
+            sum ^= (sum >> 16);
+            if ((sum & 0xFFFF) != 0)
+                return block;
+        }
+        return blocks;
+    }
+#endif
+}
@@ -0,0 +1,62 @@
+/* Header for BlockSum class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <cstdint>
+
+#include "../common/types/Types.h"
+
+#ifndef BLOCK_SUM_H_
+#define BLOCK_SUM_H_
+
+namespace OpenLogReplicator {
+    // Redo block checksum verification for runs of blocks, vectorized where the cpu allows.
+    // Since the checksum field is a part of the XOR-ed data, a block is valid when its folded XOR is zero.
+    class BlockSum final {
+    public:
+        enum class ENGINE : unsigned char {
+            SCALAR, AVX2, AVX512, NEON
+        };
+
+    protected:
+        using verifyFunc = uint (*)(const uint8_t* buffer, uint blockSize, uint blocks);
+
+        static verifyFunc verifyImpl;
+        static ENGINE engine;
+
+        static uint verifyScalar(const uint8_t* buffer, uint blockSize, uint blocks);
+#if defined(__x86_64__)
+        static uint verifyAvx2(const uint8_t* buffer, uint blockSize, uint blocks);
+        static uint verifyAvx512(const uint8_t* buffer, uint blockSize, uint blocks);
+#elif defined(__aarch64__)
+        static uint verifyNeon(const uint8_t* buffer, uint blockSize, uint blocks);
+#endif
+
+    public:
+        static void initialize();
+        [[nodiscard]] static ENGINE getEngine();
+        [[nodiscard]] static const char* getEngineName();
+
+        // Number of leading blocks in the run with a valid checksum
+        static uint verify(const uint8_t* buffer, uint blockSize, uint blocks) {
+            return verifyImpl(buffer, blockSize, blocks);
+        }
+    };
+}
+
+#endif
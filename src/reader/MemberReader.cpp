@@ -0,0 +1,166 @@
+/* Thread reading one member of a multiplexed redo log group
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#define _LARGEFILE_SOURCE
+enum {
+_FILE_OFFSET_BITS = 64
+};
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <thread>
+#include <unistd.h>
+
+#include "../common/Ctx.h"
+#include "../common/exception/RuntimeException.h"
+#include "MemberReader.h"
+
+namespace OpenLogReplicator {
+    MemberReader::MemberReader(Ctx* newCtx, std::string newAlias, FutexEvent* newEventDone) :
+            Thread(newCtx, std::move(newAlias)),
+            eventDone(newEventDone) {
+        // Aligned for O_DIRECT
+        buffer = reinterpret_cast<uint8_t*>(aligned_alloc(Ctx::MEMORY_ALIGNMENT, Ctx::MEMORY_CHUNK_SIZE));
+        if (unlikely(buffer == nullptr))
+            throw RuntimeException(10016, "couldn't allocate " + std::to_string(Ctx::MEMORY_CHUNK_SIZE) +
+                                          " bytes memory for: member read buffer");
+    }
+
+    MemberReader::~MemberReader() {
+        redoClose();
+        free(buffer);
+        buffer = nullptr;
+    }
+
+    bool MemberReader::submit(const std::string& newFileName, uint64_t newOffset, uint newSize) {
+        if (busy.load(std::memory_order_acquire))
+            return false;
+
+        std::unique_lock<std::mutex> const lck(mtx);
+        if (stopped || finished)
+            return false;
+        fileName = newFileName;
+        offset = newOffset;
+        size = std::min(newSize, static_cast<uint>(Ctx::MEMORY_CHUNK_SIZE));
+        pending = true;
+        busy.store(true, std::memory_order_release);
+        condWork.notify_all();
+        return true;
+    }
+
+    void MemberReader::stop() {
+        std::unique_lock<std::mutex> const lck(mtx);
+        stopped = true;
+        condWork.notify_all();
+    }
+
+    void MemberReader::wakeUp() {
+        std::unique_lock<std::mutex> const lck(mtx);
+        condWork.notify_all();
+    }
+
+    void MemberReader::redoOpen() {
+        if (fileDes != -1 && openName == fileName)
+            return;
+        redoClose();
+
+        int flags = O_RDONLY;
+#if __linux__
+        if (!ctx->isFlagSet(Ctx::REDO_FLAGS::DIRECT_DISABLE))
+            flags |= O_DIRECT;
+#endif
+        contextSet(CONTEXT::OS, REASON::OS);
+        fileDes = open(fileName.c_str(), flags);
+        contextSet(CONTEXT::CPU);
+        if (fileDes != -1)
+            openName = fileName;
+    }
+
+    void MemberReader::redoClose() {
+        if (fileDes == -1)
+            return;
+        contextSet(CONTEXT::OS, REASON::OS);
+        close(fileDes);
+        contextSet(CONTEXT::CPU);
+        fileDes = -1;
+        openName.clear();
+    }
+
+    void MemberReader::run() {
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
+            std::ostringstream ss;
+            ss << std::this_thread::get_id();
+            ctx->logTrace(Ctx::TRACE::THREADS, "member reader (" + ss.str() + ") start");
+        }
+
+        while (!ctx->hardShutdown) {
+            {
+                contextSet(CONTEXT::MUTEX, REASON::READER_MEMBER);
+                std::unique_lock<std::mutex> lck(mtx);
+                if (!pending) {
+                    if (stopped)
+                        break;
+                    contextSet(CONTEXT::WAIT, REASON::READER_MEMBER_NO_WORK);
+                    condWork.wait_for(lck, std::chrono::milliseconds(100));
+                    continue;
+                }
+                pending = false;
+            }
+            contextSet(CONTEXT::CPU);
+
+            redoOpen();
+            int bytes = -1;
+            int bytesError = 0;
+            if (fileDes != -1) {
+                contextSet(CONTEXT::OS, REASON::OS);
+                bytes = static_cast<int>(pread(fileDes, buffer, size, static_cast<int64_t>(offset)));
+                contextSet(CONTEXT::CPU);
+            }
+            if (bytes < 0)
+                bytesError = errno;
+            if (unlikely(ctx->isTraceSet(Ctx::TRACE::FILE)))
+                ctx->logTrace(Ctx::TRACE::FILE, "member read " + fileName + ", " + std::to_string(offset) + ", " + std::to_string(size) +
+                                                " returns " + std::to_string(bytes));
+
+            result = bytes;
+            error = bytesError;
+            busy.store(false, std::memory_order_release);
+            eventDone->notify();
+        }
+
+        {
+            std::unique_lock<std::mutex> const lck(mtx);
+            stopped = true;
+        }
+        if (busy.load(std::memory_order_acquire)) {
+            result = -1;
+            error = ECANCELED;
+        }
+        busy.store(false, std::memory_order_release);
+        eventDone->notify();
+
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
+            std::ostringstream ss;
+            ss << std::this_thread::get_id();
+            ctx->logTrace(Ctx::TRACE::THREADS, "member reader (" + ss.str() + ") stop");
+        }
+    }
+}
@@ -0,0 +1,85 @@
+/* Header for MemberReader class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef MEMBER_READER_H_
+#define MEMBER_READER_H_
+
+#include <condition_variable>
+#include <mutex>
+
+#include "../common/FutexEvent.h"
+#include "../common/Thread.h"
+
+namespace OpenLogReplicator {
+    // Reads one member of a multiplexed online redo log group on behalf of the reader. The reader hands the same range to two
+    // of them and takes the first result which passes the checksum, so a slow or damaged member doesn't stall the read.
+    // A read which lost the race is finished in the background, the buffer is not reused before that
+    class MemberReader final : public Thread {
+    protected:
+        std::mutex mtx;
+        std::condition_variable condWork;
+        // Signalled when a read is done, owned by the reader
+        FutexEvent* eventDone;
+        uint8_t* buffer{nullptr};
+        int fileDes{-1};
+        std::string openName;
+
+        std::string fileName;
+        uint64_t offset{0};
+        uint size{0};
+        bool pending{false};
+        bool stopped{false};
+        std::atomic<bool> busy{false};
+        int result{0};
+        int error{0};
+
+        void run() override;
+        void redoOpen();
+        void redoClose();
+
+    public:
+        MemberReader(Ctx* newCtx, std::string newAlias, FutexEvent* newEventDone);
+        ~MemberReader() override;
+
+        // False when the previous read is still in progress
+        [[nodiscard]] bool submit(const std::string& newFileName, uint64_t newOffset, uint newSize);
+        void stop();
+        void wakeUp() override;
+
+        [[nodiscard]] bool isBusy() const {
+            return busy.load(std::memory_order_acquire);
+        }
+
+        // Valid once isBusy() returned false after submit(), errno of the failed read is returned in newError
+        [[nodiscard]] int getResult(int& newError) const {
+            newError = error;
+            return result;
+        }
+
+        [[nodiscard]] const uint8_t* getBuffer() const {
+            return buffer;
+        }
+
+        std::string getName() const override {
+            return {"Reader: member " + alias};
+        }
+    };
+}
+
+#endif
@@ -24,16 +24,22 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include <cstring>
 #include <dirent.h>
 #include <fcntl.h>
+#include <sys/mman.h>
 #include <thread>
 #include <unistd.h>
 
 #include "../common/Clock.h"
 #include "../common/Ctx.h"
+#include "../common/Probes.h"
 #include "../common/RedoLogRecord.h"
 #include "../common/exception/RuntimeException.h"
 #include "../common/metrics/Metrics.h"
 #include "../common/types/Seq.h"
+#include "../metadata/PositionIndex.h"
+#include "BlockSum.h"
 #include "Reader.h"
+#include "RedoCache.h"
+#include "RedoCopy.h"
 
 namespace OpenLogReplicator {
     const char* Reader::REDO_MSG[]{"OK", "OVERWRITTEN", "FINISHED", "STOPPED", "SHUTDOWN", "EMPTY", "READ ERROR",
@@ -48,11 +54,21 @@ namespace OpenLogReplicator {
     }
 
     void Reader::initialize() {
+        BlockSum::initialize();
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::DISK)))
+            ctx->logTrace(Ctx::TRACE::DISK, "block checksum engine: " + std::string(BlockSum::getEngineName()));
+
         if (redoBufferList == nullptr) {
             redoBufferList = new uint8_t* [ctx->memoryChunksReadBufferMax];
             memset(reinterpret_cast<void*>(redoBufferList), 0, ctx->memoryChunksReadBufferMax * sizeof(uint8_t*));
         }
 
+        if (redoBufferTime == nullptr)
+            redoBufferTime = new std::atomic<time_ut>[ctx->memoryChunksReadBufferMax]{};
+
+        if (redoBufferMapped == nullptr)
+            redoBufferMapped = new bool[ctx->memoryChunksReadBufferMax]{};
+
         if (headerBuffer == nullptr) {
             headerBuffer = reinterpret_cast<uint8_t*>(aligned_alloc(Ctx::MEMORY_ALIGNMENT, PAGE_SIZE_MAX * 2));
             if (unlikely(headerBuffer == nullptr))
@@ -70,10 +86,11 @@ namespace OpenLogReplicator {
         contextSet(CONTEXT::MUTEX, REASON::READER_WAKE_UP);
         {
             std::unique_lock<std::mutex> const lck(mtx);
-            condBufferFull.notify_all();
             condReaderSleeping.notify_all();
             condParserSleeping.notify_all();
         }
+        eventData.notify();
+        eventSpace.notify();
         contextSet(CONTEXT::CPU);
     }
 
@@ -83,19 +100,108 @@ namespace OpenLogReplicator {
 
         delete[] redoBufferList;
         redoBufferList = nullptr;
+        delete[] redoBufferTime;
+        redoBufferTime = nullptr;
+        delete[] redoBufferMapped;
+        redoBufferMapped = nullptr;
 
         if (headerBuffer != nullptr) {
             free(headerBuffer);
             headerBuffer = nullptr;
         }
+    }
+
+    void Reader::copyClose() {
+        if (!fileCopyOpen)
+            return;
+
+        redoCopy->close(this, fileNameWrite, fileCopyComplete);
+        fileCopyOpen = false;
+        fileCopyComplete = false;
+    }
 
-        if (fileCopyDes != -1) {
-            close(fileCopyDes);
-            fileCopyDes = -1;
+    // Called with every header read from the source, the cached copy is looked up once for every log
+    void Reader::cacheCheck() {
+        const Seq sequenceHeader = Seq(ctx->read32(headerBuffer + blockSize + 8));
+        const typeResetlogs resetlogsHeader = ctx->read32(headerBuffer + blockSize + 160);
+        const Scn nextScnHeaderRead = ctx->readScn(headerBuffer + blockSize + 192);
+        if (cacheChecked && (cacheSequence != sequenceHeader || cacheResetlogs != resetlogsHeader))
+            cacheClose(false);
+        if (sequenceHeader == Seq::zero())
+            return;
+
+        if (!cacheChecked) {
+            cacheFd = redoCache->open(this, headerBuffer, blockSize, cacheName, cacheStart, cacheRead);
+            cacheEnd = cacheRead;
+            cacheSequence = sequenceHeader;
+            cacheResetlogs = resetlogsHeader;
+            cacheNextScn = nextScnHeaderRead;
+            cacheChecked = true;
+            if (cacheFd != -1 && unlikely(ctx->isTraceSet(Ctx::TRACE::FILE)))
+                ctx->logTrace(Ctx::TRACE::FILE, "file: " + fileName + " - cached: " + cacheName + " (" + std::to_string(cacheStart) + "/" +
+                                                std::to_string(cacheRead) + ")");
+        } else if (!cacheName.empty() && cacheNextScn != nextScnHeaderRead) {
+            redoCache->update(this, cacheName, headerBuffer, blockSize);
+            cacheNextScn = nextScnHeaderRead;
         }
     }
 
-    Reader::REDO_CODE Reader::checkBlockHeader(uint8_t* buffer, typeBlk blockNumber, bool showHint) {
+    void Reader::cacheClose(bool drop) {
+        if (!cacheName.empty())
+            redoCache->close(this, cacheName, cacheFd, drop);
+        cacheName.clear();
+        cacheFd = -1;
+        cacheStart = 0;
+        cacheRead = 0;
+        cacheEnd = 0;
+        // A dropped copy is started again with the next block read from the source
+        if (!drop)
+            cacheChecked = false;
+    }
+
+    void Reader::cacheAppend(uint64_t offset, const uint8_t* data, uint64_t size) {
+        if (!cacheChecked)
+            return;
+
+        if (cacheName.empty()) {
+            if (cacheEnd != 0)
+                return;
+            cacheName = redoCache->create(this, headerBuffer, blockSize, offset);
+            if (cacheName.empty()) {
+                // In use by another reader
+                cacheEnd = UINT64_MAX;
+                return;
+            }
+            cacheStart = offset;
+            cacheRead = offset;
+            cacheEnd = offset;
+        }
+
+        if (offset != cacheEnd)
+            return;
+        redoCache->append(this, cacheName, offset, data, size);
+        cacheEnd += size;
+    }
+
+    int Reader::sourceRead(uint8_t* buf, uint64_t offset, uint size) {
+        if (cacheFd != -1 && offset >= cacheStart && offset < cacheRead) {
+            const uint64_t toRead = std::min(static_cast<uint64_t>(size), cacheRead - offset);
+            contextSet(CONTEXT::OS, REASON::OS);
+            const int actualRead = static_cast<int>(pread(cacheFd, buf, toRead, static_cast<int64_t>(offset)));
+            contextSet(CONTEXT::CPU);
+            if (actualRead > 0) {
+                // sequence, offset, requested bytes, read bytes
+                OLR_PROBE4(reader_read, sequence.getData(), offset, size, actualRead);
+                return actualRead;
+            }
+            cacheClose(true);
+        }
+        const int actualRead = redoRead(buf, offset, size);
+        OLR_PROBE4(reader_read, sequence.getData(), offset, size, actualRead);
+        return actualRead;
+    }
+
+    Reader::REDO_CODE Reader::checkBlockHeader(uint8_t* buffer, typeBlk blockNumber, bool showHint, bool sumVerified) {
         if (buffer[0] == 0 && buffer[1] == 0)
             return REDO_CODE::EMPTY;
 
@@ -133,7 +239,7 @@ namespace OpenLogReplicator {
             return REDO_CODE::ERROR_BLOCK;
         }
 
-        if (!ctx->isDisableChecksSet(Ctx::DISABLE_CHECKS::BLOCK_SUM)) {
+        if (!sumVerified && !ctx->isDisableChecksSet(Ctx::DISABLE_CHECKS::BLOCK_SUM)) {
             const typeSum chSum = ctx->read16(buffer + 14);
             const typeSum chSumCalculated = calcChSum(buffer, blockSize);
             if (chSum != chSumCalculated) {
@@ -176,6 +282,7 @@ namespace OpenLogReplicator {
             ctx->error(40003, "file: " + fileName + " - " + strerror(errno));
             return REDO_CODE::ERROR_READ;
         }
+        RuntimeStats::add(ctx->stats.bytesRead, actualRead);
         if (ctx->metrics != nullptr)
             ctx->metrics->emitBytesRead(actualRead);
 
@@ -212,35 +319,28 @@ namespace OpenLogReplicator {
             return REDO_CODE::ERROR_READ;
         }
 
-        if (!ctx->redoCopyPath.empty()) {
+        if (redoCopy != nullptr) {
             if (static_cast<uint>(actualRead) > blockSize * 2)
                 actualRead = static_cast<int>(blockSize * 2);
 
             const Seq sequenceHeader = Seq(ctx->read32(headerBuffer + blockSize + 8));
-            if (fileCopySequence != sequenceHeader) {
-                if (fileCopyDes != -1) {
-                    close(fileCopyDes);
-                    fileCopyDes = -1;
-                }
-            }
+            if (fileCopySequence != sequenceHeader)
+                copyClose();
 
-            if (fileCopyDes == -1) {
+            if (!fileCopyOpen) {
                 fileNameWrite = ctx->redoCopyPath + "/" + database + "_" + sequenceHeader.toString() + ".arc";
-                fileCopyDes = open(fileNameWrite.c_str(), O_CREAT | O_WRONLY, S_IRUSR | S_IWUSR);
-                if (unlikely(fileCopyDes == -1))
-                    throw RuntimeException(10006, "file: " + fileNameWrite + " - open for writing returned: " + strerror(errno));
+                redoCopy->open(this, fileNameWrite);
                 ctx->info(0, "writing redo log copy to: " + fileNameWrite);
                 fileCopySequence = sequenceHeader;
+                fileCopyOpen = true;
             }
 
-            const int bytesWritten = pwrite(fileCopyDes, headerBuffer, actualRead, 0);
-            if (bytesWritten != actualRead) {
-                ctx->error(10007, "file: " + fileNameWrite + " - " + std::to_string(bytesWritten) + " bytes written instead of " +
-                                  std::to_string(actualRead) + ", code returned: " + strerror(errno));
-                return REDO_CODE::ERROR_WRITE;
-            }
+            redoCopy->write(this, fileNameWrite, 0, headerBuffer, actualRead);
         }
 
+        if (redoCache != nullptr)
+            cacheCheck();
+
         return REDO_CODE::OK;
     }
 
@@ -274,6 +374,7 @@ namespace OpenLogReplicator {
         firstTimeHeader = ctx->read32(headerBuffer + blockSize + 188);
         nextScnHeader = ctx->readScn(headerBuffer + blockSize + 192);
         nextTime = ctx->read32(headerBuffer + blockSize + 200);
+        miscFlags = ctx->read32(headerBuffer + blockSize + 236);
 
         if (numBlocksHeader != Ctx::ZERO_BLK && fileSize > static_cast<uint64_t>(numBlocksHeader) * blockSize && group == 0) {
             fileSize = static_cast<uint64_t>(numBlocksHeader) * blockSize;
@@ -309,7 +410,7 @@ namespace OpenLogReplicator {
         }
 
         uint badBlockCrcCount = 0;
-        retReload = checkBlockHeader(headerBuffer + blockSize, 1, false);
+        retReload = checkBlockHeader(headerBuffer + blockSize, 1, false, false);
         if (unlikely(ctx->isTraceSet(Ctx::TRACE::DISK)))
             ctx->logTrace(Ctx::TRACE::DISK, "block: 1 check: " + std::to_string(static_cast<uint>(retReload)));
 
@@ -321,7 +422,7 @@ namespace OpenLogReplicator {
             contextSet(CONTEXT::SLEEP);
             usleep(ctx->redoReadSleepUs);
             contextSet(CONTEXT::CPU);
-            retReload = checkBlockHeader(headerBuffer + blockSize, 1, false);
+            retReload = checkBlockHeader(headerBuffer + blockSize, 1, false, false);
             if (unlikely(ctx->isTraceSet(Ctx::TRACE::DISK)))
                 ctx->logTrace(Ctx::TRACE::DISK, "block: 1 check: " + std::to_string(static_cast<uint>(retReload)));
         }
@@ -350,6 +451,9 @@ namespace OpenLogReplicator {
             return REDO_CODE::ERROR_BAD_DATA;
         }
 
+        if (positionIndex != nullptr)
+            positionIndex->add(resetlogs, Seq(ctx->read32(headerBuffer + blockSize + 8)), firstScnHeader, nextScnHeader, firstTimeHeader);
+
         return retReload;
     }
 
@@ -371,11 +475,18 @@ namespace OpenLogReplicator {
             return false;
         }
 
-        bufferAllocate(redoBufferNum);
         if (unlikely(ctx->isTraceSet(Ctx::TRACE::DISK)))
             ctx->logTrace(Ctx::TRACE::DISK, "reading#1 " + fileName + " at (" + std::to_string(bufferStart) + "/" +
                                             std::to_string(bufferEnd) + "/" + std::to_string(bufferScan) + ") bytes: " + std::to_string(toRead));
-        const int actualRead = redoRead(redoBufferList[redoBufferNum] + redoBufferPos, bufferScan, toRead);
+        int actualRead;
+        if (redoMapping != nullptr) {
+            // The pages are faulted in here by the checks below, the parser finds them resident
+            bufferMap(redoBufferNum, bufferScan - redoBufferPos);
+            actualRead = static_cast<int>(toRead);
+        } else {
+            bufferAllocate(redoBufferNum);
+            actualRead = sourceRead(redoBufferList[redoBufferNum] + redoBufferPos, bufferScan, toRead);
+        }
 
         if (unlikely(ctx->isTraceSet(Ctx::TRACE::DISK)))
             ctx->logTrace(Ctx::TRACE::DISK, "reading#1 " + fileName + " at (" + std::to_string(bufferStart) + "/" +
@@ -385,29 +496,27 @@ namespace OpenLogReplicator {
             ret = REDO_CODE::ERROR_READ;
             return false;
         }
+        RuntimeStats::add(ctx->stats.bytesRead, actualRead);
         if (ctx->metrics != nullptr)
             ctx->metrics->emitBytesRead(actualRead);
 
-        if (actualRead > 0 && fileCopyDes != -1 && (ctx->redoVerifyDelayUs == 0 || group == 0)) {
-            const int bytesWritten = pwrite(fileCopyDes, redoBufferList[redoBufferNum] + redoBufferPos, actualRead,
-                                            static_cast<int64_t>(bufferEnd));
-            if (bytesWritten != actualRead) {
-                ctx->error(10007, "file: " + fileNameWrite + " - " + std::to_string(bytesWritten) + " bytes written instead of " +
-                                  std::to_string(actualRead) + ", code returned: " + strerror(errno));
-                ret = REDO_CODE::ERROR_WRITE;
-                return false;
-            }
-        }
+        if (actualRead > 0 && fileCopyOpen && (ctx->redoVerifyDelayUs == 0 || group == 0))
+            redoCopy->write(this, fileNameWrite, bufferEnd, redoBufferList[redoBufferNum] + redoBufferPos, actualRead);
 
         const typeBlk maxNumBlock = actualRead / blockSize;
         const typeBlk bufferScanBlock = bufferScan / blockSize;
         uint goodBlocks = 0;
         REDO_CODE currentRet = REDO_CODE::OK;
 
+        // Verify checksums of the whole run at once, the per block check then only covers the failing block
+        uint sumVerified = 0;
+        if (!ctx->isDisableChecksSet(Ctx::DISABLE_CHECKS::BLOCK_SUM))
+            sumVerified = BlockSum::verify(redoBufferList[redoBufferNum] + redoBufferPos, blockSize, maxNumBlock);
+
         // Check which blocks are good
         for (typeBlk numBlock = 0; numBlock < maxNumBlock; ++numBlock) {
             currentRet = checkBlockHeader(redoBufferList[redoBufferNum] + redoBufferPos + (numBlock * blockSize), bufferScanBlock + numBlock,
-                                          ctx->redoVerifyDelayUs == 0 || group == 0);
+                                          ctx->redoVerifyDelayUs == 0 || group == 0, numBlock < sumVerified);
             if (unlikely(ctx->isTraceSet(Ctx::TRACE::DISK)))
                 ctx->logTrace(Ctx::TRACE::DISK, "block: " + std::to_string(bufferScanBlock + numBlock) + " check: " +
                                                 std::to_string(static_cast<uint>(currentRet)));
@@ -417,6 +526,14 @@ namespace OpenLogReplicator {
             ++goodBlocks;
         }
 
+        // A block of the local redo cache which failed the checks is read again from the source
+        if (currentRet != REDO_CODE::OK && cacheFd != -1 && bufferScan >= cacheStart && bufferScan + (goodBlocks * blockSize) < cacheRead) {
+            cacheClose(true);
+            if (goodBlocks == 0)
+                return true;
+            currentRet = REDO_CODE::OK;
+        }
+
         // Partial online redo log file
         if (goodBlocks == 0 && group == 0) {
             if (nextScnHeader != Scn::none()) {
@@ -453,6 +570,8 @@ namespace OpenLogReplicator {
 
         lastRead = goodBlocks * blockSize;
         lastReadTime = ctx->clock->getTimeUt();
+        if (group != 0)
+            pollSchedule();
         if (goodBlocks > 0) {
             if (ctx->redoVerifyDelayUs > 0 && group != 0) {
                 bufferScan += goodBlocks * blockSize;
@@ -462,14 +581,11 @@ namespace OpenLogReplicator {
                     *readTimeP = lastReadTime;
                 }
             } else {
-                {
-                    contextSet(CONTEXT::MUTEX, REASON::READER_READ1);
-                    std::unique_lock<std::mutex> const lck(mtx);
-                    bufferEnd += goodBlocks * blockSize;
-                    bufferScan = bufferEnd;
-                    condParserSleeping.notify_all();
-                }
-                contextSet(CONTEXT::CPU);
+                cacheAppend(bufferEnd, redoBufferList[redoBufferNum] + redoBufferPos, goodBlocks * blockSize);
+                redoBufferTime[redoBufferNum].store(lastReadTime, std::memory_order_relaxed);
+                bufferEnd += goodBlocks * blockSize;
+                bufferScan = bufferEnd;
+                eventData.notify();
             }
         }
 
@@ -488,6 +604,36 @@ namespace OpenLogReplicator {
         return true;
     }
 
+    void Reader::pollSchedule() {
+        const time_ut sleepMin = std::min(POLL_SLEEP_MIN_US, static_cast<time_ut>(ctx->redoReadSleepUs));
+        const time_ut sleepMax = static_cast<time_ut>(ctx->redoReadSleepMaxUs);
+
+        if (!reachedZero) {
+            // Gaps longer than the idle sleep are idle periods, not the write rate
+            if (lastAdvanceTime != 0 && lastReadTime - lastAdvanceTime <= sleepMax) {
+                const time_ut interval = lastReadTime - lastAdvanceTime;
+                advanceIntervalUs = (advanceIntervalUs == 0 ? interval : (advanceIntervalUs * 3 + interval) / 4);
+            }
+            lastAdvanceTime = lastReadTime;
+            pollSleepUs = 0;
+            nextPollTime = lastReadTime;
+            return;
+        }
+
+        pollSleepUs = (pollSleepUs == 0 ? sleepMin : std::min(pollSleepUs * 2, sleepMax));
+        nextPollTime = lastReadTime + pollSleepUs;
+
+        if (advanceIntervalUs == 0 || lastAdvanceTime == 0)
+            return;
+
+        // The write rate is known: poll when the next LWN is due, not sooner than the floor and not later than the idle sleep
+        const time_ut expectedTime = lastAdvanceTime + advanceIntervalUs;
+        if (expectedTime > lastReadTime + sleepMin && expectedTime < lastReadTime + sleepMax)
+            nextPollTime = expectedTime;
+        else if (expectedTime <= lastReadTime && expectedTime + advanceIntervalUs > lastReadTime + sleepMin)
+            nextPollTime = std::min(nextPollTime, expectedTime + advanceIntervalUs);
+    }
+
     bool Reader::read2() {
         uint maxNumBlock = (bufferScan - bufferEnd) / blockSize;
         uint goodBlocks = 0;
@@ -526,7 +672,7 @@ namespace OpenLogReplicator {
             if (unlikely(ctx->isTraceSet(Ctx::TRACE::DISK)))
                 ctx->logTrace(Ctx::TRACE::DISK, "reading#2 " + fileName + " at (" + std::to_string(bufferStart) + "/" +
                                                 std::to_string(bufferEnd) + "/" + std::to_string(bufferScan) + ") bytes: " + std::to_string(toRead));
-            const int actualRead = redoRead(redoBufferList[redoBufferNum] + redoBufferPos, bufferEnd, toRead);
+            const int actualRead = sourceRead(redoBufferList[redoBufferNum] + redoBufferPos, bufferEnd, toRead);
 
             if (unlikely(ctx->isTraceSet(Ctx::TRACE::DISK)))
                 ctx->logTrace(Ctx::TRACE::DISK, "reading#2 " + fileName + " at (" + std::to_string(bufferStart) + "/" +
@@ -537,29 +683,26 @@ namespace OpenLogReplicator {
                 ret = REDO_CODE::ERROR_READ;
                 return false;
             }
+            RuntimeStats::add(ctx->stats.bytesRead, actualRead);
             if (ctx->metrics != nullptr)
                 ctx->metrics->emitBytesRead(actualRead);
 
-            if (actualRead > 0 && fileCopyDes != -1) {
-                const int bytesWritten = pwrite(fileCopyDes, redoBufferList[redoBufferNum] + redoBufferPos, actualRead,
-                                                static_cast<int64_t>(bufferEnd));
-                if (bytesWritten != actualRead) {
-                    ctx->error(10007, "file: " + fileNameWrite + " - " + std::to_string(bytesWritten) +
-                                      " bytes written instead of " + std::to_string(actualRead) + ", code returned: " + strerror(errno));
-                    ret = REDO_CODE::ERROR_WRITE;
-                    return false;
-                }
-            }
+            if (actualRead > 0 && fileCopyOpen)
+                redoCopy->write(this, fileNameWrite, bufferEnd, redoBufferList[redoBufferNum] + redoBufferPos, actualRead);
 
             readBlocks = true;
             REDO_CODE currentRet = REDO_CODE::OK;
             maxNumBlock = actualRead / blockSize;
             const typeBlk bufferEndBlock = bufferEnd / blockSize;
 
+            uint sumVerified = 0;
+            if (!ctx->isDisableChecksSet(Ctx::DISABLE_CHECKS::BLOCK_SUM))
+                sumVerified = BlockSum::verify(redoBufferList[redoBufferNum] + redoBufferPos, blockSize, maxNumBlock);
+
             // Check which blocks are good
             for (uint numBlock = 0; numBlock < maxNumBlock; ++numBlock) {
                 currentRet = checkBlockHeader(redoBufferList[redoBufferNum] + redoBufferPos + (numBlock * blockSize),
-                                              bufferEndBlock + numBlock, true);
+                                              bufferEndBlock + numBlock, true, numBlock < sumVerified);
                 if (unlikely(ctx->isTraceSet(Ctx::TRACE::DISK)))
                     ctx->logTrace(Ctx::TRACE::DISK, "block: " + std::to_string(bufferEndBlock + numBlock) + " check: " +
                                                     std::to_string(static_cast<uint>(currentRet)));
@@ -573,18 +716,20 @@ namespace OpenLogReplicator {
             if (currentRet == REDO_CODE::OK && group > 0)
                 currentRet = reloadHeader();
 
+            if (currentRet != REDO_CODE::OK && cacheFd != -1 && bufferEnd >= cacheStart && bufferEnd < cacheRead) {
+                cacheClose(true);
+                return true;
+            }
+
             if (currentRet != REDO_CODE::OK) {
                 ret = currentRet;
                 return false;
             }
 
-            {
-                contextSet(CONTEXT::MUTEX, REASON::READER_READ2);
-                std::unique_lock<std::mutex> const lck(mtx);
-                bufferEnd += actualRead;
-                condParserSleeping.notify_all();
-            }
-            contextSet(CONTEXT::CPU);
+            cacheAppend(bufferEnd, redoBufferList[redoBufferNum] + redoBufferPos, actualRead);
+            redoBufferTime[redoBufferNum].store(loopTime, std::memory_order_relaxed);
+            bufferEnd += actualRead;
+            eventData.notify();
         }
 
         return true;
@@ -596,6 +741,7 @@ namespace OpenLogReplicator {
                 contextSet(CONTEXT::MUTEX, REASON::READER_MAIN1);
                 std::unique_lock<std::mutex> lck(mtx);
                 condParserSleeping.notify_all();
+                eventData.notify();
 
                 if (status == STATUS::SLEEPING && !ctx->softShutdown) {
                     if (unlikely(ctx->isTraceSet(Ctx::TRACE::SLEEP)))
@@ -624,15 +770,14 @@ namespace OpenLogReplicator {
                     status = STATUS::SLEEPING;
                     condParserSleeping.notify_all();
                 }
+                eventData.notify();
                 contextSet(CONTEXT::CPU);
                 continue;
             }
 
             if (status == STATUS::UPDATE) {
-                if (fileCopyDes != -1) {
-                    close(fileCopyDes);
-                    fileCopyDes = -1;
-                }
+                copyClose();
+                cacheClose(false);
 
                 sumRead = 0;
                 sumTime = 0;
@@ -652,6 +797,7 @@ namespace OpenLogReplicator {
                     status = STATUS::SLEEPING;
                     condParserSleeping.notify_all();
                 }
+                eventData.notify();
                 contextSet(CONTEXT::CPU);
             } else if (status == STATUS::READ) {
                 if (unlikely(ctx->isTraceSet(Ctx::TRACE::DISK)))
@@ -662,6 +808,9 @@ namespace OpenLogReplicator {
                 readTime = 0;
                 bufferScan = bufferEnd;
                 reachedZero = false;
+                pollSleepUs = 0;
+                nextPollTime = 0;
+                lastAdvanceTime = 0;
 
                 while (!ctx->softShutdown && status == STATUS::READ) {
                     loopTime = ctx->clock->getTimeUt();
@@ -681,17 +830,20 @@ namespace OpenLogReplicator {
                     }
 
                     // Buffer full?
-                    if (bufferStart + ctx->bufferSizeMax == bufferEnd) {
-                        contextSet(CONTEXT::MUTEX, REASON::READER_FULL);
-                        std::unique_lock<std::mutex> lck(mtx);
-                        if (!ctx->softShutdown && bufferStart + ctx->bufferSizeMax == bufferEnd) {
+                    const uint64_t bufferSize = (bufferSizeLimit > 0 ? bufferSizeLimit.load() : ctx->bufferSizeMax);
+                    if (bufferStart + bufferSize <= bufferEnd) {
+                        auto spaceReady = [this] {
+                            return ctx->softShutdown || status != STATUS::READ ||
+                                   bufferStart + (bufferSizeLimit > 0 ? bufferSizeLimit.load() : ctx->bufferSizeMax) > bufferEnd;
+                        };
+                        if (!spaceReady()) {
                             if (unlikely(ctx->isTraceSet(Ctx::TRACE::SLEEP)))
                                 ctx->logTrace(Ctx::TRACE::SLEEP, "Reader:mainLoop:bufferFull");
                             contextSet(CONTEXT::WAIT, REASON::READER_BUFFER_FULL);
-                            condBufferFull.wait(lck);
+                            eventSpace.park(spaceReady);
                             contextSet(CONTEXT::CPU);
-                            continue;
                         }
+                        continue;
                     }
 
                     if (bufferEnd < bufferScan)
@@ -699,8 +851,9 @@ namespace OpenLogReplicator {
                             break;
 
                     // #1 read
-                    if (bufferScan < fileSize && (bufferIsFree() || (bufferScan % Ctx::MEMORY_CHUNK_SIZE) > 0)
-                        && (!reachedZero || lastReadTime + static_cast<time_t>(ctx->redoReadSleepUs) < loopTime))
+                    if (bufferScan < fileSize && (redoMapping != nullptr || bufferIsFree() || (bufferScan % Ctx::MEMORY_CHUNK_SIZE) > 0)
+                        && (bufferSizeLimit == 0 || bufferScan < bufferStart + bufferSize)
+                        && (!reachedZero || nextPollTime <= loopTime))
                         if (!read1())
                             break;
 
@@ -718,7 +871,14 @@ namespace OpenLogReplicator {
 
                     // Sleep some time
                     if (!readBlocks) {
-                        if (readTime == 0) {
+                        if (reachedZero && readTime == 0) {
+                            const time_ut nowTime = ctx->clock->getTimeUt();
+                            if (nextPollTime > nowTime) {
+                                contextSet(CONTEXT::SLEEP);
+                                usleep(nextPollTime - nowTime);
+                                contextSet(CONTEXT::CPU);
+                            }
+                        } else if (readTime == 0) {
                             contextSet(CONTEXT::SLEEP);
                             usleep(ctx->redoReadSleepUs);
                             contextSet(CONTEXT::CPU);
@@ -739,12 +899,16 @@ namespace OpenLogReplicator {
                     }
                 }
 
+                if (ret == REDO_CODE::FINISHED)
+                    fileCopyComplete = true;
+
                 {
                     contextSet(CONTEXT::MUTEX, REASON::READER_SLEEP2);
                     std::unique_lock<std::mutex> const lck(mtx);
                     status = STATUS::SLEEPING;
                     condParserSleeping.notify_all();
                 }
+                eventData.notify();
                 contextSet(CONTEXT::CPU);
             }
         }
@@ -781,10 +945,8 @@ namespace OpenLogReplicator {
         }
 
         redoClose();
-        if (fileCopyDes != -1) {
-            close(fileCopyDes);
-            fileCopyDes = -1;
-        }
+        copyClose();
+        cacheClose(false);
 
         if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
             std::ostringstream ss;
@@ -817,6 +979,7 @@ namespace OpenLogReplicator {
 
     void Reader::bufferFree(Thread* t, uint num) {
         uint8_t* buffer;
+        bool mapped;
         {
             t->contextSet(CONTEXT::MUTEX, REASON::READER_FREE);
             std::unique_lock<std::mutex> const lck(mtx);
@@ -826,13 +989,59 @@ namespace OpenLogReplicator {
             }
             buffer = redoBufferList[num];
             redoBufferList[num] = nullptr;
-            ++ctx->bufferSizeFree;
+            mapped = redoBufferMapped[num];
+            redoBufferMapped[num] = false;
+            if (!mapped)
+                ++ctx->bufferSizeFree;
         }
         t->contextSet(CONTEXT::CPU);
 
+        // The parser is past the mapped range, its pages are dropped instead of aging out of the page cache
+        if (mapped) {
+            const uint64_t offset = buffer - redoMapping;
+            if (offset < redoMappingSize)
+                madvise(buffer, std::min(Ctx::MEMORY_CHUNK_SIZE, redoMappingSize - offset), MADV_DONTNEED);
+            return;
+        }
+
         ctx->freeMemoryChunk(this, Ctx::MEMORY::READER, buffer);
     }
 
+    // The buffer points into the mapping and takes no memory chunk
+    void Reader::bufferMap(uint num, uint64_t offset) {
+        {
+            contextSet(CONTEXT::MUTEX, REASON::READER_ALLOCATE1);
+            std::unique_lock<std::mutex> const lck(mtx);
+            if (redoBufferList[num] != nullptr) {
+                contextSet(CONTEXT::CPU);
+                return;
+            }
+            redoBufferList[num] = const_cast<uint8_t*>(redoMapping) + offset;
+            redoBufferMapped[num] = true;
+        }
+        contextSet(CONTEXT::CPU);
+
+        madvise(const_cast<uint8_t*>(redoMapping) + offset, std::min(Ctx::MEMORY_CHUNK_SIZE, redoMappingSize - offset), MADV_WILLNEED);
+    }
+
+    // Called before the mapping is removed, the buffers pointing into it are forgotten without touching the pages
+    void Reader::bufferUnmapAll() {
+        if (redoBufferMapped == nullptr)
+            return;
+
+        contextSet(CONTEXT::MUTEX, REASON::READER_FREE);
+        {
+            std::unique_lock<std::mutex> const lck(mtx);
+            for (uint num = 0; num < ctx->memoryChunksReadBufferMax; ++num) {
+                if (!redoBufferMapped[num])
+                    continue;
+                redoBufferList[num] = nullptr;
+                redoBufferMapped[num] = false;
+            }
+        }
+        contextSet(CONTEXT::CPU);
+    }
+
     bool Reader::bufferIsFree() {
         bool isFree;
         {
@@ -940,7 +1149,6 @@ namespace OpenLogReplicator {
         const uint32_t largestLwn = ctx->read32(headerBuffer + blockSize + 268);
         ss << " Largest LWN: " << std::dec << largestLwn << " blocks\n";
 
-        const uint32_t miscFlags = ctx->read32(headerBuffer + blockSize + 236);
         const char* endOfRedo;
         if ((miscFlags & FLAGS_END) != 0)
             endOfRedo = "Yes";
@@ -1024,6 +1232,10 @@ namespace OpenLogReplicator {
         return FileOffset(bufferEnd);
     }
 
+    time_ut Reader::getBufferTime(uint num) const {
+        return redoBufferTime[num].load(std::memory_order_relaxed);
+    }
+
     Reader::REDO_CODE Reader::getRet() const {
         return ret;
     }
@@ -1044,6 +1256,11 @@ namespace OpenLogReplicator {
         return nextTime;
     }
 
+    // Redo log of a thread closed by the instance shutdown, archived by another instance of the RAC database
+    bool Reader::isClosedThread() const {
+        return (miscFlags & FLAGS_CLOSEDTHREAD) != 0;
+    }
+
     typeBlk Reader::getNumBlocks() const {
         return numBlocksHeader;
     }
@@ -1081,6 +1298,16 @@ namespace OpenLogReplicator {
         bufferEnd = newBufferEnd.getData();
     }
 
+    void Reader::setBufferSizeLimit(uint64_t newBufferSizeLimit) {
+        contextSet(CONTEXT::MUTEX, REASON::READER_SET_READ);
+        {
+            std::unique_lock<std::mutex> const lck(mtx);
+            bufferSizeLimit = newBufferSizeLimit;
+        }
+        eventSpace.notify();
+        contextSet(CONTEXT::CPU);
+    }
+
     bool Reader::checkRedoLog() {
         contextSet(CONTEXT::MUTEX, REASON::READER_CHECK_REDO);
         std::unique_lock<std::mutex> lck(mtx);
@@ -1088,8 +1315,8 @@ namespace OpenLogReplicator {
         sequence = Seq::zero();
         firstScn = Scn::none();
         nextScn = Scn::none();
-        condBufferFull.notify_all();
         condReaderSleeping.notify_all();
+        eventSpace.notify();
 
         while (status == STATUS::CHECK) {
             if (ctx->softShutdown)
@@ -1108,8 +1335,8 @@ namespace OpenLogReplicator {
             contextSet(CONTEXT::MUTEX, REASON::READER_UPDATE_REDO1);
             std::unique_lock<std::mutex> lck(mtx);
             status = STATUS::UPDATE;
-            condBufferFull.notify_all();
             condReaderSleeping.notify_all();
+            eventSpace.notify();
 
             while (status == STATUS::UPDATE) {
                 if (ctx->softShutdown)
@@ -1138,43 +1365,40 @@ namespace OpenLogReplicator {
             contextSet(CONTEXT::MUTEX, REASON::READER_SET_READ);
             std::unique_lock<std::mutex> const lck(mtx);
             status = STATUS::READ;
-            condBufferFull.notify_all();
             condReaderSleeping.notify_all();
         }
+        eventSpace.notify();
         contextSet(CONTEXT::CPU);
     }
 
     void Reader::confirmReadData(FileOffset confirmedBufferStart) {
-        contextSet(CONTEXT::MUTEX, REASON::READER_CONFIRM);
-        {
-            std::unique_lock<std::mutex> const lck(mtx);
-            bufferStart = confirmedBufferStart.getData();
-            if (status == STATUS::READ) {
-                condBufferFull.notify_all();
-            }
-        }
-        contextSet(CONTEXT::CPU);
+        bufferStart = confirmedBufferStart.getData();
+        if (status == STATUS::READ)
+            eventSpace.notify();
     }
 
     bool Reader::checkFinished(Thread* t, FileOffset confirmedBufferStart) {
-        t->contextSet(CONTEXT::MUTEX, REASON::READER_CHECK_FINISHED);
-        {
-            std::unique_lock<std::mutex> lck(mtx);
-            if (bufferStart < confirmedBufferStart.getData())
-                bufferStart = confirmedBufferStart.getData();
-
-            // All work done
-            if (confirmedBufferStart.getData() == bufferEnd) {
-                if (ret == REDO_CODE::STOPPED || ret == REDO_CODE::OVERWRITTEN || ret == REDO_CODE::FINISHED || status == STATUS::SLEEPING) {
-                    t->contextSet(CONTEXT::CPU);
-                    return true;
-                }
-                if (unlikely(ctx->isTraceSet(Ctx::TRACE::SLEEP)))
-                    ctx->logTrace(Ctx::TRACE::SLEEP, "Reader:checkFinished");
-                t->contextSet(CONTEXT::WAIT, REASON::READER_FINISHED);
-                condParserSleeping.wait(lck);
-            }
-        }
+        if (bufferStart < confirmedBufferStart.getData())
+            bufferStart = confirmedBufferStart.getData();
+
+        // All work done
+        if (confirmedBufferStart.getData() != bufferEnd)
+            return false;
+        if (ret == REDO_CODE::STOPPED || ret == REDO_CODE::OVERWRITTEN || ret == REDO_CODE::FINISHED || status == STATUS::SLEEPING)
+            return true;
+
+        // The next read is usually a few microseconds away, spin before parking
+        auto dataReady = [this, confirmedBufferStart] {
+            return confirmedBufferStart.getData() != bufferEnd || ret == REDO_CODE::STOPPED || ret == REDO_CODE::OVERWRITTEN ||
+                   ret == REDO_CODE::FINISHED || status == STATUS::SLEEPING;
+        };
+        if (FutexEvent::spin(dataReady))
+            return false;
+
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::SLEEP)))
+            ctx->logTrace(Ctx::TRACE::SLEEP, "Reader:checkFinished");
+        t->contextSet(CONTEXT::WAIT, REASON::READER_FINISHED);
+        eventData.park(dataReady);
         t->contextSet(CONTEXT::CPU);
         return false;
     }
@@ -20,6 +20,7 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include <atomic>
 #include <vector>
 
+#include "../common/FutexEvent.h"
 #include "../common/Thread.h"
 #include "../common/types/FileOffset.h"
 #include "../common/types/Scn.h"
@@ -31,6 +32,10 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #define READER_H_
 
 namespace OpenLogReplicator {
+    class PositionIndex;
+    class RedoCache;
+    class RedoCopy;
+
     class Reader : public Thread {
     public:
         enum class REDO_CODE : unsigned char {
@@ -52,11 +57,26 @@ namespace OpenLogReplicator {
 
         static constexpr uint PAGE_SIZE_MAX{4096};
         static constexpr uint BAD_CDC_MAX_CNT{20};
+        // Shortest sleep between polls of an online redo log that just advanced
+        static constexpr time_ut POLL_SLEEP_MIN_US{2000};
 
         std::string database;
-        int fileCopyDes{-1};
         uint64_t fileSize{0};
         Seq fileCopySequence;
+        bool fileCopyOpen{false};
+        // Set when the whole log was read, the copy is then final
+        bool fileCopyComplete{false};
+        // Copy in the local redo cache, blocks from cacheStart to cacheRead are read from it and blocks read from the source
+        // at cacheEnd are appended to it
+        std::string cacheName;
+        int cacheFd{-1};
+        bool cacheChecked{false};
+        Seq cacheSequence;
+        typeResetlogs cacheResetlogs{0};
+        Scn cacheNextScn{Scn::none()};
+        uint64_t cacheStart{0};
+        uint64_t cacheRead{0};
+        uint64_t cacheEnd{0};
         bool hintDisplayed{false};
         bool configuredBlockSum;
         bool readBlocks{false};
@@ -75,6 +95,7 @@ namespace OpenLogReplicator {
         Scn nextScn{Scn::none()};
         Scn nextScnHeader{Scn::none()};
         Time nextTime{0};
+        uint32_t miscFlags{0};
         uint blockSize{0};
         uint64_t sumRead{0};
         uint64_t sumTime{0};
@@ -83,22 +104,47 @@ namespace OpenLogReplicator {
         time_ut lastReadTime{0};
         time_ut readTime{0};
         time_ut loopTime{0};
+        // Adaptive polling: the sleep doubles with every empty poll, and the mean interval between reads that advanced
+        // predicts when the next LWN is written
+        time_ut pollSleepUs{0};
+        time_ut nextPollTime{0};
+        time_ut lastAdvanceTime{0};
+        time_ut advanceIntervalUs{0};
 
         std::mutex mtx;
         std::atomic<uint64_t> bufferStart{0};
         std::atomic<uint64_t> bufferEnd{0};
         std::atomic<STATUS> status{STATUS::SLEEPING};
         std::atomic<REDO_CODE> ret{REDO_CODE::OK};
-        std::condition_variable condBufferFull;
+        // Cap on buffered data when reading ahead, 0 means ctx->bufferSizeMax
+        std::atomic<uint64_t> bufferSizeLimit{0};
         std::condition_variable condReaderSleeping;
         std::condition_variable condParserSleeping;
+        // Hot path of the handoff, bufferEnd moved by the reader and bufferStart moved by the parser: the chunks of
+        // redoBufferList form a single producer single consumer ring, mtx is left for the status changes
+        FutexEvent eventData;
+        FutexEvent eventSpace;
+        // Archived redo log mapped read-only by the subclass, the buffers of the ring then point into the mapping instead of
+        // holding a copy, nothing writes to the buffers of an archived redo log
+        const uint8_t* redoMapping{nullptr};
+        uint64_t redoMappingSize{0};
+        bool* redoBufferMapped{nullptr};
+
+        void pollSchedule();
+        void copyClose();
+        void cacheCheck();
+        void cacheClose(bool drop);
+        void cacheAppend(uint64_t offset, const uint8_t* data, uint64_t size);
+        int sourceRead(uint8_t* buf, uint64_t offset, uint size);
+        void bufferMap(uint num, uint64_t offset);
+        void bufferUnmapAll();
 
         virtual void redoClose() = 0;
         virtual REDO_CODE redoOpen() = 0;
         virtual int redoRead(uint8_t* buf, uint64_t offset, uint size) = 0;
         virtual uint readSize(uint prevRead);
         virtual REDO_CODE reloadHeaderRead();
-        REDO_CODE checkBlockHeader(uint8_t* buffer, typeBlk blockNumber, bool showHint);
+        REDO_CODE checkBlockHeader(uint8_t* buffer, typeBlk blockNumber, bool showHint, bool sumVerified);
         REDO_CODE reloadHeader();
         bool read1();
         bool read2();
@@ -107,7 +153,16 @@ namespace OpenLogReplicator {
     public:
         const static char* REDO_MSG[static_cast<uint>(REDO_CODE::CNT)];
         uint8_t** redoBufferList{nullptr};
+        // Time of the last read which made data of the chunk available to the parser
+        std::atomic<time_ut>* redoBufferTime{nullptr};
         std::vector<std::string> paths;
+        // Mapped names of the other members of the online redo log group, read together with fileName by hedged reads
+        std::vector<std::string> members;
+        // Writer of the copy to redo-copy-path, nullptr when no copy is made
+        RedoCopy* redoCopy{nullptr};
+        // Local cache of the redo read, nullptr when not configured
+        RedoCache* redoCache{nullptr};
+        PositionIndex* positionIndex{nullptr};
         std::string fileName;
 
         Reader(Ctx* newCtx, std::string newAlias, std::string newDatabase, int newGroup, bool newConfiguredBlockSum);
@@ -124,11 +179,13 @@ namespace OpenLogReplicator {
         [[nodiscard]] uint getBlockSize() const;
         [[nodiscard]] FileOffset getBufferStart() const;
         [[nodiscard]] FileOffset getBufferEnd() const;
+        [[nodiscard]] time_ut getBufferTime(uint num) const;
         [[nodiscard]] REDO_CODE getRet() const;
         [[nodiscard]] Scn getFirstScn() const;
         [[nodiscard]] Scn getFirstScnHeader() const;
         [[nodiscard]] Scn getNextScn() const;
         [[nodiscard]] Time getNextTime() const;
+        [[nodiscard]] bool isClosedThread() const;
         [[nodiscard]] typeBlk getNumBlocks() const;
         [[nodiscard]] int getGroup() const;
         [[nodiscard]] Seq getSequence() const;
@@ -139,6 +196,7 @@ namespace OpenLogReplicator {
 
         void setRet(REDO_CODE newRet);
         void setBufferStartEnd(FileOffset newBufferStart, FileOffset newBufferEnd);
+        void setBufferSizeLimit(uint64_t newBufferSizeLimit);
         bool checkRedoLog();
         bool updateRedoLog();
         void setStatusRead();
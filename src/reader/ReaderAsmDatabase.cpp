@@ -0,0 +1,447 @@
+/* Class reading redo logs from ASM through the database connection
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+#include <unistd.h>
+
+#include "../common/Clock.h"
+#include "../common/Ctx.h"
+#include "../common/exception/RuntimeException.h"
+#include "../replicator/DatabaseConnection.h"
+#include "../replicator/DatabaseEnvironment.h"
+#include "../replicator/DatabaseStatement.h"
+#include "ReaderAsmDatabase.h"
+
+namespace OpenLogReplicator {
+    AsmSession::AsmSession(Ctx* newCtx, std::string newAlias, ReaderAsmDatabase* newReader) :
+            Thread(newCtx, std::move(newAlias)),
+            reader(newReader) {
+    }
+
+    AsmSession::~AsmSession() {
+        delete conn;
+        conn = nullptr;
+    }
+
+    void AsmSession::wakeUp() {
+        reader->sessionWakeUp();
+    }
+
+    void AsmSession::run() {
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
+            std::ostringstream ss;
+            ss << std::this_thread::get_id();
+            ctx->logTrace(Ctx::TRACE::THREADS, "asm session (" + ss.str() + ") start");
+        }
+
+        try {
+            reader->sessionRun(this);
+        } catch (RuntimeException& ex) {
+            ctx->error(ex.code, ex.msg);
+            ctx->stopHard();
+        }
+
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
+            std::ostringstream ss;
+            ss << std::this_thread::get_id();
+            ctx->logTrace(Ctx::TRACE::THREADS, "asm session (" + ss.str() + ") stop");
+        }
+    }
+
+    ReaderAsmDatabase::ReaderAsmDatabase(Ctx* newCtx, std::string newAlias, std::string newDatabase, int newGroup, bool newConfiguredBlockSum) :
+            ReaderFilesystem(newCtx, std::move(newAlias), std::move(newDatabase), newGroup, newConfiguredBlockSum),
+            ranges(ctx->asmSessions + 1),
+            rangeSize(ctx->asmRangeMb * 1024 * 1024) {
+        env = new DatabaseEnvironment(ctx);
+        env->initialize();
+        conn = new DatabaseConnection(env, ctx->asmUser, ctx->asmPassword, ctx->asmServer, ctx->asmSysAsm);
+    }
+
+    ReaderAsmDatabase::~ReaderAsmDatabase() {
+        {
+            std::unique_lock<std::mutex> const lck(fetchMtx);
+            stopped = true;
+            condFetch.notify_all();
+            condReady.notify_all();
+        }
+        for (AsmSession* session: sessions) {
+            ctx->finishThread(session);
+            delete session;
+        }
+        sessions.clear();
+        ReaderAsmDatabase::redoClose();
+
+        delete conn;
+        conn = nullptr;
+        delete env;
+        env = nullptr;
+    }
+
+    void ReaderAsmDatabase::sessionWakeUp() {
+        std::unique_lock<std::mutex> const lck(fetchMtx);
+        condFetch.notify_all();
+        condReady.notify_all();
+    }
+
+    void ReaderAsmDatabase::asmConnect(DatabaseConnection* connection) {
+        if (connection->connected)
+            return;
+
+        ctx->info(0, "connecting to ASM of " + database + " to " + connection->connectString);
+        connection->connect();
+    }
+
+    void ReaderAsmDatabase::asmOpen(DatabaseConnection* connection, const std::string& name, uint64_t& fileHandle) {
+        asmConnect(connection);
+
+        std::string fileNameBind(name);
+        uint64_t openType = fileType;
+        uint64_t openBlockSize = asmBlockSize;
+        uint64_t physicalBlockSize = 0;
+        uint64_t fileBlocks = 0;
+        DatabaseStatement stmt(connection);
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::SQL)))
+            ctx->logTrace(Ctx::TRACE::SQL, std::string(SQL_ASM_OPEN) + "\nPARAM1: " + name);
+        stmt.createStatement(SQL_ASM_OPEN);
+        stmt.bindString(1, fileNameBind);
+        stmt.bindUInt(2, openType);
+        stmt.bindUInt(3, openBlockSize);
+        stmt.bindUInt(4, fileHandle);
+        stmt.bindUInt(5, physicalBlockSize);
+        stmt.bindUInt(6, fileBlocks);
+        stmt.executeQuery();
+    }
+
+    void ReaderAsmDatabase::asmClose(DatabaseConnection* connection, uint64_t fileHandle) {
+        if (!connection->connected)
+            return;
+
+        try {
+            DatabaseStatement stmt(connection);
+            stmt.createStatement(SQL_ASM_CLOSE);
+            stmt.bindUInt(1, fileHandle);
+            stmt.executeQuery();
+        } catch (RuntimeException&) {
+            // The handle is gone with the session anyway
+            connection->disconnect();
+        }
+    }
+
+    // Reads whole logical blocks, up to READ_CALLS calls per round trip
+    void ReaderAsmDatabase::asmRead(DatabaseConnection* connection, uint64_t fileHandle, uint64_t offset, uint8_t* buf, uint64_t size) const {
+        const uint64_t callSize = (READ_CALL_MAX / asmBlockSize) * asmBlockSize;
+        uint8_t discard[READ_CALL_MAX];
+        uint16_t lengths[READ_CALLS];
+
+        DatabaseStatement stmt(connection);
+        stmt.createStatement(SQL_ASM_READ);
+        while (size > 0) {
+            uint64_t calls = std::min(static_cast<uint64_t>(READ_CALLS), size / callSize);
+            uint64_t readSize = callSize;
+            if (calls == 0) {
+                calls = 1;
+                readSize = size;
+            }
+
+            uint64_t fileHandleBind = fileHandle;
+            uint64_t block = offset / asmBlockSize + 1;
+            uint64_t callBlocks = readSize / asmBlockSize;
+            stmt.unbindAll();
+            stmt.bindUInt(1, fileHandleBind);
+            stmt.bindUInt(2, block);
+            stmt.bindUInt(3, callBlocks);
+            stmt.bindUInt(4, readSize);
+            stmt.bindUInt(5, calls);
+            for (uint call = 0; call < READ_CALLS; ++call) {
+                lengths[call] = 0;
+                if (call < calls)
+                    stmt.bindBinaryOut(6 + call, buf + call * readSize, readSize, &lengths[call]);
+                else
+                    stmt.bindBinaryOut(6 + call, discard, readSize, &lengths[call]);
+            }
+            stmt.executeQuery();
+
+            for (uint call = 0; call < calls; ++call)
+                if (unlikely(lengths[call] != readSize))
+                    throw RuntimeException(10094, "DBMS_DISKGROUP.READ returned " + std::to_string(lengths[call]) +
+                                                  " bytes at offset " + std::to_string(offset + call * readSize) + ", expected: " +
+                                                  std::to_string(readSize));
+
+            buf += calls * readSize;
+            offset += calls * readSize;
+            size -= calls * readSize;
+        }
+    }
+
+    void ReaderAsmDatabase::rangesReset() {
+        // A range being read is dropped by the session when it sees the new generation
+        for (Range& range: ranges) {
+            if (range.state == RANGE_STATE::FETCHING)
+                continue;
+            range.state = RANGE_STATE::EMPTY;
+            range.data.clear();
+        }
+    }
+
+    void ReaderAsmDatabase::redoClose() {
+        {
+            std::unique_lock<std::mutex> const lck(fetchMtx);
+            ++generation;
+            rangesReset();
+            header.clear();
+            asmFileName.clear();
+        }
+        if (remote) {
+            asmClose(conn, handle);
+            remote = false;
+        }
+        ReaderFilesystem::redoClose();
+    }
+
+    Reader::REDO_CODE ReaderAsmDatabase::redoOpen() {
+        ReaderAsmDatabase::redoClose();
+        if (!isAsm(fileName))
+            return ReaderFilesystem::redoOpen();
+
+        uint64_t fileBlocks = 0;
+        try {
+            asmConnect(conn);
+
+            std::string fileNameBind(fileName);
+            DatabaseStatement stmt(conn);
+            if (unlikely(ctx->isTraceSet(Ctx::TRACE::SQL)))
+                ctx->logTrace(Ctx::TRACE::SQL, std::string(SQL_ASM_GETFILEATTR) + "\nPARAM1: " + fileName);
+            stmt.createStatement(SQL_ASM_GETFILEATTR);
+            stmt.bindString(1, fileNameBind);
+            stmt.bindUInt(2, fileType);
+            stmt.bindUInt(3, fileBlocks);
+            stmt.bindUInt(4, asmBlockSize);
+            stmt.executeQuery();
+
+            if (asmBlockSize == 0 || asmBlockSize > READ_CALL_MAX || (asmBlockSize & (Ctx::MIN_BLOCK_SIZE - 1)) != 0) {
+                ctx->error(10094, "file: " + fileName + " - invalid ASM block size: " + std::to_string(asmBlockSize));
+                return REDO_CODE::ERROR;
+            }
+
+            asmOpen(conn, fileName, handle);
+            remote = true;
+
+            const uint64_t headerSize = std::min(fileBlocks * asmBlockSize, static_cast<uint64_t>(PAGE_SIZE_MAX * 2));
+            std::string headerData(headerSize, '\0');
+            asmRead(conn, handle, 0, reinterpret_cast<uint8_t*>(headerData.data()), headerSize);
+
+            std::unique_lock<std::mutex> const lck(fetchMtx);
+            ++generation;
+            rangesReset();
+            header = std::move(headerData);
+            asmFileName = fileName;
+            fileSize = fileBlocks * asmBlockSize;
+        } catch (RuntimeException& ex) {
+            ctx->error(ex.code, "file: " + fileName + " - " + ex.msg);
+            if (remote)
+                asmClose(conn, handle);
+            remote = false;
+            conn->disconnect();
+            return REDO_CODE::ERROR;
+        }
+
+        // Online redo logs are being written, ranges read ahead would be stale
+        if (group == 0 && sessions.empty()) {
+            for (uint num = 0; num < ctx->asmSessions; ++num) {
+                auto* session = new AsmSession(ctx, alias + "-asm-" + std::to_string(num), this);
+                session->conn = new DatabaseConnection(env, ctx->asmUser, ctx->asmPassword, ctx->asmServer, ctx->asmSysAsm);
+                sessions.push_back(session);
+                ctx->spawnThread(session);
+            }
+        }
+
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::FILE)))
+            ctx->logTrace(Ctx::TRACE::FILE, "asm file: " + fileName + " size: " + std::to_string(fileSize) + " block size: " +
+                                            std::to_string(asmBlockSize));
+        return REDO_CODE::OK;
+    }
+
+    // Returns the range, or nullptr when all ranges are in use. Ranges behind the current one or too far ahead are reused
+    ReaderAsmDatabase::Range* ReaderAsmDatabase::rangeQueue(uint64_t index, uint64_t currentIndex) {
+        for (Range& range: ranges)
+            if (range.state != RANGE_STATE::EMPTY && range.index == index)
+                return &range;
+
+        for (Range& range: ranges) {
+            const bool done = range.state == RANGE_STATE::READY || range.state == RANGE_STATE::FAILED;
+            if (range.state == RANGE_STATE::EMPTY || (done && (range.index < currentIndex || range.index >= currentIndex + ranges.size()))) {
+                range.index = index;
+                range.state = RANGE_STATE::QUEUED;
+                range.data.clear();
+                condFetch.notify_one();
+                return &range;
+            }
+        }
+        return nullptr;
+    }
+
+    int ReaderAsmDatabase::redoRead(uint8_t* buf, uint64_t offset, uint size) {
+        if (!remote)
+            return ReaderFilesystem::redoRead(buf, offset, size);
+
+        if (offset < header.size()) {
+            const uint64_t bytes = std::min(static_cast<uint64_t>(size), header.size() - offset);
+            memcpy(buf, header.data() + offset, bytes);
+            return static_cast<int>(bytes);
+        }
+
+        if (offset >= fileSize)
+            return 0;
+        if (offset + size > fileSize)
+            size = fileSize - offset;
+
+        uint64_t startTime = 0;
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::PERFORMANCE)))
+            startTime = ctx->clock->getTimeUt();
+
+        int bytes = 0;
+        if (sessions.empty()) {
+            try {
+                asmRead(conn, handle, offset, buf, size);
+                bytes = static_cast<int>(size);
+            } catch (RuntimeException& ex) {
+                ctx->error(ex.code, "file: " + fileName + " - " + ex.msg);
+                errno = EIO;
+                bytes = -1;
+            }
+        } else {
+            const uint64_t index = offset / rangeSize;
+            contextSet(CONTEXT::MUTEX, REASON::READER_FETCH);
+            std::unique_lock<std::mutex> lck(fetchMtx);
+            Range* range;
+            for (;;) {
+                range = rangeQueue(index, index);
+                for (uint64_t next = index + 1; next <= index + sessions.size() && next * rangeSize < fileSize; ++next)
+                    rangeQueue(next, index);
+
+                if (range != nullptr && (range->state == RANGE_STATE::READY || range->state == RANGE_STATE::FAILED))
+                    break;
+                if (ctx->hardShutdown || stopped) {
+                    contextSet(CONTEXT::CPU);
+                    errno = EINTR;
+                    return -1;
+                }
+                contextSet(CONTEXT::WAIT, REASON::READER_FETCH_WAIT);
+                condReady.wait_for(lck, std::chrono::milliseconds(100));
+                contextSet(CONTEXT::MUTEX, REASON::READER_FETCH);
+            }
+
+            if (range->state == RANGE_STATE::FAILED) {
+                range->state = RANGE_STATE::EMPTY;
+                errno = EIO;
+                bytes = -1;
+            } else {
+                const uint64_t pos = offset - (index * rangeSize);
+                if (pos < range->data.size()) {
+                    bytes = static_cast<int>(std::min(static_cast<uint64_t>(size), range->data.size() - pos));
+                    memcpy(buf, range->data.data() + pos, bytes);
+                }
+            }
+            lck.unlock();
+            contextSet(CONTEXT::CPU);
+        }
+
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::FILE)))
+            ctx->logTrace(Ctx::TRACE::FILE, "read " + fileName + ", " + std::to_string(offset) + ", " + std::to_string(size) +
+                                            " returns " + std::to_string(bytes));
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::PERFORMANCE))) {
+            if (bytes > 0)
+                sumRead += bytes;
+            sumTime += ctx->clock->getTimeUt() - startTime;
+        }
+        return bytes;
+    }
+
+    void ReaderAsmDatabase::sessionRun(AsmSession* session) {
+        session->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::READER_FETCH);
+        std::unique_lock<std::mutex> lck(fetchMtx);
+        while (!ctx->hardShutdown && !stopped) {
+            Range* range = nullptr;
+            for (Range& candidate: ranges)
+                if (candidate.state == RANGE_STATE::QUEUED && (range == nullptr || candidate.index < range->index))
+                    range = &candidate;
+
+            if (range == nullptr) {
+                session->contextSet(Thread::CONTEXT::WAIT, Thread::REASON::READER_FETCH_NO_WORK);
+                condFetch.wait_for(lck, std::chrono::milliseconds(100));
+                session->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::READER_FETCH);
+                continue;
+            }
+
+            range->state = RANGE_STATE::FETCHING;
+            const uint64_t fetchGeneration = generation;
+            const std::string fetchFileName = asmFileName;
+            const uint64_t start = range->index * rangeSize;
+            const uint64_t end = std::min(fileSize, start + rangeSize);
+            lck.unlock();
+            session->contextSet(Thread::CONTEXT::CPU);
+
+            std::string data(end - start, '\0');
+            bool ok = false;
+            for (uint tries = ctx->archReadTries; tries > 0 && !ctx->hardShutdown; --tries) {
+                try {
+                    if (!session->fileOpen || session->openFileName != fetchFileName) {
+                        if (session->fileOpen)
+                            asmClose(session->conn, session->openHandle);
+                        session->fileOpen = false;
+                        asmOpen(session->conn, fetchFileName, session->openHandle);
+                        session->openFileName = fetchFileName;
+                        session->fileOpen = true;
+                    }
+                    asmRead(session->conn, session->openHandle, start, reinterpret_cast<uint8_t*>(data.data()), end - start);
+                    ok = true;
+                    break;
+                } catch (RuntimeException& ex) {
+                    ctx->error(ex.code, "file: " + fetchFileName + " - range: " + std::to_string(start) + "-" + std::to_string(end - 1) + ": " +
+                                        ex.msg);
+                    session->fileOpen = false;
+                    session->conn->disconnect();
+                }
+                if (tries > 1) {
+                    session->contextSet(Thread::CONTEXT::SLEEP);
+                    usleep(ctx->archReadSleepUs);
+                    session->contextSet(Thread::CONTEXT::CPU);
+                }
+            }
+
+            session->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::READER_FETCH);
+            lck.lock();
+            if (fetchGeneration == generation) {
+                range->data = std::move(data);
+                range->state = ok ? RANGE_STATE::READY : RANGE_STATE::FAILED;
+            } else
+                range->state = RANGE_STATE::EMPTY;
+            condReady.notify_all();
+        }
+        lck.unlock();
+
+        if (session->fileOpen)
+            asmClose(session->conn, session->openHandle);
+        session->fileOpen = false;
+        session->contextSet(Thread::CONTEXT::CPU);
+    }
+}
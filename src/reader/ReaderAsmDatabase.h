@@ -0,0 +1,146 @@
+/* Header for ReaderAsmDatabase class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef READER_ASM_DATABASE_H_
+#define READER_ASM_DATABASE_H_
+
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include "ReaderFilesystem.h"
+
+namespace OpenLogReplicator {
+    class DatabaseConnection;
+    class DatabaseEnvironment;
+    class ReaderAsmDatabase;
+
+    // Database session reading ranges of the file ahead of the reader, every session opens the file on its own
+    class AsmSession final : public Thread {
+    protected:
+        ReaderAsmDatabase* reader;
+
+        void run() override;
+
+    public:
+        DatabaseConnection* conn{nullptr};
+        std::string openFileName;
+        uint64_t openHandle{0};
+        bool fileOpen{false};
+
+        AsmSession(Ctx* newCtx, std::string newAlias, ReaderAsmDatabase* newReader);
+        ~AsmSession() override;
+
+        void wakeUp() override;
+
+        std::string getName() const override {
+            return {"Reader: ASM session " + alias};
+        }
+    };
+
+    // Redo log files in ASM ("+DISKGROUP/..."), read with DBMS_DISKGROUP calls over OCI instead of asmcmd on the database host.
+    // Archived logs are split into ranges which several sessions read at once, online logs are read by the reader's own session
+    // since they are being written. Local paths are read by ReaderFilesystem
+    class ReaderAsmDatabase final : public ReaderFilesystem {
+    protected:
+        // Largest RAW returned by one DBMS_DISKGROUP.READ call
+        static constexpr uint64_t READ_CALL_MAX{32767};
+        // DBMS_DISKGROUP.READ calls in one PL/SQL block, sent in one round trip
+        static constexpr uint READ_CALLS{8};
+
+        static constexpr std::string_view SQL_ASM_GETFILEATTR
+                {"BEGIN DBMS_DISKGROUP.GETFILEATTR(:i, :j, :k, :l); END;"};
+
+        static constexpr std::string_view SQL_ASM_OPEN
+                {"BEGIN DBMS_DISKGROUP.OPEN(:i, 'r', :j, :k, :l, :m, :n); END;"};
+
+        static constexpr std::string_view SQL_ASM_CLOSE
+                {"BEGIN DBMS_DISKGROUP.CLOSE(:i); END;"};
+
+        // Offsets count logical blocks from 1, the calls which are not needed leave their buffers empty
+        static constexpr std::string_view SQL_ASM_READ
+                {"DECLARE"
+                "   H NUMBER := :h; B NUMBER := :b; K NUMBER := :k; S NUMBER := :s; N NUMBER := :n;"
+                " BEGIN"
+                "   DBMS_DISKGROUP.READ(H, B, S, :d1);"
+                "   IF N > 1 THEN DBMS_DISKGROUP.READ(H, B + K, S, :d2); END IF;"
+                "   IF N > 2 THEN DBMS_DISKGROUP.READ(H, B + 2 * K, S, :d3); END IF;"
+                "   IF N > 3 THEN DBMS_DISKGROUP.READ(H, B + 3 * K, S, :d4); END IF;"
+                "   IF N > 4 THEN DBMS_DISKGROUP.READ(H, B + 4 * K, S, :d5); END IF;"
+                "   IF N > 5 THEN DBMS_DISKGROUP.READ(H, B + 5 * K, S, :d6); END IF;"
+                "   IF N > 6 THEN DBMS_DISKGROUP.READ(H, B + 6 * K, S, :d7); END IF;"
+                "   IF N > 7 THEN DBMS_DISKGROUP.READ(H, B + 7 * K, S, :d8); END IF;"
+                " END;"};
+
+        enum class RANGE_STATE : unsigned char {
+            EMPTY, QUEUED, FETCHING, READY, FAILED
+        };
+
+        struct Range {
+            uint64_t index{0};
+            RANGE_STATE state{RANGE_STATE::EMPTY};
+            std::string data;
+        };
+
+        DatabaseEnvironment* env{nullptr};
+        // Session of the reader thread: file attributes, header and online redo log reads
+        DatabaseConnection* conn{nullptr};
+        uint64_t handle{0};
+        bool remote{false};
+        uint64_t fileType{0};
+        uint64_t asmBlockSize{0};
+
+        std::mutex fetchMtx;
+        std::condition_variable condFetch;
+        std::condition_variable condReady;
+        std::vector<Range> ranges;
+        std::vector<AsmSession*> sessions;
+        uint64_t rangeSize;
+        // Raised when a file is opened or closed, ranges read for an earlier file are dropped
+        uint64_t generation{0};
+        bool stopped{false};
+        std::string asmFileName;
+        // First bytes of the file, read when it is opened: the header is read again for every log switch check
+        std::string header;
+
+        void redoClose() override;
+        REDO_CODE redoOpen() override;
+        int redoRead(uint8_t* buf, uint64_t offset, uint size) override;
+
+        void rangesReset();
+        Range* rangeQueue(uint64_t index, uint64_t currentIndex);
+        void asmConnect(DatabaseConnection* connection);
+        void asmOpen(DatabaseConnection* connection, const std::string& name, uint64_t& fileHandle);
+        void asmClose(DatabaseConnection* connection, uint64_t fileHandle);
+        void asmRead(DatabaseConnection* connection, uint64_t fileHandle, uint64_t offset, uint8_t* buf, uint64_t size) const;
+
+    public:
+        ReaderAsmDatabase(Ctx* newCtx, std::string newAlias, std::string newDatabase, int newGroup, bool newConfiguredBlockSum);
+        ~ReaderAsmDatabase() override;
+
+        void sessionRun(AsmSession* session);
+        void sessionWakeUp();
+
+        [[nodiscard]] static bool isAsm(const std::string& path) {
+            return !path.empty() && path[0] == '+';
+        }
+    };
+}
+
+#endif
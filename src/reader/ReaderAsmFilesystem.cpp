@@ -5,12 +5,19 @@ enum {
 _FILE_OFFSET_BITS = 64
 };
 
+#include <algorithm>
 #include <cerrno>
 #include <cstring>
 #include <dirent.h>
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#ifdef LINK_LIBRARY_LZ4
+#include <lz4frame.h>
+#endif
+#ifdef LINK_LIBRARY_ZSTD
+#include <zstd.h>
+#endif
 
 #include "../common/Clock.h"
 #include "../common/Ctx.h"
@@ -31,6 +38,8 @@ namespace OpenLogReplicator
             "ORCLCDB1"        // Oracle 实例 SID
         );
 
+        transport = ctx->asmTransportCompression;
+
         // 记录当前实例的配置信息
         if (unlikely(ctx->isTraceSet(Ctx::TRACE::FILE)))
             ctx->logTrace(Ctx::TRACE::FILE, "initialized ReaderAsmFilesystem for instance " +
@@ -40,6 +49,16 @@ namespace OpenLogReplicator
 
     ReaderAsmFilesystem::~ReaderAsmFilesystem() {
         ReaderAsmFilesystem::redoClose();
+#ifdef LINK_LIBRARY_ZSTD
+        if (zstdCtx != nullptr)
+            ZSTD_freeDCtx(zstdCtx);
+        zstdCtx = nullptr;
+#endif
+#ifdef LINK_LIBRARY_LZ4
+        if (lz4Ctx != nullptr)
+            LZ4F_freeDecompressionContext(lz4Ctx);
+        lz4Ctx = nullptr;
+#endif
     }
 
     // 设置 ASM 配置参数的方法
@@ -56,11 +75,23 @@ namespace OpenLogReplicator
         oracleSid = oraSid;         // 保存 Oracle 实例 SID
     }
 
+    void ReaderAsmFilesystem::setStreaming(bool newStreaming) {
+        streaming = newStreaming;
+    }
+
     void ReaderAsmFilesystem::redoClose() {
         // ASM 模式：释放内存缓冲区和 SSH 连接
         fileBuffer.reset();  // 释放文件缓冲区内存
         bufferSize = 0;      // 重置缓冲区大小
         dataLength = 0;      // 重置数据长度
+        rangeBuffer.reset(); // 释放流式读取缓冲区
+        rangeBufferSize = 0;
+        rangeHead = 0;
+        rangeOffset = 0;
+        rangeLength = 0;
+        rangePending = false;
+        packedBuffer.reset(); // 释放压缩数据缓冲区
+        packedBufferSize = 0;
         closeSshConnection(); // 关闭 SSH 连接
 
     }
@@ -76,6 +107,18 @@ namespace OpenLogReplicator
             return result;  // 连接失败则返回错误码
         }
 
+        // 步骤2（流式模式）：启动远端常驻读取进程，按需读取数据块
+        if (streaming) {
+            result = openRangeReader();
+            if (result != REDO_CODE::OK) {
+                closeSshConnection();
+                return result;
+            }
+
+            ctx->info(0, "ASM file opened for streaming: " + fileName + ", size: " + std::to_string(fileSize) + " bytes");
+            return REDO_CODE::OK;
+        }
+
         // 步骤2：传输 ASM 文件到内存
         result = transferAsmFileToMemory();  // 调用文件传输方法
         if (result != REDO_CODE::OK) {  // 检查传输是否成功
@@ -93,98 +136,11 @@ namespace OpenLogReplicator
         return REDO_CODE::OK;  // 返回成功状态
     }
 
-    // 建立 SSH 连接的方法
+    // 从进程级会话池获取到目标主机的共享 SSH 会话，只有首次使用时才握手认证
     Reader::REDO_CODE ReaderAsmFilesystem::setupSshConnection() {
-        contextSet(CONTEXT::OS, REASON::OS);  // 设置上下文为操作系统级别操作
-
-        // 创建新的 SSH 会话
-        sshSession = ssh_new();  // 调用 libssh 创建新会话
-        if (sshSession == nullptr) {  // 检查创建是否成功
-            contextSet(CONTEXT::CPU);  // 恢复上下文为 CPU 级别
-            ctx->error(10001, "failed to create SSH session");  // 记录错误日志
-            return REDO_CODE::ERROR;  // 返回错误码
-        }
-
-        // 设置 SSH 连接参数
-        ssh_options_set(sshSession, SSH_OPTIONS_HOST, sshHost.c_str());     // 设置主机地址
-        ssh_options_set(sshSession, SSH_OPTIONS_PORT, &sshPort);            // 设置端口号
-        ssh_options_set(sshSession, SSH_OPTIONS_USER, sshUser.c_str());     // 设置用户名
-
-        // 连接到 SSH 服务器
-        int rc = ssh_connect(sshSession);  // 执行连接操作
-        if (rc != SSH_OK) {  // 检查连接是否成功
-            contextSet(CONTEXT::CPU);  // 恢复上下文
-            ctx->error(10002, "SSH connection failed: " + std::string(ssh_get_error(sshSession)));  // 记录连接错误
-            ssh_free(sshSession);  // 释放 SSH 会话资源
-            sshSession = nullptr;  // 重置会话指针
-            return REDO_CODE::ERROR;  // 返回错误码
-        }
-        int none_result = ssh_userauth_none(sshSession, nullptr);
-        int auth_methods = ssh_userauth_list(sshSession, nullptr);
-
-        if (auth_methods == 0) {
-            contextSet(CONTEXT::CPU);
-            ctx->error(10003, "获取服务器认证方法失败，可能是认证协商问题");
-            ssh_disconnect(sshSession);
-            ssh_free(sshSession);
-            sshSession = nullptr;
-            return REDO_CODE::ERROR;
-        }
-
-        if (none_result == SSH_AUTH_SUCCESS) {
-            ctx->info(0, "SSH无密码认证成功");
-            contextSet(CONTEXT::CPU);
-            ctx->info(0, "SSH认证成功，连接已建立到: " + sshHost);
-            if (unlikely(ctx->isTraceSet(Ctx::TRACE::FILE)))
-                ctx->logTrace(Ctx::TRACE::FILE, "SSH connection established to: " + sshHost);
-            return REDO_CODE::OK;
-        }
-
-        // 公钥认证
-        if (auth_methods & SSH_AUTH_METHOD_PUBLICKEY) {
-            ctx->info(0, "服务器支持公钥认证，尝试使用公钥...");
-            rc = ssh_userauth_publickey_auto(sshSession, nullptr, nullptr);
-            if (rc == SSH_AUTH_SUCCESS) {
-                ctx->info(0, "SSH公钥认证成功");
-                contextSet(CONTEXT::CPU);
-                ctx->info(0, "SSH认证成功，连接已建立到: " + sshHost);
-                if (unlikely(ctx->isTraceSet(Ctx::TRACE::FILE)))
-                    ctx->logTrace(Ctx::TRACE::FILE, "SSH connection established to: " + sshHost);
-                return REDO_CODE::OK;
-            } else {
-                std::string error_msg = ssh_get_error(sshSession);
-                ctx->error(10004, "SSH公钥认证失败: " + error_msg);
-            }
-        }
-
-        if (!(auth_methods & SSH_AUTH_METHOD_PASSWORD)) {
-            contextSet(CONTEXT::CPU);
-            ctx->error(10003, "服务器不支持密码认证，支持的方法: " + std::to_string(auth_methods));
-            ssh_disconnect(sshSession);
-            ssh_free(sshSession);
-            sshSession = nullptr;
-            return REDO_CODE::ERROR;
-        }
-
-        // 进行密码认证
-        rc = ssh_userauth_password(sshSession, nullptr, sshPassword.c_str());  // 使用密码进行用户认证
-        if (rc != SSH_AUTH_SUCCESS) {  // 检查认证是否成功
-            contextSet(CONTEXT::CPU);  // 恢复上下文
-            ctx->error(10003, "SSH authentication failed");  // 记录认证失败错误
-            ssh_disconnect(sshSession);  // 断开 SSH 连接
-            ssh_free(sshSession);  // 释放 SSH 会话资源
-            sshSession = nullptr;  // 重置会话指针
-            return REDO_CODE::ERROR;  // 返回错误码
-        }
-
-        contextSet(CONTEXT::CPU);  // 恢复上下文为 CPU 级别
-
-        ctx->info(0, "SSH认证成功，连接已建立到: " + sshHost);
-        // 记录成功建立连接的跟踪日志
-        if (unlikely(ctx->isTraceSet(Ctx::TRACE::FILE)))
-            ctx->logTrace(Ctx::TRACE::FILE, "SSH connection established to: " + sshHost);
-
-        return REDO_CODE::OK;  // 返回成功状态
+        if (sshSession == nullptr)
+            sshSession = SshSessionPool::getInstance().acquire(ctx, this, sshHost, sshUser, sshPassword, sshPort);
+        return REDO_CODE::OK;
     }
 
     // 将 ASM 文件传输到内存的方法
@@ -200,7 +156,7 @@ namespace OpenLogReplicator
                      << "export LD_LIBRARY_PATH=$ORACLE_HOME/lib:$LD_LIBRARY_PATH; "  // 更新库路径环境变量
                      << "fifo_name=\"/tmp/asm_fifo_" << oracleSid << "_$(date +%s%N | cut -b1-19)_$$\"; "  // 创建唯一的 FIFO 文件名（包含实例SID、纳秒时间戳和进程ID）
                      << "mkfifo \"$fifo_name\"; "                           // 创建命名管道
-                     << "cat \"$fifo_name\" & "                             // 后台启动读取管道的进程
+                     << "cat \"$fifo_name\"" << compressorCommand() << " & " // 后台启动读取管道的进程（传输压缩时经过压缩程序）
                      << "cat_pid=$!; "                                      // 保存 cat 进程的 PID
                      << "asmcmd cp " << fileName << " \"$fifo_name\" >&2; " // 使用 asmcmd 复制文件到管道
                      << "wait $cat_pid; "                                   // 等待 cat 进程完成
@@ -208,7 +164,7 @@ namespace OpenLogReplicator
         } else {
             // 普通文件系统文件：直接使用 cat 输出
             cmdStream << "docker exec --user oracle " << dockerContainer   // 以 oracle 用户执行 Docker 命令
-                     << " bash -c 'cat " << fileName << "'";               // 使用 cat 命令读取文件内容
+                     << " bash -c 'cat " << fileName << compressorCommand() << "'"; // 使用 cat 命令读取文件内容
         }
 
         std::string command = cmdStream.str();  // 将字符串流转换为字符串
@@ -217,42 +173,12 @@ namespace OpenLogReplicator
         if (unlikely(ctx->isTraceSet(Ctx::TRACE::FILE)))
             ctx->logTrace(Ctx::TRACE::FILE, "executing command: " + command);
 
-        contextSet(CONTEXT::OS, REASON::OS);  // 设置上下文为操作系统级别
-
-        if (sshSession == nullptr || ssh_is_connected(sshSession) == 0) {
-            ctx->error(10010, "SSH session is not connected");
+        // 在共享会话上打开新的通道并执行命令
+        sshChannel = sshSession->openChannel(ctx, this, command);
+        if (sshChannel == nullptr) {
+            ctx->error(10006, "failed to execute SSH command");
             return REDO_CODE::ERROR;
         }
-        // 创建 SSH 通道
-        sshChannel = ssh_channel_new(sshSession);  // 基于 SSH 会话创建新的通道
-        if (sshChannel == nullptr) {  // 检查通道创建是否成功
-            contextSet(CONTEXT::CPU);  // 恢复上下文
-            ctx->error(10004, "failed to create SSH channel");  // 记录错误日志
-            return REDO_CODE::ERROR;  // 返回错误码
-        }
-
-        // 打开 SSH 通道会话
-        int rc = ssh_channel_open_session(sshChannel);  // 打开通道会话
-        if (rc != SSH_OK) {  // 检查打开是否成功
-            contextSet(CONTEXT::CPU);  // 恢复上下文
-            ctx->error(10005, "failed to open SSH channel");  // 记录错误日志
-            ssh_channel_free(sshChannel);  // 释放通道资源
-            sshChannel = nullptr;  // 重置通道指针
-            return REDO_CODE::ERROR;  // 返回错误码
-        }
-
-        // 在 SSH 通道中执行命令
-        rc = ssh_channel_request_exec(sshChannel, command.c_str());  // 请求执行命令
-        if (rc != SSH_OK) {  // 检查执行请求是否成功
-            contextSet(CONTEXT::CPU);  // 恢复上下文
-            ctx->error(10006, "failed to execute SSH command");  // 记录错误日志
-            ssh_channel_close(sshChannel);  // 关闭 SSH 通道
-            ssh_channel_free(sshChannel);   // 释放通道资源
-            sshChannel = nullptr;  // 重置通道指针
-            return REDO_CODE::ERROR;  // 返回错误码
-        }
-
-        contextSet(CONTEXT::CPU);  // 恢复上下文为 CPU 级别
 
         // 初始化内存缓冲区参数
         const size_t initialBufferSize = 64 * 1024 * 1024; // 64MB 初始缓冲区大小
@@ -262,40 +188,69 @@ namespace OpenLogReplicator
         fileBuffer = std::make_unique<uint8_t[]>(bufferSize);  // 分配内存缓冲区
         dataLength = 0;  // 初始化数据长度为 0
 
-        // 循环读取数据直到完成或被中断
-        while (!ctx->hardShutdown) {  // 检查是否收到硬停止信号
-            // 检查缓冲区是否需要扩容
-            if (dataLength + chunkSize > bufferSize) {  // 当前数据加新读取的数据超过缓冲区大小
-                uint64_t newBufferSize = bufferSize * 2;  // 新缓冲区大小为当前的两倍
-                auto newBuffer = std::make_unique<uint8_t[]>(newBufferSize);  // 分配新的更大缓冲区
-                memcpy(newBuffer.get(), fileBuffer.get(), dataLength);  // 复制现有数据到新缓冲区
-                fileBuffer = std::move(newBuffer);  // 使用新缓冲区替换旧缓冲区
-                bufferSize = newBufferSize;  // 更新缓冲区大小记录
-
-                // 记录缓冲区扩展的跟踪日志
-                if (unlikely(ctx->isTraceSet(Ctx::TRACE::FILE)))
-                    ctx->logTrace(Ctx::TRACE::FILE, "expanded buffer to: " + std::to_string(bufferSize));
+        if (transport != Ctx::TRANSPORT_COMPRESSION::NONE) {
+            // 传输压缩：接收压缩数据，解压到主缓冲区
+            if (!transportReset())
+                return REDO_CODE::ERROR;
+            if (packedBufferSize < chunkSize) {
+                packedBufferSize = chunkSize;
+                packedBuffer = std::make_unique<uint8_t[]>(packedBufferSize);
             }
 
-            // 将新读取的数据复制到主缓冲区
-            contextSet(CONTEXT::OS, REASON::OS);  // 设置上下文为操作系统级别
-            int bytesRead = ssh_channel_read(sshChannel, fileBuffer.get() + dataLength,
-                                       std::min(chunkSize, bufferSize - dataLength), 0);
-            contextSet(CONTEXT::CPU);  // 恢复上下文为 CPU 级别
+            bool frameEnd = false;
+            while (!ctx->hardShutdown) {
+                const int bytesRead = sshSession->read(ctx, this, sshChannel, packedBuffer.get(), chunkSize);
+                if (bytesRead == 0)
+                    break;
 
-            if (bytesRead == 0) {  // 检查是否读取到文件末尾
-                break; // EOF - 文件结束，退出循环
+                if (bytesRead < 0) {
+                    ctx->error(10007, "SSH channel read error");
+                    return REDO_CODE::ERROR;
+                }
+
+                if (!transportDecode(packedBuffer.get(), bytesRead, fileBuffer, bufferSize, dataLength, frameEnd))
+                    return REDO_CODE::ERROR;
             }
 
-            if (bytesRead < 0) {  // 检查是否发生读取错误
-                ctx->error(10007, "SSH channel read error");  // 记录读取错误
-                return REDO_CODE::ERROR;  // 返回错误码
+            if (!frameEnd && !ctx->hardShutdown) {
+                ctx->error(10092, "file: " + fileName + " - compressed transfer is truncated, got " + std::to_string(dataLength) + " bytes");
+                return REDO_CODE::ERROR;
+            }
+        } else {
+            // 循环读取数据直到完成或被中断
+            while (!ctx->hardShutdown) {  // 检查是否收到硬停止信号
+                // 检查缓冲区是否需要扩容
+                if (dataLength + chunkSize > bufferSize) {  // 当前数据加新读取的数据超过缓冲区大小
+                    uint64_t newBufferSize = bufferSize * 2;  // 新缓冲区大小为当前的两倍
+                    auto newBuffer = std::make_unique<uint8_t[]>(newBufferSize);  // 分配新的更大缓冲区
+                    memcpy(newBuffer.get(), fileBuffer.get(), dataLength);  // 复制现有数据到新缓冲区
+                    fileBuffer = std::move(newBuffer);  // 使用新缓冲区替换旧缓冲区
+                    bufferSize = newBufferSize;  // 更新缓冲区大小记录
+
+                    // 记录缓冲区扩展的跟踪日志
+                    if (unlikely(ctx->isTraceSet(Ctx::TRACE::FILE)))
+                        ctx->logTrace(Ctx::TRACE::FILE, "expanded buffer to: " + std::to_string(bufferSize));
+                }
+
+                // 将新读取的数据复制到主缓冲区
+                int bytesRead = sshSession->read(ctx, this, sshChannel, fileBuffer.get() + dataLength,
+                                                 std::min(chunkSize, bufferSize - dataLength));
+
+                if (bytesRead == 0) {  // 检查是否读取到文件末尾
+                    break; // EOF - 文件结束，退出循环
+                }
+
+                if (bytesRead < 0) {  // 检查是否发生读取错误
+                    ctx->error(10007, "SSH channel read error");  // 记录读取错误
+                    return REDO_CODE::ERROR;  // 返回错误码
+                }
+                dataLength += bytesRead;  // 更新总数据长度
+
+                // 每 10MB 记录一次进度日志
+                if (unlikely(ctx->isTraceSet(Ctx::TRACE::FILE)) && dataLength % (10 * 1024 * 1024) == 0)
+                    ctx->logTrace(Ctx::TRACE::FILE, "loaded: " + std::to_string(dataLength / 1024 / 1024) + "MB");
             }
-            dataLength += bytesRead;  // 更新总数据长度
 
-            // 每 10MB 记录一次进度日志
-            if (unlikely(ctx->isTraceSet(Ctx::TRACE::FILE)) && dataLength % (10 * 1024 * 1024) == 0)
-                ctx->logTrace(Ctx::TRACE::FILE, "loaded: " + std::to_string(dataLength / 1024 / 1024) + "MB");
         }
 
         if (dataLength == 0) {
@@ -304,9 +259,7 @@ namespace OpenLogReplicator
         }
 
         // 检查命令执行的退出状态
-        contextSet(CONTEXT::OS, REASON::OS);  // 设置上下文为操作系统级别
-        int exitStatus = ssh_channel_get_exit_status(sshChannel);  // 获取命令执行的退出状态码
-        contextSet(CONTEXT::CPU);  // 恢复上下文为 CPU 级别
+        int exitStatus = sshSession->exitStatus(this, sshChannel);  // 获取命令执行的退出状态码
 
         if (exitStatus != 0) {  // 检查命令是否成功执行（退出码为 0 表示成功）
             ctx->error(10008, "command execution failed with exit code: " + std::to_string(exitStatus));  // 记录命令执行失败
@@ -314,10 +267,7 @@ namespace OpenLogReplicator
         }
 
         // 关闭 SSH 通道并清理资源
-        contextSet(CONTEXT::OS, REASON::OS);  // 设置上下文为操作系统级别
-        ssh_channel_close(sshChannel);  // 关闭 SSH 通道
-        ssh_channel_free(sshChannel);   // 释放通道资源
-        contextSet(CONTEXT::CPU);  // 恢复上下文为 CPU 级别
+        sshSession->closeChannel(this, sshChannel, false);  // 关闭 SSH 通道，会话保留在池中
         sshChannel = nullptr;  // 重置通道指针
 
         // 记录传输完成的跟踪日志
@@ -328,7 +278,420 @@ namespace OpenLogReplicator
     }
 
 
+    // 远端读取进程：先返回文件大小，之后对每行 "offset length" 请求返回 长度头 + 数据
+    // ASM 文件没有按偏移读取的接口，先在容器内复制到本地临时文件，只有被请求的数据块经过网络
+    std::string ReaderAsmFilesystem::buildRangeReaderCommand() const {
+        std::ostringstream cmdStream;
+        if (fileName.find('+') == 0) {
+            cmdStream << "docker exec -i " << dockerContainer << " bash -c '"
+                     << "export ORACLE_HOME=" << oracleHome << "; "
+                     << "export ORACLE_SID=" << oracleSid << "; "
+                     << "export PATH=$ORACLE_HOME/bin:$PATH; "
+                     << "export LD_LIBRARY_PATH=$ORACLE_HOME/lib:$LD_LIBRARY_PATH; "
+                     << "f=\"/tmp/asm_range_" << oracleSid << "_$(date +%s%N | cut -b1-19)_$$\"; "
+                     << "trap \"rm -f $f $f.new\" EXIT; "
+                     << "asmcmd cp " << fileName << " \"$f\" >&2 || exit 1; "
+                     << "refresh() { asmcmd cp " << fileName << " \"$f.new\" >&2 && mv -f \"$f.new\" \"$f\"; }; ";
+        } else {
+            cmdStream << "docker exec -i --user oracle " << dockerContainer << " bash -c '"
+                     << "f=\"" << fileName << "\"; "
+                     << "refresh() { :; }; ";
+        }
+
+        // 请求 "r 0"：刷新远端数据（在线日志），应答新的文件大小
+        cmdStream << "printf \"%020d\\n\" $(stat -c %s \"$f\"); "
+                 << "while read off len; do "
+                 << "if [ \"$off\" = r ]; then refresh; printf \"%020d\\n\" $(stat -c %s \"$f\"); continue; fi; "
+                 << "sz=$(stat -c %s \"$f\"); n=0; "
+                 << "if [ \"$off\" -lt \"$sz\" ]; then n=$((sz-off)); [ \"$n\" -gt \"$len\" ] && n=$len; fi; "
+                 << "printf \"%020d\\n\" $n; "
+                 << "[ \"$n\" -gt 0 ] && dd if=\"$f\" iflag=skip_bytes,count_bytes skip=$off count=$n bs=1M status=none" << compressorCommand() << "; "
+                 << "done'";
+        return cmdStream.str();
+    }
+
+    Reader::REDO_CODE ReaderAsmFilesystem::openRangeReader() {
+        const std::string command = buildRangeReaderCommand();
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::FILE)))
+            ctx->logTrace(Ctx::TRACE::FILE, "executing command: " + command);
+
+        sshChannel = sshSession->openChannel(ctx, this, command);
+        if (sshChannel == nullptr) {
+            ctx->error(10006, "failed to execute SSH command");
+            return REDO_CODE::ERROR;
+        }
+
+        // 第一行应答为文件大小
+        const int64_t size = readRangeHeader();
+        if (size < 0) {
+            ctx->error(10009, "file: " + fileName + " - remote reader did not return file size");
+            return REDO_CODE::ERROR;
+        }
+
+        fileSize = static_cast<uint64_t>(size);
+        if ((fileSize & (Ctx::MIN_BLOCK_SIZE - 1)) != 0) {
+            fileSize &= ~(Ctx::MIN_BLOCK_SIZE - 1);
+            ctx->warning(10071, "file: " + fileName + " size is not a multiplication of " + std::to_string(Ctx::MIN_BLOCK_SIZE) + ", reading only " +
+                                std::to_string(fileSize) + " bytes ");
+        }
+
+        rangeBufferSize = RANGE_READ_SIZE;
+        rangeBuffer = std::make_unique<uint8_t[]>(rangeBufferSize);
+        rangeHead = 0;
+        rangeOffset = 0;
+        rangeLength = 0;
+        rangePending = false;
+        tailCursor = 0;
+        lastRefresh = ctx->clock->getTimeUt();
+        refreshIntervalUs = std::max<time_ut>(REFRESH_INTERVAL_MIN_US, ctx->redoReadSleepUs);
+        refreshCursor = 0;
+        return REDO_CODE::OK;
+    }
+
+    // 刷新远端数据，丢弃已缓存和预取的数据
+    bool ReaderAsmFilesystem::refreshRemote() {
+        if (rangePending && receiveRange() < 0)
+            return false;
+        rangeHead = 0;
+        rangeOffset = 0;
+        rangeLength = 0;
+
+        const std::string request = "r 0\n";
+        const int written = sshSession->write(this, sshChannel, request.c_str(), request.length());
+        if (written != static_cast<int>(request.length())) {
+            ctx->error(10007, "file: " + fileName + " - SSH channel write error: " + sshSession->getError(sshChannel));
+            return false;
+        }
+
+        if (readRangeHeader() < 0)
+            return false;
+
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::FILE)))
+            ctx->logTrace(Ctx::TRACE::FILE, "refreshed remote file: " + fileName + ", cursor: " + std::to_string(tailCursor));
+        return true;
+    }
+
+    // 在线日志：重新读取文件头时（轮询）刷新远端数据。每次刷新都在远端复制整个文件，所以间隔不小于 REFRESH_INTERVAL_MIN_US，
+    // 上次刷新后没有读到新数据块（数据库空闲）时间隔加倍，读到新数据块后恢复最小间隔
+    Reader::REDO_CODE ReaderAsmFilesystem::reloadHeaderRead() {
+        if (streaming && group != 0 && sshChannel != nullptr && fileName.find('+') == 0) {
+            const time_ut now = ctx->clock->getTimeUt();
+            if (now >= lastRefresh + refreshIntervalUs) {
+                const time_ut intervalMinUs = std::max<time_ut>(REFRESH_INTERVAL_MIN_US, ctx->redoReadSleepUs);
+                if (tailCursor > refreshCursor)
+                    refreshIntervalUs = intervalMinUs;
+                else
+                    refreshIntervalUs = std::min<time_ut>(std::max(refreshIntervalUs, intervalMinUs) * 2,
+                                                          std::max(REFRESH_INTERVAL_MAX_US, intervalMinUs));
+                refreshCursor = tailCursor;
+
+                if (!refreshRemote())
+                    return REDO_CODE::ERROR_READ;
+                lastRefresh = now;
+
+                if (unlikely(ctx->isTraceSet(Ctx::TRACE::FILE)))
+                    ctx->logTrace(Ctx::TRACE::FILE, "next refresh of: " + fileName + " in " + std::to_string(refreshIntervalUs) + " us");
+
+                // 读取文件头后，从游标位置预取自上次轮询以来新写入的数据块
+                const REDO_CODE retReload = Reader::reloadHeaderRead();
+                if (retReload == REDO_CODE::OK && !rangePending && tailCursor > 0 && tailCursor < fileSize)
+                    sendRangeRequest(tailCursor, RANGE_READ_SIZE);
+                return retReload;
+            }
+        }
+
+        return Reader::reloadHeaderRead();
+    }
+
+    bool ReaderAsmFilesystem::sendRangeRequest(uint64_t offset, uint64_t size) {
+        const std::string request = std::to_string(offset) + " " + std::to_string(size) + "\n";
+
+        const int written = sshSession->write(this, sshChannel, request.c_str(), request.length());
+        if (written != static_cast<int>(request.length())) {
+            ctx->error(10007, "file: " + fileName + " - SSH channel write error: " + sshSession->getError(sshChannel));
+            return false;
+        }
+
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::FILE)))
+            ctx->logTrace(Ctx::TRACE::FILE, "range request: offset=" + std::to_string(offset) + " size=" + std::to_string(size));
+
+        rangePending = true;
+        pendingOffset = offset;
+        return true;
+    }
+
+    bool ReaderAsmFilesystem::channelReadExact(uint8_t* buf, uint64_t size) {
+        uint64_t done = 0;
+        while (done < size) {
+            if (ctx->hardShutdown)
+                return false;
+
+            const int bytesRead = sshSession->read(ctx, this, sshChannel, buf + done,
+                                                   static_cast<uint32_t>(std::min<uint64_t>(size - done, RANGE_READ_SIZE)));
+            if (bytesRead <= 0) {
+                ctx->error(10007, "file: " + fileName + " - SSH channel read error, got " + std::to_string(done) + " of " +
+                                  std::to_string(size) + " bytes");
+                return false;
+            }
+            done += bytesRead;
+        }
+        return true;
+    }
+
+    int64_t ReaderAsmFilesystem::readRangeHeader() {
+        char header[RANGE_HEADER_SIZE + 1];
+        if (!channelReadExact(reinterpret_cast<uint8_t*>(header), RANGE_HEADER_SIZE))
+            return -1;
+        header[RANGE_HEADER_SIZE] = 0;
+
+        if (header[RANGE_HEADER_SIZE - 1] != '\n') {
+            ctx->error(10009, "file: " + fileName + " - invalid remote reader response: " + std::string(header));
+            return -1;
+        }
+        return static_cast<int64_t>(strtoull(header, nullptr, 10));
+    }
+
+    // 读取已发出请求的应答，数据放入 rangeBuffer
+    int64_t ReaderAsmFilesystem::receiveRange() {
+        const int64_t size = readRangeHeader();
+        rangePending = false;
+        if (size < 0)
+            return -1;
+
+        if (static_cast<uint64_t>(size) > rangeBufferSize) {
+            rangeBufferSize = static_cast<uint64_t>(size);
+            rangeBuffer = std::make_unique<uint8_t[]>(rangeBufferSize);
+        }
+
+        if (transport != Ctx::TRANSPORT_COMPRESSION::NONE && size > 0) {
+            if (receivePacked(static_cast<uint64_t>(size)) < 0)
+                return -1;
+        } else if (!channelReadExact(rangeBuffer.get(), static_cast<uint64_t>(size)))
+            return -1;
+
+        rangeHead = 0;
+        rangeOffset = pendingOffset;
+        rangeLength = static_cast<uint64_t>(size);
+        return size;
+    }
+
+    // 传输压缩时应答数据为一个完整的压缩帧，帧结束即应答结束，解压后的长度必须与应答头一致
+    int64_t ReaderAsmFilesystem::receivePacked(uint64_t size) {
+        if (!transportReset())
+            return -1;
+        if (packedBufferSize < RANGE_READ_SIZE) {
+            packedBufferSize = RANGE_READ_SIZE;
+            packedBuffer = std::make_unique<uint8_t[]>(packedBufferSize);
+        }
+
+        uint64_t length = 0;
+        bool frameEnd = false;
+        while (!frameEnd) {
+            if (ctx->hardShutdown)
+                return -1;
+
+            const int bytesRead = sshSession->read(ctx, this, sshChannel, packedBuffer.get(), static_cast<uint32_t>(packedBufferSize));
+            if (bytesRead <= 0) {
+                ctx->error(10007, "file: " + fileName + " - SSH channel read error, got " + std::to_string(length) + " of " +
+                                  std::to_string(size) + " bytes");
+                return -1;
+            }
+
+            if (!transportDecode(packedBuffer.get(), bytesRead, rangeBuffer, rangeBufferSize, length, frameEnd))
+                return -1;
+        }
+
+        if (length != size) {
+            ctx->error(10092, "file: " + fileName + " - compressed range decompressed to " + std::to_string(length) + " bytes, expected: " +
+                              std::to_string(size));
+            return -1;
+        }
+        return static_cast<int64_t>(length);
+    }
+
+    // 远端压缩命令，追加在输出数据的命令之后
+    std::string ReaderAsmFilesystem::compressorCommand() const {
+        std::ostringstream cmdStream;
+        switch (transport) {
+            case Ctx::TRANSPORT_COMPRESSION::NONE:
+                break;
+
+            case Ctx::TRANSPORT_COMPRESSION::ZSTD:
+                cmdStream << " | zstd -c -q";
+                if (ctx->asmTransportLevel > 0)
+                    cmdStream << " -" << ctx->asmTransportLevel;
+                // -T0 使用远端全部核心
+                cmdStream << " -T" << ctx->asmTransportThreads;
+                break;
+
+            case Ctx::TRANSPORT_COMPRESSION::LZ4:
+                cmdStream << " | lz4 -c -q";
+                if (ctx->asmTransportLevel > 0)
+                    cmdStream << " -" << ctx->asmTransportLevel;
+                // 多线程压缩需要 lz4 1.10 及以上版本
+                if (ctx->asmTransportThreads != 1)
+                    cmdStream << " -T" << ctx->asmTransportThreads;
+                break;
+        }
+        return cmdStream.str();
+    }
+
+    // 每个压缩流（整文件传输或一个应答）开始前重置解压状态
+    bool ReaderAsmFilesystem::transportReset() {
+        switch (transport) {
+            case Ctx::TRANSPORT_COMPRESSION::NONE:
+                return true;
+
+            case Ctx::TRANSPORT_COMPRESSION::ZSTD:
+#ifdef LINK_LIBRARY_ZSTD
+                if (zstdCtx == nullptr)
+                    zstdCtx = ZSTD_createDCtx();
+                if (zstdCtx == nullptr) {
+                    ctx->error(10092, "file: " + fileName + " - can't initialize zstd decompression");
+                    return false;
+                }
+                ZSTD_DCtx_reset(zstdCtx, ZSTD_reset_session_only);
+                return true;
+#else
+                break;
+#endif
+
+            case Ctx::TRANSPORT_COMPRESSION::LZ4:
+#ifdef LINK_LIBRARY_LZ4
+                if (lz4Ctx == nullptr && LZ4F_isError(LZ4F_createDecompressionContext(&lz4Ctx, LZ4F_VERSION))) {
+                    lz4Ctx = nullptr;
+                    ctx->error(10092, "file: " + fileName + " - can't initialize lz4 decompression");
+                    return false;
+                }
+                LZ4F_resetDecompressionContext(lz4Ctx);
+                return true;
+#else
+                break;
+#endif
+        }
+
+        ctx->error(10092, "file: " + fileName + " - transport compression is not compiled in");
+        return false;
+    }
+
+    // 解压 in 中的数据追加到 out（outLength 之后），缓冲区不足时加倍；frameEnd 表示压缩帧已完整解压
+    bool ReaderAsmFilesystem::transportDecode(const uint8_t* in, uint64_t inSize, std::unique_ptr<uint8_t[]>& out, uint64_t& outSize,
+                                              uint64_t& outLength, bool& frameEnd) {
+        uint64_t inPos = 0;
+        frameEnd = false;
+        for (;;) {
+            if (outLength == outSize) {
+                const uint64_t newOutSize = std::max<uint64_t>(outSize * 2, RANGE_READ_SIZE);
+                auto newOut = std::make_unique<uint8_t[]>(newOutSize);
+                if (outLength > 0)
+                    memcpy(newOut.get(), out.get(), outLength);
+                out = std::move(newOut);
+                outSize = newOutSize;
+            }
+
+            uint64_t produced = 0;
+            switch (transport) {
+                case Ctx::TRANSPORT_COMPRESSION::NONE:
+                    produced = std::min(inSize - inPos, outSize - outLength);
+                    memcpy(out.get() + outLength, in + inPos, produced);
+                    inPos += produced;
+                    break;
+
+                case Ctx::TRANSPORT_COMPRESSION::ZSTD: {
+#ifdef LINK_LIBRARY_ZSTD
+                    ZSTD_inBuffer input{in + inPos, inSize - inPos, 0};
+                    ZSTD_outBuffer output{out.get() + outLength, outSize - outLength, 0};
+                    const size_t zstdRet = ZSTD_decompressStream(zstdCtx, &output, &input);
+                    if (ZSTD_isError(zstdRet)) {
+                        ctx->error(10092, "file: " + fileName + " - zstd transfer: " + ZSTD_getErrorName(zstdRet));
+                        return false;
+                    }
+                    inPos += input.pos;
+                    produced = output.pos;
+                    frameEnd = (zstdRet == 0);
+                    break;
+#else
+                    return false;
+#endif
+                }
+
+                case Ctx::TRANSPORT_COMPRESSION::LZ4: {
+#ifdef LINK_LIBRARY_LZ4
+                    size_t srcSize = inSize - inPos;
+                    size_t dstSize = outSize - outLength;
+                    const size_t lz4Ret = LZ4F_decompress(lz4Ctx, out.get() + outLength, &dstSize, in + inPos, &srcSize, nullptr);
+                    if (LZ4F_isError(lz4Ret)) {
+                        ctx->error(10092, "file: " + fileName + " - lz4 transfer: " + LZ4F_getErrorName(lz4Ret));
+                        return false;
+                    }
+                    inPos += srcSize;
+                    produced = dstSize;
+                    frameEnd = (lz4Ret == 0);
+                    break;
+#else
+                    return false;
+#endif
+                }
+            }
+
+            const bool outFull = (produced == outSize - outLength);
+            outLength += produced;
+            // 输入已用完且输出未填满时，解压器内没有剩余数据
+            if (inPos == inSize && (!outFull || produced == 0))
+                break;
+        }
+        return true;
+    }
+
+    // 流式读取：优先使用已预取的数据，数据只被读取一次，重复读取同一位置（在线日志）会重新请求远端
+    int ReaderAsmFilesystem::rangeRead(uint8_t* buf, uint64_t offset, uint size) {
+        if (sshChannel == nullptr || rangeBuffer == nullptr)
+            return -1;
+
+        uint64_t copied = 0;
+        while (copied < size && !ctx->hardShutdown) {
+            const uint64_t pos = offset + copied;
+            if (pos >= rangeOffset && pos < rangeOffset + rangeLength) {
+                const uint64_t skip = pos - rangeOffset;
+                const uint64_t toCopy = std::min<uint64_t>(size - copied, rangeLength - skip);
+                memcpy(buf + copied, rangeBuffer.get() + rangeHead + skip, toCopy);
+                copied += toCopy;
+                rangeHead += skip + toCopy;
+                rangeOffset += skip + toCopy;
+                rangeLength -= skip + toCopy;
+                continue;
+            }
+
+            if (!rangePending && !sendRangeRequest(pos, std::max<uint64_t>(size - copied, RANGE_READ_SIZE)))
+                return -1;
+
+            // 预取的数据可能不是所需位置，读取后丢弃，再发出新的请求
+            const bool requested = (pendingOffset == pos);
+            const int64_t received = receiveRange();
+            if (received < 0)
+                return -1;
+            if (requested && received == 0)
+                break;
+        }
+
+        if (offset + copied > tailCursor)
+            tailCursor = offset + copied;
+
+        // 顺序读取到缓冲区末尾时，预取下一段
+        if (!rangePending && rangeLength == 0 && offset + copied < fileSize)
+            sendRangeRequest(offset + copied, RANGE_READ_SIZE);
+
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::FILE)))
+            ctx->logTrace(Ctx::TRACE::FILE, "read from remote reader: offset=" + std::to_string(offset) +
+                         " size=" + std::to_string(size) + " returned=" + std::to_string(copied));
+
+        return static_cast<int>(copied);
+    }
+
     int ReaderAsmFilesystem::redoRead(uint8_t* buf, uint64_t offset, uint size) {
+        if (streaming)
+            return rangeRead(buf, offset, size);
+
         // ASM 模式：从内存缓冲区读取数据
         if (fileBuffer == nullptr || offset >= dataLength) {  // 检查缓冲区是否存在且偏移量有效
             return 0; // 返回 0 表示 EOF 或无效偏移量
@@ -349,26 +712,20 @@ namespace OpenLogReplicator
         return static_cast<int>(bytesToRead);  // 返回实际读取的字节数
     }
 
-    // 关闭 SSH 连接的方法
+    // 关闭通道并归还共享会话，会话本身保持连接供后续读取使用
     void ReaderAsmFilesystem::closeSshConnection() {
         if (sshChannel) {  // 检查 SSH 通道是否存在
-            contextSet(CONTEXT::OS, REASON::OS);  // 设置上下文为操作系统级别
-            ssh_channel_close(sshChannel);  // 关闭 SSH 通道
-            ssh_channel_free(sshChannel);   // 释放通道资源
-            contextSet(CONTEXT::CPU);  // 恢复上下文为 CPU 级别
+            sshSession->closeChannel(this, sshChannel, streaming);  // 流式模式下先结束远端读取进程的输入
             sshChannel = nullptr;  // 重置通道指针为空
         }
 
         if (sshSession) {  // 检查 SSH 会话是否存在
-            contextSet(CONTEXT::OS, REASON::OS);  // 设置上下文为操作系统级别
-            ssh_disconnect(sshSession);  // 断开 SSH 连接
-            ssh_free(sshSession);        // 释放会话资源
-            contextSet(CONTEXT::CPU);  // 恢复上下文为 CPU 级别
+            SshSessionPool::getInstance().release(sshSession);
             sshSession = nullptr;  // 重置会话指针为空
         }
 
         // 记录 SSH 连接关闭的跟踪日志
         if (unlikely(ctx->isTraceSet(Ctx::TRACE::FILE)))
-            ctx->logTrace(Ctx::TRACE::FILE, "SSH connection closed");
+            ctx->logTrace(Ctx::TRACE::FILE, "SSH channel closed");
     }
-}
\ No newline at end of file
+}
@@ -9,12 +9,30 @@
 #include <string>
 #include <libssh/libssh.h>
 
+#include "SshSessionPool.h"
+
+#ifdef LINK_LIBRARY_ZSTD
+typedef struct ZSTD_DCtx_s ZSTD_DCtx;
+#endif
+#ifdef LINK_LIBRARY_LZ4
+typedef struct LZ4F_dctx_s LZ4F_dctx;
+#endif
+
 namespace OpenLogReplicator {
     class ReaderAsmFilesystem final : public ReaderFilesystem {
     protected:
+        // 流式模式下每次向远端请求的最小数据量
+        static constexpr uint64_t RANGE_READ_SIZE{Ctx::MEMORY_CHUNK_SIZE};
+        // 远端应答头: 20 位十进制长度 + 换行
+        static constexpr uint64_t RANGE_HEADER_SIZE{21};
+        // 在线日志刷新需要在远端复制整个 ASM 文件：两次刷新的最小间隔，刷新没有带来新数据块时间隔加倍，直到最大间隔
+        static constexpr time_ut REFRESH_INTERVAL_MIN_US{250000};
+        static constexpr time_ut REFRESH_INTERVAL_MAX_US{8000000};
+
         void redoClose() override;
         REDO_CODE redoOpen() override;
         int redoRead(uint8_t* buf, uint64_t offset, uint size) override;
+        REDO_CODE reloadHeaderRead() override;
 
     public:
         ReaderAsmFilesystem(Ctx* newCtx, std::string newAlias, std::string newDatabase, int newGroup, bool newConfiguredBlockSum);
@@ -24,13 +42,32 @@ namespace OpenLogReplicator {
                          const std::string& password, int port,
                          const std::string& container, const std::string& oraHome,
                          const std::string& oraSid);
+        void setStreaming(bool newStreaming);
+
     private:
         REDO_CODE setupSshConnection();
         REDO_CODE transferAsmFileToMemory();
         void closeSshConnection();
 
+        // 流式模式：远端常驻进程按 offset/length 返回数据块
+        std::string buildRangeReaderCommand() const;
+        REDO_CODE openRangeReader();
+        bool sendRangeRequest(uint64_t offset, uint64_t size);
+        int64_t receiveRange();
+        int64_t readRangeHeader();
+        bool channelReadExact(uint8_t* buf, uint64_t size);
+        int64_t receivePacked(uint64_t size);
+        int rangeRead(uint8_t* buf, uint64_t offset, uint size);
+        bool refreshRemote();
+
+        // 传输压缩：远端压缩后经 SSH 传输，本地边接收边解压
+        std::string compressorCommand() const;
+        bool transportReset();
+        bool transportDecode(const uint8_t* in, uint64_t inSize, std::unique_ptr<uint8_t[]>& out, uint64_t& outSize, uint64_t& outLength,
+                             bool& frameEnd);
+
         // SSH 连接相关
-        ssh_session sshSession{nullptr};
+        SshSession* sshSession{nullptr};
         ssh_channel sshChannel{nullptr};
         std::string sshHost;
         std::string sshUser;
@@ -46,6 +83,36 @@ namespace OpenLogReplicator {
         std::unique_ptr<uint8_t[]> fileBuffer;
         uint64_t bufferSize{0};
         uint64_t dataLength{0};
+
+        // 流式模式（默认），关闭时退回整文件传输
+        bool streaming{true};
+        // 缓冲区中尚未被读取的数据：文件偏移 rangeOffset 对应 rangeBuffer[rangeHead]
+        std::unique_ptr<uint8_t[]> rangeBuffer;
+        uint64_t rangeBufferSize{0};
+        uint64_t rangeHead{0};
+        uint64_t rangeOffset{0};
+        uint64_t rangeLength{0};
+        // 已发出、尚未读取应答的预取请求
+        bool rangePending{false};
+        uint64_t pendingOffset{0};
+
+        // 在线日志跟随：已读取到的位置，每次轮询只从这里开始读取新写入的数据块
+        uint64_t tailCursor{0};
+        time_ut lastRefresh{0};
+        time_ut refreshIntervalUs{0};
+        // 上次刷新时的游标位置，用于判断刷新后是否读到了新数据块
+        uint64_t refreshCursor{0};
+
+        Ctx::TRANSPORT_COMPRESSION transport{Ctx::TRANSPORT_COMPRESSION::NONE};
+        // 接收到的压缩数据
+        std::unique_ptr<uint8_t[]> packedBuffer;
+        uint64_t packedBufferSize{0};
+#ifdef LINK_LIBRARY_ZSTD
+        ZSTD_DCtx* zstdCtx{nullptr};
+#endif
+#ifdef LINK_LIBRARY_LZ4
+        LZ4F_dctx* lz4Ctx{nullptr};
+#endif
     };
 }
 
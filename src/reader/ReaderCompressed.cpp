@@ -0,0 +1,380 @@
+/* Class reading compressed archived redo log files
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#define _LARGEFILE_SOURCE
+enum {
+_FILE_OFFSET_BITS = 64
+};
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../common/Clock.h"
+#include "../common/Ctx.h"
+#include "ReaderCompressed.h"
+
+namespace OpenLogReplicator {
+    ReaderCompressed::ReaderCompressed(Ctx* newCtx, std::string newAlias, std::string newDatabase, int newGroup, bool newConfiguredBlockSum) :
+            ReaderFilesystem(newCtx, std::move(newAlias), std::move(newDatabase), newGroup, newConfiguredBlockSum),
+            inBuffer(new uint8_t[IN_BUFFER_SIZE]),
+            skipBuffer(new uint8_t[SKIP_BUFFER_SIZE]),
+            header(new uint8_t[PAGE_SIZE_MAX * 2]) {
+    }
+
+    ReaderCompressed::~ReaderCompressed() {
+        ReaderCompressed::redoClose();
+#ifdef LINK_LIBRARY_ZSTD
+        if (zstdCtx != nullptr) {
+            ZSTD_freeDCtx(zstdCtx);
+            zstdCtx = nullptr;
+        }
+#endif /* LINK_LIBRARY_ZSTD */
+
+        delete[] inBuffer;
+        inBuffer = nullptr;
+        delete[] skipBuffer;
+        skipBuffer = nullptr;
+        delete[] header;
+        header = nullptr;
+    }
+
+    void ReaderCompressed::redoClose() {
+        ReaderFilesystem::redoClose();
+#ifdef LINK_LIBRARY_ZLIB
+        if (zlibReady) {
+            inflateEnd(&zlibStream);
+            zlibReady = false;
+        }
+#endif /* LINK_LIBRARY_ZLIB */
+        codec = CODEC::NONE;
+        frames.clear();
+        framesSize = 0;
+        headerSize = 0;
+    }
+
+    Reader::REDO_CODE ReaderCompressed::redoOpen() {
+        ReaderCompressed::redoClose();
+
+        contextSet(CONTEXT::OS, REASON::OS);
+        const int des = open(fileName.c_str(), O_RDONLY);
+        contextSet(CONTEXT::CPU);
+        if (des == -1) {
+            ctx->error(10001, "file: " + fileName + " - open for read returned: " + strerror(errno));
+            return REDO_CODE::ERROR;
+        }
+
+        uint8_t magic[4]{};
+        struct stat fileStat{};
+        contextSet(CONTEXT::OS, REASON::OS);
+        const int64_t magicSize = pread(des, magic, sizeof(magic), 0);
+        const int statRet = fstat(des, &fileStat);
+        contextSet(CONTEXT::CPU);
+
+        if (magicSize == sizeof(magic) && Ctx::read32Little(magic) == ZSTD_MAGIC)
+            codec = CODEC::ZSTD;
+        else if (magicSize >= 2 && magic[0] == 0x1F && magic[1] == 0x8B)
+            codec = CODEC::GZIP;
+
+        if (codec == CODEC::NONE || statRet != 0) {
+            close(des);
+            codec = CODEC::NONE;
+            return ReaderFilesystem::redoOpen();
+        }
+
+#ifndef LINK_LIBRARY_ZSTD
+        if (codec == CODEC::ZSTD) {
+            close(des);
+            codec = CODEC::NONE;
+            ctx->error(10092, "file: " + fileName + " - compressed with zstd, but the code is not compiled with zstd support");
+            return REDO_CODE::ERROR;
+        }
+#endif /* LINK_LIBRARY_ZSTD */
+#ifndef LINK_LIBRARY_ZLIB
+        if (codec == CODEC::GZIP) {
+            close(des);
+            codec = CODEC::NONE;
+            ctx->error(10092, "file: " + fileName + " - compressed with gzip, but the code is not compiled with zlib support");
+            return REDO_CODE::ERROR;
+        }
+#endif /* LINK_LIBRARY_ZLIB */
+
+        fileDes = des;
+        compressedSize = fileStat.st_size;
+        if (codec == CODEC::ZSTD)
+            loadSeekTable();
+
+        if (!streamReset(0, 0))
+            return REDO_CODE::ERROR;
+        const int64_t bytes = streamRead(header, PAGE_SIZE_MAX * 2);
+        if (bytes < 0)
+            return REDO_CODE::ERROR_READ;
+        headerSize = bytes;
+
+        // The size of the decompressed file is in the seek table or else in the redo log header
+        fileSize = 0;
+        if (!frames.empty()) {
+            fileSize = framesSize;
+        } else if (headerSize >= 32) {
+            const bool bigEndian = header[28] == 0x7A;
+            const uint headerBlockSize = bigEndian ? Ctx::read32Big(header + 20) : Ctx::read32Little(header + 20);
+            if ((headerBlockSize == 512 || headerBlockSize == 1024 || headerBlockSize == 4096) && headerSize >= headerBlockSize + 160) {
+                const typeBlk blocks = bigEndian ? Ctx::read32Big(header + headerBlockSize + 156) :
+                                       Ctx::read32Little(header + headerBlockSize + 156);
+                if (blocks != Ctx::ZERO_BLK)
+                    fileSize = static_cast<uint64_t>(blocks) * headerBlockSize;
+            }
+        }
+        fileSize &= ~static_cast<uint64_t>(Ctx::MIN_BLOCK_SIZE - 1);
+        if (fileSize == 0) {
+            ctx->error(10092, "file: " + fileName + " - can't find the size of the decompressed redo log");
+            return REDO_CODE::ERROR_BAD_DATA;
+        }
+
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::FILE)))
+            ctx->logTrace(Ctx::TRACE::FILE, "compressed " + std::string(codec == CODEC::ZSTD ? "zstd" : "gzip") + " file: " + fileName +
+                                            " size: " + std::to_string(compressedSize) + " decompressed: " + std::to_string(fileSize) +
+                                            " frames: " + std::to_string(frames.size()));
+        return REDO_CODE::OK;
+    }
+
+    // Seekable format: a skippable frame at the end of the file with the compressed and decompressed size of every frame,
+    // followed by the number of frames, a descriptor and the seekable magic number
+    bool ReaderCompressed::loadSeekTable() {
+        if (compressedSize < ZSTD_SEEKABLE_FOOTER + 8)
+            return false;
+
+        uint8_t footer[ZSTD_SEEKABLE_FOOTER];
+        contextSet(CONTEXT::OS, REASON::OS);
+        const int64_t footerSize = pread(fileDes, footer, ZSTD_SEEKABLE_FOOTER, static_cast<int64_t>(compressedSize - ZSTD_SEEKABLE_FOOTER));
+        contextSet(CONTEXT::CPU);
+        if (footerSize != static_cast<int64_t>(ZSTD_SEEKABLE_FOOTER) || Ctx::read32Little(footer + 5) != ZSTD_SEEKABLE_MAGIC)
+            return false;
+
+        const uint64_t numFrames = Ctx::read32Little(footer);
+        const uint64_t entrySize = (footer[4] & 0x80) != 0 ? 12 : 8;
+        const uint64_t tableSize = numFrames * entrySize;
+        const uint64_t skippableSize = tableSize + ZSTD_SEEKABLE_FOOTER;
+        if (numFrames == 0 || skippableSize + 8 > compressedSize) {
+            ctx->warning(60055, "file: " + fileName + " - invalid zstd seek table, reading sequentially");
+            return false;
+        }
+
+        std::vector<uint8_t> table(tableSize + 8);
+        contextSet(CONTEXT::OS, REASON::OS);
+        const int64_t tableRead = pread(fileDes, table.data(), tableSize + 8, static_cast<int64_t>(compressedSize - skippableSize - 8));
+        contextSet(CONTEXT::CPU);
+        if (tableRead != static_cast<int64_t>(tableSize + 8) || Ctx::read32Little(table.data()) != ZSTD_SKIPPABLE_MAGIC ||
+            Ctx::read32Little(table.data() + 4) != skippableSize) {
+            ctx->warning(60055, "file: " + fileName + " - invalid zstd seek table, reading sequentially");
+            return false;
+        }
+
+        uint64_t compressedEnd = 0;
+        uint64_t decompressedEnd = 0;
+        frames.reserve(numFrames);
+        for (uint64_t num = 0; num < numFrames; ++num) {
+            const uint8_t* entry = table.data() + 8 + (num * entrySize);
+            frames.push_back(Frame{compressedEnd, decompressedEnd});
+            compressedEnd += Ctx::read32Little(entry);
+            decompressedEnd += Ctx::read32Little(entry + 4);
+        }
+
+        if (compressedEnd != compressedSize - skippableSize - 8) {
+            ctx->warning(60055, "file: " + fileName + " - invalid zstd seek table, reading sequentially");
+            frames.clear();
+            return false;
+        }
+        framesSize = decompressedEnd;
+        return true;
+    }
+
+    bool ReaderCompressed::streamReset(uint64_t newCompressedOffset, uint64_t newStreamOffset) {
+        compressedOffset = newCompressedOffset;
+        streamOffset = newStreamOffset;
+        streamEnd = false;
+        inPos = 0;
+        inSize = 0;
+
+#ifdef LINK_LIBRARY_ZSTD
+        if (codec == CODEC::ZSTD) {
+            if (zstdCtx == nullptr)
+                zstdCtx = ZSTD_createDCtx();
+            if (zstdCtx == nullptr) {
+                ctx->error(10092, "file: " + fileName + " - can't create zstd decompression context");
+                return false;
+            }
+            ZSTD_DCtx_reset(zstdCtx, ZSTD_reset_session_only);
+        }
+#endif /* LINK_LIBRARY_ZSTD */
+#ifdef LINK_LIBRARY_ZLIB
+        if (codec == CODEC::GZIP) {
+            if (zlibReady) {
+                inflateEnd(&zlibStream);
+                zlibReady = false;
+            }
+            zlibStream = z_stream{};
+            // Gzip wrapper only
+            if (inflateInit2(&zlibStream, 16 + MAX_WBITS) != Z_OK) {
+                ctx->error(10092, "file: " + fileName + " - can't initialize zlib decompression");
+                return false;
+            }
+            zlibReady = true;
+        }
+#endif /* LINK_LIBRARY_ZLIB */
+        return true;
+    }
+
+    // A range behind the stream restarts it from the frame holding the range, or from the beginning when there is no seek table
+    bool ReaderCompressed::streamSeek(uint64_t offset) {
+        if (offset == streamOffset)
+            return true;
+
+        if (!frames.empty()) {
+            auto it = std::upper_bound(frames.begin(), frames.end(), offset,
+                                       [](uint64_t value, const Frame& frame) { return value < frame.offset; });
+            --it;
+            if (offset < streamOffset || it->offset > streamOffset)
+                if (!streamReset(it->compressedOffset, it->offset))
+                    return false;
+        } else if (offset < streamOffset) {
+            if (unlikely(ctx->isTraceSet(Ctx::TRACE::FILE)))
+                ctx->logTrace(Ctx::TRACE::FILE, "restarting decompression of: " + fileName + " for offset: " + std::to_string(offset));
+            if (!streamReset(0, 0))
+                return false;
+        }
+
+        while (streamOffset < offset) {
+            const int64_t bytes = streamRead(skipBuffer, std::min(SKIP_BUFFER_SIZE, offset - streamOffset));
+            if (bytes < 0)
+                return false;
+            if (bytes == 0)
+                break;
+        }
+        return true;
+    }
+
+    bool ReaderCompressed::inputFill() {
+        if (inPos < inSize)
+            return true;
+
+        contextSet(CONTEXT::OS, REASON::OS);
+        const int64_t bytes = pread(fileDes, inBuffer, IN_BUFFER_SIZE, static_cast<int64_t>(compressedOffset));
+        contextSet(CONTEXT::CPU);
+        if (bytes < 0)
+            return false;
+
+        inPos = 0;
+        inSize = bytes;
+        compressedOffset += bytes;
+        return true;
+    }
+
+    // Returns the number of bytes decompressed, 0 at the end of the stream and -1 on error
+    int64_t ReaderCompressed::streamRead(uint8_t* buf, uint64_t size) {
+        uint64_t done = 0;
+        while (done < size && !streamEnd) {
+            if (!inputFill())
+                return -1;
+            if (inSize == 0) {
+                streamEnd = true;
+                break;
+            }
+
+#ifdef LINK_LIBRARY_ZSTD
+            if (codec == CODEC::ZSTD) {
+                ZSTD_inBuffer input{inBuffer, inSize, inPos};
+                ZSTD_outBuffer output{buf + done, size - done, 0};
+                const size_t zstdRet = ZSTD_decompressStream(zstdCtx, &output, &input);
+                if (ZSTD_isError(zstdRet)) {
+                    ctx->error(10092, "file: " + fileName + " - zstd decompression at offset: " + std::to_string(streamOffset) + " returned: " +
+                                      ZSTD_getErrorName(zstdRet));
+                    errno = EIO;
+                    return -1;
+                }
+                inPos = input.pos;
+                done += output.pos;
+                streamOffset += output.pos;
+            }
+#endif /* LINK_LIBRARY_ZSTD */
+#ifdef LINK_LIBRARY_ZLIB
+            if (codec == CODEC::GZIP) {
+                const uInt outSize = static_cast<uInt>(std::min(size - done, static_cast<uint64_t>(Ctx::MEMORY_CHUNK_SIZE)));
+                zlibStream.next_in = inBuffer + inPos;
+                zlibStream.avail_in = static_cast<uInt>(inSize - inPos);
+                zlibStream.next_out = buf + done;
+                zlibStream.avail_out = outSize;
+                const int zlibRet = inflate(&zlibStream, Z_NO_FLUSH);
+                const uint64_t produced = outSize - zlibStream.avail_out;
+                inPos = inSize - zlibStream.avail_in;
+                done += produced;
+                streamOffset += produced;
+
+                // Concatenated gzip members make one stream
+                if (zlibRet == Z_STREAM_END) {
+                    if (inflateReset(&zlibStream) != Z_OK) {
+                        ctx->error(10092, "file: " + fileName + " - zlib reset at offset: " + std::to_string(streamOffset) + " failed");
+                        errno = EIO;
+                        return -1;
+                    }
+                } else if (zlibRet != Z_OK && zlibRet != Z_BUF_ERROR) {
+                    ctx->error(10092, "file: " + fileName + " - zlib decompression at offset: " + std::to_string(streamOffset) + " returned: " +
+                                      (zlibStream.msg != nullptr ? zlibStream.msg : std::to_string(zlibRet)));
+                    errno = EIO;
+                    return -1;
+                }
+            }
+#endif /* LINK_LIBRARY_ZLIB */
+        }
+        return static_cast<int64_t>(done);
+    }
+
+    int ReaderCompressed::redoRead(uint8_t* buf, uint64_t offset, uint size) {
+        if (codec == CODEC::NONE)
+            return ReaderFilesystem::redoRead(buf, offset, size);
+
+        // The header is read again for every log switch check
+        if (offset < headerSize) {
+            const uint64_t bytes = std::min(static_cast<uint64_t>(size), headerSize - offset);
+            memcpy(buf, header + offset, bytes);
+            return static_cast<int>(bytes);
+        }
+
+        uint64_t startTime = 0;
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::PERFORMANCE)))
+            startTime = ctx->clock->getTimeUt();
+
+        int64_t bytes = -1;
+        if (streamSeek(offset))
+            bytes = streamRead(buf, size);
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::FILE)))
+            ctx->logTrace(Ctx::TRACE::FILE, "read compressed " + fileName + ", " + std::to_string(offset) + ", " + std::to_string(size) +
+                                            " returns " + std::to_string(bytes));
+
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::PERFORMANCE))) {
+            if (bytes > 0)
+                sumRead += bytes;
+            sumTime += ctx->clock->getTimeUt() - startTime;
+        }
+        return static_cast<int>(bytes);
+    }
+}
@@ -0,0 +1,98 @@
+/* Header for ReaderCompressed class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef READER_COMPRESSED_H_
+#define READER_COMPRESSED_H_
+
+#include <vector>
+#ifdef LINK_LIBRARY_ZSTD
+#include <zstd.h>
+#endif /* LINK_LIBRARY_ZSTD */
+#ifdef LINK_LIBRARY_ZLIB
+#include <zlib.h>
+#endif /* LINK_LIBRARY_ZLIB */
+
+#include "ReaderFilesystem.h"
+
+namespace OpenLogReplicator {
+    // Archived redo logs compressed with zstd or gzip are decompressed on the fly into the redo buffers, without a copy on disk.
+    // The format is taken from the magic number, files which are not compressed are read by ReaderFilesystem.
+    // The reader asks for the header and then for ascending ranges, so the stream is only restarted for a range behind it.
+    // A zstd file in the seekable format (many frames and a seek table in a trailing skippable frame) restarts from the
+    // frame holding the range instead of from the beginning
+    class ReaderCompressed final : public ReaderFilesystem {
+    protected:
+        enum class CODEC : unsigned char {
+            NONE, ZSTD, GZIP
+        };
+
+        struct Frame {
+            uint64_t compressedOffset;
+            uint64_t offset;
+        };
+
+        static constexpr uint64_t IN_BUFFER_SIZE{1024 * 1024};
+        static constexpr uint64_t SKIP_BUFFER_SIZE{64 * 1024};
+        static constexpr uint32_t ZSTD_MAGIC{0xFD2FB528};
+        static constexpr uint32_t ZSTD_SKIPPABLE_MAGIC{0x184D2A5E};
+        static constexpr uint32_t ZSTD_SEEKABLE_MAGIC{0x8F92EAB1};
+        static constexpr uint64_t ZSTD_SEEKABLE_FOOTER{9};
+
+        CODEC codec{CODEC::NONE};
+        uint64_t compressedSize{0};
+        // Next byte of the compressed file to read to the input buffer
+        uint64_t compressedOffset{0};
+        // Offset in the decompressed file of the next byte written by the stream
+        uint64_t streamOffset{0};
+        bool streamEnd{false};
+        uint8_t* inBuffer{nullptr};
+        uint64_t inPos{0};
+        uint64_t inSize{0};
+        uint8_t* skipBuffer{nullptr};
+        // First bytes of the file, the header is read again at every log switch check
+        uint8_t* header{nullptr};
+        uint64_t headerSize{0};
+        std::vector<Frame> frames;
+        // Decompressed size of all frames of the seek table
+        uint64_t framesSize{0};
+#ifdef LINK_LIBRARY_ZSTD
+        ZSTD_DCtx* zstdCtx{nullptr};
+#endif /* LINK_LIBRARY_ZSTD */
+#ifdef LINK_LIBRARY_ZLIB
+        z_stream zlibStream{};
+        bool zlibReady{false};
+#endif /* LINK_LIBRARY_ZLIB */
+
+        void redoClose() override;
+        REDO_CODE redoOpen() override;
+        int redoRead(uint8_t* buf, uint64_t offset, uint size) override;
+
+        bool loadSeekTable();
+        bool streamReset(uint64_t newCompressedOffset, uint64_t newStreamOffset);
+        bool streamSeek(uint64_t offset);
+        int64_t streamRead(uint8_t* buf, uint64_t size);
+        bool inputFill();
+
+    public:
+        ReaderCompressed(Ctx* newCtx, std::string newAlias, std::string newDatabase, int newGroup, bool newConfiguredBlockSum);
+        ~ReaderCompressed() override;
+    };
+}
+
+#endif
@@ -26,11 +26,14 @@ _FILE_OFFSET_BITS = 64
 #include <cstring>
 #include <dirent.h>
 #include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
 #include "../common/Clock.h"
 #include "../common/Ctx.h"
+#include "BlockSum.h"
+#include "MemberReader.h"
 #include "ReaderFilesystem.h"
 
 namespace OpenLogReplicator {
@@ -39,10 +42,27 @@ namespace OpenLogReplicator {
     }
 
     ReaderFilesystem::~ReaderFilesystem() {
+        for (MemberReader*& memberReader: memberReaders) {
+            if (memberReader == nullptr)
+                continue;
+            memberReader->stop();
+            ctx->finishThread(memberReader);
+            delete memberReader;
+            memberReader = nullptr;
+        }
         ReaderFilesystem::redoClose();
     }
 
     void ReaderFilesystem::redoClose() {
+        if (redoMapping != nullptr) {
+            bufferUnmapAll();
+            contextSet(CONTEXT::OS, REASON::OS);
+            munmap(const_cast<uint8_t*>(redoMapping), redoMappingSize);
+            contextSet(CONTEXT::CPU);
+            redoMapping = nullptr;
+            redoMappingSize = 0;
+        }
+
         // 原有的文件系统模式逻辑：关闭文件描述符
         if (fileDes != -1) {  // 检查文件描述符是否有效
             contextSet(CONTEXT::OS, REASON::OS);  // 设置上下文为操作系统级别
@@ -95,10 +115,118 @@ namespace OpenLogReplicator {
         }
 #endif
 
+        // An archived redo log doesn't change any more, it is parsed in place from the mapping
+        if (ctx->readMmap && group == 0 && fileSize > 0) {
+            contextSet(CONTEXT::OS, REASON::OS);
+            void* mapping = mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fileDes, 0);
+            contextSet(CONTEXT::CPU);
+            if (mapping == MAP_FAILED) {
+                ctx->warning(60065, "file: " + fileName + " - mmap returned: " + strerror(errno) + ", reading with pread");
+            } else {
+                madvise(mapping, fileSize, MADV_SEQUENTIAL);
+                redoMapping = reinterpret_cast<const uint8_t*>(mapping);
+                redoMappingSize = fileSize;
+            }
+        }
+
         return REDO_CODE::OK;
     }
 
+    // The same range is read from two members of the group, the first result with all checksums valid is taken. When neither is
+    // fully valid, the one with more valid blocks is taken. Returns 0 when the caller should read the primary member itself
+    int ReaderFilesystem::hedgedRead(uint8_t* buf, uint64_t offset, uint size) {
+        if (memberReaders[0] == nullptr) {
+            for (uint i = 0; i < HEDGED_MEMBERS; ++i) {
+                memberReaders[i] = new MemberReader(ctx, alias + "-member-" + std::to_string(i), &eventMember);
+                ctx->spawnThread(memberReaders[i]);
+            }
+        }
+
+        const std::string* names[HEDGED_MEMBERS]{&fileName, &members.front()};
+        bool waiting[HEDGED_MEMBERS]{};
+        uint pending = 0;
+        for (uint i = 0; i < HEDGED_MEMBERS; ++i) {
+            // A member still busy with the read which lost the previous race is skipped
+            if (memberReaders[i]->submit(*names[i], offset, size)) {
+                waiting[i] = true;
+                ++pending;
+            }
+        }
+        if (pending == 0)
+            return 0;
+
+        const bool checkSum = !ctx->isDisableChecksSet(Ctx::DISABLE_CHECKS::BLOCK_SUM);
+        int bestMember = -1;
+        int bestBytes = 0;
+        uint bestGood = 0;
+        int worstMember = -1;
+        uint worstGood = 0;
+        while (pending > 0) {
+            for (uint i = 0; i < HEDGED_MEMBERS && pending > 0; ++i) {
+                if (!waiting[i] || memberReaders[i]->isBusy())
+                    continue;
+                waiting[i] = false;
+                --pending;
+
+                int readError = 0;
+                const int bytes = memberReaders[i]->getResult(readError);
+                if (bytes <= 0) {
+                    if (bytes < 0)
+                        ctx->error(10005, "file: " + *names[i] + " - " + strerror(readError));
+                    continue;
+                }
+
+                const uint blocks = bytes / blockSize;
+                const uint good = checkSum ? BlockSum::verify(memberReaders[i]->getBuffer(), blockSize, blocks) : blocks;
+                if (bestMember == -1 || good > bestGood) {
+                    if (bestMember != -1) {
+                        worstMember = bestMember;
+                        worstGood = bestGood;
+                    }
+                    memcpy(buf, memberReaders[i]->getBuffer(), bytes);
+                    bestMember = static_cast<int>(i);
+                    bestBytes = bytes;
+                    bestGood = good;
+                } else if (good < bestGood) {
+                    worstMember = static_cast<int>(i);
+                    worstGood = good;
+                }
+
+                if (good == blocks)
+                    pending = 0;
+            }
+            if (pending == 0)
+                break;
+
+            auto memberDone = [this, &waiting] {
+                for (uint i = 0; i < HEDGED_MEMBERS; ++i)
+                    if (waiting[i] && !memberReaders[i]->isBusy())
+                        return true;
+                return ctx->hardShutdown;
+            };
+            contextSet(CONTEXT::WAIT, REASON::READER_MEMBER_WAIT);
+            eventMember.park(memberDone);
+            contextSet(CONTEXT::CPU);
+            if (ctx->hardShutdown)
+                break;
+        }
+
+        if (worstMember != -1)
+            ctx->warning(60054, "file: " + *names[worstMember] + " - block: " + std::to_string(offset / blockSize + worstGood) +
+                                " - invalid checksum, block read from: " + *names[bestMember]);
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::DISK)) && bestMember != -1)
+            ctx->logTrace(Ctx::TRACE::DISK, "hedged read " + std::to_string(offset) + ", " + std::to_string(size) + " taken from: " +
+                                            *names[bestMember] + " bytes: " + std::to_string(bestBytes));
+        return bestBytes;
+    }
+
     int ReaderFilesystem::redoRead(uint8_t* buf, uint64_t offset, uint size) {
+        if (ctx->readHedged && group != 0 && blockSize > 0 && !members.empty() && size <= Ctx::MEMORY_CHUNK_SIZE) {
+            const int bytes = hedgedRead(buf, offset, size);
+            if (bytes > 0)
+                return bytes;
+        }
+
         uint64_t startTime = 0;
         if (unlikely(ctx->isTraceSet(Ctx::TRACE::PERFORMANCE)))
             startTime = ctx->clock->getTimeUt();
@@ -20,14 +20,24 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #ifndef READER_FILESYSTEM_H_
 #define READER_FILESYSTEM_H_
 
+#include "../common/FutexEvent.h"
 #include "Reader.h"
 
 namespace OpenLogReplicator {
+    class MemberReader;
+
     class ReaderFilesystem : public Reader {
 
     protected:
+        static constexpr uint HEDGED_MEMBERS{2};
+
         int fileDes{-1};
         int flags{0};
+        // Threads reading two members of the group at once, created with the first hedged read
+        MemberReader* memberReaders[HEDGED_MEMBERS]{};
+        FutexEvent eventMember;
+
+        int hedgedRead(uint8_t* buf, uint64_t offset, uint size);
         void redoClose() override;
         REDO_CODE redoOpen() override;
         int redoRead(uint8_t* buf, uint64_t offset, uint size) override;
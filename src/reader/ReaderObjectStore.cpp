@@ -0,0 +1,539 @@
+/* Class reading archived redo logs from S3 compatible object storage
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <hv/HttpClient.h>
+#include <thread>
+#include <unistd.h>
+
+#include "../common/Clock.h"
+#include "../common/Ctx.h"
+#include "../common/Sha256.h"
+#include "../common/exception/RuntimeException.h"
+#include "../common/types/Data.h"
+#include "ReaderObjectStore.h"
+
+namespace OpenLogReplicator {
+    RangeFetcher::RangeFetcher(Ctx* newCtx, std::string newAlias, ReaderObjectStore* newReader) :
+            Thread(newCtx, std::move(newAlias)),
+            reader(newReader) {
+    }
+
+    void RangeFetcher::wakeUp() {
+        reader->fetchWakeUp();
+    }
+
+    void RangeFetcher::run() {
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
+            std::ostringstream ss;
+            ss << std::this_thread::get_id();
+            ctx->logTrace(Ctx::TRACE::THREADS, "range fetcher (" + ss.str() + ") start");
+        }
+
+        try {
+            reader->fetchRun(this);
+        } catch (RuntimeException& ex) {
+            ctx->error(ex.code, ex.msg);
+            ctx->stopHard();
+        }
+
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
+            std::ostringstream ss;
+            ss << std::this_thread::get_id();
+            ctx->logTrace(Ctx::TRACE::THREADS, "range fetcher (" + ss.str() + ") stop");
+        }
+    }
+
+    ReaderObjectStore::ReaderObjectStore(Ctx* newCtx, std::string newAlias, std::string newDatabase, int newGroup, bool newConfiguredBlockSum) :
+            ReaderFilesystem(newCtx, std::move(newAlias), std::move(newDatabase), newGroup, newConfiguredBlockSum),
+            ranges(ctx->objectStoreStreams + 1),
+            rangeSize(ctx->objectStoreRangeMb * 1024 * 1024) {
+    }
+
+    ReaderObjectStore::~ReaderObjectStore() {
+        {
+            std::unique_lock<std::mutex> const lck(fetchMtx);
+            stopped = true;
+            condFetch.notify_all();
+            condReady.notify_all();
+        }
+        for (RangeFetcher* fetcher: fetchers) {
+            ctx->finishThread(fetcher);
+            delete fetcher;
+        }
+        fetchers.clear();
+        ReaderObjectStore::redoClose();
+    }
+
+    bool ReaderObjectStore::isUrl(const std::string& path) {
+        return path.rfind("s3://", 0) == 0 || path.rfind("http://", 0) == 0 || path.rfind("https://", 0) == 0;
+    }
+
+    void ReaderObjectStore::fetchWakeUp() {
+        std::unique_lock<std::mutex> const lck(fetchMtx);
+        condFetch.notify_all();
+        condReady.notify_all();
+    }
+
+    void ReaderObjectStore::rangesReset() {
+        // A range being fetched is dropped by the fetcher when it sees the new generation
+        for (Range& range: ranges) {
+            if (range.state == RANGE_STATE::FETCHING)
+                continue;
+            range.state = RANGE_STATE::EMPTY;
+            range.data.clear();
+        }
+    }
+
+    void ReaderObjectStore::redoClose() {
+        {
+            std::unique_lock<std::mutex> const lck(fetchMtx);
+            ++generation;
+            rangesReset();
+            remote = false;
+            url.clear();
+            header.clear();
+        }
+        ReaderFilesystem::redoClose();
+    }
+
+    Reader::REDO_CODE ReaderObjectStore::redoOpen() {
+        if (!isUrl(fileName)) {
+            ReaderObjectStore::redoClose();
+            return ReaderFilesystem::redoOpen();
+        }
+        ReaderObjectStore::redoClose();
+
+        // The range of the header also returns the size of the object
+        hv::HttpClient client;
+        std::string body;
+        uint64_t objectSize = 0;
+        const int httpStatus = request(ctx, &client, "GET", fileName, "", "bytes=0-" + std::to_string(PAGE_SIZE_MAX * 2 - 1), body, objectSize);
+        if (httpStatus != 200 && httpStatus != 206) {
+            ctx->error(10093, "object: " + fileName + " - GET returned: " + std::to_string(httpStatus));
+            return REDO_CODE::ERROR;
+        }
+        if (body.size() > PAGE_SIZE_MAX * 2)
+            body.resize(PAGE_SIZE_MAX * 2);
+
+        if ((objectSize & (Ctx::MIN_BLOCK_SIZE - 1)) != 0) {
+            objectSize &= ~(Ctx::MIN_BLOCK_SIZE - 1);
+            ctx->warning(10071, "file: " + fileName + " size is not a multiplication of " + std::to_string(Ctx::MIN_BLOCK_SIZE) + ", reading only " +
+                                std::to_string(objectSize) + " bytes ");
+        }
+
+        {
+            std::unique_lock<std::mutex> const lck(fetchMtx);
+            ++generation;
+            rangesReset();
+            url = fileName;
+            header = std::move(body);
+            fileSize = objectSize;
+            remote = true;
+        }
+
+        if (fetchers.empty()) {
+            for (uint num = 0; num < ctx->objectStoreStreams; ++num) {
+                auto* fetcher = new RangeFetcher(ctx, alias + "-fetcher-" + std::to_string(num), this);
+                fetchers.push_back(fetcher);
+                ctx->spawnThread(fetcher);
+            }
+        }
+
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::FILE)))
+            ctx->logTrace(Ctx::TRACE::FILE, "object: " + fileName + " size: " + std::to_string(fileSize));
+        return REDO_CODE::OK;
+    }
+
+    // Returns the range, or nullptr when all ranges are in use. Ranges behind the current one or too far ahead are reused
+    ReaderObjectStore::Range* ReaderObjectStore::rangeQueue(uint64_t index, uint64_t currentIndex) {
+        for (Range& range: ranges)
+            if (range.state != RANGE_STATE::EMPTY && range.index == index)
+                return &range;
+
+        for (Range& range: ranges) {
+            const bool done = range.state == RANGE_STATE::READY || range.state == RANGE_STATE::FAILED;
+            if (range.state == RANGE_STATE::EMPTY || (done && (range.index < currentIndex || range.index >= currentIndex + ranges.size()))) {
+                range.index = index;
+                range.state = RANGE_STATE::QUEUED;
+                range.data.clear();
+                condFetch.notify_one();
+                return &range;
+            }
+        }
+        return nullptr;
+    }
+
+    int ReaderObjectStore::redoRead(uint8_t* buf, uint64_t offset, uint size) {
+        if (!remote)
+            return ReaderFilesystem::redoRead(buf, offset, size);
+
+        if (offset < header.size()) {
+            const uint64_t bytes = std::min(static_cast<uint64_t>(size), header.size() - offset);
+            memcpy(buf, header.data() + offset, bytes);
+            return static_cast<int>(bytes);
+        }
+
+        uint64_t startTime = 0;
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::PERFORMANCE)))
+            startTime = ctx->clock->getTimeUt();
+
+        const uint64_t index = offset / rangeSize;
+        contextSet(CONTEXT::MUTEX, REASON::READER_FETCH);
+        std::unique_lock<std::mutex> lck(fetchMtx);
+        Range* range;
+        for (;;) {
+            range = rangeQueue(index, index);
+            for (uint64_t next = index + 1; next <= index + fetchers.size() && next * rangeSize < fileSize; ++next)
+                rangeQueue(next, index);
+
+            if (range != nullptr && (range->state == RANGE_STATE::READY || range->state == RANGE_STATE::FAILED))
+                break;
+            if (ctx->hardShutdown || stopped) {
+                contextSet(CONTEXT::CPU);
+                errno = EINTR;
+                return -1;
+            }
+            contextSet(CONTEXT::WAIT, REASON::READER_FETCH_WAIT);
+            condReady.wait_for(lck, std::chrono::milliseconds(100));
+            contextSet(CONTEXT::MUTEX, REASON::READER_FETCH);
+        }
+
+        int bytes = 0;
+        if (range->state == RANGE_STATE::FAILED) {
+            range->state = RANGE_STATE::EMPTY;
+            errno = EIO;
+            bytes = -1;
+        } else {
+            const uint64_t pos = offset - (index * rangeSize);
+            if (pos < range->data.size()) {
+                bytes = static_cast<int>(std::min(static_cast<uint64_t>(size), range->data.size() - pos));
+                memcpy(buf, range->data.data() + pos, bytes);
+            }
+        }
+        lck.unlock();
+        contextSet(CONTEXT::CPU);
+
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::FILE)))
+            ctx->logTrace(Ctx::TRACE::FILE, "read " + fileName + ", " + std::to_string(offset) + ", " + std::to_string(size) +
+                                            " returns " + std::to_string(bytes));
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::PERFORMANCE))) {
+            if (bytes > 0)
+                sumRead += bytes;
+            sumTime += ctx->clock->getTimeUt() - startTime;
+        }
+        return bytes;
+    }
+
+    void ReaderObjectStore::fetchRun(RangeFetcher* fetcher) {
+        hv::HttpClient client;
+
+        fetcher->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::READER_FETCH);
+        std::unique_lock<std::mutex> lck(fetchMtx);
+        while (!ctx->hardShutdown && !stopped) {
+            Range* range = nullptr;
+            for (Range& candidate: ranges)
+                if (candidate.state == RANGE_STATE::QUEUED && (range == nullptr || candidate.index < range->index))
+                    range = &candidate;
+
+            if (range == nullptr) {
+                fetcher->contextSet(Thread::CONTEXT::WAIT, Thread::REASON::READER_FETCH_NO_WORK);
+                condFetch.wait_for(lck, std::chrono::milliseconds(100));
+                fetcher->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::READER_FETCH);
+                continue;
+            }
+
+            range->state = RANGE_STATE::FETCHING;
+            const uint64_t fetchGeneration = generation;
+            const std::string fetchUrl = url;
+            const uint64_t start = range->index * rangeSize;
+            const uint64_t end = std::min(fileSize, start + rangeSize);
+            lck.unlock();
+            fetcher->contextSet(Thread::CONTEXT::CPU);
+
+            std::string body;
+            uint64_t objectSize = 0;
+            int httpStatus = -1;
+            for (uint tries = ctx->archReadTries; tries > 0 && !ctx->hardShutdown; --tries) {
+                httpStatus = request(ctx, &client, "GET", fetchUrl, "", "bytes=" + std::to_string(start) + "-" + std::to_string(end - 1), body,
+                                 objectSize);
+                if (httpStatus == 206 || httpStatus == 200)
+                    break;
+
+                ctx->error(10093, "object: " + fetchUrl + " - range: " + std::to_string(start) + "-" + std::to_string(end - 1) + " returned: " +
+                                  std::to_string(httpStatus));
+                if (tries > 1) {
+                    fetcher->contextSet(Thread::CONTEXT::SLEEP);
+                    usleep(ctx->archReadSleepUs);
+                    fetcher->contextSet(Thread::CONTEXT::CPU);
+                }
+            }
+            // Server without range support
+            if (httpStatus == 200 && body.size() > end - start) {
+                if (body.size() >= end)
+                    body = body.substr(start, end - start);
+                else
+                    body.clear();
+            }
+
+            fetcher->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::READER_FETCH);
+            lck.lock();
+            if (fetchGeneration == generation) {
+                range->data = std::move(body);
+                range->state = (httpStatus == 206 || httpStatus == 200) ? RANGE_STATE::READY : RANGE_STATE::FAILED;
+            } else
+                range->state = RANGE_STATE::EMPTY;
+            condReady.notify_all();
+        }
+        lck.unlock();
+        fetcher->contextSet(Thread::CONTEXT::CPU);
+    }
+
+    void ReaderObjectStore::hmac(const std::string& key, const std::string& data, uint8_t* digest) {
+        uint8_t keyBlock[64]{};
+        if (key.size() > sizeof(keyBlock)) {
+            Sha256 keyHash;
+            keyHash.update(reinterpret_cast<const uint8_t*>(key.data()), key.size());
+            keyHash.final(keyBlock);
+        } else
+            memcpy(keyBlock, key.data(), key.size());
+
+        uint8_t pad[64];
+        for (uint i = 0; i < sizeof(pad); ++i)
+            pad[i] = keyBlock[i] ^ 0x36;
+        Sha256 inner;
+        inner.update(pad, sizeof(pad));
+        inner.update(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+        uint8_t innerDigest[Sha256::DIGEST_SIZE];
+        inner.final(innerDigest);
+
+        for (uint i = 0; i < sizeof(pad); ++i)
+            pad[i] = keyBlock[i] ^ 0x5C;
+        Sha256 outer;
+        outer.update(pad, sizeof(pad));
+        outer.update(innerDigest, Sha256::DIGEST_SIZE);
+        outer.final(digest);
+    }
+
+    std::string ReaderObjectStore::uriEncode(const std::string& value, bool encodeSlash) {
+        static const char* hexDigits = "0123456789ABCDEF";
+        std::string result;
+        result.reserve(value.size());
+        for (const char c: value) {
+            const auto byte = static_cast<uint8_t>(c);
+            if ((byte >= 'A' && byte <= 'Z') || (byte >= 'a' && byte <= 'z') || (byte >= '0' && byte <= '9') || byte == '-' || byte == '_' ||
+                byte == '.' || byte == '~' || (byte == '/' && !encodeSlash)) {
+                result.push_back(c);
+                continue;
+            }
+            result.push_back('%');
+            result.push_back(hexDigits[byte >> 4]);
+            result.push_back(hexDigits[byte & 0x0F]);
+        }
+        return result;
+    }
+
+    // "s3://bucket/key" is sent to the endpoint with a path style URL
+    bool ReaderObjectStore::resolve(const Ctx* ctx, const std::string& path, std::string& newUrl, std::string& host, std::string& canonicalPath) {
+        std::string base;
+        if (path.rfind("s3://", 0) == 0) {
+            if (ctx->objectStoreEndpoint.empty())
+                return false;
+            base = ctx->objectStoreEndpoint;
+            while (!base.empty() && base.back() == '/')
+                base.pop_back();
+            canonicalPath = "/" + uriEncode(path.substr(5), false);
+            newUrl = base + canonicalPath;
+        } else {
+            newUrl = path;
+            base = path;
+        }
+
+        const size_t schemeEnd = base.find("://");
+        if (schemeEnd == std::string::npos)
+            return false;
+        const size_t hostEnd = base.find('/', schemeEnd + 3);
+        host = base.substr(schemeEnd + 3, hostEnd == std::string::npos ? std::string::npos : hostEnd - schemeEnd - 3);
+        if (path.rfind("s3://", 0) != 0)
+            canonicalPath = hostEnd == std::string::npos ? "/" : base.substr(hostEnd);
+        return true;
+    }
+
+    // AWS signature version 4, the payload of a GET is not signed
+    void ReaderObjectStore::sign(const Ctx* ctx, const char* method, const std::string& host, const std::string& canonicalPath, const std::string& query,
+                                 std::map<std::string, std::string>& headers) {
+        static const std::string payload("UNSIGNED-PAYLOAD");
+        static const std::string signedHeaders("host;x-amz-content-sha256;x-amz-date");
+
+        char date[17];
+        const time_t now = time(nullptr);
+        struct tm nowTm{};
+        gmtime_r(&now, &nowTm);
+        strftime(date, sizeof(date), "%Y%m%dT%H%M%SZ", &nowTm);
+        const std::string amzDate(date);
+        const std::string day(amzDate.substr(0, 8));
+        const std::string scope(day + "/" + ctx->objectStoreRegion + "/s3/aws4_request");
+
+        headers["host"] = host;
+        headers["x-amz-content-sha256"] = payload;
+        headers["x-amz-date"] = amzDate;
+
+        const std::string canonicalRequest(std::string(method) + "\n" + canonicalPath + "\n" + query + "\n" +
+                                           "host:" + host + "\n" + "x-amz-content-sha256:" + payload + "\n" + "x-amz-date:" + amzDate + "\n\n" +
+                                           signedHeaders + "\n" + payload);
+        const std::string stringToSign("AWS4-HMAC-SHA256\n" + amzDate + "\n" + scope + "\n" +
+                                       Sha256::hex(reinterpret_cast<const uint8_t*>(canonicalRequest.data()), canonicalRequest.size()));
+
+        uint8_t key[Sha256::DIGEST_SIZE];
+        hmac("AWS4" + ctx->objectStoreSecretKey, day, key);
+        hmac(std::string(reinterpret_cast<const char*>(key), Sha256::DIGEST_SIZE), ctx->objectStoreRegion, key);
+        hmac(std::string(reinterpret_cast<const char*>(key), Sha256::DIGEST_SIZE), "s3", key);
+        hmac(std::string(reinterpret_cast<const char*>(key), Sha256::DIGEST_SIZE), "aws4_request", key);
+        uint8_t signature[Sha256::DIGEST_SIZE];
+        hmac(std::string(reinterpret_cast<const char*>(key), Sha256::DIGEST_SIZE), stringToSign, signature);
+        std::string signatureHex(Sha256::DIGEST_SIZE * 2, '0');
+        Data::hexEncode(signature, Sha256::DIGEST_SIZE, signatureHex.data());
+
+        headers["authorization"] = "AWS4-HMAC-SHA256 Credential=" + ctx->objectStoreAccessKey + "/" + scope + ", SignedHeaders=" + signedHeaders +
+                                   ", Signature=" + signatureHex;
+    }
+
+    int ReaderObjectStore::request(const Ctx* ctx, hv::HttpClient* client, const char* method, const std::string& path, const std::string& query,
+                                   const std::string& range, std::string& body, uint64_t& objectSize) {
+        std::string requestUrl;
+        std::string host;
+        std::string canonicalPath;
+        if (!resolve(ctx, path, requestUrl, host, canonicalPath))
+            return -1;
+
+        std::map<std::string, std::string> headers;
+        if (!range.empty())
+            headers["range"] = range;
+        if (path.rfind("s3://", 0) == 0 && !ctx->objectStoreAccessKey.empty())
+            sign(ctx, method, host, canonicalPath, query, headers);
+
+        HttpRequest httpRequest;
+        httpRequest.method = strcmp(method, "HEAD") == 0 ? HTTP_HEAD : HTTP_GET;
+        httpRequest.url = query.empty() ? requestUrl : requestUrl + "?" + query;
+        httpRequest.timeout = OBJECT_STORE_TIMEOUT_S;
+        for (const auto& [name, value]: headers)
+            httpRequest.headers[name] = value;
+
+        HttpResponse httpResponse;
+        if (client->send(&httpRequest, &httpResponse) != 0)
+            return -1;
+
+        // "bytes first-last/size" of a ranged response
+        objectSize = 0;
+        const std::string contentRange = httpResponse.GetHeader("Content-Range");
+        const size_t slash = contentRange.find('/');
+        if (slash != std::string::npos)
+            objectSize = strtoull(contentRange.c_str() + slash + 1, nullptr, 10);
+        if (objectSize == 0) {
+            const std::string contentLength = httpResponse.GetHeader("Content-Length");
+            objectSize = contentLength.empty() ? httpResponse.body.size() : strtoull(contentLength.c_str(), nullptr, 10);
+        }
+        body = std::move(httpResponse.body);
+        return static_cast<int>(httpResponse.status_code);
+    }
+
+    std::string ReaderObjectStore::xmlValue(const std::string& text, const char* tag, uint64_t& pos) {
+        const std::string open = std::string("<") + tag + ">";
+        const std::string close = std::string("</") + tag + ">";
+        const size_t start = text.find(open, pos);
+        if (start == std::string::npos) {
+            pos = std::string::npos;
+            return "";
+        }
+        const size_t end = text.find(close, start + open.size());
+        if (end == std::string::npos) {
+            pos = std::string::npos;
+            return "";
+        }
+        pos = end + close.size();
+
+        std::string value;
+        for (size_t i = start + open.size(); i < end; ++i) {
+            if (text[i] != '&') {
+                value.push_back(text[i]);
+                continue;
+            }
+            static const std::pair<const char*, char> entities[]{{"&amp;", '&'}, {"&lt;", '<'}, {"&gt;", '>'}, {"&quot;", '"'}, {"&apos;", '\''}};
+            bool found = false;
+            for (const auto& [entity, character]: entities) {
+                if (text.compare(i, strlen(entity), entity) == 0) {
+                    value.push_back(character);
+                    i += strlen(entity) - 1;
+                    found = true;
+                    break;
+                }
+            }
+            if (!found)
+                value.push_back('&');
+        }
+        return value;
+    }
+
+    // ListObjectsV2, continued while the result is truncated
+    bool ReaderObjectStore::listObjects(const Ctx* ctx, const std::string& path, std::vector<std::string>& objects) {
+        if (path.rfind("s3://", 0) != 0) {
+            ctx->error(10093, "object: " + path + " - listing is supported only for s3:// paths");
+            return false;
+        }
+        const std::string rest(path.substr(5));
+        const size_t bucketEnd = rest.find('/');
+        const std::string bucket(rest.substr(0, bucketEnd));
+        const std::string prefix(bucketEnd == std::string::npos ? "" : rest.substr(bucketEnd + 1));
+
+        hv::HttpClient client;
+        std::string token;
+        do {
+            // Parameters sorted by name, as in the canonical request
+            std::string query;
+            if (!token.empty())
+                query = "continuation-token=" + uriEncode(token, true) + "&";
+            query += "list-type=2&prefix=" + uriEncode(prefix, true);
+
+            std::string body;
+            uint64_t objectSize = 0;
+            const int httpStatus = request(ctx, &client, "GET", "s3://" + bucket, query, "", body, objectSize);
+            if (httpStatus != 200) {
+                ctx->error(10093, "object: " + path + " - list returned: " + std::to_string(httpStatus));
+                return false;
+            }
+
+            uint64_t pos = 0;
+            while (pos != std::string::npos) {
+                const std::string key = xmlValue(body, "Key", pos);
+                if (pos != std::string::npos && !key.empty() && key.back() != '/')
+                    objects.push_back("s3://" + bucket + "/" + key);
+            }
+
+            token.clear();
+            if (body.find("<IsTruncated>true</IsTruncated>") != std::string::npos) {
+                pos = 0;
+                token = xmlValue(body, "NextContinuationToken", pos);
+            }
+        } while (!token.empty());
+        return true;
+    }
+}
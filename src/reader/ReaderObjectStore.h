@@ -0,0 +1,116 @@
+/* Header for ReaderObjectStore class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef READER_OBJECT_STORE_H_
+#define READER_OBJECT_STORE_H_
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "ReaderFilesystem.h"
+
+namespace hv {
+    class HttpClient;
+}
+
+namespace OpenLogReplicator {
+    class ReaderObjectStore;
+
+    // Downloads ranges of the object ahead of the reader, every fetcher keeps its own connection
+    class RangeFetcher final : public Thread {
+    protected:
+        ReaderObjectStore* reader;
+
+        void run() override;
+
+    public:
+        RangeFetcher(Ctx* newCtx, std::string newAlias, ReaderObjectStore* newReader);
+
+        void wakeUp() override;
+
+        std::string getName() const override {
+            return {"Reader: fetcher " + alias};
+        }
+    };
+
+    // Archived redo logs in S3 compatible object storage, read with ranged GET requests. "s3://bucket/key" is signed with
+    // AWS signature version 4 and sent to the configured endpoint, "http://" and "https://" URLs (e.g. presigned) are sent as
+    // they are. Several ranges after the read offset are fetched at once, so the reader doesn't wait for a round trip per
+    // chunk. Local paths are read by ReaderFilesystem
+    class ReaderObjectStore final : public ReaderFilesystem {
+    protected:
+        static constexpr uint16_t OBJECT_STORE_TIMEOUT_S{60};
+
+        enum class RANGE_STATE : unsigned char {
+            EMPTY, QUEUED, FETCHING, READY, FAILED
+        };
+
+        struct Range {
+            uint64_t index{0};
+            RANGE_STATE state{RANGE_STATE::EMPTY};
+            std::string data;
+        };
+
+        std::mutex fetchMtx;
+        std::condition_variable condFetch;
+        std::condition_variable condReady;
+        std::vector<Range> ranges;
+        std::vector<RangeFetcher*> fetchers;
+        uint64_t rangeSize;
+        // Raised when an object is opened or closed, ranges fetched for an earlier object are dropped
+        uint64_t generation{0};
+        bool remote{false};
+        bool stopped{false};
+        std::string url;
+        // First bytes of the object, fetched when it is opened: the header is read again for every log switch check
+        std::string header;
+
+        void redoClose() override;
+        REDO_CODE redoOpen() override;
+        int redoRead(uint8_t* buf, uint64_t offset, uint size) override;
+
+        void rangesReset();
+        Range* rangeQueue(uint64_t index, uint64_t currentIndex);
+
+        static void hmac(const std::string& key, const std::string& data, uint8_t* digest);
+        static std::string uriEncode(const std::string& value, bool encodeSlash);
+        static std::string xmlValue(const std::string& text, const char* tag, uint64_t& pos);
+        static bool resolve(const Ctx* ctx, const std::string& path, std::string& newUrl, std::string& host, std::string& canonicalPath);
+        static void sign(const Ctx* ctx, const char* method, const std::string& host, const std::string& canonicalPath, const std::string& query,
+                         std::map<std::string, std::string>& headers);
+
+    public:
+        ReaderObjectStore(Ctx* newCtx, std::string newAlias, std::string newDatabase, int newGroup, bool newConfiguredBlockSum);
+        ~ReaderObjectStore() override;
+
+        void fetchRun(RangeFetcher* fetcher);
+        void fetchWakeUp();
+
+        [[nodiscard]] static bool isUrl(const std::string& path);
+        // HTTP status, or -1 when the request failed
+        static int request(const Ctx* ctx, hv::HttpClient* client, const char* method, const std::string& path, const std::string& query,
+                           const std::string& range, std::string& body, uint64_t& objectSize);
+        // Objects under a "s3://bucket/prefix/" path, as full paths
+        static bool listObjects(const Ctx* ctx, const std::string& path, std::vector<std::string>& objects);
+    };
+}
+
+#endif
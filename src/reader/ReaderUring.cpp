@@ -0,0 +1,178 @@
+/* Class for reading redo from file system using io_uring
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include "../common/Ctx.h"
+#include "../common/exception/RuntimeException.h"
+#include "ReaderUring.h"
+
+namespace OpenLogReplicator {
+    ReaderUring::ReaderUring(Ctx* newCtx, std::string newAlias, std::string newDatabase, int newGroup, bool newConfiguredBlockSum,
+                             uint newQueueDepth) :
+            ReaderFilesystem(newCtx, std::move(newAlias), std::move(newDatabase), newGroup, newConfiguredBlockSum),
+            queueDepth(newQueueDepth) {
+
+        slots.resize(queueDepth);
+        for (Slot& slot: slots) {
+            // Aligned for O_DIRECT
+            if (posix_memalign(reinterpret_cast<void**>(&slot.data), PAGE_SIZE_MAX, Ctx::MEMORY_CHUNK_SIZE) != 0)
+                throw RuntimeException(10016, "couldn't allocate " + std::to_string(Ctx::MEMORY_CHUNK_SIZE) +
+                                              " bytes memory for: io_uring read buffer");
+        }
+
+        const int initRet = io_uring_queue_init(queueDepth, &ring, 0);
+        if (initRet < 0)
+            ctx->warning(10073, "io_uring initialization failed: " + std::string(strerror(-initRet)) + ", using synchronous reads for group: " +
+                                std::to_string(group));
+        else
+            ringReady = true;
+    }
+
+    ReaderUring::~ReaderUring() {
+        ReaderUring::redoClose();
+        if (ringReady) {
+            io_uring_queue_exit(&ring);
+            ringReady = false;
+        }
+
+        for (Slot& slot: slots) {
+            free(slot.data);
+            slot.data = nullptr;
+        }
+        slots.clear();
+    }
+
+    void ReaderUring::redoClose() {
+        drain();
+        ReaderFilesystem::redoClose();
+    }
+
+    Reader::REDO_CODE ReaderUring::redoOpen() {
+        drain();
+        return ReaderFilesystem::redoOpen();
+    }
+
+    // Wait for all reads in flight, the buffers and the file descriptor must not be released before
+    void ReaderUring::drain() {
+        for (Slot& slot: slots) {
+            if (slot.busy && !slot.done)
+                waitSlot(&slot);
+            slot.busy = false;
+            slot.done = false;
+        }
+    }
+
+    ReaderUring::Slot* ReaderUring::findSlot(uint64_t offset) {
+        for (Slot& slot: slots)
+            if (slot.busy && slot.offset == offset)
+                return &slot;
+        return nullptr;
+    }
+
+    // Keep the reads of the following chunks in flight, every read covers one chunk of the read buffer
+    void ReaderUring::submitAhead(uint64_t offset) {
+        uint64_t chunkOffset = offset - (offset % Ctx::MEMORY_CHUNK_SIZE);
+        bool submitted = false;
+
+        for (uint i = 0; i < queueDepth && chunkOffset < fileSize; ++i, chunkOffset += Ctx::MEMORY_CHUNK_SIZE) {
+            if (findSlot(chunkOffset) != nullptr)
+                continue;
+
+            Slot* freeSlot = nullptr;
+            for (Slot& slot: slots) {
+                // Chunks behind the current position are not needed anymore
+                if (slot.busy && slot.done && slot.offset + Ctx::MEMORY_CHUNK_SIZE <= offset)
+                    slot.busy = false;
+                if (!slot.busy) {
+                    freeSlot = &slot;
+                    break;
+                }
+            }
+            if (freeSlot == nullptr)
+                break;
+
+            io_uring_sqe* sqe = io_uring_get_sqe(&ring);
+            if (sqe == nullptr)
+                break;
+
+            freeSlot->offset = chunkOffset;
+            freeSlot->size = std::min<uint64_t>(Ctx::MEMORY_CHUNK_SIZE, fileSize - chunkOffset);
+            freeSlot->result = 0;
+            freeSlot->busy = true;
+            freeSlot->done = false;
+            io_uring_prep_read(sqe, fileDes, freeSlot->data, freeSlot->size, freeSlot->offset);
+            io_uring_sqe_set_data(sqe, freeSlot);
+            ++inFlight;
+            submitted = true;
+        }
+
+        if (submitted) {
+            contextSet(CONTEXT::OS, REASON::OS);
+            io_uring_submit(&ring);
+            contextSet(CONTEXT::CPU);
+        }
+    }
+
+    bool ReaderUring::waitSlot(Slot* slot) {
+        while (!slot->done && inFlight > 0) {
+            io_uring_cqe* cqe = nullptr;
+            contextSet(CONTEXT::OS, REASON::OS);
+            const int waitRet = io_uring_wait_cqe(&ring, &cqe);
+            contextSet(CONTEXT::CPU);
+            if (waitRet < 0) {
+                if (waitRet == -EINTR)
+                    continue;
+                return false;
+            }
+
+            auto* completed = reinterpret_cast<Slot*>(io_uring_cqe_get_data(cqe));
+            completed->result = cqe->res;
+            completed->done = true;
+            --inFlight;
+            io_uring_cqe_seen(&ring, cqe);
+        }
+        return slot->done;
+    }
+
+    int ReaderUring::redoRead(uint8_t* buf, uint64_t offset, uint size) {
+        // Online redo logs are still being written, read ahead data would be stale
+        if (!ringReady || group != 0 || fileDes == -1)
+            return ReaderFilesystem::redoRead(buf, offset, size);
+
+        const uint64_t chunkOffset = offset - (offset % Ctx::MEMORY_CHUNK_SIZE);
+        submitAhead(offset);
+
+        Slot* slot = findSlot(chunkOffset);
+        if (slot == nullptr || !waitSlot(slot) || slot->result < 0 || offset + size > slot->offset + static_cast<uint64_t>(slot->result)) {
+            // Short or failed read, retry synchronously with error handling of the base class
+            if (slot != nullptr)
+                slot->busy = false;
+            return ReaderFilesystem::redoRead(buf, offset, size);
+        }
+
+        memcpy(buf, slot->data + (offset - slot->offset), size);
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::FILE)))
+            ctx->logTrace(Ctx::TRACE::FILE, "read " + fileName + ", " + std::to_string(offset) + ", " + std::to_string(size) +
+                                            " returns " + std::to_string(size) + " (io_uring)");
+        return static_cast<int>(size);
+    }
+}
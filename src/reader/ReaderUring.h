@@ -0,0 +1,62 @@
+/* Header for ReaderUring class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef READER_URING_H_
+#define READER_URING_H_
+
+#include <liburing.h>
+#include <vector>
+
+#include "ReaderFilesystem.h"
+
+namespace OpenLogReplicator {
+    // Archived redo logs are read ahead with several chunk sized reads in flight, the data is handed to the reader in order
+    class ReaderUring final : public ReaderFilesystem {
+    protected:
+        struct Slot {
+            uint8_t* data{nullptr};
+            uint64_t offset{0};
+            uint64_t size{0};
+            int64_t result{0};
+            bool busy{false};
+            bool done{false};
+        };
+
+        struct io_uring ring{};
+        bool ringReady{false};
+        uint queueDepth;
+        uint inFlight{0};
+        std::vector<Slot> slots;
+
+        void redoClose() override;
+        REDO_CODE redoOpen() override;
+        int redoRead(uint8_t* buf, uint64_t offset, uint size) override;
+
+        Slot* findSlot(uint64_t offset);
+        void submitAhead(uint64_t offset);
+        bool waitSlot(Slot* slot);
+        void drain();
+
+    public:
+        ReaderUring(Ctx* newCtx, std::string newAlias, std::string newDatabase, int newGroup, bool newConfiguredBlockSum, uint newQueueDepth);
+        ~ReaderUring() override;
+    };
+}
+
+#endif
@@ -0,0 +1,288 @@
+/* Local cache of the redo read from slow storage
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <algorithm>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../common/Clock.h"
+#include "../common/Ctx.h"
+#include "../common/Thread.h"
+#include "../common/exception/RuntimeException.h"
+#include "RedoCache.h"
+#include "RedoCopy.h"
+
+namespace OpenLogReplicator {
+    RedoCache::RedoCache(Ctx* newCtx, const std::string& newAlias, std::string newPath, std::string newPrefix, uint64_t newSizeMax) :
+            ctx(newCtx),
+            path(std::move(newPath)),
+            prefix(std::move(newPrefix)),
+            sizeMax(newSizeMax),
+            writer(new RedoCopy(newCtx, newAlias, RedoCopy::COMPRESSION::NONE)) {
+        load();
+    }
+
+    RedoCache::~RedoCache() {
+        writer->stop();
+        ctx->finishThread(writer);
+        delete writer;
+        writer = nullptr;
+    }
+
+    void RedoCache::start() {
+        ctx->spawnThread(writer);
+    }
+
+    uint64_t RedoCache::key(const uint8_t* header, uint blockSize) const {
+        const typeResetlogs resetlogs = ctx->read32(header + blockSize + 160);
+        const Seq sequence = Seq(ctx->read32(header + blockSize + 8));
+        return (static_cast<uint64_t>(resetlogs) << 32) | sequence.getData();
+    }
+
+    // The next SCN of an online log is set at the log switch, the copy made before is still valid
+    bool RedoCache::valid(const uint8_t* header, const uint8_t* cached, uint blockSize) const {
+        if (ctx->read32(cached + 20) != blockSize || key(header, blockSize) != key(cached, blockSize))
+            return false;
+        if (ctx->readScn(header + blockSize + 180) != ctx->readScn(cached + blockSize + 180))
+            return false;
+        const Scn cachedNextScn = ctx->readScn(cached + blockSize + 192);
+        return cachedNextScn == Scn::none() || cachedNextScn == ctx->readScn(header + blockSize + 192);
+    }
+
+    // File names are: <prefix>_<resetlogs>_<sequence>_<start offset>.redo
+    void RedoCache::load() {
+        DIR* dir = opendir(path.c_str());
+        if (dir == nullptr)
+            throw RuntimeException(10012, "directory: " + path + " - can't read");
+
+        const std::string namePrefix(prefix + "_");
+        const std::string nameSuffix(".redo");
+        const struct dirent* ent;
+        while ((ent = readdir(dir)) != nullptr) {
+            const std::string dName(ent->d_name);
+            if (dName.length() <= namePrefix.length() + nameSuffix.length() || dName.compare(0, namePrefix.length(), namePrefix) != 0 ||
+                dName.compare(dName.length() - nameSuffix.length(), nameSuffix.length(), nameSuffix) != 0)
+                continue;
+
+            const char* str = dName.c_str() + namePrefix.length();
+            char* strEnd;
+            const uint64_t resetlogs = strtoull(str, &strEnd, 10);
+            if (*strEnd != '_')
+                continue;
+            const uint64_t sequence = strtoull(strEnd + 1, &strEnd, 10);
+            if (*strEnd != '_')
+                continue;
+            const uint64_t start = strtoull(strEnd + 1, &strEnd, 10);
+            if (std::string(strEnd) != nameSuffix || resetlogs > 0xFFFFFFFF || sequence > 0xFFFFFFFF)
+                continue;
+
+            const std::string fileName(path + "/" + dName);
+            struct stat fileStat{};
+            if (stat(fileName.c_str(), &fileStat) != 0 || !S_ISREG(fileStat.st_mode))
+                continue;
+
+            const uint64_t entryKey = (resetlogs << 32) | sequence;
+            const time_ut lastUsed = (static_cast<time_ut>(fileStat.st_mtim.tv_sec) * 1000000) + (fileStat.st_mtim.tv_nsec / 1000);
+            auto it = entries.find(entryKey);
+            if (it != entries.end()) {
+                // Left by a crash between removing the copy and creating the new one, the newer file is kept
+                if (it->second.lastUsed > lastUsed) {
+                    unlink(fileName.c_str());
+                    continue;
+                }
+                remove(entryKey);
+            }
+
+            const uint64_t bytes = static_cast<uint64_t>(fileStat.st_blocks) * 512;
+            entries.insert_or_assign(entryKey, Entry{fileName, start, static_cast<uint64_t>(fileStat.st_size), bytes, lastUsed, 0});
+            names.insert_or_assign(fileName, entryKey);
+            sizeTotal += bytes;
+        }
+        closedir(dir);
+
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::FILE)))
+            ctx->logTrace(Ctx::TRACE::FILE, "redo cache: " + path + " - files: " + std::to_string(entries.size()) + ", bytes: " +
+                                            std::to_string(sizeTotal));
+        evict();
+    }
+
+    void RedoCache::remove(uint64_t entryKey) {
+        auto it = entries.find(entryKey);
+        if (it == entries.end())
+            return;
+
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::FILE)))
+            ctx->logTrace(Ctx::TRACE::FILE, "redo cache: removing " + it->second.fileName);
+        unlink(it->second.fileName.c_str());
+        sizeTotal -= it->second.bytes;
+        names.erase(it->second.fileName);
+        entries.erase(it);
+    }
+
+    // Files in use are never removed, the cache may be over the limit until they are closed
+    void RedoCache::evict() {
+        while (sizeTotal > sizeMax) {
+            auto oldest = entries.end();
+            for (auto it = entries.begin(); it != entries.end(); ++it) {
+                if (it->second.users == 0 && (oldest == entries.end() || it->second.lastUsed < oldest->second.lastUsed))
+                    oldest = it;
+            }
+            if (oldest == entries.end())
+                return;
+            remove(oldest->first);
+        }
+    }
+
+    // Returns the descriptor of the cached copy of the log which header was just read from the source, or -1 when there is no
+    // valid copy. Blocks from start to end are read from the copy, and blocks read from the source at end are appended to it
+    int RedoCache::open(Thread* t, const uint8_t* header, uint blockSize, std::string& fileName, uint64_t& start, uint64_t& end) {
+        int fd = -1;
+        {
+            t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::REDO_CACHE);
+            std::unique_lock<std::mutex> const lck(mtx);
+            auto it = entries.find(key(header, blockSize));
+            if (it == entries.end()) {
+                t->contextSet(Thread::CONTEXT::CPU);
+                return -1;
+            }
+
+            Entry& entry = it->second;
+            t->contextSet(Thread::CONTEXT::OS, Thread::REASON::OS);
+            fd = ::open(entry.fileName.c_str(), O_RDONLY);
+            if (fd != -1) {
+                auto* cached = new uint8_t[blockSize * 2];
+                struct stat fileStat{};
+                if (pread(fd, cached, blockSize * 2, 0) != static_cast<ssize_t>(blockSize * 2) || !valid(header, cached, blockSize) ||
+                    fstat(fd, &fileStat) != 0) {
+                    ::close(fd);
+                    fd = -1;
+                } else {
+                    // Data still queued for writing is not read back, the last block is complete only when the whole block is on disk
+                    end = std::min(entry.end, static_cast<uint64_t>(fileStat.st_size));
+                    end -= end % blockSize;
+                    start = std::min(entry.start, end);
+                }
+                delete[] cached;
+            }
+            t->contextSet(Thread::CONTEXT::CPU);
+
+            if (fd == -1) {
+                if (entry.users == 0) {
+                    ctx->warning(60046, "redo cache: " + entry.fileName + " - doesn't match the source, removing");
+                    remove(it->first);
+                }
+                return -1;
+            }
+
+            fileName = entry.fileName;
+            entry.end = end;
+            entry.lastUsed = ctx->clock->getTimeUt();
+            ++entry.users;
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
+
+        writer->open(t, fileName);
+        update(t, fileName, header, blockSize);
+        return fd;
+    }
+
+    // Starts a new copy at the given position, returns an empty name when the copy is in use by another reader
+    std::string RedoCache::create(Thread* t, const uint8_t* header, uint blockSize, uint64_t start) {
+        const uint64_t entryKey = key(header, blockSize);
+        std::string fileName;
+        {
+            t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::REDO_CACHE);
+            std::unique_lock<std::mutex> const lck(mtx);
+            auto it = entries.find(entryKey);
+            if (it != entries.end()) {
+                if (it->second.users > 0) {
+                    t->contextSet(Thread::CONTEXT::CPU);
+                    return {};
+                }
+                remove(entryKey);
+            }
+
+            fileName = path + "/" + prefix + "_" + std::to_string(entryKey >> 32) + "_" + std::to_string(entryKey & 0xFFFFFFFF) + "_" +
+                       std::to_string(start) + ".redo";
+            entries.insert_or_assign(entryKey, Entry{fileName, start, start, blockSize * 2, ctx->clock->getTimeUt(), 1});
+            names.insert_or_assign(fileName, entryKey);
+            sizeTotal += blockSize * 2;
+            evict();
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
+
+        writer->open(t, fileName);
+        update(t, fileName, header, blockSize);
+        return fileName;
+    }
+
+    // The header of an online log changes at the log switch
+    void RedoCache::update(Thread* t, const std::string& fileName, const uint8_t* header, uint blockSize) {
+        writer->write(t, fileName, 0, header, blockSize * 2);
+    }
+
+    // Only blocks which passed the checks are appended, so that the copy never holds data which is not in the source
+    void RedoCache::append(Thread* t, const std::string& fileName, uint64_t offset, const uint8_t* data, uint64_t size) {
+        {
+            t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::REDO_CACHE);
+            std::unique_lock<std::mutex> const lck(mtx);
+            auto it = names.find(fileName);
+            if (it == names.end()) {
+                t->contextSet(Thread::CONTEXT::CPU);
+                return;
+            }
+
+            Entry& entry = entries.at(it->second);
+            entry.end = std::max(entry.end, offset + size);
+            entry.bytes += size;
+            entry.lastUsed = ctx->clock->getTimeUt();
+            sizeTotal += size;
+            evict();
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
+
+        writer->write(t, fileName, offset, data, size);
+    }
+
+    // A copy with a block which failed the checks is dropped, the reader continues with the source
+    void RedoCache::close(Thread* t, const std::string& fileName, int fd, bool drop) {
+        if (fd != -1)
+            ::close(fd);
+        writer->close(t, fileName, false);
+
+        t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::REDO_CACHE);
+        std::unique_lock<std::mutex> const lck(mtx);
+        auto it = names.find(fileName);
+        if (it != names.end()) {
+            Entry& entry = entries.at(it->second);
+            if (entry.users > 0)
+                --entry.users;
+            if (drop) {
+                if (entry.users == 0) {
+                    ctx->warning(60046, "redo cache: " + fileName + " - invalid block, removing");
+                    remove(it->second);
+                }
+            } else
+                evict();
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
+    }
+}
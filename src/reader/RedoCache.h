@@ -0,0 +1,82 @@
+/* Header for RedoCache class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef REDO_CACHE_H_
+#define REDO_CACHE_H_
+
+#include <mutex>
+#include <unordered_map>
+
+#include "../common/types/Seq.h"
+#include "../common/types/Time.h"
+#include "../common/types/Types.h"
+
+namespace OpenLogReplicator {
+    class Ctx;
+    class RedoCopy;
+    class Thread;
+
+    // Local copy of the redo read from slow storage (ASM over SSH, NFS), so that the redo read again after a restart doesn't go
+    // to the source. Every log has one file holding a contiguous range of verified blocks, found by resetlogs and sequence and
+    // valid only as long as the first and next SCN match the header of the source. Least recently used files are removed when
+    // the cache grows over its size
+    class RedoCache final {
+    protected:
+        struct Entry {
+            std::string fileName;
+            // Cached range of the log, the header is always kept at the beginning of the file
+            uint64_t start;
+            uint64_t end;
+            // Space used on disk
+            uint64_t bytes;
+            time_ut lastUsed;
+            uint users;
+        };
+
+        Ctx* ctx;
+        std::string path;
+        std::string prefix;
+        uint64_t sizeMax;
+        RedoCopy* writer;
+
+        std::mutex mtx;
+        std::unordered_map<uint64_t, Entry> entries;
+        std::unordered_map<std::string, uint64_t> names;
+        uint64_t sizeTotal{0};
+
+        [[nodiscard]] uint64_t key(const uint8_t* header, uint blockSize) const;
+        [[nodiscard]] bool valid(const uint8_t* header, const uint8_t* cached, uint blockSize) const;
+        void load();
+        void remove(uint64_t entryKey);
+        void evict();
+
+    public:
+        RedoCache(Ctx* newCtx, const std::string& newAlias, std::string newPath, std::string newPrefix, uint64_t newSizeMax);
+        ~RedoCache();
+
+        void start();
+        int open(Thread* t, const uint8_t* header, uint blockSize, std::string& fileName, uint64_t& start, uint64_t& end);
+        std::string create(Thread* t, const uint8_t* header, uint blockSize, uint64_t start);
+        void update(Thread* t, const std::string& fileName, const uint8_t* header, uint blockSize);
+        void append(Thread* t, const std::string& fileName, uint64_t offset, const uint8_t* data, uint64_t size);
+        void close(Thread* t, const std::string& fileName, int fd, bool drop);
+    };
+}
+
+#endif
@@ -0,0 +1,306 @@
+/* Thread writing the copy of the redo read
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#ifdef LINK_LIBRARY_LZ4
+#include <lz4frame.h>
+#endif /* LINK_LIBRARY_LZ4 */
+
+#include "../common/Ctx.h"
+#include "../common/exception/RuntimeException.h"
+#include "RedoCopy.h"
+
+namespace OpenLogReplicator {
+    RedoCopy::RedoCopy(Ctx* newCtx, std::string newAlias, COMPRESSION newCompression) :
+            Thread(newCtx, std::move(newAlias)),
+            compression(newCompression) {
+    }
+
+    RedoCopy::~RedoCopy() {
+        for (const Task& task: queue)
+            delete[] task.data;
+        queue.clear();
+
+        for (const auto& [fileName, file]: files)
+            ::close(file.fd);
+        files.clear();
+    }
+
+    void RedoCopy::open(Thread* t, const std::string& fileName) {
+        push(t, Task{OPERATION::OPEN, fileName});
+    }
+
+    // The data is copied, the read buffer may be reused as soon as the call returns
+    void RedoCopy::write(Thread* t, const std::string& fileName, uint64_t offset, const uint8_t* data, uint64_t size) {
+        Task task{OPERATION::WRITE, fileName, offset, new uint8_t[size], size};
+        memcpy(task.data, data, size);
+        push(t, std::move(task));
+    }
+
+    void RedoCopy::close(Thread* t, const std::string& fileName, bool complete) {
+        Task task{OPERATION::CLOSE, fileName};
+        task.complete = complete;
+        push(t, std::move(task));
+    }
+
+    // Waits when the queue is full, so that a slow disk bounds the memory used by queued data
+    void RedoCopy::push(Thread* t, Task task) {
+        if (t != nullptr)
+            t->contextSet(CONTEXT::MUTEX, REASON::REDO_COPY);
+        std::unique_lock<std::mutex> lck(mtx);
+        while (!done && !stopped && !ctx->hardShutdown && queueSize > 0 && queueSize + task.size > QUEUE_SIZE_MAX) {
+            if (t != nullptr)
+                t->contextSet(CONTEXT::WAIT, REASON::REDO_COPY_FULL);
+            condFree.wait_for(lck, std::chrono::milliseconds(100));
+        }
+
+        if (!done && !stopped) {
+            queueSize += task.size;
+            queue.push_back(std::move(task));
+            condWork.notify_all();
+            if (t != nullptr)
+                t->contextSet(CONTEXT::CPU);
+            return;
+        }
+
+        // The thread is gone, files are only touched under the lock from now on
+        if (t != nullptr)
+            t->contextSet(CONTEXT::CPU);
+        try {
+            process(t, task);
+        } catch (RuntimeException&) {
+            delete[] task.data;
+            throw;
+        }
+        delete[] task.data;
+    }
+
+    void RedoCopy::stop() {
+        std::unique_lock<std::mutex> const lck(mtx);
+        stopped = true;
+        condWork.notify_all();
+    }
+
+    void RedoCopy::wakeUp() {
+        std::unique_lock<std::mutex> const lck(mtx);
+        condWork.notify_all();
+        condFree.notify_all();
+    }
+
+    // The same log may be copied by two readers, e.g. the online log and its archived copy, the file stays open until both closed it
+    void RedoCopy::process(Thread* t, const Task& task) {
+        switch (task.operation) {
+            case OPERATION::OPEN: {
+                auto it = files.find(task.fileName);
+                if (it != files.end()) {
+                    ++it->second.users;
+                    return;
+                }
+
+                if (t != nullptr)
+                    t->contextSet(CONTEXT::OS, REASON::OS);
+                const std::string writeName = ctx->redoRelay ? task.fileName + PART_SUFFIX : task.fileName;
+                const int fd = ::open(writeName.c_str(), O_CREAT | O_WRONLY, S_IRUSR | S_IWUSR);
+                if (t != nullptr)
+                    t->contextSet(CONTEXT::CPU);
+                if (unlikely(fd == -1))
+                    throw RuntimeException(10006, "file: " + writeName + " - open for writing returned: " + strerror(errno));
+                files.insert_or_assign(task.fileName, File{fd, 1});
+                return;
+            }
+
+            case OPERATION::WRITE: {
+                auto it = files.find(task.fileName);
+                if (it == files.end())
+                    return;
+
+                if (t != nullptr)
+                    t->contextSet(CONTEXT::OS, REASON::OS);
+                const int64_t bytesWritten = pwrite(it->second.fd, task.data, task.size, static_cast<int64_t>(task.offset));
+                if (t != nullptr)
+                    t->contextSet(CONTEXT::CPU);
+                if (bytesWritten < 0 || static_cast<uint64_t>(bytesWritten) != task.size)
+                    throw RuntimeException(10007, "file: " + task.fileName + " - " + std::to_string(bytesWritten) + " bytes written instead of " +
+                                                  std::to_string(task.size) + ", code returned: " + strerror(errno));
+                return;
+            }
+
+            case OPERATION::CLOSE: {
+                auto it = files.find(task.fileName);
+                if (it == files.end())
+                    return;
+                if (--it->second.users > 0)
+                    return;
+
+                // Served by the relay from now on, so synced first
+                if (ctx->redoRelay && task.complete) {
+                    const std::string writeName = task.fileName + PART_SUFFIX;
+                    if (fdatasync(it->second.fd) != 0 || rename(writeName.c_str(), task.fileName.c_str()) != 0) {
+                        const std::string error = strerror(errno);
+                        ::close(it->second.fd);
+                        files.erase(it);
+                        throw RuntimeException(10088, "redo copy: " + writeName + " - publishing returned: " + error);
+                    }
+                }
+                ::close(it->second.fd);
+                files.erase(it);
+                if (task.complete && compression != COMPRESSION::NONE)
+                    compress(t, task.fileName);
+                return;
+            }
+        }
+    }
+
+    // One lz4 frame per chunk, concatenated frames are read by the lz4 tool as one stream. The compressed file is written to
+    // a temporary name and renamed when synced, the uncompressed copy is removed only then
+    void RedoCopy::compress(Thread* t, const std::string& fileName) {
+#ifdef LINK_LIBRARY_LZ4
+        const std::string compressedName = fileName + ".lz4";
+        const std::string tmpName = compressedName + ".tmp";
+        if (t != nullptr)
+            t->contextSet(CONTEXT::OS, REASON::OS);
+
+        const int inDes = ::open(fileName.c_str(), O_RDONLY);
+        if (inDes == -1)
+            throw RuntimeException(10088, "redo copy: " + fileName + " - open returned: " + strerror(errno));
+        const int outDes = ::open(tmpName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+        if (outDes == -1) {
+            const std::string error = strerror(errno);
+            ::close(inDes);
+            throw RuntimeException(10088, "redo copy: " + tmpName + " - open returned: " + error);
+        }
+
+        LZ4F_preferences_t preferences{};
+        const size_t outSize = LZ4F_compressFrameBound(Ctx::MEMORY_CHUNK_SIZE, &preferences);
+        auto* inBuffer = new uint8_t[Ctx::MEMORY_CHUNK_SIZE];
+        auto* outBuffer = new uint8_t[outSize];
+        std::string error;
+
+        while (error.empty()) {
+            const ssize_t bytesRead = read(inDes, inBuffer, Ctx::MEMORY_CHUNK_SIZE);
+            if (bytesRead < 0) {
+                if (errno == EINTR)
+                    continue;
+                error = fileName + " - read returned: " + strerror(errno);
+                break;
+            }
+            if (bytesRead == 0)
+                break;
+
+            preferences.frameInfo.contentSize = bytesRead;
+            const size_t compressed = LZ4F_compressFrame(outBuffer, outSize, inBuffer, bytesRead, &preferences);
+            if (LZ4F_isError(compressed)) {
+                error = fileName + " - lz4 compression returned: " + LZ4F_getErrorName(compressed);
+                break;
+            }
+            if (::write(outDes, outBuffer, compressed) != static_cast<ssize_t>(compressed))
+                error = tmpName + " - write returned: " + strerror(errno);
+        }
+
+        delete[] inBuffer;
+        delete[] outBuffer;
+        ::close(inDes);
+        if (error.empty() && fdatasync(outDes) != 0)
+            error = tmpName + " - fdatasync returned: " + strerror(errno);
+        ::close(outDes);
+
+        if (error.empty() && rename(tmpName.c_str(), compressedName.c_str()) != 0)
+            error = compressedName + " - rename returned: " + strerror(errno);
+        if (!error.empty()) {
+            unlink(tmpName.c_str());
+            throw RuntimeException(10088, "redo copy: " + error);
+        }
+        unlink(fileName.c_str());
+        if (t != nullptr)
+            t->contextSet(CONTEXT::CPU);
+
+        ctx->info(0, "compressed redo log copy to: " + compressedName);
+#else
+        (void)t;
+        (void)fileName;
+#endif /* LINK_LIBRARY_LZ4 */
+    }
+
+    void RedoCopy::run() {
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
+            std::ostringstream ss;
+            ss << std::this_thread::get_id();
+            ctx->logTrace(Ctx::TRACE::THREADS, "redo copy (" + ss.str() + ") start");
+        }
+
+        try {
+            while (!ctx->hardShutdown) {
+                Task task;
+                {
+                    contextSet(CONTEXT::MUTEX, REASON::REDO_COPY);
+                    std::unique_lock<std::mutex> lck(mtx);
+                    if (queue.empty()) {
+                        // Queued data is written before the thread exits
+                        if (stopped)
+                            break;
+                        if (unlikely(ctx->isTraceSet(Ctx::TRACE::SLEEP)))
+                            ctx->logTrace(Ctx::TRACE::SLEEP, "RedoCopy:run");
+                        contextSet(CONTEXT::WAIT, REASON::REDO_COPY_NO_WORK);
+                        condWork.wait_for(lck, std::chrono::milliseconds(100));
+                        continue;
+                    }
+                    task = std::move(queue.front());
+                    queue.pop_front();
+                }
+                contextSet(CONTEXT::CPU);
+
+                try {
+                    process(this, task);
+                } catch (RuntimeException&) {
+                    delete[] task.data;
+                    throw;
+                }
+                delete[] task.data;
+
+                {
+                    contextSet(CONTEXT::MUTEX, REASON::REDO_COPY);
+                    std::unique_lock<std::mutex> const lck(mtx);
+                    queueSize -= task.size;
+                    condFree.notify_all();
+                }
+                contextSet(CONTEXT::CPU);
+            }
+        } catch (RuntimeException& ex) {
+            ctx->error(ex.code, ex.msg);
+            ctx->stopHard();
+        }
+
+        {
+            std::unique_lock<std::mutex> const lck(mtx);
+            done = true;
+            condFree.notify_all();
+        }
+
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
+            std::ostringstream ss;
+            ss << std::this_thread::get_id();
+            ctx->logTrace(Ctx::TRACE::THREADS, "redo copy (" + ss.str() + ") stop");
+        }
+    }
+}
@@ -0,0 +1,96 @@
+/* Header for RedoCopy class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef REDO_COPY_H_
+#define REDO_COPY_H_
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+#include "../common/Thread.h"
+
+namespace OpenLogReplicator {
+    // Background thread writing the copy of the redo read by the readers to redo-copy-path, so that the read loop doesn't wait
+    // for the disk. A copy closed after the whole log was read is optionally compressed to an lz4 file, and the uncompressed
+    // file is removed. For the relay the copy is written as ".part" and renamed when complete, so that only whole logs are served
+    class RedoCopy final : public Thread {
+    public:
+        enum class COMPRESSION : unsigned char {
+            NONE, LZ4
+        };
+
+    protected:
+        static constexpr uint64_t QUEUE_SIZE_MAX{64 * 1024 * 1024};
+
+        enum class OPERATION : unsigned char {
+            OPEN, WRITE, CLOSE
+        };
+
+        struct Task {
+            OPERATION operation;
+            std::string fileName;
+            uint64_t offset{0};
+            uint8_t* data{nullptr};
+            uint64_t size{0};
+            bool complete{false};
+        };
+
+        struct File {
+            int fd;
+            uint users;
+        };
+
+        static constexpr const char* PART_SUFFIX{".part"};
+
+        COMPRESSION compression;
+
+        std::mutex mtx;
+        std::condition_variable condWork;
+        std::condition_variable condFree;
+        std::deque<Task> queue;
+        uint64_t queueSize{0};
+        bool stopped{false};
+        // Set when the thread has exited, later tasks are done by the caller
+        bool done{false};
+        std::unordered_map<std::string, File> files;
+
+        void run() override;
+        void push(Thread* t, Task task);
+        void process(Thread* t, const Task& task);
+        void compress(Thread* t, const std::string& fileName);
+
+    public:
+        RedoCopy(Ctx* newCtx, std::string newAlias, COMPRESSION newCompression);
+        ~RedoCopy() override;
+
+        void open(Thread* t, const std::string& fileName);
+        void write(Thread* t, const std::string& fileName, uint64_t offset, const uint8_t* data, uint64_t size);
+        void close(Thread* t, const std::string& fileName, bool complete);
+        void stop();
+        void wakeUp() override;
+
+        std::string getName() const override {
+            return {"RedoCopy: " + alias};
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,124 @@
+/* Serving of the redo log copies to other instances
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <algorithm>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sstream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../common/Ctx.h"
+#include "RedoRelay.h"
+
+namespace OpenLogReplicator {
+    Seq RedoRelay::getSequence(const std::string& fileName) {
+        static const std::string suffix(".arc");
+        if (fileName.size() <= suffix.size() || fileName.compare(fileName.size() - suffix.size(), suffix.size(), suffix) != 0)
+            return Seq::zero();
+
+        const size_t end = fileName.size() - suffix.size();
+        const size_t start = fileName.find_last_of('_', end) + 1;
+        if (start == 0 || start == end)
+            return Seq::zero();
+
+        uint32_t sequence = 0;
+        for (size_t i = start; i < end; ++i) {
+            if (fileName[i] < '0' || fileName[i] > '9')
+                return Seq::zero();
+            sequence = sequence * 10 + (fileName[i] - '0');
+        }
+        return Seq(sequence);
+    }
+
+    void RedoRelay::list(const Ctx* ctx, Seq from, std::vector<Log>& logs) {
+        DIR* dir = opendir(ctx->redoCopyPath.c_str());
+        if (dir == nullptr)
+            return;
+
+        const struct dirent* ent;
+        while ((ent = readdir(dir)) != nullptr) {
+            const std::string dName(ent->d_name);
+            const Seq sequence = getSequence(dName);
+            if (sequence == Seq::zero() || sequence < from)
+                continue;
+
+            const std::string fileName(ctx->redoCopyPath + "/" + dName);
+            struct stat fileStat{};
+            if (stat(fileName.c_str(), &fileStat) != 0 || !S_ISREG(fileStat.st_mode))
+                continue;
+            logs.push_back(Log{sequence, static_cast<uint64_t>(fileStat.st_size), fileName});
+        }
+        closedir(dir);
+
+        std::sort(logs.begin(), logs.end(), [](const Log& a, const Log& b) {
+            return a.sequence < b.sequence;
+        });
+    }
+
+    std::string RedoRelay::listJson(const Ctx* ctx, Seq from) {
+        std::vector<Log> logs;
+        list(ctx, from, logs);
+
+        std::ostringstream ss;
+        ss << R"({"logs":[)";
+        bool first = true;
+        for (const Log& log: logs) {
+            if (!first)
+                ss << ",";
+            first = false;
+            ss << R"({"sequence":)" << std::dec << log.sequence.getData() << R"(,"size":)" << log.size << "}";
+        }
+        ss << "]}";
+        return ss.str();
+    }
+
+    bool RedoRelay::read(const Ctx* ctx, Seq sequence, uint64_t offset, uint64_t size, std::string& data, uint64_t& fileSize) {
+        std::vector<Log> logs;
+        list(ctx, sequence, logs);
+        if (logs.empty() || logs.front().sequence != sequence)
+            return false;
+
+        const int fd = open(logs.front().fileName.c_str(), O_RDONLY);
+        if (fd == -1)
+            return false;
+
+        struct stat fileStat{};
+        if (fstat(fd, &fileStat) != 0) {
+            close(fd);
+            return false;
+        }
+        fileSize = static_cast<uint64_t>(fileStat.st_size);
+
+        data.clear();
+        if (offset < fileSize) {
+            data.resize(std::min(size, fileSize - offset));
+            uint64_t done = 0;
+            while (done < data.size()) {
+                const ssize_t bytes = pread(fd, data.data() + done, data.size() - done, static_cast<off_t>(offset + done));
+                if (bytes <= 0)
+                    break;
+                done += bytes;
+            }
+            data.resize(done);
+        }
+        close(fd);
+        return true;
+    }
+}
@@ -0,0 +1,54 @@
+/* Header for RedoRelay class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef REDO_RELAY_H_
+#define REDO_RELAY_H_
+
+#include <string>
+#include <vector>
+
+#include "../common/types/Seq.h"
+
+namespace OpenLogReplicator {
+    class Ctx;
+
+    // Redo logs read by this instance, served to other instances over HTTP. The source of a log is read once: the readers keep
+    // the copy of the verified blocks in redo-copy-path, and the copy is listed here when the whole log is in it. The other
+    // instances read the logs with ranged requests of ReaderObjectStore, the number of ranges fetched ahead bounds the data in
+    // flight
+    class RedoRelay final {
+    public:
+        struct Log {
+            Seq sequence;
+            uint64_t size;
+            std::string fileName;
+        };
+
+        // Complete copies of logs starting with the sequence, in sequence order
+        static void list(const Ctx* ctx, Seq from, std::vector<Log>& logs);
+        // JSON of the list, as returned to the other instances
+        static std::string listJson(const Ctx* ctx, Seq from);
+        // False when there is no complete copy of the log, data is empty past the end of the copy
+        static bool read(const Ctx* ctx, Seq sequence, uint64_t offset, uint64_t size, std::string& data, uint64_t& fileSize);
+        // Sequence of a copy named "<database>_<sequence>.arc", 0 for other files
+        [[nodiscard]] static Seq getSequence(const std::string& fileName);
+    };
+}
+
+#endif
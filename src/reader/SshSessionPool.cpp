@@ -0,0 +1,289 @@
+/* Shared SSH sessions for remote redo log readers
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include "../common/Clock.h"
+#include "../common/Ctx.h"
+#include "../common/Thread.h"
+#include "SshSessionPool.h"
+
+namespace OpenLogReplicator {
+    SshSession::SshSession(std::string newHost, std::string newUser, std::string newPassword, int newPort) :
+            host(std::move(newHost)),
+            user(std::move(newUser)),
+            password(std::move(newPassword)),
+            port(newPort) {
+    }
+
+    SshSession::~SshSession() {
+        for (const Connection& connection: connections)
+            disconnect(connection.session);
+        connections.clear();
+    }
+
+    // Called with the session mutex held, returns nullptr when the connection could not be established
+    ssh_session SshSession::connect(Ctx* ctx, Thread* t) {
+        t->contextSet(Thread::CONTEXT::OS, Thread::REASON::OS);
+        ssh_session session = ssh_new();
+        if (session == nullptr) {
+            t->contextSet(Thread::CONTEXT::CPU);
+            ctx->error(10001, "failed to create SSH session");
+            return nullptr;
+        }
+
+        ssh_options_set(session, SSH_OPTIONS_HOST, host.c_str());
+        ssh_options_set(session, SSH_OPTIONS_PORT, &port);
+        ssh_options_set(session, SSH_OPTIONS_USER, user.c_str());
+
+        if (ssh_connect(session) != SSH_OK) {
+            t->contextSet(Thread::CONTEXT::CPU);
+            ctx->error(10002, "SSH connection failed: " + std::string(ssh_get_error(session)));
+            disconnect(session);
+            return nullptr;
+        }
+
+        bool authenticated = false;
+        const int noneResult = ssh_userauth_none(session, nullptr);
+        const int authMethods = ssh_userauth_list(session, nullptr);
+        if (noneResult == SSH_AUTH_SUCCESS)
+            authenticated = true;
+
+        if (!authenticated && (authMethods & SSH_AUTH_METHOD_PUBLICKEY) != 0) {
+            if (ssh_userauth_publickey_auto(session, nullptr, nullptr) == SSH_AUTH_SUCCESS)
+                authenticated = true;
+            else
+                ctx->warning(10004, "SSH public key authentication failed: " + std::string(ssh_get_error(session)));
+        }
+
+        if (!authenticated && (authMethods & SSH_AUTH_METHOD_PASSWORD) != 0) {
+            if (ssh_userauth_password(session, nullptr, password.c_str()) == SSH_AUTH_SUCCESS)
+                authenticated = true;
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
+
+        if (!authenticated) {
+            ctx->error(10003, "SSH authentication failed for: " + user + "@" + host + ", supported methods: " + std::to_string(authMethods));
+            disconnect(session);
+            return nullptr;
+        }
+
+        connections.push_back(Connection{session, 0, ctx->clock->getTimeUt(), false});
+        ctx->info(0, "SSH connection established to: " + host + ", connections: " + std::to_string(connections.size()));
+        return session;
+    }
+
+    void SshSession::disconnect(ssh_session session) {
+        if (session == nullptr)
+            return;
+
+        ssh_disconnect(session);
+        ssh_free(session);
+    }
+
+    SshSession::Connection* SshSession::findConnection(ssh_session session) {
+        for (Connection& connection: connections)
+            if (connection.session == session)
+                return &connection;
+        return nullptr;
+    }
+
+    // Only for a connection without channels, the channels of other readers would be freed with it
+    void SshSession::dropConnection(Connection* connection) {
+        disconnect(connection->session);
+        connections.erase(connections.begin() + (connection - connections.data()));
+    }
+
+    ssh_channel SshSession::openChannel(Ctx* ctx, Thread* t, const std::string& command) {
+        t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::READER_SSH);
+        std::unique_lock<std::mutex> const lck(mtx);
+
+        // Dropped connections without channels go first, the ones still used by other readers stay until their last channel is closed
+        t->contextSet(Thread::CONTEXT::OS, Thread::REASON::OS);
+        for (uint64_t i = connections.size(); i > 0; --i) {
+            if (connections[i - 1].channels == 0 && ssh_is_connected(connections[i - 1].session) == 0)
+                dropConnection(&connections[i - 1]);
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
+
+        // Every usable connection is tried once, then new ones are opened up to the limit
+        uint64_t tried = 0;
+        for (uint attempt = 0; attempt <= CONNECTIONS_MAX * 2; ++attempt) {
+            ssh_session session = nullptr;
+            t->contextSet(Thread::CONTEXT::OS, Thread::REASON::OS);
+            for (uint64_t i = tried; i < connections.size(); ++i) {
+                tried = i + 1;
+                if (!connections[i].full && ssh_is_connected(connections[i].session) != 0) {
+                    session = connections[i].session;
+                    break;
+                }
+            }
+            t->contextSet(Thread::CONTEXT::CPU);
+
+            if (session == nullptr) {
+                if (connections.size() >= CONNECTIONS_MAX) {
+                    ctx->warning(10005, "failed to open SSH channel to: " + host + " - all " + std::to_string(CONNECTIONS_MAX) +
+                                        " connections refuse more channels");
+                    return nullptr;
+                }
+                session = connect(ctx, t);
+                if (session == nullptr)
+                    return nullptr;
+                tried = connections.size();
+            }
+
+            t->contextSet(Thread::CONTEXT::OS, Thread::REASON::OS);
+            ssh_channel channel = ssh_channel_new(session);
+            if (channel != nullptr) {
+                if (ssh_channel_open_session(channel) == SSH_OK && ssh_channel_request_exec(channel, command.c_str()) == SSH_OK) {
+                    t->contextSet(Thread::CONTEXT::CPU);
+                    Connection* connection = findConnection(session);
+                    ++connection->channels;
+                    connection->lastUsed = ctx->clock->getTimeUt();
+                    return channel;
+                }
+                ssh_channel_free(channel);
+            }
+            const bool connected = ssh_is_connected(session) != 0;
+            t->contextSet(Thread::CONTEXT::CPU);
+
+            ctx->warning(10005, "failed to open SSH channel to: " + host + " - " + std::string(ssh_get_error(session)));
+            Connection* connection = findConnection(session);
+            if (connected)
+                connection->full = true;
+            else if (connection->channels == 0) {
+                dropConnection(connection);
+                tried = 0;
+            }
+        }
+        return nullptr;
+    }
+
+    void SshSession::closeChannel(Thread* t, ssh_channel channel, bool sendEof) {
+        t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::READER_SSH);
+        std::unique_lock<std::mutex> const lck(mtx);
+        t->contextSet(Thread::CONTEXT::OS, Thread::REASON::OS);
+        ssh_session session = ssh_channel_get_session(channel);
+        if (sendEof)
+            ssh_channel_send_eof(channel);
+        ssh_channel_close(channel);
+        ssh_channel_free(channel);
+
+        Connection* connection = findConnection(session);
+        if (connection != nullptr) {
+            if (connection->channels > 0)
+                --connection->channels;
+            connection->full = false;
+            // A dropped connection is freed with its last channel
+            if (connection->channels == 0 && ssh_is_connected(session) == 0)
+                dropConnection(connection);
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
+    }
+
+    int SshSession::write(Thread* t, ssh_channel channel, const void* data, uint32_t size) {
+        t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::READER_SSH);
+        std::unique_lock<std::mutex> const lck(mtx);
+        t->contextSet(Thread::CONTEXT::OS, Thread::REASON::OS);
+        const int written = ssh_channel_write(channel, data, size);
+        t->contextSet(Thread::CONTEXT::CPU);
+        return written;
+    }
+
+    // Blocks until some data arrives; returns 0 on end of stream and a negative value on error
+    int SshSession::read(Ctx* ctx, Thread* t, ssh_channel channel, void* data, uint32_t size) {
+        while (!ctx->hardShutdown) {
+            t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::READER_SSH);
+            std::unique_lock<std::mutex> lck(mtx);
+            t->contextSet(Thread::CONTEXT::OS, Thread::REASON::OS);
+            const int bytesRead = ssh_channel_read_timeout(channel, data, size, 0, READ_SLICE_MS);
+            const bool eof = (bytesRead == 0 && ssh_channel_is_eof(channel) != 0);
+
+            // Keep the idle shared connection alive
+            Connection* connection = findConnection(ssh_channel_get_session(channel));
+            const time_ut now = ctx->clock->getTimeUt();
+            if (connection != nullptr) {
+                if (bytesRead == 0 && !eof && now > connection->lastUsed + KEEPALIVE_US) {
+                    ssh_send_keepalive(connection->session);
+                    connection->lastUsed = now;
+                } else if (bytesRead > 0)
+                    connection->lastUsed = now;
+            }
+            t->contextSet(Thread::CONTEXT::CPU);
+
+            if (bytesRead != 0 || eof)
+                return bytesRead;
+        }
+        return -1;
+    }
+
+    int SshSession::exitStatus(Thread* t, ssh_channel channel) {
+        t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::READER_SSH);
+        std::unique_lock<std::mutex> const lck(mtx);
+        t->contextSet(Thread::CONTEXT::OS, Thread::REASON::OS);
+        const int status = ssh_channel_get_exit_status(channel);
+        t->contextSet(Thread::CONTEXT::CPU);
+        return status;
+    }
+
+    std::string SshSession::getError(ssh_channel channel) {
+        std::unique_lock<std::mutex> const lck(mtx);
+        if (channel == nullptr)
+            return "not connected";
+        return ssh_get_error(ssh_channel_get_session(channel));
+    }
+
+    SshSessionPool::~SshSessionPool() {
+        for (auto& [key, sshSession]: sessions)
+            delete sshSession;
+        sessions.clear();
+    }
+
+    SshSessionPool& SshSessionPool::getInstance() {
+        static SshSessionPool pool;
+        return pool;
+    }
+
+    SshSession* SshSessionPool::acquire(Ctx* ctx, Thread* t, const std::string& host, const std::string& user, const std::string& password,
+                                        int port) {
+        const std::string key = user + "@" + host + ":" + std::to_string(port);
+        SshSession* sshSession;
+        {
+            t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::READER_SSH);
+            std::unique_lock<std::mutex> const lck(mtx);
+            auto it = sessions.find(key);
+            if (it == sessions.end()) {
+                sshSession = new SshSession(host, user, password, port);
+                sessions.insert_or_assign(key, sshSession);
+            } else
+                sshSession = it->second;
+            ++sshSession->channels;
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
+
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::FILE)))
+            ctx->logTrace(Ctx::TRACE::FILE, "using shared SSH session: " + key + ", users: " + std::to_string(sshSession->channels));
+        return sshSession;
+    }
+
+    // The session itself stays open for the next reader
+    void SshSessionPool::release(SshSession* sshSession) {
+        std::unique_lock<std::mutex> const lck(mtx);
+        if (sshSession->channels > 0)
+            --sshSession->channels;
+    }
+}
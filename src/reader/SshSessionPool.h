@@ -0,0 +1,100 @@
+/* Header for SshSessionPool class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef SSH_SESSION_POOL_H_
+#define SSH_SESSION_POOL_H_
+
+#include <libssh/libssh.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../common/types/Types.h"
+
+namespace OpenLogReplicator {
+    class Ctx;
+    class Thread;
+
+    // Authenticated SSH connections to one host shared by many channels; libssh is not thread safe, so every call on the connections and
+    // their channels is done under the session mutex and blocking reads are split into short timed reads. When the server refuses another
+    // channel (MaxSessions) one more connection is opened, a connection is freed only once the last of its channels is closed
+    class SshSession final {
+    protected:
+        static constexpr int READ_SLICE_MS{10};
+        static constexpr time_ut KEEPALIVE_US{30000000};
+        static constexpr uint CONNECTIONS_MAX{16};
+
+        struct Connection {
+            ssh_session session;
+            uint64_t channels;
+            time_ut lastUsed;
+            // The server refused a channel, not used for new channels until one of its channels is closed
+            bool full;
+        };
+
+        std::mutex mtx;
+        std::vector<Connection> connections;
+
+        ssh_session connect(Ctx* ctx, Thread* t);
+        static void disconnect(ssh_session session);
+        Connection* findConnection(ssh_session session);
+        void dropConnection(Connection* connection);
+
+        friend class SshSessionPool;
+
+    public:
+        const std::string host;
+        const std::string user;
+        const std::string password;
+        const int port;
+        uint64_t channels{0};
+
+        SshSession(std::string newHost, std::string newUser, std::string newPassword, int newPort);
+        ~SshSession();
+
+        ssh_channel openChannel(Ctx* ctx, Thread* t, const std::string& command);
+        void closeChannel(Thread* t, ssh_channel channel, bool sendEof);
+        int write(Thread* t, ssh_channel channel, const void* data, uint32_t size);
+        int read(Ctx* ctx, Thread* t, ssh_channel channel, void* data, uint32_t size);
+        int exitStatus(Thread* t, ssh_channel channel);
+        std::string getError(ssh_channel channel);
+    };
+
+    // Process-wide pool with one session per host/port/user, opening a reader costs one channel instead of a handshake
+    class SshSessionPool final {
+    protected:
+        std::mutex mtx;
+        std::map<std::string, SshSession*> sessions;
+
+        SshSessionPool() = default;
+
+    public:
+        ~SshSessionPool();
+        SshSessionPool(const SshSessionPool&) = delete;
+        SshSessionPool& operator=(const SshSessionPool&) = delete;
+
+        static SshSessionPool& getInstance();
+
+        SshSession* acquire(Ctx* ctx, Thread* t, const std::string& host, const std::string& user, const std::string& password, int port);
+        void release(SshSession* sshSession);
+    };
+}
+
+#endif
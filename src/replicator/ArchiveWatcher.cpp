@@ -0,0 +1,154 @@
+/* Watcher of the archived redo log destination
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include "../common/Ctx.h"
+#include "ArchiveWatcher.h"
+
+namespace OpenLogReplicator {
+    ArchiveWatcher::ArchiveWatcher(Ctx* newCtx) :
+            ctx(newCtx) {
+    }
+
+    ArchiveWatcher::~ArchiveWatcher() {
+        if (fd != -1) {
+            close(fd);
+            fd = -1;
+        }
+        directories.clear();
+    }
+
+    void ArchiveWatcher::disable(const std::string& msg) {
+        ctx->warning(60045, msg + " - " + strerror(errno) + ", archived redo logs are found by directory scan only");
+        if (fd != -1) {
+            close(fd);
+            fd = -1;
+        }
+        directories.clear();
+        rootWd = -1;
+        failed = true;
+    }
+
+    // Day subdirectories are created below the root, so only directory creation is watched there
+    void ArchiveWatcher::watchRoot(const std::string& path) {
+        if (failed || (fd != -1 && rootPath == path))
+            return;
+
+        if (fd == -1) {
+            fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (fd == -1) {
+                disable("inotify initialization failed");
+                return;
+            }
+        }
+
+        for (const auto& [wd, directory]: directories)
+            inotify_rm_watch(fd, wd);
+        directories.clear();
+
+        rootPath = path;
+        rootWd = inotify_add_watch(fd, rootPath.c_str(), IN_CREATE | IN_MOVED_TO | IN_ONLYDIR);
+        if (rootWd == -1) {
+            disable("directory: " + rootPath + " - watch failed");
+            return;
+        }
+        directories[rootWd] = rootPath;
+    }
+
+    // Adding the same directory again returns the same watch
+    void ArchiveWatcher::watchDirectory(const std::string& path) {
+        if (fd == -1)
+            return;
+
+        const int wd = inotify_add_watch(fd, path.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_ONLYDIR);
+        if (wd == -1) {
+            disable("directory: " + path + " - watch failed");
+            return;
+        }
+        directories[wd] = path;
+    }
+
+    // Appends files written since the last call, returns false when events were lost or a new directory appeared
+    // and the destination has to be scanned
+    bool ArchiveWatcher::collect(std::vector<std::string>& files) {
+        if (fd == -1)
+            return false;
+
+        bool complete = true;
+        alignas(struct inotify_event) char buffer[EVENT_BUFFER_SIZE];
+        while (true) {
+            const ssize_t bytes = read(fd, buffer, sizeof(buffer));
+            if (bytes <= 0) {
+                if (bytes == -1 && errno != EAGAIN && errno != EINTR) {
+                    disable("inotify read failed");
+                    return false;
+                }
+                break;
+            }
+
+            for (ssize_t pos = 0; pos < bytes;) {
+                const auto* event = reinterpret_cast<const struct inotify_event*>(buffer + pos);
+                pos += static_cast<ssize_t>(sizeof(struct inotify_event) + event->len);
+
+                if ((event->mask & IN_Q_OVERFLOW) != 0) {
+                    complete = false;
+                    continue;
+                }
+
+                if ((event->mask & IN_IGNORED) != 0) {
+                    directories.erase(event->wd);
+                    continue;
+                }
+
+                auto it = directories.find(event->wd);
+                if (it == directories.end() || event->len == 0)
+                    continue;
+
+                if (event->wd == rootWd) {
+                    // Files could have been written to the new directory before it was watched
+                    if ((event->mask & IN_ISDIR) != 0)
+                        complete = false;
+                    continue;
+                }
+
+                if ((event->mask & IN_ISDIR) == 0)
+                    files.push_back(it->second + "/" + event->name);
+            }
+        }
+
+        return complete;
+    }
+
+    // Returns false without waiting when no watch is active
+    bool ArchiveWatcher::wait(time_ut timeUs) const {
+        if (fd == -1)
+            return false;
+
+        struct pollfd pfd{};
+        pfd.fd = fd;
+        pfd.events = POLLIN;
+        poll(&pfd, 1, static_cast<int>(timeUs / 1000));
+        return true;
+    }
+}
@@ -0,0 +1,63 @@
+/* Header for ArchiveWatcher class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef ARCHIVE_WATCHER_H_
+#define ARCHIVE_WATCHER_H_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../common/types/Types.h"
+
+namespace OpenLogReplicator {
+    class Ctx;
+
+    // Reports archived redo logs written to the archive destination using inotify, so that they are processed without
+    // waiting for the next directory scan. Events are not delivered for files written by other hosts on network
+    // filesystems, therefore the scan remains as a periodic fallback
+    class ArchiveWatcher final {
+    protected:
+        static constexpr uint64_t EVENT_BUFFER_SIZE{64 * 1024};
+
+        Ctx* ctx;
+        int fd{-1};
+        bool failed{false};
+        std::string rootPath;
+        int rootWd{-1};
+        std::unordered_map<int, std::string> directories;
+
+        void disable(const std::string& msg);
+
+    public:
+        explicit ArchiveWatcher(Ctx* newCtx);
+        ~ArchiveWatcher();
+
+        [[nodiscard]] bool active() const {
+            return fd != -1;
+        }
+
+        void watchRoot(const std::string& path);
+        void watchDirectory(const std::string& path);
+        bool collect(std::vector<std::string>& files);
+        bool wait(time_ut timeUs) const;
+    };
+}
+
+#endif
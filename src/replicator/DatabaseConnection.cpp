@@ -61,6 +61,11 @@ namespace OpenLogReplicator {
         env->checkErr(errhp, OCIAttrSet(reinterpret_cast<dvoid*>(svchp), OCI_HTYPE_SVCCTX,
                                         reinterpret_cast<dvoid*>(authp), 0, OCI_ATTR_SESSION, errhp));
 
+        // Statements prepared with OCIStmtPrepare2 are kept parsed for the life of the session
+        ub4 cacheSize = STATEMENT_CACHE_SIZE;
+        env->checkErr(errhp, OCIAttrSet(reinterpret_cast<dvoid*>(svchp), OCI_HTYPE_SVCCTX, reinterpret_cast<dvoid*>(&cacheSize), 0,
+                                        OCI_ATTR_STMTCACHESIZE, errhp));
+
         connected = true;
     }
 
@@ -29,6 +29,8 @@ namespace OpenLogReplicator {
 
     class DatabaseConnection final {
     public:
+        static constexpr uint32_t STATEMENT_CACHE_SIZE{32};
+
         std::string user;
         std::string password;
         std::string connectString;
@@ -34,9 +34,11 @@ namespace OpenLogReplicator {
     DatabaseStatement::~DatabaseStatement() {
         unbindAll();
 
-        if (executed) {
+        // A prepared handle belongs to the statement cache of the connection, it is released there and never freed
+        if (prepared) {
             OCIStmtRelease(stmthp, conn->errhp, nullptr, 0, OCI_DEFAULT);
-            executed = false;
+            prepared = false;
+            stmthp = nullptr;
         }
 
         if (stmthp != nullptr) {
@@ -48,19 +50,22 @@ namespace OpenLogReplicator {
     void DatabaseStatement::createStatement(const std::string_view& sql) {
         unbindAll();
 
-        if (executed) {
+        if (prepared) {
             OCIStmtRelease(stmthp, conn->errhp, nullptr, 0, OCI_DEFAULT);
-            executed = false;
-        }
+            prepared = false;
+        } else if (stmthp != nullptr)
+            OCIHandleFree(stmthp, OCI_HTYPE_STMT);
+        stmthp = nullptr;
 
+        // Served from the statement cache of the connection when the same text was prepared before
         conn->env->checkErr(conn->errhp, OCIStmtPrepare2(conn->svchp, &stmthp, conn->errhp, reinterpret_cast<const OraText*>(sql.data()),
                                                          sql.length(), nullptr, 0, OCI_NTV_SYNTAX, OCI_DEFAULT));
+        prepared = true;
     }
 
     int DatabaseStatement::executeQuery() {
         const sword status = OCIStmtExecute(conn->svchp, stmthp, conn->errhp, 1, 0, nullptr, nullptr,
                                       OCI_DEFAULT); // COMMIT_ON_SUCCESS
-        executed = true;
         if (status == OCI_NO_DATA)
             return 0;
 
@@ -68,6 +73,23 @@ namespace OpenLogReplicator {
         return 1;
     }
 
+    // Executes without fetching, the rows are then read with fetchArray(); prefetched rows arrive with the execute round trip
+    void DatabaseStatement::execute() {
+        conn->env->checkErr(conn->errhp, OCIStmtExecute(conn->svchp, stmthp, conn->errhp, 0, 0, nullptr, nullptr, OCI_DEFAULT));
+    }
+
+    // Fetches up to rows rows into defined arrays of that many elements, returns the number of rows fetched, 0 at the end of data
+    uint32_t DatabaseStatement::fetchArray(uint32_t rows) {
+        const sword status = OCIStmtFetch2(stmthp, conn->errhp, rows, OCI_FETCH_NEXT, 0, OCI_DEFAULT);
+        if (status != OCI_NO_DATA)
+            conn->env->checkErr(conn->errhp, status);
+
+        ub4 rowsFetched = 0;
+        conn->env->checkErr(conn->errhp, OCIAttrGet(reinterpret_cast<dvoid*>(stmthp), OCI_HTYPE_STMT, reinterpret_cast<dvoid*>(&rowsFetched), nullptr,
+                                                    OCI_ATTR_ROWS_FETCHED, conn->errhp));
+        return rowsFetched;
+    }
+
     void DatabaseStatement::unbindAll() {
         for (OCIBind* bindp: binds)
             OCIHandleFree(reinterpret_cast<dvoid*>(bindp), OCI_HTYPE_BIND);
@@ -78,6 +100,15 @@ namespace OpenLogReplicator {
         defines.clear();
     }
 
+    // Rows transferred per round trip; next() is then served from the client side buffer
+    void DatabaseStatement::setPrefetchRows(uint32_t rows) {
+        if (rows == 0)
+            return;
+
+        conn->env->checkErr(conn->errhp, OCIAttrSet(reinterpret_cast<dvoid*>(stmthp), OCI_HTYPE_STMT, reinterpret_cast<dvoid*>(&rows), 0,
+                                                    OCI_ATTR_PREFETCH_ROWS, conn->errhp));
+    }
+
     int DatabaseStatement::next() {
         const sword status = OCIStmtFetch2(stmthp, conn->errhp, 1, OCI_FETCH_NEXT, 0, OCI_DEFAULT);
         if (status == OCI_NO_DATA)
@@ -107,6 +138,16 @@ namespace OpenLogReplicator {
         conn->env->checkErr(conn->errhp, ret);
     }
 
+    // PL/SQL out bind, only *length bytes of buf are sent to the server (0 for a pure out value) and *length is set to the size returned
+    void DatabaseStatement::bindBinaryOut(uint col, uint8_t* buf, uint64_t size, uint16_t* length) {
+        OCIBind* bindp = nullptr;
+        const sword ret = OCIBindByPos(stmthp, &bindp, conn->errhp, col, reinterpret_cast<void*>(buf), size, SQLT_BIN,
+                                       nullptr, length, nullptr, 0, nullptr, OCI_DEFAULT);
+        if (bindp != nullptr)
+            binds.push_back(bindp);
+        conn->env->checkErr(conn->errhp, ret);
+    }
+
     void DatabaseStatement::defineString(uint col, char* val, uint64_t len) {
         OCIDefine* defp = nullptr;
         const sword ret = OCIDefineByPos(stmthp, &defp, conn->errhp, col, val, len, SQLT_STR, nullptr,
@@ -116,6 +157,16 @@ namespace OpenLogReplicator {
         conn->env->checkErr(conn->errhp, ret);
     }
 
+    // Raw bytes of the column in the external format type, an array fetch stores row n at buf + n * size and sets its indicator and length
+    void DatabaseStatement::defineBinary(uint col, uint16_t type, uint8_t* buf, uint64_t size, int16_t* indicators, uint16_t* lengths) {
+        OCIDefine* defp = nullptr;
+        const sword ret = OCIDefineByPos(stmthp, &defp, conn->errhp, col, buf, size, type, indicators,
+                                         lengths, nullptr, OCI_DEFAULT);
+        if (defp != nullptr)
+            defines.push_back(defp);
+        conn->env->checkErr(conn->errhp, ret);
+    }
+
     bool DatabaseStatement::isNull(uint col) {
         OCIParam* paramdp;
         conn->env->checkErr(conn->errhp, OCIParamGet(stmthp, OCI_HTYPE_STMT, conn->errhp,
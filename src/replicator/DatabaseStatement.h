@@ -32,7 +32,7 @@ namespace OpenLogReplicator {
     class DatabaseStatement final {
     protected:
         DatabaseConnection* conn;
-        bool executed{false};
+        bool prepared{false};
         OCIStmt* stmthp{nullptr};
         std::vector<OCIBind*> binds;
         std::vector<OCIDefine*> defines;
@@ -44,11 +44,16 @@ namespace OpenLogReplicator {
         void createStatement(const std::string_view& sql);
         void unbindAll();
         int executeQuery();
+        void execute();
         int next();
+        uint32_t fetchArray(uint32_t rows);
+        void setPrefetchRows(uint32_t rows);
 
         void bindString(uint col, std::string& val);
         void bindBinary(uint col, uint8_t* buf, uint64_t size);
+        void bindBinaryOut(uint col, uint8_t* buf, uint64_t size, uint16_t* length);
         void defineString(uint col, char* val, uint64_t len);
+        void defineBinary(uint col, uint16_t type, uint8_t* buf, uint64_t size, int16_t* indicators, uint16_t* lengths);
         [[nodiscard]] bool isNull(uint col);
 
         template<typename T>
@@ -0,0 +1,183 @@
+/* Split of the tables of a source between cooperating instances
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <utility>
+
+#include "../common/Ctx.h"
+#include "../common/exception/DataException.h"
+#include "../common/exception/RuntimeException.h"
+#include "../common/types/Data.h"
+#include "../state/State.h"
+#include "PartitionCoordinator.h"
+
+namespace OpenLogReplicator {
+    PartitionCoordinator::PartitionCoordinator(Ctx* newCtx, State* newState, std::string newDatabase, std::string newNode, uint newPartitions,
+                                               uint64_t newTimeoutS) :
+            ctx(newCtx),
+            state(newState),
+            database(std::move(newDatabase)),
+            owned(newPartitions, false),
+            node(std::move(newNode)),
+            partitions(newPartitions),
+            timeoutS(newTimeoutS) {
+    }
+
+    PartitionCoordinator::~PartitionCoordinator() {
+        delete state;
+        state = nullptr;
+    }
+
+    std::string PartitionCoordinator::nodeName(const std::string& nodeId) const {
+        return database + "-node-" + nodeId;
+    }
+
+    std::string PartitionCoordinator::partitionName(uint partition) const {
+        return database + "-part-" + std::to_string(partition);
+    }
+
+    bool PartitionCoordinator::readJson(const std::string& name, std::string& in) const {
+        try {
+            return state->read(name, STATE_FILE_MAX_SIZE, in) && !in.empty();
+        } catch (RuntimeException& ex) {
+            ctx->error(ex.code, ex.msg);
+        }
+        return false;
+    }
+
+    void PartitionCoordinator::heartbeat(time_t now) {
+        std::ostringstream ss;
+        ss << R"({"node":")";
+        Data::writeEscapeValue(ss, node);
+        ss << R"(","time":)" << std::dec << now << "}";
+        try {
+            state->write(nodeName(node), Scn::zero(), ss);
+        } catch (RuntimeException& ex) {
+            ctx->error(ex.code, ex.msg);
+        }
+    }
+
+    // This instance is always counted, also when its own heartbeat can't be read
+    void PartitionCoordinator::liveNodes(time_t now, std::vector<std::string>& nodes) const {
+        const std::string prefix(database + "-node-");
+        std::set<std::string> names;
+        try {
+            state->list(names);
+        } catch (RuntimeException& ex) {
+            ctx->error(ex.code, ex.msg);
+        }
+
+        nodes.push_back(node);
+        for (const std::string& name: names) {
+            if (name.rfind(prefix, 0) != 0)
+                continue;
+
+            std::string in;
+            rapidjson::Document document;
+            if (!readJson(name, in) || document.Parse(in.c_str()).HasParseError() || !document.IsObject() || !document.HasMember("node") ||
+                !document.HasMember("time") || !document["node"].IsString() || !document["time"].IsUint64())
+                continue;
+
+            const std::string nodeId = document["node"].GetString();
+            const auto time = static_cast<time_t>(document["time"].GetUint64());
+            if (nodeId != node && now < time + static_cast<time_t>(timeoutS))
+                nodes.push_back(nodeId);
+        }
+        std::sort(nodes.begin(), nodes.end());
+    }
+
+    void PartitionCoordinator::start(time_t now) {
+        heartbeat(now);
+
+        std::vector<std::string> nodes;
+        liveNodes(now, nodes);
+        const auto rank = static_cast<uint64_t>(std::find(nodes.begin(), nodes.end(), node) - nodes.begin());
+        for (uint partition = 0; partition < partitions; ++partition)
+            owned[partition] = (partition % nodes.size()) == rank;
+        members = nodes.size();
+    }
+
+    // Compared with the split the instance was started with
+    bool PartitionCoordinator::assign(time_t now) {
+        std::vector<std::string> nodes;
+        liveNodes(now, nodes);
+        const auto rank = static_cast<uint64_t>(std::find(nodes.begin(), nodes.end(), node) - nodes.begin());
+        for (uint partition = 0; partition < partitions; ++partition)
+            if (owned[partition] != ((partition % nodes.size()) == rank))
+                return true;
+        return false;
+    }
+
+    std::string PartitionCoordinator::describe() const {
+        std::ostringstream ss;
+        ss << "node: " << node << " of " << std::dec << members << ", partitions:";
+        for (uint partition = 0; partition < partitions; ++partition)
+            if (owned[partition])
+                ss << " " << partition;
+        return ss.str();
+    }
+
+    bool PartitionCoordinator::startPosition(Scn& scn, typeResetlogs& resetlogs, typeActivation& activation) const {
+        bool found = false;
+        for (uint partition = 0; partition < partitions; ++partition) {
+            if (!owned[partition])
+                continue;
+
+            const std::string name(partitionName(partition));
+            std::string in;
+            if (!readJson(name, in))
+                continue;
+
+            rapidjson::Document document;
+            if (unlikely(document.Parse(in.c_str()).HasParseError()))
+                throw DataException(20001, "file: " + name + " offset: " + std::to_string(document.GetErrorOffset()) +
+                                           " - parse error: " + GetParseError_En(document.GetParseError()));
+
+            const Scn partitionScn(Ctx::getJsonFieldU64(name, document, "scn"));
+            if (!found || partitionScn < scn) {
+                scn = partitionScn;
+                resetlogs = Ctx::getJsonFieldU32(name, document, "resetlogs");
+                activation = Ctx::getJsonFieldU32(name, document, "activation");
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    // Written with every checkpoint of the writer, the output of all owned partitions is confirmed up to the same position
+    void PartitionCoordinator::confirm(Scn scn, typeResetlogs resetlogs, typeActivation activation) {
+        for (uint partition = 0; partition < partitions; ++partition) {
+            if (!owned[partition])
+                continue;
+
+            std::ostringstream ss;
+            ss << R"({"scn":)" << std::dec << scn.getData() << R"(,"resetlogs":)" << resetlogs << R"(,"activation":)" << activation
+               << R"(,"node":")";
+            Data::writeEscapeValue(ss, node);
+            ss << R"("})";
+            try {
+                state->write(partitionName(partition), scn, ss);
+            } catch (RuntimeException& ex) {
+                ctx->error(ex.code, ex.msg);
+            }
+        }
+    }
+}
@@ -0,0 +1,83 @@
+/* Header for PartitionCoordinator class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef PARTITION_COORDINATOR_H_
+#define PARTITION_COORDINATOR_H_
+
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "../common/types/Scn.h"
+#include "../common/types/Types.h"
+
+namespace OpenLogReplicator {
+    class Ctx;
+    class State;
+
+    // Instances of one source sharing the work: the tables are split by the hash of the object id into partitions, every instance
+    // parses all redo but keeps only the rows of the tables of its own partitions. Membership is a heartbeat of every instance in
+    // the shared state, the live instances sorted by name own the partitions in turn, so that all of them come to the same split
+    // without talking to each other. When the split changes, the instance stops and continues after restart from the oldest
+    // position confirmed for the partitions it owns then
+    class PartitionCoordinator final {
+    protected:
+        static constexpr uint64_t STATE_FILE_MAX_SIZE{4096};
+
+        Ctx* ctx;
+        State* state;
+        std::string database;
+        std::vector<bool> owned;
+        uint64_t members{0};
+
+        [[nodiscard]] std::string nodeName(const std::string& node) const;
+        [[nodiscard]] std::string partitionName(uint partition) const;
+        [[nodiscard]] bool readJson(const std::string& name, std::string& in) const;
+        void liveNodes(time_t now, std::vector<std::string>& nodes) const;
+
+    public:
+        const std::string node;
+        const uint partitions;
+        const uint64_t timeoutS;
+
+        PartitionCoordinator(Ctx* newCtx, State* newState, std::string newDatabase, std::string newNode, uint newPartitions,
+                             uint64_t newTimeoutS);
+        ~PartitionCoordinator();
+
+        void start(time_t now);
+        void heartbeat(time_t now);
+        // True when the partitions owned by this instance are different from the ones it runs with
+        [[nodiscard]] bool assign(time_t now);
+        [[nodiscard]] std::string describe() const;
+        // Oldest position confirmed for the owned partitions, false when none has a position yet
+        [[nodiscard]] bool startPosition(Scn& scn, typeResetlogs& resetlogs, typeActivation& activation) const;
+        void confirm(Scn scn, typeResetlogs resetlogs, typeActivation activation);
+
+        [[nodiscard]] static uint partitionOf(typeObj obj, uint partitions) {
+            // Fibonacci hashing, object ids of neighbouring tables are spread over the partitions
+            return static_cast<uint>((static_cast<uint64_t>(obj) * 0x9E3779B97F4A7C15ULL >> 32) % partitions);
+        }
+
+        [[nodiscard]] bool owns(typeObj obj) const {
+            return owned[partitionOf(obj, partitions)];
+        }
+    };
+}
+
+#endif
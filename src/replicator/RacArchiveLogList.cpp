@@ -0,0 +1,57 @@
+/* Archived log list shared by the instances of a RAC database
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include "RacArchiveLogList.h"
+#include "ReplicatorRacOnline.h"
+
+namespace OpenLogReplicator {
+    void RacArchiveLogList::list(ReplicatorRacOnline* replicator, int instId, Seq sequence, std::vector<ArchiveLog>& instArchiveLogs) {
+        std::unique_lock<std::mutex> const lck(mtx);
+        sequences[instId] = sequence;
+
+        if (fresh.find(instId) == fresh.end()) {
+            Seq minSequence = sequence;
+            for (const auto& [otherInstId, otherSequence]: sequences)
+                if (otherSequence < minSequence)
+                    minSequence = otherSequence;
+
+            std::vector<ArchiveLog> allArchiveLogs;
+            replicator->readAllArchiveLogs(minSequence, allArchiveLogs);
+
+            // Instances that never polled get nothing, their first poll would miss logs below the bound used here
+            archiveLogs.clear();
+            fresh.clear();
+            for (const auto& [otherInstId, otherSequence]: sequences) {
+                archiveLogs[otherInstId];
+                fresh.insert(otherInstId);
+            }
+            for (ArchiveLog& archiveLog: allArchiveLogs) {
+                auto it = archiveLogs.find(archiveLog.instId);
+                if (it != archiveLogs.end())
+                    it->second.push_back(std::move(archiveLog));
+            }
+        }
+
+        for (ArchiveLog& archiveLog: archiveLogs[instId])
+            if (archiveLog.sequence >= sequence)
+                instArchiveLogs.push_back(std::move(archiveLog));
+        archiveLogs.erase(instId);
+        fresh.erase(instId);
+    }
+}
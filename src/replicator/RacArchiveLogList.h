@@ -0,0 +1,50 @@
+/* Header for RacArchiveLogList class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef RAC_ARCHIVE_LOG_LIST_H_
+#define RAC_ARCHIVE_LOG_LIST_H_
+
+#include <map>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include "../common/types/Seq.h"
+#include "ReplicatorOnline.h"
+
+namespace OpenLogReplicator {
+    class ReplicatorRacOnline;
+
+    // Archived logs of all instances of one RAC database, read with one query for all redo threads.
+    // The replicator that polls first refreshes the list for every instance, the others take their rows from it,
+    // and query again only once they consumed the rows of the previous refresh
+    class RacArchiveLogList final {
+    protected:
+        std::mutex mtx;
+        // Lowest sequence still needed, per instance that polled at least once
+        std::map<int, Seq> sequences;
+        std::map<int, std::vector<ArchiveLog>> archiveLogs;
+        std::set<int> fresh;
+
+    public:
+        void list(ReplicatorRacOnline* replicator, int instId, Seq sequence, std::vector<ArchiveLog>& instArchiveLogs);
+    };
+}
+
+#endif
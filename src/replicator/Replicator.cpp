@@ -19,7 +19,9 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 
 #include <cerrno>
 #include <cstddef>
+#include <cstring>
 #include <dirent.h>
+#include <hv/HttpClient.h>
 #include <sys/stat.h>
 #include <thread>
 #include <unistd.h>
@@ -33,12 +35,30 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include "../common/exception/RuntimeException.h"
 #include "../common/types/Seq.h"
 #include "../metadata/Metadata.h"
+#include "../metadata/PositionIndex.h"
 #include "../metadata/RedoLog.h"
 #include "../metadata/Schema.h"
+#include "../parser/CatchUpDecoder.h"
+#include "../parser/LwnDecoder.h"
 #include "../parser/Parser.h"
+#include "../parser/RacCoordinator.h"
 #include "../parser/Transaction.h"
+#include "../parser/TransactionFlusher.h"
 #include "../reader/ReaderFilesystem.h"
+#include "../reader/ReaderObjectStore.h"
 #include "../reader/ReaderAsmFilesystem.h"
+#ifdef LINK_LIBRARY_OCI
+#include "../reader/ReaderAsmDatabase.h"
+#endif /* LINK_LIBRARY_OCI */
+#if defined(LINK_LIBRARY_ZSTD) || defined(LINK_LIBRARY_ZLIB)
+#include "../reader/ReaderCompressed.h"
+#endif
+#include "../reader/RedoCache.h"
+#include "../reader/RedoCopy.h"
+#ifdef LINK_LIBRARY_LIBURING
+#include "../reader/ReaderUring.h"
+#endif /* LINK_LIBRARY_LIBURING */
+#include "ArchiveWatcher.h"
 #include "Replicator.h"
 #include "ReplicatorRacOnline.h"
 namespace OpenLogReplicator {
@@ -56,12 +76,47 @@ namespace OpenLogReplicator {
     Replicator::~Replicator() {
         readerDropAll();
 
+        // After the readers, which close their copies when they finish
+        if (redoCopy != nullptr) {
+            redoCopy->stop();
+            ctx->finishThread(redoCopy);
+            delete redoCopy;
+            redoCopy = nullptr;
+        }
+
+        if (redoCache != nullptr) {
+            delete redoCache;
+            redoCache = nullptr;
+        }
+
+        if (positionIndex != nullptr) {
+            delete positionIndex;
+            positionIndex = nullptr;
+        }
+
+        if (lwnDecoderPool != nullptr) {
+            delete lwnDecoderPool;
+            lwnDecoderPool = nullptr;
+        }
+
+        if (transactionFlusher != nullptr) {
+            transactionFlusher->stop();
+            ctx->finishThread(transactionFlusher);
+            delete transactionFlusher;
+            transactionFlusher = nullptr;
+        }
+
         while (!archiveRedoQueue.empty()) {
             Parser* parser = archiveRedoQueue.top();
             archiveRedoQueue.pop();
             delete parser;
         }
 
+        if (archiveWatcher != nullptr) {
+            delete archiveWatcher;
+            archiveWatcher = nullptr;
+        }
+
         for (Parser* parser: onlineRedoSet)
             delete parser;
         onlineRedoSet.clear();
@@ -79,6 +134,15 @@ namespace OpenLogReplicator {
             archiveRedoQueue.pop();
             delete parser;
         }
+        // The watcher reports only files written later, the dropped ones are found again by the scan
+        archScanNeeded = true;
+    }
+
+    // Returns early when the archive watcher reports a change of the archive destination
+    void Replicator::archSleep(time_ut timeUs) {
+        if (archiveWatcher != nullptr && archiveWatcher->wait(timeUs))
+            return;
+        usleep(timeUs);
     }
 
     void Replicator::updateOnlineLogs() {
@@ -92,6 +156,10 @@ namespace OpenLogReplicator {
     }
 
     void Replicator::readerDropAll() {
+        // The decoders read from the readers
+        while (!archDecoders.empty())
+            archDecoderDrop(archDecoders.begin()->first);
+
         for (;;) {
             bool wakingUp = false;
             for (Reader* reader: readers) {
@@ -116,13 +184,55 @@ namespace OpenLogReplicator {
 
         archReader = nullptr;
         readers.clear();
+        archPrefetchReaders.clear();
+        archPrefetchIdle.clear();
+        archPrefetched.clear();
     }
 
     void Replicator::loadDatabaseMetadata() {
         archReader = readerCreate(0);
     }
 
+    // Start time or start SCN looked up in the position index, false when the index doesn't cover it. Within the log the parser
+    // skips the records before the first data SCN
+    bool Replicator::positionFromIndex() {
+        if (positionIndex == nullptr || metadata->startSequence != Seq::none())
+            return false;
+
+        if (!metadata->startTime.empty()) {
+            Time time;
+            Seq sequence;
+            Scn scn;
+            if (!PositionIndex::parseTime(metadata->startTime, time) || !positionIndex->findTime(metadata->resetlogs, time, sequence, scn))
+                return false;
+
+            metadata->firstDataScn = scn;
+            metadata->setSeqFileOffset(sequence, FileOffset::zero());
+            ctx->info(0, "position index: time " + metadata->startTime + " found in seq: " + sequence.toString() + ", first scn: " +
+                         scn.toString());
+            return true;
+        }
+
+        return positionSequenceFromIndex();
+    }
+
+    bool Replicator::positionSequenceFromIndex() {
+        if (positionIndex == nullptr || metadata->firstDataScn == Scn::none() || metadata->firstDataScn == Scn::zero())
+            return false;
+
+        Seq sequence;
+        if (!positionIndex->findScn(metadata->resetlogs, metadata->firstDataScn, sequence))
+            return false;
+
+        metadata->setSeqFileOffset(sequence, FileOffset::zero());
+        ctx->info(0, "position index: scn " + metadata->firstDataScn.toString() + " found in seq: " + sequence.toString());
+        return true;
+    }
+
     void Replicator::positionReader() {
+        if (positionFromIndex())
+            return;
+
         if (metadata->startSequence != Seq::none())
             metadata->setSeqFileOffset(metadata->startSequence, FileOffset::zero());
         else
@@ -142,6 +252,10 @@ namespace OpenLogReplicator {
         throw RuntimeException(10040, "schema file missing");
     }
 
+    void Replicator::createSnapshot() {
+        // Nothing for offline mode
+    }
+
     void Replicator::updateOnlineRedoLogData() {
         int64_t lastGroup = -1;
         Reader* onlineReader = nullptr;
@@ -166,8 +280,26 @@ namespace OpenLogReplicator {
         }
 
         try {
+            if (ctx->parserThreads > 0 && lwnDecoderPool == nullptr) {
+                lwnDecoderPool = new LwnDecoderPool(ctx, alias, ctx->parserThreads);
+                lwnDecoderPool->initialize();
+            }
+
+            if (ctx->commitFlushQueue > 0 && transactionFlusher == nullptr) {
+                transactionFlusher = new TransactionFlusher(ctx, alias + "-flusher", builder, metadata, transactionBuffer, ctx->commitFlushQueue);
+                ctx->spawnThread(transactionFlusher);
+            }
+
             metadata->waitForWriter(ctx->parserThread);
 
+            // The shards of a batch source see only parts of the sequence range
+            if (ctx->positionCatalog && positionIndex == nullptr && shardCoordinator == nullptr) {
+                // Sequences are numbered per thread, every RAC instance has its own catalog
+                const std::string prefix = racCoordinator != nullptr ? database + "_" + std::to_string(racInstance) : database;
+                positionIndex = new PositionIndex(ctx, metadata->state, prefix + "-positions");
+                positionIndex->load();
+            }
+
             loadDatabaseMetadata();
             metadata->readCheckpoints();
             if (!ctx->isFlagSet(Ctx::REDO_FLAGS::ARCH_ONLY))
@@ -236,6 +368,13 @@ namespace OpenLogReplicator {
                 metadata->setStatusReplicate(this);
             } while (metadata->status != Metadata::STATUS::REPLICATE);
 
+            // Transactions persisted with the checkpoint continue from their images
+            if (ctx->transactionPersistS > 0)
+                transactionBuffer->restore(metadata->schema->xmlCtxDefault, metadata->sequence, metadata->fileOffset);
+
+            // Rows present at the SCN of the schema go out before the changes made after it
+            createSnapshot();
+
             while (!ctx->softShutdown) {
                 bool logsProcessed = false;
 
@@ -248,7 +387,8 @@ namespace OpenLogReplicator {
                 if (ctx->softShutdown)
                     break;
 
-                if (!ctx->isFlagSet(Ctx::REDO_FLAGS::ARCH_ONLY))
+                // The relay serves only archived copies
+                if (!ctx->isFlagSet(Ctx::REDO_FLAGS::ARCH_ONLY) && ctx->relayUrl.empty())
                     logsProcessed |= processOnlineRedoLogs();
                 if (ctx->softShutdown)
                     break;
@@ -256,7 +396,7 @@ namespace OpenLogReplicator {
                 if (!logsProcessed) {
                     ctx->info(0, "no redo logs to process, waiting for new redo logs");
                     contextSet(CONTEXT::SLEEP);
-                    usleep(ctx->refreshIntervalUs);
+                    archSleep(ctx->refreshIntervalUs);
                     contextSet(CONTEXT::CPU);
                 }
             }
@@ -275,6 +415,9 @@ namespace OpenLogReplicator {
         }
 
         ctx->info(0, "Replicator for: " + database + " is shutting down");
+        // The other instances don't wait for this one any longer
+        if (racCoordinator != nullptr)
+            racCoordinator->finish(racInstance);
         transactionBuffer->purge();
 
         ctx->replicatorFinished = true;
@@ -289,21 +432,63 @@ namespace OpenLogReplicator {
 
     Reader* Replicator::readerCreate(int group) {
         for (Reader* reader: readers)
-            if (reader->getGroup() == group)
+            if (reader->getGroup() == group && archPrefetchReaders.find(reader) == archPrefetchReaders.end())
                 return reader;
 
+        return readerSpawn(group, alias + "-reader-" + std::to_string(group));
+    }
+
+    Reader* Replicator::readerSpawn(int group, const std::string& name) {
         auto* replicator_rac = dynamic_cast<ReplicatorRacOnline*>(this);
         Reader* readerFS;
-        if (replicator_rac->getAsm()) {
-            readerFS = new ReaderAsmFilesystem(ctx, alias + "-reader-" + std::to_string(group), database, group,
+#ifdef LINK_LIBRARY_OCI
+        if (ctx->asmDatabase) {
+            readerFS = new ReaderAsmDatabase(ctx, name, database, group,
+                                             metadata->dbBlockChecksum != "OFF" && metadata->dbBlockChecksum != "FALSE");
+        } else
+#endif /* LINK_LIBRARY_OCI */
+        if (replicator_rac != nullptr && replicator_rac->getAsm()) {
+            readerFS = new ReaderAsmFilesystem(ctx, name, database, group,
                                               metadata->dbBlockChecksum != "OFF" && metadata->dbBlockChecksum != "FALSE");
+        } else if ((ctx->objectStore || !ctx->relayUrl.empty()) && group == 0) {
+            readerFS = new ReaderObjectStore(ctx, name, database, group,
+                                             metadata->dbBlockChecksum != "OFF" && metadata->dbBlockChecksum != "FALSE");
+#if defined(LINK_LIBRARY_ZSTD) || defined(LINK_LIBRARY_ZLIB)
+        } else if (ctx->archCompressed && group == 0) {
+            readerFS = new ReaderCompressed(ctx, name, database, group,
+                                            metadata->dbBlockChecksum != "OFF" && metadata->dbBlockChecksum != "FALSE");
+#endif
+#ifdef LINK_LIBRARY_LIBURING
+        } else if (ctx->readIoUring) {
+            readerFS = new ReaderUring(ctx, name, database, group,
+                                       metadata->dbBlockChecksum != "OFF" && metadata->dbBlockChecksum != "FALSE", ctx->readQueueDepth);
+#endif /* LINK_LIBRARY_LIBURING */
         } else  {
-            readerFS = new ReaderFilesystem(ctx, alias + "-reader-" + std::to_string(group), database, group,
+            readerFS = new ReaderFilesystem(ctx, name, database, group,
                                               metadata->dbBlockChecksum != "OFF" && metadata->dbBlockChecksum != "FALSE");
         }
         readers.insert(readerFS);
         readerFS->initialize();
 
+        if (!ctx->redoCopyPath.empty()) {
+            if (redoCopy == nullptr) {
+                redoCopy = new RedoCopy(ctx, alias + "-redo-copy", ctx->redoCopyCompress ? RedoCopy::COMPRESSION::LZ4 : RedoCopy::COMPRESSION::NONE);
+                ctx->spawnThread(redoCopy);
+            }
+            readerFS->redoCopy = redoCopy;
+        }
+
+        if (!ctx->redoCachePath.empty()) {
+            if (redoCache == nullptr) {
+                // Sequences are numbered per thread, every RAC instance has its own files
+                const std::string prefix = racCoordinator != nullptr ? database + "_" + std::to_string(racInstance) : database;
+                redoCache = new RedoCache(ctx, alias + "-redo-cache", ctx->redoCachePath, prefix, ctx->redoCacheMaxMb * 1024 * 1024);
+                redoCache->start();
+            }
+            readerFS->redoCache = redoCache;
+        }
+        readerFS->positionIndex = positionIndex;
+
         ctx->spawnThread(readerFS);
         return readerFS;
     }
@@ -323,6 +508,14 @@ namespace OpenLogReplicator {
                 applyMapping(reader->fileName);
                 if (reader->checkRedoLog()) {
                     foundPath = true;
+                    reader->members.clear();
+                    for (const std::string& member: reader->paths) {
+                        std::string memberMapped(member);
+                        applyMapping(memberMapped);
+                        if (memberMapped != reader->fileName)
+                            reader->members.push_back(memberMapped);
+                    }
+
                     auto* parser = new Parser(ctx, builder, metadata, transactionBuffer,
                                              reader->getGroup(), reader->fileName);
 
@@ -354,11 +547,23 @@ namespace OpenLogReplicator {
     // %a - activation id
     // %d - database id
     // %h - some hash
-    Seq Replicator::getSequenceFromFileName(Replicator* replicator, const std::string& file) {
+    Seq Replicator::getSequenceFromFileName(Replicator* replicator, const std::string& fileCompressed) {
         Seq sequence{0};
         size_t i{};
         size_t j{};
 
+        // Suffix added by compression of the archived log
+        std::string file(fileCompressed);
+        if (replicator->ctx->archCompressed) {
+            for (const char* suffix: {".zst", ".gz"}) {
+                const size_t suffixLength = strlen(suffix);
+                if (file.length() > suffixLength && file.compare(file.length() - suffixLength, suffixLength, suffix) == 0) {
+                    file.resize(file.length() - suffixLength);
+                    break;
+                }
+            }
+        }
+
         while (i < replicator->metadata->logArchiveFormat.length() && j < file.length()) {
             if (replicator->metadata->logArchiveFormat[i] == '%') {
                 if (i + 1 >= replicator->metadata->logArchiveFormat.length()) {
@@ -473,6 +678,36 @@ namespace OpenLogReplicator {
 
         std::string mappedPath(replicator->metadata->dbRecoveryFileDest + "/" + replicator->metadata->context + "/archivelog");
         replicator->applyMapping(mappedPath);
+
+        if (replicator->archiveWatcher == nullptr)
+            replicator->archiveWatcher = new ArchiveWatcher(replicator->ctx);
+        replicator->archiveWatcher->watchRoot(mappedPath);
+
+        // Between the periodic scans only the files reported by the watcher are queued
+        const time_ut now = replicator->ctx->clock->getTimeUt();
+        std::vector<std::string> files;
+        const bool complete = replicator->archiveWatcher->collect(files);
+        if (replicator->archiveWatcher->active() && complete && !replicator->archScanNeeded && now - replicator->archScanTime < ARCH_SCAN_FALLBACK_US) {
+            for (const std::string& fileName: files) {
+                if (unlikely(replicator->ctx->isTraceSet(Ctx::TRACE::ARCHIVE_LIST)))
+                    replicator->ctx->logTrace(Ctx::TRACE::ARCHIVE_LIST, "watched file: " + fileName);
+
+                const Seq sequence = getSequenceFromFileName(replicator, fileName.substr(fileName.find_last_of('/') + 1));
+                if (sequence == Seq::zero() || sequence < replicator->metadata->sequence)
+                    continue;
+
+                auto* parser = new Parser(replicator->ctx, replicator->builder, replicator->metadata,
+                                          replicator->transactionBuffer, 0, fileName);
+                parser->firstScn = Scn::none();
+                parser->nextScn = Scn::none();
+                parser->sequence = sequence;
+                replicator->archiveRedoQueue.push(parser);
+            }
+            return;
+        }
+        replicator->archScanNeeded = false;
+        replicator->archScanTime = now;
+
         if (unlikely(replicator->ctx->isTraceSet(Ctx::TRACE::ARCHIVE_LIST)))
             replicator->ctx->logTrace(Ctx::TRACE::ARCHIVE_LIST, "checking path: " + mappedPath);
 
@@ -505,6 +740,7 @@ namespace OpenLogReplicator {
                 replicator->ctx->logTrace(Ctx::TRACE::ARCHIVE_LIST, "checking path: " + mappedPath + "/" + ent->d_name);
 
             const std::string mappedPathWithFile(mappedPath + "/" + ent->d_name);
+            replicator->archiveWatcher->watchDirectory(mappedPathWithFile);
             DIR* dir2 = opendir(mappedPathWithFile.c_str());
             if (dir2 == nullptr) {
                 closedir(dir);
@@ -551,12 +787,78 @@ namespace OpenLogReplicator {
         }
     }
 
+    // Logs copied by the relay instance, read from it by ReaderObjectStore with ranged requests
+    void Replicator::archGetLogRelay(Replicator* replicator) {
+        const Seq from = replicator->metadata->sequence == Seq::none() ? Seq::zero() : replicator->metadata->sequence;
+        hv::HttpClient client;
+        std::string body;
+        uint64_t size = 0;
+        const int httpStatus = ReaderObjectStore::request(replicator->ctx, &client, "GET", replicator->ctx->relayUrl,
+                                                          "from=" + from.toString(), "", body, size);
+        if (httpStatus != 200) {
+            replicator->ctx->warning(60059, "relay: " + replicator->ctx->relayUrl + " - list returned: " + std::to_string(httpStatus));
+            return;
+        }
+
+        rapidjson::Document document;
+        if (body.empty() || document.Parse(body.c_str()).HasParseError() || !document.IsObject() || !document.HasMember("logs") ||
+            !document["logs"].IsArray()) {
+            replicator->ctx->warning(60059, "relay: " + replicator->ctx->relayUrl + " - invalid list: " + body.substr(0, 256));
+            return;
+        }
+
+        const rapidjson::Value& logsJson = document["logs"];
+        for (rapidjson::SizeType i = 0; i < logsJson.Size(); ++i) {
+            const Seq sequence(Ctx::getJsonFieldU32(replicator->ctx->relayUrl, logsJson[i], "sequence"));
+            if (unlikely(replicator->ctx->isTraceSet(Ctx::TRACE::ARCHIVE_LIST)))
+                replicator->ctx->logTrace(Ctx::TRACE::ARCHIVE_LIST, "relay found seq: " + sequence.toString());
+
+            if (sequence == Seq::zero() || sequence < replicator->metadata->sequence)
+                continue;
+
+            auto* parser = new Parser(replicator->ctx, replicator->builder, replicator->metadata, replicator->transactionBuffer, 0,
+                                      replicator->ctx->relayUrl + "/" + sequence.toString());
+            parser->firstScn = Scn::none();
+            parser->nextScn = Scn::none();
+            parser->sequence = sequence;
+            replicator->archiveRedoQueue.push(parser);
+        }
+    }
+
     void Replicator::archGetLogList(Replicator* replicator) {
         Seq sequenceStart = Seq::none();
         for (const std::string& mappedPath: replicator->redoLogsBatch) {
             if (unlikely(replicator->ctx->isTraceSet(Ctx::TRACE::ARCHIVE_LIST)))
                 replicator->ctx->logTrace(Ctx::TRACE::ARCHIVE_LIST, "checking path: " + mappedPath);
 
+            // Object storage: a single object, or all objects under a prefix ending with '/'
+            if (replicator->ctx->objectStore && ReaderObjectStore::isUrl(mappedPath)) {
+                std::vector<std::string> objects;
+                if (mappedPath.back() != '/')
+                    objects.push_back(mappedPath);
+                else if (!ReaderObjectStore::listObjects(replicator->ctx, mappedPath, objects))
+                    continue;
+
+                for (const std::string& object: objects) {
+                    const Seq sequence = getSequenceFromFileName(replicator, object.substr(object.find_last_of('/') + 1));
+                    if (unlikely(replicator->ctx->isTraceSet(Ctx::TRACE::ARCHIVE_LIST)))
+                        replicator->ctx->logTrace(Ctx::TRACE::ARCHIVE_LIST, "object: " + object + " found seq: " + sequence.toString());
+
+                    if (sequence == Seq::zero() || sequence < replicator->metadata->sequence)
+                        continue;
+
+                    auto* parser = new Parser(replicator->ctx, replicator->builder, replicator->metadata,
+                                              replicator->transactionBuffer, 0, object);
+                    parser->firstScn = Scn::none();
+                    parser->nextScn = Scn::none();
+                    parser->sequence = sequence;
+                    replicator->archiveRedoQueue.push(parser);
+                    if (sequenceStart == Seq::none() || sequenceStart > sequence)
+                        sequenceStart = sequence;
+                }
+                continue;
+            }
+
             struct stat fileStat{};
             if (stat(mappedPath.c_str(), &fileStat) != 0) {
                 replicator->ctx->warning(10003, "file: " + mappedPath + " - get metadata returned: " + strerror(errno));
@@ -701,6 +1003,133 @@ namespace OpenLogReplicator {
                      startingSeq);
     }
 
+    void Replicator::archPrefetchStart() {
+        if (ctx->archPrefetch == 0)
+            return;
+
+        // Logs already passed are not going to be parsed
+        for (auto it = archPrefetched.begin(); it != archPrefetched.end();) {
+            if (it->second.first < metadata->sequence) {
+                archDecoderDrop(it->first);
+                archPrefetchIdle.push_back(it->second.second);
+                it = archPrefetched.erase(it);
+            } else
+                ++it;
+        }
+
+        // Look at the logs following the one being parsed
+        std::vector<Parser*> nextParsers;
+        while (!archiveRedoQueue.empty() && nextParsers.size() <= ctx->archPrefetch) {
+            nextParsers.push_back(archiveRedoQueue.top());
+            archiveRedoQueue.pop();
+        }
+        for (Parser* nextParser: nextParsers)
+            archiveRedoQueue.push(nextParser);
+
+        uint64_t bufferSize = (ctx->archPrefetchBufferMax > 0 ? ctx->archPrefetchBufferMax : ctx->bufferSizeMax / 4) / ctx->archPrefetch;
+        bufferSize = (bufferSize / Ctx::MEMORY_CHUNK_SIZE) * Ctx::MEMORY_CHUNK_SIZE;
+        if (bufferSize < Ctx::MEMORY_CHUNK_SIZE)
+            bufferSize = Ctx::MEMORY_CHUNK_SIZE;
+
+        Seq nextSequence = metadata->sequence;
+        ++nextSequence;
+        for (const Parser* nextParser: nextParsers) {
+            if (nextParser->sequence < nextSequence)
+                continue;
+            // Only a continuous run of logs is read ahead
+            if (nextParser->sequence != nextSequence)
+                break;
+            ++nextSequence;
+
+            if (archPrefetched.find(nextParser->path) != archPrefetched.end())
+                continue;
+
+            Reader* reader;
+            if (!archPrefetchIdle.empty()) {
+                reader = archPrefetchIdle.back();
+                archPrefetchIdle.pop_back();
+            } else if (archPrefetchReaders.size() < ctx->archPrefetch + 1) {
+                reader = readerSpawn(0, alias + "-reader-prefetch-" + std::to_string(archPrefetchReaders.size()));
+                archPrefetchReaders.insert(reader);
+            } else
+                break;
+
+            reader->setBufferSizeLimit(bufferSize);
+            reader->fileName = nextParser->path;
+            if (!reader->checkRedoLog() || !reader->updateRedoLog()) {
+                // Not ready yet, the log is opened again when it is its turn
+                archPrefetchIdle.push_back(reader);
+                continue;
+            }
+
+            if (unlikely(ctx->isTraceSet(Ctx::TRACE::REDO)))
+                ctx->logTrace(Ctx::TRACE::REDO, "reading ahead archived redo log: " + nextParser->path + ", seq: " +
+                                                nextParser->sequence.toString());
+            reader->setStatusRead();
+            archPrefetched.insert_or_assign(nextParser->path, std::make_pair(nextParser->sequence, reader));
+
+            // RAC instances are ordered LWN by LWN while parsing, and a dump needs the parser reading the blocks itself
+            if (archDecoders.size() < ctx->archParsers && racCoordinator == nullptr && ctx->dumpRedoLog == 0)
+                archDecoderStart(nextParser, reader);
+        }
+    }
+
+    // The log is read and decoded by a parser of its own, the parser of the log later only applies the decoded LWNs
+    void Replicator::archDecoderStart(const Parser* nextParser, Reader* reader) {
+        auto* decoderParser = new Parser(ctx, builder, metadata, transactionBuffer, 0, nextParser->path);
+        decoderParser->sequence = nextParser->sequence;
+        decoderParser->firstScn = nextParser->firstScn;
+        decoderParser->nextScn = nextParser->nextScn;
+        decoderParser->reader = reader;
+
+        auto* decoder = new CatchUpDecoder(ctx, alias + "-catch-up-" + nextParser->sequence.toString(), decoderParser);
+        archDecoders.insert_or_assign(nextParser->path, decoder);
+        ctx->spawnThread(decoder);
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::REDO)))
+            ctx->logTrace(Ctx::TRACE::REDO, "decoding ahead archived redo log: " + nextParser->path + ", seq: " + nextParser->sequence.toString());
+    }
+
+    // Stopped before its reader is used for another log
+    void Replicator::archDecoderDrop(const std::string& path) {
+        auto it = archDecoders.find(path);
+        if (it == archDecoders.end())
+            return;
+
+        CatchUpDecoder* decoder = it->second;
+        archDecoders.erase(it);
+        decoder->stop();
+        ctx->finishThread(decoder);
+        delete decoder;
+    }
+
+    Reader* Replicator::archPrefetchTake(Parser* parser) {
+        auto it = archPrefetched.find(parser->path);
+        if (it == archPrefetched.end())
+            return nullptr;
+
+        const Seq sequence = it->second.first;
+        Reader* reader = it->second.second;
+        archPrefetched.erase(it);
+
+        // The reader has started from the first block, a checkpoint position inside of the log needs a fresh one
+        if (sequence != parser->sequence || metadata->fileOffset > FileOffset::zero()) {
+            archDecoderDrop(parser->path);
+            archPrefetchIdle.push_back(reader);
+            return nullptr;
+        }
+
+        reader->setBufferSizeLimit(0);
+        auto decoderIt = archDecoders.find(parser->path);
+        if (decoderIt != archDecoders.end())
+            parser->catchUpDecoder = decoderIt->second;
+        return reader;
+    }
+
+    void Replicator::archPrefetchRelease(Reader* reader) {
+        if (archPrefetchReaders.find(reader) != archPrefetchReaders.end())
+            archPrefetchIdle.push_back(reader);
+    }
+
     bool Replicator::processArchivedRedoLogs() {
         Reader::REDO_CODE ret;
         Parser* parser;
@@ -718,7 +1147,7 @@ namespace OpenLogReplicator {
                         ctx->logTrace(Ctx::TRACE::ARCHIVE_LIST, "archived redo log missing for seq: " + metadata->sequence.toString() +
                                                                 ", sleeping");
                     contextSet(CONTEXT::SLEEP);
-                    usleep(ctx->archReadSleepUs);
+                    archSleep(ctx->archReadSleepUs);
                     contextSet(CONTEXT::CPU);
                 } else {
                     break;
@@ -750,11 +1179,18 @@ namespace OpenLogReplicator {
                     continue;
                 }
 
+                // Logs of the following shard
+                if (shardLast != Seq::none() && parser->sequence > shardLast) {
+                    archiveRedoQueue.pop();
+                    delete parser;
+                    continue;
+                }
+
                 if (parser->sequence > metadata->sequence) {
                     ctx->warning(60027, "couldn't find archive log for seq: " + metadata->sequence.toString() + ", found: " +
                                         parser->sequence.toString() + ", sleeping " + std::to_string(ctx->archReadSleepUs) + " us");
                     contextSet(CONTEXT::SLEEP);
-                    usleep(ctx->archReadSleepUs);
+                    archSleep(ctx->archReadSleepUs);
                     contextSet(CONTEXT::CPU);
                     cleanArchList();
                     archGetLog(this);
@@ -762,29 +1198,50 @@ namespace OpenLogReplicator {
                 }
 
                 logsProcessed = true;
-                parser->reader = archReader;
-
-                archReader->fileName = parser->path;
-                uint retry = ctx->archReadTries;
-
-                while (true) {
-                    if (archReader->checkRedoLog() && archReader->updateRedoLog()) {
-                        break;
+                parser->reader = archPrefetchTake(parser);
+
+                if (parser->reader == nullptr) {
+                    parser->reader = archReader;
+                    archReader->fileName = parser->path;
+                    uint retry = ctx->archReadTries;
+
+                    while (true) {
+                        if (archReader->checkRedoLog() && archReader->updateRedoLog()) {
+                            break;
+                        }
+
+                        if (retry == 0)
+                            throw RuntimeException(10009, "file: " + parser->path + " - failed to open after " +
+                                                          std::to_string(ctx->archReadTries) + " tries");
+
+                        ctx->info(0, "archived redo log " + parser->path + " is not ready for read, sleeping " +
+                                     std::to_string(ctx->archReadSleepUs) + " us");
+                        contextSet(CONTEXT::SLEEP);
+                        usleep(ctx->archReadSleepUs);
+                        contextSet(CONTEXT::CPU);
+                        --retry;
                     }
+                }
 
-                    if (retry == 0)
-                        throw RuntimeException(10009, "file: " + parser->path + " - failed to open after " +
-                                                      std::to_string(ctx->archReadTries) + " tries");
-
-                    ctx->info(0, "archived redo log " + parser->path + " is not ready for read, sleeping " +
-                                 std::to_string(ctx->archReadSleepUs) + " us");
-                    contextSet(CONTEXT::SLEEP);
-                    usleep(ctx->archReadSleepUs);
+                // Output of a shard begins with the first log of its range
+                if (parser->sequence == shardFirst && metadata->firstDataScn == Scn::none()) {
+                    contextSet(CONTEXT::MUTEX, REASON::REPLICATOR_ARCH);
+                    std::unique_lock<std::mutex> const lck(metadata->mtxCheckpoint);
+                    metadata->firstDataScn = Scn(parser->reader->getFirstScn().getData() - 1);
                     contextSet(CONTEXT::CPU);
-                    --retry;
                 }
 
+                archPrefetchStart();
+                parser->lwnDecoderPool = lwnDecoderPool;
+                parser->transactionFlusher = transactionFlusher;
+                parser->racCoordinator = racCoordinator;
+                parser->racInstance = racInstance;
                 ret = parser->parse();
+                if (parser->catchUpDecoder != nullptr) {
+                    archDecoderDrop(parser->path);
+                    parser->catchUpDecoder = nullptr;
+                }
+                archPrefetchRelease(parser->reader);
                 metadata->firstScn = parser->firstScn;
                 metadata->nextScn = parser->nextScn;
 
@@ -801,7 +1258,7 @@ namespace OpenLogReplicator {
                                                   std::to_string(static_cast<uint>(ret)));
                 }
 
-                // verifySchema(metadata->nextScn);
+                verifySchema(metadata->nextScn);
 
                 ++metadata->sequence;
                 archiveRedoQueue.pop();
@@ -891,6 +1348,10 @@ namespace OpenLogReplicator {
                 break;
             logsProcessed = true;
 
+            parser->lwnDecoderPool = lwnDecoderPool;
+            parser->transactionFlusher = transactionFlusher;
+            parser->racCoordinator = racCoordinator;
+            parser->racInstance = racInstance;
             const Reader::REDO_CODE ret = parser->parse();
             metadata->setFirstNextScn(parser->firstScn, parser->nextScn);
 
@@ -898,7 +1359,7 @@ namespace OpenLogReplicator {
                 break;
 
             if (ret == Reader::REDO_CODE::FINISHED) {
-                // verifySchema(metadata->nextScn);
+                verifySchema(metadata->nextScn);
                 metadata->setNextSequence();
             } else if (ret == Reader::REDO_CODE::STOPPED || ret == Reader::REDO_CODE::OK) {
                 if (unlikely(ctx->isTraceSet(Ctx::TRACE::REDO)))
@@ -21,6 +21,7 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #define REPLICATOR_H_
 
 #include <fstream>
+#include <map>
 #include <queue>
 #include <set>
 #include <unordered_map>
@@ -32,14 +33,23 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include "../common/exception/RedoLogException.h"
 
 namespace OpenLogReplicator {
+    class ArchiveWatcher;
+    class CatchUpDecoder;
     class Parser;
+    class PositionIndex;
     class Builder;
     class Metadata;
+    class LwnDecoderPool;
     class Reader;
     class RedoLogRecord;
     class State;
     class Transaction;
     class TransactionBuffer;
+    class RacCoordinator;
+    class RedoCache;
+    class ShardCoordinator;
+    class RedoCopy;
+    class TransactionFlusher;
 
     struct parserCompare {
         bool operator()(const Parser* p1, const Parser* p2);
@@ -47,6 +57,9 @@ namespace OpenLogReplicator {
 
     class Replicator : public Thread {
     protected:
+        // Interval of the full scan of the archive destination while the watcher reports new files
+        static constexpr time_ut ARCH_SCAN_FALLBACK_US{60000000};
+
         void (* archGetLog)(Replicator* replicator);
         Builder* builder;
         Metadata* metadata;
@@ -55,22 +68,53 @@ namespace OpenLogReplicator {
         std::string redoCopyPath;
         // Redo log files
         Reader* archReader{nullptr};
+        LwnDecoderPool* lwnDecoderPool{nullptr};
+        TransactionFlusher* transactionFlusher{nullptr};
+        RedoCopy* redoCopy{nullptr};
+        RedoCache* redoCache{nullptr};
+        PositionIndex* positionIndex{nullptr};
+        RacCoordinator* racCoordinator{nullptr};
+        uint racInstance{0};
+        ShardCoordinator* shardCoordinator{nullptr};
+        uint shard{0};
+        // Logs of the shard, the commits of the logs read before the first are not output
+        Seq shardFirst{Seq::none()};
+        Seq shardLast{Seq::none()};
         std::string lastCheckedDay;
+        ArchiveWatcher* archiveWatcher{nullptr};
+        time_ut archScanTime{0};
+        bool archScanNeeded{true};
         std::priority_queue<Parser*, std::vector<Parser*>, parserCompare> archiveRedoQueue;
         std::set<Parser*> onlineRedoSet;
         std::set<Reader*> readers;
+        // Spare readers reading the following archived redo logs ahead of the parser
+        std::set<Reader*> archPrefetchReaders;
+        std::vector<Reader*> archPrefetchIdle;
+        std::map<std::string, std::pair<Seq, Reader*>> archPrefetched;
+        // Decoders of the logs read ahead, including the one of the log being parsed
+        std::map<std::string, CatchUpDecoder*> archDecoders;
         std::vector<std::string> pathMapping;
         std::vector<std::string> redoLogsBatch;
 
         void cleanArchList();
+        void archSleep(time_ut timeUs);
         void updateOnlineLogs();
         void readerDropAll();
+        Reader* readerSpawn(int group, const std::string& name);
+        void archPrefetchStart();
+        Reader* archPrefetchTake(Parser* parser);
+        void archPrefetchRelease(Reader* reader);
+        void archDecoderStart(const Parser* nextParser, Reader* reader);
+        void archDecoderDrop(const std::string& path);
+        bool positionFromIndex();
+        bool positionSequenceFromIndex();
         static Seq getSequenceFromFileName(Replicator* replicator, const std::string& file);
         virtual std::string getModeName() const;
         virtual bool checkConnection();
         virtual bool continueWithOnline();
         virtual void verifySchema(Scn currentScn);
         virtual void createSchema();
+        virtual void createSnapshot();
         virtual void updateOnlineRedoLogData();
 
     public:
@@ -89,6 +133,7 @@ namespace OpenLogReplicator {
         void addRedoLogsBatch(std::string path);
         static void archGetLogPath(Replicator* replicator);
         static void archGetLogList(Replicator* replicator);
+        static void archGetLogRelay(Replicator* replicator);
         void applyMapping(std::string& path);
         void updateResetlogs();
         void wakeUp() override;
@@ -20,7 +20,10 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include "../common/exception/RuntimeException.h"
 #include "../metadata/Metadata.h"
 #include "../metadata/Schema.h"
+#include "../parser/Parser.h"
+#include "../parser/RedoProfile.h"
 #include "ReplicatorBatch.h"
+#include "ShardCoordinator.h"
 
 namespace OpenLogReplicator {
     ReplicatorBatch::ReplicatorBatch(Ctx* newCtx, void (* newArchGetLog)(Replicator* replicator), Builder* newBuilder, Metadata* newMetadata,
@@ -28,7 +31,22 @@ namespace OpenLogReplicator {
             Replicator(newCtx, newArchGetLog, newBuilder, newMetadata, newTransactionBuffer, std::move(newAlias), std::move(newDatabase)) {
     }
 
+    ReplicatorBatch::~ReplicatorBatch() {
+        if (ctx->redoProfile != nullptr) {
+            delete ctx->redoProfile;
+            ctx->redoProfile = nullptr;
+        }
+    }
+
     void ReplicatorBatch::positionReader() {
+        if (shardCoordinator != nullptr) {
+            positionShard();
+            return;
+        }
+
+        if (positionFromIndex())
+            return;
+
         if (metadata->startSequence != Seq::none())
             metadata->setSeqFileOffset(metadata->startSequence, FileOffset::zero());
         else
@@ -36,6 +54,40 @@ namespace OpenLogReplicator {
         metadata->sequence = 0;
     }
 
+    // All logs are listed up front, the shard reads its range and the logs just before it
+    void ReplicatorBatch::positionShard() {
+        metadata->setSeqFileOffset(Seq::zero(), FileOffset::zero());
+        archGetLog(this);
+
+        std::vector<Seq> sequences;
+        auto queue = archiveRedoQueue;
+        while (!queue.empty()) {
+            const Seq sequence = queue.top()->sequence;
+            queue.pop();
+            if (metadata->startSequence != Seq::none() && sequence < metadata->startSequence)
+                continue;
+            if (sequences.empty() || sequences.back() != sequence)
+                sequences.push_back(sequence);
+        }
+
+        Seq start;
+        if (!shardCoordinator->range(shard, sequences, shardFirst, shardLast, start)) {
+            while (!archiveRedoQueue.empty()) {
+                delete archiveRedoQueue.top();
+                archiveRedoQueue.pop();
+            }
+            metadata->setSeqFileOffset(Seq::zero(), FileOffset::zero());
+            return;
+        }
+
+        metadata->setSeqFileOffset(start, FileOffset::zero());
+        // Transactions committed before the first log of the range belong to the previous shard
+        if (start != shardFirst)
+            metadata->firstDataScn = Scn::none();
+        ctx->info(0, "shard " + std::to_string(shard) + ": reading from seq: " + start.toString() + ", output from seq: " +
+                     shardFirst.toString() + " to seq: " + shardLast.toString());
+    }
+
     void ReplicatorBatch::createSchema() {
         if (ctx->isFlagSet(Ctx::REDO_FLAGS::SCHEMALESS))
             return;
@@ -56,6 +108,14 @@ namespace OpenLogReplicator {
     }
 
     bool ReplicatorBatch::continueWithOnline() {
+        if (shardCoordinator != nullptr && !shardCoordinator->finish()) {
+            ctx->info(0, "finished batch processing of shard " + std::to_string(shard) + ", waiting for other shards");
+            return false;
+        }
+
+        if (ctx->redoProfile != nullptr)
+            ctx->redoProfile->write(metadata);
+
         ctx->info(0, "finished batch processing, exiting");
         ctx->stopSoft();
         return false;
@@ -28,13 +28,14 @@ namespace OpenLogReplicator {
         std::string getModeName() const override;
         bool continueWithOnline() override;
         void positionReader() override;
+        void positionShard();
         void createSchema() override;
         void updateOnlineRedoLogData() override;
 
     public:
         ReplicatorBatch(Ctx* newCtx, void (* newArchGetLog)(Replicator* replicator), Builder* newBuilder, Metadata* newMetadata,
                         TransactionBuffer* newTransactionBuffer, std::string newAlias, std::string newDatabase);
-        ~ReplicatorBatch() override = default;
+        ~ReplicatorBatch() override;
     };
 }
 
@@ -18,7 +18,9 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 <http://www.gnu.org/licenses/>.  */
 
 #include <algorithm>
+#include <atomic>
 #include <regex>
+#include <thread>
 #include <unistd.h>
 
 #include "../builder/Builder.h"
@@ -27,6 +29,7 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include "../common/DbTable.h"
 #include "../common/XmlCtx.h"
 #include "../common/exception/BootException.h"
+#include "../common/exception/DataException.h"
 #include "../common/exception/RuntimeException.h"
 #include "../common/table/SysCCol.h"
 #include "../common/table/SysCDef.h"
@@ -59,6 +62,73 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include "ReplicatorOnline.h"
 
 namespace OpenLogReplicator {
+    DictionaryJob::DictionaryJob(typeUser newUser, typeObj newObj) :
+            user(newUser),
+            obj(newObj) {
+    }
+
+    DictionaryJob::~DictionaryJob() {
+        // Rows not yet handed over to a schema
+        for (auto* row: sysCCols)
+            delete row;
+        for (auto* row: sysCDefs)
+            delete row;
+        for (auto* row: sysCols)
+            delete row;
+        for (auto* row: sysDeferredStgs)
+            delete row;
+        for (auto* row: sysECols)
+            delete row;
+        for (auto* row: sysLobs)
+            delete row;
+        for (auto* row: sysLobCompParts)
+            delete row;
+        for (auto* row: sysLobFrags)
+            delete row;
+        for (auto* row: sysTabs)
+            delete row;
+        for (auto* row: sysTabComParts)
+            delete row;
+        for (auto* row: sysTabParts)
+            delete row;
+        for (auto* row: sysTabSubParts)
+            delete row;
+    }
+
+    SchemaVerifier::SchemaVerifier(Ctx* newCtx, std::string newAlias, ReplicatorOnline* newReplicator) :
+            Thread(newCtx, std::move(newAlias)),
+            replicator(newReplicator) {
+    }
+
+    SchemaVerifier::~SchemaVerifier() {
+        delete conn;
+        conn = nullptr;
+    }
+
+    void SchemaVerifier::wakeUp() {
+        replicator->verifierWakeUp();
+    }
+
+    void SchemaVerifier::run() {
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
+            std::ostringstream ss;
+            ss << std::this_thread::get_id();
+            ctx->logTrace(Ctx::TRACE::THREADS, "schema verifier (" + ss.str() + ") start");
+        }
+
+        try {
+            replicator->verifierRun(this);
+        } catch (std::bad_alloc& ex) {
+            ctx->error(10018, "memory allocation failed: " + std::string(ex.what()));
+            ctx->stopHard();
+        }
+
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
+            std::ostringstream ss;
+            ss << std::this_thread::get_id();
+            ctx->logTrace(Ctx::TRACE::THREADS, "schema verifier (" + ss.str() + ") stop");
+        }
+    }
 
     ReplicatorOnline::ReplicatorOnline(Ctx* newCtx, void (* newArchGetLog)(Replicator* replicator), Builder* newBuilder, Metadata* newMetadata,
                                        TransactionBuffer* newTransactionBuffer, std::string newAlias, std::string newDatabase, std::string newUser,
@@ -72,6 +142,17 @@ namespace OpenLogReplicator {
     }
 
     ReplicatorOnline::~ReplicatorOnline() {
+        if (schemaVerifier != nullptr) {
+            {
+                std::unique_lock<std::mutex> const lck(mtxVerify);
+                verifyStop = true;
+                condVerify.notify_all();
+            }
+            ctx->finishThread(schemaVerifier);
+            delete schemaVerifier;
+            schemaVerifier = nullptr;
+        }
+
         if (conn != nullptr) {
             delete conn;
             conn = nullptr;
@@ -273,7 +354,7 @@ namespace OpenLogReplicator {
             metadata->setSeqFileOffset(metadata->startSequence, FileOffset::zero());
             if (metadata->firstDataScn == Scn::none())
                 metadata->firstDataScn = 0;
-        } else {
+        } else if (!positionSequenceFromIndex()) {
             DatabaseStatement stmt(conn);
             std::string sql;
             if (standby) {
@@ -456,30 +537,102 @@ namespace OpenLogReplicator {
         }
     }
 
+    // Only requests the verification, the dictionaries are read by the verifier session. Requests made while a verification runs or
+    // earlier than the interval after the last one are dropped
     void ReplicatorOnline::verifySchema(Scn currentScn) {
-        if (!ctx->isFlagSet(Ctx::REDO_FLAGS::VERIFY_SCHEMA))
+        if (!ctx->isFlagSet(Ctx::REDO_FLAGS::VERIFY_SCHEMA) || currentScn == Scn::none())
             return;
-        if (!checkConnection())
+
+        if (schemaVerifier == nullptr) {
+            schemaVerifier = new SchemaVerifier(ctx, alias, this);
+            schemaVerifier->conn = new DatabaseConnection(env, conn->user, conn->password, conn->connectString, false);
+            ctx->spawnThread(schemaVerifier);
+        }
+
+        const time_ut now = ctx->clock->getTimeUt();
+        std::unique_lock<std::mutex> const lck(mtxVerify);
+        if (verifyScn != Scn::none() || (verifyTime != 0 && now - verifyTime < static_cast<time_ut>(ctx->schemaVerifyIntervalS) * 1000000))
             return;
+        verifyScn = currentScn;
+        condVerify.notify_all();
+    }
+
+    void ReplicatorOnline::verifierWakeUp() {
+        std::unique_lock<std::mutex> const lck(mtxVerify);
+        condVerify.notify_all();
+    }
+
+    void ReplicatorOnline::verifierRun(SchemaVerifier* verifier) {
+        while (!ctx->softShutdown) {
+            Scn targetScn;
+            {
+                std::unique_lock<std::mutex> lck(mtxVerify);
+                while (!verifyStop && !ctx->softShutdown && verifyScn == Scn::none()) {
+                    verifier->contextSet(Thread::CONTEXT::WAIT, Thread::REASON::NONE);
+                    condVerify.wait(lck);
+                }
+                verifier->contextSet(Thread::CONTEXT::CPU);
+                if (verifyStop || ctx->softShutdown)
+                    break;
+                targetScn = verifyScn;
+            }
+
+            if (!verifier->conn->connected) {
+                try {
+                    verifier->conn->connect();
+                } catch (RuntimeException& ex) {
+                    ctx->warning(60057, "schema verification connection failed: " + ex.msg);
+                }
+            }
 
-        ctx->info(0, "verifying schema for SCN: " + currentScn.toString());
+            if (verifier->conn->connected)
+                verifySchemaAt(verifier->conn, targetScn);
+
+            std::unique_lock<std::mutex> const lck(mtxVerify);
+            verifyScn = Scn::none();
+            verifyTime = ctx->clock->getTimeUt();
+        }
+    }
+
+    // Compared with the schema built from redo only when no schema change was applied after targetScn
+    void ReplicatorOnline::verifySchemaAt(DatabaseConnection* connection, Scn targetScn) {
+        ctx->info(0, "verifying schema for SCN: " + targetScn.toString());
 
         Schema otherSchema(ctx, metadata->locales);
         try {
-            readSystemDictionariesMetadata(&otherSchema, currentScn);
+            readSystemDictionariesMetadata(connection, &otherSchema, targetScn);
             for (const SchemaElement* element: metadata->schemaElements)
-                readSystemDictionaries(&otherSchema, currentScn, element->owner, element->table, element->options);
-            std::string errMsg;
-            const bool result = metadata->schema->compare(&otherSchema, errMsg);
-            if (result) {
-                ctx->warning(70000, "schema incorrect: " + errMsg);
-            }
-        } catch (RuntimeException& e) {
-            ctx->error(e.code, e.msg);
-        } catch (std::bad_alloc& ex) {
-            ctx->error(10018, "memory allocation failed: " + std::string(ex.what()));
-            ctx->stopHard();
+                readSystemDictionaries(connection, &otherSchema, targetScn, element->owner, element->table, element->options);
+        } catch (DataException& ex) {
+            ctx->warning(60057, "schema verification for SCN: " + targetScn.toString() + " failed: " + ex.msg);
+            return;
+        } catch (RuntimeException& ex) {
+            ctx->warning(60057, "schema verification for SCN: " + targetScn.toString() + " failed: " + ex.msg);
+            connection->disconnect();
+            return;
         }
+
+        std::string errMsg;
+        bool result;
+        {
+            std::unique_lock<std::mutex> const lck(metadata->mtxSchema);
+            if (metadata->schema->scn != Scn::none() && metadata->schema->scn > targetScn) {
+                if (unlikely(ctx->isTraceSet(Ctx::TRACE::SYSTEM)))
+                    ctx->logTrace(Ctx::TRACE::SYSTEM, "schema changed at SCN: " + metadata->schema->scn.toString() + ", verification for SCN: " +
+                                                      targetScn.toString() + " skipped");
+                return;
+            }
+            result = metadata->schema->compare(&otherSchema, errMsg);
+        }
+
+        if (!result) {
+            verifyMismatch.clear();
+            return;
+        }
+        if (errMsg == verifyMismatch)
+            return;
+        verifyMismatch = errMsg;
+        ctx->warning(70000, "schema incorrect: " + errMsg);
     }
 
     void ReplicatorOnline::createSchema() {
@@ -488,6 +641,11 @@ namespace OpenLogReplicator {
 
         ctx->info(0, "reading dictionaries for scn: " + metadata->firstDataScn.toString());
 
+        // The rows read depend on the tables only, sources started together at the same SCN read them once
+        std::string key("bootstrap-" + metadata->database + "-" + metadata->firstDataScn.toString());
+        for (const SchemaElement* element: metadata->schemaElements)
+            key.append("-" + element->owner + "." + element->table + ":" + std::to_string(static_cast<uint>(element->options)));
+
         std::unordered_map<typeObj, std::string> tablesUpdated;
         {
             contextSet(CONTEXT::MUTEX, REASON::REPLICATOR_SCHEMA);
@@ -496,30 +654,41 @@ namespace OpenLogReplicator {
             metadata->schema->purgeDicts();
             metadata->schema->scn = metadata->firstDataScn;
             metadata->firstSchemaScn = metadata->firstDataScn;
-            readSystemDictionariesMetadata(metadata->schema, metadata->firstDataScn);
+            const bool adopted = metadata->schema->adoptDict(key);
+            if (!adopted)
+                readSystemDictionariesMetadata(conn, metadata->schema, metadata->firstDataScn);
 
             for (const SchemaElement* element: metadata->schemaElements)
                 createSchemaForTable(metadata->firstDataScn, element->owner, element->table, element->keyList, element->key, element->tagType,
-                                     element->tagList, element->tag, element->condition, element->options, tablesUpdated);
+                                     element->tagList, element->tag, element->condition, element->columnList, element->skipColumnList,
+                                     element->options, tablesUpdated, !adopted);
             metadata->schema->resetTouched();
+            if (!adopted)
+                metadata->schema->shareDict(key);
+
+            for (const SchemaElement* element: metadata->schemaElements)
+                if (element->snapshot)
+                    snapshotPending = true;
 
             if (unlikely(metadata->ctx->isTraceSet(Ctx::TRACE::CHECKPOINT)))
                 metadata->ctx->logTrace(Ctx::TRACE::CHECKPOINT, "schema creation completed, allowing checkpoints");
             metadata->allowCheckpoints();
         }
         contextSet(CONTEXT::CPU);
+        RuntimeStats::set<uint64_t>(ctx->stats.bootstrapScn, metadata->firstDataScn.getData());
 
         for (const auto& [_, tableName]: tablesUpdated)
             ctx->info(0, "- found: " + tableName);
     }
 
-    void ReplicatorOnline::readSystemDictionariesMetadata(Schema* schema, Scn targetScn) {
+    void ReplicatorOnline::readSystemDictionariesMetadata(DatabaseConnection* connection, Schema* schema, Scn targetScn) {
+        schema->dictForUpdate();
         if (unlikely(ctx->isTraceSet(Ctx::TRACE::REDO)))
             ctx->logTrace(Ctx::TRACE::REDO, "reading metadata");
 
         try {
             // Reading SYS.TS$
-            DatabaseStatement sysTsStmt(conn);
+            DatabaseStatement sysTsStmt(connection);
             if (unlikely(ctx->isTraceSet(Ctx::TRACE::SQL))) {
                 ctx->logTrace(Ctx::TRACE::SQL, std::string(SQL_GET_SYS_TS));
                 ctx->logTrace(Ctx::TRACE::SQL, "PARAM1: " + targetScn.toString());
@@ -537,12 +706,12 @@ namespace OpenLogReplicator {
 
             int sysTsRet = sysTsStmt.executeQuery();
             while (sysTsRet != 0) {
-                schema->sysTsPack.addWithKeys(ctx, new SysTs(RowId(sysTsRowidStr), sysTsTs, sysTsName.data(), sysTsBlockSize));
+                schema->dict->sysTsPack.addWithKeys(ctx, new SysTs(RowId(sysTsRowidStr), sysTsTs, sysTsName.data(), sysTsBlockSize));
                 sysTsRet = sysTsStmt.next();
             }
 
             // Reading XDB.XDB$TTSET
-            DatabaseStatement xdbTtSetStmt(conn);
+            DatabaseStatement xdbTtSetStmt(connection);
             if (unlikely(ctx->isTraceSet(Ctx::TRACE::SQL))) {
                 ctx->logTrace(Ctx::TRACE::SQL, std::string(SQL_GET_XDB_TTSET));
                 ctx->logTrace(Ctx::TRACE::SQL, "PARAM1: " + targetScn.toString());
@@ -562,12 +731,12 @@ namespace OpenLogReplicator {
 
             int xdbTtSetRet = xdbTtSetStmt.executeQuery();
             while (xdbTtSetRet != 0) {
-                schema->xdbTtSetPack.addWithKeys(ctx, new XdbTtSet(RowId(xdbTtSetRowidStr), xdbTtSetGuid.data(), xdbTtSetTokSuf.data(), xdbTtSetFlags,
+                schema->dict->xdbTtSetPack.addWithKeys(ctx, new XdbTtSet(RowId(xdbTtSetRowidStr), xdbTtSetGuid.data(), xdbTtSetTokSuf.data(), xdbTtSetFlags,
                                                                    xdbTtSetObj));
                 xdbTtSetRet = xdbTtSetStmt.next();
             }
 
-            for (const auto& [_, xdbTtSet]: schema->xdbTtSetPack.mapRowId) {
+            for (const auto& [_, xdbTtSet]: schema->dict->xdbTtSetPack.mapRowId) {
                 auto* xmlCtx = new XmlCtx(ctx, xdbTtSet->tokSuf, xdbTtSet->flags);
                 schema->schemaXmlMap.insert_or_assign(xdbTtSet->tokSuf, xmlCtx);
 
@@ -580,7 +749,7 @@ namespace OpenLogReplicator {
                 checkTableForGrantsFlashback(tableName, targetScn);
 
                 // Reading XDB.X$NMxxxx
-                DatabaseStatement xdbXNmStmt(conn);
+                DatabaseStatement xdbXNmStmt(connection);
                 const std::string SQL_GET_XDB_XNM = "SELECT"
                                                     "   T.ROWID, T.NMSPCURI, T.ID "
                                                     " FROM"
@@ -605,7 +774,7 @@ namespace OpenLogReplicator {
                 }
 
                 // Reading XDB.X$PTxxxx
-                DatabaseStatement xdbXPtStmt(conn);
+                DatabaseStatement xdbXPtStmt(connection);
                 const std::string SQL_GET_XDB_XPT = "SELECT"
                                                     "   T.ROWID, T.PATH, T.ID "
                                                     " FROM"
@@ -630,7 +799,7 @@ namespace OpenLogReplicator {
                 }
 
                 // Reading XDB.X$QNxxxx
-                DatabaseStatement xdbXQnStmt(conn);
+                DatabaseStatement xdbXQnStmt(connection);
                 const std::string SQL_GET_XDB_XQN = "SELECT"
                                                     "   T.ROWID, T.NMSPCID, T.LOCALNAME, T.FLAGS, T.ID "
                                                     " FROM"
@@ -667,12 +836,14 @@ namespace OpenLogReplicator {
         }
     }
 
-    void ReplicatorOnline::readSystemDictionariesDetails(Schema* schema, Scn targetScn, typeUser user, typeObj obj) {
+    void ReplicatorOnline::fetchSystemDictionariesDetails(DatabaseConnection* connection, Scn targetScn, DictionaryJob* job) {
+        typeUser user = job->user;
+        typeObj obj = job->obj;
         if (unlikely(ctx->isTraceSet(Ctx::TRACE::REDO)))
             ctx->logTrace(Ctx::TRACE::REDO, "read dictionaries for user: " + std::to_string(user) + ", object: " + std::to_string(obj));
 
         // Reading SYS.CCOL$
-        DatabaseStatement sysCColStmt(conn);
+        DatabaseStatement sysCColStmt(connection);
         if (obj != 0) {
             if (unlikely(ctx->isTraceSet(Ctx::TRACE::SQL))) {
                 ctx->logTrace(Ctx::TRACE::SQL, std::string(SQL_GET_SYS_CCOL_OBJ));
@@ -708,17 +879,17 @@ namespace OpenLogReplicator {
         uint64_t sysCColSpare12 = 0;
         sysCColStmt.defineUInt(6, sysCColSpare12);
 
+        sysCColStmt.setPrefetchRows(ctx->dictionaryPrefetchRows);
         int sysCColRet = sysCColStmt.executeQuery();
         while (sysCColRet != 0) {
-            schema->sysCColPack.addWithKeys(ctx, new SysCCol(RowId(sysCColRowidStr), sysCColCon, sysCColIntCol, sysCColObj, sysCColSpare11, sysCColSpare12));
-            schema->touchTable(sysCColObj);
+            job->sysCCols.push_back(new SysCCol(RowId(sysCColRowidStr), sysCColCon, sysCColIntCol, sysCColObj, sysCColSpare11, sysCColSpare12));
             sysCColSpare11 = 0;
             sysCColSpare12 = 0;
             sysCColRet = sysCColStmt.next();
         }
 
         // Reading SYS.CDEF$
-        DatabaseStatement sysCDefStmt(conn);
+        DatabaseStatement sysCDefStmt(connection);
         if (obj != 0) {
             if (unlikely(ctx->isTraceSet(Ctx::TRACE::SQL))) {
                 ctx->logTrace(Ctx::TRACE::SQL, std::string(SQL_GET_SYS_CDEF_OBJ));
@@ -750,15 +921,15 @@ namespace OpenLogReplicator {
         uint sysCDefType;
         sysCDefStmt.defineUInt(4, sysCDefType);
 
+        sysCDefStmt.setPrefetchRows(ctx->dictionaryPrefetchRows);
         int sysCDefRet = sysCDefStmt.executeQuery();
         while (sysCDefRet != 0) {
-            schema->sysCDefPack.addWithKeys(ctx, new SysCDef(RowId(sysCDefRowidStr), sysCDefCon, sysCDefObj, static_cast<SysCDef::CDEFTYPE>(sysCDefType)));
-            schema->touchTable(sysCDefObj);
+            job->sysCDefs.push_back(new SysCDef(RowId(sysCDefRowidStr), sysCDefCon, sysCDefObj, static_cast<SysCDef::CDEFTYPE>(sysCDefType)));
             sysCDefRet = sysCDefStmt.next();
         }
 
         // Reading SYS.COL$
-        DatabaseStatement sysColStmt(conn);
+        DatabaseStatement sysColStmt(connection);
         if (obj != 0) {
             if (unlikely(ctx->isTraceSet(Ctx::TRACE::SQL))) {
                 ctx->logTrace(Ctx::TRACE::SQL, std::string(SQL_GET_SYS_COL_OBJ));
@@ -812,12 +983,12 @@ namespace OpenLogReplicator {
         uint64_t sysColProperty2;
         sysColStmt.defineUInt(15, sysColProperty2);
 
+        sysColStmt.setPrefetchRows(ctx->dictionaryPrefetchRows);
         int sysColRet = sysColStmt.executeQuery();
         while (sysColRet != 0) {
-            schema->sysColPack.addWithKeys(ctx, new SysCol(RowId(sysColRowidStr), sysColObj, sysColCol, sysColSegCol, sysColIntCol, sysColName.data(),
-                                                           static_cast<SysCol::COLTYPE>(sysColType), sysColLength, sysColPrecision, sysColScale,
-                                                           sycColCharsetForm, sysColCharsetId, sysColNull, sysColProperty1, sysColProperty2));
-            schema->touchTable(sysColObj);
+            job->sysCols.push_back(new SysCol(RowId(sysColRowidStr), sysColObj, sysColCol, sysColSegCol, sysColIntCol, sysColName.data(),
+                                              static_cast<SysCol::COLTYPE>(sysColType), sysColLength, sysColPrecision, sysColScale,
+                                              sycColCharsetForm, sysColCharsetId, sysColNull, sysColProperty1, sysColProperty2));
             sysColPrecision = -1;
             sysColScale = -1;
             sycColCharsetForm = 0;
@@ -826,7 +997,7 @@ namespace OpenLogReplicator {
         }
 
         // Reading SYS.DEFERRED_STG$
-        DatabaseStatement sysDeferredStgStmt(conn);
+        DatabaseStatement sysDeferredStgStmt(connection);
         if (obj != 0) {
             if (unlikely(ctx->isTraceSet(Ctx::TRACE::SQL))) {
                 ctx->logTrace(Ctx::TRACE::SQL, std::string(SQL_GET_SYS_DEFERRED_STG_OBJ));
@@ -858,18 +1029,18 @@ namespace OpenLogReplicator {
         uint64_t sysDeferredStgFlagsStg2 = 0;
         sysDeferredStgStmt.defineUInt(4, sysDeferredStgFlagsStg2);
 
+        sysDeferredStgStmt.setPrefetchRows(ctx->dictionaryPrefetchRows);
         int sysDeferredStgRet = sysDeferredStgStmt.executeQuery();
         while (sysDeferredStgRet != 0) {
-            schema->sysDeferredStgPack.addWithKeys(ctx, new SysDeferredStg(RowId(sysDeferredStgRowidStr), sysDeferredStgObj,
-                                                                           sysDeferredStgFlagsStg1, sysDeferredStgFlagsStg2));
-            schema->touchTable(sysDeferredStgObj);
+            job->sysDeferredStgs.push_back(new SysDeferredStg(RowId(sysDeferredStgRowidStr), sysDeferredStgObj,
+                                                              sysDeferredStgFlagsStg1, sysDeferredStgFlagsStg2));
             sysDeferredStgFlagsStg1 = 0;
             sysDeferredStgFlagsStg2 = 0;
             sysDeferredStgRet = sysDeferredStgStmt.next();
         }
 
         // Reading SYS.ECOL$
-        DatabaseStatement sysEColStmt(conn);
+        DatabaseStatement sysEColStmt(connection);
         if (ctx->version12) {
             if (obj != 0) {
                 if (unlikely(ctx->isTraceSet(Ctx::TRACE::SQL))) {
@@ -925,17 +1096,17 @@ namespace OpenLogReplicator {
         typeCol sysEColGuardId = -1;
         sysEColStmt.defineInt(4, sysEColGuardId);
 
+        sysEColStmt.setPrefetchRows(ctx->dictionaryPrefetchRows);
         int sysEColRet = sysEColStmt.executeQuery();
         while (sysEColRet != 0) {
-            schema->sysEColPack.addWithKeys(ctx, new SysECol(RowId(sysEColRowidStr), sysEColTabObj, sysEColColNum, sysEColGuardId));
-            schema->touchTable(sysEColTabObj);
+            job->sysECols.push_back(new SysECol(RowId(sysEColRowidStr), sysEColTabObj, sysEColColNum, sysEColGuardId));
             sysEColColNum = 0;
             sysEColGuardId = -1;
             sysEColRet = sysEColStmt.next();
         }
 
         // Reading SYS.LOB$
-        DatabaseStatement sysLobStmt(conn);
+        DatabaseStatement sysLobStmt(connection);
         if (obj != 0) {
             if (unlikely(ctx->isTraceSet(Ctx::TRACE::SQL))) {
                 ctx->logTrace(Ctx::TRACE::SQL, std::string(SQL_GET_SYS_LOB_OBJ));
@@ -971,15 +1142,15 @@ namespace OpenLogReplicator {
         typeTs sysLobTs;
         sysLobStmt.defineUInt(6, sysLobTs);
 
+        sysLobStmt.setPrefetchRows(ctx->dictionaryPrefetchRows);
         int sysLobRet = sysLobStmt.executeQuery();
         while (sysLobRet != 0) {
-            schema->sysLobPack.addWithKeys(ctx, new SysLob(RowId(sysLobRowidStr), sysLobObj, sysLobCol, sysLobIntCol, sysLobLObj, sysLobTs));
-            schema->touchTable(sysLobObj);
+            job->sysLobs.push_back(new SysLob(RowId(sysLobRowidStr), sysLobObj, sysLobCol, sysLobIntCol, sysLobLObj, sysLobTs));
             sysLobRet = sysLobStmt.next();
         }
 
         // Reading SYS.LOBCOMPPART$
-        DatabaseStatement sysLobCompPartStmt(conn);
+        DatabaseStatement sysLobCompPartStmt(connection);
         if (obj != 0) {
             if (unlikely(ctx->isTraceSet(Ctx::TRACE::SQL))) {
                 ctx->logTrace(Ctx::TRACE::SQL, std::string(SQL_GET_SYS_LOB_COMP_PART_OBJ));
@@ -1013,15 +1184,15 @@ namespace OpenLogReplicator {
         typeObj sysLobCompPartLObj;
         sysLobCompPartStmt.defineUInt(3, sysLobCompPartLObj);
 
+        sysLobCompPartStmt.setPrefetchRows(ctx->dictionaryPrefetchRows);
         int sysLobCompPartRet = sysLobCompPartStmt.executeQuery();
         while (sysLobCompPartRet != 0) {
-            schema->sysLobCompPartPack.addWithKeys(ctx, new SysLobCompPart(RowId(sysLobCompPartRowidStr), sysLobCompPartPartObj, sysLobCompPartLObj));
-            metadata->schema->touchTableLob(sysLobCompPartLObj);
+            job->sysLobCompParts.push_back(new SysLobCompPart(RowId(sysLobCompPartRowidStr), sysLobCompPartPartObj, sysLobCompPartLObj));
             sysLobCompPartRet = sysLobCompPartStmt.next();
         }
 
         // Reading SYS.LOBFRAG$
-        DatabaseStatement sysLobFragStmt(conn);
+        DatabaseStatement sysLobFragStmt(connection);
         if (obj != 0) {
             if (unlikely(ctx->isTraceSet(Ctx::TRACE::SQL))) {
                 ctx->logTrace(Ctx::TRACE::SQL, std::string(SQL_GET_SYS_LOB_FRAG_OBJ));
@@ -1075,16 +1246,15 @@ namespace OpenLogReplicator {
         typeTs sysLobFragTs;
         sysLobFragStmt.defineUInt(4, sysLobFragTs);
 
+        sysLobFragStmt.setPrefetchRows(ctx->dictionaryPrefetchRows);
         int sysLobFragRet = sysLobFragStmt.executeQuery();
         while (sysLobFragRet != 0) {
-            schema->sysLobFragPack.addWithKeys(ctx, new SysLobFrag(RowId(sysLobFragRowidStr), sysLobFragFragObj, sysLobFragParentObj, sysLobFragTs));
-            metadata->schema->touchTableLobFrag(sysLobFragParentObj);
-            metadata->schema->touchTableLob(sysLobFragParentObj);
+            job->sysLobFrags.push_back(new SysLobFrag(RowId(sysLobFragRowidStr), sysLobFragFragObj, sysLobFragParentObj, sysLobFragTs));
             sysLobFragRet = sysLobFragStmt.next();
         }
 
         // Reading SYS.TAB$
-        DatabaseStatement sysTabStmt(conn);
+        DatabaseStatement sysTabStmt(connection);
         if (obj != 0) {
             if (unlikely(ctx->isTraceSet(Ctx::TRACE::SQL))) {
                 ctx->logTrace(Ctx::TRACE::SQL, std::string(SQL_GET_SYS_TAB_OBJ));
@@ -1126,18 +1296,18 @@ namespace OpenLogReplicator {
         uint64_t sysTabProperty2;
         sysTabStmt.defineUInt(9, sysTabProperty2);
 
+        sysTabStmt.setPrefetchRows(ctx->dictionaryPrefetchRows);
         int sysTabRet = sysTabStmt.executeQuery();
         while (sysTabRet != 0) {
-            schema->sysTabPack.addWithKeys(ctx, new SysTab(RowId(sysTabRowidStr), sysTabObj, sysTabDataObj, sysTabTs, sysTabCluCols, sysTabFlags1,
-                                                           sysTabFlags2, sysTabProperty1, sysTabProperty2));
-            metadata->schema->touchTable(sysTabObj);
+            job->sysTabs.push_back(new SysTab(RowId(sysTabRowidStr), sysTabObj, sysTabDataObj, sysTabTs, sysTabCluCols, sysTabFlags1,
+                                              sysTabFlags2, sysTabProperty1, sysTabProperty2));
             sysTabDataObj = 0;
             sysTabCluCols = 0;
             sysTabRet = sysTabStmt.next();
         }
 
         // Reading SYS.TABCOMPART$
-        DatabaseStatement sysTabComPartStmt(conn);
+        DatabaseStatement sysTabComPartStmt(connection);
         if (obj != 0) {
             if (unlikely(ctx->isTraceSet(Ctx::TRACE::SQL))) {
                 ctx->logTrace(Ctx::TRACE::SQL, std::string(SQL_GET_SYS_TABCOMPART_OBJ));
@@ -1169,17 +1339,17 @@ namespace OpenLogReplicator {
         typeObj sysTabComPartBo;
         sysTabComPartStmt.defineUInt(4, sysTabComPartBo);
 
+        sysTabComPartStmt.setPrefetchRows(ctx->dictionaryPrefetchRows);
         int sysTabComPartRet = sysTabComPartStmt.executeQuery();
         while (sysTabComPartRet != 0) {
-            schema->sysTabComPartPack.addWithKeys(ctx, new SysTabComPart(RowId(sysTabComPartRowidStr), sysTabComPartObj, sysTabComPartDataObj,
-                                                                         sysTabComPartBo));
-            metadata->schema->touchTable(sysTabComPartBo);
+            job->sysTabComParts.push_back(new SysTabComPart(RowId(sysTabComPartRowidStr), sysTabComPartObj, sysTabComPartDataObj,
+                                                            sysTabComPartBo));
             sysTabComPartDataObj = 0;
             sysTabComPartRet = sysTabComPartStmt.next();
         }
 
         // Reading SYS.TABPART$
-        DatabaseStatement sysTabPartStmt(conn);
+        DatabaseStatement sysTabPartStmt(connection);
         if (obj != 0) {
             if (unlikely(ctx->isTraceSet(Ctx::TRACE::SQL))) {
                 ctx->logTrace(Ctx::TRACE::SQL, std::string(SQL_GET_SYS_TABPART_OBJ));
@@ -1211,16 +1381,16 @@ namespace OpenLogReplicator {
         typeObj sysTabPartBo;
         sysTabPartStmt.defineUInt(4, sysTabPartBo);
 
+        sysTabPartStmt.setPrefetchRows(ctx->dictionaryPrefetchRows);
         int sysTabPartRet = sysTabPartStmt.executeQuery();
         while (sysTabPartRet != 0) {
-            schema->sysTabPartPack.addWithKeys(ctx, new SysTabPart(RowId(sysTabPartRowidStr), sysTabPartObj, sysTabPartDataObj, sysTabPartBo));
-            metadata->schema->touchTable(sysTabPartBo);
+            job->sysTabParts.push_back(new SysTabPart(RowId(sysTabPartRowidStr), sysTabPartObj, sysTabPartDataObj, sysTabPartBo));
             sysTabPartDataObj = 0;
             sysTabPartRet = sysTabPartStmt.next();
         }
 
         // Reading SYS.TABSUBPART$
-        DatabaseStatement sysTabSubPartStmt(conn);
+        DatabaseStatement sysTabSubPartStmt(connection);
         if (obj != 0) {
             if (unlikely(ctx->isTraceSet(Ctx::TRACE::SQL))) {
                 ctx->logTrace(Ctx::TRACE::SQL, std::string(SQL_GET_SYS_TABSUBPART_OBJ));
@@ -1252,20 +1422,179 @@ namespace OpenLogReplicator {
         typeObj sysTabSubPartPobj;
         sysTabSubPartStmt.defineUInt(4, sysTabSubPartPobj);
 
+        sysTabSubPartStmt.setPrefetchRows(ctx->dictionaryPrefetchRows);
         int sysTabSubPartRet = sysTabSubPartStmt.executeQuery();
         while (sysTabSubPartRet != 0) {
-            schema->sysTabSubPartPack.addWithKeys(ctx, new SysTabSubPart(RowId(sysTabSubPartRowidStr), sysTabSubPartObj, sysTabSubPartDataObj,
-                                                                         sysTabSubPartPobj));
-            metadata->schema->touchTablePart(sysTabSubPartObj);
+            job->sysTabSubParts.push_back(new SysTabSubPart(RowId(sysTabSubPartRowidStr), sysTabSubPartObj, sysTabSubPartDataObj,
+                                                            sysTabSubPartPobj));
             sysTabSubPartDataObj = 0;
             sysTabSubPartRet = sysTabSubPartStmt.next();
         }
+    }
+
+    void ReplicatorOnline::mergeSystemDictionariesDetails(Schema* schema, DictionaryJob* job) {
+        schema->dictForUpdate();
+        // Same order and touches as a serial read, the rows are owned by the schema as soon as they are handed over
+        for (auto*& row: job->sysCCols) {
+            SysCCol* sysCCol = row;
+            row = nullptr;
+            schema->dict->sysCColPack.addWithKeys(ctx, sysCCol);
+            schema->touchTable(sysCCol->obj);
+        }
+
+        for (auto*& row: job->sysCDefs) {
+            SysCDef* sysCDef = row;
+            row = nullptr;
+            schema->dict->sysCDefPack.addWithKeys(ctx, sysCDef);
+            schema->touchTable(sysCDef->obj);
+        }
+
+        for (auto*& row: job->sysCols) {
+            SysCol* sysCol = row;
+            row = nullptr;
+            schema->dict->sysColPack.addWithKeys(ctx, sysCol);
+            schema->touchTable(sysCol->obj);
+        }
+
+        for (auto*& row: job->sysDeferredStgs) {
+            SysDeferredStg* sysDeferredStg = row;
+            row = nullptr;
+            schema->dict->sysDeferredStgPack.addWithKeys(ctx, sysDeferredStg);
+            schema->touchTable(sysDeferredStg->obj);
+        }
+
+        for (auto*& row: job->sysECols) {
+            SysECol* sysECol = row;
+            row = nullptr;
+            schema->dict->sysEColPack.addWithKeys(ctx, sysECol);
+            schema->touchTable(sysECol->tabObj);
+        }
+
+        for (auto*& row: job->sysLobs) {
+            SysLob* sysLob = row;
+            row = nullptr;
+            schema->dict->sysLobPack.addWithKeys(ctx, sysLob);
+            schema->touchTable(sysLob->obj);
+        }
+
+        for (auto*& row: job->sysLobCompParts) {
+            SysLobCompPart* sysLobCompPart = row;
+            row = nullptr;
+            schema->dict->sysLobCompPartPack.addWithKeys(ctx, sysLobCompPart);
+            metadata->schema->touchTableLob(sysLobCompPart->lObj);
+        }
+
+        for (auto*& row: job->sysLobFrags) {
+            SysLobFrag* sysLobFrag = row;
+            row = nullptr;
+            schema->dict->sysLobFragPack.addWithKeys(ctx, sysLobFrag);
+            metadata->schema->touchTableLobFrag(sysLobFrag->parentObj);
+            metadata->schema->touchTableLob(sysLobFrag->parentObj);
+        }
+
+        for (auto*& row: job->sysTabs) {
+            SysTab* sysTab = row;
+            row = nullptr;
+            schema->dict->sysTabPack.addWithKeys(ctx, sysTab);
+            metadata->schema->touchTable(sysTab->obj);
+        }
+
+        for (auto*& row: job->sysTabComParts) {
+            SysTabComPart* sysTabComPart = row;
+            row = nullptr;
+            schema->dict->sysTabComPartPack.addWithKeys(ctx, sysTabComPart);
+            metadata->schema->touchTable(sysTabComPart->bo);
+        }
+
+        for (auto*& row: job->sysTabParts) {
+            SysTabPart* sysTabPart = row;
+            row = nullptr;
+            schema->dict->sysTabPartPack.addWithKeys(ctx, sysTabPart);
+            metadata->schema->touchTable(sysTabPart->bo);
+        }
+
+        for (auto*& row: job->sysTabSubParts) {
+            SysTabSubPart* sysTabSubPart = row;
+            row = nullptr;
+            schema->dict->sysTabSubPartPack.addWithKeys(ctx, sysTabSubPart);
+            metadata->schema->touchTablePart(sysTabSubPart->obj);
+        }
 
         schema->touched = true;
     }
 
-    void ReplicatorOnline::readSystemDictionaries(Schema* schema, Scn targetScn, const std::string& owner, const std::string& table,
-                                                  DbTable::OPTIONS options) {
+    void ReplicatorOnline::runDictionaryJobs(DatabaseConnection* connection, Scn targetScn, std::vector<std::unique_ptr<DictionaryJob>>& jobs,
+                                             std::atomic<size_t>& nextJob) {
+        for (size_t i = nextJob++; i < jobs.size(); i = nextJob++) {
+            DictionaryJob* job = jobs[i].get();
+            try {
+                fetchSystemDictionariesDetails(connection, targetScn, job);
+            } catch (RuntimeException& ex) {
+                job->failed = true;
+                job->errCode = ex.code;
+                job->errSupCode = ex.supCode;
+                job->errMsg = ex.msg;
+            } catch (DataException& ex) {
+                job->failed = true;
+                job->errData = true;
+                job->errCode = ex.code;
+                job->errMsg = ex.msg;
+            } catch (std::bad_alloc& ex) {
+                job->failed = true;
+                job->errCode = 10018;
+                job->errMsg = "memory allocation failed: " + std::string(ex.what());
+            }
+        }
+    }
+
+    void ReplicatorOnline::readSystemDictionariesDetails(DatabaseConnection* connection, Schema* schema, Scn targetScn,
+                                                         std::vector<std::unique_ptr<DictionaryJob>>& jobs) {
+        if (jobs.empty())
+            return;
+
+        // Every session reads AS OF SCN targetScn, so the rows are consistent no matter which connection fetched them
+        std::atomic<size_t> nextJob{0};
+        const size_t threads = std::min<size_t>(ctx->dictionaryThreads, jobs.size());
+        if (threads > 1) {
+            if (unlikely(ctx->isTraceSet(Ctx::TRACE::SQL)))
+                ctx->logTrace(Ctx::TRACE::SQL, "reading dictionaries for " + std::to_string(jobs.size()) + " jobs using " + std::to_string(threads) +
+                                               " connections");
+
+            std::vector<std::thread> workers;
+            workers.reserve(threads - 1);
+            for (size_t i = 1; i < threads; ++i) {
+                workers.emplace_back([this, connection, targetScn, &jobs, &nextJob]() {
+                    DatabaseConnection workerConn(env, connection->user, connection->password, connection->connectString, false);
+                    try {
+                        workerConn.connect();
+                    } catch (RuntimeException& ex) {
+                        // The remaining connections take over the jobs
+                        ctx->warning(60040, "dictionary reader connection failed: " + ex.msg);
+                        return;
+                    }
+                    runDictionaryJobs(&workerConn, targetScn, jobs, nextJob);
+                });
+            }
+
+            runDictionaryJobs(connection, targetScn, jobs, nextJob);
+            for (std::thread& worker: workers)
+                worker.join();
+        } else
+            runDictionaryJobs(connection, targetScn, jobs, nextJob);
+
+        for (const auto& job: jobs) {
+            if (job->failed) {
+                if (job->errData)
+                    throw DataException(job->errCode, job->errMsg);
+                throw RuntimeException(job->errCode, job->errMsg, job->errSupCode);
+            }
+            mergeSystemDictionariesDetails(schema, job.get());
+        }
+    }
+
+    void ReplicatorOnline::readSystemDictionaries(DatabaseConnection* connection, Schema* schema, Scn targetScn, const std::string& owner,
+                                                  const std::string& table, DbTable::OPTIONS options) {
+        schema->dictForUpdate();
         if (unlikely(ctx->isTraceSet(Ctx::TRACE::REDO)))
             ctx->logTrace(Ctx::TRACE::REDO, "read dictionaries for owner: " + owner + ", table: " + table + ", options: " +
                                             std::to_string(static_cast<uint>(options)));
@@ -1274,7 +1603,8 @@ namespace OpenLogReplicator {
             std::string ownerRegexp("^" + owner + "$");
             std::string tableRegexp("^" + table + "$");
             const bool single = DbTable::isSystemTable(options);
-            DatabaseStatement sysUserStmt(conn);
+            std::vector<std::unique_ptr<DictionaryJob>> jobs;
+            DatabaseStatement sysUserStmt(connection);
 
             // Reading SYS.USER$
             if (unlikely(ctx->isTraceSet(Ctx::TRACE::SQL))) {
@@ -1299,8 +1629,8 @@ namespace OpenLogReplicator {
             int sysUserRet = sysUserStmt.executeQuery();
             while (sysUserRet != 0) {
                 const RowId sysUserRowid(sysUserRowidStr);
-                auto sysUserMapRowIdIt = schema->sysUserPack.mapRowId.find(sysUserRowid);
-                if (sysUserMapRowIdIt != schema->sysUserPack.mapRowId.end()) {
+                auto sysUserMapRowIdIt = schema->dict->sysUserPack.mapRowId.find(sysUserRowid);
+                if (sysUserMapRowIdIt != schema->dict->sysUserPack.mapRowId.end()) {
                     if (!single) {
                         SysUser* sysUser = sysUserMapRowIdIt->second;
                         if (sysUser->single) {
@@ -1316,9 +1646,9 @@ namespace OpenLogReplicator {
                         }
                     }
                 } else
-                    schema->sysUserPack.addWithKeys(ctx, new SysUser(sysUserRowid, sysUserUser, sysUserName.data(), sysUserSpare11, sysUserSpare12, single));
+                    schema->dict->sysUserPack.addWithKeys(ctx, new SysUser(sysUserRowid, sysUserUser, sysUserName.data(), sysUserSpare11, sysUserSpare12, single));
 
-                DatabaseStatement sysObjStmt(conn);
+                DatabaseStatement sysObjStmt(connection);
                 // Reading SYS.OBJ$
                 if (!single) {
                     if (unlikely(ctx->isTraceSet(Ctx::TRACE::SQL))) {
@@ -1359,11 +1689,12 @@ namespace OpenLogReplicator {
                 uint64_t sysObjFlags2;
                 sysObjStmt.defineUInt(8, sysObjFlags2);
 
+                sysObjStmt.setPrefetchRows(ctx->dictionaryPrefetchRows);
                 int sysObjRet = sysObjStmt.executeQuery();
                 while (sysObjRet != 0) {
                     const RowId sysObjRowId(sysObjRowidStr);
-                    auto sysObjMapRowIdIt = schema->sysObjPack.mapRowId.find(sysObjRowId);
-                    if (sysObjMapRowIdIt != schema->sysObjPack.mapRowId.end()) {
+                    auto sysObjMapRowIdIt = schema->dict->sysObjPack.mapRowId.find(sysObjRowId);
+                    if (sysObjMapRowIdIt != schema->dict->sysObjPack.mapRowId.end()) {
                         SysObj* sysObj = sysObjMapRowIdIt->second;
                         if (sysObj->single && !single) {
                             sysObj->single = false;
@@ -1379,12 +1710,12 @@ namespace OpenLogReplicator {
                         continue;
                     }
 
-                    schema->sysObjPack.addWithKeys(ctx, new SysObj(sysObjRowId, sysObjOwner, sysObjObj, sysObjDataObj, static_cast<SysObj::OBJTYPE>(sysObjType),
+                    schema->dict->sysObjPack.addWithKeys(ctx, new SysObj(sysObjRowId, sysObjOwner, sysObjObj, sysObjDataObj, static_cast<SysObj::OBJTYPE>(sysObjType),
                                                                    sysObjName.data(), sysObjFlags1, sysObjFlags2, single));
                     schema->touchTable(sysObjObj);
 
                     if (single)
-                        readSystemDictionariesDetails(schema, targetScn, sysUserUser, sysObjObj);
+                        jobs.push_back(std::make_unique<DictionaryJob>(sysUserUser, sysObjObj));
 
                     sysObjDataObj = 0;
                     sysObjFlags1 = 0;
@@ -1393,12 +1724,14 @@ namespace OpenLogReplicator {
                 }
 
                 if (!single)
-                    readSystemDictionariesDetails(schema, targetScn, sysUserUser, 0);
+                    jobs.push_back(std::make_unique<DictionaryJob>(sysUserUser, 0));
 
                 sysUserSpare11 = 0;
                 sysUserSpare12 = 0;
                 sysUserRet = sysUserStmt.next();
             }
+
+            readSystemDictionariesDetails(connection, schema, targetScn, jobs);
         } catch (DataException& ex) {
             ctx->error(ex.code, ex.msg);
             throw BootException(10035, "can't read schema from flashback, provide a valid starting SCN value");
@@ -1412,19 +1745,410 @@ namespace OpenLogReplicator {
 
     void ReplicatorOnline::createSchemaForTable(Scn targetScn, const std::string& owner, const std::string& table, const std::vector<std::string>& keyList,
                                                 const std::string& key, SchemaElement::TAG_TYPE tagType, const std::vector<std::string>& tagList, const std::string& tag,
-                                                const std::string& condition, DbTable::OPTIONS options, std::unordered_map<typeObj, std::string>& tablesUpdated) {
+                                                const std::string& condition, const std::vector<std::string>& columnList,
+                                                const std::vector<std::string>& skipColumnList, DbTable::OPTIONS options,
+                                                std::unordered_map<typeObj, std::string>& tablesUpdated, bool readDictionaries) {
         if (unlikely(ctx->isTraceSet(Ctx::TRACE::REDO)))
             ctx->logTrace(Ctx::TRACE::REDO, "creating table schema for owner: " + owner + " table: " + table + " options: " +
                                             std::to_string(static_cast<uint>(options)));
 
-        readSystemDictionaries(metadata->schema, targetScn, owner, table, options);
+        if (readDictionaries)
+            readSystemDictionaries(conn, metadata->schema, targetScn, owner, table, options);
 
-        metadata->schema->buildMaps(owner, table, keyList, key, tagType, tagList, tag, condition, options, tablesUpdated, metadata->suppLogDbPrimary,
+        metadata->schema->buildMaps(owner, table, keyList, key, tagType, tagList, tag, condition, columnList, skipColumnList, options, tablesUpdated,
+                                    metadata->suppLogDbPrimary,
                                     metadata->suppLogDbAll, metadata->defaultCharacterMapId,
                                     metadata->defaultCharacterNcharMapId);
     }
 
+    void ReplicatorOnline::planSnapshotColumns(const DbTable* table, std::vector<SnapshotColumn>& columns) const {
+        std::string unsupported;
+        const auto maxI = static_cast<typeCol>(table->columns.size());
+        for (typeCol i = 0; i < maxI; ++i) {
+            const DbColumn* column = table->columns[i];
+            if (column->unused || column->guard || column->nested)
+                continue;
+
+            const std::string name("T.\"" + column->name + "\"");
+            const auto size = static_cast<uint16_t>(std::min<uint>(std::max<uint>(column->length, 1), 32767));
+            if (!column->storedAsLob) {
+                switch (column->type) {
+                    case SysCol::COLTYPE::NUMBER:
+                        columns.push_back({i, SnapshotColumn::VALUE::RAW, 22, "UTL_RAW.CAST_FROM_NUMBER(" + name + ")"});
+                        continue;
+
+                    case SysCol::COLTYPE::FLOAT:
+                        columns.push_back({i, SnapshotColumn::VALUE::BINARY, 4, "UTL_RAW.CAST_FROM_BINARY_FLOAT(" + name + ", 1)"});
+                        continue;
+
+                    case SysCol::COLTYPE::DOUBLE:
+                        columns.push_back({i, SnapshotColumn::VALUE::BINARY, 8, "UTL_RAW.CAST_FROM_BINARY_DOUBLE(" + name + ", 1)"});
+                        continue;
+
+                    // Converted to its own character set, which returns the bytes as stored
+                    case SysCol::COLTYPE::VARCHAR:
+                    case SysCol::COLTYPE::CHAR: {
+                        const CharacterSet* characterSet = metadata->locales->getCharacterSet(column->charsetId);
+                        if (characterSet == nullptr)
+                            break;
+                        columns.push_back({i, SnapshotColumn::VALUE::RAW, size, "UTL_I18N.STRING_TO_RAW(" + name + ", '" + characterSet->name + "')"});
+                        continue;
+                    }
+
+                    case SysCol::COLTYPE::RAW:
+                        columns.push_back({i, SnapshotColumn::VALUE::RAW, size, name});
+                        continue;
+
+                    case SysCol::COLTYPE::DATE:
+                        columns.push_back({i, SnapshotColumn::VALUE::DATE, 7, name});
+                        continue;
+
+                    case SysCol::COLTYPE::TIMESTAMP:
+                        columns.push_back({i, SnapshotColumn::VALUE::TIMESTAMP, 11, "CAST(" + name + " AS DATE), UTL_RAW.CAST_FROM_BINARY_INTEGER(TO_NUMBER(TO_CHAR(" +
+                                           name + ", 'FF9')), 1)"});
+                        continue;
+
+                    default:
+                        break;
+                }
+            }
+
+            if (!unsupported.empty())
+                unsupported += ", ";
+            unsupported += column->name;
+        }
+
+        if (!unsupported.empty())
+            ctx->warning(60047, "snapshot of table: " + table->owner + "." + table->name + " does not contain columns of unsupported type: " +
+                                unsupported);
+    }
+
+    void ReplicatorOnline::fetchSnapshot(DatabaseConnection* connection, Scn targetScn, SnapshotJob* job) {
+        const std::vector<SnapshotColumn>& columns = *job->columns;
+
+        // The whole segment is one ROWID range, so that a partition is read without knowing its name
+        std::string sql("SELECT T.ROWID");
+        for (const SnapshotColumn& column: columns)
+            sql += ", " + column.expression;
+        sql += " FROM \"" + job->table->owner + "\".\"" + job->table->name + "\" AS OF SCN :i T"
+               " WHERE T.ROWID BETWEEN DBMS_ROWID.ROWID_CREATE(1, :j, 0, 0, 0) AND DBMS_ROWID.ROWID_CREATE(1, :k, 1023, 4194303, 65535)";
+
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::SQL))) {
+            ctx->logTrace(Ctx::TRACE::SQL, sql);
+            ctx->logTrace(Ctx::TRACE::SQL, "PARAM1: " + targetScn.toString());
+            ctx->logTrace(Ctx::TRACE::SQL, "PARAM2: " + std::to_string(job->dataObj));
+            ctx->logTrace(Ctx::TRACE::SQL, "PARAM3: " + std::to_string(job->dataObj));
+        }
+
+        DatabaseStatement stmt(connection);
+        stmt.createStatement(sql);
+        stmt.setPrefetchRows(SNAPSHOT_FETCH_ROWS);
+        stmt.bindUInt(1, targetScn);
+        stmt.bindUInt(2, job->dataObj);
+        stmt.bindUInt(3, job->dataObj);
+
+        std::vector<char> rowIds(SNAPSHOT_FETCH_ROWS * (RowId::SIZE + 1));
+        stmt.defineString(1, rowIds.data(), RowId::SIZE + 1);
+
+        // One element per select item, a timestamp takes two
+        std::vector<std::vector<uint8_t>> buffers;
+        std::vector<std::vector<int16_t>> indicators;
+        std::vector<std::vector<uint16_t>> lengths;
+        std::vector<uint16_t> sizes;
+        for (const SnapshotColumn& column: columns) {
+            if (column.value == SnapshotColumn::VALUE::TIMESTAMP) {
+                sizes.push_back(7);
+                sizes.push_back(4);
+            } else
+                sizes.push_back(column.size);
+        }
+        buffers.resize(sizes.size());
+        indicators.resize(sizes.size(), std::vector<int16_t>(SNAPSHOT_FETCH_ROWS));
+        lengths.resize(sizes.size(), std::vector<uint16_t>(SNAPSHOT_FETCH_ROWS));
+
+        size_t item = 0;
+        for (const SnapshotColumn& column: columns) {
+            buffers[item].resize(SNAPSHOT_FETCH_ROWS * sizes[item]);
+            stmt.defineBinary(item + 2, column.value == SnapshotColumn::VALUE::DATE || column.value == SnapshotColumn::VALUE::TIMESTAMP ? SQLT_DAT : SQLT_BIN, buffers[item].data(), sizes[item],
+                              indicators[item].data(), lengths[item].data());
+            ++item;
+            if (column.value == SnapshotColumn::VALUE::TIMESTAMP) {
+                buffers[item].resize(SNAPSHOT_FETCH_ROWS * sizes[item]);
+                stmt.defineBinary(item + 2, SQLT_BIN, buffers[item].data(), sizes[item], indicators[item].data(), lengths[item].data());
+                ++item;
+            }
+        }
+
+        stmt.execute();
+        uint32_t rows;
+        do {
+            if (ctx->softShutdown || snapshotStop)
+                return;
+
+            rows = stmt.fetchArray(SNAPSHOT_FETCH_ROWS);
+            if (rows == 0)
+                break;
+
+            auto batch = std::make_unique<SnapshotBatch>();
+            batch->job = job;
+            batch->rows = rows;
+            std::vector<uint8_t>& data = batch->data;
+            const auto append = [&data](const uint8_t* value, uint16_t length) {
+                data.push_back(static_cast<uint8_t>(length & 0xFF));
+                data.push_back(static_cast<uint8_t>(length >> 8));
+                data.insert(data.end(), value, value + length);
+            };
+
+            for (uint32_t row = 0; row < rows; ++row) {
+                const auto* rowId = reinterpret_cast<const uint8_t*>(rowIds.data() + (row * (RowId::SIZE + 1)));
+                data.insert(data.end(), rowId, rowId + RowId::SIZE);
+
+                item = 0;
+                for (const SnapshotColumn& column: columns) {
+                    const uint8_t* value = buffers[item].data() + (row * sizes[item]);
+                    if (indicators[item][row] < 0)
+                        append(value, 0);
+                    else if (column.value == SnapshotColumn::VALUE::TIMESTAMP) {
+                        // Without a fraction of a second the value is stored in 7 bytes, like a date
+                        std::array<uint8_t, 11> timestamp {};
+                        memcpy(timestamp.data(), value, 7);
+                        memcpy(timestamp.data() + 7, buffers[item + 1].data() + (row * sizes[item + 1]), 4);
+                        append(timestamp.data(), Ctx::read32Big(timestamp.data() + 7) != 0 ? 11 : 7);
+                    } else if (column.value == SnapshotColumn::VALUE::BINARY) {
+                        std::array<uint8_t, 8> binary {};
+                        const uint16_t length = std::min<uint16_t>(lengths[item][row], binary.size());
+                        for (uint16_t j = 0; j < length; ++j)
+                            binary[j] = (value[0] & 0x80) != 0 ? static_cast<uint8_t>(~value[j]) : value[j];
+                        if ((value[0] & 0x80) == 0)
+                            binary[0] |= 0x80;
+                        append(binary.data(), length);
+                    } else
+                        append(value, lengths[item][row]);
+                    item += column.value == SnapshotColumn::VALUE::TIMESTAMP ? 2 : 1;
+                }
+            }
+            job->rows += rows;
+
+            std::unique_lock<std::mutex> lck(mtxSnapshot);
+            while (snapshotQueue.size() >= snapshotQueueMax && !ctx->softShutdown && !snapshotStop)
+                condSnapshotFull.wait_for(lck, std::chrono::milliseconds(100));
+            if (ctx->softShutdown || snapshotStop)
+                return;
+            snapshotQueue.push_back(std::move(batch));
+            condSnapshotEmpty.notify_all();
+        } while (rows == SNAPSHOT_FETCH_ROWS);
+
+        job->done = true;
+    }
+
+    void ReplicatorOnline::runSnapshotJobs(DatabaseConnection* connection, Scn targetScn, std::vector<std::unique_ptr<SnapshotJob>>& jobs,
+                                           std::atomic<size_t>& nextJob) {
+        for (size_t i = nextJob++; i < jobs.size(); i = nextJob++) {
+            SnapshotJob* job = jobs[i].get();
+            try {
+                fetchSnapshot(connection, targetScn, job);
+            } catch (RuntimeException& ex) {
+                job->failed = true;
+                job->errCode = ex.code;
+                job->errSupCode = ex.supCode;
+                job->errMsg = ex.msg;
+            } catch (DataException& ex) {
+                job->failed = true;
+                job->errData = true;
+                job->errCode = ex.code;
+                job->errMsg = ex.msg;
+            } catch (std::bad_alloc& ex) {
+                job->failed = true;
+                job->errCode = 10018;
+                job->errMsg = "memory allocation failed: " + std::string(ex.what());
+            }
+        }
+    }
+
+    void ReplicatorOnline::emitSnapshotBatch(Scn targetScn, const SnapshotBatch* batch, std::vector<const uint8_t*>& data, std::vector<typeSize>& size) {
+        const SnapshotJob* job = batch->job;
+        const std::unordered_map<std::string, std::string> attributes{{"snapshot", job->table->owner + "." + job->table->name}};
+        const time_t timestamp = ctx->clock->getTimeT();
+
+        builder->processBegin(Xid(), targetScn, targetScn, &attributes);
+        const uint8_t* pos = batch->data.data();
+        for (uint32_t row = 0; row < batch->rows; ++row) {
+            const RowId rowId(std::string(reinterpret_cast<const char*>(pos), RowId::SIZE));
+            pos += RowId::SIZE;
+
+            data.assign(job->table->columns.size(), nullptr);
+            size.assign(job->table->columns.size(), 0);
+            for (const SnapshotColumn& column: *job->columns) {
+                const typeSize length = static_cast<typeSize>(pos[0]) | (static_cast<typeSize>(pos[1]) << 8);
+                pos += 2;
+                data[column.col] = pos;
+                size[column.col] = length;
+                pos += length;
+            }
+
+            builder->processSnapshotInsert(targetScn, metadata->sequence, timestamp, job->table, job->obj, rowId, data.data(), size.data());
+        }
+        builder->processCommit(targetScn, metadata->sequence, timestamp);
+        builder->processEnd();
+        builder->flush();
+    }
+
+    void ReplicatorOnline::createSnapshot() {
+        if (!snapshotPending)
+            return;
+        snapshotPending = false;
+        if (!checkConnection())
+            return;
+
+        // Read AS OF the SCN of the schema, redo replication continues with the transactions committed after it
+        const Scn targetScn = metadata->firstDataScn;
+        std::vector<const DbTable*> tables;
+        for (const SchemaElement* element: metadata->schemaElements) {
+            if (!element->snapshot)
+                continue;
+
+            const std::regex regexOwner(element->owner);
+            const std::regex regexTable(element->table);
+            for (const auto& [_, table]: metadata->schema->tableMap)
+                if (table->options == DbTable::OPTIONS::DEFAULT && regex_match(table->owner, regexOwner) && regex_match(table->name, regexTable))
+                    tables.push_back(table);
+        }
+        std::sort(tables.begin(), tables.end(), [](const DbTable* a, const DbTable* b) { return a->obj < b->obj; });
+        tables.erase(std::unique(tables.begin(), tables.end()), tables.end());
+
+        // Tables built lazily get their columns now, the rows are read by column
+        for (const DbTable* table: tables) {
+            if (!table->columnsPending)
+                continue;
+            contextSet(CONTEXT::MUTEX, REASON::REPLICATOR_SCHEMA);
+            std::unique_lock<std::mutex> const lckTransaction(metadata->mtxTransaction);
+            std::unique_lock<std::mutex> const lckSchema(metadata->mtxSchema);
+            metadata->schema->materializeTable(table->obj);
+            contextSet(CONTEXT::CPU);
+        }
+
+        std::vector<std::unique_ptr<std::vector<SnapshotColumn>>> tableColumns;
+        std::vector<std::unique_ptr<SnapshotJob>> jobs;
+        for (const DbTable* table: tables) {
+            checkTableForGrantsFlashback("\"" + table->owner + "\".\"" + table->name + "\"", targetScn);
+
+            auto columns = std::make_unique<std::vector<SnapshotColumn>>();
+            planSnapshotColumns(table, *columns);
+            // A segment is created with the first row, a table or partition without it has nothing to read
+            if (table->tablePartitions.empty()) {
+                if (table->dataObj != 0)
+                    jobs.push_back(std::make_unique<SnapshotJob>(table, columns.get(), table->obj, table->dataObj));
+            } else {
+                for (const typeObj2 objx: table->tablePartitions) {
+                    const auto partitionDataObj = static_cast<typeDataObj>(objx & 0xFFFFFFFF);
+                    if (partitionDataObj != 0)
+                        jobs.push_back(std::make_unique<SnapshotJob>(table, columns.get(), static_cast<typeObj>(objx >> 32), partitionDataObj));
+                }
+            }
+            tableColumns.push_back(std::move(columns));
+        }
+        if (jobs.empty())
+            return;
+
+        const size_t sessions = std::min<size_t>(ctx->snapshotThreads, jobs.size());
+        ctx->info(0, "reading snapshot of " + std::to_string(tables.size()) + " tables (" + std::to_string(jobs.size()) + " segments) for scn: " +
+                     targetScn.toString() + " using " + std::to_string(sessions) + " connections");
+
+        snapshotQueueMax = sessions * SNAPSHOT_QUEUE_BATCHES;
+        snapshotSessions = sessions;
+        snapshotStop = false;
+        std::atomic<size_t> nextJob{0};
+        std::vector<std::thread> workers;
+        workers.reserve(sessions);
+        for (size_t i = 0; i < sessions; ++i) {
+            workers.emplace_back([this, targetScn, &jobs, &nextJob]() {
+                try {
+                    DatabaseConnection workerConn(env, conn->user, conn->password, conn->connectString, false);
+                    workerConn.connect();
+                    runSnapshotJobs(&workerConn, targetScn, jobs, nextJob);
+                } catch (RuntimeException& ex) {
+                    // The remaining connections take over the jobs
+                    ctx->warning(60048, "snapshot reader connection failed: " + ex.msg);
+                }
+
+                std::unique_lock<std::mutex> const lck(mtxSnapshot);
+                --snapshotSessions;
+                condSnapshotEmpty.notify_all();
+            });
+        }
+
+        // The builder is only used by this thread, the sessions hand over the rows they fetched
+        uint64_t rows = 0;
+        std::vector<const uint8_t*> data;
+        std::vector<typeSize> size;
+        try {
+            while (true) {
+                std::unique_ptr<SnapshotBatch> batch;
+                {
+                    contextSet(CONTEXT::MUTEX, REASON::REPLICATOR_SNAPSHOT);
+                    std::unique_lock<std::mutex> lck(mtxSnapshot);
+                    while (snapshotQueue.empty() && snapshotSessions > 0 && !ctx->softShutdown) {
+                        contextSet(CONTEXT::WAIT, REASON::REPLICATOR_SNAPSHOT_EMPTY);
+                        condSnapshotEmpty.wait_for(lck, std::chrono::milliseconds(100));
+                    }
+                    if (snapshotQueue.empty() || ctx->softShutdown)
+                        break;
+
+                    batch = std::move(snapshotQueue.front());
+                    snapshotQueue.pop_front();
+                    condSnapshotFull.notify_all();
+                }
+                contextSet(CONTEXT::CPU);
+
+                emitSnapshotBatch(targetScn, batch.get(), data, size);
+                rows += batch->rows;
+            }
+        } catch (...) {
+            snapshotStop = true;
+            for (std::thread& worker: workers)
+                worker.join();
+            snapshotQueue.clear();
+            throw;
+        }
+        contextSet(CONTEXT::CPU);
+
+        snapshotStop = true;
+        for (std::thread& worker: workers)
+            worker.join();
+        snapshotQueue.clear();
+        if (ctx->softShutdown)
+            return;
+
+        for (const auto& job: jobs) {
+            if (job->failed) {
+                if (job->errData)
+                    throw DataException(job->errCode, job->errMsg);
+                throw RuntimeException(job->errCode, job->errMsg, job->errSupCode);
+            }
+            if (unlikely(!job->done))
+                throw RuntimeException(10089, "snapshot of table: " + job->table->owner + "." + job->table->name + " (dataobj: " +
+                                              std::to_string(job->dataObj) + ") not read, no connection to the database");
+        }
+
+        ctx->info(0, "snapshot completed, rows: " + std::to_string(rows) + ", continuing with redo log from scn: " + targetScn.toString());
+    }
+
     void ReplicatorOnline::updateOnlineRedoLogData() {
+        if (headerDiscovery && onlineRedoResetlogs != 0 && onlineRedoResetlogs == metadata->resetlogs) {
+            // A header from another incarnation means resetlogs, the incarnation list and groups are read again
+            bool resetlogsChanged = false;
+            for (const Reader* reader: readers)
+                if (reader->getGroup() != 0 && reader->getResetlogs() != 0 && reader->getResetlogs() != metadata->resetlogs)
+                    resetlogsChanged = true;
+
+            if (!resetlogsChanged) {
+                if (unlikely(ctx->isTraceSet(Ctx::TRACE::REDO)))
+                    ctx->logTrace(Ctx::TRACE::REDO, "online redo log groups unchanged, using redo headers");
+                checkOnlineRedoLogs();
+                return;
+            }
+        }
+
         if (!checkConnection())
             return;
 
@@ -1546,6 +2270,7 @@ namespace OpenLogReplicator {
                 throw RuntimeException(10037, "failed to find online redo log files");
             }
         }
+        onlineRedoResetlogs = metadata->resetlogs;
         checkOnlineRedoLogs();
         contextSet(CONTEXT::CPU);
     }
@@ -1704,6 +2429,46 @@ namespace OpenLogReplicator {
         contextSet(CONTEXT::CPU);
     }
 
+    void ReplicatorOnline::listArchiveLogs(std::vector<ArchiveLog>& archiveLogs) {
+        readArchiveLogs(sqlGetArchiveLogList(), metadata->sequence, false, archiveLogs);
+    }
+
+    // Rows are fetched in arrays, with the first array prefetched by the execute call, so a short list costs one round trip
+    void ReplicatorOnline::readArchiveLogs(const std::string& sql, Seq sequence, bool withInstance, std::vector<ArchiveLog>& archiveLogs) {
+        DatabaseStatement stmt(conn);
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::SQL))) {
+            ctx->logTrace(Ctx::TRACE::SQL, sql);
+            ctx->logTrace(Ctx::TRACE::SQL, "PARAM1: " + sequence.toString());
+            ctx->logTrace(Ctx::TRACE::SQL, "PARAM2: " + std::to_string(metadata->resetlogs));
+        }
+
+        stmt.createStatement(sql);
+        stmt.setPrefetchRows(ARCHIVE_LOG_FETCH_ROWS);
+        stmt.bindUInt(1, sequence);
+        stmt.bindUInt(2, metadata->resetlogs);
+
+        std::vector<char> paths(ARCHIVE_LOG_FETCH_ROWS * ARCHIVE_LOG_PATH_SIZE);
+        std::array<Seq, ARCHIVE_LOG_FETCH_ROWS> sequences;
+        std::array<Scn, ARCHIVE_LOG_FETCH_ROWS> firstScns;
+        std::array<Scn, ARCHIVE_LOG_FETCH_ROWS> nextScns;
+        std::array<int, ARCHIVE_LOG_FETCH_ROWS> instIds {};
+        stmt.defineString(1, paths.data(), ARCHIVE_LOG_PATH_SIZE);
+        stmt.defineUInt(2, sequences[0]);
+        stmt.defineUInt(3, firstScns[0]);
+        stmt.defineUInt(4, nextScns[0]);
+        if (withInstance)
+            stmt.defineInt(5, instIds[0]);
+
+        stmt.execute();
+        uint32_t rows;
+        do {
+            rows = stmt.fetchArray(ARCHIVE_LOG_FETCH_ROWS);
+            for (uint32_t row = 0; row < rows; ++row)
+                archiveLogs.push_back({std::string(paths.data() + row * ARCHIVE_LOG_PATH_SIZE), sequences[row], firstScns[row], nextScns[row],
+                                       withInstance ? instIds[row] : -1});
+        } while (rows == ARCHIVE_LOG_FETCH_ROWS);
+    }
+
     void ReplicatorOnline::archGetLogOnline(Replicator* replicator) {
         auto* replicatorOnline = dynamic_cast<ReplicatorOnline*>(replicator);
         if (replicatorOnline == nullptr)
@@ -1717,42 +2482,17 @@ namespace OpenLogReplicator {
             replicatorOnline->updateDatabaseIncarnation();
         }
 
-        {
-            std::string sql = replicatorOnline->sqlGetArchiveLogList();
-            DatabaseStatement stmt(replicatorOnline->conn);
-            if (unlikely(replicator->ctx->isTraceSet(Ctx::TRACE::SQL))) {
-                replicator->ctx->logTrace(Ctx::TRACE::SQL, std::string(sql));
-                replicator->ctx->logTrace(Ctx::TRACE::SQL, "PARAM1: " +
-                                                           replicatorOnline->metadata->sequence.toString());
-                replicator->ctx->logTrace(Ctx::TRACE::SQL, "PARAM2: " + std::to_string(replicator->metadata->resetlogs));
-            }
-
-            stmt.createStatement(sql);
-            stmt.bindUInt(1, (reinterpret_cast<ReplicatorOnline*>(replicator))->metadata->sequence);
-            stmt.bindUInt(2, replicator->metadata->resetlogs);
-
-            std::array<char, 513> path {};
-            stmt.defineString(1, path.data(), path.size());
-            Seq sequence;
-            stmt.defineUInt(2, sequence);
-            Scn firstScn;
-            stmt.defineUInt(3, firstScn);
-            Scn nextScn;
-            stmt.defineUInt(4, nextScn);
-
-            int ret = stmt.executeQuery();
-            while (ret != 0) {
-                std::string mappedPath(path.data());
-                replicator->applyMapping(mappedPath);
-
-                auto* parser = new Parser(replicator->ctx, replicator->builder, replicator->metadata,
-                                          replicator->transactionBuffer, 0, mappedPath);
-                parser->firstScn = firstScn;
-                parser->nextScn = nextScn;
-                parser->sequence = sequence;
-                (reinterpret_cast<ReplicatorOnline*>(replicator))->archiveRedoQueue.push(parser);
-                ret = stmt.next();
-            }
+        std::vector<ArchiveLog> archiveLogs;
+        replicatorOnline->listArchiveLogs(archiveLogs);
+        for (ArchiveLog& archiveLog: archiveLogs) {
+            replicator->applyMapping(archiveLog.path);
+
+            auto* parser = new Parser(replicator->ctx, replicator->builder, replicator->metadata,
+                                      replicator->transactionBuffer, 0, archiveLog.path);
+            parser->firstScn = archiveLog.firstScn;
+            parser->nextScn = archiveLog.nextScn;
+            parser->sequence = archiveLog.sequence;
+            replicatorOnline->archiveRedoQueue.push(parser);
         }
         replicator->goStandby();
     }
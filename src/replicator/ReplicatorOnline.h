@@ -20,6 +20,14 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #ifndef REPLICATOR_ONLINE_H_
 #define REPLICATOR_ONLINE_H_
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
 #include "Replicator.h"
 #include "../common/DbTable.h"
 #include "../metadata/SchemaElement.h"
@@ -29,6 +37,127 @@ namespace OpenLogReplicator {
     class DatabaseEnvironment;
     class Schema;
         class ReplicatorRacOnline;
+    class SysCCol;
+    class SysCDef;
+    class SysCol;
+    class SysDeferredStg;
+    class SysECol;
+    class SysLob;
+    class SysLobCompPart;
+    class SysLobFrag;
+    class SysTab;
+    class SysTabComPart;
+    class SysTabPart;
+    class SysTabSubPart;
+
+    // Dictionary rows of one user (obj is 0) or one object, fetched on any connection and merged into the schema by the replicator thread
+    struct DictionaryJob final {
+        typeUser user;
+        typeObj obj;
+        std::vector<SysCCol*> sysCCols;
+        std::vector<SysCDef*> sysCDefs;
+        std::vector<SysCol*> sysCols;
+        std::vector<SysDeferredStg*> sysDeferredStgs;
+        std::vector<SysECol*> sysECols;
+        std::vector<SysLob*> sysLobs;
+        std::vector<SysLobCompPart*> sysLobCompParts;
+        std::vector<SysLobFrag*> sysLobFrags;
+        std::vector<SysTab*> sysTabs;
+        std::vector<SysTabComPart*> sysTabComParts;
+        std::vector<SysTabPart*> sysTabParts;
+        std::vector<SysTabSubPart*> sysTabSubParts;
+        bool failed{false};
+        bool errData{false};
+        int errCode{0};
+        int errSupCode{0};
+        std::string errMsg;
+
+        DictionaryJob(typeUser newUser, typeObj newObj);
+        ~DictionaryJob();
+
+        DictionaryJob(const DictionaryJob&) = delete;
+        DictionaryJob& operator=(const DictionaryJob&) = delete;
+    };
+
+    // Column read by the initial snapshot, the select expression returns the value in the on-disk format
+    struct SnapshotColumn final {
+        enum class VALUE : unsigned char {
+            // Fetched as is
+            RAW,
+            // Big endian IEEE 754, stored with the sign bit flipped for positive and all bits inverted for negative values
+            BINARY,
+            // Defined as SQLT_DAT, which is the on-disk format
+            DATE,
+            // Date part followed by the nanoseconds as a second select item
+            TIMESTAMP
+        };
+
+        typeCol col;
+        VALUE value;
+        uint16_t size;
+        std::string expression;
+    };
+
+    // One segment of a table read by the initial snapshot: the table itself or one of its partitions
+    class SnapshotJob final {
+    public:
+        const DbTable* table;
+        const std::vector<SnapshotColumn>* columns;
+        typeObj obj;
+        typeDataObj dataObj;
+        uint64_t rows{0};
+        bool done{false};
+        bool failed{false};
+        bool errData{false};
+        int errCode{0};
+        int errSupCode{0};
+        std::string errMsg;
+
+        SnapshotJob(const DbTable* newTable, const std::vector<SnapshotColumn>* newColumns, typeObj newObj, typeDataObj newDataObj) :
+                table(newTable),
+                columns(newColumns),
+                obj(newObj),
+                dataObj(newDataObj) {
+        }
+    };
+
+    // Rows of one array fetch: the row ID followed by a 16-bit length and the value of every column, length 0 for NULL
+    struct SnapshotBatch final {
+        SnapshotJob* job;
+        uint32_t rows;
+        std::vector<uint8_t> data;
+    };
+
+    // One row of the archived log list, instance is only set when the list covers all instances of a RAC database
+    struct ArchiveLog final {
+        std::string path;
+        Seq sequence;
+        Scn firstScn;
+        Scn nextScn;
+        int instId;
+    };
+
+    class ReplicatorOnline;
+
+    // Database session of the background schema verification, the dictionaries are read AS OF SCN while the replicator goes on
+    class SchemaVerifier final : public Thread {
+    protected:
+        ReplicatorOnline* replicator;
+
+        void run() override;
+
+    public:
+        DatabaseConnection* conn{nullptr};
+
+        SchemaVerifier(Ctx* newCtx, std::string newAlias, ReplicatorOnline* newReplicator);
+        ~SchemaVerifier() override;
+
+        void wakeUp() override;
+
+        std::string getName() const override {
+            return {"Replicator: schema verifier " + alias};
+        }
+    };
 
     class ReplicatorOnline : public Replicator {
     protected:
@@ -509,7 +638,40 @@ namespace OpenLogReplicator {
         static constexpr std::string_view SQL_CHECK_CONNECTION
                 {"SELECT 1 FROM DUAL"};
 
+        // Rows of a snapshot segment transferred per round trip, every batch is sent as one transaction
+        static constexpr uint32_t SNAPSHOT_FETCH_ROWS{256};
+        // Batches fetched ahead of the builder per session
+        static constexpr size_t SNAPSHOT_QUEUE_BATCHES{4};
+
+        // Rows of the archived log list transferred per round trip
+        static constexpr uint32_t ARCHIVE_LOG_FETCH_ROWS{64};
+        static constexpr uint64_t ARCHIVE_LOG_PATH_SIZE{513};
+
         bool standby{false};
+        // Resetlogs of the redo log group list last read from the database, 0 before the first read
+        typeResetlogs onlineRedoResetlogs{0};
+        // Set when the schema was read from the database at the first start, only then the tables are copied
+        bool snapshotPending{false};
+        std::mutex mtxSnapshot;
+        std::condition_variable condSnapshotFull;
+        std::condition_variable condSnapshotEmpty;
+        std::deque<std::unique_ptr<SnapshotBatch>> snapshotQueue;
+        size_t snapshotQueueMax{0};
+        size_t snapshotSessions{0};
+        // Set when the builder failed, the sessions stop reading
+        std::atomic<bool> snapshotStop{false};
+        SchemaVerifier* schemaVerifier{nullptr};
+        std::mutex mtxVerify;
+        std::condition_variable condVerify;
+        // Scn the schema is verified for, none when no verification is requested
+        Scn verifyScn{Scn::none()};
+        time_ut verifyTime{0};
+        bool verifyStop{false};
+        // Last mismatch reported, the same one is not repeated
+        std::string verifyMismatch;
+
+        void readArchiveLogs(const std::string& sql, Seq sequence, bool withInstance, std::vector<ArchiveLog>& archiveLogs);
+        virtual void listArchiveLogs(std::vector<ArchiveLog>& archiveLogs);
 
         void positionReader() override;
         void loadDatabaseMetadata() override;
@@ -520,13 +682,25 @@ namespace OpenLogReplicator {
         void checkTableForGrantsFlashback(const std::string& tableName, Scn scn);
         std::string getModeName() const override;
         void verifySchema(Scn currentScn) override;
+        void verifySchemaAt(DatabaseConnection* connection, Scn targetScn);
         void createSchema() override;
-        void readSystemDictionariesMetadata(Schema* schema, Scn targetScn);
-        void readSystemDictionariesDetails(Schema* schema, Scn targetScn, typeUser user, typeObj obj);
-        void readSystemDictionaries(Schema* schema, Scn targetScn, const std::string& owner, const std::string& table, DbTable::OPTIONS options);
+        void readSystemDictionariesMetadata(DatabaseConnection* connection, Schema* schema, Scn targetScn);
+        void fetchSystemDictionariesDetails(DatabaseConnection* connection, Scn targetScn, DictionaryJob* job);
+        void mergeSystemDictionariesDetails(Schema* schema, DictionaryJob* job);
+        void runDictionaryJobs(DatabaseConnection* connection, Scn targetScn, std::vector<std::unique_ptr<DictionaryJob>>& jobs, std::atomic<size_t>& nextJob);
+        void readSystemDictionariesDetails(DatabaseConnection* connection, Schema* schema, Scn targetScn,
+                                           std::vector<std::unique_ptr<DictionaryJob>>& jobs);
+        void readSystemDictionaries(DatabaseConnection* connection, Schema* schema, Scn targetScn, const std::string& owner, const std::string& table,
+                                    DbTable::OPTIONS options);
         void createSchemaForTable(Scn targetScn, const std::string& owner, const std::string& table, const std::vector<std::string>& keyList,
                                   const std::string& key, SchemaElement::TAG_TYPE tagType, const std::vector<std::string>& tagList, const std::string& tag,
-                                  const std::string& condition, DbTable::OPTIONS options, std::unordered_map<typeObj, std::string>& tablesUpdated);
+                                  const std::string& condition, const std::vector<std::string>& columnList, const std::vector<std::string>& skipColumnList,
+                                  DbTable::OPTIONS options, std::unordered_map<typeObj, std::string>& tablesUpdated, bool readDictionaries);
+        void createSnapshot() override;
+        void planSnapshotColumns(const DbTable* table, std::vector<SnapshotColumn>& columns) const;
+        void fetchSnapshot(DatabaseConnection* connection, Scn targetScn, SnapshotJob* job);
+        void runSnapshotJobs(DatabaseConnection* connection, Scn targetScn, std::vector<std::unique_ptr<SnapshotJob>>& jobs, std::atomic<size_t>& nextJob);
+        void emitSnapshotBatch(Scn targetScn, const SnapshotBatch* batch, std::vector<const uint8_t*>& data, std::vector<typeSize>& size);
         void updateOnlineRedoLogData() override;
         void updateDatabaseIncarnation();
 
@@ -544,6 +718,8 @@ namespace OpenLogReplicator {
         DatabaseEnvironment* env;
         DatabaseConnection* conn;
         bool keepConnection;
+        // Online redo log groups are read from the database once per incarnation, log switches are followed using the redo headers
+        bool headerDiscovery{false};
 
         ReplicatorOnline(Ctx* newCtx, void (* newArchGetLog)(Replicator* replicator), Builder* newBuilder, Metadata* newMetadata,
                          TransactionBuffer* newTransactionBuffer, std::string newAlias, std::string newDatabase, std::string newUser,
@@ -551,6 +727,8 @@ namespace OpenLogReplicator {
         ~ReplicatorOnline() override;
 
         void goStandby() override;
+        void verifierRun(SchemaVerifier* verifier);
+        void verifierWakeUp();
 
         static void archGetLogOnline(Replicator* replicator);
 
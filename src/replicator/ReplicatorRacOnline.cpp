@@ -41,6 +41,7 @@
 #include "DatabaseConnection.h"
 #include "DatabaseEnvironment.h"
 #include "DatabaseStatement.h"
+#include "RacArchiveLogList.h"
 #include "ReplicatorRacOnline.h"
 
 namespace OpenLogReplicator {
@@ -79,6 +80,31 @@ namespace OpenLogReplicator {
         return SQL_GET_RAC_ARCHIVE_LOG_LIST;
     }
 
+    // Archived logs of all instances, the instance of every row is the last column
+    std::string ReplicatorRacOnline::sqlGetAllArchiveLogList() {
+        std::string SQL_GET_RAC_ALL_ARCHIVE_LOG_LIST
+                {"SELECT"
+                "   NAME"
+                ",  SEQUENCE#"
+                ",  FIRST_CHANGE#"
+                ",  NEXT_CHANGE#"
+                ",  l.INST_ID"
+                " FROM"
+                "   SYS.GV_$ARCHIVED_LOG l"
+                " JOIN SYS.GV_$INSTANCE inst ON l.INST_ID = inst.INST_ID"
+                " AND l.THREAD# = inst.THREAD#"
+                " WHERE"
+                "   SEQUENCE# >= :i"
+                "   AND RESETLOGS_ID = :j"
+                "   AND NAME IS NOT NULL "
+                " ORDER BY"
+                "   l.INST_ID"
+                ",  SEQUENCE#"
+                ",  DEST_ID"
+                ",  IS_RECOVERY_DEST_FILE DESC"};
+        return SQL_GET_RAC_ALL_ARCHIVE_LOG_LIST;
+    }
+
     std::string ReplicatorRacOnline::sqlGetDatabaseIncarnation() {
         std::string SQL_GET_RAC_DATABASE_INCARNATION
             {"SELECT"
@@ -201,6 +227,19 @@ namespace OpenLogReplicator {
             };
         return SQL_GET_RAC_PARAMETER + std::to_string(inst_id);
     }
+    void ReplicatorRacOnline::listArchiveLogs(std::vector<ArchiveLog>& archiveLogs) {
+        if (racArchiveLogList == nullptr) {
+            ReplicatorOnline::listArchiveLogs(archiveLogs);
+            return;
+        }
+
+        racArchiveLogList->list(this, inst_id, metadata->sequence, archiveLogs);
+    }
+
+    void ReplicatorRacOnline::readAllArchiveLogs(Seq sequence, std::vector<ArchiveLog>& archiveLogs) {
+        readArchiveLogs(sqlGetAllArchiveLogList(), sequence, true, archiveLogs);
+    }
+
     void ReplicatorRacOnline::setAsm(bool flag) {
         use_asm = flag;
     }
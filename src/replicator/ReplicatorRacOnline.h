@@ -8,6 +8,8 @@
 #include "ReplicatorOnline.h"
 
 namespace OpenLogReplicator {
+    class RacArchiveLogList;
+
     class ReplicatorRacOnline final : public  ReplicatorOnline {
     protected:
         int inst_id;
@@ -20,13 +22,18 @@ namespace OpenLogReplicator {
         std::string sqlGetSequenceFromScnStandby() override ;
         std::string sqlGetLogfileList() override ;
         std::string sqlGetParameter() const override;
+        std::string sqlGetAllArchiveLogList();
+        void listArchiveLogs(std::vector<ArchiveLog>& archiveLogs) override;
 
     public:
+        RacArchiveLogList* racArchiveLogList{nullptr};
+
         ReplicatorRacOnline(int inst_id, Ctx* newCtx, void (* newArchGetLog)(Replicator* replicator), Builder* newBuilder, Metadata* newMetadata,
                          TransactionBuffer* newTransactionBuffer, std::string newAlias, std::string newDatabase, std::string newUser,
                          std::string newPassword, std::string newConnectString, bool newKeepConnection);
         void setAsm(bool);
         bool getAsm();
+        void readAllArchiveLogs(Seq sequence, std::vector<ArchiveLog>& archiveLogs);
     };
 }
 
@@ -0,0 +1,74 @@
+/* Coordinates the shards of a batch source
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <algorithm>
+
+#include "../common/Ctx.h"
+#include "ShardCoordinator.h"
+
+namespace OpenLogReplicator {
+    ShardCoordinator::ShardCoordinator(Ctx* newCtx, uint newShards, uint newOverlap) :
+            ctx(newCtx),
+            running(newShards),
+            shards(newShards),
+            overlap(newOverlap) {
+    }
+
+    // The sequences are sorted and unique. Returns false when the shard has no logs to parse
+    bool ShardCoordinator::range(uint shard, const std::vector<Seq>& sequences, Seq& first, Seq& last, Seq& start) {
+        std::unique_lock<std::mutex> const lck(mtx);
+        if (ranges.empty()) {
+            const uint64_t count = sequences.size();
+            for (uint64_t i = 0; i < shards; ++i) {
+                const uint64_t begin = count * i / shards;
+                const uint64_t end = count * (i + 1) / shards;
+                if (begin == end)
+                    ranges.emplace_back(Seq::none(), Seq::none());
+                else
+                    ranges.emplace_back(sequences[begin], sequences[end - 1]);
+            }
+
+            for (uint i = 0; i < shards; ++i) {
+                if (ranges[i].first == Seq::none())
+                    ctx->info(0, "shard " + std::to_string(i) + ": no archived redo logs");
+                else
+                    ctx->info(0, "shard " + std::to_string(i) + ": sequences " + ranges[i].first.toString() + " .. " +
+                                 ranges[i].second.toString());
+            }
+        }
+
+        first = ranges[shard].first;
+        last = ranges[shard].second;
+        if (first == Seq::none())
+            return false;
+
+        // Logs of the previous shard, the transactions committed in them are output by that shard
+        auto it = std::lower_bound(sequences.begin(), sequences.end(), first);
+        const auto before = static_cast<uint64_t>(it - sequences.begin());
+        start = overlap == 0 || before == 0 ? first : *(it - std::min<uint64_t>(before, overlap));
+        return true;
+    }
+
+    // True for the last shard to finish
+    bool ShardCoordinator::finish() {
+        std::unique_lock<std::mutex> const lck(mtx);
+        --running;
+        return running == 0;
+    }
+}
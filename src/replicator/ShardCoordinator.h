@@ -0,0 +1,55 @@
+/* Header for ShardCoordinator class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef SHARD_COORDINATOR_H_
+#define SHARD_COORDINATOR_H_
+
+#include <mutex>
+#include <vector>
+
+#include "../common/types/Seq.h"
+#include "../common/types/Types.h"
+
+namespace OpenLogReplicator {
+    class Ctx;
+
+    // Shared by the shards of a batch source. The sequences found by the first shard are split once into contiguous ranges of
+    // similar number of logs, every shard parses its own range with a separate parser and builder. A shard starts a few logs before
+    // its range to collect the transactions begun there, only those committed inside the range are output
+    class ShardCoordinator final {
+    protected:
+        Ctx* ctx;
+        std::mutex mtx;
+        // First and last sequence of every shard, empty until the split is done
+        std::vector<std::pair<Seq, Seq>> ranges;
+        uint running;
+
+    public:
+        const uint shards;
+        // Number of logs parsed before the range of a shard
+        const uint overlap;
+
+        ShardCoordinator(Ctx* newCtx, uint newShards, uint newOverlap);
+
+        bool range(uint shard, const std::vector<Seq>& sequences, Seq& first, Seq& last, Seq& start);
+        [[nodiscard]] bool finish();
+    };
+}
+
+#endif
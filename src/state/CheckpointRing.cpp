@@ -0,0 +1,197 @@
+/* Writer checkpoints in a ring of binary slots
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+#include "../common/Ctx.h"
+#include "../common/exception/RuntimeException.h"
+#include "CheckpointRing.h"
+
+namespace OpenLogReplicator {
+    namespace {
+        // CRC-32C (Castagnoli), reflected polynomial
+        constexpr std::array<uint32_t, 256> crc32cTable() {
+            std::array<uint32_t, 256> table{};
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t crc = i;
+                for (uint j = 0; j < 8; ++j)
+                    crc = (crc & 1) != 0 ? (crc >> 1) ^ 0x82F63B78 : crc >> 1;
+                table[i] = crc;
+            }
+            return table;
+        }
+
+        constexpr std::array<uint32_t, 256> CRC32C_TABLE = crc32cTable();
+    }
+
+    CheckpointRing::CheckpointRing(Ctx* newCtx, std::string newFileName, uint64_t newSlots, bool newSync) :
+            ctx(newCtx),
+            fileName(std::move(newFileName)),
+            slots(newSlots),
+            sync(newSync) {
+    }
+
+    CheckpointRing::~CheckpointRing() {
+        if (fd != -1) {
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    uint32_t CheckpointRing::crc32c(const uint8_t* data, uint64_t size) {
+        uint32_t crc = 0xFFFFFFFF;
+        for (uint64_t i = 0; i < size; ++i)
+            crc = CRC32C_TABLE[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        return crc ^ 0xFFFFFFFF;
+    }
+
+    // Everything past the crc field is covered
+    uint32_t CheckpointRing::slotCrc(const Slot& slot) {
+        const auto* data = reinterpret_cast<const uint8_t*>(&slot);
+        constexpr uint64_t start = offsetof(Slot, sequence);
+        return crc32c(data + start, sizeof(Slot) - start);
+    }
+
+    // The slots keep only a checksum of the database name, enough to refuse a file of another database
+    uint32_t CheckpointRing::databaseId(const std::string& database) {
+        return crc32c(reinterpret_cast<const uint8_t*>(database.data()), database.length());
+    }
+
+    // The file is allocated once for all slots, the later writes don't change its size and fdatasync doesn't flush the metadata
+    void CheckpointRing::open() {
+        if (fd != -1)
+            return;
+
+        fd = ::open(fileName.c_str(), O_RDWR | O_CREAT, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+        if (fd == -1)
+            throw RuntimeException(10006, "file: " + fileName + " - open for writing returned: " + strerror(errno));
+
+        struct stat fileStat{};
+        if (fstat(fd, &fileStat) != 0)
+            throw RuntimeException(10003, "file: " + fileName + " - get metadata returned: " + strerror(errno));
+
+        const auto size = static_cast<off_t>(slots * sizeof(Slot));
+        if (fileStat.st_size >= size)
+            return;
+
+        const int ret = posix_fallocate(fd, 0, size);
+        if (ret != 0 && (ret != EOPNOTSUPP || ftruncate(fd, size) != 0))
+            throw RuntimeException(10007, "file: " + fileName + " - allocation of " + std::to_string(size) + " bytes returned: " +
+                                          strerror(ret != EOPNOTSUPP ? ret : errno));
+        if (fsync(fd) != 0)
+            throw RuntimeException(10075, "file: " + fileName + " - fsync returned: " + strerror(errno));
+    }
+
+    // The newest valid slot of the whole file, it may have more slots than configured when the ring was made smaller
+    bool CheckpointRing::read(uint32_t& database, Scn& scn, typeIdx& idx, typeResetlogs& resetlogs, typeActivation& activation) {
+        open();
+
+        struct stat fileStat{};
+        if (fstat(fd, &fileStat) != 0)
+            throw RuntimeException(10003, "file: " + fileName + " - get metadata returned: " + strerror(errno));
+        const uint64_t fileSlots = static_cast<uint64_t>(fileStat.st_size) / sizeof(Slot);
+
+        std::vector<Slot> buffer(fileSlots);
+        uint64_t bytesRead = 0;
+        const uint64_t size = fileSlots * sizeof(Slot);
+        auto* data = reinterpret_cast<uint8_t*>(buffer.data());
+        while (bytesRead < size) {
+            const ssize_t bytes = pread(fd, data + bytesRead, size - bytesRead, static_cast<off_t>(bytesRead));
+            if (bytes < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw RuntimeException(10001, "file: " + fileName + " - read returned: " + strerror(errno));
+            }
+            if (bytes == 0)
+                break;
+            bytesRead += bytes;
+        }
+
+        const Slot* newest = nullptr;
+        uint64_t invalid = 0;
+        for (uint64_t i = 0; i < bytesRead / sizeof(Slot); ++i) {
+            const Slot& slot = buffer[i];
+            if (slot.magic == 0 && slot.sequence == 0)
+                continue;
+            if (slot.magic != MAGIC || slot.version != VERSION || slot.crc != slotCrc(slot)) {
+                ++invalid;
+                continue;
+            }
+            if (newest == nullptr || slot.sequence > newest->sequence)
+                newest = &slot;
+        }
+
+        if (invalid > 0)
+            ctx->warning(60067, "file: " + fileName + " - skipped " + std::to_string(invalid) + " invalid checkpoint slots");
+        if (newest == nullptr)
+            return false;
+
+        sequence = newest->sequence;
+        database = newest->database;
+        scn = Scn(newest->scn);
+        idx = newest->idx;
+        resetlogs = newest->resetlogs;
+        activation = newest->activation;
+        return true;
+    }
+
+    void CheckpointRing::write(uint32_t database, Scn scn, typeIdx idx, typeResetlogs resetlogs, typeActivation activation) {
+        open();
+
+        Slot slot{};
+        slot.magic = MAGIC;
+        slot.version = VERSION;
+        slot.sequence = sequence + 1;
+        slot.scn = scn.getData();
+        slot.idx = idx;
+        slot.resetlogs = resetlogs;
+        slot.activation = activation;
+        slot.database = database;
+        slot.time = static_cast<uint64_t>(time(nullptr));
+        slot.crc = slotCrc(slot);
+
+        // A slot never crosses a sector, a torn write damages only the slot being written
+        const auto offset = static_cast<off_t>((slot.sequence % slots) * sizeof(Slot));
+        const auto* data = reinterpret_cast<const uint8_t*>(&slot);
+        uint64_t written = 0;
+        while (written < sizeof(Slot)) {
+            const ssize_t bytes = pwrite(fd, data + written, sizeof(Slot) - written, offset + static_cast<off_t>(written));
+            if (bytes < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw RuntimeException(10007, "file: " + fileName + " - " + std::to_string(written) + " bytes written instead of " +
+                                              std::to_string(sizeof(Slot)) + ", code returned: " + strerror(errno));
+            }
+            written += bytes;
+        }
+
+        if (sync && fdatasync(fd) != 0)
+            throw RuntimeException(10075, "file: " + fileName + " - fdatasync returned: " + strerror(errno));
+        sequence = slot.sequence;
+    }
+}
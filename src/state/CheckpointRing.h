@@ -0,0 +1,87 @@
+/* Header for CheckpointRing class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef CHECKPOINT_RING_H_
+#define CHECKPOINT_RING_H_
+
+#include <string>
+
+#include "../common/types/Scn.h"
+#include "../common/types/Types.h"
+
+namespace OpenLogReplicator {
+    class Ctx;
+
+    // Writer checkpoints in a preallocated file of fixed-size binary slots. Every checkpoint goes to the next slot with one pwrite, the file
+    // is never truncated or renamed. A slot torn by a crash fails its CRC and the newest valid slot is used on restart
+    class CheckpointRing final {
+    public:
+        static constexpr const char* SUFFIX{".ring"};
+        static constexpr uint64_t SLOTS_MIN{2};
+        static constexpr uint64_t SLOTS_MAX{4096};
+
+    protected:
+        static constexpr uint32_t MAGIC{0x4F4C5243};
+        static constexpr uint32_t VERSION{1};
+
+        struct Slot {
+            uint32_t magic;
+            uint32_t crc;
+            uint64_t sequence;
+            uint64_t scn;
+            uint64_t idx;
+            uint32_t resetlogs;
+            uint32_t activation;
+            uint32_t database;
+            uint32_t version;
+            uint64_t time;
+            uint64_t reserved;
+        };
+        static_assert(sizeof(Slot) == 64, "checkpoint slot size");
+
+        Ctx* ctx;
+        std::string fileName;
+        uint64_t slots;
+        bool sync;
+        int fd{-1};
+        // Sequence of the last slot written, the next one goes to slot (sequence + 1) % slots
+        uint64_t sequence{0};
+
+        [[nodiscard]] static uint32_t crc32c(const uint8_t* data, uint64_t size);
+        [[nodiscard]] static uint32_t slotCrc(const Slot& slot);
+
+    public:
+        CheckpointRing(Ctx* newCtx, std::string newFileName, uint64_t newSlots, bool newSync);
+        ~CheckpointRing();
+        CheckpointRing(const CheckpointRing&) = delete;
+        CheckpointRing& operator=(const CheckpointRing&) = delete;
+
+        [[nodiscard]] static uint32_t databaseId(const std::string& database);
+
+        void open();
+        [[nodiscard]] bool read(uint32_t& database, Scn& scn, typeIdx& idx, typeResetlogs& resetlogs, typeActivation& activation);
+        void write(uint32_t database, Scn scn, typeIdx idx, typeResetlogs resetlogs, typeActivation activation);
+
+        [[nodiscard]] const std::string& getFileName() const {
+            return fileName;
+        }
+    };
+}
+
+#endif
@@ -17,11 +17,35 @@ You should have received a copy of the GNU General Public License
 along with OpenLogReplicator; see the file LICENSE;  If not see
 <http://www.gnu.org/licenses/>.  */
 
+#include <sys/mman.h>
+
 #include "../common/Ctx.h"
 #include "State.h"
 
 namespace OpenLogReplicator {
+    StateImage::~StateImage() {
+        release();
+    }
+
+    void StateImage::release() {
+        if (mapped != nullptr) {
+            munmap(mapped, mappedSize);
+            mapped = nullptr;
+            mappedSize = 0;
+        }
+        buffer.clear();
+        data = std::string_view();
+    }
+
     State::State(Ctx* newCtx) :
             ctx(newCtx) {
     }
+
+    bool State::map(const std::string& name, uint64_t maxSize, StateImage& image) {
+        image.release();
+        if (!read(name, maxSize, image.buffer))
+            return false;
+        image.data = image.buffer;
+        return true;
+    }
 }
@@ -21,18 +21,37 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #define STATE_H_
 
 #include <set>
+#include <string_view>
 
 #include "../common/types/Types.h"
 
 namespace OpenLogReplicator {
     class Ctx;
 
+    // Contents of a state entry read for one use. When the state can map the file the data stays in the page cache, otherwise it is
+    // copied to the buffer
+    class StateImage final {
+    public:
+        std::string buffer;
+        void* mapped{nullptr};
+        uint64_t mappedSize{0};
+        std::string_view data;
+
+        StateImage() = default;
+        StateImage(const StateImage&) = delete;
+        StateImage& operator=(const StateImage&) = delete;
+        ~StateImage();
+
+        void release();
+    };
+
     class State {
     protected:
         Ctx* ctx;
 
     public:
         static constexpr uint64_t TYPE_DISK{0};
+        static constexpr uint64_t TYPE_REDIS{1};
 
         explicit State(Ctx* newCtx);
         virtual ~State() = default;
@@ -41,6 +60,7 @@ namespace OpenLogReplicator {
         [[nodiscard]] virtual bool read(const std::string& name, uint64_t maxSize, std::string& in) = 0;
         virtual void write(const std::string& name, Scn scn, const std::ostringstream& out) = 0;
         virtual void drop(const std::string& name) = 0;
+        [[nodiscard]] virtual bool map(const std::string& name, uint64_t maxSize, StateImage& image);
     };
 }
 
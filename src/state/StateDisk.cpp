@@ -20,7 +20,10 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include <cerrno>
 #include <cstring>
 #include <dirent.h>
+#include <fcntl.h>
 #include <fstream>
+#include <sstream>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -29,12 +32,30 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include "StateDisk.h"
 
 namespace OpenLogReplicator {
-    StateDisk::StateDisk(Ctx* newCtx, std::string newPath) :
+    StateDisk::StateDisk(Ctx* newCtx, std::string newPath, std::string newSuffix) :
             State(newCtx),
-            path(std::move(newPath)) {
+            path(std::move(newPath)),
+            suffix(std::move(newSuffix)) {
     }
 
-    void StateDisk::list(std::set<std::string>& namesList) const {
+    // Files written with the other format are still found, so switching the format keeps the checkpoints
+    std::string StateDisk::findFile(const std::string& name) const {
+        const std::string fileName(path + "/" + name + suffix);
+        if (suffix == JSON_SUFFIX)
+            return fileName;
+
+        struct stat fileStat{};
+        if (stat(fileName.c_str(), &fileStat) == 0)
+            return fileName;
+
+        const std::string jsonFileName(path + "/" + name + JSON_SUFFIX);
+        if (stat(jsonFileName.c_str(), &fileStat) == 0)
+            return jsonFileName;
+        return fileName;
+    }
+
+    // Checkpoints written before the manifest existed are found by a directory scan, the manifest is created with the next write
+    void StateDisk::scanDirectory() const {
         DIR* dir = opendir(path.c_str());
         if (dir == nullptr)
             throw RuntimeException(10012, "directory: " + path + " - can't read");
@@ -57,18 +78,105 @@ namespace OpenLogReplicator {
             if (S_ISDIR(fileStat.st_mode))
                 continue;
 
-            const std::string suffix(".json");
-            if (fileName.length() < suffix.length() || fileName.substr(fileName.length() - suffix.length(), fileName.length()) != suffix)
-                continue;
+            for (const std::string& fileSuffix: {std::string(JSON_SUFFIX), suffix}) {
+                if (fileName.length() < fileSuffix.length() ||
+                    fileName.substr(fileName.length() - fileSuffix.length(), fileName.length()) != fileSuffix)
+                    continue;
 
-            const std::string fileBase(fileName.substr(0, fileName.length() - suffix.length()));
-            namesList.insert(fileBase);
+                const std::string fileBase(fileName.substr(0, fileName.length() - fileSuffix.length()));
+                index.emplace(fileBase, Scn::none());
+                break;
+            }
         }
         closedir(dir);
     }
 
+    void StateDisk::loadIndex() const {
+        if (indexLoaded)
+            return;
+        indexLoaded = true;
+
+        const std::string fileName(path + "/" + MANIFEST_NAME);
+        std::ifstream inputStream(fileName.c_str(), std::ios::in);
+        if (!inputStream.is_open()) {
+            scanDirectory();
+            return;
+        }
+
+        std::string line;
+        while (std::getline(inputStream, line)) {
+            const auto space = line.find(' ');
+            if (space == std::string::npos || space == 0 || space + 1 == line.length()) {
+                ctx->warning(10003, "file: " + fileName + " - invalid line: " + line + ", scanning directory");
+                index.clear();
+                scanDirectory();
+                return;
+            }
+            index.insert_or_assign(line.substr(space + 1), Scn(strtoull(line.substr(0, space).c_str(), nullptr, 10)));
+        }
+    }
+
+    void StateDisk::writeManifest() const {
+        std::ostringstream ss;
+        for (const auto& [name, scn]: index)
+            ss << scn.getData() << ' ' << name << '\n';
+        writeAtomic(path + "/" + MANIFEST_NAME, ss.str());
+    }
+
+    // Written to a temporary file, synced and renamed over, so a crash leaves either the old or the new content
+    void StateDisk::writeAtomic(const std::string& fileName, const std::string& data) const {
+        const std::string tempFileName(fileName + TEMP_SUFFIX);
+        const int fd = open(tempFileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+        if (fd == -1)
+            throw RuntimeException(10006, "file: " + tempFileName + " - open for writing returned: " + strerror(errno));
+
+        uint64_t written = 0;
+        while (written < data.length()) {
+            const ssize_t bytes = ::write(fd, data.data() + written, data.length() - written);
+            if (bytes < 0) {
+                if (errno == EINTR)
+                    continue;
+                const int err = errno;
+                close(fd);
+                throw RuntimeException(10007, "file: " + tempFileName + " - " + std::to_string(written) + " bytes written instead of " +
+                                              std::to_string(data.length()) + ", code returned: " + strerror(err));
+            }
+            written += bytes;
+        }
+
+        if (fsync(fd) != 0) {
+            const int err = errno;
+            close(fd);
+            throw RuntimeException(10075, "file: " + tempFileName + " - fsync returned: " + strerror(err));
+        }
+        close(fd);
+
+        if (rename(tempFileName.c_str(), fileName.c_str()) != 0)
+            throw RuntimeException(10085, "file: " + tempFileName + " - rename to " + fileName + " returned: " + strerror(errno));
+        syncDirectory();
+    }
+
+    void StateDisk::syncDirectory() const {
+        const int fd = open(path.c_str(), O_RDONLY | O_DIRECTORY);
+        if (fd == -1)
+            throw RuntimeException(10012, "directory: " + path + " - can't read");
+        if (fsync(fd) != 0) {
+            const int err = errno;
+            close(fd);
+            throw RuntimeException(10075, "directory: " + path + " - fsync returned: " + strerror(err));
+        }
+        close(fd);
+    }
+
+    void StateDisk::list(std::set<std::string>& namesList) const {
+        std::unique_lock<std::mutex> const lck(mtx);
+        loadIndex();
+        for (const auto& [name, _]: index)
+            namesList.insert(name);
+    }
+
     bool StateDisk::read(const std::string& name, uint64_t maxSize, std::string& in) {
-        const std::string fileName(path + "/" + name + ".json");
+        const std::string fileName(findFile(name));
         struct stat fileStat{};
         if (stat(fileName.c_str(), &fileStat) != 0) {
             ctx->warning(10003, "file: " + fileName + " - get metadata returned: " + strerror(errno));
@@ -79,7 +187,7 @@ namespace OpenLogReplicator {
 
         in.resize(fileStat.st_size);
         std::ifstream inputStream;
-        inputStream.open(fileName.c_str(), std::ios::in);
+        inputStream.open(fileName.c_str(), std::ios::in | std::ios::binary);
 
         if (!inputStream.is_open())
             throw RuntimeException(10001, "file: " + fileName + " - open for read returned: " + strerror(errno));
@@ -92,25 +200,63 @@ namespace OpenLogReplicator {
         return true;
     }
 
-    void StateDisk::write(const std::string& name, Scn scn __attribute__((unused)), const std::ostringstream& out) {
-        const std::string fileName(path + "/" + name + ".json");
-        std::ofstream outputStream;
+    // Schema checkpoints are decoded straight from the page cache, a restart doesn't copy the whole file first
+    bool StateDisk::map(const std::string& name, uint64_t maxSize, StateImage& image) {
+        image.release();
+        const std::string fileName(findFile(name));
+        const int fd = open(fileName.c_str(), O_RDONLY);
+        if (fd == -1) {
+            ctx->warning(10003, "file: " + fileName + " - get metadata returned: " + strerror(errno));
+            return false;
+        }
 
-        outputStream.open(fileName.c_str(), std::ios::out | std::ios::trunc);
-        if (!outputStream.is_open())
-            throw RuntimeException(10006, "file: " + fileName + " - open for writing returned: " + strerror(errno));
+        struct stat fileStat{};
+        if (fstat(fd, &fileStat) != 0) {
+            const int err = errno;
+            close(fd);
+            ctx->warning(10003, "file: " + fileName + " - get metadata returned: " + strerror(err));
+            return false;
+        }
+        if (static_cast<uint64_t>(fileStat.st_size) > maxSize || fileStat.st_size == 0) {
+            close(fd);
+            throw RuntimeException(10004, "file: " + fileName + " - wrong size: " + std::to_string(fileStat.st_size));
+        }
 
-        outputStream << out.str();
-        if (outputStream.bad() || outputStream.fail())
-            throw RuntimeException(10007, "file: " + fileName + " - 0 bytes written instead of " +
-                                          std::to_string(out.str().length()) + ", code returned: " + strerror(errno));
+        void* mapped = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        const int err = errno;
+        close(fd);
+        if (mapped == MAP_FAILED)
+            throw RuntimeException(10001, "file: " + fileName + " - mmap returned: " + strerror(err));
+        madvise(mapped, fileStat.st_size, MADV_SEQUENTIAL);
 
-        outputStream.close();
+        image.mapped = mapped;
+        image.mappedSize = fileStat.st_size;
+        image.data = std::string_view(static_cast<const char*>(mapped), fileStat.st_size);
+        return true;
+    }
+
+    void StateDisk::write(const std::string& name, Scn scn, const std::ostringstream& out) {
+        writeAtomic(path + "/" + name + suffix, out.str());
+
+        std::unique_lock<std::mutex> const lck(mtx);
+        loadIndex();
+        index.insert_or_assign(name, scn);
+        writeManifest();
     }
 
     void StateDisk::drop(const std::string& name) {
-        const std::string fileName(path + "/" + name + ".json");
-        if (unlink(fileName.c_str()) != 0)
-            throw RuntimeException(10010, "file: " + fileName + " - delete returned: " + strerror(errno));
+        const std::string fileName(findFile(name));
+        const bool unlinked = unlink(fileName.c_str()) == 0;
+        const int err = errno;
+
+        {
+            std::unique_lock<std::mutex> const lck(mtx);
+            loadIndex();
+            if (index.erase(name) > 0)
+                writeManifest();
+        }
+
+        if (!unlinked)
+            throw RuntimeException(10010, "file: " + fileName + " - delete returned: " + strerror(err));
     }
 }
@@ -20,20 +20,41 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #ifndef STATE_DISK_H_
 #define STATE_DISK_H_
 
+#include <map>
+#include <mutex>
+
 #include "State.h"
 
 namespace OpenLogReplicator {
     class StateDisk final : public State {
     protected:
+        static constexpr const char* JSON_SUFFIX{".json"};
+        static constexpr const char* TEMP_SUFFIX{".tmp"};
+        static constexpr const char* MANIFEST_NAME{"manifest.idx"};
+
         std::string path;
+        std::string suffix;
+
+        // Names of the stored entries with their scn, mirrored in the manifest file
+        mutable std::mutex mtx;
+        mutable std::map<std::string, Scn> index;
+        mutable bool indexLoaded{false};
+
+        [[nodiscard]] std::string findFile(const std::string& name) const;
+        void scanDirectory() const;
+        void loadIndex() const;
+        void writeManifest() const;
+        void writeAtomic(const std::string& fileName, const std::string& data) const;
+        void syncDirectory() const;
 
     public:
-        explicit StateDisk(Ctx* newCtx, std::string newPath);
+        StateDisk(Ctx* newCtx, std::string newPath, std::string newSuffix = JSON_SUFFIX);
         StateDisk(const StateDisk&) = delete;
         StateDisk& operator=(const StateDisk&) = delete;
 
         void list(std::set<std::string>& namesList) const override;
         [[nodiscard]] bool read(const std::string& name, uint64_t maxSize, std::string& in) override;
+        [[nodiscard]] bool map(const std::string& name, uint64_t maxSize, StateImage& image) override;
         void write(const std::string& name, Scn scn, const std::ostringstream& out) override;
         void drop(const std::string& name) override;
     };
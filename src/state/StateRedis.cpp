@@ -0,0 +1,394 @@
+/* Base class for state kept in a Redis server
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <cerrno>
+#include <cstring>
+#include <netdb.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "../common/Ctx.h"
+#include "../common/exception/RuntimeException.h"
+#include "StateRedis.h"
+
+namespace OpenLogReplicator {
+    StateRedis::StateRedis(Ctx* newCtx, const std::string& newServer, std::string newPrefix) :
+            State(newCtx),
+            prefix(std::move(newPrefix)) {
+        const auto colon = newServer.rfind(':');
+        if (colon == std::string::npos) {
+            host = newServer;
+            port = "6379";
+        } else {
+            host = newServer.substr(0, colon);
+            port = newServer.substr(colon + 1);
+        }
+
+        flusher = std::thread(&StateRedis::flushLoop, this);
+    }
+
+    StateRedis::~StateRedis() {
+        {
+            std::unique_lock<std::mutex> const lck(mtxPending);
+            stopping = true;
+            condFlush.notify_all();
+        }
+        if (flusher.joinable())
+            flusher.join();
+        disconnectServer();
+    }
+
+    void StateRedis::connectServer() const {
+        if (socketFD != -1)
+            return;
+
+        struct addrinfo hints{};
+        memset(reinterpret_cast<void*>(&hints), 0, sizeof hints);
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+
+        struct addrinfo* res = nullptr;
+        if (getaddrinfo(host.c_str(), port.c_str(), &hints, &res) != 0 || res == nullptr)
+            throw RuntimeException(10084, "state server: " + host + ":" + port + " - can't resolve address");
+
+        const int fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+        if (fd < 0) {
+            freeaddrinfo(res);
+            throw RuntimeException(10084, "state server: " + host + ":" + port + " - socket returned: " + strerror(errno));
+        }
+
+        // A stalled server must not hang the checkpoint thread forever
+        struct timeval timeout{5, 0};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        int flag = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+
+        if (connect(fd, res->ai_addr, res->ai_addrlen) < 0) {
+            const int err = errno;
+            close(fd);
+            freeaddrinfo(res);
+            throw RuntimeException(10084, "state server: " + host + ":" + port + " - connect returned: " + strerror(err));
+        }
+        freeaddrinfo(res);
+
+        socketFD = fd;
+        receiveBuffer.clear();
+    }
+
+    void StateRedis::disconnectServer() const {
+        if (socketFD == -1)
+            return;
+        close(socketFD);
+        socketFD = -1;
+        receiveBuffer.clear();
+    }
+
+    void StateRedis::sendAll(const std::string& data) const {
+        uint64_t sent = 0;
+        while (sent < data.length()) {
+            const ssize_t bytes = send(socketFD, data.data() + sent, data.length() - sent, MSG_NOSIGNAL);
+            if (bytes < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw RuntimeException(10084, "state server: " + host + ":" + port + " - send returned: " + strerror(errno));
+            }
+            sent += bytes;
+        }
+    }
+
+    void StateRedis::receiveMore() const {
+        char buffer[RECEIVE_BUFFER_SIZE];
+        while (true) {
+            const ssize_t bytes = recv(socketFD, buffer, sizeof(buffer), 0);
+            if (bytes > 0) {
+                receiveBuffer.append(buffer, bytes);
+                return;
+            }
+            if (bytes < 0 && errno == EINTR)
+                continue;
+            if (bytes == 0)
+                throw RuntimeException(10084, "state server: " + host + ":" + port + " - connection closed");
+            throw RuntimeException(10084, "state server: " + host + ":" + port + " - receive returned: " + strerror(errno));
+        }
+    }
+
+    std::string StateRedis::receiveLine() const {
+        auto pos = receiveBuffer.find("\r\n");
+        while (pos == std::string::npos) {
+            receiveMore();
+            pos = receiveBuffer.find("\r\n");
+        }
+        std::string line(receiveBuffer, 0, pos);
+        receiveBuffer.erase(0, pos + 2);
+        return line;
+    }
+
+    // Minimal RESP reply parser, nested arrays are not used by any of the commands sent
+    void StateRedis::receiveReply(std::string& value, bool& isNull, std::vector<std::string>* array) const {
+        const std::string line(receiveLine());
+        if (line.empty())
+            throw RuntimeException(10084, "state server: " + host + ":" + port + " - empty reply");
+
+        isNull = false;
+        switch (line[0]) {
+            case '+':
+            case ':':
+                value = line.substr(1);
+                return;
+
+            case '-':
+                throw RuntimeException(10084, "state server: " + host + ":" + port + " - error: " + line.substr(1));
+
+            case '$': {
+                const int64_t length = std::stoll(line.substr(1));
+                if (length < 0) {
+                    isNull = true;
+                    return;
+                }
+                while (receiveBuffer.length() < static_cast<uint64_t>(length) + 2)
+                    receiveMore();
+                value.assign(receiveBuffer, 0, length);
+                receiveBuffer.erase(0, length + 2);
+                return;
+            }
+
+            case '*': {
+                const int64_t count = std::stoll(line.substr(1));
+                if (count < 0) {
+                    isNull = true;
+                    return;
+                }
+                if (array == nullptr)
+                    throw RuntimeException(10084, "state server: " + host + ":" + port + " - unexpected array reply");
+                array->reserve(count);
+                for (int64_t i = 0; i < count; ++i) {
+                    std::string element;
+                    bool elementNull;
+                    receiveReply(element, elementNull, nullptr);
+                    array->push_back(std::move(element));
+                }
+                return;
+            }
+
+            default:
+                throw RuntimeException(10084, "state server: " + host + ":" + port + " - invalid reply: " + line);
+        }
+    }
+
+    void StateRedis::appendCommand(std::string& data, std::initializer_list<const std::string*> args) {
+        data.append("*" + std::to_string(args.size()) + "\r\n");
+        for (const std::string* arg: args) {
+            data.append("$" + std::to_string(arg->length()) + "\r\n");
+            data.append(*arg);
+            data.append("\r\n");
+        }
+    }
+
+    std::string StateRedis::keyName(const std::string& name) const {
+        return prefix + name;
+    }
+
+    // Set of all stored names, so that listing does not need to scan the key space
+    std::string StateRedis::indexName() const {
+        return prefix + "index";
+    }
+
+    const StateRedis::PendingOp* StateRedis::findPending(const std::string& name) const {
+        const auto it = pendingIndex.find(name);
+        if (it != pendingIndex.end())
+            return &pending[it->second];
+
+        for (auto op = flushing.rbegin(); op != flushing.rend(); ++op)
+            if (op->name == name)
+                return &*op;
+        return nullptr;
+    }
+
+    void StateRedis::queue(const std::string& name, std::string payload, bool drop) {
+        std::unique_lock<std::mutex> const lck(mtxPending);
+        const auto it = pendingIndex.find(name);
+        if (it != pendingIndex.end()) {
+            pending[it->second].payload = std::move(payload);
+            pending[it->second].drop = drop;
+            return;
+        }
+
+        pendingIndex.emplace(name, pending.size());
+        pending.push_back({name, std::move(payload), drop});
+        condFlush.notify_all();
+    }
+
+    void StateRedis::flushPending(const std::deque<PendingOp>& ops) const {
+        static const std::string SET("SET");
+        static const std::string DEL("DEL");
+        static const std::string SADD("SADD");
+        static const std::string SREM("SREM");
+        const std::string index(indexName());
+
+        std::string data;
+        for (const PendingOp& op: ops) {
+            const std::string key(keyName(op.name));
+            if (op.drop) {
+                appendCommand(data, {&DEL, &key});
+                appendCommand(data, {&SREM, &index, &op.name});
+            } else {
+                appendCommand(data, {&SET, &key, &op.payload});
+                appendCommand(data, {&SADD, &index, &op.name});
+            }
+        }
+
+        std::unique_lock<std::mutex> const lck(mtxSocket);
+        try {
+            connectServer();
+            sendAll(data);
+            std::string value;
+            bool isNull;
+            for (uint64_t i = 0; i < ops.size() * 2; ++i)
+                receiveReply(value, isNull, nullptr);
+        } catch (RuntimeException&) {
+            disconnectServer();
+            throw;
+        }
+    }
+
+    // Operations are collected for FLUSH_INTERVAL_US and sent in one round trip, a failed batch is retried before newer ones
+    void StateRedis::flushLoop() {
+        std::unique_lock<std::mutex> lck(mtxPending);
+        while (true) {
+            condFlush.wait(lck, [this] { return stopping || !pending.empty() || !flushing.empty(); });
+            if (!stopping)
+                condFlush.wait_for(lck, std::chrono::microseconds(FLUSH_INTERVAL_US), [this] { return stopping; });
+
+            if (flushing.empty()) {
+                if (pending.empty())
+                    break;
+                flushing.swap(pending);
+                pendingIndex.clear();
+            }
+
+            lck.unlock();
+            bool flushed = true;
+            try {
+                flushPending(flushing);
+            } catch (RuntimeException& ex) {
+                ctx->warning(60041, "state write of " + std::to_string(flushing.size()) + " entries failed: " + ex.msg);
+                flushed = false;
+            }
+            lck.lock();
+
+            if (flushed)
+                flushing.clear();
+            else if (stopping) {
+                // Do not retry endlessly on shutdown, the next start resumes from the last confirmed checkpoint
+                flushing.clear();
+                pending.clear();
+                pendingIndex.clear();
+                break;
+            } else
+                condFlush.wait_for(lck, std::chrono::microseconds(FLUSH_INTERVAL_US * 10), [this] { return stopping; });
+        }
+    }
+
+    void StateRedis::list(std::set<std::string>& namesList) const {
+        static const std::string SMEMBERS("SMEMBERS");
+        const std::string index(indexName());
+        std::string data;
+        appendCommand(data, {&SMEMBERS, &index});
+
+        std::vector<std::string> names;
+        {
+            std::unique_lock<std::mutex> const lck(mtxSocket);
+            try {
+                connectServer();
+                sendAll(data);
+                std::string value;
+                bool isNull;
+                receiveReply(value, isNull, &names);
+            } catch (RuntimeException&) {
+                disconnectServer();
+                throw;
+            }
+        }
+
+        for (std::string& name: names)
+            namesList.insert(std::move(name));
+
+        std::unique_lock<std::mutex> const lck(mtxPending);
+        for (const std::deque<PendingOp>* ops: {&flushing, &pending}) {
+            for (const PendingOp& op: *ops) {
+                if (op.drop)
+                    namesList.erase(op.name);
+                else
+                    namesList.insert(op.name);
+            }
+        }
+    }
+
+    bool StateRedis::read(const std::string& name, uint64_t maxSize, std::string& in) {
+        const std::string key(keyName(name));
+        {
+            std::unique_lock<std::mutex> const lck(mtxPending);
+            const PendingOp* op = findPending(name);
+            if (op != nullptr) {
+                if (op->drop)
+                    return false;
+                if (op->payload.length() > maxSize || op->payload.empty())
+                    throw RuntimeException(10004, "state: " + key + " - wrong size: " + std::to_string(op->payload.length()));
+                in = op->payload;
+                return true;
+            }
+        }
+
+        static const std::string GET("GET");
+        std::string data;
+        appendCommand(data, {&GET, &key});
+
+        bool isNull;
+        {
+            std::unique_lock<std::mutex> const lck(mtxSocket);
+            try {
+                connectServer();
+                sendAll(data);
+                receiveReply(in, isNull, nullptr);
+            } catch (RuntimeException&) {
+                disconnectServer();
+                throw;
+            }
+        }
+
+        if (isNull) {
+            ctx->warning(60041, "state: " + key + " - not found");
+            return false;
+        }
+        if (in.length() > maxSize || in.empty())
+            throw RuntimeException(10004, "state: " + key + " - wrong size: " + std::to_string(in.length()));
+        return true;
+    }
+
+    void StateRedis::write(const std::string& name, Scn scn __attribute__((unused)), const std::ostringstream& out) {
+        queue(name, out.str(), false);
+    }
+
+    void StateRedis::drop(const std::string& name) {
+        queue(name, "", true);
+    }
+}
@@ -0,0 +1,90 @@
+/* Header for StateRedis class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef STATE_REDIS_H_
+#define STATE_REDIS_H_
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "State.h"
+
+namespace OpenLogReplicator {
+    // State kept in a Redis server, writes are batched and sent by a background thread in one pipeline
+    class StateRedis final : public State {
+    protected:
+        static constexpr uint64_t FLUSH_INTERVAL_US{100000};
+        static constexpr uint64_t RECEIVE_BUFFER_SIZE{65536};
+
+        struct PendingOp {
+            std::string name;
+            std::string payload;
+            bool drop;
+        };
+
+        std::string host;
+        std::string port;
+        std::string prefix;
+
+        mutable std::mutex mtxSocket;
+        mutable int socketFD{-1};
+        mutable std::string receiveBuffer;
+
+        // Operations not yet sent, in order of first use, only the latest one per name is kept
+        mutable std::mutex mtxPending;
+        std::condition_variable condFlush;
+        std::deque<PendingOp> pending;
+        std::unordered_map<std::string, uint64_t> pendingIndex;
+        // Operations taken by the flusher, kept visible to readers until the server confirms them
+        std::deque<PendingOp> flushing;
+        bool stopping{false};
+        std::thread flusher;
+
+        void connectServer() const;
+        void disconnectServer() const;
+        void sendAll(const std::string& data) const;
+        void receiveMore() const;
+        [[nodiscard]] std::string receiveLine() const;
+        void receiveReply(std::string& value, bool& isNull, std::vector<std::string>* array) const;
+        static void appendCommand(std::string& data, std::initializer_list<const std::string*> args);
+        [[nodiscard]] std::string keyName(const std::string& name) const;
+        [[nodiscard]] std::string indexName() const;
+        [[nodiscard]] const PendingOp* findPending(const std::string& name) const;
+        void queue(const std::string& name, std::string payload, bool drop);
+        void flushPending(const std::deque<PendingOp>& ops) const;
+        void flushLoop();
+
+    public:
+        StateRedis(Ctx* newCtx, const std::string& newServer, std::string newPrefix);
+        ~StateRedis() override;
+        StateRedis(const StateRedis&) = delete;
+        StateRedis& operator=(const StateRedis&) = delete;
+
+        void list(std::set<std::string>& namesList) const override;
+        [[nodiscard]] bool read(const std::string& name, uint64_t maxSize, std::string& in) override;
+        void write(const std::string& name, Scn scn, const std::ostringstream& out) override;
+        void drop(const std::string& name) override;
+    };
+}
+
+#endif
@@ -42,6 +42,25 @@ namespace OpenLogReplicator {
         virtual void initializeClient() = 0;
         virtual void initializeServer() = 0;
         virtual void sendMessage(const void* msg, uint64_t length) = 0;
+        // The message may be held until flush(), so it must stay valid until then
+        virtual void queueMessage(const void* msg, uint64_t length) {
+            sendMessage(msg, length);
+        }
+        // Without force only a batch older than the latency limit is sent
+        virtual void flush(bool force __attribute__((unused))) {}
+        // Refreshes socket readiness once per poll loop, so idle sockets cost no system calls
+        virtual void pollEvents() {}
+        // Frames written after setCompression() are compressed, the peer decompresses whatever it gets
+        [[nodiscard]] virtual bool supportsCompression(const std::string& method) const {
+            return method.empty();
+        }
+        virtual void setCompression(const std::string& method __attribute__((unused))) {}
+        // Listening stream of a multi-client server hands out one stream per connected client, nullptr when none waits
+        [[nodiscard]] virtual Stream* acceptClient() {
+            return nullptr;
+        }
+        // Messages still held by the stream are copied, so the memory they point to can be released
+        virtual void copyQueued() {}
         virtual uint64_t receiveMessage(void* msg, uint64_t length) = 0;
         virtual uint64_t receiveMessageNB(void* msg, uint64_t length) = 0;
         [[nodiscard]] virtual bool isConnected() = 0;
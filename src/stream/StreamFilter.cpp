@@ -0,0 +1,264 @@
+/* Server side filter of messages sent to stream clients
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <algorithm>
+#include <set>
+
+#include "StreamFilter.h"
+
+namespace OpenLogReplicator {
+    uint64_t StreamFilter::countRules(const pb::RedoRequest& request) {
+        uint64_t count = 0;
+        for (const pb::SchemaRequest& schema: request.schema())
+            if (schema.mask().empty() || schema.mask()[0] != '@')
+                ++count;
+        return count;
+    }
+
+    std::string StreamFilter::getOption(const pb::RedoRequest& request, const std::string& name) {
+        for (const pb::SchemaRequest& schema: request.schema())
+            if (!schema.mask().empty() && schema.mask()[0] == '@' && schema.mask().compare(1, std::string::npos, name) == 0)
+                return schema.filter();
+        return "";
+    }
+
+    bool StreamFilter::initialize(const pb::RedoRequest& request, std::string& error) {
+        rules.clear();
+        key.clear();
+
+        for (const pb::SchemaRequest& schema: request.schema()) {
+            Rule rule;
+            const std::string& mask = schema.mask();
+            if (!mask.empty() && mask[0] == '@')
+                continue;
+            const auto dot = mask.find('.');
+            if (dot == std::string::npos) {
+                rule.ownerMask = mask;
+                rule.tableMask = "*";
+            } else {
+                rule.ownerMask = mask.substr(0, dot);
+                rule.tableMask = mask.substr(dot + 1);
+            }
+            if (rule.ownerMask.empty() || rule.tableMask.empty()) {
+                error = "invalid subscription mask: " + mask;
+                return false;
+            }
+
+            rule.ops = 0;
+            std::set<std::string> sortedColumns;
+            const std::string& filter = schema.filter();
+            uint64_t pos = 0;
+            while (pos < filter.length()) {
+                uint64_t end = filter.find(';', pos);
+                if (end == std::string::npos)
+                    end = filter.length();
+                const std::string option = filter.substr(pos, end - pos);
+                pos = end + 1;
+                if (option.empty())
+                    continue;
+
+                const auto eq = option.find('=');
+                if (eq == std::string::npos) {
+                    error = "invalid subscription filter: " + filter;
+                    return false;
+                }
+                const std::string name = option.substr(0, eq);
+                std::vector<std::string> values;
+                uint64_t valuePos = eq + 1;
+                while (valuePos <= option.length()) {
+                    uint64_t valueEnd = option.find(',', valuePos);
+                    if (valueEnd == std::string::npos)
+                        valueEnd = option.length();
+                    if (valueEnd > valuePos)
+                        values.push_back(option.substr(valuePos, valueEnd - valuePos));
+                    valuePos = valueEnd + 1;
+                }
+
+                if (name == "op") {
+                    for (const std::string& value: values) {
+                        if (value == "insert")
+                            rule.ops |= 1U << pb::Op::INSERT;
+                        else if (value == "update")
+                            rule.ops |= 1U << pb::Op::UPDATE;
+                        else if (value == "delete")
+                            rule.ops |= 1U << pb::Op::DELETE;
+                        else if (value == "ddl")
+                            rule.ops |= 1U << pb::Op::DDL;
+                        else {
+                            error = "invalid subscription op: " + value + R"(, expected: one of {"insert", "update", "delete", "ddl"})";
+                            return false;
+                        }
+                    }
+                } else if (name == "columns") {
+                    sortedColumns.insert(values.begin(), values.end());
+                } else {
+                    error = "invalid subscription filter option: " + name + R"(, expected: one of {"op", "columns"})";
+                    return false;
+                }
+            }
+
+            // No op list means all of them
+            if (rule.ops == 0)
+                rule.ops = (1U << pb::Op::INSERT) | (1U << pb::Op::UPDATE) | (1U << pb::Op::DELETE) | (1U << pb::Op::DDL);
+            rule.columns.insert(sortedColumns.begin(), sortedColumns.end());
+
+            // Equal subscriptions get equal keys, whatever the order of ops and columns
+            key += rule.ownerMask + "." + rule.tableMask + ":" + std::to_string(rule.ops) + ":";
+            for (const std::string& column: sortedColumns)
+                key += column + ",";
+            key += "\n";
+            rules.push_back(std::move(rule));
+        }
+
+        return true;
+    }
+
+    bool StreamFilter::matchMask(const char* mask, const char* name) {
+        const char* star = nullptr;
+        const char* starName = nullptr;
+        while (*name != 0) {
+            if (*mask == '?' || *mask == *name) {
+                ++mask;
+                ++name;
+            } else if (*mask == '*') {
+                star = mask++;
+                starName = name;
+            } else if (star != nullptr) {
+                mask = star + 1;
+                name = ++starName;
+            } else
+                return false;
+        }
+        while (*mask == '*')
+            ++mask;
+        return *mask == 0;
+    }
+
+    const StreamFilter::Rule* StreamFilter::match(const pb::Payload& payload) const {
+        const uint opBit = 1U << payload.op();
+        for (const Rule& rule: rules) {
+            if ((rule.ops & opBit) == 0)
+                continue;
+            if (matchMask(rule.ownerMask.c_str(), payload.schema().owner().c_str()) &&
+                    matchMask(rule.tableMask.c_str(), payload.schema().name().c_str()))
+                return &rule;
+        }
+        return nullptr;
+    }
+
+    template<typename T>
+    static bool projectFields(google::protobuf::RepeatedPtrField<T>* fields, const std::unordered_set<std::string>& columns) {
+        int kept = 0;
+        for (int i = 0; i < fields->size(); ++i) {
+            if (columns.find(fields->Get(i).name()) == columns.end())
+                continue;
+            if (kept != i)
+                fields->SwapElements(kept, i);
+            ++kept;
+        }
+        if (kept == fields->size())
+            return false;
+        fields->DeleteSubrange(kept, fields->size() - kept);
+        return true;
+    }
+
+    bool StreamFilter::project(pb::Payload* payload, const std::unordered_set<std::string>& columns) {
+        bool changed = projectFields(payload->mutable_before(), columns);
+        changed |= projectFields(payload->mutable_after(), columns);
+        if (payload->has_schema())
+            changed |= projectFields(payload->mutable_schema()->mutable_column(), columns);
+        return changed;
+    }
+
+    // The result for the last message is kept, so clients with the same subscription decode every message once
+    StreamFilter::RESULT StreamFilter::apply(uint64_t id, const uint8_t* data, uint64_t size) {
+        if (id == lastId)
+            return lastResult;
+        lastId = id;
+
+        response.Clear();
+        if (!response.ParseFromArray(data, static_cast<int>(size))) {
+            lastResult = RESULT::ORIGINAL;
+            return lastResult;
+        }
+
+        bool changed = false;
+        bool hadData = false;
+        bool keptData = false;
+        auto* payloads = response.mutable_payload();
+        int kept = 0;
+        for (int i = 0; i < payloads->size(); ++i) {
+            pb::Payload* payload = payloads->Mutable(i);
+            const pb::Op op = payload->op();
+            if (op == pb::Op::INSERT || op == pb::Op::UPDATE || op == pb::Op::DELETE || op == pb::Op::DDL) {
+                hadData = true;
+                const Rule* rule = match(*payload);
+                if (rule == nullptr) {
+                    changed = true;
+                    continue;
+                }
+                keptData = true;
+                if (!rule->columns.empty() && project(payload, rule->columns))
+                    changed = true;
+            }
+
+            if (kept != i)
+                payloads->SwapElements(kept, i);
+            ++kept;
+        }
+
+        if (hadData && !keptData)
+            lastResult = RESULT::SKIP;
+        else if (!changed)
+            lastResult = RESULT::ORIGINAL;
+        else {
+            payloads->DeleteSubrange(kept, payloads->size() - kept);
+            response.SerializeToString(&output);
+            lastResult = RESULT::FILTERED;
+        }
+        return lastResult;
+    }
+
+    bool StreamFilter::isTableOnly() const {
+        const uint allOps = (1U << pb::Op::INSERT) | (1U << pb::Op::UPDATE) | (1U << pb::Op::DELETE) | (1U << pb::Op::DDL);
+        for (const Rule& rule: rules)
+            if (rule.ops != allOps || !rule.columns.empty())
+                return false;
+        return true;
+    }
+
+    StreamFilter::RESULT StreamFilter::applyTable(uint64_t id, const std::string* owner, const std::string* table) {
+        if (id == lastId)
+            return lastResult;
+        lastId = id;
+
+        lastResult = RESULT::ORIGINAL;
+        if (owner == nullptr || table == nullptr)
+            return lastResult;
+
+        lastResult = RESULT::SKIP;
+        for (const Rule& rule: rules) {
+            if (matchMask(rule.ownerMask.c_str(), owner->c_str()) && matchMask(rule.tableMask.c_str(), table->c_str())) {
+                lastResult = RESULT::ORIGINAL;
+                break;
+            }
+        }
+        return lastResult;
+    }
+}
@@ -0,0 +1,82 @@
+/* Header for StreamFilter class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef STREAM_FILTER_H_
+#define STREAM_FILTER_H_
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "../common/OraProtoBuf.pb.h"
+#include "../common/types/Types.h"
+
+namespace OpenLogReplicator {
+    // Subscription of a stream client, sent as the schema list of the START/CONTINUE request:
+    // mask - OWNER.TABLE with * and ? wildcards, filter - "op=insert,update,delete,ddl;columns=COL1,COL2"
+    // A mask starting with @ is a stream option instead, with the value as filter, e.g. mask "@compression", filter "lz4"
+    class StreamFilter final {
+    public:
+        enum class RESULT : unsigned char {
+            ORIGINAL, FILTERED, SKIP
+        };
+
+    protected:
+        struct Rule {
+            std::string ownerMask;
+            std::string tableMask;
+            uint ops;
+            std::unordered_set<std::string> columns;
+        };
+
+        std::vector<Rule> rules;
+        std::string key;
+        pb::RedoResponse response;
+        std::string output;
+        uint64_t lastId{UINT64_MAX};
+        RESULT lastResult{RESULT::ORIGINAL};
+
+        static bool matchMask(const char* mask, const char* name);
+        [[nodiscard]] const Rule* match(const pb::Payload& payload) const;
+        static bool project(pb::Payload* payload, const std::unordered_set<std::string>& columns);
+
+    public:
+        // Clients sharing one filter
+        uint64_t users{0};
+
+        [[nodiscard]] static uint64_t countRules(const pb::RedoRequest& request);
+        [[nodiscard]] static std::string getOption(const pb::RedoRequest& request, const std::string& name);
+        [[nodiscard]] bool initialize(const pb::RedoRequest& request, std::string& error);
+        [[nodiscard]] RESULT apply(uint64_t id, const uint8_t* data, uint64_t size);
+        // Table granularity only, for output which is not decoded: the message is kept or skipped by the name of its table,
+        // messages with no table (begin, commit, checkpoint) are always kept
+        [[nodiscard]] bool isTableOnly() const;
+        [[nodiscard]] RESULT applyTable(uint64_t id, const std::string* owner, const std::string* table);
+
+        [[nodiscard]] const std::string& getKey() const {
+            return key;
+        }
+
+        [[nodiscard]] const std::string& getOutput() const {
+            return output;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,288 @@
+/* Streaming over gRPC (HTTP/2), one call per client subscription
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <fstream>
+#include <grpcpp/generic/async_generic_service.h>
+#include <grpcpp/security/server_credentials.h>
+#include <grpcpp/server.h>
+#include <grpcpp/server_builder.h>
+#include <unistd.h>
+
+#include "../common/Ctx.h"
+#include "../common/exception/NetworkException.h"
+#include "../common/exception/RuntimeException.h"
+#include "StreamGrpc.h"
+
+namespace OpenLogReplicator {
+    // One subscription on its own HTTP/2 stream, the reactions run on gRPC threads and the writer thread only touches the
+    // queues under the mutex, a Start* call is never made with the mutex held since its reaction may run inline
+    class GrpcCall final : public grpc::ServerGenericBidiReactor {
+    public:
+        std::mutex mtx;
+        // The call lives until gRPC is done with it, even when the writer has dropped it already
+        std::shared_ptr<GrpcCall> self;
+        grpc::ByteBuffer readBuffer;
+        std::deque<std::string> requests;
+        // Responses wait here while the HTTP/2 window of the client is exhausted, unconfirmed messages hold the writer queue
+        std::deque<grpc::ByteBuffer> responses;
+        bool writing{false};
+        bool closed{false};
+        bool finished{false};
+
+        void OnReadDone(bool ok) override {
+            {
+                std::unique_lock<std::mutex> const lck(mtx);
+                if (!ok) {
+                    closed = true;
+                    return;
+                }
+
+                std::vector<grpc::Slice> slices;
+                std::string request;
+                if (readBuffer.Dump(&slices).ok()) {
+                    for (const grpc::Slice& slice: slices)
+                        request.append(reinterpret_cast<const char*>(slice.begin()), slice.size());
+                }
+                requests.push_back(std::move(request));
+            }
+            StartRead(&readBuffer);
+        }
+
+        void OnWriteDone(bool ok) override {
+            grpc::ByteBuffer* next;
+            {
+                std::unique_lock<std::mutex> const lck(mtx);
+                responses.pop_front();
+                if (!ok)
+                    closed = true;
+                if (closed || responses.empty()) {
+                    writing = false;
+                    return;
+                }
+                next = &responses.front();
+            }
+            StartWrite(next);
+        }
+
+        void OnCancel() override {
+            std::unique_lock<std::mutex> const lck(mtx);
+            closed = true;
+        }
+
+        void OnDone() override {
+            const std::shared_ptr<GrpcCall> last = std::move(self);
+        }
+
+        void write(const void* msg, uint64_t length) {
+            grpc::ByteBuffer* next;
+            {
+                std::unique_lock<std::mutex> const lck(mtx);
+                if (closed)
+                    throw NetworkException(10082, "gRPC call closed by the client");
+
+                const grpc::Slice slice(msg, length);
+                responses.emplace_back(&slice, 1);
+                if (writing)
+                    return;
+                writing = true;
+                next = &responses.front();
+            }
+            StartWrite(next);
+        }
+
+        void finish() {
+            {
+                std::unique_lock<std::mutex> const lck(mtx);
+                if (finished)
+                    return;
+                finished = true;
+                closed = true;
+            }
+            Finish(grpc::Status::OK);
+        }
+    };
+
+    // Calls of any other method are refused by the default reactor
+    class GrpcService final : public grpc::CallbackGenericService {
+    protected:
+        StreamGrpc* stream;
+
+    public:
+        explicit GrpcService(StreamGrpc* newStream) :
+                stream(newStream) {
+        }
+
+        grpc::ServerGenericBidiReactor* CreateReactor(grpc::GenericCallbackServerContext* context) override {
+            if (context->method() != StreamGrpc::METHOD)
+                return grpc::CallbackGenericService::CreateReactor(context);
+
+            auto call = std::make_shared<GrpcCall>();
+            call->self = call;
+            call->StartRead(&call->readBuffer);
+            stream->addCall(call);
+            return call.get();
+        }
+    };
+
+    StreamGrpc::StreamGrpc(Ctx* newCtx, std::string newUri) :
+            Stream(newCtx, std::move(newUri)) {
+    }
+
+    StreamGrpc::StreamGrpc(Ctx* newCtx, std::string newUri, std::shared_ptr<GrpcCall> newCall) :
+            Stream(newCtx, std::move(newUri)),
+            call(std::move(newCall)) {
+    }
+
+    StreamGrpc::~StreamGrpc() {
+        if (call != nullptr)
+            call->finish();
+
+        std::deque<std::shared_ptr<GrpcCall>> remaining;
+        {
+            std::unique_lock<std::mutex> const lck(mtx);
+            stopping = true;
+            remaining.swap(started);
+        }
+        for (const std::shared_ptr<GrpcCall>& startedCall: remaining)
+            startedCall->finish();
+
+        if (server != nullptr) {
+            // Calls still running are cancelled instead of waited for
+            server->Shutdown(std::chrono::system_clock::now());
+            server->Wait();
+        }
+    }
+
+    void StreamGrpc::initialize() {
+    }
+
+    std::string StreamGrpc::getName() const {
+        return "gRPC:" + uri;
+    }
+
+    void StreamGrpc::initializeClient() {
+        throw RuntimeException(10083, "gRPC stream is only available as a server");
+    }
+
+    std::string StreamGrpc::readPem(const std::string& fileName) const {
+        std::ifstream file(fileName, std::ios::in | std::ios::binary);
+        if (!file.good())
+            throw RuntimeException(10083, "gRPC server initialization failed, can't read file: " + fileName);
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+
+    void StreamGrpc::initializeServer() {
+        std::shared_ptr<grpc::ServerCredentials> credentials;
+        if (tlsCert.empty())
+            credentials = grpc::InsecureServerCredentials();
+        else {
+            grpc::SslServerCredentialsOptions options(tlsCa.empty() ? GRPC_SSL_DONT_REQUEST_CLIENT_CERTIFICATE :
+                                                      GRPC_SSL_REQUEST_AND_REQUIRE_CLIENT_CERTIFICATE_AND_VERIFY);
+            options.pem_key_cert_pairs.push_back({readPem(tlsKey.empty() ? tlsCert : tlsKey), readPem(tlsCert)});
+            if (!tlsCa.empty())
+                options.pem_root_certs = readPem(tlsCa);
+            credentials = grpc::SslServerCredentials(options);
+        }
+
+        service = std::make_unique<GrpcService>(this);
+        grpc::ServerBuilder builder;
+        builder.AddListeningPort(uri, credentials);
+        builder.RegisterCallbackGenericService(service.get());
+        server = builder.BuildAndStart();
+        if (server == nullptr)
+            throw RuntimeException(10083, "gRPC server initialization failed, uri: " + uri);
+    }
+
+    void StreamGrpc::setTls(std::string newTlsCert, std::string newTlsKey, std::string newTlsCa) {
+        tlsCert = std::move(newTlsCert);
+        tlsKey = std::move(newTlsKey);
+        tlsCa = std::move(newTlsCa);
+    }
+
+    // Called by a gRPC thread
+    void StreamGrpc::addCall(std::shared_ptr<GrpcCall> newCall) {
+        {
+            std::unique_lock<std::mutex> const lck(mtx);
+            if (!stopping) {
+                started.push_back(std::move(newCall));
+                return;
+            }
+        }
+        newCall->finish();
+    }
+
+    StreamGrpc* StreamGrpc::acceptClient() {
+        std::shared_ptr<GrpcCall> startedCall;
+        {
+            std::unique_lock<std::mutex> const lck(mtx);
+            if (started.empty())
+                return nullptr;
+            startedCall = std::move(started.front());
+            started.pop_front();
+        }
+        return new StreamGrpc(ctx, uri, std::move(startedCall));
+    }
+
+    // Each message is one gRPC message, the copy lets the builder memory go as soon as the client confirms
+    void StreamGrpc::sendMessage(const void* msg, uint64_t length) {
+        if (call == nullptr)
+            throw NetworkException(10082, "gRPC call not started");
+        call->write(msg, length);
+    }
+
+    uint64_t StreamGrpc::receiveMessage(void* msg, uint64_t length) {
+        while (true) {
+            const uint64_t size = receiveMessageNB(msg, length);
+            if (size > 0)
+                return size;
+            usleep(ctx->pollIntervalUs);
+        }
+    }
+
+    uint64_t StreamGrpc::receiveMessageNB(void* msg, uint64_t length) {
+        if (call == nullptr) {
+            errno = EAGAIN;
+            return 0;
+        }
+
+        std::unique_lock<std::mutex> const lck(call->mtx);
+        if (call->requests.empty()) {
+            if (call->closed)
+                throw NetworkException(10082, "gRPC call closed by the client");
+            errno = EAGAIN;
+            return 0;
+        }
+
+        const std::string& request = call->requests.front();
+        if (request.length() > length)
+            throw NetworkException(10055, "message from client exceeds buffer size (length: " + std::to_string(request.length()) +
+                                          ", buffer size: " + std::to_string(length) + ")");
+        memcpy(msg, request.c_str(), request.length());
+        const uint64_t size = request.length();
+        call->requests.pop_front();
+        return size;
+    }
+
+    bool StreamGrpc::isConnected() {
+        if (call == nullptr)
+            return false;
+        std::unique_lock<std::mutex> const lck(call->mtx);
+        return !call->closed;
+    }
+}
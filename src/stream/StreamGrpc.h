@@ -0,0 +1,75 @@
+/* Header for StreamGrpc class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef STREAM_GRPC_H_
+#define STREAM_GRPC_H_
+
+#include <deque>
+#include <memory>
+#include <mutex>
+
+#include "Stream.h"
+
+namespace grpc {
+    class Server;
+}
+
+namespace OpenLogReplicator {
+    class GrpcCall;
+    class GrpcService;
+
+    // Server of the bidirectional gRPC method METHOD, every call is a separate client stream with its own subscription,
+    // a client may multiplex many of them over one HTTP/2 connection
+    class StreamGrpc final : public Stream {
+    protected:
+        std::unique_ptr<GrpcService> service;
+        std::unique_ptr<grpc::Server> server;
+        std::mutex mtx;
+        // Calls started by clients and not yet taken by the writer
+        std::deque<std::shared_ptr<GrpcCall>> started;
+        bool stopping{false};
+        std::shared_ptr<GrpcCall> call;
+        std::string tlsCert;
+        std::string tlsKey;
+        std::string tlsCa;
+
+        StreamGrpc(Ctx* newCtx, std::string newUri, std::shared_ptr<GrpcCall> newCall);
+        [[nodiscard]] std::string readPem(const std::string& fileName) const;
+
+    public:
+        static constexpr const char* METHOD{"/OpenLogReplicator.pb.OpenLogReplicator/Redo"};
+
+        StreamGrpc(Ctx* newCtx, std::string newUri);
+        ~StreamGrpc() override;
+
+        void initialize() override;
+        [[nodiscard]] std::string getName() const override;
+        void initializeClient() override;
+        void initializeServer() override;
+        void setTls(std::string newTlsCert, std::string newTlsKey, std::string newTlsCa);
+        void addCall(std::shared_ptr<GrpcCall> newCall);
+        void sendMessage(const void* msg, uint64_t length) override;
+        uint64_t receiveMessage(void* msg, uint64_t length) override;
+        uint64_t receiveMessageNB(void* msg, uint64_t length) override;
+        [[nodiscard]] bool isConnected() override;
+        [[nodiscard]] StreamGrpc* acceptClient() override;
+    };
+}
+
+#endif
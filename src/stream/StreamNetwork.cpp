@@ -17,12 +17,26 @@ You should have received a copy of the GNU General Public License
 along with OpenLogReplicator; see the file LICENSE;  If not see
 <http://www.gnu.org/licenses/>.  */
 
+#include <algorithm>
 #include <cerrno>
+#include <climits>
 #include <cstring>
 #include <fcntl.h>
 #include <netdb.h>
+#include <netinet/tcp.h>
 #include <unistd.h>
-
+#if __linux__
+#include <sys/epoll.h>
+#endif
+#ifdef LINK_LIBRARY_LZ4
+#include <lz4.h>
+#endif /* LINK_LIBRARY_LZ4 */
+#ifdef LINK_LIBRARY_OPENSSL
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#endif /* LINK_LIBRARY_OPENSSL */
+
+#include "../common/Clock.h"
 #include "../common/Ctx.h"
 #include "../common/Thread.h"
 #include "../common/exception/ConfigurationException.h"
@@ -42,6 +56,18 @@ namespace OpenLogReplicator {
             res = nullptr;
         }
 
+#ifdef LINK_LIBRARY_OPENSSL
+        if (ssl != nullptr) {
+            SSL_free(ssl);
+            ssl = nullptr;
+        }
+
+        if (sslCtx != nullptr && sslCtxOwner) {
+            SSL_CTX_free(sslCtx);
+            sslCtx = nullptr;
+        }
+#endif /* LINK_LIBRARY_OPENSSL */
+
         if (socketFD != -1) {
             close(socketFD);
             socketFD = -1;
@@ -51,6 +77,11 @@ namespace OpenLogReplicator {
             close(serverFD);
             serverFD = -1;
         }
+
+        if (epollFD != -1) {
+            close(epollFD);
+            epollFD = -1;
+        }
     }
 
     void StreamNetwork::initialize() {
@@ -85,6 +116,13 @@ namespace OpenLogReplicator {
         if (connect(socketFD, reinterpret_cast<struct sockaddr*>(&addressC), sizeof(addressC)) < 0)
             throw NetworkException(10062, "connection to " + uri + " failed, errno: " + std::to_string(errno) + ", message: " +
                                           strerror(errno));
+        setSocketOptions();
+
+        // The client socket is blocking, so the handshake completes here
+        initializeTls(false);
+        startTls(false);
+        if (ssl != nullptr)
+            tlsHandshake();
     }
 
     void StreamNetwork::initializeServer() {
@@ -113,312 +151,777 @@ namespace OpenLogReplicator {
 
         if (bind(serverFD, res->ai_addr, res->ai_addrlen) < 0)
             throw RuntimeException(10061, "network error, errno: " + std::to_string(errno) + ", message: " + strerror(errno) + " (8)");
-        if (listen(serverFD, 1) < 0)
+        if (listen(serverFD, SOMAXCONN) < 0)
             throw RuntimeException(10061, "network error, errno: " + std::to_string(errno) + ", message: " + strerror(errno) + " (9)");
 
         freeaddrinfo(res);
         res = nullptr;
+        initializeTls(true);
+
+#if __linux__
+        // The server and all accepted sockets share one epoll set, so a poll costs one system call however many clients there are
+        epollFD = epoll_create1(EPOLL_CLOEXEC);
+        if (epollFD < 0)
+            throw RuntimeException(10061, "network error, errno: " + std::to_string(errno) + ", message: " + strerror(errno) + " (21)");
+        poller = this;
+
+        struct epoll_event event{};
+        event.events = EPOLLIN | EPOLLET;
+        event.data.ptr = &serverReady;
+        if (epoll_ctl(epollFD, EPOLL_CTL_ADD, serverFD, &event) != 0)
+            throw RuntimeException(10061, "network error, errno: " + std::to_string(errno) + ", message: " + strerror(errno) + " (22)");
+#endif
     }
 
-    void StreamNetwork::sendMessage(const void* msg, uint64_t length) {
-        uint32_t length32 = length;
-        uint64_t sent = 0;
+    void StreamNetwork::setBatch(uint64_t newBatchBytes, uint64_t newBatchLatencyUs) {
+        batchBytes = newBatchBytes;
+        batchLatencyUs = newBatchLatencyUs;
+        if (batchBytes > 0)
+            iov.reserve(IOV_MAX);
+    }
 
-        if (socketFD == -1)
-            throw NetworkException(10061, "network error, errno: " + std::to_string(errno) + ", message: " + strerror(errno) + " (10)");
+    void StreamNetwork::setTcp(bool newTcpNoDelay, bool newTcpCork, uint64_t newSendBufferBytes, uint64_t newKeepAliveS) {
+        tcpNoDelay = newTcpNoDelay;
+        tcpCork = newTcpCork;
+        sendBufferBytes = newSendBufferBytes;
+        keepAliveS = newKeepAliveS;
+    }
 
-        fd_set wset;
-        fd_set w;
-        FD_ZERO(&wset);
-        FD_SET(socketFD, &wset);
+    void StreamNetwork::setTls(std::string newTlsCert, std::string newTlsKey, std::string newTlsCa, bool newTlsKtls) {
+        tls = true;
+        tlsCert = std::move(newTlsCert);
+        tlsKey = std::move(newTlsKey);
+        tlsCa = std::move(newTlsCa);
+        tlsKtls = newTlsKtls;
+    }
 
-        // Header content
-        if (length < 0xFFFFFFFF) {
-            // 32-bit length
-            while (sent < sizeof(uint32_t)) {
-                if (ctx->softShutdown)
+    std::string StreamNetwork::tlsErrorString() {
+#ifdef LINK_LIBRARY_OPENSSL
+        char buffer[256];
+        const unsigned long err = ERR_get_error();
+        if (err == 0)
+            return "errno: " + std::to_string(errno) + ", message: " + strerror(errno);
+        ERR_error_string_n(err, buffer, sizeof(buffer));
+        return buffer;
+#else
+        return "not compiled";
+#endif /* LINK_LIBRARY_OPENSSL */
+    }
+
+    // With kernel offload enabled OpenSSL installs the "tls" ULP on the socket after the handshake, from then on the kernel
+    // encrypts what writev() sends, so the frames keep going out without a copy
+    void StreamNetwork::initializeTls(bool server __attribute__((unused))) {
+        if (!tls)
+            return;
+
+#ifdef LINK_LIBRARY_OPENSSL
+        sslCtx = SSL_CTX_new(server ? TLS_server_method() : TLS_client_method());
+        if (sslCtx == nullptr)
+            throw RuntimeException(10080, "tls initialization failed: " + tlsErrorString());
+        sslCtxOwner = true;
+
+        SSL_CTX_set_min_proto_version(sslCtx, TLS1_2_VERSION);
+        SSL_CTX_set_mode(sslCtx, SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+#ifdef SSL_OP_ENABLE_KTLS
+        if (tlsKtls)
+            SSL_CTX_set_options(sslCtx, SSL_OP_ENABLE_KTLS);
+#endif
+
+        if (!tlsCert.empty()) {
+            if (SSL_CTX_use_certificate_chain_file(sslCtx, tlsCert.c_str()) != 1)
+                throw RuntimeException(10080, "tls initialization failed, certificate: " + tlsCert + ", error: " + tlsErrorString());
+            const std::string& keyFile = tlsKey.empty() ? tlsCert : tlsKey;
+            if (SSL_CTX_use_PrivateKey_file(sslCtx, keyFile.c_str(), SSL_FILETYPE_PEM) != 1)
+                throw RuntimeException(10080, "tls initialization failed, key: " + keyFile + ", error: " + tlsErrorString());
+        }
+
+        if (!tlsCa.empty()) {
+            if (SSL_CTX_load_verify_locations(sslCtx, tlsCa.c_str(), nullptr) != 1)
+                throw RuntimeException(10080, "tls initialization failed, ca: " + tlsCa + ", error: " + tlsErrorString());
+        } else if (!server)
+            SSL_CTX_set_default_verify_paths(sslCtx);
+
+        // The client always verifies the server, the server asks for a client certificate only with a ca configured
+        if (!server)
+            SSL_CTX_set_verify(sslCtx, SSL_VERIFY_PEER, nullptr);
+        else if (!tlsCa.empty())
+            SSL_CTX_set_verify(sslCtx, SSL_VERIFY_PEER | SSL_VERIFY_FAIL_IF_NO_PEER_CERT, nullptr);
+#else
+        throw RuntimeException(10080, "tls initialization failed, error: " + tlsErrorString());
+#endif /* LINK_LIBRARY_OPENSSL */
+    }
+
+    void StreamNetwork::startTls(bool server __attribute__((unused))) {
+#ifdef LINK_LIBRARY_OPENSSL
+        if (sslCtx == nullptr)
+            return;
+
+        ssl = SSL_new(sslCtx);
+        if (ssl == nullptr || SSL_set_fd(ssl, socketFD) != 1) {
+            const std::string error = tlsErrorString();
+            closeSocket();
+            throw NetworkException(10061, "tls error: " + error);
+        }
+
+        if (server)
+            SSL_set_accept_state(ssl);
+        else {
+            SSL_set_connect_state(ssl);
+            SSL_ctrl(ssl, SSL_CTRL_SET_TLSEXT_HOSTNAME, TLSEXT_NAMETYPE_host_name, const_cast<char*>(host.c_str()));
+            SSL_set1_host(ssl, host.c_str());
+        }
+#endif /* LINK_LIBRARY_OPENSSL */
+    }
+
+    // Returns false while the handshake waits for the socket
+    bool StreamNetwork::tlsHandshake() {
+#ifdef LINK_LIBRARY_OPENSSL
+        ERR_clear_error();
+        const int ret = SSL_do_handshake(ssl);
+        if (ret != 1) {
+            tlsRetry(ret);
+            return false;
+        }
+
+        tlsConnected = true;
+#ifdef BIO_get_ktls_send
+        ktlsSend = BIO_get_ktls_send(SSL_get_wbio(ssl)) != 0;
+#endif
+        ctx->info(0, "tls connection established: " + std::string(SSL_get_version(ssl)) + ", cipher: " + SSL_get_cipher_name(ssl) +
+                     (ktlsSend ? ", kernel offload" : ""));
+#endif /* LINK_LIBRARY_OPENSSL */
+        return true;
+    }
+
+    // Returns when the operation only has to wait for the socket, throws for anything else
+    void StreamNetwork::tlsRetry(int ret __attribute__((unused))) {
+#ifdef LINK_LIBRARY_OPENSSL
+        const int err = SSL_get_error(ssl, ret);
+        if (err == SSL_ERROR_WANT_READ) {
+            socketReady.readable = false;
+            return;
+        }
+        if (err == SSL_ERROR_WANT_WRITE) {
+            socketReady.writable = false;
+            return;
+        }
+        if (err == SSL_ERROR_SYSCALL && errno == EINTR)
+            return;
+
+        const std::string error = tlsErrorString();
+        closeSocket();
+        if (err == SSL_ERROR_ZERO_RETURN || (err == SSL_ERROR_SYSCALL && ret == 0))
+            throw NetworkException(10056, "host disconnected");
+        throw NetworkException(10061, "tls error: " + error);
+#endif /* LINK_LIBRARY_OPENSSL */
+    }
+
+    // Decrypted bytes held by OpenSSL are not reported by epoll
+    bool StreamNetwork::tlsPending() const {
+#ifdef LINK_LIBRARY_OPENSSL
+        if (ssl != nullptr)
+            return SSL_pending(ssl) > 0;
+#endif /* LINK_LIBRARY_OPENSSL */
+        return false;
+    }
+
+    void StreamNetwork::setSocketOptions() {
+        int opt = tcpNoDelay ? 1 : 0;
+        if (setsockopt(socketFD, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt)) != 0)
+            throw NetworkException(10061, "network error, errno: " + std::to_string(errno) + ", message: " + strerror(errno) + " (23)");
+
+#if __linux__
+        if (tcpCork) {
+            opt = 1;
+            if (setsockopt(socketFD, IPPROTO_TCP, TCP_CORK, &opt, sizeof(opt)) != 0)
+                throw NetworkException(10061, "network error, errno: " + std::to_string(errno) + ", message: " + strerror(errno) + " (24)");
+        }
+#endif
+
+        if (sendBufferBytes > 0) {
+            opt = static_cast<int>(sendBufferBytes);
+            if (setsockopt(socketFD, SOL_SOCKET, SO_SNDBUF, &opt, sizeof(opt)) != 0)
+                throw NetworkException(10061, "network error, errno: " + std::to_string(errno) + ", message: " + strerror(errno) + " (25)");
+        }
+
+        if (keepAliveS > 0) {
+            opt = 1;
+            if (setsockopt(socketFD, SOL_SOCKET, SO_KEEPALIVE, &opt, sizeof(opt)) != 0)
+                throw NetworkException(10061, "network error, errno: " + std::to_string(errno) + ", message: " + strerror(errno) + " (26)");
+#if __linux__
+            opt = static_cast<int>(keepAliveS);
+            if (setsockopt(socketFD, IPPROTO_TCP, TCP_KEEPIDLE, &opt, sizeof(opt)) != 0 ||
+                    setsockopt(socketFD, IPPROTO_TCP, TCP_KEEPINTVL, &opt, sizeof(opt)) != 0)
+                throw NetworkException(10061, "network error, errno: " + std::to_string(errno) + ", message: " + strerror(errno) + " (27)");
+#endif
+        }
+    }
+
+    // The socket is registered with this stream's readiness flags, after accept() it is moved over to the client stream
+    void StreamNetwork::registerSocket(bool modify) {
+#if __linux__
+        if (poller == nullptr)
+            return;
+
+        struct epoll_event event{};
+        event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        event.data.ptr = &socketReady;
+        if (epoll_ctl(poller->epollFD, modify ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, socketFD, &event) != 0)
+            throw NetworkException(10061, "network error, errno: " + std::to_string(errno) + ", message: " + strerror(errno) + " (28)");
+#endif
+    }
+
+    // Collects readiness of the server socket and of all accepted sockets without waiting
+    void StreamNetwork::pollEvents() {
+#if __linux__
+        if (epollFD == -1)
+            return;
+
+        struct epoll_event events[POLL_EVENTS];
+        int count;
+        do {
+            count = epoll_wait(epollFD, events, POLL_EVENTS, 0);
+            if (count < 0) {
+                if (errno == EINTR)
                     return;
+                throw NetworkException(10061, "network error, errno: " + std::to_string(errno) + ", message: " + strerror(errno) + " (29)");
+            }
 
-                w = wset;
-                // Blocking select
-                select(socketFD + 1, nullptr, &w, nullptr, nullptr);
-                ssize_t r = write(socketFD, reinterpret_cast<const uint8_t*>(&length32) + sent, sizeof(uint32_t) - sent);
-                if (r <= 0) {
-                    if (r < 0 && (errno == EWOULDBLOCK || errno == EAGAIN))
-                        r = 0;
-                    else {
-                        close(socketFD);
-                        socketFD = -1;
-                        throw NetworkException(10061, "network error, errno: " + std::to_string(errno) + ", message: " +
-                                                      strerror(errno) + " (11)");
-                    }
-                }
-                sent += r;
+            for (int i = 0; i < count; ++i) {
+                auto* readiness = reinterpret_cast<Readiness*>(events[i].data.ptr);
+                // A hang-up or an error is reported by the next read or write
+                if ((events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0)
+                    readiness->readable = true;
+                if ((events[i].events & (EPOLLOUT | EPOLLHUP | EPOLLERR)) != 0)
+                    readiness->writable = true;
+            }
+        } while (count == POLL_EVENTS);
+#endif
+    }
+
+    bool StreamNetwork::supportsCompression(const std::string& method) const {
+#ifdef LINK_LIBRARY_LZ4
+        if (method == "lz4")
+            return true;
+#endif /* LINK_LIBRARY_LZ4 */
+        return method.empty();
+    }
+
+    void StreamNetwork::setCompression(const std::string& method) {
+        if (compression && !compressInput.empty())
+            compressFrames();
+        compression = !method.empty() && supportsCompression(method);
+
+#ifdef LINK_LIBRARY_LZ4
+        if (compression && compressState == nullptr)
+            compressState = std::make_unique<uint8_t[]>(LZ4_sizeofState());
+#endif /* LINK_LIBRARY_LZ4 */
+    }
+
+    void StreamNetwork::appendFrame(const void* msg, uint64_t length) {
+        if (frames.empty() && compressInput.empty() && batchBytes > 0)
+            framesStart = ctx->clock->getTimeUt();
+
+        // The frame is copied into the batch, which is compressed when written or when it grows too large
+        if (compression) {
+            uint8_t header[FRAME_HEADER_MAX];
+            uint64_t headerSize = sizeof(uint32_t);
+            if (length < 0xFFFFFFFF) {
+                const uint32_t length32 = length;
+                memcpy(header, &length32, sizeof(uint32_t));
+            } else {
+                const uint32_t length32 = 0xFFFFFFFF;
+                memcpy(header, &length32, sizeof(uint32_t));
+                memcpy(header + sizeof(uint32_t), &length, sizeof(uint64_t));
+                headerSize = FRAME_HEADER_MAX;
             }
+            compressInput.insert(compressInput.end(), header, header + headerSize);
+            compressInput.insert(compressInput.end(), reinterpret_cast<const uint8_t*>(msg), reinterpret_cast<const uint8_t*>(msg) + length);
+            framesBytes += headerSize + length;
+            if (compressInput.size() >= COMPRESS_BATCH_MAX)
+                compressFrames();
+            return;
+        }
+
+        Frame& frame = frames.emplace_back();
+        frame.data = reinterpret_cast<const uint8_t*>(msg);
+        frame.length = length;
+        if (length < 0xFFFFFFFF) {
+            // 32-bit length
+            const uint32_t length32 = length;
+            memcpy(frame.header, &length32, sizeof(uint32_t));
+            frame.headerSize = sizeof(uint32_t);
         } else {
             // 64-bit length
-            length32 = 0xFFFFFFFF;
-            while (sent < sizeof(uint32_t)) {
-                if (ctx->softShutdown)
-                    return;
+            const uint32_t length32 = 0xFFFFFFFF;
+            memcpy(frame.header, &length32, sizeof(uint32_t));
+            memcpy(frame.header + sizeof(uint32_t), &length, sizeof(uint64_t));
+            frame.headerSize = sizeof(uint32_t) + sizeof(uint64_t);
+        }
+        framesBytes += frame.headerSize + length;
+    }
 
-                w = wset;
-                // Blocking select
-                select(socketFD + 1, nullptr, &w, nullptr, nullptr);
-                ssize_t r = write(socketFD, reinterpret_cast<const uint8_t*>(&length32) + sent, sizeof(uint32_t) - sent);
-                if (r <= 0) {
-                    if (r < 0 && (errno == EWOULDBLOCK || errno == EAGAIN))
-                        r = 0;
-                    else {
-                        close(socketFD);
-                        socketFD = -1;
-                        throw NetworkException(10061, "network error, errno: " + std::to_string(errno) + ", message: " +
-                                                      strerror(errno) + " (12)");
-                    }
-                }
-                sent += r;
+    // Pending frames, headers and bodies, go out with one writev per IOV_MAX entries for as long as the socket takes them,
+    // the rest waits for the next call, so a slow client never blocks the writer
+    void StreamNetwork::writeFrames() {
+        if (!compressInput.empty())
+            compressFrames();
+
+        if (ssl != nullptr && !frames.empty()) {
+            if (!tlsConnected && !tlsHandshake())
+                return;
+            if (!ktlsSend) {
+                writeFramesTls();
+                return;
             }
+        }
 
-            sent = 0;
-            while (sent < sizeof(uint64_t)) {
-                if (ctx->softShutdown)
-                    return;
+        while (!frames.empty()) {
+            if (poller != nullptr && !socketReady.writable)
+                return;
+
+            iov.clear();
+            uint64_t offset = frameOffset;
+            for (const Frame& frame: frames) {
+                if (iov.size() + 2 > IOV_MAX)
+                    break;
+                if (offset < frame.headerSize)
+                    iov.push_back({const_cast<uint8_t*>(frame.header) + offset, frame.headerSize - offset});
+                const uint64_t bodyOffset = offset > frame.headerSize ? offset - frame.headerSize : 0;
+                if (frame.length > bodyOffset)
+                    iov.push_back({const_cast<uint8_t*>(frame.data) + bodyOffset, frame.length - bodyOffset});
+                offset = 0;
+            }
 
-                w = wset;
-                // Blocking select
-                select(socketFD + 1, nullptr, &w, nullptr, nullptr);
-                ssize_t r = write(socketFD, reinterpret_cast<const uint8_t*>(&length) + sent, sizeof(uint64_t) - sent);
-                if (r <= 0) {
-                    if (r < 0 && (errno == EWOULDBLOCK || errno == EAGAIN))
-                        r = 0;
-                    else {
-                        close(socketFD);
-                        socketFD = -1;
-                        throw NetworkException(10061, "network error, errno: " + std::to_string(errno) + ", message: " +
-                                                      strerror(errno) + " (13)");
-                    }
+            const ssize_t r = writev(socketFD, iov.data(), static_cast<int>(iov.size()));
+            if (r <= 0) {
+                if (r < 0 && (errno == EWOULDBLOCK || errno == EAGAIN)) {
+                    socketReady.writable = false;
+                    return;
                 }
-                sent += r;
+                if (r < 0 && errno == EINTR)
+                    continue;
+                closeSocket();
+                throw NetworkException(10061, "network error, errno: " + std::to_string(errno) + ", message: " +
+                                              strerror(errno) + " (11)");
             }
+            corkPending = tcpCork;
+            consumeFrames(r);
         }
+        iov.clear();
+    }
 
-        sent = 0;
-        // Message content
-        while (sent < length) {
-            if (ctx->softShutdown)
+    // Without kernel offload the frames are encrypted by OpenSSL, gathered into full records instead of one record per header
+    void StreamNetwork::writeFramesTls() {
+#ifdef LINK_LIBRARY_OPENSSL
+        if (tlsBuffer == nullptr)
+            tlsBuffer = std::make_unique<uint8_t[]>(TLS_RECORD);
+
+        while (!frames.empty()) {
+            if (poller != nullptr && !socketReady.writable)
                 return;
 
-            w = wset;
-            // Blocking select
-            select(socketFD + 1, nullptr, &w, nullptr, nullptr);
-            ssize_t r = write(socketFD, reinterpret_cast<const char*>(msg) + sent, length - sent);
+            // A write that has to be repeated uses the same bytes, they are still in the buffer
+            const uint64_t length = tlsWriteLength > 0 ? tlsWriteLength : gatherFrames(tlsBuffer.get(), TLS_RECORD);
+            ERR_clear_error();
+            const int r = SSL_write(ssl, tlsBuffer.get(), static_cast<int>(length));
             if (r <= 0) {
-                if (r < 0 && (errno == EWOULDBLOCK || errno == EAGAIN))
-                    r = 0;
-                else {
-                    close(socketFD);
-                    socketFD = -1;
-                    throw NetworkException(10061, "network error, errno: " + std::to_string(errno) + ", message: " +
-                                                  strerror(errno) + " (14)");
-                }
+                tlsWriteLength = length;
+                tlsRetry(r);
+                return;
             }
-            sent += r;
+            tlsWriteLength = 0;
+            corkPending = tcpCork;
+            consumeFrames(r);
         }
+#endif /* LINK_LIBRARY_OPENSSL */
     }
 
-    uint64_t StreamNetwork::receiveMessage(void* msg, uint64_t length) {
-        uint64_t recvd = 0;
+    uint64_t StreamNetwork::gatherFrames(uint8_t* buffer, uint64_t size) const {
+        uint64_t length = 0;
+        uint64_t offset = frameOffset;
+        for (const Frame& frame: frames) {
+            if (length == size)
+                break;
+            if (offset < frame.headerSize) {
+                const uint64_t bytes = std::min(frame.headerSize - offset, size - length);
+                memcpy(reinterpret_cast<void*>(buffer + length), reinterpret_cast<const void*>(frame.header + offset), bytes);
+                length += bytes;
+            }
+            const uint64_t bodyOffset = offset > frame.headerSize ? offset - frame.headerSize : 0;
+            if (frame.length > bodyOffset) {
+                const uint64_t bytes = std::min(frame.length - bodyOffset, size - length);
+                memcpy(reinterpret_cast<void*>(buffer + length), reinterpret_cast<const void*>(frame.data + bodyOffset), bytes);
+                length += bytes;
+            }
+            offset = 0;
+        }
+        return length;
+    }
 
-        // Read message length
-        while (recvd < sizeof(uint32_t)) {
-            if (ctx->softShutdown)
-                return 0;
+    void StreamNetwork::compressFrames() {
+#ifdef LINK_LIBRARY_LZ4
+        if (compressInput.size() > static_cast<uint64_t>(INT32_MAX) - 65536)
+            throw NetworkException(10061, "network error, compressed batch too large: " + std::to_string(compressInput.size()));
+
+        const int inputSize = static_cast<int>(compressInput.size());
+        const int bound = LZ4_compressBound(inputSize);
+        Frame& frame = frames.emplace_back();
+        frame.copy.reset(new uint8_t[bound]);
+        const int size = LZ4_compress_fast_extState(compressState.get(), reinterpret_cast<const char*>(compressInput.data()),
+                                                    reinterpret_cast<char*>(frame.copy.get()), inputSize, bound, 1);
+        if (size <= 0)
+            throw RuntimeException(10081, "lz4 stream compression failed for " + std::to_string(inputSize) + " bytes");
+
+        frame.data = frame.copy.get();
+        frame.length = size;
+        const uint32_t marker = FRAME_COMPRESSED;
+        const uint32_t size32 = size;
+        const uint32_t input32 = inputSize;
+        memcpy(frame.header, &marker, sizeof(uint32_t));
+        memcpy(frame.header + sizeof(uint32_t), &size32, sizeof(uint32_t));
+        memcpy(frame.header + 2 * sizeof(uint32_t), &input32, sizeof(uint32_t));
+        frame.headerSize = FRAME_HEADER_MAX;
+        framesBytes = framesBytes + frame.headerSize + frame.length - compressInput.size();
+#endif /* LINK_LIBRARY_LZ4 */
+        compressInput.clear();
+    }
 
-            const int64_t bytes = read(socketFD, reinterpret_cast<char*>(msg) + recvd, sizeof(uint32_t) - recvd);
+    // Drops the fully written frames, a partially written one keeps its offset
+    void StreamNetwork::consumeFrames(uint64_t bytes) {
+        uint64_t left = frameOffset + bytes;
+        while (!frames.empty() && left >= frames.front().headerSize + frames.front().length) {
+            left -= frames.front().headerSize + frames.front().length;
+            framesBytes -= frames.front().headerSize + frames.front().length;
+            frames.pop_front();
+        }
+        frameOffset = left;
+    }
 
-            if (bytes > 0)
-                recvd += bytes;
-            else if (bytes == 0) {
-                close(socketFD);
-                socketFD = -1;
-                throw NetworkException(10056, "host disconnected");
-            } else {
-                close(socketFD);
-                socketFD = -1;
-                throw NetworkException(10061, "network error, errno: " + std::to_string(errno) + ", message: " + strerror(errno) + " (15)");
-            }
+    // Uncorking pushes out the partial segment the kernel holds back, then the socket is corked again for the next batch
+    void StreamNetwork::pushCork() {
+#if __linux__
+        if (!corkPending)
+            return;
+        corkPending = false;
+
+        int opt = 0;
+        if (setsockopt(socketFD, IPPROTO_TCP, TCP_CORK, &opt, sizeof(opt)) != 0)
+            throw NetworkException(10061, "network error, errno: " + std::to_string(errno) + ", message: " + strerror(errno) + " (30)");
+        opt = 1;
+        if (setsockopt(socketFD, IPPROTO_TCP, TCP_CORK, &opt, sizeof(opt)) != 0)
+            throw NetworkException(10061, "network error, errno: " + std::to_string(errno) + ", message: " + strerror(errno) + " (31)");
+#endif
+    }
+
+    // Frames borrowed from the caller are copied, so they stay valid after the caller releases its buffers
+    void StreamNetwork::copyQueued() {
+        for (Frame& frame: frames) {
+            if (frame.copy != nullptr || frame.length == 0)
+                continue;
+            frame.copy = std::make_unique<uint8_t[]>(frame.length);
+            memcpy(reinterpret_cast<void*>(frame.copy.get()), reinterpret_cast<const void*>(frame.data), frame.length);
+            frame.data = frame.copy.get();
         }
+    }
 
-        uint32_t newLength = *reinterpret_cast<const uint32_t*>(msg);
-        if (newLength < 0xFFFFFFFF) {
-            // 32-bit message length
-            if (length < newLength)
-                throw NetworkException(10055, "message from client exceeds buffer size (length: " + std::to_string(newLength) +
-                                              ", buffer size: " + std::to_string(length) + ")");
-            length = newLength;
-            recvd = 0;
-        } else {
-            // 64-bit message length
-            recvd = 0;
-
-            while (recvd < sizeof(uint64_t)) {
-                if (ctx->softShutdown)
-                    return 0;
-
-                const int64_t bytes = read(socketFD, reinterpret_cast<char*>(msg) + recvd, sizeof(uint64_t) - recvd);
-
-                if (bytes > 0)
-                    recvd += bytes;
-                else if (bytes == 0) {
-                    close(socketFD);
-                    socketFD = -1;
-                    throw NetworkException(10056, "host disconnected");
-                } else {
-                    close(socketFD);
-                    socketFD = -1;
-                    throw NetworkException(10061, "network error, errno: " + std::to_string(errno) + ", message: " +
-                                                  strerror(errno) + " (16)");
-                }
-            }
+    void StreamNetwork::sendMessage(const void* msg, uint64_t length) {
+        if (socketFD == -1)
+            throw NetworkException(10061, "network error, errno: " + std::to_string(errno) + ", message: " + strerror(errno) + " (10)");
+
+        // Anything batched before goes first, the header and the body share one writev
+        appendFrame(msg, length);
+        writeFrames();
 
-            newLength = *reinterpret_cast<const uint32_t*>(msg);
-            if (length < newLength)
-                throw NetworkException(10055, "message from client exceeds buffer size (length: " + std::to_string(newLength) +
-                                              ", buffer size: " + std::to_string(length) + ")");
-            length = newLength;
-            recvd = 0;
+        // The caller reuses its buffer after the call, a frame the socket did not take yet keeps its own copy
+        if (!frames.empty() && frames.back().copy == nullptr && length > 0) {
+            Frame& frame = frames.back();
+            frame.copy = std::make_unique<uint8_t[]>(length);
+            memcpy(reinterpret_cast<void*>(frame.copy.get()), msg, length);
+            frame.data = frame.copy.get();
         }
+        if (frames.empty())
+            pushCork();
+    }
 
-        while (recvd < length) {
-            if (ctx->softShutdown)
-                return 0;
+    void StreamNetwork::queueMessage(const void* msg, uint64_t length) {
+        if (batchBytes == 0) {
+            sendMessage(msg, length);
+            return;
+        }
+
+        if (socketFD == -1)
+            throw NetworkException(10061, "network error, errno: " + std::to_string(errno) + ", message: " + strerror(errno) + " (10)");
+
+        appendFrame(msg, length);
+        if (framesBytes >= batchBytes || frames.size() >= IOV_MAX / 2)
+            writeFrames();
+    }
+
+    void StreamNetwork::flush(bool force) {
+        if (socketFD == -1)
+            return;
+        if (frames.empty() && compressInput.empty()) {
+            if (force)
+                pushCork();
+            return;
+        }
+        if (!force && ctx->clock->getTimeUt() - framesStart < static_cast<time_ut>(batchLatencyUs))
+            return;
+        writeFrames();
+        if (force && frames.empty())
+            pushCork();
+    }
 
-            const int64_t bytes = read(socketFD, reinterpret_cast<char*>(msg) + recvd, length - recvd);
+    void StreamNetwork::closeSocket() {
+#ifdef LINK_LIBRARY_OPENSSL
+        if (ssl != nullptr) {
+            SSL_free(ssl);
+            ssl = nullptr;
+        }
+#endif /* LINK_LIBRARY_OPENSSL */
+        tlsConnected = false;
+        ktlsSend = false;
+        tlsWriteLength = 0;
+
+        // Closing the socket removes it from the epoll set
+        close(socketFD);
+        socketFD = -1;
+        readBufferLen = 0;
+        frames.clear();
+        frameOffset = 0;
+        framesBytes = 0;
+        corkPending = false;
+        compression = false;
+        compressInput.clear();
+        inflated.clear();
+        inflatedPos = 0;
+        socketReady = Readiness();
+    }
 
+    // Returns 0 when a non-blocking socket has no data
+    uint64_t StreamNetwork::readSocket(uint8_t* buffer, uint64_t size) {
+#ifdef LINK_LIBRARY_OPENSSL
+        if (ssl != nullptr) {
+            ERR_clear_error();
+            const int bytes = SSL_read(ssl, buffer, static_cast<int>(std::min<uint64_t>(size, INT_MAX)));
             if (bytes > 0)
-                recvd += bytes;
-            else if (bytes == 0) {
-                close(socketFD);
-                socketFD = -1;
-                throw NetworkException(10056, "host disconnected");
-            } else {
-                close(socketFD);
-                socketFD = -1;
-                throw NetworkException(10061, "network error, errno: " + std::to_string(errno) + ", message: " + strerror(errno) + " (17)");
-            }
+                return bytes;
+            tlsRetry(bytes);
+            return 0;
         }
+#endif /* LINK_LIBRARY_OPENSSL */
 
-        return recvd;
+        const int64_t bytes = read(socketFD, buffer, size);
+        if (bytes > 0)
+            return bytes;
+
+        if (bytes < 0 && (errno == EWOULDBLOCK || errno == EAGAIN || errno == EINTR)) {
+            if (errno != EINTR)
+                socketReady.readable = false;
+            return 0;
+        }
+
+        const int err = errno;
+        closeSocket();
+        if (bytes == 0)
+            throw NetworkException(10056, "host disconnected");
+        throw NetworkException(10061, "network error, errno: " + std::to_string(err) + ", message: " + strerror(err) + " (15)");
     }
 
-    uint64_t StreamNetwork::receiveMessageNB(void* msg, uint64_t length) {
-        uint64_t recvd = 0;
+    void StreamNetwork::consumeReadBuffer(uint64_t size) {
+        readBufferLen -= size;
+        if (readBufferLen > 0)
+            memmove(reinterpret_cast<void*>(readBuffer), reinterpret_cast<const void*>(readBuffer + size), readBufferLen);
+    }
+
+    // Frames are read through a buffer, so a batch of small messages is received with a single read, only a message
+    // larger than the buffer is read directly to the destination
+    uint64_t StreamNetwork::receiveFrame(void* msg, uint64_t length, bool blocking) {
+        if (inflatedPos < inflated.size())
+            return nextInflated(msg, length);
+
+        uint32_t length32 = 0;
+        while (true) {
+            if (readBufferLen >= sizeof(uint32_t)) {
+                memcpy(&length32, readBuffer, sizeof(uint32_t));
+                if (length32 < FRAME_COMPRESSED || readBufferLen >= FRAME_HEADER_MAX)
+                    break;
+            }
 
-        // Read message length
-        while (recvd < sizeof(uint32_t)) {
             if (ctx->softShutdown)
                 return 0;
 
-            const int64_t bytes = read(socketFD, reinterpret_cast<char*>(msg) + recvd, sizeof(uint32_t) - recvd);
+            // Nothing arrived since the last read, no need to ask the socket
+            if (!blocking && poller != nullptr && !socketReady.readable && !tlsPending()) {
+                errno = EAGAIN;
+                return 0;
+            }
 
-            if (bytes > 0)
-                recvd += bytes;
-            else if (bytes == 0) {
-                // Client disconnected
-                close(socketFD);
-                socketFD = -1;
-                throw NetworkException(10056, "host disconnected");
-            } else {
-                if (recvd == 0)
-                    return 0;
-
-                if (errno == EWOULDBLOCK || errno == EAGAIN) {
-                    ctx->writerThread->contextSet(Thread::CONTEXT::SLEEP);
-                    usleep(ctx->pollIntervalUs);
-                    ctx->writerThread->contextSet(Thread::CONTEXT::CPU);
-                } else
-                    return 0;
+            const uint64_t bytes = readSocket(readBuffer + readBufferLen, RECEIVE_BUFFER - readBufferLen);
+            if (bytes == 0 && !blocking) {
+                // The partial header stays buffered for the next call
+                errno = EAGAIN;
+                return 0;
             }
+            readBufferLen += bytes;
         }
 
-        if (*reinterpret_cast<const uint32_t*>(msg) < 0xFFFFFFFF) {
-            // 32-bit message length
-            const uint32_t newLength = *reinterpret_cast<const uint32_t*>(msg);
-            if (length < newLength)
-                throw NetworkException(10055, "message from client exceeds buffer size (length: " + std::to_string(newLength) +
-                                              ", buffer size: " + std::to_string(length) + ")");
-            length = newLength;
-            recvd = 0;
-        } else {
+        uint64_t newLength = length32;
+        uint64_t headerSize = sizeof(uint32_t);
+        uint64_t rawLength = 0;
+        auto* data = reinterpret_cast<uint8_t*>(msg);
+        if (length32 == 0xFFFFFFFF) {
             // 64-bit message length
-            recvd = 0;
-
-            while (recvd < sizeof(uint64_t)) {
-                if (ctx->softShutdown)
-                    return 0;
-
-                const int64_t bytes = read(socketFD, reinterpret_cast<char*>(msg) + recvd, sizeof(uint64_t) - recvd);
-
-                if (bytes > 0)
-                    recvd += bytes;
-                else if (bytes == 0) {
-                    // Client disconnected
-                    close(socketFD);
-                    socketFD = -1;
-                    throw NetworkException(10056, "host disconnected");
-                } else {
-                    if (recvd == 0)
-                        return 0;
-
-                    if (errno == EWOULDBLOCK || errno == EAGAIN) {
-                        ctx->writerThread->contextSet(Thread::CONTEXT::SLEEP);
-                        usleep(ctx->pollIntervalUs);
-                        ctx->writerThread->contextSet(Thread::CONTEXT::CPU);
-                    } else
-                        return 0;
-                }
-            }
-
-            const uint32_t newLength = *reinterpret_cast<const uint32_t*>(msg);
-            if (length < newLength)
-                throw NetworkException(10055, "message from client exceeds buffer size (length: " + std::to_string(newLength) +
-                                              ", buffer size: " + std::to_string(length) + ")");
-            length = newLength;
-            recvd = 0;
+            memcpy(&newLength, readBuffer + sizeof(uint32_t), sizeof(uint64_t));
+            headerSize = FRAME_HEADER_MAX;
+        } else if (length32 == FRAME_COMPRESSED) {
+            // Compressed batch, read whole and served frame by frame
+            uint32_t compressed32;
+            uint32_t raw32;
+            memcpy(&compressed32, readBuffer + sizeof(uint32_t), sizeof(uint32_t));
+            memcpy(&raw32, readBuffer + 2 * sizeof(uint32_t), sizeof(uint32_t));
+            newLength = compressed32;
+            rawLength = raw32;
+            headerSize = FRAME_HEADER_MAX;
+            compressedInput.resize(newLength);
+            data = compressedInput.data();
         }
 
-        while (recvd < length) {
-            const int64_t bytes = read(socketFD, reinterpret_cast<char*>(msg) + recvd, length - recvd);
+        if (rawLength == 0 && length < newLength)
+            throw NetworkException(10055, "message from client exceeds buffer size (length: " + std::to_string(newLength) +
+                                          ", buffer size: " + std::to_string(length) + ")");
 
-            if (bytes > 0)
+        uint64_t recvd = std::min(readBufferLen - headerSize, newLength);
+        memcpy(reinterpret_cast<void*>(data), reinterpret_cast<const void*>(readBuffer + headerSize), recvd);
+        consumeReadBuffer(headerSize + recvd);
+
+        // The buffer is empty from here on
+        while (recvd < newLength) {
+            if (ctx->softShutdown)
+                return 0;
+
+            uint64_t bytes;
+            if (newLength - recvd >= RECEIVE_BUFFER) {
+                bytes = readSocket(data + recvd, newLength - recvd);
                 recvd += bytes;
-            else if (bytes == 0) {
-                // Client disconnected
-                close(socketFD);
-                socketFD = -1;
-                throw NetworkException(10056, "host disconnected");
             } else {
-                if (errno == EWOULDBLOCK || errno == EAGAIN) {
-                    ctx->writerThread->contextSet(Thread::CONTEXT::SLEEP);
-                    usleep(ctx->pollIntervalUs);
-                    ctx->writerThread->contextSet(Thread::CONTEXT::CPU);
-                } else
-                    return 0;
+                bytes = readSocket(readBuffer, RECEIVE_BUFFER);
+                readBufferLen = bytes;
+                const uint64_t toCopy = std::min(bytes, newLength - recvd);
+                memcpy(reinterpret_cast<void*>(data + recvd), reinterpret_cast<const void*>(readBuffer), toCopy);
+                consumeReadBuffer(toCopy);
+                recvd += toCopy;
+            }
+
+            if (bytes == 0 && !blocking) {
+                ctx->writerThread->contextSet(Thread::CONTEXT::SLEEP);
+                usleep(ctx->pollIntervalUs);
+                ctx->writerThread->contextSet(Thread::CONTEXT::CPU);
             }
         }
 
+        if (rawLength > 0) {
+            inflateFrames(newLength, rawLength);
+            return nextInflated(msg, length);
+        }
         return recvd;
     }
 
+    void StreamNetwork::inflateFrames(uint64_t compressedLength, uint64_t rawLength) {
+#ifdef LINK_LIBRARY_LZ4
+        inflated.resize(rawLength);
+        inflatedPos = 0;
+        const int size = LZ4_decompress_safe(reinterpret_cast<const char*>(compressedInput.data()), reinterpret_cast<char*>(inflated.data()),
+                                             static_cast<int>(compressedLength), static_cast<int>(rawLength));
+        if (size < 0 || static_cast<uint64_t>(size) != rawLength) {
+            closeSocket();
+            throw NetworkException(10061, "network error, invalid compressed batch of " + std::to_string(compressedLength) + " bytes");
+        }
+#else
+        closeSocket();
+        throw NetworkException(10061, "network error, compressed batch of " + std::to_string(compressedLength) + " bytes (" +
+                                      std::to_string(rawLength) + " uncompressed) received, but lz4 is not compiled");
+#endif /* LINK_LIBRARY_LZ4 */
+    }
+
+    uint64_t StreamNetwork::nextInflated(void* msg, uint64_t length) {
+        uint32_t length32;
+        uint64_t newLength;
+        uint64_t headerSize = sizeof(uint32_t);
+        if (inflated.size() - inflatedPos < sizeof(uint32_t))
+            throw NetworkException(10061, "network error, truncated compressed batch");
+        memcpy(&length32, inflated.data() + inflatedPos, sizeof(uint32_t));
+        newLength = length32;
+        if (length32 == 0xFFFFFFFF) {
+            if (inflated.size() - inflatedPos < FRAME_HEADER_MAX)
+                throw NetworkException(10061, "network error, truncated compressed batch");
+            memcpy(&newLength, inflated.data() + inflatedPos + sizeof(uint32_t), sizeof(uint64_t));
+            headerSize = FRAME_HEADER_MAX;
+        }
+        if (inflated.size() - inflatedPos - headerSize < newLength)
+            throw NetworkException(10061, "network error, truncated compressed batch");
+
+        if (length < newLength)
+            throw NetworkException(10055, "message from client exceeds buffer size (length: " + std::to_string(newLength) +
+                                          ", buffer size: " + std::to_string(length) + ")");
+
+        memcpy(msg, reinterpret_cast<const void*>(inflated.data() + inflatedPos + headerSize), newLength);
+        inflatedPos += headerSize + newLength;
+        if (inflatedPos == inflated.size()) {
+            inflated.clear();
+            inflatedPos = 0;
+        }
+        return newLength;
+    }
+
+    uint64_t StreamNetwork::receiveMessage(void* msg, uint64_t length) {
+        return receiveFrame(msg, length, true);
+    }
+
+    uint64_t StreamNetwork::receiveMessageNB(void* msg, uint64_t length) {
+        return receiveFrame(msg, length, false);
+    }
+
+    // Hands a pending connection over to a new stream, so the server socket can serve any number of clients
+    StreamNetwork* StreamNetwork::acceptClient() {
+        if (!isConnected())
+            return nullptr;
+
+        auto* client = new StreamNetwork(ctx, uri);
+        client->socketFD = socketFD;
+        client->poller = poller;
+        client->socketReady = socketReady;
+        client->setBatch(batchBytes, batchLatencyUs);
+        client->setTcp(tcpNoDelay, tcpCork, sendBufferBytes, keepAliveS);
+        client->sslCtx = sslCtx;
+        client->ssl = ssl;
+        socketFD = -1;
+        ssl = nullptr;
+        socketReady = Readiness();
+
+        try {
+            client->registerSocket(true);
+        } catch (NetworkException&) {
+            delete client;
+            throw;
+        }
+        return client;
+    }
+
     bool StreamNetwork::isConnected() {
         if (socketFD != -1)
             return true;
+        if (poller != nullptr && !serverReady.readable)
+            return false;
 
         int64_t addrlen = sizeof(address);
         socketFD = accept(serverFD, reinterpret_cast<struct sockaddr*>(&address), reinterpret_cast<socklen_t*>(&addrlen));
         if (socketFD < 0) {
-            if (errno == EWOULDBLOCK)
+            if (errno == EWOULDBLOCK || errno == EAGAIN) {
+                serverReady.readable = false;
                 return false;
+            }
 
             throw NetworkException(10061, "network error, errno: " + std::to_string(errno) + ", message: " + strerror(errno) + " (18)");
         }
@@ -429,9 +932,9 @@ namespace OpenLogReplicator {
         if (fcntl(socketFD, F_SETFL, flags | O_NONBLOCK) < 0)
             throw NetworkException(10061, "network error, errno: " + std::to_string(errno) + ", message: " + strerror(errno) + " (20)");
 
-        if (socketFD != -1)
-            return true;
-
-        return false;
+        setSocketOptions();
+        registerSocket(false);
+        startTls(true);
+        return true;
     }
 }
@@ -20,21 +20,114 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #ifndef STREAM_NETWORK_H_
 #define STREAM_NETWORK_H_
 
+#include <deque>
+#include <memory>
 #include <netinet/in.h>
+#include <sys/uio.h>
+#include <vector>
 
 #include "Stream.h"
 
+struct ssl_ctx_st;
+struct ssl_st;
+
 namespace OpenLogReplicator {
     class StreamNetwork final : public Stream {
     protected:
+        static constexpr uint64_t RECEIVE_BUFFER{65536};
+        static constexpr uint64_t FRAME_HEADER_MAX{sizeof(uint32_t) + sizeof(uint64_t)};
+        static constexpr int POLL_EVENTS{64};
+        static constexpr uint64_t TLS_RECORD{16384};
+        // Header of a compressed batch: the marker, 32-bit compressed and 32-bit uncompressed length, the batch holds ordinary frames
+        static constexpr uint32_t FRAME_COMPRESSED{0xFFFFFFFE};
+        static constexpr uint64_t COMPRESS_BATCH_MAX{4194304};
+
+        // Length-prefixed message waiting to be written, the header is 32-bit length or 0xFFFFFFFF followed by 64-bit length
+        struct Frame {
+            const uint8_t* data;
+            uint64_t length;
+            uint8_t header[FRAME_HEADER_MAX];
+            uint64_t headerSize;
+            // Own copy of the body when the caller's buffer does not outlive the call
+            std::unique_ptr<uint8_t[]> copy;
+        };
+
+        // Readiness reported by epoll, edge-triggered, so a flag is cleared only when the socket returns EAGAIN
+        struct Readiness {
+            bool readable{true};
+            bool writable{true};
+        };
+
         int socketFD{-1};
         int serverFD{-1};
         struct sockaddr_storage address{};
         std::string host;
         std::string port;
-        uint8_t readBuffer[READ_NETWORK_BUFFER]{};
+        uint8_t readBuffer[RECEIVE_BUFFER]{};
         uint64_t readBufferLen{0};
         struct addrinfo* res{nullptr};
+        // Server stream owning the epoll set the socket is registered in, nullptr when epoll is not used
+        StreamNetwork* poller{nullptr};
+        int epollFD{-1};
+        Readiness serverReady;
+        Readiness socketReady;
+        std::deque<Frame> frames;
+        // Bytes of the first frame already written
+        uint64_t frameOffset{0};
+        std::vector<iovec> iov;
+        uint64_t framesBytes{0};
+        time_ut framesStart{0};
+        uint64_t batchBytes{0};
+        uint64_t batchLatencyUs{0};
+        bool tcpNoDelay{true};
+        bool tcpCork{false};
+        bool corkPending{false};
+        uint64_t sendBufferBytes{0};
+        uint64_t keepAliveS{0};
+        // TLS, the context is created by the server or client stream and shared with the accepted clients
+        bool tls{false};
+        std::string tlsCert;
+        std::string tlsKey;
+        std::string tlsCa;
+        bool tlsKtls{true};
+        ssl_ctx_st* sslCtx{nullptr};
+        bool sslCtxOwner{false};
+        ssl_st* ssl{nullptr};
+        bool tlsConnected{false};
+        // Records are encrypted by the kernel, frames are written to the socket directly
+        bool ktlsSend{false};
+        // Length of an SSL_write() to be repeated, the bytes stay in the buffer
+        uint64_t tlsWriteLength{0};
+        std::unique_ptr<uint8_t[]> tlsBuffer;
+        bool compression{false};
+        // Frames waiting to be compressed as one batch, and the reusable compression state
+        std::vector<uint8_t> compressInput;
+        std::unique_ptr<uint8_t[]> compressState;
+        std::vector<uint8_t> compressedInput;
+        std::vector<uint8_t> inflated;
+        uint64_t inflatedPos{0};
+
+        void appendFrame(const void* msg, uint64_t length);
+        void writeFrames();
+        void writeFramesTls();
+        uint64_t gatherFrames(uint8_t* buffer, uint64_t size) const;
+        void consumeFrames(uint64_t bytes);
+        void compressFrames();
+        void inflateFrames(uint64_t compressedLength, uint64_t rawLength);
+        uint64_t nextInflated(void* msg, uint64_t length);
+        void initializeTls(bool server);
+        void startTls(bool server);
+        bool tlsHandshake();
+        void tlsRetry(int ret);
+        [[nodiscard]] bool tlsPending() const;
+        [[nodiscard]] static std::string tlsErrorString();
+        void pushCork();
+        void setSocketOptions();
+        void registerSocket(bool modify);
+        void closeSocket();
+        uint64_t readSocket(uint8_t* buffer, uint64_t size);
+        void consumeReadBuffer(uint64_t size);
+        uint64_t receiveFrame(void* msg, uint64_t length, bool blocking);
 
     public:
         StreamNetwork(Ctx* newCtx, std::string newUri);
@@ -44,10 +137,20 @@ namespace OpenLogReplicator {
         [[nodiscard]] std::string getName() const override;
         void initializeClient() override;
         void initializeServer() override;
+        void setBatch(uint64_t newBatchBytes, uint64_t newBatchLatencyUs);
+        void setTcp(bool newTcpNoDelay, bool newTcpCork, uint64_t newSendBufferBytes, uint64_t newKeepAliveS);
+        void setTls(std::string newTlsCert, std::string newTlsKey, std::string newTlsCa, bool newTlsKtls);
+        void copyQueued() override;
+        [[nodiscard]] bool supportsCompression(const std::string& method) const override;
+        void setCompression(const std::string& method) override;
         void sendMessage(const void* msg, uint64_t length) override;
+        void queueMessage(const void* msg, uint64_t length) override;
+        void flush(bool force) override;
         uint64_t receiveMessage(void* msg, uint64_t length) override;
         uint64_t receiveMessageNB(void* msg, uint64_t length) override;
         [[nodiscard]] bool isConnected() override;
+        void pollEvents() override;
+        [[nodiscard]] StreamNetwork* acceptClient() override;
     };
 }
 
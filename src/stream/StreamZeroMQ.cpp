@@ -20,6 +20,7 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include <unistd.h>
 #include <zmq.h>
 
+#include "../common/Clock.h"
 #include "../common/Ctx.h"
 #include "../common/Thread.h"
 #include "../common/exception/NetworkException.h"
@@ -32,6 +33,9 @@ namespace OpenLogReplicator {
     }
 
     StreamZeroMQ::~StreamZeroMQ() {
+        // Zero-copy messages still queued point to builder memory, they are dropped instead of sent after it is gone
+        const int linger = 0;
+        zmq_setsockopt(socket, ZMQ_LINGER, &linger, sizeof(linger));
         zmq_close(socket);
         zmq_ctx_term(context);
     }
@@ -61,7 +65,75 @@ namespace OpenLogReplicator {
             throw NetworkException(10064, "ZeroMQ bind to " + uri + " failed, message: " + std::to_string(errno));
     }
 
+    void StreamZeroMQ::setBatch(uint64_t newBatchBytes, uint64_t newBatchLatencyUs) {
+        batchBytes = newBatchBytes;
+        batchLatencyUs = newBatchLatencyUs;
+        if (batchBytes > 0)
+            parts.reserve(BATCH_MAX_PARTS);
+    }
+
+    // Called by a ZeroMQ I/O thread, the builder memory itself is released by the writer once the client confirms the message
+    void StreamZeroMQ::releasePart(void* data __attribute__((unused)), void* hint) {
+        reinterpret_cast<StreamZeroMQ*>(hint)->inFlight.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // The parts go out as one multipart message without copying, ZeroMQ queues the rest atomically once the first part is accepted
+    bool StreamZeroMQ::sendParts(bool wait) {
+        uint64_t i = 0;
+        while (i < parts.size()) {
+            zmq_msg_t msg;
+            if (zmq_msg_init_data(&msg, const_cast<void*>(parts[i].data), parts[i].length, releasePart, this) != 0)
+                throw NetworkException(10054, "network send error");
+            inFlight.fetch_add(1, std::memory_order_relaxed);
+
+            const int flags = ZMQ_DONTWAIT | (i + 1 < parts.size() ? ZMQ_SNDMORE : 0);
+            if (zmq_msg_send(&msg, socket, flags) >= 0) {
+                ++i;
+                continue;
+            }
+
+            const int err = errno;
+            zmq_msg_close(&msg);
+            if (err == EAGAIN && i == 0) {
+                if (!wait || ctx->softShutdown)
+                    return false;
+                ctx->writerThread->contextSet(Thread::CONTEXT::SLEEP);
+                usleep(ctx->pollIntervalUs);
+                ctx->writerThread->contextSet(Thread::CONTEXT::CPU);
+                continue;
+            }
+
+            throw NetworkException(10054, "network send error");
+        }
+
+        parts.clear();
+        partsBytes = 0;
+        return true;
+    }
+
+    void StreamZeroMQ::queueMessage(const void* msg, uint64_t length) {
+        if (parts.empty())
+            partsStart = ctx->clock->getTimeUt();
+        parts.push_back({msg, length});
+        partsBytes += length;
+
+        if (batchBytes == 0 || partsBytes >= batchBytes || parts.size() >= BATCH_MAX_PARTS)
+            sendParts(true);
+    }
+
+    void StreamZeroMQ::flush(bool force) {
+        if (parts.empty())
+            return;
+        if (!force && ctx->clock->getTimeUt() - partsStart < static_cast<time_ut>(batchLatencyUs))
+            return;
+        sendParts(false);
+    }
+
+    // The caller reuses its buffer, so the message is copied, anything batched before goes first
     void StreamZeroMQ::sendMessage(const void* msg, uint64_t length) {
+        if (!parts.empty() && !sendParts(true))
+            return;
+
         while (!ctx->softShutdown) {
             const int64_t ret = zmq_send(socket, msg, length, ZMQ_NOBLOCK);
             if (ret == static_cast<int64_t>(length))
@@ -20,13 +20,34 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #ifndef STREAM_ZERO_MQ_H_
 #define STREAM_ZERO_MQ_H_
 
+#include <atomic>
+#include <vector>
+
 #include "Stream.h"
 
 namespace OpenLogReplicator {
     class StreamZeroMQ final : public Stream {
     protected:
+        static constexpr uint64_t BATCH_MAX_PARTS{1024};
+
+        // Message borrowed from the caller, sent as one part of a multipart batch
+        struct Part {
+            const void* data;
+            uint64_t length;
+        };
+
         void* socket{nullptr};
         void* context{nullptr};
+        std::vector<Part> parts;
+        uint64_t partsBytes{0};
+        time_ut partsStart{0};
+        uint64_t batchBytes{0};
+        uint64_t batchLatencyUs{0};
+        // Zero-copy messages ZeroMQ has not released yet
+        std::atomic<uint64_t> inFlight{0};
+
+        static void releasePart(void* data, void* hint);
+        bool sendParts(bool wait);
 
     public:
         StreamZeroMQ(Ctx* newCtx, std::string newUri);
@@ -38,7 +59,10 @@ namespace OpenLogReplicator {
         [[nodiscard]] std::string getName() const override;
         void initializeClient() override;
         void initializeServer() override;
+        void setBatch(uint64_t newBatchBytes, uint64_t newBatchLatencyUs);
         void sendMessage(const void* msg, uint64_t length) override;
+        void queueMessage(const void* msg, uint64_t length) override;
+        void flush(bool force) override;
         uint64_t receiveMessage(void* msg, uint64_t length) override;
         uint64_t receiveMessageNB(void* msg, uint64_t length) override;
         [[nodiscard]] bool isConnected() override;
@@ -0,0 +1,271 @@
+/* Per-table output files written by a pool of threads
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+#include "../common/DbTable.h"
+#include "../common/exception/RuntimeException.h"
+#include "../metadata/Metadata.h"
+#include "../metadata/Schema.h"
+#include "FilePartitioner.h"
+
+namespace OpenLogReplicator {
+    FilePartitionIo::FilePartitionIo(Ctx* newCtx, std::string newAlias, FilePartitioner* newPartitioner) :
+            Thread(newCtx, std::move(newAlias)),
+            partitioner(newPartitioner) {
+    }
+
+    void FilePartitionIo::wakeUp() {
+        Thread::wakeUp();
+        partitioner->wakeUp();
+    }
+
+    void FilePartitionIo::run() {
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
+            std::ostringstream ss;
+            ss << std::this_thread::get_id();
+            ctx->logTrace(Ctx::TRACE::THREADS, "file partition io (" + ss.str() + ") start");
+        }
+
+        try {
+            FilePartition* partition;
+            while ((partition = partitioner->take(this)) != nullptr) {
+                partitioner->writePartition(this, partition);
+                partitioner->written(partition);
+            }
+        } catch (RuntimeException& ex) {
+            ctx->error(ex.code, ex.msg);
+            ctx->stopHard();
+        }
+
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
+            std::ostringstream ss;
+            ss << std::this_thread::get_id();
+            ctx->logTrace(Ctx::TRACE::THREADS, "file partition io (" + ss.str() + ") stop");
+        }
+    }
+
+    // The partition name replaces "%p" in the output file name
+    FilePartitioner::FilePartitioner(Ctx* newCtx, std::string newAlias, Thread* newOwner, const std::string& output, bool newByTable,
+                                     uint64_t newBuckets, uint64_t newIoThreads, uint64_t newAppend, uint64_t newFlushSize) :
+            ctx(newCtx),
+            alias(std::move(newAlias)),
+            owner(newOwner),
+            byTable(newByTable),
+            buckets(newBuckets),
+            ioThreads(newIoThreads),
+            append(newAppend),
+            flushSize(newFlushSize) {
+        const size_t pos = output.find("%p");
+        pathPrefix = output.substr(0, pos);
+        if (pos != std::string::npos)
+            pathSuffix = output.substr(pos + 2);
+    }
+
+    FilePartitioner::~FilePartitioner() {
+        stop();
+        for (FilePartitionIo* thread: threads) {
+            ctx->finishThread(thread);
+            delete thread;
+        }
+        threads.clear();
+
+        for (auto& [_, partition]: partitions) {
+            if (partition->fd != -1)
+                close(partition->fd);
+            delete partition;
+        }
+        partitions.clear();
+        objPartitions.clear();
+        dirtyPartitions.clear();
+    }
+
+    void FilePartitioner::initialize() {
+        for (uint64_t i = 0; i < ioThreads; ++i) {
+            auto* thread = new FilePartitionIo(ctx, alias + "-io" + std::to_string(i), this);
+            threads.push_back(thread);
+            ctx->spawnThread(thread);
+        }
+        ctx->info(0, "partitioned file output by " + std::string(byTable ? "table" : std::to_string(buckets) + " hash buckets") +
+                     " with " + std::to_string(ioThreads) + " I/O threads");
+    }
+
+    FilePartition* FilePartitioner::openPartition(const std::string& name) {
+        auto* partition = new FilePartition();
+        partition->fileName = pathPrefix + name + pathSuffix;
+        partition->buffer.reserve(flushSize);
+        partition->writing.reserve(flushSize);
+
+        struct stat fileStat{};
+        if (stat(partition->fileName.c_str(), &fileStat) == 0 && append == 0) {
+            delete partition;
+            throw RuntimeException(10003, "file: " + pathPrefix + name + pathSuffix + " - get metadata returned: file exists");
+        }
+
+        ctx->info(0, "opening output file: " + partition->fileName);
+        partition->fd = open(partition->fileName.c_str(), O_CREAT | O_WRONLY | O_APPEND, S_IRUSR | S_IWUSR);
+        if (partition->fd == -1) {
+            const std::string fileName(partition->fileName);
+            delete partition;
+            throw RuntimeException(10006, "file: " + fileName + " - open for writing returned: " + strerror(errno));
+        }
+
+        partitions.insert_or_assign(name, partition);
+        return partition;
+    }
+
+    // Messages of no table (transaction begin and commit) go to the default partition, the route of an object is kept once found
+    FilePartition* FilePartitioner::route(Thread* t, typeObj obj, Metadata* metadata) {
+        const auto& it = objPartitions.find(obj);
+        if (it != objPartitions.end())
+            return it->second;
+
+        std::string name;
+        if (!byTable)
+            name = std::to_string(obj % buckets);
+        else if (obj == 0 || metadata == nullptr)
+            name = "default";
+        else {
+            {
+                t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::WRITER_SCHEMA);
+                std::unique_lock<std::mutex> const lck(metadata->mtxSchema);
+                const DbTable* table = metadata->schema->checkTableDict(obj);
+                if (table != nullptr)
+                    name = table->owner + "." + table->name;
+                else
+                    name = "OBJ" + std::to_string(obj);
+            }
+            t->contextSet(Thread::CONTEXT::CPU);
+            std::replace(name.begin(), name.end(), '/', '_');
+        }
+
+        const auto& partitionIt = partitions.find(name);
+        FilePartition* partition = partitionIt != partitions.end() ? partitionIt->second : openPartition(name);
+        objPartitions.insert_or_assign(obj, partition);
+        return partition;
+    }
+
+    void FilePartitioner::write(Thread* t, FilePartition* partition, const uint8_t* data, uint64_t size) {
+        partition->buffer.insert(partition->buffer.end(), data, data + size);
+        if (!partition->dirty) {
+            partition->dirty = true;
+            dirtyPartitions.push_back(partition);
+        }
+
+        if (partition->buffer.size() >= flushSize)
+            submit(t, partition);
+    }
+
+    // A partition has one write in flight at most, so its file grows in the order the messages came
+    void FilePartitioner::submit(Thread* t, FilePartition* partition) {
+        t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::WRITER_PARTITION);
+        std::unique_lock<std::mutex> lck(mtx);
+        while (partition->busy && !ctx->hardShutdown) {
+            t->contextSet(Thread::CONTEXT::WAIT, Thread::REASON::WRITER_PARTITION_FULL);
+            condDone.wait_for(lck, std::chrono::microseconds(ctx->pollIntervalUs));
+        }
+        if (!partition->busy) {
+            partition->writing.swap(partition->buffer);
+            partition->buffer.clear();
+            partition->busy = true;
+            ++inFlight;
+            work.push_back(partition);
+            condWork.notify_one();
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
+    }
+
+    void FilePartitioner::flushAll(Thread* t) {
+        for (FilePartition* partition: dirtyPartitions) {
+            partition->dirty = false;
+            if (!partition->buffer.empty())
+                submit(t, partition);
+        }
+        dirtyPartitions.clear();
+
+        t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::WRITER_PARTITION);
+        std::unique_lock<std::mutex> lck(mtx);
+        while (inFlight > 0 && !ctx->hardShutdown) {
+            t->contextSet(Thread::CONTEXT::WAIT, Thread::REASON::WRITER_PARTITION_FULL);
+            condDone.wait_for(lck, std::chrono::microseconds(ctx->pollIntervalUs));
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
+    }
+
+    void FilePartitioner::stop() {
+        std::unique_lock<std::mutex> const lck(mtx);
+        stopped = true;
+        condWork.notify_all();
+    }
+
+    void FilePartitioner::wakeUp() {
+        std::unique_lock<std::mutex> const lck(mtx);
+        condWork.notify_all();
+        condDone.notify_all();
+    }
+
+    // Queued writes are finished before the threads stop, with the owner done writing there is nothing more to come
+    FilePartition* FilePartitioner::take(Thread* t) {
+        t->contextSet(Thread::CONTEXT::MUTEX, Thread::REASON::WRITER_PARTITION);
+        std::unique_lock<std::mutex> lck(mtx);
+        while (work.empty() && !stopped && !ctx->hardShutdown && !(ctx->softShutdown && owner->finished)) {
+            if (unlikely(ctx->isTraceSet(Ctx::TRACE::SLEEP)))
+                ctx->logTrace(Ctx::TRACE::SLEEP, "FilePartitioner:take");
+            t->contextSet(Thread::CONTEXT::WAIT, Thread::REASON::WRITER_PARTITION_NO_WORK);
+            condWork.wait_for(lck, std::chrono::microseconds(ctx->pollIntervalUs));
+        }
+
+        FilePartition* partition = nullptr;
+        if (!work.empty() && !ctx->hardShutdown) {
+            partition = work.front();
+            work.pop_front();
+        }
+        t->contextSet(Thread::CONTEXT::CPU);
+        return partition;
+    }
+
+    void FilePartitioner::writePartition(Thread* t, FilePartition* partition) {
+        const uint8_t* data = partition->writing.data();
+        uint64_t left = partition->writing.size();
+        while (left > 0) {
+            t->contextSet(Thread::CONTEXT::OS, Thread::REASON::OS);
+            const int64_t bytesWritten = ::write(partition->fd, data, left);
+            t->contextSet(Thread::CONTEXT::CPU);
+            if (bytesWritten <= 0)
+                throw RuntimeException(10007, "file: " + partition->fileName + " - " + std::to_string(bytesWritten) +
+                                              " bytes written instead of " + std::to_string(left) + ", code returned: " +
+                                              strerror(errno));
+            data += bytesWritten;
+            left -= bytesWritten;
+        }
+    }
+
+    void FilePartitioner::written(FilePartition* partition) {
+        std::unique_lock<std::mutex> const lck(mtx);
+        partition->writing.clear();
+        partition->busy = false;
+        --inFlight;
+        condDone.notify_all();
+    }
+}
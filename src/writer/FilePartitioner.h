@@ -0,0 +1,121 @@
+/* Header for FilePartitioner class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef FILE_PARTITIONER_H_
+#define FILE_PARTITIONER_H_
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../common/Thread.h"
+#include "../common/types/Types.h"
+
+namespace OpenLogReplicator {
+    class FilePartitioner;
+    class Metadata;
+
+    // Output file of one table or one hash bucket of tables, filled by the merge writer and written by an I/O thread
+    struct FilePartition {
+        std::string fileName;
+        int fd{-1};
+        std::vector<uint8_t> buffer;
+        // Swapped with the buffer when handed to an I/O thread, owned by it until busy is cleared
+        std::vector<uint8_t> writing;
+        bool busy{false};
+        // Listed in dirtyPartitions until the next flushAll()
+        bool dirty{false};
+    };
+
+    class FilePartitionIo final : public Thread {
+    protected:
+        FilePartitioner* partitioner;
+
+        void run() override;
+
+    public:
+        FilePartitionIo(Ctx* newCtx, std::string newAlias, FilePartitioner* newPartitioner);
+
+        void wakeUp() override;
+
+        std::string getName() const override {
+            return {"FilePartitionIo: " + alias};
+        }
+    };
+
+    // Messages are routed by object to per-partition buffers, full buffers are written in parallel by the I/O threads. The
+    // caller hands messages back for confirmation only after flushAll(), so the confirmed position never passes data not written
+    class FilePartitioner final {
+    protected:
+        Ctx* ctx;
+        std::string alias;
+        Thread* owner;
+        std::string pathPrefix;
+        std::string pathSuffix;
+        bool byTable;
+        uint64_t buckets;
+        uint64_t ioThreads;
+        uint64_t append;
+        uint64_t flushSize;
+
+        std::mutex mtx;
+        std::condition_variable condWork;
+        std::condition_variable condDone;
+        std::deque<FilePartition*> work;
+        uint64_t inFlight{0};
+        bool stopped{false};
+
+        std::vector<FilePartitionIo*> threads;
+        std::unordered_map<std::string, FilePartition*> partitions;
+        std::unordered_map<typeObj, FilePartition*> objPartitions;
+        std::vector<FilePartition*> dirtyPartitions;
+
+        FilePartition* openPartition(const std::string& name);
+        void submit(Thread* t, FilePartition* partition);
+
+    public:
+        static constexpr uint64_t MAX_BUCKETS{4096};
+        static constexpr uint64_t MAX_IO_THREADS{64};
+
+        FilePartitioner(Ctx* newCtx, std::string newAlias, Thread* newOwner, const std::string& output, bool newByTable, uint64_t newBuckets,
+                        uint64_t newIoThreads, uint64_t newAppend, uint64_t newFlushSize);
+        ~FilePartitioner();
+
+        void initialize();
+        FilePartition* route(Thread* t, typeObj obj, Metadata* metadata);
+        void write(Thread* t, FilePartition* partition, const uint8_t* data, uint64_t size);
+        void flushAll(Thread* t);
+        void stop();
+        void wakeUp();
+
+        // I/O thread side
+        FilePartition* take(Thread* t);
+        void writePartition(Thread* t, FilePartition* partition);
+        void written(FilePartition* partition);
+
+        [[nodiscard]] uint64_t getPartitions() const {
+            return partitions.size();
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,154 @@
+/* Thread syncing output file to disk in groups
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <cstring>
+#include <thread>
+#include <unistd.h>
+
+#include "../common/exception/RuntimeException.h"
+#include "FileSyncer.h"
+
+namespace OpenLogReplicator {
+    FileSyncer::FileSyncer(Ctx* newCtx, std::string newAlias, Thread* newOwner, uint64_t newIntervalUs,
+                           uint64_t newSyncSize) :
+            Thread(newCtx, std::move(newAlias)),
+            owner(newOwner),
+            intervalUs(newIntervalUs),
+            syncSize(newSyncSize) {
+    }
+
+    // Called by the writer after opening a new output file
+    void FileSyncer::attach(int newFd, const std::string& newFileName) {
+        std::unique_lock<std::mutex> const lck(fdMtx);
+        fd = newFd;
+        fileName = newFileName;
+    }
+
+    // Called by the writer before closing the output file, everything written so far is synced at once
+    void FileSyncer::detach(Thread* t) {
+        syncNow(t, true);
+    }
+
+    void FileSyncer::syncNow(Thread* t, bool close) {
+        uint64_t target;
+        {
+            t->contextSet(CONTEXT::MUTEX, REASON::WRITER_SYNC);
+            std::unique_lock<std::mutex> const lck(mtx);
+            target = writtenBytes;
+        }
+        {
+            std::unique_lock<std::mutex> const lck(fdMtx);
+            syncFile(t, target);
+            if (close)
+                fd = -1;
+        }
+        t->contextSet(CONTEXT::CPU);
+    }
+
+    void FileSyncer::written(uint64_t bytes) {
+        std::unique_lock<std::mutex> const lck(mtx);
+        writtenBytes = bytes;
+        if (syncSize > 0 && bytes - getDurableBytes() >= syncSize && !requested) {
+            requested = true;
+            condSync.notify_all();
+        }
+    }
+
+    void FileSyncer::request() {
+        std::unique_lock<std::mutex> const lck(mtx);
+        if (requested || writtenBytes == getDurableBytes())
+            return;
+        requested = true;
+        condSync.notify_all();
+    }
+
+    void FileSyncer::stop() {
+        std::unique_lock<std::mutex> const lck(mtx);
+        stopped = true;
+        condSync.notify_all();
+    }
+
+    void FileSyncer::wakeUp() {
+        std::unique_lock<std::mutex> const lck(mtx);
+        condSync.notify_all();
+    }
+
+    // Requires fdMtx, bytes up to target are already written to the current descriptor or synced by detach()
+    void FileSyncer::syncFile(Thread* t, uint64_t target) {
+        if (target <= getDurableBytes())
+            return;
+
+        if (fd != -1) {
+            t->contextSet(CONTEXT::OS, REASON::OS);
+            const int ret = fdatasync(fd);
+            t->contextSet(CONTEXT::MUTEX, REASON::WRITER_SYNC);
+            if (ret != 0)
+                throw RuntimeException(10075, "file: " + fileName + " - fdatasync returned: " + strerror(errno));
+        }
+        durableBytes.store(target, std::memory_order_release);
+    }
+
+    void FileSyncer::run() {
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
+            std::ostringstream ss;
+            ss << std::this_thread::get_id();
+            ctx->logTrace(Ctx::TRACE::THREADS, "file syncer (" + ss.str() + ") start");
+        }
+
+        try {
+            while (!ctx->hardShutdown) {
+                uint64_t target;
+                bool last;
+                {
+                    contextSet(CONTEXT::MUTEX, REASON::WRITER_SYNC);
+                    std::unique_lock<std::mutex> lck(mtx);
+                    if (!requested && !stopped) {
+                        if (unlikely(ctx->isTraceSet(Ctx::TRACE::SLEEP)))
+                            ctx->logTrace(Ctx::TRACE::SLEEP, "FileSyncer:run");
+                        contextSet(CONTEXT::WAIT, REASON::WRITER_SYNC_NO_WORK);
+                        condSync.wait_for(lck, std::chrono::microseconds(intervalUs));
+                    }
+                    requested = false;
+                    target = writtenBytes;
+                    // The owner is done writing, the rest is synced by detach() when the file is closed
+                    last = stopped || (ctx->softShutdown && owner->finished);
+                }
+                contextSet(CONTEXT::CPU);
+                {
+                    contextSet(CONTEXT::MUTEX, REASON::WRITER_SYNC);
+                    std::unique_lock<std::mutex> const lck(fdMtx);
+                    syncFile(this, target);
+                }
+                contextSet(CONTEXT::CPU);
+
+                if (last)
+                    break;
+            }
+        } catch (RuntimeException& ex) {
+            ctx->error(ex.code, ex.msg);
+            ctx->stopHard();
+        }
+
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
+            std::ostringstream ss;
+            ss << std::this_thread::get_id();
+            ctx->logTrace(Ctx::TRACE::THREADS, "file syncer (" + ss.str() + ") stop");
+        }
+    }
+}
@@ -0,0 +1,73 @@
+/* Header for FileSyncer class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef FILE_SYNCER_H_
+#define FILE_SYNCER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+#include "../common/Thread.h"
+
+namespace OpenLogReplicator {
+    // Background thread making the output file durable in groups, the writer confirms messages up to getDurableBytes()
+    class FileSyncer final : public Thread {
+    protected:
+        Thread* owner;
+        uint64_t intervalUs;
+        uint64_t syncSize;
+
+        std::mutex mtx;
+        std::condition_variable condSync;
+        uint64_t writtenBytes{0};
+        bool requested{false};
+        bool stopped{false};
+
+        // Held for the time of fdatasync() so that the descriptor is not closed under it
+        std::mutex fdMtx;
+        int fd{-1};
+        std::string fileName;
+        std::atomic<uint64_t> durableBytes{0};
+
+        void run() override;
+        void syncFile(Thread* t, uint64_t target);
+
+    public:
+        FileSyncer(Ctx* newCtx, std::string newAlias, Thread* newOwner, uint64_t newIntervalUs, uint64_t newSyncSize);
+
+        void attach(int newFd, const std::string& newFileName);
+        void detach(Thread* t);
+        void syncNow(Thread* t, bool close = false);
+        void written(uint64_t bytes);
+        void request();
+        void stop();
+        void wakeUp() override;
+
+        [[nodiscard]] uint64_t getDurableBytes() const {
+            return durableBytes.load(std::memory_order_acquire);
+        }
+
+        std::string getName() const override {
+            return {"FileSyncer: " + alias};
+        }
+    };
+}
+
+#endif
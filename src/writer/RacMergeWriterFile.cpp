@@ -1,8 +1,13 @@
 #include <algorithm>
+#include <thread>
+#include <unistd.h>
 
 #include "../builder/Builder.h"
 #include "../common/exception/ConfigurationException.h"
+#include "../common/exception/DataException.h"
+#include "../common/exception/RuntimeException.h"
 #include "../metadata/Metadata.h"
+#include "FileSyncer.h"
 #include "RacMergeWriterFile.h"
 
 namespace OpenLogReplicator {
@@ -10,40 +15,298 @@ namespace OpenLogReplicator {
                            Metadata *newMetadata,
                            std::string newOutput, std::string newTimestampFormat, uint64_t newMaxFileSize,
                            uint64_t newNewLine, uint64_t newAppend,
-                           uint newWriteBufferFlushSize) : WriterFile(newCtx, std::move(newAlias), std::move(newDatabase),
+                           uint newWriteBufferFlushSize, bool newZeroCopy,
+                           uint64_t newFsyncIntervalUs, uint64_t newFsyncSize) : WriterFile(newCtx, std::move(newAlias), std::move(newDatabase),
                                                                   newBuilder, newMetadata,
                                                            std::move(newOutput),
                                                            std::move(newTimestampFormat),
                                                            newMaxFileSize,
                                                            newNewLine,
                                                            newAppend,
-                                                           newWriteBufferFlushSize) {
+                                                           newWriteBufferFlushSize,
+                                                           newZeroCopy,
+                                                           newFsyncIntervalUs,
+                                                           newFsyncSize) {
     }
 
-    // void RacMergeWriterFile::sendMessage(BuilderMsg *msg) {
-    //     // racMergeWriterFile->sendMessage(this, msg);
-    // }
+    RacMergeWriterFile::~RacMergeWriterFile() {
+        delete partitioner;
+        partitioner = nullptr;
+        for (RacMergeInput* input: inputs)
+            delete input;
+        inputs.clear();
+    }
+
+    RacMergeInput* RacMergeWriterFile::registerWriter(RacWriterFile* writer) {
+        auto* input = new RacMergeInput(writer, ctx->queueSize);
+        input->lastActive = ctx->clock->getTimeUt();
+        {
+            std::unique_lock<std::mutex> const lck(mtx);
+            inputs.push_back(input);
+        }
+        return input;
+    }
+
+    bool RacMergeWriterFile::enqueue(RacMergeInput* input, BuilderMsg* msg) {
+        if (!input->pending.push(msg))
+            return false;
+
+        if (msg->scn != Scn::none() && msg->scn.getData() > input->watermark.load(std::memory_order_relaxed))
+            input->watermark.store(msg->scn.getData(), std::memory_order_release);
+        input->closed.store(msg->isFlagSet(BuilderMsg::OUTPUT_BUFFER::CLOSED), std::memory_order_release);
+
+        {
+            std::unique_lock<std::mutex> const lck(mtx);
+            if (sleeping)
+                condMerge.notify_all();
+        }
+        return true;
+    }
+
+    // Progress of a producer with nothing to write: every message handed in before is already queued, so the messages of the
+    // other inputs up to this scn don't wait for it
+    void RacMergeWriterFile::advance(RacMergeInput* input, Scn scn, bool closed) {
+        if (scn != Scn::none() && scn.getData() > input->watermark.load(std::memory_order_relaxed))
+            input->watermark.store(scn.getData(), std::memory_order_release);
+        input->closed.store(closed, std::memory_order_release);
+
+        std::unique_lock<std::mutex> const lck(mtx);
+        if (sleeping)
+            condMerge.notify_all();
+    }
+
+    void RacMergeWriterFile::inputFinished(RacMergeInput* input) {
+        input->finished = true;
+        std::unique_lock<std::mutex> const lck(mtx);
+        condMerge.notify_all();
+    }
 
-    void RacMergeWriterFile::sendMessage(RacWriterFile * write, BuilderMsg * msg) {
+    void RacMergeWriterFile::setPartitions(bool byTable, uint64_t buckets, uint64_t ioThreads) {
+        partitioner = new FilePartitioner(ctx, alias, this, output, byTable, buckets, ioThreads, append, writeBufferFlushSize);
+    }
+
+    void RacMergeWriterFile::initialize() {
+        WriterFile::initialize();
+        if (partitioner != nullptr)
+            partitioner->initialize();
+    }
+
+    void RacMergeWriterFile::wakeUp() {
+        Thread::wakeUp();
         std::unique_lock<std::mutex> const lck(mtx);
-        sendMessage(msg);
-        flush();
+        condMerge.notify_all();
     }
 
+    // The message is confirmed by its producer after flushBatch(), so in zero-copy mode it is gathered in place
     void RacMergeWriterFile::sendMessage(BuilderMsg * msg) {
         checkFile(msg->scn, msg->sequence, msg->size + newLine);
 
-        bufferedWrite(msg->data + msg->tagSize, msg->size - msg->tagSize);
+        if (zeroCopy)
+            gatherWrite(msg->data + msg->tagSize, msg->size - msg->tagSize);
+        else
+            bufferedWrite(msg->data + msg->tagSize, msg->size - msg->tagSize);
         fileSize += msg->size - msg->tagSize;
 
         if (newLine > 0) {
-            bufferedWrite(newLineMsg, newLine);
+            if (zeroCopy)
+                gatherWrite(newLineMsg, newLine);
+            else
+                bufferedWrite(newLineMsg, newLine);
             fileSize += newLine;
         }
     }
 
-    void RacMergeWriterFile::run() {
+    void RacMergeWriterFile::sendPartitioned(const RacMergeInput* input, BuilderMsg* msg) {
+        FilePartition* partition = partitioner->route(this, msg->obj, input->metadata);
+        partitioner->write(this, partition, msg->data + msg->tagSize, msg->size - msg->tagSize);
+        if (newLine > 0)
+            partitioner->write(this, partition, newLineMsg, newLine);
+    }
+
+    // Min-heap on the head message of every input: commit scn first, then position in the redo stream
+    bool RacMergeWriterFile::heapCompare(const RacMergeInput* input1, const RacMergeInput* input2) {
+        const BuilderMsg* msg1 = *const_cast<RacMergeInput*>(input1)->pending.front();
+        const BuilderMsg* msg2 = *const_cast<RacMergeInput*>(input2)->pending.front();
+        if (msg1->scn != msg2->scn)
+            return msg1->scn > msg2->scn;
+        if (msg1->lwnScn != msg2->lwnScn)
+            return msg1->lwnScn > msg2->lwnScn;
+        if (msg1->lwnIdx != msg2->lwnIdx)
+            return msg1->lwnIdx > msg2->lwnIdx;
+        return input1 > input2;
+    }
+
+    bool RacMergeWriterFile::fillHeap(time_ut now) {
+        bool added = false;
+        for (RacMergeInput* input: inputs) {
+            if (input->inHeap || input->pending.front() == nullptr)
+                continue;
+
+            input->inHeap = true;
+            input->lastActive = now;
+            heap.push_back(input);
+            std::push_heap(heap.begin(), heap.end(), heapCompare);
+            added = true;
+        }
+        return added;
+    }
+
+    // The message can be written when no other input can still deliver anything older
+    bool RacMergeWriterFile::isReady(const BuilderMsg* msg, time_ut now) const {
+        for (const RacMergeInput* input: inputs) {
+            if (input->inHeap || input->finished || input->closed.load(std::memory_order_acquire))
+                continue;
+
+            if (msg->scn != Scn::none() && input->watermark.load(std::memory_order_acquire) >= msg->scn.getData())
+                continue;
+
+            if (now - input->lastActive > IDLE_INPUT_US)
+                continue;
+
+            return false;
+        }
+        return true;
+    }
+
+    bool RacMergeWriterFile::allFinished() const {
+        for (const RacMergeInput* input: inputs)
+            if (!input->finished || !input->pending.empty())
+                return false;
+        return true;
+    }
+
+    // In partitioned mode the batch is handed back once all partitions holding its messages are written
+    void RacMergeWriterFile::flushBatch() {
+        if (partitioner != nullptr)
+            partitioner->flushAll(this);
+        else
+            flush();
+
+        // With group commit only the messages already durable are handed back, the rest waits for the syncer
+        if (syncer != nullptr) {
+            for (const auto& entry: batch)
+                unsyncedBatch.emplace_back(writtenBytes, entry);
+            batch.clear();
+
+            const uint64_t durableBytes = syncer->getDurableBytes();
+            while (!unsyncedBatch.empty() && unsyncedBatch.front().first <= durableBytes) {
+                batch.push_back(unsyncedBatch.front().second);
+                unsyncedBatch.pop_front();
+            }
+        }
+
+        RacMergeInput* lastInput = nullptr;
+        for (auto& [input, msg]: batch) {
+            while (!input->done.push(msg)) {
+                if (ctx->hardShutdown)
+                    return;
+                input->writer->wakeUp();
+                contextSet(CONTEXT::SLEEP);
+                usleep(ctx->pollIntervalUs);
+                contextSet(CONTEXT::CPU);
+            }
+
+            if (input != lastInput && lastInput != nullptr)
+                lastInput->writer->wakeUp();
+            lastInput = input;
+        }
+        if (lastInput != nullptr)
+            lastInput->writer->wakeUp();
+        batch.clear();
+    }
+
+    void RacMergeWriterFile::waitForWork(uint64_t waitUs) {
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::SLEEP)))
+            ctx->logTrace(Ctx::TRACE::SLEEP, "RacMergeWriterFile:waitForWork");
+
+        contextSet(CONTEXT::MUTEX, REASON::WRITER_MERGE);
+        std::unique_lock<std::mutex> lck(mtx);
+        sleeping = true;
+        contextSet(CONTEXT::WAIT, REASON::WRITER_MERGE_NO_WORK);
+        condMerge.wait_for(lck, std::chrono::microseconds(waitUs));
+        sleeping = false;
+        contextSet(CONTEXT::CPU);
+    }
+
+    void RacMergeWriterFile::mergeLoop() {
+        while (!ctx->hardShutdown) {
+            const time_ut now = ctx->clock->getTimeUt();
+            fillHeap(now);
 
+            if (heap.empty()) {
+                if (!batch.empty() || !unsyncedBatch.empty())
+                    flushBatch();
+                if (ctx->softShutdown && allFinished())
+                    break;
+                waitForWork(ctx->pollIntervalUs);
+                continue;
+            }
+
+            RacMergeInput* input = heap.front();
+            BuilderMsg* msg = *input->pending.front();
+            if (!isReady(msg, now)) {
+                if (!batch.empty() || !unsyncedBatch.empty())
+                    flushBatch();
+                waitForWork(ctx->pollIntervalUs / 10 + 1);
+                continue;
+            }
+
+            std::pop_heap(heap.begin(), heap.end(), heapCompare);
+            heap.pop_back();
+            input->pending.pop();
+            input->inHeap = false;
+
+            if (partitioner != nullptr)
+                sendPartitioned(input, msg);
+            else
+                sendMessage(msg);
+            batch.emplace_back(input, msg);
+
+            if (input->pending.front() != nullptr) {
+                input->inHeap = true;
+                heap.push_back(input);
+                std::push_heap(heap.begin(), heap.end(), heapCompare);
+            }
+
+            if (batch.size() >= BATCH_MAX_MESSAGES)
+                flushBatch();
+        }
+
+        if ((!batch.empty() || !unsyncedBatch.empty()) && !ctx->hardShutdown) {
+            if (syncer != nullptr) {
+                flush();
+                syncer->syncNow(this);
+            }
+            flushBatch();
+        }
     }
 
+    void RacMergeWriterFile::run() {
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
+            std::ostringstream ss;
+            ss << std::this_thread::get_id();
+            ctx->logTrace(Ctx::TRACE::THREADS, "rac merge writer (" + ss.str() + ") start");
+        }
+
+        ctx->info(0, "rac merge writer is starting with " + getName() + ", inputs: " + std::to_string(inputs.size()));
+        heap.reserve(inputs.size());
+        batch.reserve(BATCH_MAX_MESSAGES);
+
+        try {
+            mergeLoop();
+        } catch (DataException& ex) {
+            ctx->error(ex.code, ex.msg);
+            ctx->stopHard();
+        } catch (RuntimeException& ex) {
+            ctx->error(ex.code, ex.msg);
+            ctx->stopHard();
+        }
+
+        ctx->info(0, "rac merge writer is stopping: " + getType());
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::THREADS))) {
+            std::ostringstream ss;
+            ss << std::this_thread::get_id();
+            ctx->logTrace(Ctx::TRACE::THREADS, "rac merge writer (" + ss.str() + ") stop");
+        }
+    }
 }
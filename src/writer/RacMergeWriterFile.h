@@ -1,28 +1,87 @@
-
-
 #ifndef RACMERGEWRITERFILE_H
 #define RACMERGEWRITERFILE_H
+
+#include <condition_variable>
+#include <deque>
+#include <vector>
+
+#include "../common/SpscQueue.h"
+#include "FilePartitioner.h"
 #include "RacWriterFile.h"
 #include "WriterFile.h"
 
 
 namespace OpenLogReplicator {
+    // Per-instance input of the merge stage, one producer (RacWriterFile) and one consumer (RacMergeWriterFile)
+    struct RacMergeInput {
+        RacWriterFile* writer;
+        // Dictionary of the producer, used to name the output of a table in partitioned mode
+        Metadata* metadata;
+        // Messages handed in for merging
+        SpscQueue<BuilderMsg*> pending;
+        // Messages already written and flushed, to be confirmed by the producer
+        SpscQueue<BuilderMsg*> done;
+        // Lowest scn the producer may still hand in
+        std::atomic<uint64_t> watermark{0};
+        // The redo thread of the producer is closed, it delivers nothing until it is opened again
+        std::atomic<bool> closed{false};
+        std::atomic<bool> finished{false};
+        time_ut lastActive{0};
+        bool inHeap{false};
+
+        RacMergeInput(RacWriterFile* newWriter, uint64_t queueSize) :
+                writer(newWriter),
+                metadata(newWriter->getMetadata()),
+                pending(queueSize),
+                done(queueSize) {
+        }
+    };
 
     class RacMergeWriterFile : public WriterFile {
-    private:
+    protected:
+        // Time after which an input with no messages and no watermark progress is not waited for
+        static constexpr time_ut IDLE_INPUT_US{1000000};
+        static constexpr uint64_t BATCH_MAX_MESSAGES{4096};
+
         std::mutex mtx;
+        std::condition_variable condMerge;
+        std::vector<RacMergeInput*> inputs;
+        std::vector<RacMergeInput*> heap;
+        std::vector<std::pair<RacMergeInput*, BuilderMsg*>> batch;
+        // Written but not yet durable, with the end offset of the write
+        std::deque<std::pair<uint64_t, std::pair<RacMergeInput*, BuilderMsg*>>> unsyncedBatch;
+        bool sleeping{false};
+        // Partitioned mode: one output file per table or hash bucket, written by a pool of I/O threads
+        FilePartitioner* partitioner{nullptr};
 
-    public:
-        BuilderMsg *msg{nullptr};
+        static bool heapCompare(const RacMergeInput* input1, const RacMergeInput* input2);
+        bool fillHeap(time_ut now);
+        bool isReady(const BuilderMsg* msg, time_ut now) const;
+        bool allFinished() const;
+        void flushBatch();
+        void sendPartitioned(const RacMergeInput* input, BuilderMsg* msg);
+        void waitForWork(uint64_t waitUs);
+        void mergeLoop();
 
+    public:
         RacMergeWriterFile(Ctx *newCtx, std::string newAlias, std::string newDatabase, Builder *newBuilder,
                       Metadata *newMetadata, std::string newOutput,
                       std::string newTimestampFormat, uint64_t newMaxFileSize, uint64_t newNewLine, uint64_t newAppend,
-                      uint newWiteBufferFlushSize);
+                      uint newWiteBufferFlushSize, bool newZeroCopy, uint64_t newFsyncIntervalUs,
+                      uint64_t newFsyncSize);
+        ~RacMergeWriterFile() override;
 
+        RacMergeInput* registerWriter(RacWriterFile* writer);
+        bool enqueue(RacMergeInput* input, BuilderMsg* msg);
+        void advance(RacMergeInput* input, Scn scn, bool closed);
+        void inputFinished(RacMergeInput* input);
+        void setPartitions(bool byTable, uint64_t buckets, uint64_t ioThreads);
+        void initialize() override;
         void sendMessage(BuilderMsg *msg) override;
-
-        void sendMessage(RacWriterFile * write, BuilderMsg * msg);
+        [[nodiscard]] bool isFragmentSupported() const override {
+            return false;
+        }
+        void wakeUp() override;
 
         void run() override;
     };
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <unistd.h>
 
 #include "../builder/Builder.h"
 #include "../common/exception/ConfigurationException.h"
@@ -11,23 +12,56 @@ namespace OpenLogReplicator {
                            Metadata *newMetadata,
                            std::string newOutput, std::string newTimestampFormat, uint64_t newMaxFileSize,
                            uint64_t newNewLine, uint64_t newAppend,
-                           uint newWriteBufferFlushSize) : WriterFile(newCtx, std::move(newAlias), std::move(newDatabase),
+                           uint newWriteBufferFlushSize, bool newZeroCopy) : WriterFile(newCtx, std::move(newAlias), std::move(newDatabase),
                                                                   newBuilder, newMetadata,
                                                            std::move(newOutput),
                                                            std::move(newTimestampFormat),
                                                            newMaxFileSize,
                                                            newNewLine,
                                                            newAppend,
-                                                           newWriteBufferFlushSize) {
+                                                           newWriteBufferFlushSize,
+                                                           newZeroCopy,
+                                                           0,
+                                                           0) {
     }
 
 
+    // The message is confirmed later, once the merge writer has written it out in scn order
     void RacWriterFile::sendMessage(BuilderMsg *msg) {
-        racMergeWriterFile->sendMessage(this, msg);
-        this->confirmMessage(msg);
+        while (!racMergeWriterFile->enqueue(mergeInput, msg)) {
+            if (ctx->hardShutdown)
+                return;
+            confirmMerged();
+            contextSet(CONTEXT::SLEEP);
+            usleep(ctx->pollIntervalUs);
+            contextSet(CONTEXT::CPU);
+        }
+    }
+
+    // Checkpoints are not written, but they carry the progress of the instance to the merge writer
+    void RacWriterFile::skipMessage(const BuilderMsg* msg) {
+        if (msg->isFlagSet(BuilderMsg::OUTPUT_BUFFER::CHECKPOINT))
+            racMergeWriterFile->advance(mergeInput, msg->lwnScn, msg->isFlagSet(BuilderMsg::OUTPUT_BUFFER::CLOSED));
+    }
+
+    void RacWriterFile::confirmMerged() {
+        BuilderMsg* msg;
+        while (mergeInput->done.pop(msg))
+            confirmMessage(msg);
+    }
+
+    void RacWriterFile::pollQueue() {
+        WriterFile::pollQueue();
+        confirmMerged();
+    }
+
+    void RacWriterFile::run() {
+        Writer::run();
+        racMergeWriterFile->inputFinished(mergeInput);
     }
 
     void RacWriterFile::setRacMergeWriterFile(RacMergeWriterFile* racMergeWriterFile) {
         this->racMergeWriterFile = racMergeWriterFile;
+        mergeInput = racMergeWriterFile->registerWriter(this);
     }
 }
@@ -5,22 +5,36 @@
 
 namespace OpenLogReplicator {
     class RacMergeWriterFile;
+    struct RacMergeInput;
 
     class RacWriterFile : public WriterFile {
     private:
         RacMergeWriterFile *racMergeWriterFile{nullptr};
+        RacMergeInput *mergeInput{nullptr};
 
-    public:
-        BuilderMsg *msg{nullptr};
+        void confirmMerged();
+
+    protected:
+        void skipMessage(const BuilderMsg* msg) override;
+        void pollQueue() override;
+        void run() override;
 
+    public:
         RacWriterFile(Ctx *newCtx, std::string newAlias, std::string newDatabase, Builder *newBuilder,
                       Metadata *newMetadata, std::string newOutput,
                       std::string newTimestampFormat, uint64_t newMaxFileSize, uint64_t newNewLine, uint64_t newAppend,
-                      uint newWiteBufferFlushSize);
+                      uint newWiteBufferFlushSize, bool newZeroCopy);
 
         void sendMessage(BuilderMsg *msg) override;
+        [[nodiscard]] bool isFragmentSupported() const override {
+            return false;
+        }
 
         void setRacMergeWriterFile(RacMergeWriterFile* racMergeWriterFile);
+
+        [[nodiscard]] Metadata* getMetadata() const {
+            return metadata;
+        }
     };
 }
 
@@ -0,0 +1,117 @@
+/* Token bucket limits of the output of a writer
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <regex>
+
+#include "RateLimit.h"
+
+namespace OpenLogReplicator {
+    std::atomic<uint64_t> RateLimit::backfillWriters{0};
+    std::atomic<time_ut> RateLimit::realtimeUntil{0};
+
+    RateLimit::RateLimit(PRIORITY newPriority) :
+            priority(newPriority) {
+        if (priority == PRIORITY::BACKFILL)
+            ++backfillWriters;
+    }
+
+    RateLimit::~RateLimit() {
+        if (priority == PRIORITY::BACKFILL)
+            --backfillWriters;
+    }
+
+    void RateLimit::setWriter(uint64_t bytesPerS, uint64_t messagesPerS, uint64_t burstMs) {
+        writer.bytes.set(bytesPerS, burstMs);
+        writer.messages.set(messagesPerS, burstMs);
+    }
+
+    void RateLimit::setBackfill(uint64_t bytesPerS, uint64_t messagesPerS, uint64_t burstMs) {
+        backfill.bytes.set(bytesPerS, burstMs);
+        backfill.messages.set(messagesPerS, burstMs);
+    }
+
+    void RateLimit::addGroup(const std::string& owner, const std::string& table, uint64_t bytesPerS, uint64_t messagesPerS, uint64_t burstMs) {
+        Group group{owner, table, {}};
+        group.limit.bytes.set(bytesPerS, burstMs);
+        group.limit.messages.set(messagesPerS, burstMs);
+        groups.push_back(std::move(group));
+        objGroups.clear();
+    }
+
+    // The first group matching the table, the owner and table of a group are regular expressions
+    void RateLimit::setGroup(typeObj obj, const std::string& owner, const std::string& table) {
+        int64_t num = -1;
+        if (!table.empty()) {
+            for (uint64_t i = 0; i < groups.size(); ++i) {
+                const std::regex regexOwner(groups[i].owner);
+                const std::regex regexTable(groups[i].table);
+                if (std::regex_match(owner, regexOwner) && std::regex_match(table, regexTable)) {
+                    num = static_cast<int64_t>(i);
+                    break;
+                }
+            }
+        }
+        objGroups.insert_or_assign(obj, num);
+    }
+
+    uint64_t RateLimit::wait(typeObj obj, time_ut now, LIMIT& limit) {
+        uint64_t us = std::max(writer.bytes.wait(now), writer.messages.wait(now));
+        limit = LIMIT::WRITER;
+
+        if (!groups.empty() && obj != 0) {
+            const auto& it = objGroups.find(obj);
+            if (it != objGroups.end() && it->second >= 0) {
+                Limit& group = groups[it->second].limit;
+                const uint64_t groupUs = std::max(group.bytes.wait(now), group.messages.wait(now));
+                if (groupUs > us) {
+                    us = groupUs;
+                    limit = LIMIT::TABLE;
+                }
+            }
+        }
+
+        if (priority == PRIORITY::BACKFILL && now < realtimeUntil.load(std::memory_order_relaxed)) {
+            const uint64_t backfillUs = std::max(backfill.bytes.wait(now), backfill.messages.wait(now));
+            if (backfillUs > us) {
+                us = backfillUs;
+                limit = LIMIT::BACKFILL;
+            }
+        }
+        return us;
+    }
+
+    void RateLimit::take(typeObj obj, uint64_t size, time_ut now) {
+        writer.bytes.take(size);
+        writer.messages.take(1);
+
+        if (!groups.empty() && obj != 0) {
+            const auto& it = objGroups.find(obj);
+            if (it != objGroups.end() && it->second >= 0) {
+                Limit& group = groups[it->second].limit;
+                group.bytes.take(size);
+                group.messages.take(1);
+            }
+        }
+
+        if (priority == PRIORITY::BACKFILL && now < realtimeUntil.load(std::memory_order_relaxed)) {
+            backfill.bytes.take(size);
+            backfill.messages.take(1);
+        }
+    }
+}
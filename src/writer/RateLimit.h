@@ -0,0 +1,160 @@
+/* Header for RateLimit class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef RATE_LIMIT_H_
+#define RATE_LIMIT_H_
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../common/types/Types.h"
+
+namespace OpenLogReplicator {
+    // Token buckets limiting the output of one writer. Every message takes its bytes and one message from the buckets of the writer, of
+    // the table group of its table and, for a backfill writer while real-time writers of the process are sending, from the backfill
+    // buckets. The output is ordered, so a message waiting for tokens holds back the messages after it
+    class RateLimit final {
+    public:
+        enum class PRIORITY : unsigned char {
+            REALTIME, BACKFILL
+        };
+
+        // What the writer waited for, the index of the wait counters
+        enum class LIMIT : unsigned char {
+            WRITER, TABLE, BACKFILL, NUM
+        };
+
+        // A real-time writer is sending when it sent a message within that time
+        static constexpr time_ut REALTIME_WINDOW_US{1000000};
+        static constexpr time_ut REALTIME_MARK_US{100000};
+
+        // Writers of the process with the backfill priority, real-time writers only mark their activity while there are some
+        static std::atomic<uint64_t> backfillWriters;
+        static std::atomic<time_ut> realtimeUntil;
+
+        class Bucket final {
+        protected:
+            static constexpr uint64_t MAX_ELAPSED_US{10000000};
+
+            uint64_t rate{0};
+            int64_t burst{0};
+            int64_t tokens{0};
+            time_ut last{0};
+
+        public:
+            void set(uint64_t newRate, uint64_t burstMs) {
+                rate = newRate;
+                burst = static_cast<int64_t>(std::max<uint64_t>(1, rate * burstMs / 1000));
+                tokens = burst;
+                last = 0;
+            }
+
+            [[nodiscard]] bool isSet() const {
+                return rate > 0;
+            }
+
+            // Microseconds until the tokens taken in advance are paid back, 0 when the next message may go
+            [[nodiscard]] uint64_t wait(time_ut now) {
+                if (rate == 0)
+                    return 0;
+                if (last == 0)
+                    last = now;
+                else if (now > last) {
+                    // The time is taken over only once it added a token, slow rates don't lose the fraction
+                    const uint64_t elapsed = std::min<uint64_t>(now - last, MAX_ELAPSED_US);
+                    const auto added = static_cast<int64_t>(rate * elapsed / 1000000);
+                    if (added > 0) {
+                        tokens = std::min(tokens + added, burst);
+                        last = now;
+                    }
+                }
+                if (tokens >= 0)
+                    return 0;
+                return (static_cast<uint64_t>(-tokens) * 1000000 / rate) + 1;
+            }
+
+            // Taken once the wait is over, the bucket may go below zero and the next message waits until the debt is paid back
+            void take(uint64_t count) {
+                if (rate > 0)
+                    tokens -= static_cast<int64_t>(count);
+            }
+        };
+
+        struct Limit {
+            Bucket bytes;
+            Bucket messages;
+
+            [[nodiscard]] bool isSet() const {
+                return bytes.isSet() || messages.isSet();
+            }
+        };
+
+        struct Group {
+            std::string owner;
+            std::string table;
+            Limit limit;
+        };
+
+    protected:
+        PRIORITY priority;
+        Limit writer;
+        Limit backfill;
+        std::vector<Group> groups;
+        // Group of the table by object id, -1 when no group matches
+        std::unordered_map<typeObj, int64_t> objGroups;
+
+    public:
+        explicit RateLimit(PRIORITY newPriority);
+        ~RateLimit();
+
+        void setWriter(uint64_t bytesPerS, uint64_t messagesPerS, uint64_t burstMs);
+        void setBackfill(uint64_t bytesPerS, uint64_t messagesPerS, uint64_t burstMs);
+        void addGroup(const std::string& owner, const std::string& table, uint64_t bytesPerS, uint64_t messagesPerS, uint64_t burstMs);
+
+        [[nodiscard]] PRIORITY getPriority() const {
+            return priority;
+        }
+
+        [[nodiscard]] bool hasGroups() const {
+            return !groups.empty();
+        }
+
+        [[nodiscard]] bool isGroupKnown(typeObj obj) const {
+            return objGroups.find(obj) != objGroups.end();
+        }
+
+        void clearGroups() {
+            objGroups.clear();
+        }
+
+        void setGroup(typeObj obj, const std::string& owner, const std::string& table);
+        [[nodiscard]] uint64_t wait(typeObj obj, time_ut now, LIMIT& limit);
+        void take(typeObj obj, uint64_t size, time_ut now);
+
+        static void markRealtime(time_ut now) {
+            if (now + REALTIME_WINDOW_US > realtimeUntil.load(std::memory_order_relaxed) + REALTIME_MARK_US)
+                realtimeUntil.store(now + REALTIME_WINDOW_US, std::memory_order_relaxed);
+        }
+    };
+}
+
+#endif
@@ -24,11 +24,18 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 
 #include "../builder/Builder.h"
 #include "../common/Ctx.h"
+#include "../common/DbTable.h"
+#include "../common/FlightRecorder.h"
+#include "../common/Probes.h"
 #include "../common/exception/DataException.h"
 #include "../common/exception/NetworkException.h"
 #include "../common/exception/RuntimeException.h"
 #include "../common/metrics/Metrics.h"
 #include "../metadata/Metadata.h"
+#include "../metadata/Schema.h"
+#include "../replicator/PartitionCoordinator.h"
+#include "../state/CheckpointRing.h"
+#include "RateLimit.h"
 #include "Writer.h"
 
 namespace OpenLogReplicator {
@@ -37,131 +44,386 @@ namespace OpenLogReplicator {
             database(std::move(newDatabase)),
             builder(newBuilder),
             metadata(newMetadata),
+            checkpointName(database + "-chkpt"),
             checkpointTime(time(nullptr)) {
         ctx->writerThread = this;
+        if (builder != nullptr)
+            builderWriter = builder->registerWriter();
     }
 
     Writer::~Writer() {
         delete[] queue;
         queue = nullptr;
+        delete rateLimit;
+        rateLimit = nullptr;
+        delete checkpointRing;
+        checkpointRing = nullptr;
     }
 
     void Writer::initialize() {
         if (queue != nullptr)
             return;
-        queue = new BuilderMsg* [ctx->queueSize];
+        queue = new QueueSlot[ctx->queueSize];
     }
 
-    void Writer::createMessage(BuilderMsg* msg) {
-        ++sentMessages;
+    // Writers sharing one builder keep their own checkpoints
+    void Writer::setCheckpointName(std::string newCheckpointName) {
+        checkpointName = std::move(newCheckpointName);
+    }
 
-        queue[currentQueueSize++] = msg;
-        hwmQueueSize = std::max(currentQueueSize, hwmQueueSize);
+    void Writer::addRouteTable(const std::string& tableName, bool include) {
+        if (include)
+            routeInclude.insert(tableName);
+        else
+            routeExclude.insert(tableName);
     }
 
-    void Writer::sortQueue() {
-        if (currentQueueSize == 0)
+    void Writer::setRateLimit(RateLimit* newRateLimit) {
+        delete rateLimit;
+        rateLimit = newRateLimit;
+    }
+
+    // Routing is decided once for every object, like the topic of a Kafka writer. Messages without an object, like begin, commit and checkpoint,
+    // go to every writer
+    bool Writer::isRouted(typeObj obj) {
+        if (obj == 0 || (routeInclude.empty() && routeExclude.empty()))
+            return true;
+
+        checkObjCaches();
+        const auto& it = objRoutes.find(obj);
+        if (it != objRoutes.end())
+            return it->second;
+
+        std::string tableName;
+        {
+            contextSet(CONTEXT::MUTEX, REASON::WRITER_SCHEMA);
+            std::unique_lock<std::mutex> const lck(metadata->mtxSchema);
+            const DbTable* table = metadata->schema->checkTableDict(obj);
+            if (table != nullptr)
+                tableName = table->owner + "." + table->name;
+        }
+        contextSet(CONTEXT::CPU);
+
+        bool routed;
+        if (!routeInclude.empty())
+            routed = routeInclude.find(tableName) != routeInclude.end();
+        else
+            routed = routeExclude.find(tableName) == routeExclude.end();
+        objRoutes.insert_or_assign(obj, routed);
+        return routed;
+    }
+
+    // Object ids are reused after a table is dropped or its partitions change, then everything resolved by object is resolved again
+    void Writer::checkObjCaches() {
+        const uint64_t version = metadata->schema->tablePartitionVersion.load(std::memory_order_acquire);
+        if (likely(version == objCacheVersion))
             return;
+        objCacheVersion = version;
+        dropObjCaches();
+    }
 
-        BuilderMsg** oldQueue = queue;
-        queue = new BuilderMsg* [ctx->queueSize];
-        uint64_t oldQueueSize = currentQueueSize;
-
-        for (uint64_t newId = 0; newId < currentQueueSize; ++newId) {
-            queue[newId] = oldQueue[0];
-            uint64_t i = 0;
-            --oldQueueSize;
-            while (i < oldQueueSize) {
-                if (i * 2 + 2 < oldQueueSize && oldQueue[(i * 2) + 2]->id < oldQueue[oldQueueSize]->id) {
-                    if (oldQueue[(i * 2) + 1]->id < oldQueue[(i * 2) + 2]->id) {
-                        oldQueue[i] = oldQueue[(i * 2) + 1];
-                        i = i * 2 + 1;
-                    } else {
-                        oldQueue[i] = oldQueue[(i * 2) + 2];
-                        i = i * 2 + 2;
+    void Writer::dropObjCaches() {
+        objRoutes.clear();
+        if (rateLimit != nullptr)
+            rateLimit->clearGroups();
+    }
+
+    // Holds the message back until the buckets of the writer, the table group and the backfill priority have tokens for it. Confirmations
+    // are still taken while waiting. Writers without a limit only mark the real-time output for the backfill writers of the process
+    void Writer::rateLimitWait(const BuilderMsg* msg) {
+        time_ut now = ctx->clock->getTimeUt();
+        if (rateLimit == nullptr || rateLimit->getPriority() == RateLimit::PRIORITY::REALTIME) {
+            if (RateLimit::backfillWriters.load(std::memory_order_relaxed) > 0)
+                RateLimit::markRealtime(now);
+            if (rateLimit == nullptr)
+                return;
+        }
+
+        if (rateLimit->hasGroups() && msg->obj != 0 && metadata != nullptr) {
+            checkObjCaches();
+            if (!rateLimit->isGroupKnown(msg->obj)) {
+                std::string owner;
+                std::string table;
+                {
+                    contextSet(CONTEXT::MUTEX, REASON::WRITER_SCHEMA);
+                    std::unique_lock<std::mutex> const lck(metadata->mtxSchema);
+                    const DbTable* dbTable = metadata->schema->checkTableDict(msg->obj);
+                    if (dbTable != nullptr) {
+                        owner = dbTable->owner;
+                        table = dbTable->name;
                     }
-                } else if (i * 2 + 1 < oldQueueSize && oldQueue[(i * 2) + 1]->id < oldQueue[oldQueueSize]->id) {
-                    oldQueue[i] = oldQueue[(i * 2) + 1];
-                    i = i * 2 + 1;
-                } else
-                    break;
+                }
+                contextSet(CONTEXT::CPU);
+                rateLimit->setGroup(msg->obj, owner, table);
             }
-            oldQueue[i] = oldQueue[oldQueueSize];
         }
 
-        delete[] oldQueue;
+        RateLimit::LIMIT limit;
+        uint64_t us = rateLimit->wait(msg->obj, now, limit);
+        if (us > 0) {
+            const RateLimit::LIMIT firstLimit = limit;
+            const time_ut start = now;
+            if (unlikely(ctx->isTraceSet(Ctx::TRACE::WRITER)))
+                ctx->logTrace(Ctx::TRACE::WRITER, "rate limit reached, message id: " + std::to_string(msg->id) + " waits " +
+                                                  std::to_string(us) + "us");
+            while (us > 0 && !ctx->hardShutdown) {
+                contextSet(CONTEXT::SLEEP, REASON::WRITER_RATE_LIMIT);
+                usleep(std::min<uint64_t>(us, ctx->pollIntervalUs));
+                contextSet(CONTEXT::CPU);
+                pollQueue();
+                now = ctx->clock->getTimeUt();
+                us = rateLimit->wait(msg->obj, now, limit);
+            }
+
+            const uint64_t waitUs = now - start;
+            RuntimeStats::add(ctx->stats.rateLimitWaitUs, waitUs);
+            if (ctx->metrics != nullptr) {
+                switch (firstLimit) {
+                    case RateLimit::LIMIT::WRITER:
+                        ctx->metrics->emitRateLimitWaitUsWriter(waitUs);
+                        ctx->metrics->emitRateLimitWaitsWriter(1);
+                        break;
+                    case RateLimit::LIMIT::TABLE:
+                        ctx->metrics->emitRateLimitWaitUsTable(waitUs);
+                        ctx->metrics->emitRateLimitWaitsTable(1);
+                        break;
+                    default:
+                        ctx->metrics->emitRateLimitWaitUsBackfill(waitUs);
+                        ctx->metrics->emitRateLimitWaitsBackfill(1);
+                }
+            }
+        }
+        rateLimit->take(msg->obj, msg->size, now);
+    }
+
+    bool Writer::isNewData(Scn scn, typeIdx idx) const {
+        // The replication starts at the oldest checkpoint of the writers sharing the metadata, every one skips what it has confirmed itself
+        if (metadata->writers <= 1)
+            return metadata->isNewData(scn, idx);
+
+        if (clientScn == Scn::none() || clientScn < scn)
+            return true;
+        return clientScn == scn && clientIdx < idx;
+    }
+
+    void Writer::createMessage(BuilderMsg* msg, uint64_t chunkId) {
+        ++sentMessages;
+
+        // Messages arrive in id order, the ring keeps them sorted without any reordering
+        if (currentQueueSize == 0)
+            queueHeadId = msg->id;
+        uint64_t pos = queueHead + currentQueueSize;
+        if (pos >= ctx->queueSize)
+            pos -= ctx->queueSize;
+        queue[pos] = {msg, chunkId, msg->lwnScn, msg->lwnIdx, false};
+        ++chunkPins[chunkId];
+        ++currentQueueSize;
+        hwmQueueSize = std::max(currentQueueSize, hwmQueueSize);
+        RuntimeStats::set<uint64_t>(ctx->stats.writerQueueSize, currentQueueSize);
     }
 
     void Writer::resetMessageQueue() {
         for (uint64_t i = 0; i < currentQueueSize; ++i) {
-            BuilderMsg* msg = queue[i];
-            if (msg->isFlagSet(BuilderMsg::OUTPUT_BUFFER::ALLOCATED))
+            uint64_t pos = queueHead + i;
+            if (pos >= ctx->queueSize)
+                pos -= ctx->queueSize;
+            if (queue[pos].confirmed)
+                continue;
+            BuilderMsg* msg = queue[pos].msg;
+            if (msg->isFlagSet(BuilderMsg::OUTPUT_BUFFER::COPY))
+                delete[] reinterpret_cast<uint8_t*>(msg);
+            else if (msg->isFlagSet(BuilderMsg::OUTPUT_BUFFER::ALLOCATED))
                 delete[] msg->data;
         }
         currentQueueSize = 0;
+        queueHead = 0;
+        chunkPins.clear();
+        RuntimeStats::set<uint64_t>(ctx->stats.writerQueueSize, 0);
 
         oldSize = builderQueue->start;
     }
 
+    // A short spin catches the next commit of a busy source without a context switch, the limit grows while spinning
+    // finds work and decays while it does not, so an idle writer parks right away
+    bool Writer::spinForWork() {
+        for (uint64_t i = 0; i < spinLimit; ++i) {
+            if (builderQueue->next != nullptr ||
+                    builderQueue->confirmedSize.load(std::memory_order_acquire) > oldSize + sizeof(struct BuilderMsg)) {
+                spinLimit = std::min(spinLimit * 2, SPIN_MAX);
+                return true;
+            }
+            CPU_RELAX();
+        }
+        spinLimit = (spinLimit == 0) ? 16 : spinLimit / 2;
+        return false;
+    }
+
+    // Nothing more to send from the builder right now
+    bool Writer::isCaughtUp() const {
+        if (builderQueue == nullptr)
+            return true;
+        return builderQueue->next == nullptr && builderQueue->confirmedSize <= oldSize + sizeof(struct BuilderMsg);
+    }
+
     void Writer::confirmMessage(BuilderMsg* msg) {
-        if (ctx->metrics != nullptr && msg != nullptr) {
-            ctx->metrics->emitBytesConfirmed(msg->size);
-            ctx->metrics->emitMessagesConfirmed(1);
+        if (msg == nullptr) {
+            contextSet(CONTEXT::MUTEX, REASON::WRITER_CONFIRM);
+            {
+                std::unique_lock<std::mutex> const lck(mtx);
+                if (currentQueueSize == 0) {
+                    ctx->warning(70007, "trying to confirm an empty message");
+                    contextSet(CONTEXT::CPU);
+                    return;
+                }
+                msg = queue[queueHead].msg;
+            }
+            contextSet(CONTEXT::CPU);
         }
 
+        confirmMessages(&msg, 1);
+    }
+
+    // Cumulative confirmation of every message with id below endId, one pass over the ring under a single lock
+    void Writer::confirmUpTo(uint64_t endId) {
+        uint64_t messages = 0;
+        uint64_t bytes = 0;
+        bool unpinned = false;
+        time_ut now = 0;
+
         contextSet(CONTEXT::MUTEX, REASON::WRITER_CONFIRM);
         std::unique_lock<std::mutex> const lck(mtx);
 
-        if (msg == nullptr) {
-            if (currentQueueSize == 0) {
-                ctx->warning(70007, "trying to confirm an empty message");
-                contextSet(CONTEXT::CPU);
-                return;
-            }
-            msg = queue[0];
+        for (uint64_t id = queueHeadId; id < endId && id < queueHeadId + currentQueueSize; ++id) {
+            QueueSlot& slot = queueSlot(id);
+            if (slot.confirmed)
+                continue;
+            ++messages;
+            bytes += slot.msg->size;
+            confirmSlot(slot, now, unpinned);
+        }
+        advanceConfirmed(messages, unpinned);
+        contextSet(CONTEXT::CPU);
+
+        if (ctx->metrics != nullptr && messages > 0) {
+            ctx->metrics->emitBytesConfirmed(bytes);
+            ctx->metrics->emitMessagesConfirmed(messages);
+        }
+    }
+
+    // Delivery reports of one poll are confirmed together, in any order, the ring advances once over the confirmed prefix
+    void Writer::confirmMessages(BuilderMsg* const* msgs, uint64_t count) {
+        if (count == 0)
+            return;
+
+        uint64_t bytes = 0;
+        bool unpinned = false;
+        time_ut now = 0;
+
+        contextSet(CONTEXT::MUTEX, REASON::WRITER_CONFIRM);
+        std::unique_lock<std::mutex> const lck(mtx);
+
+        for (uint64_t i = 0; i < count; ++i) {
+            // Ids are consecutive, so the slot is found by offset from the head
+            QueueSlot& slot = queueSlot(msgs[i]->id);
+            ctx->assertDebug(slot.msg == msgs[i] && !slot.confirmed);
+            bytes += msgs[i]->size;
+            confirmSlot(slot, now, unpinned);
+        }
+        advanceConfirmed(count, unpinned);
+        contextSet(CONTEXT::CPU);
+
+        if (ctx->metrics != nullptr) {
+            ctx->metrics->emitBytesConfirmed(bytes);
+            ctx->metrics->emitMessagesConfirmed(count);
+        }
+    }
+
+    // Marks the slot confirmed and releases its message, now is read from the clock once for all slots of the call, mtx is held
+    void Writer::confirmSlot(QueueSlot& slot, time_ut& now, bool& unpinned) {
+        BuilderMsg* msg = slot.msg;
+        slot.confirmed = true;
+        // message id, scn, obj, size
+        OLR_PROBE4(writer_confirm, msg->id, msg->scn.getData(), msg->obj, msg->size.load(std::memory_order_relaxed));
+        FlightRecorder::record(FlightRecorder::EVENT::WRITER_CONFIRM, msg->scn.getData(), msg->id);
+        if (unlikely(msg->buildTime != 0)) {
+            if (now == 0)
+                now = ctx->clock->getTimeUt();
+            ctx->recordLatency(RuntimeStats::LATENCY::BUILD_CONFIRM, msg->buildTime, now);
+        }
+        if (unlikely(msg->isFlagSet(BuilderMsg::OUTPUT_BUFFER::TRACED)) && ctx->tracer != nullptr) {
+            if (now == 0)
+                now = ctx->clock->getTimeUt();
+            ctx->tracer->confirmed(this, msg->id, now);
+        }
+        releaseMessage(msg);
+
+        auto it = chunkPins.find(slot.chunkId);
+        if (it != chunkPins.end() && --it->second == 0) {
+            chunkPins.erase(it);
+            unpinned = true;
+        }
+    }
+
+    // Advance over the confirmed prefix, every message leaves the ring once, mtx is held
+    void Writer::advanceConfirmed(uint64_t messages, bool unpinned) {
+        while (currentQueueSize > 0 && queue[queueHead].confirmed) {
+            const QueueSlot& first = queue[queueHead];
+            if (confirmedScn == Scn::none() || first.lwnScn > confirmedScn) {
+                confirmedScn = first.lwnScn;
+                confirmedIdx = first.lwnIdx;
+            } else if (first.lwnScn == confirmedScn && first.lwnIdx > confirmedIdx)
+                confirmedIdx = first.lwnIdx;
+
+            if (++queueHead == ctx->queueSize)
+                queueHead = 0;
+            ++queueHeadId;
+            --currentQueueSize;
         }
+        RuntimeStats::add(ctx->stats.messagesConfirmed, messages);
+        RuntimeStats::set<uint64_t>(ctx->stats.writerQueueSize, currentQueueSize);
+        RuntimeStats::set<uint64_t>(ctx->stats.confirmedScn, confirmedScn.getData());
+
+        releaseChunks(unpinned);
+    }
+
+    // A message in the builder buffer is left untouched when other writers read it too
+    void Writer::releaseMessage(BuilderMsg* msg) const {
+        if (msg->isFlagSet(BuilderMsg::OUTPUT_BUFFER::COPY)) {
+            delete[] reinterpret_cast<uint8_t*>(msg);
+            return;
+        }
+        if (builder->getWriters() > 1)
+            return;
 
         msg->setFlag(BuilderMsg::OUTPUT_BUFFER::CONFIRMED);
         if (msg->isFlagSet(BuilderMsg::OUTPUT_BUFFER::ALLOCATED)) {
             delete[] msg->data;
             msg->unsetFlag(BuilderMsg::OUTPUT_BUFFER::ALLOCATED);
         }
+    }
 
-        uint64_t maxId = 0;
-        {
-            while (currentQueueSize > 0 && queue[0]->isFlagSet(BuilderMsg::OUTPUT_BUFFER::CONFIRMED)) {
-                maxId = queue[0]->queueId;
-                if (confirmedScn == Scn::none() || msg->lwnScn > confirmedScn) {
-                    confirmedScn = msg->lwnScn;
-                    confirmedIdx = msg->lwnIdx;
-                } else if (msg->lwnScn == confirmedScn && msg->lwnIdx > confirmedIdx)
-                    confirmedIdx = msg->lwnIdx;
-
-                if (--currentQueueSize == 0)
-                    break;
-
-                uint64_t i = 0;
-                while (i < currentQueueSize) {
-                    if ((i * 2) + 2 < currentQueueSize && queue[(i * 2) + 2]->id < queue[currentQueueSize]->id) {
-                        if (queue[(i * 2) + 1]->id < queue[(i * 2) + 2]->id) {
-                            queue[i] = queue[(i * 2) + 1];
-                            i = (i * 2) + 1;
-                        } else {
-                            queue[i] = queue[(i * 2) + 2];
-                            i = (i * 2) + 2;
-                        }
-                    } else if ((i * 2) + 1 < currentQueueSize && queue[(i * 2) + 1]->id < queue[currentQueueSize]->id) {
-                        queue[i] = queue[(i * 2) + 1];
-                        i = (i * 2) + 1;
-                    } else
-                        break;
-                }
-                queue[i] = queue[currentQueueSize];
+    // Every buffer the writer has moved past is freed as soon as its last message is confirmed
+    void Writer::releaseChunks(bool unpinned) {
+        if (builderQueue == nullptr)
+            return;
+        const uint64_t maxId = builderQueue->id;
+        if (!unpinned && maxId == releasedChunkId)
+            return;
+        releasedChunkId = maxId;
+
+        const uint64_t outOfOrder = builder->releaseBuffers(this, builderWriter, maxId, chunkPins);
+        if (ctx->metrics != nullptr) {
+            int64_t pinnedChunks = 0;
+            int64_t pinnedMessages = 0;
+            for (auto it = chunkPins.begin(); it != chunkPins.end() && it->first < maxId; ++it) {
+                ++pinnedChunks;
+                pinnedMessages += static_cast<int64_t>(it->second);
             }
+            ctx->metrics->emitBuilderChunksPinned(pinnedChunks);
+            ctx->metrics->emitBuilderChunksPinnedMessages(pinnedMessages);
+            if (outOfOrder > 0)
+                ctx->metrics->emitBuilderChunksReleasedOutOfOrder(outOfOrder);
         }
-
-        builder->releaseBuffers(this, maxId);
-        contextSet(CONTEXT::CPU);
     }
 
     void Writer::run() {
@@ -176,9 +438,15 @@ namespace OpenLogReplicator {
         try {
             // Before anything, read the latest checkpoint
             readCheckpoint();
+            if (metadata->writers > 1) {
+                metadata->waitForWriters(this);
+                if (metadata->clientScn != Scn::none())
+                    metadata->setStatusReplicate(this);
+            }
             builderQueue = builder->firstBuilderQueue;
             oldSize = 0;
             currentQueueSize = 0;
+            queueHead = 0;
 
             // External loop for client disconnection
             while (!ctx->hardShutdown) {
@@ -214,6 +482,7 @@ namespace OpenLogReplicator {
         BuilderMsg* msg{nullptr};
         uint64_t newSize = 0;
         currentQueueSize = 0;
+        queueHead = 0;
 
         // Start streaming
         while (!ctx->hardShutdown) {
@@ -255,7 +524,9 @@ namespace OpenLogReplicator {
 
                 if (ctx->softShutdown && ctx->replicatorFinished)
                     break;
-                builder->sleepForWriterWork(this, currentQueueSize, ctx->pollIntervalUs);
+                if (spinForWork())
+                    continue;
+                builder->sleepForWriterWork(this, currentQueueSize, ctx->pollIntervalUs, builderQueue, oldSize);
             }
 
             __builtin_prefetch(reinterpret_cast<char*>(msg), 0, 0);
@@ -288,30 +559,81 @@ namespace OpenLogReplicator {
                 oldSize += sizeof(struct BuilderMsg);
 
                 // Message in one part - sent directly from buffer
-                if (oldSize + size8 <= Builder::OUTPUT_BUFFER_DATA_SIZE) {
-                    createMessage(msg);
+                if (oldSize + size8 <= builder->outputBufferDataSize) {
+                    createMessage(msg, builderQueue->id);
                     if (msg->isFlagSet(BuilderMsg::OUTPUT_BUFFER::REDO))
                         redo = true;
                     // Send the message to the client in one part
                     if ((msg->isFlagSet(BuilderMsg::OUTPUT_BUFFER::CHECKPOINT) && !ctx->isFlagSet(Ctx::REDO_FLAGS::SHOW_CHECKPOINT)) ||
-                        !metadata->isNewData(msg->lwnScn, msg->lwnIdx))
+                        !isNewData(msg->lwnScn, msg->lwnIdx) || !isRouted(msg->obj)) {
+                        skipMessage(msg);
                         confirmMessage(msg);
-                    else {
+                    } else {
+                        if (unlikely(rateLimit != nullptr || RateLimit::backfillWriters.load(std::memory_order_relaxed) != 0))
+                            rateLimitWait(msg);
                         const uint64_t msgSize = msg->size;
+                        // message id, scn, obj, size
+                        OLR_PROBE4(writer_send, msg->id, msg->scn.getData(), msg->obj, msgSize);
                         sendMessage(msg);
+                        RuntimeStats::add(ctx->stats.bytesSent, msgSize);
+                        RuntimeStats::add(ctx->stats.messagesSent, 1);
                         if (ctx->metrics != nullptr) {
                             ctx->metrics->emitBytesSent(msgSize);
                             ctx->metrics->emitMessagesSent(1);
                         }
                     }
                     oldSize += size8;
+                } else if (isFragmentSupported() &&
+                           (!msg->isFlagSet(BuilderMsg::OUTPUT_BUFFER::CHECKPOINT) || ctx->isFlagSet(Ctx::REDO_FLAGS::SHOW_CHECKPOINT)) &&
+                           isNewData(msg->lwnScn, msg->lwnIdx) && isRouted(msg->obj)) {
+                    // The message is split to many parts - send part by part
+                    if (builder->getWriters() == 1)
+                        msg->setFlag(BuilderMsg::OUTPUT_BUFFER::FRAGMENTED);
+                    createMessage(msg, builderQueue->id);
+                    if (unlikely(rateLimit != nullptr || RateLimit::backfillWriters.load(std::memory_order_relaxed) != 0))
+                        rateLimitWait(msg);
+                    const uint64_t msgSize = msg->size;
+
+                    uint64_t sent = 0;
+                    while (msgSize > sent) {
+                        uint64_t toSend = msgSize - sent;
+                        if (toSend > newSize - oldSize) {
+                            toSend = newSize - oldSize;
+                            sendMessageFragment(msg, builderQueue->data + oldSize, toSend, sent == 0, false);
+                            builderQueue = builderQueue->next;
+                            newSize = builder->outputBufferDataSize;
+                            oldSize = 0;
+                        } else {
+                            sendMessageFragment(msg, builderQueue->data + oldSize, toSend, sent == 0, true);
+                            oldSize += (toSend + 7) & 0xFFFFFFFFFFFFFFF8;
+                        }
+                        sent += toSend;
+                    }
+
+                    RuntimeStats::add(ctx->stats.bytesSent, msgSize);
+                    RuntimeStats::add(ctx->stats.messagesSent, 1);
+                    if (ctx->metrics != nullptr) {
+                        ctx->metrics->emitBytesSent(msgSize);
+                        ctx->metrics->emitMessagesSent(1);
+                    }
+                    break;
                 } else {
-                    // The message is split to many parts - merge and copy
-                    msg->data = new uint8_t[msg->size];
-                    if (unlikely(msg->data == nullptr))
-                        throw RuntimeException(10016, "couldn't allocate " + std::to_string(msg->size) +
-                                                      " bytes memory for: temporary buffer for JSON message");
-                    msg->setFlag(BuilderMsg::OUTPUT_BUFFER::ALLOCATED);
+                    // The message is split to many parts - merge and copy. Writers sharing the output copy the header as well, as
+                    // the others read the data pointer of the message in the builder buffer
+                    if (builder->getWriters() > 1) {
+                        auto* copy = reinterpret_cast<BuilderMsg*>(new uint8_t[sizeof(struct BuilderMsg) + msg->size]);
+                        memcpy(reinterpret_cast<void*>(copy), reinterpret_cast<const void*>(msg), sizeof(struct BuilderMsg));
+                        copy->data = reinterpret_cast<uint8_t*>(copy) + sizeof(struct BuilderMsg);
+                        copy->setFlag(BuilderMsg::OUTPUT_BUFFER::COPY);
+                        msg = copy;
+                    } else {
+                        msg->data = new uint8_t[msg->size];
+                        if (unlikely(msg->data == nullptr))
+                            throw RuntimeException(10016, "couldn't allocate " + std::to_string(msg->size) +
+                                                          " bytes memory for: temporary buffer for JSON message");
+                        msg->setFlag(BuilderMsg::OUTPUT_BUFFER::ALLOCATED);
+                    }
+                    const uint64_t chunkId = builderQueue->id;
 
                     uint64_t copied = 0;
                     while (msg->size > copied) {
@@ -321,7 +643,7 @@ namespace OpenLogReplicator {
                             memcpy(reinterpret_cast<void*>(msg->data + copied),
                                    reinterpret_cast<const void*>(builderQueue->data + oldSize), toCopy);
                             builderQueue = builderQueue->next;
-                            newSize = Builder::OUTPUT_BUFFER_DATA_SIZE;
+                            newSize = builder->outputBufferDataSize;
                             oldSize = 0;
                         } else {
                             memcpy(reinterpret_cast<void*>(msg->data + copied),
@@ -331,14 +653,21 @@ namespace OpenLogReplicator {
                         copied += toCopy;
                     }
 
-                    createMessage(msg);
+                    createMessage(msg, chunkId);
                     // Send only new messages to the client
                     if ((msg->isFlagSet(BuilderMsg::OUTPUT_BUFFER::CHECKPOINT) && !ctx->isFlagSet(Ctx::REDO_FLAGS::SHOW_CHECKPOINT)) ||
-                        !metadata->isNewData(msg->lwnScn, msg->lwnIdx))
+                        !isNewData(msg->lwnScn, msg->lwnIdx) || !isRouted(msg->obj)) {
+                        skipMessage(msg);
                         confirmMessage(msg);
-                    else {
+                    } else {
+                        if (unlikely(rateLimit != nullptr || RateLimit::backfillWriters.load(std::memory_order_relaxed) != 0))
+                            rateLimitWait(msg);
                         const uint64_t msgSize = msg->size;
+                        // message id, scn, obj, size
+                        OLR_PROBE4(writer_send, msg->id, msg->scn.getData(), msg->obj, msgSize);
                         sendMessage(msg);
+                        RuntimeStats::add(ctx->stats.bytesSent, msgSize);
+                        RuntimeStats::add(ctx->stats.messagesSent, 1);
                         if (ctx->metrics != nullptr) {
                             ctx->metrics->emitBytesSent(msgSize);
                             ctx->metrics->emitMessagesSent(1);
@@ -363,8 +692,8 @@ namespace OpenLogReplicator {
 
     void Writer::writeCheckpoint(bool force) {
         redo = false;
-        // Nothing changed
-        if ((checkpointScn == confirmedScn && checkpointIdx == confirmedIdx) || confirmedScn == Scn::none())
+        // Nothing changed, the standby instance keeps the checkpoint of the lease holder
+        if ((checkpointScn == confirmedScn && checkpointIdx == confirmedIdx) || confirmedScn == Scn::none() || metadata->standby)
             return;
 
         // Force first checkpoint
@@ -386,53 +715,112 @@ namespace OpenLogReplicator {
                                                       std::to_string(confirmedIdx) + " checkpoint scn: " + checkpointScn.toString() + " idx: " +
                                                       std::to_string(checkpointIdx));
         }
-        const std::string name(database + "-chkpt");
-        std::ostringstream ss;
-        ss << R"({"database":")" << database
-           << R"(","scn":)" << std::dec << confirmedScn.toString()
-           << R"(,"idx":)" << std::dec << confirmedIdx
-           << R"(,"resetlogs":)" << std::dec << metadata->resetlogs
-           << R"(,"activation":)" << std::dec << metadata->activation << "}";
-
-        if (metadata->stateWrite(name, confirmedScn, ss)) {
+        bool written = false;
+        if (checkpointRing != nullptr) {
+            try {
+                checkpointRing->write(CheckpointRing::databaseId(database), confirmedScn, confirmedIdx, metadata->resetlogs,
+                                      metadata->activation);
+                written = true;
+            } catch (RuntimeException& ex) {
+                ctx->error(ex.code, ex.msg);
+            }
+        } else {
+            const std::string& name(checkpointName);
+            std::ostringstream ss;
+            ss << R"({"database":")" << database
+               << R"(","scn":)" << std::dec << confirmedScn.toString()
+               << R"(,"idx":)" << std::dec << confirmedIdx
+               << R"(,"resetlogs":)" << std::dec << metadata->resetlogs
+               << R"(,"activation":)" << std::dec << metadata->activation << "}";
+            written = metadata->stateWrite(name, confirmedScn, ss);
+        }
+
+        if (written) {
             checkpointScn = confirmedScn;
             checkpointIdx = confirmedIdx;
             checkpointTime = now;
+            if (metadata->partitions != nullptr)
+                metadata->partitions->confirm(confirmedScn, metadata->resetlogs, metadata->activation);
         }
     }
 
     void Writer::readCheckpoint() {
-        const std::string name(database + "-chkpt");
+        const std::string& name(checkpointName);
+
+        // Partitions taken over from other instances continue from the positions confirmed there
+        Scn partitionScn = Scn::none();
+        typeResetlogs partitionResetlogs = 0;
+        typeActivation partitionActivation = 0;
+        if (metadata->partitions != nullptr && !metadata->partitions->startPosition(partitionScn, partitionResetlogs, partitionActivation))
+            partitionScn = Scn::none();
+
+        if (metadata->checkpointRingSlots > 0 && checkpointRing == nullptr)
+            checkpointRing = new CheckpointRing(ctx, metadata->checkpointRingPath + "/" + name + CheckpointRing::SUFFIX, metadata->checkpointRingSlots,
+                                                metadata->checkpointRingSync);
+
+        // The ring has the newest checkpoint once written, before that the checkpoint of the state is taken over
+        uint32_t ringDatabase = 0;
+        Scn ringScn;
+        typeIdx ringIdx = 0;
+        typeResetlogs ringResetlogs = 0;
+        typeActivation ringActivation = 0;
+        if (checkpointRing != nullptr && checkpointRing->read(ringDatabase, ringScn, ringIdx, ringResetlogs, ringActivation)) {
+            if (unlikely(ringDatabase != CheckpointRing::databaseId(database)))
+                throw DataException(20001, "file: " + checkpointRing->getFileName() + " - invalid database name, expected: " + database);
+
+            metadata->setResetlogs(ringResetlogs);
+            metadata->setActivation(ringActivation);
+            checkpointScn = ringScn;
+            checkpointIdx = ringIdx;
+        } else {
+            // Checkpoint is present - read it
+            std::string checkpoint;
+            rapidjson::Document document;
+            if (!metadata->stateRead(name, CHECKPOINT_FILE_MAX_SIZE, checkpoint)) {
+                if (partitionScn == Scn::none())
+                    return;
+                checkpoint = R"({"database":")" + database + R"(","scn":)" + std::to_string(partitionScn.getData()) + R"(,"idx":0,"resetlogs":)" +
+                             std::to_string(partitionResetlogs) + R"(,"activation":)" + std::to_string(partitionActivation) + "}";
+            }
 
-        // Checkpoint is present - read it
-        std::string checkpoint;
-        rapidjson::Document document;
-        if (!metadata->stateRead(name, CHECKPOINT_FILE_MAX_SIZE, checkpoint))
-            return;
+            if (unlikely(checkpoint.empty() || document.Parse(checkpoint.c_str()).HasParseError()))
+                throw DataException(20001, "file: " + name + " offset: " + std::to_string(document.GetErrorOffset()) +
+                                           " - parse error: " + GetParseError_En(document.GetParseError()));
+
+            if (!metadata->ctx->isDisableChecksSet(Ctx::DISABLE_CHECKS::JSON_TAGS)) {
+                static const std::vector<std::string> documentNames {"database", "resetlogs", "activation", "scn", "idx"};
+                Ctx::checkJsonFields(name, document, documentNames);
+            }
 
-        if (unlikely(checkpoint.empty() || document.Parse(checkpoint.c_str()).HasParseError()))
-            throw DataException(20001, "file: " + name + " offset: " + std::to_string(document.GetErrorOffset()) +
-                                       " - parse error: " + GetParseError_En(document.GetParseError()));
+            const std::string databaseJson = Ctx::getJsonFieldS(name, Ctx::JSON_PARAMETER_LENGTH, document, "database");
+            if (unlikely(database != databaseJson))
+                throw DataException(20001, "file: " + name + " - invalid database name: " + databaseJson);
 
-        if (!metadata->ctx->isDisableChecksSet(Ctx::DISABLE_CHECKS::JSON_TAGS)) {
-            static const std::vector<std::string> documentNames {"database", "resetlogs", "activation", "scn", "idx"};
-            Ctx::checkJsonFields(name, document, documentNames);
-        }
+            metadata->setResetlogs(Ctx::getJsonFieldU32(name, document, "resetlogs"));
+            metadata->setActivation(Ctx::getJsonFieldU32(name, document, "activation"));
 
-        const std::string databaseJson = Ctx::getJsonFieldS(name, Ctx::JSON_PARAMETER_LENGTH, document, "database");
-        if (unlikely(database != databaseJson))
-            throw DataException(20001, "file: " + name + " - invalid database name: " + databaseJson);
+            // Started earlier - continue work and ignore default startup parameters
+            checkpointScn = Ctx::getJsonFieldU64(name, document, "scn");
+            if (document.HasMember("idx"))
+                checkpointIdx = Ctx::getJsonFieldU64(name, document, "idx");
+            else
+                checkpointIdx = 0;
+        }
+        if (partitionScn != Scn::none() && partitionScn < checkpointScn) {
+            checkpointScn = partitionScn;
+            checkpointIdx = 0;
+        }
+        clientScn = checkpointScn;
+        clientIdx = checkpointIdx;
 
-        metadata->setResetlogs(Ctx::getJsonFieldU32(name, document, "resetlogs"));
-        metadata->setActivation(Ctx::getJsonFieldU32(name, document, "activation"));
+        if (metadata->writers > 1) {
+            metadata->setWriterCheckpoint(this, checkpointScn, checkpointIdx);
+            ctx->info(0, "checkpoint - all confirmed till scn: " + checkpointScn.toString() + ", idx: " +
+                         std::to_string(checkpointIdx));
+            return;
+        }
 
-        // Started earlier - continue work and ignore default startup parameters
-        checkpointScn = Ctx::getJsonFieldU64(name, document, "scn");
         metadata->clientScn = checkpointScn;
-        if (document.HasMember("idx"))
-            checkpointIdx = Ctx::getJsonFieldU64(name, document, "idx");
-        else
-            checkpointIdx = 0;
         metadata->clientIdx = checkpointIdx;
         metadata->startScn = checkpointScn;
         metadata->startSequence = Seq::none();
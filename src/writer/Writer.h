@@ -20,7 +20,11 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #ifndef WRITER_H_
 #define WRITER_H_
 
+#include <map>
 #include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include "../common/Thread.h"
 
 namespace OpenLogReplicator {
@@ -28,14 +32,36 @@ namespace OpenLogReplicator {
     struct BuilderMsg;
     struct BuilderQueue;
     class Metadata;
+    class CheckpointRing;
+    class RateLimit;
 
     class Writer : public Thread {
     protected:
         static constexpr uint64_t CHECKPOINT_FILE_MAX_SIZE = 1024;
+        // Upper bound of busy checks for new messages before parking, adjusted to how often spinning pays off
+        static constexpr uint64_t SPIN_MAX{4096};
+        // Client requests read in one poll, a burst of confirmations is then applied in one pass
+        static constexpr uint64_t MAX_REQUESTS_PER_POLL{64};
 
         std::string database;
         Builder* builder;
         Metadata* metadata;
+        // Position of the writer among the writers reading the same builder output
+        uint builderWriter{0};
+        std::string checkpointName;
+        // Tables sent by this writer as OWNER.TABLE, the others are confirmed without sending; all tables when both are empty
+        std::unordered_set<std::string> routeInclude;
+        std::unordered_set<std::string> routeExclude;
+        std::unordered_map<typeObj, bool> objRoutes;
+        // Table and partition version of the schema the caches by object were filled at
+        uint64_t objCacheVersion{0};
+        // Token buckets of the output, nullptr when it is not limited
+        RateLimit* rateLimit{nullptr};
+        // Binary checkpoint slots written instead of the state, nullptr when not configured
+        CheckpointRing* checkpointRing{nullptr};
+        // Checkpoint of this writer, used instead of the common one of the metadata when many writers share it
+        Scn clientScn{Scn::none()};
+        typeIdx clientIdx{0};
         // Information about local checkpoint
         BuilderQueue* builderQueue{nullptr};
         Scn checkpointScn{Scn::none()};
@@ -44,6 +70,8 @@ namespace OpenLogReplicator {
         uint64_t sentMessages{0};
         uint64_t oldSize{0};
         uint64_t currentQueueSize{0};
+        uint64_t queueHead{0};
+        uint64_t spinLimit{0};
         uint64_t hwmQueueSize{0};
         bool streaming{false};
         bool redo{false};
@@ -52,25 +80,76 @@ namespace OpenLogReplicator {
         // scn,idx confirmed by client
         Scn confirmedScn{Scn::none()};
         typeIdx confirmedIdx{0};
-        BuilderMsg** queue{nullptr};
+        // Copy of the message position, the message itself may be gone once its buffer is released
+        struct QueueSlot {
+            BuilderMsg* msg;
+            uint64_t chunkId;
+            Scn lwnScn;
+            typeIdx lwnIdx;
+            bool confirmed;
+        };
+        // Ring of messages sent and not confirmed yet, in id order starting at queueHead
+        QueueSlot* queue{nullptr};
+        uint64_t queueHeadId{0};
+        // Builder buffer id -> number of unconfirmed messages stored in it
+        std::map<uint64_t, uint64_t> chunkPins;
+        uint64_t releasedChunkId{0};
 
-        void createMessage(BuilderMsg* msg);
+        void createMessage(BuilderMsg* msg, uint64_t chunkId);
+        void releaseMessage(BuilderMsg* msg) const;
+        void releaseChunks(bool unpinned);
+        void confirmSlot(QueueSlot& slot, time_ut& now, bool& unpinned);
+        void advanceConfirmed(uint64_t messages, bool unpinned);
         virtual void sendMessage(BuilderMsg* msg) = 0;
+        // A message spread over many builder buffers is given part by part instead of merged into one copy first. Every part is
+        // written or copied before the call returns, the last part completes the message like sendMessage()
+        [[nodiscard]] virtual bool isFragmentSupported() const {
+            return false;
+        }
+        virtual void sendMessageFragment(BuilderMsg* msg __attribute__((unused)), const uint8_t* data __attribute__((unused)),
+                                         uint64_t size __attribute__((unused)), bool first __attribute__((unused)), bool last __attribute__((unused))) {}
+        // The message is confirmed without sending, a checkpoint or data already sent before the restart
+        virtual void skipMessage(const BuilderMsg* msg __attribute__((unused))) {}
         virtual std::string getType() const = 0;
         virtual void pollQueue() = 0;
         void run() override;
         void mainLoop();
         virtual void writeCheckpoint(bool force);
         void readCheckpoint();
-        void sortQueue();
         void resetMessageQueue();
+        bool spinForWork();
+        [[nodiscard]] bool isCaughtUp() const;
+        [[nodiscard]] bool isNewData(Scn scn, typeIdx idx) const;
+        [[nodiscard]] bool isRouted(typeObj obj);
+        virtual void dropObjCaches();
+        void checkObjCaches();
+        void rateLimitWait(const BuilderMsg* msg);
+
+        [[nodiscard]] BuilderMsg* queueFront() const {
+            return queue[queueHead].msg;
+        }
+
+        [[nodiscard]] QueueSlot& queueSlot(uint64_t id) const {
+            uint64_t pos = queueHead + (id - queueHeadId);
+            if (pos >= ctx->queueSize)
+                pos -= ctx->queueSize;
+            return queue[pos];
+        }
 
     public:
         Writer(Ctx* newCtx, std::string newAlias, std::string newDatabase, Builder* newBuilder, Metadata* newMetadata);
         ~Writer() override;
 
         virtual void initialize();
+        void setCheckpointName(std::string newCheckpointName);
+        [[nodiscard]] const std::string& getCheckpointName() const {
+            return checkpointName;
+        }
+        void addRouteTable(const std::string& tableName, bool include);
+        void setRateLimit(RateLimit* newRateLimit);
         void confirmMessage(BuilderMsg* msg);
+        void confirmMessages(BuilderMsg* const* msgs, uint64_t count);
+        void confirmUpTo(uint64_t endId);
         void wakeUp() override;
         virtual void flush() {};
 
@@ -34,6 +34,12 @@ namespace OpenLogReplicator {
         confirmMessage(msg);
     }
 
+    void WriterDiscard::sendMessageFragment(BuilderMsg* msg, const uint8_t* data __attribute__((unused)), uint64_t size __attribute__((unused)),
+                                            bool first __attribute__((unused)), bool last) {
+        if (last)
+            confirmMessage(msg);
+    }
+
     std::string WriterDiscard::getType() const {
         return "discard";
     }
@@ -26,6 +26,10 @@ namespace OpenLogReplicator {
     class WriterDiscard final : public Writer {
     protected:
         void sendMessage(BuilderMsg* msg) override;
+        [[nodiscard]] bool isFragmentSupported() const override {
+            return true;
+        }
+        void sendMessageFragment(BuilderMsg* msg, const uint8_t* data, uint64_t size, bool first, bool last) override;
         std::string getType() const override;
         void pollQueue() override;
 
@@ -0,0 +1,563 @@
+/* Thread writing to many network clients
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+
+#include "../builder/Builder.h"
+#include "../common/OraProtoBuf.pb.h"
+#include "../common/exception/NetworkException.h"
+#include "../common/DbTable.h"
+#include "../metadata/Metadata.h"
+#include "../metadata/Schema.h"
+#include "../stream/Stream.h"
+#include "../stream/StreamFilter.h"
+#include "WriterFanout.h"
+
+namespace OpenLogReplicator {
+    WriterFanout::WriterFanout(Ctx* newCtx, std::string newAlias, std::string newDatabase, Builder* newBuilder, Metadata* newMetadata,
+                               Stream* newServer, uint64_t newMaxClients, uint64_t newMaxLagMessages) :
+            Writer(newCtx, std::move(newAlias), std::move(newDatabase), newBuilder, newMetadata),
+            server(newServer),
+            maxClients(newMaxClients),
+            maxLagMessages(newMaxLagMessages) {
+        metadata->bootFailsafe = true;
+        ctx->parserThread = this;
+    }
+
+    WriterFanout::~WriterFanout() {
+        for (Client* client: clients) {
+            delete client->stream;
+            delete client;
+        }
+        clients.clear();
+
+        for (StreamFilter* filter: filters)
+            delete filter;
+        filters.clear();
+
+        if (server != nullptr) {
+            delete server;
+            server = nullptr;
+        }
+    }
+
+    void WriterFanout::initialize() {
+        Writer::initialize();
+        clients.reserve(maxClients);
+        protobufOutput = builder->isProtobuf();
+
+        server->initializeServer();
+    }
+
+    std::string WriterFanout::getType() const {
+        return server->getName() + " fan-out";
+    }
+
+    uint64_t WriterFanout::queueEndId() const {
+        return queueHeadId + currentQueueSize;
+    }
+
+    void WriterFanout::acceptClients() {
+        while (true) {
+            Stream* stream = server->acceptClient();
+            if (stream == nullptr)
+                return;
+
+            if (clients.size() >= maxClients) {
+                ctx->warning(70012, "client rejected, already serving " + std::to_string(clients.size()) + " clients");
+                delete stream;
+                continue;
+            }
+
+            clients.push_back(new Client{stream, false, Scn::none(), 0, 0, 0, 0, nullptr});
+            ctx->info(0, "client connected, clients: " + std::to_string(clients.size()));
+        }
+    }
+
+    void WriterFanout::disconnect(Client* client, const std::string& reason) {
+        clients.erase(std::find(clients.begin(), clients.end(), client));
+        ctx->warning(70012, "client disconnected: " + reason + ", clients: " + std::to_string(clients.size()));
+        releaseFilter(client);
+        delete client->stream;
+        delete client;
+    }
+
+    void WriterFanout::releaseFilter(Client* client) {
+        if (client->filter == nullptr)
+            return;
+
+        if (--client->filter->users == 0) {
+            filters.erase(std::find(filters.begin(), filters.end(), client->filter));
+            delete client->filter;
+        }
+        client->filter = nullptr;
+    }
+
+    // Clients with identical subscriptions share one filter, so every message is filtered once for all of them
+    bool WriterFanout::subscribe(Client* client) {
+        releaseFilter(client);
+        const uint64_t rules = StreamFilter::countRules(request);
+        if (rules == 0)
+            return true;
+
+        std::string error;
+        if (!protobufOutput && !builder->isMessagePerRow())
+            error = "subscription filters require protobuf format or one message per row";
+        else {
+            auto* newFilter = new StreamFilter();
+            if (newFilter->initialize(request, error) && !protobufOutput && !newFilter->isTableOnly())
+                error = "subscription filters with op or columns require protobuf format";
+            else if (error.empty()) {
+                for (StreamFilter* filter: filters) {
+                    if (filter->getKey() == newFilter->getKey()) {
+                        client->filter = filter;
+                        break;
+                    }
+                }
+
+                if (client->filter == nullptr) {
+                    filters.push_back(newFilter);
+                    client->filter = newFilter;
+                } else
+                    delete newFilter;
+                ++client->filter->users;
+                ctx->info(0, "client subscribed to " + std::to_string(rules) + " table masks, shared by " +
+                             std::to_string(client->filter->users) + " clients");
+                return true;
+            }
+            delete newFilter;
+        }
+
+        ctx->warning(60038, "invalid subscription: " + error);
+        response.set_code(pb::ResponseCode::INVALID_COMMAND);
+        return false;
+    }
+
+    // The accepted method is named in the reply, the frames after the reply are compressed
+    std::string WriterFanout::negotiateCompression(const Client* client) {
+        const std::string method = StreamFilter::getOption(request, "compression");
+        if (method.empty() || !client->streaming)
+            return "";
+
+        if (!client->stream->supportsCompression(method)) {
+            ctx->warning(60039, "client requested unsupported compression: " + method + ", sending uncompressed");
+            return "";
+        }
+        (*response.mutable_attributes())["compression"] = method;
+        ctx->info(0, "compression for client: " + method);
+        return method;
+    }
+
+    void WriterFanout::processInfo() {
+        response.Clear();
+        if (request.database_name() != database) {
+            ctx->warning(60035, "unknown database requested, got: " + request.database_name() + ", expected: " + database);
+            response.set_code(pb::ResponseCode::INVALID_DATABASE);
+            return;
+        }
+
+        if (metadata->status == Metadata::STATUS::READY) {
+            ctx->logTrace(Ctx::TRACE::WRITER, "info, ready");
+            response.set_code(pb::ResponseCode::READY);
+            return;
+        }
+
+        if (metadata->status == Metadata::STATUS::START) {
+            ctx->logTrace(Ctx::TRACE::WRITER, "info, start");
+            response.set_code(pb::ResponseCode::STARTING);
+        }
+
+        ctx->logTrace(Ctx::TRACE::WRITER, "info, first scn: " + metadata->firstDataScn.toString());
+        response.set_code(pb::ResponseCode::REPLICATE);
+        response.set_scn(metadata->firstDataScn.getData());
+        response.set_c_scn(confirmedScn.getData());
+        response.set_c_idx(confirmedIdx);
+    }
+
+    void WriterFanout::processStart(Client* client) {
+        response.Clear();
+        if (request.database_name() != database) {
+            ctx->warning(60035, "unknown database requested, got: " + request.database_name() + ", expected: " + database);
+            response.set_code(pb::ResponseCode::INVALID_DATABASE);
+            return;
+        }
+
+        if (metadata->status == Metadata::STATUS::REPLICATE) {
+            ctx->logTrace(Ctx::TRACE::WRITER, "client requested start when already started");
+            response.set_code(pb::ResponseCode::ALREADY_STARTED);
+            response.set_scn(metadata->firstDataScn.getData());
+            response.set_c_scn(confirmedScn.getData());
+            response.set_c_idx(confirmedIdx);
+            return;
+        }
+
+        if (metadata->status == Metadata::STATUS::START) {
+            ctx->logTrace(Ctx::TRACE::WRITER, "client requested start when already starting");
+            response.set_code(pb::ResponseCode::STARTING);
+            return;
+        }
+
+        if (!subscribe(client))
+            return;
+
+        std::string paramSeq;
+        if (request.has_seq()) {
+            metadata->startSequence = request.seq();
+            paramSeq = ", seq: " + std::to_string(request.seq());
+        } else
+            metadata->startSequence = Seq::none();
+
+        metadata->startScn = Scn::none();
+        metadata->startTime = "";
+        metadata->startTimeRel = 0;
+
+        switch (request.tm_val_case()) {
+            case pb::RedoRequest::TmValCase::kScn:
+                metadata->startScn = request.scn();
+                if (metadata->startScn == Scn::none())
+                    ctx->info(0, "client requested to start from NOW" + paramSeq);
+                else
+                    ctx->info(0, "client requested to start from scn: " + metadata->startScn.toString() + paramSeq);
+                break;
+
+            case pb::RedoRequest::TmValCase::kTms:
+                metadata->startTime = request.tms();
+                ctx->info(0, "client requested to start from time: " + metadata->startTime + paramSeq);
+                break;
+
+            case pb::RedoRequest::TmValCase::kTmRel:
+                metadata->startTimeRel = request.tm_rel();
+                ctx->info(0, "client requested to start from relative time: " + std::to_string(metadata->startTimeRel) + paramSeq);
+                break;
+
+            default:
+                ctx->logTrace(Ctx::TRACE::WRITER, "client requested an invalid starting point");
+                response.set_code(pb::ResponseCode::INVALID_COMMAND);
+                return;
+        }
+        metadata->setStatusStart(this);
+
+        contextSet(CONTEXT::SLEEP);
+        metadata->waitForReplicator(this);
+
+        if (metadata->status == Metadata::STATUS::REPLICATE) {
+            response.set_code(pb::ResponseCode::REPLICATE);
+            response.set_scn(metadata->firstDataScn.getData());
+            response.set_c_scn(confirmedScn.getData());
+            response.set_c_idx(confirmedIdx);
+
+            client->streaming = true;
+            client->startScn = Scn::none();
+            client->startIdx = 0;
+            client->nextId = (currentQueueSize > 0) ? queueHeadId : 0;
+            client->confirmedId = client->nextId;
+            client->sentEndId = client->nextId;
+            ctx->info(0, "streaming to client");
+            streaming = true;
+        } else {
+            ctx->logTrace(Ctx::TRACE::WRITER, "starting failed");
+            response.set_code(pb::ResponseCode::FAILED_START);
+        }
+    }
+
+    // The first client sets the replication position, any later one joins the stream at its own position, as long as
+    // it is not older than what every other client has confirmed already
+    void WriterFanout::processContinue(Client* client) {
+        response.Clear();
+        if (request.database_name() != database) {
+            ctx->warning(60035, "unknown database requested, got: " + std::string(request.database_name()) + " instead of " + database);
+            response.set_code(pb::ResponseCode::INVALID_DATABASE);
+            return;
+        }
+
+        if (!subscribe(client))
+            return;
+
+        Scn startScn = confirmedScn;
+        typeIdx startIdx = confirmedIdx;
+        std::string paramIdx;
+
+        // 0 means continue with last value
+        if (request.has_c_scn() && request.c_scn() != 0) {
+            startScn = request.c_scn();
+            startIdx = request.has_c_idx() ? request.c_idx() : 0;
+            paramIdx = ", idx: " + std::to_string(startIdx);
+        }
+        ctx->info(0, "client requested scn: " + startScn.toString() + paramIdx);
+
+        if (!streaming) {
+            metadata->clientScn = startScn;
+            metadata->clientIdx = startIdx;
+            resetMessageQueue();
+        } else if (confirmedScn != Scn::none() && (startScn < confirmedScn || (startScn == confirmedScn && startIdx < confirmedIdx))) {
+            ctx->warning(70012, "client requested scn: " + startScn.toString() + " older than confirmed by all clients: " +
+                                confirmedScn.toString());
+            response.set_code(pb::ResponseCode::FAILED_START);
+            return;
+        }
+
+        client->streaming = true;
+        client->startScn = startScn;
+        client->startIdx = startIdx;
+        client->nextId = (currentQueueSize > 0) ? queueHeadId : 0;
+        client->confirmedId = client->nextId;
+        client->sentEndId = client->nextId;
+        response.set_code(pb::ResponseCode::REPLICATE);
+        ctx->info(0, "streaming to client, clients: " + std::to_string(clients.size()));
+        streaming = true;
+    }
+
+    void WriterFanout::processConfirm(Client* client) {
+        if (request.database_name() != database) {
+            ctx->warning(60035, "unknown database confirmed, got: " + request.database_name() + ", expected: " + database);
+            return;
+        }
+
+        const Scn scn(request.c_scn());
+        const typeIdx idx = request.c_idx();
+        if (client->confirmedId < queueHeadId)
+            client->confirmedId = queueHeadId;
+        while (client->confirmedId < client->nextId) {
+            const QueueSlot& slot = queueSlot(client->confirmedId);
+            if (slot.lwnScn > scn || (slot.lwnScn == scn && slot.lwnIdx > idx))
+                break;
+            ++client->confirmedId;
+        }
+        if (client->confirmedId >= client->sentEndId)
+            client->confirmedId = client->nextId;
+    }
+
+    void WriterFanout::sendResponse(Client* client) {
+        std::string msgS;
+        response.SerializeToString(&msgS);
+        client->stream->sendMessage(msgS.c_str(), msgS.length());
+    }
+
+    void WriterFanout::processRequest(Client* client, const uint8_t* data, uint64_t size) {
+        request.Clear();
+        if (!request.ParseFromArray(data, static_cast<int>(size))) {
+            std::ostringstream ss;
+            ss << "request decoder[" << std::dec << size << "]: ";
+            for (uint64_t i = 0; i < size; ++i)
+                ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<uint>(data[i]) << " ";
+            ctx->warning(60033, ss.str());
+            return;
+        }
+
+        if (client->streaming) {
+            switch (request.code()) {
+                case pb::RequestCode::INFO:
+                    processInfo();
+                    sendResponse(client);
+                    client->stream->setCompression("");
+                    // Builder memory behind the unsent messages is no longer held for this client
+                    client->stream->copyQueued();
+                    client->streaming = false;
+                    break;
+
+                case pb::RequestCode::CONFIRM:
+                    processConfirm(client);
+                    break;
+
+                default:
+                    ctx->warning(60032, "unknown request code: " + std::to_string(request.code()));
+                    response.Clear();
+                    response.set_code(pb::ResponseCode::INVALID_COMMAND);
+                    sendResponse(client);
+                    break;
+            }
+        } else {
+            switch (request.code()) {
+                case pb::RequestCode::INFO:
+                    processInfo();
+                    sendResponse(client);
+                    break;
+
+                case pb::RequestCode::START: {
+                    processStart(client);
+                    const std::string compression = negotiateCompression(client);
+                    sendResponse(client);
+                    client->stream->setCompression(compression);
+                    break;
+                }
+
+                case pb::RequestCode::CONTINUE: {
+                    processContinue(client);
+                    const std::string compression = negotiateCompression(client);
+                    sendResponse(client);
+                    client->stream->setCompression(compression);
+                    break;
+                }
+
+                default:
+                    ctx->warning(60032, "unknown request code: " + std::to_string(request.code()));
+                    response.Clear();
+                    response.set_code(pb::ResponseCode::INVALID_COMMAND);
+                    sendResponse(client);
+                    break;
+            }
+        }
+    }
+
+    // Catch up a client with everything in the queue it has not got yet, messages the client did not ask for are
+    // skipped but still count as sent
+    void WriterFanout::sendPending(Client* client) {
+        if (client->nextId < queueHeadId)
+            client->nextId = queueHeadId;
+
+        while (client->nextId < queueEndId()) {
+            const QueueSlot& slot = queueSlot(client->nextId);
+            if (slot.confirmed) {
+                ++client->nextId;
+                if (client->confirmedId >= client->sentEndId)
+                    client->confirmedId = client->nextId;
+                continue;
+            }
+            sendTo(client, slot.msg, client->startScn == Scn::none() || slot.lwnScn > client->startScn ||
+                                     (slot.lwnScn == client->startScn && slot.lwnIdx > client->startIdx));
+        }
+    }
+
+    const std::pair<std::string, std::string>& WriterFanout::objectName(typeObj obj) {
+        const auto& it = objectNames.find(obj);
+        if (it != objectNames.end())
+            return it->second;
+
+        std::pair<std::string, std::string> name;
+        {
+            contextSet(CONTEXT::MUTEX, REASON::WRITER_SCHEMA);
+            std::unique_lock<std::mutex> const lck(metadata->mtxSchema);
+            const DbTable* table = metadata->schema->checkTableDict(obj);
+            if (table != nullptr)
+                name = {table->owner, table->name};
+        }
+        contextSet(CONTEXT::CPU);
+        return objectNames.insert_or_assign(obj, std::move(name)).first->second;
+    }
+
+    void WriterFanout::sendTo(Client* client, BuilderMsg* msg, bool wanted) {
+        if (wanted && client->filter != nullptr) {
+            StreamFilter::RESULT result;
+            if (protobufOutput)
+                result = client->filter->apply(msg->id, msg->data + msg->tagSize, msg->size - msg->tagSize);
+            else if (msg->obj == 0)
+                result = client->filter->applyTable(msg->id, nullptr, nullptr);
+            else {
+                const std::pair<std::string, std::string>& name = objectName(msg->obj);
+                result = client->filter->applyTable(msg->id, &name.first, &name.second);
+            }
+
+            switch (result) {
+                case StreamFilter::RESULT::ORIGINAL:
+                    client->stream->queueMessage(msg->data + msg->tagSize, msg->size - msg->tagSize);
+                    break;
+
+                case StreamFilter::RESULT::FILTERED:
+                    // The filtered copy is replaced by the next message, so it is not batched
+                    client->stream->sendMessage(client->filter->getOutput().c_str(), client->filter->getOutput().length());
+                    break;
+
+                case StreamFilter::RESULT::SKIP:
+                    wanted = false;
+                    break;
+            }
+        } else if (wanted)
+            client->stream->queueMessage(msg->data + msg->tagSize, msg->size - msg->tagSize);
+
+        client->nextId = msg->id + 1;
+        if (wanted)
+            client->sentEndId = client->nextId;
+        else if (client->confirmedId >= client->sentEndId)
+            client->confirmedId = client->nextId;
+    }
+
+    // Builder memory is released up to the lowest position confirmed by all streaming clients
+    void WriterFanout::confirmAll() {
+        uint64_t minId = UINT64_MAX;
+        for (const Client* client: clients)
+            if (client->streaming)
+                minId = std::min(minId, std::max(client->confirmedId, queueHeadId));
+        if (minId == UINT64_MAX)
+            return;
+
+        confirmUpTo(minId);
+    }
+
+    void WriterFanout::pollQueue() {
+        server->pollEvents();
+        acceptClients();
+
+        const bool force = isCaughtUp() || currentQueueSize >= ctx->queueSize;
+        for (uint64_t i = 0; i < clients.size();) {
+            Client* client = clients[i];
+            try {
+                // Confirmations only move the cursor of the client, the queue is walked once in confirmAll()
+                uint8_t msgR[Stream::READ_NETWORK_BUFFER];
+                for (uint64_t requests = 0; requests < MAX_REQUESTS_PER_POLL; ++requests) {
+                    const uint64_t size = client->stream->receiveMessageNB(msgR, Stream::READ_NETWORK_BUFFER);
+                    if (size == 0) {
+                        if (errno != EAGAIN)
+                            throw NetworkException(10061, "network error, errno: " + std::to_string(errno) + ", message: " +
+                                                   strerror(errno));
+                        break;
+                    }
+                    processRequest(client, msgR, size);
+                }
+
+                if (client->streaming) {
+                    sendPending(client);
+                    client->stream->flush(force);
+
+                    if (maxLagMessages > 0 && currentQueueSize > 0 &&
+                            queueEndId() - std::max(client->confirmedId, queueHeadId) > maxLagMessages) {
+                        disconnect(client, "more than " + std::to_string(maxLagMessages) + " messages not confirmed");
+                        continue;
+                    }
+                }
+            } catch (NetworkException& ex) {
+                disconnect(client, ex.msg);
+                continue;
+            }
+            ++i;
+        }
+
+        confirmAll();
+    }
+
+    void WriterFanout::sendMessage(BuilderMsg* msg) {
+        for (uint64_t i = 0; i < clients.size();) {
+            Client* client = clients[i];
+            if (client->streaming) {
+                if (client->nextId < queueHeadId)
+                    client->nextId = queueHeadId;
+                try {
+                    if (client->nextId == msg->id)
+                        sendTo(client, msg, client->startScn == Scn::none() || msg->lwnScn > client->startScn ||
+                                            (msg->lwnScn == client->startScn && msg->lwnIdx > client->startIdx));
+                } catch (NetworkException& ex) {
+                    disconnect(client, ex.msg);
+                    continue;
+                }
+            }
+            ++i;
+        }
+    }
+}
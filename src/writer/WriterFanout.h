@@ -0,0 +1,91 @@
+/* Header for WriterFanout class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef WRITER_FANOUT_H_
+#define WRITER_FANOUT_H_
+
+#include <unordered_map>
+#include <vector>
+
+#include "Writer.h"
+#include "../common/OraProtoBuf.pb.h"
+
+namespace OpenLogReplicator {
+    class Stream;
+    class StreamFilter;
+
+    // Many network clients reading the same output, each one with its own confirmed position
+    class WriterFanout final : public Writer {
+    protected:
+        struct Client {
+            Stream* stream;
+            bool streaming;
+            // Position requested by the client, older messages are not sent to it
+            Scn startScn;
+            typeIdx startIdx;
+            // Id of the next message to send, and of the first one not confirmed yet
+            uint64_t nextId;
+            uint64_t confirmedId;
+            // Id after the last message actually sent, everything from there on needs no confirmation
+            uint64_t sentEndId;
+            // Subscription shared with all clients having the same one, nullptr for everything
+            StreamFilter* filter;
+        };
+
+        Stream* server;
+        std::vector<Client*> clients;
+        std::vector<StreamFilter*> filters;
+        // Owner and name by object, for table filters on output which is not decoded, empty for objects not in the schema
+        std::unordered_map<typeObj, std::pair<std::string, std::string>> objectNames;
+        bool protobufOutput{false};
+        uint64_t maxClients;
+        uint64_t maxLagMessages;
+        pb::RedoRequest request;
+        pb::RedoResponse response;
+
+        std::string getType() const override;
+        [[nodiscard]] uint64_t queueEndId() const;
+        void acceptClients();
+        void disconnect(Client* client, const std::string& reason);
+        void releaseFilter(Client* client);
+        [[nodiscard]] const std::pair<std::string, std::string>& objectName(typeObj obj);
+        bool subscribe(Client* client);
+        [[nodiscard]] std::string negotiateCompression(const Client* client);
+        void sendTo(Client* client, BuilderMsg* msg, bool wanted);
+        void processRequest(Client* client, const uint8_t* data, uint64_t size);
+        void processInfo();
+        void processStart(Client* client);
+        void processContinue(Client* client);
+        void processConfirm(Client* client);
+        void sendPending(Client* client);
+        void sendResponse(Client* client);
+        void confirmAll();
+        void pollQueue() override;
+        void sendMessage(BuilderMsg* msg) override;
+
+    public:
+        WriterFanout(Ctx* newCtx, std::string newAlias, std::string newDatabase, Builder* newBuilder, Metadata* newMetadata,
+                     Stream* newServer, uint64_t newMaxClients, uint64_t newMaxLagMessages);
+        ~WriterFanout() override;
+
+        void initialize() override;
+    };
+}
+
+#endif
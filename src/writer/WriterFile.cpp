@@ -23,14 +23,20 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include <algorithm>
 #include <cstring>
 #include <dirent.h>
+#include <climits>
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#ifdef LINK_LIBRARY_LZ4
+#define LZ4F_STATIC_LINKING_ONLY
+#include <lz4frame.h>
+#endif /* LINK_LIBRARY_LZ4 */
 
 #include "../builder/Builder.h"
 #include "../common/exception/ConfigurationException.h"
 #include "../common/exception/RuntimeException.h"
 #include "../metadata/Metadata.h"
+#include "FileSyncer.h"
 #include "WriterFile.h"
 
 namespace OpenLogReplicator {
@@ -38,18 +44,44 @@ namespace OpenLogReplicator {
                            Metadata *newMetadata,
                            std::string newOutput, std::string newTimestampFormat, uint64_t newMaxFileSize,
                            uint64_t newNewLine, uint64_t newAppend,
-                           uint newWriteBufferFlushSize) : Writer(newCtx, std::move(newAlias), std::move(newDatabase),
+                           uint newWriteBufferFlushSize, bool newZeroCopy,
+                           uint64_t newFsyncIntervalUs, uint64_t newFsyncSize) : Writer(newCtx, std::move(newAlias), std::move(newDatabase),
                                                                   newBuilder, newMetadata),
                                                            output(std::move(newOutput)),
                                                            timestampFormat(std::move(newTimestampFormat)),
                                                            maxFileSize(newMaxFileSize),
                                                            newLine(newNewLine),
                                                            append(newAppend),
-                                                           writeBufferFlushSize(newWriteBufferFlushSize) {
+                                                           writeBufferFlushSize(newWriteBufferFlushSize),
+                                                           zeroCopy(newZeroCopy),
+                                                           fsyncIntervalUs(newFsyncIntervalUs),
+                                                           fsyncSize(newFsyncSize) {
     }
 
     WriterFile::~WriterFile() {
         closeFile();
+        if (syncer != nullptr) {
+            syncer->stop();
+            ctx->finishThread(syncer);
+            delete syncer;
+            syncer = nullptr;
+        }
+#ifdef LINK_LIBRARY_LZ4
+        if (compressCtx != nullptr) {
+            LZ4F_freeCompressionContext(compressCtx);
+            compressCtx = nullptr;
+        }
+        if (compressDict != nullptr) {
+            LZ4F_freeCDict(compressDict);
+            compressDict = nullptr;
+        }
+#endif /* LINK_LIBRARY_LZ4 */
+        delete[] compressBuffer;
+        compressBuffer = nullptr;
+        if (directBuffer != nullptr) {
+            ctx->freeMemoryChunk(this, Ctx::MEMORY::WRITER, directBuffer);
+            directBuffer = nullptr;
+        }
         if (buffer == nullptr)
             return;
         ctx->freeMemoryChunk(this, Ctx::MEMORY::WRITER, buffer);
@@ -59,6 +91,12 @@ namespace OpenLogReplicator {
     void WriterFile::initialize() {
         Writer::initialize();
         buffer = ctx->getMemoryChunk(this, Ctx::MEMORY::WRITER);
+        if (directIo)
+            directBuffer = ctx->getMemoryChunk(this, Ctx::MEMORY::WRITER);
+        if (zeroCopy) {
+            iov.reserve(IOV_MAX);
+            iovMessages.reserve(ctx->queueSize);
+        }
 
         if (newLine == 1) {
             newLineMsg = reinterpret_cast<const uint8_t *>("\n");
@@ -66,11 +104,19 @@ namespace OpenLogReplicator {
             newLineMsg = reinterpret_cast<const uint8_t *>("\r\n");
         }
 
+        if (compression != COMPRESSION::NONE)
+            initializeCompression();
+
         if (this->output.empty()) {
             outputDes = STDOUT_FILENO;
             return;
         }
 
+        if (fsyncIntervalUs > 0) {
+            syncer = new FileSyncer(ctx, alias + "-sync", this, fsyncIntervalUs, fsyncSize);
+            ctx->spawnThread(syncer);
+        }
+
         auto outputIt = this->output.find_last_of('/');
         if (outputIt != std::string::npos) {
             pathName = this->output.substr(0, outputIt);
@@ -125,6 +171,10 @@ namespace OpenLogReplicator {
         } else if ((prefixPos = fileNameMask.find("%s")) != std::string::npos) {
             mode = MODE::SEQUENCE;
             suffixPos = prefixPos + 2;
+        } else if ((prefixPos = fileNameMask.find("%p")) != std::string::npos) {
+            // Named after the table or hash bucket, the files are opened by the partitioner of the merge writer
+            mode = MODE::PARTITION;
+            suffixPos = prefixPos + 2;
         } else {
             if ((prefixPos = fileNameMask.find('%')) != std::string::npos)
                 throw ConfigurationException(30005, "invalid value for 'output': " + this->output);
@@ -137,6 +187,9 @@ namespace OpenLogReplicator {
         if ((mode == MODE::TIMESTAMP || mode == MODE::NUM) && maxFileSize == 0)
             throw ConfigurationException(30007, "output file is with no max file size: " + this->output +
                                                 " - 'max-file-size' must be defined for output with rotation");
+        if (preallocate && maxFileSize == 0)
+            throw ConfigurationException(30007, "output file is with no max file size: " + this->output +
+                                                " - 'max-file-size' must be defined for preallocated output");
 
         // Search for last used number
         if (mode == MODE::NUM) {
@@ -196,10 +249,78 @@ namespace OpenLogReplicator {
         streaming = true;
     }
 
+    void WriterFile::setCompression(COMPRESSION newCompression, int newCompressionLevel,
+                                    std::string newCompressionDictionaryFile) {
+        compression = newCompression;
+        compressionLevel = newCompressionLevel;
+        compressionDictionaryFile = std::move(newCompressionDictionaryFile);
+    }
+
+    void WriterFile::setFileIo(bool newPreallocate, bool newDirectIo) {
+        preallocate = newPreallocate;
+        directIo = newDirectIo;
+    }
+
+    void WriterFile::initializeCompression() {
+        if (!compressionDictionaryFile.empty()) {
+            const int fd = open(compressionDictionaryFile.c_str(), O_RDONLY);
+            if (fd == -1)
+                throw RuntimeException(10001, "file: " + compressionDictionaryFile + " - open for read returned: " +
+                                              strerror(errno));
+
+            char data[4096];
+            int64_t bytesRead;
+            while ((bytesRead = read(fd, data, sizeof(data))) > 0)
+                compressionDictionary.append(data, bytesRead);
+            close(fd);
+            if (bytesRead < 0)
+                throw RuntimeException(10005, "file: " + compressionDictionaryFile + " - read returned: " +
+                                              strerror(errno));
+
+            if (compressionDictionary.length() > COMPRESSION_DICTIONARY_MAX_SIZE)
+                compressionDictionary.erase(0, compressionDictionary.length() - COMPRESSION_DICTIONARY_MAX_SIZE);
+        }
+
+#ifdef LINK_LIBRARY_LZ4
+        LZ4F_preferences_t preferences{};
+        preferences.compressionLevel = compressionLevel;
+        compressBufferSize = LZ4F_compressFrameBound(Ctx::MEMORY_CHUNK_SIZE, &preferences);
+        compressBuffer = new uint8_t[compressBufferSize];
+
+        LZ4F_cctx* cctx;
+        const LZ4F_errorCode_t ret = LZ4F_createCompressionContext(&cctx, LZ4F_VERSION);
+        if (LZ4F_isError(ret))
+            throw RuntimeException(10076, std::string("lz4 compression context creation returned: ") +
+                                          LZ4F_getErrorName(ret));
+        compressCtx = cctx;
+
+        if (!compressionDictionary.empty()) {
+            compressDict = LZ4F_createCDict(compressionDictionary.c_str(), compressionDictionary.length());
+            if (compressDict == nullptr)
+                throw RuntimeException(10076, "file: " + compressionDictionaryFile +
+                                              " - lz4 dictionary creation failed");
+        }
+#endif /* LINK_LIBRARY_LZ4 */
+    }
+
     void WriterFile::closeFile() {
         if (outputDes == -1)
             return;
 
+        if (syncer != nullptr)
+            syncer->detach(this);
+
+        // Blocks preallocated past the end are released
+        if (preallocate) {
+            contextSet(CONTEXT::OS, REASON::OS);
+            const int truncateRet = ftruncate(outputDes, static_cast<off_t>(fileEnd()));
+            contextSet(CONTEXT::CPU);
+            if (truncateRet != 0)
+                ctx->warning(60064, "file: " + fullFileName + " - release of preallocated space returned: " + strerror(errno));
+        }
+        directOffset = 0;
+        directFill = 0;
+
         contextSet(CONTEXT::OS, REASON::OS);
         close(outputDes);
         contextSet(CONTEXT::CPU);
@@ -216,7 +337,7 @@ namespace OpenLogReplicator {
     }
 
     void WriterFile::checkFile(Scn scn __attribute__((unused)), Seq sequence, uint64_t size) {
-        if (mode == MODE::STDOUT)
+        if (mode == MODE::STDOUT || mode == MODE::PARTITION)
             return;
 
         if (mode == MODE::NO_ROTATE) {
@@ -299,24 +420,85 @@ namespace OpenLogReplicator {
 
             ctx->info(0, "opening output file: " + fullFileName);
             contextSet(CONTEXT::OS, REASON::OS);
-            outputDes = open(fullFileName.c_str(), O_CREAT | O_WRONLY, S_IRUSR | S_IWUSR);
+            if (directIo)
+                outputDes = open(fullFileName.c_str(), O_CREAT | O_RDWR | O_DIRECT, S_IRUSR | S_IWUSR);
+            else
+                outputDes = open(fullFileName.c_str(), O_CREAT | O_WRONLY, S_IRUSR | S_IWUSR);
             contextSet(CONTEXT::CPU);
 
             if (outputDes == -1)
                 throw RuntimeException(
                     10006, "file: " + fullFileName + " - open for writing returned: " + strerror(errno));
 
+            // Appending starts from the last partial block, it is read back to the staging buffer
+            if (directIo) {
+                const uint64_t existingSize = statRet == 0 ? static_cast<uint64_t>(fileStat.st_size) : 0;
+                directOffset = existingSize & ~(DIRECT_IO_ALIGNMENT - 1);
+                directFill = existingSize - directOffset;
+                if (directFill > 0) {
+                    contextSet(CONTEXT::OS, REASON::OS);
+                    const int64_t bytesRead = pread(outputDes, directBuffer, DIRECT_IO_ALIGNMENT, static_cast<off_t>(directOffset));
+                    contextSet(CONTEXT::CPU);
+                    if (bytesRead < 0 || static_cast<uint64_t>(bytesRead) < directFill)
+                        throw RuntimeException(10005, "file: " + fullFileName + " - " + std::to_string(bytesRead) +
+                                                      " bytes read instead of " + std::to_string(directFill) +
+                                                      ", code returned: " + strerror(errno));
+                }
+            }
+
             contextSet(CONTEXT::OS, REASON::OS);
             const int lseekRet = lseek(outputDes, 0, SEEK_END);
             contextSet(CONTEXT::CPU);
             if (lseekRet == -1)
                 throw RuntimeException(10011, "file: " + fullFileName + " - seek returned: " + strerror(errno));
+
+            if (preallocate)
+                preallocateFile();
+
+            if (syncer != nullptr)
+                syncer->attach(outputDes, fullFileName);
         }
     }
 
+    // The size is kept, readers of the file see only the bytes written, a file system without support turns it off
+    void WriterFile::preallocateFile() {
+        const uint64_t end = fileEnd();
+        if (end >= maxFileSize)
+            return;
+
+        contextSet(CONTEXT::OS, REASON::OS);
+        const int allocateRet = fallocate(outputDes, FALLOC_FL_KEEP_SIZE, static_cast<off_t>(end), static_cast<off_t>(maxFileSize - end));
+        contextSet(CONTEXT::CPU);
+        if (allocateRet == 0)
+            return;
+
+        ctx->warning(60063, "file: " + fullFileName + " - preallocation returned: " + strerror(errno) + ", disabled");
+        preallocate = false;
+    }
+
+    uint64_t WriterFile::fileEnd() const {
+        if (directIo)
+            return directOffset + directFill;
+        const off_t pos = lseek(outputDes, 0, SEEK_CUR);
+        return pos < 0 ? 0 : static_cast<uint64_t>(pos);
+    }
+
     void WriterFile::sendMessage(BuilderMsg *msg) {
         checkFile(msg->scn, msg->sequence, msg->size + newLine);
 
+        if (zeroCopy) {
+            // The message stays in the builder queue until written, confirmed by flush()
+            iovMessages.push_back(msg);
+            gatherWrite(msg->data + msg->tagSize, msg->size - msg->tagSize);
+            fileSize += msg->size - msg->tagSize;
+
+            if (newLine > 0) {
+                gatherWrite(newLineMsg, newLine);
+                fileSize += newLine;
+            }
+            return;
+        }
+
         bufferedWrite(msg->data + msg->tagSize, msg->size - msg->tagSize);
         fileSize += msg->size - msg->tagSize;
 
@@ -325,7 +507,49 @@ namespace OpenLogReplicator {
             fileSize += newLine;
         }
 
-        confirmMessage(msg);
+        releaseMessage(msg);
+    }
+
+    // Parts are copied to the write buffer, the builder buffers they come from may be released before the file is written
+    void WriterFile::sendMessageFragment(BuilderMsg *msg, const uint8_t *data, uint64_t size, bool first, bool last) {
+        if (first) {
+            checkFile(msg->scn, msg->sequence, msg->size + newLine);
+            fragmentTagLeft = msg->tagSize;
+        }
+
+        const uint64_t tagSkip = std::min(fragmentTagLeft, size);
+        fragmentTagLeft -= tagSkip;
+        bufferedWrite(data + tagSkip, size - tagSkip);
+        fileSize += size - tagSkip;
+        if (!last)
+            return;
+
+        if (newLine > 0) {
+            bufferedWrite(newLineMsg, newLine);
+            fileSize += newLine;
+        }
+
+        if (zeroCopy)
+            iovMessages.push_back(msg);
+        else
+            releaseMessage(msg);
+    }
+
+    // The message ends where the bytes written so far and the bytes still buffered end
+    void WriterFile::releaseMessage(BuilderMsg *msg) {
+        if (syncer == nullptr) {
+            confirmMessage(msg);
+            return;
+        }
+        unsyncedMessages.emplace_back(writtenBytes + (zeroCopy ? iovSize : bufferFill), msg);
+    }
+
+    void WriterFile::confirmSynced() {
+        const uint64_t durableBytes = syncer->getDurableBytes();
+        while (!unsyncedMessages.empty() && unsyncedMessages.front().first <= durableBytes) {
+            confirmMessage(unsyncedMessages.front().second);
+            unsyncedMessages.pop_front();
+        }
     }
 
     std::string WriterFile::getType() const {
@@ -338,10 +562,23 @@ namespace OpenLogReplicator {
         if (metadata->status == Metadata::STATUS::READY)
             metadata->setStatusStart(this);
 
-        flush();
+        // Deferred messages hold the output queue, write them out when it is full or there is nothing more to gather
+        if (!zeroCopy || currentQueueSize >= ctx->queueSize || isCaughtUp())
+            flush();
+
+        if (syncer != nullptr) {
+            if (currentQueueSize >= ctx->queueSize)
+                syncer->request();
+            confirmSynced();
+        }
     }
 
     void WriterFile::flush() {
+        if (zeroCopy) {
+            gatherFlush();
+            return;
+        }
+
         if (bufferFill == 0)
             return;
 
@@ -349,7 +586,94 @@ namespace OpenLogReplicator {
         bufferFill = 0;
     }
 
+    void WriterFile::gatherFlush() {
+        uint64_t pos = 0;
+        while (pos < iov.size()) {
+            const int count = static_cast<int>(std::min<uint64_t>(iov.size() - pos, IOV_MAX));
+            contextSet(CONTEXT::OS, REASON::OS);
+            const int64_t bytesWritten = writev(outputDes, iov.data() + pos, count);
+            contextSet(CONTEXT::CPU);
+            if (bytesWritten <= 0)
+                throw RuntimeException(
+                    10007, "file: " + fullFileName + " - " + std::to_string(bytesWritten) + " bytes written instead of " +
+                           std::to_string(iovSize) + ", code returned: " + strerror(errno));
+
+            // Skip the fully written entries, continue a partial write from the middle of an entry
+            auto left = static_cast<uint64_t>(bytesWritten);
+            iovSize -= left;
+            writtenBytes += left;
+            while (left > 0 && left >= iov[pos].iov_len)
+                left -= iov[pos++].iov_len;
+            if (left > 0) {
+                iov[pos].iov_base = reinterpret_cast<uint8_t*>(iov[pos].iov_base) + left;
+                iov[pos].iov_len -= left;
+            }
+        }
+        iov.clear();
+        iovSize = 0;
+        bufferFill = 0;
+        if (syncer != nullptr)
+            syncer->written(writtenBytes);
+
+        for (BuilderMsg* msg: iovMessages)
+            releaseMessage(msg);
+        iovMessages.clear();
+    }
+
+    void WriterFile::gatherWrite(const uint8_t *data, uint64_t size) {
+        if (size == 0)
+            return;
+
+        iov.push_back({const_cast<uint8_t*>(data), size});
+        iovSize += size;
+
+        if (iovSize > writeBufferFlushSize || iov.size() >= IOV_MAX)
+            gatherFlush();
+    }
+
     void WriterFile::unbufferedWrite(const uint8_t *data, uint64_t size) {
+        if (compression != COMPRESSION::NONE)
+            compressedWrite(data, size);
+        else
+            writeFile(data, size);
+        // Bytes reported as written must be in the file, the staged partial block included
+        if (directIo)
+            directWriteTail();
+
+        writtenBytes += size;
+        if (syncer != nullptr)
+            syncer->written(writtenBytes);
+    }
+
+    // Input larger than the write buffer is split, one frame for every chunk
+    void WriterFile::compressedWrite(const uint8_t *data, uint64_t size) {
+#ifdef LINK_LIBRARY_LZ4
+        LZ4F_preferences_t preferences{};
+        preferences.compressionLevel = compressionLevel;
+        while (size > 0) {
+            const uint64_t part = std::min<uint64_t>(size, Ctx::MEMORY_CHUNK_SIZE);
+            preferences.frameInfo.contentSize = part;
+            const size_t compressed = LZ4F_compressFrame_usingCDict(compressCtx, compressBuffer, compressBufferSize, data, part,
+                                                                    compressDict, &preferences);
+            if (LZ4F_isError(compressed))
+                throw RuntimeException(10076, "file: " + fullFileName + " - lz4 compression returned: " +
+                                              LZ4F_getErrorName(compressed));
+
+            writeFile(compressBuffer, compressed);
+            data += part;
+            size -= part;
+        }
+#else
+        writeFile(data, size);
+#endif /* LINK_LIBRARY_LZ4 */
+    }
+
+    void WriterFile::writeFile(const uint8_t *data, uint64_t size) {
+        if (directIo) {
+            directWrite(data, size);
+            return;
+        }
+
         contextSet(CONTEXT::OS, REASON::OS);
         const int64_t bytesWritten = write(outputDes, data, size);
         contextSet(CONTEXT::CPU);
@@ -359,10 +683,73 @@ namespace OpenLogReplicator {
                        std::to_string(size) + ", code returned: " + strerror(errno));
     }
 
+    // Whole blocks leave the staging buffer, the partial last block is moved to its start
+    void WriterFile::directWrite(const uint8_t* data, uint64_t size) {
+        while (size > 0) {
+            const uint64_t part = std::min<uint64_t>(size, Ctx::MEMORY_CHUNK_SIZE - directFill);
+            memcpy(directBuffer + directFill, data, part);
+            directFill += part;
+            data += part;
+            size -= part;
+
+            const uint64_t blocks = directFill & ~(DIRECT_IO_ALIGNMENT - 1);
+            if (blocks == 0)
+                continue;
+            directWriteAt(directBuffer, blocks, directOffset);
+            directOffset += blocks;
+            directFill -= blocks;
+            if (directFill > 0)
+                memmove(directBuffer, directBuffer + blocks, directFill);
+        }
+    }
+
+    // The block stays staged and is written again once filled, the padding is cut off and the preallocation restored
+    void WriterFile::directWriteTail() {
+        if (directFill == 0)
+            return;
+
+        const uint64_t padded = (directFill + DIRECT_IO_ALIGNMENT - 1) & ~(DIRECT_IO_ALIGNMENT - 1);
+        memset(directBuffer + directFill, 0, padded - directFill);
+        directWriteAt(directBuffer, padded, directOffset);
+
+        contextSet(CONTEXT::OS, REASON::OS);
+        const int truncateRet = ftruncate(outputDes, static_cast<off_t>(directOffset + directFill));
+        contextSet(CONTEXT::CPU);
+        if (truncateRet != 0)
+            throw RuntimeException(10011, "file: " + fullFileName + " - truncate returned: " + strerror(errno));
+
+        if (preallocate)
+            preallocateFile();
+    }
+
+    void WriterFile::directWriteAt(const uint8_t* data, uint64_t size, uint64_t offset) {
+        contextSet(CONTEXT::OS, REASON::OS);
+        const int64_t bytesWritten = pwrite(outputDes, data, size, static_cast<off_t>(offset));
+        contextSet(CONTEXT::CPU);
+        if (bytesWritten <= 0 || static_cast<uint64_t>(bytesWritten) != size)
+            throw RuntimeException(
+                10007, "file: " + fullFileName + " - " + std::to_string(bytesWritten) + " bytes written instead of " +
+                       std::to_string(size) + ", code returned: " + strerror(errno));
+    }
+
     void WriterFile::bufferedWrite(const uint8_t *data, uint64_t size) {
         if (bufferFill + size > Ctx::MEMORY_CHUNK_SIZE)
             flush();
 
+        // Data not owned by the builder queue is copied to the buffer and gathered from there
+        if (zeroCopy) {
+            if (size > Ctx::MEMORY_CHUNK_SIZE) {
+                flush();
+                unbufferedWrite(data, size);
+                return;
+            }
+            uint8_t* copy = buffer + bufferFill;
+            memcpy(copy, data, size);
+            bufferFill += size;
+            gatherWrite(copy, size);
+            return;
+        }
+
         if (size > Ctx::MEMORY_CHUNK_SIZE) {
             unbufferedWrite(data, size);
             return;
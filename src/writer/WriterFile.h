@@ -20,13 +20,30 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #ifndef WRITER_FILE_H_
 #define WRITER_FILE_H_
 
+#include <deque>
+#include <sys/uio.h>
+#include <vector>
+
 #include "Writer.h"
 
+struct LZ4F_cctx_s;
+struct LZ4F_CDict_s;
+
 namespace OpenLogReplicator {
+    class FileSyncer;
+
     class WriterFile : public Writer {
+    public:
+        enum class COMPRESSION : unsigned char {
+            NONE, LZ4
+        };
+
     protected:
+        // LZ4 uses at most the last 64 KB of the dictionary
+        static constexpr uint64_t COMPRESSION_DICTIONARY_MAX_SIZE{65536};
+
         enum class MODE : unsigned char {
-            STDOUT, NO_ROTATE, NUM, TIMESTAMP, SEQUENCE
+            STDOUT, NO_ROTATE, NUM, TIMESTAMP, SEQUENCE, PARTITION
         };
 
         size_t prefixPos{0};
@@ -50,6 +67,39 @@ namespace OpenLogReplicator {
         uint8_t *buffer{nullptr};
         uint bufferFill{0};
         uint writeBufferFlushSize;
+        // Zero-copy mode: the output is gathered as iovec entries pointing into the builder queue and written with
+        // writev(), messages are confirmed only after the write completes
+        bool zeroCopy;
+        std::vector<iovec> iov;
+        std::vector<BuilderMsg*> iovMessages;
+        // Tag bytes not yet skipped of the message sent in parts
+        uint64_t fragmentTagLeft{0};
+        uint64_t iovSize{0};
+        // Group commit mode: the file is synced by a background thread, messages are confirmed once their bytes are
+        // durable, writtenBytes and message end offsets count all bytes written since start
+        uint64_t fsyncIntervalUs;
+        uint64_t fsyncSize;
+        FileSyncer* syncer{nullptr};
+        uint64_t writtenBytes{0};
+        std::deque<std::pair<uint64_t, BuilderMsg*>> unsyncedMessages;
+        // Every flush is compressed as a separate frame, so a file cut at any flush is still readable
+        COMPRESSION compression{COMPRESSION::NONE};
+        int compressionLevel{0};
+        std::string compressionDictionaryFile;
+        std::string compressionDictionary;
+        uint8_t* compressBuffer{nullptr};
+        uint64_t compressBufferSize{0};
+        LZ4F_cctx_s* compressCtx{nullptr};
+        LZ4F_CDict_s* compressDict{nullptr};
+        // Every output file is preallocated to 'max-file-size' when opened, the unused part is released on close
+        bool preallocate{false};
+        // O_DIRECT output keeps the files out of the page cache, the bytes are staged in an aligned buffer and
+        // written in whole blocks, the partial last block is written padded and the file cut back to its end
+        bool directIo{false};
+        uint8_t* directBuffer{nullptr};
+        uint64_t directOffset{0};
+        uint64_t directFill{0};
+        static constexpr uint64_t DIRECT_IO_ALIGNMENT{Ctx::MEMORY_ALIGNMENT};
 
         void closeFile();
 
@@ -57,18 +107,37 @@ namespace OpenLogReplicator {
 
         void checkFile(Scn scn, Seq sequence, uint64_t size);
         void sendMessage(BuilderMsg* msg) override;
+        [[nodiscard]] bool isFragmentSupported() const override {
+            return true;
+        }
+        void sendMessageFragment(BuilderMsg* msg, const uint8_t* data, uint64_t size, bool first, bool last) override;
         std::string getType() const override;
         void pollQueue() override;
         void unbufferedWrite(const uint8_t* data, uint64_t size);
+        void writeFile(const uint8_t* data, uint64_t size);
+        void compressedWrite(const uint8_t* data, uint64_t size);
+        void directWrite(const uint8_t* data, uint64_t size);
+        void directWriteTail();
+        void directWriteAt(const uint8_t* data, uint64_t size, uint64_t offset);
+        void preallocateFile();
+        [[nodiscard]] uint64_t fileEnd() const;
+        void initializeCompression();
         void bufferedWrite(const uint8_t* data, uint64_t size);
+        void gatherWrite(const uint8_t* data, uint64_t size);
+        void gatherFlush();
+        void releaseMessage(BuilderMsg* msg);
+        void confirmSynced();
 
     public:
         WriterFile(Ctx* newCtx, std::string newAlias, std::string newDatabase, Builder* newBuilder, Metadata* newMetadata, std::string newOutput,
-                   std::string newTimestampFormat, uint64_t newMaxFileSize, uint64_t newNewLine, uint64_t newAppend, uint newWiteBufferFlushSize);
+                   std::string newTimestampFormat, uint64_t newMaxFileSize, uint64_t newNewLine, uint64_t newAppend, uint newWiteBufferFlushSize,
+                   bool newZeroCopy, uint64_t newFsyncIntervalUs, uint64_t newFsyncSize);
         ~WriterFile() override;
 
         void initialize() override;
         void flush() override;
+        void setCompression(COMPRESSION newCompression, int newCompressionLevel, std::string newCompressionDictionaryFile);
+        void setFileIo(bool newPreallocate, bool newDirectIo);
     };
 }
 
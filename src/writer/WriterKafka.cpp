@@ -17,10 +17,14 @@ You should have received a copy of the GNU General Public License
 along with OpenLogReplicator; see the file LICENSE;  If not see
 <http://www.gnu.org/licenses/>.  */
 
+#include <string_view>
+
 #include "../builder/Builder.h"
 #include "../common/exception/ConfigurationException.h"
 #include "../common/exception/RuntimeException.h"
+#include "../common/DbTable.h"
 #include "../metadata/Metadata.h"
+#include "../metadata/Schema.h"
 #include "WriterKafka.h"
 
 namespace OpenLogReplicator {
@@ -34,14 +38,19 @@ namespace OpenLogReplicator {
         if (conf != nullptr)
             rd_kafka_conf_destroy(conf);
 
-        if (rkt != nullptr)
-            rd_kafka_topic_destroy(rkt);
-
-        const rd_kafka_resp_err_t err = rd_kafka_fatal_error(rk, nullptr, 0);
-        if (rk != nullptr)
-            rd_kafka_destroy(rk);
+        for (Producer& producer: producers) {
+            for (rd_kafka_topic_t* handle: producer.topics)
+                rd_kafka_topic_destroy(handle);
+            producer.topics.clear();
 
-        ctx->info(0, "Kafka producer exit code: " + std::to_string(err));
+            const rd_kafka_resp_err_t err = rd_kafka_fatal_error(producer.rk, nullptr, 0);
+            rd_kafka_destroy(producer.rk);
+            ctx->info(0, "Kafka producer exit code: " + std::to_string(err));
+        }
+        producers.clear();
+        objRoutes.clear();
+        checkpointRkt = nullptr;
+        rk = nullptr;
     }
 
     void WriterKafka::addProperty(std::string key, std::string value) {
@@ -50,6 +59,33 @@ namespace OpenLogReplicator {
         properties.insert_or_assign(std::move(key), std::move(value));
     }
 
+    void WriterKafka::addTableTopic(std::string table, std::string tableTopic) {
+        if (tableTopics.find(table) != tableTopics.end())
+            throw ConfigurationException(30009, "Kafka topic for table '" + table + "' is defined multiple times");
+        tableTopics.insert_or_assign(std::move(table), std::move(tableTopic));
+    }
+
+    void WriterKafka::setPartitionByTable(bool newPartitionByTable) {
+        partitionByTable = newPartitionByTable;
+    }
+
+    void WriterKafka::setRecordHeaders(bool newRecordHeaders) {
+        recordHeaders = newRecordHeaders;
+    }
+
+    void WriterKafka::setPollMessages(uint64_t newPollMessages) {
+        pollMessages = newPollMessages;
+    }
+
+    void WriterKafka::setProducers(uint64_t newProducerCount) {
+        producerCount = newProducerCount;
+    }
+
+    void WriterKafka::setTransaction(uint64_t newTransactionMessages, std::string newCheckpointTopic) {
+        transactionMessages = newTransactionMessages;
+        checkpointTopic = std::move(newCheckpointTopic);
+    }
+
     void WriterKafka::initialize() {
         Writer::initialize();
 
@@ -78,25 +114,248 @@ namespace OpenLogReplicator {
         rd_kafka_conf_set_error_cb(conf, error_cb);
         rd_kafka_conf_set_log_cb(conf, logger_cb);
 
-        rk = rd_kafka_new(RD_KAFKA_PRODUCER, conf, errStr, sizeof(errStr));
-        if (rk == nullptr)
-            throw RuntimeException(10060, "Kafka failed to create producer, message: " + std::string(errStr));
-        conf = nullptr;
+        if (producerCount > 1 && properties.find("transactional.id") != properties.end())
+            throw ConfigurationException(30010, "Kafka property 'transactional.id' is defined, but it requires a single producer");
+
+        producers.reserve(producerCount);
+        for (uint64_t i = 0; i < producerCount; ++i) {
+            // The configuration is consumed by rd_kafka_new, the last producer takes the original
+            rd_kafka_conf_t* producerConf = conf;
+            if (i + 1 < producerCount) {
+                producerConf = rd_kafka_conf_dup(conf);
+                if (producerConf == nullptr)
+                    throw RuntimeException(10058, "Kafka failed to create configuration");
+            }
 
-        rkt = rd_kafka_topic_new(rk, topic.c_str(), nullptr);
+            rd_kafka_t* producerRk = rd_kafka_new(RD_KAFKA_PRODUCER, producerConf, errStr, sizeof(errStr));
+            if (producerRk == nullptr) {
+                if (producerConf != conf)
+                    rd_kafka_conf_destroy(producerConf);
+                throw RuntimeException(10060, "Kafka failed to create producer, message: " + std::string(errStr));
+            }
+            if (producerConf == conf)
+                conf = nullptr;
+            producers.push_back(Producer{producerRk, {}});
+        }
+        rk = producers.front().rk;
+
+        getTopic(topic);
+        if (producerCount > 1)
+            ctx->info(0, "Kafka writer with " + std::to_string(producerCount) + " producers");
+
+        if (properties.find("transactional.id") != properties.end()) {
+            transactional = true;
+            checkTransactionError(rd_kafka_init_transactions(rk, TRANSACTION_TIMEOUT_MS), "init transactions");
+            if (!checkpointTopic.empty())
+                checkpointRkt = producers.front().topics[getTopic(checkpointTopic)];
+            transactionSent.reserve(ctx->queueSize);
+            ctx->info(0, "Kafka transactional producer, up to " + std::to_string(transactionMessages) +
+                         " messages per transaction");
+        } else if (!checkpointTopic.empty())
+            throw ConfigurationException(30010, "Kafka checkpoint topic requires property 'transactional.id' to be set");
+        delivered.reserve(ctx->queueSize);
         streaming = true;
     }
 
+    void WriterKafka::checkTransactionError(rd_kafka_error_t* error, const std::string& operation) {
+        if (error == nullptr)
+            return;
+
+        const std::string errorStr(rd_kafka_error_string(error));
+        rd_kafka_error_destroy(error);
+        throw RuntimeException(10079, "Kafka: " + operation + " failed: " + errorStr);
+    }
+
+    void WriterKafka::beginTransaction() {
+        checkTransactionError(rd_kafka_begin_transaction(rk), "begin transaction");
+        transactionOpen = true;
+        transactionCount = 0;
+    }
+
+    // The checkpoint marker is committed atomically with the data, a read_committed consumer finds the replay
+    // position in it, messages are confirmed only after the commit succeeds
+    void WriterKafka::commitTransaction() {
+        if (!transactionOpen)
+            return;
+
+        if (checkpointRkt != nullptr) {
+            const std::string marker = R"({"database":")" + database + R"(","c_scn":)" + transactionLastScn.toString() +
+                                       R"(,"c_idx":)" + std::to_string(transactionLastIdx) + "}";
+            const rd_kafka_resp_err_t err = rd_kafka_producev(rk,
+                                    RD_KAFKA_VTYPE_RKT, checkpointRkt,
+                                    RD_KAFKA_VTYPE_MSGFLAGS, RD_KAFKA_MSG_F_COPY,
+                                    RD_KAFKA_VTYPE_VALUE, marker.c_str(), marker.length(),
+                                    RD_KAFKA_VTYPE_END);
+            if (err != 0)
+                throw RuntimeException(10079, "Kafka: checkpoint marker to topic " + checkpointTopic + " failed: " +
+                                              rd_kafka_err2str(err));
+        }
+
+        contextSet(CONTEXT::WAIT, REASON::WRITER_NO_WORK);
+        rd_kafka_error_t* error = rd_kafka_commit_transaction(rk, TRANSACTION_TIMEOUT_MS);
+        while (error != nullptr && rd_kafka_error_is_retriable(error) != 0 && !ctx->hardShutdown) {
+            rd_kafka_error_destroy(error);
+            error = rd_kafka_commit_transaction(rk, TRANSACTION_TIMEOUT_MS);
+        }
+        contextSet(CONTEXT::CPU);
+
+        if (error != nullptr && rd_kafka_error_txn_requires_abort(error) != 0) {
+            ctx->warning(60068, "Kafka: commit transaction failed: " + std::string(rd_kafka_error_string(error)) + ", aborting and sending " +
+                                std::to_string(transactionSent.size()) + " messages again");
+            rd_kafka_error_destroy(error);
+            abortTransaction();
+            return;
+        }
+        checkTransactionError(error, "commit transaction");
+        transactionOpen = false;
+        unpolledMessages = 0;
+
+        confirmMessages(transactionSent.data(), transactionSent.size());
+        transactionSent.clear();
+    }
+
+    // The messages of the aborted transaction are still held by the queue, they are produced again in a new transaction
+    void WriterKafka::abortTransaction() {
+        contextSet(CONTEXT::WAIT, REASON::WRITER_NO_WORK);
+        rd_kafka_error_t* error = rd_kafka_abort_transaction(rk, TRANSACTION_TIMEOUT_MS);
+        contextSet(CONTEXT::CPU);
+        checkTransactionError(error, "abort transaction");
+        transactionOpen = false;
+        unpolledMessages = 0;
+
+        std::vector<BuilderMsg*> messages;
+        messages.swap(transactionSent);
+        transactionSent.reserve(ctx->queueSize);
+        beginTransaction();
+        for (BuilderMsg* msg: messages) {
+            if (!produce(msg))
+                continue;
+            transactionSent.push_back(msg);
+            ++transactionCount;
+        }
+    }
+
+    // Every producer gets a handle of every topic, the id is the same for all of them
+    uint64_t WriterKafka::getTopic(const std::string& name) {
+        const auto& it = topicIds.find(name);
+        if (it != topicIds.end())
+            return it->second;
+
+        const uint64_t topicId = topicNames.size();
+        for (Producer& producer: producers) {
+            rd_kafka_topic_t* handle = rd_kafka_topic_new(producer.rk, name.c_str(), nullptr);
+            if (handle == nullptr)
+                throw RuntimeException(10060, "Kafka failed to create topic: " + name + ", message: " +
+                                              rd_kafka_err2str(rd_kafka_last_error()));
+            producer.topics.push_back(handle);
+        }
+        topicNames.push_back(name);
+        topicIds.insert_or_assign(name, topicId);
+        return topicId;
+    }
+
+    // Messages of one key, or of one table when there is no key, stay on one producer and keep their order.
+    // A keyed message is routed by the hash of the raw key values computed by the builder, the rendered key is not hashed again.
+    // Messages not bound to any table go to the first producer
+    WriterKafka::Producer& WriterKafka::selectProducer(const BuilderMsg* msg) {
+        if (producers.size() == 1)
+            return producers.front();
+
+        uint64_t hash;
+        if (msg->tagSize > 0)
+            hash = msg->tagHash;
+        else if (msg->obj != 0)
+            hash = std::hash<typeObj>{}(msg->obj);
+        else
+            return producers.front();
+        return producers[hash % producers.size()];
+    }
+
+    // Messages of tables with no topic of their own, and messages not bound to one table, go to the default topic.
+    // The table name is looked up once per object, and only when topic routing or record headers need it
+    const WriterKafka::ObjRoute* WriterKafka::resolveObj(typeObj obj) {
+        if ((tableTopics.empty() && !recordHeaders) || obj == 0)
+            return nullptr;
+
+        checkObjCaches();
+        const auto& it = objRoutes.find(obj);
+        if (it != objRoutes.end())
+            return &it->second;
+
+        ObjRoute route{TOPIC_DEFAULT, "", ""};
+        {
+            contextSet(CONTEXT::MUTEX, REASON::WRITER_SCHEMA);
+            std::unique_lock<std::mutex> const lck(metadata->mtxSchema);
+            const DbTable* table = metadata->schema->checkTableDict(obj);
+            if (table != nullptr) {
+                route.owner = table->owner;
+                route.table = table->name;
+            }
+        }
+        contextSet(CONTEXT::CPU);
+
+        const auto& topicIt = tableTopics.find(route.owner + "." + route.table);
+        if (topicIt != tableTopics.end())
+            route.topic = getTopic(topicIt->second);
+        return &objRoutes.insert_or_assign(obj, std::move(route)).first->second;
+    }
+
+    void WriterKafka::dropObjCaches() {
+        Writer::dropObjCaches();
+        objRoutes.clear();
+    }
+
+    rd_kafka_headers_t* WriterKafka::createHeaders(const BuilderMsg* msg, const ObjRoute* route) const {
+        rd_kafka_headers_t* headers = rd_kafka_headers_new(6);
+        const std::string scn(msg->scn.toString());
+        rd_kafka_header_add(headers, "scn", -1, scn.c_str(), static_cast<ssize_t>(scn.length()));
+        if (msg->op != BuilderMsg::OP::NONE) {
+            // Checkpoint messages carry no transaction
+            const std::string xid(msg->xid.toString());
+            rd_kafka_header_add(headers, "xid", -1, xid.c_str(), static_cast<ssize_t>(xid.length()));
+            rd_kafka_header_add(headers, "op", -1, BuilderMsg::opName(msg->op), -1);
+        }
+        if (route != nullptr && !route->table.empty()) {
+            rd_kafka_header_add(headers, "owner", -1, route->owner.c_str(), static_cast<ssize_t>(route->owner.length()));
+            rd_kafka_header_add(headers, "table", -1, route->table.c_str(), static_cast<ssize_t>(route->table.length()));
+        }
+        return headers;
+    }
+
     void WriterKafka::dr_msg_cb(rd_kafka_t* rkCb __attribute__((unused)), const rd_kafka_message_t* rkMessage, void* opaque __attribute__((unused))) {
         auto* msg = reinterpret_cast<BuilderMsg*>(rkMessage->_private);
-        auto* writer = reinterpret_cast<Writer*>(opaque);
+        auto* writer = reinterpret_cast<WriterKafka*>(opaque);
+        // Checkpoint marker
+        if (msg == nullptr)
+            return;
+
         if (rkMessage->err != 0) {
             writer->ctx->warning(70008, "Kafka: " + std::to_string(msg->id) + " delivery failed: " + rd_kafka_err2str(rkMessage->err));
-        } else {
-            writer->confirmMessage(msg);
+        } else if (!writer->transactional) {
+            writer->delivered.push_back(msg);
         }
     }
 
+    void WriterKafka::poll(const Producer& producer, int timeoutMs) {
+        rd_kafka_poll(producer.rk, timeoutMs);
+        confirmDelivered();
+    }
+
+    void WriterKafka::pollAll() {
+        for (const Producer& producer: producers)
+            rd_kafka_poll(producer.rk, 0);
+        confirmDelivered();
+        unpolledMessages = 0;
+    }
+
+    void WriterKafka::confirmDelivered() {
+        if (delivered.empty())
+            return;
+
+        confirmMessages(delivered.data(), delivered.size());
+        delivered.clear();
+    }
+
     void WriterKafka::error_cb(rd_kafka_t* rkCb, int err, const char* reason, void* opaque) {
         auto* writer = reinterpret_cast<Writer*>(opaque);
 
@@ -122,35 +381,85 @@ namespace OpenLogReplicator {
 
     void WriterKafka::sendMessage(BuilderMsg* msg) {
         msg->ptr = reinterpret_cast<void*>(this);
-        for (;;) {
-            rd_kafka_resp_err_t err;
-            if (msg->tagSize > 0)
-                err = rd_kafka_producev(rk,
-                                        RD_KAFKA_VTYPE_TOPIC, topic.c_str(),
-                                        RD_KAFKA_VTYPE_KEY, reinterpret_cast<void*>(msg->data), static_cast<size_t>(msg->tagSize),
-                                        RD_KAFKA_VTYPE_VALUE, reinterpret_cast<void*>(msg->data + msg->tagSize), static_cast<size_t>(msg->size - msg->tagSize),
-                                        RD_KAFKA_VTYPE_OPAQUE, reinterpret_cast<void*>(msg),
-                                        RD_KAFKA_VTYPE_END);
-            else
-                err = rd_kafka_producev(rk,
-                                        RD_KAFKA_VTYPE_TOPIC, topic.c_str(),
-                                        RD_KAFKA_VTYPE_VALUE, reinterpret_cast<void*>(msg->data), static_cast<size_t>(msg->size),
-                                        RD_KAFKA_VTYPE_OPAQUE, reinterpret_cast<void*>(msg),
-                                        RD_KAFKA_VTYPE_END);
-
-            if (err != 0) {
-                ctx->warning(60031, "failed to produce to topic " + topic + ", message: " + rd_kafka_err2str(err));
-
-                if (err == RD_KAFKA_RESP_ERR__QUEUE_FULL) {
-                    ctx->warning(60031, "queue, full, sleeping " + std::to_string(ctx->pollIntervalUs / 1000) + " ms, then retrying");
-                    rd_kafka_poll(rk, static_cast<int>((ctx->pollIntervalUs / 1000)));
-                    continue;
+
+        // All messages of a database transaction are built at its commit LWN, a Kafka transaction ends only between LWNs
+        if (transactional) {
+            if (transactionOpen && transactionCount >= transactionMessages && msg->lwnScn != transactionLastScn)
+                commitTransaction();
+            if (!transactionOpen)
+                beginTransaction();
+        }
+
+        if (produce(msg) && transactional) {
+            transactionSent.push_back(msg);
+            ++transactionCount;
+            transactionLastScn = msg->lwnScn;
+            transactionLastIdx = msg->lwnIdx;
+        }
+
+        if (++unpolledMessages >= pollMessages)
+            pollAll();
+    }
+
+    // Returns false when the message was not accepted by the producer
+    bool WriterKafka::produce(BuilderMsg* msg) {
+        const ObjRoute* route = resolveObj(msg->obj);
+        const uint64_t topicId = route != nullptr ? route->topic : TOPIC_DEFAULT;
+
+        // Without a key tag the object id keeps every table on one partition, in order
+        const void* key = nullptr;
+        size_t keySize = 0;
+        if (msg->tagSize > 0) {
+            key = msg->data;
+            keySize = msg->tagSize;
+        } else if (partitionByTable && msg->obj != 0) {
+            key = &msg->obj;
+            keySize = sizeof(msg->obj);
+        }
+
+        // Owned by librdkafka once the message is accepted, kept for a retry when the queue is full
+        rd_kafka_headers_t* headers = nullptr;
+        if (recordHeaders)
+            headers = createHeaders(msg, route);
+
+        Producer& producer = selectProducer(msg);
+        rd_kafka_topic_t* msgTopic = producer.topics[topicId];
+        bool queueFull = false;
+        bool produced = false;
+        while (!ctx->hardShutdown) {
+            const rd_kafka_resp_err_t err = rd_kafka_producev(producer.rk,
+                                    RD_KAFKA_VTYPE_RKT, msgTopic,
+                                    RD_KAFKA_VTYPE_KEY, key, keySize,
+                                    RD_KAFKA_VTYPE_VALUE, reinterpret_cast<void*>(msg->data + msg->tagSize), static_cast<size_t>(msg->size - msg->tagSize),
+                                    RD_KAFKA_VTYPE_HEADERS, headers,
+                                    RD_KAFKA_VTYPE_OPAQUE, reinterpret_cast<void*>(msg),
+                                    RD_KAFKA_VTYPE_END);
+
+            if (err == RD_KAFKA_RESP_ERR__QUEUE_FULL) {
+                // Block until delivery reports free some space in the producer queue
+                if (!queueFull) {
+                    if (unlikely(ctx->isTraceSet(Ctx::TRACE::WRITER)))
+                        ctx->logTrace(Ctx::TRACE::WRITER, "Kafka producer queue full, waiting for delivery reports");
+                    queueFull = true;
                 }
+                contextSet(CONTEXT::WAIT, REASON::WRITER_NO_WORK);
+                poll(producer, static_cast<int>(ctx->pollIntervalUs / 1000) + 1);
+                contextSet(CONTEXT::CPU);
+                continue;
+            }
+
+            if (err != 0)
+                ctx->warning(60031, "failed to produce to topic " + std::string(rd_kafka_topic_name(msgTopic)) +
+                                    ", message: " + rd_kafka_err2str(err));
+            else {
+                headers = nullptr;
+                produced = true;
             }
             break;
         }
-
-        rd_kafka_poll(rk, 0);
+        if (headers != nullptr)
+            rd_kafka_headers_destroy(headers);
+        return produced;
     }
 
     std::string WriterKafka::getType() const {
@@ -162,6 +471,10 @@ namespace OpenLogReplicator {
             metadata->setStatusStart(this);
 
         if (currentQueueSize > 0)
-            rd_kafka_poll(rk, 0);
+            pollAll();
+
+        // An open transaction holds its messages unconfirmed, close it when idle or when the output queue is full
+        if (transactionOpen && (currentQueueSize >= ctx->queueSize || isCaughtUp()))
+            commitTransaction();
     }
 }
@@ -23,6 +23,8 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include <librdkafka/rdkafka.h>
 
 #include <map>
+#include <unordered_map>
+#include <vector>
 #include "Writer.h"
 
 namespace OpenLogReplicator {
@@ -31,9 +33,62 @@ namespace OpenLogReplicator {
         std::string topic;
         char errStr[512]{};
         std::map<std::string, std::string> properties;
+        // Independent producer instances, each with its own queue and broker threads, so that serialization and
+        // compression of large messages run in parallel. A message key always goes to the same producer
+        struct Producer {
+            rd_kafka_t* rk;
+            // Handles in the order of topicNames
+            std::vector<rd_kafka_topic_t*> topics;
+        };
+        std::vector<Producer> producers;
+        uint64_t producerCount{1};
+        // First producer, the only one in transactional mode
         rd_kafka_t* rk{nullptr};
-        rd_kafka_topic_t* rkt{nullptr};
         rd_kafka_conf_t* conf{nullptr};
+        // Routing of table messages to their own topics, keyed by "OWNER.TABLE", resolved once per object
+        std::unordered_map<std::string, std::string> tableTopics;
+        std::vector<std::string> topicNames;
+        std::unordered_map<std::string, uint64_t> topicIds;
+        struct ObjRoute {
+            uint64_t topic;
+            std::string owner;
+            std::string table;
+        };
+        std::unordered_map<typeObj, ObjRoute> objRoutes;
+        bool partitionByTable{false};
+        // Routing metadata copied to record headers, so that consumers route without parsing the payload
+        bool recordHeaders{false};
+        uint64_t pollMessages{1};
+        uint64_t unpolledMessages{0};
+        // Transactional mode, enabled by the "transactional.id" property: messages are confirmed once the Kafka
+        // transaction holding them commits, a transaction is closed only between database transactions
+        bool transactional{false};
+        bool transactionOpen{false};
+        uint64_t transactionMessages{1000};
+        uint64_t transactionCount{0};
+        Scn transactionLastScn{Scn::none()};
+        typeIdx transactionLastIdx{0};
+        std::string checkpointTopic;
+        rd_kafka_topic_t* checkpointRkt{nullptr};
+        static constexpr uint64_t TOPIC_DEFAULT = 0;
+        // Messages of the open transaction, confirmed once it commits
+        std::vector<BuilderMsg*> transactionSent;
+        // Delivery reports collected by the callback during one poll, confirmed in a single step after it
+        std::vector<BuilderMsg*> delivered;
+
+        uint64_t getTopic(const std::string& name);
+        [[nodiscard]] Producer& selectProducer(const BuilderMsg* msg);
+        const ObjRoute* resolveObj(typeObj obj);
+        void dropObjCaches() override;
+        rd_kafka_headers_t* createHeaders(const BuilderMsg* msg, const ObjRoute* route) const;
+        void beginTransaction();
+        void commitTransaction();
+        void abortTransaction();
+        bool produce(BuilderMsg* msg);
+        void poll(const Producer& producer, int timeoutMs);
+        void pollAll();
+        void confirmDelivered();
+        void checkTransactionError(rd_kafka_error_t* error, const std::string& operation);
         static void dr_msg_cb(rd_kafka_t* rkCb, const rd_kafka_message_t* rkMessage, void* opaque);
         static void error_cb(rd_kafka_t* rkCb, int err, const char* reason, void* opaque);
         static void logger_cb(const rd_kafka_t* rkCb, int level, const char* fac, const char* buf);
@@ -44,11 +99,19 @@ namespace OpenLogReplicator {
 
     public:
         static constexpr uint64_t MAX_KAFKA_MESSAGE_MB = 953;
+        static constexpr int TRANSACTION_TIMEOUT_MS = 60000;
+        static constexpr uint64_t MAX_PRODUCERS = 64;
 
         WriterKafka(Ctx* newCtx, std::string newAlias, std::string newDatabase, Builder* newBuilder, Metadata* newMetadata, std::string newTopic);
         ~WriterKafka() override;
 
         void addProperty(std::string key, std::string value);
+        void addTableTopic(std::string table, std::string tableTopic);
+        void setPartitionByTable(bool newPartitionByTable);
+        void setRecordHeaders(bool newRecordHeaders);
+        void setPollMessages(uint64_t newPollMessages);
+        void setProducers(uint64_t newProducerCount);
+        void setTransaction(uint64_t newTransactionMessages, std::string newCheckpointTopic);
         void initialize() override;
     };
 }
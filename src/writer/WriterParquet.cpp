@@ -0,0 +1,516 @@
+/* Thread writing to Parquet or Arrow IPC files
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+#include <sys/stat.h>
+#include <parquet/properties.h>
+
+#include "../builder/Builder.h"
+#include "../common/DbColumn.h"
+#include "../common/DbTable.h"
+#include "../common/exception/ConfigurationException.h"
+#include "../common/exception/RuntimeException.h"
+#include "../metadata/Metadata.h"
+#include "../metadata/Schema.h"
+#include "WriterParquet.h"
+
+namespace OpenLogReplicator {
+    WriterParquet::WriterParquet(Ctx* newCtx, std::string newAlias, std::string newDatabase, Builder* newBuilder, Metadata* newMetadata,
+                                 FILE_FORMAT newFileFormat, std::string newOutput, uint64_t newRowGroupRows, uint64_t newMaxFileSize,
+                                 uint64_t newMaxFileAgeS, arrow::Compression::type newCompression, Format::TIMESTAMP_FORMAT newTimestampFormat) :
+            Writer(newCtx, std::move(newAlias), std::move(newDatabase), newBuilder, newMetadata),
+            fileFormat(newFileFormat),
+            output(std::move(newOutput)),
+            rowGroupRows(newRowGroupRows),
+            maxFileSize(newMaxFileSize),
+            maxFileAgeS(newMaxFileAgeS),
+            compression(newCompression) {
+        switch (newTimestampFormat) {
+            case Format::TIMESTAMP_FORMAT::UNIX_NANO:
+            case Format::TIMESTAMP_FORMAT::UNIX_NANO_STRING:
+                timestampTyped = true;
+                timestampUnit = arrow::TimeUnit::NANO;
+                break;
+
+            case Format::TIMESTAMP_FORMAT::UNIX_MICRO:
+            case Format::TIMESTAMP_FORMAT::UNIX_MICRO_STRING:
+                timestampTyped = true;
+                timestampUnit = arrow::TimeUnit::MICRO;
+                break;
+
+            case Format::TIMESTAMP_FORMAT::UNIX_MILLI:
+            case Format::TIMESTAMP_FORMAT::UNIX_MILLI_STRING:
+                timestampTyped = true;
+                timestampUnit = arrow::TimeUnit::MILLI;
+                break;
+
+            case Format::TIMESTAMP_FORMAT::UNIX:
+            case Format::TIMESTAMP_FORMAT::UNIX_STRING:
+                timestampTyped = true;
+                timestampUnit = arrow::TimeUnit::SECOND;
+                break;
+
+            default:
+                timestampTyped = false;
+        }
+    }
+
+    WriterParquet::~WriterParquet() {
+        for (auto& [obj, tableFile]: tables)
+            delete tableFile;
+        tables.clear();
+    }
+
+    void WriterParquet::initialize() {
+        Writer::initialize();
+
+        if (output.find("%t") == std::string::npos || output.find("%s") == std::string::npos)
+            throw ConfigurationException(30005, "invalid value for 'output': " + output + " - expected to contain %t and %s");
+
+        streaming = true;
+    }
+
+    std::string WriterParquet::getType() const {
+        if (fileFormat == FILE_FORMAT::ARROW)
+            return "arrow:" + output;
+        return "parquet:" + output;
+    }
+
+    void WriterParquet::checkStatus(const arrow::Status& status, const std::string& fileName, const std::string& operation) const {
+        if (unlikely(!status.ok()))
+            throw RuntimeException(10090, "file: " + fileName + " - " + operation + " returned: " + status.ToString());
+    }
+
+    void WriterParquet::addColumn(TableFile* tableFile, const std::string& name, KIND kind, const std::shared_ptr<arrow::DataType>& type,
+                                  int32_t scale) {
+        auto builderResult = arrow::MakeBuilder(type);
+        checkStatus(builderResult.status(), tableFile->name, "column " + name + " builder creation");
+        tableFile->columnIndex.insert_or_assign(name, tableFile->columns.size());
+        tableFile->columns.push_back(ColumnBuffer{name, kind, scale, std::move(*builderResult), false});
+    }
+
+    WriterParquet::TableFile* WriterParquet::getTable(typeObj obj) {
+        const auto& it = tables.find(obj);
+        if (it != tables.end())
+            return it->second;
+
+        // Column list is copied, the schema may change while the rows are gathered
+        std::string tableName;
+        std::vector<std::pair<std::string, std::shared_ptr<arrow::DataType>>> types;
+        std::vector<std::pair<KIND, int32_t>> kinds;
+        {
+            contextSet(CONTEXT::MUTEX, REASON::WRITER_SCHEMA);
+            std::unique_lock<std::mutex> const lck(metadata->mtxSchema);
+            const DbTable* table = metadata->schema->checkTableDict(obj);
+            if (table != nullptr) {
+                tableName = table->owner + "." + table->name;
+                for (const DbColumn* column: table->columns) {
+                    if (column->guard || column->nested || column->unused || column->hidden)
+                        continue;
+
+                    KIND kind = KIND::STRING;
+                    std::shared_ptr<arrow::DataType> type = arrow::utf8();
+                    int32_t scale = 0;
+                    switch (column->type) {
+                        case SysCol::COLTYPE::NUMBER:
+                            // NUMBER without declared precision may hold any value, text keeps it exact
+                            if (column->precision > 0 && column->precision <= 18 && column->scale == 0) {
+                                kind = KIND::INT64;
+                                type = arrow::int64();
+                            } else if (column->precision > 0 && column->precision <= 38 && column->scale >= 0 && column->scale <= column->precision) {
+                                kind = KIND::DECIMAL;
+                                type = arrow::decimal128(column->precision, column->scale);
+                                scale = column->scale;
+                            }
+                            break;
+
+                        case SysCol::COLTYPE::FLOAT:
+                            kind = KIND::FLOAT;
+                            type = arrow::float32();
+                            break;
+
+                        case SysCol::COLTYPE::DOUBLE:
+                            kind = KIND::DOUBLE;
+                            type = arrow::float64();
+                            break;
+
+                        case SysCol::COLTYPE::BOOLEAN:
+                            kind = KIND::BOOLEAN;
+                            type = arrow::boolean();
+                            break;
+
+                        case SysCol::COLTYPE::DATE:
+                        case SysCol::COLTYPE::TIMESTAMP:
+                            if (timestampTyped) {
+                                kind = KIND::TIMESTAMP;
+                                type = arrow::timestamp(timestampUnit);
+                            }
+                            break;
+
+                        default:
+                            break;
+                    }
+                    types.emplace_back(column->name, type);
+                    kinds.emplace_back(kind, scale);
+                }
+            }
+        }
+        contextSet(CONTEXT::CPU);
+
+        if (tableName.empty()) {
+            ctx->warning(60049, "table obj: " + std::to_string(obj) + " - not found in schema, rows are not written");
+            tables.insert_or_assign(obj, nullptr);
+            return nullptr;
+        }
+
+        auto* tableFile = new TableFile();
+        tableFile->name = tableName;
+        std::vector<std::shared_ptr<arrow::Field>> fields;
+        fields.push_back(arrow::field("_op", arrow::utf8(), false));
+        addColumn(tableFile, "_op", KIND::STRING, arrow::utf8(), 0);
+        fields.push_back(arrow::field("_scn", arrow::int64(), false));
+        addColumn(tableFile, "_scn", KIND::INT64, arrow::int64(), 0);
+        for (uint64_t i = 0; i < types.size(); ++i) {
+            fields.push_back(arrow::field(types[i].first, types[i].second));
+            addColumn(tableFile, types[i].first, kinds[i].first, types[i].second, kinds[i].second);
+        }
+        tableFile->schema = arrow::schema(fields);
+        tables.insert_or_assign(obj, tableFile);
+        return tableFile;
+    }
+
+    // Numbers are parsed as text, so that the decimal values are read without rounding
+    void WriterParquet::appendValue(ColumnBuffer& column, const rapidjson::Value& value) {
+        arrow::Status status;
+        if (value.IsNull()) {
+            status = column.builder->AppendNull();
+        } else if (column.kind == KIND::STRING) {
+            if (value.IsString())
+                status = static_cast<arrow::StringBuilder*>(column.builder.get())->Append(std::string_view(value.GetString(), value.GetStringLength()));
+            else {
+                rapidjson::StringBuffer buffer;
+                rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+                value.Accept(writer);
+                status = static_cast<arrow::StringBuilder*>(column.builder.get())->Append(std::string_view(buffer.GetString(), buffer.GetSize()));
+            }
+        } else if (column.kind == KIND::BOOLEAN) {
+            if (value.IsBool())
+                status = static_cast<arrow::BooleanBuilder*>(column.builder.get())->Append(value.GetBool());
+            else
+                status = column.builder->AppendNull();
+        } else if (!value.IsString()) {
+            status = column.builder->AppendNull();
+        } else {
+            const char* text = value.GetString();
+            char* end = nullptr;
+            errno = 0;
+            switch (column.kind) {
+                case KIND::INT64: {
+                    const int64_t number = strtoll(text, &end, 10);
+                    if (end == text || *end != 0 || errno != 0)
+                        status = column.builder->AppendNull();
+                    else
+                        status = static_cast<arrow::Int64Builder*>(column.builder.get())->Append(number);
+                    break;
+                }
+
+                case KIND::TIMESTAMP: {
+                    const int64_t number = strtoll(text, &end, 10);
+                    if (end == text || *end != 0 || errno != 0)
+                        status = column.builder->AppendNull();
+                    else
+                        status = static_cast<arrow::TimestampBuilder*>(column.builder.get())->Append(number);
+                    break;
+                }
+
+                case KIND::DECIMAL: {
+                    arrow::Decimal128 decimal;
+                    int32_t precision;
+                    int32_t scale;
+                    if (!arrow::Decimal128::FromString(std::string_view(text, value.GetStringLength()), &decimal, &precision, &scale).ok()) {
+                        status = column.builder->AppendNull();
+                        break;
+                    }
+                    if (scale != column.scale) {
+                        auto rescaled = decimal.Rescale(scale, column.scale);
+                        if (!rescaled.ok()) {
+                            status = column.builder->AppendNull();
+                            break;
+                        }
+                        decimal = *rescaled;
+                    }
+                    status = static_cast<arrow::Decimal128Builder*>(column.builder.get())->Append(decimal);
+                    break;
+                }
+
+                case KIND::FLOAT: {
+                    const float number = strtof(text, &end);
+                    if (end == text)
+                        status = column.builder->AppendNull();
+                    else
+                        status = static_cast<arrow::FloatBuilder*>(column.builder.get())->Append(number);
+                    break;
+                }
+
+                case KIND::DOUBLE: {
+                    const double number = strtod(text, &end);
+                    if (end == text)
+                        status = column.builder->AppendNull();
+                    else
+                        status = static_cast<arrow::DoubleBuilder*>(column.builder.get())->Append(number);
+                    break;
+                }
+
+                default:
+                    status = column.builder->AppendNull();
+            }
+        }
+        checkStatus(status, column.name, "value append");
+        column.set = true;
+    }
+
+    void WriterParquet::appendRow(TableFile* tableFile, char op, Scn scn, const rapidjson::Value& values) {
+        if (tableFile->sink == nullptr)
+            openFile(tableFile, scn);
+
+        for (ColumnBuffer& column: tableFile->columns)
+            column.set = false;
+
+        checkStatus(static_cast<arrow::StringBuilder*>(tableFile->columns[COLUMN_OP].builder.get())->Append(std::string_view(&op, 1)),
+                    tableFile->name, "value append");
+        checkStatus(static_cast<arrow::Int64Builder*>(tableFile->columns[COLUMN_SCN].builder.get())->Append(static_cast<int64_t>(scn.getData())),
+                    tableFile->name, "value append");
+
+        if (values.IsObject()) {
+            for (rapidjson::Value::ConstMemberIterator it = values.MemberBegin(); it != values.MemberEnd(); ++it) {
+                const auto& columnIt = tableFile->columnIndex.find(std::string(it->name.GetString(), it->name.GetStringLength()));
+                if (columnIt == tableFile->columnIndex.end() || columnIt->second < COLUMN_FIRST)
+                    continue;
+                ColumnBuffer& column = tableFile->columns[columnIt->second];
+                if (!column.set)
+                    appendValue(column, it->value);
+            }
+        }
+
+        // Columns not present in the message, like not changed columns of an update
+        for (uint64_t i = COLUMN_FIRST; i < tableFile->columns.size(); ++i)
+            if (!tableFile->columns[i].set)
+                checkStatus(tableFile->columns[i].builder->AppendNull(), tableFile->name, "value append");
+        ++tableFile->rows;
+    }
+
+    void WriterParquet::appendPayload(TableFile* tableFile, Scn scn, const rapidjson::Value& payload, bool& ddl) {
+        if (payload.IsArray()) {
+            for (rapidjson::SizeType i = 0; i < payload.Size(); ++i)
+                appendPayload(tableFile, scn, payload[i], ddl);
+            return;
+        }
+        if (!payload.IsObject() || !payload.HasMember("op") || !payload["op"].IsString())
+            return;
+
+        const std::string op(payload["op"].GetString());
+        if (op == "ddl") {
+            ddl = true;
+            return;
+        }
+        if (tableFile == nullptr)
+            return;
+
+        static const rapidjson::Value empty;
+        if (op == "c")
+            appendRow(tableFile, 'c', scn, payload.HasMember("after") ? payload["after"] : empty);
+        else if (op == "u")
+            appendRow(tableFile, 'u', scn, payload.HasMember("after") ? payload["after"] : empty);
+        else if (op == "d")
+            appendRow(tableFile, 'd', scn, payload.HasMember("before") ? payload["before"] : empty);
+    }
+
+    void WriterParquet::openFile(TableFile* tableFile, Scn scn) {
+        std::string fileName;
+        for (uint64_t num = 0; ; ++num) {
+            fileName = output;
+            fileName.replace(fileName.find("%t"), 2, tableFile->name);
+            std::string scnStr = scn.toString();
+            if (num > 0)
+                scnStr += "_" + std::to_string(num);
+            fileName.replace(fileName.find("%s"), 2, scnStr);
+
+            // Rows sent again after a restart go to a new file, a closed file is never overwritten
+            struct stat fileStat{};
+            contextSet(CONTEXT::OS, REASON::OS);
+            const int statRet = stat(fileName.c_str(), &fileStat);
+            contextSet(CONTEXT::CPU);
+            if (statRet != 0)
+                break;
+        }
+
+        ctx->info(0, "opening output file: " + fileName);
+        contextSet(CONTEXT::OS, REASON::OS);
+        auto sinkResult = arrow::io::FileOutputStream::Open(fileName);
+        contextSet(CONTEXT::CPU);
+        checkStatus(sinkResult.status(), fileName, "open for writing");
+        tableFile->sink = *sinkResult;
+        tableFile->fileName = fileName;
+        tableFile->fileTime = time(nullptr);
+        tableFile->fileSize = 0;
+
+        if (fileFormat == FILE_FORMAT::PARQUET) {
+            const std::shared_ptr<parquet::WriterProperties> properties = parquet::WriterProperties::Builder().compression(compression)->build();
+            const std::shared_ptr<parquet::ArrowWriterProperties> arrowProperties = parquet::ArrowWriterProperties::Builder().store_schema()->build();
+            auto writerResult = parquet::arrow::FileWriter::Open(*tableFile->schema, arrow::default_memory_pool(), tableFile->sink, properties,
+                                                                 arrowProperties);
+            checkStatus(writerResult.status(), fileName, "parquet writer creation");
+            tableFile->parquetWriter = std::move(*writerResult);
+        } else {
+            auto writerResult = arrow::ipc::MakeFileWriter(tableFile->sink, tableFile->schema);
+            checkStatus(writerResult.status(), fileName, "arrow writer creation");
+            tableFile->ipcWriter = *writerResult;
+        }
+    }
+
+    void WriterParquet::writeRowGroup(TableFile* tableFile) {
+        if (tableFile->rows == 0)
+            return;
+
+        std::vector<std::shared_ptr<arrow::Array>> arrays;
+        arrays.reserve(tableFile->columns.size());
+        for (ColumnBuffer& column: tableFile->columns) {
+            std::shared_ptr<arrow::Array> array;
+            checkStatus(column.builder->Finish(&array), tableFile->fileName, "column " + column.name + " finish");
+            arrays.push_back(std::move(array));
+        }
+        const std::shared_ptr<arrow::RecordBatch> batch = arrow::RecordBatch::Make(tableFile->schema, static_cast<int64_t>(tableFile->rows),
+                                                                                   std::move(arrays));
+
+        contextSet(CONTEXT::OS, REASON::OS);
+        if (fileFormat == FILE_FORMAT::PARQUET) {
+            auto tableResult = arrow::Table::FromRecordBatches({batch});
+            checkStatus(tableResult.status(), tableFile->fileName, "table creation");
+            checkStatus(tableFile->parquetWriter->WriteTable(**tableResult, static_cast<int64_t>(tableFile->rows)), tableFile->fileName,
+                        "row group write");
+        } else
+            checkStatus(tableFile->ipcWriter->WriteRecordBatch(*batch), tableFile->fileName, "record batch write");
+        contextSet(CONTEXT::CPU);
+
+        if (unlikely(ctx->isTraceSet(Ctx::TRACE::WRITER)))
+            ctx->logTrace(Ctx::TRACE::WRITER, "file: " + tableFile->fileName + " - written rows: " + std::to_string(tableFile->rows));
+        tableFile->rows = 0;
+    }
+
+    void WriterParquet::closeFile(TableFile* tableFile) {
+        if (tableFile->sink != nullptr) {
+            writeRowGroup(tableFile);
+
+            contextSet(CONTEXT::OS, REASON::OS);
+            if (tableFile->parquetWriter != nullptr)
+                checkStatus(tableFile->parquetWriter->Close(), tableFile->fileName, "close");
+            if (tableFile->ipcWriter != nullptr)
+                checkStatus(tableFile->ipcWriter->Close(), tableFile->fileName, "close");
+            checkStatus(tableFile->sink->Close(), tableFile->fileName, "close");
+            contextSet(CONTEXT::CPU);
+
+            tableFile->parquetWriter = nullptr;
+            tableFile->ipcWriter = nullptr;
+            tableFile->sink = nullptr;
+            tableFile->fileSize = 0;
+        }
+
+        for (BuilderMsg* msg: tableFile->messages)
+            confirmMessage(msg);
+        tableFile->messages.clear();
+    }
+
+    void WriterParquet::closeFiles(bool all) {
+        const time_t now = time(nullptr);
+        for (auto& [obj, tableFile]: tables) {
+            if (tableFile == nullptr || tableFile->sink == nullptr)
+                continue;
+            if (all || tableFile->fileTime + static_cast<time_t>(maxFileAgeS) <= now)
+                closeFile(tableFile);
+        }
+    }
+
+    void WriterParquet::sendMessage(BuilderMsg* msg) {
+        // Begin, commit and checkpoint messages carry no rows
+        if (msg->obj == 0) {
+            confirmMessage(msg);
+            return;
+        }
+
+        TableFile* tableFile = getTable(msg->obj);
+        rapidjson::Document document;
+        if (document.Parse<rapidjson::kParseNumbersAsStringsFlag>(reinterpret_cast<const char*>(msg->data + msg->tagSize),
+                                                                   msg->size - msg->tagSize).HasParseError())
+            throw RuntimeException(10091, "message scn: " + msg->scn.toString() + " - parse error: " + GetParseError_En(document.GetParseError()));
+
+        const uint64_t rows = tableFile != nullptr ? tableFile->rows : 0;
+        bool ddl = false;
+        // A batch of messages is an array, every element with the header and the payload of one row
+        const rapidjson::SizeType elements = document.IsArray() ? document.Size() : 1;
+        for (rapidjson::SizeType i = 0; i < elements; ++i) {
+            const rapidjson::Value& element = document.IsArray() ? document[i] : document;
+            if (!element.IsObject() || !element.HasMember("payload"))
+                continue;
+
+            Scn scn = msg->scn;
+            if (element.HasMember("scn") && element["scn"].IsString())
+                scn = Scn(strtoull(element["scn"].GetString(), nullptr, 10));
+            appendPayload(tableFile, scn, element["payload"], ddl);
+        }
+
+        // Columns may have changed, the rows gathered so far are written and the table is read again for the next rows
+        if (ddl) {
+            if (tableFile != nullptr) {
+                closeFile(tableFile);
+                delete tableFile;
+            }
+            tables.erase(msg->obj);
+            confirmMessage(msg);
+            return;
+        }
+
+        if (tableFile == nullptr || tableFile->rows == rows) {
+            confirmMessage(msg);
+            return;
+        }
+
+        tableFile->messages.push_back(msg);
+        tableFile->fileSize += msg->size - msg->tagSize;
+        if (tableFile->rows >= rowGroupRows)
+            writeRowGroup(tableFile);
+        if (tableFile->fileSize >= maxFileSize)
+            closeFile(tableFile);
+    }
+
+    void WriterParquet::pollQueue() {
+        if (metadata->status == Metadata::STATUS::READY)
+            metadata->setStatusStart(this);
+
+        // Messages wait in the output queue until their file is closed, a full queue would stop the writer
+        closeFiles(currentQueueSize >= ctx->queueSize);
+    }
+
+    void WriterParquet::flush() {
+        closeFiles(true);
+    }
+}
@@ -0,0 +1,117 @@
+/* Header for WriterParquet class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef WRITER_PARQUET_H_
+#define WRITER_PARQUET_H_
+
+#include <arrow/api.h>
+#include <arrow/io/file.h>
+#include <arrow/ipc/writer.h>
+#include <parquet/arrow/writer.h>
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "../common/Format.h"
+#include "Writer.h"
+
+namespace OpenLogReplicator {
+    class DbTable;
+
+    // Columnar output: the rows of every table are gathered in record batches typed after the table columns and written to
+    // files of their own. A file is readable only once closed, so its messages are confirmed when the file is closed
+    class WriterParquet final : public Writer {
+    public:
+        enum class FILE_FORMAT : unsigned char {
+            PARQUET, ARROW
+        };
+
+    protected:
+        enum class KIND : unsigned char {
+            STRING, INT64, DECIMAL, FLOAT, DOUBLE, BOOLEAN, TIMESTAMP
+        };
+
+        struct ColumnBuffer {
+            std::string name;
+            KIND kind;
+            int32_t scale;
+            std::unique_ptr<arrow::ArrayBuilder> builder;
+            // Value already appended for the row being added
+            bool set;
+        };
+
+        struct TableFile {
+            std::string name;
+            std::shared_ptr<arrow::Schema> schema;
+            // Starting with the operation and the scn of the row, then the table columns
+            std::vector<ColumnBuffer> columns;
+            std::unordered_map<std::string, size_t> columnIndex;
+            uint64_t rows{0};
+            uint64_t fileSize{0};
+            time_t fileTime{0};
+            std::string fileName;
+            std::shared_ptr<arrow::io::FileOutputStream> sink;
+            std::unique_ptr<parquet::arrow::FileWriter> parquetWriter;
+            std::shared_ptr<arrow::ipc::RecordBatchWriter> ipcWriter;
+            // Sent and waiting for the file to be closed
+            std::vector<BuilderMsg*> messages;
+        };
+
+        static constexpr uint64_t COLUMN_OP{0};
+        static constexpr uint64_t COLUMN_SCN{1};
+        static constexpr uint64_t COLUMN_FIRST{2};
+
+        FILE_FORMAT fileFormat;
+        std::string output;
+        uint64_t rowGroupRows;
+        uint64_t maxFileSize;
+        uint64_t maxFileAgeS;
+        arrow::Compression::type compression;
+        // DATE and TIMESTAMP columns are typed only for the unix formats of the builder, otherwise they stay text
+        bool timestampTyped{false};
+        arrow::TimeUnit::type timestampUnit{arrow::TimeUnit::SECOND};
+        std::unordered_map<typeObj, TableFile*> tables;
+
+        TableFile* getTable(typeObj obj);
+        void addColumn(TableFile* tableFile, const std::string& name, KIND kind, const std::shared_ptr<arrow::DataType>& type, int32_t scale);
+        void appendValue(ColumnBuffer& column, const rapidjson::Value& value);
+        void appendRow(TableFile* tableFile, char op, Scn scn, const rapidjson::Value& values);
+        void appendPayload(TableFile* tableFile, Scn scn, const rapidjson::Value& payload, bool& ddl);
+        void writeRowGroup(TableFile* tableFile);
+        void openFile(TableFile* tableFile, Scn scn);
+        void closeFile(TableFile* tableFile);
+        void closeFiles(bool all);
+        void checkStatus(const arrow::Status& status, const std::string& fileName, const std::string& operation) const;
+
+        void sendMessage(BuilderMsg* msg) override;
+        std::string getType() const override;
+        void pollQueue() override;
+
+    public:
+        WriterParquet(Ctx* newCtx, std::string newAlias, std::string newDatabase, Builder* newBuilder, Metadata* newMetadata, FILE_FORMAT newFileFormat,
+                      std::string newOutput, uint64_t newRowGroupRows, uint64_t newMaxFileSize, uint64_t newMaxFileAgeS,
+                      arrow::Compression::type newCompression, Format::TIMESTAMP_FORMAT newTimestampFormat);
+        ~WriterParquet() override;
+
+        void initialize() override;
+        void flush() override;
+    };
+}
+
+#endif
@@ -0,0 +1,172 @@
+/* Thread publishing messages to a shared memory ring
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "../builder/Builder.h"
+#include "../common/exception/RuntimeException.h"
+#include "../metadata/Metadata.h"
+#include "WriterShm.h"
+
+namespace OpenLogReplicator {
+    WriterShm::WriterShm(Ctx* newCtx, std::string newAlias, std::string newDatabase, Builder* newBuilder, Metadata* newMetadata,
+                         std::string newName, uint64_t newRingSize) :
+            Writer(newCtx, std::move(newAlias), std::move(newDatabase), newBuilder, newMetadata),
+            name(std::move(newName)),
+            ringSize(newRingSize) {
+    }
+
+    WriterShm::~WriterShm() {
+        if (shmData != nullptr) {
+            munmap(shmData, shmSize);
+            shmData = nullptr;
+            header = nullptr;
+            ring = nullptr;
+        }
+        if (shmDes != -1) {
+            close(shmDes);
+            shm_unlink(name.c_str());
+            shmDes = -1;
+        }
+    }
+
+    void WriterShm::initialize() {
+        Writer::initialize();
+
+        static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared memory ring requires lock-free 64-bit atomics");
+        uint64_t capacity = 4096;
+        while (capacity < ringSize)
+            capacity <<= 1;
+        const uint64_t dataOffset = (sizeof(ShmRingHeader) + 4095) & ~static_cast<uint64_t>(4095);
+        shmSize = dataOffset + capacity;
+
+        shmDes = shm_open(name.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+        if (shmDes == -1)
+            throw RuntimeException(10077, "shared memory: " + name + " - open returned: " + strerror(errno));
+
+        if (ftruncate(shmDes, static_cast<off_t>(shmSize)) != 0)
+            throw RuntimeException(10077, "shared memory: " + name + " - resize to " + std::to_string(shmSize) +
+                                          " bytes returned: " + strerror(errno));
+
+        void* addr = mmap(nullptr, shmSize, PROT_READ | PROT_WRITE, MAP_SHARED, shmDes, 0);
+        if (addr == MAP_FAILED)
+            throw RuntimeException(10077, "shared memory: " + name + " - map returned: " + strerror(errno));
+        shmData = reinterpret_cast<uint8_t*>(addr);
+
+        // Publish the magic last, a consumer attaching in between sees no valid ring yet
+        header = new(shmData) ShmRingHeader();
+        header->magic = 0;
+        header->version = ShmRingHeader::VERSION;
+        header->capacity = capacity;
+        header->dataOffset = dataOffset;
+        header->epoch = ctx->clock->getTimeUt();
+        header->writePos.store(0, std::memory_order_relaxed);
+        header->writeSeq.store(0, std::memory_order_relaxed);
+        header->readPos.store(0, std::memory_order_relaxed);
+        header->confirmedSeq.store(0, std::memory_order_relaxed);
+        ring = shmData + dataOffset;
+        std::atomic_thread_fence(std::memory_order_release);
+        header->magic = ShmRingHeader::MAGIC;
+
+        ctx->info(0, "shared memory ring: " + name + ", size: " + std::to_string(capacity) + " bytes");
+        streaming = true;
+    }
+
+    void WriterShm::sendMessage(BuilderMsg* msg) {
+        const uint64_t size = msg->size - msg->tagSize;
+        const uint64_t recordSize = (sizeof(ShmRecord) + size + 7) & 0xFFFFFFFFFFFFFFF8;
+        const uint64_t capacity = header->capacity;
+        if (recordSize > capacity)
+            throw RuntimeException(10078, "shared memory: " + name + " - message size (" + std::to_string(recordSize) +
+                                          ") exceeds ring size (" + std::to_string(capacity) + ")");
+
+        // A record never wraps, the rest of the data area is skipped
+        const uint64_t offset = writePos & (capacity - 1);
+        const uint64_t padding = (offset + recordSize > capacity) ? capacity - offset : 0;
+
+        while (writePos + padding + recordSize - header->readPos.load(std::memory_order_acquire) > capacity) {
+            if (ctx->hardShutdown)
+                return;
+            confirmConsumed();
+            if (writePos + padding + recordSize - header->readPos.load(std::memory_order_acquire) <= capacity)
+                break;
+
+            if (unlikely(ctx->isTraceSet(Ctx::TRACE::WRITER)))
+                ctx->logTrace(Ctx::TRACE::WRITER, "shared memory ring is full, sleeping " + std::to_string(ctx->pollIntervalUs) + "us");
+            contextSet(CONTEXT::SLEEP);
+            usleep(ctx->pollIntervalUs);
+            contextSet(CONTEXT::CPU);
+        }
+
+        if (padding > 0) {
+            if (padding >= sizeof(ShmRecord)) {
+                auto* record = reinterpret_cast<ShmRecord*>(ring + offset);
+                record->seq = 0;
+                record->size = ShmRecord::PADDING;
+            }
+            writePos += padding;
+        }
+
+        auto* record = reinterpret_cast<ShmRecord*>(ring + (writePos & (capacity - 1)));
+        record->seq = nextSeq;
+        record->size = size;
+        record->scn = msg->scn.getData();
+        record->lwnScn = msg->lwnScn.getData();
+        record->lwnIdx = msg->lwnIdx;
+        memcpy(reinterpret_cast<uint8_t*>(record) + sizeof(ShmRecord), msg->data + msg->tagSize, size);
+        writePos += recordSize;
+
+        header->writePos.store(writePos, std::memory_order_release);
+        header->writeSeq.store(nextSeq, std::memory_order_release);
+
+        // The message is confirmed when the consumer moves its cursor past the sequence
+        pending.push_back({nextSeq, writePos, msg});
+        ++nextSeq;
+    }
+
+    void WriterShm::confirmConsumed() {
+        const uint64_t confirmedSeq = header->confirmedSeq.load(std::memory_order_acquire);
+        if (pending.empty() || pending.front().seq > confirmedSeq)
+            return;
+
+        uint64_t readPos = 0;
+        while (!pending.empty() && pending.front().seq <= confirmedSeq) {
+            readPos = pending.front().endPos;
+            confirmMessage(pending.front().msg);
+            pending.pop_front();
+        }
+        header->readPos.store(readPos, std::memory_order_release);
+    }
+
+    std::string WriterShm::getType() const {
+        return "shm:" + name;
+    }
+
+    void WriterShm::pollQueue() {
+        if (metadata->status == Metadata::STATUS::READY)
+            metadata->setStatusStart(this);
+
+        if (header != nullptr)
+            confirmConsumed();
+    }
+}
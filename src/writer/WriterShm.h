@@ -0,0 +1,95 @@
+/* Header for WriterShm class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef WRITER_SHM_H_
+#define WRITER_SHM_H_
+
+#include <atomic>
+#include <deque>
+
+#include "Writer.h"
+
+namespace OpenLogReplicator {
+    // Layout of the shared memory ring, the consumer maps the same object read-write and only stores confirmedSeq
+    struct ShmRingHeader {
+        static constexpr uint64_t MAGIC{0x4E4952524853524FULL};
+        static constexpr uint64_t VERSION{1};
+
+        uint64_t magic;
+        uint64_t version;
+        // Size of the data area, a power of two, the data area starts at dataOffset
+        uint64_t capacity;
+        uint64_t dataOffset;
+        // Changed every time the ring is created, sequences start again from 1
+        uint64_t epoch;
+        // Bytes and last sequence published by the writer
+        alignas(64) std::atomic<uint64_t> writePos;
+        std::atomic<uint64_t> writeSeq;
+        // Bytes released by the writer once confirmed by the consumer
+        alignas(64) std::atomic<uint64_t> readPos;
+        // Last sequence processed by the consumer
+        alignas(64) std::atomic<uint64_t> confirmedSeq;
+    };
+
+    // Every message is a record header followed by the payload, padded to 8 bytes; a record with size equal to
+    // PADDING, or less than the record header left before the end of the data area, means: continue from the start
+    struct ShmRecord {
+        static constexpr uint64_t PADDING{UINT64_MAX};
+
+        uint64_t seq;
+        uint64_t size;
+        uint64_t scn;
+        uint64_t lwnScn;
+        uint64_t lwnIdx;
+    };
+
+    class WriterShm final : public Writer {
+    protected:
+        struct ShmPending {
+            uint64_t seq;
+            uint64_t endPos;
+            BuilderMsg* msg;
+        };
+
+        std::string name;
+        uint64_t ringSize;
+        int shmDes{-1};
+        uint8_t* shmData{nullptr};
+        uint64_t shmSize{0};
+        ShmRingHeader* header{nullptr};
+        uint8_t* ring{nullptr};
+        uint64_t writePos{0};
+        uint64_t nextSeq{1};
+        std::deque<ShmPending> pending;
+
+        void sendMessage(BuilderMsg* msg) override;
+        std::string getType() const override;
+        void pollQueue() override;
+        void confirmConsumed();
+
+    public:
+        WriterShm(Ctx* newCtx, std::string newAlias, std::string newDatabase, Builder* newBuilder, Metadata* newMetadata,
+                  std::string newName, uint64_t newRingSize);
+        ~WriterShm() override;
+
+        void initialize() override;
+    };
+}
+
+#endif
@@ -0,0 +1,258 @@
+/* Server-Sent Events output for the embedded HTTP server
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include "../builder/Builder.h"
+#include "../common/Clock.h"
+#include "../common/DbTable.h"
+#include "../common/exception/RuntimeException.h"
+#include "../metadata/Metadata.h"
+#include "../metadata/Schema.h"
+#include "WriterSse.h"
+
+namespace OpenLogReplicator {
+    std::mutex WriterSse::streamsMtx;
+    std::unordered_map<std::string, WriterSse*> WriterSse::streams;
+
+    WriterSse::WriterSse(Ctx* newCtx, std::string newAlias, std::string newDatabase, Builder* newBuilder, Metadata* newMetadata, std::string newStream,
+                         uint64_t newBufferSize, uint64_t newClientBufferSize, uint64_t newBatchBytes, uint64_t newBatchLatencyUs,
+                         uint64_t newMaxClients) :
+            Writer(newCtx, std::move(newAlias), std::move(newDatabase), newBuilder, newMetadata),
+            stream(std::move(newStream)),
+            bufferSize(newBufferSize),
+            clientBufferSize(newClientBufferSize),
+            batchBytes(newBatchBytes),
+            batchLatencyUs(newBatchLatencyUs),
+            maxClients(newMaxClients) {
+    }
+
+    WriterSse::~WriterSse() {
+        {
+            std::unique_lock<std::mutex> const lckStreams(streamsMtx);
+            auto streamsIt = streams.find(ctx->tenant + "/" + stream);
+            if (streamsIt != streams.end() && streamsIt->second == this)
+                streams.erase(streamsIt);
+        }
+
+        std::unique_lock<std::mutex> const lck(mtx);
+        for (auto& subscriber: subscribers)
+            subscriber.client->close();
+        subscribers.clear();
+    }
+
+    void WriterSse::initialize() {
+        Writer::initialize();
+
+        const std::string key(ctx->tenant + "/" + stream);
+        {
+            std::unique_lock<std::mutex> const lckStreams(streamsMtx);
+            if (streams.find(key) != streams.end())
+                throw RuntimeException(10098, "sse stream: " + key + " - already used by another writer");
+            streams.insert_or_assign(key, this);
+        }
+
+        ctx->info(0, "sse stream: " + key + ", replay buffer: " + std::to_string(bufferSize) + " bytes");
+        lastFlush = ctx->clock->getTimeUt();
+        streaming = true;
+    }
+
+    std::string WriterSse::eventId(Scn lwnScn, typeIdx lwnIdx) {
+        return lwnScn.toString() + "." + std::to_string(lwnIdx);
+    }
+
+    bool WriterSse::parseEventId(const std::string& id, Scn& lwnScn, typeIdx& lwnIdx) {
+        const size_t dot = id.find('.');
+        if (dot == std::string::npos || dot == 0 || dot + 1 == id.length())
+            return false;
+
+        char* end = nullptr;
+        lwnScn = Scn(strtoull(id.c_str(), &end, 10));
+        if (end != id.c_str() + dot)
+            return false;
+        lwnIdx = strtoull(id.c_str() + dot + 1, &end, 10);
+        return *end == 0;
+    }
+
+    // Resolved once for every object, like the routing of the writer
+    const std::string& WriterSse::objectName(typeObj obj) {
+        auto objectNamesIt = objectNames.find(obj);
+        if (objectNamesIt != objectNames.end())
+            return objectNamesIt->second;
+
+        std::string tableName;
+        {
+            contextSet(CONTEXT::MUTEX, REASON::WRITER_SCHEMA);
+            std::unique_lock<std::mutex> const lck(metadata->mtxSchema);
+            const DbTable* table = metadata->schema->checkTableDict(obj);
+            if (table != nullptr)
+                tableName = table->owner + "." + table->name;
+        }
+        contextSet(CONTEXT::CPU);
+        return objectNames.insert_or_assign(obj, std::move(tableName)).first->second;
+    }
+
+    // Messages without an object, like begin and commit, go to every subscriber
+    void WriterSse::appendEvent(Subscriber& subscriber, const Event& event) {
+        if (!subscriber.tables.empty() && !event.table.empty() && subscriber.tables.find(event.table) == subscriber.tables.end())
+            return;
+
+        subscriber.batch.append("data: ");
+        size_t start = 0;
+        size_t newLine;
+        while ((newLine = event.data.find('\n', start)) != std::string::npos) {
+            subscriber.batch.append(event.data, start, newLine - start);
+            subscriber.batch.append("\ndata: ");
+            start = newLine + 1;
+        }
+        subscriber.batch.append(event.data, start, std::string::npos);
+        subscriber.batch.push_back('\n');
+        subscriber.lastId = eventId(event.lwnScn, event.lwnIdx);
+    }
+
+    // A batch is sent when it is big enough or when it waited long enough. A client whose socket still holds unsent data over the limit
+    // is dropped, it may reconnect with the id of the last event it received
+    void WriterSse::flushSubscribers(bool force) {
+        const time_ut now = ctx->clock->getTimeUt();
+        const bool due = force || now - lastFlush >= static_cast<time_ut>(batchLatencyUs);
+
+        std::unique_lock<std::mutex> const lck(mtx);
+        for (auto subscribersIt = subscribers.begin(); subscribersIt != subscribers.end();) {
+            Subscriber& subscriber = *subscribersIt;
+            if (!subscriber.client->connected()) {
+                ctx->info(0, "sse stream: " + ctx->tenant + "/" + stream + " - client disconnected, last event: " + subscriber.lastId);
+                subscribersIt = subscribers.erase(subscribersIt);
+                continue;
+            }
+
+            if (subscriber.batch.empty() || (!due && subscriber.batch.size() < batchBytes)) {
+                ++subscribersIt;
+                continue;
+            }
+
+            const uint64_t backlog = subscriber.client->backlog();
+            if (backlog > 0 && backlog + subscriber.batch.size() > clientBufferSize) {
+                ctx->warning(60061, "sse stream: " + ctx->tenant + "/" + stream + " - client dropped, unsent: " + std::to_string(backlog) +
+                                    " bytes, last event: " + subscriber.lastId);
+                subscriber.client->close();
+                subscribersIt = subscribers.erase(subscribersIt);
+                continue;
+            }
+
+            subscriber.client->send("id: " + subscriber.lastId + "\n" + subscriber.batch + "\n");
+            subscriber.batch.clear();
+            ++subscribersIt;
+        }
+
+        if (due)
+            lastFlush = now;
+    }
+
+    void WriterSse::sendMessage(BuilderMsg* msg) {
+        Event event{msg->scn, msg->lwnScn, msg->lwnIdx, msg->obj != 0 ? objectName(msg->obj) : std::string(),
+                    std::string(reinterpret_cast<const char*>(msg->data + msg->tagSize), msg->size - msg->tagSize)};
+        confirmMessage(msg);
+
+        {
+            std::unique_lock<std::mutex> const lck(mtx);
+            for (auto& subscriber: subscribers)
+                appendEvent(subscriber, event);
+
+            eventsSize += event.data.size();
+            events.push_back(std::move(event));
+            while (eventsSize > bufferSize && events.size() > 1) {
+                const Event& oldest = events.front();
+                trimmedScn = oldest.scn;
+                trimmedLwnScn = oldest.lwnScn;
+                trimmedLwnIdx = oldest.lwnIdx;
+                eventsSize -= oldest.data.size();
+                events.pop_front();
+            }
+        }
+
+        flushSubscribers(false);
+    }
+
+    std::string WriterSse::getType() const {
+        return "sse:" + stream;
+    }
+
+    void WriterSse::pollQueue() {
+        if (metadata->status == Metadata::STATUS::READY)
+            metadata->setStatusStart(this);
+
+        flushSubscribers(false);
+    }
+
+    void WriterSse::flush() {
+        flushSubscribers(true);
+    }
+
+    WriterSse::SUBSCRIBE WriterSse::subscribe(const std::string& tenant, const std::string& name, const std::shared_ptr<SseClient>& client,
+                                              const std::unordered_set<std::string>& tables, Scn scn, const std::string& lastEventId) {
+        std::unique_lock<std::mutex> const lckStreams(streamsMtx);
+        WriterSse* writer = nullptr;
+        if (!name.empty()) {
+            auto streamsIt = streams.find(tenant + "/" + name);
+            if (streamsIt != streams.end())
+                writer = streamsIt->second;
+        } else {
+            // Without a name the tenant must have exactly one stream
+            const std::string prefix(tenant + "/");
+            for (const auto& [key, stream]: streams) {
+                if (key.compare(0, prefix.length(), prefix) != 0)
+                    continue;
+                if (writer != nullptr)
+                    return SUBSCRIBE::NOT_FOUND;
+                writer = stream;
+            }
+        }
+        if (writer == nullptr)
+            return SUBSCRIBE::NOT_FOUND;
+
+        std::unique_lock<std::mutex> const lck(writer->mtx);
+        if (writer->subscribers.size() >= writer->maxClients)
+            return SUBSCRIBE::TOO_MANY_CLIENTS;
+
+        Subscriber subscriber{client, tables, "", ""};
+        if (!lastEventId.empty()) {
+            Scn lwnScn;
+            typeIdx lwnIdx;
+            if (!parseEventId(lastEventId, lwnScn, lwnIdx))
+                return SUBSCRIBE::POSITION_LOST;
+            if (writer->trimmedLwnScn != Scn::none() &&
+                (lwnScn < writer->trimmedLwnScn || (lwnScn == writer->trimmedLwnScn && lwnIdx < writer->trimmedLwnIdx)))
+                return SUBSCRIBE::POSITION_LOST;
+
+            for (const Event& event: writer->events)
+                if (lwnScn < event.lwnScn || (lwnScn == event.lwnScn && lwnIdx < event.lwnIdx))
+                    appendEvent(subscriber, event);
+        } else if (scn != Scn::none()) {
+            if (writer->trimmedScn != Scn::none() && scn <= writer->trimmedScn)
+                return SUBSCRIBE::POSITION_LOST;
+
+            for (const Event& event: writer->events)
+                if (scn <= event.scn)
+                    appendEvent(subscriber, event);
+        }
+
+        writer->ctx->info(0, "sse stream: " + tenant + "/" + writer->stream + " - client connected, replayed: " +
+                             std::to_string(subscriber.batch.size()) + " bytes");
+        writer->subscribers.push_back(std::move(subscriber));
+        return SUBSCRIBE::OK;
+    }
+}
@@ -0,0 +1,119 @@
+/* Header for WriterSse class
+   Copyright (C) 2018-2025 Adam Leszczynski (aleszczynski@bersler.com)
+
+This file is part of OpenLogReplicator.
+
+OpenLogReplicator is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as published
+by the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+OpenLogReplicator is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenLogReplicator; see the file LICENSE;  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef WRITER_SSE_H_
+#define WRITER_SSE_H_
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "Writer.h"
+
+namespace OpenLogReplicator {
+    // Connection of a subscriber, implemented by the embedded HTTP server. Called by the writer thread
+    class SseClient {
+    public:
+        virtual ~SseClient() = default;
+
+        [[nodiscard]] virtual bool connected() const = 0;
+        // Bytes accepted by send() and not written to the socket yet
+        [[nodiscard]] virtual uint64_t backlog() const = 0;
+        virtual void send(const std::string& frame) = 0;
+        virtual void close() = 0;
+    };
+
+    // Server-Sent Events for lightweight consumers attached to the embedded HTTP server of the replicator manager. Delivery is best
+    // effort: messages are confirmed as soon as they are copied to a replay buffer, a client which can't keep up is dropped and
+    // resumes from the buffer by the id of the last event it received. Every event carries a batch of messages, one per data line
+    class WriterSse final : public Writer {
+    public:
+        enum class SUBSCRIBE : unsigned char {
+            OK, NOT_FOUND, TOO_MANY_CLIENTS, POSITION_LOST
+        };
+
+    protected:
+        struct Event {
+            Scn scn;
+            Scn lwnScn;
+            typeIdx lwnIdx;
+            // OWNER.TABLE, empty for messages without an object
+            std::string table;
+            std::string data;
+        };
+
+        struct Subscriber {
+            std::shared_ptr<SseClient> client;
+            // OWNER.TABLE, every table when empty
+            std::unordered_set<std::string> tables;
+            std::string batch;
+            std::string lastId;
+        };
+
+        static std::mutex streamsMtx;
+        static std::unordered_map<std::string, WriterSse*> streams;
+
+        std::string stream;
+        uint64_t bufferSize;
+        uint64_t clientBufferSize;
+        uint64_t batchBytes;
+        uint64_t batchLatencyUs;
+        uint64_t maxClients;
+
+        // Guards the replay buffer and the subscribers, both are used by the server threads when a client connects
+        std::mutex mtx;
+        std::deque<Event> events;
+        uint64_t eventsSize{0};
+        // Position of the last event dropped from the replay buffer, positions up to it can't be resumed
+        Scn trimmedScn{Scn::none()};
+        Scn trimmedLwnScn{Scn::none()};
+        typeIdx trimmedLwnIdx{0};
+        std::vector<Subscriber> subscribers;
+        std::unordered_map<typeObj, std::string> objectNames;
+        time_ut lastFlush{0};
+
+        [[nodiscard]] static std::string eventId(Scn lwnScn, typeIdx lwnIdx);
+        [[nodiscard]] static bool parseEventId(const std::string& id, Scn& lwnScn, typeIdx& lwnIdx);
+        [[nodiscard]] const std::string& objectName(typeObj obj);
+        static void appendEvent(Subscriber& subscriber, const Event& event);
+        void flushSubscribers(bool force);
+
+        void sendMessage(BuilderMsg* msg) override;
+        std::string getType() const override;
+        void pollQueue() override;
+
+    public:
+        WriterSse(Ctx* newCtx, std::string newAlias, std::string newDatabase, Builder* newBuilder, Metadata* newMetadata, std::string newStream,
+                  uint64_t newBufferSize, uint64_t newClientBufferSize, uint64_t newBatchBytes, uint64_t newBatchLatencyUs, uint64_t newMaxClients);
+        ~WriterSse() override;
+
+        void initialize() override;
+        void flush() override;
+
+        // Resumes after lastEventId when set, else from the first message with at least the given SCN, else with new messages only
+        [[nodiscard]] static SUBSCRIBE subscribe(const std::string& tenant, const std::string& name, const std::shared_ptr<SseClient>& client,
+                                                 const std::unordered_set<std::string>& tables, Scn scn, const std::string& lastEventId);
+    };
+}
+
+#endif
@@ -22,6 +22,7 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 #include "../common/exception/NetworkException.h"
 #include "../metadata/Metadata.h"
 #include "../stream/Stream.h"
+#include "../stream/StreamFilter.h"
 #include "WriterStream.h"
 
 namespace OpenLogReplicator {
@@ -33,6 +34,11 @@ namespace OpenLogReplicator {
     }
 
     WriterStream::~WriterStream() {
+        if (filter != nullptr) {
+            delete filter;
+            filter = nullptr;
+        }
+
         if (stream != nullptr) {
             delete stream;
             stream = nullptr;
@@ -41,10 +47,54 @@ namespace OpenLogReplicator {
 
     void WriterStream::initialize() {
         Writer::initialize();
+        protobufOutput = builder->isProtobuf();
 
         stream->initializeServer();
     }
 
+    // Subscription sent with START/CONTINUE replaces the previous one
+    bool WriterStream::setFilter() {
+        if (filter != nullptr) {
+            delete filter;
+            filter = nullptr;
+        }
+        const uint64_t rules = StreamFilter::countRules(request);
+        if (rules == 0)
+            return true;
+
+        std::string error;
+        if (!protobufOutput)
+            error = "subscription filters require protobuf format";
+        else {
+            filter = new StreamFilter();
+            if (filter->initialize(request, error)) {
+                ctx->info(0, "client subscribed to " + std::to_string(rules) + " table masks");
+                return true;
+            }
+            delete filter;
+            filter = nullptr;
+        }
+
+        ctx->warning(60038, "invalid subscription: " + error);
+        response.set_code(pb::ResponseCode::INVALID_COMMAND);
+        return false;
+    }
+
+    // The accepted method is named in the reply, the frames after the reply are compressed
+    std::string WriterStream::negotiateCompression() {
+        const std::string method = StreamFilter::getOption(request, "compression");
+        if (method.empty() || !streaming)
+            return "";
+
+        if (!stream->supportsCompression(method)) {
+            ctx->warning(60039, "client requested unsupported compression: " + method + ", sending uncompressed");
+            return "";
+        }
+        (*response.mutable_attributes())["compression"] = method;
+        ctx->info(0, "compression for client: " + method);
+        return method;
+    }
+
     std::string WriterStream::getType() const {
         return stream->getName();
     }
@@ -98,6 +148,9 @@ namespace OpenLogReplicator {
             return;
         }
 
+        if (!setFilter())
+            return;
+
         std::string paramSeq;
         if (request.has_seq()) {
             metadata->startSequence = request.seq();
@@ -160,6 +213,9 @@ namespace OpenLogReplicator {
             return;
         }
 
+        if (!setFilter())
+            return;
+
         // default values
         metadata->clientScn = confirmedScn;
         metadata->clientIdx = confirmedIdx;
@@ -181,92 +237,149 @@ namespace OpenLogReplicator {
         streaming = true;
     }
 
+    // The acknowledgement is cumulative, only the end of the confirmed prefix is moved
     void WriterStream::processConfirm() {
         if (request.database_name() != database) {
             ctx->warning(60035, "unknown database confirmed, got: " + request.database_name() + ", expected: " + database);
             return;
         }
 
-        while (currentQueueSize > 0 && (queue[0]->lwnScn < Scn(request.c_scn()) ||
-                (queue[0]->lwnScn == Scn(request.c_scn()) && queue[0]->lwnIdx <= request.c_idx())))
-            confirmMessage(queue[0]);
+        const Scn scn(request.c_scn());
+        const typeIdx idx = request.c_idx();
+        uint64_t endId = std::max(confirmEndId, queueHeadId);
+        while (endId < queueHeadId + currentQueueSize) {
+            const QueueSlot& slot = queueSlot(endId);
+            if (slot.lwnScn > scn || (slot.lwnScn == scn && slot.lwnIdx > idx))
+                break;
+            ++endId;
+        }
+        confirmEndId = endId;
     }
 
-    void WriterStream::pollQueue() {
-        // No client connected
-        if (!stream->isConnected())
-            return;
+    void WriterStream::applyConfirm() {
+        if (confirmEndId > queueHeadId)
+            confirmUpTo(confirmEndId);
+        confirmEndId = 0;
+    }
 
-        uint8_t msgR[Stream::READ_NETWORK_BUFFER];
+    void WriterStream::processRequest(const uint8_t* data, uint64_t size) {
         std::string msgS;
 
-        const uint64_t size = stream->receiveMessageNB(msgR, Stream::READ_NETWORK_BUFFER);
-
-        if (size > 0) {
-            request.Clear();
-            if (request.ParseFromArray(msgR, static_cast<int>(size))) {
-                if (streaming) {
-                    switch (request.code()) {
-                        case pb::RequestCode::INFO:
-                            processInfo();
-                            response.SerializeToString(&msgS);
-                            stream->sendMessage(msgS.c_str(), msgS.length());
-                            streaming = false;
-                            break;
-
-                        case pb::RequestCode::CONFIRM:
-                            processConfirm();
-                            break;
-
-                        default:
-                            ctx->warning(60032, "unknown request code: " + std::to_string(request.code()));
-                            response.Clear();
-                            response.set_code(pb::ResponseCode::INVALID_COMMAND);
-                            response.SerializeToString(&msgS);
-                            stream->sendMessage(msgS.c_str(), msgS.length());
-                            break;
+        request.Clear();
+        if (request.ParseFromArray(data, static_cast<int>(size))) {
+            // Anything else than a confirmation sees the queue with every earlier confirmation applied
+            if (request.code() != pb::RequestCode::CONFIRM)
+                applyConfirm();
+
+            if (streaming) {
+                switch (request.code()) {
+                    case pb::RequestCode::INFO:
+                        processInfo();
+                        response.SerializeToString(&msgS);
+                        stream->sendMessage(msgS.c_str(), msgS.length());
+                        stream->setCompression("");
+                        streaming = false;
+                        break;
+
+                    case pb::RequestCode::CONFIRM:
+                        processConfirm();
+                        break;
+
+                    default:
+                        ctx->warning(60032, "unknown request code: " + std::to_string(request.code()));
+                        response.Clear();
+                        response.set_code(pb::ResponseCode::INVALID_COMMAND);
+                        response.SerializeToString(&msgS);
+                        stream->sendMessage(msgS.c_str(), msgS.length());
+                        break;
+                }
+            } else {
+                switch (request.code()) {
+                    case pb::RequestCode::INFO:
+                        processInfo();
+                        response.SerializeToString(&msgS);
+                        stream->sendMessage(msgS.c_str(), msgS.length());
+                        break;
+
+                    case pb::RequestCode::START: {
+                        processStart();
+                        const std::string compression = negotiateCompression();
+                        response.SerializeToString(&msgS);
+                        stream->sendMessage(msgS.c_str(), msgS.length());
+                        stream->setCompression(compression);
+                        break;
                     }
-                } else {
-                    switch (request.code()) {
-                        case pb::RequestCode::INFO:
-                            processInfo();
-                            response.SerializeToString(&msgS);
-                            stream->sendMessage(msgS.c_str(), msgS.length());
-                            break;
-
-                        case pb::RequestCode::START:
-                            processStart();
-                            response.SerializeToString(&msgS);
-                            stream->sendMessage(msgS.c_str(), msgS.length());
-                            break;
-
-                        case pb::RequestCode::CONTINUE:
-                            processContinue();
-                            response.SerializeToString(&msgS);
-                            stream->sendMessage(msgS.c_str(), msgS.length());
-                            break;
-
-                        default:
-                            ctx->warning(60032, "unknown request code: " + std::to_string(request.code()));
-                            response.Clear();
-                            response.set_code(pb::ResponseCode::INVALID_COMMAND);
-                            response.SerializeToString(&msgS);
-                            stream->sendMessage(msgS.c_str(), msgS.length());
-                            break;
+
+                    case pb::RequestCode::CONTINUE: {
+                        processContinue();
+                        const std::string compression = negotiateCompression();
+                        response.SerializeToString(&msgS);
+                        stream->sendMessage(msgS.c_str(), msgS.length());
+                        stream->setCompression(compression);
+                        break;
                     }
+
+                    default:
+                        ctx->warning(60032, "unknown request code: " + std::to_string(request.code()));
+                        response.Clear();
+                        response.set_code(pb::ResponseCode::INVALID_COMMAND);
+                        response.SerializeToString(&msgS);
+                        stream->sendMessage(msgS.c_str(), msgS.length());
+                        break;
                 }
-            } else {
-                std::ostringstream ss;
-                ss << "request decoder[" << std::dec << size << "]: ";
-                for (uint64_t i = 0; i < size; ++i)
-                    ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<uint>(msgR[i]) << " ";
-                ctx->warning(60033, ss.str());
             }
-        } else if (errno != EAGAIN)
-            throw NetworkException(10061, "network error, errno: " + std::to_string(errno) + ", message: " + strerror(errno));
+        } else {
+            std::ostringstream ss;
+            ss << "request decoder[" << std::dec << size << "]: ";
+            for (uint64_t i = 0; i < size; ++i)
+                ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<uint>(data[i]) << " ";
+            ctx->warning(60033, ss.str());
+        }
+    }
+
+    void WriterStream::pollQueue() {
+        stream->pollEvents();
+
+        // No client connected
+        if (!stream->isConnected())
+            return;
+
+        // Batched messages are sent when the latency limit passes, at once when there is nothing more to add
+        stream->flush(isCaughtUp() || currentQueueSize >= ctx->queueSize);
+
+        uint8_t msgR[Stream::READ_NETWORK_BUFFER];
+        for (uint64_t requests = 0; requests < MAX_REQUESTS_PER_POLL; ++requests) {
+            const uint64_t size = stream->receiveMessageNB(msgR, Stream::READ_NETWORK_BUFFER);
+            if (size == 0) {
+                if (errno != EAGAIN)
+                    throw NetworkException(10061, "network error, errno: " + std::to_string(errno) + ", message: " + strerror(errno));
+                break;
+            }
+            processRequest(msgR, size);
+        }
+        applyConfirm();
     }
 
     void WriterStream::sendMessage(BuilderMsg* msg) {
-        stream->sendMessage(msg->data + msg->tagSize, msg->size - msg->tagSize);
+        if (filter == nullptr) {
+            stream->queueMessage(msg->data + msg->tagSize, msg->size - msg->tagSize);
+            return;
+        }
+
+        switch (filter->apply(msg->id, msg->data + msg->tagSize, msg->size - msg->tagSize)) {
+            case StreamFilter::RESULT::ORIGINAL:
+                stream->queueMessage(msg->data + msg->tagSize, msg->size - msg->tagSize);
+                break;
+
+            case StreamFilter::RESULT::FILTERED:
+                // The filtered copy does not outlive the call, so it is not batched
+                stream->sendMessage(filter->getOutput().c_str(), filter->getOutput().length());
+                break;
+
+            case StreamFilter::RESULT::SKIP:
+                // Nothing the client subscribed to, it would never confirm the message
+                confirmMessage(msg);
+                break;
+        }
     }
 }
@@ -25,18 +25,28 @@ along with OpenLogReplicator; see the file LICENSE;  If not see
 
 namespace OpenLogReplicator {
     class Stream;
+    class StreamFilter;
 
     class WriterStream final : public Writer {
     protected:
         Stream* stream;
+        // Subscription of the client, nullptr for everything
+        StreamFilter* filter{nullptr};
+        bool protobufOutput{false};
         pb::RedoRequest request;
         pb::RedoResponse response;
+        // End of the confirmed prefix requested by the client and not applied to the queue yet
+        uint64_t confirmEndId{0};
 
         std::string getType() const override;
+        bool setFilter();
+        [[nodiscard]] std::string negotiateCompression();
         void processInfo();
         void processStart();
         void processContinue();
         void processConfirm();
+        void applyConfirm();
+        void processRequest(const uint8_t* data, uint64_t size);
         void pollQueue() override;
         void sendMessage(BuilderMsg* msg) override;
 